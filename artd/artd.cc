@@ -55,12 +55,15 @@
 #include "android/binder_interface_utils.h"
 #include "android/binder_manager.h"
 #include "android/binder_process.h"
+#include "arch/instruction_set.h"
 #include "base/compiler_filter.h"
 #include "base/file_utils.h"
 #include "base/globals.h"
 #include "base/logging.h"
 #include "base/os.h"
+#include "class_loader_context.h"
 #include "cmdline_types.h"
+#include "dex2oat_fork_server.h"
 #include "exec_utils.h"
 #include "file_utils.h"
 #include "fmt/format.h"
@@ -101,11 +104,9 @@ using ::android::base::Dirname;
 using ::android::base::Error;
 using ::android::base::Join;
 using ::android::base::make_scope_guard;
-using ::android::base::ReadFileToString;
 using ::android::base::Result;
 using ::android::base::Split;
 using ::android::base::StringReplace;
-using ::android::base::WriteStringToFd;
 using ::art::tools::CmdlineBuilder;
 using ::ndk::ScopedAStatus;
 
@@ -126,6 +127,33 @@ constexpr int kShortTimeoutSec = 60;  // 1 minute.
 // would take down the system server.
 constexpr int kLongTimeoutSec = 570;  // 9.5 minutes.
 
+// The number of compilations after which a dex2oat fork server is replaced by a new one, so that
+// the state accumulated by the fork server process, if any, does not grow unbounded.
+constexpr size_t kMaxDex2oatForkServerRequests = 64;
+
+// The maximum number of cached results of `getDexoptNeeded` and of `getDexoptStatus` each. The
+// caches are cleared when they are full.
+constexpr size_t kMaxDexoptStatusCacheEntries = 4096;
+
+// Returns a fingerprint that changes when the file at `path` is created, deleted, replaced, or
+// written, or std::nullopt if the file cannot be checked.
+std::optional<std::string> GetFileFingerprint(const std::string& path) {
+  struct stat st;
+  if (stat(path.c_str(), &st) != 0) {
+    if (errno == ENOENT || errno == ENOTDIR) {
+      return "missing";
+    }
+    return std::nullopt;
+  }
+  return "{}:{}:{}:{}.{}:{}.{}"_format(st.st_dev,
+                                       st.st_ino,
+                                       st.st_size,
+                                       st.st_mtim.tv_sec,
+                                       st.st_mtim.tv_nsec,
+                                       st.st_ctim.tv_sec,
+                                       st.st_ctim.tv_nsec);
+}
+
 std::optional<int64_t> GetSize(std::string_view path) {
   std::error_code ec;
   int64_t size = std::filesystem::file_size(path, ec);
@@ -316,14 +344,9 @@ Result<ArtdCancellationSignal*> ToArtdCancellationSignal(IArtdCancellationSignal
 }
 
 Result<void> CopyFile(const std::string& src_path, const NewFile& dst_file) {
-  std::string content;
-  if (!ReadFileToString(src_path, &content)) {
-    return Errorf("Failed to read file '{}': {}", src_path, strerror(errno));
-  }
-  if (!WriteStringToFd(content, dst_file.Fd())) {
-    return Errorf("Failed to write file '{}': {}", dst_file.TempPath(), strerror(errno));
-  }
-  if (fsync(dst_file.Fd()) != 0) {
+  OR_RETURN(CopyFileContents(src_path, dst_file));
+  // Only the data and the size need to be durable.
+  if (fdatasync(dst_file.Fd()) != 0) {
     return Errorf("Failed to flush file '{}': {}", dst_file.TempPath(), strerror(errno));
   }
   if (lseek(dst_file.Fd(), /*offset=*/0, SEEK_SET) != 0) {
@@ -354,13 +377,15 @@ class FdLogger {
   void Add(const NewFile& file) { fd_mapping_.emplace_back(file.Fd(), file.TempPath()); }
   void Add(const File& file) { fd_mapping_.emplace_back(file.Fd(), file.GetPath()); }
 
-  std::string GetFds() {
+  std::string GetFds() { return Join(GetFdList(), ':'); }
+
+  std::vector<int> GetFdList() {
     std::vector<int> fds;
     fds.reserve(fd_mapping_.size());
     for (const auto& [fd, path] : fd_mapping_) {
       fds.push_back(fd);
     }
-    return Join(fds, ':');
+    return fds;
   }
 
  private:
@@ -415,6 +440,17 @@ ScopedAStatus Artd::getDexoptStatus(const std::string& in_dexFile,
     return NonFatal("Failed to get runtime options: " + ofa_context.error().message());
   }
 
+  std::optional<std::string> cache_key =
+      GetDexoptStatusCacheKey(in_dexFile, in_instructionSet, in_classLoaderContext);
+  if (cache_key.has_value()) {
+    std::lock_guard<std::mutex> lock(dexopt_status_cache_mu_);
+    auto it = dexopt_status_cache_.find(cache_key.value());
+    if (it != dexopt_status_cache_.end()) {
+      *_aidl_return = it->second;
+      return ScopedAStatus::ok();
+    }
+  }
+
   std::unique_ptr<ClassLoaderContext> context;
   std::string error_msg;
   auto oat_file_assistant = OatFileAssistant::Create(in_dexFile,
@@ -442,6 +478,14 @@ ScopedAStatus Artd::getDexoptStatus(const std::string& in_dexFile,
   DCHECK(ignored_odex_status == "up-to-date" || ignored_odex_status == "apk-more-recent" ||
          ignored_odex_status == "io-error-no-oat");
 
+  if (cache_key.has_value()) {
+    std::lock_guard<std::mutex> lock(dexopt_status_cache_mu_);
+    if (dexopt_status_cache_.size() >= kMaxDexoptStatusCacheEntries) {
+      dexopt_status_cache_.clear();
+    }
+    dexopt_status_cache_.insert_or_assign(std::move(cache_key.value()), *_aidl_return);
+  }
+
   return ScopedAStatus::ok();
 }
 
@@ -755,6 +799,20 @@ ndk::ScopedAStatus Artd::getDexoptNeeded(const std::string& in_dexFile,
     return NonFatal("Failed to get runtime options: " + ofa_context.error().message());
   }
 
+  CompilerFilter::Filter compiler_filter = OR_RETURN_FATAL(ParseCompilerFilter(in_compilerFilter));
+
+  std::optional<std::string> cache_key =
+      GetDexoptStatusCacheKey(in_dexFile, in_instructionSet, in_classLoaderContext);
+  if (cache_key.has_value()) {
+    cache_key.value() += "{}\n{}\n"_format(in_compilerFilter, in_dexoptTrigger);
+    std::lock_guard<std::mutex> lock(dexopt_status_cache_mu_);
+    auto it = dexopt_needed_cache_.find(cache_key.value());
+    if (it != dexopt_needed_cache_.end()) {
+      *_aidl_return = it->second;
+      return ScopedAStatus::ok();
+    }
+  }
+
   std::unique_ptr<ClassLoaderContext> context;
   std::string error_msg;
   auto oat_file_assistant = OatFileAssistant::Create(in_dexFile,
@@ -770,13 +828,19 @@ ndk::ScopedAStatus Artd::getDexoptNeeded(const std::string& in_dexFile,
   }
 
   OatFileAssistant::DexOptStatus status;
-  _aidl_return->isDexoptNeeded =
-      oat_file_assistant->GetDexOptNeeded(OR_RETURN_FATAL(ParseCompilerFilter(in_compilerFilter)),
-                                          DexOptTriggerFromAidl(in_dexoptTrigger),
-                                          &status);
+  _aidl_return->isDexoptNeeded = oat_file_assistant->GetDexOptNeeded(
+      compiler_filter, DexOptTriggerFromAidl(in_dexoptTrigger), &status);
   _aidl_return->isVdexUsable = status.IsVdexUsable();
   _aidl_return->artifactsLocation = ArtifactsLocationToAidl(status.GetLocation());
 
+  if (cache_key.has_value()) {
+    std::lock_guard<std::mutex> lock(dexopt_status_cache_mu_);
+    if (dexopt_needed_cache_.size() >= kMaxDexoptStatusCacheEntries) {
+      dexopt_needed_cache_.clear();
+    }
+    dexopt_needed_cache_.insert_or_assign(std::move(cache_key.value()), *_aidl_return);
+  }
+
   return ScopedAStatus::ok();
 }
 
@@ -958,6 +1022,15 @@ ndk::ScopedAStatus Artd::dexopt(
   // For being surfaced in crash reports on crashes.
   args.Add("--comments=%s", in_dexoptOptions.comments);
 
+  // Compilations at boot can reuse a dex2oat fork server, see `RunDex2oatInForkServer`.
+  bool use_fork_server = ShouldUseDex2oatForkServer(in_priorityClass);
+  std::vector<std::string> fork_server_art_exec_args;
+  std::vector<std::string> dex2oat_args;
+  if (use_fork_server) {
+    fork_server_art_exec_args = art_exec_args.Get();
+    dex2oat_args = args.Get();
+  }
+
   art_exec_args.Add("--keep-fds=%s", fd_logger.GetFds()).Add("--").Concat(std::move(args));
 
   LOG(INFO) << "Running dex2oat: " << Join(art_exec_args.Get(), /*separator=*/" ")
@@ -983,7 +1056,15 @@ ndk::ScopedAStatus Artd::dexopt(
   };
 
   ProcessStat stat;
-  Result<int> result = ExecAndReturnCode(art_exec_args.Get(), kLongTimeoutSec, callbacks, &stat);
+  std::optional<Result<int>> fork_server_result = std::nullopt;
+  if (use_fork_server) {
+    fork_server_result = RunDex2oatInForkServer(
+        fork_server_art_exec_args, dex2oat_args, fd_logger.GetFdList(), callbacks, &stat);
+  }
+  Result<int> result =
+      fork_server_result.has_value() ?
+          std::move(fork_server_result).value() :
+          ExecAndReturnCode(art_exec_args.Get(), kLongTimeoutSec, callbacks, &stat);
   _aidl_return->wallTimeMs = stat.wall_time_ms;
   _aidl_return->cpuTimeMs = stat.cpu_time_ms;
   if (!result.ok()) {
@@ -1120,6 +1201,56 @@ Result<OatFileAssistantContext*> Artd::GetOatFileAssistantContext() {
   return ofa_context_.get();
 }
 
+std::optional<std::string> Artd::GetDexoptStatusCacheKey(
+    const std::string& dex_file,
+    const std::string& instruction_set,
+    const std::optional<std::string>& class_loader_context) {
+  InstructionSet isa = GetInstructionSetFromString(instruction_set.c_str());
+  if (isa == InstructionSet::kNone) {
+    return std::nullopt;
+  }
+
+  // The files that OatFileAssistant checks. The boot image and the boot classpath do not change
+  // while artd is running.
+  std::vector<std::string> paths = {dex_file, GetDmFilename(dex_file)};
+  std::string error_msg;
+  std::string odex_path;
+  if (OatFileAssistant::DexLocationToOdexFilename(dex_file, isa, &odex_path, &error_msg)) {
+    paths.push_back(odex_path);
+    paths.push_back(GetVdexFilename(odex_path));
+  }
+  std::string oat_path;
+  if (OatFileAssistant::DexLocationToOatFilename(
+          dex_file, isa, DenyArtApexDataFiles(), &oat_path, &error_msg)) {
+    paths.push_back(oat_path);
+    paths.push_back(GetVdexFilename(oat_path));
+  }
+  if (class_loader_context.has_value()) {
+    std::unique_ptr<ClassLoaderContext> context =
+        ClassLoaderContext::Create(class_loader_context.value());
+    if (context == nullptr) {
+      return std::nullopt;
+    }
+    // Relative paths are relative to the directory of the dex file, see
+    // `ClassLoaderContext::OpenDexFiles`.
+    std::string dex_dir = Dirname(dex_file);
+    for (const std::string& path : context->FlattenDexPaths()) {
+      paths.push_back(path.empty() || path[0] == '/' ? path : "{}/{}"_format(dex_dir, path));
+    }
+  }
+
+  std::string key =
+      "{}\n{}\n{}\n"_format(dex_file, instruction_set, class_loader_context.value_or("null"));
+  for (const std::string& path : paths) {
+    std::optional<std::string> fingerprint = GetFileFingerprint(path);
+    if (!fingerprint.has_value()) {
+      return std::nullopt;
+    }
+    key += "{}={}\n"_format(path, fingerprint.value());
+  }
+  return key;
+}
+
 Result<const std::vector<std::string>*> Artd::GetBootImageLocations() {
   std::lock_guard<std::mutex> lock(cache_mu_);
 
@@ -1305,6 +1436,52 @@ void Artd::AddPerfConfigFlags(PriorityClass priority_class,
                      "--compile-individually");
 }
 
+bool Artd::ShouldUseDex2oatForkServer(PriorityClass priority_class) {
+  // Only compilations at boot come in bulk and run with the process settings of the fork server:
+  // art_exec sets no task profile or priority for them.
+  return priority_class >= PriorityClass::BOOT && !UseJitZygote() &&
+         props_->GetBool("dalvik.vm.dex2oat-fork-server", /*default_value=*/false);
+}
+
+std::optional<Result<int>> Artd::RunDex2oatInForkServer(
+    const std::vector<std::string>& art_exec_args,
+    const std::vector<std::string>& dex2oat_args,
+    const std::vector<int>& fds,
+    const ExecCallbacks& callbacks,
+    ProcessStat* stat) {
+  std::vector<std::string> server_args = Dex2oatForkServer::GetServerArgs(dex2oat_args);
+  server_args.insert(server_args.begin(), dex2oat_args[0]);
+  std::string key = "{} -- {}"_format(Join(art_exec_args, ' '), Join(server_args, ' '));
+
+  std::unique_ptr<Dex2oatForkServer> server;
+  {
+    std::lock_guard<std::mutex> lock(fork_server_mu_);
+    auto it = idle_fork_servers_.find(key);
+    if (it != idle_fork_servers_.end()) {
+      server = std::move(it->second);
+      idle_fork_servers_.erase(it);
+    }
+  }
+  if (server == nullptr) {
+    Result<std::unique_ptr<Dex2oatForkServer>> new_server =
+        Dex2oatForkServer::Start(exec_utils_.get(), art_exec_args, server_args);
+    if (!new_server.ok()) {
+      LOG(WARNING) << new_server.error().message();
+      return std::nullopt;
+    }
+    server = std::move(new_server).value();
+  }
+
+  std::optional<Result<int>> result =
+      server->Run(dex2oat_args, fds, kLongTimeoutSec, callbacks, stat);
+
+  if (!server->IsBroken() && server->GetNumRequests() < kMaxDex2oatForkServerRequests) {
+    std::lock_guard<std::mutex> lock(fork_server_mu_);
+    idle_fork_servers_.emplace(std::move(key), std::move(server));
+  }
+  return result;
+}
+
 Result<int> Artd::ExecAndReturnCode(const std::vector<std::string>& args,
                                     int timeout_sec,
                                     const ExecCallbacks& callbacks,
@@ -23,6 +23,7 @@
 #include <csignal>
 #include <cstdint>
 #include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -38,6 +39,7 @@
 #include "android-base/thread_annotations.h"
 #include "android/binder_auto_utils.h"
 #include "base/os.h"
+#include "dex2oat_fork_server.h"
 #include "exec_utils.h"
 #include "oat_file_assistant_context.h"
 #include "tools/cmdline_builder.h"
@@ -173,6 +175,14 @@ class Artd : public aidl::com::android::server::art::BnArtd {
   android::base::Result<OatFileAssistantContext*> GetOatFileAssistantContext()
       EXCLUDES(ofa_context_mu_);
 
+  // Returns a key for the cached results of `getDexoptNeeded` and `getDexoptStatus`, made of the
+  // arguments and the fingerprints of the files that the results depend on, or std::nullopt if
+  // the results should not be cached.
+  std::optional<std::string> GetDexoptStatusCacheKey(
+      const std::string& dex_file,
+      const std::string& instruction_set,
+      const std::optional<std::string>& class_loader_context) EXCLUDES(cache_mu_);
+
   android::base::Result<const std::vector<std::string>*> GetBootImageLocations()
       EXCLUDES(cache_mu_);
 
@@ -214,6 +224,18 @@ class Artd : public aidl::com::android::server::art::BnArtd {
                           /*out*/ art::tools::CmdlineBuilder& art_exec_args,
                           /*out*/ art::tools::CmdlineBuilder& args);
 
+  bool ShouldUseDex2oatForkServer(aidl::com::android::server::art::PriorityClass priority_class);
+
+  // Runs dex2oat with `dex2oat_args` in an idle fork server started with `art_exec_args` that can
+  // serve it, starting one if there is none. Returns std::nullopt if the compilation could not be
+  // started that way, in which case it should be run by exec'ing dex2oat.
+  std::optional<android::base::Result<int>> RunDex2oatInForkServer(
+      const std::vector<std::string>& art_exec_args,
+      const std::vector<std::string>& dex2oat_args,
+      const std::vector<int>& fds,
+      const ExecCallbacks& callbacks,
+      /*out*/ ProcessStat* stat) EXCLUDES(fork_server_mu_);
+
   android::base::Result<struct stat> Fstat(const art::File& file) const;
 
   std::mutex cache_mu_;
@@ -226,10 +248,22 @@ class Artd : public aidl::com::android::server::art::BnArtd {
   std::mutex ofa_context_mu_;
   std::unique_ptr<OatFileAssistantContext> ofa_context_ GUARDED_BY(ofa_context_mu_);
 
+  std::mutex dexopt_status_cache_mu_;
+  std::unordered_map<std::string, aidl::com::android::server::art::GetDexoptNeededResult>
+      dexopt_needed_cache_ GUARDED_BY(dexopt_status_cache_mu_);
+  std::unordered_map<std::string, aidl::com::android::server::art::GetDexoptStatusResult>
+      dexopt_status_cache_ GUARDED_BY(dexopt_status_cache_mu_);
+
   const std::unique_ptr<art::tools::SystemProperties> props_;
   const std::unique_ptr<ExecUtils> exec_utils_;
   const std::function<int(pid_t, int)> kill_;
   const std::function<int(int, struct stat*)> fstat_;
+
+  // Declared after `exec_utils_`, which the fork servers use until they are destroyed.
+  std::mutex fork_server_mu_;
+  // Idle dex2oat fork servers, keyed by the command line that started them.
+  std::multimap<std::string, std::unique_ptr<Dex2oatForkServer>> idle_fork_servers_
+      GUARDED_BY(fork_server_mu_);
 };
 
 }  // namespace artd
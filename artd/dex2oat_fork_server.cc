@@ -0,0 +1,284 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dex2oat_fork_server.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "android-base/logging.h"
+#include "android-base/result.h"
+#include "android-base/strings.h"
+#include "android-base/unique_fd.h"
+#include "dex2oat/dex2oat_fork_server.h"
+#include "exec_utils.h"
+#include "fmt/format.h"
+
+namespace art {
+namespace artd {
+
+namespace {
+
+using ::android::base::ErrnoErrorf;
+using ::android::base::Error;
+using ::android::base::Errorf;
+using ::android::base::Result;
+using ::android::base::StartsWith;
+using ::android::base::unique_fd;
+
+using ::fmt::literals::operator""_format;  // NOLINT
+
+using Protocol = ::art::Dex2oatForkServerProtocol;
+
+// Receives a reply. Returns false if no reply has arrived in `timeout_ms`, unless it is negative.
+Result<bool> ReceiveReply(int fd, int timeout_ms, /*out*/ Protocol::Reply* reply) {
+  struct pollfd pfd = {.fd = fd, .events = POLLIN};
+  int poll_ret = TEMP_FAILURE_RETRY(poll(&pfd, /*nfds=*/1, timeout_ms));
+  if (poll_ret < 0) {
+    return ErrnoErrorf("Failed to poll the dex2oat fork server");
+  }
+  if (poll_ret == 0) {
+    return false;
+  }
+  ssize_t size = TEMP_FAILURE_RETRY(recv(fd, reply, sizeof(*reply), /*flags=*/0));
+  if (size < 0) {
+    return ErrnoErrorf("Failed to receive a reply from the dex2oat fork server");
+  }
+  if (static_cast<size_t>(size) != sizeof(*reply)) {
+    return Errorf("Unexpected reply of size {} from the dex2oat fork server", size);
+  }
+  return true;
+}
+
+}  // namespace
+
+Result<std::unique_ptr<Dex2oatForkServer>> Dex2oatForkServer::Start(
+    const ExecUtils* exec_utils,
+    const std::vector<std::string>& art_exec_args,
+    const std::vector<std::string>& server_args) {
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, /*protocol=*/0, fds) != 0) {
+    return ErrnoErrorf("Failed to create a socket pair for the dex2oat fork server");
+  }
+  unique_fd client_fd(fds[0]);
+  unique_fd server_fd(fds[1]);
+  // The server end is passed to the fork server, like the fds passed to dex2oat.
+  if (fcntl(server_fd.get(), F_SETFD, 0) != 0) {
+    return ErrnoErrorf("Failed to clear FD_CLOEXEC for the dex2oat fork server");
+  }
+
+  std::vector<std::string> args = art_exec_args;
+  args.push_back("--keep-fds={}"_format(server_fd.get()));
+  args.push_back("--");
+  args.push_back(server_args[0]);
+  args.push_back("--fork-server-fd={}"_format(server_fd.get()));
+  args.insert(args.end(), server_args.begin() + 1, server_args.end());
+
+  LOG(INFO) << "Starting dex2oat fork server: " << android::base::Join(args, /*separator=*/" ");
+
+  // The fork server runs until the client end of the socket is closed. `ExecAndReturnResult` waits
+  // for it, so it gets its own thread.
+  auto started = std::make_shared<std::promise<bool>>();
+  std::future<bool> started_future = started->get_future();
+  std::thread server_thread(
+      [exec_utils, args = std::move(args), server_fd = std::move(server_fd), started]() mutable {
+        bool notified = false;
+        ExecCallbacks callbacks{
+            .on_start =
+                [&](pid_t) {
+                  server_fd.reset();
+                  started->set_value(true);
+                  notified = true;
+                },
+        };
+        std::string error_msg;
+        ExecResult result = exec_utils->ExecAndReturnResult(
+            args, /*timeout_sec=*/-1, callbacks, /*stat=*/nullptr, &error_msg);
+        if (!notified) {
+          server_fd.reset();
+          started->set_value(false);
+        }
+        if (result.status != ExecResult::kExited) {
+          LOG(ERROR) << "dex2oat fork server failed: " << error_msg;
+        } else if (result.exit_code != 0) {
+          LOG(ERROR) << "dex2oat fork server returned code " << result.exit_code;
+        }
+      });
+  if (!started_future.get()) {
+    server_thread.join();
+    return Error() << "Failed to start the dex2oat fork server";
+  }
+  return std::make_unique<Dex2oatForkServer>(std::move(client_fd), std::move(server_thread));
+}
+
+std::vector<std::string> Dex2oatForkServer::GetServerArgs(
+    const std::vector<std::string>& dex2oat_args) {
+  std::vector<std::string> server_args;
+  for (size_t i = 1; i < dex2oat_args.size(); ++i) {
+    const std::string& arg = dex2oat_args[i];
+    if (StartsWith(arg, "--boot-image=") || StartsWith(arg, "--instruction-set=")) {
+      server_args.push_back(arg);
+    } else if (arg == "--runtime-arg" && i + 1 < dex2oat_args.size()) {
+      const std::string& runtime_arg = dex2oat_args[++i];
+      // Set by the fork server per compilation.
+      if (!StartsWith(runtime_arg, "-Xtarget-sdk-version:") &&
+          !StartsWith(runtime_arg, "-Xhidden-api-policy:")) {
+        server_args.push_back(arg);
+        server_args.push_back(runtime_arg);
+      }
+    }
+  }
+  return server_args;
+}
+
+Dex2oatForkServer::Dex2oatForkServer(unique_fd socket, std::thread server_thread)
+    : socket_(std::move(socket)), server_thread_(std::move(server_thread)) {}
+
+Dex2oatForkServer::~Dex2oatForkServer() {
+  socket_.reset();
+  if (server_thread_.joinable()) {
+    server_thread_.join();
+  }
+}
+
+std::optional<Result<int>> Dex2oatForkServer::Run(const std::vector<std::string>& args,
+                                                  const std::vector<int>& fds,
+                                                  int timeout_sec,
+                                                  const ExecCallbacks& callbacks,
+                                                  /*out*/ ProcessStat* stat) {
+  if (broken_ || fds.size() > Protocol::kMaxRequestFds) {
+    return std::nullopt;
+  }
+
+  Protocol::Request request = {.magic = Protocol::kRequestMagic,
+                               .num_fds = static_cast<uint32_t>(fds.size()),
+                               .num_args = static_cast<uint32_t>(args.size())};
+  std::vector<uint8_t> message(sizeof(request));
+  memcpy(message.data(), &request, sizeof(request));
+  for (int fd : fds) {
+    int32_t target_fd = fd;
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(&target_fd);
+    message.insert(message.end(), data, data + sizeof(target_fd));
+  }
+  for (const std::string& arg : args) {
+    message.insert(message.end(), arg.begin(), arg.end());
+    message.push_back(0u);
+  }
+  if (message.size() > Protocol::kMaxRequestSize) {
+    return std::nullopt;
+  }
+
+  iovec iov = {message.data(), message.size()};
+  msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  std::vector<uint8_t> control(CMSG_SPACE(sizeof(int) * fds.size()));
+  if (!fds.empty()) {
+    msg.msg_control = control.data();
+    msg.msg_controllen = control.size();
+    cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int) * fds.size());
+    memcpy(CMSG_DATA(cmsg), fds.data(), sizeof(int) * fds.size());
+  }
+  if (TEMP_FAILURE_RETRY(sendmsg(socket_.get(), &msg, MSG_NOSIGNAL)) < 0) {
+    PLOG(WARNING) << "Failed to send a request to the dex2oat fork server";
+    broken_ = true;
+    return std::nullopt;
+  }
+
+  auto start_time = std::chrono::steady_clock::now();
+  Protocol::Reply reply;
+  Result<bool> received = ReceiveReply(socket_.get(), /*timeout_ms=*/-1, &reply);
+  if (!received.ok() || reply.type != Protocol::Reply::kStarted) {
+    LOG(WARNING) << "The dex2oat fork server did not start the compilation: "
+                 << (received.ok() ? "Unexpected reply" : received.error().message());
+    broken_ = true;
+    return std::nullopt;
+  }
+  if (reply.pid < 0) {
+    // The fork server rejected the request or failed to fork, but it can serve other requests.
+    return std::nullopt;
+  }
+  pid_t pid = reply.pid;
+  ++num_requests_;
+  callbacks.on_start(pid);
+
+  bool timed_out = false;
+  while (true) {
+    int timeout_ms = -1;
+    if (timeout_sec >= 0 && !timed_out) {
+      auto elapsed = std::chrono::steady_clock::now() - start_time;
+      timeout_ms = static_cast<int>(std::max<int64_t>(
+          0,
+          timeout_sec * INT64_C(1000) -
+              std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()));
+    }
+    received = ReceiveReply(socket_.get(), timeout_ms, &reply);
+    if (!received.ok() || (received.value() && reply.type != Protocol::Reply::kExited)) {
+      // Don't leave the compilation running or the fork server would keep waiting for it.
+      kill(pid, SIGKILL);
+      broken_ = true;
+      callbacks.on_end(pid);
+      return Error() << "Lost the dex2oat fork server while running (" << args[0] << "): "
+                     << (received.ok() ? "Unexpected reply" : received.error().message());
+    }
+    if (received.value()) {
+      break;
+    }
+    kill(pid, SIGKILL);
+    timed_out = true;
+  }
+  callbacks.on_end(pid);
+
+  if (stat != nullptr) {
+    stat->wall_time_ms = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                              std::chrono::steady_clock::now() - start_time)
+                                              .count());
+    stat->cpu_time_ms = reply.cpu_time_ms;
+  }
+
+  if (timed_out) {
+    return Errorf("Failed to execute ({}) because the child process timed out after {}ms",
+                  args[0],
+                  timeout_sec * 1000);
+  }
+  if (!WIFEXITED(reply.wait_status)) {
+    return Errorf("Failed to execute ({}) because the child process is terminated by signal {}",
+                  args[0],
+                  WTERMSIG(reply.wait_status));
+  }
+  return WEXITSTATUS(reply.wait_status);
+}
+
+}  // namespace artd
+}  // namespace art
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_ARTD_DEX2OAT_FORK_SERVER_H_
+#define ART_ARTD_DEX2OAT_FORK_SERVER_H_
+
+#include <sys/types.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "android-base/result.h"
+#include "android-base/unique_fd.h"
+#include "exec_utils.h"
+
+namespace art {
+namespace artd {
+
+// A dex2oat process that keeps a runtime created for compiling apps against the boot image and
+// forks a child running dex2oat for each compilation sent to it, so that the compilations don't
+// pay for creating the runtime and mapping the boot image. See
+// dex2oat/include/dex2oat/dex2oat_fork_server.h for the protocol.
+//
+// Every compilation runs in its own child process, so nothing of a compilation stays in memory
+// after it is done. A fork server serves one compilation at a time. This class is
+// thread-compatible.
+class Dex2oatForkServer {
+ public:
+  // Starts a fork server by running `art_exec_args`, followed by the arguments that keep the socket
+  // fd, and then `server_args`, which must start with the path to dex2oat.
+  static android::base::Result<std::unique_ptr<Dex2oatForkServer>> Start(
+      const ExecUtils* exec_utils,
+      const std::vector<std::string>& art_exec_args,
+      const std::vector<std::string>& server_args);
+
+  // Returns the arguments of a fork server that can serve the compilation with `dex2oat_args`, not
+  // including the path to dex2oat.
+  static std::vector<std::string> GetServerArgs(const std::vector<std::string>& dex2oat_args);
+
+  // Uses a fork server reachable through `socket`. `server_thread`, if joinable, is joined on
+  // destruction.
+  explicit Dex2oatForkServer(android::base::unique_fd socket,
+                             std::thread server_thread = std::thread());
+
+  // Closes the socket, which makes the fork server exit.
+  ~Dex2oatForkServer();
+
+  Dex2oatForkServer(const Dex2oatForkServer&) = delete;
+  Dex2oatForkServer& operator=(const Dex2oatForkServer&) = delete;
+
+  // Runs dex2oat with `args`, which start with the path to dex2oat, in a child of the fork server.
+  // `fds` are the fds that `args` refer to, the child gets them at the same fd numbers. Behaves
+  // like `ExecUtils::ExecAndReturnResult` otherwise, and returns the exit code of dex2oat. Returns
+  // std::nullopt if the compilation could not be started, in which case the caller may run dex2oat
+  // without the fork server.
+  std::optional<android::base::Result<int>> Run(const std::vector<std::string>& args,
+                                                const std::vector<int>& fds,
+                                                int timeout_sec,
+                                                const ExecCallbacks& callbacks,
+                                                /*out*/ ProcessStat* stat);
+
+  // Returns true if the connection to the fork server is lost, in which case it must not be used
+  // anymore.
+  bool IsBroken() const { return broken_; }
+
+  // Returns the number of compilations started by the fork server.
+  size_t GetNumRequests() const { return num_requests_; }
+
+ private:
+  android::base::unique_fd socket_;
+  std::thread server_thread_;
+  bool broken_ = false;
+  size_t num_requests_ = 0;
+};
+
+}  // namespace artd
+}  // namespace art
+
+#endif  // ART_ARTD_DEX2OAT_FORK_SERVER_H_
@@ -0,0 +1,238 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dex2oat_fork_server.h"
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <csignal>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "android-base/result-gmock.h"
+#include "android-base/result.h"
+#include "android-base/unique_fd.h"
+#include "base/common_art_test.h"
+#include "dex2oat/dex2oat_fork_server.h"
+#include "exec_utils.h"
+#include "fmt/format.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace art {
+namespace artd {
+namespace {
+
+using ::android::base::Result;
+using ::android::base::unique_fd;
+using ::android::base::testing::HasError;
+using ::android::base::testing::HasValue;
+using ::android::base::testing::WithMessage;
+using ::testing::ContainsRegex;
+using ::testing::ElementsAre;
+
+using ::fmt::literals::operator""_format;  // NOLINT
+
+using Protocol = ::art::Dex2oatForkServerProtocol;
+
+struct ReceivedRequest {
+  Protocol::Request header;
+  std::vector<int32_t> target_fds;
+  std::vector<std::string> args;
+  std::vector<unique_fd> fds;
+};
+
+ReceivedRequest ReceiveRequest(int socket) {
+  std::vector<uint8_t> buffer(Protocol::kMaxRequestSize);
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * Protocol::kMaxRequestFds)];
+  iovec iov = {buffer.data(), buffer.size()};
+  msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  ssize_t size = TEMP_FAILURE_RETRY(recvmsg(socket, &msg, MSG_CMSG_CLOEXEC));
+  CHECK_GE(size, static_cast<ssize_t>(sizeof(Protocol::Request)));
+
+  ReceivedRequest request;
+  memcpy(&request.header, buffer.data(), sizeof(request.header));
+  const uint8_t* data = buffer.data() + sizeof(request.header);
+  for (size_t i = 0; i != request.header.num_fds; ++i) {
+    int32_t target_fd;
+    memcpy(&target_fd, data, sizeof(target_fd));
+    request.target_fds.push_back(target_fd);
+    data += sizeof(target_fd);
+  }
+  const char* arg = reinterpret_cast<const char*>(data);
+  const char* end = reinterpret_cast<const char*>(buffer.data()) + size;
+  for (; arg != end; arg += strlen(arg) + 1) {
+    request.args.push_back(arg);
+  }
+  for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+    size_t num_fds = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+    const int* fds = reinterpret_cast<const int*>(CMSG_DATA(cmsg));
+    for (size_t i = 0; i != num_fds; ++i) {
+      request.fds.emplace_back(fds[i]);
+    }
+  }
+  return request;
+}
+
+void SendReply(int socket, Protocol::Reply::Type type, pid_t pid, int wait_status = 0) {
+  Protocol::Reply reply = {
+      .type = type, .pid = pid, .wait_status = wait_status, .cpu_time_ms = 10};
+  CHECK_EQ(TEMP_FAILURE_RETRY(send(socket, &reply, sizeof(reply), MSG_NOSIGNAL)),
+           static_cast<ssize_t>(sizeof(reply)));
+}
+
+class Dex2oatForkServerTest : public CommonArtTest {
+ protected:
+  void SetUp() override {
+    CommonArtTest::SetUp();
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, /*protocol=*/0, fds), 0);
+    client_socket_.reset(fds[0]);
+    server_socket_.reset(fds[1]);
+    scratch_file_ = std::make_unique<ScratchFile>();
+  }
+
+  void TearDown() override {
+    scratch_file_.reset();
+    CommonArtTest::TearDown();
+  }
+
+  unique_fd client_socket_;
+  unique_fd server_socket_;
+  std::unique_ptr<ScratchFile> scratch_file_;
+};
+
+TEST_F(Dex2oatForkServerTest, GetServerArgs) {
+  EXPECT_THAT(Dex2oatForkServer::GetServerArgs({"/apex/com.android.art/bin/dex2oat64",
+                                                 "--zip-fd=3",
+                                                 "--boot-image=/system/framework/boot.art",
+                                                 "--instruction-set=riscv64",
+                                                 "--instruction-set-features=default",
+                                                 "--runtime-arg",
+                                                 "-Xdeny-art-apex-data-files",
+                                                 "--runtime-arg",
+                                                 "-Xtarget-sdk-version:34",
+                                                 "--runtime-arg",
+                                                 "-Xhidden-api-policy:enabled",
+                                                 "--runtime-arg",
+                                                 "-Xmx512m"}),
+              ElementsAre("--boot-image=/system/framework/boot.art",
+                          "--instruction-set=riscv64",
+                          "--runtime-arg",
+                          "-Xdeny-art-apex-data-files",
+                          "--runtime-arg",
+                          "-Xmx512m"));
+}
+
+TEST_F(Dex2oatForkServerTest, Run) {
+  int fd = scratch_file_->GetFd();
+  std::thread server_thread([&]() {
+    ReceivedRequest request = ReceiveRequest(server_socket_.get());
+    EXPECT_EQ(request.header.magic, Protocol::kRequestMagic);
+    EXPECT_THAT(request.args, ElementsAre("dex2oat", "--zip-fd={}"_format(fd)));
+    EXPECT_THAT(request.target_fds, ElementsAre(fd));
+    ASSERT_EQ(request.fds.size(), 1u);
+    struct stat expected_st, actual_st;
+    ASSERT_EQ(fstat(fd, &expected_st), 0);
+    ASSERT_EQ(fstat(request.fds[0].get(), &actual_st), 0);
+    EXPECT_EQ(expected_st.st_ino, actual_st.st_ino);
+    SendReply(server_socket_.get(), Protocol::Reply::kStarted, /*pid=*/12345);
+    SendReply(
+        server_socket_.get(), Protocol::Reply::kExited, /*pid=*/12345, /*wait_status=*/3 << 8);
+  });
+
+  Dex2oatForkServer server(std::move(client_socket_));
+  std::vector<pid_t> started_pids;
+  std::vector<pid_t> ended_pids;
+  ExecCallbacks callbacks{
+      .on_start = [&](pid_t pid) { started_pids.push_back(pid); },
+      .on_end = [&](pid_t pid) { ended_pids.push_back(pid); },
+  };
+  ProcessStat stat;
+  std::optional<Result<int>> result = server.Run({"dex2oat", "--zip-fd={}"_format(fd)},
+                                                 {fd},
+                                                 /*timeout_sec=*/-1,
+                                                 callbacks,
+                                                 &stat);
+  server_thread.join();
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_THAT(result.value(), HasValue(3));
+  EXPECT_THAT(started_pids, ElementsAre(12345));
+  EXPECT_THAT(ended_pids, ElementsAre(12345));
+  EXPECT_EQ(stat.cpu_time_ms, 10);
+  EXPECT_FALSE(server.IsBroken());
+  EXPECT_EQ(server.GetNumRequests(), 1u);
+}
+
+TEST_F(Dex2oatForkServerTest, RunSignaled) {
+  std::thread server_thread([&]() {
+    ReceiveRequest(server_socket_.get());
+    SendReply(server_socket_.get(), Protocol::Reply::kStarted, /*pid=*/12345);
+    SendReply(server_socket_.get(), Protocol::Reply::kExited, /*pid=*/12345, SIGKILL);
+  });
+
+  Dex2oatForkServer server(std::move(client_socket_));
+  std::optional<Result<int>> result =
+      server.Run({"dex2oat"}, {}, /*timeout_sec=*/-1, ExecCallbacks(), /*stat=*/nullptr);
+  server_thread.join();
+
+  ASSERT_TRUE(result.has_value());
+  EXPECT_THAT(result.value(), HasError(WithMessage(ContainsRegex("terminated by signal 9"))));
+  EXPECT_FALSE(server.IsBroken());
+}
+
+TEST_F(Dex2oatForkServerTest, RunRejected) {
+  std::thread server_thread([&]() {
+    ReceiveRequest(server_socket_.get());
+    SendReply(server_socket_.get(), Protocol::Reply::kStarted, /*pid=*/-1);
+  });
+
+  Dex2oatForkServer server(std::move(client_socket_));
+  std::optional<Result<int>> result =
+      server.Run({"dex2oat"}, {}, /*timeout_sec=*/-1, ExecCallbacks(), /*stat=*/nullptr);
+  server_thread.join();
+
+  // A rejected request does not make the fork server unusable.
+  EXPECT_FALSE(result.has_value());
+  EXPECT_FALSE(server.IsBroken());
+  EXPECT_EQ(server.GetNumRequests(), 0u);
+}
+
+TEST_F(Dex2oatForkServerTest, RunServerGone) {
+  server_socket_.reset();
+
+  Dex2oatForkServer server(std::move(client_socket_));
+  std::optional<Result<int>> result =
+      server.Run({"dex2oat"}, {}, /*timeout_sec=*/-1, ExecCallbacks(), /*stat=*/nullptr);
+
+  EXPECT_FALSE(result.has_value());
+  EXPECT_TRUE(server.IsBroken());
+}
+
+}  // namespace
+}  // namespace artd
+}  // namespace art
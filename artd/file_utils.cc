@@ -17,19 +17,25 @@
 #include "file_utils.h"
 
 #include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <cerrno>
 #include <filesystem>
 #include <memory>
 #include <string>
 #include <string_view>
 #include <system_error>
+#include <unordered_set>
 #include <utility>
 
 #include "aidl/com/android/server/art/FsPermission.h"
 #include "android-base/errors.h"
+#include "android-base/file.h"
 #include "android-base/logging.h"
 #include "android-base/result.h"
 #include "android-base/scopeguard.h"
@@ -44,7 +50,9 @@ namespace {
 
 using ::aidl::com::android::server::art::FsPermission;
 using ::android::base::make_scope_guard;
+using ::android::base::ReadFdToString;
 using ::android::base::Result;
+using ::android::base::WriteStringToFd;
 
 using ::fmt::literals::operator""_format;  // NOLINT
 
@@ -56,6 +64,32 @@ void UnlinkIfExists(const std::string& path) {
   }
 }
 
+// Makes the renames in the given directories durable. Renaming files into a directory only needs
+// one fsync of the directory, however many files are committed.
+void SyncDirectories(const std::vector<NewFile*>& committed_files) {
+  std::unordered_set<std::string> dirs;
+  for (const NewFile* file : committed_files) {
+    dirs.insert(std::filesystem::path(file->FinalPath()).parent_path().string());
+  }
+  for (const std::string& dir : dirs) {
+    int fd = open(dir.empty() ? "." : dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0 || fsync(fd) != 0) {
+      // The files are committed. They are written again if they are lost on a crash.
+      PLOG(WARNING) << "Failed to sync directory '" << dir << "'";
+    }
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+}
+
+// Returns true if `copy_file_range` cannot copy between the files, as opposed to an I/O error.
+bool IsCopyFileRangeUnsupported(int error) {
+  // ENOSYS: Kernels before 4.5. EXDEV: Different filesystems before 5.3. EINVAL, EOPNOTSUPP:
+  // Filesystems or file types that do not support it.
+  return error == ENOSYS || error == EXDEV || error == EINVAL || error == EOPNOTSUPP;
+}
+
 }  // namespace
 
 Result<std::unique_ptr<NewFile>> NewFile::Create(const std::string& path,
@@ -195,6 +229,8 @@ Result<void> NewFile::CommitAllOrAbandon(const std::vector<NewFile*>& files_to_c
 
   cleanup.Disable();
 
+  SyncDirectories(files_to_commit);
+
   // Clean up old files.
   for (const auto& [original_path, temp_path] : moved_files) {
     // This should never fail.  We were able to move the file to `temp_path`. We should be able to
@@ -217,6 +253,48 @@ Result<std::unique_ptr<File>> OpenFileForReading(const std::string& path) {
   return file;
 }
 
+Result<void> CopyFileContents(const std::string& src_path, const NewFile& dst_file) {
+  std::unique_ptr<File> src_file = OR_RETURN(OpenFileForReading(src_path));
+
+  // Share the extents of the source file, e.g., on btrfs and XFS.
+  if (ioctl(dst_file.Fd(), FICLONE, src_file->Fd()) == 0) {
+    return {};
+  }
+
+  // Let the kernel copy the data, e.g., on f2fs and ext4. Not all C libraries that artd is built
+  // against have the wrapper.
+  constexpr size_t kMaxCopySize = 1u << 30;
+  bool copied_any = false;
+  while (true) {
+    ssize_t copied = TEMP_FAILURE_RETRY(syscall(__NR_copy_file_range,
+                                                src_file->Fd(),
+                                                /*off_in=*/nullptr,
+                                                dst_file.Fd(),
+                                                /*off_out=*/nullptr,
+                                                kMaxCopySize,
+                                                /*flags=*/0u));
+    if (copied == 0) {
+      return {};
+    }
+    if (copied < 0) {
+      if (!copied_any && IsCopyFileRangeUnsupported(errno)) {
+        break;
+      }
+      return ErrnoErrorf("Failed to copy file '{}' to '{}'", src_path, dst_file.TempPath());
+    }
+    copied_any = true;
+  }
+
+  std::string content;
+  if (!ReadFdToString(src_file->Fd(), &content)) {
+    return ErrnoErrorf("Failed to read file '{}'", src_path);
+  }
+  if (!WriteStringToFd(content, dst_file.Fd())) {
+    return ErrnoErrorf("Failed to write file '{}'", dst_file.TempPath());
+  }
+  return {};
+}
+
 mode_t FileFsPermissionToMode(const FsPermission& fs_permission) {
   return S_IRUSR | S_IWUSR | S_IRGRP | (fs_permission.isOtherReadable ? S_IROTH : 0) |
          (fs_permission.isOtherExecutable ? S_IXOTH : 0);
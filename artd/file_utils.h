@@ -119,6 +119,11 @@ class NewFile {
 // Opens a file for reading.
 android::base::Result<std::unique_ptr<File>> OpenFileForReading(const std::string& path);
 
+// Copies the content of the file at `src_path` to the new file, which must be empty. The data is
+// not copied through user space if the filesystem supports it: the extents are shared if the
+// filesystem supports reflinks, or the data is copied by the kernel otherwise.
+android::base::Result<void> CopyFileContents(const std::string& src_path, const NewFile& dst_file);
+
 // Converts FsPermission to Linux access mode for a file.
 mode_t FileFsPermissionToMode(const aidl::com::android::server::art::FsPermission& fs_permission);
 
@@ -325,6 +325,29 @@ TEST_F(FileUtilsTest, OpenFileForReadingFailed) {
               HasError(WithMessage(ContainsRegex("Failed to open file .*/foo"))));
 }
 
+TEST_F(FileUtilsTest, CopyFileContents) {
+  std::string src_path = scratch_dir_->GetPath() + "/src";
+  std::string content(100000, 'a');
+  content += "end";
+  ASSERT_TRUE(WriteStringToFile(content, src_path));
+  std::string dst_path = scratch_dir_->GetPath() + "/dst";
+  std::unique_ptr<NewFile> dst_file = OR_FATAL(NewFile::Create(dst_path, fs_permission_));
+
+  ASSERT_THAT(CopyFileContents(src_path, *dst_file), Ok());
+  ASSERT_THAT(dst_file->CommitOrAbandon(), Ok());
+
+  CheckContent(dst_path, content);
+}
+
+TEST_F(FileUtilsTest, CopyFileContentsFailed) {
+  std::string src_path = scratch_dir_->GetPath() + "/src";
+  std::string dst_path = scratch_dir_->GetPath() + "/dst";
+  std::unique_ptr<NewFile> dst_file = OR_FATAL(NewFile::Create(dst_path, fs_permission_));
+
+  EXPECT_THAT(CopyFileContents(src_path, *dst_file),
+              HasError(WithMessage(ContainsRegex("Failed to open file .*/src"))));
+}
+
 TEST_F(FileUtilsTest, FileFsPermissionToMode) {
   EXPECT_EQ(FileFsPermissionToMode(FsPermission{}), S_IRUSR | S_IWUSR | S_IRGRP);
   EXPECT_EQ(FileFsPermissionToMode(FsPermission{.isOtherReadable = true}),
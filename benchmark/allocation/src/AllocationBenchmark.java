@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class AllocationBenchmark {
+    static class Small {
+        int value;
+    }
+
+    static class Medium {
+        long l0, l1, l2, l3, l4, l5, l6, l7;
+        Object o0, o1;
+    }
+
+    static class WithFinalizer {
+        @Override
+        protected void finalize() {}
+    }
+
+    // Keep the last allocated object reachable so that the allocations are not eliminated.
+    public static Object sink;
+
+    public void timeAllocSmallObject(int count) {
+        Object last = null;
+        for (int i = 0; i < count; ++i) {
+            Small s = new Small();
+            s.value = i;
+            last = s;
+        }
+        sink = last;
+    }
+
+    public void timeAllocMediumObject(int count) {
+        Object last = null;
+        for (int i = 0; i < count; ++i) {
+            last = new Medium();
+        }
+        sink = last;
+    }
+
+    public void timeAllocObjectWithFinalizer(int count) {
+        Object last = null;
+        for (int i = 0; i < count; ++i) {
+            last = new WithFinalizer();
+        }
+        sink = last;
+    }
+
+    public void timeAllocIntArray16(int count) {
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            int[] array = new int[16];
+            sum += array.length;
+            sink = array;
+        }
+        if (sum != count * 16) {
+            throw new AssertionError();
+        }
+    }
+
+    public void timeAllocByteArray4K(int count) {
+        for (int i = 0; i < count; ++i) {
+            sink = new byte[4096];
+        }
+    }
+
+    public void timeAllocObjectArray64(int count) {
+        for (int i = 0; i < count; ++i) {
+            sink = new Object[64];
+        }
+    }
+
+    public void timeAllocString(int count) {
+        char[] chars = { 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h' };
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            String s = new String(chars);
+            sum += s.length();
+            sink = s;
+        }
+        if (sum != count * chars.length) {
+            throw new AssertionError();
+        }
+    }
+
+    public void timeAllocLargeObject(int count) {
+        // Above the large object space threshold.
+        for (int i = 0; i < count; ++i) {
+            sink = new byte[64 * 1024];
+        }
+    }
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.reflect.Constructor;
+
+public class ClassLoadingBenchmark {
+    // Loaded in fresh class loaders; they are not used anywhere else.
+    static class Loaded1 {}
+    static class Loaded2 extends Loaded1 {}
+    static class Loaded3 extends Loaded2 implements Runnable {
+        public void run() {}
+    }
+
+    private static final String[] classNames = {
+        "ClassLoadingBenchmark$Loaded1",
+        "ClassLoadingBenchmark$Loaded2",
+        "ClassLoadingBenchmark$Loaded3",
+    };
+
+    private final String classPath;
+    private final Constructor<?> pathClassLoaderConstructor;
+
+    public ClassLoadingBenchmark() throws Exception {
+        classPath = System.getProperty("java.class.path");
+        pathClassLoaderConstructor = Class.forName("dalvik.system.PathClassLoader")
+                .getConstructor(String.class, ClassLoader.class);
+    }
+
+    private ClassLoader newClassLoader() throws Exception {
+        return (ClassLoader) pathClassLoaderConstructor.newInstance(
+                classPath, Object.class.getClassLoader());
+    }
+
+    // Class loader creation, including opening the already mapped dex file.
+    public void timeCreateClassLoader(int count) throws Exception {
+        for (int i = 0; i < count; ++i) {
+            newClassLoader();
+        }
+    }
+
+    // Loading, linking and initializing a small class hierarchy in a new class loader.
+    public void timeLoadClassesInNewLoader(int count) throws Exception {
+        for (int i = 0; i < count; ++i) {
+            ClassLoader loader = newClassLoader();
+            for (String name : classNames) {
+                Class.forName(name, /* initialize= */ true, loader);
+            }
+        }
+    }
+
+    // Lookups of classes that are already loaded, in the boot class loader and in the
+    // class table of the application class loader.
+    public void timeForNameLoaded(int count) throws Exception {
+        ClassLoader loader = ClassLoadingBenchmark.class.getClassLoader();
+        for (int i = 0; i < count; ++i) {
+            Class.forName("java.util.ArrayList", /* initialize= */ false, loader);
+            Class.forName(classNames[i % classNames.length], /* initialize= */ false, loader);
+        }
+    }
+
+    // Lookups that miss in every class loader.
+    public void timeForNameMissing(int count) throws Exception {
+        ClassLoader loader = ClassLoadingBenchmark.class.getClassLoader();
+        for (int i = 0; i < count; ++i) {
+            try {
+                Class.forName("com.example.DoesNotExist", /* initialize= */ false, loader);
+                throw new AssertionError();
+            } catch (ClassNotFoundException expected) {
+            }
+        }
+    }
+}
@@ -0,0 +1,272 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2023 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Compares the code generated by the optimizing compiler for several instruction sets.
+
+Build dex2oat and the target boot image of a product for each instruction set, then from the
+top of the tree, for example:
+
+  art/benchmark/codegen-quality/run-codegen-quality.py \\
+      --product-out=arm64=out/target/product/generic_arm64 \\
+      --product-out=riscv64=out/target/product/generic_riscv64 --output=codegen.json
+  art/benchmark/codegen-quality/run-codegen-quality.py ... --device=arm64=SERIAL1 \\
+      --device=riscv64=SERIAL2 --baseline=codegen.json
+
+Each corpus file, by default framework.jar of the first product, is compiled once for each
+instruction set with --dump-code-quality, using the command line of
+art/benchmark/dex2oat/run-dex2oat-benchmark.py. The methods compiled for all instruction sets
+are compared with the first one: the totals of the code size, native instructions, spills and
+stack map sizes, and the methods whose code grew the most. With --device, the ART benchmarks
+also run on a device of each instruction set with art/benchmark/run-benchmarks.py. With
+--baseline, the script fails if a total of any instruction set regressed by more than the
+threshold. Options that are not recognized here are passed to dex2oat.
+"""
+
+import argparse
+import importlib.util
+import json
+import os
+import subprocess
+import sys
+import tempfile
+import types
+
+BENCHMARK_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+
+# The totals checked against the baseline, for which smaller is better.
+REGRESSION_METRICS = ['code_size', 'native_instructions', 'spill_stores', 'spill_loads',
+                      'stack_map_size']
+
+def parse_args():
+  parser = argparse.ArgumentParser(description='Compare the generated code of several ISAs.')
+  parser.add_argument('--dex2oat', default=os.path.expandvars('$ANDROID_HOST_OUT/bin/dex2oat64'),
+                      help='The dex2oat to use, by default the release dex2oat64.')
+  parser.add_argument('--archs', default='arm64,riscv64',
+                      help='Comma-separated instruction sets, compared with the first one.')
+  parser.add_argument('--product-out', action='append', default=[], metavar='ARCH=DIR',
+                      help='The product with the boot image for ARCH, can be repeated. '
+                           'Default: $ANDROID_PRODUCT_OUT.')
+  parser.add_argument('--corpus', action='append', default=[],
+                      help='A jar or apk to compile, can be repeated. Default: framework.jar.')
+  parser.add_argument('--compiler-filter', default='speed', help='The compiler filter to use.')
+  parser.add_argument('--threads', type=int, default=os.cpu_count(),
+                      help='The dex2oat thread count.')
+  parser.add_argument('--worst-methods', type=int, default=20,
+                      help='The number of methods with the largest code growth to report.')
+  parser.add_argument('--device', action='append', default=[], metavar='ARCH=SERIAL',
+                      help='Run the ART benchmarks on the device SERIAL for ARCH.')
+  parser.add_argument('--benchmark-modes', default='aot,jit',
+                      help='The modes of run-benchmarks.py, default aot,jit.')
+  parser.add_argument('--benchmark-filter', help='Only run benchmarks matching this regex.')
+  parser.add_argument('--output', help='Write the results to this JSON file.')
+  parser.add_argument('--baseline', help='Compare the results with this JSON file.')
+  parser.add_argument('--threshold', type=float, default=1.0,
+                      help='Regression threshold in percent for --baseline, default 1.')
+  return parser.parse_known_args()
+
+def parse_arch_map(values, option):
+  result = {}
+  for value in values:
+    arch, separator, setting = value.partition('=')
+    if not separator:
+      sys.exit('Expected %s=ARCH=VALUE, got %s' % (option, value))
+    result[arch] = setting
+  return result
+
+def load_dex2oat_benchmark():
+  """Imports run-dex2oat-benchmark.py, which has the dex2oat command line of a corpus file."""
+  spec = importlib.util.spec_from_file_location(
+      'run_dex2oat_benchmark', os.path.join(BENCHMARK_DIR, 'dex2oat', 'run-dex2oat-benchmark.py'))
+  module = importlib.util.module_from_spec(spec)
+  spec.loader.exec_module(module)
+  return module
+
+def compile_corpus(args, arch, product_out, corpus_file, dex2oat_args):
+  """Compiles `corpus_file` for `arch` and returns its --dump-code-quality report."""
+  dex2oat_benchmark = load_dex2oat_benchmark()
+  os.environ['ANDROID_PRODUCT_OUT'] = product_out
+  with tempfile.TemporaryDirectory() as tmp_dir:
+    report_file = os.path.join(tmp_dir, 'code-quality.json')
+    command_args = types.SimpleNamespace(dex2oat=args.dex2oat,
+                                         arch=arch,
+                                         compiler_filter=args.compiler_filter,
+                                         threads=args.threads,
+                                         slowest_methods=0)
+    command = dex2oat_benchmark.dex2oat_command(
+        command_args, corpus_file, tmp_dir, dex2oat_args + ['--dump-code-quality=' + report_file])
+    print('Compiling %s for %s' % (os.path.basename(corpus_file), arch), file=sys.stderr)
+    dex2oat_benchmark.run_dex2oat(command)
+    with open(report_file) as f:
+      return json.load(f)
+
+def sum_totals(method_stats):
+  totals = {}
+  for stats in method_stats:
+    for key, value in stats.items():
+      totals[key] = totals.get(key, 0) + value
+  return totals
+
+def ratio(value, reference):
+  return value / reference if reference else None
+
+def compare_reports(archs, reports, worst_methods):
+  """Compares the methods compiled for all `archs` with the first arch."""
+  reference_arch = archs[0]
+  methods_by_arch = {
+    arch: {stats.pop('method'): stats for stats in reports[arch]['method_stats']}
+    for arch in archs
+  }
+  common_methods = sorted(set.intersection(*(set(methods) for methods in
+                                             methods_by_arch.values())))
+  result = {'reference': reference_arch, 'common_methods': len(common_methods), 'archs': {}}
+  reference_totals = sum_totals(methods_by_arch[reference_arch][m] for m in common_methods)
+  for arch in archs:
+    methods = methods_by_arch[arch]
+    totals = sum_totals(methods[m] for m in common_methods)
+    arch_result = {
+      'compiled_methods': reports[arch]['methods'],
+      'totals': totals,
+      'ratios': {key: ratio(value, reference_totals.get(key)) for key, value in totals.items()},
+    }
+    if arch != reference_arch:
+      reference_methods = methods_by_arch[reference_arch]
+      growth = sorted(common_methods,
+                      key=lambda m: methods[m]['code_size'] - reference_methods[m]['code_size'],
+                      reverse=True)
+      arch_result['worst_methods'] = [
+        {'method': m, reference_arch: reference_methods[m], arch: methods[m]}
+        for m in growth[:worst_methods]
+      ]
+    result['archs'][arch] = arch_result
+  result['method_stats'] = {
+    m: {arch: methods_by_arch[arch][m] for arch in archs} for m in common_methods
+  }
+  return result
+
+def run_benchmarks(args, arch, serial):
+  """Runs run-benchmarks.py on the device `serial` and returns its results."""
+  with tempfile.TemporaryDirectory() as tmp_dir:
+    output = os.path.join(tmp_dir, 'benchmarks.json')
+    command = [sys.executable, os.path.join(BENCHMARK_DIR, 'run-benchmarks.py'),
+               '--isa=' + arch, '--modes=' + args.benchmark_modes, '--output=' + output]
+    if args.benchmark_filter:
+      command.append('--filter=' + args.benchmark_filter)
+    print('Running the benchmarks for %s on %s' % (arch, serial), file=sys.stderr)
+    subprocess.run(command, check=True, env=dict(os.environ, ANDROID_SERIAL=serial))
+    with open(output) as f:
+      return json.load(f)['results']
+
+def compare_benchmarks(archs, benchmarks):
+  """Returns the time of each benchmark relative to the first arch that ran it."""
+  archs = [arch for arch in archs if arch in benchmarks]
+  if len(archs) < 2:
+    return []
+  reference = {(r['benchmark'], r['mode']): r['ns_per_op'] for r in benchmarks[archs[0]]}
+  comparisons = []
+  for arch in archs[1:]:
+    for r in benchmarks[arch]:
+      reference_ns = reference.get((r['benchmark'], r['mode']))
+      if reference_ns:
+        comparisons.append({'benchmark': r['benchmark'], 'mode': r['mode'], 'arch': arch,
+                            'ratio': ratio(r['ns_per_op'], reference_ns)})
+  return comparisons
+
+def print_result(corpus_file, comparison):
+  print('%s: %d methods compiled for all archs' %
+        (os.path.basename(corpus_file), comparison['common_methods']))
+  print('  %-10s %12s %12s %10s %10s %12s' %
+        ('arch', 'code_size', 'insns', 'spill_st', 'spill_ld', 'stack_maps'))
+  for arch, arch_result in comparison['archs'].items():
+    totals = arch_result['totals']
+    print('  %-10s %12d %12s %10d %10d %12d' %
+          (arch, totals['code_size'], totals.get('native_instructions', '-'),
+           totals['spill_stores'], totals['spill_loads'], totals['stack_map_size']))
+  for arch, arch_result in comparison['archs'].items():
+    for method in arch_result.get('worst_methods', [])[:10]:
+      print('  %-80s %8d -> %8d' % (method['method'][:80],
+                                    method[comparison['reference']]['code_size'],
+                                    method[arch]['code_size']))
+
+def compare_with_baseline(results, baseline, threshold):
+  """Prints the changes of the totals from the baseline and returns the number of
+  regressions."""
+  baseline_results = {r['corpus']: r for r in baseline['code_quality']}
+  regressions = 0
+  for result in results['code_quality']:
+    base = baseline_results.get(result['corpus'])
+    if base is None:
+      continue
+    for arch, arch_result in result['archs'].items():
+      base_arch = base['archs'].get(arch)
+      if base_arch is None:
+        continue
+      for metric in REGRESSION_METRICS:
+        value = arch_result['totals'].get(metric)
+        base_value = base_arch['totals'].get(metric)
+        if not value or not base_value:
+          continue
+        change = (value / base_value - 1.0) * 100.0
+        marker = ''
+        if change > threshold:
+          marker = '  REGRESSION'
+          regressions += 1
+        print('%-30s %-10s %-20s %+6.2f%%%s' % (result['corpus'], arch, metric, change, marker))
+  return regressions
+
+def main():
+  args, dex2oat_args = parse_args()
+  archs = args.archs.split(',')
+  product_outs = parse_arch_map(args.product_out, '--product-out')
+  for arch in archs:
+    if arch not in product_outs:
+      if 'ANDROID_PRODUCT_OUT' not in os.environ:
+        sys.exit('Specify --product-out=%s=DIR or set ANDROID_PRODUCT_OUT.' % arch)
+      product_outs[arch] = os.environ['ANDROID_PRODUCT_OUT']
+  corpus = args.corpus or [
+    os.path.join(product_outs[archs[0]], 'system', 'framework', 'framework.jar')
+  ]
+
+  results = {'archs': archs, 'compiler_filter': args.compiler_filter, 'code_quality': []}
+  for corpus_file in corpus:
+    reports = {arch: compile_corpus(args, arch, product_outs[arch], corpus_file, dex2oat_args)
+               for arch in archs}
+    comparison = compare_reports(archs, reports, args.worst_methods)
+    comparison['corpus'] = os.path.basename(corpus_file)
+    print_result(corpus_file, comparison)
+    results['code_quality'].append(comparison)
+
+  devices = parse_arch_map(args.device, '--device')
+  if devices:
+    benchmarks = {arch: run_benchmarks(args, arch, devices[arch])
+                  for arch in archs if arch in devices}
+    results['benchmarks'] = benchmarks
+    results['benchmark_ratios'] = compare_benchmarks(archs, benchmarks)
+    for comparison in results['benchmark_ratios']:
+      print('%-10s %-8s %-60s %6.2fx' % (comparison['arch'], comparison['mode'],
+                                        comparison['benchmark'], comparison['ratio']))
+
+  if args.output:
+    with open(args.output, 'w') as f:
+      json.dump(results, f, indent=2)
+  if args.baseline:
+    with open(args.baseline) as f:
+      baseline = json.load(f)
+    regressions = compare_with_baseline(results, baseline, args.threshold)
+    if regressions != 0:
+      sys.exit('%d total(s) regressed by more than %.1f%%' % (regressions, args.threshold))
+
+if __name__ == '__main__':
+  main()
@@ -0,0 +1,200 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2023 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Measures the compile time of host dex2oat on a fixed corpus.
+
+Build dex2oat and the target boot image (`m dex2oat64 droid`), then from the top of the tree,
+for example:
+
+  art/benchmark/dex2oat/run-dex2oat-benchmark.py --arch=riscv64 --output=dex2oat.json
+  art/benchmark/dex2oat/run-dex2oat-benchmark.py --arch=riscv64 --corpus=Maps.apk \\
+      --baseline=dex2oat.json
+
+Each corpus file, by default framework.jar from $ANDROID_PRODUCT_OUT, is compiled --repeat
+times with the boot class path that art/tools/compile-jar.py finds for the target. The median
+wall and CPU times are reported, with the --dump-pass-profile of the last run: the CPU time of
+the optimizing compiler passes summed over all methods and the slowest methods. With
+--baseline, the script fails if the median CPU time of any corpus file regressed by more than
+the threshold. Options that are not recognized here are passed to dex2oat.
+"""
+
+import argparse
+import importlib.util
+import json
+import os
+import resource
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+TOOLS_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', 'tools')
+
+def parse_args():
+  parser = argparse.ArgumentParser(description='Benchmark host dex2oat on a fixed corpus.')
+  parser.add_argument('--dex2oat', default=os.path.expandvars('$ANDROID_HOST_OUT/bin/dex2oat64'),
+                      help='The dex2oat to benchmark, by default the release dex2oat64.')
+  parser.add_argument('--arch', default='arm64',
+                      choices=['arm', 'arm64', 'riscv64', 'x86', 'x86_64'],
+                      help='The target architecture to compile for.')
+  parser.add_argument('--corpus', action='append', default=[],
+                      help='A jar or apk to compile, can be repeated. Default: framework.jar.')
+  parser.add_argument('--compiler-filter', default='speed', help='The compiler filter to use.')
+  parser.add_argument('--threads', type=int, default=1,
+                      help='The dex2oat thread count, default 1 for stable CPU times.')
+  parser.add_argument('--repeat', type=int, default=5, help='The number of runs of each file.')
+  parser.add_argument('--slowest-methods', type=int, default=20,
+                      help='The number of slowest methods to report.')
+  parser.add_argument('--output', help='Write the results to this JSON file.')
+  parser.add_argument('--baseline', help='Compare the results with this JSON file.')
+  parser.add_argument('--threshold', type=float, default=3.0,
+                      help='Regression threshold in percent for --baseline, default 3.')
+  return parser.parse_known_args()
+
+def load_compile_jar():
+  """Imports art/tools/compile-jar.py, which finds the boot class path of the target."""
+  spec = importlib.util.spec_from_file_location('compile_jar',
+                                                os.path.join(TOOLS_DIR, 'compile-jar.py'))
+  module = importlib.util.module_from_spec(spec)
+  spec.loader.exec_module(module)
+  return module
+
+def dex2oat_command(args, corpus_file, tmp_dir, dex2oat_args):
+  """Returns the dex2oat command line compiling `corpus_file` as a system jar, like
+  compile-jar.py does, so that only dex2oat itself is measured."""
+  product_out = os.environ['ANDROID_PRODUCT_OUT']
+  boot_image = ':'.join([
+    os.path.join(product_out, 'apex', 'art_boot_images', 'javalib', 'boot.art'),
+    os.path.join(product_out, 'system', 'framework', 'boot-framework.art'),
+  ])
+  command = [
+    args.dex2oat,
+    '--dex-file=' + corpus_file,
+    '--dex-location=/system/framework/' + os.path.basename(corpus_file),
+    '--oat-file=' + os.path.join(tmp_dir, 'out.odex'),
+    '--instruction-set=' + args.arch,
+    '--boot-image=' + boot_image,
+    '--android-root=' + os.path.join(product_out, 'system'),
+    '--runtime-arg', '-Xms64m', '--runtime-arg', '-Xmx512m',
+    '--compiler-filter=' + args.compiler_filter,
+    '-j%d' % args.threads,
+    '--dump-pass-profile=' + os.path.join(tmp_dir, 'pass-profile.json'),
+    '--dump-pass-profile-methods=%d' % args.slowest_methods,
+  ]
+  command += load_compile_jar().get_bcp_runtime_args([], boot_image, args.arch)
+  return command + dex2oat_args
+
+def run_dex2oat(command):
+  """Runs dex2oat once and returns its wall and CPU time in seconds."""
+  usage_before = resource.getrusage(resource.RUSAGE_CHILDREN)
+  start = time.monotonic()
+  result = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                          universal_newlines=True)
+  wall_s = time.monotonic() - start
+  usage_after = resource.getrusage(resource.RUSAGE_CHILDREN)
+  if result.returncode != 0:
+    sys.exit('Running %s failed:\n%s' % (' '.join(command), result.stdout))
+  cpu_s = (usage_after.ru_utime - usage_before.ru_utime +
+           usage_after.ru_stime - usage_before.ru_stime)
+  return wall_s, cpu_s
+
+def benchmark(args, corpus_file, dex2oat_args):
+  with tempfile.TemporaryDirectory() as tmp_dir:
+    command = dex2oat_command(args, corpus_file, tmp_dir, dex2oat_args)
+    wall_times = []
+    cpu_times = []
+    for _ in range(args.repeat):
+      wall_s, cpu_s = run_dex2oat(command)
+      wall_times.append(wall_s)
+      cpu_times.append(cpu_s)
+    with open(os.path.join(tmp_dir, 'pass-profile.json')) as f:
+      pass_profile = json.load(f)
+  return {
+    'corpus': os.path.basename(corpus_file),
+    'arch': args.arch,
+    'compiler_filter': args.compiler_filter,
+    'threads': args.threads,
+    'wall_s': statistics.median(wall_times),
+    'cpu_s': statistics.median(cpu_times),
+    'min_cpu_s': min(cpu_times),
+    'max_cpu_s': max(cpu_times),
+    # The maximum over all runs, the children are not distinguished.
+    'max_rss_kb': resource.getrusage(resource.RUSAGE_CHILDREN).ru_maxrss,
+    'methods': pass_profile['methods'],
+    'pass_profile': pass_profile,
+  }
+
+def print_result(result):
+  print('%s: %d methods, wall %.2fs, cpu %.2fs (%.2f-%.2f), max rss %d kB' %
+        (result['corpus'], result['methods'], result['wall_s'], result['cpu_s'],
+         result['min_cpu_s'], result['max_cpu_s'], result['max_rss_kb']))
+  profile = result['pass_profile']
+  total_ns = max(profile['cpu_ns'], 1)
+  print('  %-40s %10s %7s %14s' % ('pass', 'cpu_ms', 'share', 'graph_kb'))
+  for optimization_pass in profile['passes'][:15]:
+    print('  %-40s %10.1f %6.1f%% %14d' %
+          (optimization_pass['name'], optimization_pass['cpu_ns'] / 1e6,
+           optimization_pass['cpu_ns'] * 100.0 / total_ns,
+           optimization_pass['graph_bytes'] // 1024))
+  print('  %-80s %10s %8s %s' % ('slowest method', 'cpu_ms', 'units', 'slowest pass'))
+  for method in profile['slowest_methods'][:10]:
+    print('  %-80s %10.1f %8d %s' % (method['method'][:80], method['cpu_ns'] / 1e6,
+                                     method['dex_code_units'], method['slowest_pass']))
+
+def compare_with_baseline(results, baseline, threshold):
+  """Prints the changes from the baseline and returns the number of regressions."""
+  baseline_results = {(r['corpus'], r['arch'], r['compiler_filter']): r for r in baseline}
+  regressions = 0
+  for result in results:
+    base = baseline_results.get((result['corpus'], result['arch'], result['compiler_filter']))
+    if base is None or base['cpu_s'] == 0:
+      continue
+    change = (result['cpu_s'] / base['cpu_s'] - 1.0) * 100.0
+    marker = ''
+    if change > threshold:
+      marker = '  REGRESSION'
+      regressions += 1
+    print('%-40s cpu %+6.1f%%%s' % (result['corpus'], change, marker))
+  return regressions
+
+def main():
+  args, dex2oat_args = parse_args()
+  corpus = args.corpus
+  product_out = os.environ.get('ANDROID_PRODUCT_OUT')
+  if product_out is None:
+    sys.exit('Set ANDROID_PRODUCT_OUT to the product with the target boot image.')
+  if not corpus:
+    corpus = [os.path.join(product_out, 'system', 'framework', 'framework.jar')]
+
+  results = []
+  for corpus_file in corpus:
+    result = benchmark(args, corpus_file, dex2oat_args)
+    print_result(result)
+    results.append(result)
+
+  if args.output:
+    with open(args.output, 'w') as f:
+      json.dump(results, f, indent=2)
+  if args.baseline:
+    with open(args.baseline) as f:
+      baseline = json.load(f)
+    regressions = compare_with_baseline(results, baseline, args.threshold)
+    if regressions != 0:
+      sys.exit('%d corpus file(s) regressed by more than %.1f%%' % (regressions, args.threshold))
+
+if __name__ == '__main__':
+  main()
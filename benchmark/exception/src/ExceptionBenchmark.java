@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class ExceptionBenchmark {
+    static class PreallocatedException extends RuntimeException {
+        PreallocatedException() {
+            super(null, null, /* enableSuppression= */ false, /* writableStackTrace= */ false);
+        }
+    }
+
+    private static final PreallocatedException preallocated = new PreallocatedException();
+
+    private static void $noinline$throwNew(int depth) {
+        if (depth == 0) {
+            throw new IllegalStateException();
+        }
+        $noinline$throwNew(depth - 1);
+    }
+
+    private static void $noinline$throwPreallocated(int depth) {
+        if (depth == 0) {
+            throw preallocated;
+        }
+        $noinline$throwPreallocated(depth - 1);
+    }
+
+    private static void check(int sum, int count) {
+        if (sum != count) {
+            throw new AssertionError();
+        }
+    }
+
+    public void timeThrowCatchShallow(int count) {
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            try {
+                $noinline$throwNew(0);
+            } catch (IllegalStateException e) {
+                ++sum;
+            }
+        }
+        check(sum, count);
+    }
+
+    public void timeThrowCatchDeep(int count) {
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            try {
+                $noinline$throwNew(20);
+            } catch (IllegalStateException e) {
+                ++sum;
+            }
+        }
+        check(sum, count);
+    }
+
+    // Without the stack trace collection, this measures the unwinding on its own.
+    public void timeThrowCatchPreallocatedDeep(int count) {
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            try {
+                $noinline$throwPreallocated(20);
+            } catch (PreallocatedException e) {
+                ++sum;
+            }
+        }
+        check(sum, count);
+    }
+
+    public void timeImplicitNullPointerException(int count) {
+        Object[] objects = { null };
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            try {
+                sum += objects[0].hashCode();
+            } catch (NullPointerException e) {
+                ++sum;
+            }
+        }
+        check(sum, count);
+    }
+
+    public void timeGetStackTrace(int count) {
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += (new Throwable().getStackTrace().length != 0) ? 1 : 0;
+        }
+        check(sum, count);
+    }
+}
@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2023 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Runs the GcStress driver on a device with several collector configurations.
+
+Build the driver with `m art-benchmarks`, then for example:
+
+  art/benchmark/gc-stress/run-gc-stress.py --collectors=CC,CMC --conc-gc-threads=1,2,4 \\
+      --shapes=deep-list,weak-refs --output=gc.json
+
+Each combination of collector, thread count and shape runs in a fresh runtime. The results
+are printed as a table and written as a JSON list of the driver results. Options that are
+not recognized here, e.g. --live-mb=128 or --threads=8, are passed to GcStress.
+"""
+
+import argparse
+import json
+import os
+import shlex
+import subprocess
+import sys
+
+DEVICE_DIR = '/data/local/tmp/art-benchmarks'
+JAR_NAME = 'art-benchmarks.jar'
+
+COLUMNS = ['stall_p50_us', 'stall_p99_us', 'stall_p99_9_us', 'stall_max_us', 'gc_cpu_ms',
+           'allocation_stall_ms', 'allocated_mb_per_s', 'peak_rss_kb']
+
+def parse_args():
+  parser = argparse.ArgumentParser(description='Run the GcStress driver on a device.')
+  parser.add_argument('--jar',
+                      help='The art-benchmarks jar, by default from $ANDROID_PRODUCT_OUT.')
+  parser.add_argument('--collectors', default='default',
+                      help='Comma-separated -Xgc: collectors (CC, CMC, CMS, MS) or "default".')
+  parser.add_argument('--conc-gc-threads', default='',
+                      help='Comma-separated -XX:ConcGCThreads= values to try.')
+  parser.add_argument('--parallel-gc-threads', default='',
+                      help='Comma-separated -XX:ParallelGCThreads= values to try.')
+  parser.add_argument('--shapes', default='mixed', help='Comma-separated heap shapes.')
+  parser.add_argument('--heap-size', default='512m', help='The -Xmx and -Xms of the runtime.')
+  parser.add_argument('--dalvikvm', default='dalvikvm64', help='The dalvikvm binary to use.')
+  parser.add_argument('--output', help='Write the results to this JSON file.')
+  return parser.parse_known_args()
+
+def adb(*args, check=True):
+  cmd = ['adb'] + list(args)
+  return subprocess.run(cmd, check=check, stdout=subprocess.PIPE, universal_newlines=True).stdout
+
+def split_list(value):
+  return [v for v in value.split(',') if v] or [None]
+
+def runtime_configs(args):
+  """Yields (label, runtime options) for all combinations of the collector options."""
+  for collector in split_list(args.collectors):
+    for conc in split_list(args.conc_gc_threads):
+      for parallel in split_list(args.parallel_gc_threads):
+        label = collector
+        options = []
+        if collector != 'default':
+          options.append('-Xgc:' + collector)
+        if conc is not None:
+          label += '/conc=' + conc
+          options.append('-XX:ConcGCThreads=' + conc)
+        if parallel is not None:
+          label += '/parallel=' + parallel
+          options.append('-XX:ParallelGCThreads=' + parallel)
+        yield label, options
+
+def main():
+  args, driver_args = parse_args()
+  jar = args.jar
+  if jar is None:
+    product_out = os.environ.get('ANDROID_PRODUCT_OUT')
+    if product_out is None:
+      sys.exit('Specify --jar or set ANDROID_PRODUCT_OUT.')
+    jar = os.path.join(product_out, 'system', 'framework', JAR_NAME)
+  adb('shell', 'mkdir -p ' + DEVICE_DIR)
+  adb('push', jar, DEVICE_DIR + '/' + JAR_NAME)
+
+  results = []
+  print('%-32s %-14s' % ('config', 'shape') + ''.join(' %14s' % c for c in COLUMNS))
+  for label, options in runtime_configs(args):
+    for shape in args.shapes.split(','):
+      command = [args.dalvikvm, '-Xmx' + args.heap_size, '-Xms' + args.heap_size] + options
+      command += ['-cp', DEVICE_DIR + '/' + JAR_NAME, 'GcStress', '--config=' + label,
+                  '--shape=' + shape] + driver_args
+      output = adb('shell', ' '.join(shlex.quote(arg) for arg in command), check=False)
+      lines = [line for line in output.splitlines() if line.startswith('{')]
+      if not lines:
+        print('%-32s %-14s failed:\n%s' % (label, shape, output), file=sys.stderr)
+        continue
+      result = json.loads(lines[-1])
+      result['runtime_options'] = options
+      results.append(result)
+      print('%-32s %-14s' % (label, shape) + ''.join(' %14s' % result[c] for c in COLUMNS))
+
+  if args.output:
+    with open(args.output, 'w') as f:
+      json.dump(results, f, indent=2)
+
+if __name__ == '__main__':
+  main()
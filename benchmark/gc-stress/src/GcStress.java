@@ -0,0 +1,425 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.io.BufferedReader;
+import java.io.File;
+import java.io.FileReader;
+import java.io.IOException;
+import java.lang.ref.WeakReference;
+import java.lang.reflect.Method;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.List;
+import java.util.Random;
+import java.util.concurrent.atomic.AtomicLong;
+
+/**
+ * A GC stress driver that keeps a live set of a configurable shape and size, replaces parts
+ * of it and mutates it at a configurable rate from a number of threads, and reports pause,
+ * CPU time, allocation stall and memory statistics as one JSON object. The heap shapes only
+ * depend on the options and the seed, so runs with different collector options are
+ * comparable. See run-gc-stress.py for running it with several collector configurations.
+ *
+ * Usage: GcStress [options]
+ *   --shape=NAME        deep-list, wide-tree, large-arrays, weak-refs, finalizers or mixed.
+ *   --live-mb=N         Size of the live set, default 64.
+ *   --unit-kb=N         Size of the units of the live set that are replaced, default 256.
+ *   --garbage-ratio=N   Short-lived bytes allocated for each byte of replaced units, default 4.
+ *   --mutations=N       Reference stores into old units for each replaced unit, default 64.
+ *   --threads=N         Number of mutator threads, default 4.
+ *   --duration-s=N      Duration of the measurement, default 30.
+ *   --seed=N            Seed of the random number generators, default 42.
+ *   --config=NAME       Collector configuration label included in the results.
+ */
+public class GcStress {
+    // Approximate sizes of the objects, for sizing the units.
+    private static final int OBJECT_HEADER_SIZE = 8;
+    private static final int NODE_SIZE = 24;
+    private static final int HOLDERS_PER_UNIT = 64;
+
+    // The interval of the stall meter and the number of its samples kept.
+    private static final long STALL_METER_INTERVAL_MS = 1;
+    private static final int MAX_STALL_SAMPLES = 1 << 20;
+
+    private static final String[] SHAPES = {
+        "deep-list", "wide-tree", "large-arrays", "weak-refs", "finalizers"
+    };
+
+    private static final String[] GC_STATS = {
+        "art.gc.gc-count",
+        "art.gc.gc-time",
+        "art.gc.blocking-gc-count",
+        "art.gc.blocking-gc-time",
+        "art.gc.total-time-waiting-for-gc",
+    };
+
+    private String shape = "mixed";
+    private long liveBytes = 64L << 20;
+    private int unitBytes = 256 << 10;
+    private int garbageRatio = 4;
+    private int mutations = 64;
+    private int threads = 4;
+    private long durationNs = 30L * 1000000000L;
+    private long seed = 42;
+    private String config = "default";
+
+    private static final AtomicLong finalizedCount = new AtomicLong();
+    private final AtomicLong allocatedBytes = new AtomicLong();
+    private final AtomicLong replacedUnits = new AtomicLong();
+    private volatile boolean stop = false;
+
+    /** A node of the live set with a field that the mutators store into. */
+    static class Node {
+        Node next;
+        Object ref;
+    }
+
+    static class FinalizableNode extends Node {
+        @Override
+        protected void finalize() {
+            finalizedCount.incrementAndGet();
+        }
+    }
+
+    /** A replaceable part of the live set. */
+    static class Unit {
+        final Object root;
+        final Node[] holders;
+
+        Unit(Object root, Node[] holders) {
+            this.root = root;
+            this.holders = holders;
+        }
+    }
+
+    public static void main(String[] args) throws Exception {
+        GcStress stress = new GcStress();
+        for (String arg : args) {
+            String value = arg.substring(arg.indexOf('=') + 1);
+            if (arg.startsWith("--shape=")) {
+                stress.shape = value;
+                if (!value.equals("mixed") && !Arrays.asList(SHAPES).contains(value)) {
+                    throw new IllegalArgumentException("Unknown shape " + value);
+                }
+            } else if (arg.startsWith("--live-mb=")) {
+                stress.liveBytes = Long.parseLong(value) << 20;
+            } else if (arg.startsWith("--unit-kb=")) {
+                stress.unitBytes = Integer.parseInt(value) << 10;
+            } else if (arg.startsWith("--garbage-ratio=")) {
+                stress.garbageRatio = Integer.parseInt(value);
+            } else if (arg.startsWith("--mutations=")) {
+                stress.mutations = Integer.parseInt(value);
+            } else if (arg.startsWith("--threads=")) {
+                stress.threads = Integer.parseInt(value);
+            } else if (arg.startsWith("--duration-s=")) {
+                stress.durationNs = Long.parseLong(value) * 1000000000L;
+            } else if (arg.startsWith("--seed=")) {
+                stress.seed = Long.parseLong(value);
+            } else if (arg.startsWith("--config=")) {
+                stress.config = value;
+            } else {
+                throw new IllegalArgumentException("Unknown option " + arg);
+            }
+        }
+        System.out.println(stress.run());
+    }
+
+    private String shapeOf(int unitIndex) {
+        return shape.equals("mixed") ? SHAPES[unitIndex % SHAPES.length] : shape;
+    }
+
+    private Node[] newHolders() {
+        Node[] holders = new Node[HOLDERS_PER_UNIT];
+        for (int i = 0; i < holders.length; ++i) {
+            holders[i] = new Node();
+        }
+        return holders;
+    }
+
+    private Unit makeUnit(int unitIndex, Random random) {
+        String unitShape = shapeOf(unitIndex);
+        int numNodes = Math.max(1, unitBytes / NODE_SIZE);
+        switch (unitShape) {
+            case "deep-list": {
+                // A single list, as deep as the unit allows.
+                Node[] holders = new Node[HOLDERS_PER_UNIT];
+                int stride = Math.max(1, numNodes / HOLDERS_PER_UNIT);
+                Node head = null;
+                for (int i = 0; i < numNodes; ++i) {
+                    Node node = new Node();
+                    node.next = head;
+                    head = node;
+                    if (i % stride == 0 && i / stride < HOLDERS_PER_UNIT) {
+                        holders[i / stride] = node;
+                    }
+                }
+                for (int i = 0; i < holders.length; ++i) {
+                    if (holders[i] == null) {
+                        holders[i] = head;
+                    }
+                }
+                return new Unit(head, holders);
+            }
+            case "wide-tree": {
+                // A two level tree with a wide fan-out, the arrays are scanned element by element.
+                int fanOut = Math.max(1, (int) Math.sqrt(numNodes));
+                Object[] root = new Object[fanOut];
+                Node[] holders = newHolders();
+                for (int i = 0; i < fanOut; ++i) {
+                    Node[] children = new Node[fanOut];
+                    for (int j = 0; j < fanOut; ++j) {
+                        children[j] = new Node();
+                    }
+                    root[i] = children;
+                    holders[i % HOLDERS_PER_UNIT] = children[random.nextInt(fanOut)];
+                }
+                return new Unit(root, holders);
+            }
+            case "large-arrays": {
+                // Primitive arrays in the large object space.
+                int arrayBytes = Math.max(64 << 10, unitBytes / 4);
+                Object[] arrays = new Object[Math.max(1, unitBytes / arrayBytes)];
+                for (int i = 0; i < arrays.length; ++i) {
+                    long[] array = new long[arrayBytes / 8];
+                    array[random.nextInt(array.length)] = i;
+                    arrays[i] = array;
+                }
+                return new Unit(arrays, newHolders());
+            }
+            case "weak-refs": {
+                // Weak references, half of them to objects that are otherwise unreachable.
+                int numRefs = Math.max(2, unitBytes / (NODE_SIZE * 3));
+                Object[] refs = new Object[numRefs];
+                Node[] strong = new Node[numRefs / 2];
+                for (int i = 0; i < numRefs; ++i) {
+                    Node referent = new Node();
+                    if (i % 2 == 0) {
+                        strong[i / 2] = referent;
+                    }
+                    refs[i] = new WeakReference<Node>(referent);
+                }
+                return new Unit(new Object[] { refs, strong }, newHolders());
+            }
+            case "finalizers": {
+                // Finalizable objects, which become finalizable garbage with the unit.
+                Node head = null;
+                for (int i = 0; i < numNodes / 4; ++i) {
+                    Node node = (i % 8 == 0) ? new FinalizableNode() : new Node();
+                    node.next = head;
+                    head = node;
+                }
+                return new Unit(head, newHolders());
+            }
+            default:
+                throw new AssertionError(unitShape);
+        }
+    }
+
+    private void allocateGarbage(long bytes, Random random) {
+        Object last = null;
+        for (long allocated = 0; allocated < bytes; ) {
+            int size = 16 + random.nextInt(112);
+            last = new byte[size];
+            allocated += size + OBJECT_HEADER_SIZE;
+        }
+        if (last == null && bytes > 0) {
+            throw new AssertionError();
+        }
+    }
+
+    private void mutator(Unit[] units, int first, int count, Random random) {
+        while (!stop) {
+            int index = first + random.nextInt(count);
+            units[index] = makeUnit(index, random);
+            replacedUnits.incrementAndGet();
+            for (int i = 0; i < mutations; ++i) {
+                Unit old = units[first + random.nextInt(count)];
+                old.holders[random.nextInt(HOLDERS_PER_UNIT)].ref = new Node();
+            }
+            long garbage = (long) unitBytes * garbageRatio;
+            allocateGarbage(garbage, random);
+            allocatedBytes.addAndGet(unitBytes + garbage + (long) mutations * NODE_SIZE);
+        }
+    }
+
+    // Records how late a thread sleeping for a fixed interval wakes up. Long delays are
+    // mostly the pauses that the mutators observe, including the time to reach a suspend
+    // point and the time to resume.
+    private long[] runStallMeter(long durationNs) throws InterruptedException {
+        long[] samples = new long[MAX_STALL_SAMPLES];
+        int numSamples = 0;
+        long end = System.nanoTime() + durationNs;
+        long last = System.nanoTime();
+        while (last < end && numSamples < samples.length) {
+            Thread.sleep(STALL_METER_INTERVAL_MS);
+            long now = System.nanoTime();
+            samples[numSamples++] = Math.max(0, now - last - STALL_METER_INTERVAL_MS * 1000000L);
+            last = now;
+        }
+        samples = Arrays.copyOf(samples, numSamples);
+        Arrays.sort(samples);
+        return samples;
+    }
+
+    private String run() throws Exception {
+        int numUnits = (int) Math.max(threads, liveBytes / unitBytes);
+        Unit[] units = new Unit[numUnits];
+        Random setupRandom = new Random(seed);
+        for (int i = 0; i < numUnits; ++i) {
+            units[i] = makeUnit(i, setupRandom);
+        }
+        Runtime.getRuntime().gc();
+
+        List<Thread> mutators = new ArrayList<>();
+        int unitsPerThread = numUnits / threads;
+        for (int t = 0; t < threads; ++t) {
+            final int first = t * unitsPerThread;
+            final int count = (t == threads - 1) ? numUnits - first : unitsPerThread;
+            final Random random = new Random(seed + 1 + t);
+            mutators.add(new Thread(() -> mutator(units, first, count, random), "GcStress-" + t));
+        }
+
+        long[] gcStatsBefore = getGcStats();
+        long gcCpuBefore = getGcThreadsCpuTimeNs();
+        long start = System.nanoTime();
+        for (Thread mutator : mutators) {
+            mutator.start();
+        }
+        long[] stalls = runStallMeter(durationNs);
+        stop = true;
+        for (Thread mutator : mutators) {
+            mutator.join();
+        }
+        long elapsedNs = System.nanoTime() - start;
+        long gcCpuNs = getGcThreadsCpuTimeNs() - gcCpuBefore;
+        long[] gcStatsAfter = getGcStats();
+
+        StringBuilder json = new StringBuilder();
+        json.append("{\"config\": \"").append(config).append('"');
+        json.append(", \"shape\": \"").append(shape).append('"');
+        json.append(", \"live_mb\": ").append(liveBytes >> 20);
+        json.append(", \"unit_kb\": ").append(unitBytes >> 10);
+        json.append(", \"garbage_ratio\": ").append(garbageRatio);
+        json.append(", \"mutations\": ").append(mutations);
+        json.append(", \"threads\": ").append(threads);
+        json.append(", \"seed\": ").append(seed);
+        json.append(", \"elapsed_ms\": ").append(elapsedNs / 1000000);
+        json.append(", \"allocated_mb_per_s\": ")
+            .append((allocatedBytes.get() >> 20) * 1000000000L / elapsedNs);
+        json.append(", \"replaced_units\": ").append(replacedUnits.get());
+        json.append(", \"finalized\": ").append(finalizedCount.get());
+        for (double percentile : new double[] { 50.0, 90.0, 99.0, 99.9 }) {
+            String key = Double.toString(percentile).replace(".0", "").replace('.', '_');
+            json.append(", \"stall_p").append(key).append("_us\": ")
+                .append(percentile(stalls, percentile) / 1000);
+        }
+        json.append(", \"stall_max_us\": ")
+            .append(stalls.length != 0 ? stalls[stalls.length - 1] / 1000 : 0);
+        long gcTimeMs = gcStatsAfter[1] - gcStatsBefore[1];
+        json.append(", \"gc_count\": ").append(gcStatsAfter[0] - gcStatsBefore[0]);
+        json.append(", \"gc_time_ms\": ").append(gcTimeMs);
+        json.append(", \"blocking_gc_count\": ").append(gcStatsAfter[2] - gcStatsBefore[2]);
+        json.append(", \"blocking_gc_time_ms\": ").append(gcStatsAfter[3] - gcStatsBefore[3]);
+        json.append(", \"allocation_stall_ms\": ")
+            .append((gcStatsAfter[4] - gcStatsBefore[4]) / 1000000);
+        json.append(", \"gc_cpu_ms\": ").append(gcCpuNs / 1000000);
+        json.append(", \"peak_rss_kb\": ").append(getStatusValueKb("VmHWM:"));
+        json.append('}');
+        return json.toString();
+    }
+
+    private static long percentile(long[] sorted, double percentile) {
+        if (sorted.length == 0) {
+            return 0;
+        }
+        int index = (int) Math.ceil(percentile / 100.0 * sorted.length) - 1;
+        return sorted[Math.max(0, Math.min(sorted.length - 1, index))];
+    }
+
+    private static long[] getGcStats() {
+        long[] stats = new long[GC_STATS.length];
+        try {
+            Method getRuntimeStat =
+                Class.forName("dalvik.system.VMDebug").getMethod("getRuntimeStat", String.class);
+            for (int i = 0; i < GC_STATS.length; ++i) {
+                String value = (String) getRuntimeStat.invoke(null, GC_STATS[i]);
+                stats[i] = (value != null) ? Long.parseLong(value) : 0;
+            }
+        } catch (ReflectiveOperationException e) {
+            // Not running on ART, GC statistics are not reported.
+        }
+        return stats;
+    }
+
+    // The CPU time of the threads running the collector: the heap task daemon running the
+    // concurrent collections and the workers of the heap thread pool.
+    private static long getGcThreadsCpuTimeNs() {
+        File[] tasks = new File("/proc/self/task").listFiles();
+        if (tasks == null) {
+            return 0;
+        }
+        long ticks = 0;
+        for (File task : tasks) {
+            String stat = readFirstLine(new File(task, "stat"));
+            if (stat == null) {
+                continue;
+            }
+            int nameStart = stat.indexOf('(');
+            int nameEnd = stat.lastIndexOf(')');
+            String name = stat.substring(nameStart + 1, nameEnd);
+            if (!name.startsWith("HeapTaskDaemon") && !name.startsWith("Heap thread poo")) {
+                continue;
+            }
+            // The fields after the name start with the state; utime and stime are the
+            // 14th and 15th fields of the line.
+            String[] fields = stat.substring(nameEnd + 2).split(" ");
+            ticks += Long.parseLong(fields[11]) + Long.parseLong(fields[12]);
+        }
+        return ticks * (1000000000L / getClockTicksPerSecond());
+    }
+
+    private static long getClockTicksPerSecond() {
+        try {
+            Class<?> os = Class.forName("android.system.Os");
+            Class<?> constants = Class.forName("android.system.OsConstants");
+            int name = constants.getField("_SC_CLK_TCK").getInt(null);
+            return (Long) os.getMethod("sysconf", int.class).invoke(null, name);
+        } catch (ReflectiveOperationException e) {
+            return 100;  // USER_HZ on Linux.
+        }
+    }
+
+    private static long getStatusValueKb(String key) {
+        try (BufferedReader reader = new BufferedReader(new FileReader("/proc/self/status"))) {
+            for (String line = reader.readLine(); line != null; line = reader.readLine()) {
+                if (line.startsWith(key)) {
+                    return Long.parseLong(line.substring(key.length()).trim().split(" ")[0]);
+                }
+            }
+        } catch (IOException e) {
+            // Fall through.
+        }
+        return 0;
+    }
+
+    private static String readFirstLine(File file) {
+        try (BufferedReader reader = new BufferedReader(new FileReader(file))) {
+            return reader.readLine();
+        } catch (IOException e) {
+            return null;  // The thread exited.
+        }
+    }
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.util.ArrayList;
+import java.util.HashMap;
+
+public class GcBenchmark {
+    static class Node {
+        Node left;
+        Node right;
+        int value;
+
+        Node(Node left, Node right, int value) {
+            this.left = left;
+            this.right = right;
+            this.value = value;
+        }
+    }
+
+    // A long-lived tree that every collection has to trace or, with a generational
+    // collector, keep in the old generation.
+    private static final Node retained = makeTree(16);
+
+    public static Object sink;
+
+    private static Node makeTree(int depth) {
+        if (depth == 0) {
+            return new Node(null, null, 0);
+        }
+        return new Node(makeTree(depth - 1), makeTree(depth - 1), depth);
+    }
+
+    private static int checkTree(Node node) {
+        return (node == null) ? 0 : 1 + checkTree(node.left) + checkTree(node.right);
+    }
+
+    // Allocation of short-lived trees, the young generation throughput case.
+    public void timeShortLivedTrees(int count) {
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            Node tree = makeTree(6);
+            sum += tree.value;
+        }
+        if (sum != count * 6) {
+            throw new AssertionError();
+        }
+    }
+
+    // A sliding window of medium-lived objects, some of which survive a few collections.
+    public void timeSlidingWindow(int count) {
+        final int windowSize = 16 * 1024;
+        Object[] window = new Object[windowSize];
+        for (int i = 0; i < count; ++i) {
+            window[i % windowSize] = new int[8 + (i & 31)];
+        }
+        sink = window;
+    }
+
+    // Growing and discarding collections of boxed values, typical for application code.
+    public void timeCollectionChurn(int count) {
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            ArrayList<Integer> list = new ArrayList<>();
+            HashMap<Integer, Integer> map = new HashMap<>();
+            for (int j = 0; j < 16; ++j) {
+                list.add(j * 1000);
+                map.put(j * 1000, j);
+            }
+            sum += list.size() + map.size();
+        }
+        if (sum != count * 32) {
+            throw new AssertionError();
+        }
+    }
+
+    // Explicit collections with a large live set; the pause times are reported by the
+    // harness from the blocking GC statistics.
+    public void timeExplicitGcWithLiveSet(int count) {
+        for (int i = 0; i < count; ++i) {
+            Runtime.getRuntime().gc();
+        }
+        if (checkTree(retained) != (1 << 17) - 1) {
+            throw new AssertionError();
+        }
+    }
+}
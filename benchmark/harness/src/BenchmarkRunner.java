@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.reflect.InvocationTargetException;
+import java.lang.reflect.Method;
+import java.lang.reflect.Modifier;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.List;
+import java.util.regex.Pattern;
+
+/**
+ * Runs the {@code timeXxx(int count)} methods of the benchmarks in this directory and prints
+ * one JSON object per line for each of them. See run-benchmarks.py for running the suite in
+ * the different execution modes and for comparing the results with a baseline.
+ *
+ * Usage: BenchmarkRunner [options] [benchmark class...]
+ *   --mode=NAME          Execution mode label included in the results, e.g. "jit".
+ *   --filter=REGEX       Only run the benchmarks with a matching "Class.method" name.
+ *   --warmup-ms=N        Minimal warmup time for each benchmark, default 2000ms.
+ *   --round-ms=N         Target duration of each measured round, default 200ms.
+ *   --rounds=N           Number of measured rounds, default 10.
+ *   --load-library=NAME  Load a native library first, e.g. "artbenchmark" for the JNI benchmarks.
+ * Without benchmark classes, runs the benchmarks that do not need a native library, and also
+ * the JNI benchmarks if a native library was loaded.
+ */
+public class BenchmarkRunner {
+    private static final String[] DEFAULT_BENCHMARKS = {
+        "AllocationBenchmark",
+        "ClassLoadingBenchmark",
+        "ConstClassBenchmark",
+        "ConstStringBenchmark",
+        "ExceptionBenchmark",
+        "GcBenchmark",
+        "InvokeBenchmark",
+        "MonitorBenchmark",
+        "ReflectionBenchmark",
+        "StringBuilderAppendBenchmark",
+        "StringIndexOfBenchmark",
+        "TypeCheckBenchmark",
+    };
+
+    // The benchmarks using libartbenchmark.
+    private static final String[] JNI_BENCHMARKS = {
+        "JObjectBenchmark",
+        "JniPerfBenchmark",
+        "MicroNativeBenchmark",
+        "ScopedPrimitiveArrayBenchmark",
+    };
+
+    private static final String[] GC_STATS = {
+        "art.gc.gc-count",
+        "art.gc.gc-time",
+        "art.gc.blocking-gc-count",
+        "art.gc.blocking-gc-time",
+    };
+
+    private static final int MAX_COUNT = 1 << 30;
+
+    private String mode = "default";
+    private Pattern filter = null;
+    private long warmupNs = 2000L * 1000000L;
+    private long roundNs = 200L * 1000000L;
+    private int rounds = 10;
+    private Method getRuntimeStat = null;
+
+    public static void main(String[] args) throws Exception {
+        BenchmarkRunner runner = new BenchmarkRunner();
+        List<String> classNames = new ArrayList<>();
+        boolean loadedLibrary = false;
+        for (String arg : args) {
+            if (arg.startsWith("--mode=")) {
+                runner.mode = arg.substring("--mode=".length());
+            } else if (arg.startsWith("--filter=")) {
+                runner.filter = Pattern.compile(arg.substring("--filter=".length()));
+            } else if (arg.startsWith("--warmup-ms=")) {
+                runner.warmupNs = Long.parseLong(arg.substring("--warmup-ms=".length())) * 1000000L;
+            } else if (arg.startsWith("--round-ms=")) {
+                runner.roundNs = Long.parseLong(arg.substring("--round-ms=".length())) * 1000000L;
+            } else if (arg.startsWith("--rounds=")) {
+                runner.rounds = Integer.parseInt(arg.substring("--rounds=".length()));
+            } else if (arg.startsWith("--load-library=")) {
+                System.loadLibrary(arg.substring("--load-library=".length()));
+                loadedLibrary = true;
+            } else if (arg.startsWith("--")) {
+                System.err.println("Unknown option " + arg);
+                System.exit(2);
+            } else {
+                classNames.add(arg);
+            }
+        }
+        if (classNames.isEmpty()) {
+            classNames.addAll(Arrays.asList(DEFAULT_BENCHMARKS));
+            if (loadedLibrary) {
+                classNames.addAll(Arrays.asList(JNI_BENCHMARKS));
+            }
+        }
+        runner.initGcStats();
+        boolean failed = false;
+        for (String className : classNames) {
+            failed |= !runner.runClass(Class.forName(className));
+        }
+        System.exit(failed ? 1 : 0);
+    }
+
+    private void initGcStats() {
+        try {
+            getRuntimeStat =
+                Class.forName("dalvik.system.VMDebug").getMethod("getRuntimeStat", String.class);
+        } catch (ReflectiveOperationException e) {
+            // Not running on ART, GC statistics are not reported.
+        }
+    }
+
+    private long[] getGcStats() throws ReflectiveOperationException {
+        long[] stats = new long[GC_STATS.length];
+        if (getRuntimeStat != null) {
+            for (int i = 0; i < GC_STATS.length; ++i) {
+                stats[i] = Long.parseLong((String) getRuntimeStat.invoke(null, GC_STATS[i]));
+            }
+        }
+        return stats;
+    }
+
+    private boolean runClass(Class<?> benchmarkClass) throws Exception {
+        Method[] methods = benchmarkClass.getMethods();
+        Arrays.sort(methods, (a, b) -> a.getName().compareTo(b.getName()));
+        Object instance = benchmarkClass.getDeclaredConstructor().newInstance();
+        boolean passed = true;
+        for (Method method : methods) {
+            String name = method.getName();
+            if (!name.startsWith("time") ||
+                    Modifier.isStatic(method.getModifiers()) ||
+                    !Arrays.equals(method.getParameterTypes(), new Class<?>[] { int.class })) {
+                continue;
+            }
+            String fullName = benchmarkClass.getName() + "." + name.substring("time".length());
+            if (filter != null && !filter.matcher(fullName).find()) {
+                continue;
+            }
+            try {
+                runBenchmark(instance, method, fullName);
+            } catch (InvocationTargetException e) {
+                System.err.println(fullName + " failed:");
+                e.getCause().printStackTrace();
+                passed = false;
+            }
+        }
+        return passed;
+    }
+
+    private long timeCall(Object instance, Method method, int count) throws Exception {
+        long start = System.nanoTime();
+        method.invoke(instance, count);
+        return System.nanoTime() - start;
+    }
+
+    private void runBenchmark(Object instance, Method method, String fullName) throws Exception {
+        // Warm up, giving the JIT a chance to compile the benchmark, and find an iteration
+        // count for which a call takes about the round time.
+        int count = 1;
+        long warmupStart = System.nanoTime();
+        while (true) {
+            long duration = timeCall(instance, method, count);
+            if (duration < roundNs && count < MAX_COUNT) {
+                long scaled = (duration <= 0) ? 2L * count : count * roundNs / duration;
+                count = (int) Math.min(MAX_COUNT, Math.max(2L * count, scaled));
+            } else if (System.nanoTime() - warmupStart >= warmupNs) {
+                break;
+            }
+        }
+
+        double[] nsPerOp = new double[rounds];
+        long[] gcStatsBefore = getGcStats();
+        for (int round = 0; round < rounds; ++round) {
+            nsPerOp[round] = (double) timeCall(instance, method, count) / count;
+        }
+        long[] gcStatsAfter = getGcStats();
+        Arrays.sort(nsPerOp);
+
+        StringBuilder json = new StringBuilder();
+        json.append("{\"benchmark\": \"").append(fullName).append('"');
+        json.append(", \"mode\": \"").append(mode).append('"');
+        json.append(", \"iterations\": ").append(count);
+        json.append(", \"rounds\": ").append(rounds);
+        json.append(", \"ns_per_op\": ").append(median(nsPerOp));
+        json.append(", \"min_ns_per_op\": ").append(nsPerOp[0]);
+        json.append(", \"max_ns_per_op\": ").append(nsPerOp[rounds - 1]);
+        for (int i = 0; i < GC_STATS.length; ++i) {
+            String key = GC_STATS[i].substring("art.gc.".length()).replace('-', '_');
+            json.append(", \"").append(key).append("\": ")
+                .append(gcStatsAfter[i] - gcStatsBefore[i]);
+        }
+        json.append('}');
+        System.out.println(json);
+    }
+
+    private static double median(double[] sorted) {
+        int mid = sorted.length / 2;
+        return (sorted.length % 2 != 0) ? sorted[mid] : (sorted[mid - 1] + sorted[mid]) / 2.0;
+    }
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class InvokeBenchmark {
+    interface Itf {
+        int get();
+    }
+
+    static class Base implements Itf {
+        public int get() { return 1; }
+    }
+
+    static class Impl1 extends Base {
+        public int get() { return 1; }
+    }
+
+    static class Impl2 extends Base {
+        public int get() { return 1; }
+    }
+
+    static class Impl3 extends Base {
+        public int get() { return 1; }
+    }
+
+    static class Impl4 extends Base {
+        public int get() { return 1; }
+    }
+
+    static class Impl5 extends Base {
+        public int get() { return 1; }
+    }
+
+    static class Impl6 extends Base {
+        public int get() { return 1; }
+    }
+
+    static class Impl7 extends Base {
+        public int get() { return 1; }
+    }
+
+    static class Other1 implements Itf {
+        public int get() { return 1; }
+    }
+
+    static class Other2 implements Itf {
+        public int get() { return 1; }
+    }
+
+    static class Other3 implements Itf {
+        public int get() { return 1; }
+    }
+
+    // Megamorphic receivers, more classes than an inline cache can hold.
+    private static final Base[] megamorphicVirtual = {
+        new Base(), new Impl1(), new Impl2(), new Impl3(),
+        new Impl4(), new Impl5(), new Impl6(), new Impl7(),
+    };
+    private static final Itf[] megamorphicInterface = {
+        new Base(), new Impl1(), new Impl2(), new Impl3(), new Impl4(),
+        new Other1(), new Other2(), new Other3(),
+    };
+    private static final Base[] polymorphic = { new Impl1(), new Impl2() };
+    private static final Base monomorphic = new Impl1();
+
+    private static int $noinline$invokeVirtual(Base b) {
+        return b.get();
+    }
+
+    private static int $noinline$invokeInterface(Itf i) {
+        return i.get();
+    }
+
+    private static int $noinline$invokeStatic(int value) {
+        return value;
+    }
+
+    private void check(int sum, int count) {
+        if (sum != count) {
+            throw new AssertionError();
+        }
+    }
+
+    public void timeInvokeStatic(int count) {
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += $noinline$invokeStatic(1);
+        }
+        check(sum, count);
+    }
+
+    public void timeInvokeVirtualMonomorphic(int count) {
+        Base b = monomorphic;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += $noinline$invokeVirtual(b);
+        }
+        check(sum, count);
+    }
+
+    public void timeInvokeVirtualPolymorphic(int count) {
+        Base[] receivers = polymorphic;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += $noinline$invokeVirtual(receivers[i & 1]);
+        }
+        check(sum, count);
+    }
+
+    public void timeInvokeVirtualMegamorphic(int count) {
+        Base[] receivers = megamorphicVirtual;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += $noinline$invokeVirtual(receivers[i & 7]);
+        }
+        check(sum, count);
+    }
+
+    public void timeInvokeInterfaceMonomorphic(int count) {
+        Itf itf = monomorphic;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += $noinline$invokeInterface(itf);
+        }
+        check(sum, count);
+    }
+
+    public void timeInvokeInterfaceMegamorphic(int count) {
+        Itf[] receivers = megamorphicInterface;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += $noinline$invokeInterface(receivers[i & 7]);
+        }
+        check(sum, count);
+    }
+
+    public void timeInvokeLambda(int count) {
+        java.util.function.IntUnaryOperator op = x -> x + 1;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum = op.applyAsInt(sum);
+        }
+        check(sum, count);
+    }
+}
@@ -96,6 +96,77 @@ static JNINativeMethod gMethods_Critical[] = {
         reinterpret_cast<void*>(NAME_CRITICAL_JNI_METHOD(emptyJniStaticMethod6_1Critical)) }
 };
 
+// The matrix of argument shapes of NativeMethods.jniStatic*(). The normal and the _Fast
+// variants share the implementation, the _Critical variants have no JNIEnv* and jclass.
+static jlong NativeMethods_jniStatic8J(JNIEnv*, jclass, jlong a, jlong, jlong, jlong, jlong,
+                                       jlong, jlong, jlong) {
+  return a;
+}
+static jlong NativeMethods_jniStatic8J_Critical(jlong a, jlong, jlong, jlong, jlong, jlong, jlong,
+                                                jlong) {
+  return a;
+}
+static jdouble NativeMethods_jniStatic8D(JNIEnv*, jclass, jdouble a, jdouble, jdouble, jdouble,
+                                         jdouble, jdouble, jdouble, jdouble) {
+  return a;
+}
+static jdouble NativeMethods_jniStatic8D_Critical(jdouble a, jdouble, jdouble, jdouble, jdouble,
+                                                  jdouble, jdouble, jdouble) {
+  return a;
+}
+static jdouble NativeMethods_jniStatic12D(JNIEnv*, jclass, jdouble, jdouble, jdouble, jdouble,
+                                          jdouble, jdouble, jdouble, jdouble, jdouble, jdouble,
+                                          jdouble, jdouble l) {
+  return l;
+}
+static jdouble NativeMethods_jniStatic12D_Critical(jdouble, jdouble, jdouble, jdouble, jdouble,
+                                                   jdouble, jdouble, jdouble, jdouble, jdouble,
+                                                   jdouble, jdouble l) {
+  return l;
+}
+static jint NativeMethods_jniStatic16Mixed(JNIEnv*, jclass, jint, jlong, jfloat, jdouble, jint,
+                                           jlong, jfloat, jdouble, jint, jlong, jfloat, jdouble,
+                                           jint m, jlong, jfloat, jdouble) {
+  return m;
+}
+static jint NativeMethods_jniStatic16Mixed_Critical(jint, jlong, jfloat, jdouble, jint, jlong,
+                                                    jfloat, jdouble, jint, jlong, jfloat, jdouble,
+                                                    jint m, jlong, jfloat, jdouble) {
+  return m;
+}
+static jobject NativeMethods_jniStaticReturnObject(JNIEnv*, jclass, jobject a) {
+  return a;
+}
+static jint NativeMethods_jniStaticArrayCritical(JNIEnv* env, jclass, jintArray a) {
+  jint* data = reinterpret_cast<jint*>(env->GetPrimitiveArrayCritical(a, nullptr));
+  jint result = data[0];
+  env->ReleasePrimitiveArrayCritical(a, data, JNI_ABORT);
+  return result;
+}
+
+#define MATRIX_METHOD(name, signature) \
+  NATIVE_METHOD(NativeMethods, name, signature), \
+  { #name "_Fast", signature, reinterpret_cast<void*>(NativeMethods_ ## name) }
+
+#define SIGNATURE_12D "(DDDDDDDDDDDD)D"
+#define SIGNATURE_16MIXED "(IJFDIJFDIJFDIJFD)I"
+
+static JNINativeMethod gMethods_Matrix[] = {
+  MATRIX_METHOD(jniStatic8J, "(JJJJJJJJ)J"),
+  MATRIX_METHOD(jniStatic8D, "(DDDDDDDD)D"),
+  MATRIX_METHOD(jniStatic12D, SIGNATURE_12D),
+  MATRIX_METHOD(jniStatic16Mixed, SIGNATURE_16MIXED),
+  MATRIX_METHOD(jniStaticReturnObject, "(Ljava/lang/Object;)Ljava/lang/Object;"),
+  MATRIX_METHOD(jniStaticArrayCritical, "([I)I"),
+};
+
+static JNINativeMethod gMethods_MatrixCritical[] = {
+  NATIVE_METHOD(NativeMethods, jniStatic8J_Critical, "(JJJJJJJJ)J"),
+  NATIVE_METHOD(NativeMethods, jniStatic8D_Critical, "(DDDDDDDD)D"),
+  NATIVE_METHOD(NativeMethods, jniStatic12D_Critical, SIGNATURE_12D),
+  NATIVE_METHOD(NativeMethods, jniStatic16Mixed_Critical, SIGNATURE_16MIXED),
+};
+
 void jniRegisterNativeMethods(JNIEnv* env,
                               const char* className,
                               const JNINativeMethod* methods,
@@ -132,10 +203,13 @@ void register_micro_native_methods(JNIEnv* env) {
   jniRegisterNativeMethods(env, CLASS_NAME, gMethods_NormalOnly, NELEM(gMethods_NormalOnly));
   jniRegisterNativeMethods(env, CLASS_NAME, gMethods, NELEM(gMethods));
   jniRegisterNativeMethods(env, CLASS_NAME, gMethods_Fast, NELEM(gMethods_Fast));
+  jniRegisterNativeMethods(env, CLASS_NAME, gMethods_Matrix, NELEM(gMethods_Matrix));
 
   if (env->FindClass("dalvik/annotation/optimization/CriticalNative") != nullptr) {
     // Only register them explicitly if the annotation is present.
     jniRegisterNativeMethods(env, CLASS_NAME, gMethods_Critical, NELEM(gMethods_Critical));
+    jniRegisterNativeMethods(
+        env, CLASS_NAME, gMethods_MatrixCritical, NELEM(gMethods_MatrixCritical));
   } else {
     if (env->ExceptionCheck()) {
       // It will throw NoClassDefFoundError
@@ -0,0 +1,264 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import benchmarks.MicroNative.java.NativeMethods;
+
+/**
+ * Measures the JNI transitions of the NativeMethods matrix of argument shapes and normal,
+ * {@code @FastNative} and {@code @CriticalNative} methods. Needs libartbenchmark, loaded with
+ * the BenchmarkRunner option --load-library=artbenchmark.
+ */
+public class MicroNativeBenchmark {
+    private final NativeMethods instance = new NativeMethods();
+    private final Object object = new Object();
+    private final int[] array = new int[] { 1 };
+
+    public void timeEmptyJniMethod0(int count) {
+        for (int i = 0; i < count; ++i) {
+            instance.emptyJniMethod0();
+        }
+    }
+
+    public void timeEmptyJniMethod6(int count) {
+        for (int i = 0; i < count; ++i) {
+            instance.emptyJniMethod6(i, 1, 2, 3, 4, 5);
+        }
+    }
+
+    public void timeEmptyJniMethod6L(int count) {
+        for (int i = 0; i < count; ++i) {
+            instance.emptyJniMethod6L(null, null, null, object, null, null);
+        }
+    }
+
+    public void timeEmptyJniStaticMethod0(int count) {
+        for (int i = 0; i < count; ++i) {
+            NativeMethods.emptyJniStaticMethod0();
+        }
+    }
+
+    public void timeEmptyJniStaticMethod6(int count) {
+        for (int i = 0; i < count; ++i) {
+            NativeMethods.emptyJniStaticMethod6(i, 1, 2, 3, 4, 5);
+        }
+    }
+
+    public void timeEmptyJniStaticMethod6L(int count) {
+        for (int i = 0; i < count; ++i) {
+            NativeMethods.emptyJniStaticMethod6L(null, null, null, object, null, null);
+        }
+    }
+
+    public void timeEmptyJniMethod0Fast(int count) {
+        for (int i = 0; i < count; ++i) {
+            instance.emptyJniMethod0_Fast();
+        }
+    }
+
+    public void timeEmptyJniMethod6Fast(int count) {
+        for (int i = 0; i < count; ++i) {
+            instance.emptyJniMethod6_Fast(i, 1, 2, 3, 4, 5);
+        }
+    }
+
+    public void timeEmptyJniMethod6LFast(int count) {
+        for (int i = 0; i < count; ++i) {
+            instance.emptyJniMethod6L_Fast(null, null, null, object, null, null);
+        }
+    }
+
+    public void timeEmptyJniStaticMethod0Fast(int count) {
+        for (int i = 0; i < count; ++i) {
+            NativeMethods.emptyJniStaticMethod0_Fast();
+        }
+    }
+
+    public void timeEmptyJniStaticMethod6Fast(int count) {
+        for (int i = 0; i < count; ++i) {
+            NativeMethods.emptyJniStaticMethod6_Fast(i, 1, 2, 3, 4, 5);
+        }
+    }
+
+    public void timeEmptyJniStaticMethod6LFast(int count) {
+        for (int i = 0; i < count; ++i) {
+            NativeMethods.emptyJniStaticMethod6L_Fast(null, null, null, object, null, null);
+        }
+    }
+
+    public void timeEmptyJniStaticMethod0Critical(int count) {
+        for (int i = 0; i < count; ++i) {
+            NativeMethods.emptyJniStaticMethod0_Critical();
+        }
+    }
+
+    public void timeEmptyJniStaticMethod6Critical(int count) {
+        for (int i = 0; i < count; ++i) {
+            NativeMethods.emptyJniStaticMethod6_Critical(i, 1, 2, 3, 4, 5);
+        }
+    }
+
+    public void timeEmptyJniSynchronizedMethod0(int count) {
+        for (int i = 0; i < count; ++i) {
+            instance.emptyJniSynchronizedMethod0();
+        }
+    }
+
+    public void timeEmptyJniStaticSynchronizedMethod0(int count) {
+        for (int i = 0; i < count; ++i) {
+            NativeMethods.emptyJniStaticSynchronizedMethod0();
+        }
+    }
+
+    public void timeJniStatic8J(int count) {
+        long sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += NativeMethods.jniStatic8J(i, 1L, 2L, 3L, 4L, 5L, 6L, 7L);
+        }
+        check(sum == (long) count * (count - 1) / 2);
+    }
+
+    public void timeJniStatic8D(int count) {
+        double sum = 0.0;
+        for (int i = 0; i < count; ++i) {
+            sum += NativeMethods.jniStatic8D(1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, i);
+        }
+        check(sum == count);
+    }
+
+    public void timeJniStatic12D(int count) {
+        double sum = 0.0;
+        for (int i = 0; i < count; ++i) {
+            sum += NativeMethods.jniStatic12D(
+                    i, 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0, 1.0);
+        }
+        check(sum == count);
+    }
+
+    public void timeJniStatic16Mixed(int count) {
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += NativeMethods.jniStatic16Mixed(
+                    i, 1L, 2.0f, 3.0, 4, 5L, 6.0f, 7.0, 8, 9L, 10.0f, 11.0, 1, 13L, 14.0f, 15.0);
+        }
+        check(sum == count);
+    }
+
+    public void timeJniStatic8JFast(int count) {
+        long sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += NativeMethods.jniStatic8J_Fast(i, 1L, 2L, 3L, 4L, 5L, 6L, 7L);
+        }
+        check(sum == (long) count * (count - 1) / 2);
+    }
+
+    public void timeJniStatic8DFast(int count) {
+        double sum = 0.0;
+        for (int i = 0; i < count; ++i) {
+            sum += NativeMethods.jniStatic8D_Fast(1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, i);
+        }
+        check(sum == count);
+    }
+
+    public void timeJniStatic12DFast(int count) {
+        double sum = 0.0;
+        for (int i = 0; i < count; ++i) {
+            sum += NativeMethods.jniStatic12D_Fast(
+                    i, 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0, 1.0);
+        }
+        check(sum == count);
+    }
+
+    public void timeJniStatic16MixedFast(int count) {
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += NativeMethods.jniStatic16Mixed_Fast(
+                    i, 1L, 2.0f, 3.0, 4, 5L, 6.0f, 7.0, 8, 9L, 10.0f, 11.0, 1, 13L, 14.0f, 15.0);
+        }
+        check(sum == count);
+    }
+
+    public void timeJniStatic8JCritical(int count) {
+        long sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += NativeMethods.jniStatic8J_Critical(i, 1L, 2L, 3L, 4L, 5L, 6L, 7L);
+        }
+        check(sum == (long) count * (count - 1) / 2);
+    }
+
+    public void timeJniStatic8DCritical(int count) {
+        double sum = 0.0;
+        for (int i = 0; i < count; ++i) {
+            sum += NativeMethods.jniStatic8D_Critical(1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, i);
+        }
+        check(sum == count);
+    }
+
+    public void timeJniStatic12DCritical(int count) {
+        double sum = 0.0;
+        for (int i = 0; i < count; ++i) {
+            sum += NativeMethods.jniStatic12D_Critical(
+                    i, 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0, 1.0);
+        }
+        check(sum == count);
+    }
+
+    public void timeJniStatic16MixedCritical(int count) {
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += NativeMethods.jniStatic16Mixed_Critical(
+                    i, 1L, 2.0f, 3.0, 4, 5L, 6.0f, 7.0, 8, 9L, 10.0f, 11.0, 1, 13L, 14.0f, 15.0);
+        }
+        check(sum == count);
+    }
+
+    public void timeJniStaticReturnObject(int count) {
+        Object last = null;
+        for (int i = 0; i < count; ++i) {
+            last = NativeMethods.jniStaticReturnObject(object);
+        }
+        check(count == 0 || last == object);
+    }
+
+    public void timeJniStaticArrayCritical(int count) {
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += NativeMethods.jniStaticArrayCritical(array);
+        }
+        check(sum == count);
+    }
+
+    public void timeJniStaticReturnObjectFast(int count) {
+        Object last = null;
+        for (int i = 0; i < count; ++i) {
+            last = NativeMethods.jniStaticReturnObject_Fast(object);
+        }
+        check(count == 0 || last == object);
+    }
+
+    public void timeJniStaticArrayCriticalFast(int count) {
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += NativeMethods.jniStaticArrayCritical_Fast(array);
+        }
+        check(sum == count);
+    }
+
+    private static void check(boolean condition) {
+        if (!condition) {
+            throw new AssertionError();
+        }
+    }
+}
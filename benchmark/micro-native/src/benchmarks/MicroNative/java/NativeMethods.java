@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package benchmarks.MicroNative.java;
+
+import dalvik.annotation.optimization.CriticalNative;
+import dalvik.annotation.optimization.FastNative;
+
+/**
+ * The native methods registered by micro_native.cc. The jniStatic* methods form a matrix of
+ * argument shapes and JNI transition kinds: each shape has a normal, a {@code _Fast} and, for
+ * primitive shapes, a {@code _Critical} variant. The shapes with 12 doubles and with 16 mixed
+ * arguments exceed the argument registers of the managed and native calling conventions, so
+ * the JNI stubs have to move some of the arguments between registers and the stack.
+ */
+public class NativeMethods {
+    public static synchronized native void emptyJniStaticSynchronizedMethod0();
+    public synchronized native void emptyJniSynchronizedMethod0();
+
+    public native void emptyJniMethod0();
+    public native void emptyJniMethod6(int a, int b, int c, int d, int e, int f);
+    public native void emptyJniMethod6L(String a, String[] b, int[][] c, Object d, Object[] e,
+                                        Object[][][][] f);
+    public static native void emptyJniStaticMethod6L(String a, String[] b, int[][] c, Object d,
+                                                     Object[] e, Object[][][][] f);
+    public static native void emptyJniStaticMethod0();
+    public static native void emptyJniStaticMethod6(int a, int b, int c, int d, int e, int f);
+
+    @FastNative
+    public native void emptyJniMethod0_Fast();
+    @FastNative
+    public native void emptyJniMethod6_Fast(int a, int b, int c, int d, int e, int f);
+    @FastNative
+    public native void emptyJniMethod6L_Fast(String a, String[] b, int[][] c, Object d,
+                                             Object[] e, Object[][][][] f);
+    @FastNative
+    public static native void emptyJniStaticMethod6L_Fast(String a, String[] b, int[][] c,
+                                                          Object d, Object[] e, Object[][][][] f);
+    @FastNative
+    public static native void emptyJniStaticMethod0_Fast();
+    @FastNative
+    public static native void emptyJniStaticMethod6_Fast(int a, int b, int c, int d, int e, int f);
+
+    @CriticalNative
+    public static native void emptyJniStaticMethod0_Critical();
+    @CriticalNative
+    public static native void emptyJniStaticMethod6_Critical(int a, int b, int c, int d, int e,
+                                                             int f);
+
+    // 8 longs, filling the integer argument registers of the native calling conventions.
+    public static native long jniStatic8J(long a, long b, long c, long d, long e, long f, long g,
+                                          long h);
+    @FastNative
+    public static native long jniStatic8J_Fast(long a, long b, long c, long d, long e, long f,
+                                               long g, long h);
+    @CriticalNative
+    public static native long jniStatic8J_Critical(long a, long b, long c, long d, long e, long f,
+                                                   long g, long h);
+
+    // 8 doubles, filling the floating point argument registers.
+    public static native double jniStatic8D(double a, double b, double c, double d, double e,
+                                            double f, double g, double h);
+    @FastNative
+    public static native double jniStatic8D_Fast(double a, double b, double c, double d, double e,
+                                                 double f, double g, double h);
+    @CriticalNative
+    public static native double jniStatic8D_Critical(double a, double b, double c, double d,
+                                                     double e, double f, double g, double h);
+
+    // 12 doubles. On riscv64, native calls pass the doubles that do not fit into FP registers
+    // in integer registers, on arm64 and x86-64 on the stack.
+    public static native double jniStatic12D(double a, double b, double c, double d, double e,
+                                             double f, double g, double h, double i, double j,
+                                             double k, double l);
+    @FastNative
+    public static native double jniStatic12D_Fast(double a, double b, double c, double d,
+                                                  double e, double f, double g, double h,
+                                                  double i, double j, double k, double l);
+    @CriticalNative
+    public static native double jniStatic12D_Critical(double a, double b, double c, double d,
+                                                      double e, double f, double g, double h,
+                                                      double i, double j, double k, double l);
+
+    // 16 mixed arguments, some of them on the stack in both calling conventions.
+    public static native int jniStatic16Mixed(int a, long b, float c, double d, int e, long f,
+                                              float g, double h, int i, long j, float k,
+                                              double l, int m, long n, float o, double p);
+    @FastNative
+    public static native int jniStatic16Mixed_Fast(int a, long b, float c, double d, int e,
+                                                   long f, float g, double h, int i, long j,
+                                                   float k, double l, int m, long n, float o,
+                                                   double p);
+    @CriticalNative
+    public static native int jniStatic16Mixed_Critical(int a, long b, float c, double d, int e,
+                                                       long f, float g, double h, int i, long j,
+                                                       float k, double l, int m, long n, float o,
+                                                       double p);
+
+    // Reference arguments and results, which @CriticalNative does not allow.
+    public static native Object jniStaticReturnObject(Object a);
+    @FastNative
+    public static native Object jniStaticReturnObject_Fast(Object a);
+
+    // GetPrimitiveArrayCritical() and ReleasePrimitiveArrayCritical() of the argument.
+    public static native int jniStaticArrayCritical(int[] a);
+    @FastNative
+    public static native int jniStaticArrayCritical_Fast(int[] a);
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class MonitorBenchmark {
+    private final Object lock = new Object();
+    private final Object inflatedLock = new Object();
+    private int counter;
+
+    public MonitorBenchmark() {
+        // Inflate the lock by taking its hash code while holding it.
+        synchronized (inflatedLock) {
+            inflatedLock.hashCode();
+        }
+    }
+
+    private synchronized void $noinline$synchronizedIncrement() {
+        ++counter;
+    }
+
+    public void timeUncontendedThinLock(int count) {
+        Object l = lock;
+        for (int i = 0; i < count; ++i) {
+            synchronized (l) {
+                ++counter;
+            }
+        }
+    }
+
+    public void timeNestedThinLock(int count) {
+        Object l = lock;
+        for (int i = 0; i < count; ++i) {
+            synchronized (l) {
+                synchronized (l) {
+                    ++counter;
+                }
+            }
+        }
+    }
+
+    public void timeUncontendedFatLock(int count) {
+        Object l = inflatedLock;
+        for (int i = 0; i < count; ++i) {
+            synchronized (l) {
+                ++counter;
+            }
+        }
+    }
+
+    public void timeSynchronizedMethod(int count) {
+        for (int i = 0; i < count; ++i) {
+            $noinline$synchronizedIncrement();
+        }
+    }
+
+    public void timeStringBufferAppend(int count) {
+        StringBuffer sb = new StringBuffer();
+        for (int i = 0; i < count; ++i) {
+            sb.append('x');
+            if (sb.length() == 1024) {
+                sb.setLength(0);
+            }
+        }
+    }
+
+    // Two threads alternately take the same lock.
+    public void timeContendedLock(int count) throws InterruptedException {
+        final int half = count / 2;
+        final Object l = lock;
+        Thread other = new Thread() {
+            public void run() {
+                for (int i = 0; i < half; ++i) {
+                    synchronized (l) {
+                        ++counter;
+                    }
+                }
+            }
+        };
+        other.start();
+        for (int i = 0; i < count - half; ++i) {
+            synchronized (l) {
+                ++counter;
+            }
+        }
+        other.join();
+    }
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.invoke.MethodHandle;
+import java.lang.invoke.MethodHandles;
+import java.lang.invoke.MethodType;
+import java.lang.invoke.VarHandle;
+import java.lang.reflect.Constructor;
+import java.lang.reflect.Field;
+import java.lang.reflect.Method;
+
+public class ReflectionBenchmark {
+    public static class Target {
+        public Target() {}
+    }
+
+    public int field = 1;
+
+    public int add(int a, int b) {
+        return a + b;
+    }
+
+    public static int staticAdd(int a, int b) {
+        return a + b;
+    }
+
+    private final Method addMethod;
+    private final Method staticAddMethod;
+    private final Field intField;
+    private final Constructor<Target> constructor;
+    private final MethodHandle addHandle;
+    private final MethodHandle staticAddHandle;
+    private final VarHandle fieldHandle;
+
+    public ReflectionBenchmark() throws Exception {
+        addMethod = ReflectionBenchmark.class.getMethod("add", int.class, int.class);
+        staticAddMethod = ReflectionBenchmark.class.getMethod("staticAdd", int.class, int.class);
+        intField = ReflectionBenchmark.class.getField("field");
+        constructor = Target.class.getConstructor();
+        MethodHandles.Lookup lookup = MethodHandles.lookup();
+        MethodType type = MethodType.methodType(int.class, int.class, int.class);
+        addHandle = lookup.findVirtual(ReflectionBenchmark.class, "add", type);
+        staticAddHandle = lookup.findStatic(ReflectionBenchmark.class, "staticAdd", type);
+        fieldHandle = lookup.findVarHandle(ReflectionBenchmark.class, "field", int.class);
+    }
+
+    private static void check(int sum, int count) {
+        if (sum != count) {
+            throw new AssertionError();
+        }
+    }
+
+    public void timeMethodInvoke(int count) throws Exception {
+        Method m = addMethod;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum = (Integer) m.invoke(this, sum, 1);
+        }
+        check(sum, count);
+    }
+
+    public void timeStaticMethodInvoke(int count) throws Exception {
+        Method m = staticAddMethod;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum = (Integer) m.invoke(null, sum, 1);
+        }
+        check(sum, count);
+    }
+
+    public void timeFieldGetInt(int count) throws Exception {
+        Field f = intField;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += f.getInt(this);
+        }
+        check(sum, count);
+    }
+
+    public void timeConstructorNewInstance(int count) throws Exception {
+        Constructor<Target> c = constructor;
+        for (int i = 0; i < count; ++i) {
+            c.newInstance();
+        }
+    }
+
+    public void timeGetDeclaredMethod(int count) throws Exception {
+        for (int i = 0; i < count; ++i) {
+            ReflectionBenchmark.class.getDeclaredMethod("add", int.class, int.class);
+        }
+    }
+
+    public void timeMethodHandleInvokeExact(int count) throws Throwable {
+        MethodHandle mh = addHandle;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum = (int) mh.invokeExact(this, sum, 1);
+        }
+        check(sum, count);
+    }
+
+    public void timeStaticMethodHandleInvokeExact(int count) throws Throwable {
+        MethodHandle mh = staticAddHandle;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum = (int) mh.invokeExact(sum, 1);
+        }
+        check(sum, count);
+    }
+
+    public void timeMethodHandleInvokeWithConversion(int count) throws Throwable {
+        MethodHandle mh = staticAddHandle;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            Integer boxed = (Integer) mh.invoke((Integer) sum, 1);
+            sum = boxed;
+        }
+        check(sum, count);
+    }
+
+    public void timeVarHandleGet(int count) {
+        VarHandle vh = fieldHandle;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += (int) vh.get(this);
+        }
+        check(sum, count);
+    }
+}
@@ -0,0 +1,169 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2023 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Runs the ART benchmarks on a device in several execution modes.
+
+Build the benchmarks with `m art-benchmarks`, then for example:
+
+  art/benchmark/run-benchmarks.py --output=results.json
+  art/benchmark/run-benchmarks.py --modes=jit,aot --filter=Invoke --baseline=results.json
+
+The results of all modes are written as one JSON file. With --baseline, the results are
+compared with a previous results file and the script fails if any benchmark regressed by
+more than the threshold.
+"""
+
+import argparse
+import json
+import os
+import shlex
+import subprocess
+import sys
+
+DEVICE_DIR = '/data/local/tmp/art-benchmarks'
+JAR_NAME = 'art-benchmarks.jar'
+
+# Runtime options for each mode. The AOT mode compiles the jar with dex2oat first, the
+# other modes run without an oat file.
+MODES = {
+  'interpreter': ['-Xint'],
+  'nterp': ['-Xusejit:false'],
+  'jit': ['-Xusejit:true'],
+  'aot': ['-Xusejit:false'],
+}
+
+def parse_args():
+  parser = argparse.ArgumentParser(description='Run the ART benchmarks on a device.')
+  parser.add_argument('--jar',
+                      help='The art-benchmarks jar, by default from $ANDROID_PRODUCT_OUT.')
+  parser.add_argument('--modes', default=','.join(MODES),
+                      help='Comma-separated execution modes, from: ' + ', '.join(MODES))
+  parser.add_argument('--isa', help='Instruction set, by default the primary device ABI.')
+  parser.add_argument('--filter', help='Only run benchmarks matching this regex.')
+  parser.add_argument('--benchmarks', help='Comma-separated benchmark classes to run.')
+  parser.add_argument('--warmup-ms', type=int, help='Warmup time for each benchmark.')
+  parser.add_argument('--round-ms', type=int, help='Duration of each measured round.')
+  parser.add_argument('--rounds', type=int, help='Number of measured rounds.')
+  parser.add_argument('--jni', action='store_true',
+                      help='Load libartbenchmark and also run the JNI benchmarks.')
+  parser.add_argument('--output', help='Write the results to this JSON file.')
+  parser.add_argument('--baseline', help='Compare the results with this JSON file.')
+  parser.add_argument('--threshold', type=float, default=5.0,
+                      help='Regression threshold in percent for --baseline, default 5.')
+  return parser.parse_args()
+
+def adb(*args, check=True):
+  cmd = ['adb'] + list(args)
+  return subprocess.run(cmd, check=check, stdout=subprocess.PIPE, universal_newlines=True).stdout
+
+def adb_shell(command, check=True):
+  return adb('shell', command, check=check)
+
+def get_isa():
+  abi = adb_shell('getprop ro.product.cpu.abi').strip()
+  return {'arm64-v8a': 'arm64', 'armeabi-v7a': 'arm', 'x86': 'x86', 'x86_64': 'x86_64',
+          'riscv64': 'riscv64'}[abi]
+
+def is_64_bit(isa):
+  return isa in ('arm64', 'riscv64', 'x86_64')
+
+def run_mode(args, mode, isa):
+  device_jar = DEVICE_DIR + '/' + JAR_NAME
+  oat_dir = DEVICE_DIR + '/oat/' + isa
+  adb_shell('rm -rf ' + DEVICE_DIR + '/oat')
+  if mode == 'aot':
+    dex2oat = 'dex2oat64' if is_64_bit(isa) else 'dex2oat32'
+    odex = oat_dir + '/' + JAR_NAME.replace('.jar', '.odex')
+    adb_shell('mkdir -p %s && %s --dex-file=%s --oat-file=%s --instruction-set=%s '
+              '--compiler-filter=speed --class-loader-context=\'PCL[]\'' %
+              (oat_dir, dex2oat, device_jar, odex, isa))
+
+  runner_args = ['--mode=' + mode]
+  if args.filter:
+    runner_args.append('--filter=' + args.filter)
+  for option in ('warmup_ms', 'round_ms', 'rounds'):
+    value = getattr(args, option)
+    if value is not None:
+      runner_args.append('--%s=%d' % (option.replace('_', '-'), value))
+  if args.jni:
+    runner_args.append('--load-library=artbenchmark')
+  if args.benchmarks:
+    runner_args.extend(args.benchmarks.split(','))
+
+  command = ['dalvikvm64' if is_64_bit(isa) else 'dalvikvm32'] + MODES[mode]
+  command += ['-cp', device_jar, 'BenchmarkRunner'] + runner_args
+  print('Running ' + mode + ' benchmarks', file=sys.stderr)
+  output = adb_shell(' '.join(shlex.quote(arg) for arg in command), check=False)
+  results = []
+  for line in output.splitlines():
+    line = line.strip()
+    if line.startswith('{'):
+      result = json.loads(line)
+      print('  %-60s %12.2f ns' % (result['benchmark'], result['ns_per_op']), file=sys.stderr)
+      results.append(result)
+  return results
+
+def compare_with_baseline(results, baseline, threshold):
+  """Prints the changes from the baseline and returns the number of regressions."""
+  baseline_results = {(r['benchmark'], r['mode']): r for r in baseline['results']}
+  regressions = 0
+  for result in results:
+    base = baseline_results.get((result['benchmark'], result['mode']))
+    if base is None or base['ns_per_op'] == 0:
+      continue
+    change = (result['ns_per_op'] / base['ns_per_op'] - 1.0) * 100.0
+    marker = ''
+    if change > threshold:
+      marker = '  REGRESSION'
+      regressions += 1
+    print('%-12s %-60s %+7.1f%%%s' % (result['mode'], result['benchmark'], change, marker))
+  return regressions
+
+def main():
+  args = parse_args()
+  jar = args.jar
+  if jar is None:
+    product_out = os.environ.get('ANDROID_PRODUCT_OUT')
+    if product_out is None:
+      sys.exit('Specify --jar or set ANDROID_PRODUCT_OUT.')
+    jar = os.path.join(product_out, 'system', 'framework', JAR_NAME)
+  modes = args.modes.split(',')
+  for mode in modes:
+    if mode not in MODES:
+      sys.exit('Unknown mode ' + mode)
+  isa = args.isa or get_isa()
+
+  adb_shell('mkdir -p ' + DEVICE_DIR)
+  adb('push', jar, DEVICE_DIR + '/' + JAR_NAME)
+  results = []
+  for mode in modes:
+    results.extend(run_mode(args, mode, isa))
+
+  output = {'isa': isa, 'results': results}
+  if args.output:
+    with open(args.output, 'w') as f:
+      json.dump(output, f, indent=2)
+  if args.baseline:
+    with open(args.baseline) as f:
+      baseline = json.load(f)
+    if baseline.get('isa') != isa:
+      print('Warning: baseline is for ' + str(baseline.get('isa')), file=sys.stderr)
+    regressions = compare_with_baseline(results, baseline, args.threshold)
+    if regressions != 0:
+      sys.exit('%d benchmark(s) regressed by more than %.1f%%' % (regressions, args.threshold))
+
+if __name__ == '__main__':
+  main()
@@ -113,10 +113,114 @@ public class StringIndexOfBenchmark {
         }
     }
 
+    // The same chars as `string36` with a trailing non-Latin-1 char, so not compressed.
+    public static final String string36Utf16 = string36 + "\u0100";  // length = 37
+    public static final String string36Copy = new String(string36.toCharArray());
+    public static final String string36Mismatch = string36.substring(0, 35) + "_";
+
+    public void timeIndexOfVUncompressed(int count) {
+        final char c = 'V';
+        String s = string36Utf16;
+        for (int i = 0; i < count; ++i) {
+            $noinline$indexOf(s, c);
+        }
+    }
+
+    public void timeIndexOf_Uncompressed(int count) {
+        final char c = '_';
+        String s = string36Utf16;
+        for (int i = 0; i < count; ++i) {
+            $noinline$indexOf(s, c);
+        }
+    }
+
+    public void timeCompareToCompressed(int count) {
+        String lhs = string36Copy;
+        String rhs = string36Mismatch;
+        for (int i = 0; i < count; ++i) {
+            $noinline$compareTo(lhs, rhs);
+        }
+    }
+
+    public void timeCompareToMixed(int count) {
+        String lhs = string36;
+        String rhs = string36Utf16;
+        for (int i = 0; i < count; ++i) {
+            $noinline$compareTo(lhs, rhs);
+        }
+    }
+
+    public void timeCompareToUncompressed(int count) {
+        String lhs = string36Utf16;
+        String rhs = new String(string36Utf16.toCharArray());
+        for (int i = 0; i < count; ++i) {
+            $noinline$compareTo(lhs, rhs);
+        }
+    }
+
+    public void timeEqualsCompressed(int count) {
+        String lhs = string36;
+        String rhs = string36Copy;
+        for (int i = 0; i < count; ++i) {
+            $noinline$equals(lhs, rhs);
+        }
+    }
+
+    public void timeEqualsUncompressed(int count) {
+        String lhs = string36Utf16;
+        String rhs = new String(string36Utf16.toCharArray());
+        for (int i = 0; i < count; ++i) {
+            $noinline$equals(lhs, rhs);
+        }
+    }
+
+    public void timeRegionMatchesMixed(int count) {
+        String lhs = string36;
+        String rhs = string36Utf16;
+        for (int i = 0; i < count; ++i) {
+            $noinline$regionMatches(lhs, rhs);
+        }
+    }
+
+    // String.hashCode() is cached in the String, so hash new strings of the same chars.
+    public void timeHashCodeCompressed(int count) {
+        char[] chars = string36.toCharArray();
+        for (int i = 0; i < count; ++i) {
+            $noinline$hashCode(new String(chars));
+        }
+    }
+
+    public void timeHashCodeUncompressed(int count) {
+        char[] chars = string36Utf16.toCharArray();
+        for (int i = 0; i < count; ++i) {
+            $noinline$hashCode(new String(chars));
+        }
+    }
+
     static int $noinline$indexOf(String s, char c) {
         if (doThrow) { throw new Error(); }
         return s.indexOf(c);
     }
 
+    static int $noinline$compareTo(String lhs, String rhs) {
+        if (doThrow) { throw new Error(); }
+        return lhs.compareTo(rhs);
+    }
+
+    static boolean $noinline$equals(String lhs, String rhs) {
+        if (doThrow) { throw new Error(); }
+        return lhs.equals(rhs);
+    }
+
+    static boolean $noinline$regionMatches(String lhs, String rhs) {
+        if (doThrow) { throw new Error(); }
+        return lhs.regionMatches(1, rhs, 1, 34);
+    }
+
+    static int $noinline$hashCode(String s) {
+        if (doThrow) { throw new Error(); }
+        return s.hashCode();
+    }
+
     public static boolean doThrow = false;
 }
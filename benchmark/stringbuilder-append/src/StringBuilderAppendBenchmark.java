@@ -24,6 +24,8 @@ public class StringBuilderAppendBenchmark {
     public static double double2 = 1.0E308;
     public static float float1 = 42.0f;
     public static float float2 = 1.0E38f;
+    public static Integer boxedInt1 = 4242;
+    public static Long boxedLong1 = -42L;
 
     public void timeAppendStrings(int count) {
         String s1 = string1;
@@ -133,4 +135,33 @@ public class StringBuilderAppendBenchmark {
             throw new AssertionError();
         }
     }
+
+    public void timeAppendStringAndBoxedInts(int count) {
+        String s1 = string1;
+        Integer b1 = boxedInt1;
+        Long b2 = boxedLong1;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            String result = s1 + b1 + b2;
+            sum += result.length();  // Make sure the append is not optimized away.
+        }
+        if (sum != count * (s1.length() + b1.toString().length() + b2.toString().length())) {
+            throw new AssertionError();
+        }
+    }
+
+    public void timeAppendLongChain(int count) {
+        String s1 = string1;
+        String s2 = string2;
+        int i1 = int1;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            // Twelve appended values, more than fit in one fused append.
+            String result = s1 + i1 + s2 + i1 + s1 + i1 + s2 + i1 + s1 + i1 + s2 + i1;
+            sum += result.length();  // Make sure the append is not optimized away.
+        }
+        if (sum != count * 3 * (s1.length() + s2.length() + 2 * Integer.toString(i1).length())) {
+            throw new AssertionError();
+        }
+    }
 }
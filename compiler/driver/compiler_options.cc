@@ -60,10 +60,14 @@ CompilerOptions::CompilerOptions()
       implicit_null_checks_(true),
       implicit_so_checks_(true),
       implicit_suspend_checks_(false),
+      explicit_suspend_checks_(false),
       compile_pic_(false),
       dump_timings_(false),
       dump_pass_timings_(false),
       dump_stats_(false),
+      dump_pass_profile_file_name_(""),
+      dump_pass_profile_methods_(20u),
+      dump_code_quality_file_name_(""),
       top_k_profile_threshold_(kDefaultTopKProfileThreshold),
       profile_compilation_info_(nullptr),
       verbose_methods_(),
@@ -120,11 +124,17 @@ bool CompilerOptions::ParseRegisterAllocationStrategy(const std::string& option,
                                                       std::string* error_msg) {
   if (option == "linear-scan") {
     register_allocation_strategy_ = RegisterAllocator::Strategy::kRegisterAllocatorLinearScan;
+  } else if (option == "linear-scan-spill-costs") {
+    register_allocation_strategy_ =
+        RegisterAllocator::Strategy::kRegisterAllocatorLinearScanSpillCosts;
+  } else if (option == "local") {
+    register_allocation_strategy_ = RegisterAllocator::Strategy::kRegisterAllocatorLocal;
   } else if (option == "graph-color") {
     LOG(ERROR) << "Graph coloring allocator has been removed, using linear scan instead.";
     register_allocation_strategy_ = RegisterAllocator::Strategy::kRegisterAllocatorLinearScan;
   } else {
-    *error_msg = "Unrecognized register allocation strategy. Try linear-scan, or graph-color.";
+    *error_msg = "Unrecognized register allocation strategy. Try linear-scan, "
+                 "linear-scan-spill-costs, local, or graph-color.";
     return false;
   }
   return true;
@@ -44,6 +44,10 @@ namespace linker {
 class Arm64RelativePatcherTest;
 }  // namespace linker
 
+namespace mirror {
+class Class;
+}  // namespace mirror
+
 class ArtMethod;
 class DexFile;
 enum class InstructionSet;
@@ -61,6 +65,9 @@ class CompilerOptions final {
  public:
   // Guide heuristics to determine whether to compile method if profile data not available.
   static const size_t kDefaultHugeMethodThreshold = 10000;
+  // Hot methods, by the profile or by a JIT hotness counter, are compiled up to this multiple
+  // of the huge method threshold.
+  static const size_t kHotHugeMethodThresholdFactor = 4;
   static const size_t kDefaultLargeMethodThreshold = 600;
   static const size_t kDefaultNumDexMethodsThreshold = 900;
   static constexpr double kDefaultTopKProfileThreshold = 90.0;
@@ -130,6 +137,11 @@ class CompilerOptions final {
     return num_dalvik_instructions > huge_method_threshold_;
   }
 
+  // Whether a huge method is too large to be compiled even if it is hot.
+  bool IsTooHugeToCompileEvenIfHot(size_t num_dalvik_instructions) const {
+    return num_dalvik_instructions > huge_method_threshold_ * kHotHugeMethodThresholdFactor;
+  }
+
   bool IsLargeMethod(size_t num_dalvik_instructions) const {
     return num_dalvik_instructions > large_method_threshold_;
   }
@@ -207,6 +219,13 @@ class CompilerOptions final {
     return implicit_suspend_checks_;
   }
 
+  // Whether implicit suspend checks were disabled with --explicit-suspend-checks. Code with
+  // explicit checks also works when the runtime uses implicit ones, as it then still sets the
+  // thread flags in addition to clearing the suspend trigger.
+  bool GetExplicitSuspendChecks() const {
+    return explicit_suspend_checks_;
+  }
+
   bool IsGeneratingImage() const {
     return IsBootImage() || IsBootImageExtension() || IsAppImage();
   }
@@ -296,6 +315,12 @@ class CompilerOptions final {
 
   EXPORT bool IsImageClass(const char* descriptor) const;
 
+  // Returns whether `klass` is a boot image class with a type check bitstring assigned
+  // in the boot image, so that AOT compiled code can embed the bitstring.
+  bool HasBootImageTypeCheckBitstring(const mirror::Class* klass) const {
+    return boot_image_bitstring_classes_.find(klass) != boot_image_bitstring_classes_.end();
+  }
+
   // Returns whether the given `pretty_descriptor` is in the list of preloaded
   // classes. `pretty_descriptor` should be the result of calling `PrettyDescriptor`.
   EXPORT bool IsPreloadedClass(const char* pretty_descriptor) const;
@@ -348,6 +373,18 @@ class CompilerOptions final {
     return dump_pass_timings_;
   }
 
+  const std::string& GetDumpPassProfileFileName() const {
+    return dump_pass_profile_file_name_;
+  }
+
+  size_t GetDumpPassProfileMethods() const {
+    return dump_pass_profile_methods_;
+  }
+
+  const std::string& GetDumpCodeQualityFileName() const {
+    return dump_code_quality_file_name_;
+  }
+
   bool GetDumpStats() const {
     return dump_stats_;
   }
@@ -392,6 +429,8 @@ class CompilerOptions final {
   EXPORT bool ParseRegisterAllocationStrategy(const std::string& option, std::string* error_msg);
 
   CompilerFilter::Filter compiler_filter_;
+  // Methods above this size are not compiled, unless they are hot and at most
+  // kHotHugeMethodThresholdFactor times this size.
   size_t huge_method_threshold_;
   size_t large_method_threshold_;
   size_t num_dex_methods_threshold_;
@@ -416,6 +455,10 @@ class CompilerOptions final {
   // boot image extension compilation.
   HashSet<std::string> preloaded_classes_;
 
+  // Boot image classes with a type check bitstring assigned in the boot image, recorded by
+  // dex2oat before compiling an app or a boot image extension.
+  HashSet<const mirror::Class*> boot_image_bitstring_classes_;
+
   CompilerType compiler_type_;
   ImageType image_type_;
   bool multi_image_;
@@ -428,11 +471,21 @@ class CompilerOptions final {
   bool implicit_null_checks_;
   bool implicit_so_checks_;
   bool implicit_suspend_checks_;
+  // Poll the thread flags even where the ISA defaults to implicit suspend checks.
+  bool explicit_suspend_checks_;
   bool compile_pic_;
   bool dump_timings_;
   bool dump_pass_timings_;
   bool dump_stats_;
 
+  // Write the aggregated pass profile to this file if not empty, with this many slowest methods.
+  std::string dump_pass_profile_file_name_;
+  unsigned int dump_pass_profile_methods_;
+
+  // Write the code size, spills and stack map sizes of every compiled method to this file if
+  // not empty.
+  std::string dump_code_quality_file_name_;
+
   // When using a profile file only the top K% of the profiled samples will be compiled.
   double top_k_profile_threshold_;
 
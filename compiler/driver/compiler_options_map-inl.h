@@ -82,7 +82,8 @@ inline bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string
     options->dump_cfg_append_ = true;
   }
   if (map.Exists(Base::RegisterAllocationStrategy)) {
-    if (!options->ParseRegisterAllocationStrategy(*map.Get(Base::DumpInitFailures), error_msg)) {
+    if (!options->ParseRegisterAllocationStrategy(*map.Get(Base::RegisterAllocationStrategy),
+                                                  error_msg)) {
       return false;
     }
   }
@@ -91,6 +92,9 @@ inline bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string
   if (map.Exists(Base::CountHotnessInCompiledCode)) {
     options->count_hotness_in_compiled_code_ = true;
   }
+  if (map.Exists(Base::ExplicitSuspendChecks)) {
+    options->explicit_suspend_checks_ = true;
+  }
   map.AssignIfExists(Base::ResolveStartupConstStrings, &options->resolve_startup_const_strings_);
   map.AssignIfExists(Base::InitializeAppImageClasses, &options->initialize_app_image_classes_);
   if (map.Exists(Base::CheckProfiledMethods)) {
@@ -106,6 +110,10 @@ inline bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string
     options->dump_pass_timings_ = true;
   }
 
+  map.AssignIfExists(Base::DumpPassProfile, &options->dump_pass_profile_file_name_);
+  map.AssignIfExists(Base::DumpPassProfileMethods, &options->dump_pass_profile_methods_);
+  map.AssignIfExists(Base::DumpCodeQuality, &options->dump_code_quality_file_name_);
+
   if (map.Exists(Base::DumpStats)) {
     options->dump_stats_ = true;
   }
@@ -179,6 +187,13 @@ inline void AddCompilerOptionsArgumentParserOptions(Builder& b) {
       .Define({"--count-hotness-in-compiled-code"})
           .IntoKey(Map::CountHotnessInCompiledCode)
 
+      .Define({"--explicit-suspend-checks"})
+          .WithHelp("Test the thread flags in suspend checks instead of loading from the\n"
+                    "suspend trigger, which faults to suspend the thread. This avoids one\n"
+                    "signal per thread in each suspension for slightly larger code.\n"
+                    "Only makes a difference on ISAs that default to implicit checks (arm64).")
+          .IntoKey(Map::ExplicitSuspendChecks)
+
       .Define({"--check-profiled-methods=_"})
           .template WithType<ProfileMethodsCheck>()
           .WithValueMap({{"log", ProfileMethodsCheck::kLog},
@@ -194,6 +209,22 @@ inline void AddCompilerOptionsArgumentParserOptions(Builder& b) {
                     " method.")
           .IntoKey(Map::DumpPassTimings)
 
+      .Define("--dump-pass-profile=_")
+          .template WithType<std::string>()
+          .WithHelp("Write the CPU time and arena memory of the optimization passes, summed over\n"
+                    "all compiled methods, and the slowest methods as JSON to the specified file.")
+          .IntoKey(Map::DumpPassProfile)
+      .Define("--dump-pass-profile-methods=_")
+          .template WithType<unsigned int>()
+          .WithHelp("The number of slowest methods reported by --dump-pass-profile, default 20.")
+          .IntoKey(Map::DumpPassProfileMethods)
+
+      .Define("--dump-code-quality=_")
+          .template WithType<std::string>()
+          .WithHelp("Write the code size, spill counts and stack map size of every method\n"
+                    "compiled by the optimizing compiler as JSON to the specified file.")
+          .IntoKey(Map::DumpCodeQuality)
+
       .Define({"--dump-stats"})
           .WithHelp("Display overall compilation statistics.")
           .IntoKey(Map::DumpStats)
@@ -233,6 +264,9 @@ inline void AddCompilerOptionsArgumentParserOptions(Builder& b) {
 
       .Define("--register-allocation-strategy=_")
           .template WithType<std::string>()
+          .WithHelp("linear-scan (default), linear-scan-spill-costs, which spills by\n"
+                    "loop-weighted use costs, or local, which keeps all values on the stack\n"
+                    "for faster baseline compiles. Otherwise the JIT always uses linear-scan.")
           .IntoKey(Map::RegisterAllocationStrategy)
 
       .Define("--resolve-startup-const-strings=_")
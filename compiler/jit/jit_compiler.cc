@@ -74,7 +74,8 @@ void JitCompiler::ParseCompilerOptions() {
 
   compiler_options_->implicit_null_checks_ = runtime->GetImplicitNullChecks();
   compiler_options_->implicit_so_checks_ = runtime->GetImplicitStackOverflowChecks();
-  compiler_options_->implicit_suspend_checks_ = runtime->GetImplicitSuspendChecks();
+  compiler_options_->implicit_suspend_checks_ =
+      runtime->GetImplicitSuspendChecks() && !compiler_options_->GetExplicitSuspendChecks();
 
   const InstructionSet instruction_set = compiler_options_->GetInstructionSet();
   if (kRuntimeISA == InstructionSet::kArm) {
@@ -205,6 +206,10 @@ bool JitCompiler::CompileMethod(
     runtime->GetMetrics()->JitMethodCompileCount()->AddOne();
     runtime->GetMetrics()->JitMethodCompileTotalTimeDelta()->Add(duration_us);
     runtime->GetMetrics()->JitMethodCompileCountDelta()->AddOne();
+    if (success) {
+      runtime->GetStartupTimeline()->MarkPhase(metrics::StartupPhase::kFirstJitCompilation,
+                                               runtime->GetMetrics());
+    }
   }
 
   // Trim maps to reduce memory usage.
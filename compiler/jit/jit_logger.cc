@@ -195,6 +195,9 @@ static uint32_t GetElfMach() {
 #elif defined(__aarch64__)
   static const uint32_t kElfMachARM64 = 0xB7;
   return kElfMachARM64;
+#elif defined(__riscv)
+  static const uint32_t kElfMachRISCV = 0xF3;
+  return kElfMachRISCV;
 #elif defined(__i386__)
   static const uint32_t kElfMachIA32 = 0x3;
   return kElfMachIA32;
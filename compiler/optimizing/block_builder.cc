@@ -20,6 +20,7 @@
 #include "dex/bytecode_utils.h"
 #include "dex/code_item_accessors-inl.h"
 #include "dex/dex_file_exception_helpers.h"
+#include "sparse_switch_tree.h"
 
 namespace art HIDDEN {
 
@@ -106,18 +107,27 @@ bool HBasicBlockBuilder::CreateBranchTargets() {
     } else if (instruction.IsSwitch()) {
       number_of_branches_++;  // count as at least one branch (b/77652521)
       DexSwitchTable table(instruction, dex_pc);
+      const bool build_tree = SparseSwitchTree::ShouldBuildTree(table);
       for (DexSwitchTableIterator s_it(table); !s_it.Done(); s_it.Advance()) {
         MaybeCreateBlockAt(dex_pc + s_it.CurrentTargetOffset());
 
         // Create N-1 blocks where we will insert comparisons of the input value
         // against the Switch's case keys.
-        if (table.ShouldBuildDecisionTree() && !s_it.IsLast()) {
+        if (table.ShouldBuildDecisionTree() && !build_tree && !s_it.IsLast()) {
           // Store the block under dex_pc of the current key at the switch data
           // instruction for uniqueness but give it the dex_pc of the SWITCH
           // instruction which it semantically belongs to.
           MaybeCreateBlockAt(dex_pc, s_it.GetDexPcForCurrentIndex());
         }
       }
+      if (build_tree) {
+        // Create the blocks of the non-root nodes of the tree, stored like above.
+        ScopedArenaAllocator allocator(local_allocator_->GetArenaStack());
+        SparseSwitchTree tree(table, &allocator);
+        for (size_t index = 1u; index != tree.GetNumberOfNodes(); ++index) {
+          MaybeCreateBlockAt(dex_pc, tree.GetStoreDexPcForNode(index));
+        }
+      }
     } else if (instruction.Opcode() == Instruction::MOVE_EXCEPTION) {
       // End the basic block after MOVE_EXCEPTION. This simplifies the later
       // stage of TryBoundary-block insertion.
@@ -182,6 +192,13 @@ void HBasicBlockBuilder::ConnectBasicBlocks() {
       block->AddSuccessor(graph_->GetExitBlock());
     } else if (instruction.IsSwitch()) {
       DexSwitchTable table(instruction, dex_pc);
+      if (SparseSwitchTree::ShouldBuildTree(table)) {
+        DCHECK(instruction.CanFlowThrough());
+        HBasicBlock* default_block = GetBlockAt(std::next(DexInstructionIterator(pair)).DexPc());
+        ConnectSparseSwitchTree(table, dex_pc, block, default_block);
+        block = nullptr;
+        continue;
+      }
       for (DexSwitchTableIterator s_it(table); !s_it.Done(); s_it.Advance()) {
         uint32_t target_dex_pc = dex_pc + s_it.CurrentTargetOffset();
         block->AddSuccessor(GetBlockAt(target_dex_pc));
@@ -211,6 +228,46 @@ void HBasicBlockBuilder::ConnectBasicBlocks() {
   graph_->AddBlock(graph_->GetExitBlock());
 }
 
+void HBasicBlockBuilder::ConnectSparseSwitchTree(const DexSwitchTable& table,
+                                                 uint32_t dex_pc,
+                                                 HBasicBlock* switch_block,
+                                                 HBasicBlock* default_block) {
+  ScopedArenaAllocator allocator(local_allocator_->GetArenaStack());
+  SparseSwitchTree tree(table, &allocator);
+  auto node_block = [&](size_t index) {
+    return (index == 0u) ? switch_block : GetBlockAt(tree.GetStoreDexPcForNode(index));
+  };
+  auto case_block = [&](size_t case_index) {
+    return (case_index == SparseSwitchTree::kDefaultCase)
+        ? default_block
+        : GetBlockAt(dex_pc + tree.GetTargetOffset(case_index));
+  };
+  // The nodes are in preorder, so the blocks are added after the blocks of their parents.
+  for (size_t index = 0u; index != tree.GetNumberOfNodes(); ++index) {
+    HBasicBlock* block = node_block(index);
+    if (index != 0u) {
+      graph_->AddBlock(block);
+    }
+    const SparseSwitchTree::Node& node = tree.GetNode(index);
+    switch (node.kind) {
+      case SparseSwitchTree::NodeKind::kLessThan:
+        block->AddSuccessor(node_block(node.left));
+        block->AddSuccessor(node_block(node.right));
+        break;
+      case SparseSwitchTree::NodeKind::kEqual:
+        block->AddSuccessor(case_block(node.first_case));
+        block->AddSuccessor(default_block);
+        break;
+      case SparseSwitchTree::NodeKind::kPackedSwitch:
+        tree.VisitJumpTable(node, [&](size_t case_index) {
+          block->AddSuccessor(case_block(case_index));
+        });
+        block->AddSuccessor(default_block);
+        break;
+    }
+  }
+}
+
 // Returns the TryItem stored for `block` or nullptr if there is no info for it.
 static const dex::TryItem* GetTryItem(
     HBasicBlock* block,
@@ -26,6 +26,8 @@
 
 namespace art HIDDEN {
 
+class DexSwitchTable;
+
 class HBasicBlockBuilder : public ValueObject {
  public:
   HBasicBlockBuilder(HGraph* graph,
@@ -56,6 +58,12 @@ class HBasicBlockBuilder : public ValueObject {
 
   bool CreateBranchTargets();
   void ConnectBasicBlocks();
+  // Connects the blocks of the SparseSwitchTree of the switch at `dex_pc`, the root of
+  // which is `switch_block`.
+  void ConnectSparseSwitchTree(const DexSwitchTable& table,
+                               uint32_t dex_pc,
+                               HBasicBlock* switch_block,
+                               HBasicBlock* default_block);
   void InsertTryBoundaryBlocks();
 
   // To ensure branches with negative offsets can always OSR jump to compiled
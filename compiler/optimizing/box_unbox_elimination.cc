@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "box_unbox_elimination.h"
+
+#include "base/arena_bit_vector.h"
+#include "base/bit_vector-inl.h"
+#include "base/scoped_arena_allocator.h"
+#include "base/scoped_arena_containers.h"
+#include "mirror/object.h"
+#include "nodes.h"
+#include "optimizing_compiler_stats.h"
+
+namespace art HIDDEN {
+
+// `value` is the only instance field of `java.lang.Integer`, right after the object header.
+static constexpr uint32_t kIntegerValueOffset = mirror::kObjectHeaderSize;
+
+static bool IsIntegerBox(HInstruction* instruction) {
+  return instruction->IsInvokeStaticOrDirect() &&
+         instruction->AsInvokeStaticOrDirect()->GetIntrinsic() == Intrinsics::kIntegerValueOf;
+}
+
+// Returns whether `instruction` reads `Integer.value`, provided its input is an Integer.
+static bool IsIntegerUnboxing(HInstruction* instruction) {
+  if (!instruction->IsInstanceFieldGet()) {
+    return false;
+  }
+  const FieldInfo& field_info = instruction->AsInstanceFieldGet()->GetFieldInfo();
+  return field_info.GetFieldType() == DataType::Type::kInt32 &&
+         !field_info.IsVolatile() &&
+         field_info.GetFieldOffset().Uint32Value() == kIntegerValueOffset;
+}
+
+class BoxUnboxEliminationHelper : public ValueObject {
+ public:
+  BoxUnboxEliminationHelper(HGraph* graph, OptimizingCompilerStats* stats)
+      : graph_(graph),
+        stats_(stats),
+        allocator_(graph->GetArenaStack()),
+        unboxed_phis_(std::less<HPhi*>(), allocator_.Adapter(kArenaAllocMisc)),
+        rejected_phis_(&allocator_, graph->GetCurrentInstructionId(), /*expandable=*/ false),
+        phi_web_(allocator_.Adapter(kArenaAllocMisc)),
+        unused_boxes_(allocator_.Adapter(kArenaAllocMisc)) {}
+
+  bool Run();
+
+ private:
+  // Returns the unboxed value of `boxed` if it is an Integer box or a Phi of such boxes,
+  // creating the int Phis as needed, or null otherwise.
+  HInstruction* GetUnboxedValue(HInstruction* boxed);
+
+  // Creates the int Phis for the web of Phis of boxes reachable from `phi`. Returns
+  // false if some input in the web is not a box.
+  bool CreateUnboxedPhis(HPhi* phi);
+
+  bool CanRemoveEnvironmentUses(HInstruction* instruction) const;
+  void RemoveUnusedBoxes();
+
+  HGraph* const graph_;
+  OptimizingCompilerStats* const stats_;
+  ScopedArenaAllocator allocator_;
+  ScopedArenaSafeMap<HPhi*, HPhi*> unboxed_phis_;
+  // Phis from which CreateUnboxedPhis() found an input that is not a box.
+  ArenaBitVector rejected_phis_;
+  ScopedArenaVector<HPhi*> phi_web_;
+  // Boxes and Phis of boxes which lost an unboxing use.
+  ScopedArenaVector<HInstruction*> unused_boxes_;
+
+  DISALLOW_COPY_AND_ASSIGN(BoxUnboxEliminationHelper);
+};
+
+HInstruction* BoxUnboxEliminationHelper::GetUnboxedValue(HInstruction* boxed) {
+  if (IsIntegerBox(boxed)) {
+    return boxed->InputAt(0);
+  }
+  if (!boxed->IsPhi() || boxed->GetType() != DataType::Type::kReference) {
+    return nullptr;
+  }
+  HPhi* phi = boxed->AsPhi();
+  auto it = unboxed_phis_.find(phi);
+  if (it != unboxed_phis_.end()) {
+    return it->second;
+  }
+  if (rejected_phis_.IsBitSet(phi->GetId()) || !CreateUnboxedPhis(phi)) {
+    return nullptr;
+  }
+  return unboxed_phis_.Get(phi);
+}
+
+bool BoxUnboxEliminationHelper::CreateUnboxedPhis(HPhi* phi) {
+  // Collect the web of Phis, rejecting it if any leaf is not a box. Catch Phis do not have
+  // an input per predecessor and irreducible loop header Phis may be entered from the
+  // interpreter with OSR, so neither can be duplicated as int Phis.
+  phi_web_.clear();
+  phi_web_.push_back(phi);
+  ArenaBitVector visited(&allocator_, graph_->GetCurrentInstructionId(), /*expandable=*/ false);
+  visited.SetBit(phi->GetId());
+  for (size_t i = 0; i != phi_web_.size(); ++i) {
+    HPhi* current = phi_web_[i];
+    if (current->IsCatchPhi() || current->IsIrreducibleLoopHeaderPhi()) {
+      rejected_phis_.SetBit(phi->GetId());
+      return false;
+    }
+    for (HInstruction* input : current->GetInputs()) {
+      if (IsIntegerBox(input)) {
+        continue;
+      }
+      if (!input->IsPhi() || rejected_phis_.IsBitSet(input->GetId())) {
+        rejected_phis_.SetBit(phi->GetId());
+        return false;
+      }
+      if (unboxed_phis_.find(input->AsPhi()) == unboxed_phis_.end() &&
+          !visited.IsBitSet(input->GetId())) {
+        visited.SetBit(input->GetId());
+        phi_web_.push_back(input->AsPhi());
+      }
+    }
+  }
+
+  // Create the int Phis, fill their inputs and add them to their blocks.
+  ArenaAllocator* allocator = graph_->GetAllocator();
+  for (HPhi* current : phi_web_) {
+    unboxed_phis_.Put(current,
+                      new (allocator) HPhi(allocator,
+                                           kNoRegNumber,
+                                           current->InputCount(),
+                                           DataType::Type::kInt32,
+                                           current->GetDexPc()));
+  }
+  for (HPhi* current : phi_web_) {
+    HPhi* unboxed_phi = unboxed_phis_.Get(current);
+    for (size_t i = 0, size = current->InputCount(); i != size; ++i) {
+      HInstruction* input = current->InputAt(i);
+      unboxed_phi->SetRawInputAt(
+          i, IsIntegerBox(input) ? input->InputAt(0) : unboxed_phis_.Get(input->AsPhi()));
+    }
+  }
+  for (HPhi* current : phi_web_) {
+    current->GetBlock()->AddPhi(unboxed_phis_.Get(current));
+  }
+  return true;
+}
+
+bool BoxUnboxEliminationHelper::CanRemoveEnvironmentUses(HInstruction* instruction) const {
+  if (graph_->IsDebuggable()) {
+    return !instruction->HasEnvironmentUses();
+  }
+  for (const HUseListNode<HEnvironment*>& use : instruction->GetEnvUses()) {
+    HInstruction* holder = use.GetUser()->GetHolder();
+    if (holder->IsDeoptimize() ||
+        holder->GetBlock()->IsTryBlock() ||
+        (holder->IsSuspendCheck() && graph_->IsCompilingOsr())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void BoxUnboxEliminationHelper::RemoveUnusedBoxes() {
+  while (!unused_boxes_.empty()) {
+    HInstruction* boxed = unused_boxes_.back();
+    unused_boxes_.pop_back();
+    if (boxed->GetBlock() == nullptr ||  // Already removed.
+        boxed->HasNonEnvironmentUses() ||
+        !CanRemoveEnvironmentUses(boxed)) {
+      continue;
+    }
+    if (boxed->IsPhi()) {
+      for (HInstruction* input : boxed->GetInputs()) {
+        unused_boxes_.push_back(input);
+      }
+    }
+    boxed->RemoveEnvironmentUsers();
+    boxed->GetBlock()->RemoveInstructionOrPhi(boxed);
+  }
+}
+
+bool BoxUnboxEliminationHelper::Run() {
+  bool did_eliminate = false;
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      if (!IsIntegerUnboxing(instruction)) {
+        continue;
+      }
+      HInstruction* object = instruction->InputAt(0);
+      HInstruction* boxed = object->IsNullCheck() ? object->InputAt(0) : object;
+      HInstruction* value = GetUnboxedValue(boxed);
+      if (value == nullptr) {
+        continue;
+      }
+      instruction->ReplaceWith(value);
+      block->RemoveInstruction(instruction);
+      if (object->IsNullCheck()) {
+        // Integer.valueOf() never returns null.
+        object->ReplaceWith(boxed);
+        object->GetBlock()->RemoveInstruction(object);
+        MaybeRecordStat(stats_, MethodCompilationStat::kRemovedNullCheck);
+      }
+      unused_boxes_.push_back(boxed);
+      MaybeRecordStat(stats_, MethodCompilationStat::kBoxUnboxEliminated);
+      did_eliminate = true;
+    }
+  }
+  RemoveUnusedBoxes();
+  return did_eliminate;
+}
+
+bool BoxUnboxElimination::Run() {
+  BoxUnboxEliminationHelper helper(graph_, stats_);
+  return helper.Run();
+}
+
+}  // namespace art
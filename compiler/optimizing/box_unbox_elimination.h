@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ART_COMPILER_OPTIMIZING_BOX_UNBOX_ELIMINATION_H_
+#define ART_COMPILER_OPTIMIZING_BOX_UNBOX_ELIMINATION_H_
+
+#include "base/macros.h"
+#include "optimization.h"
+
+namespace art HIDDEN {
+
+/*
+ * Box-Unbox Elimination.
+ *
+ * Replaces the reads of `Integer.value` from the result of the `Integer.valueOf()` intrinsic
+ * by the boxed int, also when the boxes are merged by Phis, as arises after inlining
+ * `Integer.intValue()` for code using boxed integers (e.g. Kotlin `Int?` loop variables).
+ * Reads through a Phi of boxes get a new int Phi of the boxed values. The boxes and the Phis
+ * that are left without uses are then removed, unless they are needed by the environment of
+ * a deoptimization, of an instruction that can throw into a catch block or of a debuggable
+ * method.
+ */
+class BoxUnboxElimination : public HOptimization {
+ public:
+  BoxUnboxElimination(HGraph* graph,
+                      OptimizingCompilerStats* stats,
+                      const char* name = kBoxUnboxEliminationPassName)
+      : HOptimization(graph, name, stats) {}
+
+  bool Run() override;
+
+  static constexpr const char* kBoxUnboxEliminationPassName = "box_unbox_elimination";
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(BoxUnboxElimination);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_BOX_UNBOX_ELIMINATION_H_
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "box_unbox_elimination.h"
+
+#include "base/macros.h"
+#include "mirror/object.h"
+#include "nodes.h"
+#include "optimizing_unit_test.h"
+
+namespace art HIDDEN {
+
+class BoxUnboxEliminationTest : public OptimizingUnitTest {
+ protected:
+  HInvokeStaticOrDirect* MakeIntegerValueOf(HInstruction* value) {
+    HInvokeStaticOrDirect* box = MakeInvoke(DataType::Type::kReference, { value });
+    box->SetIntrinsic(Intrinsics::kIntegerValueOf,
+                      kNeedsEnvironment,
+                      kNoSideEffects,
+                      kNoThrow);
+    return box;
+  }
+
+  HInstanceFieldGet* MakeIntValue(HInstruction* boxed) {
+    return MakeIFieldGet(boxed, DataType::Type::kInt32, MemberOffset(mirror::kObjectHeaderSize));
+  }
+
+  bool PerformBoxUnboxElimination() {
+    graph_->BuildDominatorTree();
+    bool result = BoxUnboxElimination(graph_, /*stats=*/ nullptr).Run();
+    std::ostringstream oss;
+    EXPECT_TRUE(CheckGraph(oss)) << oss.str();
+    return result;
+  }
+};
+
+// Integer.valueOf(x).intValue() is replaced by x.
+TEST_F(BoxUnboxEliminationTest, BoxUnbox) {
+  CreateGraph();
+  AdjacencyListGraph blks(SetupFromAdjacencyList("entry",
+                                                 "exit",
+                                                 {{"entry", "breturn"}, {"breturn", "exit"}}));
+  HBasicBlock* entry = blks.Get("entry");
+  HBasicBlock* breturn = blks.Get("breturn");
+  HBasicBlock* exit = blks.Get("exit");
+  HInstruction* x = MakeParam(DataType::Type::kInt32);
+  entry->AddInstruction(new (GetAllocator()) HGoto());
+
+  HInstruction* box = MakeIntegerValueOf(x);
+  HInstruction* null_check = new (GetAllocator()) HNullCheck(box, 0);
+  HInstruction* unbox = MakeIntValue(null_check);
+  HInstruction* ret = new (GetAllocator()) HReturn(unbox);
+  breturn->AddInstruction(box);
+  breturn->AddInstruction(null_check);
+  breturn->AddInstruction(unbox);
+  breturn->AddInstruction(ret);
+  ManuallyBuildEnvFor(box, {});
+  null_check->CopyEnvironmentFrom(box->GetEnvironment());
+  SetupExit(exit);
+
+  EXPECT_TRUE(PerformBoxUnboxElimination());
+
+  EXPECT_INS_EQ(ret->InputAt(0), x);
+  EXPECT_INS_REMOVED(unbox);
+  EXPECT_INS_REMOVED(null_check);
+  EXPECT_INS_REMOVED(box);
+}
+
+// Integer sum = 0;
+// while (cond()) {
+//   sum = sum + 1;
+// }
+// return sum.intValue();
+TEST_F(BoxUnboxEliminationTest, LoopPhi) {
+  CreateGraph();
+  AdjacencyListGraph blks(SetupFromAdjacencyList("entry",
+                                                 "exit",
+                                                 {{"entry", "loop_pre_header"},
+                                                  {"loop_pre_header", "loop_header"},
+                                                  {"loop_header", "loop_body"},
+                                                  {"loop_body", "loop_header"},
+                                                  {"loop_header", "breturn"},
+                                                  {"breturn", "exit"}}));
+#define GET_BLOCK(name) HBasicBlock* name = blks.Get(#name)
+  GET_BLOCK(entry);
+  GET_BLOCK(loop_pre_header);
+  GET_BLOCK(loop_header);
+  GET_BLOCK(loop_body);
+  GET_BLOCK(breturn);
+  GET_BLOCK(exit);
+#undef GET_BLOCK
+  EnsurePredecessorOrder(loop_header, {loop_pre_header, loop_body});
+  HInstruction* c0 = graph_->GetIntConstant(0);
+  HInstruction* c1 = graph_->GetIntConstant(1);
+  entry->AddInstruction(new (GetAllocator()) HGoto());
+
+  HInstruction* box0 = MakeIntegerValueOf(c0);
+  loop_pre_header->AddInstruction(box0);
+  loop_pre_header->AddInstruction(new (GetAllocator()) HGoto());
+  ManuallyBuildEnvFor(box0, {});
+
+  HPhi* phi = new (GetAllocator()) HPhi(GetAllocator(), 0, 0, DataType::Type::kReference);
+  HInstruction* suspend_check = new (GetAllocator()) HSuspendCheck();
+  HInstruction* cond = MakeInvoke(DataType::Type::kBool, {});
+  loop_header->AddPhi(phi);
+  loop_header->AddInstruction(suspend_check);
+  loop_header->AddInstruction(cond);
+  loop_header->AddInstruction(new (GetAllocator()) HIf(cond));
+  ManuallyBuildEnvFor(suspend_check, {phi});
+  cond->CopyEnvironmentFrom(suspend_check->GetEnvironment());
+
+  HInstruction* unbox = MakeIntValue(phi);
+  HInstruction* add = new (GetAllocator()) HAdd(DataType::Type::kInt32, unbox, c1);
+  HInstruction* box1 = MakeIntegerValueOf(add);
+  loop_body->AddInstruction(unbox);
+  loop_body->AddInstruction(add);
+  loop_body->AddInstruction(box1);
+  loop_body->AddInstruction(new (GetAllocator()) HGoto());
+  ManuallyBuildEnvFor(box1, {phi});
+  phi->AddInput(box0);
+  phi->AddInput(box1);
+
+  HInstruction* unbox_result = MakeIntValue(phi);
+  HInstruction* ret = new (GetAllocator()) HReturn(unbox_result);
+  breturn->AddInstruction(unbox_result);
+  breturn->AddInstruction(ret);
+  SetupExit(exit);
+
+  EXPECT_TRUE(PerformBoxUnboxElimination());
+
+  HInstruction* sum = ret->InputAt(0);
+  ASSERT_TRUE(sum->IsPhi());
+  EXPECT_EQ(sum->GetType(), DataType::Type::kInt32);
+  EXPECT_EQ(sum->GetBlock(), loop_header);
+  EXPECT_INS_EQ(sum->InputAt(0), c0);
+  EXPECT_INS_EQ(sum->InputAt(1), add);
+  EXPECT_INS_EQ(add->InputAt(0), sum);
+  EXPECT_INS_REMOVED(unbox);
+  EXPECT_INS_REMOVED(unbox_result);
+  EXPECT_INS_REMOVED(phi);
+  EXPECT_INS_REMOVED(box0);
+  EXPECT_INS_REMOVED(box1);
+}
+
+// The value read from a Phi that merges a box with another reference is kept.
+TEST_F(BoxUnboxEliminationTest, PhiWithOtherReference) {
+  CreateGraph();
+  AdjacencyListGraph blks(SetupFromAdjacencyList("entry",
+                                                 "exit",
+                                                 {{"entry", "left"},
+                                                  {"entry", "right"},
+                                                  {"left", "breturn"},
+                                                  {"right", "breturn"},
+                                                  {"breturn", "exit"}}));
+#define GET_BLOCK(name) HBasicBlock* name = blks.Get(#name)
+  GET_BLOCK(entry);
+  GET_BLOCK(left);
+  GET_BLOCK(right);
+  GET_BLOCK(breturn);
+  GET_BLOCK(exit);
+#undef GET_BLOCK
+  EnsurePredecessorOrder(breturn, {left, right});
+  HInstruction* x = MakeParam(DataType::Type::kInt32);
+  HInstruction* obj = MakeParam(DataType::Type::kReference);
+  HInstruction* bool_value = MakeParam(DataType::Type::kBool);
+  entry->AddInstruction(new (GetAllocator()) HIf(bool_value));
+
+  HInstruction* box = MakeIntegerValueOf(x);
+  left->AddInstruction(box);
+  left->AddInstruction(new (GetAllocator()) HGoto());
+  ManuallyBuildEnvFor(box, {});
+
+  right->AddInstruction(new (GetAllocator()) HGoto());
+
+  HPhi* phi = new (GetAllocator()) HPhi(GetAllocator(), 0, 0, DataType::Type::kReference);
+  HInstruction* unbox = MakeIntValue(phi);
+  HInstruction* ret = new (GetAllocator()) HReturn(unbox);
+  breturn->AddPhi(phi);
+  breturn->AddInstruction(unbox);
+  breturn->AddInstruction(ret);
+  phi->AddInput(box);
+  phi->AddInput(obj);
+  SetupExit(exit);
+
+  EXPECT_FALSE(PerformBoxUnboxElimination());
+
+  EXPECT_INS_EQ(ret->InputAt(0), unbox);
+  EXPECT_INS_RETAINED(phi);
+  EXPECT_INS_RETAINED(box);
+}
+
+}  // namespace art
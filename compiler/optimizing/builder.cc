@@ -30,6 +30,7 @@
 #include "mirror/dex_cache.h"
 #include "nodes.h"
 #include "optimizing_compiler_stats.h"
+#include "profile/profile_compilation_info.h"
 #include "ssa_builder.h"
 #include "thread.h"
 
@@ -77,6 +78,16 @@ bool HGraphBuilder::SkipCompilation(size_t number_of_branches) {
 
   const uint32_t code_units = code_item_accessor_.InsnsSizeInCodeUnits();
   if (compiler_options.IsHugeMethod(code_units)) {
+    // Generated code like state machines and lexers keeps its hot loops in huge methods,
+    // which would otherwise stay interpreted forever. Compile them if they are hot and
+    // not too far over the threshold.
+    if (!compiler_options.IsTooHugeToCompileEvenIfHot(code_units) && IsHotMethod()) {
+      VLOG(compiler) << "Compiling hot huge method "
+                     << dex_file_->PrettyMethod(dex_compilation_unit_->GetDexMethodIndex())
+                     << ": " << code_units << " code units";
+      MaybeRecordStat(compilation_stats_, MethodCompilationStat::kCompiledHotHugeMethod);
+      return false;
+    }
     VLOG(compiler) << "Skip compilation of huge method "
                    << dex_file_->PrettyMethod(dex_compilation_unit_->GetDexMethodIndex())
                    << ": " << code_units << " code units";
@@ -96,6 +107,21 @@ bool HGraphBuilder::SkipCompilation(size_t number_of_branches) {
   return false;
 }
 
+bool HGraphBuilder::IsHotMethod() const {
+  const CompilerOptions& compiler_options = code_generator_->GetCompilerOptions();
+  if (compiler_options.IsJitCompiler()) {
+    // Baseline compilation is requested early, optimized and OSR compilation only once the
+    // hotness counter, or a loop for OSR, got hot.
+    return !graph_->IsCompilingBaseline();
+  }
+  const ProfileCompilationInfo* pci = compiler_options.GetProfileCompilationInfo();
+  if (pci == nullptr) {
+    return false;
+  }
+  return pci->GetMethodHotness(
+      MethodReference(dex_file_, dex_compilation_unit_->GetDexMethodIndex())).IsHot();
+}
+
 GraphAnalysisResult HGraphBuilder::BuildGraph() {
   DCHECK(code_item_accessor_.HasCodeItem());
   DCHECK(graph_->GetBlocks().empty());
@@ -54,6 +54,8 @@ class HGraphBuilder : public ValueObject {
 
  private:
   bool SkipCompilation(size_t number_of_branches);
+  // Whether the profile or the JIT hotness counters show that the method is hot.
+  bool IsHotMethod() const;
 
   HGraph* const graph_;
   const DexFile* const dex_file_;
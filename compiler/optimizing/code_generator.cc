@@ -362,6 +362,7 @@ void CodeGenerator::InitializeCodeGeneration(size_t number_of_spill_slots,
   DCHECK(!block_order.empty());
   DCHECK(block_order[0] == GetGraph()->GetEntryBlock());
   ComputeSpillMask();
+  number_of_spill_slots_ = number_of_spill_slots;
   first_register_slot_in_slow_path_ = RoundUp(
       (number_of_out_slots + number_of_spill_slots) * kVRegSize, GetPreferredSlotsAlignment());
 
@@ -556,6 +557,7 @@ void CodeGenerator::CreateStringBuilderAppendLocations(HStringBuilderAppend* ins
     StringBuilderAppend::Argument arg_type =
         static_cast<StringBuilderAppend::Argument>(f & StringBuilderAppend::kArgMask);
     switch (arg_type) {
+      case StringBuilderAppend::Argument::kObject:
       case StringBuilderAppend::Argument::kStringBuilder:
       case StringBuilderAppend::Argument::kString:
       case StringBuilderAppend::Argument::kCharArray:
@@ -948,6 +950,7 @@ CodeGenerator::CodeGenerator(HGraph* graph,
       core_spill_mask_(0),
       fpu_spill_mask_(0),
       first_register_slot_in_slow_path_(0),
+      number_of_spill_slots_(0),
       allocated_registers_(RegisterSet::Empty()),
       blocked_core_registers_(graph->GetAllocator()->AllocArray<bool>(number_of_core_registers,
                                                                       kArenaAllocCodeGenerator)),
@@ -1779,6 +1782,9 @@ void CodeGenerator::EmitJitRoots(uint8_t* code,
 }
 
 QuickEntrypointEnum CodeGenerator::GetArrayAllocationEntrypoint(HNewArray* new_array) {
+  if (new_array->IsPretenured()) {
+    return kQuickAllocArrayNonMoving;
+  }
   switch (new_array->GetComponentSizeShift()) {
     case 0: return kQuickAllocArrayResolved8;
     case 1: return kQuickAllocArrayResolved16;
@@ -575,6 +575,11 @@ class CodeGenerator : public DeletableArenaObject<kArenaAllocCodeGenerator> {
     return first_register_slot_in_slow_path_;
   }
 
+  // The number of stack slots that the register allocator used for spilling.
+  size_t GetNumberOfSpillSlots() const {
+    return number_of_spill_slots_;
+  }
+
   uint32_t FrameEntrySpillSize() const {
     return GetFpuSpillSize() + GetCoreSpillSize();
   }
@@ -830,6 +835,7 @@ class CodeGenerator : public DeletableArenaObject<kArenaAllocCodeGenerator> {
   uint32_t core_spill_mask_;
   uint32_t fpu_spill_mask_;
   uint32_t first_register_slot_in_slow_path_;
+  size_t number_of_spill_slots_;
 
   // Registers that were allocated during linear scan.
   RegisterSet allocated_registers_;
@@ -22,7 +22,9 @@
 #include "base/macros.h"
 #include "code_generator.h"
 #include "driver/compiler_options.h"
+#include "jit_patches_riscv64.h"
 #include "optimizing/locations.h"
+#include "parallel_move_resolver.h"
 #include "utils/riscv64/assembler_riscv64.h"
 
 namespace art {
@@ -47,13 +49,78 @@ static constexpr FRegister kRuntimeParameterFpuRegisters[] = {
 static constexpr size_t kRuntimeParameterFpuRegistersLength =
     arraysize(kRuntimeParameterFpuRegisters);
 
-#define UNIMPLEMENTED_INTRINSIC_LIST_RISCV64(V) INTRINSICS_LIST(V)
+// The vector length used by the auto-vectorizer with the "V" or "XTheadVector" extension.
+// This is the minimum VLEN required by the RVA application profiles; the code generator
+// configures `vl` explicitly, so it works correctly on hardware with longer vectors.
+static constexpr size_t kRiscv64SIMDRegisterWidth = 16u;
+
+#define UNIMPLEMENTED_INTRINSIC_LIST_RISCV64(V) \
+  V(MethodHandleInvokeExact)                    \
+  V(MethodHandleInvoke)                         \
+  V(IntegerReverse)                             \
+  V(LongReverse)                                \
+  V(SystemArrayCopyByte)                        \
+  V(SystemArrayCopyInt)                         \
+  V(SystemArrayCopy)                            \
+  V(FP16Ceil)                                   \
+  V(FP16Compare)                                \
+  V(FP16Floor)                                  \
+  V(FP16Rint)                                   \
+  V(FP16ToFloat)                                \
+  V(FP16ToHalf)                                 \
+  V(FP16Greater)                                \
+  V(FP16GreaterEquals)                          \
+  V(FP16Less)                                   \
+  V(FP16LessEquals)                             \
+  V(FP16Min)                                    \
+  V(FP16Max)                                    \
+  V(StringCompareTo)                            \
+  V(StringGetCharsNoCheck)                      \
+  V(StringIndexOf)                              \
+  V(StringIndexOfAfter)                         \
+  V(StringStringIndexOf)                        \
+  V(StringStringIndexOfAfter)                   \
+  V(StringBufferAppend)                         \
+  V(StringBufferLength)                         \
+  V(StringBufferToString)                       \
+  V(StringBuilderAppendObject)                  \
+  V(StringBuilderAppendString)                  \
+  V(StringBuilderAppendCharSequence)            \
+  V(StringBuilderAppendCharArray)               \
+  V(StringBuilderAppendBoolean)                 \
+  V(StringBuilderAppendChar)                    \
+  V(StringBuilderAppendInt)                     \
+  V(StringBuilderAppendLong)                    \
+  V(StringBuilderAppendFloat)                   \
+  V(StringBuilderAppendDouble)                  \
+  V(StringBuilderLength)                        \
+  V(StringBuilderToString)                      \
+  V(ReferenceGetReferent)                       \
+  V(ReferenceRefersTo)                          \
+  V(IntegerValueOf)
 
 // Method register on invoke.
 static const XRegister kArtMethodRegister = A0;
 
 class CodeGeneratorRISCV64;
 
+Location Riscv64ReturnLocation(DataType::Type return_type);
+
+class InvokeRuntimeCallingConvention : public CallingConvention<XRegister, FRegister> {
+ public:
+  InvokeRuntimeCallingConvention()
+      : CallingConvention(kRuntimeParameterCoreRegisters,
+                          kRuntimeParameterCoreRegistersLength,
+                          kRuntimeParameterFpuRegisters,
+                          kRuntimeParameterFpuRegistersLength,
+                          kRiscv64PointerSize) {}
+
+  Location GetReturnLocation(DataType::Type return_type);
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(InvokeRuntimeCallingConvention);
+};
+
 class InvokeDexCallingConvention : public CallingConvention<XRegister, FRegister> {
  public:
   InvokeDexCallingConvention()
@@ -67,6 +134,33 @@ class InvokeDexCallingConvention : public CallingConvention<XRegister, FRegister
   DISALLOW_COPY_AND_ASSIGN(InvokeDexCallingConvention);
 };
 
+class FieldAccessCallingConventionRISCV64 : public FieldAccessCallingConvention {
+ public:
+  FieldAccessCallingConventionRISCV64() {}
+
+  Location GetObjectLocation() const override {
+    return Location::RegisterLocation(A1);
+  }
+  Location GetFieldIndexLocation() const override {
+    return Location::RegisterLocation(A0);
+  }
+  Location GetReturnLocation([[maybe_unused]] DataType::Type type) const override {
+    return Location::RegisterLocation(A0);
+  }
+  Location GetSetValueLocation([[maybe_unused]] DataType::Type type,
+                               bool is_instance) const override {
+    return is_instance
+        ? Location::RegisterLocation(A2)
+        : Location::RegisterLocation(A1);
+  }
+  Location GetFpuLocation([[maybe_unused]] DataType::Type type) const override {
+    return Location::FpuRegisterLocation(FA0);
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(FieldAccessCallingConventionRISCV64);
+};
+
 class InvokeDexCallingConventionVisitorRISCV64 : public InvokeDexCallingConventionVisitor {
  public:
   InvokeDexCallingConventionVisitorRISCV64() {}
@@ -82,6 +176,31 @@ class InvokeDexCallingConventionVisitorRISCV64 : public InvokeDexCallingConventi
   DISALLOW_COPY_AND_ASSIGN(InvokeDexCallingConventionVisitorRISCV64);
 };
 
+class CriticalNativeCallingConventionVisitorRISCV64 : public InvokeDexCallingConventionVisitor {
+ public:
+  explicit CriticalNativeCallingConventionVisitorRISCV64(bool for_register_allocation)
+      : for_register_allocation_(for_register_allocation) {}
+
+  virtual ~CriticalNativeCallingConventionVisitorRISCV64() {}
+
+  Location GetNextLocation(DataType::Type type) override;
+  Location GetReturnLocation(DataType::Type type) const override;
+  Location GetMethodLocation() const override;
+
+  size_t GetStackOffset() const { return stack_offset_; }
+
+ private:
+  // Register allocator does not support adjusting frame size, so we cannot provide final locations
+  // of stack arguments for register allocation. We ask the register allocator for any location and
+  // move these arguments to the right place after adjusting the SP when generating the call.
+  const bool for_register_allocation_;
+  size_t gpr_index_ = 0u;
+  size_t fpr_index_ = 0u;
+  size_t stack_offset_ = 0u;
+
+  DISALLOW_COPY_AND_ASSIGN(CriticalNativeCallingConventionVisitorRISCV64);
+};
+
 class SlowPathCodeRISCV64 : public SlowPathCode {
  public:
   explicit SlowPathCodeRISCV64(HInstruction* instruction)
@@ -97,6 +216,24 @@ class SlowPathCodeRISCV64 : public SlowPathCode {
   DISALLOW_COPY_AND_ASSIGN(SlowPathCodeRISCV64);
 };
 
+class ParallelMoveResolverRISCV64 : public ParallelMoveResolverWithSwap {
+ public:
+  ParallelMoveResolverRISCV64(ArenaAllocator* allocator, CodeGeneratorRISCV64* codegen)
+      : ParallelMoveResolverWithSwap(allocator), codegen_(codegen) {}
+
+  void EmitMove(size_t index) override;
+  void EmitSwap(size_t index) override;
+  void SpillScratch(int reg) override;
+  void RestoreScratch(int reg) override;
+
+  Riscv64Assembler* GetAssembler() const;
+
+ private:
+  CodeGeneratorRISCV64* const codegen_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelMoveResolverRISCV64);
+};
+
 class LocationsBuilderRISCV64 : public HGraphVisitor {
  public:
   LocationsBuilderRISCV64(HGraph* graph, CodeGeneratorRISCV64* codegen)
@@ -151,16 +288,28 @@ class InstructionCodeGeneratorRISCV64 : public InstructionCodeGenerator {
 
   void GenerateMemoryBarrier(MemBarrierKind kind);
 
+  // Load or store `value` of `type` at `base + offset`. The access of a reference
+  // is not (un)poisoned here, callers need to take care of that.
+  void Load(Location out, XRegister base, int32_t offset, DataType::Type type);
+  void Store(Location value, XRegister base, int32_t offset, DataType::Type type);
+
+  // Helpers for moving SIMD values, see `code_generator_vector_riscv64.cc`.
+  void LoadSIMDRegFromStack(Location destination, Location source);
+  void MoveSIMDRegToSIMDReg(Location destination, Location source);
+  void MoveToSIMDStackSlot(Location destination, Location source);
+
  protected:
   void GenerateClassInitializationCheck(SlowPathCodeRISCV64* slow_path, XRegister class_reg);
   void GenerateBitstringTypeCheckCompare(HTypeCheckInstruction* check, XRegister temp);
   void GenerateSuspendCheck(HSuspendCheck* check, HBasicBlock* successor);
+  void GenerateMethodEntryExitHook(HInstruction* instruction);
   void HandleBinaryOp(HBinaryOperation* operation);
   void HandleCondition(HCondition* instruction);
   void HandleShift(HBinaryOperation* operation);
   void HandleFieldSet(HInstruction* instruction,
                       const FieldInfo& field_info,
-                      bool value_can_be_null);
+                      bool value_can_be_null,
+                      WriteBarrierKind write_barrier_kind);
   void HandleFieldGet(HInstruction* instruction, const FieldInfo& field_info);
 
   void GenerateMinMaxInt(LocationSummary* locations, bool is_min);
@@ -258,10 +407,33 @@ class InstructionCodeGeneratorRISCV64 : public InstructionCodeGenerator {
                                  uint32_t num_entries,
                                  HBasicBlock* switch_block,
                                  HBasicBlock* default_block);
-  int32_t VecAddress(LocationSummary* locations,
-                     size_t size,
-                     /*out*/ XRegister* adjusted_base);
-  void GenConditionalMove(HSelect* select);
+  // Compute the address of the first element accessed by a vector memory operation.
+  void VecAddress(HVecMemoryOperation* instruction, XRegister adjusted_base);
+  template <void (Riscv64Assembler::*opVI)(VRegister, VRegister, uint32_t),
+            void (Riscv64Assembler::*opVX)(VRegister, VRegister, XRegister)>
+  void GenerateVecShift(HVecBinaryOperation* instruction);
+
+  template <typename Reg,
+            void (Riscv64Assembler::*opS)(Reg, FRegister, FRegister),
+            void (Riscv64Assembler::*opD)(Reg, FRegister, FRegister)>
+  void FpBinOp(Reg rd, FRegister rs1, FRegister rs2, DataType::Type type);
+  void FAdd(FRegister rd, FRegister rs1, FRegister rs2, DataType::Type type);
+  void FSub(FRegister rd, FRegister rs1, FRegister rs2, DataType::Type type);
+  void FDiv(FRegister rd, FRegister rs1, FRegister rs2, DataType::Type type);
+  void FMul(FRegister rd, FRegister rs1, FRegister rs2, DataType::Type type);
+  void FMin(FRegister rd, FRegister rs1, FRegister rs2, DataType::Type type);
+  void FMax(FRegister rd, FRegister rs1, FRegister rs2, DataType::Type type);
+  void FEq(XRegister rd, FRegister rs1, FRegister rs2, DataType::Type type);
+  void FLt(XRegister rd, FRegister rs1, FRegister rs2, DataType::Type type);
+  void FLe(XRegister rd, FRegister rs1, FRegister rs2, DataType::Type type);
+
+  template <typename Reg,
+            void (Riscv64Assembler::*opS)(Reg, FRegister),
+            void (Riscv64Assembler::*opD)(Reg, FRegister)>
+  void FpUnOp(Reg rd, FRegister rs1, DataType::Type type);
+  void FAbs(FRegister rd, FRegister rs1, DataType::Type type);
+  void FNeg(FRegister rd, FRegister rs1, DataType::Type type);
+  void FMv(FRegister rd, FRegister rs1, DataType::Type type);
 
   Riscv64Assembler* const assembler_;
   CodeGeneratorRISCV64* const codegen_;
@@ -281,45 +453,53 @@ class CodeGeneratorRISCV64 : public CodeGenerator {
 
   void Bind(HBasicBlock* block) override;
 
-  size_t GetWordSize() const override { return kRiscv64WordSize; }
+  size_t GetWordSize() const override { return kRiscv64DoublewordSize; }
 
   bool SupportsPredicatedSIMD() const override {
-    // TODO(riscv64): Check the vector extension.
+    // TODO(riscv64): Use `vsetvli` for the loop control once the register allocator
+    // supports vector and mask registers. See `code_generator_vector_riscv64.cc`.
     return false;
   }
 
   size_t GetSlowPathFPWidth() const override {
-    LOG(FATAL) << "CodeGeneratorRISCV64::GetSlowPathFPWidth is unimplemented";
-    UNREACHABLE();
+    // The vector registers do not overlap the FP registers, so slow paths in methods
+    // with SIMD instructions need to save both the 64-bit FP and the vector registers.
+    return GetGraph()->HasSIMD()
+        ? kRiscv64DoublewordSize + GetSIMDRegisterWidth()
+        : kRiscv64DoublewordSize;
   }
 
   size_t GetCalleePreservedFPWidth() const override {
-    LOG(FATAL) << "CodeGeneratorRISCV64::GetCalleePreservedFPWidth is unimplemented";
-    UNREACHABLE();
+    return kRiscv64DoublewordSize;
   };
 
   size_t GetSIMDRegisterWidth() const override;
 
   uintptr_t GetAddressOf(HBasicBlock* block) override {
-    UNUSED(block);
-    LOG(FATAL) << "CodeGeneratorRISCV64::GetAddressOf is unimplemented";
-    UNREACHABLE();
+    return assembler_.GetLabelLocation(GetLabelOf(block));
   };
 
-  void Initialize() override { LOG(FATAL) << "unimplemented"; }
+  Riscv64Label* GetLabelOf(HBasicBlock* block) const {
+    return CommonGetLabelOf<Riscv64Label>(block_labels_, block);
+  }
+
+  Riscv64Label* GetFrameEntryLabel() { return &frame_entry_label_; }
+
+  void Initialize() override { block_labels_ = CommonInitializeLabels<Riscv64Label>(); }
 
   void MoveConstant(Location destination, int32_t value) override;
   void MoveLocation(Location dst, Location src, DataType::Type dst_type) override;
   void AddLocationAsTemp(Location location, LocationSummary* locations) override;
 
-  HGraphVisitor* GetInstructionVisitor() override {
-    LOG(FATAL) << "unimplemented";
-    UNREACHABLE();
+  InstructionCodeGeneratorRISCV64* GetInstructionVisitor() override {
+    return &instruction_visitor_;
   }
 
   Riscv64Assembler* GetAssembler() override { return &assembler_; }
   const Riscv64Assembler& GetAssembler() const override { return assembler_; }
 
+  const Riscv64InstructionSetFeatures& GetInstructionSetFeatures() const;
+
   HGraphVisitor* GetLocationBuilder() override { return &location_builder_; }
 
   void SetupBlockedRegisters() const override;
@@ -335,8 +515,7 @@ class CodeGeneratorRISCV64 : public CodeGenerator {
   InstructionSet GetInstructionSet() const override { return InstructionSet::kRiscv64; }
 
   uint32_t GetPreferredSlotsAlignment() const override {
-    LOG(FATAL) << "Unimplemented";
-    UNREACHABLE();
+    return static_cast<uint32_t>(kRiscv64PointerSize);
   }
 
   void Finalize() override;
@@ -353,11 +532,10 @@ class CodeGeneratorRISCV64 : public CodeGenerator {
                                            HInstruction* instruction,
                                            SlowPathCode* slow_path);
 
-  // TODO(riscv64): Add ParallelMoveResolverRISCV64 Later
-  ParallelMoveResolver* GetMoveResolver() override {
-    LOG(FATAL) << "Unimplemented";
-    UNREACHABLE();
-  }
+  ParallelMoveResolver* GetMoveResolver() override { return &move_resolver_; }
+
+  // Swap the contents of two locations holding values of the same kind.
+  void SwapLocations(Location loc1, Location loc2, DataType::Type type);
 
   bool NeedsTwoRegisters([[maybe_unused]] DataType::Type type) const override { return false; }
 
@@ -393,9 +571,162 @@ class CodeGeneratorRISCV64 : public CodeGenerator {
                            SlowPathCode* slow_path = nullptr) override;
   void MoveFromReturnRegister(Location trg, DataType::Type type) override;
 
+  // Emit a write barrier marking the card of `object` as dirty. If `value_can_be_null`,
+  // the card is not marked when `value` is null.
+  void MarkGCCard(XRegister object, XRegister value, bool value_can_be_null);
+
+  // Fast path implementation of ReadBarrier::Barrier for a heap
+  // reference field load when Baker's read barriers are used.
+  void GenerateFieldLoadWithBakerReadBarrier(HInstruction* instruction,
+                                             Location ref,
+                                             XRegister obj,
+                                             uint32_t offset,
+                                             bool needs_null_check);
+  // Fast path implementation of ReadBarrier::Barrier for a heap
+  // reference array load when Baker's read barriers are used.
+  void GenerateArrayLoadWithBakerReadBarrier(HInstruction* instruction,
+                                             Location ref,
+                                             XRegister obj,
+                                             uint32_t data_offset,
+                                             Location index,
+                                             bool needs_null_check);
+  // Factored implementation, used by GenerateFieldLoadWithBakerReadBarrier
+  // and GenerateArrayLoadWithBakerReadBarrier.
+  //
+  // While the Marking Register (MR) is zero, this is a plain reference load. Otherwise
+  // an out-of-line slow path checks the gray bit in the lock word of `obj`, performs
+  // the load with a fake address dependency on the lock word and marks the reference
+  // if `obj` is gray. For an array load with a register `index`, the element address
+  // is kept in `TMP2` across the slow path.
+  void GenerateReferenceLoadWithBakerReadBarrier(HInstruction* instruction,
+                                                 Location ref,
+                                                 XRegister obj,
+                                                 uint32_t offset,
+                                                 Location index,
+                                                 bool needs_null_check);
+
+  void MaybeIncrementHotness(bool is_frame_entry);
+
+  // The PC-relative address is loaded with an AUIPC and an ADDI or a load, for example:
+  //     auipc reg1, 0x12345  // Patched with the high 20 bits of the PC-relative offset.
+  //     addi  reg2, reg1, 0x678  // Patched with the low 12 bits of the PC-relative offset.
+  // Both instructions are patched relative to the AUIPC, so the patch info for the low
+  // instruction records the label of the AUIPC. The AUIPC may be shared by several low
+  // instructions but it must dominate them.
+  struct PcRelativePatchInfo : PatchInfo<Riscv64Label> {
+    PcRelativePatchInfo(const DexFile* dex_file,
+                        uint32_t off_or_idx,
+                        const PcRelativePatchInfo* info_high)
+        : PatchInfo<Riscv64Label>(dex_file, off_or_idx),
+          pc_insn_label(info_high != nullptr ? &info_high->label : &label) {
+      DCHECK_IMPLIES(info_high != nullptr, info_high->pc_insn_label == &info_high->label);
+    }
+
+    // Pointer to the label of the AUIPC; points to `label` if this is the AUIPC patch info.
+    const Riscv64Label* pc_insn_label;
+
+   private:
+    PcRelativePatchInfo(PcRelativePatchInfo&& other) = delete;
+    DISALLOW_COPY_AND_ASSIGN(PcRelativePatchInfo);
+  };
+
+  PcRelativePatchInfo* NewBootImageIntrinsicPatch(uint32_t intrinsic_data,
+                                                  const PcRelativePatchInfo* info_high = nullptr);
+  PcRelativePatchInfo* NewBootImageRelRoPatch(uint32_t boot_image_offset,
+                                              const PcRelativePatchInfo* info_high = nullptr);
+  PcRelativePatchInfo* NewBootImageMethodPatch(MethodReference target_method,
+                                               const PcRelativePatchInfo* info_high = nullptr);
+  PcRelativePatchInfo* NewMethodBssEntryPatch(MethodReference target_method,
+                                              const PcRelativePatchInfo* info_high = nullptr);
+  PcRelativePatchInfo* NewBootImageJniEntrypointPatch(
+      MethodReference target_method, const PcRelativePatchInfo* info_high = nullptr);
+  PcRelativePatchInfo* NewBootImageTypePatch(const DexFile& dex_file,
+                                             dex::TypeIndex type_index,
+                                             const PcRelativePatchInfo* info_high = nullptr);
+  PcRelativePatchInfo* NewTypeBssEntryPatch(HLoadClass* load_class,
+                                            const PcRelativePatchInfo* info_high = nullptr);
+  PcRelativePatchInfo* NewBootImageStringPatch(const DexFile& dex_file,
+                                               dex::StringIndex string_index,
+                                               const PcRelativePatchInfo* info_high = nullptr);
+  PcRelativePatchInfo* NewStringBssEntryPatch(const DexFile& dex_file,
+                                              dex::StringIndex string_index,
+                                              const PcRelativePatchInfo* info_high = nullptr);
+
+  void EmitPcRelativeAuipcPlaceholder(PcRelativePatchInfo* info_high, XRegister out);
+  void EmitPcRelativeAddiPlaceholder(PcRelativePatchInfo* info_low, XRegister rd, XRegister rs1);
+  void EmitPcRelativeLwuPlaceholder(PcRelativePatchInfo* info_low, XRegister rd, XRegister rs1);
+  void EmitPcRelativeLdPlaceholder(PcRelativePatchInfo* info_low, XRegister rd, XRegister rs1);
+
+  // Load a 32-bit boot image entry from the .data.bimg.rel.ro section.
+  void LoadBootImageRelRoEntry(XRegister dest, uint32_t boot_image_offset);
+  // Load the address of a boot image object; used by intrinsics.
+  void LoadBootImageAddress(XRegister dest, uint32_t boot_image_reference);
+
+  void EmitLinkerPatches(ArenaVector<linker::LinkerPatch>* linker_patches) override;
+
+  Literal* DeduplicateUint64Literal(uint64_t value) {
+    return jit_patches_.DeduplicateUint64Literal(value);
+  }
+  Literal* DeduplicateBootImageAddressLiteral(uint64_t address) {
+    return jit_patches_.DeduplicateBootImageAddressLiteral(address);
+  }
+  Literal* DeduplicateJitStringLiteral(const DexFile& dex_file,
+                                       dex::StringIndex string_index,
+                                       Handle<mirror::String> handle) {
+    return jit_patches_.DeduplicateJitStringLiteral(
+        dex_file, string_index, handle, GetCodeGenerationData());
+  }
+  Literal* DeduplicateJitClassLiteral(const DexFile& dex_file,
+                                      dex::TypeIndex class_index,
+                                      Handle<mirror::Class> handle) {
+    return jit_patches_.DeduplicateJitClassLiteral(
+        dex_file, class_index, handle, GetCodeGenerationData());
+  }
+
+  void EmitJitRootPatches(uint8_t* code, const uint8_t* roots_data) override;
+
  private:
+  PcRelativePatchInfo* NewPcRelativePatch(const DexFile* dex_file,
+                                          uint32_t offset_or_index,
+                                          const PcRelativePatchInfo* info_high,
+                                          ArenaDeque<PcRelativePatchInfo>* patches);
+
+  template <linker::LinkerPatch (*Factory)(size_t, const DexFile*, uint32_t, uint32_t)>
+  void EmitPcRelativeLinkerPatches(const ArenaDeque<PcRelativePatchInfo>& infos,
+                                   ArenaVector<linker::LinkerPatch>* linker_patches);
+
   Riscv64Assembler assembler_;
   LocationsBuilderRISCV64 location_builder_;
+  InstructionCodeGeneratorRISCV64 instruction_visitor_;
+  ParallelMoveResolverRISCV64 move_resolver_;
+
+  // Labels for each block that will be compiled.
+  Riscv64Label* block_labels_;  // Indexed by block id.
+  Riscv64Label frame_entry_label_;
+
+  // PC-relative method patch info for kBootImageLinkTimePcRelative.
+  ArenaDeque<PcRelativePatchInfo> boot_image_method_patches_;
+  // PC-relative method patch info for kBssEntry.
+  ArenaDeque<PcRelativePatchInfo> method_bss_entry_patches_;
+  // PC-relative type patch info for kBootImageLinkTimePcRelative.
+  ArenaDeque<PcRelativePatchInfo> boot_image_type_patches_;
+  // PC-relative type patch info for kBssEntry.
+  ArenaDeque<PcRelativePatchInfo> type_bss_entry_patches_;
+  // PC-relative public type patch info for kBssEntryPublic.
+  ArenaDeque<PcRelativePatchInfo> public_type_bss_entry_patches_;
+  // PC-relative package type patch info for kBssEntryPackage.
+  ArenaDeque<PcRelativePatchInfo> package_type_bss_entry_patches_;
+  // PC-relative String patch info for kBootImageLinkTimePcRelative.
+  ArenaDeque<PcRelativePatchInfo> boot_image_string_patches_;
+  // PC-relative String patch info for kBssEntry.
+  ArenaDeque<PcRelativePatchInfo> string_bss_entry_patches_;
+  // PC-relative method patch info for kBootImageLinkTimePcRelative+kCallCriticalNative.
+  ArenaDeque<PcRelativePatchInfo> boot_image_jni_entrypoint_patches_;
+  // PC-relative patch info for IntrinsicObjects for the boot image,
+  // and for method/type/string patches for kBootImageRelRo otherwise.
+  ArenaDeque<PcRelativePatchInfo> boot_image_other_patches_;
+
+  JitPatchesRISCV64 jit_patches_;
 };
 
 }  // namespace riscv64
@@ -0,0 +1,992 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "code_generator_riscv64.h"
+
+#include "android-base/logging.h"
+#include "mirror/array-inl.h"
+
+namespace art {
+namespace riscv64 {
+
+// The vector code uses a fixed vector length of `kRiscv64SIMDRegisterWidth` bytes with LMUL = 1,
+// i.e. the loop optimizer's "NEON-like" non-predicated mode. Vector values are allocated to
+// `FpuRegister` locations and the register number `n` of such location denotes `v<n>`.
+// The vector registers do not overlap the FP registers, so the `f<n>` register is left intact.
+
+static inline VRegister VRegisterFrom(Location location) {
+  DCHECK(location.IsFpuRegister()) << location;
+  return location.AsFpuRegister<VRegister>();
+}
+
+static VectorSew VectorSewFromType(DataType::Type type) {
+  switch (DataType::Size(type)) {
+    case 1u:
+      return VectorSew::kE8;
+    case 2u:
+      return VectorSew::kE16;
+    case 4u:
+      return VectorSew::kE32;
+    case 8u:
+      return VectorSew::kE64;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << type;
+      UNREACHABLE();
+  }
+}
+
+// Set `vl` and `vtype` for the packed type and vector length of the `instruction`.
+static void SetVectorConfig(Riscv64Assembler* assembler, HVecOperation* instruction) {
+  DataType::Type packed_type = instruction->GetPackedType();
+  DCHECK_EQ(instruction->GetVectorLength() * DataType::Size(packed_type),
+            kRiscv64SIMDRegisterWidth);
+  assembler->SetVectorConfig(instruction->GetVectorLength(), VectorSewFromType(packed_type));
+}
+
+// Helper to return a constant location for values that can be encoded as the 5-bit
+// signed immediate of the `.vi` instruction forms, or a core register location otherwise.
+static Location VectorImmediateOrRegister(HInstruction* input) {
+  if (input->IsConstant() && IsInt<5>(CodeGenerator::GetInt64ValueOf(input->AsConstant()))) {
+    return Location::ConstantLocation(input);
+  }
+  return Location::RequiresRegister();
+}
+
+#define __ GetAssembler()->
+
+void LocationsBuilderRISCV64::VisitVecReplicateScalar(HVecReplicateScalar* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+  HInstruction* input = instruction->InputAt(0);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      locations->SetInAt(0, VectorImmediateOrRegister(input));
+      locations->SetOut(Location::RequiresFpuRegister());
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      locations->SetInAt(0, IsZeroBitPattern(input) ? Location::ConstantLocation(input)
+                                                    : Location::RequiresFpuRegister());
+      locations->SetOut(Location::RequiresFpuRegister());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecReplicateScalar(HVecReplicateScalar* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  Location src_loc = locations->InAt(0);
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorConfig(GetAssembler(), instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      if (src_loc.IsConstant()) {
+        __ VMvVI(dst, dchecked_integral_cast<int32_t>(
+                          CodeGenerator::GetInt64ValueOf(src_loc.GetConstant())));
+      } else {
+        __ VMvVX(dst, src_loc.AsRegister<XRegister>());
+      }
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      if (src_loc.IsConstant()) {
+        __ VMvVI(dst, 0);
+      } else {
+        __ VFmvVF(dst, src_loc.AsFpuRegister<FRegister>());
+      }
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecExtractScalar(HVecExtractScalar* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetOut(Location::RequiresRegister());
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      // Unlike NEON, the scalar result does not live in the vector register.
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetOut(Location::RequiresFpuRegister());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecExtractScalar(HVecExtractScalar* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister src = VRegisterFrom(locations->InAt(0));
+  SetVectorConfig(GetAssembler(), instruction);
+  DataType::Type type = instruction->GetPackedType();
+  if (DataType::IsFloatingPointType(type)) {
+    __ VFmvFS(locations->Out().AsFpuRegister<FRegister>(), src);
+    return;
+  }
+  XRegister dst = locations->Out().AsRegister<XRegister>();
+  __ VMvXS(dst, src);
+  // RVV 1.0 sign-extends the element to XLEN but "XTheadVector" can zero-extend it.
+  // Normalize the value to the representation expected for the packed type.
+  switch (type) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+      __ ZextB(dst, dst);
+      break;
+    case DataType::Type::kInt8:
+      __ SextB(dst, dst);
+      break;
+    case DataType::Type::kUint16:
+      __ ZextH(dst, dst);
+      break;
+    case DataType::Type::kInt16:
+      __ SextH(dst, dst);
+      break;
+    case DataType::Type::kInt32:
+      if (GetAssembler()->HasXTheadVector()) {
+        __ SextW(dst, dst);
+      }
+      break;
+    case DataType::Type::kInt64:
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << type;
+      UNREACHABLE();
+  }
+}
+
+// Helper to set up locations for vector unary operations.
+static void CreateVecUnOpLocations(ArenaAllocator* allocator, HVecUnaryOperation* instruction) {
+  LocationSummary* locations = new (allocator) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetOut(Location::RequiresFpuRegister(), Location::kNoOutputOverlap);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecReduce(HVecReduce* instruction) {
+  CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecReduce(HVecReduce* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister src = VRegisterFrom(locations->InAt(0));
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorConfig(GetAssembler(), instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      switch (instruction->GetReductionKind()) {
+        case HVecReduce::kSum:
+          // The scalar operand of the reduction is the element 0 of `vs1`, use zero.
+          __ VMvSX(VTMP, Zero);
+          __ VRedsumVS(dst, src, VTMP);
+          break;
+        case HVecReduce::kMin:
+          __ VRedminVS(dst, src, src);
+          break;
+        case HVecReduce::kMax:
+          __ VRedmaxVS(dst, src, src);
+          break;
+      }
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecCnv(HVecCnv* instruction) {
+  CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecCnv(HVecCnv* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister src = VRegisterFrom(locations->InAt(0));
+  VRegister dst = VRegisterFrom(locations->Out());
+  DataType::Type from = instruction->GetInputType();
+  DataType::Type to = instruction->GetResultType();
+  if (from == DataType::Type::kInt32 && to == DataType::Type::kFloat32) {
+    DCHECK_EQ(4u, instruction->GetVectorLength());
+    SetVectorConfig(GetAssembler(), instruction);
+    // Uses the dynamic rounding mode (round to nearest, ties to even) as required by Java.
+    __ VFcvtFXV(dst, src);
+  } else {
+    LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecNeg(HVecNeg* instruction) {
+  CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecNeg(HVecNeg* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister src = VRegisterFrom(locations->InAt(0));
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorConfig(GetAssembler(), instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      __ VRsubVI(dst, src, 0);
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      __ VFsgnjnVV(dst, src, src);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecAbs(HVecAbs* instruction) {
+  CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecAbs(HVecAbs* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister src = VRegisterFrom(locations->InAt(0));
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorConfig(GetAssembler(), instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kInt8:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      __ VRsubVI(VTMP, src, 0);
+      __ VMaxVV(dst, src, VTMP);
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      __ VFsgnjxVV(dst, src, src);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecNot(HVecNot* instruction) {
+  CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecNot(HVecNot* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister src = VRegisterFrom(locations->InAt(0));
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorConfig(GetAssembler(), instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:  // special case boolean-not
+      __ VXorVI(dst, src, 1);
+      break;
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      __ VXorVI(dst, src, -1);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+// Helper to set up locations for vector binary operations.
+static void CreateVecBinOpLocations(ArenaAllocator* allocator, HVecBinaryOperation* instruction) {
+  LocationSummary* locations = new (allocator) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetInAt(1, Location::RequiresFpuRegister());
+      locations->SetOut(Location::RequiresFpuRegister(), Location::kNoOutputOverlap);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecAdd(HVecAdd* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecAdd(HVecAdd* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister lhs = VRegisterFrom(locations->InAt(0));
+  VRegister rhs = VRegisterFrom(locations->InAt(1));
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorConfig(GetAssembler(), instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      __ VAddVV(dst, lhs, rhs);
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      __ VFaddVV(dst, lhs, rhs);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecSaturationAdd(HVecSaturationAdd* instruction) {
+  LOG(FATAL) << "Unsupported SIMD instruction " << instruction->GetId();
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecSaturationAdd(HVecSaturationAdd* instruction) {
+  LOG(FATAL) << "Unsupported SIMD instruction " << instruction->GetId();
+}
+
+void LocationsBuilderRISCV64::VisitVecHalvingAdd(HVecHalvingAdd* instruction) {
+  LOG(FATAL) << "Unsupported SIMD instruction " << instruction->GetId();
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecHalvingAdd(HVecHalvingAdd* instruction) {
+  LOG(FATAL) << "Unsupported SIMD instruction " << instruction->GetId();
+}
+
+void LocationsBuilderRISCV64::VisitVecSub(HVecSub* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecSub(HVecSub* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister lhs = VRegisterFrom(locations->InAt(0));
+  VRegister rhs = VRegisterFrom(locations->InAt(1));
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorConfig(GetAssembler(), instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      __ VSubVV(dst, lhs, rhs);
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      __ VFsubVV(dst, lhs, rhs);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecSaturationSub(HVecSaturationSub* instruction) {
+  LOG(FATAL) << "Unsupported SIMD instruction " << instruction->GetId();
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecSaturationSub(HVecSaturationSub* instruction) {
+  LOG(FATAL) << "Unsupported SIMD instruction " << instruction->GetId();
+}
+
+void LocationsBuilderRISCV64::VisitVecMul(HVecMul* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecMul(HVecMul* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister lhs = VRegisterFrom(locations->InAt(0));
+  VRegister rhs = VRegisterFrom(locations->InAt(1));
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorConfig(GetAssembler(), instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      __ VMulVV(dst, lhs, rhs);
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      __ VFmulVV(dst, lhs, rhs);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecDiv(HVecDiv* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecDiv(HVecDiv* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister lhs = VRegisterFrom(locations->InAt(0));
+  VRegister rhs = VRegisterFrom(locations->InAt(1));
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorConfig(GetAssembler(), instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      __ VFdivVV(dst, lhs, rhs);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecMin(HVecMin* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecMin(HVecMin* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister lhs = VRegisterFrom(locations->InAt(0));
+  VRegister rhs = VRegisterFrom(locations->InAt(1));
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorConfig(GetAssembler(), instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kUint32:
+    case DataType::Type::kUint64:
+      __ VMinuVV(dst, lhs, rhs);
+      break;
+    case DataType::Type::kInt8:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      __ VMinVV(dst, lhs, rhs);
+      break;
+    default:
+      // Note: `vfmin.vv` does not propagate NaNs as required by Java.
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecMax(HVecMax* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecMax(HVecMax* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister lhs = VRegisterFrom(locations->InAt(0));
+  VRegister rhs = VRegisterFrom(locations->InAt(1));
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorConfig(GetAssembler(), instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kUint32:
+    case DataType::Type::kUint64:
+      __ VMaxuVV(dst, lhs, rhs);
+      break;
+    case DataType::Type::kInt8:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      __ VMaxVV(dst, lhs, rhs);
+      break;
+    default:
+      // Note: `vfmax.vv` does not propagate NaNs as required by Java.
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecAnd(HVecAnd* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecAnd(HVecAnd* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister lhs = VRegisterFrom(locations->InAt(0));
+  VRegister rhs = VRegisterFrom(locations->InAt(1));
+  VRegister dst = VRegisterFrom(locations->Out());
+  // Bitwise operations do not depend on the element width.
+  SetVectorConfig(GetAssembler(), instruction);
+  __ VAndVV(dst, lhs, rhs);
+}
+
+void LocationsBuilderRISCV64::VisitVecAndNot(HVecAndNot* instruction) {
+  LOG(FATAL) << "Unsupported SIMD instruction " << instruction->GetId();
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecAndNot(HVecAndNot* instruction) {
+  // TODO: Use `vandn.vv` from the "Zvbb" extension when available.
+  LOG(FATAL) << "Unsupported SIMD instruction " << instruction->GetId();
+}
+
+void LocationsBuilderRISCV64::VisitVecOr(HVecOr* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecOr(HVecOr* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister lhs = VRegisterFrom(locations->InAt(0));
+  VRegister rhs = VRegisterFrom(locations->InAt(1));
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorConfig(GetAssembler(), instruction);
+  __ VOrVV(dst, lhs, rhs);
+}
+
+void LocationsBuilderRISCV64::VisitVecXor(HVecXor* instruction) {
+  CreateVecBinOpLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecXor(HVecXor* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister lhs = VRegisterFrom(locations->InAt(0));
+  VRegister rhs = VRegisterFrom(locations->InAt(1));
+  VRegister dst = VRegisterFrom(locations->Out());
+  SetVectorConfig(GetAssembler(), instruction);
+  __ VXorVV(dst, lhs, rhs);
+}
+
+// Helper to set up locations for vector shift operations.
+static void CreateVecShiftLocations(ArenaAllocator* allocator, HVecBinaryOperation* instruction) {
+  LocationSummary* locations = new (allocator) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetInAt(1, Location::ConstantLocation(instruction->InputAt(1)));
+      locations->SetOut(Location::RequiresFpuRegister(), Location::kNoOutputOverlap);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+template <void (Riscv64Assembler::*opVI)(VRegister, VRegister, uint32_t),
+          void (Riscv64Assembler::*opVX)(VRegister, VRegister, XRegister)>
+void InstructionCodeGeneratorRISCV64::GenerateVecShift(HVecBinaryOperation* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister lhs = VRegisterFrom(locations->InAt(0));
+  VRegister dst = VRegisterFrom(locations->Out());
+  uint32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
+  DCHECK_LT(value, DataType::Size(instruction->GetPackedType()) * kBitsPerByte);
+  SetVectorConfig(GetAssembler(), instruction);
+  if (IsUint<5>(value)) {
+    (GetAssembler()->*opVI)(dst, lhs, value);
+  } else {
+    // Only 64-bit elements can be shifted by 32 or more.
+    ScratchRegisterScope srs(GetAssembler());
+    XRegister tmp = srs.AllocateXRegister();
+    __ Li(tmp, value);
+    (GetAssembler()->*opVX)(dst, lhs, tmp);
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecShl(HVecShl* instruction) {
+  CreateVecShiftLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecShl(HVecShl* instruction) {
+  GenerateVecShift<&Riscv64Assembler::VSllVI, &Riscv64Assembler::VSllVX>(instruction);
+}
+
+void LocationsBuilderRISCV64::VisitVecShr(HVecShr* instruction) {
+  CreateVecShiftLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecShr(HVecShr* instruction) {
+  GenerateVecShift<&Riscv64Assembler::VSraVI, &Riscv64Assembler::VSraVX>(instruction);
+}
+
+void LocationsBuilderRISCV64::VisitVecUShr(HVecUShr* instruction) {
+  CreateVecShiftLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecUShr(HVecUShr* instruction) {
+  GenerateVecShift<&Riscv64Assembler::VSrlVI, &Riscv64Assembler::VSrlVX>(instruction);
+}
+
+void LocationsBuilderRISCV64::VisitVecSetScalars(HVecSetScalars* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+
+  DCHECK_EQ(1u, instruction->InputCount());  // only one input currently implemented
+
+  HInstruction* input = instruction->InputAt(0);
+  bool is_zero = IsZeroBitPattern(input);
+
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      locations->SetInAt(0, is_zero ? Location::ConstantLocation(input)
+                                    : Location::RequiresRegister());
+      locations->SetOut(Location::RequiresFpuRegister());
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      locations->SetInAt(0, is_zero ? Location::ConstantLocation(input)
+                                    : Location::RequiresFpuRegister());
+      locations->SetOut(Location::RequiresFpuRegister());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecSetScalars(HVecSetScalars* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister dst = VRegisterFrom(locations->Out());
+
+  DCHECK_EQ(1u, instruction->InputCount());  // only one input currently implemented
+
+  // Zero out all other elements first.
+  SetVectorConfig(GetAssembler(), instruction);
+  __ VMvVI(dst, 0);
+
+  // Shorthand for any type of zero.
+  if (IsZeroBitPattern(instruction->InputAt(0))) {
+    return;
+  }
+
+  // Set the element 0, the tail elements are undisturbed.
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      __ VMvSX(dst, locations->InAt(0).AsRegister<XRegister>());
+      break;
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      __ VFmvSF(dst, locations->InAt(0).AsFpuRegister<FRegister>());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+// Helper to set up locations for vector accumulations.
+static void CreateVecAccumLocations(ArenaAllocator* allocator, HVecOperation* instruction) {
+  LocationSummary* locations = new (allocator) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+      locations->SetInAt(0, Location::RequiresFpuRegister());
+      locations->SetInAt(1, Location::RequiresFpuRegister());
+      locations->SetInAt(2, Location::RequiresFpuRegister());
+      locations->SetOut(Location::SameAsFirstInput());
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecMultiplyAccumulate(HVecMultiplyAccumulate* instruction) {
+  CreateVecAccumLocations(GetGraph()->GetAllocator(), instruction);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecMultiplyAccumulate(
+    HVecMultiplyAccumulate* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister acc = VRegisterFrom(locations->InAt(0));
+  VRegister left = VRegisterFrom(locations->InAt(1));
+  VRegister right = VRegisterFrom(locations->InAt(2));
+
+  DCHECK(locations->InAt(0).Equals(locations->Out()));
+
+  SetVectorConfig(GetAssembler(), instruction);
+  if (instruction->GetOpKind() == HInstruction::kAdd) {
+    __ VMaccVV(acc, left, right);
+  } else {
+    DCHECK_EQ(instruction->GetOpKind(), HInstruction::kSub);
+    __ VNmsacVV(acc, left, right);
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecSADAccumulate(HVecSADAccumulate* instruction) {
+  LOG(FATAL) << "Unsupported SIMD instruction " << instruction->GetId();
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecSADAccumulate(HVecSADAccumulate* instruction) {
+  LOG(FATAL) << "Unsupported SIMD instruction " << instruction->GetId();
+}
+
+void LocationsBuilderRISCV64::VisitVecDotProd(HVecDotProd* instruction) {
+  LOG(FATAL) << "Unsupported SIMD instruction " << instruction->GetId();
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecDotProd(HVecDotProd* instruction) {
+  LOG(FATAL) << "Unsupported SIMD instruction " << instruction->GetId();
+}
+
+// Helper to set up locations for vector memory operations.
+static void CreateVecMemLocations(ArenaAllocator* allocator,
+                                  HVecMemoryOperation* instruction,
+                                  bool is_load) {
+  LocationSummary* locations = new (allocator) LocationSummary(instruction);
+  switch (instruction->GetPackedType()) {
+    case DataType::Type::kBool:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
+    case DataType::Type::kInt32:
+    case DataType::Type::kInt64:
+    case DataType::Type::kFloat32:
+    case DataType::Type::kFloat64:
+      locations->SetInAt(0, Location::RequiresRegister());
+      locations->SetInAt(1, Location::RegisterOrConstant(instruction->InputAt(1)));
+      if (is_load) {
+        locations->SetOut(Location::RequiresFpuRegister());
+      } else {
+        locations->SetInAt(2, Location::RequiresFpuRegister());
+      }
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void InstructionCodeGeneratorRISCV64::VecAddress(HVecMemoryOperation* instruction,
+                                                 XRegister adjusted_base) {
+  LocationSummary* locations = instruction->GetLocations();
+  XRegister base = locations->InAt(0).AsRegister<XRegister>();
+  Location index = locations->InAt(1);
+  size_t shift = DataType::SizeShift(instruction->GetPackedType());
+  uint32_t data_offset = mirror::Array::DataOffset(DataType::Size(instruction->GetPackedType()))
+                             .Uint32Value();
+
+  if (index.IsConstant()) {
+    int64_t offset = static_cast<int64_t>(data_offset) +
+        (static_cast<int64_t>(index.GetConstant()->AsIntConstant()->GetValue()) << shift);
+    __ AddConst64(adjusted_base, base, offset);
+  } else {
+    __ ShiftAndAdd(adjusted_base, base, index.AsRegister<XRegister>(), shift);
+    __ AddConst64(adjusted_base, adjusted_base, data_offset);
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecLoad(HVecLoad* instruction) {
+  CreateVecMemLocations(GetGraph()->GetAllocator(), instruction, /*is_load*/ true);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecLoad(HVecLoad* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister reg = VRegisterFrom(locations->Out());
+  // The loop optimizer does not vectorize `String.charAt()` on riscv64, so we do not
+  // need to handle compressed strings here.
+  DCHECK(!instruction->IsStringCharAt());
+  SetVectorConfig(GetAssembler(), instruction);
+  ScratchRegisterScope srs(GetAssembler());
+  XRegister address = srs.AllocateXRegister();
+  VecAddress(instruction, address);
+  switch (DataType::Size(instruction->GetPackedType())) {
+    case 1u:
+      __ VLe8(reg, address);
+      break;
+    case 2u:
+      __ VLe16(reg, address);
+      break;
+    case 4u:
+      __ VLe32(reg, address);
+      break;
+    case 8u:
+      __ VLe64(reg, address);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecStore(HVecStore* instruction) {
+  CreateVecMemLocations(GetGraph()->GetAllocator(), instruction, /*is_load*/ false);
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecStore(HVecStore* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  VRegister reg = VRegisterFrom(locations->InAt(2));
+  SetVectorConfig(GetAssembler(), instruction);
+  ScratchRegisterScope srs(GetAssembler());
+  XRegister address = srs.AllocateXRegister();
+  VecAddress(instruction, address);
+  switch (DataType::Size(instruction->GetPackedType())) {
+    case 1u:
+      __ VSe8(reg, address);
+      break;
+    case 2u:
+      __ VSe16(reg, address);
+      break;
+    case 4u:
+      __ VSe32(reg, address);
+      break;
+    case 8u:
+      __ VSe64(reg, address);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderRISCV64::VisitVecPredSetAll(HVecPredSetAll* instruction) {
+  LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
+  DCHECK(instruction->InputAt(0)->IsIntConstant());
+  locations->SetInAt(0, Location::NoLocation());
+  locations->SetOut(Location::NoLocation());
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecPredSetAll(HVecPredSetAll*) {
+}
+
+void LocationsBuilderRISCV64::VisitVecPredWhile(HVecPredWhile* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecPredWhile(HVecPredWhile* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void LocationsBuilderRISCV64::VisitVecPredCondition(HVecPredCondition* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void InstructionCodeGeneratorRISCV64::VisitVecPredCondition(HVecPredCondition* instruction) {
+  LOG(FATAL) << "No SIMD for " << instruction->GetId();
+  UNREACHABLE();
+}
+
+void InstructionCodeGeneratorRISCV64::LoadSIMDRegFromStack(Location destination,
+                                                           Location source) {
+  DCHECK(source.IsSIMDStackSlot());
+  DCHECK_EQ(codegen_->GetSIMDRegisterWidth(), kRiscv64SIMDRegisterWidth);
+  __ SetVectorConfig(kRiscv64SIMDRegisterWidth, VectorSew::kE8);
+  ScratchRegisterScope srs(GetAssembler());
+  XRegister address = srs.AllocateXRegister();
+  __ AddConst64(address, SP, source.GetStackIndex());
+  __ VLe8(VRegisterFrom(destination), address);
+}
+
+void InstructionCodeGeneratorRISCV64::MoveSIMDRegToSIMDReg(Location destination,
+                                                           Location source) {
+  DCHECK_EQ(codegen_->GetSIMDRegisterWidth(), kRiscv64SIMDRegisterWidth);
+  __ SetVectorConfig(kRiscv64SIMDRegisterWidth, VectorSew::kE8);
+  __ VMvVV(VRegisterFrom(destination), VRegisterFrom(source));
+}
+
+void InstructionCodeGeneratorRISCV64::MoveToSIMDStackSlot(Location destination,
+                                                          Location source) {
+  DCHECK(destination.IsSIMDStackSlot());
+  DCHECK_EQ(codegen_->GetSIMDRegisterWidth(), kRiscv64SIMDRegisterWidth);
+
+  if (source.IsFpuRegister()) {
+    __ SetVectorConfig(kRiscv64SIMDRegisterWidth, VectorSew::kE8);
+    ScratchRegisterScope srs(GetAssembler());
+    XRegister address = srs.AllocateXRegister();
+    __ AddConst64(address, SP, destination.GetStackIndex());
+    __ VSe8(VRegisterFrom(source), address);
+  } else {
+    DCHECK(source.IsSIMDStackSlot());
+    ScratchRegisterScope srs(GetAssembler());
+    XRegister temp = srs.AllocateXRegister();
+    for (size_t offset = 0u;
+         offset != kRiscv64SIMDRegisterWidth;
+         offset += kRiscv64DoublewordSize) {
+      __ Loadd(temp, SP, source.GetStackIndex() + offset);
+      __ Stored(temp, SP, destination.GetStackIndex() + offset);
+    }
+  }
+}
+
+#undef __
+
+}  // namespace riscv64
+}  // namespace art
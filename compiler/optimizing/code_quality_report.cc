@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "code_quality_report.h"
+
+#include <algorithm>
+
+#include "code_generator.h"
+#include "locations.h"
+#include "nodes.h"
+#include "pass_profile.h"
+#include "thread-current-inl.h"
+
+namespace art HIDDEN {
+
+// The size of every instruction for the instruction sets with fixed-size instructions, or 0.
+// The Riscv64Assembler does not emit compressed instructions.
+static size_t GetFixedInstructionSize(InstructionSet instruction_set) {
+  switch (instruction_set) {
+    case InstructionSet::kArm64:
+    case InstructionSet::kRiscv64:
+      return 4u;
+    default:
+      return 0u;
+  }
+}
+
+CodeQualityReport::CodeQualityReport(InstructionSet instruction_set)
+    : instruction_set_(instruction_set),
+      lock_("code quality report lock") {}
+
+void CodeQualityReport::RecordMethod(CodeGenerator* codegen,
+                                     uint32_t dex_code_units,
+                                     size_t stack_map_size) {
+  HGraph* graph = codegen->GetGraph();
+  size_t spill_stores = 0u;
+  size_t spill_loads = 0u;
+  for (HBasicBlock* block : graph->GetBlocks()) {
+    if (block == nullptr) {
+      continue;
+    }
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HParallelMove* parallel_move = it.Current()->AsParallelMoveOrNull();
+      if (parallel_move == nullptr) {
+        continue;
+      }
+      for (size_t i = 0; i != parallel_move->NumMoves(); ++i) {
+        const MoveOperands* move = parallel_move->MoveOperandsAt(i);
+        Location source = move->GetSource();
+        Location destination = move->GetDestination();
+        if (source.Equals(destination)) {
+          continue;
+        }
+        if (destination.IsStackSlot() ||
+            destination.IsDoubleStackSlot() ||
+            destination.IsSIMDStackSlot()) {
+          ++spill_stores;
+        }
+        if (source.IsStackSlot() || source.IsDoubleStackSlot() || source.IsSIMDStackSlot()) {
+          ++spill_loads;
+        }
+      }
+    }
+  }
+
+  MethodInfo info = {
+      graph->GetDexFile().PrettyMethod(graph->GetMethodIdx()),
+      dex_code_units,
+      static_cast<size_t>(graph->GetCurrentInstructionId()),
+      codegen->GetCode().size(),
+      codegen->GetFrameSize(),
+      codegen->GetNumberOfSpillSlots(),
+      spill_stores,
+      spill_loads,
+      stack_map_size
+  };
+  MutexLock mu(Thread::Current(), lock_);
+  methods_.push_back(std::move(info));
+}
+
+void CodeQualityReport::Dump(std::ostream& os) {
+  MutexLock mu(Thread::Current(), lock_);
+  // The methods are recorded in the order of the compiler threads.
+  std::sort(methods_.begin(), methods_.end(), [](const MethodInfo& lhs, const MethodInfo& rhs) {
+    return lhs.name < rhs.name;
+  });
+  size_t instruction_size = GetFixedInstructionSize(instruction_set_);
+
+  MethodInfo totals = {};
+  for (const MethodInfo& info : methods_) {
+    totals.dex_code_units += info.dex_code_units;
+    totals.hir_instructions += info.hir_instructions;
+    totals.code_size += info.code_size;
+    totals.frame_size += info.frame_size;
+    totals.spill_slots += info.spill_slots;
+    totals.spill_stores += info.spill_stores;
+    totals.spill_loads += info.spill_loads;
+    totals.stack_map_size += info.stack_map_size;
+  }
+
+  // Without fixed-size instructions, the native instruction counts are not reported.
+  auto dump_info = [&os, instruction_size](const MethodInfo& info) {
+    os << "\"dex_code_units\": " << info.dex_code_units
+       << ", \"hir_instructions\": " << info.hir_instructions
+       << ", \"code_size\": " << info.code_size;
+    if (instruction_size != 0u) {
+      os << ", \"native_instructions\": " << info.code_size / instruction_size;
+    }
+    os << ", \"frame_size\": " << info.frame_size
+       << ", \"spill_slots\": " << info.spill_slots
+       << ", \"spill_stores\": " << info.spill_stores
+       << ", \"spill_loads\": " << info.spill_loads
+       << ", \"stack_map_size\": " << info.stack_map_size;
+  };
+
+  os << "{\n  \"instruction_set\": ";
+  DumpJsonString(os, GetInstructionSetString(instruction_set_));
+  os << ",\n  \"methods\": " << methods_.size() << ",\n  \"totals\": {";
+  dump_info(totals);
+  os << "},\n  \"method_stats\": [";
+  const char* separator = "\n";
+  for (const MethodInfo& info : methods_) {
+    os << separator << "    {\"method\": ";
+    DumpJsonString(os, info.name);
+    os << ", ";
+    dump_info(info);
+    os << "}";
+    separator = ",\n";
+  }
+  os << "\n  ]\n}\n";
+}
+
+}  // namespace art
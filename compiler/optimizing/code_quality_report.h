@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_CODE_QUALITY_REPORT_H_
+#define ART_COMPILER_OPTIMIZING_CODE_QUALITY_REPORT_H_
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "arch/instruction_set.h"
+#include "base/macros.h"
+#include "base/mutex.h"
+
+namespace art HIDDEN {
+
+class CodeGenerator;
+
+// Collects the size of the generated code, its spills and its stack maps for every method
+// compiled by the optimizing compiler, for dex2oat --dump-code-quality. The methods are dumped
+// by name, so that the reports of different instruction sets for the same corpus can be
+// compared method by method.
+class CodeQualityReport {
+ public:
+  explicit CodeQualityReport(InstructionSet instruction_set);
+
+  // Record the method compiled by `codegen`, after code generation.
+  void RecordMethod(CodeGenerator* codegen, uint32_t dex_code_units, size_t stack_map_size)
+      REQUIRES(!lock_);
+
+  // Write the report as one JSON object, with the methods sorted by name.
+  void Dump(std::ostream& os) REQUIRES(!lock_);
+
+ private:
+  struct MethodInfo {
+    std::string name;
+    uint32_t dex_code_units;
+    size_t hir_instructions;
+    size_t code_size;
+    uint32_t frame_size;
+    size_t spill_slots;
+    // Moves of the register allocator to and from stack slots.
+    size_t spill_stores;
+    size_t spill_loads;
+    size_t stack_map_size;
+  };
+
+  const InstructionSet instruction_set_;
+
+  Mutex lock_;
+  std::vector<MethodInfo> methods_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(CodeQualityReport);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_CODE_QUALITY_REPORT_H_
@@ -24,7 +24,10 @@
 #include "dex/dex_file.h"
 #include "dex/dex_instruction.h"
 #include "driver/compiler_options.h"
+#include "induction_var_analysis.h"
+#include "loop_optimization.h"
 #include "nodes.h"
+#include "optimizing_compiler.h"
 #include "optimizing_unit_test.h"
 #include "register_allocator_linear_scan.h"
 #include "utils/arm/assembler_arm_vixl.h"
@@ -899,4 +902,91 @@ TEST_F(CodegenTest, ARM64FrameSizeNoSIMD) {
 
 #endif
 
+#ifdef ART_ENABLE_CODEGEN_riscv64
+// Check that a loop vectorized for riscv64 is accepted by the riscv64 compiler and compiles.
+TEST_F(CodegenTest, RISCV64VectorizedLoop) {
+  // The C910 has the "XTheadVector" extension.
+  std::unique_ptr<CompilerOptions> compiler_options =
+      CommonCompilerTest::CreateCompilerOptions(InstructionSet::kRiscv64, "thead-c910");
+  InitGraph();
+  HInstruction* array = MakeParam(DataType::Type::kReference);
+
+  // for (int i = 0; i < 128; ++i) { array[i] = array[i] + 1; }, after bounds check elimination.
+  HBasicBlock* preheader = AddNewBlock();
+  HBasicBlock* header = AddNewBlock();
+  HBasicBlock* body = AddNewBlock();
+  entry_block_->ReplaceSuccessor(return_block_, preheader);
+  preheader->AddSuccessor(header);
+  header->AddSuccessor(return_block_);
+  header->AddSuccessor(body);
+  body->AddSuccessor(header);
+  entry_block_->AddInstruction(new (GetAllocator()) HGoto());
+  preheader->AddInstruction(new (GetAllocator()) HGoto());
+
+  HIntConstant* const_0 = graph_->GetIntConstant(0);
+  HIntConstant* const_1 = graph_->GetIntConstant(1);
+  HIntConstant* const_128 = graph_->GetIntConstant(128);
+  HPhi* phi = new (GetAllocator()) HPhi(GetAllocator(), 0, 0, DataType::Type::kInt32);
+  HInstruction* suspend_check = new (GetAllocator()) HSuspendCheck();
+  HInstruction* loop_check = new (GetAllocator()) HGreaterThanOrEqual(phi, const_128);
+  header->AddPhi(phi);
+  header->AddInstruction(suspend_check);
+  header->AddInstruction(loop_check);
+  header->AddInstruction(new (GetAllocator()) HIf(loop_check));
+
+  HInstruction* array_get =
+      new (GetAllocator()) HArrayGet(array, phi, DataType::Type::kInt32, /* dex_pc= */ 0u);
+  HInstruction* add = new (GetAllocator()) HAdd(DataType::Type::kInt32, array_get, const_1);
+  HInstruction* array_set = new (GetAllocator()) HArraySet(
+      array, phi, add, DataType::Type::kInt32, /* dex_pc= */ 0u);
+  HInstruction* induction_inc = new (GetAllocator()) HAdd(DataType::Type::kInt32, phi, const_1);
+  body->AddInstruction(array_get);
+  body->AddInstruction(add);
+  body->AddInstruction(array_set);
+  body->AddInstruction(induction_inc);
+  body->AddInstruction(new (GetAllocator()) HGoto());
+  phi->AddInput(const_0);
+  phi->AddInput(induction_inc);
+
+  ArenaVector<HInstruction*> current_locals({phi, const_128, array},
+                                            GetAllocator()->Adapter(kArenaAllocInstruction));
+  ManuallyBuildEnvFor(suspend_check, &current_locals);
+  graph_->BuildDominatorTree();
+  ValidateGraph(graph_);
+
+  riscv64::CodeGeneratorRISCV64 codegen(graph_, *compiler_options);
+  HInductionVarAnalysis iva(graph_);
+  iva.Run();
+  HLoopOptimization loop_optimization(graph_, codegen, &iva, /* stats= */ nullptr);
+  loop_optimization.Run();
+  ValidateGraph(graph_);
+
+  ASSERT_TRUE(graph_->HasSIMD());
+  size_t num_vec_loads = 0u;
+  size_t num_vec_stores = 0u;
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      num_vec_loads += it.Current()->IsVecLoad() ? 1u : 0u;
+      num_vec_stores += it.Current()->IsVecStore() ? 1u : 0u;
+    }
+  }
+  EXPECT_NE(num_vec_loads, 0u);
+  EXPECT_NE(num_vec_stores, 0u);
+  // A vectorized method must not be left to the interpreter.
+  ASSERT_TRUE(CanAssembleGraphForRiscv64(graph_));
+
+  {
+    ScopedArenaAllocator local_allocator(graph_->GetArenaStack());
+    SsaLivenessAnalysis liveness(graph_, &codegen, &local_allocator);
+    PrepareForRegisterAllocation(graph_, *compiler_options).Run();
+    liveness.Analyze();
+    std::unique_ptr<RegisterAllocator> register_allocator =
+        RegisterAllocator::Create(&local_allocator, &codegen, liveness);
+    register_allocator->AllocateRegisters();
+  }
+  codegen.Compile();
+  EXPECT_NE(codegen.GetCode().size(), 0u);
+}
+#endif
+
 }  // namespace art
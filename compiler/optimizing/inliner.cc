@@ -28,6 +28,7 @@
 #include "dex/inline_method_analyser.h"
 #include "driver/compiler_options.h"
 #include "driver/dex_compilation_unit.h"
+#include "escape.h"
 #include "instruction_simplifier.h"
 #include "intrinsics.h"
 #include "jit/jit.h"
@@ -56,6 +57,16 @@ static constexpr size_t kMaximumNumberOfTotalInstructions = 1024;
 // are not reached.
 static constexpr size_t kMaximumNumberOfInstructionsForSmallMethod = 3;
 
+// Instruction limit for call sites that the profile shows to be hot. Inlining into hot loops
+// pays for the extra compilation memory and code size.
+static constexpr size_t kMaximumNumberOfTotalInstructionsForHotCallSites = 1536;
+
+// Maximum number of instructions inlined at a call site that the profile shows to be cold.
+static constexpr size_t kMaximumNumberOfInstructionsForColdCallSite = 32;
+
+// Maximum size of the code of a method analyzed for only reading the heap.
+static constexpr size_t kMaximumCodeUnitsForReadOnlyAnalysis = 256;
+
 // Limit the number of dex registers that we accumulate while inlining
 // to avoid creating large amount of nested environments.
 static constexpr size_t kMaximumNumberOfCumulatedDexRegisters = 32;
@@ -133,6 +144,75 @@ void HInliner::UpdateInliningBudget() {
   }
 }
 
+bool HInliner::PassesScalarReplaceableAllocation(HInvoke* invoke_instruction) {
+  for (size_t i = 0, e = invoke_instruction->GetNumberOfArguments(); i != e; ++i) {
+    HInstruction* argument = invoke_instruction->InputAt(i);
+    if (!argument->IsNewInstance() || argument->AsNewInstance()->IsFinalizable()) {
+      continue;
+    }
+    LambdaNoEscapeCheck no_escape([invoke_instruction](HInstruction* ref, HInstruction* user) {
+      return user == invoke_instruction ||
+             (user->IsInvoke() &&
+              user->AsInvoke()->GetInvokeType() != kStatic &&
+              user->InputAt(0) == ref);
+    });
+    if (DoesNotEscape(argument, no_escape)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+HInliner::CallSiteHotness HInliner::GetCallSiteHotness(HInvoke* invoke_instruction,
+                                                       ArtMethod* method) const {
+  const bool in_loop = invoke_instruction->GetBlock()->IsInLoop();
+  if (PassesScalarReplaceableAllocation(invoke_instruction)) {
+    // Favor call sites that keep an allocation from being replaced by its fields, in loops
+    // in particular where the allocation would be repeated on each iteration.
+    return in_loop ? CallSiteHotness::kHot : CallSiteHotness::kNormal;
+  }
+  if (codegen_->GetCompilerOptions().IsJitCompiler()) {
+    // A callee that got hot enough to be JIT compiled is hot when called from a loop.
+    if (in_loop && Runtime::Current()->GetJit()->GetCodeCache()->ContainsPc(
+            method->GetEntryPointFromQuickCompiledCode())) {
+      return CallSiteHotness::kHot;
+    }
+    return CallSiteHotness::kNormal;
+  }
+  const ProfileCompilationInfo* pci = codegen_->GetCompilerOptions().GetProfileCompilationInfo();
+  if (pci == nullptr) {
+    return CallSiteHotness::kNormal;
+  }
+  ProfileCompilationInfo::MethodHotness hotness =
+      pci->GetMethodHotness(MethodReference(method->GetDexFile(), method->GetDexMethodIndex()));
+  if (hotness.IsHot()) {
+    return in_loop ? CallSiteHotness::kHot : CallSiteHotness::kNormal;
+  }
+  // Only trust the absence of profile data for methods of a dex file that is being profiled.
+  if (!in_loop &&
+      !hotness.IsInProfile() &&
+      method->GetDexFile() == caller_compilation_unit_.GetDexFile()) {
+    return CallSiteHotness::kCold;
+  }
+  return CallSiteHotness::kNormal;
+}
+
+size_t HInliner::GetInliningBudget(HInvoke* invoke_instruction, ArtMethod* method) const {
+  switch (GetCallSiteHotness(invoke_instruction, method)) {
+    case CallSiteHotness::kHot:
+      if (total_number_of_instructions_ >= kMaximumNumberOfTotalInstructionsForHotCallSites) {
+        return inlining_budget_;
+      }
+      return std::max(
+          inlining_budget_,
+          kMaximumNumberOfTotalInstructionsForHotCallSites - total_number_of_instructions_);
+    case CallSiteHotness::kNormal:
+      return inlining_budget_;
+    case CallSiteHotness::kCold:
+      return std::min(inlining_budget_, kMaximumNumberOfInstructionsForColdCallSite);
+  }
+}
+
 bool HInliner::Run() {
   if (codegen_->GetCompilerOptions().GetInlineMaxCodeUnits() == 0) {
     // Inlining effectively disabled.
@@ -191,9 +271,12 @@ bool HInliner::Run() {
           if (callee_name.find("$noinline$") == std::string::npos) {
             if (TryInline(call)) {
               did_inline = true;
-            } else if (honor_inline_directives) {
-              bool should_have_inlined = (callee_name.find("$inline$") != std::string::npos);
-              CHECK(!should_have_inlined) << "Could not inline " << callee_name;
+            } else {
+              MaybeSetReadOnlySideEffects(call);
+              if (honor_inline_directives) {
+                bool should_have_inlined = (callee_name.find("$inline$") != std::string::npos);
+                CHECK(!should_have_inlined) << "Could not inline " << callee_name;
+              }
             }
           }
         } else {
@@ -201,6 +284,8 @@ bool HInliner::Run() {
           // Normal case: try to inline.
           if (TryInline(call)) {
             did_inline = true;
+          } else {
+            MaybeSetReadOnlySideEffects(call);
           }
         }
       }
@@ -213,6 +298,63 @@ bool HInliner::Run() {
   return did_inline || graph_->HasAlwaysThrowingInvokes();
 }
 
+// Returns whether the code of `method` does not write the heap, does not synchronize and does
+// not call other methods or class initializers. The method only reads the heap and allocates
+// arrays, which nobody else can see while it runs.
+static bool IsReadOnlyMethod(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_) {
+  if (method->IsNative() || method->IsAbstract() || method->IsSynchronized()) {
+    return false;
+  }
+  CodeItemInstructionAccessor accessor = method->DexInstructions();
+  if (!accessor.HasCodeItem() ||
+      accessor.InsnsSizeInCodeUnits() > kMaximumCodeUnitsForReadOnlyAnalysis) {
+    return false;
+  }
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  for (const DexInstructionPcPair& pair : accessor) {
+    const Instruction& instruction = pair.Inst();
+    Instruction::Code opcode = instruction.Opcode();
+    if (opcode >= Instruction::IGET && opcode <= Instruction::IGET_SHORT) {
+      // Volatile loads order the loads which follow them.
+      ArtField* field = class_linker->LookupResolvedField(
+          instruction.VRegC_22c(), method, /* is_static= */ false);
+      if (field == nullptr || field->IsVolatile()) {
+        return false;
+      }
+    } else if (!((opcode >= Instruction::NOP && opcode <= Instruction::CONST_CLASS) ||
+                 (opcode >= Instruction::CHECK_CAST && opcode <= Instruction::ARRAY_LENGTH) ||
+                 opcode == Instruction::NEW_ARRAY ||
+                 (opcode >= Instruction::THROW && opcode <= Instruction::IF_LEZ) ||
+                 (opcode >= Instruction::AGET && opcode <= Instruction::AGET_SHORT) ||
+                 (opcode >= Instruction::NEG_INT && opcode <= Instruction::USHR_INT_LIT8))) {
+      // Stores, static field accesses, monitors, invokes and allocations of instances, which
+      // may run class initializers.
+      return false;
+    }
+  }
+  return true;
+}
+
+void HInliner::MaybeSetReadOnlySideEffects(HInvoke* invoke_instruction) {
+  // The invoke may have been replaced, for example when devirtualized.
+  if (invoke_instruction->GetBlock() == nullptr ||
+      !invoke_instruction->IsInvokeStaticOrDirect() ||
+      invoke_instruction->IsIntrinsic() ||
+      !invoke_instruction->GetSideEffects().DoesAnyWrite()) {
+    return;
+  }
+  HInvokeStaticOrDirect* invoke = invoke_instruction->AsInvokeStaticOrDirect();
+  if (invoke->IsStringInit() || invoke->IsStaticWithImplicitClinitCheck()) {
+    return;
+  }
+  ScopedObjectAccess soa(Thread::Current());
+  ArtMethod* method = invoke->GetResolvedMethod();
+  if (method != nullptr && IsReadOnlyMethod(method)) {
+    invoke->SetSideEffects(SideEffects::AllReads().Union(SideEffects::CanTriggerGC()));
+    MaybeRecordStat(stats_, MethodCompilationStat::kReadOnlyCalleeInvoke);
+  }
+}
+
 static bool IsMethodOrDeclaringClassFinal(ArtMethod* method)
     REQUIRES_SHARED(Locks::mutator_lock_) {
   return method->IsFinal() || method->GetDeclaringClass()->IsFinal();
@@ -962,6 +1104,10 @@ bool HInliner::TryInlinePolymorphicCall(
     return true;
   }
 
+  if (TryInlinePolymorphicCallGroupedByTarget(invoke_instruction, classes)) {
+    return true;
+  }
+
   ClassLinker* class_linker = caller_compilation_unit_.GetClassLinker();
   PointerSize pointer_size = class_linker->GetImagePointerSize();
 
@@ -1144,13 +1290,7 @@ bool HInliner::TryInlinePolymorphicCallToSameTarget(
     return false;
   }
 
-  ClassLinker* class_linker = caller_compilation_unit_.GetClassLinker();
-  PointerSize pointer_size = class_linker->GetImagePointerSize();
-
   ArtMethod* actual_method = nullptr;
-  size_t method_index = invoke_instruction->IsInvokeVirtual()
-      ? invoke_instruction->AsInvokeVirtual()->GetVTableIndex()
-      : invoke_instruction->AsInvokeInterface()->GetImtIndex();
 
   // Check whether we are actually calling the same method among
   // the different types seen.
@@ -1158,21 +1298,13 @@ bool HInliner::TryInlinePolymorphicCallToSameTarget(
   uint8_t number_of_types = InlineCache::kIndividualCacheSize - classes.RemainingSlots();
   for (size_t i = 0; i != number_of_types; ++i) {
     DCHECK(classes.GetReference(i) != nullptr);
-    ArtMethod* new_method = nullptr;
-    if (invoke_instruction->IsInvokeInterface()) {
-      new_method = classes.GetReference(i)->AsClass()->GetImt(pointer_size)->Get(
-          method_index, pointer_size);
-      if (new_method->IsRuntimeMethod()) {
-        // Bail out as soon as we see a conflict trampoline in one of the target's
-        // interface table.
-        return false;
-      }
-    } else {
-      DCHECK(invoke_instruction->IsInvokeVirtual());
-      new_method =
-          classes.GetReference(i)->AsClass()->GetEmbeddedVTableEntry(method_index, pointer_size);
+    ArtMethod* new_method =
+        FindDispatchTarget(invoke_instruction, classes.GetReference(i)->AsClass());
+    if (new_method == nullptr) {
+      // Bail out as soon as we see a conflict trampoline in one of the target's
+      // interface table.
+      return false;
     }
-    DCHECK(new_method != nullptr);
     if (actual_method == nullptr) {
       actual_method = new_method;
     } else if (actual_method != new_method) {
@@ -1195,12 +1327,148 @@ bool HInliner::TryInlinePolymorphicCallToSameTarget(
   }
 
   // We successfully inlined, now add a guard.
+  HInstruction* compare =
+      AddTableEntryGuard(receiver, cursor, bb_cursor, invoke_instruction, actual_method);
+
+  if (outermost_graph_->IsCompilingOsr()) {
+    CreateDiamondPatternForPolymorphicInline(compare, return_replacement, invoke_instruction);
+  } else {
+    HDeoptimize* deoptimize = new (graph_->GetAllocator()) HDeoptimize(
+        graph_->GetAllocator(),
+        compare,
+        receiver,
+        DeoptimizationKind::kJitSameTarget,
+        invoke_instruction->GetDexPc());
+    bb_cursor->InsertInstructionAfter(deoptimize, compare);
+    deoptimize->CopyEnvironmentFrom(invoke_instruction->GetEnvironment());
+    MaybeReplaceAndRemove(return_replacement, invoke_instruction);
+    receiver->ReplaceUsesDominatedBy(deoptimize, deoptimize);
+    deoptimize->SetReferenceTypeInfo(receiver->GetReferenceTypeInfo());
+  }
+
+  // Run type propagation to get the guard typed.
+  ReferenceTypePropagation rtp_fixup(graph_,
+                                     outer_compilation_unit_.GetDexCache(),
+                                     /* is_first_run= */ false);
+  rtp_fixup.Run();
+
+  MaybeRecordStat(stats_, MethodCompilationStat::kInlinedPolymorphicCall);
+
+  LOG_SUCCESS() << "Inlined same polymorphic target " << actual_method->PrettyMethod();
+  return true;
+}
+
+bool HInliner::TryInlinePolymorphicCallGroupedByTarget(
+    HInvoke* invoke_instruction,
+    const StackHandleScope<InlineCache::kIndividualCacheSize>& classes) {
+  // The guards compare against ArtMethod pointers, which only works under JIT.
+  if (!codegen_->GetCompilerOptions().IsJitCompiler()) {
+    return false;
+  }
+
+  // Collect the distinct targets, in the order of the inline cache.
+  std::array<ArtMethod*, InlineCache::kIndividualCacheSize> targets;
+  size_t number_of_targets = 0;
+  DCHECK_EQ(classes.NumberOfReferences(), InlineCache::kIndividualCacheSize);
+  uint8_t number_of_types = InlineCache::kIndividualCacheSize - classes.RemainingSlots();
+  for (size_t i = 0; i != number_of_types; ++i) {
+    DCHECK(classes.GetReference(i) != nullptr);
+    ArtMethod* method = FindDispatchTarget(invoke_instruction, classes.GetReference(i)->AsClass());
+    if (method == nullptr) {
+      // A receiver with an IMT conflict would never pass a guard on the IMT entry.
+      return false;
+    }
+    if (std::find(targets.begin(), targets.begin() + number_of_targets, method) ==
+            targets.begin() + number_of_targets) {
+      targets[number_of_targets++] = method;
+    }
+  }
+  if (number_of_targets == number_of_types) {
+    // Nothing to share, the class guards give the inlined code exact receiver types.
+    return false;
+  }
+
+  bool one_target_inlined = false;
+  for (size_t i = 0; i != number_of_targets; ++i) {
+    ArtMethod* method = targets[i];
+    if (CountRecursiveCallsOf(method) > kMaximumNumberOfPolymorphicRecursiveCalls) {
+      LOG_FAIL(stats_, MethodCompilationStat::kNotInlinedPolymorphicRecursiveBudget)
+          << "Method " << method->PrettyMethod()
+          << " is not inlined because it has reached its polymorphic recursive call budget.";
+      continue;
+    }
+
+    HInstruction* receiver = invoke_instruction->InputAt(0);
+    HInstruction* cursor = invoke_instruction->GetPrevious();
+    HBasicBlock* bb_cursor = invoke_instruction->GetBlock();
+    HInstruction* return_replacement = nullptr;
+    LOG_NOTE() << "Try inline polymorphic call to shared target " << method->PrettyMethod();
+    if (!TryBuildAndInline(invoke_instruction,
+                           method,
+                           ReferenceTypeInfo::CreateInvalid(),
+                           &return_replacement,
+                           /* is_speculative= */ true)) {
+      continue;
+    }
+    one_target_inlined = true;
+    LOG_SUCCESS() << "Polymorphic call to "
+                  << invoke_instruction->GetMethodReference().PrettyMethod()
+                  << " has inlined shared target " << ArtMethod::PrettyMethod(method);
+
+    // Receivers with other targets, including the ones not seen yet, take the original invoke.
+    HInstruction* compare =
+        AddTableEntryGuard(receiver, cursor, bb_cursor, invoke_instruction, method);
+    CreateDiamondPatternForPolymorphicInline(compare, return_replacement, invoke_instruction);
+  }
+
+  if (!one_target_inlined) {
+    return false;
+  }
+
+  MaybeRecordStat(stats_, MethodCompilationStat::kInlinedPolymorphicCall);
+
+  // Run type propagation to get the guards typed.
+  ReferenceTypePropagation rtp_fixup(graph_,
+                                     outer_compilation_unit_.GetDexCache(),
+                                     /* is_first_run= */ false);
+  rtp_fixup.Run();
+  return true;
+}
+
+ArtMethod* HInliner::FindDispatchTarget(HInvoke* invoke_instruction,
+                                        ObjPtr<mirror::Class> klass) {
+  PointerSize pointer_size = caller_compilation_unit_.GetClassLinker()->GetImagePointerSize();
+  ArtMethod* method = nullptr;
+  if (invoke_instruction->IsInvokeInterface()) {
+    method = klass->GetImt(pointer_size)->Get(
+        invoke_instruction->AsInvokeInterface()->GetImtIndex(), pointer_size);
+    if (method->IsRuntimeMethod()) {
+      return nullptr;
+    }
+  } else {
+    DCHECK(invoke_instruction->IsInvokeVirtual());
+    method = klass->GetEmbeddedVTableEntry(
+        invoke_instruction->AsInvokeVirtual()->GetVTableIndex(), pointer_size);
+  }
+  DCHECK(method != nullptr);
+  return method;
+}
+
+HInstruction* HInliner::AddTableEntryGuard(HInstruction* receiver,
+                                           HInstruction* cursor,
+                                           HBasicBlock* bb_cursor,
+                                           HInvoke* invoke_instruction,
+                                           ArtMethod* method) {
+  ClassLinker* class_linker = caller_compilation_unit_.GetClassLinker();
   HInstanceFieldGet* receiver_class = BuildGetReceiverClass(
       class_linker, receiver, invoke_instruction->GetDexPc());
 
   DataType::Type type = Is64BitInstructionSet(graph_->GetInstructionSet())
       ? DataType::Type::kInt64
       : DataType::Type::kInt32;
+  size_t method_index = invoke_instruction->IsInvokeVirtual()
+      ? invoke_instruction->AsInvokeVirtual()->GetVTableIndex()
+      : invoke_instruction->AsInvokeInterface()->GetImtIndex();
   HClassTableGet* class_table_get = new (graph_->GetAllocator()) HClassTableGet(
       receiver_class,
       type,
@@ -1212,10 +1480,10 @@ bool HInliner::TryInlinePolymorphicCallToSameTarget(
   HConstant* constant;
   if (type == DataType::Type::kInt64) {
     constant = graph_->GetLongConstant(
-        reinterpret_cast<intptr_t>(actual_method), invoke_instruction->GetDexPc());
+        reinterpret_cast<intptr_t>(method), invoke_instruction->GetDexPc());
   } else {
     constant = graph_->GetIntConstant(
-        reinterpret_cast<intptr_t>(actual_method), invoke_instruction->GetDexPc());
+        reinterpret_cast<intptr_t>(method), invoke_instruction->GetDexPc());
   }
 
   HNotEqual* compare = new (graph_->GetAllocator()) HNotEqual(class_table_get, constant);
@@ -1226,33 +1494,7 @@ bool HInliner::TryInlinePolymorphicCallToSameTarget(
   }
   bb_cursor->InsertInstructionAfter(class_table_get, receiver_class);
   bb_cursor->InsertInstructionAfter(compare, class_table_get);
-
-  if (outermost_graph_->IsCompilingOsr()) {
-    CreateDiamondPatternForPolymorphicInline(compare, return_replacement, invoke_instruction);
-  } else {
-    HDeoptimize* deoptimize = new (graph_->GetAllocator()) HDeoptimize(
-        graph_->GetAllocator(),
-        compare,
-        receiver,
-        DeoptimizationKind::kJitSameTarget,
-        invoke_instruction->GetDexPc());
-    bb_cursor->InsertInstructionAfter(deoptimize, compare);
-    deoptimize->CopyEnvironmentFrom(invoke_instruction->GetEnvironment());
-    MaybeReplaceAndRemove(return_replacement, invoke_instruction);
-    receiver->ReplaceUsesDominatedBy(deoptimize, deoptimize);
-    deoptimize->SetReferenceTypeInfo(receiver->GetReferenceTypeInfo());
-  }
-
-  // Run type propagation to get the guard typed.
-  ReferenceTypePropagation rtp_fixup(graph_,
-                                     outer_compilation_unit_.GetDexCache(),
-                                     /* is_first_run= */ false);
-  rtp_fixup.Run();
-
-  MaybeRecordStat(stats_, MethodCompilationStat::kInlinedPolymorphicCall);
-
-  LOG_SUCCESS() << "Inlined same polymorphic target " << actual_method->PrettyMethod();
-  return true;
+  return compare;
 }
 
 void HInliner::MaybeRunReferenceTypePropagation(HInstruction* replacement,
@@ -1883,6 +2125,64 @@ void HInliner::SubstituteArguments(HGraph* callee_graph,
   }
 }
 
+// Returns the array whose length `length` is, looking through its null check.
+static HInstruction* GetArrayOfLength(HInstruction* length) {
+  HInstruction* array = length->InputAt(0);
+  return array->IsNullCheck() ? array->InputAt(0) : array;
+}
+
+void HInliner::RemoveBoundsChecksWithCallerRange(HGraph* callee_graph,
+                                                 HInvoke* invoke_instruction) {
+  // An argument which is the result of a bounds check in the caller is known to be in range
+  // of the array whose length it was checked against. If that array is also an argument, the
+  // same range holds for the corresponding parameters of the callee.
+  // Note: parameters are counted like in SubstituteArguments(), the index of a parameter value
+  // counts the dex registers of its predecessors instead.
+  const HInstructionList& parameters = callee_graph->GetEntryBlock()->GetInstructions();
+  size_t index_arg = 0;
+  for (HInstructionIterator index_it(parameters); !index_it.Done(); index_it.Advance()) {
+    HParameterValue* index = index_it.Current()->AsParameterValueOrNull();
+    if (index == nullptr) {
+      continue;
+    }
+    HBoundsCheck* check = invoke_instruction->InputAt(index_arg++)->AsBoundsCheckOrNull();
+    if (check == nullptr || !index->HasUses() || !check->InputAt(1)->IsArrayLength()) {
+      continue;
+    }
+    HArrayLength* length = check->InputAt(1)->AsArrayLength();
+    HInstruction* array = GetArrayOfLength(length);
+    size_t array_arg = 0;
+    for (HInstructionIterator array_it(parameters); !array_it.Done(); array_it.Advance()) {
+      HParameterValue* parameter = array_it.Current()->AsParameterValueOrNull();
+      if (parameter == nullptr) {
+        continue;
+      }
+      HInstruction* argument = invoke_instruction->InputAt(array_arg++);
+      if ((argument->IsNullCheck() ? argument->InputAt(0) : argument) != array) {
+        continue;
+      }
+      for (auto it = index->GetUses().begin(); it != index->GetUses().end();) {
+        HInstruction* user = it->GetUser();
+        size_t input_index = it->GetIndex();
+        ++it;  // Advance before we remove the bounds check.
+        if (input_index != 0u ||
+            !user->IsBoundsCheck() ||
+            user->AsBoundsCheck()->IsStringCharAt() != check->IsStringCharAt() ||
+            !user->InputAt(1)->IsArrayLength()) {
+          continue;
+        }
+        HArrayLength* callee_length = user->InputAt(1)->AsArrayLength();
+        if (callee_length->IsStringLength() == length->IsStringLength() &&
+            GetArrayOfLength(callee_length) == parameter) {
+          user->ReplaceWith(index);
+          user->GetBlock()->RemoveInstruction(user);
+          MaybeRecordStat(stats_, MethodCompilationStat::kRemovedBoundsCheckWithCallerRange);
+        }
+      }
+    }
+  }
+}
+
 // Returns whether we can inline the callee_graph into the target_block.
 //
 // This performs a combination of semantics checks, compiler support checks, and
@@ -1971,6 +2271,7 @@ bool HInliner::CanInlineBody(const HGraph* callee_graph,
   bool needs_bss_check = false;
   const bool can_encode_in_stack_map = CanEncodeInlinedMethodInStackMap(
       *outer_compilation_unit_.GetDexFile(), resolved_method, codegen_, &needs_bss_check);
+  const size_t inlining_budget = GetInliningBudget(invoke, resolved_method);
   size_t number_of_instructions = 0;
   // Skip the entry block, it does not contain instructions that prevent inlining.
   for (HBasicBlock* block : callee_graph->GetReversePostOrderSkipEntryBlock()) {
@@ -1997,7 +2298,7 @@ bool HInliner::CanInlineBody(const HGraph* callee_graph,
     for (HInstructionIterator instr_it(block->GetInstructions());
          !instr_it.Done();
          instr_it.Advance()) {
-      if (++number_of_instructions > inlining_budget_) {
+      if (++number_of_instructions > inlining_budget) {
         LOG_FAIL(stats_, MethodCompilationStat::kNotInlinedInstructionBudget)
             << "Method " << resolved_method->PrettyMethod()
             << " is not inlined because the outer method has reached"
@@ -2166,6 +2467,9 @@ bool HInliner::TryBuildAndInlineHelper(HInvoke* invoke_instruction,
                    dex_compilation_unit,
                    try_catch_inlining_allowed_for_recursive_inline);
 
+  // Remove the bounds checks proven by the caller before checking the inlining budget.
+  RemoveBoundsChecksWithCallerRange(callee_graph, invoke_instruction);
+
   size_t number_of_instructions = 0;
   if (!CanInlineBody(callee_graph, invoke_instruction, &number_of_instructions, is_speculative)) {
     return false;
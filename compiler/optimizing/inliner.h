@@ -75,6 +75,10 @@ class HInliner : public HOptimization {
 
   bool TryInline(HInvoke* invoke_instruction);
 
+  // Restrict the side effects of `invoke_instruction`, which was not inlined, to reads if its
+  // target only reads the heap, so that other optimizations can move loads across it.
+  void MaybeSetReadOnlySideEffects(HInvoke* invoke_instruction);
+
   // Try to inline `resolved_method` in place of `invoke_instruction`. `do_rtp` is whether
   // reference type propagation can run after the inlining. If the inlining is successful, this
   // method will replace and remove the `invoke_instruction`.
@@ -106,6 +110,10 @@ class HInliner : public HOptimization {
                            const DexCompilationUnit& dex_compilation_unit)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Removes the bounds checks of `callee_graph` whose index and array are parameters which
+  // the caller passes an index already checked against the same array for.
+  void RemoveBoundsChecksWithCallerRange(HGraph* callee_graph, HInvoke* invoke_instruction);
+
   // Run simple optimizations on `callee_graph`.
   void RunOptimizations(HGraph* callee_graph,
                         const dex::CodeItem* code_item,
@@ -219,6 +227,27 @@ class HInliner : public HOptimization {
       const StackHandleScope<InlineCache::kIndividualCacheSize>& classes)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Try to inline the targets of a polymorphic call where several receiver types share
+  // the same target, with one guard on the vtable or IMT entry per distinct target.
+  bool TryInlinePolymorphicCallGroupedByTarget(
+      HInvoke* invoke_instruction,
+      const StackHandleScope<InlineCache::kIndividualCacheSize>& classes)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Find the method `invoke_instruction` dispatches to for receivers of type `klass`.
+  // Returns null for an IMT conflict.
+  ArtMethod* FindDispatchTarget(HInvoke* invoke_instruction, ObjPtr<mirror::Class> klass)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Add a guard that checks whether the vtable or IMT entry of `invoke_instruction`
+  // in the class of `receiver` is `method`. Returns the HNotEqual of the check.
+  HInstruction* AddTableEntryGuard(HInstruction* receiver,
+                                   HInstruction* cursor,
+                                   HBasicBlock* bb_cursor,
+                                   HInvoke* invoke_instruction,
+                                   ArtMethod* method)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Returns whether or not we should use only polymorphic inlining with no deoptimizations.
   bool UseOnlyPolymorphicInliningWithNoDeopt();
 
@@ -307,6 +336,27 @@ class HInliner : public HOptimization {
   // Update the inlining budget based on `total_number_of_instructions_`.
   void UpdateInliningBudget();
 
+  enum class CallSiteHotness {
+    kCold,
+    kNormal,
+    kHot,
+  };
+
+  // Returns whether `invoke_instruction` gets an allocation of this method that does not
+  // escape apart from being passed to invokes, as its receiver or to `invoke_instruction`.
+  // Inlining these invokes lets load-store elimination replace the allocation by its fields.
+  static bool PassesScalarReplaceableAllocation(HInvoke* invoke_instruction);
+
+  // Classify the call of `method` at `invoke_instruction` from the JIT code cache or the
+  // AOT profile, and from the allocations it gets.
+  CallSiteHotness GetCallSiteHotness(HInvoke* invoke_instruction, ArtMethod* method) const
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Return the number of instructions we may inline at `invoke_instruction`: hot call sites
+  // may go over `inlining_budget_`, cold ones get less of it.
+  size_t GetInliningBudget(HInvoke* invoke_instruction, ArtMethod* method) const
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Count the number of calls of `method` being inlined recursively.
   size_t CountRecursiveCallsOf(ArtMethod* method) const;
 
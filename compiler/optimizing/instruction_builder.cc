@@ -33,12 +33,14 @@
 #include "intrinsics.h"
 #include "intrinsics_utils.h"
 #include "jit/jit.h"
+#include "jit/profiling_info.h"
 #include "mirror/dex_cache.h"
 #include "oat_file.h"
 #include "optimizing_compiler_stats.h"
 #include "reflective_handle_scope-inl.h"
 #include "scoped_thread_state_change-inl.h"
 #include "sharpening.h"
+#include "sparse_switch_tree.h"
 #include "ssa_builder.h"
 #include "well_known_classes.h"
 
@@ -807,6 +809,8 @@ void HInstructionBuilder::BuildSwitch(const Instruction& instruction, uint32_t d
     // Empty Switch. Code falls through to the next block.
     DCHECK(IsFallthroughInstruction(instruction, dex_pc, current_block_));
     AppendInstruction(new (allocator_) HGoto(dex_pc));
+  } else if (SparseSwitchTree::ShouldBuildTree(table)) {
+    BuildSparseSwitchTree(table, value, dex_pc);
   } else if (table.ShouldBuildDecisionTree()) {
     for (DexSwitchTableIterator it(table); !it.Done(); it.Advance()) {
       HInstruction* case_value = graph_->GetIntConstant(it.CurrentKey(), dex_pc);
@@ -826,6 +830,39 @@ void HInstructionBuilder::BuildSwitch(const Instruction& instruction, uint32_t d
   current_block_ = nullptr;
 }
 
+void HInstructionBuilder::BuildSparseSwitchTree(const DexSwitchTable& table,
+                                                HInstruction* value,
+                                                uint32_t dex_pc) {
+  ScopedArenaAllocator allocator(local_allocator_->GetArenaStack());
+  SparseSwitchTree tree(table, &allocator);
+  for (size_t index = 0u; index != tree.GetNumberOfNodes(); ++index) {
+    if (index != 0u) {
+      current_block_ = FindBlockStartingAt(tree.GetStoreDexPcForNode(index));
+    }
+    const SparseSwitchTree::Node& node = tree.GetNode(index);
+    switch (node.kind) {
+      case SparseSwitchTree::NodeKind::kLessThan: {
+        HInstruction* key = graph_->GetIntConstant(node.key, dex_pc);
+        HLessThan* comparison = new (allocator_) HLessThan(value, key, dex_pc);
+        AppendInstruction(comparison);
+        AppendInstruction(new (allocator_) HIf(comparison, dex_pc));
+        break;
+      }
+      case SparseSwitchTree::NodeKind::kEqual: {
+        HInstruction* key = graph_->GetIntConstant(node.key, dex_pc);
+        HEqual* comparison = new (allocator_) HEqual(value, key, dex_pc);
+        AppendInstruction(comparison);
+        AppendInstruction(new (allocator_) HIf(comparison, dex_pc));
+        break;
+      }
+      case SparseSwitchTree::NodeKind::kPackedSwitch:
+        AppendInstruction(new (allocator_) HPackedSwitch(
+            node.key, tree.GetNumberOfEntries(node), value, dex_pc));
+        break;
+    }
+  }
+}
+
 void HInstructionBuilder::BuildReturn(const Instruction& instruction,
                                       DataType::Type type,
                                       uint32_t dex_pc) {
@@ -1437,6 +1474,10 @@ HNewInstance* HInstructionBuilder::BuildNewInstance(dex::TypeIndex type_index, u
   if (!klass.IsNull() && klass->IsStringClass()) {
     entrypoint = kQuickAllocStringObject;
   }
+  if ((entrypoint == kQuickAllocObjectInitialized || entrypoint == kQuickAllocObjectResolved) &&
+      IsLongLivedAllocationSite(dex_pc)) {
+    entrypoint = kQuickAllocObjectNonMoving;
+  }
 
   // Consider classes we haven't resolved as potentially finalizable.
   bool finalizable = (klass == nullptr) || klass->IsFinalizable();
@@ -1652,6 +1693,20 @@ static bool HasTrivialInitialization(ObjPtr<mirror::Class> cls,
   return true;
 }
 
+bool HInstructionBuilder::IsLongLivedAllocationSite(uint32_t dex_pc) {
+  // Baseline code is what collects the samples, and only optimized code uses them.
+  ProfilingInfo* info = graph_->GetProfilingInfo();
+  if (info == nullptr || graph_->IsCompilingBaseline()) {
+    return false;
+  }
+  AllocationSite* site = info->GetAllocationSite(dex_pc);
+  if (site == nullptr || !site->IsLongLived()) {
+    return false;
+  }
+  MaybeRecordStat(compilation_stats_, MethodCompilationStat::kPretenuredAllocation);
+  return true;
+}
+
 bool HInstructionBuilder::IsInitialized(ObjPtr<mirror::Class> cls) const {
   if (cls == nullptr) {
     return false;
@@ -2419,6 +2474,9 @@ HNewArray* HInstructionBuilder::BuildNewArray(uint32_t dex_pc,
   size_t component_type_shift = Primitive::ComponentSizeShift(Primitive::GetType(descriptor[1]));
 
   HNewArray* new_array = new (allocator_) HNewArray(cls, length, dex_pc, component_type_shift);
+  if (IsLongLivedAllocationSite(dex_pc)) {
+    new_array->SetPretenured();
+  }
   AppendInstruction(new_array);
   return new_array;
 }
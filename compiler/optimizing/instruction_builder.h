@@ -35,6 +35,7 @@ class ArtField;
 class ArtMethod;
 class CodeGenerator;
 class DexCompilationUnit;
+class DexSwitchTable;
 class HBasicBlockBuilder;
 class Instruction;
 class InstructionOperands;
@@ -210,6 +211,8 @@ class HInstructionBuilder : public ValueObject {
 
   // Builds an instruction sequence for a switch statement.
   void BuildSwitch(const Instruction& instruction, uint32_t dex_pc);
+  // Builds the comparisons and jump tables of the blocks of a SparseSwitchTree.
+  void BuildSparseSwitchTree(const DexSwitchTable& table, HInstruction* value, uint32_t dex_pc);
 
   // Builds a `HLoadString` loading the given `string_index`.
   void BuildLoadString(dex::StringIndex string_index, uint32_t dex_pc);
@@ -286,6 +289,10 @@ class HInstructionBuilder : public ValueObject {
   bool IsInitialized(ObjPtr<mirror::Class> cls) const
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Return whether the objects allocated at `dex_pc` mostly survived their first GC in the
+  // samples of the ProfilingInfo, so that the allocation should go to the non-moving space.
+  bool IsLongLivedAllocationSite(uint32_t dex_pc);
+
   // Try to resolve a field using the class linker. Return null if it could not
   // be found.
   ArtField* ResolveField(uint16_t field_idx, bool is_static, bool is_put);
@@ -30,6 +30,7 @@
 #include "scoped_thread_state_change-inl.h"
 #include "sharpening.h"
 #include "string_builder_append.h"
+#include "well_known_classes-inl.h"
 
 namespace art HIDDEN {
 
@@ -2626,6 +2627,25 @@ static bool NoEscapeForStringBufferReference(HInstruction* reference, HInstructi
   return false;
 }
 
+// Returns whether an `Object` with the given reference type info can be appended with
+// `StringBuilderAppend::Argument::kObject`, i.e. whether it is known to be a null or a boxed
+// primitive that `StringBuilderAppend` formats without calling `Object.toString()`.
+static bool IsStringBuilderAppendBoxedPrimitive(ReferenceTypeInfo rti) {
+  if (!rti.IsValid()) {
+    return false;
+  }
+  ScopedObjectAccess soa(Thread::Current());
+  ObjPtr<mirror::Class> input_type = rti.GetTypeHandle().Get();
+  DCHECK(input_type != nullptr);
+  // The boxed primitive classes are final, so the type info does not need to be exact.
+  return input_type == WellKnownClasses::java_lang_Boolean ||
+         input_type == WellKnownClasses::java_lang_Byte ||
+         input_type == WellKnownClasses::java_lang_Character ||
+         input_type == WellKnownClasses::java_lang_Short ||
+         input_type == WellKnownClasses::java_lang_Integer ||
+         input_type == WellKnownClasses::java_lang_Long;
+}
+
 static bool TryReplaceStringBuilderAppend(HInvoke* invoke) {
   DCHECK_EQ(invoke->GetIntrinsic(), Intrinsics::kStringBuilderToString);
   if (invoke->CanThrowIntoCatchBlock()) {
@@ -2659,10 +2679,12 @@ static bool TryReplaceStringBuilderAppend(HInvoke* invoke) {
   bool seen_constructor = false;
   bool seen_constructor_fence = false;
   bool seen_to_string = false;
-  uint32_t format = 0u;
+  // Chains longer than `StringBuilderAppend::kMaxArgs` are split into several appends, each
+  // of them starting with the result of the previous one.
+  static constexpr size_t kMaxChainedArgs = 4u * StringBuilderAppend::kMaxArgs;
   uint32_t num_args = 0u;
-  bool has_fp_args = false;
-  HInstruction* args[StringBuilderAppend::kMaxArgs];  // Added in reverse order.
+  HInstruction* args[kMaxChainedArgs];  // Added in reverse order.
+  StringBuilderAppend::Argument arg_kinds[kMaxChainedArgs];  // Added in reverse order.
   for (HBackwardInstructionIterator iter(block->GetInstructions()); !iter.Done(); iter.Advance()) {
     HInstruction* user = iter.Current();
     // Instructions of interest apply to `sb`, skip those that do not involve `sb`.
@@ -2686,8 +2708,12 @@ static bool TryReplaceStringBuilderAppend(HInvoke* invoke) {
       StringBuilderAppend::Argument arg;
       switch (as_invoke_virtual->GetIntrinsic()) {
         case Intrinsics::kStringBuilderAppendObject:
-          // TODO: Unimplemented, needs to call String.valueOf().
-          return false;
+          // TODO: Other objects are unimplemented, they need to call String.valueOf().
+          if (!IsStringBuilderAppendBoxedPrimitive(user->InputAt(1)->GetReferenceTypeInfo())) {
+            return false;
+          }
+          arg = StringBuilderAppend::Argument::kObject;
+          break;
         case Intrinsics::kStringBuilderAppendString:
           arg = StringBuilderAppend::Argument::kString;
           break;
@@ -2709,11 +2735,9 @@ static bool TryReplaceStringBuilderAppend(HInvoke* invoke) {
           break;
         case Intrinsics::kStringBuilderAppendFloat:
           arg = StringBuilderAppend::Argument::kFloat;
-          has_fp_args = true;
           break;
         case Intrinsics::kStringBuilderAppendDouble:
           arg = StringBuilderAppend::Argument::kDouble;
-          has_fp_args = true;
           break;
         case Intrinsics::kStringBuilderAppendCharSequence: {
           ReferenceTypeInfo rti = user->AsInvokeVirtual()->InputAt(1)->GetReferenceTypeInfo();
@@ -2741,10 +2765,10 @@ static bool TryReplaceStringBuilderAppend(HInvoke* invoke) {
       // Uses of the append return value should have been replaced with the first input.
       DCHECK(!as_invoke_virtual->HasUses());
       DCHECK(!as_invoke_virtual->HasEnvironmentUses());
-      if (num_args == StringBuilderAppend::kMaxArgs) {
+      if (num_args == kMaxChainedArgs) {
         return false;
       }
-      format = (format << StringBuilderAppend::kBitsPerArg) | static_cast<uint32_t>(arg);
+      arg_kinds[num_args] = arg;
       args[num_args] = as_invoke_virtual->InputAt(1u);
       ++num_args;
     } else if (user->IsInvokeStaticOrDirect() &&
@@ -2783,20 +2807,7 @@ static bool TryReplaceStringBuilderAppend(HInvoke* invoke) {
     }
   }
 
-  // Create replacement instruction.
-  HIntConstant* fmt = block->GetGraph()->GetIntConstant(static_cast<int32_t>(format));
-  ArenaAllocator* allocator = block->GetGraph()->GetAllocator();
-  HStringBuilderAppend* append = new (allocator) HStringBuilderAppend(
-      fmt, num_args, has_fp_args, allocator, invoke->GetDexPc());
-  append->SetReferenceTypeInfoIfValid(invoke->GetReferenceTypeInfo());
-  for (size_t i = 0; i != num_args; ++i) {
-    append->SetArgumentAt(i, args[num_args - 1u - i]);
-  }
-  block->InsertInstructionBefore(append, invoke);
-  DCHECK(!invoke->CanBeNull());
-  DCHECK(!append->CanBeNull());
-  invoke->ReplaceWith(append);
-  // Copy environment, except for the StringBuilder uses.
+  // Remove the StringBuilder uses from the environment that the replacement instructions copy.
   for (HEnvironment* env = invoke->GetEnvironment(); env != nullptr; env = env->GetParent()) {
     for (size_t i = 0, size = env->Size(); i != size; ++i) {
       if (env->GetInstructionAt(i) == sb) {
@@ -2805,7 +2816,48 @@ static bool TryReplaceStringBuilderAppend(HInvoke* invoke) {
       }
     }
   }
-  append->CopyEnvironmentFrom(invoke->GetEnvironment());
+
+  // Create replacement instructions.
+  ArenaAllocator* allocator = block->GetGraph()->GetAllocator();
+  HStringBuilderAppend* append = nullptr;
+  size_t next_arg = 0u;  // Index of the next argument in source order.
+  while (next_arg != num_args) {
+    HInstruction* chunk_args[StringBuilderAppend::kMaxArgs];
+    StringBuilderAppend::Argument chunk_arg_kinds[StringBuilderAppend::kMaxArgs];
+    size_t chunk_size = 0u;
+    if (append != nullptr) {
+      chunk_args[0] = append;
+      chunk_arg_kinds[0] = StringBuilderAppend::Argument::kString;
+      chunk_size = 1u;
+    }
+    for (; chunk_size != StringBuilderAppend::kMaxArgs && next_arg != num_args; ++chunk_size) {
+      chunk_args[chunk_size] = args[num_args - 1u - next_arg];
+      chunk_arg_kinds[chunk_size] = arg_kinds[num_args - 1u - next_arg];
+      ++next_arg;
+    }
+    uint32_t format = 0u;
+    bool has_fp_args = false;
+    for (size_t i = chunk_size; i != 0u; ) {
+      --i;
+      format = (format << StringBuilderAppend::kBitsPerArg) |
+               static_cast<uint32_t>(chunk_arg_kinds[i]);
+      has_fp_args = has_fp_args ||
+                    chunk_arg_kinds[i] == StringBuilderAppend::Argument::kFloat ||
+                    chunk_arg_kinds[i] == StringBuilderAppend::Argument::kDouble;
+    }
+    HIntConstant* fmt = block->GetGraph()->GetIntConstant(static_cast<int32_t>(format));
+    append = new (allocator) HStringBuilderAppend(
+        fmt, chunk_size, has_fp_args, allocator, invoke->GetDexPc());
+    append->SetReferenceTypeInfoIfValid(invoke->GetReferenceTypeInfo());
+    for (size_t i = 0; i != chunk_size; ++i) {
+      append->SetArgumentAt(i, chunk_args[i]);
+    }
+    block->InsertInstructionBefore(append, invoke);
+    append->CopyEnvironmentFrom(invoke->GetEnvironment());
+  }
+  DCHECK(!invoke->CanBeNull());
+  DCHECK(!append->CanBeNull());
+  invoke->ReplaceWith(append);
   // Remove the old instruction.
   block->RemoveInstruction(invoke);
   // Remove the StringBuilder's uses and StringBuilder.
@@ -0,0 +1,2659 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "intrinsics_riscv64.h"
+
+#include "art_method.h"
+#include "base/bit_utils.h"
+#include "code_generator_riscv64.h"
+#include "entrypoints/quick/quick_entrypoints.h"
+#include "heap_poisoning.h"
+#include "intrinsics.h"
+#include "intrinsics_utils.h"
+#include "mirror/array-inl.h"
+#include "mirror/string-inl.h"
+#include "mirror/var_handle.h"
+#include "runtime.h"
+#include "thread.h"
+#include "utils/riscv64/assembler_riscv64.h"
+
+namespace art {
+namespace riscv64 {
+
+using IntrinsicSlowPathRISCV64 = IntrinsicSlowPath<InvokeDexCallingConventionVisitorRISCV64,
+                                                   SlowPathCodeRISCV64,
+                                                   Riscv64Assembler>;
+
+// The exponent bias and the number of explicitly stored mantissa bits of `double`.
+static constexpr int32_t kDoubleExponentBias = 1023;
+static constexpr uint32_t kDoubleMantissaBits = 52u;
+
+// Bit patterns of `double` and `float` constants used below.
+static constexpr int64_t kDoubleTwoPow52 = INT64_C(0x4330000000000000);
+static constexpr int64_t kDoubleOneHalf = INT64_C(0x3fe0000000000000);
+static constexpr int32_t kFloatOneHalf = 0x3f000000;
+
+bool IntrinsicLocationsBuilderRISCV64::TryDispatch(HInvoke* invoke) {
+  Dispatch(invoke);
+  LocationSummary* res = invoke->GetLocations();
+  if (res == nullptr) {
+    return false;
+  }
+  return res->Intrinsified();
+}
+
+Riscv64Assembler* IntrinsicCodeGeneratorRISCV64::GetAssembler() {
+  return codegen_->GetAssembler();
+}
+
+#define __ assembler->
+
+static void CreateFPToIntLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresFpuRegister());
+  locations->SetOut(Location::RequiresRegister());
+}
+
+static void CreateIntToFPLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetOut(Location::RequiresFpuRegister());
+}
+
+static void CreateIntToIntLocations(
+    ArenaAllocator* allocator,
+    HInvoke* invoke,
+    Location::OutputOverlap overlaps = Location::kNoOutputOverlap) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister(), overlaps);
+}
+
+static void CreateIntIntToIntLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kNoOutputOverlap);
+}
+
+static void CreateIntIntToIntSlowPathCallLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  // Force kOutputOverlap; see comments in IntrinsicSlowPath::EmitNativeCode.
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+static void CreateFPToFPLocations(
+    ArenaAllocator* allocator,
+    HInvoke* invoke,
+    Location::OutputOverlap overlaps = Location::kNoOutputOverlap) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresFpuRegister());
+  locations->SetOut(Location::RequiresFpuRegister(), overlaps);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitDoubleDoubleToRawLongBits(HInvoke* invoke) {
+  CreateFPToIntLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitDoubleDoubleToRawLongBits(HInvoke* invoke) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = GetAssembler();
+  __ FMvXD(locations->Out().AsRegister<XRegister>(), locations->InAt(0).AsFpuRegister<FRegister>());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitDoubleLongBitsToDouble(HInvoke* invoke) {
+  CreateIntToFPLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitDoubleLongBitsToDouble(HInvoke* invoke) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = GetAssembler();
+  __ FMvDX(locations->Out().AsFpuRegister<FRegister>(), locations->InAt(0).AsRegister<XRegister>());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitFloatFloatToRawIntBits(HInvoke* invoke) {
+  CreateFPToIntLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitFloatFloatToRawIntBits(HInvoke* invoke) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = GetAssembler();
+  // FMV.X.W sign-extends the 32-bit value, as expected for `int`.
+  __ FMvXW(locations->Out().AsRegister<XRegister>(), locations->InAt(0).AsFpuRegister<FRegister>());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitFloatIntBitsToFloat(HInvoke* invoke) {
+  CreateIntToFPLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitFloatIntBitsToFloat(HInvoke* invoke) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = GetAssembler();
+  __ FMvWX(locations->Out().AsFpuRegister<FRegister>(), locations->InAt(0).AsRegister<XRegister>());
+}
+
+static void GenIsInfinite(LocationSummary* locations,
+                          DataType::Type type,
+                          Riscv64Assembler* assembler) {
+  FRegister in = locations->InAt(0).AsFpuRegister<FRegister>();
+  XRegister out = locations->Out().AsRegister<XRegister>();
+  if (type == DataType::Type::kFloat64) {
+    __ FClassD(out, in);
+  } else {
+    DCHECK_EQ(type, DataType::Type::kFloat32);
+    __ FClassS(out, in);
+  }
+  __ Andi(out, out, kPositiveInfinity | kNegativeInfinity);
+  __ Snez(out, out);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitDoubleIsInfinite(HInvoke* invoke) {
+  CreateFPToIntLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitDoubleIsInfinite(HInvoke* invoke) {
+  GenIsInfinite(invoke->GetLocations(), DataType::Type::kFloat64, GetAssembler());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitFloatIsInfinite(HInvoke* invoke) {
+  CreateFPToIntLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitFloatIsInfinite(HInvoke* invoke) {
+  GenIsInfinite(invoke->GetLocations(), DataType::Type::kFloat32, GetAssembler());
+}
+
+// Population count using CPOP from the "Zbb" extension if available. Otherwise, use the
+// SWAR ("SIMD within a register") algorithm as there is no CPOP instruction in the base ISA.
+static void GenBitCount(LocationSummary* locations, bool is_long, Riscv64Assembler* assembler) {
+  XRegister in = locations->InAt(0).AsRegister<XRegister>();
+  XRegister out = locations->Out().AsRegister<XRegister>();
+  if (assembler->HasZbb()) {
+    if (is_long) {
+      __ Cpop(out, in);
+    } else {
+      __ Cpopw(out, in);
+    }
+    return;
+  }
+
+  ScratchRegisterScope srs(assembler);
+  XRegister tmp = srs.AllocateXRegister();
+  XRegister mask = srs.AllocateXRegister();
+
+  if (is_long) {
+    __ Srli(tmp, in, 1);
+    __ Li(mask, INT64_C(0x5555555555555555));
+    __ And(tmp, tmp, mask);
+    __ Sub(out, in, tmp);  // 2-bit sums.
+    __ Li(mask, INT64_C(0x3333333333333333));
+    __ Srli(tmp, out, 2);
+    __ And(tmp, tmp, mask);
+    __ And(out, out, mask);
+    __ Add(out, out, tmp);  // 4-bit sums.
+    __ Srli(tmp, out, 4);
+    __ Add(out, out, tmp);
+    __ Li(mask, INT64_C(0x0f0f0f0f0f0f0f0f));
+    __ And(out, out, mask);  // 8-bit sums.
+    __ Li(mask, INT64_C(0x0101010101010101));
+    __ Mul(out, out, mask);  // Sum of all bytes in the most significant byte.
+    __ Srli(out, out, 56);
+  } else {
+    // The W-variants of the instructions operate on the low 32 bits only.
+    __ Srliw(tmp, in, 1);
+    __ Li(mask, 0x55555555);
+    __ And(tmp, tmp, mask);
+    __ Subw(out, in, tmp);
+    __ Li(mask, 0x33333333);
+    __ Srliw(tmp, out, 2);
+    __ And(tmp, tmp, mask);
+    __ And(out, out, mask);
+    __ Addw(out, out, tmp);
+    __ Srliw(tmp, out, 4);
+    __ Addw(out, out, tmp);
+    __ Li(mask, 0x0f0f0f0f);
+    __ And(out, out, mask);
+    __ Li(mask, 0x01010101);
+    __ Mulw(out, out, mask);
+    __ Srliw(out, out, 24);
+  }
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitIntegerBitCount(HInvoke* invoke) {
+  CreateIntToIntLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitIntegerBitCount(HInvoke* invoke) {
+  GenBitCount(invoke->GetLocations(), /*is_long=*/ false, GetAssembler());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitLongBitCount(HInvoke* invoke) {
+  CreateIntToIntLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitLongBitCount(HInvoke* invoke) {
+  GenBitCount(invoke->GetLocations(), /*is_long=*/ true, GetAssembler());
+}
+
+// The base ISA has no instructions for counting leading or trailing zeros, so unless the
+// "Zbb" or "XTheadBb" extension is available, we
+// convert the unsigned value to `double` and extract the biased exponent which is the
+// index of the highest set bit plus `kDoubleExponentBias`. For `long`, the conversion
+// rounds towards zero so that it cannot carry into the exponent; for `int`, it is exact.
+// The input must not be zero.
+static void GenHighestSetBitExponent(Riscv64Assembler* assembler,
+                                     XRegister out,
+                                     XRegister in,
+                                     bool is_long) {
+  ScratchRegisterScope srs(assembler);
+  FRegister ftmp = srs.AllocateFRegister();
+  if (is_long) {
+    __ FCvtDLu(ftmp, in, FPRoundingMode::kRTZ);
+  } else {
+    __ FCvtDWu(ftmp, in);
+  }
+  __ FMvXD(out, ftmp);
+  __ Srli(out, out, kDoubleMantissaBits);  // The sign bit is zero.
+}
+
+static void GenNumberOfLeadingZeros(LocationSummary* locations,
+                                    bool is_long,
+                                    Riscv64Assembler* assembler) {
+  XRegister in = locations->InAt(0).AsRegister<XRegister>();
+  XRegister out = locations->Out().AsRegister<XRegister>();
+  int32_t bits = is_long ? 64 : 32;
+  DCHECK_NE(in, out);
+
+  if (assembler->HasZbb()) {
+    if (is_long) {
+      __ Clz(out, in);
+    } else {
+      __ Clzw(out, in);
+    }
+    return;
+  }
+  if (assembler->HasXTheadBb()) {
+    // `th.ff1` counts the leading zeros of the full 64-bit register, so for `int`,
+    // zero-extend the input and subtract the 32 extra leading zeros.
+    if (is_long) {
+      __ ThFf1(out, in);
+    } else {
+      __ ThExtu(out, in, 31, 0);
+      __ ThFf1(out, out);
+      __ Addi(out, out, -32);
+    }
+    return;
+  }
+
+  Riscv64Label done;
+  __ Li(out, bits);
+  __ Beqz(in, &done);
+  GenHighestSetBitExponent(assembler, out, in, is_long);
+  // out = (bits - 1) - (exponent - bias)
+  __ Addi(out, out, -(kDoubleExponentBias + bits - 1));
+  __ Neg(out, out);
+  __ Bind(&done);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitIntegerNumberOfLeadingZeros(HInvoke* invoke) {
+  CreateIntToIntLocations(allocator_, invoke, Location::kOutputOverlap);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitIntegerNumberOfLeadingZeros(HInvoke* invoke) {
+  GenNumberOfLeadingZeros(invoke->GetLocations(), /*is_long=*/ false, GetAssembler());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitLongNumberOfLeadingZeros(HInvoke* invoke) {
+  CreateIntToIntLocations(allocator_, invoke, Location::kOutputOverlap);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitLongNumberOfLeadingZeros(HInvoke* invoke) {
+  GenNumberOfLeadingZeros(invoke->GetLocations(), /*is_long=*/ true, GetAssembler());
+}
+
+static void GenNumberOfTrailingZeros(LocationSummary* locations,
+                                     bool is_long,
+                                     Riscv64Assembler* assembler) {
+  XRegister in = locations->InAt(0).AsRegister<XRegister>();
+  XRegister out = locations->Out().AsRegister<XRegister>();
+  DCHECK_NE(in, out);
+
+  if (assembler->HasZbb()) {
+    if (is_long) {
+      __ Ctz(out, in);
+    } else {
+      __ Ctzw(out, in);
+    }
+    return;
+  }
+
+  Riscv64Label done;
+  __ Li(out, is_long ? 64 : 32);
+  __ Beqz(in, &done);
+  {
+    ScratchRegisterScope srs(assembler);
+    XRegister tmp = srs.AllocateXRegister();
+    // Isolate the lowest set bit. Its conversion to `double` is exact. For `int`, only
+    // the low 32 bits are converted, so the 64-bit negation is fine.
+    __ Neg(tmp, in);
+    __ And(tmp, tmp, in);
+    GenHighestSetBitExponent(assembler, out, tmp, is_long);
+  }
+  __ Addi(out, out, -kDoubleExponentBias);
+  __ Bind(&done);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitIntegerNumberOfTrailingZeros(HInvoke* invoke) {
+  CreateIntToIntLocations(allocator_, invoke, Location::kOutputOverlap);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitIntegerNumberOfTrailingZeros(HInvoke* invoke) {
+  GenNumberOfTrailingZeros(invoke->GetLocations(), /*is_long=*/ false, GetAssembler());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitLongNumberOfTrailingZeros(HInvoke* invoke) {
+  CreateIntToIntLocations(allocator_, invoke, Location::kOutputOverlap);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitLongNumberOfTrailingZeros(HInvoke* invoke) {
+  GenNumberOfTrailingZeros(invoke->GetLocations(), /*is_long=*/ true, GetAssembler());
+}
+
+// Byte reversal needs REV8 from the "Zbb" extension or TH.REV/TH.REVW from "XTheadBb".
+// Without these, leave the call to the Java implementation.
+static bool CanReverseBytes(CodeGeneratorRISCV64* codegen) {
+  const Riscv64InstructionSetFeatures& features = codegen->GetInstructionSetFeatures();
+  return features.HasZbb() || features.HasXTheadBb();
+}
+
+static void GenReverseBytes(LocationSummary* locations,
+                            DataType::Type type,
+                            Riscv64Assembler* assembler) {
+  XRegister in = locations->InAt(0).AsRegister<XRegister>();
+  XRegister out = locations->Out().AsRegister<XRegister>();
+  DCHECK(assembler->HasZbb() || assembler->HasXTheadBb());
+  if (type == DataType::Type::kInt32 && !assembler->HasZbb()) {
+    // TH.REVW sign-extends the reversed low 32 bits.
+    __ ThRevw(out, in);
+    return;
+  }
+  if (assembler->HasZbb()) {
+    __ Rev8(out, in);
+  } else {
+    __ ThRev(out, in);
+  }
+  // Move the reversed bytes of `int` or `short` down, keeping the result sign-extended.
+  if (type == DataType::Type::kInt32) {
+    __ Srai(out, out, 32);
+  } else if (type == DataType::Type::kInt16) {
+    __ Srai(out, out, 48);
+  } else {
+    DCHECK_EQ(type, DataType::Type::kInt64);
+  }
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitIntegerReverseBytes(HInvoke* invoke) {
+  if (CanReverseBytes(codegen_)) {
+    CreateIntToIntLocations(allocator_, invoke);
+  }
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitIntegerReverseBytes(HInvoke* invoke) {
+  GenReverseBytes(invoke->GetLocations(), DataType::Type::kInt32, GetAssembler());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitLongReverseBytes(HInvoke* invoke) {
+  if (CanReverseBytes(codegen_)) {
+    CreateIntToIntLocations(allocator_, invoke);
+  }
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitLongReverseBytes(HInvoke* invoke) {
+  GenReverseBytes(invoke->GetLocations(), DataType::Type::kInt64, GetAssembler());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitShortReverseBytes(HInvoke* invoke) {
+  if (CanReverseBytes(codegen_)) {
+    CreateIntToIntLocations(allocator_, invoke);
+  }
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitShortReverseBytes(HInvoke* invoke) {
+  GenReverseBytes(invoke->GetLocations(), DataType::Type::kInt16, GetAssembler());
+}
+
+static void GenHighestOneBit(LocationSummary* locations,
+                             bool is_long,
+                             Riscv64Assembler* assembler) {
+  XRegister in = locations->InAt(0).AsRegister<XRegister>();
+  XRegister out = locations->Out().AsRegister<XRegister>();
+  ScratchRegisterScope srs(assembler);
+  FRegister ftmp = srs.AllocateFRegister();
+
+  // Convert to `double` rounding towards zero, clear the mantissa and convert back.
+  // This yields the highest set bit, or zero if the input is zero.
+  if (is_long) {
+    __ FCvtDLu(ftmp, in, FPRoundingMode::kRTZ);
+  } else {
+    __ FCvtDWu(ftmp, in);
+  }
+  __ FMvXD(out, ftmp);
+  __ Srli(out, out, kDoubleMantissaBits);
+  __ Slli(out, out, kDoubleMantissaBits);
+  __ FMvDX(ftmp, out);
+  if (is_long) {
+    __ FCvtLuD(out, ftmp, FPRoundingMode::kRTZ);
+  } else {
+    // The result for a negative `int` is 2^31 which needs to be sign-extended.
+    __ FCvtLD(out, ftmp, FPRoundingMode::kRTZ);
+    __ SextW(out, out);
+  }
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitIntegerHighestOneBit(HInvoke* invoke) {
+  CreateIntToIntLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitIntegerHighestOneBit(HInvoke* invoke) {
+  GenHighestOneBit(invoke->GetLocations(), /*is_long=*/ false, GetAssembler());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitLongHighestOneBit(HInvoke* invoke) {
+  CreateIntToIntLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitLongHighestOneBit(HInvoke* invoke) {
+  GenHighestOneBit(invoke->GetLocations(), /*is_long=*/ true, GetAssembler());
+}
+
+static void GenLowestOneBit(LocationSummary* locations,
+                            bool is_long,
+                            Riscv64Assembler* assembler) {
+  XRegister in = locations->InAt(0).AsRegister<XRegister>();
+  XRegister out = locations->Out().AsRegister<XRegister>();
+  ScratchRegisterScope srs(assembler);
+  XRegister tmp = srs.AllocateXRegister();
+  if (is_long) {
+    __ Neg(tmp, in);
+  } else {
+    __ NegW(tmp, in);  // Keep the result sign-extended for `Integer.MIN_VALUE`.
+  }
+  __ And(out, in, tmp);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitIntegerLowestOneBit(HInvoke* invoke) {
+  CreateIntToIntLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitIntegerLowestOneBit(HInvoke* invoke) {
+  GenLowestOneBit(invoke->GetLocations(), /*is_long=*/ false, GetAssembler());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitLongLowestOneBit(HInvoke* invoke) {
+  CreateIntToIntLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitLongLowestOneBit(HInvoke* invoke) {
+  GenLowestOneBit(invoke->GetLocations(), /*is_long=*/ true, GetAssembler());
+}
+
+static void GenerateDivideUnsigned(HInvoke* invoke, CodeGeneratorRISCV64* codegen) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+  DataType::Type type = invoke->GetType();
+  DCHECK(type == DataType::Type::kInt32 || type == DataType::Type::kInt64);
+
+  XRegister dividend = locations->InAt(0).AsRegister<XRegister>();
+  XRegister divisor = locations->InAt(1).AsRegister<XRegister>();
+  XRegister out = locations->Out().AsRegister<XRegister>();
+
+  // Check if divisor is zero, bail to managed implementation to handle.
+  SlowPathCodeRISCV64* slow_path =
+      new (codegen->GetScopedAllocator()) IntrinsicSlowPathRISCV64(invoke);
+  codegen->AddSlowPath(slow_path);
+  __ Beqz(divisor, slow_path->GetEntryLabel());
+
+  if (type == DataType::Type::kInt32) {
+    __ Divuw(out, dividend, divisor);
+  } else {
+    __ Divu(out, dividend, divisor);
+  }
+
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitIntegerDivideUnsigned(HInvoke* invoke) {
+  CreateIntIntToIntSlowPathCallLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitIntegerDivideUnsigned(HInvoke* invoke) {
+  GenerateDivideUnsigned(invoke, codegen_);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitLongDivideUnsigned(HInvoke* invoke) {
+  CreateIntIntToIntSlowPathCallLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitLongDivideUnsigned(HInvoke* invoke) {
+  GenerateDivideUnsigned(invoke, codegen_);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitMathMultiplyHigh(HInvoke* invoke) {
+  CreateIntIntToIntLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitMathMultiplyHigh(HInvoke* invoke) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = GetAssembler();
+  __ Mulh(locations->Out().AsRegister<XRegister>(),
+          locations->InAt(0).AsRegister<XRegister>(),
+          locations->InAt(1).AsRegister<XRegister>());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitMathSqrt(HInvoke* invoke) {
+  CreateFPToFPLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitMathSqrt(HInvoke* invoke) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = GetAssembler();
+  __ FSqrtD(locations->Out().AsFpuRegister<FRegister>(),
+            locations->InAt(0).AsFpuRegister<FRegister>());
+}
+
+// Round a `double` to an integral `double` with the given rounding mode. Values with
+// magnitude of at least 2^52 (as well as infinities and NaNs) are already integral and
+// are returned unchanged; other values are rounded by a conversion to `long` and back.
+static void GenDoubleRound(LocationSummary* locations,
+                           FPRoundingMode mode,
+                           Riscv64Assembler* assembler) {
+  FRegister in = locations->InAt(0).AsFpuRegister<FRegister>();
+  FRegister out = locations->Out().AsFpuRegister<FRegister>();
+  DCHECK_NE(in, out);
+  ScratchRegisterScope srs(assembler);
+  XRegister tmp = srs.AllocateXRegister();
+  FRegister ftmp = srs.AllocateFRegister();
+
+  Riscv64Label done;
+  __ Li(tmp, kDoubleTwoPow52);
+  __ FMvDX(ftmp, tmp);
+  __ FAbsD(out, in);
+  __ FLtD(tmp, out, ftmp);  // False for NaN.
+  __ FMvD(out, in);
+  __ Beqz(tmp, &done);
+  __ FCvtLD(tmp, in, mode);
+  __ FCvtDL(out, tmp, mode);  // Exact.
+  // Restore the sign for results that are zero, for example `Math.ceil(-0.5) == -0.0`.
+  __ FSgnjD(out, out, in);
+  __ Bind(&done);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitMathCeil(HInvoke* invoke) {
+  CreateFPToFPLocations(allocator_, invoke, Location::kOutputOverlap);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitMathCeil(HInvoke* invoke) {
+  GenDoubleRound(invoke->GetLocations(), FPRoundingMode::kRUP, GetAssembler());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitMathFloor(HInvoke* invoke) {
+  CreateFPToFPLocations(allocator_, invoke, Location::kOutputOverlap);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitMathFloor(HInvoke* invoke) {
+  GenDoubleRound(invoke->GetLocations(), FPRoundingMode::kRDN, GetAssembler());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitMathRint(HInvoke* invoke) {
+  CreateFPToFPLocations(allocator_, invoke, Location::kOutputOverlap);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitMathRint(HInvoke* invoke) {
+  GenDoubleRound(invoke->GetLocations(), FPRoundingMode::kRNE, GetAssembler());
+}
+
+static void CreateFPToIntPlusFPTempLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresFpuRegister());
+  locations->SetOut(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+}
+
+// `Math.round()` rounds ties towards positive infinity. Convert with rounding to nearest,
+// ties away from zero, and add one if the input was a negative tie.
+static void GenMathRound(LocationSummary* locations,
+                         DataType::Type type,
+                         Riscv64Assembler* assembler) {
+  FRegister in = locations->InAt(0).AsFpuRegister<FRegister>();
+  XRegister out = locations->Out().AsRegister<XRegister>();
+  FRegister diff = locations->GetTemp(0).AsFpuRegister<FRegister>();
+  ScratchRegisterScope srs(assembler);
+  XRegister tmp = srs.AllocateXRegister();
+  FRegister half = srs.AllocateFRegister();
+
+  if (type == DataType::Type::kFloat64) {
+    __ FCvtLD(out, in, FPRoundingMode::kRMM);
+    __ FCvtDL(diff, out, FPRoundingMode::kRTZ);
+    __ FSubD(diff, in, diff);
+    __ Li(tmp, kDoubleOneHalf);
+    __ FMvDX(half, tmp);
+    __ FEqD(tmp, diff, half);
+    __ Add(out, out, tmp);
+    __ FEqD(tmp, in, in);  // False for NaN.
+  } else {
+    DCHECK_EQ(type, DataType::Type::kFloat32);
+    __ FCvtWS(out, in, FPRoundingMode::kRMM);
+    __ FCvtSW(diff, out, FPRoundingMode::kRTZ);
+    __ FSubS(diff, in, diff);
+    __ Li(tmp, kFloatOneHalf);
+    __ FMvWX(half, tmp);
+    __ FEqS(tmp, diff, half);
+    __ Addw(out, out, tmp);
+    __ FEqS(tmp, in, in);  // False for NaN.
+  }
+  // The conversion yields the maximum value for NaN but `Math.round(NaN)` is 0.
+  __ Neg(tmp, tmp);
+  __ And(out, out, tmp);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitMathRoundDouble(HInvoke* invoke) {
+  CreateFPToIntPlusFPTempLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitMathRoundDouble(HInvoke* invoke) {
+  GenMathRound(invoke->GetLocations(), DataType::Type::kFloat64, GetAssembler());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitMathRoundFloat(HInvoke* invoke) {
+  CreateFPToIntPlusFPTempLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitMathRoundFloat(HInvoke* invoke) {
+  GenMathRound(invoke->GetLocations(), DataType::Type::kFloat32, GetAssembler());
+}
+
+static void CreateFPFPFPToFPLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  DCHECK_EQ(invoke->GetNumberOfArguments(), 3U);
+  LocationSummary* const locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresFpuRegister());
+  locations->SetInAt(1, Location::RequiresFpuRegister());
+  locations->SetInAt(2, Location::RequiresFpuRegister());
+  locations->SetOut(Location::RequiresFpuRegister(), Location::kNoOutputOverlap);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitMathFmaDouble(HInvoke* invoke) {
+  CreateFPFPFPToFPLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitMathFmaDouble(HInvoke* invoke) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = GetAssembler();
+  __ FMAddD(locations->Out().AsFpuRegister<FRegister>(),
+            locations->InAt(0).AsFpuRegister<FRegister>(),
+            locations->InAt(1).AsFpuRegister<FRegister>(),
+            locations->InAt(2).AsFpuRegister<FRegister>());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitMathFmaFloat(HInvoke* invoke) {
+  CreateFPFPFPToFPLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitMathFmaFloat(HInvoke* invoke) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = GetAssembler();
+  __ FMAddS(locations->Out().AsFpuRegister<FRegister>(),
+            locations->InAt(0).AsFpuRegister<FRegister>(),
+            locations->InAt(1).AsFpuRegister<FRegister>(),
+            locations->InAt(2).AsFpuRegister<FRegister>());
+}
+
+static void CreateFPToFPCallLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  DCHECK_EQ(invoke->GetNumberOfArguments(), 1U);
+  DCHECK(DataType::IsFloatingPointType(invoke->InputAt(0)->GetType()));
+  DCHECK(DataType::IsFloatingPointType(invoke->GetType()));
+
+  LocationSummary* const locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kCallOnMainOnly, kIntrinsified);
+  InvokeRuntimeCallingConvention calling_convention;
+
+  locations->SetInAt(0, Location::FpuRegisterLocation(calling_convention.GetFpuRegisterAt(0)));
+  locations->SetOut(calling_convention.GetReturnLocation(invoke->GetType()));
+}
+
+static void CreateFPFPToFPCallLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  DCHECK_EQ(invoke->GetNumberOfArguments(), 2U);
+  DCHECK(DataType::IsFloatingPointType(invoke->InputAt(0)->GetType()));
+  DCHECK(DataType::IsFloatingPointType(invoke->InputAt(1)->GetType()));
+  DCHECK(DataType::IsFloatingPointType(invoke->GetType()));
+
+  LocationSummary* const locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kCallOnMainOnly, kIntrinsified);
+  InvokeRuntimeCallingConvention calling_convention;
+
+  locations->SetInAt(0, Location::FpuRegisterLocation(calling_convention.GetFpuRegisterAt(0)));
+  locations->SetInAt(1, Location::FpuRegisterLocation(calling_convention.GetFpuRegisterAt(1)));
+  locations->SetOut(calling_convention.GetReturnLocation(invoke->GetType()));
+}
+
+static void GenFPToFPCall(HInvoke* invoke,
+                          CodeGeneratorRISCV64* codegen,
+                          QuickEntrypointEnum entry) {
+  codegen->InvokeRuntime(entry, invoke, invoke->GetDexPc());
+}
+
+#define MATH_CALL_INTRINSIC(Name, EntrypointName, Arity)                       \
+  void IntrinsicLocationsBuilderRISCV64::VisitMath##Name(HInvoke* invoke) {    \
+    Create##Arity##ToFPCallLocations(allocator_, invoke);                      \
+  }                                                                            \
+  void IntrinsicCodeGeneratorRISCV64::VisitMath##Name(HInvoke* invoke) {       \
+    GenFPToFPCall(invoke, codegen_, kQuick##EntrypointName);                   \
+  }
+
+MATH_CALL_INTRINSIC(Cos, Cos, FP)
+MATH_CALL_INTRINSIC(Sin, Sin, FP)
+MATH_CALL_INTRINSIC(Acos, Acos, FP)
+MATH_CALL_INTRINSIC(Asin, Asin, FP)
+MATH_CALL_INTRINSIC(Atan, Atan, FP)
+MATH_CALL_INTRINSIC(Cbrt, Cbrt, FP)
+MATH_CALL_INTRINSIC(Cosh, Cosh, FP)
+MATH_CALL_INTRINSIC(Exp, Exp, FP)
+MATH_CALL_INTRINSIC(Expm1, Expm1, FP)
+MATH_CALL_INTRINSIC(Log, Log, FP)
+MATH_CALL_INTRINSIC(Log10, Log10, FP)
+MATH_CALL_INTRINSIC(Sinh, Sinh, FP)
+MATH_CALL_INTRINSIC(Tan, Tan, FP)
+MATH_CALL_INTRINSIC(Tanh, Tanh, FP)
+MATH_CALL_INTRINSIC(Atan2, Atan2, FPFP)
+MATH_CALL_INTRINSIC(Pow, Pow, FPFP)
+MATH_CALL_INTRINSIC(Hypot, Hypot, FPFP)
+MATH_CALL_INTRINSIC(NextAfter, NextAfter, FPFP)
+
+#undef MATH_CALL_INTRINSIC
+
+static void GenMemoryPeek(LocationSummary* locations,
+                          DataType::Type type,
+                          Riscv64Assembler* assembler) {
+  XRegister address = locations->InAt(0).AsRegister<XRegister>();
+  XRegister out = locations->Out().AsRegister<XRegister>();
+  // The address may be unaligned for the multi-byte accesses.
+  switch (type) {
+    case DataType::Type::kInt8:
+      __ Lb(out, address, 0);
+      break;
+    case DataType::Type::kInt16:
+      __ Lh(out, address, 0);
+      break;
+    case DataType::Type::kInt32:
+      __ Lw(out, address, 0);
+      break;
+    case DataType::Type::kInt64:
+      __ Ld(out, address, 0);
+      break;
+    default:
+      LOG(FATAL) << "Unexpected type " << type;
+      UNREACHABLE();
+  }
+}
+
+static void GenMemoryPoke(LocationSummary* locations,
+                          DataType::Type type,
+                          Riscv64Assembler* assembler) {
+  XRegister address = locations->InAt(0).AsRegister<XRegister>();
+  XRegister value = locations->InAt(1).AsRegister<XRegister>();
+  switch (type) {
+    case DataType::Type::kInt8:
+      __ Sb(value, address, 0);
+      break;
+    case DataType::Type::kInt16:
+      __ Sh(value, address, 0);
+      break;
+    case DataType::Type::kInt32:
+      __ Sw(value, address, 0);
+      break;
+    case DataType::Type::kInt64:
+      __ Sd(value, address, 0);
+      break;
+    default:
+      LOG(FATAL) << "Unexpected type " << type;
+      UNREACHABLE();
+  }
+}
+
+static void CreateIntIntToVoidLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+}
+
+#define MEMORY_PEEK_POKE_INTRINSICS(Suffix, TypeKind)                                \
+  void IntrinsicLocationsBuilderRISCV64::VisitMemoryPeek##Suffix(HInvoke* invoke) {  \
+    CreateIntToIntLocations(allocator_, invoke);                                     \
+  }                                                                                  \
+  void IntrinsicCodeGeneratorRISCV64::VisitMemoryPeek##Suffix(HInvoke* invoke) {     \
+    GenMemoryPeek(invoke->GetLocations(), DataType::Type::TypeKind, GetAssembler()); \
+  }                                                                                  \
+  void IntrinsicLocationsBuilderRISCV64::VisitMemoryPoke##Suffix(HInvoke* invoke) {  \
+    CreateIntIntToVoidLocations(allocator_, invoke);                                 \
+  }                                                                                  \
+  void IntrinsicCodeGeneratorRISCV64::VisitMemoryPoke##Suffix(HInvoke* invoke) {     \
+    GenMemoryPoke(invoke->GetLocations(), DataType::Type::TypeKind, GetAssembler()); \
+  }
+
+MEMORY_PEEK_POKE_INTRINSICS(Byte, kInt8)
+MEMORY_PEEK_POKE_INTRINSICS(ShortNative, kInt16)
+MEMORY_PEEK_POKE_INTRINSICS(IntNative, kInt32)
+MEMORY_PEEK_POKE_INTRINSICS(LongNative, kInt64)
+
+#undef MEMORY_PEEK_POKE_INTRINSICS
+
+void IntrinsicLocationsBuilderRISCV64::VisitThreadCurrentThread(HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator_) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetOut(Location::RequiresRegister());
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitThreadCurrentThread(HInvoke* invoke) {
+  Riscv64Assembler* assembler = GetAssembler();
+  XRegister out = invoke->GetLocations()->Out().AsRegister<XRegister>();
+  __ Loadwu(out, TR, Thread::PeerOffset<kRiscv64PointerSize>().Int32Value());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitThreadInterrupted(HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator_) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetOut(Location::RequiresRegister());
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitThreadInterrupted(HInvoke* invoke) {
+  Riscv64Assembler* assembler = GetAssembler();
+  XRegister out = invoke->GetLocations()->Out().AsRegister<XRegister>();
+  int32_t offset = Thread::InterruptedOffset<kRiscv64PointerSize>().Int32Value();
+  Riscv64Label done;
+  // Load-acquire the flag and, if it is set, clear it with a store-release.
+  __ Loadw(out, TR, offset);
+  __ Fence(/*pred=*/ kFenceRead, /*succ=*/ kFenceRead | kFenceWrite);
+  __ Beqz(out, &done);
+  __ Fence(/*pred=*/ kFenceRead | kFenceWrite, /*succ=*/ kFenceWrite);
+  __ Storew(Zero, TR, offset);
+  __ Bind(&done);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitReachabilityFence(HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator_) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::Any());
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitReachabilityFence([[maybe_unused]] HInvoke* invoke) {}
+
+// There are no CRC instructions in RV64GC and the carry-less multiply from "Zbc" is not
+// available on the cores we target, so the CRC32 intrinsics use a table of the CRC of each
+// nibble, embedded in the code as literals. This avoids the JNI transition to zlib which
+// dominates the cost of `CRC32.update()` and of short `CRC32.updateBytes()` calls.
+static constexpr uint32_t kCRC32Polynomial = 0xedb88320u;  // Reflected CRC-32 polynomial.
+static constexpr size_t kCRC32NibbleTableSize = 16u;
+
+static void LoadCRC32NibbleTable(Riscv64Assembler* assembler, XRegister table) {
+  // The literals are emitted in the order of creation, so the entries are contiguous.
+  Literal* first = nullptr;
+  for (uint32_t i = 0; i != kCRC32NibbleTableSize; ++i) {
+    uint32_t crc = i;
+    for (size_t bit = 0; bit != 4u; ++bit) {
+      crc = (crc >> 1) ^ ((crc & 1u) != 0u ? kCRC32Polynomial : 0u);
+    }
+    Literal* literal = __ NewLiteral<uint32_t>(crc);
+    if (first == nullptr) {
+      first = literal;
+    }
+  }
+  __ LoadLabelAddress(table, first->GetLabel());
+}
+
+// Update the inverted CRC in `crc` with the byte in the low 8 bits of `value` which
+// must be zero-extended. Clobbers `value`.
+static void GenerateCRC32UpdateByte(CodeGeneratorRISCV64* codegen,
+                                    XRegister crc,
+                                    XRegister value,
+                                    XRegister table) {
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+  bool has_indexed_load = codegen->GetInstructionSetFeatures().HasXTheadMemIdx();
+  __ Xor(crc, crc, value);
+  for (size_t nibble = 0; nibble != 2u; ++nibble) {
+    __ Andi(value, crc, kCRC32NibbleTableSize - 1u);
+    if (has_indexed_load) {
+      __ ThLrwu(value, table, value, /*imm2=*/ 2);
+    } else {
+      __ ShiftAndAdd(value, table, value, /*shift=*/ 2u);
+      __ Lwu(value, value, 0);
+    }
+    __ Srliw(crc, crc, 4);
+    __ Xor(crc, crc, value);
+  }
+}
+
+// Calculate the CRC32 of `length` bytes at `ptr`, starting with the CRC in `crc`, and put
+// the result in `out`. Clobbers `ptr` and `end`.
+static void GenerateCRC32UpdateBytes(CodeGeneratorRISCV64* codegen,
+                                     XRegister crc,
+                                     XRegister ptr,
+                                     XRegister length,
+                                     XRegister end,
+                                     XRegister table,
+                                     XRegister out) {
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+  ScratchRegisterScope srs(assembler);
+  XRegister value = srs.AllocateXRegister();
+  Riscv64Label loop, done;
+
+  __ Add(end, ptr, length);
+  LoadCRC32NibbleTable(assembler, table);
+  __ Not(out, crc);
+  __ Beq(ptr, end, &done);
+  __ Bind(&loop);
+  __ Lbu(value, ptr, 0);
+  __ Addi(ptr, ptr, 1);
+  GenerateCRC32UpdateByte(codegen, out, value, table);
+  __ Bne(ptr, end, &loop);
+  __ Bind(&done);
+  __ Not(out, out);
+  __ SextW(out, out);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitCRC32Update(HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator_) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kNoOutputOverlap);
+}
+
+// Lower the invoke of CRC32.update(int crc, int b).
+void IntrinsicCodeGeneratorRISCV64::VisitCRC32Update(HInvoke* invoke) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = GetAssembler();
+  XRegister crc = locations->InAt(0).AsRegister<XRegister>();
+  XRegister b = locations->InAt(1).AsRegister<XRegister>();
+  XRegister table = locations->GetTemp(0).AsRegister<XRegister>();
+  XRegister out = locations->Out().AsRegister<XRegister>();
+
+  ScratchRegisterScope srs(assembler);
+  XRegister value = srs.AllocateXRegister();
+  __ Andi(value, b, 0xff);  // Read `b` before writing `out`, they may be the same register.
+  LoadCRC32NibbleTable(assembler, table);
+  __ Not(out, crc);
+  GenerateCRC32UpdateByte(codegen_, out, value, table);
+  __ Not(out, out);
+  __ SextW(out, out);
+}
+
+// The threshold for sizes of arrays to use the library provided implementation
+// of CRC32.updateBytes instead of the intrinsic. The nibble table processes a byte
+// in about a dozen cycles, the table driven zlib code is faster for long inputs.
+static constexpr int32_t kCRC32UpdateBytesThreshold = 32;
+
+static void CreateCRC32UpdateBytesLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetInAt(2, Location::RegisterOrConstant(invoke->InputAt(2)));
+  locations->SetInAt(3, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  // Force kOutputOverlap; see comments in IntrinsicSlowPath::EmitNativeCode.
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+// Generate the code for `CRC32.updateBytes(int crc, byte[] b, int off, int len)` using the
+// array data offset `data_offset` or `CRC32.updateByteBuffer(int crc, long addr, int off,
+// int len)` with `data_offset` zero. Long inputs are left to the library implementation.
+static void GenerateCRC32UpdateBytesOrByteBuffer(HInvoke* invoke,
+                                                 CodeGeneratorRISCV64* codegen,
+                                                 uint32_t data_offset) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+  XRegister crc = locations->InAt(0).AsRegister<XRegister>();
+  XRegister base = locations->InAt(1).AsRegister<XRegister>();
+  Location offset = locations->InAt(2);
+  XRegister length = locations->InAt(3).AsRegister<XRegister>();
+  XRegister ptr = locations->GetTemp(0).AsRegister<XRegister>();
+  XRegister end = locations->GetTemp(1).AsRegister<XRegister>();
+  XRegister table = locations->GetTemp(2).AsRegister<XRegister>();
+  XRegister out = locations->Out().AsRegister<XRegister>();
+
+  SlowPathCodeRISCV64* slow_path =
+      new (codegen->GetScopedAllocator()) IntrinsicSlowPathRISCV64(invoke);
+  codegen->AddSlowPath(slow_path);
+
+  // The unsigned comparison also sends any negative length to the library implementation.
+  __ Li(ptr, kCRC32UpdateBytesThreshold);
+  __ Bgtu(length, ptr, slow_path->GetEntryLabel());
+
+  if (offset.IsConstant()) {
+    int32_t offset_value = offset.GetConstant()->AsIntConstant()->GetValue();
+    __ AddConst64(ptr, base, static_cast<int64_t>(data_offset) + offset_value);
+  } else {
+    __ Add(ptr, base, offset.AsRegister<XRegister>());
+    if (data_offset != 0u) {
+      __ Addi(ptr, ptr, data_offset);
+    }
+  }
+
+  GenerateCRC32UpdateBytes(codegen, crc, ptr, length, end, table, out);
+
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitCRC32UpdateBytes(HInvoke* invoke) {
+  CreateCRC32UpdateBytesLocations(allocator_, invoke);
+}
+
+// Lower the invoke of CRC32.updateBytes(int crc, byte[] b, int off, int len).
+void IntrinsicCodeGeneratorRISCV64::VisitCRC32UpdateBytes(HInvoke* invoke) {
+  GenerateCRC32UpdateBytesOrByteBuffer(
+      invoke, codegen_, mirror::Array::DataOffset(sizeof(int8_t)).Uint32Value());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitCRC32UpdateByteBuffer(HInvoke* invoke) {
+  CreateCRC32UpdateBytesLocations(allocator_, invoke);
+}
+
+// Lower the invoke of CRC32.updateByteBuffer(int crc, long addr, int off, int len).
+//
+// As on arm64, there is no need to check `addr` for 0; the method is private to
+// java.util.zip.CRC32 and an empty DirectBuffer with a zero address has zero length.
+void IntrinsicCodeGeneratorRISCV64::VisitCRC32UpdateByteBuffer(HInvoke* invoke) {
+  GenerateCRC32UpdateBytesOrByteBuffer(invoke, codegen_, /*data_offset=*/ 0u);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitStringEquals(HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator_) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  // TODO: If the String.equals() is used only for an immediately following HIf, we can
+  // mark it as emitted-at-use-site and emit branches directly to the appropriate blocks.
+  // Then we shall need an extra temporary register instead of the output register.
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitStringEquals(HInvoke* invoke) {
+  Riscv64Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  XRegister str = locations->InAt(0).AsRegister<XRegister>();
+  XRegister arg = locations->InAt(1).AsRegister<XRegister>();
+  XRegister out = locations->Out().AsRegister<XRegister>();
+  XRegister str_ptr = locations->GetTemp(0).AsRegister<XRegister>();
+  XRegister arg_ptr = locations->GetTemp(1).AsRegister<XRegister>();
+
+  ScratchRegisterScope srs(assembler);
+  XRegister temp = srs.AllocateXRegister();
+  XRegister temp1 = srs.AllocateXRegister();
+
+  Riscv64Label loop;
+  Riscv64Label end;
+  Riscv64Label return_true;
+  Riscv64Label return_false;
+
+  // Get offsets of count, value, and class fields within a string object.
+  const int32_t count_offset = mirror::String::CountOffset().Int32Value();
+  const int32_t value_offset = mirror::String::ValueOffset().Int32Value();
+  const int32_t class_offset = mirror::Object::ClassOffset().Int32Value();
+
+  // Note that the null check must have been done earlier.
+  DCHECK(!invoke->CanDoImplicitNullCheckOn(invoke->InputAt(0)));
+
+  StringEqualsOptimizations optimizations(invoke);
+  if (!optimizations.GetArgumentNotNull()) {
+    // Check if input is null, return false if it is.
+    __ Beqz(arg, &return_false);
+  }
+
+  // Reference equality check, return true if same reference.
+  __ Beq(str, arg, &return_true);
+
+  if (!optimizations.GetArgumentIsString()) {
+    // Instanceof check for the argument by comparing class fields.
+    // All string objects must have the same type since String cannot be subclassed.
+    // Receiver must be a string object, so its class field is equal to all strings' class fields.
+    // If the argument is a string object, its class field must be equal to receiver's class field.
+    //
+    // As the String class is expected to be non-movable, we can read the class
+    // field from String.equals' arguments without read barriers.
+    AssertNonMovableStringClass();
+    // /* HeapReference<Class> */ temp = str->klass_
+    __ Loadwu(temp, str, class_offset);
+    // /* HeapReference<Class> */ temp1 = arg->klass_
+    __ Loadwu(temp1, arg, class_offset);
+    // Also, because we use the previously loaded class references only in the
+    // following comparison, we don't need to unpoison them.
+    __ Bne(temp, temp1, &return_false);
+  }
+
+  // Load `count` fields of this and argument strings.
+  __ Loadwu(temp, str, count_offset);
+  __ Loadwu(temp1, arg, count_offset);
+  // Check if `count` fields are equal, return false if they're not.
+  // Also compares the compression style, if differs return false.
+  __ Bne(temp, temp1, &return_false);
+
+  // Return true if both strings are empty. Even with string compression `count == 0` means empty.
+  static_assert(static_cast<uint32_t>(mirror::StringCompressionFlag::kCompressed) == 0u,
+                "Expecting 0=compressed, 1=uncompressed");
+  __ Beqz(temp, &return_true);
+
+  // Calculate the number of bytes to compare.
+  if (mirror::kUseStringCompression) {
+    __ Andi(temp1, temp, 1);  // Extract compression flag.
+    __ Srli(temp, temp, 1u);  // Extract length.
+    __ Sll(temp, temp, temp1);
+  } else {
+    __ Slli(temp, temp, 1u);
+  }
+
+  // Assertions that must hold in order to compare strings 8 bytes at a time.
+  // Ok to do this because strings are zero-padded to kObjectAlignment.
+  DCHECK_ALIGNED(value_offset, 8);
+  static_assert(IsAligned<8>(kObjectAlignment), "String of odd length is not zero padded");
+
+  // Loop to compare strings 8 bytes at a time starting at the front of the string.
+  __ Addi(str_ptr, str, value_offset);
+  __ Addi(arg_ptr, arg, value_offset);
+  __ Bind(&loop);
+  __ Ld(out, str_ptr, 0);
+  __ Ld(temp1, arg_ptr, 0);
+  __ Addi(str_ptr, str_ptr, sizeof(uint64_t));
+  __ Addi(arg_ptr, arg_ptr, sizeof(uint64_t));
+  __ Bne(out, temp1, &return_false);
+  __ Addi(temp, temp, -static_cast<int32_t>(sizeof(uint64_t)));
+  __ Bgtz(temp, &loop);
+
+  // Return true and exit the function.
+  // If loop does not result in returning false, we return true.
+  __ Bind(&return_true);
+  __ Li(out, 1);
+  __ J(&end);
+
+  // Return false and exit the function.
+  __ Bind(&return_false);
+  __ Li(out, 0);
+  __ Bind(&end);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitStringNewStringFromBytes(HInvoke* invoke) {
+  LocationSummary* locations = new (allocator_) LocationSummary(
+      invoke, LocationSummary::kCallOnMainAndSlowPath, kIntrinsified);
+  InvokeRuntimeCallingConvention calling_convention;
+  locations->SetInAt(0, Location::RegisterLocation(calling_convention.GetRegisterAt(0)));
+  locations->SetInAt(1, Location::RegisterLocation(calling_convention.GetRegisterAt(1)));
+  locations->SetInAt(2, Location::RegisterLocation(calling_convention.GetRegisterAt(2)));
+  locations->SetInAt(3, Location::RegisterLocation(calling_convention.GetRegisterAt(3)));
+  locations->SetOut(calling_convention.GetReturnLocation(DataType::Type::kReference));
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitStringNewStringFromBytes(HInvoke* invoke) {
+  Riscv64Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  XRegister byte_array = locations->InAt(0).AsRegister<XRegister>();
+  SlowPathCodeRISCV64* slow_path =
+      new (codegen_->GetScopedAllocator()) IntrinsicSlowPathRISCV64(invoke);
+  codegen_->AddSlowPath(slow_path);
+  __ Beqz(byte_array, slow_path->GetEntryLabel());
+
+  codegen_->InvokeRuntime(kQuickAllocStringFromBytes, invoke, invoke->GetDexPc(), slow_path);
+  CheckEntrypointTypes<kQuickAllocStringFromBytes, void*, void*, int32_t, int32_t, int32_t>();
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitStringNewStringFromChars(HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator_) LocationSummary(invoke, LocationSummary::kCallOnMainOnly, kIntrinsified);
+  InvokeRuntimeCallingConvention calling_convention;
+  locations->SetInAt(0, Location::RegisterLocation(calling_convention.GetRegisterAt(0)));
+  locations->SetInAt(1, Location::RegisterLocation(calling_convention.GetRegisterAt(1)));
+  locations->SetInAt(2, Location::RegisterLocation(calling_convention.GetRegisterAt(2)));
+  locations->SetOut(calling_convention.GetReturnLocation(DataType::Type::kReference));
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitStringNewStringFromChars(HInvoke* invoke) {
+  // No need to emit code checking whether `locations->InAt(2)` is a null
+  // pointer, as callers of the native method
+  //
+  //   java.lang.StringFactory.newStringFromChars(int offset, int charCount, char[] data)
+  //
+  // all include a null check on `data` before calling that method.
+  codegen_->InvokeRuntime(kQuickAllocStringFromChars, invoke, invoke->GetDexPc());
+  CheckEntrypointTypes<kQuickAllocStringFromChars, void*, int32_t, int32_t, void*>();
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitStringNewStringFromString(HInvoke* invoke) {
+  LocationSummary* locations = new (allocator_) LocationSummary(
+      invoke, LocationSummary::kCallOnMainAndSlowPath, kIntrinsified);
+  InvokeRuntimeCallingConvention calling_convention;
+  locations->SetInAt(0, Location::RegisterLocation(calling_convention.GetRegisterAt(0)));
+  locations->SetOut(calling_convention.GetReturnLocation(DataType::Type::kReference));
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitStringNewStringFromString(HInvoke* invoke) {
+  Riscv64Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  XRegister string_to_copy = locations->InAt(0).AsRegister<XRegister>();
+  SlowPathCodeRISCV64* slow_path =
+      new (codegen_->GetScopedAllocator()) IntrinsicSlowPathRISCV64(invoke);
+  codegen_->AddSlowPath(slow_path);
+  __ Beqz(string_to_copy, slow_path->GetEntryLabel());
+
+  codegen_->InvokeRuntime(kQuickAllocStringFromString, invoke, invoke->GetDexPc(), slow_path);
+  CheckEntrypointTypes<kQuickAllocStringFromString, void*, void*>();
+  __ Bind(slow_path->GetExitLabel());
+}
+
+// This value is greater than ARRAYCOPY_SHORT_CHAR_ARRAY_THRESHOLD in libcore,
+// so if we choose to jump to the slow path we will end up in the native implementation.
+static constexpr int32_t kSystemArrayCopyCharThreshold = 192;
+
+void IntrinsicLocationsBuilderRISCV64::VisitSystemArrayCopyChar(HInvoke* invoke) {
+  // Check to see if we have known failures that will cause us to have to bail out
+  // to the runtime, and just generate the runtime call directly.
+  HIntConstant* src_pos = invoke->InputAt(1)->AsIntConstantOrNull();
+  HIntConstant* dst_pos = invoke->InputAt(3)->AsIntConstantOrNull();
+
+  // The positions must be non-negative.
+  if ((src_pos != nullptr && src_pos->GetValue() < 0) ||
+      (dst_pos != nullptr && dst_pos->GetValue() < 0)) {
+    // We will have to fail anyways.
+    return;
+  }
+
+  // The length must be >= 0 and not so long that we would (currently) prefer libcore's
+  // native implementation.
+  HIntConstant* length = invoke->InputAt(4)->AsIntConstantOrNull();
+  if (length != nullptr) {
+    int32_t len = length->GetValue();
+    if (len < 0 || len > kSystemArrayCopyCharThreshold) {
+      // Just call as normal.
+      return;
+    }
+  }
+
+  LocationSummary* locations =
+      new (allocator_) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+  // arraycopy(char[] src, int src_pos, char[] dst, int dst_pos, int length).
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetInAt(2, Location::RequiresRegister());
+  locations->SetInAt(3, Location::RequiresRegister());
+  locations->SetInAt(4, Location::RequiresRegister());
+
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+}
+
+// Check that `pos >= 0` and `length(input) - pos >= length`, otherwise go to the slow path.
+static void CheckSystemArrayCopyPosition(Riscv64Assembler* assembler,
+                                         XRegister pos,
+                                         XRegister input,
+                                         XRegister length,
+                                         SlowPathCodeRISCV64* slow_path,
+                                         XRegister temp) {
+  const int32_t length_offset = mirror::Array::LengthOffset().Int32Value();
+  __ Bltz(pos, slow_path->GetEntryLabel());
+  __ Loadw(temp, input, length_offset);
+  __ Sub(temp, temp, pos);
+  __ Blt(temp, length, slow_path->GetEntryLabel());
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitSystemArrayCopyChar(HInvoke* invoke) {
+  Riscv64Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  XRegister src = locations->InAt(0).AsRegister<XRegister>();
+  XRegister src_pos = locations->InAt(1).AsRegister<XRegister>();
+  XRegister dst = locations->InAt(2).AsRegister<XRegister>();
+  XRegister dst_pos = locations->InAt(3).AsRegister<XRegister>();
+  XRegister length = locations->InAt(4).AsRegister<XRegister>();
+  XRegister src_curr_addr = locations->GetTemp(0).AsRegister<XRegister>();
+  XRegister dst_curr_addr = locations->GetTemp(1).AsRegister<XRegister>();
+  XRegister src_stop_addr = locations->GetTemp(2).AsRegister<XRegister>();
+
+  SlowPathCodeRISCV64* slow_path =
+      new (codegen_->GetScopedAllocator()) IntrinsicSlowPathRISCV64(invoke);
+  codegen_->AddSlowPath(slow_path);
+
+  // If source and destination are the same, take the slow path. Overlapping copy regions must be
+  // copied in reverse and we can't know in all cases if it's needed.
+  __ Beq(src, dst, slow_path->GetEntryLabel());
+
+  // Bail out if the source or the destination is null.
+  __ Beqz(src, slow_path->GetEntryLabel());
+  __ Beqz(dst, slow_path->GetEntryLabel());
+
+  ScratchRegisterScope srs(assembler);
+  XRegister tmp = srs.AllocateXRegister();
+
+  // Merge the following two comparisons into one:
+  //   If the length is negative, bail out (delegate to libcore's native implementation).
+  //   If the length > kSystemArrayCopyCharThreshold then (currently) prefer libcore's
+  //   native implementation.
+  __ Li(tmp, kSystemArrayCopyCharThreshold);
+  __ Bgtu(length, tmp, slow_path->GetEntryLabel());
+
+  // Validity checks: source and destination.
+  CheckSystemArrayCopyPosition(assembler, src_pos, src, length, slow_path, tmp);
+  CheckSystemArrayCopyPosition(assembler, dst_pos, dst, length, slow_path, tmp);
+
+  // Compute the source and destination start addresses and the source end address.
+  const size_t char_size = DataType::Size(DataType::Type::kUint16);
+  const uint32_t data_offset = mirror::Array::DataOffset(char_size).Uint32Value();
+  const size_t char_shift = DataType::SizeShift(DataType::Type::kUint16);
+  __ ShiftAndAdd(src_curr_addr, src, src_pos, char_shift);
+  __ Addi(src_curr_addr, src_curr_addr, data_offset);
+  __ ShiftAndAdd(dst_curr_addr, dst, dst_pos, char_shift);
+  __ Addi(dst_curr_addr, dst_curr_addr, data_offset);
+  __ ShiftAndAdd(src_stop_addr, src_curr_addr, length, char_shift);
+
+  // Copy one character at a time. The char array data is only 4-byte aligned.
+  Riscv64Label loop;
+  __ Beq(src_curr_addr, src_stop_addr, slow_path->GetExitLabel());
+  __ Bind(&loop);
+  __ Lhu(tmp, src_curr_addr, 0);
+  __ Sh(tmp, dst_curr_addr, 0);
+  __ Addi(src_curr_addr, src_curr_addr, char_size);
+  __ Addi(dst_curr_addr, dst_curr_addr, char_size);
+  __ Bne(src_curr_addr, src_stop_addr, &loop);
+  __ Bind(slow_path->GetExitLabel());
+}
+
+// Unsafe and JdkUnsafe accesses. The arguments are (this, base object, long offset, ...).
+
+static void CreateUnsafeGetLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::NoLocation());        // Unused receiver.
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetInAt(2, Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kNoOutputOverlap);
+}
+
+static void CreateUnsafeGetObjectLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  // TODO(riscv64): Implement read barriers.
+  if (gUseReadBarrier) {
+    return;
+  }
+  CreateUnsafeGetLocations(allocator, invoke);
+}
+
+// Volatile and acquire loads are followed by a LoadAny barrier.
+static void GenUnsafeGet(HInvoke* invoke,
+                         DataType::Type type,
+                         bool is_volatile_or_acquire,
+                         CodeGeneratorRISCV64* codegen) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+  XRegister base = locations->InAt(1).AsRegister<XRegister>();
+  XRegister offset = locations->InAt(2).AsRegister<XRegister>();
+  XRegister out = locations->Out().AsRegister<XRegister>();
+
+  __ Add(out, base, offset);
+  switch (type) {
+    case DataType::Type::kInt32:
+      __ Lw(out, out, 0);
+      break;
+    case DataType::Type::kInt64:
+      __ Ld(out, out, 0);
+      break;
+    case DataType::Type::kReference:
+      __ Lwu(out, out, 0);
+      break;
+    default:
+      LOG(FATAL) << "Unexpected type " << type;
+      UNREACHABLE();
+  }
+  if (is_volatile_or_acquire) {
+    __ Fence(/*pred=*/ kFenceRead, /*succ=*/ kFenceRead | kFenceWrite);
+  }
+  if (type == DataType::Type::kReference) {
+    __ MaybeUnpoisonHeapReference(out);
+  }
+}
+
+static void CreateUnsafePutLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::NoLocation());        // Unused receiver.
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetInAt(2, Location::RequiresRegister());
+  locations->SetInAt(3, Location::RequiresRegister());
+}
+
+// Ordered (release) and volatile stores are preceded by an AnyStore barrier,
+// volatile stores are also followed by an AnyAny barrier.
+static void GenUnsafePut(HInvoke* invoke,
+                         DataType::Type type,
+                         std::memory_order order,
+                         CodeGeneratorRISCV64* codegen) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+  XRegister base = locations->InAt(1).AsRegister<XRegister>();
+  XRegister offset = locations->InAt(2).AsRegister<XRegister>();
+  XRegister value = locations->InAt(3).AsRegister<XRegister>();
+
+  {
+    ScratchRegisterScope srs(assembler);
+    XRegister address = srs.AllocateXRegister();
+    __ Add(address, base, offset);
+    if (order != std::memory_order_relaxed) {
+      __ Fence(/*pred=*/ kFenceRead | kFenceWrite, /*succ=*/ kFenceWrite);
+    }
+    switch (type) {
+      case DataType::Type::kInt32:
+        __ Sw(value, address, 0);
+        break;
+      case DataType::Type::kInt64:
+        __ Sd(value, address, 0);
+        break;
+      case DataType::Type::kReference:
+        if (kPoisonHeapReferences) {
+          XRegister temp = srs.AllocateXRegister();
+          __ Mv(temp, value);
+          __ PoisonHeapReference(temp);
+          __ Sw(temp, address, 0);
+        } else {
+          __ Sw(value, address, 0);
+        }
+        break;
+      default:
+        LOG(FATAL) << "Unexpected type " << type;
+        UNREACHABLE();
+    }
+    if (order == std::memory_order_seq_cst) {
+      __ Fence(/*pred=*/ kFenceRead | kFenceWrite, /*succ=*/ kFenceRead | kFenceWrite);
+    }
+  }
+
+  if (type == DataType::Type::kReference) {
+    bool value_can_be_null = true;  // TODO: Worth finding out this information?
+    codegen->MarkGCCard(base, value, value_can_be_null);
+  }
+}
+
+static void CreateUnsafeCASLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::NoLocation());        // Unused receiver.
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetInAt(2, Location::RequiresRegister());
+  locations->SetInAt(3, Location::RequiresRegister());
+  locations->SetInAt(4, Location::RequiresRegister());
+  // The output is written in the LR/SC loop while the inputs are still needed.
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+static void CreateUnsafeCASObjectLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  // TODO(riscv64): Implement read barriers and heap poisoning for the reference CAS.
+  if (gUseReadBarrier || kPoisonHeapReferences) {
+    return;
+  }
+  CreateUnsafeCASLocations(allocator, invoke);
+}
+
+// Sequentially consistent compare-and-set. Returns 1 in `out` on success, 0 otherwise.
+static void GenUnsafeCas(HInvoke* invoke, DataType::Type type, CodeGeneratorRISCV64* codegen) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+  XRegister base = locations->InAt(1).AsRegister<XRegister>();
+  XRegister offset = locations->InAt(2).AsRegister<XRegister>();
+  XRegister expected = locations->InAt(3).AsRegister<XRegister>();
+  XRegister new_value = locations->InAt(4).AsRegister<XRegister>();
+  XRegister out = locations->Out().AsRegister<XRegister>();
+
+  if (type == DataType::Type::kReference) {
+    // Mark card for object assuming new value is stored.
+    bool new_value_can_be_null = true;  // TODO: Worth finding out this information?
+    codegen->MarkGCCard(base, new_value, new_value_can_be_null);
+  }
+
+  ScratchRegisterScope srs(assembler);
+  XRegister address = srs.AllocateXRegister();
+  __ Add(address, base, offset);
+  if (type == DataType::Type::kReference) {
+    // LR.W sign-extends the loaded reference, so sign-extend the expected one as well.
+    XRegister sign_extended_expected = srs.AllocateXRegister();
+    __ SextW(sign_extended_expected, expected);
+    expected = sign_extended_expected;
+  }
+
+  Riscv64Label loop;
+  Riscv64Label done;
+  __ Bind(&loop);
+  if (type == DataType::Type::kInt64) {
+    __ LrD(out, address, kAqRlAcquireRelease);
+  } else {
+    __ LrW(out, address, kAqRlAcquireRelease);
+  }
+  __ Sub(out, out, expected);
+  __ Bnez(out, &done);
+  if (type == DataType::Type::kInt64) {
+    __ ScD(out, new_value, address, kAqRlRelease);
+  } else {
+    __ ScW(out, new_value, address, kAqRlRelease);
+  }
+  __ Bnez(out, &loop);
+  // The `out` is zero if, and only if, the store succeeded.
+  __ Bind(&done);
+  __ Seqz(out, out);
+}
+
+static void CreateUnsafeGetAndUpdateLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::NoLocation());        // Unused receiver.
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetInAt(2, Location::RequiresRegister());
+  locations->SetInAt(3, Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kNoOutputOverlap);
+}
+
+static void CreateUnsafeGetAndSetObjectLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  // TODO(riscv64): Implement read barriers and heap poisoning for the reference exchange.
+  if (gUseReadBarrier || kPoisonHeapReferences) {
+    return;
+  }
+  CreateUnsafeGetAndUpdateLocations(allocator, invoke);
+}
+
+// Sequentially consistent atomic add or exchange using the AMO instructions.
+static void GenUnsafeGetAndUpdate(HInvoke* invoke,
+                                  DataType::Type type,
+                                  bool is_add,
+                                  CodeGeneratorRISCV64* codegen) {
+  LocationSummary* locations = invoke->GetLocations();
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+  XRegister base = locations->InAt(1).AsRegister<XRegister>();
+  XRegister offset = locations->InAt(2).AsRegister<XRegister>();
+  XRegister arg = locations->InAt(3).AsRegister<XRegister>();
+  XRegister out = locations->Out().AsRegister<XRegister>();
+
+  if (type == DataType::Type::kReference) {
+    DCHECK(!is_add);
+    bool value_can_be_null = true;  // TODO: Worth finding out this information?
+    codegen->MarkGCCard(base, arg, value_can_be_null);
+  }
+
+  ScratchRegisterScope srs(assembler);
+  XRegister address = srs.AllocateXRegister();
+  __ Add(address, base, offset);
+  switch (type) {
+    case DataType::Type::kInt32:
+      if (is_add) {
+        __ AmoAddW(out, arg, address, kAqRlAcquireRelease);
+      } else {
+        __ AmoSwapW(out, arg, address, kAqRlAcquireRelease);
+      }
+      break;
+    case DataType::Type::kInt64:
+      if (is_add) {
+        __ AmoAddD(out, arg, address, kAqRlAcquireRelease);
+      } else {
+        __ AmoSwapD(out, arg, address, kAqRlAcquireRelease);
+      }
+      break;
+    case DataType::Type::kReference:
+      __ AmoSwapW(out, arg, address, kAqRlAcquireRelease);
+      __ ZextW(out, out);  // References are zero-extended.
+      break;
+    default:
+      LOG(FATAL) << "Unexpected type " << type;
+      UNREACHABLE();
+  }
+}
+
+#define UNSAFE_GET_INTRINSIC(Name, TypeKind, IsVolatileOrAcquire, CreateLocations) \
+  void IntrinsicLocationsBuilderRISCV64::Visit##Name(HInvoke* invoke) {            \
+    CreateLocations(allocator_, invoke);                                           \
+  }                                                                                \
+  void IntrinsicCodeGeneratorRISCV64::Visit##Name(HInvoke* invoke) {               \
+    GenUnsafeGet(invoke, DataType::Type::TypeKind, IsVolatileOrAcquire, codegen_); \
+  }
+
+UNSAFE_GET_INTRINSIC(UnsafeGet, kInt32, false, CreateUnsafeGetLocations)
+UNSAFE_GET_INTRINSIC(UnsafeGetVolatile, kInt32, true, CreateUnsafeGetLocations)
+UNSAFE_GET_INTRINSIC(UnsafeGetLong, kInt64, false, CreateUnsafeGetLocations)
+UNSAFE_GET_INTRINSIC(UnsafeGetLongVolatile, kInt64, true, CreateUnsafeGetLocations)
+UNSAFE_GET_INTRINSIC(UnsafeGetObject, kReference, false, CreateUnsafeGetObjectLocations)
+UNSAFE_GET_INTRINSIC(UnsafeGetObjectVolatile, kReference, true, CreateUnsafeGetObjectLocations)
+UNSAFE_GET_INTRINSIC(JdkUnsafeGet, kInt32, false, CreateUnsafeGetLocations)
+UNSAFE_GET_INTRINSIC(JdkUnsafeGetVolatile, kInt32, true, CreateUnsafeGetLocations)
+UNSAFE_GET_INTRINSIC(JdkUnsafeGetAcquire, kInt32, true, CreateUnsafeGetLocations)
+UNSAFE_GET_INTRINSIC(JdkUnsafeGetLong, kInt64, false, CreateUnsafeGetLocations)
+UNSAFE_GET_INTRINSIC(JdkUnsafeGetLongVolatile, kInt64, true, CreateUnsafeGetLocations)
+UNSAFE_GET_INTRINSIC(JdkUnsafeGetLongAcquire, kInt64, true, CreateUnsafeGetLocations)
+UNSAFE_GET_INTRINSIC(JdkUnsafeGetObject, kReference, false, CreateUnsafeGetObjectLocations)
+UNSAFE_GET_INTRINSIC(
+    JdkUnsafeGetObjectVolatile, kReference, true, CreateUnsafeGetObjectLocations)
+UNSAFE_GET_INTRINSIC(
+    JdkUnsafeGetObjectAcquire, kReference, true, CreateUnsafeGetObjectLocations)
+
+#undef UNSAFE_GET_INTRINSIC
+
+#define UNSAFE_PUT_INTRINSIC(Name, TypeKind, Order)                                      \
+  void IntrinsicLocationsBuilderRISCV64::Visit##Name(HInvoke* invoke) {                  \
+    CreateUnsafePutLocations(allocator_, invoke);                                        \
+  }                                                                                      \
+  void IntrinsicCodeGeneratorRISCV64::Visit##Name(HInvoke* invoke) {                     \
+    GenUnsafePut(invoke, DataType::Type::TypeKind, std::memory_order_##Order, codegen_); \
+  }
+
+UNSAFE_PUT_INTRINSIC(UnsafePut, kInt32, relaxed)
+UNSAFE_PUT_INTRINSIC(UnsafePutOrdered, kInt32, release)
+UNSAFE_PUT_INTRINSIC(UnsafePutVolatile, kInt32, seq_cst)
+UNSAFE_PUT_INTRINSIC(UnsafePutLong, kInt64, relaxed)
+UNSAFE_PUT_INTRINSIC(UnsafePutLongOrdered, kInt64, release)
+UNSAFE_PUT_INTRINSIC(UnsafePutLongVolatile, kInt64, seq_cst)
+UNSAFE_PUT_INTRINSIC(UnsafePutObject, kReference, relaxed)
+UNSAFE_PUT_INTRINSIC(UnsafePutObjectOrdered, kReference, release)
+UNSAFE_PUT_INTRINSIC(UnsafePutObjectVolatile, kReference, seq_cst)
+UNSAFE_PUT_INTRINSIC(JdkUnsafePut, kInt32, relaxed)
+UNSAFE_PUT_INTRINSIC(JdkUnsafePutOrdered, kInt32, release)
+UNSAFE_PUT_INTRINSIC(JdkUnsafePutRelease, kInt32, release)
+UNSAFE_PUT_INTRINSIC(JdkUnsafePutVolatile, kInt32, seq_cst)
+UNSAFE_PUT_INTRINSIC(JdkUnsafePutLong, kInt64, relaxed)
+UNSAFE_PUT_INTRINSIC(JdkUnsafePutLongOrdered, kInt64, release)
+UNSAFE_PUT_INTRINSIC(JdkUnsafePutLongRelease, kInt64, release)
+UNSAFE_PUT_INTRINSIC(JdkUnsafePutLongVolatile, kInt64, seq_cst)
+UNSAFE_PUT_INTRINSIC(JdkUnsafePutObject, kReference, relaxed)
+UNSAFE_PUT_INTRINSIC(JdkUnsafePutObjectOrdered, kReference, release)
+UNSAFE_PUT_INTRINSIC(JdkUnsafePutObjectRelease, kReference, release)
+UNSAFE_PUT_INTRINSIC(JdkUnsafePutObjectVolatile, kReference, seq_cst)
+
+#undef UNSAFE_PUT_INTRINSIC
+
+#define UNSAFE_CAS_INTRINSIC(Name, TypeKind, CreateLocations)           \
+  void IntrinsicLocationsBuilderRISCV64::Visit##Name(HInvoke* invoke) { \
+    CreateLocations(allocator_, invoke);                                \
+  }                                                                     \
+  void IntrinsicCodeGeneratorRISCV64::Visit##Name(HInvoke* invoke) {    \
+    GenUnsafeCas(invoke, DataType::Type::TypeKind, codegen_);           \
+  }
+
+UNSAFE_CAS_INTRINSIC(UnsafeCASInt, kInt32, CreateUnsafeCASLocations)
+UNSAFE_CAS_INTRINSIC(UnsafeCASLong, kInt64, CreateUnsafeCASLocations)
+UNSAFE_CAS_INTRINSIC(UnsafeCASObject, kReference, CreateUnsafeCASObjectLocations)
+UNSAFE_CAS_INTRINSIC(JdkUnsafeCASInt, kInt32, CreateUnsafeCASLocations)
+UNSAFE_CAS_INTRINSIC(JdkUnsafeCASLong, kInt64, CreateUnsafeCASLocations)
+UNSAFE_CAS_INTRINSIC(JdkUnsafeCASObject, kReference, CreateUnsafeCASObjectLocations)
+UNSAFE_CAS_INTRINSIC(JdkUnsafeCompareAndSetInt, kInt32, CreateUnsafeCASLocations)
+UNSAFE_CAS_INTRINSIC(JdkUnsafeCompareAndSetLong, kInt64, CreateUnsafeCASLocations)
+UNSAFE_CAS_INTRINSIC(JdkUnsafeCompareAndSetObject, kReference, CreateUnsafeCASObjectLocations)
+
+#undef UNSAFE_CAS_INTRINSIC
+
+#define UNSAFE_GET_AND_UPDATE_INTRINSIC(Name, TypeKind, IsAdd, CreateLocations) \
+  void IntrinsicLocationsBuilderRISCV64::Visit##Name(HInvoke* invoke) {         \
+    CreateLocations(allocator_, invoke);                                        \
+  }                                                                             \
+  void IntrinsicCodeGeneratorRISCV64::Visit##Name(HInvoke* invoke) {            \
+    GenUnsafeGetAndUpdate(invoke, DataType::Type::TypeKind, IsAdd, codegen_);   \
+  }
+
+UNSAFE_GET_AND_UPDATE_INTRINSIC(UnsafeGetAndAddInt, kInt32, true, CreateUnsafeGetAndUpdateLocations)
+UNSAFE_GET_AND_UPDATE_INTRINSIC(
+    UnsafeGetAndAddLong, kInt64, true, CreateUnsafeGetAndUpdateLocations)
+UNSAFE_GET_AND_UPDATE_INTRINSIC(
+    UnsafeGetAndSetInt, kInt32, false, CreateUnsafeGetAndUpdateLocations)
+UNSAFE_GET_AND_UPDATE_INTRINSIC(
+    UnsafeGetAndSetLong, kInt64, false, CreateUnsafeGetAndUpdateLocations)
+UNSAFE_GET_AND_UPDATE_INTRINSIC(
+    UnsafeGetAndSetObject, kReference, false, CreateUnsafeGetAndSetObjectLocations)
+UNSAFE_GET_AND_UPDATE_INTRINSIC(
+    JdkUnsafeGetAndAddInt, kInt32, true, CreateUnsafeGetAndUpdateLocations)
+UNSAFE_GET_AND_UPDATE_INTRINSIC(
+    JdkUnsafeGetAndAddLong, kInt64, true, CreateUnsafeGetAndUpdateLocations)
+UNSAFE_GET_AND_UPDATE_INTRINSIC(
+    JdkUnsafeGetAndSetInt, kInt32, false, CreateUnsafeGetAndUpdateLocations)
+UNSAFE_GET_AND_UPDATE_INTRINSIC(
+    JdkUnsafeGetAndSetLong, kInt64, false, CreateUnsafeGetAndUpdateLocations)
+UNSAFE_GET_AND_UPDATE_INTRINSIC(
+    JdkUnsafeGetAndSetObject, kReference, false, CreateUnsafeGetAndSetObjectLocations)
+
+#undef UNSAFE_GET_AND_UPDATE_INTRINSIC
+
+// VarHandle accesses. The arguments are (VarHandle, coordinates..., values...).
+//
+// Only field and array VarHandles are intrinsified; byte array views, ByteBuffer views and
+// all arrays that do not exactly match the VarHandle's coordinate type take the slow path.
+
+// Ordering bits of an AMO/LR/SC instruction implementing an atomic access with `order`.
+static AqRl GetAmoAqRl(std::memory_order order) {
+  switch (order) {
+    case std::memory_order_relaxed:
+      return kAqRlNone;
+    case std::memory_order_acquire:
+      return kAqRlAcquire;
+    case std::memory_order_release:
+      return kAqRlRelease;
+    case std::memory_order_seq_cst:
+      return kAqRlAcquireRelease;
+    default:
+      LOG(FATAL) << "Unexpected memory order " << static_cast<int>(order);
+      UNREACHABLE();
+  }
+}
+
+// The LR of a LR/SC sequence carries the acquire semantics, the SC carries the release.
+static AqRl GetLrAqRl(std::memory_order order) {
+  return static_cast<AqRl>(GetAmoAqRl(order) & kAqRlAcquire);
+}
+
+static AqRl GetScAqRl(std::memory_order order) {
+  return static_cast<AqRl>(GetAmoAqRl(order) & kAqRlRelease);
+}
+
+// Return the register holding an input of `invoke` or the `Zero` register for an input
+// with the zero bit pattern. Floating point inputs are moved to a scratch register.
+static XRegister GetVarHandleValueRegister(HInvoke* invoke,
+                                           uint32_t index,
+                                           DataType::Type type,
+                                           Riscv64Assembler* assembler,
+                                           ScratchRegisterScope* srs) {
+  Location location = invoke->GetLocations()->InAt(index);
+  if (location.IsConstant()) {
+    DCHECK(IsZeroBitPattern(location.GetConstant()));
+    return Zero;
+  } else if (DataType::IsFloatingPointType(type)) {
+    XRegister reg = srs->AllocateXRegister();
+    if (type == DataType::Type::kFloat64) {
+      __ FMvXD(reg, location.AsFpuRegister<FRegister>());
+    } else {
+      // FMV.X.W sign-extends the value like LR.W and AMO*.W do.
+      __ FMvXW(reg, location.AsFpuRegister<FRegister>());
+    }
+    return reg;
+  } else {
+    return location.AsRegister<XRegister>();
+  }
+}
+
+// Generate subtype check without read barriers. Uses `temp` for walking the superclasses.
+static void GenerateSubTypeObjectCheckNoReadBarrier(CodeGeneratorRISCV64* codegen,
+                                                    SlowPathCodeRISCV64* slow_path,
+                                                    XRegister object,
+                                                    XRegister type,
+                                                    XRegister temp,
+                                                    bool object_can_be_null = true) {
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+
+  const MemberOffset class_offset = mirror::Object::ClassOffset();
+  const MemberOffset super_class_offset = mirror::Class::SuperClassOffset();
+
+  Riscv64Label success;
+  if (object_can_be_null) {
+    __ Beqz(object, &success);
+  }
+
+  __ Loadwu(temp, object, class_offset.Int32Value());
+  __ MaybeUnpoisonHeapReference(temp);
+  Riscv64Label loop;
+  __ Bind(&loop);
+  __ Beq(type, temp, &success);
+  __ Loadwu(temp, temp, super_class_offset.Int32Value());
+  __ MaybeUnpoisonHeapReference(temp);
+  __ Beqz(temp, slow_path->GetEntryLabel());
+  __ J(&loop);
+  __ Bind(&success);
+}
+
+// Check access mode and the primitive type from VarHandle.varType.
+// Check reference arguments against the VarHandle.varType; for references this is a subclass
+// check without read barrier, so it can have false negatives which we handle in the slow path.
+static void GenerateVarHandleAccessModeAndVarTypeChecks(HInvoke* invoke,
+                                                        CodeGeneratorRISCV64* codegen,
+                                                        SlowPathCodeRISCV64* slow_path,
+                                                        DataType::Type type) {
+  mirror::VarHandle::AccessMode access_mode =
+      mirror::VarHandle::GetAccessModeByIntrinsic(invoke->GetIntrinsic());
+  Primitive::Type primitive_type = DataTypeToPrimitive(type);
+
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  XRegister varhandle = locations->InAt(0).AsRegister<XRegister>();
+
+  const MemberOffset var_type_offset = mirror::VarHandle::VarTypeOffset();
+  const MemberOffset access_mode_bit_mask_offset = mirror::VarHandle::AccessModesBitMaskOffset();
+  const MemberOffset primitive_type_offset = mirror::Class::PrimitiveTypeOffset();
+
+  ScratchRegisterScope srs(assembler);
+  XRegister var_type_no_rb = srs.AllocateXRegister();
+  XRegister temp = srs.AllocateXRegister();
+
+  // Check that the operation is permitted and the primitive type of varhandle.varType.
+  // We do not need a read barrier when loading a reference only for loading constant
+  // primitive field through the reference.
+  __ Loadw(temp, varhandle, access_mode_bit_mask_offset.Int32Value());
+  __ Srliw(temp, temp, static_cast<int32_t>(access_mode));
+  __ Andi(temp, temp, 1);
+  __ Beqz(temp, slow_path->GetEntryLabel());
+  __ Loadwu(var_type_no_rb, varhandle, var_type_offset.Int32Value());
+  __ MaybeUnpoisonHeapReference(var_type_no_rb);
+  __ Loadhu(temp, var_type_no_rb, primitive_type_offset.Int32Value());
+  static_assert(Primitive::kPrimNot == 0);
+  if (primitive_type != Primitive::kPrimNot) {
+    __ Addi(temp, temp, -static_cast<int32_t>(primitive_type));
+  }
+  __ Bnez(temp, slow_path->GetEntryLabel());
+
+  if (type == DataType::Type::kReference) {
+    // Check reference arguments against the varType.
+    // False negatives due to varType being an interface or array type
+    // or due to the missing read barrier are handled by the slow path.
+    size_t expected_coordinates_count = GetExpectedVarHandleCoordinatesCount(invoke);
+    uint32_t arguments_start = /* VarHandle object */ 1u + expected_coordinates_count;
+    uint32_t number_of_arguments = invoke->GetNumberOfArguments();
+    for (size_t arg_index = arguments_start; arg_index != number_of_arguments; ++arg_index) {
+      HInstruction* arg = invoke->InputAt(arg_index);
+      DCHECK_EQ(arg->GetType(), DataType::Type::kReference);
+      if (!arg->IsNullConstant()) {
+        XRegister arg_reg = locations->InAt(arg_index).AsRegister<XRegister>();
+        GenerateSubTypeObjectCheckNoReadBarrier(codegen, slow_path, arg_reg, var_type_no_rb, temp);
+      }
+    }
+  }
+}
+
+static void GenerateVarHandleStaticFieldCheck(HInvoke* invoke,
+                                              CodeGeneratorRISCV64* codegen,
+                                              SlowPathCodeRISCV64* slow_path) {
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+  XRegister varhandle = invoke->GetLocations()->InAt(0).AsRegister<XRegister>();
+
+  const MemberOffset coordinate_type0_offset = mirror::VarHandle::CoordinateType0Offset();
+
+  ScratchRegisterScope srs(assembler);
+  XRegister temp = srs.AllocateXRegister();
+
+  // Check that the VarHandle references a static field by checking that coordinateType0 == null.
+  // Do not emit read barrier (or unpoison the reference) for comparing to null.
+  __ Loadwu(temp, varhandle, coordinate_type0_offset.Int32Value());
+  __ Bnez(temp, slow_path->GetEntryLabel());
+}
+
+static void GenerateVarHandleInstanceFieldChecks(HInvoke* invoke,
+                                                 CodeGeneratorRISCV64* codegen,
+                                                 SlowPathCodeRISCV64* slow_path) {
+  VarHandleOptimizations optimizations(invoke);
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  XRegister varhandle = locations->InAt(0).AsRegister<XRegister>();
+  XRegister object = locations->InAt(1).AsRegister<XRegister>();
+
+  const MemberOffset coordinate_type0_offset = mirror::VarHandle::CoordinateType0Offset();
+  const MemberOffset coordinate_type1_offset = mirror::VarHandle::CoordinateType1Offset();
+
+  // Null-check the object.
+  if (!optimizations.GetSkipObjectNullCheck()) {
+    __ Beqz(object, slow_path->GetEntryLabel());
+  }
+
+  ScratchRegisterScope srs(assembler);
+  XRegister temp = srs.AllocateXRegister();
+  XRegister temp2 = srs.AllocateXRegister();
+
+  // Check that the VarHandle references an instance field by checking that
+  // coordinateType1 == null. coordinateType0 should not be null, but this is handled by the
+  // type compatibility check with the source object's type, which will fail for null.
+  // No need for read barrier or unpoisoning of coordinateType1 for comparison with null.
+  __ Loadwu(temp, varhandle, coordinate_type1_offset.Int32Value());
+  __ Bnez(temp, slow_path->GetEntryLabel());
+  __ Loadwu(temp, varhandle, coordinate_type0_offset.Int32Value());
+  __ MaybeUnpoisonHeapReference(temp);
+
+  // Check that the object has the correct type.
+  // We deliberately avoid the read barrier, letting the slow path handle the false negatives.
+  GenerateSubTypeObjectCheckNoReadBarrier(
+      codegen, slow_path, object, temp, temp2, /*object_can_be_null=*/ false);
+}
+
+static void GenerateVarHandleArrayChecks(HInvoke* invoke,
+                                         CodeGeneratorRISCV64* codegen,
+                                         SlowPathCodeRISCV64* slow_path) {
+  VarHandleOptimizations optimizations(invoke);
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  XRegister varhandle = locations->InAt(0).AsRegister<XRegister>();
+  XRegister object = locations->InAt(1).AsRegister<XRegister>();
+  XRegister index = locations->InAt(2).AsRegister<XRegister>();
+  DataType::Type value_type =
+      GetVarHandleExpectedValueType(invoke, /*expected_coordinates_count=*/ 2u);
+  Primitive::Type primitive_type = DataTypeToPrimitive(value_type);
+
+  const MemberOffset coordinate_type0_offset = mirror::VarHandle::CoordinateType0Offset();
+  const MemberOffset coordinate_type1_offset = mirror::VarHandle::CoordinateType1Offset();
+  const MemberOffset component_type_offset = mirror::Class::ComponentTypeOffset();
+  const MemberOffset primitive_type_offset = mirror::Class::PrimitiveTypeOffset();
+  const MemberOffset class_offset = mirror::Object::ClassOffset();
+  const MemberOffset array_length_offset = mirror::Array::LengthOffset();
+
+  // Null-check the object.
+  if (!optimizations.GetSkipObjectNullCheck()) {
+    __ Beqz(object, slow_path->GetEntryLabel());
+  }
+
+  ScratchRegisterScope srs(assembler);
+  XRegister temp = srs.AllocateXRegister();
+  XRegister temp2 = srs.AllocateXRegister();
+
+  // Check that the VarHandle references an array, byte array view or ByteBuffer by checking
+  // that coordinateType1 != null. If that's true, coordinateType1 shall be int.class and
+  // coordinateType0 shall not be null but we do not explicitly verify that.
+  // No need for read barrier or unpoisoning of coordinateType1 for comparison with null.
+  __ Loadwu(temp, varhandle, coordinate_type1_offset.Int32Value());
+  __ Beqz(temp, slow_path->GetEntryLabel());
+
+  // Check object class against componentType0.
+  //
+  // This is an exact check and we defer other cases to the runtime. This includes
+  // conversion to array of superclass references, which is valid but subsequently
+  // requires all update operations to check that the value can indeed be stored.
+  // We do not want to perform such extra checks in the intrinsified code.
+  //
+  // We do this check without read barrier, so there can be false negatives which we
+  // defer to the slow path. There shall be no false negatives for array classes in the
+  // boot image (including Object[] and primitive arrays) because they are non-movable.
+  __ Loadwu(temp, varhandle, coordinate_type0_offset.Int32Value());
+  __ MaybeUnpoisonHeapReference(temp);
+  __ Loadwu(temp2, object, class_offset.Int32Value());
+  __ MaybeUnpoisonHeapReference(temp2);
+  __ Bne(temp, temp2, slow_path->GetEntryLabel());
+
+  // Check that the coordinateType0 is an array type. We do not need a read barrier
+  // for loading constant reference fields (or chains of them) for comparison with null,
+  // nor for finally loading a constant primitive field (primitive type) below.
+  __ Loadwu(temp2, temp, component_type_offset.Int32Value());
+  __ MaybeUnpoisonHeapReference(temp2);
+  __ Beqz(temp2, slow_path->GetEntryLabel());
+
+  // Check that the array component type matches the primitive type. A mismatch means
+  // a byte array view, which is left to the slow path.
+  __ Loadhu(temp2, temp2, primitive_type_offset.Int32Value());
+  static_assert(Primitive::kPrimNot == 0);
+  if (primitive_type != Primitive::kPrimNot) {
+    __ Addi(temp2, temp2, -static_cast<int32_t>(primitive_type));
+  }
+  __ Bnez(temp2, slow_path->GetEntryLabel());
+
+  // Check for array index out of bounds.
+  __ Loadw(temp, object, array_length_offset.Int32Value());
+  __ Bgeu(index, temp, slow_path->GetEntryLabel());
+}
+
+static void GenerateVarHandleCoordinateChecks(HInvoke* invoke,
+                                              CodeGeneratorRISCV64* codegen,
+                                              SlowPathCodeRISCV64* slow_path) {
+  size_t expected_coordinates_count = GetExpectedVarHandleCoordinatesCount(invoke);
+  if (expected_coordinates_count == 0u) {
+    GenerateVarHandleStaticFieldCheck(invoke, codegen, slow_path);
+  } else if (expected_coordinates_count == 1u) {
+    GenerateVarHandleInstanceFieldChecks(invoke, codegen, slow_path);
+  } else {
+    DCHECK_EQ(expected_coordinates_count, 2u);
+    GenerateVarHandleArrayChecks(invoke, codegen, slow_path);
+  }
+}
+
+// Unlike arm64, we do not use the known boot image VarHandle; the checks are always emitted.
+static SlowPathCodeRISCV64* GenerateVarHandleChecks(HInvoke* invoke,
+                                                    CodeGeneratorRISCV64* codegen,
+                                                    DataType::Type type) {
+  SlowPathCodeRISCV64* slow_path =
+      new (codegen->GetScopedAllocator()) IntrinsicSlowPathRISCV64(invoke);
+  codegen->AddSlowPath(slow_path);
+
+  GenerateVarHandleAccessModeAndVarTypeChecks(invoke, codegen, slow_path, type);
+  GenerateVarHandleCoordinateChecks(invoke, codegen, slow_path);
+
+  return slow_path;
+}
+
+struct VarHandleTarget {
+  XRegister object;  // The object holding the value to operate on.
+  XRegister offset;  // The offset of the value to operate on.
+};
+
+static VarHandleTarget GetVarHandleTarget(HInvoke* invoke) {
+  size_t expected_coordinates_count = GetExpectedVarHandleCoordinatesCount(invoke);
+  LocationSummary* locations = invoke->GetLocations();
+
+  VarHandleTarget target;
+  // The temporary allocated for loading the offset.
+  target.offset = locations->GetTemp(0u).AsRegister<XRegister>();
+  // The reference to the object that holds the value to operate on.
+  target.object = (expected_coordinates_count == 0u)
+      ? locations->GetTemp(1u).AsRegister<XRegister>()
+      : locations->InAt(1).AsRegister<XRegister>();
+  return target;
+}
+
+// Load the target object and offset, then replace the offset with the address of the value.
+static XRegister GenerateVarHandleTargetAddress(HInvoke* invoke,
+                                                const VarHandleTarget& target,
+                                                CodeGeneratorRISCV64* codegen) {
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  XRegister varhandle = locations->InAt(0).AsRegister<XRegister>();
+  size_t expected_coordinates_count = GetExpectedVarHandleCoordinatesCount(invoke);
+
+  if (expected_coordinates_count <= 1u) {
+    // For static fields, we need to fill the `target.object` with the declaring class,
+    // so we can use `target.object` as temporary for the `ArtField*`. For instance fields,
+    // we do not need the declaring class, so we can forget the `ArtField*` when
+    // we load the `target.offset`, so use the `target.offset` to hold the `ArtField*`.
+    XRegister field = (expected_coordinates_count == 0) ? target.object : target.offset;
+
+    const MemberOffset art_field_offset = mirror::FieldVarHandle::ArtFieldOffset();
+    const MemberOffset offset_offset = ArtField::OffsetOffset();
+
+    // Load the ArtField, the offset and, if needed, declaring class.
+    __ Loadd(field, varhandle, art_field_offset.Int32Value());
+    __ Loadwu(target.offset, field, offset_offset.Int32Value());
+    if (expected_coordinates_count == 0u) {
+      // The declaring class is a GC root; static field VarHandles are not intrinsified
+      // with read barriers, see `CreateVarHandleCommonLocations()`. GC roots are not poisoned.
+      DCHECK(!gUseReadBarrier);
+      __ Loadwu(target.object, field, ArtField::DeclaringClassOffset().Int32Value());
+    }
+  } else {
+    DCHECK_EQ(expected_coordinates_count, 2u);
+    DataType::Type value_type =
+        GetVarHandleExpectedValueType(invoke, /*expected_coordinates_count=*/ 2u);
+    size_t size_shift = DataType::SizeShift(value_type);
+    MemberOffset data_offset = mirror::Array::DataOffset(DataType::Size(value_type));
+
+    XRegister index = locations->InAt(2).AsRegister<XRegister>();
+    XRegister shifted_index = index;
+    if (size_shift != 0u) {
+      shifted_index = target.offset;
+      __ Slli(shifted_index, index, size_shift);
+    }
+    __ Addi(target.offset, shifted_index, data_offset.Int32Value());
+  }
+
+  __ Add(target.offset, target.object, target.offset);
+  return target.offset;
+}
+
+// Returns true if the VarHandle access `invoke` with a value of `value_type` is intrinsified.
+static bool IsSupportedVarHandleAccess(HInvoke* invoke, DataType::Type value_type) {
+  if (VarHandleOptimizations(invoke).GetDoNotIntrinsify()) {
+    return false;
+  }
+  // TODO(riscv64): Implement read barriers for reference values and the declaring class.
+  if (gUseReadBarrier &&
+      (value_type == DataType::Type::kReference ||
+       GetExpectedVarHandleCoordinatesCount(invoke) == 0u)) {
+    return false;
+  }
+  mirror::VarHandle::AccessModeTemplate access_mode_template =
+      mirror::VarHandle::GetAccessModeTemplateByIntrinsic(invoke->GetIntrinsic());
+  if (access_mode_template == mirror::VarHandle::AccessModeTemplate::kGet ||
+      access_mode_template == mirror::VarHandle::AccessModeTemplate::kSet) {
+    return true;
+  }
+  // Atomic updates are done with LR/SC and AMO instructions which access only words
+  // and doublewords. TODO(riscv64): Implement heap poisoning for the reference updates.
+  if (DataType::Size(value_type) < 4u ||
+      (value_type == DataType::Type::kReference && kPoisonHeapReferences)) {
+    return false;
+  }
+  // There is no AMO instruction for floating point add.
+  return !(IsVarHandleGetAndAdd(invoke) && DataType::IsFloatingPointType(value_type));
+}
+
+static LocationSummary* CreateVarHandleCommonLocations(HInvoke* invoke) {
+  size_t expected_coordinates_count = GetExpectedVarHandleCoordinatesCount(invoke);
+  DataType::Type return_type = invoke->GetType();
+
+  ArenaAllocator* allocator = invoke->GetBlock()->GetGraph()->GetAllocator();
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  // Require coordinates in registers. These are the object holding the value
+  // to operate on (except for static fields) and index (for arrays).
+  for (size_t i = 0; i != expected_coordinates_count; ++i) {
+    locations->SetInAt(/* VarHandle object */ 1u + i, Location::RequiresRegister());
+  }
+  if (return_type != DataType::Type::kVoid) {
+    // The output is written while the inputs are still needed, keep the default overlap.
+    if (DataType::IsFloatingPointType(return_type)) {
+      locations->SetOut(Location::RequiresFpuRegister());
+    } else {
+      locations->SetOut(Location::RequiresRegister());
+    }
+  }
+  uint32_t arguments_start = /* VarHandle object */ 1u + expected_coordinates_count;
+  uint32_t number_of_arguments = invoke->GetNumberOfArguments();
+  for (size_t arg_index = arguments_start; arg_index != number_of_arguments; ++arg_index) {
+    HInstruction* arg = invoke->InputAt(arg_index);
+    if (IsZeroBitPattern(arg)) {
+      locations->SetInAt(arg_index, Location::ConstantLocation(arg));
+    } else if (DataType::IsFloatingPointType(arg->GetType())) {
+      locations->SetInAt(arg_index, Location::RequiresFpuRegister());
+    } else {
+      locations->SetInAt(arg_index, Location::RequiresRegister());
+    }
+  }
+
+  // Add a temporary for offset.
+  locations->AddTemp(Location::RequiresRegister());
+  if (expected_coordinates_count == 0u) {
+    // Add a temporary to hold the declaring class.
+    locations->AddTemp(Location::RequiresRegister());
+  }
+
+  return locations;
+}
+
+static void CreateVarHandleGetLocations(HInvoke* invoke) {
+  if (!IsSupportedVarHandleAccess(invoke, invoke->GetType())) {
+    return;
+  }
+
+  CreateVarHandleCommonLocations(invoke);
+}
+
+// Acquire and volatile loads are followed by a LoadAny barrier.
+static void GenerateVarHandleGet(HInvoke* invoke,
+                                 CodeGeneratorRISCV64* codegen,
+                                 std::memory_order order) {
+  DataType::Type type = invoke->GetType();
+  DCHECK_NE(type, DataType::Type::kVoid);
+
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+  Location out = invoke->GetLocations()->Out();
+
+  VarHandleTarget target = GetVarHandleTarget(invoke);
+  SlowPathCodeRISCV64* slow_path = GenerateVarHandleChecks(invoke, codegen, type);
+  XRegister address = GenerateVarHandleTargetAddress(invoke, target, codegen);
+
+  codegen->GetInstructionVisitor()->Load(out, address, /*offset=*/ 0, type);
+  if (order == std::memory_order_acquire || order == std::memory_order_seq_cst) {
+    __ Fence(/*pred=*/ kFenceRead, /*succ=*/ kFenceRead | kFenceWrite);
+  } else {
+    DCHECK(order == std::memory_order_relaxed);
+  }
+  if (type == DataType::Type::kReference) {
+    __ MaybeUnpoisonHeapReference(out.AsRegister<XRegister>());
+  }
+
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitVarHandleGet(HInvoke* invoke) {
+  CreateVarHandleGetLocations(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitVarHandleGet(HInvoke* invoke) {
+  GenerateVarHandleGet(invoke, codegen_, std::memory_order_relaxed);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitVarHandleGetOpaque(HInvoke* invoke) {
+  CreateVarHandleGetLocations(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitVarHandleGetOpaque(HInvoke* invoke) {
+  GenerateVarHandleGet(invoke, codegen_, std::memory_order_relaxed);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitVarHandleGetAcquire(HInvoke* invoke) {
+  CreateVarHandleGetLocations(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitVarHandleGetAcquire(HInvoke* invoke) {
+  GenerateVarHandleGet(invoke, codegen_, std::memory_order_acquire);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitVarHandleGetVolatile(HInvoke* invoke) {
+  CreateVarHandleGetLocations(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitVarHandleGetVolatile(HInvoke* invoke) {
+  GenerateVarHandleGet(invoke, codegen_, std::memory_order_seq_cst);
+}
+
+static void CreateVarHandleSetLocations(HInvoke* invoke) {
+  uint32_t value_index = invoke->GetNumberOfArguments() - 1;
+  if (!IsSupportedVarHandleAccess(invoke, GetDataTypeFromShorty(invoke, value_index))) {
+    return;
+  }
+
+  CreateVarHandleCommonLocations(invoke);
+}
+
+// Release and volatile stores are preceded by an AnyStore barrier,
+// volatile stores are also followed by an AnyAny barrier.
+static void GenerateVarHandleSet(HInvoke* invoke,
+                                 CodeGeneratorRISCV64* codegen,
+                                 std::memory_order order) {
+  uint32_t value_index = invoke->GetNumberOfArguments() - 1;
+  DataType::Type value_type = GetDataTypeFromShorty(invoke, value_index);
+
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+  Location value = invoke->GetLocations()->InAt(value_index);
+
+  VarHandleTarget target = GetVarHandleTarget(invoke);
+  SlowPathCodeRISCV64* slow_path = GenerateVarHandleChecks(invoke, codegen, value_type);
+  XRegister address = GenerateVarHandleTargetAddress(invoke, target, codegen);
+
+  {
+    ScratchRegisterScope srs(assembler);
+    if (kPoisonHeapReferences &&
+        value_type == DataType::Type::kReference &&
+        !value.IsConstant()) {
+      XRegister temp = srs.AllocateXRegister();
+      __ Mv(temp, value.AsRegister<XRegister>());
+      __ PoisonHeapReference(temp);
+      value = Location::RegisterLocation(temp);
+    }
+    if (order == std::memory_order_release || order == std::memory_order_seq_cst) {
+      __ Fence(/*pred=*/ kFenceRead | kFenceWrite, /*succ=*/ kFenceWrite);
+    } else {
+      DCHECK(order == std::memory_order_relaxed);
+    }
+    codegen->GetInstructionVisitor()->Store(value, address, /*offset=*/ 0, value_type);
+    if (order == std::memory_order_seq_cst) {
+      __ Fence(/*pred=*/ kFenceRead | kFenceWrite, /*succ=*/ kFenceRead | kFenceWrite);
+    }
+  }
+
+  if (CodeGenerator::StoreNeedsWriteBarrier(value_type, invoke->InputAt(value_index))) {
+    codegen->MarkGCCard(target.object,
+                        invoke->GetLocations()->InAt(value_index).AsRegister<XRegister>(),
+                        /*value_can_be_null=*/ true);
+  }
+
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitVarHandleSet(HInvoke* invoke) {
+  CreateVarHandleSetLocations(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitVarHandleSet(HInvoke* invoke) {
+  GenerateVarHandleSet(invoke, codegen_, std::memory_order_relaxed);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitVarHandleSetOpaque(HInvoke* invoke) {
+  CreateVarHandleSetLocations(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitVarHandleSetOpaque(HInvoke* invoke) {
+  GenerateVarHandleSet(invoke, codegen_, std::memory_order_relaxed);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitVarHandleSetRelease(HInvoke* invoke) {
+  CreateVarHandleSetLocations(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitVarHandleSetRelease(HInvoke* invoke) {
+  GenerateVarHandleSet(invoke, codegen_, std::memory_order_release);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitVarHandleSetVolatile(HInvoke* invoke) {
+  CreateVarHandleSetLocations(invoke);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitVarHandleSetVolatile(HInvoke* invoke) {
+  GenerateVarHandleSet(invoke, codegen_, std::memory_order_seq_cst);
+}
+
+static void CreateVarHandleCompareAndSetOrExchangeLocations(HInvoke* invoke, bool return_success) {
+  uint32_t number_of_arguments = invoke->GetNumberOfArguments();
+  DataType::Type value_type = GetDataTypeFromShorty(invoke, number_of_arguments - 1u);
+  if (!IsSupportedVarHandleAccess(invoke, value_type)) {
+    return;
+  }
+
+  LocationSummary* locations = CreateVarHandleCommonLocations(invoke);
+  if (!return_success) {
+    // Add a temporary for the store result; the output holds the old value.
+    locations->AddTemp(Location::RequiresRegister());
+    if (DataType::IsFloatingPointType(value_type)) {
+      // Add a temporary for the old value before moving it to the FP output,
+      // the scratch registers may hold the `expected` and `new_value`.
+      locations->AddTemp(Location::RequiresRegister());
+    }
+  }
+}
+
+static void GenerateVarHandleCompareAndSetOrExchange(HInvoke* invoke,
+                                                     CodeGeneratorRISCV64* codegen,
+                                                     std::memory_order order,
+                                                     bool return_success,
+                                                     bool strong) {
+  DCHECK(return_success || strong);
+
+  uint32_t expected_index = invoke->GetNumberOfArguments() - 2;
+  uint32_t new_value_index = invoke->GetNumberOfArguments() - 1;
+  DataType::Type value_type = GetDataTypeFromShorty(invoke, new_value_index);
+  DCHECK_EQ(value_type, GetDataTypeFromShorty(invoke, expected_index));
+
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  Location out = locations->Out();
+
+  VarHandleTarget target = GetVarHandleTarget(invoke);
+  SlowPathCodeRISCV64* slow_path = GenerateVarHandleChecks(invoke, codegen, value_type);
+  XRegister address = GenerateVarHandleTargetAddress(invoke, target, codegen);
+
+  if (CodeGenerator::StoreNeedsWriteBarrier(value_type, invoke->InputAt(new_value_index))) {
+    // Mark card for object assuming new value is stored.
+    bool new_value_can_be_null = true;  // TODO: Worth finding out this information?
+    codegen->MarkGCCard(target.object,
+                        locations->InAt(new_value_index).AsRegister<XRegister>(),
+                        new_value_can_be_null);
+  }
+
+  // Note that float/double CAS uses bitwise comparison, rather than the operator==.
+  ScratchRegisterScope srs(assembler);
+  XRegister expected =
+      GetVarHandleValueRegister(invoke, expected_index, value_type, assembler, &srs);
+  XRegister new_value =
+      GetVarHandleValueRegister(invoke, new_value_index, value_type, assembler, &srs);
+  if (value_type == DataType::Type::kReference && expected != Zero) {
+    // LR.W sign-extends the loaded reference, so sign-extend the expected one as well.
+    DCHECK_NE(srs.AvailableXRegisters(), 0u);
+    XRegister sign_extended_expected = srs.AllocateXRegister();
+    __ SextW(sign_extended_expected, expected);
+    expected = sign_extended_expected;
+  }
+  bool is_64_bit = DataType::Is64BitType(value_type);
+
+  // Prepare registers for old value and the result of the store conditional.
+  size_t old_temp_index = (GetExpectedVarHandleCoordinatesCount(invoke) == 0u) ? 2u : 1u;
+  XRegister old_value;
+  XRegister store_result;
+  if (return_success) {
+    // Use the output register for both old value and store result.
+    old_value = out.AsRegister<XRegister>();
+    store_result = old_value;
+  } else {
+    store_result = locations->GetTemp(old_temp_index).AsRegister<XRegister>();
+    old_value = DataType::IsFloatingPointType(value_type)
+        ? locations->GetTemp(old_temp_index + 1u).AsRegister<XRegister>()
+        : out.AsRegister<XRegister>();
+  }
+
+  Riscv64Label loop;
+  Riscv64Label done;
+  __ Bind(&loop);
+  if (is_64_bit) {
+    __ LrD(old_value, address, GetLrAqRl(order));
+  } else {
+    __ LrW(old_value, address, GetLrAqRl(order));
+  }
+  if (return_success) {
+    __ Sub(old_value, old_value, expected);
+    __ Bnez(old_value, &done);
+  } else {
+    __ Bne(old_value, expected, &done);
+  }
+  if (is_64_bit) {
+    __ ScD(store_result, new_value, address, GetScAqRl(order));
+  } else {
+    __ ScW(store_result, new_value, address, GetScAqRl(order));
+  }
+  if (strong) {
+    __ Bnez(store_result, &loop);
+  }
+  __ Bind(&done);
+
+  if (return_success) {
+    // The `out` is zero if, and only if, the store succeeded.
+    __ Seqz(old_value, old_value);
+  } else if (value_type == DataType::Type::kReference) {
+    __ ZextW(old_value, old_value);  // References are zero-extended.
+  } else if (value_type == DataType::Type::kFloat32) {
+    __ FMvWX(out.AsFpuRegister<FRegister>(), old_value);
+  } else if (value_type == DataType::Type::kFloat64) {
+    __ FMvDX(out.AsFpuRegister<FRegister>(), old_value);
+  }
+
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitVarHandleCompareAndExchange(HInvoke* invoke) {
+  CreateVarHandleCompareAndSetOrExchangeLocations(invoke, /*return_success=*/ false);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitVarHandleCompareAndExchange(HInvoke* invoke) {
+  GenerateVarHandleCompareAndSetOrExchange(
+      invoke, codegen_, std::memory_order_seq_cst, /*return_success=*/ false, /*strong=*/ true);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitVarHandleCompareAndExchangeAcquire(HInvoke* invoke) {
+  CreateVarHandleCompareAndSetOrExchangeLocations(invoke, /*return_success=*/ false);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitVarHandleCompareAndExchangeAcquire(HInvoke* invoke) {
+  GenerateVarHandleCompareAndSetOrExchange(
+      invoke, codegen_, std::memory_order_acquire, /*return_success=*/ false, /*strong=*/ true);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitVarHandleCompareAndExchangeRelease(HInvoke* invoke) {
+  CreateVarHandleCompareAndSetOrExchangeLocations(invoke, /*return_success=*/ false);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitVarHandleCompareAndExchangeRelease(HInvoke* invoke) {
+  GenerateVarHandleCompareAndSetOrExchange(
+      invoke, codegen_, std::memory_order_release, /*return_success=*/ false, /*strong=*/ true);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitVarHandleCompareAndSet(HInvoke* invoke) {
+  CreateVarHandleCompareAndSetOrExchangeLocations(invoke, /*return_success=*/ true);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitVarHandleCompareAndSet(HInvoke* invoke) {
+  GenerateVarHandleCompareAndSetOrExchange(
+      invoke, codegen_, std::memory_order_seq_cst, /*return_success=*/ true, /*strong=*/ true);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitVarHandleWeakCompareAndSet(HInvoke* invoke) {
+  CreateVarHandleCompareAndSetOrExchangeLocations(invoke, /*return_success=*/ true);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitVarHandleWeakCompareAndSet(HInvoke* invoke) {
+  GenerateVarHandleCompareAndSetOrExchange(
+      invoke, codegen_, std::memory_order_seq_cst, /*return_success=*/ true, /*strong=*/ false);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitVarHandleWeakCompareAndSetAcquire(HInvoke* invoke) {
+  CreateVarHandleCompareAndSetOrExchangeLocations(invoke, /*return_success=*/ true);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitVarHandleWeakCompareAndSetAcquire(HInvoke* invoke) {
+  GenerateVarHandleCompareAndSetOrExchange(
+      invoke, codegen_, std::memory_order_acquire, /*return_success=*/ true, /*strong=*/ false);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitVarHandleWeakCompareAndSetPlain(HInvoke* invoke) {
+  CreateVarHandleCompareAndSetOrExchangeLocations(invoke, /*return_success=*/ true);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitVarHandleWeakCompareAndSetPlain(HInvoke* invoke) {
+  GenerateVarHandleCompareAndSetOrExchange(
+      invoke, codegen_, std::memory_order_relaxed, /*return_success=*/ true, /*strong=*/ false);
+}
+
+void IntrinsicLocationsBuilderRISCV64::VisitVarHandleWeakCompareAndSetRelease(HInvoke* invoke) {
+  CreateVarHandleCompareAndSetOrExchangeLocations(invoke, /*return_success=*/ true);
+}
+
+void IntrinsicCodeGeneratorRISCV64::VisitVarHandleWeakCompareAndSetRelease(HInvoke* invoke) {
+  GenerateVarHandleCompareAndSetOrExchange(
+      invoke, codegen_, std::memory_order_release, /*return_success=*/ true, /*strong=*/ false);
+}
+
+enum class GetAndUpdateOp {
+  kSet,
+  kAdd,
+  kAnd,
+  kOr,
+  kXor
+};
+
+static void CreateVarHandleGetAndUpdateLocations(HInvoke* invoke) {
+  uint32_t arg_index = invoke->GetNumberOfArguments() - 1;
+  if (!IsSupportedVarHandleAccess(invoke, GetDataTypeFromShorty(invoke, arg_index))) {
+    return;
+  }
+
+  CreateVarHandleCommonLocations(invoke);
+}
+
+static void GenerateVarHandleGetAndUpdate(HInvoke* invoke,
+                                          CodeGeneratorRISCV64* codegen,
+                                          GetAndUpdateOp get_and_update_op,
+                                          std::memory_order order) {
+  uint32_t arg_index = invoke->GetNumberOfArguments() - 1;
+  DataType::Type value_type = GetDataTypeFromShorty(invoke, arg_index);
+  DCHECK(get_and_update_op == GetAndUpdateOp::kSet || DataType::IsIntegralType(value_type));
+
+  Riscv64Assembler* assembler = codegen->GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  Location out = locations->Out();
+
+  VarHandleTarget target = GetVarHandleTarget(invoke);
+  SlowPathCodeRISCV64* slow_path = GenerateVarHandleChecks(invoke, codegen, value_type);
+  XRegister address = GenerateVarHandleTargetAddress(invoke, target, codegen);
+
+  if (CodeGenerator::StoreNeedsWriteBarrier(value_type, invoke->InputAt(arg_index))) {
+    DCHECK(get_and_update_op == GetAndUpdateOp::kSet);
+    // Mark card for object, the new value shall be stored.
+    bool new_value_can_be_null = true;  // TODO: Worth finding out this information?
+    codegen->MarkGCCard(target.object,
+                        locations->InAt(arg_index).AsRegister<XRegister>(),
+                        new_value_can_be_null);
+  }
+
+  ScratchRegisterScope srs(assembler);
+  XRegister arg = GetVarHandleValueRegister(invoke, arg_index, value_type, assembler, &srs);
+  XRegister old_value = DataType::IsFloatingPointType(value_type)
+      ? srs.AllocateXRegister()
+      : out.AsRegister<XRegister>();
+  AqRl aqrl = GetAmoAqRl(order);
+  if (DataType::Is64BitType(value_type)) {
+    switch (get_and_update_op) {
+      case GetAndUpdateOp::kSet:
+        __ AmoSwapD(old_value, arg, address, aqrl);
+        break;
+      case GetAndUpdateOp::kAdd:
+        __ AmoAddD(old_value, arg, address, aqrl);
+        break;
+      case GetAndUpdateOp::kAnd:
+        __ AmoAndD(old_value, arg, address, aqrl);
+        break;
+      case GetAndUpdateOp::kOr:
+        __ AmoOrD(old_value, arg, address, aqrl);
+        break;
+      case GetAndUpdateOp::kXor:
+        __ AmoXorD(old_value, arg, address, aqrl);
+        break;
+    }
+  } else {
+    switch (get_and_update_op) {
+      case GetAndUpdateOp::kSet:
+        __ AmoSwapW(old_value, arg, address, aqrl);
+        break;
+      case GetAndUpdateOp::kAdd:
+        __ AmoAddW(old_value, arg, address, aqrl);
+        break;
+      case GetAndUpdateOp::kAnd:
+        __ AmoAndW(old_value, arg, address, aqrl);
+        break;
+      case GetAndUpdateOp::kOr:
+        __ AmoOrW(old_value, arg, address, aqrl);
+        break;
+      case GetAndUpdateOp::kXor:
+        __ AmoXorW(old_value, arg, address, aqrl);
+        break;
+    }
+  }
+
+  if (value_type == DataType::Type::kReference) {
+    __ ZextW(old_value, old_value);  // References are zero-extended.
+  } else if (value_type == DataType::Type::kFloat32) {
+    __ FMvWX(out.AsFpuRegister<FRegister>(), old_value);
+  } else if (value_type == DataType::Type::kFloat64) {
+    __ FMvDX(out.AsFpuRegister<FRegister>(), old_value);
+  }
+
+  __ Bind(slow_path->GetExitLabel());
+}
+
+#define VAR_HANDLE_GET_AND_UPDATE_INTRINSIC(Name, Op, Order)                   \
+  void IntrinsicLocationsBuilderRISCV64::Visit##Name(HInvoke* invoke) {        \
+    CreateVarHandleGetAndUpdateLocations(invoke);                              \
+  }                                                                            \
+  void IntrinsicCodeGeneratorRISCV64::Visit##Name(HInvoke* invoke) {           \
+    GenerateVarHandleGetAndUpdate(                                             \
+        invoke, codegen_, GetAndUpdateOp::Op, std::memory_order_##Order);      \
+  }
+
+VAR_HANDLE_GET_AND_UPDATE_INTRINSIC(VarHandleGetAndSet, kSet, seq_cst)
+VAR_HANDLE_GET_AND_UPDATE_INTRINSIC(VarHandleGetAndSetAcquire, kSet, acquire)
+VAR_HANDLE_GET_AND_UPDATE_INTRINSIC(VarHandleGetAndSetRelease, kSet, release)
+VAR_HANDLE_GET_AND_UPDATE_INTRINSIC(VarHandleGetAndAdd, kAdd, seq_cst)
+VAR_HANDLE_GET_AND_UPDATE_INTRINSIC(VarHandleGetAndAddAcquire, kAdd, acquire)
+VAR_HANDLE_GET_AND_UPDATE_INTRINSIC(VarHandleGetAndAddRelease, kAdd, release)
+VAR_HANDLE_GET_AND_UPDATE_INTRINSIC(VarHandleGetAndBitwiseAnd, kAnd, seq_cst)
+VAR_HANDLE_GET_AND_UPDATE_INTRINSIC(VarHandleGetAndBitwiseAndAcquire, kAnd, acquire)
+VAR_HANDLE_GET_AND_UPDATE_INTRINSIC(VarHandleGetAndBitwiseAndRelease, kAnd, release)
+VAR_HANDLE_GET_AND_UPDATE_INTRINSIC(VarHandleGetAndBitwiseOr, kOr, seq_cst)
+VAR_HANDLE_GET_AND_UPDATE_INTRINSIC(VarHandleGetAndBitwiseOrAcquire, kOr, acquire)
+VAR_HANDLE_GET_AND_UPDATE_INTRINSIC(VarHandleGetAndBitwiseOrRelease, kOr, release)
+VAR_HANDLE_GET_AND_UPDATE_INTRINSIC(VarHandleGetAndBitwiseXor, kXor, seq_cst)
+VAR_HANDLE_GET_AND_UPDATE_INTRINSIC(VarHandleGetAndBitwiseXorAcquire, kXor, acquire)
+VAR_HANDLE_GET_AND_UPDATE_INTRINSIC(VarHandleGetAndBitwiseXorRelease, kXor, release)
+
+#undef VAR_HANDLE_GET_AND_UPDATE_INTRINSIC
+
+#define MARK_UNIMPLEMENTED(Name) UNIMPLEMENTED_INTRINSIC(RISCV64, Name)
+UNIMPLEMENTED_INTRINSIC_LIST_RISCV64(MARK_UNIMPLEMENTED);
+#undef MARK_UNIMPLEMENTED
+
+UNREACHABLE_INTRINSICS(RISCV64)
+
+#undef __
+
+}  // namespace riscv64
+}  // namespace art
@@ -16,6 +16,9 @@
 
 #include "linear_order.h"
 
+#include <algorithm>
+
+#include "base/arena_bit_vector.h"
 #include "base/scoped_arena_allocator.h"
 #include "base/scoped_arena_containers.h"
 
@@ -83,6 +86,66 @@ static bool IsLinearOrderWellFormed(const HGraph* graph, ArrayRef<HBasicBlock*>
   return true;
 }
 
+// Returns whether `block` is only executed on the way to throwing an exception.
+static bool IsColdBlock(const HBasicBlock* block, const BitVector& is_cold) {
+  if (block->IsEntryBlock() ||
+      block->IsExitBlock() ||
+      block->GetLoopInformation() != nullptr ||
+      block->IsTryBlock() ||
+      block->IsCatchBlock()) {
+    return false;
+  }
+  if (block->GetLastInstruction()->IsThrow()) {
+    return true;
+  }
+  for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+    if (it.Current()->AlwaysThrows()) {
+      return true;
+    }
+  }
+  // Note: successors are visited before `block` in post order as `block` is not in a loop.
+  return std::all_of(block->GetSuccessors().begin(),
+                     block->GetSuccessors().end(),
+                     [&](HBasicBlock* successor) { return is_cold.IsBitSet(successor->GetBlockId()); });
+}
+
+// Moves the cold blocks, which lead to throwing an exception, after all the other blocks but the
+// exit block, so that the code of the other blocks is contiguous in the generated code. The
+// order stays topological as the successors of a cold block are cold blocks or the exit block.
+static void MoveColdBlocksToEnd(const HGraph* graph, ArrayRef<HBasicBlock*> linear_order) {
+  ScopedArenaAllocator allocator(graph->GetArenaStack());
+  ArenaBitVector is_cold(
+      &allocator, graph->GetBlocks().size(), /* expandable= */ false, kArenaAllocLinearOrder);
+  bool has_cold_blocks = false;
+  for (HBasicBlock* block : ReverseRange(graph->GetReversePostOrder())) {
+    if (IsColdBlock(block, is_cold)) {
+      is_cold.SetBit(block->GetBlockId());
+      has_cold_blocks = true;
+    }
+  }
+  if (!has_cold_blocks) {
+    return;
+  }
+
+  ScopedArenaVector<HBasicBlock*> cold_blocks(allocator.Adapter(kArenaAllocLinearOrder));
+  HBasicBlock* exit_block = nullptr;
+  size_t num_hot = 0u;
+  for (HBasicBlock* block : linear_order) {
+    if (is_cold.IsBitSet(block->GetBlockId())) {
+      cold_blocks.push_back(block);
+    } else if (block->IsExitBlock()) {
+      exit_block = block;
+    } else {
+      linear_order[num_hot] = block;
+      ++num_hot;
+    }
+  }
+  std::copy(cold_blocks.begin(), cold_blocks.end(), linear_order.begin() + num_hot);
+  if (exit_block != nullptr) {
+    linear_order.back() = exit_block;
+  }
+}
+
 void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_order) {
   DCHECK_EQ(linear_order.size(), graph->GetReversePostOrder().size());
   // Create a reverse post ordering with the following properties:
@@ -127,6 +190,11 @@ void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_o
   } while (!worklist.empty());
   DCHECK_EQ(num_added, linear_order.size());
 
+  // (3): Move the blocks leading to a throw out of the way of the other blocks.
+  if (!graph->HasIrreducibleLoops()) {
+    MoveColdBlocksToEnd(graph, linear_order);
+  }
+
   DCHECK(graph->HasIrreducibleLoops() || IsLinearOrderWellFormed(graph, linear_order));
 }
 
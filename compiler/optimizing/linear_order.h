@@ -28,7 +28,8 @@ void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_o
 
 // Linearizes the 'graph' such that:
 // (1): a block is always after its dominator,
-// (2): blocks of loops are contiguous.
+// (2): blocks of loops are contiguous,
+// (3): blocks only leading to a throw are placed after the other blocks, but before the exit.
 //
 // Storage is obtained through 'allocator' and the linear order it computed
 // into 'linear_order'. Once computed, iteration can be expressed as:
@@ -88,6 +88,10 @@ class ArchDefaultLoopHelper : public ArchNoOptsLoopHelper {
   static constexpr uint32_t kScalarHeuristicMaxBodySizeBlocks = 6;
   // Maximum number of instructions to be created as a result of full unrolling.
   static constexpr uint32_t kScalarHeuristicFullyUnrolledMaxInstrThreshold = 35;
+  // Loop's maximum instruction count. Loops with higher count will not be unswitched.
+  static constexpr uint32_t kScalarHeuristicMaxUnswitchBodySizeInstr = 60;
+  // Loop's maximum basic block count. Loops with higher count will not be unswitched.
+  static constexpr uint32_t kScalarHeuristicMaxUnswitchBodySizeBlocks = 12;
 
   bool IsLoopNonBeneficialForScalarOpts(LoopAnalysisInfo* analysis_info) const override {
     return analysis_info->HasLongTypeInstructions() ||
@@ -120,6 +124,12 @@ class ArchDefaultLoopHelper : public ArchNoOptsLoopHelper {
     return (trip_count * instr_num < kScalarHeuristicFullyUnrolledMaxInstrThreshold);
   }
 
+  bool IsLoopUnswitchingBeneficial(LoopAnalysisInfo* analysis_info) const override {
+    return !IsLoopTooBig(analysis_info,
+                         kScalarHeuristicMaxUnswitchBodySizeInstr,
+                         kScalarHeuristicMaxUnswitchBodySizeBlocks);
+  }
+
  protected:
   bool IsLoopTooBig(LoopAnalysisInfo* loop_analysis_info,
                     size_t instr_threshold,
@@ -318,6 +328,14 @@ class X86_64LoopHelper : public ArchDefaultLoopHelper {
  public:
   explicit X86_64LoopHelper(const CodeGenerator& codegen) : ArchDefaultLoopHelper(codegen) {}
 
+  // Unlike the default heuristics, do not reject loops with long instructions: these do not
+  // need register pairs on a 64-bit target.
+  bool IsLoopNonBeneficialForScalarOpts(LoopAnalysisInfo* loop_analysis_info) const override {
+    return IsLoopTooBig(loop_analysis_info,
+                        kScalarHeuristicMaxBodySizeInstr,
+                        kScalarHeuristicMaxBodySizeBlocks);
+  }
+
   uint32_t GetSIMDUnrollingFactor(HBasicBlock* block,
                                   int64_t trip_count,
                                   uint32_t max_peel,
@@ -407,6 +425,24 @@ uint32_t X86_64LoopHelper::GetUnrollingFactor(HLoopInformation* loop_info,
   return (1 << unrolling_factor);
 }
 
+// Custom implementation of loop helper for riscv64 target. Enables heuristics for scalar loop
+// peeling and unrolling; the target does not support SIMD loop unrolling.
+class Riscv64LoopHelper : public ArchDefaultLoopHelper {
+ public:
+  explicit Riscv64LoopHelper(const CodeGenerator& codegen) : ArchDefaultLoopHelper(codegen) {}
+
+  // Loop's maximum instruction count. Loops with higher count will not be peeled/unrolled.
+  static constexpr uint32_t kRiscv64ScalarHeuristicMaxBodySizeInstr = 30;
+  // Loop's maximum basic block count. Loops with higher count will not be peeled/unrolled.
+  static constexpr uint32_t kRiscv64ScalarHeuristicMaxBodySizeBlocks = 8;
+
+  bool IsLoopNonBeneficialForScalarOpts(LoopAnalysisInfo* loop_analysis_info) const override {
+    return IsLoopTooBig(loop_analysis_info,
+                        kRiscv64ScalarHeuristicMaxBodySizeInstr,
+                        kRiscv64ScalarHeuristicMaxBodySizeBlocks);
+  }
+};
+
 ArchNoOptsLoopHelper* ArchNoOptsLoopHelper::Create(const CodeGenerator& codegen,
                                                    ArenaAllocator* allocator) {
   InstructionSet isa = codegen.GetInstructionSet();
@@ -417,6 +453,9 @@ ArchNoOptsLoopHelper* ArchNoOptsLoopHelper::Create(const CodeGenerator& codegen,
     case InstructionSet::kX86_64: {
       return new (allocator) X86_64LoopHelper(codegen);
     }
+    case InstructionSet::kRiscv64: {
+      return new (allocator) Riscv64LoopHelper(codegen);
+    }
     default: {
       return new (allocator) ArchDefaultLoopHelper(codegen);
     }
@@ -172,6 +172,15 @@ class ArchNoOptsLoopHelper : public ArenaObject<kArenaAllocOptimization> {
     return false;
   }
 
+  // Returns whether it is beneficial to unswitch the loop, i.e. to duplicate it for the two
+  // values of a loop-invariant condition.
+  //
+  // Returns 'false' by default, should be overridden by particular target loop helper.
+  virtual bool IsLoopUnswitchingBeneficial(
+      [[maybe_unused]] LoopAnalysisInfo* analysis_info) const {
+    return false;
+  }
+
   // Returns optimal SIMD unrolling factor for the loop.
   //
   // Returns kNoUnrollingFactor by default, should be overridden by particular target loop helper.
@@ -19,6 +19,7 @@
 #include "arch/arm/instruction_set_features_arm.h"
 #include "arch/arm64/instruction_set_features_arm64.h"
 #include "arch/instruction_set.h"
+#include "arch/riscv64/instruction_set_features_riscv64.h"
 #include "arch/x86/instruction_set_features_x86.h"
 #include "arch/x86_64/instruction_set_features_x86_64.h"
 #include "code_generator.h"
@@ -868,7 +869,7 @@ bool HLoopOptimization::TryOptimizeInnerLoopFinite(LoopNode* node) {
 }
 
 bool HLoopOptimization::OptimizeInnerLoop(LoopNode* node) {
-  return TryOptimizeInnerLoopFinite(node) || TryLoopScalarOpts(node);
+  return TryOptimizeInnerLoopFinite(node) || TryLoopUnswitching(node) || TryLoopScalarOpts(node);
 }
 
 //
@@ -1005,6 +1006,74 @@ bool HLoopOptimization::TryLoopScalarOpts(LoopNode* node) {
          TryUnrollingForBranchPenaltyReduction(&analysis_info) || removed_suspend_check;
 }
 
+//
+// Loop unswitching.
+//
+
+// Returns an HIf of the loop which is not a loop exit and whose condition is loop-invariant,
+// or nullptr if there is none.
+static HIf* FindLoopInvariantBranch(HLoopInformation* loop_info) {
+  for (HBlocksInLoopIterator it(*loop_info); !it.Done(); it.Advance()) {
+    HIf* hif = it.Current()->GetLastInstruction()->AsIfOrNull();
+    if (hif == nullptr) {
+      continue;
+    }
+    HInstruction* cond = hif->InputAt(0);
+    if (!cond->IsConstant() &&
+        !loop_info->Contains(*cond->GetBlock()) &&
+        loop_info->Contains(*hif->IfTrueSuccessor()) &&
+        loop_info->Contains(*hif->IfFalseSuccessor())) {
+      return hif;
+    }
+  }
+  return nullptr;
+}
+
+bool HLoopOptimization::TryLoopUnswitching(LoopNode* node) {
+  HLoopInformation* loop_info = node->loop_info;
+  HIf* hif = FindLoopInvariantBranch(loop_info);
+  if (hif == nullptr) {
+    return false;
+  }
+
+  LoopAnalysisInfo analysis_info(loop_info);
+  LoopAnalysis::CalculateLoopBasicProperties(
+      loop_info, &analysis_info, LoopAnalysisInfo::kUnknownTripCount);
+  if (!arch_loop_helper_->IsLoopUnswitchingBeneficial(&analysis_info)) {
+    return false;
+  }
+
+  // Run 'IsLoopClonable' the last as it might be time-consuming.
+  if (!LoopClonerHelper::IsLoopClonable(loop_info)) {
+    return false;
+  }
+
+  // Version the loop: the original loop is entered through the first successor of the
+  // preheader, its copy through the second one.
+  //
+  //         preheader                       preheader: if (cond)
+  //             |                              /          \
+  //      loop: if (cond)       ==>    loop: if (1)    loop_copy: if (0)
+  //             |                              \          /
+  //           exit                                exit
+  //
+  HInstruction* cond = hif->InputAt(0);
+  HBasicBlock* preheader = loop_info->GetPreHeader();
+  LoopClonerSimpleHelper helper(loop_info, &induction_range_);
+  helper.DoVersioning();
+  DCHECK_EQ(preheader->GetSuccessors().size(), 2u);
+
+  HInstruction* preheader_goto = preheader->GetLastInstruction();
+  DCHECK(preheader_goto->IsGoto());
+  HIf* version_if = new (global_allocator_) HIf(cond, preheader_goto->GetDexPc());
+  preheader->ReplaceAndRemoveInstructionWith(preheader_goto, version_if);
+
+  // Statically evaluate the condition in both versions; dead code elimination removes the
+  // branches that are no longer taken.
+  TryToEvaluateIfCondition(version_if, graph_);
+  return true;
+}
+
 //
 // Loop vectorization. The implementation is based on the book by Aart J.C. Bik:
 // "The Software Vectorization Handbook. Applying Multimedia Extensions for Maximum Performance."
@@ -1839,6 +1908,51 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
         }  // switch type
       }
       return false;
+    case InstructionSet::kRiscv64:
+      // Allow vectorization for devices with the "V" extension or the T-Head vendor
+      // "XTheadVector" (RVV 0.7.1) extension. The code generator uses a fixed vector
+      // length of 128 bits, the minimum VLEN of the application processor profiles.
+      if (features->AsRiscv64InstructionSetFeatures()->HasVector() ||
+          features->AsRiscv64InstructionSetFeatures()->HasXTheadVector()) {
+        DCHECK_EQ(simd_register_size_, 16u);
+        switch (type) {
+          case DataType::Type::kBool:
+          case DataType::Type::kUint8:
+          case DataType::Type::kInt8:
+            *restrictions |= kNoDiv |
+                             kNoSignedHAdd |
+                             kNoUnsignedHAdd |
+                             kNoUnroundedHAdd |
+                             kNoSAD |
+                             kNoDotProd;
+            return TrySetVectorLength(type, 16);
+          case DataType::Type::kUint16:
+          case DataType::Type::kInt16:
+            *restrictions |= kNoDiv |
+                             kNoStringCharAt |
+                             kNoSignedHAdd |
+                             kNoUnsignedHAdd |
+                             kNoUnroundedHAdd |
+                             kNoSAD |
+                             kNoDotProd;
+            return TrySetVectorLength(type, 8);
+          case DataType::Type::kInt32:
+            *restrictions |= kNoDiv | kNoSAD | kNoDotProd;
+            return TrySetVectorLength(type, 4);
+          case DataType::Type::kInt64:
+            *restrictions |= kNoDiv | kNoSAD;
+            return TrySetVectorLength(type, 2);
+          case DataType::Type::kFloat32:
+            *restrictions |= kNoReduction;
+            return TrySetVectorLength(type, 4);
+          case DataType::Type::kFloat64:
+            *restrictions |= kNoReduction;
+            return TrySetVectorLength(type, 2);
+          default:
+            break;
+        }  // switch type
+      }
+      return false;
     default:
       return false;
   }  // switch instruction set
@@ -199,6 +199,11 @@ class HLoopOptimization : public HOptimization {
   // Tries to apply scalar loop optimizations.
   bool TryLoopScalarOpts(LoopNode* node);
 
+  // Tries to unswitch the loop on a loop-invariant condition of a branch in the loop body:
+  // the loop is versioned and the preheader selects the version by evaluating the condition,
+  // which then becomes a constant in each version. Returns whether transformation happened.
+  bool TryLoopUnswitching(LoopNode* node);
+
   //
   // Vectorization analysis and synthesis.
   //
@@ -904,6 +904,7 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
   ArenaSet<ArtMethod*> cha_single_implementation_list_;
 
   friend class SsaBuilder;           // For caching constants.
+  friend class RegisterAllocatorLocal;  // For the linear order.
   friend class SsaLivenessAnalysis;  // For the linear order.
   friend class HInliner;             // For the reverse post order.
   ART_FRIEND_TEST(GraphTest, IfSuccessorSimpleJoinBlock1);
@@ -5336,6 +5337,7 @@ class HNewArray final : public HExpression<2> {
     SetRawInputAt(0, cls);
     SetRawInputAt(1, length);
     SetPackedField<ComponentSizeShiftField>(component_size_shift);
+    SetPackedFlag<kFlagPretenured>(false);
   }
 
   bool IsClonable() const override { return true; }
@@ -5361,6 +5363,11 @@ class HNewArray final : public HExpression<2> {
     return GetPackedField<ComponentSizeShiftField>();
   }
 
+  // Whether the array is allocated in the non-moving space, as the JIT found the objects
+  // allocated by this instruction to be long-lived.
+  bool IsPretenured() const { return GetPackedFlag<kFlagPretenured>(); }
+  void SetPretenured() { SetPackedFlag<kFlagPretenured>(true); }
+
   DECLARE_INSTRUCTION(NewArray);
 
  protected:
@@ -5369,8 +5376,9 @@ class HNewArray final : public HExpression<2> {
  private:
   static constexpr size_t kFieldComponentSizeShift = kNumberOfGenericPackedBits;
   static constexpr size_t kFieldComponentSizeShiftSize = MinimumBitsToStore(3u);
-  static constexpr size_t kNumberOfNewArrayPackedBits =
+  static constexpr size_t kFlagPretenured =
       kFieldComponentSizeShift + kFieldComponentSizeShiftSize;
+  static constexpr size_t kNumberOfNewArrayPackedBits = kFlagPretenured + 1;
   static_assert(kNumberOfNewArrayPackedBits <= kMaxNumberOfPackedBits, "Too many packed fields.");
   using ComponentSizeShiftField =
       BitField<size_t, kFieldComponentSizeShift, kFieldComponentSizeShiftSize>;
@@ -35,6 +35,7 @@
 #endif
 
 #include "bounds_check_elimination.h"
+#include "box_unbox_elimination.h"
 #include "cha_guard_optimization.h"
 #include "code_sinking.h"
 #include "constant_folding.h"
@@ -95,6 +96,8 @@ const char* OptimizationPassName(OptimizationPass pass) {
       return CodeSinking::kCodeSinkingPassName;
     case OptimizationPass::kConstructorFenceRedundancyElimination:
       return ConstructorFenceRedundancyElimination::kCFREPassName;
+    case OptimizationPass::kBoxUnboxElimination:
+      return BoxUnboxElimination::kBoxUnboxEliminationPassName;
     case OptimizationPass::kScheduling:
       return HInstructionScheduling::kInstructionSchedulingPassName;
     case OptimizationPass::kWriteBarrierElimination:
@@ -133,6 +136,7 @@ const char* OptimizationPassName(OptimizationPass pass) {
 
 OptimizationPass OptimizationPassByName(const std::string& pass_name) {
   X(OptimizationPass::kBoundsCheckElimination);
+  X(OptimizationPass::kBoxUnboxElimination);
   X(OptimizationPass::kCHAGuardOptimization);
   X(OptimizationPass::kCodeSinking);
   X(OptimizationPass::kConstantFolding);
@@ -274,6 +278,9 @@ ArenaVector<HOptimization*> ConstructOptimizations(
       case OptimizationPass::kConstructorFenceRedundancyElimination:
         opt = new (allocator) ConstructorFenceRedundancyElimination(graph, stats, pass_name);
         break;
+      case OptimizationPass::kBoxUnboxElimination:
+        opt = new (allocator) BoxUnboxElimination(graph, stats, pass_name);
+        break;
       case OptimizationPass::kLoadStoreElimination:
         opt = new (allocator) LoadStoreElimination(graph, stats, pass_name);
         break;
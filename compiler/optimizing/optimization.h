@@ -70,6 +70,7 @@ enum class OptimizationPass {
   kAggressiveConstantFolding,
   kAggressiveInstructionSimplifier,
   kBoundsCheckElimination,
+  kBoxUnboxElimination,
   kCHAGuardOptimization,
   kCodeSinking,
   kConstantFolding,
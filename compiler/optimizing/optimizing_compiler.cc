@@ -30,9 +30,11 @@
 #include "base/macros.h"
 #include "base/mutex.h"
 #include "base/scoped_arena_allocator.h"
+#include "base/time_utils.h"
 #include "base/timing_logger.h"
 #include "builder.h"
 #include "code_generator.h"
+#include "code_quality_report.h"
 #include "compiler.h"
 #include "debug/elf_debug_writer.h"
 #include "debug/method_debug_info.h"
@@ -52,9 +54,11 @@
 #include "nodes.h"
 #include "oat_quick_method_header.h"
 #include "optimizing/write_barrier_elimination.h"
+#include "pass_profile.h"
 #include "prepare_for_register_allocation.h"
 #include "reference_type_propagation.h"
 #include "register_allocator_linear_scan.h"
+#include "register_allocator_local.h"
 #include "select_generator.h"
 #include "ssa_builder.h"
 #include "ssa_liveness_analysis.h"
@@ -81,9 +85,19 @@ class PassObserver : public ValueObject {
   PassObserver(HGraph* graph,
                CodeGenerator* codegen,
                std::ostream* visualizer_output,
-               const CompilerOptions& compiler_options)
+               const CompilerOptions& compiler_options,
+               OptimizingCompilerStats* compilation_stats,
+               PassProfile* pass_profile,
+               uint32_t dex_code_units)
       : graph_(graph),
         last_seen_graph_size_(0),
+        compilation_stats_(compilation_stats),
+        pass_profile_(pass_profile),
+        dex_code_units_(dex_code_units),
+        method_start_cpu_ns_(pass_profile != nullptr ? ThreadCpuNanoTime() : 0u),
+        pass_start_cpu_ns_(0u),
+        pass_start_graph_bytes_(0u),
+        pass_start_stack_peak_bytes_(0u),
         cached_method_name_(),
         timing_logger_enabled_(compiler_options.GetDumpPassTimings()),
         timing_logger_(timing_logger_enabled_ ? GetMethodName() : "", true, true),
@@ -106,6 +120,10 @@ class PassObserver : public ValueObject {
   }
 
   ~PassObserver() {
+    if (pass_profile_ != nullptr) {
+      pass_profile_->RecordMethod(
+          graph_, dex_code_units_, ThreadCpuNanoTime() - method_start_cpu_ns_, pass_samples_);
+    }
     if (timing_logger_enabled_) {
       LOG(INFO) << "TIMINGS " << GetMethodName();
       LOG(INFO) << Dumpable<TimingLogger>(timing_logger_);
@@ -144,6 +162,13 @@ class PassObserver : public ValueObject {
     if (timing_logger_enabled_) {
       timing_logger_.StartTiming(pass_name);
     }
+    if (compilation_stats_ != nullptr || pass_profile_ != nullptr) {
+      pass_start_graph_bytes_ = graph_->GetAllocator()->BytesUsed();
+      pass_start_stack_peak_bytes_ = graph_->GetArenaStack()->ApproximatePeakBytes();
+    }
+    if (pass_profile_ != nullptr) {
+      pass_start_cpu_ns_ = ThreadCpuNanoTime();
+    }
   }
 
   void FlushVisualizer() {
@@ -158,6 +183,22 @@ class PassObserver : public ValueObject {
     if (timing_logger_enabled_) {
       timing_logger_.EndTiming();
     }
+    if (pass_profile_ != nullptr) {
+      uint64_t cpu_ns = ThreadCpuNanoTime() - pass_start_cpu_ns_;
+      pass_samples_.push_back({
+          pass_name,
+          cpu_ns,
+          graph_->GetAllocator()->BytesUsed() - pass_start_graph_bytes_,
+          graph_->GetArenaStack()->ApproximatePeakBytes() - pass_start_stack_peak_bytes_});
+    }
+    if (compilation_stats_ != nullptr) {
+      // The ArenaStack only tracks its high-water mark, so a pass that stays below the peak of
+      // the previous passes is recorded as not growing it.
+      compilation_stats_->RecordPassArenaBytes(
+          pass_name,
+          graph_->GetAllocator()->BytesUsed() - pass_start_graph_bytes_,
+          graph_->GetArenaStack()->ApproximatePeakBytes() - pass_start_stack_peak_bytes_);
+    }
     if (visualizer_enabled_) {
       visualizer_.DumpGraph(pass_name, /* is_after_pass= */ true, graph_in_bad_state_);
       FlushVisualizer();
@@ -199,6 +240,18 @@ class PassObserver : public ValueObject {
   HGraph* const graph_;
   size_t last_seen_graph_size_;
 
+  // Arena usage and CPU time at the start of the current pass, tracked only when collecting
+  // stats or the pass profile. The pass profile gets the samples of all passes of the method
+  // at once, so that it is locked once per method.
+  OptimizingCompilerStats* const compilation_stats_;
+  PassProfile* const pass_profile_;
+  const uint32_t dex_code_units_;
+  const uint64_t method_start_cpu_ns_;
+  uint64_t pass_start_cpu_ns_;
+  size_t pass_start_graph_bytes_;
+  size_t pass_start_stack_peak_bytes_;
+  std::vector<PassProfile::PassSample> pass_samples_;
+
   std::string cached_method_name_;
 
   bool timing_logger_enabled_;
@@ -379,6 +432,10 @@ class OptimizingCompiler final : public Compiler {
 
   std::unique_ptr<OptimizingCompilerStats> compilation_stats_;
 
+  std::unique_ptr<PassProfile> pass_profile_;
+
+  std::unique_ptr<CodeQualityReport> code_quality_report_;
+
   std::unique_ptr<std::ostream> visualizer_output_;
 
   DISALLOW_COPY_AND_ASSIGN(OptimizingCompiler);
@@ -400,12 +457,34 @@ OptimizingCompiler::OptimizingCompiler(const CompilerOptions& compiler_options,
   if (compiler_options.GetDumpStats()) {
     compilation_stats_.reset(new OptimizingCompilerStats());
   }
+  if (!compiler_options.GetDumpPassProfileFileName().empty()) {
+    pass_profile_.reset(new PassProfile(compiler_options.GetDumpPassProfileMethods()));
+  }
+  if (!compiler_options.GetDumpCodeQualityFileName().empty()) {
+    code_quality_report_.reset(new CodeQualityReport(compiler_options.GetInstructionSet()));
+  }
 }
 
 OptimizingCompiler::~OptimizingCompiler() {
   if (compilation_stats_.get() != nullptr) {
     compilation_stats_->Log();
   }
+  if (pass_profile_.get() != nullptr) {
+    const std::string& file_name = GetCompilerOptions().GetDumpPassProfileFileName();
+    std::ofstream output(file_name);
+    pass_profile_->Dump(output);
+    if (!output.good()) {
+      PLOG(ERROR) << "Failed to write the pass profile to " << file_name;
+    }
+  }
+  if (code_quality_report_.get() != nullptr) {
+    const std::string& file_name = GetCompilerOptions().GetDumpCodeQualityFileName();
+    std::ofstream output(file_name);
+    code_quality_report_->Dump(output);
+    if (!output.good()) {
+      PLOG(ERROR) << "Failed to write the code quality report to " << file_name;
+    }
+  }
 }
 
 void OptimizingCompiler::DumpInstructionSetFeaturesToCfg() const {
@@ -438,6 +517,7 @@ static bool IsInstructionSetSupported(InstructionSet instruction_set) {
   return instruction_set == InstructionSet::kArm
       || instruction_set == InstructionSet::kArm64
       || instruction_set == InstructionSet::kThumb2
+      || instruction_set == InstructionSet::kRiscv64
       || instruction_set == InstructionSet::kX86
       || instruction_set == InstructionSet::kX86_64;
 }
@@ -518,6 +598,18 @@ bool OptimizingCompiler::RunArchOptimizations(HGraph* graph,
                               arm64_optimizations);
     }
 #endif
+#ifdef ART_ENABLE_CODEGEN_riscv64
+    case InstructionSet::kRiscv64: {
+      OptimizationDef riscv64_optimizations[] = {
+        OptDef(OptimizationPass::kScheduling)
+      };
+      return RunOptimizations(graph,
+                              codegen,
+                              dex_compilation_unit,
+                              pass_observer,
+                              riscv64_optimizations);
+    }
+#endif
 #ifdef ART_ENABLE_CODEGEN_x86
     case InstructionSet::kX86: {
       OptimizationDef x86_optimizations[] = {
@@ -557,6 +649,183 @@ bool OptimizingCompiler::RunArchOptimizations(HGraph* graph,
   }
 }
 
+#ifdef ART_ENABLE_CODEGEN_riscv64
+// The riscv64 code generator is still incomplete. Check that the graph only uses
+// instructions (and load kinds) it can handle, so that other methods are left to
+// the interpreter instead of hitting an unimplemented visitor.
+bool CanAssembleGraphForRiscv64(HGraph* graph) {
+  for (HBasicBlock* block : graph->GetPostOrder()) {
+    // Phis have no code to emit, so check only non-Phi instructions.
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      switch (instruction->GetKind()) {
+        case HInstruction::kExit:
+        case HInstruction::kGoto:
+        case HInstruction::kParameterValue:
+        case HInstruction::kReturn:
+        case HInstruction::kReturnVoid:
+        case HInstruction::kSuspendCheck:
+        case HInstruction::kTryBoundary:
+        case HInstruction::kNop:
+        case HInstruction::kPackedSwitch:
+        case HInstruction::kThrow:
+        case HInstruction::kDoubleConstant:
+        case HInstruction::kFloatConstant:
+        case HInstruction::kIntConstant:
+        case HInstruction::kLongConstant:
+        case HInstruction::kNullConstant:
+        case HInstruction::kCurrentMethod:
+        case HInstruction::kAdd:
+        case HInstruction::kSub:
+        case HInstruction::kMul:
+        case HInstruction::kDiv:
+        case HInstruction::kRem:
+        case HInstruction::kAnd:
+        case HInstruction::kOr:
+        case HInstruction::kXor:
+        case HInstruction::kShl:
+        case HInstruction::kShr:
+        case HInstruction::kUShr:
+        case HInstruction::kRor:
+        case HInstruction::kNeg:
+        case HInstruction::kNot:
+        case HInstruction::kBooleanNot:
+        case HInstruction::kAbs:
+        case HInstruction::kMin:
+        case HInstruction::kMax:
+        case HInstruction::kCompare:
+        case HInstruction::kEqual:
+        case HInstruction::kNotEqual:
+        case HInstruction::kLessThan:
+        case HInstruction::kLessThanOrEqual:
+        case HInstruction::kGreaterThan:
+        case HInstruction::kGreaterThanOrEqual:
+        case HInstruction::kBelow:
+        case HInstruction::kBelowOrEqual:
+        case HInstruction::kAbove:
+        case HInstruction::kAboveOrEqual:
+        case HInstruction::kIf:
+        case HInstruction::kSelect:
+        case HInstruction::kTypeConversion:
+        case HInstruction::kDivZeroCheck:
+        case HInstruction::kNullCheck:
+        case HInstruction::kBoundsCheck:
+        case HInstruction::kArrayLength:
+        case HInstruction::kInstanceFieldSet:
+        case HInstruction::kStaticFieldSet:
+        case HInstruction::kMemoryBarrier:
+        case HInstruction::kConstructorFence:
+        case HInstruction::kMonitorOperation:
+        case HInstruction::kLoadException:
+        case HInstruction::kClearException:
+        case HInstruction::kInvokeVirtual:
+        case HInstruction::kInvokePolymorphic:
+        case HInstruction::kInvokeCustom:
+        case HInstruction::kLoadMethodHandle:
+        case HInstruction::kLoadMethodType:
+        case HInstruction::kParallelMove:
+        case HInstruction::kArrayGet:
+        case HInstruction::kInstanceFieldGet:
+        case HInstruction::kStaticFieldGet:
+        case HInstruction::kPredicatedInstanceFieldGet:
+        case HInstruction::kUnresolvedInstanceFieldGet:
+        case HInstruction::kUnresolvedInstanceFieldSet:
+        case HInstruction::kUnresolvedStaticFieldGet:
+        case HInstruction::kUnresolvedStaticFieldSet:
+        case HInstruction::kArraySet:
+        case HInstruction::kNewArray:
+        case HInstruction::kNewInstance:
+        case HInstruction::kInstanceOf:
+        case HInstruction::kCheckCast:
+        case HInstruction::kClinitCheck:
+        case HInstruction::kClassTableGet:
+        case HInstruction::kInvokeInterface:
+        case HInstruction::kInvokeUnresolved:
+        case HInstruction::kDeoptimize:
+        case HInstruction::kShouldDeoptimizeFlag:
+        case HInstruction::kMethodEntryHook:
+        case HInstruction::kMethodExitHook:
+        case HInstruction::kStringBuilderAppend:
+        case HInstruction::kVecReplicateScalar:
+        case HInstruction::kVecExtractScalar:
+        case HInstruction::kVecReduce:
+        case HInstruction::kVecCnv:
+        case HInstruction::kVecNeg:
+        case HInstruction::kVecAbs:
+        case HInstruction::kVecNot:
+        case HInstruction::kVecAdd:
+        case HInstruction::kVecSub:
+        case HInstruction::kVecMul:
+        case HInstruction::kVecDiv:
+        case HInstruction::kVecMin:
+        case HInstruction::kVecMax:
+        case HInstruction::kVecAnd:
+        case HInstruction::kVecOr:
+        case HInstruction::kVecXor:
+        case HInstruction::kVecShl:
+        case HInstruction::kVecShr:
+        case HInstruction::kVecUShr:
+        case HInstruction::kVecSetScalars:
+        case HInstruction::kVecMultiplyAccumulate:
+        case HInstruction::kVecLoad:
+        case HInstruction::kVecStore:
+          break;
+        case HInstruction::kLoadClass: {
+          HLoadClass* load_class = instruction->AsLoadClass();
+          HLoadClass::LoadKind load_kind = load_class->GetLoadKind();
+          if (load_kind == HLoadClass::LoadKind::kRuntimeCall ||
+              load_kind == HLoadClass::LoadKind::kBootImageLinkTimePcRelative ||
+              load_kind == HLoadClass::LoadKind::kBootImageRelRo ||
+              load_kind == HLoadClass::LoadKind::kJitBootImageAddress ||
+              load_kind == HLoadClass::LoadKind::kJitTableAddress) {
+            break;
+          }
+          if (load_kind == HLoadClass::LoadKind::kReferrersClass ||
+              load_kind == HLoadClass::LoadKind::kBssEntry ||
+              load_kind == HLoadClass::LoadKind::kBssEntryPublic ||
+              load_kind == HLoadClass::LoadKind::kBssEntryPackage) {
+            break;
+          }
+          return false;
+        }
+        case HInstruction::kLoadString: {
+          HLoadString::LoadKind load_kind = instruction->AsLoadString()->GetLoadKind();
+          if (load_kind == HLoadString::LoadKind::kRuntimeCall ||
+              load_kind == HLoadString::LoadKind::kBootImageLinkTimePcRelative ||
+              load_kind == HLoadString::LoadKind::kBootImageRelRo ||
+              load_kind == HLoadString::LoadKind::kJitBootImageAddress ||
+              load_kind == HLoadString::LoadKind::kJitTableAddress ||
+              load_kind == HLoadString::LoadKind::kBssEntry) {
+            break;
+          }
+          return false;
+        }
+        case HInstruction::kInvokeStaticOrDirect: {
+          HInvokeStaticOrDirect* invoke = instruction->AsInvokeStaticOrDirect();
+          switch (invoke->GetMethodLoadKind()) {
+            case MethodLoadKind::kRecursive:
+            case MethodLoadKind::kStringInit:
+            case MethodLoadKind::kBootImageLinkTimePcRelative:
+            case MethodLoadKind::kBootImageRelRo:
+            case MethodLoadKind::kBssEntry:
+            case MethodLoadKind::kJitDirectAddress:
+            case MethodLoadKind::kRuntimeCall:
+              break;
+            default:
+              return false;
+          }
+          break;
+        }
+        default:
+          // Unimplemented instruction.
+          return false;
+      }
+    }
+  }
+  return true;
+}
+#endif
+
 NO_INLINE  // Avoid increasing caller's frame size by large stack-allocated objects.
 static void AllocateRegisters(HGraph* graph,
                               CodeGenerator* codegen,
@@ -568,6 +837,18 @@ static void AllocateRegisters(HGraph* graph,
                     pass_observer);
     PrepareForRegisterAllocation(graph, codegen->GetCompilerOptions(), stats).Run();
   }
+  if (strategy == RegisterAllocator::kRegisterAllocatorLocal) {
+    // Baseline code is replaced by optimized code once it is hot, so skipping the liveness
+    // analysis is worth the slower code.
+    if (graph->IsCompilingBaseline() &&
+        RegisterAllocatorLocal::CanAllocateRegistersFor(*graph, codegen->GetInstructionSet())) {
+      ScopedArenaAllocator local_allocator(graph->GetArenaStack());
+      PassScope scope(RegisterAllocator::kRegisterAllocatorPassName, pass_observer);
+      RegisterAllocatorLocal(&local_allocator, codegen).AllocateRegisters();
+      return;
+    }
+    strategy = RegisterAllocator::kRegisterAllocatorLinearScan;
+  }
   // Use local allocator shared by SSA liveness analysis and register allocator.
   // (Register allocator creates new objects in the liveness data.)
   ScopedArenaAllocator local_allocator(graph->GetArenaStack());
@@ -629,6 +910,9 @@ void OptimizingCompiler::RunOptimizations(HGraph* graph,
     OptDef(OptimizationPass::kInstructionSimplifier,
            "instruction_simplifier$after_inlining",
            OptimizationPass::kInliner),
+    OptDef(OptimizationPass::kBoxUnboxElimination,
+           "box_unbox_elimination$after_inlining",
+           OptimizationPass::kInliner),
     OptDef(OptimizationPass::kDeadCodeElimination,
            "dead_code_elimination$after_inlining",
            OptimizationPass::kInliner),
@@ -706,6 +990,13 @@ CompiledMethod* OptimizingCompiler::Emit(ArenaAllocator* allocator,
                                          const dex::CodeItem* code_item_for_osr_check) const {
   ArenaVector<linker::LinkerPatch> linker_patches = EmitAndSortLinkerPatches(codegen);
   ScopedArenaVector<uint8_t> stack_map = codegen->BuildStackMaps(code_item_for_osr_check);
+  if (code_quality_report_ != nullptr) {
+    uint32_t dex_code_units = (code_item_for_osr_check != nullptr)
+        ? CodeItemInstructionAccessor(codegen->GetGraph()->GetDexFile(), code_item_for_osr_check)
+              .InsnsSizeInCodeUnits()
+        : 0u;
+    code_quality_report_->RecordMethod(codegen, dex_code_units, stack_map.size());
+  }
 
   CompiledCodeStorage* storage = GetCompiledCodeStorage();
   CompiledMethod* compiled_method = storage->CreateCompiledMethod(
@@ -826,7 +1117,10 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
   PassObserver pass_observer(graph,
                              codegen.get(),
                              visualizer_output_.get(),
-                             compiler_options);
+                             compiler_options,
+                             compilation_stats_.get(),
+                             pass_profile_.get(),
+                             dex_compilation_unit.GetCodeItemAccessor().InsnsSizeInCodeUnits());
 
   {
     VLOG(compiler) << "Building " << pass_observer.GetMethodName();
@@ -886,8 +1180,21 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
     WriteBarrierElimination(graph, compilation_stats_.get()).Run();
   }
 
+#ifdef ART_ENABLE_CODEGEN_riscv64
+  // TODO(riscv64): Remove this check when all instructions are implemented.
+  if (instruction_set == InstructionSet::kRiscv64 && !CanAssembleGraphForRiscv64(graph)) {
+    MaybeRecordStat(compilation_stats_.get(), MethodCompilationStat::kNotCompiledUnsupportedIsa);
+    return nullptr;
+  }
+#endif
+
   RegisterAllocator::Strategy regalloc_strategy =
     compiler_options.GetRegisterAllocationStrategy();
+  if (compiler_options.IsJitCompiler() &&
+      regalloc_strategy != RegisterAllocator::kRegisterAllocatorLocal) {
+    // Compilation time matters more than code quality for the JIT.
+    regalloc_strategy = RegisterAllocator::kRegisterAllocatorLinearScan;
+  }
   AllocateRegisters(graph,
                     codegen.get(),
                     &pass_observer,
@@ -950,7 +1257,10 @@ CodeGenerator* OptimizingCompiler::TryCompileIntrinsic(
   PassObserver pass_observer(graph,
                              codegen.get(),
                              visualizer_output_.get(),
-                             compiler_options);
+                             compiler_options,
+                             compilation_stats_.get(),
+                             pass_profile_.get(),
+                             dex_compilation_unit.GetCodeItemAccessor().InsnsSizeInCodeUnits());
 
   {
     VLOG(compiler) << "Building intrinsic graph " << pass_observer.GetMethodName();
@@ -981,6 +1291,13 @@ CodeGenerator* OptimizingCompiler::TryCompileIntrinsic(
     WriteBarrierElimination(graph, compilation_stats_.get()).Run();
   }
 
+#ifdef ART_ENABLE_CODEGEN_riscv64
+  // TODO(riscv64): Remove this check when all instructions are implemented.
+  if (instruction_set == InstructionSet::kRiscv64 && !CanAssembleGraphForRiscv64(graph)) {
+    return nullptr;
+  }
+#endif
+
   AllocateRegisters(graph,
                     codegen.get(),
                     &pass_observer,
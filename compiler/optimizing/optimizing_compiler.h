@@ -28,12 +28,18 @@ class CompiledCodeStorage;
 class Compiler;
 class CompilerOptions;
 class DexFile;
+class HGraph;
 
 Compiler* CreateOptimizingCompiler(const CompilerOptions& compiler_options,
                                    CompiledCodeStorage* storage);
 
 bool EncodeArtMethodInInlineInfo(ArtMethod* method);
 
+#ifdef ART_ENABLE_CODEGEN_riscv64
+// Whether the riscv64 code generator implements all instructions of `graph`.
+bool CanAssembleGraphForRiscv64(HGraph* graph);
+#endif
+
 }  // namespace art
 
 #endif  // ART_COMPILER_OPTIMIZING_OPTIMIZING_COMPILER_H_
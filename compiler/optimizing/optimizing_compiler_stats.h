@@ -17,9 +17,13 @@
 #ifndef ART_COMPILER_OPTIMIZING_OPTIMIZING_COMPILER_STATS_H_
 #define ART_COMPILER_OPTIMIZING_OPTIMIZING_COMPILER_STATS_H_
 
+#include <algorithm>
 #include <atomic>
+#include <cstring>
 #include <iomanip>
+#include <map>
 #include <string>
+#include <string_view>
 #include <type_traits>
 
 #include <android-base/logging.h>
@@ -36,6 +40,7 @@ enum class MethodCompilationStat {
   kCompiledNativeStub,
   kCompiledIntrinsic,
   kCompiledBytecode,
+  kCompiledHotHugeMethod,
   kCHAInline,
   kInlinedInvoke,
   kInlinedLastInvoke,
@@ -133,6 +138,10 @@ enum class MethodCompilationStat {
   kPredicatedLoadAdded,
   kPredicatedStoreAdded,
   kDevirtualized,
+  kBoxUnboxEliminated,
+  kRemovedBoundsCheckWithCallerRange,
+  kReadOnlyCalleeInvoke,
+  kPretenuredAllocation,
   kLastStat
 };
 std::ostream& operator<<(std::ostream& os, MethodCompilationStat rhs);
@@ -156,6 +165,20 @@ class OptimizingCompilerStats {
     return compile_stats_[stat_index];
   }
 
+  // Record the arena memory used by one run of the pass `pass_name`: the `graph_bytes` it
+  // allocated from the graph's ArenaAllocator and the `stack_peak_bytes` by which it raised the
+  // peak of the graph's ArenaStack. Pass names are string literals that outlive the stats.
+  void RecordPassArenaBytes(const char* pass_name, size_t graph_bytes, size_t stack_peak_bytes) {
+    PassArenaStats* entry = FindOrClaimPassArenaStats(pass_name);
+    if (entry == nullptr) {
+      return;
+    }
+    entry->runs.fetch_add(1u, std::memory_order_relaxed);
+    entry->total_graph_bytes.fetch_add(graph_bytes, std::memory_order_relaxed);
+    UpdateMax(&entry->max_graph_bytes, graph_bytes);
+    UpdateMax(&entry->max_stack_peak_bytes, stack_peak_bytes);
+  }
+
   void Log() const {
     uint32_t compiled_intrinsics = GetStat(MethodCompilationStat::kCompiledIntrinsic);
     uint32_t compiled_native_stubs = GetStat(MethodCompilationStat::kCompiledNativeStub);
@@ -183,6 +206,7 @@ class OptimizingCompilerStats {
               << compile_stats_[i];
         }
       }
+      LogPassArenaStats();
     }
   }
 
@@ -193,16 +217,110 @@ class OptimizingCompilerStats {
         other_stats->RecordStat(static_cast<MethodCompilationStat>(i), count);
       }
     }
+    for (const PassArenaStats& entry : pass_arena_stats_) {
+      const char* pass_name = entry.pass_name.load(std::memory_order_acquire);
+      if (pass_name == nullptr) {
+        break;
+      }
+      PassArenaStats* other_entry = other_stats->FindOrClaimPassArenaStats(pass_name);
+      if (other_entry != nullptr) {
+        other_entry->runs.fetch_add(entry.runs.load(std::memory_order_relaxed),
+                                    std::memory_order_relaxed);
+        other_entry->total_graph_bytes.fetch_add(
+            entry.total_graph_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        UpdateMax(&other_entry->max_graph_bytes,
+                  entry.max_graph_bytes.load(std::memory_order_relaxed));
+        UpdateMax(&other_entry->max_stack_peak_bytes,
+                  entry.max_stack_peak_bytes.load(std::memory_order_relaxed));
+      }
+    }
   }
 
   void Reset() {
     for (std::atomic<uint32_t>& stat : compile_stats_) {
       stat = 0u;
     }
+    for (PassArenaStats& entry : pass_arena_stats_) {
+      entry.pass_name.store(nullptr, std::memory_order_relaxed);
+      entry.runs.store(0u, std::memory_order_relaxed);
+      entry.total_graph_bytes.store(0u, std::memory_order_relaxed);
+      entry.max_graph_bytes.store(0u, std::memory_order_relaxed);
+      entry.max_stack_peak_bytes.store(0u, std::memory_order_relaxed);
+    }
   }
 
  private:
+  // Enough for all passes of the optimizing compiler, including the renamed instances.
+  static constexpr size_t kMaxPassArenaStats = 128u;
+
+  struct PassArenaStats {
+    std::atomic<const char*> pass_name;
+    std::atomic<uint64_t> runs;
+    std::atomic<uint64_t> total_graph_bytes;
+    std::atomic<uint64_t> max_graph_bytes;
+    std::atomic<uint64_t> max_stack_peak_bytes;
+  };
+
+  static void UpdateMax(std::atomic<uint64_t>* max_value, uint64_t value) {
+    uint64_t old_value = max_value->load(std::memory_order_relaxed);
+    while (value > old_value &&
+           !max_value->compare_exchange_weak(old_value, value, std::memory_order_relaxed)) {
+    }
+  }
+
+  // Entries are claimed in order and never released until `Reset()`, so the lookup can stop at
+  // the first unclaimed entry. Returns null if all entries are taken by other passes.
+  PassArenaStats* FindOrClaimPassArenaStats(const char* pass_name) {
+    for (PassArenaStats& entry : pass_arena_stats_) {
+      const char* entry_name = entry.pass_name.load(std::memory_order_acquire);
+      if (entry_name == nullptr &&
+          entry.pass_name.compare_exchange_strong(entry_name,
+                                                  pass_name,
+                                                  std::memory_order_acq_rel,
+                                                  std::memory_order_acquire)) {
+        return &entry;
+      }
+      if (entry_name == pass_name || strcmp(entry_name, pass_name) == 0) {
+        return &entry;
+      }
+    }
+    return nullptr;
+  }
+
+  void LogPassArenaStats() const {
+    // Print the passes sorted by name.
+    struct Totals {
+      uint64_t runs = 0u;
+      uint64_t total_graph_bytes = 0u;
+      uint64_t max_graph_bytes = 0u;
+      uint64_t max_stack_peak_bytes = 0u;
+    };
+    std::map<std::string_view, Totals> totals;
+    for (const PassArenaStats& entry : pass_arena_stats_) {
+      const char* pass_name = entry.pass_name.load(std::memory_order_acquire);
+      if (pass_name == nullptr) {
+        break;
+      }
+      Totals& pass_totals = totals[pass_name];
+      pass_totals.runs += entry.runs.load(std::memory_order_relaxed);
+      pass_totals.total_graph_bytes += entry.total_graph_bytes.load(std::memory_order_relaxed);
+      pass_totals.max_graph_bytes = std::max<uint64_t>(
+          pass_totals.max_graph_bytes, entry.max_graph_bytes.load(std::memory_order_relaxed));
+      pass_totals.max_stack_peak_bytes = std::max<uint64_t>(
+          pass_totals.max_stack_peak_bytes,
+          entry.max_stack_peak_bytes.load(std::memory_order_relaxed));
+    }
+    for (const auto& [pass_name, pass_totals] : totals) {
+      LOG(INFO) << "OptArenaStat#" << pass_name << ": runs=" << pass_totals.runs
+          << " graph_bytes_avg="
+          << pass_totals.total_graph_bytes / std::max<uint64_t>(pass_totals.runs, 1u)
+          << " graph_bytes_max=" << pass_totals.max_graph_bytes
+          << " stack_peak_growth_max=" << pass_totals.max_stack_peak_bytes;
+    }
+  }
+
   std::atomic<uint32_t> compile_stats_[static_cast<size_t>(MethodCompilationStat::kLastStat)];
+  PassArenaStats pass_arena_stats_[kMaxPassArenaStats];
 
   DISALLOW_COPY_AND_ASSIGN(OptimizingCompilerStats);
 };
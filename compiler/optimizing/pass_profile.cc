@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pass_profile.h"
+
+#include <algorithm>
+#include <iomanip>
+
+#include "nodes.h"
+#include "thread-current-inl.h"
+
+namespace art HIDDEN {
+
+// Method names may contain any character of a dex string.
+void DumpJsonString(std::ostream& os, std::string_view str) {
+  os << '"';
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      os << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20u) {
+      os << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+         << static_cast<uint32_t>(c) << std::dec << std::setfill(' ');
+    } else {
+      os << c;
+    }
+  }
+  os << '"';
+}
+
+PassProfile::PassProfile(size_t max_slowest_methods)
+    : max_slowest_methods_(max_slowest_methods),
+      lock_("pass profile lock"),
+      methods_(0u),
+      cpu_ns_(0u) {}
+
+void PassProfile::RecordMethod(const HGraph* graph,
+                               uint32_t dex_code_units,
+                               uint64_t cpu_ns,
+                               const std::vector<PassSample>& passes) {
+  uint64_t graph_bytes = 0u;
+  const PassSample* slowest_pass = nullptr;
+  for (const PassSample& sample : passes) {
+    graph_bytes += sample.graph_bytes;
+    if (slowest_pass == nullptr || sample.cpu_ns > slowest_pass->cpu_ns) {
+      slowest_pass = &sample;
+    }
+  }
+
+  MutexLock mu(Thread::Current(), lock_);
+  ++methods_;
+  cpu_ns_ += cpu_ns;
+  for (const PassSample& sample : passes) {
+    PassTotals& totals = passes_[sample.pass_name];
+    ++totals.runs;
+    totals.cpu_ns += sample.cpu_ns;
+    totals.max_cpu_ns = std::max(totals.max_cpu_ns, sample.cpu_ns);
+    totals.graph_bytes += sample.graph_bytes;
+    totals.max_graph_bytes = std::max(totals.max_graph_bytes, sample.graph_bytes);
+    totals.max_stack_peak_bytes = std::max(totals.max_stack_peak_bytes, sample.stack_peak_bytes);
+  }
+
+  if (max_slowest_methods_ == 0u ||
+      (slowest_methods_.size() == max_slowest_methods_ &&
+       cpu_ns <= slowest_methods_.front().cpu_ns)) {
+    return;
+  }
+  // PrettyMethod() is expensive, so only call it for the methods that are kept. The heap
+  // is full after the first few methods, so this is rare.
+  MethodInfo info = {
+      graph->GetDexFile().PrettyMethod(graph->GetMethodIdx()),
+      cpu_ns,
+      graph_bytes,
+      dex_code_units,
+      static_cast<size_t>(graph->GetCurrentInstructionId()),
+      graph->GetBlocks().size(),
+      slowest_pass != nullptr ? slowest_pass->pass_name : nullptr
+  };
+  if (slowest_methods_.size() == max_slowest_methods_) {
+    std::pop_heap(slowest_methods_.begin(), slowest_methods_.end(), IsSlowerMethod);
+    slowest_methods_.back() = std::move(info);
+  } else {
+    slowest_methods_.push_back(std::move(info));
+  }
+  std::push_heap(slowest_methods_.begin(), slowest_methods_.end(), IsSlowerMethod);
+}
+
+bool PassProfile::IsSlowerMethod(const MethodInfo& lhs, const MethodInfo& rhs) {
+  return lhs.cpu_ns > rhs.cpu_ns;
+}
+
+void PassProfile::Dump(std::ostream& os) {
+  MutexLock mu(Thread::Current(), lock_);
+  std::vector<std::pair<std::string_view, PassTotals>> passes(passes_.begin(), passes_.end());
+  std::stable_sort(passes.begin(), passes.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.second.cpu_ns > rhs.second.cpu_ns;
+  });
+  std::vector<MethodInfo> methods = slowest_methods_;
+  std::sort_heap(methods.begin(), methods.end(), IsSlowerMethod);
+
+  os << "{\n  \"methods\": " << methods_ << ",\n  \"cpu_ns\": " << cpu_ns_ << ",\n";
+  os << "  \"passes\": [";
+  const char* separator = "\n";
+  for (const auto& [pass_name, totals] : passes) {
+    os << separator << "    {\"name\": ";
+    DumpJsonString(os, pass_name);
+    os << ", \"runs\": " << totals.runs
+       << ", \"cpu_ns\": " << totals.cpu_ns
+       << ", \"max_cpu_ns\": " << totals.max_cpu_ns
+       << ", \"graph_bytes\": " << totals.graph_bytes
+       << ", \"max_graph_bytes\": " << totals.max_graph_bytes
+       << ", \"max_stack_peak_growth\": " << totals.max_stack_peak_bytes << "}";
+    separator = ",\n";
+  }
+  os << "\n  ],\n  \"slowest_methods\": [";
+  separator = "\n";
+  for (const MethodInfo& info : methods) {
+    os << separator << "    {\"method\": ";
+    DumpJsonString(os, info.name);
+    os << ", \"cpu_ns\": " << info.cpu_ns
+       << ", \"graph_bytes\": " << info.graph_bytes
+       << ", \"dex_code_units\": " << info.dex_code_units
+       << ", \"hir_instructions\": " << info.hir_instructions
+       << ", \"blocks\": " << info.blocks
+       << ", \"slowest_pass\": ";
+    DumpJsonString(os, info.slowest_pass != nullptr ? info.slowest_pass : "");
+    os << "}";
+    separator = ",\n";
+  }
+  os << "\n  ]\n}\n";
+}
+
+}  // namespace art
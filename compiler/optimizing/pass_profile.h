@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_PASS_PROFILE_H_
+#define ART_COMPILER_OPTIMIZING_PASS_PROFILE_H_
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/mutex.h"
+
+namespace art HIDDEN {
+
+class HGraph;
+
+// Write `str` as a JSON string, escaping the characters that JSON requires.
+void DumpJsonString(std::ostream& os, std::string_view str);
+
+// Aggregates the CPU time and arena allocation of the optimizing compiler passes over all
+// compiled methods and keeps the slowest methods, for dex2oat --dump-pass-profile. Unlike
+// --dump-pass-timings, nothing is logged per method.
+class PassProfile {
+ public:
+  // One run of a pass in the compilation of a method. Pass names are string literals or
+  // strings owned by the CompilerOptions, so they outlive the profile.
+  struct PassSample {
+    const char* pass_name;
+    uint64_t cpu_ns;
+    uint64_t graph_bytes;
+    uint64_t stack_peak_bytes;
+  };
+
+  explicit PassProfile(size_t max_slowest_methods);
+
+  // Record the compilation of the method of `graph`, which took `cpu_ns` of thread CPU time in
+  // total, including the code generation outside of the `passes`.
+  void RecordMethod(const HGraph* graph,
+                    uint32_t dex_code_units,
+                    uint64_t cpu_ns,
+                    const std::vector<PassSample>& passes) REQUIRES(!lock_);
+
+  // Write the profile as one JSON object, with the passes sorted by decreasing CPU time.
+  void Dump(std::ostream& os) REQUIRES(!lock_);
+
+ private:
+  struct PassTotals {
+    uint64_t runs = 0u;
+    uint64_t cpu_ns = 0u;
+    uint64_t max_cpu_ns = 0u;
+    uint64_t graph_bytes = 0u;
+    uint64_t max_graph_bytes = 0u;
+    uint64_t max_stack_peak_bytes = 0u;
+  };
+
+  struct MethodInfo {
+    std::string name;
+    uint64_t cpu_ns;
+    uint64_t graph_bytes;
+    uint32_t dex_code_units;
+    size_t hir_instructions;
+    size_t blocks;
+    const char* slowest_pass;
+  };
+
+  // The comparator of the min-heap of the slowest methods.
+  static bool IsSlowerMethod(const MethodInfo& lhs, const MethodInfo& rhs);
+
+  const size_t max_slowest_methods_;
+
+  Mutex lock_;
+  uint64_t methods_ GUARDED_BY(lock_);
+  uint64_t cpu_ns_ GUARDED_BY(lock_);
+  std::map<std::string_view, PassTotals> passes_ GUARDED_BY(lock_);
+  // A min-heap on `cpu_ns` of at most `max_slowest_methods_` entries.
+  std::vector<MethodInfo> slowest_methods_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(PassProfile);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_PASS_PROFILE_H_
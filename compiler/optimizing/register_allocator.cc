@@ -43,9 +43,15 @@ std::unique_ptr<RegisterAllocator> RegisterAllocator::Create(ScopedArenaAllocato
     case kRegisterAllocatorLinearScan:
       return std::unique_ptr<RegisterAllocator>(
           new (allocator) RegisterAllocatorLinearScan(allocator, codegen, analysis));
+    case kRegisterAllocatorLinearScanSpillCosts:
+      return std::unique_ptr<RegisterAllocator>(new (allocator) RegisterAllocatorLinearScan(
+          allocator, codegen, analysis, /* use_spill_costs= */ true));
     case kRegisterAllocatorGraphColor:
       LOG(FATAL) << "Graph coloring register allocator has been removed.";
       UNREACHABLE();
+    case kRegisterAllocatorLocal:
+      LOG(FATAL) << "The local register allocator does not use the liveness analysis.";
+      UNREACHABLE();
     default:
       LOG(FATAL) << "Invalid register allocation strategy: " << strategy;
       UNREACHABLE();
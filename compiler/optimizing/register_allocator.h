@@ -40,7 +40,13 @@ class RegisterAllocator : public DeletableArenaObject<kArenaAllocRegisterAllocat
  public:
   enum Strategy {
     kRegisterAllocatorLinearScan,
-    kRegisterAllocatorGraphColor
+    kRegisterAllocatorGraphColor,
+    // Linear scan that takes registers from the intervals with the lowest spill costs,
+    // weighing uses by loop depth. It takes longer to compile and is meant for AOT only.
+    kRegisterAllocatorLinearScanSpillCosts,
+    // RegisterAllocatorLocal, which keeps every value in a stack slot and does not need the
+    // liveness analysis. It is only used for baseline compiles, see `OptimizingCompiler`.
+    kRegisterAllocatorLocal
   };
 
   static constexpr Strategy kRegisterAllocatorDefault = kRegisterAllocatorLinearScan;
@@ -42,7 +42,8 @@ static bool IsLowOfUnalignedPairInterval(LiveInterval* low) {
 
 RegisterAllocatorLinearScan::RegisterAllocatorLinearScan(ScopedArenaAllocator* allocator,
                                                          CodeGenerator* codegen,
-                                                         const SsaLivenessAnalysis& liveness)
+                                                         const SsaLivenessAnalysis& liveness,
+                                                         bool use_spill_costs)
       : RegisterAllocator(allocator, codegen, liveness),
         unhandled_core_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
         unhandled_fp_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
@@ -64,7 +65,8 @@ RegisterAllocatorLinearScan::RegisterAllocatorLinearScan(ScopedArenaAllocator* a
         registers_array_(nullptr),
         blocked_core_registers_(codegen->GetBlockedCoreRegisters()),
         blocked_fp_registers_(codegen->GetBlockedFloatingPointRegisters()),
-        reserved_out_slots_(0) {
+        reserved_out_slots_(0),
+        use_spill_costs_(use_spill_costs) {
   temp_intervals_.reserve(4);
   int_spill_slots_.reserve(kDefaultNumberOfSpillSlots);
   long_spill_slots_.reserve(kDefaultNumberOfSpillSlots);
@@ -185,8 +187,10 @@ void RegisterAllocatorLinearScan::AllocateRegistersInternal() {
   }
 
   number_of_registers_ = codegen_->GetNumberOfCoreRegisters();
-  registers_array_ = allocator_->AllocArray<size_t>(number_of_registers_,
-                                                    kArenaAllocRegisterAllocator);
+  // With spill costs, the second half of the array holds the cost of each register.
+  registers_array_ = allocator_->AllocArray<size_t>(
+      use_spill_costs_ ? 2 * number_of_registers_ : number_of_registers_,
+      kArenaAllocRegisterAllocator);
   processing_core_registers_ = true;
   unhandled_ = &unhandled_core_intervals_;
   for (LiveInterval* fixed : physical_core_register_intervals_) {
@@ -205,8 +209,10 @@ void RegisterAllocatorLinearScan::AllocateRegistersInternal() {
   handled_.clear();
 
   number_of_registers_ = codegen_->GetNumberOfFloatingPointRegisters();
-  registers_array_ = allocator_->AllocArray<size_t>(number_of_registers_,
-                                                    kArenaAllocRegisterAllocator);
+  // With spill costs, the second half of the array holds the cost of each register.
+  registers_array_ = allocator_->AllocArray<size_t>(
+      use_spill_costs_ ? 2 * number_of_registers_ : number_of_registers_,
+      kArenaAllocRegisterAllocator);
   processing_core_registers_ = false;
   unhandled_ = &unhandled_fp_intervals_;
   for (LiveInterval* fixed : physical_fp_register_intervals_) {
@@ -854,6 +860,65 @@ int RegisterAllocatorLinearScan::FindAvailableRegister(size_t* next_use, LiveInt
   return reg;
 }
 
+// Weight of a use at loop depth `depth` for the spill costs.
+static size_t UseWeightAtLoopDepth(size_t depth) {
+  static constexpr size_t kLoopDepthWeightShift = 3;
+  static constexpr size_t kMaxWeightedLoopDepth = 6;
+  return static_cast<size_t>(1u) << (kLoopDepthWeightShift * std::min(depth, kMaxWeightedLoopDepth));
+}
+
+size_t RegisterAllocatorLinearScan::SpillCostAfter(LiveInterval* interval, size_t position) const {
+  size_t cost = 0;
+  size_t end = interval->GetEnd();
+  for (const UsePosition& use : interval->GetUses()) {
+    size_t use_position = use.GetPosition();
+    if (use_position > end) {
+      break;
+    }
+    // Synthesized uses keep values alive across loops, they do not need a reload.
+    if (use_position > position && !use.IsSynthesized()) {
+      size_t depth = 0;
+      for (HLoopInformationOutwardIterator it(*use.GetUser()->GetBlock()); !it.Done(); it.Advance()) {
+        ++depth;
+      }
+      cost += UseWeightAtLoopDepth(depth);
+    }
+  }
+  return cost;
+}
+
+int RegisterAllocatorLinearScan::FindCheapestRegisterToSpill(size_t* next_use,
+                                                             LiveInterval* current,
+                                                             size_t first_register_use,
+                                                             int candidate) const {
+  size_t* spill_costs = registers_array_ + number_of_registers_;
+  std::fill_n(spill_costs, number_of_registers_, 0u);
+  for (LiveInterval* active : active_) {
+    if (!active->IsFixed()) {
+      spill_costs[active->GetRegister()] += SpillCostAfter(active, current->GetStart());
+    }
+  }
+  for (LiveInterval* inactive : inactive_) {
+    if (!inactive->IsFixed() && inactive->FirstIntersectionWith(current) != kNoLifetime) {
+      spill_costs[inactive->GetRegister()] += SpillCostAfter(inactive, current->GetStart());
+    }
+  }
+
+  // Only consider the registers that are free at least until the first register use of
+  // `current`, as `candidate` is. Between equal costs, keep the one used the last.
+  int reg = candidate;
+  for (size_t i = 0; i < number_of_registers_; ++i) {
+    if (IsBlocked(i) || next_use[i] <= first_register_use) {
+      continue;
+    }
+    if (spill_costs[i] < spill_costs[reg] ||
+        (spill_costs[i] == spill_costs[reg] && next_use[i] > next_use[reg])) {
+      reg = i;
+    }
+  }
+  return reg;
+}
+
 // Remove interval and its other half if any. Return iterator to the following element.
 static ArenaVector<LiveInterval*>::iterator RemoveIntervalAndPotentialOtherHalf(
     ScopedArenaVector<LiveInterval*>* intervals, ScopedArenaVector<LiveInterval*>::iterator pos) {
@@ -984,6 +1049,9 @@ bool RegisterAllocatorLinearScan::AllocateBlockedReg(LiveInterval* current) {
     DCHECK(!current->IsHighInterval());
     reg = FindAvailableRegister(next_use, current);
     should_spill = (first_register_use >= next_use[reg]);
+    if (use_spill_costs_ && !should_spill && next_use[reg] != kMaxLifetimePosition) {
+      reg = FindCheapestRegisterToSpill(next_use, current, first_register_use, reg);
+    }
   }
 
   DCHECK_NE(reg, kNoRegister);
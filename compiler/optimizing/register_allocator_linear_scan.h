@@ -41,7 +41,8 @@ class RegisterAllocatorLinearScan : public RegisterAllocator {
  public:
   RegisterAllocatorLinearScan(ScopedArenaAllocator* allocator,
                               CodeGenerator* codegen,
-                              const SsaLivenessAnalysis& analysis);
+                              const SsaLivenessAnalysis& analysis,
+                              bool use_spill_costs = false);
   ~RegisterAllocatorLinearScan() override;
 
   void AllocateRegisters() override;
@@ -96,6 +97,11 @@ class RegisterAllocatorLinearScan : public RegisterAllocator {
   void DumpAllIntervals(std::ostream& stream) const;
   int FindAvailableRegisterPair(size_t* next_use, size_t starting_at) const;
   int FindAvailableRegister(size_t* next_use, LiveInterval* current) const;
+  int FindCheapestRegisterToSpill(size_t* next_use,
+                                  LiveInterval* current,
+                                  size_t first_register_use,
+                                  int candidate) const;
+  size_t SpillCostAfter(LiveInterval* interval, size_t position) const;
   bool IsCallerSaveRegister(int reg) const;
 
   // If any inputs require specific registers, block those registers
@@ -193,6 +199,10 @@ class RegisterAllocatorLinearScan : public RegisterAllocator {
   // Slots reserved for out arguments.
   size_t reserved_out_slots_;
 
+  // Whether to choose the register to take from other intervals by the cost of spilling
+  // their uses, weighed by loop depth, rather than by their next use.
+  const bool use_spill_costs_;
+
   ART_FRIEND_TEST(RegisterAllocatorTest, FreeUntil);
   ART_FRIEND_TEST(RegisterAllocatorTest, SpillInactive);
 
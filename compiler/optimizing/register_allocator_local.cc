@@ -0,0 +1,509 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "register_allocator_local.h"
+
+#include "base/arena_bit_vector.h"
+#include "base/bit_utils.h"
+#include "base/bit_utils_iterator.h"
+#include "base/bit_vector-inl.h"
+#include "code_generator.h"
+#include "linear_order.h"
+#include "nodes.h"
+
+namespace art HIDDEN {
+
+// Every value with uses gets its own home, so the frame grows with the size of the graph.
+// Larger graphs are left to the linear scan allocator, which reuses the spill slots.
+static constexpr size_t kMaximumNumberOfSpillSlots = 1024;
+
+static size_t NumberOfSpillSlotsFor(DataType::Type type) {
+  return DataType::Is64BitType(type) ? 2u : 1u;
+}
+
+static void AddFixedRegister(Location location, uint32_t* core_used, uint32_t* fp_used) {
+  DCHECK(!location.IsPair());
+  if (location.IsRegister()) {
+    *core_used |= 1u << location.reg();
+  } else if (location.IsFpuRegister()) {
+    *fp_used |= 1u << location.reg();
+  }
+}
+
+// Adds the fixed input registers of `instruction`, including those of the inputs that are
+// emitted at the use site, as the code of the user reads their locations.
+static void AddFixedInputRegisters(HInstruction* instruction,
+                                   uint32_t* core_used,
+                                   uint32_t* fp_used) {
+  LocationSummary* locations = instruction->GetLocations();
+  for (size_t i = 0, e = instruction->InputCount(); i != e; ++i) {
+    Location location = locations->InAt(i);
+    if (location.IsValid()) {
+      AddFixedRegister(location, core_used, fp_used);
+    } else if (instruction->InputAt(i)->IsEmittedAtUseSite()) {
+      AddFixedInputRegisters(instruction->InputAt(i), core_used, fp_used);
+    }
+  }
+}
+
+RegisterAllocatorLocal::RegisterAllocatorLocal(ScopedArenaAllocator* allocator,
+                                               CodeGenerator* codegen)
+    : allocator_(allocator),
+      codegen_(codegen),
+      graph_(codegen->GetGraph()),
+      homes_(graph_->GetCurrentInstructionId(),
+             Location::NoLocation(),
+             allocator->Adapter(kArenaAllocRegisterAllocator)),
+      safepoints_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+      // Like the linear scan allocator, always reserve for the current method and the graph's
+      // max out registers. ArtMethod* takes 2 vregs for 64 bits.
+      reserved_out_slots_(
+          static_cast<size_t>(InstructionSetPointerSize(codegen->GetInstructionSet())) /
+              kVRegSize +
+          graph_->GetMaximumNumberOfOutVRegs()),
+      next_slot_(reserved_out_slots_) {}
+
+bool RegisterAllocatorLocal::CanAllocateRegistersFor(const HGraph& graph,
+                                                     InstructionSet instruction_set) {
+  if (!Is64BitInstructionSet(instruction_set) ||
+      graph.HasTryCatch() ||
+      graph.HasIrreducibleLoops()) {
+    return false;
+  }
+  size_t number_of_spill_slots = 0u;
+  for (HBasicBlock* block : graph.GetReversePostOrder()) {
+    for (HInstructionIterator it(block->GetPhis()); !it.Done(); it.Advance()) {
+      number_of_spill_slots += NumberOfSpillSlotsFor(it.Current()->GetType());
+    }
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      if (instruction->GetType() != DataType::Type::kVoid && !instruction->IsConstant()) {
+        number_of_spill_slots += NumberOfSpillSlotsFor(instruction->GetType());
+      }
+    }
+  }
+  return number_of_spill_slots <= kMaximumNumberOfSpillSlots;
+}
+
+void RegisterAllocatorLocal::AllocateRegisters() {
+  codegen_->SetupBlockedRegisters();
+  LinearizeGraph(graph_, &graph_->linear_order_);
+
+  // Assign the registers within each instruction and the homes of the values. This does not
+  // change the graph, so it can be done before the frame size is known.
+  for (HBasicBlock* block : graph_->GetLinearOrder()) {
+    for (HInstructionIterator it(block->GetPhis()); !it.Done(); it.Advance()) {
+      codegen_->AllocateLocations(it.Current());
+      AllocateHome(it.Current());
+    }
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      codegen_->AllocateLocations(instruction);
+      AllocateRegistersFor(instruction);
+      AllocateHome(instruction);
+    }
+  }
+
+  // Computes frame size and spill mask.
+  codegen_->InitializeCodeGeneration(next_slot_ - reserved_out_slots_,
+                                     CalculateMaximumSafepointSpillSize(),
+                                     reserved_out_slots_,  // Includes slot(s) for the art method.
+                                     graph_->GetLinearOrder());
+
+  ResolveParameterHomes();
+  for (HBasicBlock* block : graph_->GetLinearOrder()) {
+    InsertPhiMoves(block);
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      // Skip the phi moves inserted at the exit of the predecessors of blocks visited before.
+      if (!instruction->IsParallelMove()) {
+        SetEnvironmentLocations(instruction);
+        InsertMoves(instruction);
+      }
+    }
+  }
+  SetStackMasks();
+}
+
+void RegisterAllocatorLocal::AllocateHome(HInstruction* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  if (locations == nullptr || !locations->Out().IsValid() || !instruction->HasUses()) {
+    return;
+  }
+  Location home;
+  size_t number_of_slots = NumberOfSpillSlotsFor(instruction->GetType());
+  if (instruction->IsConstant()) {
+    home = locations->Out();
+  } else if (instruction->IsCurrentMethod()) {
+    // The frame entry stores the current method at offset 0.
+    DCHECK(codegen_->RequiresCurrentMethod());
+    home = Location::StackSlotByNumOfSlots(number_of_slots, 0);
+  } else if (instruction->IsParameterValue() &&
+             (locations->Out().IsStackSlot() || locations->Out().IsDoubleStackSlot())) {
+    // Parameters passed on the stack stay in the caller's frame. The offset is adjusted in
+    // `ResolveParameterHomes()` once the frame size is known.
+    home = locations->Out();
+  } else {
+    if (number_of_slots == 2u) {
+      next_slot_ = RoundUp(next_slot_, 2u);
+    }
+    home = Location::StackSlotByNumOfSlots(number_of_slots, next_slot_ * kVRegSize);
+    next_slot_ += number_of_slots;
+  }
+  homes_[instruction->GetId()] = home;
+}
+
+void RegisterAllocatorLocal::AllocateRegistersFor(HInstruction* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  if (locations == nullptr) {
+    return;
+  }
+  if (locations->NeedsSafepoint()) {
+    safepoints_.push_back(instruction);
+  }
+  if (instruction->IsEmittedAtUseSite()) {
+    // The user loads the inputs.
+    return;
+  }
+
+  // The fixed registers of the instruction are not available for the other locations.
+  uint32_t core_used = 0u;
+  uint32_t fp_used = 0u;
+  AddFixedInputRegisters(instruction, &core_used, &fp_used);
+  for (size_t i = 0, e = locations->GetTempCount(); i != e; ++i) {
+    AddFixedRegister(locations->GetTemp(i), &core_used, &fp_used);
+  }
+  AddFixedRegister(locations->Out(), &core_used, &fp_used);
+
+  AllocateInputRegisters(
+      instruction, locations->CanCall() ? locations : nullptr, &core_used, &fp_used);
+
+  for (size_t i = 0, e = locations->GetTempCount(); i != e; ++i) {
+    Location temp = locations->GetTemp(i);
+    if (temp.IsUnallocated()) {
+      // Like the inputs, the temporaries must survive a call on the main path.
+      bool is_fp = (temp.GetPolicy() == Location::kRequiresFpuRegister);
+      DCHECK(is_fp || temp.GetPolicy() == Location::kRequiresRegister);
+      int reg = AllocateRegister(is_fp, locations->WillCall(), is_fp ? &fp_used : &core_used);
+      locations->SetTempAt(
+          i, is_fp ? Location::FpuRegisterLocation(reg) : Location::RegisterLocation(reg));
+    }
+  }
+
+  Location out = locations->Out();
+  if (out.IsUnallocated()) {
+    if (out.GetPolicy() == Location::kSameAsFirstInput) {
+      DCHECK(locations->InAt(0).IsRegister() || locations->InAt(0).IsFpuRegister());
+      locations->UpdateOut(locations->InAt(0));
+    } else {
+      // The output never shares a register with the inputs, so the overlap does not matter.
+      bool is_fp = (out.GetPolicy() == Location::kRequiresFpuRegister) ||
+                   (out.GetPolicy() == Location::kAny &&
+                    DataType::IsFloatingPointType(instruction->GetType()));
+      int reg = AllocateRegister(is_fp, /* callee_save_only= */ false,
+                                 is_fp ? &fp_used : &core_used);
+      locations->UpdateOut(
+          is_fp ? Location::FpuRegisterLocation(reg) : Location::RegisterLocation(reg));
+    }
+  }
+
+  for (uint32_t reg : LowToHighBits(core_used)) {
+    if (!codegen_->IsBlockedCoreRegister(reg)) {
+      codegen_->AddAllocatedRegister(Location::RegisterLocation(reg));
+    }
+  }
+  for (uint32_t reg : LowToHighBits(fp_used)) {
+    if (!codegen_->IsBlockedFloatingPointRegister(reg)) {
+      codegen_->AddAllocatedRegister(Location::FpuRegisterLocation(reg));
+    }
+  }
+}
+
+void RegisterAllocatorLocal::AllocateInputRegisters(HInstruction* instruction,
+                                                    LocationSummary* safepoint_locations,
+                                                    uint32_t* core_used,
+                                                    uint32_t* fp_used) {
+  LocationSummary* locations = instruction->GetLocations();
+  for (size_t i = 0, e = instruction->InputCount(); i != e; ++i) {
+    HInstruction* input = instruction->InputAt(i);
+    Location location = locations->InAt(i);
+    if (!location.IsValid()) {
+      if (input->IsEmittedAtUseSite()) {
+        AllocateInputRegisters(input, safepoint_locations, core_used, fp_used);
+      }
+      continue;
+    }
+    if (!location.IsUnallocated()) {
+      continue;
+    }
+    bool is_fp;
+    if (location.GetPolicy() == Location::kAny) {
+      if (!locations->OutputUsesSameAs(i)) {
+        // Read from the home, see `AddInputMoves()`.
+        continue;
+      }
+      is_fp = DataType::IsFloatingPointType(input->GetType());
+    } else {
+      DCHECK(location.GetPolicy() == Location::kRequiresRegister ||
+             location.GetPolicy() == Location::kRequiresFpuRegister);
+      is_fp = (location.GetPolicy() == Location::kRequiresFpuRegister);
+    }
+    // The inputs are live during the instruction. If it calls on the main path, they must be
+    // in callee-save registers to be used after the call.
+    bool callee_save_only = (safepoint_locations != nullptr) && safepoint_locations->WillCall();
+    int reg = AllocateRegister(is_fp, callee_save_only, is_fp ? fp_used : core_used);
+    Location allocated =
+        is_fp ? Location::FpuRegisterLocation(reg) : Location::RegisterLocation(reg);
+    locations->SetInAt(i, allocated);
+    if (safepoint_locations != nullptr) {
+      safepoint_locations->AddLiveRegister(allocated);
+      if (input->GetType() == DataType::Type::kReference) {
+        DCHECK(!is_fp);
+        safepoint_locations->SetRegisterBit(reg);
+      }
+    }
+  }
+}
+
+int RegisterAllocatorLocal::AllocateRegister(bool is_fp, bool callee_save_only, uint32_t* used) {
+  size_t number_of_registers = is_fp ? codegen_->GetNumberOfFloatingPointRegisters()
+                                     : codegen_->GetNumberOfCoreRegisters();
+  DCHECK_LE(number_of_registers, BitSizeOf<uint32_t>());
+  // Prefer the caller-save registers, which the frame entry does not need to save.
+  for (bool callee_save : {false, true}) {
+    if (callee_save_only && !callee_save) {
+      continue;
+    }
+    for (size_t reg = 0; reg != number_of_registers; ++reg) {
+      bool blocked = is_fp ? codegen_->IsBlockedFloatingPointRegister(reg)
+                           : codegen_->IsBlockedCoreRegister(reg);
+      bool is_callee_save = is_fp ? codegen_->IsFloatingPointCalleeSaveRegister(reg)
+                                  : codegen_->IsCoreCalleeSaveRegister(reg);
+      if (!blocked && (*used & (1u << reg)) == 0u && is_callee_save == callee_save) {
+        *used |= 1u << reg;
+        return reg;
+      }
+    }
+  }
+  LOG(FATAL) << "No register left for the locations of an instruction";
+  UNREACHABLE();
+}
+
+size_t RegisterAllocatorLocal::CalculateMaximumSafepointSpillSize() const {
+  size_t core_register_spill_size = codegen_->GetWordSize();
+  size_t fp_register_spill_size = codegen_->GetSlowPathFPWidth();
+  size_t maximum_safepoint_spill_size = 0u;
+  for (HInstruction* instruction : safepoints_) {
+    LocationSummary* locations = instruction->GetLocations();
+    if (locations->OnlyCallsOnSlowPath()) {
+      size_t core_spills =
+          codegen_->GetNumberOfSlowPathSpills(locations, /* core_registers= */ true);
+      size_t fp_spills =
+          codegen_->GetNumberOfSlowPathSpills(locations, /* core_registers= */ false);
+      size_t spill_size =
+          core_register_spill_size * core_spills + fp_register_spill_size * fp_spills;
+      maximum_safepoint_spill_size = std::max(maximum_safepoint_spill_size, spill_size);
+    }
+  }
+  return maximum_safepoint_spill_size;
+}
+
+void RegisterAllocatorLocal::ResolveParameterHomes() {
+  for (HInstructionIterator it(graph_->GetEntryBlock()->GetInstructions());
+       !it.Done();
+       it.Advance()) {
+    HParameterValue* parameter = it.Current()->AsParameterValueOrNull();
+    if (parameter == nullptr) {
+      continue;
+    }
+    LocationSummary* locations = parameter->GetLocations();
+    Location location = locations->Out();
+    if (location.IsStackSlot()) {
+      location = Location::StackSlot(location.GetStackIndex() + codegen_->GetFrameSize());
+    } else if (location.IsDoubleStackSlot()) {
+      location = Location::DoubleStackSlot(location.GetStackIndex() + codegen_->GetFrameSize());
+    } else {
+      continue;
+    }
+    locations->UpdateOut(location);
+    if (GetHome(parameter).IsValid()) {
+      homes_[parameter->GetId()] = location;
+    }
+  }
+}
+
+void RegisterAllocatorLocal::InsertMoves(HInstruction* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  if (locations == nullptr || instruction->IsEmittedAtUseSite()) {
+    return;
+  }
+  HParallelMove* input_move = nullptr;
+  AddInputMoves(instruction, instruction, &input_move);
+
+  Location home = GetHome(instruction);
+  Location out = locations->Out();
+  if (home.IsValid() &&
+      (out.IsRegister() || out.IsFpuRegister()) &&
+      // The frame entry stores the current method.
+      !instruction->IsCurrentMethod()) {
+    DCHECK(!instruction->IsControlFlow());
+    ArenaAllocator* allocator = graph_->GetAllocator();
+    HParallelMove* output_move = new (allocator) HParallelMove(allocator);
+    instruction->GetBlock()->InsertInstructionAfter(output_move, instruction);
+    output_move->AddMove(out, home, instruction->GetType(), instruction);
+  }
+}
+
+void RegisterAllocatorLocal::AddInputMoves(HInstruction* instruction,
+                                           HInstruction* user,
+                                           HParallelMove** move) {
+  LocationSummary* locations = instruction->GetLocations();
+  for (size_t i = 0, e = instruction->InputCount(); i != e; ++i) {
+    HInstruction* input = instruction->InputAt(i);
+    Location location = locations->InAt(i);
+    if (!location.IsValid()) {
+      if (input->IsEmittedAtUseSite()) {
+        AddInputMoves(input, user, move);
+      }
+      continue;
+    }
+    Location home = GetHome(input);
+    DCHECK(home.IsValid()) << input->DebugName() << " used by " << instruction->DebugName();
+    if (location.IsUnallocated()) {
+      DCHECK_EQ(location.GetPolicy(), Location::kAny);
+      locations->SetInAt(i, home);
+    } else if (!location.IsConstant() && !location.Equals(home)) {
+      if (*move == nullptr) {
+        ArenaAllocator* allocator = graph_->GetAllocator();
+        *move = new (allocator) HParallelMove(allocator);
+        user->GetBlock()->InsertInstructionBefore(*move, user);
+      }
+      (*move)->AddMove(home, location, input->GetType(), /* instruction= */ nullptr);
+    }
+  }
+}
+
+void RegisterAllocatorLocal::InsertPhiMoves(HBasicBlock* block) {
+  if (block->GetPhis().IsEmpty()) {
+    return;
+  }
+  for (HInstructionIterator it(block->GetPhis()); !it.Done(); it.Advance()) {
+    Location home = GetHome(it.Current());
+    if (home.IsValid()) {
+      it.Current()->GetLocations()->UpdateOut(home);
+    }
+  }
+  // The phis of a block are assigned in parallel, so each predecessor gets one move for all.
+  for (size_t i = 0, e = block->GetPredecessors().size(); i != e; ++i) {
+    HBasicBlock* predecessor = block->GetPredecessors()[i];
+    DCHECK_EQ(predecessor->GetNormalSuccessors().size(), 1u);
+    HParallelMove* move = nullptr;
+    for (HInstructionIterator it(block->GetPhis()); !it.Done(); it.Advance()) {
+      HPhi* phi = it.Current()->AsPhi();
+      Location source = GetHome(phi->InputAt(i));
+      DCHECK(source.IsValid());
+      phi->GetLocations()->SetInAt(i, source);
+      Location destination = GetHome(phi);
+      if (!destination.IsValid() || source.Equals(destination)) {
+        continue;
+      }
+      if (move == nullptr) {
+        ArenaAllocator* allocator = graph_->GetAllocator();
+        move = new (allocator) HParallelMove(allocator);
+        predecessor->InsertInstructionBefore(move, predecessor->GetLastInstruction());
+      }
+      move->AddMove(source, destination, phi->GetType(), phi);
+    }
+  }
+}
+
+void RegisterAllocatorLocal::SetEnvironmentLocations(HInstruction* instruction) {
+  for (HEnvironment* environment = instruction->GetEnvironment();
+       environment != nullptr;
+       environment = environment->GetParent()) {
+    for (size_t i = 0, e = environment->Size(); i != e; ++i) {
+      HInstruction* value = environment->GetInstructionAt(i);
+      if (value != nullptr) {
+        DCHECK(GetHome(value).IsValid()) << value->DebugName();
+        environment->SetLocationAt(i, GetHome(value));
+      }
+    }
+  }
+}
+
+void RegisterAllocatorLocal::SetStackMasks() {
+  // Walk the dominator tree, keeping the stack slots of the references defined by the
+  // dominators of the current block and by the instructions before the current one. Their
+  // homes have been written, and they include all references that are live at a safepoint.
+  ArenaBitVector references(allocator_, 0u, /* expandable= */ true, kArenaAllocRegisterAllocator);
+  ScopedArenaVector<size_t> reference_slots(allocator_->Adapter(kArenaAllocRegisterAllocator));
+  struct DominatorTreeVisit {
+    HBasicBlock* block;
+    size_t next_dominated_block;
+    size_t number_of_reference_slots;
+  };
+  ScopedArenaVector<DominatorTreeVisit> worklist(
+      allocator_->Adapter(kArenaAllocRegisterAllocator));
+
+  auto add_reference = [&](HInstruction* instruction) {
+    if (instruction->GetType() == DataType::Type::kReference) {
+      Location home = GetHome(instruction);
+      if (home.IsStackSlot()) {
+        size_t slot = home.GetStackIndex() / kVRegSize;
+        references.SetBit(slot);
+        reference_slots.push_back(slot);
+      }
+    }
+  };
+  auto visit_block = [&](HBasicBlock* block) {
+    worklist.push_back({block, 0u, reference_slots.size()});
+    for (HInstructionIterator it(block->GetPhis()); !it.Done(); it.Advance()) {
+      add_reference(it.Current());
+    }
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      LocationSummary* locations = instruction->GetLocations();
+      if (locations != nullptr && locations->NeedsSafepoint()) {
+        locations->GetStackMask()->Union(&references);
+      }
+      add_reference(instruction);
+    }
+  };
+
+  visit_block(graph_->GetEntryBlock());
+  while (!worklist.empty()) {
+    DominatorTreeVisit& visit = worklist.back();
+    const ArenaVector<HBasicBlock*>& dominated_blocks = visit.block->GetDominatedBlocks();
+    if (visit.next_dominated_block != dominated_blocks.size()) {
+      // This invalidates `visit`.
+      visit_block(dominated_blocks[visit.next_dominated_block++]);
+    } else {
+      for (size_t i = visit.number_of_reference_slots; i != reference_slots.size(); ++i) {
+        references.ClearBit(reference_slots[i]);
+      }
+      reference_slots.resize(visit.number_of_reference_slots);
+      worklist.pop_back();
+    }
+  }
+}
+
+Location RegisterAllocatorLocal::GetHome(HInstruction* instruction) const {
+  DCHECK_LT(instruction->GetId(), static_cast<int>(homes_.size()));
+  return homes_[instruction->GetId()];
+}
+
+}  // namespace art
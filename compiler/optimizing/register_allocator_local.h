@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ART_COMPILER_OPTIMIZING_REGISTER_ALLOCATOR_LOCAL_H_
+#define ART_COMPILER_OPTIMIZING_REGISTER_ALLOCATOR_LOCAL_H_
+
+#include "arch/instruction_set.h"
+#include "base/macros.h"
+#include "base/scoped_arena_containers.h"
+#include "locations.h"
+
+namespace art HIDDEN {
+
+class CodeGenerator;
+class HBasicBlock;
+class HGraph;
+class HInstruction;
+class HParallelMove;
+
+/**
+ * A register allocator for baseline compiles that does not need the liveness analysis.
+ *
+ * Every value that has uses lives in its own stack slot, its home, for its whole lifetime.
+ * Registers are only assigned within an instruction: a parallel move before the instruction
+ * loads its inputs from their homes, and a parallel move after it stores its output to its
+ * home. Phi inputs are copied to the home of the phi at the end of the predecessors. The
+ * allocation is a single pass over the instructions, plus a walk of the dominator tree for the
+ * references of the stack maps: a reference that is live at a safepoint is defined by an
+ * instruction that dominates it, so the homes of the dominating references are reported.
+ *
+ * The code is slower than the code from the linear scan allocator, which is acceptable for
+ * baseline code that gets replaced by optimized code once it is hot.
+ */
+class RegisterAllocatorLocal {
+ public:
+  RegisterAllocatorLocal(ScopedArenaAllocator* allocator, CodeGenerator* codegen);
+
+  // Returns whether the graph can be compiled with this allocator. Graphs with try/catch or
+  // irreducible loops are left to the linear scan allocator, as are 32-bit instruction sets,
+  // which need register pairs, and graphs with more values than fit into a small frame.
+  static bool CanAllocateRegistersFor(const HGraph& graph, InstructionSet instruction_set);
+
+  // Allocates the locations, assigns the registers and the homes, and inserts the moves.
+  void AllocateRegisters();
+
+ private:
+  void AllocateHome(HInstruction* instruction);
+  void AllocateRegistersFor(HInstruction* instruction);
+  void AllocateInputRegisters(HInstruction* instruction,
+                              LocationSummary* safepoint_locations,
+                              uint32_t* core_used,
+                              uint32_t* fp_used);
+  int AllocateRegister(bool is_fp, bool callee_save_only, uint32_t* used);
+  size_t CalculateMaximumSafepointSpillSize() const;
+
+  void ResolveParameterHomes();
+  void InsertMoves(HInstruction* instruction);
+  void AddInputMoves(HInstruction* instruction, HInstruction* user, HParallelMove** move);
+  void InsertPhiMoves(HBasicBlock* block);
+  void SetEnvironmentLocations(HInstruction* instruction);
+  void SetStackMasks();
+
+  Location GetHome(HInstruction* instruction) const;
+
+  ScopedArenaAllocator* const allocator_;
+  CodeGenerator* const codegen_;
+  HGraph* const graph_;
+
+  // The home of each value, indexed by instruction id. Invalid for values without uses.
+  ScopedArenaVector<Location> homes_;
+
+  // The instructions with a safepoint, for the size of the slow path spills.
+  ScopedArenaVector<HInstruction*> safepoints_;
+
+  // The slots for the current method and the outgoing arguments of calls.
+  const size_t reserved_out_slots_;
+
+  // The next free slot, above the reserved out slots.
+  size_t next_slot_;
+
+  DISALLOW_COPY_AND_ASSIGN(RegisterAllocatorLocal);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_REGISTER_ALLOCATOR_LOCAL_H_
@@ -21,6 +21,7 @@
 #include "base/scoped_arena_allocator.h"
 #include "base/scoped_arena_containers.h"
 #include "data_type-inl.h"
+#include "driver/compiler_options.h"
 #include "optimizing/load_store_analysis.h"
 #include "prepare_for_register_allocation.h"
 
@@ -32,6 +33,11 @@
 #include "scheduler_arm.h"
 #endif
 
+#ifdef ART_ENABLE_CODEGEN_riscv64
+#include "arch/riscv64/instruction_set_features_riscv64.h"
+#include "scheduler_riscv64.h"
+#endif
+
 namespace art HIDDEN {
 
 void SchedulingGraph::AddDependency(SchedulingNode* node,
@@ -795,7 +801,8 @@ bool HScheduler::IsSchedulingBarrier(const HInstruction* instr) const {
 
 bool HInstructionScheduling::Run(bool only_optimize_loop_blocks,
                                  bool schedule_randomly) {
-#if defined(ART_ENABLE_CODEGEN_arm64) || defined(ART_ENABLE_CODEGEN_arm)
+#if defined(ART_ENABLE_CODEGEN_arm64) || defined(ART_ENABLE_CODEGEN_arm) || \
+    defined(ART_ENABLE_CODEGEN_riscv64)
   // Phase-local allocator that allocates scheduler internal data structures like
   // scheduling nodes, internel nodes map, dependencies, etc.
   CriticalPathSchedulingNodeSelector critical_path_selector;
@@ -828,6 +835,20 @@ bool HInstructionScheduling::Run(bool only_optimize_loop_blocks,
       scheduler.Schedule(graph_);
       break;
     }
+#endif
+#if defined(ART_ENABLE_CODEGEN_riscv64)
+    case InstructionSet::kRiscv64: {
+      // The latency model is selected from the instruction set features. Use the generic
+      // model if there is no code generator, for example in tests.
+      const Riscv64InstructionSetFeatures* features = (codegen_ != nullptr)
+          ? codegen_->GetCompilerOptions().GetInstructionSetFeatures()
+                ->AsRiscv64InstructionSetFeatures()
+          : nullptr;
+      riscv64::HSchedulerRISCV64 scheduler(selector, features);
+      scheduler.SetOnlyOptimizeLoopBlocks(only_optimize_loop_blocks);
+      scheduler.Schedule(graph_);
+      break;
+    }
 #endif
     default:
       break;
@@ -0,0 +1,378 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "scheduler_riscv64.h"
+
+#include "arch/riscv64/instruction_set_features_riscv64.h"
+#include "code_generator_utils.h"
+#include "mirror/string.h"
+
+namespace art HIDDEN {
+namespace riscv64 {
+
+// Latencies for cores without a specific model. These are conservative values for a
+// dual-issue in-order pipeline in the style of the SiFive U74 and similar RV64GC cores.
+static constexpr Riscv64SchedulingLatencies kRiscv64GenericLatencies = {
+  /* integer_op= */ 1u,
+  /* memory_load= */ 3u,
+  /* memory_store= */ 1u,
+  /* mul_integer= */ 3u,
+  /* div_integer= */ 20u,
+  /* floating_point_op= */ 5u,
+  /* mul_floating_point= */ 5u,
+  /* div_float= */ 20u,
+  /* div_double= */ 30u,
+  /* type_conversion_floating_point_integer= */ 4u,
+  /* branch= */ 1u,
+  /* call= */ 5u,
+  /* call_internal= */ 10u,
+  /* load_string_internal= */ 7u,
+  /* simd_integer_op= */ 4u,
+  /* simd_floating_point_op= */ 6u,
+  /* simd_mul_integer= */ 6u,
+  /* simd_mul_floating_point= */ 8u,
+  /* simd_div_float= */ 30u,
+  /* simd_div_double= */ 60u,
+  /* simd_memory_load= */ 6u,
+  /* simd_memory_store= */ 4u,
+  /* simd_replicate_op= */ 6u,
+  /* simd_type_conversion_int_to_fp= */ 6u,
+};
+
+// Approximate latencies of the T-Head XuanTie C910 (as found in the TH1520 SoC). The core
+// issues out of order but its front end is narrow, so hiding the load-use, multiply and
+// FP latencies in the instruction order still matters.
+static constexpr Riscv64SchedulingLatencies kRiscv64THeadC910Latencies = {
+  /* integer_op= */ 1u,
+  /* memory_load= */ 3u,
+  /* memory_store= */ 1u,
+  /* mul_integer= */ 3u,
+  /* div_integer= */ 12u,
+  /* floating_point_op= */ 3u,
+  /* mul_floating_point= */ 4u,
+  /* div_float= */ 10u,
+  /* div_double= */ 15u,
+  /* type_conversion_floating_point_integer= */ 3u,
+  /* branch= */ 1u,
+  /* call= */ 5u,
+  /* call_internal= */ 10u,
+  /* load_string_internal= */ 7u,
+  /* simd_integer_op= */ 3u,
+  /* simd_floating_point_op= */ 5u,
+  /* simd_mul_integer= */ 4u,
+  /* simd_mul_floating_point= */ 5u,
+  /* simd_div_float= */ 20u,
+  /* simd_div_double= */ 30u,
+  /* simd_memory_load= */ 4u,
+  /* simd_memory_store= */ 1u,
+  /* simd_replicate_op= */ 4u,
+  /* simd_type_conversion_int_to_fp= */ 4u,
+};
+
+const Riscv64SchedulingLatencies& GetRiscv64SchedulingLatencies(
+    const Riscv64InstructionSetFeatures* features) {
+  if (features != nullptr &&
+      (features->HasXTheadBa() ||
+       features->HasXTheadBb() ||
+       features->HasXTheadMemIdx() ||
+       features->HasXTheadMac() ||
+       features->HasXTheadVector())) {
+    return kRiscv64THeadC910Latencies;
+  }
+  return kRiscv64GenericLatencies;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitBinaryOperation(HBinaryOperation* instr) {
+  last_visited_latency_ = DataType::IsFloatingPointType(instr->GetResultType())
+      ? latencies_.floating_point_op
+      : latencies_.integer_op;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitArrayGet(HArrayGet* instruction) {
+  if (!instruction->GetIndex()->IsConstant()) {
+    // Take the element address computation into account.
+    last_visited_internal_latency_ = latencies_.integer_op;
+  }
+  if (mirror::kUseStringCompression && instruction->IsStringCharAt()) {
+    // Load and test the compression flag.
+    last_visited_internal_latency_ += latencies_.memory_load + latencies_.branch;
+  }
+  last_visited_latency_ = latencies_.memory_load;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitArrayLength([[maybe_unused]] HArrayLength*) {
+  last_visited_latency_ = latencies_.memory_load;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitArraySet(HArraySet* instruction) {
+  if (!instruction->GetIndex()->IsConstant()) {
+    // Take the element address computation into account.
+    last_visited_internal_latency_ = latencies_.integer_op;
+  }
+  last_visited_latency_ = latencies_.memory_store;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitBoundsCheck([[maybe_unused]] HBoundsCheck*) {
+  last_visited_internal_latency_ = latencies_.integer_op;
+  // Users do not use any data results.
+  last_visited_latency_ = 0;
+}
+
+void SchedulingLatencyVisitorRISCV64::HandleDivRemByConstant(HBinaryOperation* instruction) {
+  // Follow the code path used by code generation.
+  DCHECK(instruction->GetRight()->IsConstant());
+  int64_t imm = Int64FromConstant(instruction->GetRight()->AsConstant());
+  if (imm == 0) {
+    last_visited_internal_latency_ = 0;
+    last_visited_latency_ = 0;
+  } else if (imm == 1 || imm == -1) {
+    last_visited_internal_latency_ = 0;
+    last_visited_latency_ = latencies_.integer_op;
+  } else if (IsPowerOfTwo(AbsOrMin(imm))) {
+    last_visited_internal_latency_ = 3 * latencies_.integer_op;
+    last_visited_latency_ = latencies_.integer_op;
+  } else {
+    DCHECK(imm <= -2 || imm >= 2);
+    // Multiply by the magic number and correct the result with shifts and additions.
+    last_visited_internal_latency_ = latencies_.mul_integer + 2 * latencies_.integer_op;
+    last_visited_latency_ = instruction->IsRem() ? latencies_.mul_integer
+                                                 : latencies_.integer_op;
+  }
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitDiv(HDiv* instr) {
+  DataType::Type type = instr->GetResultType();
+  switch (type) {
+    case DataType::Type::kFloat32:
+      last_visited_latency_ = latencies_.div_float;
+      break;
+    case DataType::Type::kFloat64:
+      last_visited_latency_ = latencies_.div_double;
+      break;
+    default:
+      if (instr->GetRight()->IsConstant()) {
+        HandleDivRemByConstant(instr);
+      } else {
+        last_visited_latency_ = latencies_.div_integer;
+      }
+      break;
+  }
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitInstanceFieldGet(
+    [[maybe_unused]] HInstanceFieldGet*) {
+  last_visited_latency_ = latencies_.memory_load;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitInstanceOf([[maybe_unused]] HInstanceOf*) {
+  last_visited_internal_latency_ = latencies_.call_internal;
+  last_visited_latency_ = latencies_.integer_op;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitInvoke([[maybe_unused]] HInvoke*) {
+  last_visited_internal_latency_ = latencies_.call_internal;
+  last_visited_latency_ = latencies_.call;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitLoadString([[maybe_unused]] HLoadString*) {
+  last_visited_internal_latency_ = latencies_.load_string_internal;
+  last_visited_latency_ = latencies_.memory_load;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitMul(HMul* instr) {
+  last_visited_latency_ = DataType::IsFloatingPointType(instr->GetResultType())
+      ? latencies_.mul_floating_point
+      : latencies_.mul_integer;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitNewArray([[maybe_unused]] HNewArray*) {
+  last_visited_internal_latency_ = latencies_.integer_op + latencies_.call_internal;
+  last_visited_latency_ = latencies_.call;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitNewInstance(HNewInstance* instruction) {
+  if (instruction->IsStringAlloc()) {
+    last_visited_internal_latency_ = 2 + latencies_.memory_load + latencies_.call_internal;
+  } else {
+    last_visited_internal_latency_ = latencies_.call_internal;
+  }
+  last_visited_latency_ = latencies_.call;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitRem(HRem* instruction) {
+  if (DataType::IsFloatingPointType(instruction->GetResultType())) {
+    last_visited_internal_latency_ = latencies_.call_internal;
+    last_visited_latency_ = latencies_.call;
+  } else if (instruction->GetRight()->IsConstant()) {
+    HandleDivRemByConstant(instruction);
+  } else {
+    // Unlike ARM64, the remainder is computed by a single `rem` instruction.
+    last_visited_latency_ = latencies_.div_integer;
+  }
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitStaticFieldGet([[maybe_unused]] HStaticFieldGet*) {
+  last_visited_latency_ = latencies_.memory_load;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitSuspendCheck(HSuspendCheck* instruction) {
+  HBasicBlock* block = instruction->GetBlock();
+  DCHECK_IMPLIES(block->GetLoopInformation() == nullptr,
+                 block->IsEntryBlock() && instruction->GetNext()->IsGoto());
+  // Users do not use any data results.
+  last_visited_latency_ = 0;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitTypeConversion(HTypeConversion* instr) {
+  if (DataType::IsFloatingPointType(instr->GetResultType()) ||
+      DataType::IsFloatingPointType(instr->GetInputType())) {
+    last_visited_latency_ = latencies_.type_conversion_floating_point_integer;
+  } else {
+    last_visited_latency_ = latencies_.integer_op;
+  }
+}
+
+void SchedulingLatencyVisitorRISCV64::HandleSimpleArithmeticSIMD(HVecOperation* instr) {
+  if (DataType::IsFloatingPointType(instr->GetPackedType())) {
+    last_visited_latency_ = latencies_.simd_floating_point_op;
+  } else {
+    last_visited_latency_ = latencies_.simd_integer_op;
+  }
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecReplicateScalar(
+    [[maybe_unused]] HVecReplicateScalar* instr) {
+  last_visited_latency_ = latencies_.simd_replicate_op;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecExtractScalar(HVecExtractScalar* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecReduce(HVecReduce* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecCnv([[maybe_unused]] HVecCnv* instr) {
+  last_visited_latency_ = latencies_.simd_type_conversion_int_to_fp;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecNeg(HVecNeg* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecAbs(HVecAbs* instr) {
+  if (!DataType::IsFloatingPointType(instr->GetPackedType())) {
+    // The integer absolute value needs a negation before the `vmax.vv`.
+    last_visited_internal_latency_ = latencies_.simd_integer_op;
+  }
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecNot([[maybe_unused]] HVecNot* instr) {
+  last_visited_latency_ = latencies_.simd_integer_op;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecAdd(HVecAdd* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecSub(HVecSub* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecMul(HVecMul* instr) {
+  if (DataType::IsFloatingPointType(instr->GetPackedType())) {
+    last_visited_latency_ = latencies_.simd_mul_floating_point;
+  } else {
+    last_visited_latency_ = latencies_.simd_mul_integer;
+  }
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecDiv(HVecDiv* instr) {
+  if (instr->GetPackedType() == DataType::Type::kFloat32) {
+    last_visited_latency_ = latencies_.simd_div_float;
+  } else {
+    DCHECK(instr->GetPackedType() == DataType::Type::kFloat64);
+    last_visited_latency_ = latencies_.simd_div_double;
+  }
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecMin(HVecMin* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecMax(HVecMax* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecAnd([[maybe_unused]] HVecAnd* instr) {
+  last_visited_latency_ = latencies_.simd_integer_op;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecOr([[maybe_unused]] HVecOr* instr) {
+  last_visited_latency_ = latencies_.simd_integer_op;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecXor([[maybe_unused]] HVecXor* instr) {
+  last_visited_latency_ = latencies_.simd_integer_op;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecShl(HVecShl* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecShr(HVecShr* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecUShr(HVecUShr* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecSetScalars(HVecSetScalars* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecMultiplyAccumulate(
+    [[maybe_unused]] HVecMultiplyAccumulate* instr) {
+  last_visited_latency_ = latencies_.simd_mul_integer;
+}
+
+void SchedulingLatencyVisitorRISCV64::HandleVecAddress(HVecMemoryOperation* instruction) {
+  HInstruction* index = instruction->InputAt(1);
+  if (!index->IsConstant()) {
+    // Shift-and-add of the index followed by the addition of the data offset.
+    last_visited_internal_latency_ += 2 * latencies_.integer_op;
+  } else {
+    last_visited_internal_latency_ += latencies_.integer_op;
+  }
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecLoad(HVecLoad* instr) {
+  last_visited_internal_latency_ = 0;
+  HandleVecAddress(instr);
+  last_visited_latency_ = latencies_.simd_memory_load;
+}
+
+void SchedulingLatencyVisitorRISCV64::VisitVecStore(HVecStore* instr) {
+  last_visited_internal_latency_ = 0;
+  HandleVecAddress(instr);
+  last_visited_latency_ = latencies_.simd_memory_store;
+}
+
+}  // namespace riscv64
+}  // namespace art
@@ -35,6 +35,11 @@
 #include "scheduler_arm.h"
 #endif
 
+#ifdef ART_ENABLE_CODEGEN_riscv64
+#include "arch/riscv64/instruction_set_features_riscv64.h"
+#include "scheduler_riscv64.h"
+#endif
+
 namespace art HIDDEN {
 
 // Return all combinations of ISA and code generator that are executable on
@@ -420,6 +425,35 @@ TEST_F(SchedulerTest, ArrayAccessAliasingARM) {
 }
 #endif
 
+#if defined(ART_ENABLE_CODEGEN_riscv64)
+TEST_F(SchedulerTest, DependencyGraphAndSchedulerRISCV64) {
+  CriticalPathSchedulingNodeSelector critical_path_selector;
+  riscv64::HSchedulerRISCV64 scheduler(&critical_path_selector, /*features=*/ nullptr);
+  TestBuildDependencyGraphAndSchedule(&scheduler);
+}
+
+TEST_F(SchedulerTest, ArrayAccessAliasingRISCV64) {
+  CriticalPathSchedulingNodeSelector critical_path_selector;
+  riscv64::HSchedulerRISCV64 scheduler(&critical_path_selector, /*features=*/ nullptr);
+  TestDependencyGraphOnAliasingArrayAccesses(&scheduler);
+}
+
+TEST_F(SchedulerTest, LatencyModelRISCV64) {
+  std::string error_msg;
+  std::unique_ptr<const Riscv64InstructionSetFeatures> generic_features =
+      Riscv64InstructionSetFeatures::FromVariant("generic", &error_msg);
+  std::unique_ptr<const Riscv64InstructionSetFeatures> c910_features =
+      Riscv64InstructionSetFeatures::FromVariant("thead-c910", &error_msg);
+  // The generic model is used by default and the T-Head extensions select the C910 model.
+  const riscv64::Riscv64SchedulingLatencies& default_latencies =
+      riscv64::GetRiscv64SchedulingLatencies(nullptr);
+  EXPECT_EQ(&default_latencies,
+            &riscv64::GetRiscv64SchedulingLatencies(generic_features.get()));
+  EXPECT_NE(&default_latencies,
+            &riscv64::GetRiscv64SchedulingLatencies(c910_features.get()));
+}
+#endif
+
 TEST_F(SchedulerTest, RandomScheduling) {
   //
   // Java source: crafted code to make sure (random) scheduling should get correct result.
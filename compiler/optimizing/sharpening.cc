@@ -324,9 +324,9 @@ static inline bool CanUseTypeCheckBitstring(ObjPtr<mirror::Class> klass, CodeGen
     // If the target is a boot image class, try to assign a type check bitstring (fall through).
     // (If --force-determinism, this was already done; repeating is OK and yields the same result.)
   } else {
-    // TODO: Use the bitstring also for AOT app compilation if the target class has a bitstring
-    // already assigned in the boot image.
-    return false;
+    // For AOT app compilation, use the bitstring if the target class has a bitstring already
+    // assigned in the boot image. Do not assign one here, it would not be the same at runtime.
+    return compiler_options.HasBootImageTypeCheckBitstring(klass.Ptr());
   }
 
   // Try to assign a type check bitstring.
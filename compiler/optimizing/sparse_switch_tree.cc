@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sparse_switch_tree.h"
+
+#include <algorithm>
+
+namespace art HIDDEN {
+
+SparseSwitchTree::SparseSwitchTree(const DexSwitchTable& table, ScopedArenaAllocator* allocator)
+    : table_(table),
+      leaves_(allocator->Adapter(kArenaAllocGraphBuilder)),
+      nodes_(allocator->Adapter(kArenaAllocGraphBuilder)) {
+  DCHECK(ShouldBuildTree(table));
+  FindLeaves();
+  // A tree with L leaves has L - 1 inner nodes. The non-root nodes use the dex pcs of
+  // the first 2 * L - 2 of the 2 * N entries of the table.
+  nodes_.reserve(2u * leaves_.size() - 1u);
+  BuildNodes(0u, leaves_.size());
+  DCHECK_EQ(nodes_.size(), 2u * leaves_.size() - 1u);
+}
+
+void SparseSwitchTree::FindLeaves() {
+  // The verifier checks that the keys of a sparse-switch are sorted in ascending order.
+  // Greedily take the longest dense cluster starting at each case.
+  const size_t num_cases = table_.GetNumEntries();
+  size_t first_case = 0u;
+  while (first_case != num_cases) {
+    const int64_t first_key = GetKey(first_case);
+    size_t last_case = first_case;
+    size_t end_search = std::min(num_cases, first_case + kMaxClusterCases);
+    for (size_t case_index = first_case + 1u; case_index != end_search; ++case_index) {
+      int64_t range = static_cast<int64_t>(GetKey(case_index)) - first_key + 1;
+      int64_t num_cluster_cases = static_cast<int64_t>(case_index - first_case + 1u);
+      DCHECK_GE(range, num_cluster_cases);
+      if (range <= static_cast<int64_t>(kMinClusterDensityFactor) * num_cluster_cases) {
+        last_case = case_index;
+      } else if (range > static_cast<int64_t>(kMinClusterDensityFactor * kMaxClusterCases)) {
+        break;
+      }
+    }
+    if (last_case - first_case + 1u < kMinClusterCases) {
+      last_case = first_case;
+    }
+    leaves_.push_back({first_case, last_case});
+    first_case = last_case + 1u;
+  }
+}
+
+size_t SparseSwitchTree::BuildNodes(size_t first_leaf, size_t end_leaf) {
+  DCHECK_LT(first_leaf, end_leaf);
+  size_t index = nodes_.size();
+  if (end_leaf - first_leaf == 1u) {
+    const Leaf& leaf = leaves_[first_leaf];
+    NodeKind kind =
+        (leaf.first_case == leaf.last_case) ? NodeKind::kEqual : NodeKind::kPackedSwitch;
+    nodes_.push_back({kind, GetKey(leaf.first_case), leaf.first_case, leaf.last_case, 0u, 0u});
+    return index;
+  }
+  size_t middle_leaf = first_leaf + (end_leaf - first_leaf) / 2u;
+  const Leaf& pivot_leaf = leaves_[middle_leaf];
+  nodes_.push_back({NodeKind::kLessThan,
+                    GetKey(pivot_leaf.first_case),
+                    leaves_[first_leaf].first_case,
+                    leaves_[end_leaf - 1u].last_case,
+                    0u,
+                    0u});
+  size_t left = BuildNodes(first_leaf, middle_leaf);
+  size_t right = BuildNodes(middle_leaf, end_leaf);
+  nodes_[index].left = left;
+  nodes_[index].right = right;
+  return index;
+}
+
+}  // namespace art
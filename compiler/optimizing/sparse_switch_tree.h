@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_SPARSE_SWITCH_TREE_H_
+#define ART_COMPILER_OPTIMIZING_SPARSE_SWITCH_TREE_H_
+
+#include "base/macros.h"
+#include "base/scoped_arena_allocator.h"
+#include "base/scoped_arena_containers.h"
+#include "base/value_object.h"
+#include "dex/bytecode_utils.h"
+
+namespace art HIDDEN {
+
+// The lowering of a large sparse-switch: the sorted keys are split into dense clusters, which
+// become HPackedSwitch jump tables, and single keys, which are compared for equality. These
+// leaves are joined by a balanced binary search tree of `value < pivot` tests.
+//
+// The HBasicBlockBuilder creates and connects one block per node and the HInstructionBuilder
+// fills them, so both build the same tree from the DexSwitchTable. The root node is the block
+// of the switch instruction. The other nodes, numbered in preorder, are stored under the dex
+// pcs of the entries of the switch table, like the blocks of the linear decision tree.
+class SparseSwitchTree : public ValueObject {
+ public:
+  enum class NodeKind {
+    kLessThan,      // `value < key`, true to `left`, false to `right`.
+    kEqual,         // `value == key`, true to the target of `first_case`, false to the default.
+    kPackedSwitch,  // A jump table for the cases `first_case` to `last_case`.
+  };
+
+  struct Node {
+    NodeKind kind;
+    int32_t key;  // The pivot, the compared key or the first key of the jump table.
+    size_t first_case;
+    size_t last_case;
+    size_t left;
+    size_t right;
+  };
+
+  // Whether the switch is large enough for the tree. Smaller sparse switches and small packed
+  // switches use the linear decision tree, larger packed switches a single HPackedSwitch.
+  static bool ShouldBuildTree(const DexSwitchTable& table) {
+    return table.IsSparse() && table.GetNumEntries() >= kMinCasesForTree;
+  }
+
+  SparseSwitchTree(const DexSwitchTable& table, ScopedArenaAllocator* allocator);
+
+  size_t GetNumberOfNodes() const { return nodes_.size(); }
+  const Node& GetNode(size_t index) const { return nodes_[index]; }
+
+  // The dex pc under which the block of the non-root node `index` is stored.
+  uint32_t GetStoreDexPcForNode(size_t index) const {
+    DCHECK_NE(index, 0u);
+    return table_.GetDexPcForIndex(index - 1u);
+  }
+
+  int32_t GetKey(size_t case_index) const { return table_.GetEntryAt(case_index); }
+  int32_t GetTargetOffset(size_t case_index) const {
+    return table_.GetEntryAt(table_.GetFirstValueIndex() + case_index);
+  }
+
+  // The number of jump table entries of a kPackedSwitch node.
+  uint32_t GetNumberOfEntries(const Node& node) const {
+    DCHECK(node.kind == NodeKind::kPackedSwitch);
+    return static_cast<uint32_t>(GetKey(node.last_case)) -
+           static_cast<uint32_t>(GetKey(node.first_case)) + 1u;
+  }
+
+  // Calls `visit(case_index)` for each entry of the jump table of a kPackedSwitch node, with
+  // `case_index` equal to `kDefaultCase` for the values that have no case.
+  template <typename Visitor>
+  void VisitJumpTable(const Node& node, Visitor&& visit) const {
+    DCHECK(node.kind == NodeKind::kPackedSwitch);
+    size_t case_index = node.first_case;
+    for (int64_t value = GetKey(node.first_case); value <= GetKey(node.last_case); ++value) {
+      if (GetKey(case_index) == value) {
+        visit(case_index);
+        ++case_index;
+      } else {
+        visit(kDefaultCase);
+      }
+    }
+    DCHECK_EQ(case_index, node.last_case + 1u);
+  }
+
+  static constexpr size_t kDefaultCase = static_cast<size_t>(-1);
+
+ private:
+  struct Leaf {
+    size_t first_case;
+    size_t last_case;
+  };
+
+  void FindLeaves();
+  size_t BuildNodes(size_t first_leaf, size_t end_leaf);
+
+  // Sparse switches with fewer cases are faster as a linear decision tree.
+  static constexpr uint16_t kMinCasesForTree = 6u;
+  // The minimum number of cases of a jump table, and the maximum, which bounds the search for
+  // the clusters.
+  static constexpr size_t kMinClusterCases = 4u;
+  static constexpr size_t kMaxClusterCases = 256u;
+  // A jump table must have at least one case for every two entries.
+  static constexpr size_t kMinClusterDensityFactor = 2u;
+
+  const DexSwitchTable& table_;
+  ScopedArenaVector<Leaf> leaves_;
+  ScopedArenaVector<Node> nodes_;
+
+  DISALLOW_COPY_AND_ASSIGN(SparseSwitchTree);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_SPARSE_SWITCH_TREE_H_
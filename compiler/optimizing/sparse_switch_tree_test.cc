@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sparse_switch_tree.h"
+
+#include "base/macros.h"
+#include "graph_checker.h"
+#include "optimizing_unit_test.h"
+
+namespace art HIDDEN {
+
+class SparseSwitchTreeTest : public CommonCompilerTest, public OptimizingUnitTestHelper {};
+
+TEST_F(SparseSwitchTreeTest, ClustersAndBinarySearch) {
+  // switch (v0) { case 0: case 1: case 2: case 3: case 4: case 100: case 200: case 300: }
+  const std::vector<uint16_t> data = ONE_REGISTER_CODE_ITEM(
+    Instruction::CONST_4 | 0 | 0,
+    Instruction::SPARSE_SWITCH, 5, 0,
+    Instruction::RETURN_VOID,
+    Instruction::RETURN_VOID,
+    static_cast<uint16_t>(Instruction::kSparseSwitchSignature), 8,
+    0, 0, 1, 0, 2, 0, 3, 0, 4, 0, 100, 0, 200, 0, 300, 0,
+    4, 0, 4, 0, 4, 0, 4, 0, 4, 0, 4, 0, 4, 0, 4, 0);
+
+  HGraph* graph = CreateCFG(data);
+  ASSERT_NE(graph, nullptr);
+  GraphChecker graph_checker(graph);
+  graph_checker.Run();
+  ASSERT_TRUE(graph_checker.IsValid());
+
+  // The dense keys 0 to 4 become a jump table, the others are compared one by one. The
+  // four leaves are joined by three `value < pivot` tests, two on each path.
+  size_t num_less_than = 0u;
+  size_t num_equal = 0u;
+  size_t num_packed_switch = 0u;
+  for (HBasicBlock* block : graph->GetBlocks()) {
+    if (block == nullptr) {
+      continue;
+    }
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      if (instruction->IsLessThan()) {
+        ++num_less_than;
+      } else if (instruction->IsEqual()) {
+        ++num_equal;
+      } else if (instruction->IsPackedSwitch()) {
+        ++num_packed_switch;
+        EXPECT_EQ(instruction->AsPackedSwitch()->GetStartValue(), 0);
+        EXPECT_EQ(instruction->AsPackedSwitch()->GetNumEntries(), 5u);
+      }
+    }
+  }
+  EXPECT_EQ(num_less_than, 3u);
+  EXPECT_EQ(num_equal, 3u);
+  EXPECT_EQ(num_packed_switch, 1u);
+}
+
+TEST_F(SparseSwitchTreeTest, SmallSwitchUsesDecisionTree) {
+  // switch (v0) { case 0: case 100: case 200: }
+  const std::vector<uint16_t> data = ONE_REGISTER_CODE_ITEM(
+    Instruction::CONST_4 | 0 | 0,
+    Instruction::SPARSE_SWITCH, 5, 0,
+    Instruction::RETURN_VOID,
+    Instruction::RETURN_VOID,
+    static_cast<uint16_t>(Instruction::kSparseSwitchSignature), 3,
+    0, 0, 100, 0, 200, 0,
+    4, 0, 4, 0, 4, 0);
+
+  HGraph* graph = CreateCFG(data);
+  ASSERT_NE(graph, nullptr);
+  GraphChecker graph_checker(graph);
+  graph_checker.Run();
+  ASSERT_TRUE(graph_checker.IsValid());
+
+  size_t num_equal = 0u;
+  for (HBasicBlock* block : graph->GetBlocks()) {
+    if (block == nullptr) {
+      continue;
+    }
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      EXPECT_FALSE(it.Current()->IsLessThan());
+      EXPECT_FALSE(it.Current()->IsPackedSwitch());
+      if (it.Current()->IsEqual()) {
+        ++num_equal;
+      }
+    }
+  }
+  EXPECT_EQ(num_equal, 3u);
+}
+
+}  // namespace art
@@ -29,13 +29,33 @@ class WBEVisitor final : public HGraphVisitor {
       : HGraphVisitor(graph),
         scoped_allocator_(graph->GetArenaStack()),
         current_write_barriers_(scoped_allocator_.Adapter(kArenaAllocWBE)),
+        successor_write_barriers_(std::less<HBasicBlock*>(),
+                                  scoped_allocator_.Adapter(kArenaAllocWBE)),
         stats_(stats) {}
 
   void VisitBasicBlock(HBasicBlock* block) override {
-    // We clear the map to perform this optimization only in the same block. Doing it across blocks
-    // would entail non-trivial merging of states.
+    // A block with a single predecessor starts with the write barriers at the end of that
+    // predecessor, which dominates it and was visited before it in reverse post order. We clear
+    // the map for blocks with several predecessors, as that would entail non-trivial merging of
+    // states. A loop header always has several predecessors, so a write barrier before a loop is
+    // never used in the loop and a write barrier in the loop body never crosses the back edge.
+    // That is also required for correctness: the suspend check of the loop is a GC point.
     current_write_barriers_.clear();
+    auto it = successor_write_barriers_.find(block);
+    if (it != successor_write_barriers_.end()) {
+      DCHECK(HasSinglePredecessor(block));
+      current_write_barriers_.swap(it->second);
+      successor_write_barriers_.erase(it);
+    }
     HGraphVisitor::VisitBasicBlock(block);
+    if (current_write_barriers_.empty()) {
+      return;
+    }
+    for (HBasicBlock* successor : block->GetSuccessors()) {
+      if (HasSinglePredecessor(successor)) {
+        successor_write_barriers_.Put(successor, current_write_barriers_);
+      }
+    }
   }
 
   void VisitInstanceFieldSet(HInstanceFieldSet* instruction) override {
@@ -54,7 +74,7 @@ class WBEVisitor final : public HGraphVisitor {
       DCHECK(it->second->IsInstanceFieldSet());
       DCHECK(it->second->AsInstanceFieldSet()->GetWriteBarrierKind() !=
              WriteBarrierKind::kDontEmit);
-      DCHECK_EQ(it->second->GetBlock(), instruction->GetBlock());
+      DCHECK(it->second->GetBlock()->Dominates(instruction->GetBlock()));
       it->second->AsInstanceFieldSet()->SetWriteBarrierKind(WriteBarrierKind::kEmitNoNullCheck);
       instruction->SetWriteBarrierKind(WriteBarrierKind::kDontEmit);
       MaybeRecordStat(stats_, MethodCompilationStat::kRemovedWriteBarrier);
@@ -80,7 +100,7 @@ class WBEVisitor final : public HGraphVisitor {
     if (it != current_write_barriers_.end()) {
       DCHECK(it->second->IsStaticFieldSet());
       DCHECK(it->second->AsStaticFieldSet()->GetWriteBarrierKind() != WriteBarrierKind::kDontEmit);
-      DCHECK_EQ(it->second->GetBlock(), instruction->GetBlock());
+      DCHECK(it->second->GetBlock()->Dominates(instruction->GetBlock()));
       it->second->AsStaticFieldSet()->SetWriteBarrierKind(WriteBarrierKind::kEmitNoNullCheck);
       instruction->SetWriteBarrierKind(WriteBarrierKind::kDontEmit);
       MaybeRecordStat(stats_, MethodCompilationStat::kRemovedWriteBarrier);
@@ -108,7 +128,7 @@ class WBEVisitor final : public HGraphVisitor {
     if (it != current_write_barriers_.end()) {
       DCHECK(it->second->IsArraySet());
       DCHECK(it->second->AsArraySet()->GetWriteBarrierKind() != WriteBarrierKind::kDontEmit);
-      DCHECK_EQ(it->second->GetBlock(), instruction->GetBlock());
+      DCHECK(it->second->GetBlock()->Dominates(instruction->GetBlock()));
       // We never skip the null check in ArraySets so that value is already set.
       DCHECK(it->second->AsArraySet()->GetWriteBarrierKind() == WriteBarrierKind::kEmitNoNullCheck);
       instruction->SetWriteBarrierKind(WriteBarrierKind::kDontEmit);
@@ -129,6 +149,12 @@ class WBEVisitor final : public HGraphVisitor {
  private:
   void ClearCurrentValues() { current_write_barriers_.clear(); }
 
+  // Catch blocks are entered from the throwing instructions of their try blocks, not from the
+  // end of their predecessors, so they never inherit write barriers.
+  static bool HasSinglePredecessor(HBasicBlock* block) {
+    return block->GetPredecessors().size() == 1u && !block->IsCatchBlock();
+  }
+
   HInstruction* HuntForOriginalReference(HInstruction* ref) const {
     // An original reference can be transformed by instructions like:
     //   i0 NewArray
@@ -147,6 +173,11 @@ class WBEVisitor final : public HGraphVisitor {
   // `InstructionWhereTheWriteBarrierIs` is used for DCHECKs only.
   ScopedArenaHashMap<HInstruction*, HInstruction*> current_write_barriers_;
 
+  // The write barriers at the end of the single predecessor of each of the keys, for the
+  // successors that are not visited yet.
+  ScopedArenaSafeMap<HBasicBlock*, ScopedArenaHashMap<HInstruction*, HInstruction*>>
+      successor_write_barriers_;
+
   OptimizingCompilerStats* const stats_;
 
   DISALLOW_COPY_AND_ASSIGN(WBEVisitor);
@@ -32,6 +32,11 @@ namespace art HIDDEN {
 //   o.inner_obj3 = io3;
 // We can keep the write barrier for `inner_obj` and remove the other two.
 //
+// The write barriers are tracked across a block boundary when the successor has a single
+// predecessor, so that a write barrier also covers the stores to the same receiver in the
+// branches of an `if` that follows it. Any instruction that can trigger a GC, including the
+// suspend check of a loop, ends the tracking, since the GC may clean the card.
+//
 // In order to do this, we set the WriteBarrierKind of the instruction. The instruction's kind are
 // set to kEmitNoNullCheck (if this write barrier coalesced other write barriers, we don't want to
 // perform the null check optimization), or to kDontEmit (if the write barrier as a whole is not
@@ -147,7 +147,7 @@ class AssemblerTestBase : public testing::Test {
                 "--compile",
                 "-target",
                 "riscv64-linux-gnu",
-                "-march=rv64imafd",
+                "-march=rv64imafdv_zba_zbb_zbs",
                 // Force the assembler to fully emit branch instructions instead of leaving
                 // offsets unresolved with relocation information for the linker.
                 "-mno-relax"};
@@ -174,7 +174,8 @@ class AssemblerTestBase : public testing::Test {
                 "--disassemble",
                 "--no-print-imm-hex",
                 "--no-show-raw-insn",
-                "--mattr=+F,+D,+A",  // Disassemble "F", "D" and "A" Standard Extensions.
+                // Disassemble "F", "D", "A", "V", "Zba", "Zbb" and "Zbs" Standard Extensions.
+                "--mattr=+F,+D,+A,+V,+zba,+zbb,+zbs",
                 "-M",
                 "no-aliases"};
       default:
@@ -20,6 +20,7 @@
 #include "base/casts.h"
 #include "base/logging.h"
 #include "base/memory_region.h"
+#include "heap_poisoning.h"
 
 namespace art HIDDEN {
 namespace riscv64 {
@@ -88,10 +89,16 @@ void Riscv64Assembler::Auipc(XRegister rd, uint32_t imm20) {
 // Jump instructions (RV32I), opcode = 0x67, 0x6f
 
 void Riscv64Assembler::Jal(XRegister rd, int32_t offset) {
+  if (rd != Zero) {
+    InvalidateVectorConfig();  // The callee may change the vector configuration.
+  }
   EmitJ(offset, rd, 0x6F);
 }
 
 void Riscv64Assembler::Jalr(XRegister rd, XRegister rs1, int32_t offset) {
+  if (rd != Zero) {
+    InvalidateVectorConfig();  // The callee may change the vector configuration.
+  }
   EmitI(offset, rs1, 0x0, rd, 0x67);
 }
 
@@ -786,6 +793,607 @@ void Riscv64Assembler::FClassD(XRegister rd, FRegister rs1) {
 
 /////////////////////////////// RV64 "FD" Instructions  END ///////////////////////////////
 
+/////////////////////////////// RV64 "Zba" Instructions  START ///////////////////////////////
+
+void Riscv64Assembler::AddUw(XRegister rd, XRegister rs1, XRegister rs2) {
+  EmitR(0x4, rs2, rs1, 0x0, rd, 0x3b);
+}
+
+void Riscv64Assembler::Sh1Add(XRegister rd, XRegister rs1, XRegister rs2) {
+  EmitR(0x10, rs2, rs1, 0x2, rd, 0x33);
+}
+
+void Riscv64Assembler::Sh1AddUw(XRegister rd, XRegister rs1, XRegister rs2) {
+  EmitR(0x10, rs2, rs1, 0x2, rd, 0x3b);
+}
+
+void Riscv64Assembler::Sh2Add(XRegister rd, XRegister rs1, XRegister rs2) {
+  EmitR(0x10, rs2, rs1, 0x4, rd, 0x33);
+}
+
+void Riscv64Assembler::Sh2AddUw(XRegister rd, XRegister rs1, XRegister rs2) {
+  EmitR(0x10, rs2, rs1, 0x4, rd, 0x3b);
+}
+
+void Riscv64Assembler::Sh3Add(XRegister rd, XRegister rs1, XRegister rs2) {
+  EmitR(0x10, rs2, rs1, 0x6, rd, 0x33);
+}
+
+void Riscv64Assembler::Sh3AddUw(XRegister rd, XRegister rs1, XRegister rs2) {
+  EmitR(0x10, rs2, rs1, 0x6, rd, 0x3b);
+}
+
+void Riscv64Assembler::SlliUw(XRegister rd, XRegister rs1, int32_t shamt) {
+  EmitI6(0x2, shamt, rs1, 0x1, rd, 0x1b);
+}
+
+//////////////////////////////// RV64 "Zba" Instructions  END ////////////////////////////////
+
+/////////////////////////////// RV64 "Zbb" Instructions  START ///////////////////////////////
+
+void Riscv64Assembler::Andn(XRegister rd, XRegister rs1, XRegister rs2) {
+  EmitR(0x20, rs2, rs1, 0x7, rd, 0x33);
+}
+
+void Riscv64Assembler::Orn(XRegister rd, XRegister rs1, XRegister rs2) {
+  EmitR(0x20, rs2, rs1, 0x6, rd, 0x33);
+}
+
+void Riscv64Assembler::Xnor(XRegister rd, XRegister rs1, XRegister rs2) {
+  EmitR(0x20, rs2, rs1, 0x4, rd, 0x33);
+}
+
+void Riscv64Assembler::Clz(XRegister rd, XRegister rs1) {
+  EmitI(0x600, rs1, 0x1, rd, 0x13);
+}
+
+void Riscv64Assembler::Clzw(XRegister rd, XRegister rs1) {
+  EmitI(0x600, rs1, 0x1, rd, 0x1b);
+}
+
+void Riscv64Assembler::Ctz(XRegister rd, XRegister rs1) {
+  EmitI(0x601, rs1, 0x1, rd, 0x13);
+}
+
+void Riscv64Assembler::Ctzw(XRegister rd, XRegister rs1) {
+  EmitI(0x601, rs1, 0x1, rd, 0x1b);
+}
+
+void Riscv64Assembler::Cpop(XRegister rd, XRegister rs1) {
+  EmitI(0x602, rs1, 0x1, rd, 0x13);
+}
+
+void Riscv64Assembler::Cpopw(XRegister rd, XRegister rs1) {
+  EmitI(0x602, rs1, 0x1, rd, 0x1b);
+}
+
+void Riscv64Assembler::Min(XRegister rd, XRegister rs1, XRegister rs2) {
+  EmitR(0x5, rs2, rs1, 0x4, rd, 0x33);
+}
+
+void Riscv64Assembler::Minu(XRegister rd, XRegister rs1, XRegister rs2) {
+  EmitR(0x5, rs2, rs1, 0x5, rd, 0x33);
+}
+
+void Riscv64Assembler::Max(XRegister rd, XRegister rs1, XRegister rs2) {
+  EmitR(0x5, rs2, rs1, 0x6, rd, 0x33);
+}
+
+void Riscv64Assembler::Maxu(XRegister rd, XRegister rs1, XRegister rs2) {
+  EmitR(0x5, rs2, rs1, 0x7, rd, 0x33);
+}
+
+void Riscv64Assembler::Rol(XRegister rd, XRegister rs1, XRegister rs2) {
+  EmitR(0x30, rs2, rs1, 0x1, rd, 0x33);
+}
+
+void Riscv64Assembler::Rolw(XRegister rd, XRegister rs1, XRegister rs2) {
+  EmitR(0x30, rs2, rs1, 0x1, rd, 0x3b);
+}
+
+void Riscv64Assembler::Ror(XRegister rd, XRegister rs1, XRegister rs2) {
+  EmitR(0x30, rs2, rs1, 0x5, rd, 0x33);
+}
+
+void Riscv64Assembler::Rorw(XRegister rd, XRegister rs1, XRegister rs2) {
+  EmitR(0x30, rs2, rs1, 0x5, rd, 0x3b);
+}
+
+void Riscv64Assembler::Rori(XRegister rd, XRegister rs1, int32_t shamt) {
+  CHECK_LT(static_cast<uint32_t>(shamt), 64u);
+  EmitI6(0x18, shamt, rs1, 0x5, rd, 0x13);
+}
+
+void Riscv64Assembler::Roriw(XRegister rd, XRegister rs1, int32_t shamt) {
+  CHECK_LT(static_cast<uint32_t>(shamt), 32u);
+  EmitR(0x30, shamt, rs1, 0x5, rd, 0x1b);
+}
+
+void Riscv64Assembler::OrcB(XRegister rd, XRegister rs1) {
+  EmitI(0x287, rs1, 0x5, rd, 0x13);
+}
+
+void Riscv64Assembler::Rev8(XRegister rd, XRegister rs1) {
+  EmitI(0x6b8, rs1, 0x5, rd, 0x13);
+}
+
+void Riscv64Assembler::ZbbSextB(XRegister rd, XRegister rs1) {
+  EmitI(0x604, rs1, 0x1, rd, 0x13);
+}
+
+void Riscv64Assembler::ZbbSextH(XRegister rd, XRegister rs1) {
+  EmitI(0x605, rs1, 0x1, rd, 0x13);
+}
+
+void Riscv64Assembler::ZbbZextH(XRegister rd, XRegister rs1) {
+  EmitR(0x4, 0x0, rs1, 0x4, rd, 0x3b);
+}
+
+//////////////////////////////// RV64 "Zbb" Instructions  END ////////////////////////////////
+
+/////////////////////////////// RV64 "Zbs" Instructions  START ///////////////////////////////
+
+void Riscv64Assembler::Bclr(XRegister rd, XRegister rs1, XRegister rs2) {
+  EmitR(0x24, rs2, rs1, 0x1, rd, 0x33);
+}
+
+void Riscv64Assembler::Bclri(XRegister rd, XRegister rs1, int32_t shamt) {
+  CHECK_LT(static_cast<uint32_t>(shamt), 64u);
+  EmitI6(0x12, shamt, rs1, 0x1, rd, 0x13);
+}
+
+void Riscv64Assembler::Bext(XRegister rd, XRegister rs1, XRegister rs2) {
+  EmitR(0x24, rs2, rs1, 0x5, rd, 0x33);
+}
+
+void Riscv64Assembler::Bexti(XRegister rd, XRegister rs1, int32_t shamt) {
+  CHECK_LT(static_cast<uint32_t>(shamt), 64u);
+  EmitI6(0x12, shamt, rs1, 0x5, rd, 0x13);
+}
+
+void Riscv64Assembler::Binv(XRegister rd, XRegister rs1, XRegister rs2) {
+  EmitR(0x34, rs2, rs1, 0x1, rd, 0x33);
+}
+
+void Riscv64Assembler::Binvi(XRegister rd, XRegister rs1, int32_t shamt) {
+  CHECK_LT(static_cast<uint32_t>(shamt), 64u);
+  EmitI6(0x1a, shamt, rs1, 0x1, rd, 0x13);
+}
+
+void Riscv64Assembler::Bset(XRegister rd, XRegister rs1, XRegister rs2) {
+  EmitR(0x14, rs2, rs1, 0x1, rd, 0x33);
+}
+
+void Riscv64Assembler::Bseti(XRegister rd, XRegister rs1, int32_t shamt) {
+  CHECK_LT(static_cast<uint32_t>(shamt), 64u);
+  EmitI6(0xa, shamt, rs1, 0x1, rd, 0x13);
+}
+
+//////////////////////////////// RV64 "Zbs" Instructions  END ////////////////////////////////
+
+/////////////////////////////// T-Head Vendor Instructions  START ///////////////////////////////
+
+// "XTheadBa" extension: opcode = 0x0b, funct3 = 0x1, funct7 = imm2
+
+void Riscv64Assembler::ThAddsl(XRegister rd, XRegister rs1, XRegister rs2, int32_t imm2) {
+  CHECK(IsUint<2>(imm2)) << imm2;
+  EmitR(imm2, rs2, rs1, 0x1, rd, 0x0b);
+}
+
+// "XTheadBb" extension: opcode = 0x0b, funct3 = 0x1 ~ 0x3
+
+void Riscv64Assembler::ThExt(XRegister rd, XRegister rs1, int32_t msb, int32_t lsb) {
+  CHECK(IsUint<6>(msb)) << msb;
+  CHECK(IsUint<6>(lsb)) << lsb;
+  CHECK_GE(msb, lsb);
+  EmitI6(msb, lsb, rs1, 0x2, rd, 0x0b);
+}
+
+void Riscv64Assembler::ThExtu(XRegister rd, XRegister rs1, int32_t msb, int32_t lsb) {
+  CHECK(IsUint<6>(msb)) << msb;
+  CHECK(IsUint<6>(lsb)) << lsb;
+  CHECK_GE(msb, lsb);
+  EmitI6(msb, lsb, rs1, 0x3, rd, 0x0b);
+}
+
+void Riscv64Assembler::ThFf0(XRegister rd, XRegister rs1) {
+  EmitR(0x42, 0x0, rs1, 0x1, rd, 0x0b);
+}
+
+void Riscv64Assembler::ThFf1(XRegister rd, XRegister rs1) {
+  EmitR(0x43, 0x0, rs1, 0x1, rd, 0x0b);
+}
+
+void Riscv64Assembler::ThRev(XRegister rd, XRegister rs1) {
+  EmitR(0x41, 0x0, rs1, 0x1, rd, 0x0b);
+}
+
+void Riscv64Assembler::ThRevw(XRegister rd, XRegister rs1) {
+  EmitR(0x48, 0x0, rs1, 0x1, rd, 0x0b);
+}
+
+void Riscv64Assembler::ThSrri(XRegister rd, XRegister rs1, int32_t shamt) {
+  CHECK_LT(static_cast<uint32_t>(shamt), 64u);
+  EmitI6(0x4, shamt, rs1, 0x1, rd, 0x0b);
+}
+
+void Riscv64Assembler::ThSrriw(XRegister rd, XRegister rs1, int32_t shamt) {
+  CHECK_LT(static_cast<uint32_t>(shamt), 32u);
+  EmitR(0xa, shamt, rs1, 0x1, rd, 0x0b);
+}
+
+void Riscv64Assembler::ThTstnbz(XRegister rd, XRegister rs1) {
+  EmitR(0x40, 0x0, rs1, 0x1, rd, 0x0b);
+}
+
+// "XTheadBs" extension: opcode = 0x0b, funct3 = 0x1, funct6 = 0x22
+
+void Riscv64Assembler::ThTst(XRegister rd, XRegister rs1, int32_t shamt) {
+  CHECK_LT(static_cast<uint32_t>(shamt), 64u);
+  EmitI6(0x22, shamt, rs1, 0x1, rd, 0x0b);
+}
+
+// "XTheadMemIdx" extension: opcode = 0x0b, funct3 = 0x4 (loads) or 0x5 (stores),
+// funct7 = funct5 << 2 | imm2
+
+void Riscv64Assembler::EmitThMemIdx(
+    uint32_t funct5, int32_t imm2, XRegister rs2, XRegister rs1, uint32_t funct3, XRegister rd) {
+  CHECK(IsUint<2>(imm2)) << imm2;
+  DCHECK(IsUint<5>(funct5));
+  EmitR(funct5 << 2 | static_cast<uint32_t>(imm2), rs2, rs1, funct3, rd, 0x0b);
+}
+
+void Riscv64Assembler::ThLrb(XRegister rd, XRegister rs1, XRegister rs2, int32_t imm2) {
+  EmitThMemIdx(0x0, imm2, rs2, rs1, 0x4, rd);
+}
+
+void Riscv64Assembler::ThLrbu(XRegister rd, XRegister rs1, XRegister rs2, int32_t imm2) {
+  EmitThMemIdx(0x10, imm2, rs2, rs1, 0x4, rd);
+}
+
+void Riscv64Assembler::ThLrh(XRegister rd, XRegister rs1, XRegister rs2, int32_t imm2) {
+  EmitThMemIdx(0x4, imm2, rs2, rs1, 0x4, rd);
+}
+
+void Riscv64Assembler::ThLrhu(XRegister rd, XRegister rs1, XRegister rs2, int32_t imm2) {
+  EmitThMemIdx(0x14, imm2, rs2, rs1, 0x4, rd);
+}
+
+void Riscv64Assembler::ThLrw(XRegister rd, XRegister rs1, XRegister rs2, int32_t imm2) {
+  EmitThMemIdx(0x8, imm2, rs2, rs1, 0x4, rd);
+}
+
+void Riscv64Assembler::ThLrwu(XRegister rd, XRegister rs1, XRegister rs2, int32_t imm2) {
+  EmitThMemIdx(0x18, imm2, rs2, rs1, 0x4, rd);
+}
+
+void Riscv64Assembler::ThLrd(XRegister rd, XRegister rs1, XRegister rs2, int32_t imm2) {
+  EmitThMemIdx(0xc, imm2, rs2, rs1, 0x4, rd);
+}
+
+void Riscv64Assembler::ThLurw(XRegister rd, XRegister rs1, XRegister rs2, int32_t imm2) {
+  EmitThMemIdx(0xa, imm2, rs2, rs1, 0x4, rd);
+}
+
+void Riscv64Assembler::ThLurwu(XRegister rd, XRegister rs1, XRegister rs2, int32_t imm2) {
+  EmitThMemIdx(0x1a, imm2, rs2, rs1, 0x4, rd);
+}
+
+void Riscv64Assembler::ThLurd(XRegister rd, XRegister rs1, XRegister rs2, int32_t imm2) {
+  EmitThMemIdx(0xe, imm2, rs2, rs1, 0x4, rd);
+}
+
+void Riscv64Assembler::ThSrb(XRegister rs3, XRegister rs1, XRegister rs2, int32_t imm2) {
+  EmitThMemIdx(0x0, imm2, rs2, rs1, 0x5, rs3);
+}
+
+void Riscv64Assembler::ThSrh(XRegister rs3, XRegister rs1, XRegister rs2, int32_t imm2) {
+  EmitThMemIdx(0x4, imm2, rs2, rs1, 0x5, rs3);
+}
+
+void Riscv64Assembler::ThSrw(XRegister rs3, XRegister rs1, XRegister rs2, int32_t imm2) {
+  EmitThMemIdx(0x8, imm2, rs2, rs1, 0x5, rs3);
+}
+
+void Riscv64Assembler::ThSrd(XRegister rs3, XRegister rs1, XRegister rs2, int32_t imm2) {
+  EmitThMemIdx(0xc, imm2, rs2, rs1, 0x5, rs3);
+}
+
+// "XTheadMac" extension: opcode = 0x0b, funct3 = 0x1, funct7 = 0x10 ~ 0x13
+
+void Riscv64Assembler::ThMula(XRegister rd, XRegister rs1, XRegister rs2) {
+  EmitR(0x10, rs2, rs1, 0x1, rd, 0x0b);
+}
+
+void Riscv64Assembler::ThMulaw(XRegister rd, XRegister rs1, XRegister rs2) {
+  EmitR(0x12, rs2, rs1, 0x1, rd, 0x0b);
+}
+
+void Riscv64Assembler::ThMuls(XRegister rd, XRegister rs1, XRegister rs2) {
+  EmitR(0x11, rs2, rs1, 0x1, rd, 0x0b);
+}
+
+void Riscv64Assembler::ThMulsw(XRegister rd, XRegister rs1, XRegister rs2) {
+  EmitR(0x13, rs2, rs1, 0x1, rd, 0x0b);
+}
+
+//////////////////////////////// T-Head Vendor Instructions  END ////////////////////////////////
+
+/////////////////////////////// RV64 "V" Instructions  START ///////////////////////////////
+
+// The `funct3` values of the vector arithmetic instructions, opcode = 0x57.
+static constexpr uint32_t kOPIVV = 0x0;
+static constexpr uint32_t kOPFVV = 0x1;
+static constexpr uint32_t kOPMVV = 0x2;
+static constexpr uint32_t kOPIVI = 0x3;
+static constexpr uint32_t kOPIVX = 0x4;
+static constexpr uint32_t kOPFVF = 0x5;
+static constexpr uint32_t kOPMVX = 0x6;
+static constexpr uint32_t kOPCFG = 0x7;
+
+static uint32_t EncodeSimm5(int32_t imm5) {
+  CHECK(IsInt<5>(imm5)) << imm5;
+  return static_cast<uint32_t>(imm5) & 0x1fu;
+}
+
+// Configuration-setting instructions, funct3 = 0x7
+
+void Riscv64Assembler::VSetvli(XRegister rd, XRegister rs1, uint32_t vtypei) {
+  DCHECK(IsUint<11>(vtypei)) << vtypei;
+  InvalidateVectorConfig();
+  EmitI(static_cast<int32_t>(vtypei), rs1, kOPCFG, rd, 0x57);
+}
+
+void Riscv64Assembler::VSetivli(XRegister rd, uint32_t uimm5, uint32_t vtypei) {
+  CHECK(!has_xthead_vector_) << "vsetivli is not available in XTheadVector";
+  CHECK(IsUint<5>(uimm5)) << uimm5;
+  DCHECK(IsUint<10>(vtypei)) << vtypei;
+  InvalidateVectorConfig();
+  uint32_t encoding = 0x3u << 30 | vtypei << 20 | uimm5 << 15 | kOPCFG << 12 |
+                      static_cast<uint32_t>(rd) << 7 | 0x57;
+  Emit(encoding);
+}
+
+// Unit-stride loads and stores, opcode = 0x07, 0x27
+
+void Riscv64Assembler::EmitVMem(VectorSew eew, XRegister rs1, VRegister vd, uint32_t opcode) {
+  // The `width` field encodes the element width in RVV 1.0. The draft uses `vle.v` and `vse.v`
+  // (width = 0x7) for SEW-wide elements because the other widths sign- or zero-extend.
+  static constexpr uint32_t kWidth[] = {0x0, 0x5, 0x6, 0x7};
+  uint32_t width = has_xthead_vector_ ? 0x7u : kWidth[static_cast<uint32_t>(eew)];
+  // nf = 0, mew = 0, mop = 0 (unit-stride), vm = 1, lumop/sumop = 0.
+  uint32_t encoding = 1u << 25 | static_cast<uint32_t>(rs1) << 15 | width << 12 |
+                      static_cast<uint32_t>(vd) << 7 | opcode;
+  Emit(encoding);
+}
+
+void Riscv64Assembler::VLe8(VRegister vd, XRegister rs1) {
+  EmitVMem(VectorSew::kE8, rs1, vd, 0x07);
+}
+
+void Riscv64Assembler::VLe16(VRegister vd, XRegister rs1) {
+  EmitVMem(VectorSew::kE16, rs1, vd, 0x07);
+}
+
+void Riscv64Assembler::VLe32(VRegister vd, XRegister rs1) {
+  EmitVMem(VectorSew::kE32, rs1, vd, 0x07);
+}
+
+void Riscv64Assembler::VLe64(VRegister vd, XRegister rs1) {
+  EmitVMem(VectorSew::kE64, rs1, vd, 0x07);
+}
+
+void Riscv64Assembler::VSe8(VRegister vs3, XRegister rs1) {
+  EmitVMem(VectorSew::kE8, rs1, vs3, 0x27);
+}
+
+void Riscv64Assembler::VSe16(VRegister vs3, XRegister rs1) {
+  EmitVMem(VectorSew::kE16, rs1, vs3, 0x27);
+}
+
+void Riscv64Assembler::VSe32(VRegister vs3, XRegister rs1) {
+  EmitVMem(VectorSew::kE32, rs1, vs3, 0x27);
+}
+
+void Riscv64Assembler::VSe64(VRegister vs3, XRegister rs1) {
+  EmitVMem(VectorSew::kE64, rs1, vs3, 0x27);
+}
+
+// Integer arithmetic instructions, opcode = 0x57, funct3 = 0x0, 0x2, 0x3, 0x4 or 0x6
+
+void Riscv64Assembler::VAddVV(VRegister vd, VRegister vs2, VRegister vs1) {
+  EmitV(0x0, vs2, vs1, kOPIVV, vd);
+}
+
+void Riscv64Assembler::VAddVX(VRegister vd, VRegister vs2, XRegister rs1) {
+  EmitV(0x0, vs2, rs1, kOPIVX, vd);
+}
+
+void Riscv64Assembler::VAddVI(VRegister vd, VRegister vs2, int32_t imm5) {
+  EmitV(0x0, vs2, EncodeSimm5(imm5), kOPIVI, vd);
+}
+
+void Riscv64Assembler::VSubVV(VRegister vd, VRegister vs2, VRegister vs1) {
+  EmitV(0x2, vs2, vs1, kOPIVV, vd);
+}
+
+void Riscv64Assembler::VSubVX(VRegister vd, VRegister vs2, XRegister rs1) {
+  EmitV(0x2, vs2, rs1, kOPIVX, vd);
+}
+
+void Riscv64Assembler::VRsubVX(VRegister vd, VRegister vs2, XRegister rs1) {
+  EmitV(0x3, vs2, rs1, kOPIVX, vd);
+}
+
+void Riscv64Assembler::VRsubVI(VRegister vd, VRegister vs2, int32_t imm5) {
+  EmitV(0x3, vs2, EncodeSimm5(imm5), kOPIVI, vd);
+}
+
+void Riscv64Assembler::VMinuVV(VRegister vd, VRegister vs2, VRegister vs1) {
+  EmitV(0x4, vs2, vs1, kOPIVV, vd);
+}
+
+void Riscv64Assembler::VMinVV(VRegister vd, VRegister vs2, VRegister vs1) {
+  EmitV(0x5, vs2, vs1, kOPIVV, vd);
+}
+
+void Riscv64Assembler::VMaxuVV(VRegister vd, VRegister vs2, VRegister vs1) {
+  EmitV(0x6, vs2, vs1, kOPIVV, vd);
+}
+
+void Riscv64Assembler::VMaxVV(VRegister vd, VRegister vs2, VRegister vs1) {
+  EmitV(0x7, vs2, vs1, kOPIVV, vd);
+}
+
+void Riscv64Assembler::VAndVV(VRegister vd, VRegister vs2, VRegister vs1) {
+  EmitV(0x9, vs2, vs1, kOPIVV, vd);
+}
+
+void Riscv64Assembler::VOrVV(VRegister vd, VRegister vs2, VRegister vs1) {
+  EmitV(0xa, vs2, vs1, kOPIVV, vd);
+}
+
+void Riscv64Assembler::VXorVV(VRegister vd, VRegister vs2, VRegister vs1) {
+  EmitV(0xb, vs2, vs1, kOPIVV, vd);
+}
+
+void Riscv64Assembler::VXorVI(VRegister vd, VRegister vs2, int32_t imm5) {
+  EmitV(0xb, vs2, EncodeSimm5(imm5), kOPIVI, vd);
+}
+
+void Riscv64Assembler::VSllVX(VRegister vd, VRegister vs2, XRegister rs1) {
+  EmitV(0x25, vs2, rs1, kOPIVX, vd);
+}
+
+void Riscv64Assembler::VSllVI(VRegister vd, VRegister vs2, uint32_t uimm5) {
+  CHECK(IsUint<5>(uimm5)) << uimm5;
+  EmitV(0x25, vs2, uimm5, kOPIVI, vd);
+}
+
+void Riscv64Assembler::VSrlVX(VRegister vd, VRegister vs2, XRegister rs1) {
+  EmitV(0x28, vs2, rs1, kOPIVX, vd);
+}
+
+void Riscv64Assembler::VSrlVI(VRegister vd, VRegister vs2, uint32_t uimm5) {
+  CHECK(IsUint<5>(uimm5)) << uimm5;
+  EmitV(0x28, vs2, uimm5, kOPIVI, vd);
+}
+
+void Riscv64Assembler::VSraVX(VRegister vd, VRegister vs2, XRegister rs1) {
+  EmitV(0x29, vs2, rs1, kOPIVX, vd);
+}
+
+void Riscv64Assembler::VSraVI(VRegister vd, VRegister vs2, uint32_t uimm5) {
+  CHECK(IsUint<5>(uimm5)) << uimm5;
+  EmitV(0x29, vs2, uimm5, kOPIVI, vd);
+}
+
+void Riscv64Assembler::VMulVV(VRegister vd, VRegister vs2, VRegister vs1) {
+  EmitV(0x25, vs2, vs1, kOPMVV, vd);
+}
+
+void Riscv64Assembler::VMaccVV(VRegister vd, VRegister vs1, VRegister vs2) {
+  EmitV(0x2d, vs2, vs1, kOPMVV, vd);
+}
+
+void Riscv64Assembler::VNmsacVV(VRegister vd, VRegister vs1, VRegister vs2) {
+  EmitV(0x2f, vs2, vs1, kOPMVV, vd);
+}
+
+// Integer move instructions, opcode = 0x57, funct6 = 0x17 (vmv.v.*) or 0x10 (vmv.x.s, vmv.s.x)
+// The draft encodes vmv.x.s as `vext.x.v rd, vs2, x0` (funct6 = 0xc) and vmv.s.x with
+// funct6 = 0xd.
+
+void Riscv64Assembler::VMvVV(VRegister vd, VRegister vs1) {
+  EmitV(0x17, V0, vs1, kOPIVV, vd);
+}
+
+void Riscv64Assembler::VMvVX(VRegister vd, XRegister rs1) {
+  EmitV(0x17, V0, rs1, kOPIVX, vd);
+}
+
+void Riscv64Assembler::VMvVI(VRegister vd, int32_t imm5) {
+  EmitV(0x17, V0, EncodeSimm5(imm5), kOPIVI, vd);
+}
+
+void Riscv64Assembler::VMvXS(XRegister rd, VRegister vs2) {
+  EmitV(has_xthead_vector_ ? 0xc : 0x10, vs2, Zero, kOPMVV, rd);
+}
+
+void Riscv64Assembler::VMvSX(VRegister vd, XRegister rs1) {
+  EmitV(has_xthead_vector_ ? 0xd : 0x10, V0, rs1, kOPMVX, vd);
+}
+
+// Integer reduction instructions, opcode = 0x57, funct3 = 0x2
+
+void Riscv64Assembler::VRedsumVS(VRegister vd, VRegister vs2, VRegister vs1) {
+  EmitV(0x0, vs2, vs1, kOPMVV, vd);
+}
+
+void Riscv64Assembler::VRedminuVS(VRegister vd, VRegister vs2, VRegister vs1) {
+  EmitV(0x4, vs2, vs1, kOPMVV, vd);
+}
+
+void Riscv64Assembler::VRedminVS(VRegister vd, VRegister vs2, VRegister vs1) {
+  EmitV(0x5, vs2, vs1, kOPMVV, vd);
+}
+
+void Riscv64Assembler::VRedmaxuVS(VRegister vd, VRegister vs2, VRegister vs1) {
+  EmitV(0x6, vs2, vs1, kOPMVV, vd);
+}
+
+void Riscv64Assembler::VRedmaxVS(VRegister vd, VRegister vs2, VRegister vs1) {
+  EmitV(0x7, vs2, vs1, kOPMVV, vd);
+}
+
+// Floating-point instructions, opcode = 0x57, funct3 = 0x1 or 0x5
+
+void Riscv64Assembler::VFaddVV(VRegister vd, VRegister vs2, VRegister vs1) {
+  EmitV(0x0, vs2, vs1, kOPFVV, vd);
+}
+
+void Riscv64Assembler::VFsubVV(VRegister vd, VRegister vs2, VRegister vs1) {
+  EmitV(0x2, vs2, vs1, kOPFVV, vd);
+}
+
+void Riscv64Assembler::VFmulVV(VRegister vd, VRegister vs2, VRegister vs1) {
+  EmitV(0x24, vs2, vs1, kOPFVV, vd);
+}
+
+void Riscv64Assembler::VFdivVV(VRegister vd, VRegister vs2, VRegister vs1) {
+  EmitV(0x20, vs2, vs1, kOPFVV, vd);
+}
+
+void Riscv64Assembler::VFsgnjnVV(VRegister vd, VRegister vs2, VRegister vs1) {
+  EmitV(0x9, vs2, vs1, kOPFVV, vd);
+}
+
+void Riscv64Assembler::VFsgnjxVV(VRegister vd, VRegister vs2, VRegister vs1) {
+  EmitV(0xa, vs2, vs1, kOPFVV, vd);
+}
+
+void Riscv64Assembler::VFcvtFXV(VRegister vd, VRegister vs2) {
+  // VFUNARY0 with vs1 = 0x3; the draft uses funct6 = 0x22 instead of 0x12.
+  EmitV(has_xthead_vector_ ? 0x22 : 0x12, vs2, 0x3u, kOPFVV, vd);
+}
+
+// Floating-point move instructions, opcode = 0x57, funct6 = 0x17 (vfmv.v.f) or
+// 0x10 (vfmv.f.s, vfmv.s.f; 0xc and 0xd in the draft)
+
+void Riscv64Assembler::VFmvVF(VRegister vd, FRegister rs1) {
+  EmitV(0x17, V0, rs1, kOPFVF, vd);
+}
+
+void Riscv64Assembler::VFmvFS(FRegister rd, VRegister vs2) {
+  EmitV(has_xthead_vector_ ? 0xc : 0x10, vs2, V0, kOPFVV, rd);
+}
+
+void Riscv64Assembler::VFmvSF(VRegister vd, FRegister rs1) {
+  EmitV(has_xthead_vector_ ? 0xd : 0x10, V0, rs1, kOPFVF, vd);
+}
+
+//////////////////////////////// RV64 "V" Instructions  END ////////////////////////////////
+
 ////////////////////////////// RV64 MACRO Instructions  START ///////////////////////////////
 
 // Pseudo instructions
@@ -805,13 +1413,25 @@ void Riscv64Assembler::Neg(XRegister rd, XRegister rs) { Sub(rd, Zero, rs); }
 void Riscv64Assembler::NegW(XRegister rd, XRegister rs) { Subw(rd, Zero, rs); }
 
 void Riscv64Assembler::SextB(XRegister rd, XRegister rs) {
-  Slli(rd, rs, kXlen - 8u);
-  Srai(rd, rd, kXlen - 8u);
+  if (has_zbb_) {
+    ZbbSextB(rd, rs);
+  } else if (has_xthead_bb_) {
+    ThExt(rd, rs, 7, 0);
+  } else {
+    Slli(rd, rs, kXlen - 8u);
+    Srai(rd, rd, kXlen - 8u);
+  }
 }
 
 void Riscv64Assembler::SextH(XRegister rd, XRegister rs) {
-  Slli(rd, rs, kXlen - 16u);
-  Srai(rd, rd, kXlen - 16u);
+  if (has_zbb_) {
+    ZbbSextH(rd, rs);
+  } else if (has_xthead_bb_) {
+    ThExt(rd, rs, 15, 0);
+  } else {
+    Slli(rd, rs, kXlen - 16u);
+    Srai(rd, rd, kXlen - 16u);
+  }
 }
 
 void Riscv64Assembler::SextW(XRegister rd, XRegister rs) { Addiw(rd, rs, 0); }
@@ -819,13 +1439,25 @@ void Riscv64Assembler::SextW(XRegister rd, XRegister rs) { Addiw(rd, rs, 0); }
 void Riscv64Assembler::ZextB(XRegister rd, XRegister rs) { Andi(rd, rs, 0xff); }
 
 void Riscv64Assembler::ZextH(XRegister rd, XRegister rs) {
-  Slli(rd, rs, kXlen - 16u);
-  Srli(rd, rd, kXlen - 16u);
+  if (has_zbb_) {
+    ZbbZextH(rd, rs);
+  } else if (has_xthead_bb_) {
+    ThExtu(rd, rs, 15, 0);
+  } else {
+    Slli(rd, rs, kXlen - 16u);
+    Srli(rd, rd, kXlen - 16u);
+  }
 }
 
 void Riscv64Assembler::ZextW(XRegister rd, XRegister rs) {
-  Slli(rd, rs, kXlen - 32u);
-  Srli(rd, rd, kXlen - 32u);
+  if (has_zba_) {
+    AddUw(rd, rs, Zero);
+  } else if (has_xthead_bb_) {
+    ThExtu(rd, rs, 31, 0);
+  } else {
+    Slli(rd, rs, kXlen - 32u);
+    Srli(rd, rd, kXlen - 32u);
+  }
 }
 
 void Riscv64Assembler::Seqz(XRegister rd, XRegister rs) { Sltiu(rd, rs, 1); }
@@ -1073,6 +1705,81 @@ void Riscv64Assembler::AddConst64(XRegister rd, XRegister rs1, int64_t value) {
   AddConstImpl(this, rd, rs1, value, addi, add_large);
 }
 
+void Riscv64Assembler::ShiftAndAdd(XRegister rd, XRegister rs1, XRegister rs2, uint32_t shift) {
+  DCHECK_LT(shift, kXlen);
+  if (shift == 0u) {
+    Add(rd, rs1, rs2);
+  } else if (has_zba_ && shift <= 3u) {
+    // Note: The Zba instructions add the shifted first source operand.
+    if (shift == 1u) {
+      Sh1Add(rd, rs2, rs1);
+    } else if (shift == 2u) {
+      Sh2Add(rd, rs2, rs1);
+    } else {
+      Sh3Add(rd, rs2, rs1);
+    }
+  } else if (has_xthead_ba_ && shift <= 3u) {
+    ThAddsl(rd, rs1, rs2, shift);
+  } else if (rd != rs1) {
+    Slli(rd, rs2, shift);
+    Add(rd, rs1, rd);
+  } else {
+    ScratchRegisterScope srs(this);
+    XRegister tmp = srs.AllocateXRegister();
+    Slli(tmp, rs2, shift);
+    Add(rd, rs1, tmp);
+  }
+}
+
+uint32_t Riscv64Assembler::VTypeI(VectorSew sew) const {
+  // RVV 1.0: vtype = vma[7] | vta[6] | vsew[5:3] | vlmul[2:0].
+  // Draft:   vtype = vediv[6:5] | vsew[4:2] | vlmul[1:0].
+  // We use LMUL = 1 (vlmul = 0) with tail and mask undisturbed (vta = vma = 0).
+  return static_cast<uint32_t>(sew) << (has_xthead_vector_ ? 2 : 3);
+}
+
+void Riscv64Assembler::SetVectorConfig(uint32_t num_elements, VectorSew sew) {
+  DCHECK_NE(num_elements, 0u);
+  uint32_t config = num_elements << 2 | static_cast<uint32_t>(sew);
+  if (config == vector_config_) {
+    return;
+  }
+  if (!has_xthead_vector_ && IsUint<5>(num_elements)) {
+    VSetivli(Zero, num_elements, VTypeI(sew));
+  } else {
+    ScratchRegisterScope srs(this);
+    XRegister tmp = srs.AllocateXRegister();
+    Li(tmp, num_elements);
+    VSetvli(Zero, tmp, VTypeI(sew));
+  }
+  vector_config_ = config;
+}
+
+void Riscv64Assembler::PoisonHeapReference(XRegister reg) {
+  // Heap references are 32-bit values kept zero-extended in 64-bit registers.
+  // reg = -reg (mod 2^32).
+  Neg(reg, reg);
+  ZextW(reg, reg);
+}
+
+void Riscv64Assembler::UnpoisonHeapReference(XRegister reg) {
+  // reg = -reg (mod 2^32).
+  Neg(reg, reg);
+  ZextW(reg, reg);
+}
+
+void Riscv64Assembler::MaybePoisonHeapReference(XRegister reg) {
+  if (kPoisonHeapReferences) {
+    PoisonHeapReference(reg);
+  }
+}
+
+void Riscv64Assembler::MaybeUnpoisonHeapReference(XRegister reg) {
+  if (kPoisonHeapReferences) {
+    UnpoisonHeapReference(reg);
+  }
+}
+
 void Riscv64Assembler::Beqz(XRegister rs, Riscv64Label* label, bool is_bare) {
   Beq(rs, Zero, label, is_bare);
 }
@@ -1138,6 +1845,9 @@ void Riscv64Assembler::Bgtu(XRegister rs, XRegister rt, Riscv64Label* label, boo
 }
 
 void Riscv64Assembler::Jal(XRegister rd, Riscv64Label* label, bool is_bare) {
+  if (rd != Zero) {
+    InvalidateVectorConfig();  // The callee may change the vector configuration.
+  }
   Buncond(label, rd, is_bare);
 }
 
@@ -1718,6 +2428,9 @@ void Riscv64Assembler::Bind(Riscv64Label* label) {
   CHECK(!label->IsBound());
   uint32_t bound_pc = buffer_.Size();
 
+  // The vector configuration is not known on other paths reaching the label.
+  InvalidateVectorConfig();
+
   // Walk the list of branches referring to and preceding this label.
   // Store the previously unknown target addresses in them.
   while (label->IsLinked()) {
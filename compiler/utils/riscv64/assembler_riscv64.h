@@ -64,6 +64,36 @@ enum FenceType {
   kFenceDefault = 0xf,
 };
 
+// The `aq` and `rl` ordering bits of the "A" extension instructions.
+enum AqRl {
+  kAqRlNone = 0x0,
+  kAqRlRelease = 0x1,
+  kAqRlAcquire = 0x2,
+  kAqRlAcquireRelease = kAqRlAcquire | kAqRlRelease,
+};
+
+// The bits of the result of the FClassS/FClassD instructions.
+enum FPClassMaskType {
+  kNegativeInfinity = 0x001,
+  kNegativeNormal = 0x002,
+  kNegativeSubnormal = 0x004,
+  kNegativeZero = 0x008,
+  kPositiveZero = 0x010,
+  kPositiveSubnormal = 0x020,
+  kPositiveNormal = 0x040,
+  kPositiveInfinity = 0x080,
+  kSignalingNaN = 0x100,
+  kQuietNaN = 0x200,
+};
+
+// The selected element width (SEW) of the vector instructions, as encoded in `vtype.vsew`.
+enum class VectorSew : uint32_t {
+  kE8 = 0x0,
+  kE16 = 0x1,
+  kE32 = 0x2,
+  kE64 = 0x3,
+};
+
 class Riscv64Label : public Label {
  public:
   Riscv64Label() : prev_branch_id_(kNoPrevBranchId) {}
@@ -150,8 +180,16 @@ class Riscv64Assembler final : public Assembler {
         last_old_position_(0),
         last_branch_id_(0),
         available_scratch_core_registers_((1u << TMP) | (1u << TMP2)),
-        available_scratch_fp_registers_(1u << FTMP) {
-    UNUSED(instruction_set_features);
+        available_scratch_fp_registers_(1u << FTMP),
+        has_zba_(instruction_set_features != nullptr && instruction_set_features->HasZba()),
+        has_zbb_(instruction_set_features != nullptr && instruction_set_features->HasZbb()),
+        has_xthead_ba_(instruction_set_features != nullptr &&
+                       instruction_set_features->HasXTheadBa()),
+        has_xthead_bb_(instruction_set_features != nullptr &&
+                       instruction_set_features->HasXTheadBb()),
+        has_xthead_vector_(instruction_set_features != nullptr &&
+                           instruction_set_features->HasXTheadVector()),
+        vector_config_(kUnknownVectorConfig) {
     cfi().DelayEmittingAdvancePCs();
   }
 
@@ -164,6 +202,13 @@ class Riscv64Assembler final : public Assembler {
   size_t CodeSize() const override { return Assembler::CodeSize(); }
   DebugFrameOpCodeWriterForAssembler& cfi() { return Assembler::cfi(); }
 
+  // Optional ISA extensions that the macro instructions below may take advantage of.
+  bool HasZba() const { return has_zba_; }
+  bool HasZbb() const { return has_zbb_; }
+  bool HasXTheadBa() const { return has_xthead_ba_; }
+  bool HasXTheadBb() const { return has_xthead_bb_; }
+  bool HasXTheadVector() const { return has_xthead_vector_; }
+
   // According to "The RISC-V Instruction Set Manual"
 
   // LUI/AUIPC (RV32I, with sign-extension on RV64I), opcode = 0x17, 0x37
@@ -453,6 +498,171 @@ class Riscv64Assembler final : public Assembler {
   void FClassS(XRegister rd, FRegister rs1);
   void FClassD(XRegister rd, FRegister rs1);
 
+  // "Zba" Standard Extension, opcode = 0x1b, 0x33 or 0x3b, funct3 and funct7 varies.
+  void AddUw(XRegister rd, XRegister rs1, XRegister rs2);
+  void Sh1Add(XRegister rd, XRegister rs1, XRegister rs2);
+  void Sh1AddUw(XRegister rd, XRegister rs1, XRegister rs2);
+  void Sh2Add(XRegister rd, XRegister rs1, XRegister rs2);
+  void Sh2AddUw(XRegister rd, XRegister rs1, XRegister rs2);
+  void Sh3Add(XRegister rd, XRegister rs1, XRegister rs2);
+  void Sh3AddUw(XRegister rd, XRegister rs1, XRegister rs2);
+  void SlliUw(XRegister rd, XRegister rs1, int32_t shamt);
+
+  // "Zbb" Standard Extension, opcode = 0x13, 0x1b, 0x33 or 0x3b, funct3 and funct7 varies.
+  // Note: 32-bit sext.b, sext.h and zext.h from the Zbb extension are explicitly
+  // prefixed with "Zbb" to differentiate them from the utility macros.
+  void Andn(XRegister rd, XRegister rs1, XRegister rs2);
+  void Orn(XRegister rd, XRegister rs1, XRegister rs2);
+  void Xnor(XRegister rd, XRegister rs1, XRegister rs2);
+  void Clz(XRegister rd, XRegister rs1);
+  void Clzw(XRegister rd, XRegister rs1);
+  void Ctz(XRegister rd, XRegister rs1);
+  void Ctzw(XRegister rd, XRegister rs1);
+  void Cpop(XRegister rd, XRegister rs1);
+  void Cpopw(XRegister rd, XRegister rs1);
+  void Min(XRegister rd, XRegister rs1, XRegister rs2);
+  void Minu(XRegister rd, XRegister rs1, XRegister rs2);
+  void Max(XRegister rd, XRegister rs1, XRegister rs2);
+  void Maxu(XRegister rd, XRegister rs1, XRegister rs2);
+  void Rol(XRegister rd, XRegister rs1, XRegister rs2);
+  void Rolw(XRegister rd, XRegister rs1, XRegister rs2);
+  void Ror(XRegister rd, XRegister rs1, XRegister rs2);
+  void Rorw(XRegister rd, XRegister rs1, XRegister rs2);
+  void Rori(XRegister rd, XRegister rs1, int32_t shamt);
+  void Roriw(XRegister rd, XRegister rs1, int32_t shamt);
+  void OrcB(XRegister rd, XRegister rs1);
+  void Rev8(XRegister rd, XRegister rs1);
+  void ZbbSextB(XRegister rd, XRegister rs1);
+  void ZbbSextH(XRegister rd, XRegister rs1);
+  void ZbbZextH(XRegister rd, XRegister rs1);
+
+  // "Zbs" Standard Extension, opcode = 0x13 or 0x33, funct3 and funct7 varies.
+  void Bclr(XRegister rd, XRegister rs1, XRegister rs2);
+  void Bclri(XRegister rd, XRegister rs1, int32_t shamt);
+  void Bext(XRegister rd, XRegister rs1, XRegister rs2);
+  void Bexti(XRegister rd, XRegister rs1, int32_t shamt);
+  void Binv(XRegister rd, XRegister rs1, XRegister rs2);
+  void Binvi(XRegister rd, XRegister rs1, int32_t shamt);
+  void Bset(XRegister rd, XRegister rs1, XRegister rs2);
+  void Bseti(XRegister rd, XRegister rs1, int32_t shamt);
+
+  // T-Head vendor extensions (as implemented by the XuanTie C9xx cores), opcode = 0x0b.
+  //
+  // "XTheadBa": address calculation, `rd = rs1 + (rs2 << imm2)`.
+  void ThAddsl(XRegister rd, XRegister rs1, XRegister rs2, int32_t imm2);
+
+  // "XTheadBb": basic bit manipulation.
+  void ThExt(XRegister rd, XRegister rs1, int32_t msb, int32_t lsb);
+  void ThExtu(XRegister rd, XRegister rs1, int32_t msb, int32_t lsb);
+  void ThFf0(XRegister rd, XRegister rs1);
+  void ThFf1(XRegister rd, XRegister rs1);
+  void ThRev(XRegister rd, XRegister rs1);
+  void ThRevw(XRegister rd, XRegister rs1);
+  void ThSrri(XRegister rd, XRegister rs1, int32_t shamt);
+  void ThSrriw(XRegister rd, XRegister rs1, int32_t shamt);
+  void ThTstnbz(XRegister rd, XRegister rs1);
+
+  // "XTheadBs": single-bit test, `rd = (rs1 >> shamt) & 1`.
+  void ThTst(XRegister rd, XRegister rs1, int32_t shamt);
+
+  // "XTheadMemIdx": indexed loads and stores, address = `rs1 + (rs2 << imm2)`.
+  // The "Ur" variants zero-extend the lower 32 bits of the index register.
+  void ThLrb(XRegister rd, XRegister rs1, XRegister rs2, int32_t imm2);
+  void ThLrbu(XRegister rd, XRegister rs1, XRegister rs2, int32_t imm2);
+  void ThLrh(XRegister rd, XRegister rs1, XRegister rs2, int32_t imm2);
+  void ThLrhu(XRegister rd, XRegister rs1, XRegister rs2, int32_t imm2);
+  void ThLrw(XRegister rd, XRegister rs1, XRegister rs2, int32_t imm2);
+  void ThLrwu(XRegister rd, XRegister rs1, XRegister rs2, int32_t imm2);
+  void ThLrd(XRegister rd, XRegister rs1, XRegister rs2, int32_t imm2);
+  void ThLurw(XRegister rd, XRegister rs1, XRegister rs2, int32_t imm2);
+  void ThLurwu(XRegister rd, XRegister rs1, XRegister rs2, int32_t imm2);
+  void ThLurd(XRegister rd, XRegister rs1, XRegister rs2, int32_t imm2);
+  void ThSrb(XRegister rs3, XRegister rs1, XRegister rs2, int32_t imm2);
+  void ThSrh(XRegister rs3, XRegister rs1, XRegister rs2, int32_t imm2);
+  void ThSrw(XRegister rs3, XRegister rs1, XRegister rs2, int32_t imm2);
+  void ThSrd(XRegister rs3, XRegister rs1, XRegister rs2, int32_t imm2);
+
+  // "XTheadMac": multiply-accumulate, `rd += rs1 * rs2` or `rd -= rs1 * rs2`.
+  void ThMula(XRegister rd, XRegister rs1, XRegister rs2);
+  void ThMulaw(XRegister rd, XRegister rs1, XRegister rs2);
+  void ThMuls(XRegister rd, XRegister rs1, XRegister rs2);
+  void ThMulsw(XRegister rd, XRegister rs1, XRegister rs2);
+
+  // "V" Standard Extension (RVV 1.0), opcode = 0x07, 0x27 and 0x57.
+  //
+  // Only unmasked operations (vm = 1) with LMUL = 1 are provided. If the target implements
+  // "XTheadVector" (the RVV 0.7.1 draft implemented by the T-Head C9xx cores) instead of "V",
+  // the instructions that are encoded differently in the draft use the draft encoding, and
+  // the instructions that do not exist in the draft, such as `vsetivli`, must not be used.
+
+  // Configuration-setting instructions. See `VTypeI()` for `vtypei`.
+  void VSetvli(XRegister rd, XRegister rs1, uint32_t vtypei);
+  void VSetivli(XRegister rd, uint32_t uimm5, uint32_t vtypei);
+
+  // Unit-stride loads and stores.
+  void VLe8(VRegister vd, XRegister rs1);
+  void VLe16(VRegister vd, XRegister rs1);
+  void VLe32(VRegister vd, XRegister rs1);
+  void VLe64(VRegister vd, XRegister rs1);
+  void VSe8(VRegister vs3, XRegister rs1);
+  void VSe16(VRegister vs3, XRegister rs1);
+  void VSe32(VRegister vs3, XRegister rs1);
+  void VSe64(VRegister vs3, XRegister rs1);
+
+  // Integer arithmetic instructions.
+  void VAddVV(VRegister vd, VRegister vs2, VRegister vs1);
+  void VAddVX(VRegister vd, VRegister vs2, XRegister rs1);
+  void VAddVI(VRegister vd, VRegister vs2, int32_t imm5);
+  void VSubVV(VRegister vd, VRegister vs2, VRegister vs1);
+  void VSubVX(VRegister vd, VRegister vs2, XRegister rs1);
+  void VRsubVX(VRegister vd, VRegister vs2, XRegister rs1);
+  void VRsubVI(VRegister vd, VRegister vs2, int32_t imm5);
+  void VMinuVV(VRegister vd, VRegister vs2, VRegister vs1);
+  void VMinVV(VRegister vd, VRegister vs2, VRegister vs1);
+  void VMaxuVV(VRegister vd, VRegister vs2, VRegister vs1);
+  void VMaxVV(VRegister vd, VRegister vs2, VRegister vs1);
+  void VAndVV(VRegister vd, VRegister vs2, VRegister vs1);
+  void VOrVV(VRegister vd, VRegister vs2, VRegister vs1);
+  void VXorVV(VRegister vd, VRegister vs2, VRegister vs1);
+  void VXorVI(VRegister vd, VRegister vs2, int32_t imm5);
+  void VSllVX(VRegister vd, VRegister vs2, XRegister rs1);
+  void VSllVI(VRegister vd, VRegister vs2, uint32_t uimm5);
+  void VSrlVX(VRegister vd, VRegister vs2, XRegister rs1);
+  void VSrlVI(VRegister vd, VRegister vs2, uint32_t uimm5);
+  void VSraVX(VRegister vd, VRegister vs2, XRegister rs1);
+  void VSraVI(VRegister vd, VRegister vs2, uint32_t uimm5);
+  void VMulVV(VRegister vd, VRegister vs2, VRegister vs1);
+  void VMaccVV(VRegister vd, VRegister vs1, VRegister vs2);
+  void VNmsacVV(VRegister vd, VRegister vs1, VRegister vs2);
+
+  // Integer move instructions.
+  void VMvVV(VRegister vd, VRegister vs1);
+  void VMvVX(VRegister vd, XRegister rs1);
+  void VMvVI(VRegister vd, int32_t imm5);
+  void VMvXS(XRegister rd, VRegister vs2);
+  void VMvSX(VRegister vd, XRegister rs1);
+
+  // Integer reduction instructions, `vd[0] = op(vs1[0], vs2[*])`.
+  void VRedsumVS(VRegister vd, VRegister vs2, VRegister vs1);
+  void VRedminuVS(VRegister vd, VRegister vs2, VRegister vs1);
+  void VRedminVS(VRegister vd, VRegister vs2, VRegister vs1);
+  void VRedmaxuVS(VRegister vd, VRegister vs2, VRegister vs1);
+  void VRedmaxVS(VRegister vd, VRegister vs2, VRegister vs1);
+
+  // Floating-point instructions.
+  void VFaddVV(VRegister vd, VRegister vs2, VRegister vs1);
+  void VFsubVV(VRegister vd, VRegister vs2, VRegister vs1);
+  void VFmulVV(VRegister vd, VRegister vs2, VRegister vs1);
+  void VFdivVV(VRegister vd, VRegister vs2, VRegister vs1);
+  void VFsgnjnVV(VRegister vd, VRegister vs2, VRegister vs1);
+  void VFsgnjxVV(VRegister vd, VRegister vs2, VRegister vs1);
+  void VFcvtFXV(VRegister vd, VRegister vs2);
+
+  // Floating-point move instructions.
+  void VFmvVF(VRegister vd, FRegister rs1);
+  void VFmvFS(FRegister rd, VRegister vs2);
+  void VFmvSF(VRegister vd, FRegister rs1);
+
   ////////////////////////////// RV64 MACRO Instructions  START ///////////////////////////////
   // These pseudo instructions are from "RISC-V Assembly Programmer's Manual".
 
@@ -536,6 +746,29 @@ class Riscv64Assembler final : public Assembler {
   void AddConst32(XRegister rd, XRegister rs1, int32_t value);
   void AddConst64(XRegister rd, XRegister rs1, int64_t value);
 
+  // Macro for address calculation, `rd = rs1 + (rs2 << shift)`. Uses a single
+  // instruction from the "Zba" or "XTheadBa" extension for shifts 1 to 3 if available.
+  void ShiftAndAdd(XRegister rd, XRegister rs1, XRegister rs2, uint32_t shift);
+
+  // Return the `vtypei` operand of `VSetvli()` and `VSetivli()` for LMUL = 1 and the given
+  // element width, with tail and mask undisturbed. The encoding depends on whether the target
+  // implements RVV 1.0 or "XTheadVector".
+  uint32_t VTypeI(VectorSew sew) const;
+
+  // Macro for setting `vl` to `num_elements` elements of width `sew` with LMUL = 1.
+  // The instruction is omitted when the same configuration is known to be active,
+  // i.e. no label was bound and no call was emitted since the last time it was set.
+  void SetVectorConfig(uint32_t num_elements, VectorSew sew);
+
+  // Poison a heap reference contained in `reg`.
+  void PoisonHeapReference(XRegister reg);
+  // Unpoison a heap reference contained in `reg`.
+  void UnpoisonHeapReference(XRegister reg);
+  // Poison a heap reference contained in `reg` if heap poisoning is enabled.
+  void MaybePoisonHeapReference(XRegister reg);
+  // Unpoison a heap reference contained in `reg` if heap poisoning is enabled.
+  void MaybeUnpoisonHeapReference(XRegister reg);
+
   // Jumps and branches to a label.
   void Beqz(XRegister rs, Riscv64Label* label, bool is_bare = false);
   void Bnez(XRegister rs, Riscv64Label* label, bool is_bare = false);
@@ -571,9 +804,7 @@ class Riscv64Assembler final : public Assembler {
 
   void Bind(Label* label) override { Bind(down_cast<Riscv64Label*>(label)); }
 
-  void Jump([[maybe_unused]] Label* label) override {
-    UNIMPLEMENTED(FATAL) << "Do not use Jump for RISCV64";
-  }
+  void Jump(Label* label) override { J(down_cast<Riscv64Label*>(label)); }
 
   void Bind(Riscv64Label* label);
 
@@ -812,6 +1043,16 @@ class Riscv64Assembler final : public Assembler {
   template <void (Riscv64Assembler::*insn)(FRegister, XRegister, int32_t)>
   void FStoreToOffset(FRegister rs2, XRegister rs1, int32_t offset);
 
+  // Emit helper for the "XTheadMemIdx" indexed loads and stores.
+  void EmitThMemIdx(
+      uint32_t funct5, int32_t imm2, XRegister rs2, XRegister rs1, uint32_t funct3, XRegister rd);
+
+  // Emit helper for the unit-stride vector loads and stores.
+  void EmitVMem(VectorSew eew, XRegister rs1, VRegister vd, uint32_t opcode);
+
+  // Forget the vector configuration set by `SetVectorConfig()`.
+  void InvalidateVectorConfig() { vector_config_ = kUnknownVectorConfig; }
+
   // Implementation helper for `Li()`, `LoadConst32()` and `LoadConst64()`.
   void LoadImmediate(XRegister rd, int64_t imm, bool can_use_tmp);
 
@@ -949,6 +1190,27 @@ class Riscv64Assembler final : public Assembler {
     Emit(encoding);
   }
 
+  // V-type instruction for the vector arithmetic instructions (OP-V, opcode = 0x57),
+  // always unmasked (vm = 1):
+  //
+  //    31       26 25 24     20 19     15 14 12 11      7 6           0
+  //   -----------------------------------------------------------------
+  //   [ . . . . . | | . . . . | . . . . | . . | . . . . | . . . . . . ]
+  //   [   funct6   vm    vs2   vs1/rs1  funct3   vd/rd       opcode   ]
+  //   -----------------------------------------------------------------
+  template <typename Reg1, typename Reg2, typename Reg3>
+  void EmitV(uint32_t funct6, Reg1 vs2, Reg2 vs1, uint32_t funct3, Reg3 vd) {
+    DCHECK(IsUint<6>(funct6));
+    DCHECK(IsUint<5>(static_cast<uint32_t>(vs2)));
+    DCHECK(IsUint<5>(static_cast<uint32_t>(vs1)));
+    DCHECK(IsUint<3>(funct3));
+    DCHECK(IsUint<5>(static_cast<uint32_t>(vd)));
+    uint32_t encoding = funct6 << 26 | 1u << 25 | static_cast<uint32_t>(vs2) << 20 |
+                        static_cast<uint32_t>(vs1) << 15 | funct3 << 12 |
+                        static_cast<uint32_t>(vd) << 7 | 0x57;
+    Emit(encoding);
+  }
+
   // U-type instruction:
   //
   //    31                                   12 11      7 6           0
@@ -1006,6 +1268,17 @@ class Riscv64Assembler final : public Assembler {
   uint32_t available_scratch_core_registers_;
   uint32_t available_scratch_fp_registers_;
 
+  // Optional ISA extensions supported by the target.
+  const bool has_zba_;
+  const bool has_zbb_;
+  const bool has_xthead_ba_;
+  const bool has_xthead_bb_;
+  const bool has_xthead_vector_;
+
+  // The vector configuration set by the last `SetVectorConfig()`, if still known to be active.
+  static constexpr uint32_t kUnknownVectorConfig = 0xffffffffu;
+  uint32_t vector_config_;
+
   static constexpr uint32_t kXlen = 64;
 
   friend class ScratchRegisterScope;
@@ -36,13 +36,15 @@ class AssemblerRISCV64Test : public AssemblerTest<riscv64::Riscv64Assembler,
                                                   riscv64::Riscv64Label,
                                                   riscv64::XRegister,
                                                   riscv64::FRegister,
-                                                  int32_t> {
+                                                  int32_t,
+                                                  riscv64::VRegister> {
  public:
   using Base = AssemblerTest<riscv64::Riscv64Assembler,
                              riscv64::Riscv64Label,
                              riscv64::XRegister,
                              riscv64::FRegister,
-                             int32_t>;
+                             int32_t,
+                             riscv64::VRegister>;
 
   AssemblerRISCV64Test()
       : instruction_set_features_(Riscv64InstructionSetFeatures::FromVariant("default", nullptr)) {}
@@ -154,6 +156,16 @@ class AssemblerRISCV64Test : public AssemblerTest<riscv64::Riscv64Assembler,
       fp_registers_.push_back(new riscv64::FRegister(riscv64::FT9));
       fp_registers_.push_back(new riscv64::FRegister(riscv64::FT10));
       fp_registers_.push_back(new riscv64::FRegister(riscv64::FT11));
+
+      // Use a subset of vector registers to keep the number of combinations reasonable.
+      vec_registers_.push_back(new riscv64::VRegister(riscv64::V0));
+      vec_registers_.push_back(new riscv64::VRegister(riscv64::V1));
+      vec_registers_.push_back(new riscv64::VRegister(riscv64::V2));
+      vec_registers_.push_back(new riscv64::VRegister(riscv64::V7));
+      vec_registers_.push_back(new riscv64::VRegister(riscv64::V8));
+      vec_registers_.push_back(new riscv64::VRegister(riscv64::V15));
+      vec_registers_.push_back(new riscv64::VRegister(riscv64::V16));
+      vec_registers_.push_back(new riscv64::VRegister(riscv64::V31));
     }
   }
 
@@ -161,6 +173,7 @@ class AssemblerRISCV64Test : public AssemblerTest<riscv64::Riscv64Assembler,
     AssemblerTest::TearDown();
     STLDeleteElements(&registers_);
     STLDeleteElements(&fp_registers_);
+    STLDeleteElements(&vec_registers_);
   }
 
   std::vector<riscv64::Riscv64Label> GetAddresses() override {
@@ -172,6 +185,8 @@ class AssemblerRISCV64Test : public AssemblerTest<riscv64::Riscv64Assembler,
 
   std::vector<riscv64::FRegister*> GetFPRegisters() override { return fp_registers_; }
 
+  std::vector<riscv64::VRegister*> GetVectorRegisters() override { return vec_registers_; }
+
   std::string GetSecondaryRegisterName(const riscv64::XRegister& reg) override {
     CHECK(secondary_register_names_.find(reg) != secondary_register_names_.end());
     return secondary_register_names_[reg];
@@ -899,6 +914,55 @@ class AssemblerRISCV64Test : public AssemblerTest<riscv64::Riscv64Assembler,
     return str;
   }
 
+  std::string RepeatVVR(void (Riscv64Assembler::*f)(VRegister, VRegister, XRegister),
+                        const std::string& fmt) {
+    return RepeatTemplatedRegisters<VRegister, VRegister, XRegister>(
+        f,
+        GetVectorRegisters(),
+        GetVectorRegisters(),
+        GetRegisters(),
+        &AssemblerRISCV64Test::GetVecRegName,
+        &AssemblerRISCV64Test::GetVecRegName,
+        &AssemblerRISCV64Test::GetRegName<RegisterView::kUsePrimaryName>,
+        fmt);
+  }
+
+  std::string RepeatRV(void (Riscv64Assembler::*f)(XRegister, VRegister), const std::string& fmt) {
+    return RepeatTemplatedRegisters<XRegister, VRegister>(
+        f,
+        GetRegisters(),
+        GetVectorRegisters(),
+        &AssemblerRISCV64Test::GetRegName<RegisterView::kUsePrimaryName>,
+        &AssemblerRISCV64Test::GetVecRegName,
+        fmt);
+  }
+
+  std::string RepeatVF(void (Riscv64Assembler::*f)(VRegister, FRegister), const std::string& fmt) {
+    return RepeatTemplatedRegisters<VRegister, FRegister>(f,
+                                                          GetVectorRegisters(),
+                                                          GetFPRegisters(),
+                                                          &AssemblerRISCV64Test::GetVecRegName,
+                                                          &AssemblerRISCV64Test::GetFPRegName,
+                                                          fmt);
+  }
+
+  std::string RepeatFV(void (Riscv64Assembler::*f)(FRegister, VRegister), const std::string& fmt) {
+    return RepeatTemplatedRegisters<FRegister, VRegister>(f,
+                                                          GetFPRegisters(),
+                                                          GetVectorRegisters(),
+                                                          &AssemblerRISCV64Test::GetFPRegName,
+                                                          &AssemblerRISCV64Test::GetVecRegName,
+                                                          fmt);
+  }
+
+  // The `vtype` operands as written by the assembler for `VTypeI()` of each `VectorSew`.
+  static constexpr std::pair<VectorSew, const char*> kVectorTypes[] = {
+      {VectorSew::kE8, "e8, m1, tu, mu"},
+      {VectorSew::kE16, "e16, m1, tu, mu"},
+      {VectorSew::kE32, "e32, m1, tu, mu"},
+      {VectorSew::kE64, "e64, m1, tu, mu"},
+  };
+
   std::string RepeatCsrrX(void (Riscv64Assembler::*f)(XRegister, uint32_t, XRegister),
                           const std::string& fmt) {
     CHECK(f != nullptr);
@@ -1030,6 +1094,8 @@ class AssemblerRISCV64Test : public AssemblerTest<riscv64::Riscv64Assembler,
 
   std::vector<riscv64::FRegister*> fp_registers_;
 
+  std::vector<riscv64::VRegister*> vec_registers_;
+
   std::unique_ptr<const Riscv64InstructionSetFeatures> instruction_set_features_;
 };
 
@@ -1780,6 +1846,471 @@ TEST_F(AssemblerRISCV64Test, FClassD) {
   DriverStr(RepeatrF(&riscv64::Riscv64Assembler::FClassD, "fclass.d {reg1}, {reg2}"), "FClassD");
 }
 
+TEST_F(AssemblerRISCV64Test, AddUw) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::AddUw, "add.uw {reg1}, {reg2}, {reg3}"), "AddUw");
+}
+
+TEST_F(AssemblerRISCV64Test, Sh1Add) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Sh1Add, "sh1add {reg1}, {reg2}, {reg3}"),
+            "Sh1Add");
+}
+
+TEST_F(AssemblerRISCV64Test, Sh1AddUw) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Sh1AddUw, "sh1add.uw {reg1}, {reg2}, {reg3}"),
+            "Sh1AddUw");
+}
+
+TEST_F(AssemblerRISCV64Test, Sh2Add) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Sh2Add, "sh2add {reg1}, {reg2}, {reg3}"),
+            "Sh2Add");
+}
+
+TEST_F(AssemblerRISCV64Test, Sh2AddUw) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Sh2AddUw, "sh2add.uw {reg1}, {reg2}, {reg3}"),
+            "Sh2AddUw");
+}
+
+TEST_F(AssemblerRISCV64Test, Sh3Add) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Sh3Add, "sh3add {reg1}, {reg2}, {reg3}"),
+            "Sh3Add");
+}
+
+TEST_F(AssemblerRISCV64Test, Sh3AddUw) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Sh3AddUw, "sh3add.uw {reg1}, {reg2}, {reg3}"),
+            "Sh3AddUw");
+}
+
+TEST_F(AssemblerRISCV64Test, SlliUw) {
+  DriverStr(RepeatRRIb(&riscv64::Riscv64Assembler::SlliUw, 6, "slli.uw {reg1}, {reg2}, {imm}"),
+            "SlliUw");
+}
+
+TEST_F(AssemblerRISCV64Test, Andn) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Andn, "andn {reg1}, {reg2}, {reg3}"), "Andn");
+}
+
+TEST_F(AssemblerRISCV64Test, Orn) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Orn, "orn {reg1}, {reg2}, {reg3}"), "Orn");
+}
+
+TEST_F(AssemblerRISCV64Test, Xnor) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Xnor, "xnor {reg1}, {reg2}, {reg3}"), "Xnor");
+}
+
+TEST_F(AssemblerRISCV64Test, Clz) {
+  DriverStr(RepeatRR(&riscv64::Riscv64Assembler::Clz, "clz {reg1}, {reg2}"), "Clz");
+}
+
+TEST_F(AssemblerRISCV64Test, Clzw) {
+  DriverStr(RepeatRR(&riscv64::Riscv64Assembler::Clzw, "clzw {reg1}, {reg2}"), "Clzw");
+}
+
+TEST_F(AssemblerRISCV64Test, Ctz) {
+  DriverStr(RepeatRR(&riscv64::Riscv64Assembler::Ctz, "ctz {reg1}, {reg2}"), "Ctz");
+}
+
+TEST_F(AssemblerRISCV64Test, Ctzw) {
+  DriverStr(RepeatRR(&riscv64::Riscv64Assembler::Ctzw, "ctzw {reg1}, {reg2}"), "Ctzw");
+}
+
+TEST_F(AssemblerRISCV64Test, Cpop) {
+  DriverStr(RepeatRR(&riscv64::Riscv64Assembler::Cpop, "cpop {reg1}, {reg2}"), "Cpop");
+}
+
+TEST_F(AssemblerRISCV64Test, Cpopw) {
+  DriverStr(RepeatRR(&riscv64::Riscv64Assembler::Cpopw, "cpopw {reg1}, {reg2}"), "Cpopw");
+}
+
+TEST_F(AssemblerRISCV64Test, Min) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Min, "min {reg1}, {reg2}, {reg3}"), "Min");
+}
+
+TEST_F(AssemblerRISCV64Test, Minu) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Minu, "minu {reg1}, {reg2}, {reg3}"), "Minu");
+}
+
+TEST_F(AssemblerRISCV64Test, Max) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Max, "max {reg1}, {reg2}, {reg3}"), "Max");
+}
+
+TEST_F(AssemblerRISCV64Test, Maxu) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Maxu, "maxu {reg1}, {reg2}, {reg3}"), "Maxu");
+}
+
+TEST_F(AssemblerRISCV64Test, Rol) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Rol, "rol {reg1}, {reg2}, {reg3}"), "Rol");
+}
+
+TEST_F(AssemblerRISCV64Test, Rolw) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Rolw, "rolw {reg1}, {reg2}, {reg3}"), "Rolw");
+}
+
+TEST_F(AssemblerRISCV64Test, Ror) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Ror, "ror {reg1}, {reg2}, {reg3}"), "Ror");
+}
+
+TEST_F(AssemblerRISCV64Test, Rorw) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Rorw, "rorw {reg1}, {reg2}, {reg3}"), "Rorw");
+}
+
+TEST_F(AssemblerRISCV64Test, Rori) {
+  DriverStr(RepeatRRIb(&riscv64::Riscv64Assembler::Rori, 6, "rori {reg1}, {reg2}, {imm}"), "Rori");
+}
+
+TEST_F(AssemblerRISCV64Test, Roriw) {
+  DriverStr(RepeatRRIb(&riscv64::Riscv64Assembler::Roriw, 5, "roriw {reg1}, {reg2}, {imm}"),
+            "Roriw");
+}
+
+TEST_F(AssemblerRISCV64Test, OrcB) {
+  DriverStr(RepeatRR(&riscv64::Riscv64Assembler::OrcB, "orc.b {reg1}, {reg2}"), "OrcB");
+}
+
+TEST_F(AssemblerRISCV64Test, Rev8) {
+  DriverStr(RepeatRR(&riscv64::Riscv64Assembler::Rev8, "rev8 {reg1}, {reg2}"), "Rev8");
+}
+
+TEST_F(AssemblerRISCV64Test, ZbbSextB) {
+  DriverStr(RepeatRR(&riscv64::Riscv64Assembler::ZbbSextB, "sext.b {reg1}, {reg2}"), "ZbbSextB");
+}
+
+TEST_F(AssemblerRISCV64Test, ZbbSextH) {
+  DriverStr(RepeatRR(&riscv64::Riscv64Assembler::ZbbSextH, "sext.h {reg1}, {reg2}"), "ZbbSextH");
+}
+
+TEST_F(AssemblerRISCV64Test, ZbbZextH) {
+  DriverStr(RepeatRR(&riscv64::Riscv64Assembler::ZbbZextH, "zext.h {reg1}, {reg2}"), "ZbbZextH");
+}
+
+TEST_F(AssemblerRISCV64Test, Bclr) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Bclr, "bclr {reg1}, {reg2}, {reg3}"), "Bclr");
+}
+
+TEST_F(AssemblerRISCV64Test, Bclri) {
+  DriverStr(RepeatRRIb(&riscv64::Riscv64Assembler::Bclri, 6, "bclri {reg1}, {reg2}, {imm}"),
+            "Bclri");
+}
+
+TEST_F(AssemblerRISCV64Test, Bext) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Bext, "bext {reg1}, {reg2}, {reg3}"), "Bext");
+}
+
+TEST_F(AssemblerRISCV64Test, Bexti) {
+  DriverStr(RepeatRRIb(&riscv64::Riscv64Assembler::Bexti, 6, "bexti {reg1}, {reg2}, {imm}"),
+            "Bexti");
+}
+
+TEST_F(AssemblerRISCV64Test, Binv) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Binv, "binv {reg1}, {reg2}, {reg3}"), "Binv");
+}
+
+TEST_F(AssemblerRISCV64Test, Binvi) {
+  DriverStr(RepeatRRIb(&riscv64::Riscv64Assembler::Binvi, 6, "binvi {reg1}, {reg2}, {imm}"),
+            "Binvi");
+}
+
+TEST_F(AssemblerRISCV64Test, Bset) {
+  DriverStr(RepeatRRR(&riscv64::Riscv64Assembler::Bset, "bset {reg1}, {reg2}, {reg3}"), "Bset");
+}
+
+TEST_F(AssemblerRISCV64Test, Bseti) {
+  DriverStr(RepeatRRIb(&riscv64::Riscv64Assembler::Bseti, 6, "bseti {reg1}, {reg2}, {imm}"),
+            "Bseti");
+}
+
+TEST_F(AssemblerRISCV64Test, VSetvli) {
+  std::string expected;
+  for (XRegister* rd : GetRegisters()) {
+    for (XRegister* rs1 : GetRegisters()) {
+      for (const auto& [sew, vtype] : kVectorTypes) {
+        __ VSetvli(*rd, *rs1, __ VTypeI(sew));
+        expected += "vsetvli " + GetRegisterName(*rd) + ", " + GetRegisterName(*rs1) + ", " +
+                    vtype + "\n";
+      }
+    }
+  }
+  DriverStr(expected, "VSetvli");
+}
+
+TEST_F(AssemblerRISCV64Test, VSetivli) {
+  std::vector<int64_t> uimms = CreateImmediateValuesBits(5, /*as_uint=*/ true);
+  std::string expected;
+  for (XRegister* rd : GetRegisters()) {
+    for (int64_t uimm : uimms) {
+      for (const auto& [sew, vtype] : kVectorTypes) {
+        __ VSetivli(*rd, dchecked_integral_cast<uint32_t>(uimm), __ VTypeI(sew));
+        expected += "vsetivli " + GetRegisterName(*rd) + ", " + std::to_string(uimm) + ", " +
+                    vtype + "\n";
+      }
+    }
+  }
+  DriverStr(expected, "VSetivli");
+}
+
+TEST_F(AssemblerRISCV64Test, SetVectorConfig) {
+  __ SetVectorConfig(16u, VectorSew::kE8);
+  __ SetVectorConfig(16u, VectorSew::kE8);  // Omitted, the configuration is already active.
+  __ SetVectorConfig(4u, VectorSew::kE32);
+  Riscv64Label label;
+  __ Bind(&label);
+  __ SetVectorConfig(4u, VectorSew::kE32);  // Emitted again after a label.
+  __ Jalr(A0);
+  __ SetVectorConfig(4u, VectorSew::kE32);  // Emitted again after a call.
+  __ SetVectorConfig(32u, VectorSew::kE8);  // Too many elements for `vsetivli`.
+  DriverStr("vsetivli zero, 16, e8, m1, tu, mu\n"
+            "vsetivli zero, 4, e32, m1, tu, mu\n"
+            "vsetivli zero, 4, e32, m1, tu, mu\n"
+            "jalr ra, a0, 0\n"
+            "vsetivli zero, 4, e32, m1, tu, mu\n"
+            "addi t6, zero, 32\n"
+            "vsetvli zero, t6, e8, m1, tu, mu\n",
+            "SetVectorConfig");
+}
+
+TEST_F(AssemblerRISCV64Test, VLe8) {
+  DriverStr(RepeatVR(&riscv64::Riscv64Assembler::VLe8, "vle8.v {reg1}, ({reg2})"), "VLe8");
+}
+
+TEST_F(AssemblerRISCV64Test, VLe16) {
+  DriverStr(RepeatVR(&riscv64::Riscv64Assembler::VLe16, "vle16.v {reg1}, ({reg2})"), "VLe16");
+}
+
+TEST_F(AssemblerRISCV64Test, VLe32) {
+  DriverStr(RepeatVR(&riscv64::Riscv64Assembler::VLe32, "vle32.v {reg1}, ({reg2})"), "VLe32");
+}
+
+TEST_F(AssemblerRISCV64Test, VLe64) {
+  DriverStr(RepeatVR(&riscv64::Riscv64Assembler::VLe64, "vle64.v {reg1}, ({reg2})"), "VLe64");
+}
+
+TEST_F(AssemblerRISCV64Test, VSe8) {
+  DriverStr(RepeatVR(&riscv64::Riscv64Assembler::VSe8, "vse8.v {reg1}, ({reg2})"), "VSe8");
+}
+
+TEST_F(AssemblerRISCV64Test, VSe16) {
+  DriverStr(RepeatVR(&riscv64::Riscv64Assembler::VSe16, "vse16.v {reg1}, ({reg2})"), "VSe16");
+}
+
+TEST_F(AssemblerRISCV64Test, VSe32) {
+  DriverStr(RepeatVR(&riscv64::Riscv64Assembler::VSe32, "vse32.v {reg1}, ({reg2})"), "VSe32");
+}
+
+TEST_F(AssemblerRISCV64Test, VSe64) {
+  DriverStr(RepeatVR(&riscv64::Riscv64Assembler::VSe64, "vse64.v {reg1}, ({reg2})"), "VSe64");
+}
+
+TEST_F(AssemblerRISCV64Test, VAddVV) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VAddVV, "vadd.vv {reg1}, {reg2}, {reg3}"),
+            "VAddVV");
+}
+
+TEST_F(AssemblerRISCV64Test, VAddVX) {
+  DriverStr(RepeatVVR(&riscv64::Riscv64Assembler::VAddVX, "vadd.vx {reg1}, {reg2}, {reg3}"),
+            "VAddVX");
+}
+
+TEST_F(AssemblerRISCV64Test, VAddVI) {
+  DriverStr(RepeatVVIb(&riscv64::Riscv64Assembler::VAddVI, -5, "vadd.vi {reg1}, {reg2}, {imm}"),
+            "VAddVI");
+}
+
+TEST_F(AssemblerRISCV64Test, VSubVV) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VSubVV, "vsub.vv {reg1}, {reg2}, {reg3}"),
+            "VSubVV");
+}
+
+TEST_F(AssemblerRISCV64Test, VSubVX) {
+  DriverStr(RepeatVVR(&riscv64::Riscv64Assembler::VSubVX, "vsub.vx {reg1}, {reg2}, {reg3}"),
+            "VSubVX");
+}
+
+TEST_F(AssemblerRISCV64Test, VRsubVX) {
+  DriverStr(RepeatVVR(&riscv64::Riscv64Assembler::VRsubVX, "vrsub.vx {reg1}, {reg2}, {reg3}"),
+            "VRsubVX");
+}
+
+TEST_F(AssemblerRISCV64Test, VRsubVI) {
+  DriverStr(RepeatVVIb(&riscv64::Riscv64Assembler::VRsubVI, -5, "vrsub.vi {reg1}, {reg2}, {imm}"),
+            "VRsubVI");
+}
+
+TEST_F(AssemblerRISCV64Test, VMinuVV) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VMinuVV, "vminu.vv {reg1}, {reg2}, {reg3}"),
+            "VMinuVV");
+}
+
+TEST_F(AssemblerRISCV64Test, VMinVV) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VMinVV, "vmin.vv {reg1}, {reg2}, {reg3}"),
+            "VMinVV");
+}
+
+TEST_F(AssemblerRISCV64Test, VMaxuVV) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VMaxuVV, "vmaxu.vv {reg1}, {reg2}, {reg3}"),
+            "VMaxuVV");
+}
+
+TEST_F(AssemblerRISCV64Test, VMaxVV) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VMaxVV, "vmax.vv {reg1}, {reg2}, {reg3}"),
+            "VMaxVV");
+}
+
+TEST_F(AssemblerRISCV64Test, VAndVV) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VAndVV, "vand.vv {reg1}, {reg2}, {reg3}"),
+            "VAndVV");
+}
+
+TEST_F(AssemblerRISCV64Test, VOrVV) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VOrVV, "vor.vv {reg1}, {reg2}, {reg3}"),
+            "VOrVV");
+}
+
+TEST_F(AssemblerRISCV64Test, VXorVV) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VXorVV, "vxor.vv {reg1}, {reg2}, {reg3}"),
+            "VXorVV");
+}
+
+TEST_F(AssemblerRISCV64Test, VXorVI) {
+  DriverStr(RepeatVVIb(&riscv64::Riscv64Assembler::VXorVI, -5, "vxor.vi {reg1}, {reg2}, {imm}"),
+            "VXorVI");
+}
+
+TEST_F(AssemblerRISCV64Test, VSllVX) {
+  DriverStr(RepeatVVR(&riscv64::Riscv64Assembler::VSllVX, "vsll.vx {reg1}, {reg2}, {reg3}"),
+            "VSllVX");
+}
+
+TEST_F(AssemblerRISCV64Test, VSllVI) {
+  DriverStr(RepeatVVIb(&riscv64::Riscv64Assembler::VSllVI, 5, "vsll.vi {reg1}, {reg2}, {imm}"),
+            "VSllVI");
+}
+
+TEST_F(AssemblerRISCV64Test, VSrlVX) {
+  DriverStr(RepeatVVR(&riscv64::Riscv64Assembler::VSrlVX, "vsrl.vx {reg1}, {reg2}, {reg3}"),
+            "VSrlVX");
+}
+
+TEST_F(AssemblerRISCV64Test, VSrlVI) {
+  DriverStr(RepeatVVIb(&riscv64::Riscv64Assembler::VSrlVI, 5, "vsrl.vi {reg1}, {reg2}, {imm}"),
+            "VSrlVI");
+}
+
+TEST_F(AssemblerRISCV64Test, VSraVX) {
+  DriverStr(RepeatVVR(&riscv64::Riscv64Assembler::VSraVX, "vsra.vx {reg1}, {reg2}, {reg3}"),
+            "VSraVX");
+}
+
+TEST_F(AssemblerRISCV64Test, VSraVI) {
+  DriverStr(RepeatVVIb(&riscv64::Riscv64Assembler::VSraVI, 5, "vsra.vi {reg1}, {reg2}, {imm}"),
+            "VSraVI");
+}
+
+TEST_F(AssemblerRISCV64Test, VMulVV) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VMulVV, "vmul.vv {reg1}, {reg2}, {reg3}"),
+            "VMulVV");
+}
+
+TEST_F(AssemblerRISCV64Test, VMaccVV) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VMaccVV, "vmacc.vv {reg1}, {reg2}, {reg3}"),
+            "VMaccVV");
+}
+
+TEST_F(AssemblerRISCV64Test, VNmsacVV) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VNmsacVV, "vnmsac.vv {reg1}, {reg2}, {reg3}"),
+            "VNmsacVV");
+}
+
+TEST_F(AssemblerRISCV64Test, VMvVV) {
+  DriverStr(RepeatVV(&riscv64::Riscv64Assembler::VMvVV, "vmv.v.v {reg1}, {reg2}"), "VMvVV");
+}
+
+TEST_F(AssemblerRISCV64Test, VMvVX) {
+  DriverStr(RepeatVR(&riscv64::Riscv64Assembler::VMvVX, "vmv.v.x {reg1}, {reg2}"), "VMvVX");
+}
+
+TEST_F(AssemblerRISCV64Test, VMvVI) {
+  DriverStr(RepeatVIb(&riscv64::Riscv64Assembler::VMvVI, -5, "vmv.v.i {reg}, {imm}"), "VMvVI");
+}
+
+TEST_F(AssemblerRISCV64Test, VMvXS) {
+  DriverStr(RepeatRV(&riscv64::Riscv64Assembler::VMvXS, "vmv.x.s {reg1}, {reg2}"), "VMvXS");
+}
+
+TEST_F(AssemblerRISCV64Test, VMvSX) {
+  DriverStr(RepeatVR(&riscv64::Riscv64Assembler::VMvSX, "vmv.s.x {reg1}, {reg2}"), "VMvSX");
+}
+
+TEST_F(AssemblerRISCV64Test, VRedsumVS) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VRedsumVS, "vredsum.vs {reg1}, {reg2}, {reg3}"),
+            "VRedsumVS");
+}
+
+TEST_F(AssemblerRISCV64Test, VRedminuVS) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VRedminuVS, "vredminu.vs {reg1}, {reg2}, {reg3}"),
+            "VRedminuVS");
+}
+
+TEST_F(AssemblerRISCV64Test, VRedminVS) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VRedminVS, "vredmin.vs {reg1}, {reg2}, {reg3}"),
+            "VRedminVS");
+}
+
+TEST_F(AssemblerRISCV64Test, VRedmaxuVS) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VRedmaxuVS, "vredmaxu.vs {reg1}, {reg2}, {reg3}"),
+            "VRedmaxuVS");
+}
+
+TEST_F(AssemblerRISCV64Test, VRedmaxVS) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VRedmaxVS, "vredmax.vs {reg1}, {reg2}, {reg3}"),
+            "VRedmaxVS");
+}
+
+TEST_F(AssemblerRISCV64Test, VFaddVV) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VFaddVV, "vfadd.vv {reg1}, {reg2}, {reg3}"),
+            "VFaddVV");
+}
+
+TEST_F(AssemblerRISCV64Test, VFsubVV) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VFsubVV, "vfsub.vv {reg1}, {reg2}, {reg3}"),
+            "VFsubVV");
+}
+
+TEST_F(AssemblerRISCV64Test, VFmulVV) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VFmulVV, "vfmul.vv {reg1}, {reg2}, {reg3}"),
+            "VFmulVV");
+}
+
+TEST_F(AssemblerRISCV64Test, VFdivVV) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VFdivVV, "vfdiv.vv {reg1}, {reg2}, {reg3}"),
+            "VFdivVV");
+}
+
+TEST_F(AssemblerRISCV64Test, VFsgnjnVV) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VFsgnjnVV, "vfsgnjn.vv {reg1}, {reg2}, {reg3}"),
+            "VFsgnjnVV");
+}
+
+TEST_F(AssemblerRISCV64Test, VFsgnjxVV) {
+  DriverStr(RepeatVVV(&riscv64::Riscv64Assembler::VFsgnjxVV, "vfsgnjx.vv {reg1}, {reg2}, {reg3}"),
+            "VFsgnjxVV");
+}
+
+TEST_F(AssemblerRISCV64Test, VFcvtFXV) {
+  DriverStr(RepeatVV(&riscv64::Riscv64Assembler::VFcvtFXV, "vfcvt.f.x.v {reg1}, {reg2}"),
+            "VFcvtFXV");
+}
+
+TEST_F(AssemblerRISCV64Test, VFmvVF) {
+  DriverStr(RepeatVF(&riscv64::Riscv64Assembler::VFmvVF, "vfmv.v.f {reg1}, {reg2}"), "VFmvVF");
+}
+
+TEST_F(AssemblerRISCV64Test, VFmvFS) {
+  DriverStr(RepeatFV(&riscv64::Riscv64Assembler::VFmvFS, "vfmv.f.s {reg1}, {reg2}"), "VFmvFS");
+}
+
+TEST_F(AssemblerRISCV64Test, VFmvSF) {
+  DriverStr(RepeatVF(&riscv64::Riscv64Assembler::VFmvSF, "vfmv.s.f {reg1}, {reg2}"), "VFmvSF");
+}
+
 // Pseudo instructions.
 TEST_F(AssemblerRISCV64Test, Nop) {
   __ Nop();
@@ -95,7 +95,7 @@ void Riscv64JNIMacroAssembler::BuildFrame(size_t frame_size,
 
 void Riscv64JNIMacroAssembler::RemoveFrame(size_t frame_size,
                                            ArrayRef<const ManagedRegister> callee_save_regs,
-                                           [[maybe_unused]] bool may_suspend) {
+                                           bool may_suspend) {
   cfi().RememberState();
 
   // Restore callee-saves.
@@ -118,6 +118,14 @@ void Riscv64JNIMacroAssembler::RemoveFrame(size_t frame_size,
   }
   DCHECK_EQ(offset, frame_size);
 
+  // Emit marking register refresh even with all GCs as we are still using the
+  // register due to nterp's dependency.
+  if (kReserveMarkingRegister && may_suspend) {
+    // The method may be suspended; refresh the Marking Register. Otherwise the Marking
+    // Register is a native callee-save register and has been preserved by native code.
+    __ Loadw(MR, TR, Thread::IsGcMarkingOffset<kRiscv64PointerSize>().Int32Value());
+  }
+
   // Decrease the frame size.
   DecreaseFrameSize(frame_size);
 
@@ -18,7 +18,10 @@
 #include <log/log.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
 #include <sys/stat.h>
+#include <sys/wait.h>
 
 #include <algorithm>
 #include <forward_list>
@@ -78,12 +81,14 @@
 #include "dex/dex_file_loader.h"
 #include "dex/quick_compiler_callbacks.h"
 #include "dex/verification_results.h"
+#include "dex2oat/dex2oat_fork_server.h"
 #include "dex2oat_options.h"
 #include "dexlayout.h"
 #include "driver/compiler_driver.h"
 #include "driver/compiler_options.h"
 #include "driver/compiler_options_map-inl.h"
 #include "elf_file.h"
+#include "gc/heap.h"
 #include "gc/space/image_space.h"
 #include "gc/space/space-inl.h"
 #include "gc/verification.h"
@@ -109,6 +114,7 @@
 #include "scoped_thread_state_change-inl.h"
 #include "stream/buffered_output_stream.h"
 #include "stream/file_output_stream.h"
+#include "subtype_check.h"
 #include "vdex_file.h"
 #include "verifier/verifier_deps.h"
 
@@ -132,6 +138,11 @@ static constexpr size_t kDefaultMinDexFileCumulativeSizeForSwap = 20 * MB;
 // Compiler filter override for very large apps.
 static constexpr CompilerFilter::Filter kLargeAppFilter = CompilerFilter::kVerify;
 
+// Estimated memory used for each byte of the input dex files, by the runtime data structures
+// and the compiled code, and by each compiler thread, for fitting in the memory budget.
+static constexpr size_t kMemoryBudgetBytesPerDexFileByte = 4;
+static constexpr size_t kMemoryBudgetBytesPerThread = 64 * MB;
+
 static int original_argc;
 static char** original_argv;
 
@@ -507,6 +518,32 @@ class OatKeyValueStore : public SafeMap<std::string, std::string> {
   }
 };
 
+// The runtime of the fork server this process was forked from, see dex2oat_fork_server.h.
+struct ForkServerRuntimeConfig {
+  std::string boot_image;
+  InstructionSet isa;
+  // As returned by `GetForkServerRuntimeArgs()`.
+  std::vector<std::string> runtime_args;
+};
+
+static ForkServerRuntimeConfig* gForkServerRuntimeConfig = nullptr;
+
+// Returns the runtime arguments that must match between a fork server and the compilations it
+// serves. The target SDK version and the hidden API policy are set per compilation.
+static std::vector<std::string> GetForkServerRuntimeArgs(const std::vector<const char*>& args) {
+  std::vector<std::string> result;
+  for (const char* arg : args) {
+    if (!android::base::StartsWith(arg, "-Xtarget-sdk-version:") &&
+        !android::base::StartsWith(arg, "-Xhidden-api-policy:")) {
+      result.push_back(arg);
+    }
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+static int Dex2oatForkServer(int argc, char** argv);
+
 class Dex2Oat final {
  public:
   explicit Dex2Oat(TimingLogger* timings)
@@ -559,9 +596,11 @@ class Dex2Oat final {
     if (!kIsDebugBuild && !(kRunningOnMemoryTool && kMemoryToolDetectsLeaks)) {
       // We want to just exit on non-debug builds, not bringing the runtime down
       // in an orderly fashion. So release the following fields.
-      if (!compiler_options_->GetDumpStats()) {
-        // The --dump-stats get logged when the optimizing compiler gets destroyed, so we can't
-        // release the driver_.
+      if (!compiler_options_->GetDumpStats() &&
+          compiler_options_->GetDumpPassProfileFileName().empty() &&
+          compiler_options_->GetDumpCodeQualityFileName().empty()) {
+        // The --dump-stats get logged and the --dump-pass-profile and --dump-code-quality get
+        // written when the optimizing compiler gets destroyed, so we can't release the driver_.
         driver_.release();              // NOLINT
       }
       image_writer_.release();          // NOLINT
@@ -856,7 +895,7 @@ class Dex2Oat final {
     // Set the compilation target's implicit checks options.
     switch (compiler_options_->GetInstructionSet()) {
       case InstructionSet::kArm64:
-        compiler_options_->implicit_suspend_checks_ = true;
+        compiler_options_->implicit_suspend_checks_ = !compiler_options_->explicit_suspend_checks_;
         FALLTHROUGH_INTENDED;
       case InstructionSet::kArm:
       case InstructionSet::kThumb2:
@@ -1096,6 +1135,9 @@ class Dex2Oat final {
     AssignIfExists(args, M::SwapDexSizeThreshold, &min_dex_file_cumulative_size_for_swap_);
     AssignIfExists(args, M::SwapDexCountThreshold, &min_dex_files_for_swap_);
     AssignIfExists(args, M::VeryLargeAppThreshold, &very_large_threshold_);
+    if (args.Exists(M::MemoryBudgetMb)) {
+      memory_budget_ = static_cast<size_t>(*args.Get(M::MemoryBudgetMb)) * MB;
+    }
     AssignIfExists(args, M::AppImageFile, &app_image_file_name_);
     AssignIfExists(args, M::AppImageFileFd, &app_image_fd_);
     AssignIfExists(args, M::NoInlineFrom, &no_inline_from_string_);
@@ -1531,13 +1573,20 @@ class Dex2Oat final {
     //       store which is used for determining whether the oat file is up to date,
     //       together with the boot class path locations and checksums stored below.
     CompilerFilter::Filter original_compiler_filter = compiler_options_->GetCompilerFilter();
+    if (!IsBootImage() && !IsBootImageExtension()) {
+      fits_in_memory_budget_ = LimitThreadsToMemoryBudget(dex_files);
+    }
     if (!IsBootImage() && !IsBootImageExtension() && IsVeryLarge(dex_files)) {
       // Disable app image to make sure dex2oat unloading is enabled.
       compiler_options_->image_type_ = CompilerOptions::ImageType::kNone;
 
       // If we need to downgrade the compiler-filter for size reasons, do that early before we read
       // it below for creating verification callbacks.
-      if (!CompilerFilter::IsAsGoodAs(kLargeAppFilter, compiler_options_->GetCompilerFilter())) {
+      if (fits_in_memory_budget_) {
+        LOG(INFO) << "Very large app, compiling within the memory budget with " << thread_count_
+                  << " threads.";
+      } else if (!CompilerFilter::IsAsGoodAs(kLargeAppFilter,
+                                             compiler_options_->GetCompilerFilter())) {
         LOG(INFO) << "Very large app, downgrading to verify.";
         compiler_options_->SetCompilerFilter(kLargeAppFilter);
       }
@@ -1555,7 +1604,11 @@ class Dex2Oat final {
       // Note: Runtime acquires ownership of these dex files.
       runtime_options.Set(RuntimeArgumentMap::BootClassPathDexList, &opened_dex_files_);
     }
-    if (!CreateRuntime(std::move(runtime_options))) {
+    if (gForkServerRuntimeConfig != nullptr) {
+      if (!AdoptForkServerRuntime(runtime_options)) {
+        return dex2oat::ReturnCode::kCreateRuntime;
+      }
+    } else if (!CreateRuntime(std::move(runtime_options))) {
       return dex2oat::ReturnCode::kCreateRuntime;
     }
     if (runtime_->GetHeap()->GetBootImageSpaces().empty() &&
@@ -1565,6 +1618,9 @@ class Dex2Oat final {
                    << " without a primary boot image.";
       compiler_options_->image_type_ = CompilerOptions::ImageType::kNone;
     }
+    if (kBitstringSubtypeCheckEnabled && !IsBootImage()) {
+      RecordBootImageTypeCheckBitstrings();
+    }
     ArrayRef<const DexFile* const> bcp_dex_files(runtime_->GetClassLinker()->GetBootClassPath());
     if (IsBootImage() || IsBootImageExtension()) {
       // Check boot class path dex files and, if compiling an extension, the images it depends on.
@@ -2520,11 +2576,17 @@ class Dex2Oat final {
   };
 
  private:
+  friend int Dex2oatForkServer(int argc, char** argv);
+
   bool UseSwap(bool is_image, const std::vector<const DexFile*>& dex_files) {
     if (is_image) {
       // Don't use swap, we know generation should succeed, and we don't want to slow it down.
       return false;
     }
+    if (fits_in_memory_budget_) {
+      // The compilation is estimated to fit in the memory budget without swap.
+      return false;
+    }
     if (dex_files.size() < min_dex_files_for_swap_) {
       // If there are less dex files than the threshold, assume it's gonna be fine.
       return false;
@@ -2536,6 +2598,31 @@ class Dex2Oat final {
     return dex_files_size >= min_dex_file_cumulative_size_for_swap_;
   }
 
+  // Reduces the number of threads so that the estimated memory use of the compilation fits in
+  // the memory budget. Returns whether it fits, false if there is no memory budget.
+  bool LimitThreadsToMemoryBudget(const std::vector<const DexFile*>& dex_files) {
+    if (memory_budget_ == 0u) {
+      return false;
+    }
+    size_t dex_files_size = 0;
+    for (const auto* dex_file : dex_files) {
+      dex_files_size += dex_file->GetHeader().file_size_;
+    }
+    size_t base_memory = dex_files_size * kMemoryBudgetBytesPerDexFileByte;
+    if (base_memory + kMemoryBudgetBytesPerThread > memory_budget_) {
+      LOG(INFO) << "Estimated memory use exceeds the memory budget of "
+                << PrettySize(memory_budget_);
+      return false;
+    }
+    size_t max_threads = (memory_budget_ - base_memory) / kMemoryBudgetBytesPerThread;
+    if (thread_count_ > max_threads) {
+      VLOG(compiler) << "Reducing threads from " << thread_count_ << " to " << max_threads
+                     << " for the memory budget of " << PrettySize(memory_budget_);
+      thread_count_ = max_threads;
+    }
+    return true;
+  }
+
   bool IsVeryLarge(const std::vector<const DexFile*>& dex_files) {
     size_t dex_files_size = 0;
     for (const auto* dex_file : dex_files) {
@@ -2711,26 +2798,31 @@ class Dex2Oat final {
       raw_options.push_back(std::make_pair(runtime_args_[i], nullptr));
     }
 
-    raw_options.push_back(std::make_pair("compilercallbacks", callbacks));
-    raw_options.push_back(
-        std::make_pair("imageinstructionset",
-                       GetInstructionSetString(compiler_options_->GetInstructionSet())));
+    AddCommonRuntimeOptions(callbacks, compiler_options_->GetInstructionSet(), &raw_options);
+
+    if (!Runtime::ParseOptions(raw_options, false, runtime_options)) {
+      LOG(ERROR) << "Failed to parse runtime options";
+      return false;
+    }
+    return true;
+  }
+
+  // Add the runtime options that every compiler runtime uses, whatever is compiled.
+  static void AddCommonRuntimeOptions(QuickCompilerCallbacks* callbacks,
+                                      InstructionSet isa,
+                                      RuntimeOptions* raw_options) {
+    raw_options->push_back(std::make_pair("compilercallbacks", callbacks));
+    raw_options->push_back(std::make_pair("imageinstructionset", GetInstructionSetString(isa)));
 
     // Never allow implicit image compilation.
-    raw_options.push_back(std::make_pair("-Xnoimage-dex2oat", nullptr));
+    raw_options->push_back(std::make_pair("-Xnoimage-dex2oat", nullptr));
     // Disable libsigchain. We don't don't need it during compilation and it prevents us
     // from getting a statically linked version of dex2oat (because of dlsym and RTLD_NEXT).
-    raw_options.push_back(std::make_pair("-Xno-sig-chain", nullptr));
+    raw_options->push_back(std::make_pair("-Xno-sig-chain", nullptr));
     // Disable Hspace compaction to save heap size virtual space.
     // Only need disable Hspace for OOM becasue background collector is equal to
     // foreground collector by default for dex2oat.
-    raw_options.push_back(std::make_pair("-XX:DisableHSpaceCompactForOOM", nullptr));
-
-    if (!Runtime::ParseOptions(raw_options, false, runtime_options)) {
-      LOG(ERROR) << "Failed to parse runtime options";
-      return false;
-    }
-    return true;
+    raw_options->push_back(std::make_pair("-XX:DisableHSpaceCompactForOOM", nullptr));
   }
 
   // Create a runtime necessary for compilation.
@@ -2751,11 +2843,21 @@ class Dex2Oat final {
     SetThreadName(kIsDebugBuild ? "dex2oatd" : "dex2oat");
 
     runtime_.reset(Runtime::Current());
-    runtime_->SetInstructionSet(compiler_options_->GetInstructionSet());
+    InitializeCompilerRuntime(runtime_.get(), compiler_options_->GetInstructionSet());
+
+    WatchDog::SetRuntime(runtime_.get());
+
+    return true;
+  }
+
+  // Finish setting up a runtime just created by `Runtime::Create` for compiling for `isa`.
+  static void InitializeCompilerRuntime(Runtime* runtime, InstructionSet isa)
+      RELEASE_SHARED(Locks::mutator_lock_) {
+    runtime->SetInstructionSet(isa);
     for (uint32_t i = 0; i < static_cast<uint32_t>(CalleeSaveType::kLastCalleeSaveType); ++i) {
       CalleeSaveType type = CalleeSaveType(i);
-      if (!runtime_->HasCalleeSaveMethod(type)) {
-        runtime_->SetCalleeSaveMethod(runtime_->CreateCalleeSaveMethod(), type);
+      if (!runtime->HasCalleeSaveMethod(type)) {
+        runtime->SetCalleeSaveMethod(runtime->CreateCalleeSaveMethod(), type);
       }
     }
 
@@ -2764,17 +2866,37 @@ class Dex2Oat final {
     interpreter::UnstartedRuntime::Initialize();
 
     Thread* self = Thread::Current();
-    runtime_->GetClassLinker()->RunEarlyRootClinits(self);
+    runtime->GetClassLinker()->RunEarlyRootClinits(self);
     InitializeIntrinsics();
-    runtime_->RunRootClinits(self);
+    runtime->RunRootClinits(self);
 
     // Runtime::Create acquired the mutator_lock_ that is normally given away when we
     // Runtime::Start, give it away now so that we don't starve GC.
     self->TransitionFromRunnableToSuspended(ThreadState::kNative);
+  }
 
-    WatchDog::SetRuntime(runtime_.get());
-
-    return true;
+  // Use the runtime of the fork server this process was forked from instead of creating one.
+  // Returns false if the runtime was not created with the options this compilation needs.
+  bool AdoptForkServerRuntime(const RuntimeArgumentMap& runtime_options);
+
+  // Record the boot image classes with a type check bitstring assigned in the boot image, the
+  // compiled code can use their bitstrings. This must run before any class of the compiled dex
+  // files is initialized, as that assigns bitstrings to its superclasses in this process only.
+  void RecordBootImageTypeCheckBitstrings() {
+    ScopedObjectAccess soa(Thread::Current());
+    gc::Heap* heap = runtime_->GetHeap();
+    HashSet<const mirror::Class*>* classes = &compiler_options_->boot_image_bitstring_classes_;
+    MutexLock subtype_check_lock(soa.Self(), *Locks::subtype_check_lock_);
+    // NO_THREAD_SAFETY_ANALYSIS for the locks held outside of the lambda.
+    ClassFuncVisitor visitor([&](ObjPtr<mirror::Class> klass) NO_THREAD_SAFETY_ANALYSIS {
+      if (heap->ObjectIsInBootImageSpace(klass) &&
+          SubtypeCheck<ObjPtr<mirror::Class>>::GetState(klass) == SubtypeCheckInfo::kAssigned) {
+        classes->insert(klass.Ptr());
+      }
+      return true;
+    });
+    runtime_->GetClassLinker()->VisitClasses(&visitor);
+    VLOG(compiler) << "Boot image classes with type check bitstrings: " << classes->size();
   }
 
   // Let the ImageWriter write the image files. If we do not compile PIC, also fix up the oat files.
@@ -2994,6 +3116,8 @@ class Dex2Oat final {
   size_t min_dex_files_for_swap_ = kDefaultMinDexFilesForSwap;
   size_t min_dex_file_cumulative_size_for_swap_ = kDefaultMinDexFileCumulativeSizeForSwap;
   size_t very_large_threshold_ = std::numeric_limits<size_t>::max();
+  size_t memory_budget_ = 0u;
+  bool fits_in_memory_budget_ = false;
   std::string app_image_file_name_;
   int app_image_fd_;
   std::vector<std::string> profile_files_;
@@ -3129,6 +3253,33 @@ static dex2oat::ReturnCode DoCompilation(Dex2Oat& dex2oat) REQUIRES(!Locks::muta
   return dex2oat::ReturnCode::kNoFailure;
 }
 
+bool Dex2Oat::AdoptForkServerRuntime(const RuntimeArgumentMap& runtime_options) {
+  DCHECK(gForkServerRuntimeConfig != nullptr);
+  if (IsBootImage() || IsBootImageExtension()) {
+    LOG(ERROR) << "A fork server cannot compile a boot image or a boot image extension";
+    return false;
+  }
+  if (boot_image_filename_ != gForkServerRuntimeConfig->boot_image ||
+      compiler_options_->GetInstructionSet() != gForkServerRuntimeConfig->isa ||
+      GetForkServerRuntimeArgs(runtime_args_) != gForkServerRuntimeConfig->runtime_args) {
+    LOG(ERROR) << "The runtime of the fork server does not match the compilation";
+    return false;
+  }
+
+  mirror::Object::SetHashCodeSeed(987654321u ^ GetCombinedChecksums());
+  SetThreadName(kIsDebugBuild ? "dex2oatd" : "dex2oat");
+
+  runtime_.reset(Runtime::Current());
+  runtime_->SetCompilerCallbacks(callbacks_.get());
+  runtime_->SetTargetSdkVersion(runtime_options.GetOrDefault(RuntimeArgumentMap::TargetSdkVersion));
+  runtime_->SetHiddenApiEnforcementPolicy(
+      runtime_options.GetOrDefault(RuntimeArgumentMap::HiddenApiPolicy));
+
+  WatchDog::SetRuntime(runtime_.get());
+
+  return true;
+}
+
 static dex2oat::ReturnCode Dex2oat(int argc, char** argv) {
   b13564922();
 
@@ -3220,9 +3371,226 @@ static dex2oat::ReturnCode Dex2oat(int argc, char** argv) {
 
   return result;
 }
+
+static bool SendForkServerReply(int fd, const Dex2oatForkServerProtocol::Reply& reply) {
+  if (TEMP_FAILURE_RETRY(send(fd, &reply, sizeof(reply), MSG_NOSIGNAL)) !=
+      static_cast<ssize_t>(sizeof(reply))) {
+    PLOG(ERROR) << "Failed to send fork server reply";
+    return false;
+  }
+  return true;
+}
+
+// Receives a request into `buffer` and the fds it carries into `fds`. Returns the size of the
+// request, 0 at the end of the stream, or -1 on error.
+static ssize_t ReceiveForkServerRequest(int fd,
+                                        std::vector<uint8_t>* buffer,
+                                        std::vector<android::base::unique_fd>* fds) {
+  iovec iov = {buffer->data(), buffer->size()};
+  static constexpr size_t kControlSize =
+      CMSG_SPACE(sizeof(int) * Dex2oatForkServerProtocol::kMaxRequestFds);
+  alignas(cmsghdr) char control[kControlSize];
+  msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  ssize_t size = TEMP_FAILURE_RETRY(recvmsg(fd, &msg, MSG_CMSG_CLOEXEC));
+  if (size < 0) {
+    return -1;
+  }
+  for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+    if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+      size_t num_fds = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+      const int* data = reinterpret_cast<const int*>(CMSG_DATA(cmsg));
+      for (size_t i = 0; i != num_fds; ++i) {
+        fds->emplace_back(data[i]);
+      }
+    }
+  }
+  if ((msg.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) != 0) {
+    errno = EMSGSIZE;
+    return -1;
+  }
+  return size;
+}
+
+// Runs the compilation of a request in the child forked for it.
+[[noreturn]] static void RunForkServerChild(int server_fd,
+                                            std::vector<android::base::unique_fd>&& fds,
+                                            const std::vector<int>& target_fds,
+                                            std::vector<char*>&& args) {
+  close(server_fd);
+  // Move the received fds above the target fd numbers first, so that installing one of them does
+  // not close another one.
+  int min_fd =
+      target_fds.empty() ? 0 : *std::max_element(target_fds.begin(), target_fds.end()) + 1;
+  std::vector<int> temp_fds;
+  for (android::base::unique_fd& fd : fds) {
+    int temp_fd = fcntl(fd.get(), F_DUPFD_CLOEXEC, min_fd);
+    if (temp_fd < 0) {
+      PLOG(FATAL) << "Failed to duplicate fd " << fd.get();
+    }
+    temp_fds.push_back(temp_fd);
+  }
+  fds.clear();
+  for (size_t i = 0; i != temp_fds.size(); ++i) {
+    if (dup2(temp_fds[i], target_fds[i]) < 0) {
+      PLOG(FATAL) << "Failed to install fd " << target_fds[i];
+    }
+    close(temp_fds[i]);
+  }
+
+  Thread::Current()->InitAfterFork();
+  args.push_back(nullptr);
+  int result = static_cast<int>(Dex2oat(static_cast<int>(args.size() - 1u), args.data()));
+  if (!kIsDebugBuild && !kIsPGOInstrumentation && !kRunningOnMemoryTool) {
+    FastExit(result);
+  }
+  exit(result);
+}
+
+static int Dex2oatForkServer(int argc, char** argv) {
+  using Protocol = Dex2oatForkServerProtocol;
+
+  Locks::Init();
+  InitLogging(argv, Runtime::Abort);
+  MemMap::Init();
+
+  int server_fd = -1;
+  std::string boot_image;
+  InstructionSet isa = kRuntimeISA;
+  std::vector<const char*> runtime_args;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg(argv[i]);
+    if (android::base::StartsWith(arg, "--fork-server-fd=")) {
+      if (!android::base::ParseInt(argv[i] + strlen("--fork-server-fd="), &server_fd, 0)) {
+        LOG(ERROR) << "Invalid fork server fd: " << arg;
+        return EXIT_FAILURE;
+      }
+    } else if (android::base::StartsWith(arg, "--boot-image=")) {
+      boot_image = arg.substr(strlen("--boot-image="));
+    } else if (android::base::StartsWith(arg, "--instruction-set=")) {
+      isa = GetInstructionSetFromString(argv[i] + strlen("--instruction-set="));
+      if (isa == InstructionSet::kNone) {
+        LOG(ERROR) << "Unknown instruction set: " << arg;
+        return EXIT_FAILURE;
+      }
+    } else if (arg == "--runtime-arg" && i + 1 < argc) {
+      runtime_args.push_back(argv[++i]);
+    } else {
+      LOG(ERROR) << "Unknown fork server argument: " << arg;
+      return EXIT_FAILURE;
+    }
+  }
+  if (boot_image.empty()) {
+    boot_image = GetDefaultBootImageLocation(GetAndroidRoot(), /*deny_art_apex_data_files=*/false);
+  }
+
+  // The callbacks only make the runtime an AOT compiler runtime, each compilation sets its own.
+  QuickCompilerCallbacks callbacks(CompilerCallbacks::CallbackMode::kCompileApp);
+  RuntimeOptions raw_options;
+  raw_options.push_back(std::make_pair("-Ximage:" + boot_image, nullptr));
+  for (const char* runtime_arg : runtime_args) {
+    raw_options.push_back(std::make_pair(runtime_arg, nullptr));
+  }
+  Dex2Oat::AddCommonRuntimeOptions(&callbacks, isa, &raw_options);
+  RuntimeArgumentMap runtime_options;
+  if (!Runtime::ParseOptions(raw_options, false, &runtime_options)) {
+    LOG(ERROR) << "Failed to parse runtime options";
+    return EXIT_FAILURE;
+  }
+  if (!Runtime::Create(std::move(runtime_options))) {
+    LOG(ERROR) << "Failed to create runtime";
+    return EXIT_FAILURE;
+  }
+  Dex2Oat::InitializeCompilerRuntime(Runtime::Current(), isa);
+  gForkServerRuntimeConfig =
+      new ForkServerRuntimeConfig{boot_image, isa, GetForkServerRuntimeArgs(runtime_args)};
+
+  std::vector<uint8_t> buffer(Protocol::kMaxRequestSize);
+  while (true) {
+    std::vector<android::base::unique_fd> fds;
+    ssize_t size = ReceiveForkServerRequest(server_fd, &buffer, &fds);
+    if (size == 0) {
+      break;
+    }
+    if (size < 0) {
+      PLOG(ERROR) << "Failed to receive fork server request";
+      return EXIT_FAILURE;
+    }
+
+    Protocol::Request request;
+    std::vector<int> target_fds;
+    std::vector<char*> args;
+    bool valid = static_cast<size_t>(size) >= sizeof(request);
+    if (valid) {
+      memcpy(&request, buffer.data(), sizeof(request));
+      valid = request.magic == Protocol::kRequestMagic && request.num_fds == fds.size() &&
+              request.num_args != 0u &&
+              static_cast<size_t>(size) >= sizeof(request) + request.num_fds * sizeof(int32_t) &&
+              buffer[size - 1] == 0u;
+    }
+    if (valid) {
+      const uint8_t* fd_data = buffer.data() + sizeof(request);
+      for (size_t i = 0; i != request.num_fds; ++i) {
+        int32_t target_fd;
+        memcpy(&target_fd, fd_data + i * sizeof(int32_t), sizeof(int32_t));
+        valid = valid && target_fd > STDERR_FILENO;
+        target_fds.push_back(target_fd);
+      }
+      char* arg_data = reinterpret_cast<char*>(buffer.data()) + sizeof(request) +
+                       request.num_fds * sizeof(int32_t);
+      for (char* end = reinterpret_cast<char*>(buffer.data()) + size; arg_data != end;
+           arg_data += strlen(arg_data) + 1u) {
+        args.push_back(arg_data);
+      }
+      valid = valid && args.size() == request.num_args;
+    }
+    if (!valid) {
+      LOG(ERROR) << "Invalid fork server request";
+      if (!SendForkServerReply(server_fd, {Protocol::Reply::kStarted, -1, 0, 0})) {
+        return EXIT_FAILURE;
+      }
+      continue;
+    }
+
+    pid_t pid = fork();
+    if (pid == 0) {
+      RunForkServerChild(server_fd, std::move(fds), target_fds, std::move(args));
+    }
+    if (pid < 0) {
+      PLOG(ERROR) << "Failed to fork";
+    }
+    if (!SendForkServerReply(server_fd, {Protocol::Reply::kStarted, pid, 0, 0})) {
+      return EXIT_FAILURE;
+    }
+    if (pid < 0) {
+      continue;
+    }
+    fds.clear();
+    int status;
+    rusage usage;
+    if (TEMP_FAILURE_RETRY(wait4(pid, &status, 0, &usage)) != pid) {
+      PLOG(FATAL) << "Failed to wait for " << pid;
+    }
+    int64_t cpu_time_ms = (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * INT64_C(1000) +
+                          (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000;
+    if (!SendForkServerReply(
+            server_fd,
+            {Protocol::Reply::kExited, pid, status, static_cast<int32_t>(cpu_time_ms)})) {
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
 }  // namespace art
 
 int main(int argc, char** argv) {
+  if (argc > 1 && android::base::StartsWith(argv[1], "--fork-server-fd=")) {
+    return art::Dex2oatForkServer(argc, argv);
+  }
   int result = static_cast<int>(art::Dex2oat(argc, argv));
   // Everything was done, do an explicit exit here to avoid running Runtime destructors that take
   // time (bug 10645725) unless we're a debug or instrumented build or running on a memory tool.
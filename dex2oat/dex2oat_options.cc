@@ -215,6 +215,7 @@ static void AddImageMappings(Builder& builder) {
           .WithType<ImageHeader::StorageMode>()
           .WithValueMap({{"lz4", ImageHeader::kStorageModeLZ4},
                          {"lz4hc", ImageHeader::kStorageModeLZ4HC},
+                         {"zstd", ImageHeader::kStorageModeZstd},
                          {"uncompressed", ImageHeader::kStorageModeUncompressed}})
           .WithHelp("Which format to store the image Defaults to uncompressed. Eg:"
                     " --image-format=lz4")
@@ -357,6 +358,12 @@ Parser CreateDex2oatArgumentParser() {
           .WithHelp("Specifies the minimum total dex file size in bytes to consider the input\n"
                     "\"very large\" and reduce compilation done.")
           .IntoKey(M::VeryLargeAppThreshold)
+      .Define("--memory-budget-mb=_")
+          .WithType<unsigned int>()
+          .WithHelp("Specifies the memory in megabytes that the compilation may use. Very large\n"
+                    "apps are compiled instead of being downgraded to verify if the estimated\n"
+                    "memory use fits, with fewer threads if needed and without swap.")
+          .IntoKey(M::MemoryBudgetMb)
       .Define("--force-determinism")
           .WithHelp("Force the compiler to emit a deterministic output")
           .IntoKey(M::ForceDeterminism)
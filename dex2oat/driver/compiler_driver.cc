@@ -23,6 +23,8 @@
 #endif
 
 #include <string_view>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "android-base/logging.h"
@@ -447,6 +449,47 @@ static bool ShouldCompileBasedOnProfile(const CompilerOptions& compiler_options,
   }
 }
 
+// Returns whether the profile has inline caches for the method, which make its compiled code
+// specific to it.
+static bool HasInlineCaches(const CompilerOptions& compiler_options,
+                            ProfileCompilationInfo::ProfileIndexType profile_index,
+                            MethodReference method_ref) {
+  if (profile_index == ProfileCompilationInfo::MaxProfileIndex()) {
+    return false;
+  }
+  ProfileCompilationInfo::MethodHotness hotness =
+      compiler_options.GetProfileCompilationInfo()->GetMethodHotness(method_ref);
+  return hotness.GetInlineCacheMap() != nullptr && !hotness.GetInlineCacheMap()->empty();
+}
+
+// Returns a copy of the code compiled for `duplicate_method_idx`, which has the same code item,
+// access flags, prototype and declaring class as method `method_idx`, so that the compiler would
+// generate the same code for both. Returns null if the code cannot be reused.
+static CompiledMethod* ReuseCompiledMethod(CompilerDriver* driver,
+                                           const DexFile& dex_file,
+                                           uint32_t method_idx,
+                                           uint32_t duplicate_method_idx,
+                                           ProfileCompilationInfo::ProfileIndexType profile_index) {
+  if (duplicate_method_idx == dex::kDexNoIndex) {
+    return nullptr;
+  }
+  const CompilerOptions& compiler_options = driver->GetCompilerOptions();
+  MethodReference duplicate_ref(&dex_file, duplicate_method_idx);
+  CompiledMethod* duplicate = driver->GetCompiledMethod(duplicate_ref);
+  if (duplicate == nullptr ||
+      duplicate->IsIntrinsic() ||
+      HasInlineCaches(compiler_options, profile_index, duplicate_ref) ||
+      HasInlineCaches(compiler_options, profile_index, MethodReference(&dex_file, method_idx))) {
+    return nullptr;
+  }
+  return driver->GetCompiledMethodStorage()->CreateCompiledMethod(duplicate->GetInstructionSet(),
+                                                                  duplicate->GetQuickCode(),
+                                                                  duplicate->GetVmapTable(),
+                                                                  duplicate->GetCFIInfo(),
+                                                                  duplicate->GetPatches(),
+                                                                  /* is_intrinsic= */ false);
+}
+
 static void CompileMethodQuick(
     Thread* self,
     CompilerDriver* driver,
@@ -458,8 +501,9 @@ static void CompileMethodQuick(
     Handle<mirror::ClassLoader> class_loader,
     const DexFile& dex_file,
     Handle<mirror::DexCache> dex_cache,
-    ProfileCompilationInfo::ProfileIndexType profile_index) {
-  auto quick_fn = [profile_index]([[maybe_unused]] Thread* self,
+    ProfileCompilationInfo::ProfileIndexType profile_index,
+    uint32_t duplicate_method_idx) {
+  auto quick_fn = [profile_index, duplicate_method_idx]([[maybe_unused]] Thread* self,
                                   CompilerDriver* driver,
                                   const dex::CodeItem* code_item,
                                   uint32_t access_flags,
@@ -508,6 +552,10 @@ static void CompileMethodQuick(
       compile = compile && ShouldCompileBasedOnProfile(compiler_options, profile_index, method_ref);
 
       if (compile) {
+        compiled_method = ReuseCompiledMethod(
+            driver, dex_file, method_idx, duplicate_method_idx, profile_index);
+      }
+      if (compile && compiled_method == nullptr) {
         // NOTE: if compiler declines to compile this method, it will return null.
         compiled_method = driver->GetCompiler()->Compile(code_item,
                                                          access_flags,
@@ -2567,32 +2615,117 @@ void CompilerDriver::InitializeClasses(jobject class_loader,
   }
 }
 
+// A range of the methods of a class, compiled by one thread.
+struct CompileWorkItem {
+  uint32_t dex_file_index;
+  uint16_t class_def_index;
+  // Positions of the first and past the last method of the range in the class data.
+  uint32_t method_begin;
+  uint32_t method_end;
+  // Estimated compilation cost of the methods, their number of code units.
+  size_t cost;
+};
+
+// Minimum number of work items per thread. The classes are split into method ranges so that
+// no work item costs more than a share of the total cost, which keeps giant classes from
+// leaving a single thread busy at the end of the compilation.
+static constexpr size_t kMinCompileWorkItemsPerThread = 8;
+// Cost added for each method, for the work independent of its code size.
+static constexpr size_t kCompileCostPerMethod = 16;
+
+// Compiles the classes of all `dex_files` as a single parallel work set, so that the threads
+// do not wait for the last classes of a dex file before starting on the next dex file. The most
+// costly work items are compiled first.
 template <typename CompileFn>
-static void CompileDexFile(CompilerDriver* driver,
-                           jobject class_loader,
-                           const DexFile& dex_file,
-                           const std::vector<const DexFile*>& dex_files,
-                           ThreadPool* thread_pool,
-                           size_t thread_count,
-                           TimingLogger* timings,
-                           const char* timing_name,
-                           CompileFn compile_fn) {
+static void CompileDexFiles(CompilerDriver* driver,
+                            jobject class_loader,
+                            const std::vector<const DexFile*>& dex_files,
+                            ThreadPool* thread_pool,
+                            size_t thread_count,
+                            TimingLogger* timings,
+                            const char* timing_name,
+                            CompileFn compile_fn) {
   TimingLogger::ScopedTiming t(timing_name, timings);
   ParallelCompilationManager context(Runtime::Current()->GetClassLinker(),
                                      class_loader,
                                      driver,
-                                     &dex_file,
+                                     /* dex_file= */ nullptr,
                                      dex_files,
                                      thread_pool);
   const CompilerOptions& compiler_options = driver->GetCompilerOptions();
   bool have_profile = (compiler_options.GetProfileCompilationInfo() != nullptr);
   bool use_profile = CompilerFilter::DependsOnProfile(compiler_options.GetCompilerFilter());
-  ProfileCompilationInfo::ProfileIndexType profile_index = (have_profile && use_profile)
-      ? compiler_options.GetProfileCompilationInfo()->FindDexFile(dex_file)
-      : ProfileCompilationInfo::MaxProfileIndex();
 
-  auto compile = [&context, &compile_fn, profile_index](size_t class_def_index) {
-    const DexFile& dex_file = *context.GetDexFile();
+  std::vector<ProfileCompilationInfo::ProfileIndexType> profile_indexes;
+  for (const DexFile* dex_file : dex_files) {
+    CHECK(dex_file != nullptr);
+    profile_indexes.push_back((have_profile && use_profile)
+        ? compiler_options.GetProfileCompilationInfo()->FindDexFile(*dex_file)
+        : ProfileCompilationInfo::MaxProfileIndex());
+  }
+
+  // Estimate the cost of each class and split the costly ones into ranges of methods.
+  std::vector<std::vector<size_t>> method_costs;
+  size_t total_cost = 0u;
+  for (const DexFile* dex_file : dex_files) {
+    for (ClassAccessor accessor : dex_file->GetClasses()) {
+      std::vector<size_t>& costs = method_costs.emplace_back();
+      for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+        costs.push_back(kCompileCostPerMethod + method.GetInstructions().InsnsSizeInCodeUnits());
+        total_cost += costs.back();
+      }
+    }
+  }
+  const size_t max_work_item_cost =
+      std::max<size_t>(total_cost / (thread_count * kMinCompileWorkItemsPerThread), 1u);
+  std::vector<CompileWorkItem> work_items;
+  auto class_costs_it = method_costs.begin();
+  for (uint32_t dex_file_index = 0; dex_file_index != dex_files.size(); ++dex_file_index) {
+    for (uint32_t class_def_index = 0;
+         class_def_index != dex_files[dex_file_index]->NumClassDefs();
+         ++class_def_index, ++class_costs_it) {
+      const std::vector<size_t>& costs = *class_costs_it;
+      CompileWorkItem item = {dex_file_index, dchecked_integral_cast<uint16_t>(class_def_index),
+                              /* method_begin= */ 0u, /* method_end= */ 0u, /* cost= */ 0u};
+      for (size_t cost : costs) {
+        if (item.cost != 0u && item.cost + cost > max_work_item_cost) {
+          work_items.push_back(item);
+          item.method_begin = item.method_end;
+          item.cost = 0u;
+        }
+        ++item.method_end;
+        item.cost += cost;
+      }
+      if (item.cost != 0u) {
+        work_items.push_back(item);
+      }
+    }
+  }
+  DCHECK(class_costs_it == method_costs.end());
+  method_costs.clear();
+  std::stable_sort(work_items.begin(),
+                   work_items.end(),
+                   [](const CompileWorkItem& lhs, const CompileWorkItem& rhs) {
+                     return lhs.cost > rhs.cost;
+                   });
+
+  // The compiled code cannot be shared by methods which are compiled as intrinsics or which are
+  // expected to be compiled separately by the tests.
+  bool reuse_compiled_code = !compiler_options.IsBootImage() &&
+                             !compiler_options.IsBootImageExtension() &&
+                             !compiler_options.CompileArtTest();
+
+  auto compile = [&context,
+                  &compile_fn,
+                  &dex_files,
+                  &work_items,
+                  &profile_indexes,
+                  reuse_compiled_code](size_t index) {
+    const CompileWorkItem& item = work_items[index];
+    const DexFile& dex_file = *dex_files[item.dex_file_index];
+    const size_t class_def_index = item.class_def_index;
+    const ProfileCompilationInfo::ProfileIndexType profile_index =
+        profile_indexes[item.dex_file_index];
     SCOPED_TRACE << "compile " << dex_file.GetLocation() << "@" << class_def_index;
     ClassLinker* class_linker = context.GetClassLinker();
     jobject jclass_loader = context.GetClassLoader();
@@ -2634,16 +2767,42 @@ static void CompileDexFile(CompilerDriver* driver,
     // Go to native so that we don't block GC during compilation.
     ScopedThreadSuspension sts(soa.Self(), ThreadState::kNative);
 
-    // Compile direct and virtual methods.
+    // Methods of the class compiled so far, by code item. Dex files share the code items of
+    // methods with identical code, such as the trivial constructors and the bridge methods.
+    std::unordered_map<const dex::CodeItem*, std::pair<uint32_t, uint32_t>> compiled_code_items;
+
+    // Compile the direct and virtual methods of the work item.
     int64_t previous_method_idx = -1;
+    uint32_t method_position = 0u;
     for (const ClassAccessor::Method& method : accessor.GetMethods()) {
       const uint32_t method_idx = method.GetIndex();
+      const bool in_work_item =
+          method_position >= item.method_begin && method_position < item.method_end;
+      ++method_position;
       if (method_idx == previous_method_idx) {
         // smali can create dex files with two encoded_methods sharing the same method_idx
         // http://code.google.com/p/smali/issues/detail?id=119
         continue;
       }
       previous_method_idx = method_idx;
+      if (!in_work_item) {
+        continue;
+      }
+      // The code compiled for a method with the same code item can be reused if the method
+      // also has the same access flags and prototype, as they are in the same class.
+      uint32_t duplicate_method_idx = dex::kDexNoIndex;
+      if (method.GetCodeItem() != nullptr && reuse_compiled_code) {
+        auto [it, inserted] = compiled_code_items.emplace(
+            method.GetCodeItem(), std::make_pair(method_idx, method.GetAccessFlags()));
+        if (!inserted) {
+          auto [first_method_idx, first_access_flags] = it->second;
+          if (dex_file.GetMethodId(method_idx).proto_idx_ ==
+                  dex_file.GetMethodId(first_method_idx).proto_idx_ &&
+              method.GetAccessFlags() == first_access_flags) {
+            duplicate_method_idx = first_method_idx;
+          }
+        }
+      }
       compile_fn(soa.Self(),
                  driver,
                  method.GetCodeItem(),
@@ -2654,10 +2813,11 @@ static void CompileDexFile(CompilerDriver* driver,
                  class_loader,
                  dex_file,
                  dex_cache,
-                 profile_index);
+                 profile_index,
+                 duplicate_method_idx);
     }
   };
-  context.ForAllLambda(0, dex_file.NumClassDefs(), compile, thread_count);
+  context.ForAllLambda(0, work_items.size(), compile, thread_count);
 }
 
 void CompilerDriver::Compile(jobject class_loader,
@@ -2672,22 +2832,18 @@ void CompilerDriver::Compile(jobject class_loader,
             : profile_compilation_info->DumpInfo(dex_files));
   }
 
-  for (const DexFile* dex_file : dex_files) {
-    CHECK(dex_file != nullptr);
-    CompileDexFile(this,
-                   class_loader,
-                   *dex_file,
-                   dex_files,
-                   parallel_thread_pool_.get(),
-                   parallel_thread_count_,
-                   timings,
-                   "Compile Dex File Quick",
-                   CompileMethodQuick);
-    const ArenaPool* const arena_pool = Runtime::Current()->GetArenaPool();
-    const size_t arena_alloc = arena_pool->GetBytesAllocated();
-    max_arena_alloc_ = std::max(arena_alloc, max_arena_alloc_);
-    Runtime::Current()->ReclaimArenaPoolMemory();
-  }
+  CompileDexFiles(this,
+                  class_loader,
+                  dex_files,
+                  parallel_thread_pool_.get(),
+                  parallel_thread_count_,
+                  timings,
+                  "Compile Dex Files Quick",
+                  CompileMethodQuick);
+  const ArenaPool* const arena_pool = Runtime::Current()->GetArenaPool();
+  const size_t arena_alloc = arena_pool->GetBytesAllocated();
+  max_arena_alloc_ = std::max(arena_alloc, max_arena_alloc_);
+  Runtime::Current()->ReclaimArenaPoolMemory();
 
   VLOG(compiler) << "Compile: " << GetMemoryUsageString(false);
 }
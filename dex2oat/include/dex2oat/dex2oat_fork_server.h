@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_DEX2OAT_INCLUDE_DEX2OAT_DEX2OAT_FORK_SERVER_H_
+#define ART_DEX2OAT_INCLUDE_DEX2OAT_DEX2OAT_FORK_SERVER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace art {
+
+// The protocol between a dex2oat fork server and its client.
+//
+// A fork server is started with
+//   dex2oat --fork-server-fd=<fd> [--boot-image=<location>] --instruction-set=<isa>
+//       [--runtime-arg <arg>]...
+// where <fd> is one end of a SOCK_SEQPACKET socket pair. It creates a runtime for compiling apps
+// against the given boot image and then serves compilation requests, one at a time, by forking a
+// child that reuses the runtime. It exits when the client closes its end of the socket.
+//
+// A request is a single message consisting of a `Request`, `num_fds` int32_t fd numbers, and
+// `num_args` NUL-terminated dex2oat arguments, starting with argv[0]. The message carries `num_fds`
+// fds as SCM_RIGHTS ancillary data, which the child installs at the fd numbers of the request
+// before running dex2oat with the arguments. The boot image, the instruction set and the runtime
+// arguments of the request must match the ones of the server, except for -Xtarget-sdk-version and
+// -Xhidden-api-policy. The server answers each request with a `kStarted`
+// reply once the child is forked and a `kExited` reply once it has exited.
+class Dex2oatForkServerProtocol {
+ public:
+  static constexpr uint32_t kRequestMagic = 0x64326673;  // "d2fs"
+  static constexpr size_t kMaxRequestSize = 128 * 1024;
+  // SCM_MAX_FD.
+  static constexpr size_t kMaxRequestFds = 253;
+
+  struct Request {
+    uint32_t magic;
+    uint32_t num_fds;
+    uint32_t num_args;
+  };
+
+  struct Reply {
+    enum Type : uint32_t {
+      // The child has been forked, `pid` is its pid, or -1 if the request failed.
+      kStarted = 1,
+      // The child has exited, `wait_status` is its status as returned by `wait4`.
+      kExited = 2,
+    };
+
+    Type type;
+    int32_t pid;
+    int32_t wait_status;
+    // The CPU time of the child, in milliseconds.
+    int32_t cpu_time_ms;
+  };
+};
+
+}  // namespace art
+
+#endif  // ART_DEX2OAT_INCLUDE_DEX2OAT_DEX2OAT_FORK_SERVER_H_
@@ -156,5 +156,14 @@ TEST_F(ImageWriteReadTest, WriteReadLZ4HCKBBlock) {
   TestWriteRead(ImageHeader::kStorageModeLZ4HC, /*max_image_block_size=*/KB);
 }
 
+TEST_F(ImageWriteReadTest, WriteReadZstd) {
+  TestWriteRead(ImageHeader::kStorageModeZstd,
+                /*max_image_block_size=*/std::numeric_limits<uint32_t>::max());
+}
+
+TEST_F(ImageWriteReadTest, WriteReadZstdKBBlock) {
+  TestWriteRead(ImageHeader::kStorageModeZstd, /*max_image_block_size=*/KB);
+}
+
 }  // namespace linker
 }  // namespace art
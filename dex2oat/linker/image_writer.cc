@@ -62,6 +62,7 @@
 #include "jni/jni_internal.h"
 #include "linear_alloc.h"
 #include "lock_word.h"
+#include "mirror/array-alloc-inl.h"
 #include "mirror/array-inl.h"
 #include "mirror/class-inl.h"
 #include "mirror/class_ext-inl.h"
@@ -116,15 +117,54 @@ constexpr double kImageInternTableMaxLoadFactor = 0.6;
 // Separate objects into multiple bins to optimize dirty memory use.
 static constexpr bool kBinObjects = true;
 
+// Record the WellKnownClasses members if all their declaring classes are in the boot image
+// being compiled, so that the runtime does not need to look them up by name.
+static bool AllocateWellKnownMembers(
+    Thread* self,
+    const CompilerOptions& compiler_options,
+    /*out*/ MutableHandle<mirror::ObjectArray<mirror::Class>> classes,
+    /*out*/ MutableHandle<mirror::IntArray> indexes) REQUIRES_SHARED(Locks::mutator_lock_) {
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  size_t num_members = WellKnownClasses::GetNumberOfBootImageMembers();
+  classes.Assign(mirror::ObjectArray<mirror::Class>::Alloc(
+      self, GetClassRoot<mirror::ObjectArray<mirror::Class>>(class_linker), num_members));
+  if (classes == nullptr) {
+    return false;
+  }
+  indexes.Assign(mirror::IntArray::Alloc(self, num_members));
+  if (indexes == nullptr) {
+    return false;
+  }
+  WellKnownClasses::FillBootImageMembers(classes.Get(), indexes.Get());
+  for (size_t i = 0; i != num_members; ++i) {
+    if (!compiler_options.WithinOatFile(&classes->GetWithoutChecks(i)->GetDexFile())) {
+      classes.Assign(nullptr);
+      indexes.Assign(nullptr);
+      break;
+    }
+  }
+  return true;
+}
+
 static ObjPtr<mirror::ObjectArray<mirror::Object>> AllocateBootImageLiveObjects(
-    Thread* self, Runtime* runtime) REQUIRES_SHARED(Locks::mutator_lock_) {
+    Thread* self,
+    Runtime* runtime,
+    const CompilerOptions& compiler_options) REQUIRES_SHARED(Locks::mutator_lock_) {
   ClassLinker* class_linker = runtime->GetClassLinker();
   // The objects used for the Integer.valueOf() intrinsic must remain live even if references
   // to them are removed using reflection. Image roots are not accessible through reflection,
   // so the array we construct here shall keep them alive.
-  StackHandleScope<1> hs(self);
+  StackHandleScope<3> hs(self);
   Handle<mirror::ObjectArray<mirror::Object>> integer_cache =
       hs.NewHandle(IntrinsicObjects::LookupIntegerCache(self, class_linker));
+  MutableHandle<mirror::ObjectArray<mirror::Class>> well_known_member_classes =
+      hs.NewHandle<mirror::ObjectArray<mirror::Class>>(nullptr);
+  MutableHandle<mirror::IntArray> well_known_member_indexes =
+      hs.NewHandle<mirror::IntArray>(nullptr);
+  if (!AllocateWellKnownMembers(
+          self, compiler_options, well_known_member_classes, well_known_member_indexes)) {
+    return nullptr;
+  }
   size_t live_objects_size =
       enum_cast<size_t>(ImageHeader::kIntrinsicObjectsStart) +
       ((integer_cache != nullptr) ? (/* cache */ 1u + integer_cache->GetLength()) : 0u);
@@ -149,6 +189,8 @@ static ObjPtr<mirror::ObjectArray<mirror::Object>> AllocateBootImageLiveObjects(
             runtime->GetPreAllocatedOutOfMemoryErrorWhenHandlingStackOverflow());
   set_entry(ImageHeader::kNoClassDefFoundError, runtime->GetPreAllocatedNoClassDefFoundError());
   set_entry(ImageHeader::kClearedJniWeakSentinel, runtime->GetSentinel().Read());
+  set_entry(ImageHeader::kWellKnownMemberClasses, well_known_member_classes.Get());
+  set_entry(ImageHeader::kWellKnownMemberIndexes, well_known_member_indexes.Get());
 
   DCHECK_EQ(index, enum_cast<int32_t>(ImageHeader::kIntrinsicObjectsStart));
   if (integer_cache != nullptr) {
@@ -1070,7 +1112,8 @@ bool ImageWriter::CreateImageRoots() {
   // Prepare boot image live objects if we're compiling a boot image or boot image extension.
   Handle<mirror::ObjectArray<mirror::Object>> boot_image_live_objects;
   if (compiler_options_.IsBootImage()) {
-    boot_image_live_objects = handles.NewHandle(AllocateBootImageLiveObjects(self, runtime));
+    boot_image_live_objects =
+        handles.NewHandle(AllocateBootImageLiveObjects(self, runtime, compiler_options_));
     if (boot_image_live_objects == nullptr) {
       return false;
     }
@@ -1301,7 +1344,9 @@ void ImageWriter::TryAssignConflictTableOffset(ImtConflictTable* table, size_t o
   CHECK(!IsInBootImage(table));
   // If the method is a conflict method we also want to assign the conflict table offset.
   ImageInfo& image_info = GetImageInfo(oat_index);
-  const size_t size = table->ComputeSize(target_ptr_size_);
+  // The copy is linear, see CopyAndFixupImtConflictTable().
+  const size_t size =
+      ImtConflictTable::ComputeSize(table->NumEntries(target_ptr_size_), target_ptr_size_);
   native_object_relocations_.insert(std::make_pair(
       table,
       NativeObjectRelocation{
@@ -1463,7 +1508,7 @@ class ImageWriter::LayoutHelper::CollectClassesVisitor {
       ClassTable* app_class_table = app_class_loader->GetClassTable();
       ReaderMutexLock lock(self, app_class_table->lock_);
       DCHECK_EQ(app_class_table->classes_.size(), 1u);
-      const ClassTable::ClassSet& app_class_set = app_class_table->classes_[0];
+      const ClassTable::ClassSet& app_class_set = app_class_table->classes_.front();
       DCHECK_GE(app_class_set.size(), image_info.class_table_size_);
       boot_image_classes.reserve(app_class_set.size() - image_info.class_table_size_);
       for (const ClassTable::TableSlot& slot : app_class_set) {
@@ -2789,10 +2834,13 @@ void ImageWriter::CopyAndFixupImTable(ImTable* orig, ImTable* copy) {
 }
 
 void ImageWriter::CopyAndFixupImtConflictTable(ImtConflictTable* orig, ImtConflictTable* copy) {
-  const size_t count = orig->NumEntries(target_ptr_size_);
-  for (size_t i = 0; i < count; ++i) {
-    ArtMethod* interface_method = orig->GetInterfaceMethod(i, target_ptr_size_);
-    ArtMethod* implementation_method = orig->GetImplementationMethod(i, target_ptr_size_);
+  // The slots of a hashed table depend on the method addresses, which change here and when
+  // the image is relocated, so the entries of hashed tables are compacted into a linear table.
+  size_t i = 0u;
+  orig->Visit([&](const std::pair<ArtMethod*, ArtMethod*>& methods)
+                  REQUIRES_SHARED(Locks::mutator_lock_) {
+    ArtMethod* interface_method = methods.first;
+    ArtMethod* implementation_method = methods.second;
     CopyAndFixupPointer(copy->AddressOfInterfaceMethod(i, target_ptr_size_), interface_method);
     CopyAndFixupPointer(
         copy->AddressOfImplementationMethod(i, target_ptr_size_), implementation_method);
@@ -2800,7 +2848,10 @@ void ImageWriter::CopyAndFixupImtConflictTable(ImtConflictTable* orig, ImtConfli
               NativeLocationInImage(interface_method));
     DCHECK_EQ(copy->GetImplementationMethod(i, target_ptr_size_),
               NativeLocationInImage(implementation_method));
-  }
+    ++i;
+    return methods;
+  }, target_ptr_size_);
+  DCHECK_EQ(i, copy->NumEntries(target_ptr_size_));
 }
 
 void ImageWriter::CopyAndFixupNativeData(size_t oat_index) {
@@ -2905,7 +2956,7 @@ void ImageWriter::CopyAndFixupNativeData(size_t oat_index) {
       MutexLock lock(Thread::Current(), *Locks::intern_table_lock_);
       CHECK(!temp_intern_table.strong_interns_.tables_.empty());
       // The UnorderedSet was inserted at the beginning.
-      CHECK_EQ(temp_intern_table.strong_interns_.tables_[0].Size(), intern_table.size());
+      CHECK_EQ(temp_intern_table.strong_interns_.tables_.front().Size(), intern_table.size());
     }
   }
 
@@ -2934,7 +2985,7 @@ void ImageWriter::CopyAndFixupNativeData(size_t oat_index) {
       ReaderMutexLock lock(Thread::Current(), temp_class_table.lock_);
       CHECK(!temp_class_table.classes_.empty());
       // The ClassSet was inserted at the beginning.
-      CHECK_EQ(temp_class_table.classes_[0].size(), table.size());
+      CHECK_EQ(temp_class_table.classes_.front().size(), table.size());
     }
   }
 }
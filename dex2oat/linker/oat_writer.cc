@@ -367,6 +367,7 @@ OatWriter::OatWriter(const CompilerOptions& compiler_options,
       size_verifier_deps_alignment_(0),
       size_vdex_lookup_table_alignment_(0),
       size_vdex_lookup_table_(0),
+      size_vdex_class_descriptor_hashes_(0),
       size_interpreter_to_interpreter_bridge_(0),
       size_interpreter_to_compiled_code_bridge_(0),
       size_jni_dlsym_lookup_trampoline_(0),
@@ -943,6 +944,8 @@ struct OatWriter::BssMappingInfo {
 // See also OrderedMethodVisitor.
 struct OatWriter::OrderedMethodData {
   uint32_t hotness_bits;
+  // Rank of the method in the profile's startup order, or `kNoStartupOrder`.
+  uint32_t startup_order;
   OatClass* oat_class;
   CompiledMethod* compiled_method;
   MethodReference method_reference;
@@ -974,6 +977,10 @@ struct OatWriter::OrderedMethodData {
   //  -- post-startup
   //
   // (See MethodHotness enum definition for up-to-date binning order.)
+  //
+  // Methods with a startup order in the profile come before all bins, in the order in which
+  // they were first executed. This keeps the code executed during startup contiguous and
+  // places callees that are first executed from their caller next to it.
   bool operator<(const OrderedMethodData& other) const {
     if (kOatWriterForceOatCodeLayout) {
       // Development flag: Override default behavior by sorting by name.
@@ -983,7 +990,10 @@ struct OatWriter::OrderedMethodData {
       return name < other_name;
     }
 
-    // Use the profile's method hotness to determine sort order.
+    // Use the profile's startup order and method hotness to determine sort order.
+    if (startup_order != other.startup_order) {
+      return startup_order < other.startup_order;
+    }
     if (hotness_bits < other.hotness_bits) {
       return true;
     }
@@ -1104,6 +1114,7 @@ class OatWriter::LayoutCodeMethodVisitor final : public OatDexMethodVisitor {
       uint32_t method_index = method.GetIndex();
       MethodReference method_ref(dex_file_, method_index);
       uint32_t hotness_bits = 0u;
+      uint32_t startup_order = ProfileCompilationInfo::kNoStartupOrder;
       if (profile_index_ != ProfileCompilationInfo::MaxProfileIndex()) {
         ProfileCompilationInfo* pci = writer_->profile_compilation_info_;
         DCHECK(pci != nullptr);
@@ -1117,6 +1128,7 @@ class OatWriter::LayoutCodeMethodVisitor final : public OatDexMethodVisitor {
             (pci->IsHotMethod(profile_index_, method_index) ? kHotBit : 0u) |
             (pci->IsStartupMethod(profile_index_, method_index) ? kStartupBit : 0u) |
             (pci->IsPostStartupMethod(profile_index_, method_index) ? kPostStartupBit : 0u);
+        startup_order = pci->GetStartupOrder(profile_index_, method_index);
         if (kIsDebugBuild) {
           // Check for bins that are always-empty given a real profile.
           if (hotness_bits == kHotBit) {
@@ -1130,6 +1142,7 @@ class OatWriter::LayoutCodeMethodVisitor final : public OatDexMethodVisitor {
       // Handle duplicate methods by pushing them repeatedly.
       OrderedMethodData method_data = {
           hotness_bits,
+          startup_order,
           oat_class,
           compiled_method,
           method_ref,
@@ -2344,7 +2357,9 @@ size_t OatWriter::InitOatCodeDexFiles(size_t offset) {
                   << "@ offset "
                   << relative_patcher_->GetOffset(ordered_method.method_reference)
                   << " X hotness "
-                  << ordered_method.hotness_bits;
+                  << ordered_method.hotness_bits
+                  << " X startup order "
+                  << ordered_method.startup_order;
       }
     }
   }
@@ -2618,6 +2633,7 @@ bool OatWriter::CheckOatSize(OutputStream* out, size_t file_offset, size_t relat
     DO_STAT(size_verifier_deps_alignment_);
     DO_STAT(size_vdex_lookup_table_);
     DO_STAT(size_vdex_lookup_table_alignment_);
+    DO_STAT(size_vdex_class_descriptor_hashes_);
     DO_STAT(size_interpreter_to_interpreter_bridge_);
     DO_STAT(size_interpreter_to_compiled_code_bridge_);
     DO_STAT(size_jni_dlsym_lookup_trampoline_);
@@ -3590,7 +3606,7 @@ void OatWriter::WriteTypeLookupTables(/*out*/std::vector<uint8_t>* buffer) {
   size_t type_lookup_table_size = 0u;
   for (const DexFile* dex_file : *dex_files_) {
     type_lookup_table_size +=
-        sizeof(uint32_t) + TypeLookupTable::RawDataLength(dex_file->NumClassDefs());
+        sizeof(uint32_t) + VdexFile::TypeLookupTableDataSize(dex_file->NumClassDefs());
   }
   // Reserve the space to avoid reallocations later on.
   buffer->reserve(buffer->size() + type_lookup_table_size);
@@ -3619,12 +3635,20 @@ void OatWriter::WriteTypeLookupTables(/*out*/std::vector<uint8_t>* buffer) {
       uint32_t table_size = table.RawDataLength();
       DCHECK_NE(0u, table_size);
       DCHECK_ALIGNED(table_size, 4);
+      // The descriptor hashes of the class defs follow the table.
+      std::vector<uint32_t> hashes = VdexFile::ComputeClassDescriptorHashes(*(*dex_files_)[i]);
+      uint32_t hashes_size = hashes.size() * sizeof(uint32_t);
+      uint32_t data_size = table_size + hashes_size;
+      DCHECK_EQ(data_size, VdexFile::TypeLookupTableDataSize(hashes.size()));
       size_t old_buffer_size = buffer->size();
-      buffer->resize(old_buffer_size + table.RawDataLength() + sizeof(uint32_t), 0u);
-      memcpy(buffer->data() + old_buffer_size, &table_size, sizeof(uint32_t));
-      memcpy(buffer->data() + old_buffer_size + sizeof(uint32_t), table.RawData(), table_size);
-      vdex_size_ += table_size + sizeof(uint32_t);
+      buffer->resize(old_buffer_size + data_size + sizeof(uint32_t), 0u);
+      uint8_t* data = buffer->data() + old_buffer_size;
+      memcpy(data, &data_size, sizeof(uint32_t));
+      memcpy(data + sizeof(uint32_t), table.RawData(), table_size);
+      memcpy(data + sizeof(uint32_t) + table_size, hashes.data(), hashes_size);
+      vdex_size_ += data_size + sizeof(uint32_t);
       size_vdex_lookup_table_ += table_size + sizeof(uint32_t);
+      size_vdex_class_descriptor_hashes_ += hashes_size;
     }
   }
 }
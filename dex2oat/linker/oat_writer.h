@@ -504,6 +504,7 @@ class OatWriter {
   uint32_t size_verifier_deps_alignment_;
   uint32_t size_vdex_lookup_table_alignment_;
   uint32_t size_vdex_lookup_table_;
+  uint32_t size_vdex_class_descriptor_hashes_;
   uint32_t size_interpreter_to_interpreter_bridge_;
   uint32_t size_interpreter_to_compiled_code_bridge_;
   uint32_t size_jni_dlsym_lookup_trampoline_;
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "linker/riscv64/relative_patcher_riscv64.h"
+
+#include "debug/method_debug_info.h"
+#include "linker/linker_patch.h"
+
+namespace art {
+namespace linker {
+
+namespace {
+
+// Instruction encoding details used for checking the instructions we patch.
+constexpr uint32_t kOpcodeMask = 0x7fu;
+constexpr uint32_t kOpcodeAuipc = 0x17u;
+constexpr uint32_t kOpcodeAndFunct3Mask = 0x707fu;
+constexpr uint32_t kAddi = 0x0013u;
+constexpr uint32_t kLw = 0x2003u;
+constexpr uint32_t kLd = 0x3003u;
+constexpr uint32_t kLwu = 0x6003u;
+constexpr uint32_t kJalr = 0x0067u;
+
+// Placeholder immediates emitted by the code generator for the unpatched instruction pair.
+constexpr uint32_t kAuipcImm20Placeholder = 0x12345u;
+constexpr uint32_t kImm12Placeholder = 0x678u;
+
+inline uint32_t GetRd(uint32_t insn) { return (insn >> 7) & 0x1fu; }
+inline uint32_t GetRs1(uint32_t insn) { return (insn >> 15) & 0x1fu; }
+
+}  // anonymous namespace
+
+uint32_t Riscv64RelativePatcher::ReserveSpace(
+    uint32_t offset,
+    [[maybe_unused]] const CompiledMethod* compiled_method,
+    [[maybe_unused]] MethodReference method_ref) {
+  return offset;  // No space reserved; the AUIPC pairs reach the whole oat file.
+}
+
+uint32_t Riscv64RelativePatcher::ReserveSpaceEnd(uint32_t offset) {
+  return offset;  // No space reserved; the AUIPC pairs reach the whole oat file.
+}
+
+uint32_t Riscv64RelativePatcher::WriteThunks([[maybe_unused]] OutputStream* out, uint32_t offset) {
+  return offset;  // No thunks added; the AUIPC pairs reach the whole oat file.
+}
+
+std::vector<debug::MethodDebugInfo> Riscv64RelativePatcher::GenerateThunkDebugInfo(
+    [[maybe_unused]] uint32_t executable_offset) {
+  return std::vector<debug::MethodDebugInfo>();  // No thunks added.
+}
+
+void Riscv64RelativePatcher::PatchCall(std::vector<uint8_t>* code,
+                                       uint32_t literal_offset,
+                                       uint32_t patch_offset,
+                                       uint32_t target_offset) {
+  // The call is an `AUIPC RA, hi20` followed by `JALR RA, lo12(RA)`.
+  DCHECK_ALIGNED(patch_offset, 4u);
+  DCHECK_ALIGNED(target_offset, 4u);
+  uint32_t auipc = GetInsn(code, literal_offset);
+  uint32_t jalr = GetInsn(code, literal_offset + 4u);
+  DCHECK_EQ(auipc & kOpcodeMask, kOpcodeAuipc) << std::hex << auipc;
+  DCHECK_EQ(jalr & kOpcodeAndFunct3Mask, kJalr) << std::hex << jalr;
+  DCHECK_EQ(GetRs1(jalr), GetRd(auipc));
+  // Unsigned arithmetic with its well-defined overflow behavior is just fine here.
+  uint32_t disp = target_offset - patch_offset;
+  SetInsn(code, literal_offset, PatchAuipc(auipc, disp));
+  SetInsn(code, literal_offset + 4u, PatchITypeImm12(jalr, disp));
+}
+
+void Riscv64RelativePatcher::PatchPcRelativeReference(std::vector<uint8_t>* code,
+                                                      const LinkerPatch& patch,
+                                                      uint32_t patch_offset,
+                                                      uint32_t target_offset) {
+  DCHECK_ALIGNED(patch_offset, 4u);
+  DCHECK_ALIGNED(target_offset, 4u);
+  uint32_t literal_offset = patch.LiteralOffset();
+  uint32_t insn = GetInsn(code, literal_offset);
+  uint32_t pc_insn_offset = patch.PcInsnOffset();
+  // Both instructions of the pair are patched with the displacement from the AUIPC.
+  uint32_t disp = target_offset - (patch_offset - literal_offset + pc_insn_offset);
+  if (literal_offset == pc_insn_offset) {
+    // Check it's an AUIPC with the placeholder immediate (unset).
+    DCHECK_EQ(insn & kOpcodeMask, kOpcodeAuipc) << std::hex << insn;
+    DCHECK_EQ(insn >> 12, kAuipcImm20Placeholder) << std::hex << insn;
+    insn = PatchAuipc(insn, disp);
+  } else {
+    // Check it's an ADDI or a load with the placeholder immediate (unset).
+    DCHECK_EQ(insn >> 20, kImm12Placeholder) << std::hex << insn;
+    if ((insn & kOpcodeAndFunct3Mask) == kAddi) {
+      DCHECK(patch.GetType() == LinkerPatch::Type::kIntrinsicReference ||
+             patch.GetType() == LinkerPatch::Type::kMethodRelative ||
+             patch.GetType() == LinkerPatch::Type::kTypeRelative ||
+             patch.GetType() == LinkerPatch::Type::kStringRelative) << patch.GetType();
+    } else {
+      DCHECK(patch.GetType() == LinkerPatch::Type::kDataBimgRelRo ||
+             patch.GetType() == LinkerPatch::Type::kMethodBssEntry ||
+             patch.GetType() == LinkerPatch::Type::kJniEntrypointRelative ||
+             patch.GetType() == LinkerPatch::Type::kTypeBssEntry ||
+             patch.GetType() == LinkerPatch::Type::kPublicTypeBssEntry ||
+             patch.GetType() == LinkerPatch::Type::kPackageTypeBssEntry ||
+             patch.GetType() == LinkerPatch::Type::kStringBssEntry) << patch.GetType();
+      DCHECK((insn & kOpcodeAndFunct3Mask) == kLw ||
+             (insn & kOpcodeAndFunct3Mask) == kLwu ||
+             (insn & kOpcodeAndFunct3Mask) == kLd) << std::hex << insn;
+    }
+    if (kIsDebugBuild) {
+      uint32_t auipc = GetInsn(code, pc_insn_offset);
+      CHECK_EQ(auipc & kOpcodeMask, kOpcodeAuipc) << std::hex << auipc;  // Check that
+      CHECK_EQ(GetRd(auipc), GetRs1(insn));  // pc_insn_offset points to AUIPC with matching reg.
+    }
+    insn = PatchITypeImm12(insn, disp);
+  }
+  SetInsn(code, literal_offset, insn);
+}
+
+void Riscv64RelativePatcher::PatchEntrypointCall([[maybe_unused]] std::vector<uint8_t>* code,
+                                                 [[maybe_unused]] const LinkerPatch& patch,
+                                                 [[maybe_unused]] uint32_t patch_offset) {
+  // Entrypoints are called directly through the thread register, no thunks are needed.
+  LOG(FATAL) << "UNIMPLEMENTED";
+}
+
+void Riscv64RelativePatcher::PatchBakerReadBarrierBranch(
+    [[maybe_unused]] std::vector<uint8_t>* code,
+    [[maybe_unused]] const LinkerPatch& patch,
+    [[maybe_unused]] uint32_t patch_offset) {
+  LOG(FATAL) << "UNIMPLEMENTED";
+}
+
+uint32_t Riscv64RelativePatcher::PatchAuipc(uint32_t auipc, uint32_t disp) {
+  // The imm12 of the paired instruction is sign-extended, so round the high part accordingly.
+  uint32_t imm20 = (disp + 0x800u) >> 12;
+  return (auipc & 0xfffu) | (imm20 << 12);
+}
+
+uint32_t Riscv64RelativePatcher::PatchITypeImm12(uint32_t insn, uint32_t disp) {
+  return (insn & 0xfffffu) | ((disp & 0xfffu) << 20);
+}
+
+void Riscv64RelativePatcher::SetInsn(std::vector<uint8_t>* code, uint32_t offset, uint32_t value) {
+  DCHECK_LE(offset + 4u, code->size());
+  DCHECK_ALIGNED(offset, 4u);
+  uint8_t* addr = &(*code)[offset];
+  addr[0] = (value >> 0) & 0xff;
+  addr[1] = (value >> 8) & 0xff;
+  addr[2] = (value >> 16) & 0xff;
+  addr[3] = (value >> 24) & 0xff;
+}
+
+uint32_t Riscv64RelativePatcher::GetInsn(ArrayRef<const uint8_t> code, uint32_t offset) {
+  DCHECK_LE(offset + 4u, code.size());
+  DCHECK_ALIGNED(offset, 4u);
+  const uint8_t* addr = &code[offset];
+  return
+      (static_cast<uint32_t>(addr[0]) << 0) +
+      (static_cast<uint32_t>(addr[1]) << 8) +
+      (static_cast<uint32_t>(addr[2]) << 16)+
+      (static_cast<uint32_t>(addr[3]) << 24);
+}
+
+template <typename Alloc>
+uint32_t Riscv64RelativePatcher::GetInsn(std::vector<uint8_t, Alloc>* code, uint32_t offset) {
+  return GetInsn(ArrayRef<const uint8_t>(*code), offset);
+}
+
+}  // namespace linker
+}  // namespace art
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "linker/riscv64/relative_patcher_riscv64.h"
+
+#include "linker/relative_patcher_test.h"
+
+namespace art {
+namespace linker {
+
+class Riscv64RelativePatcherTest : public RelativePatcherTest {
+ public:
+  Riscv64RelativePatcherTest() : RelativePatcherTest(InstructionSet::kRiscv64, "generic") { }
+
+ protected:
+  // Unpatched instructions, as emitted by the code generator.
+  static constexpr uint32_t kAuipcRaZero = 0x00000097u;     // AUIPC RA, 0
+  static constexpr uint32_t kJalrRaRaZero = 0x000080e7u;    // JALR RA, 0(RA)
+  static constexpr uint32_t kAuipcA0 = 0x12345517u;         // AUIPC A0, <placeholder>
+  static constexpr uint32_t kAddiA0A0 = 0x67850513u;        // ADDI A0, A0, <placeholder>
+  static constexpr uint32_t kLwuA0A0 = 0x67856503u;         // LWU A0, <placeholder>(A0)
+
+  static std::vector<uint8_t> RawCode(std::initializer_list<uint32_t> insns) {
+    std::vector<uint8_t> raw_code;
+    raw_code.reserve(insns.size() * 4u);
+    for (uint32_t insn : insns) {
+      raw_code.push_back(static_cast<uint8_t>(insn));
+      raw_code.push_back(static_cast<uint8_t>(insn >> 8));
+      raw_code.push_back(static_cast<uint8_t>(insn >> 16));
+      raw_code.push_back(static_cast<uint8_t>(insn >> 24));
+    }
+    return raw_code;
+  }
+
+  // Expected AUIPC and paired instruction for a displacement `disp` from the AUIPC.
+  static std::vector<uint8_t> PatchedCode(uint32_t auipc, uint32_t insn, uint32_t disp) {
+    uint32_t patched_auipc = (auipc & 0xfffu) | (((disp + 0x800u) >> 12) << 12);
+    uint32_t patched_insn = (insn & 0xfffffu) | ((disp & 0xfffu) << 20);
+    // Verify that the pair adds `disp` to the PC of the AUIPC, using the sign-extended imm12.
+    int32_t hi = static_cast<int32_t>(patched_auipc & 0xfffff000u);
+    int32_t lo = static_cast<int32_t>(patched_insn) >> 20;
+    CHECK_EQ(static_cast<uint32_t>(hi + lo), disp);
+    return RawCode({patched_auipc, patched_insn});
+  }
+
+  uint32_t GetMethodOffset(uint32_t method_idx) {
+    auto result = method_offset_map_.FindMethodOffset(MethodRef(method_idx));
+    CHECK(result.first);
+    return result.second;
+  }
+
+  void TestStringReference(uint32_t string_offset) {
+    constexpr uint32_t kStringIndex = 1u;
+    string_index_to_offset_map_.Put(kStringIndex, string_offset);
+    const std::vector<uint8_t> raw_code = RawCode({kAuipcA0, kAddiA0A0});
+    LinkerPatch patches[] = {
+        LinkerPatch::RelativeStringPatch(0u, nullptr, 0u, kStringIndex),
+        LinkerPatch::RelativeStringPatch(4u, nullptr, 0u, kStringIndex),
+    };
+    AddCompiledMethod(MethodRef(1u),
+                      ArrayRef<const uint8_t>(raw_code),
+                      ArrayRef<const LinkerPatch>(patches));
+    Link();
+
+    uint32_t disp = string_offset - GetMethodOffset(1u);
+    std::vector<uint8_t> expected_code = PatchedCode(kAuipcA0, kAddiA0A0, disp);
+    EXPECT_TRUE(CheckLinkedMethod(MethodRef(1u), ArrayRef<const uint8_t>(expected_code)));
+  }
+};
+
+TEST_F(Riscv64RelativePatcherTest, CallSelf) {
+  const std::vector<uint8_t> raw_code = RawCode({kAuipcRaZero, kJalrRaRaZero});
+  LinkerPatch patches[] = {
+      LinkerPatch::RelativeCodePatch(0u, nullptr, 1u),
+  };
+  AddCompiledMethod(MethodRef(1u),
+                    ArrayRef<const uint8_t>(raw_code),
+                    ArrayRef<const LinkerPatch>(patches));
+  Link();
+
+  std::vector<uint8_t> expected_code = PatchedCode(kAuipcRaZero, kJalrRaRaZero, 0u);
+  EXPECT_TRUE(CheckLinkedMethod(MethodRef(1u), ArrayRef<const uint8_t>(expected_code)));
+}
+
+TEST_F(Riscv64RelativePatcherTest, CallOther) {
+  const std::vector<uint8_t> raw_code = RawCode({kAuipcRaZero, kJalrRaRaZero});
+  LinkerPatch method1_patches[] = {
+      LinkerPatch::RelativeCodePatch(0u, nullptr, 2u),
+  };
+  AddCompiledMethod(MethodRef(1u),
+                    ArrayRef<const uint8_t>(raw_code),
+                    ArrayRef<const LinkerPatch>(method1_patches));
+  LinkerPatch method2_patches[] = {
+      LinkerPatch::RelativeCodePatch(0u, nullptr, 1u),
+  };
+  AddCompiledMethod(MethodRef(2u),
+                    ArrayRef<const uint8_t>(raw_code),
+                    ArrayRef<const LinkerPatch>(method2_patches));
+  Link();
+
+  uint32_t method1_offset = GetMethodOffset(1u);
+  uint32_t method2_offset = GetMethodOffset(2u);
+  std::vector<uint8_t> method1_expected_code =
+      PatchedCode(kAuipcRaZero, kJalrRaRaZero, method2_offset - method1_offset);
+  EXPECT_TRUE(CheckLinkedMethod(MethodRef(1u), ArrayRef<const uint8_t>(method1_expected_code)));
+  std::vector<uint8_t> method2_expected_code =
+      PatchedCode(kAuipcRaZero, kJalrRaRaZero, method1_offset - method2_offset);
+  EXPECT_TRUE(CheckLinkedMethod(MethodRef(2u), ArrayRef<const uint8_t>(method2_expected_code)));
+}
+
+TEST_F(Riscv64RelativePatcherTest, CallTrampoline) {
+  const std::vector<uint8_t> raw_code = RawCode({kAuipcRaZero, kJalrRaRaZero});
+  LinkerPatch patches[] = {
+      LinkerPatch::RelativeCodePatch(0u, nullptr, 2u),
+  };
+  AddCompiledMethod(MethodRef(1u),
+                    ArrayRef<const uint8_t>(raw_code),
+                    ArrayRef<const LinkerPatch>(patches));
+  Link();
+
+  uint32_t disp = kTrampolineOffset - GetMethodOffset(1u);
+  std::vector<uint8_t> expected_code = PatchedCode(kAuipcRaZero, kJalrRaRaZero, disp);
+  EXPECT_TRUE(CheckLinkedMethod(MethodRef(1u), ArrayRef<const uint8_t>(expected_code)));
+}
+
+TEST_F(Riscv64RelativePatcherTest, StringBssEntry) {
+  bss_begin_ = 0x12345678;
+  constexpr size_t kStringEntryOffset = 0x1234;
+  constexpr uint32_t kStringIndex = 1u;
+  string_index_to_offset_map_.Put(kStringIndex, kStringEntryOffset);
+  const std::vector<uint8_t> raw_code = RawCode({kAuipcA0, kLwuA0A0});
+  LinkerPatch patches[] = {
+      LinkerPatch::StringBssEntryPatch(0u, nullptr, 0u, kStringIndex),
+      LinkerPatch::StringBssEntryPatch(4u, nullptr, 0u, kStringIndex),
+  };
+  AddCompiledMethod(MethodRef(1u),
+                    ArrayRef<const uint8_t>(raw_code),
+                    ArrayRef<const LinkerPatch>(patches));
+  Link();
+
+  uint32_t disp = bss_begin_ + kStringEntryOffset - GetMethodOffset(1u);
+  std::vector<uint8_t> expected_code = PatchedCode(kAuipcA0, kLwuA0A0, disp);
+  EXPECT_TRUE(CheckLinkedMethod(MethodRef(1u), ArrayRef<const uint8_t>(expected_code)));
+}
+
+TEST_F(Riscv64RelativePatcherTest, StringReference) {
+  TestStringReference(0x12345678u);
+}
+
+TEST_F(Riscv64RelativePatcherTest, StringReferenceNegativeLowBits) {
+  // The low 12 bits of the displacement are sign-extended by the ADDI, so the AUIPC must
+  // compensate by adding one to its immediate.
+  TestStringReference(0x12345ff8u);
+}
+
+TEST_F(Riscv64RelativePatcherTest, StringReferenceBackwards) {
+  TestStringReference(0u);
+}
+
+}  // namespace linker
+}  // namespace art
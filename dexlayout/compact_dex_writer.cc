@@ -144,10 +144,13 @@ void CompactDexWriter::WriteCodeItem(Stream* stream,
                                      bool reserve_only) {
   DCHECK(code_item != nullptr);
   DCHECK(!reserve_only) << "Not supported because of deduping.";
+  // Code items only refer to the ids of their own dex file, so an identical code item of another
+  // dex file in the shared data section is equivalent and can be reused. Multidex apps often
+  // have the same accessors, constructors and lambdas in several dex files.
   ScopedDataSectionItem data_item(stream,
                                   code_item,
                                   CompactDexFile::CodeItem::kAlignment,
-                                  /* deduper= */ nullptr);
+                                  data_item_dedupe_);
 
   CompactDexFile::CodeItem disk_code_item;
 
@@ -252,10 +252,36 @@ void DexWriter::WriteStringData(Stream* stream, dex_ir::StringData* string_data)
   stream->Skip(1);
 }
 
+template <typename T>
+void DexWriter::RecordLayoutSection(DexLayoutSections::SectionType section_type,
+                                    const std::unordered_map<T*, LayoutType>& item_layout,
+                                    T* item,
+                                    uint32_t start_offset,
+                                    uint32_t end_offset) {
+  // Deduplicated items of compact dex files are not written again.
+  if (start_offset == end_offset) {
+    return;
+  }
+  auto it = item_layout.find(item);
+  if (it != item_layout.end()) {
+    DexLayoutSection& section =
+        dex_layout_->GetSections().sections_[static_cast<size_t>(section_type)];
+    section.parts_[static_cast<size_t>(it->second)].CombineSection(start_offset, end_offset);
+  }
+}
+
 void DexWriter::WriteStringDatas(Stream* stream) {
   const uint32_t start = stream->Tell();
   for (auto& string_data : header_->StringDatas()) {
+    uint32_t start_offset = stream->Tell();
     WriteStringData(stream, string_data.get());
+    if (dex_layout_ != nullptr) {
+      RecordLayoutSection(DexLayoutSections::SectionType::kSectionTypeStrings,
+                          dex_layout_->LayoutHotnessInfo().string_data_layout_,
+                          string_data.get(),
+                          start_offset,
+                          stream->Tell());
+    }
   }
   if (compute_offsets_ && start != stream->Tell()) {
     header_->StringDatas().SetOffset(start);
@@ -353,8 +379,16 @@ void DexWriter::WriteEncodedArrays(Stream* stream) {
   const uint32_t start = stream->Tell();
   for (auto& encoded_array : header_->EncodedArrayItems()) {
     stream->AlignTo(SectionAlignment(DexFile::kDexTypeEncodedArrayItem));
+    uint32_t start_offset = stream->Tell();
     ProcessOffset(stream, encoded_array.get());
     WriteEncodedArray(stream, encoded_array->GetEncodedValues());
+    if (dex_layout_ != nullptr) {
+      RecordLayoutSection(DexLayoutSections::SectionType::kSectionTypeStaticValues,
+                          dex_layout_->LayoutHotnessInfo().encoded_array_layout_,
+                          encoded_array.get(),
+                          start_offset,
+                          stream->Tell());
+    }
   }
   if (compute_offsets_ && start != stream->Tell()) {
     header_->EncodedArrayItems().SetOffset(start);
@@ -607,8 +641,8 @@ void DexWriter::WriteCodeItems(Stream* stream, bool reserve_only) {
   for (auto& code_item : header_->CodeItems()) {
     uint32_t start_offset = stream->Tell();
     WriteCodeItem(stream, code_item.get(), reserve_only);
-    // Only add the section hotness info once.
-    if (!reserve_only && code_section != nullptr) {
+    // Only add the section hotness info once. A deduplicated code item writes nothing.
+    if (!reserve_only && code_section != nullptr && stream->Tell() != start_offset) {
       auto it = dex_layout_->LayoutHotnessInfo().code_item_layout_.find(code_item.get());
       if (it != dex_layout_->LayoutHotnessInfo().code_item_layout_.end()) {
         code_section->parts_[static_cast<size_t>(it->second)].CombineSection(
@@ -657,6 +691,7 @@ void DexWriter::WriteClassDatas(Stream* stream) {
   for (const std::unique_ptr<dex_ir::ClassData>& class_data :
       header_->ClassDatas()) {
     stream->AlignTo(SectionAlignment(DexFile::kDexTypeClassDataItem));
+    uint32_t start_offset = stream->Tell();
     ProcessOffset(stream, class_data.get());
     stream->WriteUleb128(class_data->StaticFields()->size());
     stream->WriteUleb128(class_data->InstanceFields()->size());
@@ -666,6 +701,13 @@ void DexWriter::WriteClassDatas(Stream* stream) {
     WriteEncodedFields(stream, class_data->InstanceFields());
     WriteEncodedMethods(stream, class_data->DirectMethods());
     WriteEncodedMethods(stream, class_data->VirtualMethods());
+    if (dex_layout_ != nullptr) {
+      RecordLayoutSection(DexLayoutSections::SectionType::kSectionTypeClassData,
+                          dex_layout_->LayoutHotnessInfo().class_data_layout_,
+                          class_data.get(),
+                          start_offset,
+                          stream->Tell());
+    }
   }
   if (compute_offsets_ && start != stream->Tell()) {
     header_->ClassDatas().SetOffset(start);
@@ -21,12 +21,14 @@
 
 #include <functional>
 #include <memory>  // For unique_ptr
+#include <unordered_map>
 
 #include "base/os.h"
 #include "base/unix_file/fd_file.h"
 #include "dex/compact_dex_level.h"
 #include "dex_container.h"
 #include "dex/dex_file.h"
+#include "dex/dex_file_layout.h"
 #include "dex_ir.h"
 
 #include <queue>
@@ -268,6 +270,15 @@ class DexWriter {
   virtual void WriteDebugInfoItem(Stream* stream, dex_ir::DebugInfoItem* debug_info);
   virtual void WriteStringData(Stream* stream, dex_ir::StringData* string_data);
 
+  // Add the range of a written `item` to the part of the layout section given by `item_layout`,
+  // if the item has a layout.
+  template <typename T>
+  void RecordLayoutSection(DexLayoutSections::SectionType section_type,
+                           const std::unordered_map<T*, LayoutType>& item_layout,
+                           T* item,
+                           uint32_t start_offset,
+                           uint32_t end_offset);
+
   // Process an offset, if compute_offset is set, write into the dex ir item, otherwise read the
   // existing offset and use that for writing.
   void ProcessOffset(Stream* stream, dex_ir::Item* item);
@@ -25,6 +25,7 @@
 #include <inttypes.h>
 #include <stdio.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <iostream>
 #include <iterator>
@@ -1880,6 +1881,30 @@ void DexLayout::LayoutClassDefsAndClassData(const DexFile* dex_file) {
       new_class_def_order.push_back(class_def.get());
     }
   }
+  const size_t num_profile_classes = new_class_def_order.size();
+  if (info_->HasStartupOrder()) {
+    // Order the profile classes by their first use, the earliest startup order of their methods.
+    std::unordered_map<dex_ir::ClassDef*, uint32_t> class_startup_order;
+    for (dex_ir::ClassDef* class_def : new_class_def_order) {
+      uint32_t startup_order = ProfileCompilationInfo::kNoStartupOrder;
+      dex_ir::ClassData* class_data = class_def->GetClassData();
+      if (class_data != nullptr) {
+        for (size_t i = 0; i < 2; ++i) {
+          for (auto& method : *(i == 0 ? class_data->DirectMethods()
+                                       : class_data->VirtualMethods())) {
+            MethodReference ref(dex_file, method.GetMethodId()->GetIndex());
+            startup_order = std::min(startup_order, info_->GetStartupOrder(ref));
+          }
+        }
+      }
+      class_startup_order.emplace(class_def, startup_order);
+    }
+    std::stable_sort(new_class_def_order.begin(),
+                     new_class_def_order.end(),
+                     [&](dex_ir::ClassDef* a, dex_ir::ClassDef* b) {
+      return class_startup_order[a] < class_startup_order[b];
+    });
+  }
   for (auto& class_def : header_->ClassDefs()) {
     dex::TypeIndex type_idx(class_def->ClassType()->GetIndex());
     if (!info_->ContainsClass(*dex_file, type_idx)) {
@@ -1889,6 +1914,14 @@ void DexLayout::LayoutClassDefsAndClassData(const DexFile* dex_file) {
   std::unordered_set<dex_ir::ClassData*> visited_class_data;
   size_t class_data_index = 0;
   auto& class_datas = header_->ClassDatas();
+  for (size_t i = 0; i < num_profile_classes; ++i) {
+    // The class data of a profile class is read when the class is loaded and linked, and again
+    // by the code that looks up its fields and methods.
+    dex_ir::ClassData* class_data = new_class_def_order[i]->GetClassData();
+    if (class_data != nullptr) {
+      layout_hotness_info_.class_data_layout_.emplace(class_data, LayoutType::kLayoutTypeHot);
+    }
+  }
   for (dex_ir::ClassDef* class_def : new_class_def_order) {
     dex_ir::ClassData* class_data = class_def->GetClassData();
     if (class_data != nullptr && visited_class_data.find(class_data) == visited_class_data.end()) {
@@ -1903,6 +1936,32 @@ void DexLayout::LayoutClassDefsAndClassData(const DexFile* dex_file) {
   }
   CHECK_EQ(class_data_index, class_datas.Size());
 
+  // Static values are only read when the class is initialized, put the ones of the profile
+  // classes first in the same order as their class data. The other encoded arrays, including
+  // the call site arrays, keep their order.
+  std::vector<dex_ir::EncodedArrayItem*> new_encoded_array_order;
+  std::unordered_set<dex_ir::EncodedArrayItem*> visited_encoded_arrays;
+  for (size_t i = 0; i < num_profile_classes; ++i) {
+    dex_ir::EncodedArrayItem* static_values = new_class_def_order[i]->StaticValues();
+    if (static_values != nullptr && visited_encoded_arrays.insert(static_values).second) {
+      new_encoded_array_order.push_back(static_values);
+      layout_hotness_info_.encoded_array_layout_.emplace(static_values,
+                                                         LayoutType::kLayoutTypeStartupOnly);
+    }
+  }
+  auto& encoded_arrays = header_->EncodedArrayItems();
+  for (auto& encoded_array : encoded_arrays) {
+    if (visited_encoded_arrays.find(encoded_array.get()) == visited_encoded_arrays.end()) {
+      new_encoded_array_order.push_back(encoded_array.get());
+    }
+  }
+  CHECK_EQ(new_encoded_array_order.size(), encoded_arrays.Size());
+  for (size_t i = 0; i < encoded_arrays.Size(); ++i) {
+    // Same as for the class data, the sets of objects are equivalent.
+    encoded_arrays[i].release();  // NOLINT b/117926937
+    encoded_arrays[i].reset(new_encoded_array_order[i]);
+  }
+
   if (DexLayout::kChangeClassDefOrder) {
     // This currently produces dex files that violate the spec since the super class class_def is
     // supposed to occur before any subclasses.
@@ -2027,6 +2086,14 @@ void DexLayout::LayoutStringData(const DexFile* dex_file) {
     }
   }
   CHECK_EQ(data_index, string_datas.Size());
+  // The hot strings and the shorties of the executed methods are sorted to the end, record them
+  // so that the writer can compute the hot range.
+  for (auto& string_id : header_->StringIds()) {
+    if (from_hot_method[string_id->GetIndex()] || is_shorty[string_id->GetIndex()]) {
+      layout_hotness_info_.string_data_layout_.emplace(string_id->DataItem(),
+                                                       LayoutType::kLayoutTypeHot);
+    }
+  }
 }
 
 // Orders code items according to specified class data ordering.
@@ -2038,6 +2105,8 @@ void DexLayout::LayoutCodeItems(const DexFile* dex_file) {
 
   std::unordered_map<dex_ir::CodeItem*, LayoutType>& code_item_layout =
       layout_hotness_info_.code_item_layout_;
+  // The earliest startup order of the methods using each code item, if the profile has one.
+  std::unordered_map<dex_ir::CodeItem*, uint32_t> code_item_startup_order;
 
   // Assign hotness flags to all code items.
   for (InvokeType invoke_type : invoke_types) {
@@ -2083,6 +2152,14 @@ void DexLayout::LayoutCodeItems(const DexFile* dex_file) {
           // Already exists, merge the hotness.
           layout_type = MergeLayoutType(layout_type, state);
         }
+        uint32_t startup_order =
+            info_->GetStartupOrder(MethodReference(dex_file, method_id->GetIndex()));
+        if (startup_order != ProfileCompilationInfo::kNoStartupOrder) {
+          auto order_it = code_item_startup_order.emplace(code_item, startup_order);
+          if (!order_it.second) {
+            order_it.first->second = std::min(order_it.first->second, startup_order);
+          }
+        }
       }
     }
   }
@@ -2100,8 +2177,14 @@ void DexLayout::LayoutCodeItems(const DexFile* dex_file) {
     }
   }
 
-  // Sort the code items vector by new layout. The writing process will take care of calculating
-  // all the offsets. Stable sort to preserve any existing locality that might be there.
+  // Sort the code items vector by new layout, and code items with a startup order by that order
+  // within their layout type. The writing process will take care of calculating all the offsets.
+  // Stable sort to preserve any existing locality that might be there.
+  auto get_startup_order = [&](dex_ir::CodeItem* code_item) {
+    auto it = code_item_startup_order.find(code_item);
+    return it != code_item_startup_order.end() ? it->second
+                                               : ProfileCompilationInfo::kNoStartupOrder;
+  };
   std::stable_sort(code_items.begin(),
                    code_items.end(),
                    [&](const std::unique_ptr<dex_ir::CodeItem>& a,
@@ -2112,7 +2195,10 @@ void DexLayout::LayoutCodeItems(const DexFile* dex_file) {
     DCHECK(it_b != code_item_layout.end());
     const LayoutType layout_type_a = it_a->second;
     const LayoutType layout_type_b = it_b->second;
-    return layout_type_a < layout_type_b;
+    if (layout_type_a != layout_type_b) {
+      return layout_type_a < layout_type_b;
+    }
+    return get_startup_order(a.get()) < get_startup_order(b.get());
   });
 }
 
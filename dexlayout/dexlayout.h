@@ -81,6 +81,11 @@ class DexLayoutHotnessInfo {
  public:
   // Store layout information so that the offset calculation can specify the section sizes.
   std::unordered_map<dex_ir::CodeItem*, LayoutType> code_item_layout_;
+  // The string data, class data and static values that are used by the profile, items that are
+  // not in these maps are not part of any hot or startup range.
+  std::unordered_map<dex_ir::StringData*, LayoutType> string_data_layout_;
+  std::unordered_map<dex_ir::ClassData*, LayoutType> class_data_layout_;
+  std::unordered_map<dex_ir::EncodedArrayItem*, LayoutType> encoded_array_layout_;
 };
 
 class DexLayout {
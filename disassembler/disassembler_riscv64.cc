@@ -0,0 +1,1353 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "disassembler_riscv64.h"
+
+#include <inttypes.h>
+
+#include <ostream>
+#include <sstream>
+
+#include "android-base/logging.h"
+#include "android-base/stringprintf.h"
+
+using android::base::StringPrintf;
+
+namespace art {
+namespace riscv64 {
+
+// This enumeration should mirror the declarations in
+// runtime/arch/riscv64/registers_riscv64.h. We do not include that file to
+// avoid a dependency on libart.
+enum {
+  Zero = 0,
+  RA = 1,
+  SP = 2,
+  TR = 9,
+};
+
+static const char* const kXRegisterNames[] = {
+    "zero", "ra", "sp", "gp", "tp", "t0", "t1", "t2",
+    "fp",   "tr", "a0", "a1", "a2", "a3", "a4", "a5",
+    "a6",   "a7", "s2", "s3", "s4", "s5", "s6", "s7",
+    "s8",   "s9", "s10", "s11", "t3", "t4", "t5", "t6"};
+
+static const char* const kFRegisterNames[] = {
+    "ft0", "ft1", "ft2",  "ft3",  "ft4", "ft5", "ft6",  "ft7",
+    "fs0", "fs1", "fa0",  "fa1",  "fa2", "fa3", "fa4",  "fa5",
+    "fa6", "fa7", "fs2",  "fs3",  "fs4", "fs5", "fs6",  "fs7",
+    "fs8", "fs9", "fs10", "fs11", "ft8", "ft9", "ft10", "ft11"};
+
+static const char* const kUnknown = "<unknown>";
+
+static const char* XRegName(uint32_t reg) {
+  DCHECK_LT(reg, 32u);
+  return kXRegisterNames[reg];
+}
+
+static const char* FRegName(uint32_t reg) {
+  DCHECK_LT(reg, 32u);
+  return kFRegisterNames[reg];
+}
+
+static int32_t SignExtend(uint32_t value, uint32_t bits) {
+  DCHECK_GT(bits, 0u);
+  DCHECK_LE(bits, 32u);
+  uint32_t shift = 32u - bits;
+  return static_cast<int32_t>(value << shift) >> shift;
+}
+
+static uint32_t Rd(uint32_t bits) { return (bits >> 7) & 0x1fu; }
+static uint32_t Funct3(uint32_t bits) { return (bits >> 12) & 0x7u; }
+static uint32_t Rs1(uint32_t bits) { return (bits >> 15) & 0x1fu; }
+static uint32_t Rs2(uint32_t bits) { return (bits >> 20) & 0x1fu; }
+static uint32_t Rs3(uint32_t bits) { return bits >> 27; }
+static uint32_t Funct7(uint32_t bits) { return bits >> 25; }
+
+static int32_t ImmI(uint32_t bits) { return static_cast<int32_t>(bits) >> 20; }
+
+static int32_t ImmS(uint32_t bits) {
+  return (static_cast<int32_t>(bits & 0xfe000000u) >> 20) | static_cast<int32_t>(Rd(bits));
+}
+
+static int32_t ImmB(uint32_t bits) {
+  uint32_t imm = (((bits >> 31) & 0x1u) << 12) |
+                 (((bits >> 7) & 0x1u) << 11) |
+                 (((bits >> 25) & 0x3fu) << 5) |
+                 (((bits >> 8) & 0xfu) << 1);
+  return SignExtend(imm, 13u);
+}
+
+static int32_t ImmJ(uint32_t bits) {
+  uint32_t imm = (((bits >> 31) & 0x1u) << 20) |
+                 (((bits >> 12) & 0xffu) << 12) |
+                 (((bits >> 20) & 0x1u) << 11) |
+                 (((bits >> 21) & 0x3ffu) << 1);
+  return SignExtend(imm, 21u);
+}
+
+// Rounding mode operand. The dynamic rounding mode is the default and it is not printed.
+static std::string RoundingMode(uint32_t rm) {
+  static const char* const kNames[] = {"rne", "rtz", "rdn", "rup", "rmm", "?", "?", "dyn"};
+  return (rm == 7u) ? std::string() : StringPrintf(", %s", kNames[rm]);
+}
+
+static std::string FenceSet(uint32_t set) {
+  std::string result;
+  if ((set & 8u) != 0u) result += 'i';
+  if ((set & 4u) != 0u) result += 'o';
+  if ((set & 2u) != 0u) result += 'r';
+  if ((set & 1u) != 0u) result += 'w';
+  return result.empty() ? std::string("0") : result;
+}
+
+static std::string CsrName(uint32_t csr) {
+  switch (csr) {
+    case 0x001u: return "fflags";
+    case 0x002u: return "frm";
+    case 0x003u: return "fcsr";
+    case 0x008u: return "vstart";
+    case 0x009u: return "vxsat";
+    case 0x00au: return "vxrm";
+    case 0x00fu: return "vcsr";
+    case 0xc00u: return "cycle";
+    case 0xc01u: return "time";
+    case 0xc02u: return "instret";
+    case 0xc20u: return "vl";
+    case 0xc21u: return "vtype";
+    case 0xc22u: return "vlenb";
+    default: return StringPrintf("0x%03x", csr);
+  }
+}
+
+static std::string VType(uint32_t vtypei) {
+  static const char* const kLmulNames[] = {"m1", "m2", "m4", "m8", "?", "mf8", "mf4", "mf2"};
+  uint32_t sew = 8u << ((vtypei >> 3) & 0x7u);
+  return StringPrintf("e%u, %s, %s, %s",
+                      sew,
+                      kLmulNames[vtypei & 0x7u],
+                      ((vtypei & 0x40u) != 0u) ? "ta" : "tu",
+                      ((vtypei & 0x80u) != 0u) ? "ma" : "mu");
+}
+
+static const char* VMask(uint32_t bits) {
+  return ((bits >> 25) & 0x1u) == 0u ? ", v0.t" : "";
+}
+
+// Vector load and store width encoding, in bits. Returns 0 for scalar FP loads and stores.
+static uint32_t VectorMemoryWidth(uint32_t funct3) {
+  switch (funct3) {
+    case 0u: return 8u;
+    case 5u: return 16u;
+    case 6u: return 32u;
+    case 7u: return 64u;
+    default: return 0u;
+  }
+}
+
+static std::string DisassembleVectorMemory(uint32_t bits, bool is_load) {
+  uint32_t width = VectorMemoryWidth(Funct3(bits));
+  uint32_t nf = bits >> 29;
+  uint32_t mew = (bits >> 28) & 0x1u;
+  uint32_t mop = (bits >> 26) & 0x3u;
+  uint32_t umop = Rs2(bits);
+  if (mew != 0u) {
+    return kUnknown;
+  }
+  const char* ls = is_load ? "l" : "s";
+  std::string seg = (nf != 0u) ? StringPrintf("seg%u", nf + 1u) : std::string();
+  std::string mnemonic;
+  std::string extra;
+  switch (mop) {
+    case 0u:  // Unit-stride.
+      if (umop == 0u) {
+        mnemonic = StringPrintf("v%s%se%u.v", ls, seg.c_str(), width);
+      } else if (umop == 8u) {
+        // Whole register load and store.
+        mnemonic = is_load ? StringPrintf("vl%ure%u.v", nf + 1u, width)
+                           : StringPrintf("vs%ur.v", nf + 1u);
+      } else if (umop == 0xbu && nf == 0u && width == 8u) {
+        mnemonic = StringPrintf("v%sm.v", ls);
+      } else if (umop == 0x10u && is_load) {
+        mnemonic = StringPrintf("vl%se%uff.v", seg.c_str(), width);
+      } else {
+        return kUnknown;
+      }
+      break;
+    case 2u:  // Strided.
+      mnemonic = StringPrintf("v%ss%se%u.v", ls, seg.c_str(), width);
+      extra = StringPrintf(", %s", XRegName(umop));
+      break;
+    default:  // Indexed, unordered (1) or ordered (3).
+      mnemonic = StringPrintf("v%s%s%sei%u.v", ls, (mop == 1u) ? "ux" : "ox", seg.c_str(), width);
+      extra = StringPrintf(", v%u", umop);
+      break;
+  }
+  return StringPrintf("%s v%u, (%s)%s%s",
+                      mnemonic.c_str(),
+                      Rd(bits),
+                      XRegName(Rs1(bits)),
+                      extra.c_str(),
+                      VMask(bits));
+}
+
+// Vector arithmetic operand categories, encoded in funct3 of the OP-V major opcode.
+enum VectorCategory : uint32_t {
+  kOPIVV = 0u,
+  kOPFVV = 1u,
+  kOPMVV = 2u,
+  kOPIVI = 3u,
+  kOPIVX = 4u,
+  kOPFVF = 5u,
+  kOPMVX = 6u,
+};
+
+enum class VOpKind {
+  kNormal,        // vd, vs2, vs1/rs1/imm
+  kUnsignedImm,   // As kNormal but the 5-bit immediate is unsigned.
+  kMulAdd,        // vd, vs1/rs1, vs2
+  kReduction,     // vd, vs2, vs1 with the ".vs" suffix.
+  kMaskLogical,   // vd, vs2, vs1 with the ".mm" suffix.
+  kCarry,         // vd, vs2, vs1/rs1/imm, v0 with the "m" suffix.
+  kCarryOut,      // kCarry when masked, kNormal otherwise.
+};
+
+struct VOp {
+  const char* name;
+  VOpKind kind;
+};
+
+static VOp OpIName(uint32_t funct6, uint32_t category) {
+  switch (funct6) {
+    case 0x00u: return {"vadd", VOpKind::kNormal};
+    case 0x02u: return {"vsub", VOpKind::kNormal};
+    case 0x03u: return {"vrsub", VOpKind::kNormal};
+    case 0x04u: return {"vminu", VOpKind::kNormal};
+    case 0x05u: return {"vmin", VOpKind::kNormal};
+    case 0x06u: return {"vmaxu", VOpKind::kNormal};
+    case 0x07u: return {"vmax", VOpKind::kNormal};
+    case 0x09u: return {"vand", VOpKind::kNormal};
+    case 0x0au: return {"vor", VOpKind::kNormal};
+    case 0x0bu: return {"vxor", VOpKind::kNormal};
+    case 0x0cu: return {"vrgather", VOpKind::kUnsignedImm};
+    case 0x0eu:
+      return {(category == kOPIVV) ? "vrgatherei16" : "vslideup", VOpKind::kUnsignedImm};
+    case 0x0fu: return {"vslidedown", VOpKind::kUnsignedImm};
+    case 0x10u: return {"vadc", VOpKind::kCarry};
+    case 0x11u: return {"vmadc", VOpKind::kCarryOut};
+    case 0x12u: return {"vsbc", VOpKind::kCarry};
+    case 0x13u: return {"vmsbc", VOpKind::kCarryOut};
+    case 0x18u: return {"vmseq", VOpKind::kNormal};
+    case 0x19u: return {"vmsne", VOpKind::kNormal};
+    case 0x1au: return {"vmsltu", VOpKind::kNormal};
+    case 0x1bu: return {"vmslt", VOpKind::kNormal};
+    case 0x1cu: return {"vmsleu", VOpKind::kNormal};
+    case 0x1du: return {"vmsle", VOpKind::kNormal};
+    case 0x1eu: return {"vmsgtu", VOpKind::kNormal};
+    case 0x1fu: return {"vmsgt", VOpKind::kNormal};
+    case 0x20u: return {"vsaddu", VOpKind::kNormal};
+    case 0x21u: return {"vsadd", VOpKind::kNormal};
+    case 0x22u: return {"vssubu", VOpKind::kNormal};
+    case 0x23u: return {"vssub", VOpKind::kNormal};
+    case 0x25u: return {"vsll", VOpKind::kUnsignedImm};
+    case 0x27u: return {"vsmul", VOpKind::kNormal};
+    case 0x28u: return {"vsrl", VOpKind::kUnsignedImm};
+    case 0x29u: return {"vsra", VOpKind::kUnsignedImm};
+    case 0x2au: return {"vssrl", VOpKind::kUnsignedImm};
+    case 0x2bu: return {"vssra", VOpKind::kUnsignedImm};
+    case 0x2cu: return {"vnsrl.w", VOpKind::kUnsignedImm};
+    case 0x2du: return {"vnsra.w", VOpKind::kUnsignedImm};
+    case 0x2eu: return {"vnclipu.w", VOpKind::kUnsignedImm};
+    case 0x2fu: return {"vnclip.w", VOpKind::kUnsignedImm};
+    case 0x30u: return {"vwredsumu", VOpKind::kReduction};
+    case 0x31u: return {"vwredsum", VOpKind::kReduction};
+    default: return {nullptr, VOpKind::kNormal};
+  }
+}
+
+static VOp OpMName(uint32_t funct6) {
+  switch (funct6) {
+    case 0x00u: return {"vredsum", VOpKind::kReduction};
+    case 0x01u: return {"vredand", VOpKind::kReduction};
+    case 0x02u: return {"vredor", VOpKind::kReduction};
+    case 0x03u: return {"vredxor", VOpKind::kReduction};
+    case 0x04u: return {"vredminu", VOpKind::kReduction};
+    case 0x05u: return {"vredmin", VOpKind::kReduction};
+    case 0x06u: return {"vredmaxu", VOpKind::kReduction};
+    case 0x07u: return {"vredmax", VOpKind::kReduction};
+    case 0x08u: return {"vaaddu", VOpKind::kNormal};
+    case 0x09u: return {"vaadd", VOpKind::kNormal};
+    case 0x0au: return {"vasubu", VOpKind::kNormal};
+    case 0x0bu: return {"vasub", VOpKind::kNormal};
+    case 0x0eu: return {"vslide1up", VOpKind::kNormal};
+    case 0x0fu: return {"vslide1down", VOpKind::kNormal};
+    case 0x18u: return {"vmandn", VOpKind::kMaskLogical};
+    case 0x19u: return {"vmand", VOpKind::kMaskLogical};
+    case 0x1au: return {"vmor", VOpKind::kMaskLogical};
+    case 0x1bu: return {"vmxor", VOpKind::kMaskLogical};
+    case 0x1cu: return {"vmorn", VOpKind::kMaskLogical};
+    case 0x1du: return {"vmnand", VOpKind::kMaskLogical};
+    case 0x1eu: return {"vmnor", VOpKind::kMaskLogical};
+    case 0x1fu: return {"vmxnor", VOpKind::kMaskLogical};
+    case 0x20u: return {"vdivu", VOpKind::kNormal};
+    case 0x21u: return {"vdiv", VOpKind::kNormal};
+    case 0x22u: return {"vremu", VOpKind::kNormal};
+    case 0x23u: return {"vrem", VOpKind::kNormal};
+    case 0x24u: return {"vmulhu", VOpKind::kNormal};
+    case 0x25u: return {"vmul", VOpKind::kNormal};
+    case 0x26u: return {"vmulhsu", VOpKind::kNormal};
+    case 0x27u: return {"vmulh", VOpKind::kNormal};
+    case 0x29u: return {"vmadd", VOpKind::kMulAdd};
+    case 0x2bu: return {"vnmsub", VOpKind::kMulAdd};
+    case 0x2du: return {"vmacc", VOpKind::kMulAdd};
+    case 0x2fu: return {"vnmsac", VOpKind::kMulAdd};
+    case 0x30u: return {"vwaddu", VOpKind::kNormal};
+    case 0x31u: return {"vwadd", VOpKind::kNormal};
+    case 0x32u: return {"vwsubu", VOpKind::kNormal};
+    case 0x33u: return {"vwsub", VOpKind::kNormal};
+    case 0x34u: return {"vwaddu.w", VOpKind::kNormal};
+    case 0x35u: return {"vwadd.w", VOpKind::kNormal};
+    case 0x36u: return {"vwsubu.w", VOpKind::kNormal};
+    case 0x37u: return {"vwsub.w", VOpKind::kNormal};
+    case 0x38u: return {"vwmulu", VOpKind::kNormal};
+    case 0x3au: return {"vwmulsu", VOpKind::kNormal};
+    case 0x3bu: return {"vwmul", VOpKind::kNormal};
+    case 0x3cu: return {"vwmaccu", VOpKind::kMulAdd};
+    case 0x3du: return {"vwmacc", VOpKind::kMulAdd};
+    case 0x3eu: return {"vwmaccus", VOpKind::kMulAdd};
+    case 0x3fu: return {"vwmaccsu", VOpKind::kMulAdd};
+    default: return {nullptr, VOpKind::kNormal};
+  }
+}
+
+static VOp OpFName(uint32_t funct6) {
+  switch (funct6) {
+    case 0x00u: return {"vfadd", VOpKind::kNormal};
+    case 0x01u: return {"vfredusum", VOpKind::kReduction};
+    case 0x02u: return {"vfsub", VOpKind::kNormal};
+    case 0x03u: return {"vfredosum", VOpKind::kReduction};
+    case 0x04u: return {"vfmin", VOpKind::kNormal};
+    case 0x05u: return {"vfredmin", VOpKind::kReduction};
+    case 0x06u: return {"vfmax", VOpKind::kNormal};
+    case 0x07u: return {"vfredmax", VOpKind::kReduction};
+    case 0x08u: return {"vfsgnj", VOpKind::kNormal};
+    case 0x09u: return {"vfsgnjn", VOpKind::kNormal};
+    case 0x0au: return {"vfsgnjx", VOpKind::kNormal};
+    case 0x0eu: return {"vfslide1up", VOpKind::kNormal};
+    case 0x0fu: return {"vfslide1down", VOpKind::kNormal};
+    case 0x18u: return {"vmfeq", VOpKind::kNormal};
+    case 0x19u: return {"vmfle", VOpKind::kNormal};
+    case 0x1bu: return {"vmflt", VOpKind::kNormal};
+    case 0x1cu: return {"vmfne", VOpKind::kNormal};
+    case 0x1du: return {"vmfgt", VOpKind::kNormal};
+    case 0x1fu: return {"vmfge", VOpKind::kNormal};
+    case 0x20u: return {"vfdiv", VOpKind::kNormal};
+    case 0x21u: return {"vfrdiv", VOpKind::kNormal};
+    case 0x24u: return {"vfmul", VOpKind::kNormal};
+    case 0x27u: return {"vfrsub", VOpKind::kNormal};
+    case 0x28u: return {"vfmadd", VOpKind::kMulAdd};
+    case 0x29u: return {"vfnmadd", VOpKind::kMulAdd};
+    case 0x2au: return {"vfmsub", VOpKind::kMulAdd};
+    case 0x2bu: return {"vfnmsub", VOpKind::kMulAdd};
+    case 0x2cu: return {"vfmacc", VOpKind::kMulAdd};
+    case 0x2du: return {"vfnmacc", VOpKind::kMulAdd};
+    case 0x2eu: return {"vfmsac", VOpKind::kMulAdd};
+    case 0x2fu: return {"vfnmsac", VOpKind::kMulAdd};
+    case 0x30u: return {"vfwadd", VOpKind::kNormal};
+    case 0x31u: return {"vfwredusum", VOpKind::kReduction};
+    case 0x32u: return {"vfwsub", VOpKind::kNormal};
+    case 0x33u: return {"vfwredosum", VOpKind::kReduction};
+    case 0x34u: return {"vfwadd.w", VOpKind::kNormal};
+    case 0x36u: return {"vfwsub.w", VOpKind::kNormal};
+    case 0x38u: return {"vfwmul", VOpKind::kNormal};
+    case 0x3cu: return {"vfwmacc", VOpKind::kMulAdd};
+    case 0x3du: return {"vfwnmacc", VOpKind::kMulAdd};
+    case 0x3eu: return {"vfwmsac", VOpKind::kMulAdd};
+    case 0x3fu: return {"vfwnmsac", VOpKind::kMulAdd};
+    default: return {nullptr, VOpKind::kNormal};
+  }
+}
+
+static const char* VFUnary0Name(uint32_t vs1) {
+  switch (vs1) {
+    case 0x00u: return "vfcvt.xu.f.v";
+    case 0x01u: return "vfcvt.x.f.v";
+    case 0x02u: return "vfcvt.f.xu.v";
+    case 0x03u: return "vfcvt.f.x.v";
+    case 0x06u: return "vfcvt.rtz.xu.f.v";
+    case 0x07u: return "vfcvt.rtz.x.f.v";
+    case 0x08u: return "vfwcvt.xu.f.v";
+    case 0x09u: return "vfwcvt.x.f.v";
+    case 0x0au: return "vfwcvt.f.xu.v";
+    case 0x0bu: return "vfwcvt.f.x.v";
+    case 0x0cu: return "vfwcvt.f.f.v";
+    case 0x0eu: return "vfwcvt.rtz.xu.f.v";
+    case 0x0fu: return "vfwcvt.rtz.x.f.v";
+    case 0x10u: return "vfncvt.xu.f.w";
+    case 0x11u: return "vfncvt.x.f.w";
+    case 0x12u: return "vfncvt.f.xu.w";
+    case 0x13u: return "vfncvt.f.x.w";
+    case 0x14u: return "vfncvt.f.f.w";
+    case 0x15u: return "vfncvt.rod.f.f.w";
+    case 0x16u: return "vfncvt.rtz.xu.f.w";
+    case 0x17u: return "vfncvt.rtz.x.f.w";
+    default: return nullptr;
+  }
+}
+
+static const char* VFUnary1Name(uint32_t vs1) {
+  switch (vs1) {
+    case 0x00u: return "vfsqrt.v";
+    case 0x04u: return "vfrsqrt7.v";
+    case 0x05u: return "vfrec7.v";
+    case 0x10u: return "vfclass.v";
+    default: return nullptr;
+  }
+}
+
+static const char* VXUnary0Name(uint32_t vs1) {
+  switch (vs1) {
+    case 0x02u: return "vzext.vf8";
+    case 0x03u: return "vsext.vf8";
+    case 0x04u: return "vzext.vf4";
+    case 0x05u: return "vsext.vf4";
+    case 0x06u: return "vzext.vf2";
+    case 0x07u: return "vsext.vf2";
+    default: return nullptr;
+  }
+}
+
+static const char* VMUnary0Name(uint32_t vs1) {
+  switch (vs1) {
+    case 0x01u: return "vmsbf.m";
+    case 0x02u: return "vmsof.m";
+    case 0x03u: return "vmsif.m";
+    case 0x10u: return "viota.m";
+    default: return nullptr;
+  }
+}
+
+static std::string DisassembleVectorConfig(uint32_t bits) {
+  uint32_t rd = Rd(bits);
+  uint32_t rs1 = Rs1(bits);
+  if ((bits >> 31) == 0u) {
+    return StringPrintf("vsetvli %s, %s, %s",
+                        XRegName(rd),
+                        XRegName(rs1),
+                        VType((bits >> 20) & 0x7ffu).c_str());
+  } else if ((bits >> 30) == 3u) {
+    return StringPrintf("vsetivli %s, %u, %s", XRegName(rd), rs1, VType((bits >> 20) & 0x3ffu).c_str());
+  } else if (Funct7(bits) == 0x40u) {
+    return StringPrintf("vsetvl %s, %s, %s", XRegName(rd), XRegName(rs1), XRegName(Rs2(bits)));
+  } else {
+    return kUnknown;
+  }
+}
+
+static std::string DisassembleVectorArithmetic(uint32_t bits) {
+  uint32_t category = Funct3(bits);
+  if (category == 7u) {
+    return DisassembleVectorConfig(bits);
+  }
+  uint32_t funct6 = bits >> 26;
+  uint32_t vm = (bits >> 25) & 0x1u;
+  uint32_t vd = Rd(bits);
+  uint32_t src1 = Rs1(bits);
+  uint32_t vs2 = Rs2(bits);
+  const char* mask = VMask(bits);
+
+  // Moves, merges and unary operations with special operand forms.
+  switch (category) {
+    case kOPIVV:
+    case kOPIVX:
+    case kOPIVI:
+      if (funct6 == 0x17u) {
+        const char* form = (category == kOPIVV) ? "v" : (category == kOPIVX) ? "x" : "i";
+        std::string src = (category == kOPIVV) ? StringPrintf("v%u", src1)
+                        : (category == kOPIVX) ? std::string(XRegName(src1))
+                        : StringPrintf("%d", SignExtend(src1, 5u));
+        return (vm == 1u)
+            ? ((vs2 == 0u) ? StringPrintf("vmv.v.%s v%u, %s", form, vd, src.c_str())
+                           : std::string(kUnknown))
+            : StringPrintf("vmerge.v%sm v%u, v%u, %s, v0", form, vd, vs2, src.c_str());
+      }
+      if (funct6 == 0x27u && category == kOPIVI) {
+        return (vm == 1u) ? StringPrintf("vmv%ur.v v%u, v%u", src1 + 1u, vd, vs2)
+                          : std::string(kUnknown);
+      }
+      break;
+    case kOPMVV:
+      if (funct6 == 0x10u) {
+        if (src1 == 0u) {
+          return StringPrintf("vmv.x.s %s, v%u", XRegName(vd), vs2);
+        } else if (src1 == 0x10u) {
+          return StringPrintf("vcpop.m %s, v%u%s", XRegName(vd), vs2, mask);
+        } else if (src1 == 0x11u) {
+          return StringPrintf("vfirst.m %s, v%u%s", XRegName(vd), vs2, mask);
+        }
+        return kUnknown;
+      } else if (funct6 == 0x12u) {
+        const char* name = VXUnary0Name(src1);
+        return (name != nullptr) ? StringPrintf("%s v%u, v%u%s", name, vd, vs2, mask)
+                                 : std::string(kUnknown);
+      } else if (funct6 == 0x14u) {
+        if (src1 == 0x11u) {
+          return StringPrintf("vid.v v%u%s", vd, mask);
+        }
+        const char* name = VMUnary0Name(src1);
+        return (name != nullptr) ? StringPrintf("%s v%u, v%u%s", name, vd, vs2, mask)
+                                 : std::string(kUnknown);
+      } else if (funct6 == 0x17u) {
+        return StringPrintf("vcompress.vm v%u, v%u, v%u", vd, vs2, src1);
+      }
+      break;
+    case kOPMVX:
+      if (funct6 == 0x10u) {
+        return (vs2 == 0u) ? StringPrintf("vmv.s.x v%u, %s", vd, XRegName(src1))
+                           : std::string(kUnknown);
+      }
+      break;
+    case kOPFVV:
+      if (funct6 == 0x10u) {
+        return (src1 == 0u) ? StringPrintf("vfmv.f.s %s, v%u", FRegName(vd), vs2)
+                            : std::string(kUnknown);
+      } else if (funct6 == 0x12u || funct6 == 0x13u) {
+        const char* name = (funct6 == 0x12u) ? VFUnary0Name(src1) : VFUnary1Name(src1);
+        return (name != nullptr) ? StringPrintf("%s v%u, v%u%s", name, vd, vs2, mask)
+                                 : std::string(kUnknown);
+      }
+      break;
+    case kOPFVF:
+      if (funct6 == 0x10u) {
+        return (vs2 == 0u) ? StringPrintf("vfmv.s.f v%u, %s", vd, FRegName(src1))
+                           : std::string(kUnknown);
+      } else if (funct6 == 0x17u) {
+        return (vm == 1u)
+            ? ((vs2 == 0u) ? StringPrintf("vfmv.v.f v%u, %s", vd, FRegName(src1))
+                           : std::string(kUnknown))
+            : StringPrintf("vfmerge.vfm v%u, v%u, %s, v0", vd, vs2, FRegName(src1));
+      }
+      break;
+  }
+
+  VOp op;
+  char form;
+  std::string src;
+  switch (category) {
+    case kOPIVV:
+      op = OpIName(funct6, category);
+      form = 'v';
+      src = StringPrintf("v%u", src1);
+      break;
+    case kOPIVX:
+      op = OpIName(funct6, category);
+      form = 'x';
+      src = XRegName(src1);
+      break;
+    case kOPIVI:
+      op = OpIName(funct6, category);
+      form = 'i';
+      src = (op.kind == VOpKind::kUnsignedImm) ? StringPrintf("%u", src1)
+                                               : StringPrintf("%d", SignExtend(src1, 5u));
+      break;
+    case kOPMVV:
+      op = OpMName(funct6);
+      form = 'v';
+      src = StringPrintf("v%u", src1);
+      break;
+    case kOPMVX:
+      op = OpMName(funct6);
+      form = 'x';
+      src = XRegName(src1);
+      break;
+    case kOPFVV:
+      op = OpFName(funct6);
+      form = 'v';
+      src = StringPrintf("v%u", src1);
+      break;
+    default:
+      DCHECK_EQ(category, static_cast<uint32_t>(kOPFVF));
+      op = OpFName(funct6);
+      form = 'f';
+      src = FRegName(src1);
+      break;
+  }
+  if (op.name == nullptr) {
+    return kUnknown;
+  }
+  bool is_vv = (category == kOPIVV || category == kOPMVV || category == kOPFVV);
+  std::string name = op.name;
+  switch (op.kind) {
+    case VOpKind::kReduction:
+      if (!is_vv) {
+        return kUnknown;
+      }
+      return StringPrintf("%s.vs v%u, v%u, %s%s", name.c_str(), vd, vs2, src.c_str(), mask);
+    case VOpKind::kMaskLogical:
+      if (!is_vv) {
+        return kUnknown;
+      }
+      return StringPrintf("%s.mm v%u, v%u, %s", name.c_str(), vd, vs2, src.c_str());
+    default:
+      break;
+  }
+  // Names of operations with a wide `vs2` already contain the ".w" part of the suffix.
+  name += (name.find('.') != std::string::npos) ? std::string(1, form) : std::string(".v") + form;
+  if (op.kind == VOpKind::kMulAdd) {
+    return StringPrintf("%s v%u, %s, v%u%s", name.c_str(), vd, src.c_str(), vs2, mask);
+  } else if (op.kind == VOpKind::kCarry || (op.kind == VOpKind::kCarryOut && vm == 0u)) {
+    return StringPrintf("%sm v%u, v%u, %s, v0", name.c_str(), vd, vs2, src.c_str());
+  } else {
+    return StringPrintf("%s v%u, v%u, %s%s", name.c_str(), vd, vs2, src.c_str(), mask);
+  }
+}
+
+static std::string DisassembleOp(uint32_t bits) {
+  uint32_t funct7 = Funct7(bits);
+  uint32_t funct3 = Funct3(bits);
+  uint32_t rd = Rd(bits);
+  uint32_t rs1 = Rs1(bits);
+  uint32_t rs2 = Rs2(bits);
+  const char* name = nullptr;
+  switch (funct7) {
+    case 0x00u: {
+      static const char* const kNames[] = {"add", "sll", "slt", "sltu", "xor", "srl", "or", "and"};
+      name = kNames[funct3];
+      if (funct3 == 3u && rs1 == Zero) {
+        return StringPrintf("snez %s, %s", XRegName(rd), XRegName(rs2));
+      }
+      break;
+    }
+    case 0x20u: {
+      static const char* const kNames[] = {"sub", nullptr, nullptr, nullptr,
+                                           "xnor", "sra", "orn", "andn"};
+      name = kNames[funct3];
+      if (funct3 == 0u && rs1 == Zero) {
+        return StringPrintf("neg %s, %s", XRegName(rd), XRegName(rs2));
+      }
+      break;
+    }
+    case 0x01u: {
+      static const char* const kNames[] = {"mul", "mulh", "mulhsu", "mulhu",
+                                           "div", "divu", "rem", "remu"};
+      name = kNames[funct3];
+      break;
+    }
+    case 0x05u: {
+      static const char* const kNames[] = {nullptr, "clmul", "clmulr", "clmulh",
+                                           "min", "minu", "max", "maxu"};
+      name = kNames[funct3];
+      break;
+    }
+    case 0x10u: {
+      static const char* const kNames[] = {nullptr, nullptr, "sh1add", nullptr,
+                                           "sh2add", nullptr, "sh3add", nullptr};
+      name = kNames[funct3];
+      break;
+    }
+    case 0x14u:
+      name = (funct3 == 1u) ? "bset" : nullptr;
+      break;
+    case 0x24u:
+      name = (funct3 == 1u) ? "bclr" : (funct3 == 5u) ? "bext" : nullptr;
+      break;
+    case 0x30u:
+      name = (funct3 == 1u) ? "rol" : (funct3 == 5u) ? "ror" : nullptr;
+      break;
+    case 0x34u:
+      name = (funct3 == 1u) ? "binv" : nullptr;
+      break;
+  }
+  if (name == nullptr) {
+    return kUnknown;
+  }
+  return StringPrintf("%s %s, %s, %s", name, XRegName(rd), XRegName(rs1), XRegName(rs2));
+}
+
+static std::string DisassembleOp32(uint32_t bits) {
+  uint32_t funct7 = Funct7(bits);
+  uint32_t funct3 = Funct3(bits);
+  uint32_t rd = Rd(bits);
+  uint32_t rs1 = Rs1(bits);
+  uint32_t rs2 = Rs2(bits);
+  const char* name = nullptr;
+  switch (funct7) {
+    case 0x00u:
+      name = (funct3 == 0u) ? "addw" : (funct3 == 1u) ? "sllw" : (funct3 == 5u) ? "srlw" : nullptr;
+      break;
+    case 0x20u:
+      if (funct3 == 0u && rs1 == Zero) {
+        return StringPrintf("negw %s, %s", XRegName(rd), XRegName(rs2));
+      }
+      name = (funct3 == 0u) ? "subw" : (funct3 == 5u) ? "sraw" : nullptr;
+      break;
+    case 0x01u: {
+      static const char* const kNames[] = {"mulw", nullptr, nullptr, nullptr,
+                                           "divw", "divuw", "remw", "remuw"};
+      name = kNames[funct3];
+      break;
+    }
+    case 0x04u:
+      if (funct3 == 0u) {
+        if (rs2 == Zero) {
+          return StringPrintf("zext.w %s, %s", XRegName(rd), XRegName(rs1));
+        }
+        name = "add.uw";
+      } else if (funct3 == 4u && rs2 == Zero) {
+        return StringPrintf("zext.h %s, %s", XRegName(rd), XRegName(rs1));
+      }
+      break;
+    case 0x10u: {
+      static const char* const kNames[] = {nullptr, nullptr, "sh1add.uw", nullptr,
+                                           "sh2add.uw", nullptr, "sh3add.uw", nullptr};
+      name = kNames[funct3];
+      break;
+    }
+    case 0x30u:
+      name = (funct3 == 1u) ? "rolw" : (funct3 == 5u) ? "rorw" : nullptr;
+      break;
+  }
+  if (name == nullptr) {
+    return kUnknown;
+  }
+  return StringPrintf("%s %s, %s, %s", name, XRegName(rd), XRegName(rs1), XRegName(rs2));
+}
+
+static std::string DisassembleOpImm(uint32_t bits) {
+  uint32_t funct3 = Funct3(bits);
+  uint32_t rd = Rd(bits);
+  uint32_t rs1 = Rs1(bits);
+  int32_t imm = ImmI(bits);
+  uint32_t imm12 = bits >> 20;
+  uint32_t funct6 = bits >> 26;
+  uint32_t shamt = imm12 & 0x3fu;
+  switch (funct3) {
+    case 0u:
+      if (rd == Zero && rs1 == Zero && imm == 0) {
+        return "nop";
+      } else if (rs1 == Zero) {
+        return StringPrintf("li %s, %d", XRegName(rd), imm);
+      } else if (imm == 0) {
+        return StringPrintf("mv %s, %s", XRegName(rd), XRegName(rs1));
+      }
+      return StringPrintf("addi %s, %s, %d", XRegName(rd), XRegName(rs1), imm);
+    case 1u: {
+      const char* name = nullptr;
+      if (funct6 == 0x00u) {
+        name = "slli";
+      } else if (funct6 == 0x0au) {
+        name = "bseti";
+      } else if (funct6 == 0x12u) {
+        name = "bclri";
+      } else if (funct6 == 0x1au) {
+        name = "binvi";
+      } else {
+        switch (imm12) {
+          case 0x600u: name = "clz"; break;
+          case 0x601u: name = "ctz"; break;
+          case 0x602u: name = "cpop"; break;
+          case 0x604u: name = "sext.b"; break;
+          case 0x605u: name = "sext.h"; break;
+          default: return kUnknown;
+        }
+        return StringPrintf("%s %s, %s", name, XRegName(rd), XRegName(rs1));
+      }
+      return StringPrintf("%s %s, %s, %u", name, XRegName(rd), XRegName(rs1), shamt);
+    }
+    case 2u:
+      return StringPrintf("slti %s, %s, %d", XRegName(rd), XRegName(rs1), imm);
+    case 3u:
+      if (imm == 1) {
+        return StringPrintf("seqz %s, %s", XRegName(rd), XRegName(rs1));
+      }
+      return StringPrintf("sltiu %s, %s, %d", XRegName(rd), XRegName(rs1), imm);
+    case 4u:
+      if (imm == -1) {
+        return StringPrintf("not %s, %s", XRegName(rd), XRegName(rs1));
+      }
+      return StringPrintf("xori %s, %s, %d", XRegName(rd), XRegName(rs1), imm);
+    case 5u: {
+      const char* name = nullptr;
+      if (imm12 == 0x287u) {
+        return StringPrintf("orc.b %s, %s", XRegName(rd), XRegName(rs1));
+      } else if (imm12 == 0x6b8u) {
+        return StringPrintf("rev8 %s, %s", XRegName(rd), XRegName(rs1));
+      } else if (funct6 == 0x00u) {
+        name = "srli";
+      } else if (funct6 == 0x10u) {
+        name = "srai";
+      } else if (funct6 == 0x12u) {
+        name = "bexti";
+      } else if (funct6 == 0x18u) {
+        name = "rori";
+      } else {
+        return kUnknown;
+      }
+      return StringPrintf("%s %s, %s, %u", name, XRegName(rd), XRegName(rs1), shamt);
+    }
+    case 6u:
+      return StringPrintf("ori %s, %s, %d", XRegName(rd), XRegName(rs1), imm);
+    default:
+      return StringPrintf("andi %s, %s, %d", XRegName(rd), XRegName(rs1), imm);
+  }
+}
+
+static std::string DisassembleOpImm32(uint32_t bits) {
+  uint32_t funct3 = Funct3(bits);
+  uint32_t rd = Rd(bits);
+  uint32_t rs1 = Rs1(bits);
+  int32_t imm = ImmI(bits);
+  uint32_t imm12 = bits >> 20;
+  uint32_t funct7 = Funct7(bits);
+  switch (funct3) {
+    case 0u:
+      if (imm == 0) {
+        return StringPrintf("sext.w %s, %s", XRegName(rd), XRegName(rs1));
+      }
+      return StringPrintf("addiw %s, %s, %d", XRegName(rd), XRegName(rs1), imm);
+    case 1u:
+      if (funct7 == 0x00u) {
+        return StringPrintf("slliw %s, %s, %u", XRegName(rd), XRegName(rs1), Rs2(bits));
+      } else if ((bits >> 26) == 0x02u) {
+        return StringPrintf("slli.uw %s, %s, %u", XRegName(rd), XRegName(rs1), imm12 & 0x3fu);
+      } else if (imm12 == 0x600u || imm12 == 0x601u || imm12 == 0x602u) {
+        static const char* const kNames[] = {"clzw", "ctzw", "cpopw"};
+        return StringPrintf("%s %s, %s", kNames[imm12 - 0x600u], XRegName(rd), XRegName(rs1));
+      }
+      return kUnknown;
+    case 5u: {
+      const char* name = (funct7 == 0x00u) ? "srliw"
+                       : (funct7 == 0x20u) ? "sraiw"
+                       : (funct7 == 0x30u) ? "roriw"
+                       : nullptr;
+      if (name == nullptr) {
+        return kUnknown;
+      }
+      return StringPrintf("%s %s, %s, %u", name, XRegName(rd), XRegName(rs1), Rs2(bits));
+    }
+    default:
+      return kUnknown;
+  }
+}
+
+static std::string DisassembleOpFp(uint32_t bits) {
+  uint32_t funct7 = Funct7(bits);
+  uint32_t fmt = funct7 & 0x3u;
+  uint32_t rd = Rd(bits);
+  uint32_t rs1 = Rs1(bits);
+  uint32_t rs2 = Rs2(bits);
+  uint32_t rm = Funct3(bits);
+  if (fmt > 1u) {
+    return kUnknown;
+  }
+  char type = (fmt == 0u) ? 's' : 'd';
+  switch (funct7 >> 2) {
+    case 0x00u:
+    case 0x01u:
+    case 0x02u:
+    case 0x03u: {
+      static const char* const kNames[] = {"fadd", "fsub", "fmul", "fdiv"};
+      return StringPrintf("%s.%c %s, %s, %s%s",
+                          kNames[funct7 >> 2],
+                          type,
+                          FRegName(rd),
+                          FRegName(rs1),
+                          FRegName(rs2),
+                          RoundingMode(rm).c_str());
+    }
+    case 0x0bu:
+      return StringPrintf(
+          "fsqrt.%c %s, %s%s", type, FRegName(rd), FRegName(rs1), RoundingMode(rm).c_str());
+    case 0x04u:
+      if (rs1 == rs2 && rm < 3u) {
+        static const char* const kNames[] = {"fmv", "fneg", "fabs"};
+        return StringPrintf("%s.%c %s, %s", kNames[rm], type, FRegName(rd), FRegName(rs1));
+      } else if (rm < 3u) {
+        static const char* const kNames[] = {"fsgnj", "fsgnjn", "fsgnjx"};
+        return StringPrintf(
+            "%s.%c %s, %s, %s", kNames[rm], type, FRegName(rd), FRegName(rs1), FRegName(rs2));
+      }
+      return kUnknown;
+    case 0x05u:
+      if (rm < 2u) {
+        return StringPrintf("%s.%c %s, %s, %s",
+                            (rm == 0u) ? "fmin" : "fmax",
+                            type,
+                            FRegName(rd),
+                            FRegName(rs1),
+                            FRegName(rs2));
+      }
+      return kUnknown;
+    case 0x08u:
+      if (fmt == 0u && rs2 == 1u) {
+        return StringPrintf(
+            "fcvt.s.d %s, %s%s", FRegName(rd), FRegName(rs1), RoundingMode(rm).c_str());
+      } else if (fmt == 1u && rs2 == 0u) {
+        return StringPrintf("fcvt.d.s %s, %s", FRegName(rd), FRegName(rs1));
+      }
+      return kUnknown;
+    case 0x14u:
+      if (rm < 3u) {
+        static const char* const kNames[] = {"fle", "flt", "feq"};
+        return StringPrintf(
+            "%s.%c %s, %s, %s", kNames[rm], type, XRegName(rd), FRegName(rs1), FRegName(rs2));
+      }
+      return kUnknown;
+    case 0x18u:
+    case 0x1au: {
+      static const char* const kIntTypes[] = {"w", "wu", "l", "lu"};
+      if (rs2 >= 4u) {
+        return kUnknown;
+      }
+      if ((funct7 >> 2) == 0x18u) {
+        return StringPrintf("fcvt.%s.%c %s, %s%s",
+                            kIntTypes[rs2],
+                            type,
+                            XRegName(rd),
+                            FRegName(rs1),
+                            RoundingMode(rm).c_str());
+      }
+      return StringPrintf("fcvt.%c.%s %s, %s%s",
+                          type,
+                          kIntTypes[rs2],
+                          FRegName(rd),
+                          XRegName(rs1),
+                          RoundingMode(rm).c_str());
+    }
+    case 0x1cu:
+      if (rs2 == 0u && rm == 0u) {
+        return StringPrintf(
+            "fmv.x.%c %s, %s", (fmt == 0u) ? 'w' : 'd', XRegName(rd), FRegName(rs1));
+      } else if (rs2 == 0u && rm == 1u) {
+        return StringPrintf("fclass.%c %s, %s", type, XRegName(rd), FRegName(rs1));
+      }
+      return kUnknown;
+    case 0x1eu:
+      if (rs2 == 0u && rm == 0u) {
+        return StringPrintf(
+            "fmv.%c.x %s, %s", (fmt == 0u) ? 'w' : 'd', FRegName(rd), XRegName(rs1));
+      }
+      return kUnknown;
+    default:
+      return kUnknown;
+  }
+}
+
+static std::string DisassembleFma(uint32_t bits) {
+  static const char* const kNames[] = {"fmadd", "fmsub", "fnmsub", "fnmadd"};
+  uint32_t fmt = (bits >> 25) & 0x3u;
+  if (fmt > 1u) {
+    return kUnknown;
+  }
+  return StringPrintf("%s.%c %s, %s, %s, %s%s",
+                      kNames[((bits & 0x7fu) - 0x43u) >> 2],
+                      (fmt == 0u) ? 's' : 'd',
+                      FRegName(Rd(bits)),
+                      FRegName(Rs1(bits)),
+                      FRegName(Rs2(bits)),
+                      FRegName(Rs3(bits)),
+                      RoundingMode(Funct3(bits)).c_str());
+}
+
+static std::string DisassembleAmo(uint32_t bits) {
+  uint32_t funct3 = Funct3(bits);
+  if (funct3 != 2u && funct3 != 3u) {
+    return kUnknown;
+  }
+  const char* name = nullptr;
+  switch (bits >> 27) {
+    case 0x00u: name = "amoadd"; break;
+    case 0x01u: name = "amoswap"; break;
+    case 0x02u: name = "lr"; break;
+    case 0x03u: name = "sc"; break;
+    case 0x04u: name = "amoxor"; break;
+    case 0x08u: name = "amoor"; break;
+    case 0x0cu: name = "amoand"; break;
+    case 0x10u: name = "amomin"; break;
+    case 0x14u: name = "amomax"; break;
+    case 0x18u: name = "amominu"; break;
+    case 0x1cu: name = "amomaxu"; break;
+    default: return kUnknown;
+  }
+  static const char* const kOrdering[] = {"", ".rl", ".aq", ".aqrl"};
+  std::string mnemonic = StringPrintf(
+      "%s.%c%s", name, (funct3 == 2u) ? 'w' : 'd', kOrdering[(bits >> 25) & 0x3u]);
+  if ((bits >> 27) == 0x02u) {
+    return StringPrintf("%s %s, (%s)", mnemonic.c_str(), XRegName(Rd(bits)), XRegName(Rs1(bits)));
+  }
+  return StringPrintf("%s %s, %s, (%s)",
+                      mnemonic.c_str(),
+                      XRegName(Rd(bits)),
+                      XRegName(Rs2(bits)),
+                      XRegName(Rs1(bits)));
+}
+
+static std::string DisassembleSystem(uint32_t bits) {
+  uint32_t funct3 = Funct3(bits);
+  if (funct3 == 0u) {
+    switch (bits) {
+      case 0x00000073u: return "ecall";
+      case 0x00100073u: return "ebreak";
+      case 0x10500073u: return "wfi";
+      default: return kUnknown;
+    }
+  } else if (funct3 == 4u) {
+    return kUnknown;
+  }
+  static const char* const kNames[] = {nullptr, "csrrw", "csrrs", "csrrc",
+                                       nullptr, "csrrwi", "csrrsi", "csrrci"};
+  uint32_t rd = Rd(bits);
+  uint32_t rs1 = Rs1(bits);
+  std::string csr = CsrName(bits >> 20);
+  bool is_imm = (funct3 >= 5u);
+  std::string src = is_imm ? StringPrintf("%u", rs1) : std::string(XRegName(rs1));
+  if (funct3 == 2u && rs1 == Zero) {
+    return StringPrintf("csrr %s, %s", XRegName(rd), csr.c_str());
+  } else if (rd == Zero) {
+    static const char* const kShortNames[] = {nullptr, "csrw", "csrs", "csrc",
+                                              nullptr, "csrwi", "csrsi", "csrci"};
+    return StringPrintf("%s %s, %s", kShortNames[funct3], csr.c_str(), src.c_str());
+  }
+  return StringPrintf("%s %s, %s, %s", kNames[funct3], XRegName(rd), csr.c_str(), src.c_str());
+}
+
+std::string DisassemblerRiscv64::FormatBranchTarget(const uint8_t* insn, int32_t offset) {
+  return StringPrintf("%+d ; ", offset) + FormatInstructionPointer(insn + offset);
+}
+
+std::string DisassemblerRiscv64::FormatMemoryOperand(uint32_t rs1, int32_t offset) {
+  std::string result = StringPrintf("%d(%s)", offset, XRegName(rs1));
+  if (rs1 == TR && offset >= 0) {
+    std::ostringstream tmp_stream;
+    GetDisassemblerOptions()->thread_offset_name_function_(tmp_stream,
+                                                           static_cast<uint32_t>(offset));
+    result += " ; " + tmp_stream.str();
+  }
+  return result;
+}
+
+std::string DisassemblerRiscv64::Disassemble32(const uint8_t* insn, uint32_t bits) {
+  uint32_t rd = Rd(bits);
+  uint32_t rs1 = Rs1(bits);
+  uint32_t rs2 = Rs2(bits);
+  uint32_t funct3 = Funct3(bits);
+  switch (bits & 0x7fu) {
+    case 0x37u:  // LUI
+      return StringPrintf("lui %s, 0x%x", XRegName(rd), bits >> 12);
+    case 0x17u:  // AUIPC
+      return StringPrintf("auipc %s, 0x%x", XRegName(rd), bits >> 12);
+    case 0x6fu: {  // JAL
+      std::string target = FormatBranchTarget(insn, ImmJ(bits));
+      if (rd == Zero) {
+        return "j " + target;
+      }
+      return StringPrintf("jal %s, ", XRegName(rd)) + target;
+    }
+    case 0x67u: {  // JALR
+      if (funct3 != 0u) {
+        return kUnknown;
+      }
+      int32_t imm = ImmI(bits);
+      if (rd == Zero && rs1 == RA && imm == 0) {
+        return "ret";
+      } else if (rd == Zero && imm == 0) {
+        return StringPrintf("jr %s", XRegName(rs1));
+      } else if (rd == RA && imm == 0) {
+        return StringPrintf("jalr %s", XRegName(rs1));
+      }
+      return StringPrintf("jalr %s, %d(%s)", XRegName(rd), imm, XRegName(rs1));
+    }
+    case 0x63u: {  // BRANCH
+      static const char* const kNames[] = {"beq", "bne", nullptr, nullptr,
+                                           "blt", "bge", "bltu", "bgeu"};
+      const char* name = kNames[funct3];
+      if (name == nullptr) {
+        return kUnknown;
+      }
+      std::string target = FormatBranchTarget(insn, ImmB(bits));
+      if (rs2 == Zero && (funct3 == 0u || funct3 == 1u)) {
+        return StringPrintf("%sz %s, ", name, XRegName(rs1)) + target;
+      }
+      return StringPrintf("%s %s, %s, ", name, XRegName(rs1), XRegName(rs2)) + target;
+    }
+    case 0x03u: {  // LOAD
+      static const char* const kNames[] = {"lb", "lh", "lw", "ld", "lbu", "lhu", "lwu", nullptr};
+      const char* name = kNames[funct3];
+      if (name == nullptr) {
+        return kUnknown;
+      }
+      return StringPrintf("%s %s, ", name, XRegName(rd)) + FormatMemoryOperand(rs1, ImmI(bits));
+    }
+    case 0x23u: {  // STORE
+      static const char* const kNames[] = {"sb", "sh", "sw", "sd"};
+      if (funct3 >= 4u) {
+        return kUnknown;
+      }
+      return StringPrintf("%s %s, ", kNames[funct3], XRegName(rs2)) +
+             FormatMemoryOperand(rs1, ImmS(bits));
+    }
+    case 0x07u:  // LOAD-FP
+      if (funct3 == 2u || funct3 == 3u) {
+        return StringPrintf("%s %s, ", (funct3 == 2u) ? "flw" : "fld", FRegName(rd)) +
+               FormatMemoryOperand(rs1, ImmI(bits));
+      } else if (VectorMemoryWidth(funct3) != 0u) {
+        return DisassembleVectorMemory(bits, /*is_load=*/ true);
+      }
+      return kUnknown;
+    case 0x27u:  // STORE-FP
+      if (funct3 == 2u || funct3 == 3u) {
+        return StringPrintf("%s %s, ", (funct3 == 2u) ? "fsw" : "fsd", FRegName(rs2)) +
+               FormatMemoryOperand(rs1, ImmS(bits));
+      } else if (VectorMemoryWidth(funct3) != 0u) {
+        return DisassembleVectorMemory(bits, /*is_load=*/ false);
+      }
+      return kUnknown;
+    case 0x13u:  // OP-IMM
+      return DisassembleOpImm(bits);
+    case 0x1bu:  // OP-IMM-32
+      return DisassembleOpImm32(bits);
+    case 0x33u:  // OP
+      return DisassembleOp(bits);
+    case 0x3bu:  // OP-32
+      return DisassembleOp32(bits);
+    case 0x53u:  // OP-FP
+      return DisassembleOpFp(bits);
+    case 0x43u:  // MADD
+    case 0x47u:  // MSUB
+    case 0x4bu:  // NMSUB
+    case 0x4fu:  // NMADD
+      return DisassembleFma(bits);
+    case 0x57u:  // OP-V
+      return DisassembleVectorArithmetic(bits);
+    case 0x2fu:  // AMO
+      return DisassembleAmo(bits);
+    case 0x0fu:  // MISC-MEM
+      if (funct3 == 1u) {
+        return "fence.i";
+      } else if (funct3 == 0u) {
+        uint32_t pred = (bits >> 24) & 0xfu;
+        uint32_t succ = (bits >> 20) & 0xfu;
+        if ((bits >> 28) == 8u && pred == 3u && succ == 3u) {
+          return "fence.tso";
+        }
+        return StringPrintf("fence %s, %s", FenceSet(pred).c_str(), FenceSet(succ).c_str());
+      }
+      return kUnknown;
+    case 0x73u:  // SYSTEM
+      return DisassembleSystem(bits);
+    default:
+      return kUnknown;
+  }
+}
+
+std::string DisassemblerRiscv64::DisassembleCompressed(const uint8_t* insn, uint32_t bits) {
+  uint32_t funct3 = (bits >> 13) & 0x7u;
+  // Full register numbers for the CR and CI formats, and the x8-x15 registers used by the
+  // CIW, CL, CS, CA and CB formats.
+  uint32_t rd = (bits >> 7) & 0x1fu;
+  uint32_t rs2 = (bits >> 2) & 0x1fu;
+  uint32_t rd_short = 8u + ((bits >> 2) & 0x7u);
+  uint32_t rs1_short = 8u + ((bits >> 7) & 0x7u);
+  int32_t imm6 = SignExtend((((bits >> 12) & 0x1u) << 5) | ((bits >> 2) & 0x1fu), 6u);
+  uint32_t uimm6 = (((bits >> 12) & 0x1u) << 5) | ((bits >> 2) & 0x1fu);
+  switch (bits & 0x3u) {
+    case 0u: {
+      // Offsets for the CL and CS formats, for words and doublewords.
+      uint32_t offset_w = (((bits >> 10) & 0x7u) << 3) |
+                          (((bits >> 6) & 0x1u) << 2) |
+                          (((bits >> 5) & 0x1u) << 6);
+      uint32_t offset_d = (((bits >> 10) & 0x7u) << 3) | (((bits >> 5) & 0x3u) << 6);
+      switch (funct3) {
+        case 0u: {
+          uint32_t nzuimm = (((bits >> 7) & 0xfu) << 6) |
+                            (((bits >> 11) & 0x3u) << 4) |
+                            (((bits >> 5) & 0x1u) << 3) |
+                            (((bits >> 6) & 0x1u) << 2);
+          if (nzuimm == 0u) {
+            return (bits == 0u) ? "unimp" : kUnknown;
+          }
+          return StringPrintf("addi %s, sp, %u", XRegName(rd_short), nzuimm);
+        }
+        case 1u:
+          return StringPrintf("fld %s, ", FRegName(rd_short)) +
+                 FormatMemoryOperand(rs1_short, offset_d);
+        case 2u:
+          return StringPrintf("lw %s, ", XRegName(rd_short)) +
+                 FormatMemoryOperand(rs1_short, offset_w);
+        case 3u:
+          return StringPrintf("ld %s, ", XRegName(rd_short)) +
+                 FormatMemoryOperand(rs1_short, offset_d);
+        case 5u:
+          return StringPrintf("fsd %s, ", FRegName(rd_short)) +
+                 FormatMemoryOperand(rs1_short, offset_d);
+        case 6u:
+          return StringPrintf("sw %s, ", XRegName(rd_short)) +
+                 FormatMemoryOperand(rs1_short, offset_w);
+        case 7u:
+          return StringPrintf("sd %s, ", XRegName(rd_short)) +
+                 FormatMemoryOperand(rs1_short, offset_d);
+        default:
+          return kUnknown;
+      }
+    }
+    case 1u:
+      switch (funct3) {
+        case 0u:
+          if (rd == Zero) {
+            return "nop";
+          }
+          return StringPrintf("addi %s, %s, %d", XRegName(rd), XRegName(rd), imm6);
+        case 1u:
+          if (rd == Zero) {
+            return kUnknown;
+          } else if (imm6 == 0) {
+            return StringPrintf("sext.w %s, %s", XRegName(rd), XRegName(rd));
+          }
+          return StringPrintf("addiw %s, %s, %d", XRegName(rd), XRegName(rd), imm6);
+        case 2u:
+          return StringPrintf("li %s, %d", XRegName(rd), imm6);
+        case 3u:
+          if (rd == SP) {
+            uint32_t nzimm = (((bits >> 12) & 0x1u) << 9) |
+                             (((bits >> 6) & 0x1u) << 4) |
+                             (((bits >> 5) & 0x1u) << 6) |
+                             (((bits >> 3) & 0x3u) << 7) |
+                             (((bits >> 2) & 0x1u) << 5);
+            return StringPrintf("addi sp, sp, %d", SignExtend(nzimm, 10u));
+          } else if (imm6 == 0) {
+            return kUnknown;
+          }
+          return StringPrintf("lui %s, 0x%x", XRegName(rd), static_cast<uint32_t>(imm6) & 0xfffffu);
+        case 4u: {
+          uint32_t rd_alu = rs1_short;
+          switch ((bits >> 10) & 0x3u) {
+            case 0u:
+              return StringPrintf("srli %s, %s, %u", XRegName(rd_alu), XRegName(rd_alu), uimm6);
+            case 1u:
+              return StringPrintf("srai %s, %s, %u", XRegName(rd_alu), XRegName(rd_alu), uimm6);
+            case 2u:
+              return StringPrintf("andi %s, %s, %d", XRegName(rd_alu), XRegName(rd_alu), imm6);
+            default: {
+              static const char* const kNames[] = {"sub", "xor", "or", "and",
+                                                   "subw", "addw", nullptr, nullptr};
+              const char* name = kNames[(((bits >> 12) & 0x1u) << 2) | ((bits >> 5) & 0x3u)];
+              if (name == nullptr) {
+                return kUnknown;
+              }
+              return StringPrintf(
+                  "%s %s, %s, %s", name, XRegName(rd_alu), XRegName(rd_alu), XRegName(rd_short));
+            }
+          }
+        }
+        case 5u: {
+          uint32_t offset = (((bits >> 12) & 0x1u) << 11) |
+                            (((bits >> 11) & 0x1u) << 4) |
+                            (((bits >> 9) & 0x3u) << 8) |
+                            (((bits >> 8) & 0x1u) << 10) |
+                            (((bits >> 7) & 0x1u) << 6) |
+                            (((bits >> 6) & 0x1u) << 7) |
+                            (((bits >> 3) & 0x7u) << 1) |
+                            (((bits >> 2) & 0x1u) << 5);
+          return "j " + FormatBranchTarget(insn, SignExtend(offset, 12u));
+        }
+        default: {
+          uint32_t offset = (((bits >> 12) & 0x1u) << 8) |
+                            (((bits >> 10) & 0x3u) << 3) |
+                            (((bits >> 5) & 0x3u) << 6) |
+                            (((bits >> 3) & 0x3u) << 1) |
+                            (((bits >> 2) & 0x1u) << 5);
+          return StringPrintf("%s %s, ", (funct3 == 6u) ? "beqz" : "bnez", XRegName(rs1_short)) +
+                 FormatBranchTarget(insn, SignExtend(offset, 9u));
+        }
+      }
+    case 2u: {
+      // Offsets for the CI and CSS stack-pointer-relative formats.
+      uint32_t load_offset_w = (((bits >> 12) & 0x1u) << 5) |
+                               (((bits >> 4) & 0x7u) << 2) |
+                               (((bits >> 2) & 0x3u) << 6);
+      uint32_t load_offset_d = (((bits >> 12) & 0x1u) << 5) |
+                               (((bits >> 5) & 0x3u) << 3) |
+                               (((bits >> 2) & 0x7u) << 6);
+      uint32_t store_offset_w = (((bits >> 9) & 0xfu) << 2) | (((bits >> 7) & 0x3u) << 6);
+      uint32_t store_offset_d = (((bits >> 10) & 0x7u) << 3) | (((bits >> 7) & 0x7u) << 6);
+      switch (funct3) {
+        case 0u:
+          return StringPrintf("slli %s, %s, %u", XRegName(rd), XRegName(rd), uimm6);
+        case 1u:
+          return StringPrintf("fld %s, ", FRegName(rd)) + FormatMemoryOperand(SP, load_offset_d);
+        case 2u:
+          return StringPrintf("lw %s, ", XRegName(rd)) + FormatMemoryOperand(SP, load_offset_w);
+        case 3u:
+          return StringPrintf("ld %s, ", XRegName(rd)) + FormatMemoryOperand(SP, load_offset_d);
+        case 4u:
+          if (((bits >> 12) & 0x1u) == 0u) {
+            if (rs2 == Zero) {
+              return (rd == RA) ? std::string("ret") : StringPrintf("jr %s", XRegName(rd));
+            }
+            return StringPrintf("mv %s, %s", XRegName(rd), XRegName(rs2));
+          } else if (rs2 == Zero) {
+            return (rd == Zero) ? std::string("ebreak") : StringPrintf("jalr %s", XRegName(rd));
+          }
+          return StringPrintf("add %s, %s, %s", XRegName(rd), XRegName(rd), XRegName(rs2));
+        case 5u:
+          return StringPrintf("fsd %s, ", FRegName(rs2)) + FormatMemoryOperand(SP, store_offset_d);
+        case 6u:
+          return StringPrintf("sw %s, ", XRegName(rs2)) + FormatMemoryOperand(SP, store_offset_w);
+        default:
+          return StringPrintf("sd %s, ", XRegName(rs2)) + FormatMemoryOperand(SP, store_offset_d);
+      }
+    }
+    default:
+      LOG(FATAL) << "Unreachable";
+      UNREACHABLE();
+  }
+}
+
+size_t DisassemblerRiscv64::Disassemble(const uint8_t* insn, std::string* text) {
+  uint32_t bits = static_cast<uint32_t>(insn[0]) | (static_cast<uint32_t>(insn[1]) << 8);
+  if ((bits & 0x3u) != 0x3u) {
+    *text = DisassembleCompressed(insn, bits);
+    return 2u;
+  }
+  bits |= (static_cast<uint32_t>(insn[2]) << 16) | (static_cast<uint32_t>(insn[3]) << 24);
+  *text = Disassemble32(insn, bits);
+  return 4u;
+}
+
+size_t DisassemblerRiscv64::Dump(std::ostream& os, const uint8_t* begin) {
+  std::string text;
+  size_t length = Disassemble(begin, &text);
+  if (length == 2u) {
+    uint32_t bits = static_cast<uint32_t>(begin[0]) | (static_cast<uint32_t>(begin[1]) << 8);
+    os << FormatInstructionPointer(begin) << StringPrintf(": %04x    \t%s\n", bits, text.c_str());
+  } else {
+    uint32_t bits = static_cast<uint32_t>(begin[0]) |
+                    (static_cast<uint32_t>(begin[1]) << 8) |
+                    (static_cast<uint32_t>(begin[2]) << 16) |
+                    (static_cast<uint32_t>(begin[3]) << 24);
+    os << FormatInstructionPointer(begin) << StringPrintf(": %08x\t%s\n", bits, text.c_str());
+  }
+  return length;
+}
+
+void DisassemblerRiscv64::Dump(std::ostream& os, const uint8_t* begin, const uint8_t* end) {
+  for (const uint8_t* cur = begin; cur < end; ) {
+    cur += Dump(os, cur);
+  }
+}
+
+}  // namespace riscv64
+}  // namespace art
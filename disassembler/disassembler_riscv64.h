@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_DISASSEMBLER_DISASSEMBLER_RISCV64_H_
+#define ART_DISASSEMBLER_DISASSEMBLER_RISCV64_H_
+
+#include <string>
+
+#include "disassembler.h"
+
+namespace art {
+namespace riscv64 {
+
+// Disassembler for RV64GC with the Zba, Zbb, Zbs and V extensions.
+class DisassemblerRiscv64 final : public Disassembler {
+ public:
+  explicit DisassemblerRiscv64(DisassemblerOptions* options) : Disassembler(options) {}
+
+  size_t Dump(std::ostream& os, const uint8_t* begin) override;
+  void Dump(std::ostream& os, const uint8_t* begin, const uint8_t* end) override;
+
+  // Disassemble the instruction at `insn`, storing its text in `text`. Returns the length
+  // of the instruction in bytes, 2 for compressed and 4 for standard instructions.
+  size_t Disassemble(const uint8_t* insn, std::string* text);
+
+ private:
+  std::string DisassembleCompressed(const uint8_t* insn, uint32_t bits);
+  std::string Disassemble32(const uint8_t* insn, uint32_t bits);
+
+  // Format a pc-relative branch or jump target.
+  std::string FormatBranchTarget(const uint8_t* insn, int32_t offset);
+
+  // Format a memory operand `offset(rs1)`, appending the thread offset name for
+  // accesses relative to the thread register.
+  std::string FormatMemoryOperand(uint32_t rs1, int32_t offset);
+
+  DISALLOW_COPY_AND_ASSIGN(DisassemblerRiscv64);
+};
+
+}  // namespace riscv64
+}  // namespace art
+
+#endif  // ART_DISASSEMBLER_DISASSEMBLER_RISCV64_H_
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <inttypes.h>
+
+#include <memory>
+#include <string>
+
+#include "base/common_art_test.h"
+#include "disassembler_riscv64.h"
+#include "thread.h"
+
+namespace art {
+namespace riscv64 {
+
+class DisassemblerRiscv64Test : public CommonArtTest {
+ public:
+  void SetUp() override {
+    CommonArtTest::SetUp();
+    disasm_.reset(new DisassemblerRiscv64(
+        new DisassemblerOptions(/* absolute_addresses= */ false,
+                                code_,
+                                code_ + sizeof(code_),
+                                /* can_read_literals_= */ false,
+                                &Thread::DumpThreadOffset<PointerSize::k64>)));
+  }
+
+  // Place the instruction at `kInstructionOffset` within the buffer so that branch
+  // targets before the instruction stay within the buffer.
+  static constexpr size_t kInstructionOffset = 16u;
+
+  void Compare(uint32_t bits, size_t size, const char* expected) {
+    for (size_t i = 0; i != size; ++i) {
+      code_[kInstructionOffset + i] = static_cast<uint8_t>(bits >> (8u * i));
+    }
+    std::string text;
+    EXPECT_EQ(size, disasm_->Disassemble(code_ + kInstructionOffset, &text));
+    EXPECT_EQ(std::string(expected), text) << "Encoding: " << std::hex << bits;
+  }
+
+  void Compare32(uint32_t bits, const char* expected) { Compare(bits, 4u, expected); }
+  void Compare16(uint16_t bits, const char* expected) { Compare(bits, 2u, expected); }
+
+ private:
+  uint8_t code_[32] = {};
+  std::unique_ptr<DisassemblerRiscv64> disasm_;
+};
+
+TEST_F(DisassemblerRiscv64Test, Base) {
+  Compare32(0x00b50533u, "add a0, a0, a1");
+  Compare32(0x00c5b503u, "ld a0, 12(a1)");
+  Compare32(0x0205d513u, "srli a0, a1, 32");
+  Compare32(0xfeb50ce3u, "beq a0, a1, -8 ; 0x00000008");
+  Compare32(0x00008067u, "ret");
+  Compare32(0x0330000fu, "fence rw, rw");
+  Compare16(0xbff5u, "j -4 ; 0x0000000c");
+  Compare16(0x852eu, "mv a0, a1");
+}
+
+TEST_F(DisassemblerRiscv64Test, ThreadOffset) {
+  // Append the thread offset name to accesses relative to the thread register.
+  Compare32(0x0084a503u, "lw a0, 8(tr) ; thin_lock_thread_id");
+  Compare16(0x4488u, "lw a0, 8(tr) ; thin_lock_thread_id");
+  // Do not append anything for other base registers.
+  Compare16(0x6588u, "ld a0, 8(a1)");
+}
+
+TEST_F(DisassemblerRiscv64Test, FloatingPointAndAtomics) {
+  Compare32(0xc2051553u, "fcvt.w.d a0, fa0, rtz");
+  Compare32(0x06c5a52fu, "amoadd.w.aqrl a0, a2, (a1)");
+}
+
+TEST_F(DisassemblerRiscv64Test, BitManipulation) {
+  Compare32(0x20c5c533u, "sh2add a0, a1, a2");
+  Compare32(0x6b85d513u, "rev8 a0, a1");
+}
+
+TEST_F(DisassemblerRiscv64Test, Vector) {
+  Compare32(0x0d0572d7u, "vsetvli t0, a0, e32, m1, ta, ma");
+  Compare32(0x02056407u, "vle32.v v8, (a0)");
+  Compare32(0x002540d7u, "vadd.vx v1, v2, a0, v0.t");
+  Compare32(0xb23550d7u, "vfmacc.vf v1, fa0, v3");
+}
+
+}  // namespace riscv64
+}  // namespace art
@@ -21,12 +21,15 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <algorithm>
 #include <functional>
 #include <map>
 #include <optional>
 #include <ostream>
 #include <set>
+#include <sstream>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -34,8 +37,10 @@
 #include "art_field-inl.h"
 #include "art_method-inl.h"
 #include "base/array_ref.h"
+#include "base/casts.h"
 #include "base/os.h"
 #include "base/string_view_cpp20.h"
+#include "base/time_utils.h"
 #include "base/unix_file/fd_file.h"
 #include "class_linker.h"
 #include "cmdline.h"
@@ -287,6 +292,7 @@ struct RegionCommon {
   size_t GetDirtyEntryBytes() const { return dirty_entry_bytes_; }
   size_t GetFalseDirtyEntryCount() const { return false_dirty_entries_.size(); }
   size_t GetFalseDirtyEntryBytes() const { return false_dirty_entry_bytes_; }
+  const std::set<T*>& GetImageDirtyEntries() const { return image_dirty_entries_; }
 
  protected:
   bool IsEntryOnDirtyPage(T* entry, const std::set<size_t>& dirty_pages) const
@@ -1111,7 +1117,11 @@ class ImgDiagDumper {
         image_diff_pid_(image_diff_pid),
         zygote_diff_pid_(zygote_diff_pid),
         dump_dirty_objects_(dump_dirty_objects),
-        zygote_pid_only_(false) {}
+        zygote_pid_only_(false),
+        report_os_(os),
+        null_os_(nullptr),
+        sample_(0u),
+        image_chunk_begin_(nullptr) {}
 
   bool Init() {
     std::ostream& os = *os_;
@@ -1218,9 +1228,71 @@ class ImgDiagDumper {
     return true;
   }
 
+  // Starts sample `sample` of the continuous sampling mode. Only a sample with `write_report`
+  // writes the full report, the others only record the entries that became private dirty.
+  void BeginSample(size_t sample, bool write_report) {
+    sample_ = sample;
+    os_ = write_report ? report_os_ : &null_os_;
+  }
+
+  // Writes the objects that became private dirty in any sample in the format of dex2oat's
+  // --dirty-image-objects. The sort key is the first sample in which the object was dirty, so
+  // that dex2oat places the objects dirtied in the same phase of the app next to each other.
+  // The offsets only match the boot image layout if the boot image was compiled without a
+  // dirty image objects file. The dirty ArtMethods are only listed in comments.
+  bool WriteDirtyObjects(const std::string& file_name) REQUIRES_SHARED(Locks::mutator_lock_) {
+    std::vector<std::pair<mirror::Object*, DirtyEntryInfo>> objects(dirty_objects_.begin(),
+                                                                    dirty_objects_.end());
+    std::sort(objects.begin(), objects.end(), [](const auto& lhs, const auto& rhs) {
+      return std::make_pair(lhs.second.first_sample, lhs.second.offset) <
+             std::make_pair(rhs.second.first_sample, rhs.second.offset);
+    });
+    std::ostringstream oss;
+    oss << "# Private dirty boot image objects of pid " << image_diff_pid_ << " in "
+        << sample_ + 1u << " sample(s).\n";
+    for (const auto& [obj, info] : objects) {
+      const bool is_class = obj->IsClass();
+      const uint32_t descriptor_hash =
+          is_class ? obj->AsClass()->DescriptorHash() : obj->GetClass()->DescriptorHash();
+      oss << "dirty_obj: " << info.offset << (is_class ? " class " : " instance ")
+          << descriptor_hash << " " << info.first_sample << "\n";
+    }
+    std::vector<std::pair<ArtMethod*, DirtyEntryInfo>> methods(dirty_methods_.begin(),
+                                                               dirty_methods_.end());
+    std::sort(methods.begin(), methods.end(), [](const auto& lhs, const auto& rhs) {
+      return std::make_pair(lhs.second.first_sample, lhs.second.offset) <
+             std::make_pair(rhs.second.first_sample, rhs.second.offset);
+    });
+    for (const auto& [method, info] : methods) {
+      oss << "# dirty_method: " << info.first_sample << " " << method->PrettyMethod() << "\n";
+    }
+
+    std::unique_ptr<File> file(OS::CreateEmptyFile(file_name.c_str()));
+    if (file == nullptr) {
+      *report_os_ << "Failed to create " << file_name << "\n";
+      return false;
+    }
+    std::string contents = oss.str();
+    if (!file->WriteFully(contents.data(), contents.size())) {
+      *report_os_ << "Failed to write " << file_name << "\n";
+      file->Erase();
+      return false;
+    }
+    if (file->FlushCloseOrErase() != 0) {
+      *report_os_ << "Flush and close of " << file_name << " failed\n";
+      return false;
+    }
+    return true;
+  }
+
   bool Dump(const ImageHeader& image_header, const std::string& image_location)
       REQUIRES_SHARED(Locks::mutator_lock_) {
     std::ostream& os = *os_;
+    // The primary image of a boot image or extension records the number of components compiled
+    // together. dex2oat's dirty object offsets are relative to the first of those images.
+    if (image_header.GetComponentCount() != 0u || image_chunk_begin_ == nullptr) {
+      image_chunk_begin_ = image_header.GetImageBegin();
+    }
     os << "IMAGE LOCATION: " << image_location << "\n\n";
 
     os << "MAGIC: " << image_header.GetMagic() << "\n\n";
@@ -1540,9 +1612,45 @@ class ImgDiagDumper {
     artmethod_region_data.ProcessRegion(mapping_data,
                                         remotes,
                                         image_begin_unaligned);
+
+    size_t new_objects = RecordDirtyEntries(object_region_data.GetImageDirtyEntries(),
+                                            &dirty_objects_);
+    size_t new_methods = RecordDirtyEntries(artmethod_region_data.GetImageDirtyEntries(),
+                                            &dirty_methods_);
+    if (os_ != report_os_ || sample_ != 0u) {
+      *report_os_ << "SAMPLE " << sample_ << " " << GetImageLocationBaseName(image_location)
+                  << ": " << mapping_data.private_dirty_pages << " private dirty pages, "
+                  << object_region_data.GetImageDirtyEntries().size() << " dirty objects ("
+                  << new_objects << " new), "
+                  << artmethod_region_data.GetImageDirtyEntries().size() << " dirty methods ("
+                  << new_methods << " new)\n";
+    }
     return true;
   }
 
+  struct DirtyEntryInfo {
+    // The offset from the beginning of the images compiled together.
+    uint32_t offset;
+    // The first sample in which the entry was private dirty.
+    size_t first_sample;
+  };
+
+  // Records the first sample for the `entries` that were not dirty in an earlier sample and
+  // returns their number.
+  template <typename T>
+  size_t RecordDirtyEntries(const std::set<T*>& entries,
+                            std::unordered_map<T*, DirtyEntryInfo>* dirty_entries) {
+    size_t new_entries = 0u;
+    for (T* entry : entries) {
+      uint32_t offset =
+          dchecked_integral_cast<uint32_t>(reinterpret_cast<uint8_t*>(entry) - image_chunk_begin_);
+      if (dirty_entries->emplace(entry, DirtyEntryInfo{offset, sample_}).second) {
+        ++new_entries;
+      }
+    }
+    return new_entries;
+  }
+
   static int IsPageDirty(File& page_map_file,
                          File& clean_pagemap_file,
                          File& kpageflags_file,
@@ -1619,6 +1727,17 @@ class ImgDiagDumper {
   bool dump_dirty_objects_;  // Adds dumping of objects that are dirty.
   bool zygote_pid_only_;  // The user only specified a pid for the zygote.
 
+  // The stream for the report, `os_` points to `null_os_` in the samples without a report.
+  std::ostream* report_os_;
+  std::ostream null_os_;
+  // The current sample of the continuous sampling mode.
+  size_t sample_;
+  // The beginning of the images compiled together with the current image.
+  const uint8_t* image_chunk_begin_;
+  // The entries that were private dirty in any sample.
+  std::unordered_map<mirror::Object*, DirtyEntryInfo> dirty_objects_;
+  std::unordered_map<ArtMethod*, DirtyEntryInfo> dirty_methods_;
+
   // Used for finding the memory mapping of the image file.
   std::vector<android::procinfo::MapInfo> image_proc_maps_;
   // A File for reading /proc/<image_diff_pid_>/mem.
@@ -1645,7 +1764,10 @@ static int DumpImage(Runtime* runtime,
                      std::ostream* os,
                      pid_t image_diff_pid,
                      pid_t zygote_diff_pid,
-                     bool dump_dirty_objects) {
+                     bool dump_dirty_objects,
+                     size_t sample_count,
+                     uint32_t sample_interval_ms,
+                     const std::string& dirty_objects_output) {
   ScopedObjectAccess soa(Thread::Current());
   gc::Heap* heap = runtime->GetHeap();
   const std::vector<gc::space::ImageSpace*>& image_spaces = heap->GetBootImageSpaces();
@@ -1657,17 +1779,32 @@ static int DumpImage(Runtime* runtime,
   if (!img_diag_dumper.Init()) {
     return EXIT_FAILURE;
   }
-  for (gc::space::ImageSpace* image_space : image_spaces) {
-    const ImageHeader& image_header = image_space->GetImageHeader();
-    if (!image_header.IsValid()) {
-      fprintf(stderr, "Invalid image header %s\n", image_space->GetImageLocation().c_str());
-      return EXIT_FAILURE;
-    }
+  for (size_t sample = 0; sample != sample_count; ++sample) {
+    if (sample != 0u) {
+      // Let the runtime's own threads run while waiting.
+      ScopedThreadSuspension sts(soa.Self(), ThreadState::kSuspended);
+      NanoSleep(MsToNs(sample_interval_ms));
+    }
+    // Only the last sample writes the full report.
+    img_diag_dumper.BeginSample(sample, /*write_report=*/ sample + 1u == sample_count);
+    for (gc::space::ImageSpace* image_space : image_spaces) {
+      const ImageHeader& image_header = image_space->GetImageHeader();
+      if (!image_header.IsValid()) {
+        fprintf(stderr, "Invalid image header %s\n", image_space->GetImageLocation().c_str());
+        return EXIT_FAILURE;
+      }
 
-    if (!img_diag_dumper.Dump(image_header, image_space->GetImageLocation())) {
-      return EXIT_FAILURE;
+      if (!img_diag_dumper.Dump(image_header, image_space->GetImageLocation())) {
+        fprintf(stderr, "Failed to diff %s in sample %zu\n",
+                image_space->GetImageLocation().c_str(),
+                sample);
+        return EXIT_FAILURE;
+      }
     }
   }
+  if (!dirty_objects_output.empty() && !img_diag_dumper.WriteDirtyObjects(dirty_objects_output)) {
+    return EXIT_FAILURE;
+  }
   return EXIT_SUCCESS;
 }
 
@@ -1703,6 +1840,22 @@ struct ImgDiagArgs : public CmdlineArgs {
       }
     } else if (option == "--dump-dirty-objects") {
       dump_dirty_objects_ = true;
+    } else if (StartsWith(option, "--sample-count=")) {
+      const char* sample_count = raw_option + strlen("--sample-count=");
+
+      if (!android::base::ParseUint(sample_count, &sample_count_) || sample_count_ == 0u) {
+        *error_msg = "Sample count must be a positive integer";
+        return kParseError;
+      }
+    } else if (StartsWith(option, "--sample-interval-ms=")) {
+      const char* sample_interval_ms = raw_option + strlen("--sample-interval-ms=");
+
+      if (!android::base::ParseUint(sample_interval_ms, &sample_interval_ms_)) {
+        *error_msg = "Sample interval out of range";
+        return kParseError;
+      }
+    } else if (StartsWith(option, "--dirty-objects-output=")) {
+      dirty_objects_output_ = raw_option + strlen("--dirty-objects-output=");
     } else {
       return kParseUnknownArgument;
     }
@@ -1756,6 +1909,13 @@ struct ImgDiagArgs : public CmdlineArgs {
         "against.\n"
         "      Example: --zygote-diff-pid=$(pid zygote)\n"
         "  --dump-dirty-objects: additionally output dirty objects of interest.\n"
+        "  --sample-count=<n>: diff the images <n> times and report in which sample the objects\n"
+        "      and methods first became private dirty. Only the last sample writes the full\n"
+        "      report. Default: 1.\n"
+        "  --sample-interval-ms=<ms>: the time between two samples. Default: 1000.\n"
+        "  --dirty-objects-output=<file>: write the objects that were private dirty in any\n"
+        "      sample to <file>, in the format of dex2oat --dirty-image-objects. The offsets\n"
+        "      only match if the boot image was compiled without --dirty-image-objects.\n"
         "\n";
 
     return usage;
@@ -1765,6 +1925,9 @@ struct ImgDiagArgs : public CmdlineArgs {
   pid_t image_diff_pid_ = -1;
   pid_t zygote_diff_pid_ = -1;
   bool dump_dirty_objects_ = false;
+  size_t sample_count_ = 1u;
+  uint32_t sample_interval_ms_ = 1000u;
+  std::string dirty_objects_output_;
 };
 
 struct ImgDiagMain : public CmdlineMain<ImgDiagArgs> {
@@ -1775,7 +1938,10 @@ struct ImgDiagMain : public CmdlineMain<ImgDiagArgs> {
                      args_->os_,
                      args_->image_diff_pid_,
                      args_->zygote_diff_pid_,
-                     args_->dump_dirty_objects_) == EXIT_SUCCESS;
+                     args_->dump_dirty_objects_,
+                     args_->sample_count_,
+                     args_->sample_interval_ms_,
+                     args_->dirty_objects_output_) == EXIT_SUCCESS;
   }
 };
 
@@ -406,9 +406,27 @@ class BitMemoryReader {
       values[i] = BitFieldExtract(data, i * kVarintBits, kVarintBits);
     }
     // Do the second part in its own loop as that seems to produce better code in clang.
+    size_t large_bits = 0;
     for (size_t i = 0; i < N; i++) {
       if (UNLIKELY(values[i] > kVarintMax)) {
-        values[i] = ReadBits((values[i] - kVarintMax) * kBitsPerByte);
+        large_bits += (values[i] - kVarintMax) * kBitsPerByte;
+      }
+    }
+    if (LIKELY(large_bits <= BitSizeOf<uint64_t>())) {
+      // The large values usually fit in a word, load them together.
+      uint64_t large = ReadBits<uint64_t>(large_bits);
+      for (size_t i = 0; i < N; i++) {
+        if (UNLIKELY(values[i] > kVarintMax)) {
+          size_t bits = (values[i] - kVarintMax) * kBitsPerByte;
+          values[i] = static_cast<uint32_t>(large & MaxInt<uint64_t>(bits));
+          large >>= bits;  // At most 32 bits.
+        }
+      }
+    } else {
+      for (size_t i = 0; i < N; i++) {
+        if (UNLIKELY(values[i] > kVarintMax)) {
+          values[i] = ReadBits((values[i] - kVarintMax) * kBitsPerByte);
+        }
       }
     }
     return values;
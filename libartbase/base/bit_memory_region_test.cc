@@ -51,6 +51,27 @@ TEST(BitMemoryRegion, TestVarint) {
   }
 }
 
+TEST(BitMemoryRegion, TestInterleavedVarints) {
+  std::array<std::array<uint32_t, 5>, 4> tests = {{
+    {0u, 1u, 11u, 7u, 3u},  // No large values.
+    {12u, 5u, 255u, 256u, 1u << 16},  // Large values fit in a word.
+    {~0u, 1u, 1u << 24, ~1u, 0u},  // Large values take more than a word.
+    {~0u, ~0u, ~0u, ~0u, ~0u},
+  }};
+  for (size_t start_bit_offset = 0; start_bit_offset <= 32; start_bit_offset++) {
+    for (const std::array<uint32_t, 5>& values : tests) {
+      std::vector<uint8_t> buffer;
+      BitMemoryWriter<std::vector<uint8_t>> writer(&buffer, start_bit_offset);
+      writer.WriteInterleavedVarints(values);
+
+      BitMemoryReader reader(buffer.data(), start_bit_offset);
+      std::array<uint32_t, 5> result = reader.ReadInterleavedVarints<5>();
+      EXPECT_EQ(writer.NumberOfWrittenBits(), reader.NumberOfReadBits());
+      EXPECT_EQ(values, result);
+    }
+  }
+}
+
 TEST(BitMemoryRegion, TestBit) {
   uint8_t data[sizeof(uint32_t) * 2];
   for (size_t bit_offset = 0; bit_offset < 2 * sizeof(uint32_t) * kBitsPerByte; ++bit_offset) {
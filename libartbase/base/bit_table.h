@@ -69,6 +69,35 @@ class BitTableBase {
     return table_data_.LoadBits(offset, NumColumnBits(column)) + kValueBias;
   }
 
+  // Get the values of `kCount` consecutive columns of `row`, starting at `first_column`.
+  // The columns are loaded together when they fit in a word, which saves the separate load
+  // of each column for callers that need several columns of the same row.
+  template <uint32_t kCount>
+  ALWAYS_INLINE std::array<uint32_t, kCount> GetColumns(uint32_t row,
+                                                        uint32_t first_column = 0) const {
+    DCHECK(table_data_.IsValid()) << "Table has not been loaded";
+    DCHECK_LT(row, num_rows_);
+    DCHECK_LE(first_column + kCount, kNumColumns);
+    std::array<uint32_t, kCount> values;
+    uint32_t begin = column_offset_[first_column];
+    uint32_t num_bits = column_offset_[first_column + kCount] - begin;
+    if (LIKELY(num_bits <= BitSizeOf<uint64_t>())) {
+      uint64_t bits = table_data_.LoadBits<uint64_t>(row * NumRowBits() + begin, num_bits);
+      for (uint32_t i = 0; i != kCount; ++i) {
+        uint32_t column = first_column + i;
+        // Columns are at most 32 bits, an empty column may start at bit 64.
+        uint32_t shift = (column_offset_[column] - begin) & (BitSizeOf<uint64_t>() - 1u);
+        uint64_t value = (bits >> shift) & MaxInt<uint64_t>(NumColumnBits(column));
+        values[i] = static_cast<uint32_t>(value) + kValueBias;
+      }
+    } else {
+      for (uint32_t i = 0; i != kCount; ++i) {
+        values[i] = Get(row, first_column + i);
+      }
+    }
+    return values;
+  }
+
   ALWAYS_INLINE BitMemoryRegion GetBitMemoryRegion(uint32_t row, uint32_t column = 0) const {
     DCHECK(table_data_.IsValid()) << "Table has not been loaded";
     DCHECK_LT(row, num_rows_);
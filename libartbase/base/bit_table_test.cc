@@ -119,6 +119,43 @@ TEST(BitTableTest, TestBigTable) {
   EXPECT_EQ(32u, table.NumColumnBits(3));
 }
 
+TEST(BitTableTest, TestGetColumns) {
+  MallocArenaPool pool;
+  ArenaStack arena_stack(&pool);
+  ScopedArenaAllocator allocator(&arena_stack);
+
+  constexpr uint32_t kNoValue = -1;
+  for (size_t start_bit_offset = 0; start_bit_offset <= 32; start_bit_offset++) {
+    std::vector<uint8_t> buffer;
+    BitMemoryWriter<std::vector<uint8_t>> writer(&buffer, start_bit_offset);
+    BitTableBuilderBase<4> builder(&allocator);
+    builder.Add({42u, static_cast<uint32_t>(-2), 0u, 7u});
+    builder.Add({62u, kNoValue, 63u, static_cast<uint32_t>(-3)});
+    builder.Add({1u, 0u, 5u, 0u});
+    builder.Encode(writer);
+
+    BitMemoryReader reader(buffer.data(), start_bit_offset);
+    BitTableBase<4> table(reader);
+    // Two columns take 32 bits, so the full rows do not fit in a word.
+    EXPECT_GT(table.NumRowBits(), 64u);
+    for (uint32_t row = 0; row != table.NumRows(); ++row) {
+      std::array<uint32_t, 4> all = table.GetColumns<4>(row);
+      std::array<uint32_t, 3> first = table.GetColumns<3>(row);
+      std::array<uint32_t, 2> middle = table.GetColumns<2>(row, 1);
+      std::array<uint32_t, 1> last = table.GetColumns<1>(row, 3);
+      for (uint32_t column = 0; column != 4u; ++column) {
+        EXPECT_EQ(table.Get(row, column), all[column]);
+      }
+      for (uint32_t column = 0; column != 3u; ++column) {
+        EXPECT_EQ(table.Get(row, column), first[column]);
+      }
+      EXPECT_EQ(table.Get(row, 1), middle[0]);
+      EXPECT_EQ(table.Get(row, 2), middle[1]);
+      EXPECT_EQ(table.Get(row, 3), last[0]);
+    }
+  }
+}
+
 TEST(BitTableTest, TestDedup) {
   MallocArenaPool pool;
   ArenaStack arena_stack(&pool);
@@ -311,6 +311,17 @@ struct Flags {
   // to logcat will be in human-readable text format.
   // Supported values are "text" and "xml".
   Flag<std::string> MetricsFormat{"metrics.format", "text", FlagType::kCmdlineOnly};
+
+
+  // Heap dump flags.
+
+  // Whether VMDebug.dumpHprofData() dumps the heap in a forked child, so that the app only
+  // pauses for the fork.
+  Flag<bool> HprofFork{"hprof.fork", false, FlagType::kDeviceConfig};
+
+  // Whether VMDebug.dumpHprofData() walks the heap once and writes the string and class records
+  // after the heap dump segments. See hprof::DumpHeapOptions.
+  Flag<bool> HprofStreaming{"hprof.streaming", false, FlagType::kDeviceConfig};
 };
 
 // This is the actual instance of all the flags.
@@ -34,6 +34,8 @@
 
 namespace art {
 
+template <class T, class EmptyFn, class HashFn, class Pred, class Alloc> class SwissHashSet;
+
 template <class Elem, class HashSetType>
 class HashSetIterator {
  public:
@@ -95,6 +97,8 @@ class HashSetIterator {
   friend bool operator==(const HashSetIterator<Elem1, HashSetType1>& lhs,
                          const HashSetIterator<Elem2, HashSetType2>& rhs);
   template <class T, class EmptyFn, class HashFn, class Pred, class Alloc> friend class HashSet;
+  template <class T, class EmptyFn, class HashFn, class Pred, class Alloc>
+  friend class SwissHashSet;
   template <class OtherElem, class OtherHashSetType> friend class HashSetIterator;
 };
 
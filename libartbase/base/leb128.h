@@ -17,6 +17,8 @@
 #ifndef ART_LIBARTBASE_BASE_LEB128_H_
 #define ART_LIBARTBASE_BASE_LEB128_H_
 
+#include <string.h>
+
 #include <vector>
 
 #include <android-base/logging.h>
@@ -59,6 +61,47 @@ static inline uint32_t DecodeUnsignedLeb128WithoutMovingCursor(const uint8_t* da
   return DecodeUnsignedLeb128(&data);
 }
 
+// Reads `kCount` consecutive unsigned LEB128 values into `out`, updating the given pointer to
+// point just past the end of the last value. The `kCount` values take at least `kCount` bytes,
+// so the common case of all values fitting in one byte is detected with a single load.
+template <size_t kCount>
+static inline void DecodeUnsignedLeb128s(const uint8_t** data, /*out*/ uint32_t* out) {
+  static_assert(kCount != 0u && kCount <= sizeof(uint64_t));
+  const uint8_t* ptr = *data;
+  uint64_t bytes = 0u;
+  memcpy(&bytes, ptr, kCount);
+  constexpr uint64_t kContinuationBits =
+      UINT64_C(0x8080808080808080) >> (BitSizeOf<uint64_t>() - kBitsPerByte * kCount);
+  if (LIKELY((bytes & kContinuationBits) == 0u)) {
+    for (size_t i = 0; i != kCount; ++i) {
+      out[i] = ptr[i];
+    }
+    *data = ptr + kCount;
+  } else {
+    for (size_t i = 0; i != kCount; ++i) {
+      out[i] = DecodeUnsignedLeb128(data);
+    }
+  }
+}
+
+// Decodes an unsigned LEB128 value of two to five bytes from one 64-bit load of the eight bytes
+// at `ptr`, which must all be readable. Stores the number of bytes of the value in `length`.
+// Like `DecodeUnsignedLeb128()`, this tolerates garbage in the high bits of the fifth byte.
+static inline uint32_t DecodeMultiByteUnsignedLeb128(const uint8_t* ptr, /*out*/ size_t* length) {
+  DCHECK_GT(*ptr, 0x7fu);
+  uint64_t word;
+  memcpy(&word, ptr, sizeof(word));  // Little-endian, bytes are in stream order.
+  // A byte without the continuation bit ends the value, five bytes at most.
+  uint64_t ends = ~word & UINT64_C(0x0000008080808080);
+  *length = (ends != 0u) ? CTZ(ends) / kBitsPerByte + 1u : 5u;
+  word &= ~UINT64_C(0) >> (BitSizeOf<uint64_t>() - kBitsPerByte * *length);
+  return static_cast<uint32_t>((word & 0x7fu) |
+                               ((word >> 1) & (0x7fu << 7)) |
+                               ((word >> 2) & (0x7fu << 14)) |
+                               ((word >> 3) & (0x7fu << 21)) |
+                               ((word >> 4) & (UINT64_C(0xf) << 28)));
+}
+
 static inline bool DecodeUnsignedLeb128Checked(const uint8_t** data,
                                                const void* end,
                                                uint32_t* out) {
@@ -66,6 +109,13 @@ static inline bool DecodeUnsignedLeb128Checked(const uint8_t** data,
   if (ptr >= end) {
     return false;
   }
+  if (UNLIKELY(*ptr > 0x7f) &&
+      static_cast<size_t>(reinterpret_cast<const uint8_t*>(end) - ptr) >= sizeof(uint64_t)) {
+    size_t length;
+    *out = DecodeMultiByteUnsignedLeb128(ptr, &length);
+    *data = ptr + length;
+    return true;
+  }
   int result = *(ptr++);
   if (UNLIKELY(result > 0x7f)) {
     if (ptr >= end) {
@@ -253,6 +253,59 @@ TEST(Leb128Test, SignedStream) {
   EXPECT_EQ(data_size, static_cast<size_t>(encoded_data_ptr - encoded_data));
 }
 
+TEST(Leb128Test, UnsignedChecked) {
+  // Decode each value both near the end of the data and with enough data after it for the
+  // word-load decoder, including garbage in the high bits of the fifth byte.
+  for (size_t i = 0; i < arraysize(uleb128_tests); ++i) {
+    for (uint8_t fifth_byte_garbage : {0x00u, 0xf0u}) {
+      uint8_t encoded_data[16] = {0xffu};
+      uint8_t* end = EncodeUnsignedLeb128(encoded_data, uleb128_tests[i].decoded);
+      size_t size = static_cast<size_t>(end - encoded_data);
+      if (size == 5u) {
+        encoded_data[4] |= fifth_byte_garbage;
+      }
+      for (const uint8_t* data_end : {end, encoded_data + arraysize(encoded_data)}) {
+        const uint8_t* data_ptr = encoded_data;
+        uint32_t value = 0u;
+        ASSERT_TRUE(DecodeUnsignedLeb128Checked(&data_ptr, data_end, &value));
+        EXPECT_EQ(uleb128_tests[i].decoded, value) << " i = " << i;
+        EXPECT_EQ(end, data_ptr) << " i = " << i;
+      }
+      // A truncated value must be rejected.
+      const uint8_t* data_ptr = encoded_data;
+      uint32_t value = 0u;
+      EXPECT_FALSE(DecodeUnsignedLeb128Checked(&data_ptr, end - 1, &value)) << " i = " << i;
+    }
+  }
+}
+
+TEST(Leb128Test, UnsignedMultiple) {
+  std::vector<uint32_t> values;
+  for (size_t i = 0; i < arraysize(uleb128_tests); ++i) {
+    for (size_t j = 0; j < arraysize(uleb128_tests); ++j) {
+      for (size_t k = 0; k < arraysize(uleb128_tests); ++k) {
+        values.push_back(uleb128_tests[i].decoded);
+        values.push_back(uleb128_tests[j].decoded);
+        values.push_back(uleb128_tests[k].decoded);
+      }
+    }
+  }
+  Leb128EncodingVector<> builder;
+  for (uint32_t value : values) {
+    builder.PushBackUnsigned(value);
+  }
+  const uint8_t* encoded_data_ptr = &builder.GetData()[0];
+  for (size_t i = 0; i < values.size(); i += 3u) {
+    uint32_t decoded[3];
+    DecodeUnsignedLeb128s<3u>(&encoded_data_ptr, decoded);
+    EXPECT_EQ(values[i], decoded[0]) << " i = " << i;
+    EXPECT_EQ(values[i + 1u], decoded[1]) << " i = " << i;
+    EXPECT_EQ(values[i + 2u], decoded[2]) << " i = " << i;
+  }
+  EXPECT_EQ(builder.GetData().size(),
+            static_cast<size_t>(encoded_data_ptr - &builder.GetData()[0]));
+}
+
 TEST(Leb128Test, UnsignedUpdate) {
   for (size_t i = 0; i < arraysize(uleb128_tests); ++i) {
     for (size_t j = 0; j < arraysize(uleb128_tests); ++j) {
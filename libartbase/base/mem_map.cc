@@ -17,6 +17,7 @@
 #include "mem_map.h"
 
 #include <inttypes.h>
+#include <stdio.h>
 #include <stdlib.h>
 #if !defined(ANDROID_OS) && !defined(__Fuchsia__) && !defined(_WIN32)
 #include <sys/resource.h>
@@ -146,6 +147,35 @@ static uintptr_t GenerateNextMemPos() {
 
 // Initialize linear scan to random position.
 uintptr_t MemMap::next_mem_pos_ = GenerateNextMemPos();
+
+// Find the lowest page-aligned range of `length` bytes at or after `start` that is below 4GB
+// and free according to /proc/self/maps, which unlike gMaps also lists the mappings not made
+// through MemMap. Returns 0 if there is no such range or the maps cannot be read.
+static uintptr_t FindFreeLow4GBRange(uintptr_t start, size_t length) {
+  FILE* maps = fopen("/proc/self/maps", "re");
+  if (maps == nullptr) {
+    return 0u;
+  }
+  uintptr_t free_begin = std::max(start, LOW_MEM_START);
+  char* line = nullptr;
+  size_t line_capacity = 0u;
+  // The maps are listed in address order.
+  while (getline(&line, &line_capacity, maps) != -1) {
+    uintptr_t map_begin;
+    uintptr_t map_end;
+    if (sscanf(line, "%" SCNxPTR "-%" SCNxPTR, &map_begin, &map_end) != 2 ||
+        map_end <= free_begin) {
+      continue;
+    }
+    if (map_begin >= 4 * GB || map_begin >= free_begin + length) {
+      break;
+    }
+    free_begin = map_end;
+  }
+  free(line);
+  fclose(maps);
+  return (free_begin < 4 * GB && 4 * GB - free_begin >= length) ? free_begin : 0u;
+}
 #endif
 
 // Return true if the address range is contained in a single memory map by either reading
@@ -1058,6 +1088,7 @@ void* MemMap::MapInternalArtLow4GBAllocator(size_t length,
   void* actual = MAP_FAILED;
 
   bool first_run = true;
+  bool searched_free_ranges = false;
 
   std::lock_guard<std::mutex> mu(*mem_maps_lock_);
   for (uintptr_t ptr = next_mem_pos_; ptr < 4 * GB; ptr += kPageSize) {
@@ -1091,6 +1122,24 @@ void* MemMap::MapInternalArtLow4GBAllocator(size_t length,
       return actual;
     }
 
+    if (!searched_free_ranges) {
+      // Something that ART did not map is in the way. Rather than probing page by page below,
+      // look for a free range in the kernel's list of mappings, first above `ptr`, then from
+      // the bottom. The linear scan remains the fallback, e.g. if the maps cannot be read.
+      searched_free_ranges = true;
+      for (uintptr_t start : {ptr, LOW_MEM_START}) {
+        uintptr_t free_ptr = FindFreeLow4GBRange(start, length);
+        if (free_ptr != 0u) {
+          actual = TryMemMapLow4GB(
+              reinterpret_cast<void*>(free_ptr), length, prot, flags, fd, offset);
+          if (actual != MAP_FAILED) {
+            next_mem_pos_ = reinterpret_cast<uintptr_t>(actual) + length;
+            return actual;
+          }
+        }
+      }
+    }
+
     if (4U * GB - ptr < length) {
       // Not enough memory until 4GB.
       if (first_run) {
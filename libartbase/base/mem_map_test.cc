@@ -156,6 +156,36 @@ TEST_F(MemMapTest, Start) {
 #endif
   // End of test.
 }
+
+TEST_F(MemMapTest, MapAnonymousLow4GBSkipsForeignMapping) {
+  CommonInit();
+  std::string error_msg;
+  MemMap map = MemMap::MapAnonymous("MapAnonymousLow4GBSkipsForeignMapping",
+                                    kPageSize,
+                                    PROT_READ | PROT_WRITE,
+                                    /*low_4gb=*/ true,
+                                    &error_msg);
+  ASSERT_TRUE(map.IsValid()) << error_msg;
+  map.Reset();
+  // Put a mapping that MemMap does not know about where the next low 4GB map would go.
+  void* next_pos = reinterpret_cast<void*>(GetLinearScanPos());
+  void* foreign = mmap(next_pos, kPageSize, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  ASSERT_NE(foreign, MAP_FAILED);
+  if (foreign != next_pos) {
+    munmap(foreign, kPageSize);
+    GTEST_SKIP() << "Could not map at " << next_pos;
+  }
+  map = MemMap::MapAnonymous("MapAnonymousLow4GBSkipsForeignMapping",
+                             16 * kPageSize,
+                             PROT_READ | PROT_WRITE,
+                             /*low_4gb=*/ true,
+                             &error_msg);
+  ASSERT_TRUE(map.IsValid()) << error_msg;
+  EXPECT_LT(reinterpret_cast<uintptr_t>(map.BaseEnd()), 4 * GB);
+  EXPECT_TRUE(map.BaseEnd() <= foreign ||
+              map.BaseBegin() >= reinterpret_cast<uint8_t*>(foreign) + kPageSize);
+  munmap(foreign, kPageSize);
+}
 #endif
 
 // We need mremap to be able to test ReplaceMapping at all
@@ -46,7 +46,7 @@
   METRIC(WorldStopTimeDuringGCAvg, MetricsAverage)                  \
   METRIC(YoungGcCount, MetricsCounter)                              \
   METRIC(FullGcCount, MetricsCounter)                               \
-  METRIC(TotalBytesAllocated, MetricsCounter)                       \
+  METRIC(TotalBytesAllocated, MetricsShardedCounter)                \
   METRIC(TotalGcCollectionTime, MetricsCounter)                     \
   METRIC(YoungGcThroughputAvg, MetricsAverage)                      \
   METRIC(FullGcThroughputAvg, MetricsAverage)                       \
@@ -60,6 +60,7 @@
   METRIC(FullGcThroughput, MetricsHistogram, 15, 0, 10'000)         \
   METRIC(YoungGcTracingThroughput, MetricsHistogram, 15, 0, 10'000) \
   METRIC(FullGcTracingThroughput, MetricsHistogram, 15, 0, 10'000)  \
+  METRIC(AllocationSizeClass, MetricsHistogram, 12, 0, 12)          \
   METRIC(GcWorldStopTime, MetricsCounter)                           \
   METRIC(GcWorldStopCount, MetricsCounter)                          \
   METRIC(YoungGcScannedBytes, MetricsCounter)                       \
@@ -67,7 +68,33 @@
   METRIC(YoungGcDuration, MetricsCounter)                           \
   METRIC(FullGcScannedBytes, MetricsCounter)                        \
   METRIC(FullGcFreedBytes, MetricsCounter)                          \
-  METRIC(FullGcDuration, MetricsCounter)
+  METRIC(FullGcDuration, MetricsCounter)                            \
+  METRIC(GcMarkingTime, MetricsCounter)                             \
+  METRIC(GcReclaimTime, MetricsCounter)                             \
+  METRIC(GcCompactionTime, MetricsCounter)                          \
+  METRIC(GcReferenceProcessingTime, MetricsCounter)                 \
+  METRIC(GcRootVisitingTime, MetricsCounter)                        \
+  METRIC(GcThreadCpuTime, MetricsCounter)                           \
+  METRIC(GcMovedBytes, MetricsCounter)                              \
+  METRIC(TlabWastedBytes, MetricsCounter)                           \
+  METRIC(TimeToSafepoint, MetricsHistogram, 15, 0, 10'000)          \
+  METRIC(RuntimeInitTime, MetricsCounter)                           \
+  METRIC(RuntimeInitHeapTime, MetricsCounter)                       \
+  METRIC(RuntimeInitClassLinkerTime, MetricsCounter)                \
+  METRIC(MonitorHashCodeInflationCount, MetricsCounter)             \
+  METRIC(ClassLoadingCount, MetricsCounter)                         \
+  METRIC(ClassInitializationCount, MetricsCounter)                  \
+  METRIC(StartupRuntimeInitializedTime, MetricsCounter)             \
+  METRIC(StartupRuntimeStartedTime, MetricsCounter)                 \
+  METRIC(StartupAppInfoRegisteredTime, MetricsCounter)              \
+  METRIC(StartupDexFilesLoadedTime, MetricsCounter)                 \
+  METRIC(StartupFirstJitCompilationTime, MetricsCounter)            \
+  METRIC(StartupCompletedTime, MetricsCounter)                      \
+  METRIC(StartupClassesLoadedCount, MetricsCounter)                 \
+  METRIC(StartupClassesVerifiedCount, MetricsCounter)               \
+  METRIC(StartupClassesInitializedCount, MetricsCounter)            \
+  METRIC(StartupBytesAllocated, MetricsCounter)                     \
+  METRIC(StartupJitCompilationCount, MetricsCounter)
 
 // Increasing counter metrics, reported as Value Metrics in delta increments.
 #define ART_VALUE_METRICS(METRIC)                              \
@@ -84,7 +111,7 @@
   METRIC(ClassVerificationTotalTimeDelta, MetricsDeltaCounter) \
   METRIC(ClassVerificationCountDelta, MetricsDeltaCounter)     \
   METRIC(ClassLoadingTotalTimeDelta, MetricsDeltaCounter)      \
-  METRIC(TotalBytesAllocatedDelta, MetricsDeltaCounter)        \
+  METRIC(TotalBytesAllocatedDelta, MetricsShardedDeltaCounter) \
   METRIC(TotalGcCollectionTimeDelta, MetricsDeltaCounter)      \
   METRIC(YoungGcCountDelta, MetricsDeltaCounter)               \
   METRIC(FullGcCountDelta, MetricsDeltaCounter)
@@ -282,6 +309,10 @@ class MetricsBackend {
   friend class MetricsCounter;
   template <DatumId counter_type, typename T>
   friend class MetricsDeltaCounter;
+  template <DatumId counter_type, typename T>
+  friend class MetricsShardedCounter;
+  template <DatumId counter_type, typename T>
+  friend class MetricsShardedDeltaCounter;
   template <DatumId histogram_type, size_t num_buckets, int64_t low_value, int64_t high_value>
   friend class MetricsHistogram;
   template <DatumId datum_id, typename T, const T& AccumulatorFunction(const T&, const T&)>
@@ -322,6 +353,9 @@ class MetricsCounter : public MetricsBase<T> {
     value_.fetch_add(value, std::memory_order::memory_order_relaxed);
   }
 
+  // Read the counter, for the runtime code that takes snapshots of it (e.g. the startup timeline).
+  value_t Value() const { return value_.load(std::memory_order::memory_order_relaxed); }
+
   void Report(const std::vector<MetricsBackend*>& backends) const {
     for (MetricsBackend* backend : backends) {
       backend->ReportCounter(counter_type, Value());
@@ -330,7 +364,6 @@ class MetricsCounter : public MetricsBase<T> {
 
  protected:
   void Reset() { value_ = 0; }
-  value_t Value() const { return value_.load(std::memory_order::memory_order_relaxed); }
 
  private:
   bool IsNull() const override { return Value() == 0; }
@@ -433,6 +466,126 @@ class MetricsDeltaCounter : public MetricsBase<T> {
   friend class ArtMetrics;
 };
 
+// Per-thread shards of a counter for metrics updated from many threads on hot paths. Each shard
+// has a cache line of its own, so that threads adding to different shards do not contend for it,
+// and the shards are summed when the metric is reported.
+template <typename T>
+class MetricsShards {
+ public:
+  static constexpr size_t kNumShards = 16u;
+
+  constexpr MetricsShards() : shards_{} {}
+
+  void Add(T value) {
+    shards_[CurrentShard()].value.fetch_add(value, std::memory_order::memory_order_relaxed);
+  }
+
+  T Sum() const {
+    T sum = 0;
+    for (const Shard& shard : shards_) {
+      sum += shard.value.load(std::memory_order::memory_order_relaxed);
+    }
+    return sum;
+  }
+
+  // Returns the sum and resets the shards; additions racing with this go to the next sum.
+  T SumAndReset() {
+    T sum = 0;
+    for (Shard& shard : shards_) {
+      sum += shard.value.exchange(0, std::memory_order::memory_order_relaxed);
+    }
+    return sum;
+  }
+
+  void Reset() {
+    for (Shard& shard : shards_) {
+      shard.value = 0;
+    }
+  }
+
+ private:
+  // Assumed size of a cache line, the size on all supported architectures.
+  static constexpr size_t kShardAlignment = 64u;
+
+  struct alignas(kShardAlignment) Shard {
+    std::atomic<T> value{0};
+  };
+  static_assert(std::atomic<T>::is_always_lock_free);
+
+  // Pick a shard from the stack pointer of the calling thread: thread stacks are separate
+  // mappings of at least a few hundred KiB, so this spreads threads over the shards without
+  // the cost of thread-local storage or asking which CPU the thread runs on.
+  static size_t CurrentShard() {
+    uintptr_t stack_position = reinterpret_cast<uintptr_t>(__builtin_frame_address(0));
+    uint64_t hash = static_cast<uint64_t>(stack_position >> 18) * UINT64_C(0x9e3779b97f4a7c15);
+    return static_cast<size_t>(hash >> (BitSizeOf<uint64_t>() - WhichPowerOf2(kNumShards)));
+  }
+
+  std::array<Shard, kNumShards> shards_;
+};
+
+// A `MetricsCounter` for counters updated from many threads on hot paths, see `MetricsShards`.
+template <DatumId counter_type, typename T = uint64_t>
+class MetricsShardedCounter final : public MetricsBase<T> {
+ public:
+  using value_t = T;
+
+  constexpr MetricsShardedCounter() {}
+
+  void AddOne() { Add(1u); }
+  void Add(value_t value) override { shards_.Add(value); }
+
+  // Sums the shards, see `MetricsCounter::Value()`.
+  value_t Value() const { return shards_.Sum(); }
+
+  void Report(const std::vector<MetricsBackend*>& backends) const {
+    for (MetricsBackend* backend : backends) {
+      backend->ReportCounter(counter_type, Value());
+    }
+  }
+
+ protected:
+  void Reset() { shards_.Reset(); }
+
+ private:
+  bool IsNull() const override { return Value() == 0; }
+
+  MetricsShards<value_t> shards_;
+
+  friend class ArtMetrics;
+};
+
+// A `MetricsDeltaCounter` for counters updated from many threads on hot paths, see
+// `MetricsShards`.
+template <DatumId datum_id, typename T = uint64_t>
+class MetricsShardedDeltaCounter final : public MetricsBase<T> {
+ public:
+  using value_t = T;
+
+  constexpr MetricsShardedDeltaCounter() {}
+
+  void Add(value_t value) override { shards_.Add(value); }
+  void AddOne() { Add(1u); }
+
+  void ReportAndReset(const std::vector<MetricsBackend*>& backends) {
+    value_t value = shards_.SumAndReset();
+    for (MetricsBackend* backend : backends) {
+      backend->ReportCounter(datum_id, value);
+    }
+  }
+
+  void Reset() { shards_.Reset(); }
+
+ private:
+  value_t Value() const { return shards_.Sum(); }
+
+  bool IsNull() const override { return Value() == 0; }
+
+  MetricsShards<value_t> shards_;
+
+  friend class ArtMetrics;
+};
+
 template <DatumId histogram_type_,
           size_t num_buckets_,
           int64_t minimum_value_,
@@ -132,6 +132,42 @@ TEST_F(MetricsTest, AverageMetric) {
   EXPECT_EQ(CounterValue(avg), (kMaxValue + 1) / 2);
 }
 
+TEST_F(MetricsTest, ShardedCounter) {
+  MetricsShardedCounter<DatumId::kTotalBytesAllocated> counter;
+  MetricsShardedDeltaCounter<DatumId::kTotalBytesAllocatedDelta> delta_counter;
+
+  std::vector<std::thread> threads;
+
+  constexpr uint64_t kNumThreads = 32;
+  constexpr uint64_t kNumAdds = 1000;
+
+  for (uint64_t i = 0; i != kNumThreads; i++) {
+    threads.emplace_back(std::thread{[&counter, &delta_counter, i]() {
+      for (uint64_t j = 0; j != kNumAdds; j++) {
+        counter.Add(i);
+        delta_counter.AddOne();
+      }
+    }});
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(CounterValue(counter), kNumAdds * kNumThreads * (kNumThreads - 1) / 2);
+
+  uint64_t delta_value = 0;
+  struct DeltaBackend : public TestBackendBase {
+    explicit DeltaBackend(uint64_t* value) : value_{value} {}
+    void ReportCounter(DatumId, uint64_t value) override { *value_ = value; }
+    uint64_t* value_;
+  } delta_backend{&delta_value};
+  delta_counter.ReportAndReset({&delta_backend});
+  EXPECT_EQ(delta_value, kNumAdds * kNumThreads);
+  delta_counter.ReportAndReset({&delta_backend});
+  EXPECT_EQ(delta_value, 0u);
+}
+
 TEST_F(MetricsTest, DatumName) {
   EXPECT_EQ("ClassVerificationTotalTime", DatumName(DatumId::kClassVerificationTotalTime));
 }
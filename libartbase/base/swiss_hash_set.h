@@ -0,0 +1,623 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_LIBARTBASE_BASE_SWISS_HASH_SET_H_
+#define ART_LIBARTBASE_BASE_SWISS_HASH_SET_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include <android-base/logging.h>
+
+#include "bit_utils.h"
+#include "hash_set.h"
+#include "macros.h"
+
+namespace art {
+
+namespace detail {
+
+// Control byte of a free slot. A slot holding an element has the top 7 bits of the mixed hash of
+// the element as its control byte, so free slots are the ones with the top bit set.
+static constexpr uint8_t kSwissCtrlEmpty = 0x80u;
+static constexpr uint8_t kSwissCtrlDeleted = 0xfeu;
+
+// Slots of a group matching a probe, as a bit mask with `1 << kShift` bits per slot.
+template <size_t kShift>
+class SwissGroupMask {
+ public:
+  explicit SwissGroupMask(uint64_t mask) : mask_(mask) {}
+
+  bool HasAny() const {
+    return mask_ != 0u;
+  }
+
+  // The index in the group of the first matching slot.
+  size_t Lowest() const {
+    DCHECK(HasAny());
+    return static_cast<size_t>(CTZ(mask_)) >> kShift;
+  }
+
+  void ClearLowest() {
+    mask_ &= mask_ - 1u;
+  }
+
+ private:
+  uint64_t mask_;
+};
+
+// The control bytes of a group of consecutive slots, probed together.
+#if defined(__SSE2__)
+class SwissGroup {
+ public:
+  static constexpr size_t kWidth = 16u;
+  using Mask = SwissGroupMask<0u>;
+
+  explicit SwissGroup(const uint8_t* ctrl)
+      : ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))) {}
+
+  Mask Match(uint8_t h2) const {
+    __m128i match = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(h2)), ctrl_);
+    return Mask(static_cast<uint32_t>(_mm_movemask_epi8(match)));
+  }
+
+  Mask MatchEmpty() const {
+    return Match(kSwissCtrlEmpty);
+  }
+
+  Mask MatchEmptyOrDeleted() const {
+    return Mask(static_cast<uint32_t>(_mm_movemask_epi8(ctrl_)));
+  }
+
+ private:
+  __m128i ctrl_;
+};
+#else
+// Eight control bytes in a 64-bit word, with the match of a slot in the top bit of its byte.
+// Uses NEON compares where available and plain integer operations otherwise. ART only supports
+// little-endian targets, so the first slot of the group is the least significant byte.
+class SwissGroup {
+ public:
+  static constexpr size_t kWidth = 8u;
+  using Mask = SwissGroupMask<3u>;
+
+  explicit SwissGroup(const uint8_t* ctrl) {
+    memcpy(&ctrl_, ctrl, sizeof(ctrl_));
+  }
+
+  // May report a slot that does not match after a slot that does, the element comparison of
+  // the caller rejects these. Never reports a free slot.
+  Mask Match(uint8_t h2) const {
+#if defined(__ARM_NEON)
+    uint8x8_t match = vceq_u8(vdup_n_u8(h2), vcreate_u8(ctrl_));
+    return Mask(vget_lane_u64(vreinterpret_u64_u8(match), 0) & kMsbs);
+#else
+    uint64_t x = ctrl_ ^ (kLsbs * h2);
+    return Mask((x - kLsbs) & ~x & kMsbs);
+#endif
+  }
+
+  Mask MatchEmpty() const {
+    // Empty is the only free control byte with bit 1 clear.
+    return Mask(ctrl_ & ~(ctrl_ << 6) & kMsbs);
+  }
+
+  Mask MatchEmptyOrDeleted() const {
+    return Mask(ctrl_ & kMsbs);
+  }
+
+ private:
+  static constexpr uint64_t kLsbs = UINT64_C(0x0101010101010101);
+  static constexpr uint64_t kMsbs = UINT64_C(0x8080808080808080);
+
+  uint64_t ctrl_;
+};
+#endif
+
+}  // namespace detail
+
+// Open addressing hash set with a separate array of control bytes, one per slot. Lookups compare
+// a 7-bit fragment of the hash with a whole group of control bytes at once and only compare the
+// elements whose fragment matches, so a miss usually costs one group probe instead of a walk of
+// the collision chain with an element comparison per slot.
+//
+// The template interface is the one of HashSet<> so that a user can switch a set by changing its
+// type. Differences: the maximum load factor is fixed at 7/8, erase() never moves elements, and
+// there is no support for preallocated buffers or WriteToMemory(). EmptyFn is not used, elements
+// are only constructed in slots that hold one.
+template <class T,
+          class EmptyFn = DefaultEmptyFn<T>,
+          class HashFn = DefaultHashFn<T>,
+          class Pred = DefaultPred<T>,
+          class Alloc = std::allocator<T>>
+class SwissHashSet {
+ public:
+  using value_type = T;
+  using allocator_type = Alloc;
+  using reference = T&;
+  using const_reference = const T&;
+  using pointer = T*;
+  using const_pointer = const T*;
+  using iterator = HashSetIterator<T, SwissHashSet>;
+  using const_iterator = HashSetIterator<const T, const SwissHashSet>;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+
+  static constexpr size_t kGroupWidth = detail::SwissGroup::kWidth;
+
+  void clear() {
+    DeallocateStorage();
+    num_elements_ = 0u;
+    growth_left_ = 0u;
+  }
+
+  SwissHashSet() : SwissHashSet(HashFn(), Pred()) {}
+  explicit SwissHashSet(const allocator_type& alloc) noexcept
+      : SwissHashSet(HashFn(), Pred(), alloc) {}
+
+  SwissHashSet(const HashFn& hashfn, const Pred& pred) noexcept
+      : SwissHashSet(hashfn, pred, allocator_type()) {}
+  SwissHashSet(const HashFn& hashfn, const Pred& pred, const allocator_type& alloc) noexcept
+      : allocfn_(alloc),
+        hashfn_(hashfn),
+        pred_(pred),
+        num_elements_(0u),
+        num_buckets_(0u),
+        growth_left_(0u),
+        ctrl_(nullptr),
+        data_(nullptr) {}
+
+  SwissHashSet(const SwissHashSet& other)
+      : allocfn_(other.allocfn_),
+        hashfn_(other.hashfn_),
+        pred_(other.pred_),
+        num_elements_(other.num_elements_),
+        num_buckets_(0u),
+        growth_left_(other.growth_left_),
+        ctrl_(nullptr),
+        data_(nullptr) {
+    if (other.num_buckets_ != 0u) {
+      AllocateStorage(other.num_buckets_);
+      memcpy(ctrl_, other.ctrl_, num_buckets_);
+      for (size_t i = 0; i != num_buckets_; ++i) {
+        if (!IsFreeSlot(i)) {
+          AllocTraits::construct(allocfn_, &data_[i], other.data_[i]);
+        }
+      }
+    }
+  }
+
+  SwissHashSet(SwissHashSet&& other) noexcept
+      : allocfn_(std::move(other.allocfn_)),
+        hashfn_(std::move(other.hashfn_)),
+        pred_(std::move(other.pred_)),
+        num_elements_(other.num_elements_),
+        num_buckets_(other.num_buckets_),
+        growth_left_(other.growth_left_),
+        ctrl_(other.ctrl_),
+        data_(other.data_) {
+    other.num_elements_ = 0u;
+    other.num_buckets_ = 0u;
+    other.growth_left_ = 0u;
+    other.ctrl_ = nullptr;
+    other.data_ = nullptr;
+  }
+
+  ~SwissHashSet() {
+    DeallocateStorage();
+  }
+
+  SwissHashSet& operator=(SwissHashSet&& other) noexcept {
+    SwissHashSet(std::move(other)).swap(*this);  // NOLINT [runtime/explicit] [5]
+    return *this;
+  }
+
+  SwissHashSet& operator=(const SwissHashSet& other) {
+    SwissHashSet(other).swap(*this);  // NOLINT(runtime/explicit)
+    return *this;
+  }
+
+  iterator begin() {
+    iterator ret(this, 0);
+    if (num_buckets_ != 0 && IsFreeSlot(ret.index_)) {
+      ++ret;  // Skip all the empty slots.
+    }
+    return ret;
+  }
+
+  const_iterator begin() const {
+    const_iterator ret(this, 0);
+    if (num_buckets_ != 0 && IsFreeSlot(ret.index_)) {
+      ++ret;  // Skip all the empty slots.
+    }
+    return ret;
+  }
+
+  iterator end() {
+    return iterator(this, NumBuckets());
+  }
+
+  const_iterator end() const {
+    return const_iterator(this, NumBuckets());
+  }
+
+  size_t size() const {
+    return num_elements_;
+  }
+
+  bool empty() const {
+    return size() == 0;
+  }
+
+  // Erase the element and return an iterator to the next one. Lookups stop at the first group
+  // with an empty slot, so the slot can only become empty again if its group already has one.
+  // Otherwise it is marked deleted, and deleted slots are dropped when the set is rehashed.
+  iterator erase(iterator it) {
+    size_t index = it.index_;
+    DCHECK(!IsFreeSlot(index));
+    AllocTraits::destroy(allocfn_, &data_[index]);
+    size_t group_start = index & ~(kGroupWidth - 1u);
+    if (detail::SwissGroup(ctrl_ + group_start).MatchEmpty().HasAny()) {
+      ctrl_[index] = detail::kSwissCtrlEmpty;
+      ++growth_left_;
+    } else {
+      ctrl_[index] = detail::kSwissCtrlDeleted;
+    }
+    --num_elements_;
+    ++it;
+    return it;
+  }
+
+  // Find an element, returns end() if not found. Allows custom key (K) types like HashSet<>.
+  template <typename K>
+  iterator find(const K& key) {
+    return FindWithHash(key, hashfn_(key));
+  }
+
+  template <typename K>
+  const_iterator find(const K& key) const {
+    return FindWithHash(key, hashfn_(key));
+  }
+
+  template <typename K>
+  iterator FindWithHash(const K& key, size_t hash) {
+    return iterator(this, FindIndex(key, hash));
+  }
+
+  template <typename K>
+  const_iterator FindWithHash(const K& key, size_t hash) const {
+    return const_iterator(this, FindIndex(key, hash));
+  }
+
+  std::pair<iterator, bool> insert([[maybe_unused]] const_iterator hint, const T& element) {
+    return insert(element);
+  }
+  std::pair<iterator, bool> insert([[maybe_unused]] const_iterator hint, T&& element) {
+    return insert(std::move(element));
+  }
+
+  std::pair<iterator, bool> insert(const T& element) {
+    return InsertWithHash(element, hashfn_(element));
+  }
+  std::pair<iterator, bool> insert(T&& element) {
+    return InsertWithHash(std::move(element), hashfn_(element));
+  }
+
+  template <typename U, typename = std::enable_if_t<std::is_convertible_v<U, T>>>
+  std::pair<iterator, bool> InsertWithHash(U&& element, size_t hash) {
+    size_t index = FindIndex(element, hash);
+    if (index != NumBuckets()) {
+      return std::make_pair(iterator(this, index), false);
+    }
+    index = PutWithHashImpl(std::forward<U>(element), hash);
+    return std::make_pair(iterator(this, index), true);
+  }
+
+  // Insert an element known not to be in the set.
+  void Put(const T& element) {
+    return PutWithHash(element, hashfn_(element));
+  }
+  void Put(T&& element) {
+    return PutWithHash(std::move(element), hashfn_(element));
+  }
+
+  template <typename U, typename = std::enable_if_t<std::is_convertible_v<U, T>>>
+  void PutWithHash(U&& element, size_t hash) {
+    DCHECK_EQ(FindIndex(element, hash), NumBuckets());
+    PutWithHashImpl(std::forward<U>(element), hash);
+  }
+
+  void swap(SwissHashSet& other) {
+    // Use argument-dependent lookup with fall-back to std::swap() for function objects.
+    using std::swap;
+    swap(allocfn_, other.allocfn_);
+    swap(hashfn_, other.hashfn_);
+    swap(pred_, other.pred_);
+    std::swap(num_elements_, other.num_elements_);
+    std::swap(num_buckets_, other.num_buckets_);
+    std::swap(growth_left_, other.growth_left_);
+    std::swap(ctrl_, other.ctrl_);
+    std::swap(data_, other.data_);
+  }
+
+  allocator_type get_allocator() const {
+    return allocfn_;
+  }
+
+  void ShrinkToMaximumLoad() {
+    if (empty()) {
+      clear();
+    } else {
+      Resize(NumBucketsFor(size()));
+    }
+  }
+
+  // Reserve enough room to insert until size() == num_elements without requiring to grow the
+  // hash set. No-op if the hash set is already large enough to do this.
+  void reserve(size_t num_elements) {
+    if (num_elements > size() && num_elements - size() > growth_left_) {
+      Resize(std::max(NumBucketsFor(num_elements), NumBuckets()));
+    }
+  }
+
+  // Total number of groups that lookups of the elements probe before the group that holds the
+  // element. Used for measuring how good hash functions are.
+  size_t TotalProbeDistance() const {
+    size_t total = 0;
+    for (size_t i = 0; i != NumBuckets(); ++i) {
+      if (!IsFreeSlot(i)) {
+        size_t group = GroupForHash(MixHash(hashfn_(data_[i])));
+        for (size_t step = 1; group != i / kGroupWidth; ++step) {
+          group = NextGroup(group, step);
+          ++total;
+        }
+      }
+    }
+    return total;
+  }
+
+  // Calculate the current load factor and return it.
+  double CalculateLoadFactor() const {
+    return static_cast<double>(size()) / static_cast<double>(NumBuckets());
+  }
+
+  size_t NumBuckets() const {
+    return num_buckets_;
+  }
+
+ private:
+  using AllocTraits = std::allocator_traits<Alloc>;
+  using CtrlAlloc = typename AllocTraits::template rebind_alloc<uint8_t>;
+
+  // Maximum number of elements and deleted slots for a number of buckets, load factor 7/8.
+  static size_t MaxElements(size_t num_buckets) {
+    return num_buckets - num_buckets / 8u;
+  }
+
+  static size_t NumBucketsFor(size_t num_elements) {
+    size_t num_buckets = kGroupWidth;
+    while (MaxElements(num_buckets) < num_elements) {
+      num_buckets *= 2u;
+    }
+    return num_buckets;
+  }
+
+  // The hash functions of many sets return the value or its address, mix the bits so that
+  // both the group index and the control byte depend on all of them.
+  static uint64_t MixHash(size_t hash) {
+    uint64_t mixed = static_cast<uint64_t>(hash) * UINT64_C(0x9e3779b97f4a7c15);
+    return mixed ^ (mixed >> 32);
+  }
+
+  static uint8_t ControlByteForHash(uint64_t mixed) {
+    return static_cast<uint8_t>(mixed >> 57);
+  }
+
+  size_t GroupForHash(uint64_t mixed) const {
+    return static_cast<size_t>(mixed) & (NumGroups() - 1u);
+  }
+
+  // Triangular probing, which visits each group once as the number of groups is a power of two.
+  size_t NextGroup(size_t group, size_t step) const {
+    return (group + step) & (NumGroups() - 1u);
+  }
+
+  size_t NumGroups() const {
+    return num_buckets_ / kGroupWidth;
+  }
+
+  T& ElementForIndex(size_t index) {
+    DCHECK_LT(index, NumBuckets());
+    DCHECK(!IsFreeSlot(index));
+    return data_[index];
+  }
+
+  const T& ElementForIndex(size_t index) const {
+    DCHECK_LT(index, NumBuckets());
+    DCHECK(!IsFreeSlot(index));
+    return data_[index];
+  }
+
+  bool IsFreeSlot(size_t index) const {
+    return (ctrl_[index] & detail::kSwissCtrlEmpty) != 0u;
+  }
+
+  // Find the slot of an element, or return NumBuckets() if not found.
+  template <typename K>
+  ALWAYS_INLINE
+  size_t FindIndex(const K& key, size_t hash) const {
+    DCHECK_EQ(hashfn_(key), hash);
+    if (UNLIKELY(num_elements_ == 0u)) {
+      return NumBuckets();
+    }
+    uint64_t mixed = MixHash(hash);
+    uint8_t h2 = ControlByteForHash(mixed);
+    size_t group = GroupForHash(mixed);
+    for (size_t step = 1; ; ++step) {
+      DCHECK_LE(step, NumGroups());
+      detail::SwissGroup probe(ctrl_ + group * kGroupWidth);
+      for (auto match = probe.Match(h2); match.HasAny(); match.ClearLowest()) {
+        size_t index = group * kGroupWidth + match.Lowest();
+        if (LIKELY(pred_(data_[index], key))) {
+          return index;
+        }
+      }
+      if (LIKELY(probe.MatchEmpty().HasAny())) {
+        return NumBuckets();
+      }
+      group = NextGroup(group, step);
+    }
+  }
+
+  // Find the first free slot in the probe sequence of a hash. There is always an empty slot as
+  // elements and deleted slots never exceed the maximum load.
+  size_t FindInsertSlot(uint64_t mixed) const {
+    size_t group = GroupForHash(mixed);
+    for (size_t step = 1; ; ++step) {
+      DCHECK_LE(step, NumGroups());
+      auto match = detail::SwissGroup(ctrl_ + group * kGroupWidth).MatchEmptyOrDeleted();
+      if (match.HasAny()) {
+        return group * kGroupWidth + match.Lowest();
+      }
+      group = NextGroup(group, step);
+    }
+  }
+
+  template <typename U>
+  size_t PutWithHashImpl(U&& element, size_t hash) {
+    DCHECK_EQ(hash, hashfn_(element));
+    uint64_t mixed = MixHash(hash);
+    size_t index = (num_buckets_ != 0u) ? FindInsertSlot(mixed) : 0u;
+    // Reusing a deleted slot does not change the load.
+    if (num_buckets_ == 0u ||
+        (growth_left_ == 0u && ctrl_[index] != detail::kSwissCtrlDeleted)) {
+      Grow();
+      index = FindInsertSlot(mixed);
+    }
+    if (ctrl_[index] == detail::kSwissCtrlEmpty) {
+      DCHECK_NE(growth_left_, 0u);
+      --growth_left_;
+    }
+    ctrl_[index] = ControlByteForHash(mixed);
+    AllocTraits::construct(allocfn_, &data_[index], std::forward<U>(element));
+    ++num_elements_;
+    return index;
+  }
+
+  void Grow() {
+    if (num_buckets_ == 0u) {
+      Resize(kGroupWidth);
+    } else if (num_elements_ <= MaxElements(num_buckets_) / 2u) {
+      // Mostly deleted slots, rehash in place to drop them.
+      Resize(num_buckets_);
+    } else {
+      Resize(num_buckets_ * 2u);
+    }
+  }
+
+  void AllocateStorage(size_t num_buckets) {
+    DCHECK(IsPowerOfTwo(num_buckets));
+    DCHECK_GE(num_buckets, kGroupWidth);
+    CtrlAlloc ctrl_alloc(allocfn_);
+    num_buckets_ = num_buckets;
+    ctrl_ = std::allocator_traits<CtrlAlloc>::allocate(ctrl_alloc, num_buckets);
+    memset(ctrl_, detail::kSwissCtrlEmpty, num_buckets);
+    data_ = AllocTraits::allocate(allocfn_, num_buckets);
+  }
+
+  void DeallocateStorage() {
+    if (num_buckets_ != 0u) {
+      for (size_t i = 0; i != num_buckets_; ++i) {
+        if (!IsFreeSlot(i)) {
+          AllocTraits::destroy(allocfn_, &data_[i]);
+        }
+      }
+      CtrlAlloc ctrl_alloc(allocfn_);
+      std::allocator_traits<CtrlAlloc>::deallocate(ctrl_alloc, ctrl_, num_buckets_);
+      AllocTraits::deallocate(allocfn_, data_, num_buckets_);
+    }
+    ctrl_ = nullptr;
+    data_ = nullptr;
+    num_buckets_ = 0u;
+  }
+
+  // Move the elements to new storage with `new_num_buckets` slots, dropping deleted slots.
+  void Resize(size_t new_num_buckets) {
+    DCHECK_LE(num_elements_, MaxElements(new_num_buckets));
+    uint8_t* const old_ctrl = ctrl_;
+    T* const old_data = data_;
+    const size_t old_num_buckets = num_buckets_;
+    AllocateStorage(new_num_buckets);
+    for (size_t i = 0; i != old_num_buckets; ++i) {
+      if ((old_ctrl[i] & detail::kSwissCtrlEmpty) == 0u) {
+        T& element = old_data[i];
+        uint64_t mixed = MixHash(hashfn_(element));
+        size_t index = FindInsertSlot(mixed);
+        ctrl_[index] = ControlByteForHash(mixed);
+        AllocTraits::construct(allocfn_, &data_[index], std::move(element));
+        AllocTraits::destroy(allocfn_, &element);
+      }
+    }
+    if (old_num_buckets != 0u) {
+      CtrlAlloc ctrl_alloc(allocfn_);
+      std::allocator_traits<CtrlAlloc>::deallocate(ctrl_alloc, old_ctrl, old_num_buckets);
+      AllocTraits::deallocate(allocfn_, old_data, old_num_buckets);
+    }
+    growth_left_ = MaxElements(num_buckets_) - num_elements_;
+  }
+
+  size_t NextNonEmptySlot(size_t index) const {
+    const size_t num_buckets = NumBuckets();
+    DCHECK_LT(index, num_buckets);
+    do {
+      ++index;
+    } while (index < num_buckets && IsFreeSlot(index));
+    return index;
+  }
+
+  Alloc allocfn_;  // Allocator function.
+  HashFn hashfn_;  // Hashing function.
+  Pred pred_;  // Equals function.
+  size_t num_elements_;  // Number of inserted elements.
+  size_t num_buckets_;  // Number of slots, a power of two and a multiple of kGroupWidth.
+  size_t growth_left_;  // Number of empty slots that can be filled before the set grows.
+  uint8_t* ctrl_;  // Control bytes, one per slot.
+  T* data_;  // Slots, only full ones hold a constructed element.
+
+  template <class Elem, class HashSetType>
+  friend class HashSetIterator;
+};
+
+template <class T, class EmptyFn, class HashFn, class Pred, class Alloc>
+void swap(SwissHashSet<T, EmptyFn, HashFn, Pred, Alloc>& lhs,
+          SwissHashSet<T, EmptyFn, HashFn, Pred, Alloc>& rhs) {
+  lhs.swap(rhs);
+}
+
+}  // namespace art
+
+#endif  // ART_LIBARTBASE_BASE_SWISS_HASH_SET_H_
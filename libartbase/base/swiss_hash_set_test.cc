@@ -0,0 +1,249 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "swiss_hash_set.h"
+
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "hash_set.h"
+
+namespace art {
+
+class SwissHashSetTest : public testing::Test {
+ public:
+  SwissHashSetTest() : seed_(97421), unique_number_(0) {
+  }
+  std::string RandomString(size_t len) {
+    std::ostringstream oss;
+    for (size_t i = 0; i < len; ++i) {
+      oss << static_cast<char>('A' + PRand() % 64);
+    }
+    oss << " " << unique_number_++;
+    return oss.str();
+  }
+  void SetSeed(size_t seed) {
+    seed_ = seed;
+  }
+  size_t PRand() {  // Pseudo random.
+    seed_ = seed_ * 1103515245 + 12345;
+    return seed_;
+  }
+
+ private:
+  size_t seed_;
+  size_t unique_number_;
+};
+
+TEST_F(SwissHashSetTest, TestSmoke) {
+  SwissHashSet<std::string> hash_set;
+  const std::string test_string = "hello world 1234";
+  ASSERT_TRUE(hash_set.empty());
+  ASSERT_EQ(hash_set.size(), 0U);
+  ASSERT_TRUE(hash_set.find(test_string) == hash_set.end());
+  hash_set.insert(test_string);
+  auto it = hash_set.find(test_string);
+  ASSERT_EQ(*it, test_string);
+  auto after_it = hash_set.erase(it);
+  ASSERT_TRUE(after_it == hash_set.end());
+  ASSERT_TRUE(hash_set.empty());
+  ASSERT_EQ(hash_set.size(), 0U);
+  it = hash_set.find(test_string);
+  ASSERT_TRUE(it == hash_set.end());
+}
+
+TEST_F(SwissHashSetTest, TestInsertAndErase) {
+  SwissHashSet<std::string> hash_set;
+  static constexpr size_t count = 1000;
+  std::vector<std::string> strings;
+  for (size_t i = 0; i < count; ++i) {
+    strings.push_back(RandomString(10));
+    auto [it, inserted] = hash_set.insert(strings[i]);
+    ASSERT_TRUE(inserted);
+    ASSERT_EQ(*it, strings[i]);
+    ASSERT_FALSE(hash_set.insert(strings[i]).second);
+  }
+  ASSERT_EQ(strings.size(), hash_set.size());
+  for (size_t i = 1; i < count; i += 2) {
+    auto it = hash_set.find(strings[i]);
+    ASSERT_TRUE(it != hash_set.end());
+    hash_set.erase(it);
+  }
+  for (size_t i = 0; i < count; ++i) {
+    auto it = hash_set.find(strings[i]);
+    ASSERT_EQ(it == hash_set.end(), i % 2 == 1);
+  }
+  // Erasing every element must leave a set that can be filled again.
+  for (auto it = hash_set.begin(); it != hash_set.end();) {
+    it = hash_set.erase(it);
+  }
+  ASSERT_TRUE(hash_set.empty());
+  for (size_t i = 0; i < count; ++i) {
+    hash_set.Put(strings[i]);
+  }
+  ASSERT_EQ(strings.size(), hash_set.size());
+}
+
+TEST_F(SwissHashSetTest, TestIterator) {
+  SwissHashSet<std::string> hash_set;
+  ASSERT_TRUE(hash_set.begin() == hash_set.end());
+  static constexpr size_t count = 1000;
+  std::vector<std::string> strings;
+  for (size_t i = 0; i < count; ++i) {
+    strings.push_back(RandomString(10));
+    hash_set.insert(strings[i]);
+  }
+  size_t total_length = 0;
+  for (const std::string& s : hash_set) {
+    total_length += s.length();
+  }
+  size_t expected_length = 0;
+  for (const std::string& s : strings) {
+    expected_length += s.length();
+  }
+  ASSERT_EQ(total_length, expected_length);
+}
+
+TEST_F(SwissHashSetTest, TestCopyAndSwap) {
+  SwissHashSet<std::string> hash_seta, hash_setb;
+  std::vector<std::string> strings;
+  static constexpr size_t count = 1000;
+  for (size_t i = 0; i < count; ++i) {
+    strings.push_back(RandomString(10));
+    hash_seta.insert(strings[i]);
+  }
+  std::swap(hash_seta, hash_setb);
+  ASSERT_TRUE(hash_seta.empty());
+  ASSERT_EQ(hash_setb.size(), count);
+  SwissHashSet<std::string> hash_setc(hash_setb);
+  hash_setb.clear();
+  ASSERT_EQ(hash_setc.size(), count);
+  for (const std::string& s : strings) {
+    ASSERT_TRUE(hash_setc.find(s) != hash_setc.end());
+  }
+}
+
+TEST_F(SwissHashSetTest, TestReserveAndShrink) {
+  SwissHashSet<size_t> hash_set;
+  hash_set.reserve(1000u);
+  size_t num_buckets = hash_set.NumBuckets();
+  for (size_t i = 0; i != 1000u; ++i) {
+    hash_set.insert(i);
+  }
+  ASSERT_EQ(num_buckets, hash_set.NumBuckets());
+  ASSERT_LE(hash_set.CalculateLoadFactor(), 7.0 / 8.0);
+  for (size_t i = 0; i != 900u; ++i) {
+    hash_set.erase(hash_set.find(i));
+  }
+  hash_set.ShrinkToMaximumLoad();
+  ASSERT_LT(hash_set.NumBuckets(), num_buckets);
+  for (size_t i = 900u; i != 1000u; ++i) {
+    ASSERT_TRUE(hash_set.find(i) != hash_set.end());
+  }
+}
+
+TEST_F(SwissHashSetTest, TestStress) {
+  SwissHashSet<std::string> hash_set;
+  std::unordered_set<std::string> std_set;
+  std::vector<std::string> strings;
+  static constexpr size_t string_count = 2000;
+  static constexpr size_t operations = 100000;
+  static constexpr size_t target_size = 5000;
+  for (size_t i = 0; i < string_count; ++i) {
+    strings.push_back(RandomString(i % 10 + 1));
+  }
+  const size_t seed = time(nullptr);
+  SetSeed(seed);
+  LOG(INFO) << "Starting stress test with seed " << seed;
+  for (size_t i = 0; i < operations; ++i) {
+    ASSERT_EQ(hash_set.size(), std_set.size());
+    size_t delta = std::abs(static_cast<ssize_t>(target_size) -
+                            static_cast<ssize_t>(hash_set.size()));
+    size_t n = PRand();
+    if (n % target_size == 0) {
+      hash_set.clear();
+      std_set.clear();
+    } else if (n % target_size < delta) {
+      const std::string& s = strings[PRand() % string_count];
+      hash_set.insert(s);
+      std_set.insert(s);
+      ASSERT_EQ(*hash_set.find(s), *std_set.find(s));
+    } else {
+      const std::string& s = strings[PRand() % string_count];
+      auto it1 = hash_set.find(s);
+      auto it2 = std_set.find(s);
+      ASSERT_EQ(it1 == hash_set.end(), it2 == std_set.end());
+      if (it1 != hash_set.end()) {
+        ASSERT_EQ(*it1, *it2);
+        hash_set.erase(it1);
+        std_set.erase(it2);
+      }
+    }
+  }
+}
+
+TEST_F(SwissHashSetTest, TestLookupByAlternateKeyType) {
+  SwissHashSet<std::string> hash_set;
+  hash_set.insert("Lcom/example/Foo;");
+  ASSERT_TRUE(hash_set.find(std::string_view("Lcom/example/Foo;")) != hash_set.end());
+  ASSERT_TRUE(hash_set.find(std::string_view("Lcom/example/Bar;")) == hash_set.end());
+}
+
+// Compare lookups of class descriptors with HashSet<>, mostly misses like the lookups in the
+// class tables of parent class loaders. Only checks the results, the times are logged.
+TEST_F(SwissHashSetTest, CompareDescriptorLookupsWithHashSet) {
+  static constexpr size_t kNumClasses = 20000u;
+  static constexpr size_t kNumLookups = 200000u;
+  std::vector<std::string> descriptors;
+  std::vector<std::string> missing;
+  for (size_t i = 0; i != kNumClasses; ++i) {
+    descriptors.push_back("Lcom/example/app" + std::to_string(i % 37) + "/Class" +
+                          std::to_string(i) + ";");
+    missing.push_back("Landroid/widget/View" + std::to_string(i) + ";");
+  }
+  HashSet<std::string> hash_set;
+  SwissHashSet<std::string> swiss_hash_set;
+  for (const std::string& descriptor : descriptors) {
+    hash_set.insert(descriptor);
+    swiss_hash_set.insert(descriptor);
+  }
+  auto time_lookups = [&](const auto& set) {
+    size_t found = 0u;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i != kNumLookups; ++i) {
+      const std::string& key = (i % 4u == 0u) ? descriptors[i % kNumClasses]
+                                              : missing[i % kNumClasses];
+      found += (set.find(key) != set.end()) ? 1u : 0u;
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::make_pair(found, std::chrono::duration<double, std::micro>(end - start).count());
+  };
+  auto [hash_set_found, hash_set_us] = time_lookups(hash_set);
+  auto [swiss_found, swiss_us] = time_lookups(swiss_hash_set);
+  ASSERT_EQ(hash_set_found, kNumLookups / 4u);
+  ASSERT_EQ(swiss_found, kNumLookups / 4u);
+  LOG(INFO) << "Descriptor lookups: HashSet " << hash_set_us << "us, load "
+            << hash_set.CalculateLoadFactor() << "; SwissHashSet " << swiss_us << "us, load "
+            << swiss_hash_set.CalculateLoadFactor();
+}
+
+}  // namespace art
@@ -21,6 +21,9 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 #include <vector>
 
 #include "android-base/stringprintf.h"
@@ -35,6 +38,11 @@ namespace art {
 // Log file contents and mmap info when mapping entries directly.
 static constexpr const bool kDebugZipMapDirectly = false;
 
+// Entries are inflated on several threads only when there is enough data to save more than
+// the cost of creating the threads.
+static constexpr size_t kMinParallelExtractionSize = 1 * MB;
+static constexpr size_t kMaxExtractionThreads = 4u;
+
 using android::base::StringPrintf;
 
 uint32_t ZipEntry::GetUncompressedLength() {
@@ -304,6 +312,53 @@ ZipEntry* ZipArchive::Find(const char* name, std::string* error_msg) const {
   return new ZipEntry(handle_, zip_entry.release(), name);
 }
 
+std::vector<MemMap> ZipArchive::ExtractToMemMaps(const std::vector<ZipEntry*>& entries,
+                                                 const char* zip_filename) const {
+  size_t total_size = 0u;
+#ifdef __linux__
+  const int zip_fd = GetFileDescriptor(handle_);
+#endif
+  for (ZipEntry* entry : entries) {
+    DCHECK_EQ(entry->handle_, handle_);
+    total_size += entry->GetUncompressedLength();
+#ifdef __linux__
+    // Start reading all compressed data now rather than one entry at a time as it is inflated.
+    if (zip_fd >= 0) {
+      posix_fadvise(zip_fd,
+                    entry->zip_entry_->offset,
+                    entry->zip_entry_->compressed_length,
+                    POSIX_FADV_WILLNEED);
+    }
+#endif
+  }
+
+  std::vector<MemMap> maps(entries.size());
+  std::atomic<size_t> next_entry(0u);
+  auto extract_entries = [&]() {
+    for (size_t i = next_entry.fetch_add(1u, std::memory_order_relaxed);
+         i < entries.size();
+         i = next_entry.fetch_add(1u, std::memory_order_relaxed)) {
+      std::string error_msg;
+      maps[i] = entries[i]->ExtractToMemMap(zip_filename, entries[i]->entry_name_.c_str(),
+                                            &error_msg);
+    }
+  };
+  size_t num_threads = std::min<size_t>(
+      {std::thread::hardware_concurrency(), kMaxExtractionThreads, entries.size()});
+  std::vector<std::thread> threads;
+  if (total_size >= kMinParallelExtractionSize && num_threads > 1u) {
+    threads.reserve(num_threads - 1u);
+    for (size_t i = 1u; i != num_threads; ++i) {
+      threads.emplace_back(extract_entries);
+    }
+  }
+  extract_entries();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  return maps;
+}
+
 ZipArchive::~ZipArchive() {
   CloseArchive(handle_);
 }
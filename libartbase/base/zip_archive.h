@@ -20,6 +20,7 @@
 #include <stdint.h>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <android-base/logging.h>
 
@@ -100,6 +101,13 @@ class ZipArchive {
 
   ZipEntry* Find(const char* name, std::string* error_msg) const;
 
+  // Extracts the `entries` of this archive to anonymous memory like `ZipEntry::ExtractToMemMap()`,
+  // first asking the kernel to read ahead their compressed data and then inflating several
+  // entries in parallel. Returns one MemMap per entry, in order; the MemMap is invalid for each
+  // entry that failed to extract, callers that need the error can retry with `ExtractToMemMap()`.
+  std::vector<MemMap> ExtractToMemMaps(const std::vector<ZipEntry*>& entries,
+                                       const char* zip_filename) const;
+
   ~ZipArchive();
 
  private:
@@ -21,6 +21,7 @@
 #include <sys/types.h>
 #include <zlib.h>
 #include <memory>
+#include <vector>
 
 #include "base/common_art_test.h"
 #include "file_utils.h"
@@ -64,4 +65,28 @@ TEST_F(ZipArchiveTest, FindAndExtract) {
   EXPECT_EQ(zip_entry->GetCrc32(), computed_crc);
 }
 
+TEST_F(ZipArchiveTest, ExtractToMemMaps) {
+  std::string error_msg;
+  std::string zip_filename = GetLibCoreDexFileNames()[0];
+  std::unique_ptr<ZipArchive> zip_archive(ZipArchive::Open(zip_filename.c_str(), &error_msg));
+  ASSERT_TRUE(zip_archive.get() != nullptr) << error_msg;
+  // Extract the same entry several times to have enough data for parallel extraction.
+  static constexpr size_t kNumEntries = 8u;
+  std::vector<std::unique_ptr<ZipEntry>> zip_entries;
+  std::vector<ZipEntry*> entries;
+  for (size_t i = 0; i != kNumEntries; ++i) {
+    zip_entries.emplace_back(zip_archive->Find("classes.dex", &error_msg));
+    ASSERT_TRUE(zip_entries.back() != nullptr) << error_msg;
+    entries.push_back(zip_entries.back().get());
+  }
+  std::vector<MemMap> maps = zip_archive->ExtractToMemMaps(entries, zip_filename.c_str());
+  ASSERT_EQ(kNumEntries, maps.size());
+  for (size_t i = 0; i != kNumEntries; ++i) {
+    ASSERT_TRUE(maps[i].IsValid());
+    ASSERT_EQ(entries[i]->GetUncompressedLength(), maps[i].Size());
+    uint32_t computed_crc = crc32(crc32(0L, Z_NULL, 0), maps[i].Begin(), maps[i].Size());
+    EXPECT_EQ(entries[i]->GetCrc32(), computed_crc);
+  }
+}
+
 }  // namespace art
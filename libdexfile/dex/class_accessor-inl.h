@@ -64,8 +64,11 @@ inline ClassAccessor::ClassAccessor(const DexFile& dex_file,
 }
 
 inline void ClassAccessor::Method::Read() {
-  index_ += DecodeUnsignedLeb128(&ptr_pos_);
-  access_flags_ = DecodeUnsignedLeb128(&ptr_pos_);
+  // The index delta and, except for constructors, the access flags usually fit in one byte.
+  uint32_t index_delta_and_access_flags[2];
+  DecodeUnsignedLeb128s<2u>(&ptr_pos_, index_delta_and_access_flags);
+  index_ += index_delta_and_access_flags[0];
+  access_flags_ = index_delta_and_access_flags[1];
   code_off_ = DecodeUnsignedLeb128(&ptr_pos_);
   if (hiddenapi_ptr_pos_ != nullptr) {
     hiddenapi_flags_ = DecodeUnsignedLeb128(&hiddenapi_ptr_pos_);
@@ -79,8 +82,10 @@ inline MethodReference ClassAccessor::Method::GetReference() const {
 
 
 inline void ClassAccessor::Field::Read() {
-  index_ += DecodeUnsignedLeb128(&ptr_pos_);
-  access_flags_ = DecodeUnsignedLeb128(&ptr_pos_);
+  uint32_t index_delta_and_access_flags[2];
+  DecodeUnsignedLeb128s<2u>(&ptr_pos_, index_delta_and_access_flags);
+  index_ += index_delta_and_access_flags[0];
+  access_flags_ = index_delta_and_access_flags[1];
   if (hiddenapi_ptr_pos_ != nullptr) {
     hiddenapi_flags_ = DecodeUnsignedLeb128(&hiddenapi_ptr_pos_);
     DCHECK(hiddenapi::ApiList(hiddenapi_flags_).IsValid());
@@ -22,13 +22,17 @@
 #include <string.h>
 #include <zlib.h>
 
+#include <algorithm>
 #include <memory>
 #include <optional>
 #include <ostream>
 #include <sstream>
+#include <thread>
 #include <type_traits>
+#include <vector>
 
 #include "android-base/stringprintf.h"
+#include "base/bit_utils.h"
 #include "base/enums.h"
 #include "base/hiddenapi_domain.h"
 #include "base/leb128.h"
@@ -70,8 +74,41 @@ uint32_t DexFile::CalculateChecksum(const uint8_t* begin, size_t size) {
   return ChecksumMemoryRange(begin + non_sum_bytes, size - non_sum_bytes);
 }
 
+// Ranges of at least this size are checksummed in chunks on several threads, which saves more
+// than the cost of creating the threads.
+static constexpr size_t kMinParallelChecksumSize = 2 * MB;
+static constexpr size_t kMaxChecksumThreads = 4u;
+
 uint32_t DexFile::ChecksumMemoryRange(const uint8_t* begin, size_t size) {
-  return adler32(adler32(0L, Z_NULL, 0), begin, size);
+  const uLong initial = adler32(0L, Z_NULL, 0);
+  size_t num_threads = std::min<size_t>(std::thread::hardware_concurrency(), kMaxChecksumThreads);
+  if (size < kMinParallelChecksumSize || num_threads <= 1u) {
+    return adler32(initial, begin, size);
+  }
+  // The checksums of the chunks are combined into the checksum of the whole range, which is the
+  // same as computing it in one pass.
+  size_t chunk_size = RoundUp(size / num_threads, kPageSize);
+  std::vector<uLong> chunk_checksums(num_threads, initial);
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads - 1u);
+  for (size_t i = 1u; i != num_threads && i * chunk_size < size; ++i) {
+    threads.emplace_back([&, i]() {
+      size_t chunk_begin = i * chunk_size;
+      chunk_checksums[i] =
+          adler32(initial, begin + chunk_begin, std::min(chunk_size, size - chunk_begin));
+    });
+  }
+  chunk_checksums[0] = adler32(initial, begin, std::min(chunk_size, size));
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  uLong checksum = chunk_checksums[0];
+  for (size_t i = 1u; i != threads.size() + 1u; ++i) {
+    size_t chunk_begin = i * chunk_size;
+    checksum = adler32_combine(
+        checksum, chunk_checksums[i], std::min(chunk_size, size - chunk_begin));
+  }
+  return checksum;
 }
 
 bool DexFile::IsReadOnly() const {
@@ -22,6 +22,31 @@
 
 namespace art {
 
+size_t DexLayoutSections::MadviseAtLoad(const DexFile& dex_file) const {
+  size_t advised_bytes = 0u;
+  for (const DexLayoutSection& section : sections_) {
+    for (LayoutType type : {LayoutType::kLayoutTypeHot, LayoutType::kLayoutTypeStartupOnly}) {
+      const DexLayoutSection::Subsection& part = section.parts_[static_cast<size_t>(type)];
+      if (part.start_offset_ >= part.end_offset_ || part.end_offset_ > dex_file.DataSize()) {
+        continue;
+      }
+      // Reading a little more than the part does not hurt, so round the range outwards.
+      uint8_t* begin = AlignDown(const_cast<uint8_t*>(dex_file.DataBegin()) + part.start_offset_,
+                                 kPageSize);
+      uint8_t* end = AlignUp(const_cast<uint8_t*>(dex_file.DataBegin()) + part.end_offset_,
+                             kPageSize);
+#ifndef _WIN32
+      if (madvise(begin, end - begin, MADV_WILLNEED) != 0) {
+        PLOG(WARNING) << "Failed to madvise " << type << " part of " << dex_file.GetLocation();
+        continue;
+      }
+#endif
+      advised_bytes += end - begin;
+    }
+  }
+  return advised_bytes;
+}
+
 std::ostream& operator<<(std::ostream& os, const DexLayoutSection& section) {
   for (size_t i = 0; i < static_cast<size_t>(LayoutType::kLayoutTypeCount); ++i) {
     const DexLayoutSection::Subsection& part = section.parts_[i];
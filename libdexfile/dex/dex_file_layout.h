@@ -87,15 +87,21 @@ class DexLayoutSection {
   Subsection parts_[static_cast<size_t>(LayoutType::kLayoutTypeCount)];
 };
 
-// A set of dex layout sections, currently there is only one section for code and one for strings.
+// A set of dex layout sections, one for each kind of dex data that dexlayout orders by the profile.
 class DexLayoutSections {
  public:
   enum class SectionType : uint8_t {
     kSectionTypeCode,
     kSectionTypeStrings,
+    kSectionTypeClassData,
+    kSectionTypeStaticValues,
     kSectionCount,
   };
 
+  // Advise the kernel that the hot and startup only parts of the sections of `dex_file` are needed
+  // soon, so that reading them starts before the first access. Returns the number of bytes advised.
+  size_t MadviseAtLoad(const DexFile& dex_file) const;
+
   DexLayoutSection sections_[static_cast<size_t>(SectionType::kSectionCount)];
 };
 
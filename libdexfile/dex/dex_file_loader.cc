@@ -358,6 +358,8 @@ bool DexFileLoader::Open(bool verify,
       DCHECK(!error_msg->empty());
       return false;
     }
+    // Entries that failed to extract here are extracted again below to report the error.
+    std::vector<MemMap> extracted_maps = ExtractMultiDexEntries(*zip_archive);
     for (size_t i = 0;; ++i) {
       std::string name = GetMultiDexClassesDexName(i);
       std::string multidex_location = GetMultiDexLocation(i, location_.c_str());
@@ -366,6 +368,8 @@ bool DexFileLoader::Open(bool verify,
                                  multidex_location,
                                  verify,
                                  verify_checksum,
+                                 i < extracted_maps.size() ? std::move(extracted_maps[i])
+                                                           : MemMap::Invalid(),
                                  error_code,
                                  error_msg,
                                  dex_files);
@@ -464,11 +468,49 @@ std::unique_ptr<DexFile> DexFileLoader::OpenCommon(std::shared_ptr<DexFileContai
   return dex_file;
 }
 
+std::vector<MemMap> DexFileLoader::ExtractMultiDexEntries(const ZipArchive& zip_archive) const {
+  std::vector<std::unique_ptr<ZipEntry>> zip_entries;
+  std::vector<ZipEntry*> entries_to_extract;
+  for (size_t i = 0;; ++i) {
+    std::string error_msg;
+    std::unique_ptr<ZipEntry> zip_entry(
+        zip_archive.Find(GetMultiDexClassesDexName(i).c_str(), &error_msg));
+    if (zip_entry == nullptr) {
+      break;
+    }
+    // Uncompressed, aligned entries are mapped directly from the file by `OpenFromZipEntry()`.
+    bool map_directly = file_.has_value() &&
+                        zip_entry->IsUncompressed() &&
+                        zip_entry->IsAlignedTo(alignof(DexFile::Header));
+    if (!map_directly && zip_entry->GetUncompressedLength() != 0u) {
+      entries_to_extract.push_back(zip_entry.get());
+    }
+    zip_entries.push_back(std::move(zip_entry));
+  }
+  if (entries_to_extract.size() < 2u) {
+    return {};
+  }
+
+  DEXFILE_SCOPED_TRACE(std::string("Extract dex files ") + location_);
+  CHECK(MemMap::IsInitialized());
+  std::vector<MemMap> extracted_maps =
+      zip_archive.ExtractToMemMaps(entries_to_extract, location_.c_str());
+  std::vector<MemMap> maps(zip_entries.size());
+  for (size_t i = 0, j = 0; i != zip_entries.size() && j != entries_to_extract.size(); ++i) {
+    if (zip_entries[i].get() == entries_to_extract[j]) {
+      maps[i] = std::move(extracted_maps[j]);
+      ++j;
+    }
+  }
+  return maps;
+}
+
 bool DexFileLoader::OpenFromZipEntry(const ZipArchive& zip_archive,
                                      const char* entry_name,
                                      const std::string& location,
                                      bool verify,
                                      bool verify_checksum,
+                                     MemMap extracted_map,
                                      DexFileLoaderErrorCode* error_code,
                                      std::string* error_msg,
                                      std::vector<std::unique_ptr<const DexFile>>* dex_files) const {
@@ -485,9 +527,10 @@ bool DexFileLoader::OpenFromZipEntry(const ZipArchive& zip_archive,
   }
 
   CHECK(MemMap::IsInitialized());
-  MemMap map;
+  MemMap map = std::move(extracted_map);
+  DCHECK(!map.IsValid() || map.Size() == zip_entry->GetUncompressedLength());
   bool is_file_map = false;
-  if (file_.has_value() && zip_entry->IsUncompressed()) {
+  if (!map.IsValid() && file_.has_value() && zip_entry->IsUncompressed()) {
     if (!zip_entry->IsAlignedTo(alignof(DexFile::Header))) {
       // Do not mmap unaligned ZIP entries because
       // doing so would fail dex verification which requires 4 byte alignment.
@@ -284,12 +284,18 @@ class DexFileLoader {
                                              std::unique_ptr<DexFileContainer> container,
                                              VerifyResult* verify_result);
 
-  // Open .dex files from the entry_name in a zip archive.
+  // Extract the compressed classes*.dex entries of a zip archive in parallel. Returns the
+  // extracted entries by multidex index, or an empty vector if there are too few to be worth it.
+  std::vector<MemMap> ExtractMultiDexEntries(const ZipArchive& zip_archive) const;
+
+  // Open .dex files from the entry_name in a zip archive. If valid, `extracted_map` holds the
+  // already extracted contents of the entry.
   bool OpenFromZipEntry(const ZipArchive& zip_archive,
                         const char* entry_name,
                         const std::string& location,
                         bool verify,
                         bool verify_checksum,
+                        MemMap extracted_map,
                         DexFileLoaderErrorCode* error_code,
                         std::string* error_msg,
                         std::vector<std::unique_ptr<const DexFile>>* dex_files) const;
@@ -16,10 +16,13 @@
 
 #include "utf.h"
 
+#include <string.h>
+
 #include <android-base/logging.h>
 #include <android-base/stringprintf.h>
 #include <android-base/strings.h>
 
+#include "base/bit_utils.h"
 #include "base/casts.h"
 #include "utf-inl.h"
 
@@ -27,6 +30,64 @@ namespace art {
 
 using android::base::StringAppendF;
 
+// The ASCII fast paths below check eight bytes at a time in a general purpose register, which
+// does not depend on vector extensions (the RV64GC targets have none) and leaves the remaining
+// byte loops simple enough for the compiler to vectorize where vector registers are available.
+static constexpr size_t kWordSize = sizeof(uint64_t);
+
+ALWAYS_INLINE static inline uint64_t LoadAlignedWord(const void* p) {
+  DCHECK_ALIGNED(p, kWordSize);
+  uint64_t word;
+  memcpy(&word, __builtin_assume_aligned(p, kWordSize), kWordSize);
+  return word;
+}
+
+// Returns the number of leading bytes of `utf8` below 0x80, checking at most `byte_count` bytes.
+ALWAYS_INLINE static inline size_t CountAsciiPrefix(const char* utf8, size_t byte_count) {
+  size_t i = 0u;
+  while (i != byte_count && !IsAligned<kWordSize>(utf8 + i)) {
+    if ((utf8[i] & 0x80) != 0) {
+      return i;
+    }
+    ++i;
+  }
+  for (; byte_count - i >= kWordSize; i += kWordSize) {
+    if ((LoadAlignedWord(utf8 + i) & UINT64_C(0x8080808080808080)) != 0u) {
+      break;
+    }
+  }
+  while (i != byte_count && (utf8[i] & 0x80) == 0) {
+    ++i;
+  }
+  return i;
+}
+
+// Returns the number of leading characters of `utf16` in the range U+0001 - U+007F, i.e. the
+// characters with a one-byte modified UTF-8 encoding, checking at most `char_count` characters.
+ALWAYS_INLINE static inline size_t CountAsciiPrefix(const uint16_t* utf16, size_t char_count) {
+  auto is_one_byte = [](uint16_t ch) ALWAYS_INLINE { return ch - 1u < 0x7fu; };
+  size_t i = 0u;
+  while (i != char_count && !IsAligned<kWordSize>(utf16 + i)) {
+    if (!is_one_byte(utf16[i])) {
+      return i;
+    }
+    ++i;
+  }
+  constexpr size_t kCharsPerWord = kWordSize / sizeof(uint16_t);
+  for (; char_count - i >= kCharsPerWord; i += kCharsPerWord) {
+    uint64_t word = LoadAlignedWord(utf16 + i);
+    // With all characters below 0x80, subtracting one from each only borrows from a zero one.
+    if ((word & UINT64_C(0xff80ff80ff80ff80)) != 0u ||
+        ((word - UINT64_C(0x0001000100010001)) & UINT64_C(0x8000800080008000)) != 0u) {
+      break;
+    }
+  }
+  while (i != char_count && is_one_byte(utf16[i])) {
+    ++i;
+  }
+  return i;
+}
+
 // This is used only from debugger and test code.
 size_t CountModifiedUtf8Chars(const char* utf8) {
   return CountModifiedUtf8Chars(utf8, strlen(utf8));
@@ -52,6 +113,12 @@ size_t CountModifiedUtf8Chars(const char* utf8, size_t byte_count) {
   size_t len = 0;
   const char* end = utf8 + byte_count;
   for (; utf8 < end; ++utf8) {
+    size_t ascii_count = CountAsciiPrefix(utf8, end - utf8);
+    len += ascii_count;
+    utf8 += ascii_count;
+    if (utf8 == end) {
+      break;
+    }
     int ic = *utf8;
     len++;
     if (LIKELY((ic & 0x80) == 0)) {
@@ -110,6 +177,14 @@ void ConvertModifiedUtf8ToUtf16(uint16_t* utf16_data_out, size_t out_chars,
 
   // String contains non-ASCII characters.
   for (const char *p = in_start; p < in_end;) {
+    // Copy runs of ASCII characters without decoding them.
+    const char* ascii_end = p + CountAsciiPrefix(p, in_end - p);
+    while (p != ascii_end) {
+      *out_p++ = dchecked_integral_cast<uint16_t>(*p++);
+    }
+    if (p == in_end) {
+      break;
+    }
     const uint32_t ch = GetUtf16FromUtf8(&p);
     const uint16_t leading = GetLeadingUtf16Char(ch);
     const uint16_t trailing = GetTrailingUtf16Char(ch);
@@ -132,12 +207,17 @@ void ConvertUtf16ToModifiedUtf8(char* utf8_out, size_t byte_count,
     return;
   }
 
-  // String contains non-ASCII characters.
+  // String contains non-ASCII characters. Copy the leading ASCII characters without encoding them.
+  size_t ascii_count = CountAsciiPrefix(utf16_in, char_count);
+  for (size_t i = 0; i != ascii_count; ++i) {
+    *utf8_out++ = dchecked_integral_cast<char>(utf16_in[i]);
+  }
   // FIXME: We should not emit 4-byte sequences. Bug: 192935764
   auto append = [&](char c) { *utf8_out++ = c; };
   ConvertUtf16ToUtf8</*kUseShortZero=*/ false,
                      /*kUse4ByteSequence=*/ true,
-                     /*kReplaceBadSurrogates=*/ false>(utf16_in, char_count, append);
+                     /*kReplaceBadSurrogates=*/ false>(
+      utf16_in + ascii_count, char_count - ascii_count, append);
 }
 
 int32_t ComputeUtf16HashFromModifiedUtf8(const char* utf8, size_t utf16_length) {
@@ -157,8 +237,25 @@ int32_t ComputeUtf16HashFromModifiedUtf8(const char* utf8, size_t utf16_length)
   return static_cast<int32_t>(hash);
 }
 
+// Update a modified UTF-8 hash with four characters. This is the same as four calls to
+// `UpdateModifiedUtf8Hash()` but the multiplications do not depend on each other.
+ALWAYS_INLINE static inline uint32_t UpdateModifiedUtf8Hash4(uint32_t hash, const char* chars) {
+  constexpr uint32_t k31Pow2 = 31u * 31u;
+  constexpr uint32_t k31Pow3 = k31Pow2 * 31u;
+  constexpr uint32_t k31Pow4 = k31Pow3 * 31u;
+  return hash * k31Pow4 +
+         static_cast<uint8_t>(chars[0]) * k31Pow3 +
+         static_cast<uint8_t>(chars[1]) * k31Pow2 +
+         static_cast<uint8_t>(chars[2]) * 31u +
+         static_cast<uint8_t>(chars[3]);
+}
+
 uint32_t ComputeModifiedUtf8Hash(const char* chars) {
   uint32_t hash = StartModifiedUtf8Hash();
+  while (chars[0] != '\0' && chars[1] != '\0' && chars[2] != '\0' && chars[3] != '\0') {
+    hash = UpdateModifiedUtf8Hash4(hash, chars);
+    chars += 4;
+  }
   while (*chars != '\0') {
     hash = UpdateModifiedUtf8Hash(hash, *chars);
     ++chars;
@@ -167,7 +264,12 @@ uint32_t ComputeModifiedUtf8Hash(const char* chars) {
 }
 
 uint32_t ComputeModifiedUtf8Hash(std::string_view chars) {
-  return UpdateModifiedUtf8Hash(StartModifiedUtf8Hash(), chars);
+  uint32_t hash = StartModifiedUtf8Hash();
+  size_t i = 0u;
+  for (; chars.size() - i >= 4u; i += 4u) {
+    hash = UpdateModifiedUtf8Hash4(hash, chars.data() + i);
+  }
+  return UpdateModifiedUtf8Hash(hash, chars.substr(i));
 }
 
 int CompareModifiedUtf8ToUtf16AsCodePointValues(const char* utf8, const uint16_t* utf16,
@@ -207,12 +309,15 @@ int CompareModifiedUtf8ToUtf16AsCodePointValues(const char* utf8, const uint16_t
 }
 
 size_t CountModifiedUtf8BytesInUtf16(const uint16_t* chars, size_t char_count) {
+  // Leading ASCII characters are encoded in one byte each.
+  size_t ascii_count = CountAsciiPrefix(chars, char_count);
+  size_t result = ascii_count;
   // FIXME: We should not emit 4-byte sequences. Bug: 192935764
-  size_t result = 0;
   auto append = [&]([[maybe_unused]] char c) { ++result; };
   ConvertUtf16ToUtf8</*kUseShortZero=*/ false,
                      /*kUse4ByteSequence=*/ true,
-                     /*kReplaceBadSurrogates=*/ false>(chars, char_count, append);
+                     /*kReplaceBadSurrogates=*/ false>(
+      chars + ascii_count, char_count - ascii_count, append);
   return result;
 }
 
@@ -103,6 +103,15 @@ int32_t ComputeUtf16Hash(const MemoryType* chars, size_t char_count) {
                 std::is_same_v<MemoryType, uint16_t>);
   using UnsignedMemoryType = std::make_unsigned_t<MemoryType>;
   uint32_t hash = 0;
+  // Apply four steps of Horner's method at once, `hash * 31^4 + c0 * 31^3 + c1 * 31^2 + c2 * 31 +
+  // c3`, so that the multiplications do not form one long dependency chain.
+  for (; char_count >= 4u; char_count -= 4u, chars += 4) {
+    hash = hash * (31u * 31u * 31u * 31u) +
+           static_cast<UnsignedMemoryType>(chars[0]) * (31u * 31u * 31u) +
+           static_cast<UnsignedMemoryType>(chars[1]) * (31u * 31u) +
+           static_cast<UnsignedMemoryType>(chars[2]) * 31u +
+           static_cast<UnsignedMemoryType>(chars[3]);
+  }
   while (char_count--) {
     hash = hash * 31 + static_cast<UnsignedMemoryType>(*chars++);
   }
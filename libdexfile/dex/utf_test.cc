@@ -17,6 +17,7 @@
 #include "utf.h"
 
 #include <map>
+#include <string>
 #include <vector>
 
 #include <android-base/stringprintf.h>
@@ -198,6 +199,38 @@ TEST_F(UtfTest, CountAndConvertUtf8Bytes_UnpairedSurrogate) {
   }
 }
 
+TEST_F(UtfTest, CountAndConvertUtf8Bytes_LongAscii) {
+  // Place a non-ASCII character at every position of a string long enough for the ASCII
+  // fast paths to check whole words, starting at every alignment.
+  for (uint16_t special : { 0x0000, 0x0081, 0x0801 }) {
+    for (size_t length = 1u; length != 40u; ++length) {
+      for (size_t pos = 0u; pos != length; ++pos) {
+        std::vector<uint16_t> utf16(length, 'a');
+        utf16[pos] = special;
+        std::vector<uint8_t> expected(length, 'a');
+        std::vector<uint8_t> encoded = (special == 0x0000) ? std::vector<uint8_t>{ 0xc0, 0x80 }
+                                     : (special == 0x0081) ? std::vector<uint8_t>{ 0xc2, 0x81 }
+                                     : std::vector<uint8_t>{ 0xe0, 0xa0, 0x81 };
+        expected.erase(expected.begin() + pos);
+        expected.insert(expected.begin() + pos, encoded.begin(), encoded.end());
+        AssertConversion(utf16, expected);
+
+        std::string utf8(expected.begin(), expected.end());
+        for (size_t offset = 0u; offset != 8u; ++offset) {
+          std::string shifted = std::string(offset, 'b') + utf8;
+          const char* in = shifted.c_str() + offset;
+          ASSERT_EQ(length, CountModifiedUtf8Chars(in, utf8.size()));
+          std::vector<uint16_t> output(length);
+          ConvertModifiedUtf8ToUtf16(output.data(), length, in, utf8.size());
+          EXPECT_EQ(utf16, output);
+          EXPECT_EQ(ComputeModifiedUtf8Hash(std::string_view(in, utf8.size())),
+                    ComputeModifiedUtf8Hash(in));
+        }
+      }
+    }
+  }
+}
+
 // Old versions of functions, here to compare answers with optimized versions.
 
 size_t CountModifiedUtf8Chars_reference(const char* utf8) {
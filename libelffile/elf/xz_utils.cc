@@ -16,11 +16,14 @@
 
 #include "xz_utils.h"
 
-#include <vector>
+#include <algorithm>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 #include "base/array_ref.h"
 #include "base/bit_utils.h"
+#include "base/casts.h"
 #include "base/leb128.h"
 #include "dwarf/writer.h"
 
@@ -40,12 +43,21 @@ static void XzInitCrc() {
   });
 }
 
-void XzCompress(ArrayRef<const uint8_t> src,
-                std::vector<uint8_t>* dst,
-                int level,
-                size_t block_size) {
+// Inputs of at least this size are split into chunks compressed on several threads.
+static constexpr size_t kMinParallelXzSize = 1 * MB;
+static constexpr size_t kMaxXzThreads = 4u;
+
+// The fixed-size parts of the xz stream format.
+static constexpr size_t kXzStreamHeaderSize = 12u;  // Magic, stream flags and their CRC32.
+static constexpr size_t kXzStreamFooterSize = 12u;  // CRC32, backward size, flags and magic.
+static constexpr size_t kXzStreamFlagsOffset = 6u;
+static constexpr size_t kXzStreamFlagsSize = 2u;
+
+static void XzCompressStream(ArrayRef<const uint8_t> src,
+                             std::vector<uint8_t>* dst,
+                             int level,
+                             size_t block_size) {
   // Configure the compression library.
-  XzInitCrc();
   CLzma2EncProps lzma2Props;
   Lzma2EncProps_Init(&lzma2Props);
   lzma2Props.lzmaProps.level = level;
@@ -87,6 +99,96 @@ void XzCompress(ArrayRef<const uint8_t> src,
   // Compress.
   SRes res = Xz_Encode(&callbacks, &callbacks, &props, &callbacks);
   CHECK_EQ(res, SZ_OK);
+}
+
+static void AppendLittleEndian32(std::vector<uint8_t>* dst, uint32_t value) {
+  for (size_t i = 0; i != sizeof(uint32_t); ++i) {
+    dst->push_back(static_cast<uint8_t>(value >> (8u * i)));
+  }
+}
+
+// Append the blocks of the xz `streams` to `dst` as a single stream. The blocks are independent,
+// so only the index, which lists the sizes of all the blocks, and the footer are rewritten.
+static void XzMergeStreams(const std::vector<std::vector<uint8_t>>& streams,
+                           std::vector<uint8_t>* dst) {
+  DCHECK(!streams.empty());
+  const std::vector<uint8_t>& first = streams[0];
+  dst->insert(dst->end(), first.begin(), first.begin() + kXzStreamHeaderSize);
+  // The index records, an unpadded compressed size and an uncompressed size per block.
+  std::vector<uint32_t> records;
+  for (const std::vector<uint8_t>& stream : streams) {
+    CHECK_GE(stream.size(), kXzStreamHeaderSize + kXzStreamFooterSize);
+    DCHECK(std::equal(first.begin(), first.begin() + kXzStreamHeaderSize, stream.begin()));
+    const uint8_t* footer = stream.data() + stream.size() - kXzStreamFooterSize;
+    uint32_t backward_size = footer[4] | (footer[5] << 8) | (footer[6] << 16) | (footer[7] << 24);
+    size_t index_size = (static_cast<size_t>(backward_size) + 1u) * 4u;
+    size_t index_begin = stream.size() - kXzStreamFooterSize - index_size;
+    CHECK_GE(index_begin, kXzStreamHeaderSize);
+    const uint8_t* index = stream.data() + index_begin;
+    CHECK_EQ(*index, 0u);  // Index indicator.
+    ++index;
+    uint32_t num_records = DecodeUnsignedLeb128(&index);
+    for (uint32_t i = 0; i != 2u * num_records; ++i) {
+      records.push_back(DecodeUnsignedLeb128(&index));
+    }
+    dst->insert(dst->end(), stream.begin() + kXzStreamHeaderSize, stream.begin() + index_begin);
+  }
+  // Write the index: indicator, number of records, records, padding and CRC32.
+  size_t index_begin = dst->size();
+  dst->push_back(0u);
+  EncodeUnsignedLeb128(dst, records.size() / 2u);
+  for (uint32_t value : records) {
+    EncodeUnsignedLeb128(dst, value);
+  }
+  while ((dst->size() - index_begin) % 4u != 0u) {
+    dst->push_back(0u);
+  }
+  AppendLittleEndian32(dst, CrcCalc(dst->data() + index_begin, dst->size() - index_begin));
+  size_t index_size = dst->size() - index_begin;
+  // Write the footer: CRC32 of the backward size and the stream flags, followed by them.
+  std::vector<uint8_t> footer;
+  AppendLittleEndian32(&footer, dchecked_integral_cast<uint32_t>(index_size / 4u - 1u));
+  footer.insert(footer.end(),
+                first.begin() + kXzStreamFlagsOffset,
+                first.begin() + kXzStreamFlagsOffset + kXzStreamFlagsSize);
+  AppendLittleEndian32(dst, CrcCalc(footer.data(), footer.size()));
+  dst->insert(dst->end(), footer.begin(), footer.end());
+  dst->push_back('Y');
+  dst->push_back('Z');
+}
+
+void XzCompress(ArrayRef<const uint8_t> src,
+                std::vector<uint8_t>* dst,
+                int level,
+                size_t block_size) {
+  XzInitCrc();
+  size_t num_threads = std::min<size_t>(std::thread::hardware_concurrency(), kMaxXzThreads);
+  if (src.size() < kMinParallelXzSize || num_threads <= 1u) {
+    XzCompressStream(src, dst, level, block_size);
+  } else {
+    // Compress chunks of whole blocks into separate streams and merge them. The chunks end at
+    // block boundaries, so the result is a regular multi-block stream whose blocks unwinders
+    // can still decompress independently.
+    size_t chunk_size = RoundUp(RoundUp(src.size(), num_threads) / num_threads, block_size);
+    size_t num_chunks = RoundUp(src.size(), chunk_size) / chunk_size;
+    std::vector<std::vector<uint8_t>> streams(num_chunks);
+    auto compress_chunk = [&](size_t i) {
+      size_t chunk_begin = i * chunk_size;
+      size_t size = std::min(chunk_size, src.size() - chunk_begin);
+      streams[i].reserve(size / 4u);
+      XzCompressStream(src.SubArray(chunk_begin, size), &streams[i], level, block_size);
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(num_chunks - 1u);
+    for (size_t i = 1u; i != num_chunks; ++i) {
+      threads.emplace_back(compress_chunk, i);
+    }
+    compress_chunk(0u);
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+    XzMergeStreams(streams, dst);
+  }
 
   // Decompress the data back and check that we get the original.
   if (kIsDebugBuild) {
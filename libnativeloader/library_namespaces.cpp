@@ -438,6 +438,12 @@ NativeLoaderNamespace* LibraryNamespaces::FindNamespaceByClassLoader(JNIEnv* env
                            return env->IsSameObject(value.first, class_loader);
                          });
   if (it != namespaces_.end()) {
+    // Most lookups are for the class loader of the previous lookup, typically the app's main
+    // class loader, so move the namespace found to the front. Splicing keeps the addresses of
+    // the namespaces valid.
+    if (it != namespaces_.begin()) {
+      namespaces_.splice(namespaces_.begin(), namespaces_, it);
+    }
     return &it->second;
   }
 
@@ -65,6 +65,8 @@ class LibraryNamespaces {
 
   bool initialized_;
   NativeLoaderNamespace* app_main_namespace_;
+  // Ordered from the most recently found namespace. A jweak cannot be hashed, as the identity
+  // of the class loader is only known through JNIEnv::IsSameObject().
   std::list<std::pair<jweak, NativeLoaderNamespace>> namespaces_;
 };
 
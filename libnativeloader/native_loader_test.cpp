@@ -453,6 +453,12 @@ TEST_P(NativeLoaderTest_Create, TwoApks) {
 
     // The created namespace is for the second apk
     EXPECT_EQ(second_app_dex_path.c_str(), reinterpret_cast<const char*>(ns));
+
+    // The lookups reorder the namespaces, which does not change what they find.
+    ns = FindNamespaceByClassLoader(env(), env()->NewStringUTF(class_loader.c_str()));
+    EXPECT_EQ(dex_path.c_str(), reinterpret_cast<const char*>(ns));
+    ns = FindNamespaceByClassLoader(env(), env()->NewStringUTF(second_app_class_loader.c_str()));
+    EXPECT_EQ(second_app_dex_path.c_str(), reinterpret_cast<const char*>(ns));
   } else {
     struct NativeLoaderNamespace* ns = FindNativeLoaderNamespaceByClassLoader(
         env(), env()->NewStringUTF(second_app_class_loader.c_str()));
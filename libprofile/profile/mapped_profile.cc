@@ -0,0 +1,269 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mapped_profile.h"
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+#include "android-base/stringprintf.h"
+#include "base/bit_utils.h"
+#include "base/casts.h"
+#include "base/logging.h"
+#include "base/mman.h"
+#include "dex/dex_file.h"
+#include "profile_helpers.h"
+
+namespace art {
+
+using android::base::StringPrintf;
+
+const uint8_t MappedProfile::kMappedProfileMagic[] = { 'p', 'm', 'p', '\0' };
+const uint8_t MappedProfile::kMappedProfileVersion[] = { '0', '0', '1', '\0' };
+
+struct MappedProfile::Header {
+  uint8_t magic[4];
+  uint8_t version[4];
+  uint32_t num_dex_files;
+  // The number of method bitmaps of each dex file, one for each hotness flag from kFlagFirst.
+  uint32_t num_flags;
+};
+
+struct MappedProfile::DexFileEntry {
+  uint32_t checksum;
+  uint32_t num_method_ids;
+  uint32_t num_type_ids;
+  uint32_t profile_key_offset;
+  uint32_t profile_key_size;
+  // The bitmaps of the flags, as 32-bit words. The bit of `method_index` for the flag at
+  // `flag_index` is `flag_index * num_method_ids + method_index`.
+  uint32_t method_bitmap_offset;
+  // The sorted 16-bit type indexes of the classes.
+  uint32_t classes_offset;
+  uint32_t num_classes;
+};
+
+static_assert(sizeof(MappedProfile::kMappedProfileMagic) == 4, "Invalid magic size");
+static_assert(sizeof(MappedProfile::kMappedProfileVersion) == 4, "Invalid version size");
+
+static size_t GetMethodBitmapWords(uint32_t num_flags, uint32_t num_method_ids) {
+  return RoundUp(static_cast<size_t>(num_flags) * num_method_ids, 32u) / 32u;
+}
+
+bool MappedProfile::Save(const ProfileCompilationInfo& info, int fd) {
+  using DexFileData = ProfileCompilationInfo::DexFileData;
+  const uint32_t last_flag = info.IsForBootImage() ? MethodHotness::kFlagLastBoot
+                                                   : MethodHotness::kFlagLastRegular;
+  const uint32_t num_flags = WhichPowerOf2(last_flag) + 1u;
+
+  // Sort the dex files by checksum for the lookup, keeping the profile order for equal checksums
+  // so that the first dex file with a matching key is found like in ProfileCompilationInfo.
+  std::vector<const DexFileData*> dex_data;
+  dex_data.reserve(info.info_.size());
+  for (const std::unique_ptr<DexFileData>& data : info.info_) {
+    dex_data.push_back(data.get());
+  }
+  std::stable_sort(dex_data.begin(), dex_data.end(), [](const auto* lhs, const auto* rhs) {
+    return lhs->checksum < rhs->checksum;
+  });
+
+  std::vector<DexFileEntry> entries(dex_data.size());
+  std::vector<uint8_t> buffer(sizeof(Header) + entries.size() * sizeof(DexFileEntry));
+  auto align = [&buffer]() { buffer.resize(RoundUp(buffer.size(), sizeof(uint32_t))); };
+  for (size_t i = 0; i != dex_data.size(); ++i) {
+    const DexFileData* data = dex_data[i];
+    DexFileEntry& entry = entries[i];
+    entry.checksum = data->checksum;
+    entry.num_method_ids = data->num_method_ids;
+    entry.num_type_ids = data->num_type_ids;
+
+    entry.profile_key_offset = dchecked_integral_cast<uint32_t>(buffer.size());
+    entry.profile_key_size = dchecked_integral_cast<uint32_t>(data->profile_key.size());
+    AddStringToBuffer(&buffer, data->profile_key);
+    align();
+
+    std::vector<uint32_t> bitmap(GetMethodBitmapWords(num_flags, data->num_method_ids), 0u);
+    for (uint32_t method_index = 0; method_index != data->num_method_ids; ++method_index) {
+      uint32_t flags = data->GetHotnessInfo(method_index).GetFlags();
+      for (uint32_t flag_index = 0; flag_index != num_flags; ++flag_index) {
+        if ((flags & (1u << flag_index)) != 0u) {
+          size_t bit = static_cast<size_t>(flag_index) * data->num_method_ids + method_index;
+          bitmap[bit / 32u] |= 1u << (bit % 32u);
+        }
+      }
+    }
+    entry.method_bitmap_offset = dchecked_integral_cast<uint32_t>(buffer.size());
+    for (uint32_t word : bitmap) {
+      AddUintToBuffer(&buffer, word);
+    }
+
+    // Classes without a type id in the dex file refer to extra descriptors, which are not saved.
+    entry.classes_offset = dchecked_integral_cast<uint32_t>(buffer.size());
+    entry.num_classes = 0u;
+    for (dex::TypeIndex type_index : data->class_set) {
+      if (type_index.index_ < data->num_type_ids) {
+        AddUintToBuffer(&buffer, type_index.index_);
+        ++entry.num_classes;
+      }
+    }
+    align();
+  }
+  if (buffer.size() > std::numeric_limits<uint32_t>::max()) {
+    LOG(ERROR) << "Mapped profile too big: " << buffer.size();
+    return false;
+  }
+
+  Header header;
+  memcpy(header.magic, kMappedProfileMagic, sizeof(header.magic));
+  memcpy(header.version, kMappedProfileVersion, sizeof(header.version));
+  header.num_dex_files = dchecked_integral_cast<uint32_t>(entries.size());
+  header.num_flags = num_flags;
+  memcpy(buffer.data(), &header, sizeof(header));
+  if (!entries.empty()) {
+    memcpy(buffer.data() + sizeof(header), entries.data(), entries.size() * sizeof(DexFileEntry));
+  }
+  return WriteBuffer(fd, buffer.data(), buffer.size());
+}
+
+std::unique_ptr<MappedProfile> MappedProfile::Open(int fd, std::string* error_msg) {
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    *error_msg = StringPrintf("Failed to stat mapped profile: %s", strerror(errno));
+    return nullptr;
+  }
+  uint64_t size = static_cast<uint64_t>(st.st_size);
+  if (size < sizeof(Header) || size > std::numeric_limits<uint32_t>::max()) {
+    *error_msg = StringPrintf("Invalid mapped profile size %" PRIu64, size);
+    return nullptr;
+  }
+
+  // Nothing to initialize if there is a runtime, like for the OatFileAssistant.
+  MemMap::Init();
+  MemMap map = MemMap::MapFile(size,
+                               PROT_READ,
+                               MAP_PRIVATE,
+                               fd,
+                               /*start=*/ 0,
+                               /*low_4gb=*/ false,
+                               "mapped profile",
+                               error_msg);
+  if (!map.IsValid()) {
+    return nullptr;
+  }
+  std::unique_ptr<MappedProfile> profile(new MappedProfile(std::move(map)));
+
+  // Check the offsets once so that the queries can use them without checks.
+  const Header& header = profile->GetHeader();
+  if (memcmp(header.magic, kMappedProfileMagic, sizeof(header.magic)) != 0 ||
+      memcmp(header.version, kMappedProfileVersion, sizeof(header.version)) != 0) {
+    *error_msg = "Invalid mapped profile magic or version";
+    return nullptr;
+  }
+  constexpr uint32_t kMaxFlags =
+      WhichPowerOf2(static_cast<uint32_t>(MethodHotness::kFlagLastBoot)) + 1u;
+  if (header.num_flags == 0u ||
+      header.num_flags > kMaxFlags ||
+      sizeof(Header) + static_cast<uint64_t>(header.num_dex_files) * sizeof(DexFileEntry) > size) {
+    *error_msg = "Invalid mapped profile header";
+    return nullptr;
+  }
+  const DexFileEntry* entries = profile->GetDexFileEntries();
+  for (uint32_t i = 0; i != header.num_dex_files; ++i) {
+    const DexFileEntry& entry = entries[i];
+    uint64_t bitmap_size =
+        GetMethodBitmapWords(header.num_flags, entry.num_method_ids) * sizeof(uint32_t);
+    if (static_cast<uint64_t>(entry.profile_key_offset) + entry.profile_key_size > size ||
+        !IsAligned<sizeof(uint32_t)>(entry.method_bitmap_offset) ||
+        entry.method_bitmap_offset + bitmap_size > size ||
+        !IsAligned<sizeof(uint16_t)>(entry.classes_offset) ||
+        entry.classes_offset + static_cast<uint64_t>(entry.num_classes) * sizeof(uint16_t) > size ||
+        (i != 0u && entries[i - 1u].checksum > entry.checksum)) {
+      *error_msg = StringPrintf("Invalid mapped profile entry %u", i);
+      return nullptr;
+    }
+  }
+  return profile;
+}
+
+size_t MappedProfile::GetNumberOfDexFiles() const {
+  return GetHeader().num_dex_files;
+}
+
+MappedProfile::MethodHotness MappedProfile::GetMethodHotness(
+    const MethodReference& method_ref) const {
+  MethodHotness hotness;
+  const DexFileEntry* entry = FindDexFileEntry(*method_ref.dex_file);
+  if (entry != nullptr && method_ref.index < entry->num_method_ids) {
+    for (uint32_t flag_index = 0; flag_index != GetHeader().num_flags; ++flag_index) {
+      if (LoadBit(*entry, flag_index, method_ref.index)) {
+        hotness.AddFlag(static_cast<MethodHotness::Flag>(1u << flag_index));
+      }
+    }
+  }
+  return hotness;
+}
+
+bool MappedProfile::ContainsClass(const DexFile& dex_file, dex::TypeIndex type_idx) const {
+  const DexFileEntry* entry = FindDexFileEntry(dex_file);
+  if (entry == nullptr) {
+    return false;
+  }
+  const uint16_t* classes = GetData<uint16_t>(entry->classes_offset);
+  return std::binary_search(classes, classes + entry->num_classes, type_idx.index_);
+}
+
+const MappedProfile::Header& MappedProfile::GetHeader() const {
+  return *GetData<Header>(0u);
+}
+
+const MappedProfile::DexFileEntry* MappedProfile::GetDexFileEntries() const {
+  return GetData<DexFileEntry>(sizeof(Header));
+}
+
+const MappedProfile::DexFileEntry* MappedProfile::FindDexFileEntry(const DexFile& dex_file) const {
+  const DexFileEntry* begin = GetDexFileEntries();
+  const DexFileEntry* end = begin + GetHeader().num_dex_files;
+  uint32_t checksum = dex_file.GetLocationChecksum();
+  const DexFileEntry* it = std::lower_bound(
+      begin, end, checksum, [](const DexFileEntry& entry, uint32_t value) {
+        return entry.checksum < value;
+      });
+  std::string_view base_key =
+      ProfileCompilationInfo::GetProfileDexFileBaseKeyView(dex_file.GetLocation());
+  for (; it != end && it->checksum == checksum; ++it) {
+    std::string_view profile_key(GetData<char>(it->profile_key_offset), it->profile_key_size);
+    if (ProfileCompilationInfo::GetBaseKeyViewFromAugmentedKey(profile_key) == base_key) {
+      return it;
+    }
+  }
+  return nullptr;
+}
+
+bool MappedProfile::LoadBit(const DexFileEntry& entry,
+                            size_t flag_index,
+                            uint32_t method_index) const {
+  size_t bit = flag_index * entry.num_method_ids + method_index;
+  const uint32_t* bitmap = GetData<uint32_t>(entry.method_bitmap_offset);
+  return (bitmap[bit / 32u] & (1u << (bit % 32u))) != 0u;
+}
+
+}  // namespace art
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_LIBPROFILE_PROFILE_MAPPED_PROFILE_H_
+#define ART_LIBPROFILE_PROFILE_MAPPED_PROFILE_H_
+
+#include <memory>
+#include <string>
+
+#include "base/macros.h"
+#include "base/mem_map.h"
+#include "dex/dex_file_types.h"
+#include "dex/method_reference.h"
+#include "profile/profile_compilation_info.h"
+
+namespace art {
+
+class DexFile;
+
+/**
+ * The method hotness and the classes of a profile in an uncompressed and indexed format that is
+ * queried in place after mapping the file, so no time is spent parsing and inflating it.
+ *
+ * The file starts with a header followed by a table of dex files sorted by checksum. Each dex
+ * file has its profile key, one bitmap of `num_method_ids` bits for each hotness flag, and the
+ * sorted type indexes of its classes.
+ *
+ * Only the data needed for the queries below is kept: the inline caches, the extra descriptors
+ * and the startup order of the ProfileCompilationInfo are not saved, so the format is meant for
+ * readers of hotness data, not as a replacement of the `.prof` format.
+ */
+class MappedProfile {
+ public:
+  using MethodHotness = ProfileCompilationInfo::MethodHotness;
+
+  static const uint8_t kMappedProfileMagic[];
+  static const uint8_t kMappedProfileVersion[];
+
+  // Save the methods and classes of `info` in the mapped format into `fd`.
+  static bool Save(const ProfileCompilationInfo& info, int fd);
+
+  // Map the profile saved in `fd`. Returns null and sets `error_msg` if the file is not a valid
+  // mapped profile.
+  static std::unique_ptr<MappedProfile> Open(int fd, std::string* error_msg);
+
+  size_t GetNumberOfDexFiles() const;
+
+  // Same as ProfileCompilationInfo::GetMethodHotness() without annotation, except that the
+  // returned hotness has no inline caches.
+  MethodHotness GetMethodHotness(const MethodReference& method_ref) const;
+
+  // Same as ProfileCompilationInfo::ContainsClass() without annotation.
+  bool ContainsClass(const DexFile& dex_file, dex::TypeIndex type_idx) const;
+
+ private:
+  struct Header;
+  struct DexFileEntry;
+
+  explicit MappedProfile(MemMap&& map) : map_(std::move(map)) {}
+
+  const Header& GetHeader() const;
+  const DexFileEntry* GetDexFileEntries() const;
+  const DexFileEntry* FindDexFileEntry(const DexFile& dex_file) const;
+  bool LoadBit(const DexFileEntry& entry, size_t flag_index, uint32_t method_index) const;
+
+  template <typename T>
+  const T* GetData(uint32_t offset) const {
+    return reinterpret_cast<const T*>(map_.Begin() + offset);
+  }
+
+  MemMap map_;
+
+  DISALLOW_COPY_AND_ASSIGN(MappedProfile);
+};
+
+}  // namespace art
+
+#endif  // ART_LIBPROFILE_PROFILE_MAPPED_PROFILE_H_
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "profile/mapped_profile.h"
+
+#include <gtest/gtest.h>
+
+#include "base/common_art_test.h"
+#include "profile/profile_compilation_info.h"
+#include "profile/profile_test_helper.h"
+
+namespace art {
+
+class MappedProfileTest : public CommonArtTest, public ProfileTestHelper {
+ public:
+  void SetUp() override {
+    CommonArtTest::SetUp();
+    dex1 = BuildDex("location1", /*location_checksum=*/ 2, "LUnique1;", /*num_method_ids=*/ 101);
+    dex2 = BuildDex("location2", /*location_checksum=*/ 1, "LUnique2;", /*num_method_ids=*/ 102);
+    dex1_checksum_mismatch =
+        BuildDex("location1", /*location_checksum=*/ 3, "LUnique1;", /*num_method_ids=*/ 101);
+  }
+
+ protected:
+  std::unique_ptr<MappedProfile> SaveAndOpen(const ProfileCompilationInfo& info) {
+    ScratchFile file;
+    CHECK(MappedProfile::Save(info, file.GetFd()));
+    CHECK_EQ(file.GetFile()->Flush(), 0);
+    std::string error_msg;
+    std::unique_ptr<MappedProfile> profile = MappedProfile::Open(file.GetFd(), &error_msg);
+    CHECK(profile != nullptr) << error_msg;
+    return profile;
+  }
+
+  void CheckSameData(const ProfileCompilationInfo& info,
+                     const MappedProfile& profile,
+                     const DexFile* dex) {
+    for (uint32_t method_index = 0; method_index != dex->NumMethodIds(); ++method_index) {
+      MethodReference ref(dex, method_index);
+      EXPECT_EQ(info.GetMethodHotness(ref).GetFlags(), profile.GetMethodHotness(ref).GetFlags())
+          << method_index;
+    }
+    for (uint32_t type_index = 0; type_index != dex->NumTypeIds(); ++type_index) {
+      EXPECT_EQ(info.ContainsClass(*dex, dex::TypeIndex(type_index)),
+                profile.ContainsClass(*dex, dex::TypeIndex(type_index)))
+          << type_index;
+    }
+  }
+
+  const DexFile* dex1;
+  const DexFile* dex2;
+  const DexFile* dex1_checksum_mismatch;
+};
+
+TEST_F(MappedProfileTest, MethodsAndClasses) {
+  ProfileCompilationInfo info;
+  ASSERT_TRUE(AddMethod(&info, dex1, /*method_idx=*/ 0));
+  ASSERT_TRUE(AddMethod(&info, dex1, /*method_idx=*/ 1, Hotness::kFlagStartup));
+  ASSERT_TRUE(AddMethod(&info,
+                        dex1,
+                        /*method_idx=*/ 100,
+                        static_cast<Hotness::Flag>(Hotness::kFlagHot |
+                                                   Hotness::kFlagPostStartup)));
+  ASSERT_TRUE(AddMethod(&info, dex2, /*method_idx=*/ 50, Hotness::kFlagPostStartup));
+  ASSERT_TRUE(AddClass(&info, dex1, dex::TypeIndex(1)));
+  ASSERT_TRUE(AddClass(&info, dex1, dex::TypeIndex(3)));
+  ASSERT_TRUE(AddClass(&info, dex2, dex::TypeIndex(0)));
+
+  std::unique_ptr<MappedProfile> profile = SaveAndOpen(info);
+  EXPECT_EQ(profile->GetNumberOfDexFiles(), 2u);
+  CheckSameData(info, *profile, dex1);
+  CheckSameData(info, *profile, dex2);
+
+  EXPECT_TRUE(profile->GetMethodHotness(MethodReference(dex1, 100)).IsHot());
+  EXPECT_TRUE(profile->GetMethodHotness(MethodReference(dex1, 100)).IsPostStartup());
+  EXPECT_FALSE(profile->GetMethodHotness(MethodReference(dex1, 2)).IsInProfile());
+  EXPECT_FALSE(profile->GetMethodHotness(MethodReference(dex1_checksum_mismatch, 0)).IsHot());
+  EXPECT_FALSE(profile->ContainsClass(*dex1_checksum_mismatch, dex::TypeIndex(1)));
+}
+
+TEST_F(MappedProfileTest, BootImageFlags) {
+  ProfileCompilationInfo info(/*for_boot_image=*/ true);
+  ASSERT_TRUE(AddMethod(&info,
+                        dex1,
+                        /*method_idx=*/ 7,
+                        static_cast<Hotness::Flag>(Hotness::kFlagHot | Hotness::kFlagBoot)));
+  ASSERT_TRUE(AddMethod(&info, dex2, /*method_idx=*/ 8, Hotness::kFlagAmStartup));
+
+  std::unique_ptr<MappedProfile> profile = SaveAndOpen(info);
+  CheckSameData(info, *profile, dex1);
+  CheckSameData(info, *profile, dex2);
+}
+
+TEST_F(MappedProfileTest, OpenInvalidFile) {
+  ProfileCompilationInfo info;
+  ASSERT_TRUE(AddMethod(&info, dex1, /*method_idx=*/ 0));
+  ScratchFile file;
+  ASSERT_TRUE(info.Save(file.GetFd()));
+  ASSERT_EQ(file.GetFile()->Flush(), 0);
+
+  std::string error_msg;
+  EXPECT_EQ(MappedProfile::Open(file.GetFd(), &error_msg), nullptr);
+  EXPECT_FALSE(error_msg.empty());
+}
+
+}  // namespace art
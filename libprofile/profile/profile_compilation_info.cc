@@ -32,6 +32,8 @@
 #include <numeric>
 #include <random>
 #include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 #include "android-base/file.h"
@@ -231,8 +233,12 @@ enum class ProfileCompilationInfo::FileSectionType : uint32_t {
   // an optional reserved section not implemented on client yet.
   kAggregationCounts = 4,
 
+  // The order in which methods were first executed during startup. This section
+  // is optional and used for laying out the compiled code.
+  kStartupOrder = 5,
+
   // The number of known sections.
-  kNumberOfSections = 5
+  kNumberOfSections = 6
 };
 
 class ProfileCompilationInfo::FileSectionInfo {
@@ -957,6 +963,7 @@ static bool WriteBuffer(int fd, const void* buffer, size_t byte_count) {
  *   ExtraDescriptors - optional, zipped
  *   Classes - optional, zipped
  *   Methods - optional, zipped
+ *   StartupOrder - optional, zipped
  *   AggregationCounts - optional, zipped, server-side
  *
  * DexFiles:
@@ -996,6 +1003,11 @@ static bool WriteBuffer(int fd, const void* buffer, size_t byte_count) {
  *    type_index_diff[dex_map_size]
  * where `M` stands for special encodings indicating missing types (kIsMissingTypesEncoding)
  * or memamorphic call (kIsMegamorphicEncoding) which both imply `dex_map_size == 0`.
+ *
+ * StartupOrder:
+ *    number_of_entries
+ *    (profile_index,method_index)[number_of_entries]
+ * where the entries are in the order in which the methods were first executed.
  **/
 bool ProfileCompilationInfo::Save(int fd) {
   uint64_t start = NanoTime();
@@ -1015,6 +1027,7 @@ bool ProfileCompilationInfo::Save(int fd) {
   uint64_t dex_files_section_size = sizeof(ProfileIndexType);  // Number of dex files.
   uint64_t classes_section_size = 0u;
   uint64_t methods_section_size = 0u;
+  uint64_t startup_order_section_size = 0u;
   DCHECK_LE(info_.size(), MaxProfileIndex());
   for (const std::unique_ptr<DexFileData>& dex_data : info_) {
     if (dex_data->profile_key.size() > kMaxDexFileKeyLength) {
@@ -1027,13 +1040,19 @@ bool ProfileCompilationInfo::Save(int fd) {
         sizeof(uint16_t) + dex_data->profile_key.size();
     classes_section_size += dex_data->ClassesDataSize();
     methods_section_size += dex_data->MethodsDataSize();
+    startup_order_section_size +=
+        dex_data->startup_order.size() * (sizeof(ProfileIndexType) + sizeof(uint16_t));
+  }
+  if (startup_order_section_size != 0u) {
+    startup_order_section_size += sizeof(uint32_t);  // Number of entries.
   }
 
   const uint32_t file_section_count =
       /* dex files */ 1u +
       /* extra descriptors */ (extra_descriptors_section_size != 0u ? 1u : 0u) +
       /* classes */ (classes_section_size != 0u ? 1u : 0u) +
-      /* methods */ (methods_section_size != 0u ? 1u : 0u);
+      /* methods */ (methods_section_size != 0u ? 1u : 0u) +
+      /* startup order */ (startup_order_section_size != 0u ? 1u : 0u);
   uint64_t header_and_infos_size =
       sizeof(FileHeader) + file_section_count * sizeof(FileSectionInfo);
 
@@ -1044,7 +1063,8 @@ bool ProfileCompilationInfo::Save(int fd) {
       dex_files_section_size +
       extra_descriptors_section_size +
       classes_section_size +
-      methods_section_size;
+      methods_section_size +
+      startup_order_section_size;
   VLOG(profiler) << "Required capacity: " << total_uncompressed_size << " bytes.";
   if (total_uncompressed_size > GetSizeErrorThresholdBytes()) {
     LOG(WARNING) << "Profile data size exceeds "
@@ -1143,6 +1163,25 @@ bool ProfileCompilationInfo::Save(int fd) {
     add_section_info(FileSectionType::kMethods, buffer.Size(), methods_section_size);
   }
 
+  // Write the startup order section.
+  if (startup_order_section_size != 0u) {
+    dchecked_vector<std::pair<ProfileIndexType, uint16_t>> entries = GetStartupOrderEntries();
+    SafeBuffer buffer(startup_order_section_size);
+    buffer.WriteUintAndAdvance(dchecked_integral_cast<uint32_t>(entries.size()));
+    for (const std::pair<ProfileIndexType, uint16_t>& entry : entries) {
+      buffer.WriteUintAndAdvance(entry.first);
+      buffer.WriteUintAndAdvance(entry.second);
+    }
+    DCHECK_EQ(buffer.GetAvailableBytes(), 0u);
+    if (!buffer.Deflate()) {
+      return false;
+    }
+    if (!WriteBuffer(fd, buffer.Get(), buffer.Size())) {
+      return false;
+    }
+    add_section_info(FileSectionType::kStartupOrder, buffer.Size(), startup_order_section_size);
+  }
+
   if (file_offset > GetSizeWarningThresholdBytes()) {
     LOG(WARNING) << "Profile data size exceeds "
         << GetSizeWarningThresholdBytes()
@@ -1755,6 +1794,48 @@ ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::ReadMethodsSec
   return ProfileLoadStatus::kSuccess;
 }
 
+ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::ReadStartupOrderSection(
+    ProfileSource& source,
+    const FileSectionInfo& section_info,
+    const dchecked_vector<ProfileIndexType>& dex_profile_index_remap,
+    /*out*/ std::string* error) {
+  DCHECK(section_info.GetType() == FileSectionType::kStartupOrder);
+  SafeBuffer buffer;
+  ProfileLoadStatus status = ReadSectionData(source, section_info, &buffer, error);
+  if (status != ProfileLoadStatus::kSuccess) {
+    return status;
+  }
+
+  uint32_t num_entries;
+  if (!buffer.ReadUintAndAdvance(&num_entries)) {
+    *error = "Error reading number of startup order entries.";
+    return ProfileLoadStatus::kBadData;
+  }
+  for (uint32_t i = 0; i != num_entries; ++i) {
+    ProfileIndexType profile_index;
+    uint16_t method_index;
+    if (!buffer.ReadUintAndAdvance(&profile_index) ||
+        !buffer.ReadUintAndAdvance(&method_index)) {
+      *error = "Error reading startup order entry.";
+      return ProfileLoadStatus::kBadData;
+    }
+    if (profile_index >= dex_profile_index_remap.size()) {
+      *error = "Invalid profile index in startup order section.";
+      return ProfileLoadStatus::kBadData;
+    }
+    profile_index = dex_profile_index_remap[profile_index];
+    if (profile_index == MaxProfileIndex()) {
+      continue;  // The dex file was filtered out.
+    }
+    if (method_index >= info_[profile_index]->num_method_ids) {
+      *error = "Invalid method index in startup order section.";
+      return ProfileLoadStatus::kBadData;
+    }
+    AddStartupOrder(profile_index, method_index);
+  }
+  return ProfileLoadStatus::kSuccess;
+}
+
 // TODO(calin): fail fast if the dex checksums don't match.
 ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::LoadInternal(
     int32_t fd,
@@ -1879,6 +1960,12 @@ ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::LoadInternal(
       case FileSectionType::kAggregationCounts:
         // This section is only used on server side.
         break;
+      case FileSectionType::kStartupOrder:
+        // Skip if all dex files were filtered out.
+        if (!info_.empty()) {
+          status = ReadStartupOrderSection(*source, section_info, dex_profile_index_remap, error);
+        }
+        break;
       default:
         // Unknown section. Skip it. New versions of ART are allowed
         // to add sections that shall be ignored by old versions.
@@ -2020,9 +2107,62 @@ bool ProfileCompilationInfo::MergeWith(const ProfileCompilationInfo& other,
     dex_data->MergeBitmap(*other_dex_data);
   }
 
+  // Append the startup order of the other profile. Methods already executed during startup
+  // according to this profile keep their place.
+  for (const std::pair<ProfileIndexType, uint16_t>& entry : other.GetStartupOrderEntries()) {
+    AddStartupOrder(dex_profile_index_remap[entry.first], entry.second);
+  }
+
   return true;
 }
 
+void ProfileCompilationInfo::AddStartupOrder(ProfileIndexType profile_index,
+                                             uint16_t method_index) {
+  DCHECK_LT(profile_index, info_.size());
+  DexFileData* const data = info_[profile_index].get();
+  DCHECK_LT(method_index, data->num_method_ids);
+  if (data->startup_order.find(method_index) == data->startup_order.end()) {
+    data->startup_order.Put(method_index, next_startup_order_);
+    ++next_startup_order_;
+  }
+}
+
+bool ProfileCompilationInfo::AddStartupOrder(const MethodReference& method_ref,
+                                             const ProfileSampleAnnotation& annotation) {
+  DexFileData* const data = GetOrAddDexFileData(method_ref.dex_file, annotation);
+  if (data == nullptr) {
+    return false;
+  }
+  AddStartupOrder(data->profile_index, dchecked_integral_cast<uint16_t>(method_ref.index));
+  return true;
+}
+
+uint32_t ProfileCompilationInfo::GetStartupOrder(
+    const MethodReference& method_ref,
+    const ProfileSampleAnnotation& annotation) const {
+  const DexFileData* dex_data = FindDexDataUsingAnnotations(method_ref.dex_file, annotation);
+  return dex_data != nullptr
+      ? GetStartupOrder(dex_data->profile_index, method_ref.index)
+      : kNoStartupOrder;
+}
+
+dchecked_vector<std::pair<ProfileCompilationInfo::ProfileIndexType, uint16_t>>
+ProfileCompilationInfo::GetStartupOrderEntries() const {
+  dchecked_vector<std::tuple<uint32_t, ProfileIndexType, uint16_t>> ranked_entries;
+  for (const std::unique_ptr<DexFileData>& dex_data : info_) {
+    for (const auto& [method_index, order] : dex_data->startup_order) {
+      ranked_entries.emplace_back(order, dex_data->profile_index, method_index);
+    }
+  }
+  std::sort(ranked_entries.begin(), ranked_entries.end());
+  dchecked_vector<std::pair<ProfileIndexType, uint16_t>> entries;
+  entries.reserve(ranked_entries.size());
+  for (const auto& [order, profile_index, method_index] : ranked_entries) {
+    entries.emplace_back(profile_index, method_index);
+  }
+  return entries;
+}
+
 ProfileCompilationInfo::MethodHotness ProfileCompilationInfo::GetMethodHotness(
     const MethodReference& method_ref,
     const ProfileSampleAnnotation& annotation) const {
@@ -2516,6 +2656,7 @@ void ProfileCompilationInfo::ClearData() {
   info_.clear();
   extra_descriptors_indexes_.clear();
   extra_descriptors_.clear();
+  next_startup_order_ = 0u;
 }
 
 void ProfileCompilationInfo::ClearDataAndAdjustVersion(bool for_boot_image) {
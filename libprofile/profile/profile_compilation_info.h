@@ -20,7 +20,9 @@
 #include <array>
 #include <list>
 #include <set>
+#include <limits>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #include "base/arena_containers.h"
@@ -94,6 +96,9 @@ class ProfileCompilationInfo {
   static constexpr size_t kProfileVersionSize = 4;
   static constexpr uint8_t kIndividualInlineCacheSize = 5;
 
+  // Returned by `GetStartupOrder()` for methods without a startup order.
+  static constexpr uint32_t kNoStartupOrder = std::numeric_limits<uint32_t>::max();
+
   // Data structures for encoding the offline representation of inline caches.
   // This is exposed as public in order to make it available to dex2oat compilations
   // (see compiler/optimizing/inliner.cc).
@@ -521,6 +526,39 @@ class ProfileCompilationInfo {
     return data->IsMethodInProfile(method_index);
   }
 
+  // Records that the referenced method was executed during startup, after all the methods that
+  // already have a startup order. Does nothing if the method already has a startup order.
+  void AddStartupOrder(ProfileIndexType profile_index, uint16_t method_index);
+
+  // Same as above, for a method reference.
+  //
+  // Note: see AddMethods docs for the handling of annotations.
+  bool AddStartupOrder(
+      const MethodReference& method_ref,
+      const ProfileSampleAnnotation& annotation = ProfileSampleAnnotation::kNone);
+
+  // Returns the rank of the referenced method in the order in which methods were first executed
+  // during startup, or `kNoStartupOrder` if the method has no startup order.
+  uint32_t GetStartupOrder(ProfileIndexType profile_index, uint32_t method_index) const {
+    DCHECK_LT(profile_index, info_.size());
+    const DexFileData* const data = info_[profile_index].get();
+    DCHECK_LT(method_index, data->num_method_ids);
+    auto it = data->startup_order.find(static_cast<uint16_t>(method_index));
+    return it != data->startup_order.end() ? it->second : kNoStartupOrder;
+  }
+
+  // Same as above, for a method reference.
+  //
+  // Note: see GetMethodHotness docs for the handling of annotations.
+  uint32_t GetStartupOrder(
+      const MethodReference& method_ref,
+      const ProfileSampleAnnotation& annotation = ProfileSampleAnnotation::kNone) const;
+
+  // Returns whether any method has a startup order.
+  bool HasStartupOrder() const {
+    return next_startup_order_ != 0u;
+  }
+
   // Returns the profile method info for a given method reference.
   //
   // Note that if the profile was built with annotations, the same dex file may be
@@ -791,6 +829,7 @@ class ProfileCompilationInfo {
           num_type_ids(num_types),
           num_method_ids(num_methods),
           bitmap_storage(allocator->Adapter(kArenaAllocProfile)),
+          startup_order(std::less<uint16_t>(), allocator->Adapter(kArenaAllocProfile)),
           is_for_boot_image(for_boot_image) {
       bitmap_storage.resize(ComputeBitmapStorage(is_for_boot_image, num_method_ids));
       if (!bitmap_storage.empty()) {
@@ -819,7 +858,8 @@ class ProfileCompilationInfo {
           num_method_ids == other.num_method_ids &&
           method_map == other.method_map &&
           class_set == other.class_set &&
-          BitMemoryRegion::Equals(method_bitmap, other.method_bitmap);
+          BitMemoryRegion::Equals(method_bitmap, other.method_bitmap) &&
+          startup_order == other.startup_order;
     }
 
     // Mark a method as executed at least once.
@@ -907,6 +947,8 @@ class ProfileCompilationInfo {
     uint32_t num_method_ids;
     ArenaVector<uint8_t> bitmap_storage;
     BitMemoryRegion method_bitmap;
+    // The startup order of the methods executed during startup, see `AddStartupOrder()`.
+    ArenaSafeMap<uint16_t, uint32_t> startup_order;
     bool is_for_boot_image;
 
    private:
@@ -1025,6 +1067,15 @@ class ProfileCompilationInfo {
       const dchecked_vector<ExtraDescriptorIndex>& extra_descriptors_remap,
       /*out*/ std::string* error);
 
+  ProfileLoadStatus ReadStartupOrderSection(
+      ProfileSource& source,
+      const FileSectionInfo& section_info,
+      const dchecked_vector<ProfileIndexType>& dex_profile_index_remap,
+      /*out*/ std::string* error);
+
+  // Returns the methods with a startup order, sorted by their startup order.
+  dchecked_vector<std::pair<ProfileIndexType, uint16_t>> GetStartupOrderEntries() const;
+
   // Entry point for profile loading functionality.
   ProfileLoadStatus LoadInternal(
       int32_t fd,
@@ -1063,6 +1114,7 @@ class ProfileCompilationInfo {
   static std::string MigrateAnnotationInfo(const std::string& base_key,
                                            const std::string& augmented_key);
 
+  friend class MappedProfile;
   friend class ProfileCompilationInfoTest;
   friend class CompilerDriverProfileTest;
   friend class ProfileAssistantTest;
@@ -1088,6 +1140,9 @@ class ProfileCompilationInfo {
 
   // The version of the profile.
   uint8_t version_[kProfileVersionSize];
+
+  // The startup order to assign to the next method executed during startup.
+  uint32_t next_startup_order_ = 0u;
 };
 
 /**
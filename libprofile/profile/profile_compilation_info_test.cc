@@ -1957,4 +1957,45 @@ TEST_F(ProfileCompilationInfoTest, MergeFlattenData) {
   }
 }
 
+TEST_F(ProfileCompilationInfoTest, SaveAndMergeStartupOrder) {
+  ScratchFile profile;
+
+  ProfileCompilationInfo saved_info;
+  ASSERT_FALSE(saved_info.HasStartupOrder());
+  ASSERT_TRUE(saved_info.AddStartupOrder(MethodReference(dex2, 5)));
+  ASSERT_TRUE(saved_info.AddStartupOrder(MethodReference(dex1, 3)));
+  ASSERT_TRUE(saved_info.AddStartupOrder(MethodReference(dex2, 1)));
+  // Methods keep the rank of their first execution.
+  ASSERT_TRUE(saved_info.AddStartupOrder(MethodReference(dex1, 3)));
+  ASSERT_TRUE(saved_info.HasStartupOrder());
+  EXPECT_EQ(0u, saved_info.GetStartupOrder(MethodReference(dex2, 5)));
+  EXPECT_EQ(1u, saved_info.GetStartupOrder(MethodReference(dex1, 3)));
+  EXPECT_EQ(2u, saved_info.GetStartupOrder(MethodReference(dex2, 1)));
+  EXPECT_EQ(ProfileCompilationInfo::kNoStartupOrder,
+            saved_info.GetStartupOrder(MethodReference(dex1, 5)));
+  EXPECT_EQ(ProfileCompilationInfo::kNoStartupOrder,
+            saved_info.GetStartupOrder(MethodReference(dex3, 5)));
+
+  ASSERT_TRUE(saved_info.Save(GetFd(profile)));
+  ASSERT_EQ(0, profile.GetFile()->Flush());
+
+  // Check that we get back what we saved.
+  ProfileCompilationInfo loaded_info;
+  ASSERT_TRUE(loaded_info.Load(GetFd(profile)));
+  ASSERT_TRUE(loaded_info.Equals(saved_info));
+  EXPECT_EQ(1u, loaded_info.GetStartupOrder(MethodReference(dex1, 3)));
+
+  // Merging appends the new methods after the existing ones.
+  ProfileCompilationInfo other_info;
+  ASSERT_TRUE(other_info.AddStartupOrder(MethodReference(dex3, 7)));
+  ASSERT_TRUE(other_info.AddStartupOrder(MethodReference(dex2, 1)));
+  ASSERT_TRUE(other_info.AddStartupOrder(MethodReference(dex1, 8)));
+  ASSERT_TRUE(loaded_info.MergeWith(other_info));
+  EXPECT_EQ(0u, loaded_info.GetStartupOrder(MethodReference(dex2, 5)));
+  EXPECT_EQ(1u, loaded_info.GetStartupOrder(MethodReference(dex1, 3)));
+  EXPECT_EQ(2u, loaded_info.GetStartupOrder(MethodReference(dex2, 1)));
+  EXPECT_EQ(3u, loaded_info.GetStartupOrder(MethodReference(dex3, 7)));
+  EXPECT_EQ(4u, loaded_info.GetStartupOrder(MethodReference(dex1, 8)));
+}
+
 }  // namespace art
@@ -22,7 +22,9 @@
 #include <iostream>
 #include <map>
 #include <set>
+#include <sstream>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -41,6 +43,7 @@
 #include "base/safe_map.h"
 #include "base/stats-inl.h"
 #include "base/stl_util.h"
+#include "base/string_view_cpp20.h"
 #include "base/unix_file/fd_file.h"
 #include "class_linker-inl.h"
 #include "class_linker.h"
@@ -331,6 +334,107 @@ class OatSymbolizer final {
   bool no_bits_;
 };
 
+// Statistics of the code compiled by the optimizing compiler, for --code-stats.
+struct CodeStats {
+  uint64_t code_bytes = 0u;
+  uint64_t frame_bytes = 0u;
+  // Spilled callee-save registers.
+  uint64_t core_spills = 0u;
+  uint64_t fp_spills = 0u;
+  uint64_t stack_maps = 0u;
+  // Inlined frames over all stack maps.
+  uint64_t inline_infos = 0u;
+  // References of runtime entrypoints. Most of them are the calls in slow paths.
+  uint64_t runtime_calls = 0u;
+  // The runtime calls of the null and bounds checks that throw explicitly, the read barrier
+  // marking, the suspend checks and the deoptimizations. The Baker read barriers of arm64 use
+  // introspection thunks, which are not counted.
+  uint64_t explicit_null_checks = 0u;
+  uint64_t bounds_checks = 0u;
+  uint64_t read_barriers = 0u;
+  uint64_t suspend_checks = 0u;
+  uint64_t deoptimizations = 0u;
+
+  void AddEntrypointReference(std::string_view name) {
+    if (!StartsWith(name, "p")) {
+      // Thread fields such as "state_and_flags" or "card_table".
+      return;
+    }
+    ++runtime_calls;
+    if (name == "pThrowNullPointer") {
+      ++explicit_null_checks;
+    } else if (name == "pThrowArrayBounds" || name == "pThrowStringBounds") {
+      ++bounds_checks;
+    } else if (StartsWith(name, "pReadBarrier")) {
+      ++read_barriers;
+    } else if (name == "pTestSuspend") {
+      ++suspend_checks;
+    } else if (name == "pDeoptimize") {
+      ++deoptimizations;
+    }
+  }
+
+  void Add(const CodeStats& other) {
+    code_bytes += other.code_bytes;
+    frame_bytes += other.frame_bytes;
+    core_spills += other.core_spills;
+    fp_spills += other.fp_spills;
+    stack_maps += other.stack_maps;
+    inline_infos += other.inline_infos;
+    runtime_calls += other.runtime_calls;
+    explicit_null_checks += other.explicit_null_checks;
+    bounds_checks += other.bounds_checks;
+    read_barriers += other.read_barriers;
+    suspend_checks += other.suspend_checks;
+    deoptimizations += other.deoptimizations;
+  }
+
+  // Writes the statistics as the members of a JSON object.
+  void DumpJsonMembers(std::ostream& os) const {
+    os << "\"code_bytes\": " << code_bytes
+       << ", \"frame_bytes\": " << frame_bytes
+       << ", \"core_spills\": " << core_spills
+       << ", \"fp_spills\": " << fp_spills
+       << ", \"stack_maps\": " << stack_maps
+       << ", \"inline_infos\": " << inline_infos
+       << ", \"runtime_calls\": " << runtime_calls
+       << ", \"explicit_null_checks\": " << explicit_null_checks
+       << ", \"bounds_checks\": " << bounds_checks
+       << ", \"read_barriers\": " << read_barriers
+       << ", \"suspend_checks\": " << suspend_checks
+       << ", \"deoptimizations\": " << deoptimizations;
+  }
+};
+
+// The CodeStats that CountThreadOffset() adds the entrypoint references to.
+static CodeStats* gDisassembledCodeStats = nullptr;
+
+// The thread offset name function of the disassembler of --code-stats.
+template <PointerSize kPointerSize>
+static void CountThreadOffset(std::ostream& os, uint32_t offset) {
+  std::ostringstream name;
+  Thread::DumpThreadOffset<kPointerSize>(name, offset);
+  if (gDisassembledCodeStats != nullptr) {
+    gDisassembledCodeStats->AddEntrypointReference(name.str());
+  }
+  os << name.str();
+}
+
+// Method names may contain any character of a dex string.
+static void DumpJsonString(std::ostream& os, std::string_view str) {
+  os << '"';
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      os << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20u) {
+      os << StringPrintf("\\u%04x", static_cast<uint32_t>(c));
+    } else {
+      os << c;
+    }
+  }
+  os << '"';
+}
+
 class OatDumperOptions {
  public:
   OatDumperOptions(bool dump_vmap,
@@ -345,7 +449,8 @@ class OatDumperOptions {
                    const char* export_dex_location,
                    const char* app_image,
                    const char* app_oat,
-                   uint32_t addr2instr)
+                   uint32_t addr2instr,
+                   const char* code_stats)
     : dump_vmap_(dump_vmap),
       dump_code_info_stack_maps_(dump_code_info_stack_maps),
       disassemble_code_(disassemble_code),
@@ -359,6 +464,7 @@ class OatDumperOptions {
       app_image_(app_image),
       app_oat_(app_oat),
       addr2instr_(addr2instr),
+      code_stats_(code_stats),
       class_loader_(nullptr) {}
 
   const bool dump_vmap_;
@@ -374,6 +480,7 @@ class OatDumperOptions {
   const char* const app_image_;
   const char* const app_oat_;
   uint32_t addr2instr_;
+  const char* const code_stats_;
   Handle<mirror::ClassLoader>* class_loader_;
 };
 
@@ -692,6 +799,10 @@ class OatDumper {
       }
     }
 
+    if (options_.code_stats_ != nullptr && !DumpCodeStats(os, options_.code_stats_)) {
+      success = false;
+    }
+
     {
       os << "OAT FILE STATS:\n";
       VariableIndentationOutputStream vios(&os);
@@ -1545,6 +1656,171 @@ class OatDumper {
     }
   }
 
+  // Writes the --code-stats of the methods compiled by the optimizing compiler to `file_name`,
+  // as one JSON object with the totals of the oat file and an entry per method. The class and
+  // method filters apply.
+  bool DumpCodeStats(std::ostream& os, const char* file_name) {
+    std::unique_ptr<Disassembler> disassembler(Disassembler::Create(
+        instruction_set_,
+        new DisassemblerOptions(/* absolute_addresses= */ false,
+                                oat_file_.Begin(),
+                                oat_file_.End(),
+                                /* can_read_literals= */ false,
+                                Is64BitInstructionSet(instruction_set_)
+                                    ? &CountThreadOffset<PointerSize::k64>
+                                    : &CountThreadOffset<PointerSize::k32>)));
+    // The disassembly itself is discarded.
+    std::ostream null_os(nullptr);
+    CodeStats totals;
+    size_t methods = 0u;
+    std::ostringstream methods_json;
+    const char* separator = "\n";
+    for (const OatDexFile* oat_dex_file : oat_dex_files_) {
+      std::string error_msg;
+      const DexFile* const dex_file = OpenDexFile(oat_dex_file, &error_msg);
+      if (dex_file == nullptr) {
+        os << "Failed to open dex file '" << oat_dex_file->GetDexFileLocation() << "': "
+           << error_msg << "\n";
+        return false;
+      }
+      for (ClassAccessor accessor : dex_file->GetClasses()) {
+        if (DescriptorToDot(accessor.GetDescriptor()).find(options_.class_filter_) ==
+                std::string::npos) {
+          continue;
+        }
+        const OatFile::OatClass oat_class = oat_dex_file->GetOatClass(accessor.GetClassDefIndex());
+        uint32_t class_method_index = 0;
+        for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+          const OatFile::OatMethod oat_method = oat_class.GetOatMethod(class_method_index++);
+          CodeItemDataAccessor code_item_accessor(*dex_file, method.GetCodeItem());
+          uint32_t dex_method_idx = method.GetIndex();
+          if (!IsMethodGeneratedByOptimizingCompiler(oat_method, code_item_accessor)) {
+            continue;
+          }
+          uint64_t aligned_code_end =
+              AlignCodeOffset(oat_method.GetCodeOffset()) + oat_method.GetQuickCodeSize();
+          if (aligned_code_end > oat_file_.Size()) {
+            os << "WARNING: code of " << dex_file->PrettyMethod(dex_method_idx)
+               << " is past end of file, skipped in the code stats.\n";
+            continue;
+          }
+          std::string method_name = dex_file->GetMethodName(dex_file->GetMethodId(dex_method_idx));
+          if (method_name.find(options_.method_filter_) == std::string::npos) {
+            continue;
+          }
+
+          CodeStats stats;
+          std::map<std::string, size_t> inlined_methods;
+          ComputeCodeStats(*dex_file, oat_method, disassembler.get(), null_os, &stats,
+                           &inlined_methods);
+          totals.Add(stats);
+          ++methods;
+
+          methods_json << separator << "    {\"method\": ";
+          DumpJsonString(methods_json, dex_file->PrettyMethod(dex_method_idx));
+          methods_json << ", ";
+          stats.DumpJsonMembers(methods_json);
+          methods_json << ", \"inlined_methods\": [";
+          const char* inlined_separator = "";
+          for (const auto& [inlined_method, count] : inlined_methods) {
+            methods_json << inlined_separator << "{\"method\": ";
+            DumpJsonString(methods_json, inlined_method);
+            methods_json << ", \"inline_infos\": " << count << "}";
+            inlined_separator = ", ";
+          }
+          methods_json << "]}";
+          separator = ",\n";
+        }
+      }
+    }
+
+    std::ostringstream json;
+    json << "{\n  \"oat_file\": ";
+    DumpJsonString(json, oat_file_.GetLocation());
+    json << ",\n  \"instruction_set\": \"" << instruction_set_ << "\""
+         << ",\n  \"methods\": " << methods << ",\n  \"totals\": {";
+    totals.DumpJsonMembers(json);
+    json << "},\n  \"code\": [" << methods_json.str() << "\n  ]\n}\n";
+
+    std::unique_ptr<File> file(OS::CreateEmptyFile(file_name));
+    if (file == nullptr) {
+      os << "Failed to open code stats file " << file_name << "\n";
+      return false;
+    }
+    std::string contents = json.str();
+    if (!file->WriteFully(contents.data(), contents.size())) {
+      os << "Failed to write code stats file " << file_name << "\n";
+      file->Erase();
+      return false;
+    }
+    if (file->FlushCloseOrErase() != 0) {
+      os << "Flush and close of code stats file " << file_name << " failed\n";
+      return false;
+    }
+    os << "CODE STATS:\n" << methods << " methods written to " << file_name << "\n\n";
+    return true;
+  }
+
+  void ComputeCodeStats(const DexFile& dex_file,
+                        const OatFile::OatMethod& oat_method,
+                        Disassembler* disassembler,
+                        std::ostream& null_os,
+                        /*out*/ CodeStats* stats,
+                        /*out*/ std::map<std::string, size_t>* inlined_methods) {
+    stats->code_bytes = oat_method.GetQuickCodeSize();
+    stats->frame_bytes = oat_method.GetFrameSizeInBytes();
+    stats->core_spills = POPCOUNT(oat_method.GetCoreSpillMask());
+    stats->fp_spills = POPCOUNT(oat_method.GetFpSpillMask());
+
+    CodeInfo code_info(oat_method.GetVmapTable());
+    stats->stack_maps = code_info.GetNumberOfStackMaps();
+    for (const StackMap& stack_map : code_info.GetStackMaps()) {
+      for (const InlineInfo& inline_info : code_info.GetInlineInfosOf(stack_map)) {
+        ++stats->inline_infos;
+        ++(*inlined_methods)[GetInlinedMethodName(dex_file, code_info, inline_info)];
+      }
+    }
+
+    const uint8_t* quick_native_pc = reinterpret_cast<const uint8_t*>(oat_method.GetQuickCode());
+    size_t code_size = oat_method.GetQuickCodeSize();
+    gDisassembledCodeStats = stats;
+    for (size_t offset = 0; offset < code_size; ) {
+      offset += disassembler->Dump(null_os, quick_native_pc + offset);
+    }
+    gDisassembledCodeStats = nullptr;
+  }
+
+  std::string GetInlinedMethodName(const DexFile& dex_file,
+                                   const CodeInfo& code_info,
+                                   const InlineInfo& inline_info) {
+    if (inline_info.EncodesArtMethod()) {
+      // Only JIT code encodes the ArtMethod.
+      return StringPrintf("ArtMethod@%p", inline_info.GetArtMethod());
+    }
+    MethodInfo method_info = code_info.GetMethodInfoOf(inline_info);
+    uint32_t method_index = method_info.GetMethodIndex();
+    if (!method_info.HasDexFileIndex()) {
+      return dex_file.PrettyMethod(method_index);
+    }
+    uint32_t dex_file_index = method_info.GetDexFileIndex();
+    if (method_info.GetDexFileIndexKind() == MethodInfo::kKindBCP) {
+      Runtime* const runtime = Runtime::Current();
+      if (runtime != nullptr &&
+          dex_file_index < runtime->GetClassLinker()->GetBootClassPath().size()) {
+        const DexFile* bcp_dex_file = runtime->GetClassLinker()->GetBootClassPath()[dex_file_index];
+        return bcp_dex_file->PrettyMethod(method_index);
+      }
+      // Without a boot image, only the indexes are known.
+      return StringPrintf("bcp[%u]:%u", dex_file_index, method_index);
+    }
+    std::string error_msg;
+    const DexFile* other_dex_file = dex_file_index < oat_dex_files_.size()
+        ? OpenDexFile(oat_dex_files_[dex_file_index], &error_msg)
+        : nullptr;
+    return other_dex_file != nullptr ? other_dex_file->PrettyMethod(method_index)
+                                     : StringPrintf("dex[%u]:%u", dex_file_index, method_index);
+  }
+
   std::pair<const uint8_t*, const uint8_t*> GetBootImageLiveObjectsDataRange(gc::Heap* heap) const
       REQUIRES_SHARED(Locks::mutator_lock_) {
     const std::vector<gc::space::ImageSpace*>& boot_image_spaces = heap->GetBootImageSpaces();
@@ -3172,6 +3448,8 @@ struct OatdumpArgs : public CmdlineArgs {
       imt_dump_ = std::string(option.substr(strlen("--dump-imt=")));
     } else if (option == "--dump-imt-stats") {
       imt_stat_dump_ = true;
+    } else if (StartsWith(option, "--code-stats=")) {
+      code_stats_ = raw_option + strlen("--code-stats=");
     } else {
       return kParseUnknownArgument;
     }
@@ -3198,6 +3476,9 @@ struct OatdumpArgs : public CmdlineArgs {
     } else if (image_location_ != nullptr && oat_filename_ != nullptr) {
       *error_msg = "Either --image or --oat-file must be specified but not both";
       return kParseError;
+    } else if (code_stats_ != nullptr && oat_filename_ == nullptr) {
+      *error_msg = "--code-stats requires --oat-file";
+      return kParseError;
     }
 
     return kParseOk;
@@ -3277,7 +3558,15 @@ struct OatdumpArgs : public CmdlineArgs {
         "      Example: --dump-imt=imt.txt\n"
         "\n"
         "  --dump-imt-stats: output IMT statistics for the given boot image\n"
-        "      Example: --dump-imt-stats"
+        "      Example: --dump-imt-stats\n"
+        "\n"
+        "  --code-stats=<file.json>: write statistics of the code compiled by the optimizing\n"
+        "      compiler to the given file: per method and in total the code and frame size,\n"
+        "      the spilled registers, the stack maps, the inlined methods and the runtime\n"
+        "      calls, including the explicit null and bounds checks, read barriers, suspend\n"
+        "      checks and deoptimizations. Requires --oat-file. The class and method filters\n"
+        "      apply. Combine with --header-only to skip the full dump.\n"
+        "      Example: --oat-file=boot.oat --header-only --code-stats=boot-code.json\n"
         "\n";
 
     return usage;
@@ -3304,6 +3593,7 @@ struct OatdumpArgs : public CmdlineArgs {
   const char* export_dex_location_ = nullptr;
   const char* app_image_ = nullptr;
   const char* app_oat_ = nullptr;
+  const char* code_stats_ = nullptr;
 };
 
 struct OatdumpMain : public CmdlineMain<OatdumpArgs> {
@@ -3326,7 +3616,8 @@ struct OatdumpMain : public CmdlineMain<OatdumpArgs> {
         args_->export_dex_location_,
         args_->app_image_,
         args_->app_oat_,
-        args_->addr2instr_));
+        args_->addr2instr_,
+        args_->code_stats_));
 
     return (args_->boot_image_location_ != nullptr ||
             args_->image_location_ != nullptr ||
@@ -121,4 +121,18 @@ TEST_F(OatDumpTest, TestExportDexStatic) {
   ASSERT_TRUE(Exec(Flavor::kStatic, kModeOat, {"--export-dex-to=" + tmp_dir_}, kListOnly));
 }
 
+TEST_F(OatDumpTest, TestCodeStats) {
+  TEST_DISABLED_FOR_RISCV64();
+  ASSERT_TRUE(GenerateAppOdexFile(Flavor::kDynamic, {"--runtime-arg", "-Xmx64M"}));
+  const std::string code_stats = tmp_dir_ + "/code_stats.json";
+  ASSERT_TRUE(Exec(Flavor::kDynamic,
+                   kModeOat,
+                   {"--header-only", "--code-stats=" + code_stats},
+                   kListOnly));
+  std::string contents;
+  ASSERT_TRUE(android::base::ReadFileToString(code_stats, &contents));
+  EXPECT_NE(contents.find("\"totals\": {\"code_bytes\": "), std::string::npos) << contents;
+  EXPECT_NE(contents.find("\"inlined_methods\": ["), std::string::npos) << contents;
+}
+
 }  // namespace art
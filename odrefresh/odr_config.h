@@ -52,6 +52,7 @@ const std::unordered_set<std::string> kIgnoredSystemProperties{
     "dalvik.vm.dex2oat-threads",
     "dalvik.vm.boot-dex2oat-cpu-set",
     "dalvik.vm.boot-dex2oat-threads",
+    "dalvik.vm.boot-dex2oat-parallel-jobs",
     "dalvik.vm.restore-dex2oat-cpu-set",
     "dalvik.vm.restore-dex2oat-threads",
     "dalvik.vm.background-dex2oat-cpu-set",
@@ -20,6 +20,7 @@
 #include <fcntl.h>
 #include <inttypes.h>
 #include <limits.h>
+#include <sched.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/stat.h>
@@ -28,6 +29,7 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <condition_variable>
 #include <cstdarg>
 #include <cstdint>
 #include <cstdio>
@@ -40,6 +42,7 @@
 #include <iostream>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <ostream>
 #include <set>
@@ -47,6 +50,7 @@
 #include <string>
 #include <string_view>
 #include <system_error>
+#include <thread>
 #include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
@@ -109,6 +113,7 @@ using ::android::base::Join;
 using ::android::base::ParseBool;
 using ::android::base::ParseBoolResult;
 using ::android::base::ParseInt;
+using ::android::base::ParseUint;
 using ::android::base::Result;
 using ::android::base::SetProperty;
 using ::android::base::Split;
@@ -283,22 +288,49 @@ Result<void> CheckComponents(
   return {};
 }
 
-Result<void> CheckSystemServerComponents(
+// Returns the system server jars whose artifacts depend on a component that differs between
+// `expected_components` and `actual_components`. A jar on SYSTEMSERVERCLASSPATH is compiled against
+// the classpath jars before it and a standalone jar against the whole classpath, so a change to a
+// classpath jar invalidates the artifacts of all the jars after it. Returns an error if the
+// components don't correspond to the same jars, in which case all artifacts are invalid.
+Result<std::set<std::string>> GetStaleSystemServerJars(
     const std::vector<art_apex::SystemServerComponent>& expected_components,
     const std::vector<art_apex::SystemServerComponent>& actual_components) {
-  return CheckComponents<art_apex::SystemServerComponent>(
-      expected_components,
-      actual_components,
-      [](const art_apex::SystemServerComponent& expected,
-         const art_apex::SystemServerComponent& actual) -> Result<void> {
-        if (expected.getIsInClasspath() != actual.getIsInClasspath()) {
-          return Errorf("isInClasspath differs ({} != {})",
-                        expected.getIsInClasspath(),
-                        actual.getIsInClasspath());
-        }
+  if (expected_components.size() != actual_components.size()) {
+    return Errorf(
+        "Component count differs ({} != {})", expected_components.size(), actual_components.size());
+  }
 
-        return {};
-      });
+  std::set<std::string> stale_jars;
+  bool classpath_changed = false;
+  // Standalone jars come after the classpath jars, see the `OnDeviceRefresh` constructor.
+  for (size_t i = 0; i < expected_components.size(); ++i) {
+    const art_apex::SystemServerComponent& expected = expected_components[i];
+    const art_apex::SystemServerComponent& actual = actual_components[i];
+
+    if (expected.getFile() != actual.getFile()) {
+      return Errorf(
+          "Component {} file differs ('{}' != '{}')", i, expected.getFile(), actual.getFile());
+    }
+
+    if (expected.getIsInClasspath() != actual.getIsInClasspath()) {
+      return Errorf("Component {} isInClasspath differs ({} != {})",
+                    i,
+                    expected.getIsInClasspath(),
+                    actual.getIsInClasspath());
+    }
+
+    bool changed = expected.getSize() != actual.getSize() ||
+                   expected.getChecksums() != actual.getChecksums();
+    if (changed || classpath_changed) {
+      stale_jars.insert(expected.getFile());
+    }
+    if (changed && expected.getIsInClasspath()) {
+      classpath_changed = true;
+    }
+  }
+
+  return stale_jars;
 }
 
 template <typename T>
@@ -401,8 +433,71 @@ bool IsCpuSetSpecValid(const std::string& cpu_set) {
   return true;
 }
 
+std::string GetDex2OatCpuSetSpec(bool is_compilation_os) {
+  std::string cpu_set;
+  if (is_compilation_os) {
+    cpu_set = GetProperty("dalvik.vm.background-dex2oat-cpu-set", "");
+    if (cpu_set.empty()) {
+      cpu_set = GetProperty("dalvik.vm.dex2oat-cpu-set", "");
+    }
+  } else {
+    cpu_set = GetProperty("dalvik.vm.boot-dex2oat-cpu-set", "");
+  }
+  return cpu_set;
+}
+
+// Returns the CPUs that dex2oat invocations can share, or an empty vector on error.
+std::vector<int> GetDex2OatCpus(bool is_compilation_os) {
+  std::vector<int> cpus;
+  std::string cpu_set = GetDex2OatCpuSetSpec(is_compilation_os);
+  if (!cpu_set.empty()) {
+    for (const std::string& str : Split(cpu_set, ",")) {
+      int id;
+      if (!ParseInt(str, &id, 0)) {
+        return {};
+      }
+      cpus.push_back(id);
+    }
+    return cpus;
+  }
+
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  if (sched_getaffinity(/*pid=*/0, sizeof(mask), &mask) != 0) {
+    PLOG(WARNING) << "Failed to get the CPU affinity";
+    return {};
+  }
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &mask)) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+size_t GetMaxParallelDex2OatInvocations(bool is_compilation_os) {
+  if (is_compilation_os) {
+    return 1;
+  }
+  uint32_t jobs;
+  std::string value = GetProperty("dalvik.vm.boot-dex2oat-parallel-jobs", "");
+  if (value.empty() || !ParseUint(value, &jobs) || jobs == 0) {
+    return 1;
+  }
+  return jobs;
+}
+
+// If `cpu_set` is not empty, dex2oat runs in parallel with other invocations and is pinned to its
+// share of the CPUs.
 Result<void> AddDex2OatConcurrencyArguments(/*inout*/ std::vector<std::string>& args,
-                                            bool is_compilation_os) {
+                                            bool is_compilation_os,
+                                            const std::vector<int>& cpu_set) {
+  if (!cpu_set.empty()) {
+    args.push_back(ART_FORMAT("-j{}", cpu_set.size()));
+    args.push_back("--cpu-set=" + Join(cpu_set, ','));
+    return {};
+  }
+
   std::string threads;
   if (is_compilation_os) {
     threads = GetProperty("dalvik.vm.background-dex2oat-threads", "");
@@ -416,20 +511,12 @@ Result<void> AddDex2OatConcurrencyArguments(/*inout*/ std::vector<std::string>&
     args.push_back("-j" + threads);
   }
 
-  std::string cpu_set;
-  if (is_compilation_os) {
-    cpu_set = GetProperty("dalvik.vm.background-dex2oat-cpu-set", "");
-    if (cpu_set.empty()) {
-      cpu_set = GetProperty("dalvik.vm.dex2oat-cpu-set", "");
-    }
-  } else {
-    cpu_set = GetProperty("dalvik.vm.boot-dex2oat-cpu-set", "");
-  }
-  if (!cpu_set.empty()) {
-    if (!IsCpuSetSpecValid(cpu_set)) {
-      return Errorf("Invalid CPU set spec '{}'", cpu_set);
+  std::string cpu_set_spec = GetDex2OatCpuSetSpec(is_compilation_os);
+  if (!cpu_set_spec.empty()) {
+    if (!IsCpuSetSpecValid(cpu_set_spec)) {
+      return Errorf("Invalid CPU set spec '{}'", cpu_set_spec);
     }
-    args.push_back("--cpu-set=" + cpu_set);
+    args.push_back("--cpu-set=" + cpu_set_spec);
   }
 
   return {};
@@ -615,6 +702,103 @@ bool HasVettedDeviceSystemServerProfiles() {
 
 }  // namespace
 
+Dex2oatScheduler::Dex2oatScheduler(size_t max_parallel_invocations, std::vector<int> cpu_set)
+    : max_parallel_invocations_(std::max<size_t>(max_parallel_invocations, 1)),
+      cpu_set_(std::move(cpu_set)) {
+  if (!cpu_set_.empty()) {
+    // Each invocation needs at least one CPU of its own.
+    max_parallel_invocations_ = std::min(max_parallel_invocations_, cpu_set_.size());
+  }
+}
+
+size_t Dex2oatScheduler::AddTask(Task task, const std::vector<size_t>& dependencies) {
+  size_t id = tasks_.size();
+  DCHECK(std::all_of(dependencies.begin(), dependencies.end(), [&](size_t dependency) {
+    return dependency < id;
+  }));
+  tasks_.push_back({std::move(task), dependencies});
+  return id;
+}
+
+std::vector<std::optional<CompilationResult>> Dex2oatScheduler::Run() {
+  std::vector<std::optional<CompilationResult>> results(tasks_.size());
+  std::vector<bool> started(tasks_.size(), false);
+  std::vector<bool> done(tasks_.size(), false);
+  std::vector<int> free_cpus = cpu_set_;
+  size_t num_running = 0;
+  size_t num_done = 0;
+  std::mutex lock;
+  std::condition_variable cond;
+  std::vector<std::thread> threads;
+
+  std::unique_lock<std::mutex> guard(lock);
+  while (num_done != tasks_.size()) {
+    // Dependencies have smaller ids than their dependents, so a single pass sees a task skipped
+    // because of a failure before its own dependents.
+    std::vector<size_t> ready;
+    for (size_t i = 0; i < tasks_.size(); ++i) {
+      if (started[i]) {
+        continue;
+      }
+      bool dependencies_done = true;
+      bool dependency_failed = false;
+      for (size_t dependency : tasks_[i].dependencies) {
+        if (!done[dependency]) {
+          dependencies_done = false;
+        } else if (!results[dependency].has_value() || !results[dependency]->IsOk()) {
+          dependency_failed = true;
+        }
+      }
+      if (dependency_failed) {
+        started[i] = true;
+        done[i] = true;
+        ++num_done;
+      } else if (dependencies_done) {
+        ready.push_back(i);
+      }
+    }
+
+    for (size_t j = 0; j < ready.size() && num_running < max_parallel_invocations_; ++j) {
+      std::vector<int> cpus;
+      if (!cpu_set_.empty()) {
+        size_t num_starting = std::min(ready.size() - j, max_parallel_invocations_ - num_running);
+        size_t num_cpus = free_cpus.size() / num_starting;
+        if (num_cpus == 0) {
+          // Wait for a running invocation to release its CPUs.
+          break;
+        }
+        cpus.assign(free_cpus.begin(), free_cpus.begin() + num_cpus);
+        free_cpus.erase(free_cpus.begin(), free_cpus.begin() + num_cpus);
+      }
+
+      size_t i = ready[j];
+      started[i] = true;
+      ++num_running;
+      threads.emplace_back([&, i, cpus = std::move(cpus)]() {
+        CompilationResult result = tasks_[i].task(cpus);
+        std::lock_guard<std::mutex> task_guard(lock);
+        results[i] = std::move(result);
+        done[i] = true;
+        ++num_done;
+        --num_running;
+        free_cpus.insert(free_cpus.end(), cpus.begin(), cpus.end());
+        std::sort(free_cpus.begin(), free_cpus.end());
+        cond.notify_one();
+      });
+    }
+
+    if (num_done != tasks_.size()) {
+      cond.wait(guard);
+    }
+  }
+  guard.unlock();
+
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  return results;
+}
+
 CompilationOptions CompilationOptions::CompileAll(const OnDeviceRefresh& odr) {
   CompilationOptions options;
   for (InstructionSet isa : odr.Config().GetBootClasspathIsas()) {
@@ -1258,24 +1442,38 @@ WARN_UNUSED PreconditionCheckResult OnDeviceRefresh::CheckPreconditionForData(
     cached_module_info_map[module_info.getName()] = &module_info;
   }
 
+  // APEXes that contribute to the boot classpath. The boot image mainline extension is compiled
+  // from all of them at once, so an update to any of them invalidates it.
+  std::unordered_set<std::string_view> bcp_apexes;
+  for (const std::string& jar : boot_classpath_jars_) {
+    std::string_view apex = ApexNameFromLocation(jar);
+    if (!apex.empty()) {
+      bcp_apexes.insert(apex);
+    }
+  }
+
   // Note that apex_info_list may omit APEXes that are included in cached_module_info - e.g. if an
   // apex used to be compilable, but now isn't. That won't be detected by this loop, but will be
   // detected below in CheckComponents.
+  //
+  // An update to an APEX that only contributes system_server jars doesn't invalidate anything by
+  // itself. The system_server components below tell which jars have actually changed.
+  bool system_server_apex_changed = false;
   for (const apex::ApexInfo& current_apex_info : apex_info_list) {
     auto& apex_name = current_apex_info.getModuleName();
 
     auto it = cached_module_info_map.find(apex_name);
     if (it == cached_module_info_map.end()) {
       LOG(INFO) << "Missing APEX info from cache-info (" << apex_name << ").";
-      return PreconditionCheckResult::BootImageMainlineExtensionNotOk(
-          OdrMetrics::Trigger::kApexVersionMismatch);
+    } else if (CheckModuleInfo(*it->second, current_apex_info)) {
+      continue;
     }
 
-    const art_apex::ModuleInfo* cached_module_info = it->second;
-    if (!CheckModuleInfo(*cached_module_info, current_apex_info)) {
+    if (bcp_apexes.count(apex_name) != 0) {
       return PreconditionCheckResult::BootImageMainlineExtensionNotOk(
           OdrMetrics::Trigger::kApexVersionMismatch);
     }
+    system_server_apex_changed = true;
   }
 
   const std::vector<art_apex::Component> current_bcp_components = GenerateBootClasspathComponents();
@@ -1315,13 +1513,25 @@ WARN_UNUSED PreconditionCheckResult OnDeviceRefresh::CheckPreconditionForData(
     return PreconditionCheckResult::SystemServerNotOk(OdrMetrics::Trigger::kApexVersionMismatch);
   }
 
-  result = CheckSystemServerComponents(current_system_server_components,
-                                       cached_system_server_components->getComponent());
-  if (!result.ok()) {
-    LOG(INFO) << "SystemServerComponents mismatch: " << result.error();
+  Result<std::set<std::string>> stale_jars = GetStaleSystemServerJars(
+      current_system_server_components, cached_system_server_components->getComponent());
+  if (!stale_jars.ok()) {
+    LOG(INFO) << "SystemServerComponents mismatch: " << stale_jars.error();
     return PreconditionCheckResult::SystemServerNotOk(OdrMetrics::Trigger::kDexFilesChanged);
   }
 
+  if (!stale_jars->empty()) {
+    LOG(INFO) << "SystemServerComponents changed: " << Join(*stale_jars, ':');
+    return PreconditionCheckResult::SystemServerNotOk(OdrMetrics::Trigger::kDexFilesChanged,
+                                                      std::move(*stale_jars));
+  }
+
+  if (system_server_apex_changed) {
+    // Nothing to recompile, but the cache info needs to be updated.
+    return PreconditionCheckResult::SystemServerNotOk(OdrMetrics::Trigger::kApexVersionMismatch,
+                                                      std::set<std::string>());
+  }
+
   return PreconditionCheckResult::AllOk();
 }
 
@@ -1440,6 +1650,30 @@ std::set<std::string> OnDeviceRefresh::CheckSystemServerArtifactsAreUpToDate(
   if (data_result.IsSystemServerOk()) {
     SystemServerArtifactsExist(
         /*on_system=*/false, &error_msg, &jars_missing_artifacts_on_data, checked_artifacts);
+  } else if (data_result.GetStaleSystemServerJars().has_value()) {
+    // Keep the artifacts of the jars that haven't changed. The stale artifacts are not kept, so
+    // that they are not taken for valid ones if their recompilation fails.
+    const std::set<std::string>& stale_jars = data_result.GetStaleSystemServerJars().value();
+    std::unordered_set<std::string> stale_artifacts;
+    for (const std::string& jar : stale_jars) {
+      const OdrArtifacts artifacts =
+          OdrArtifacts::ForSystemServer(GetSystemServerImagePath(/*on_system=*/false, jar));
+      stale_artifacts.insert(artifacts.ImagePath());
+      stale_artifacts.insert(artifacts.OatPath());
+      stale_artifacts.insert(artifacts.VdexPath());
+    }
+    std::vector<std::string> checked_data_artifacts;
+    SystemServerArtifactsExist(
+        /*on_system=*/false, &error_msg, &jars_missing_artifacts_on_data, &checked_data_artifacts);
+    if (checked_artifacts != nullptr) {
+      std::copy_if(checked_data_artifacts.begin(),
+                   checked_data_artifacts.end(),
+                   std::back_inserter(*checked_artifacts),
+                   [&](const std::string& artifact) {
+                     return stale_artifacts.count(artifact) == 0;
+                   });
+    }
+    jars_missing_artifacts_on_data.insert(stale_jars.begin(), stale_jars.end());
   } else {
     jars_missing_artifacts_on_data = AllSystemServerJars();
   }
@@ -1647,6 +1881,7 @@ WARN_UNUSED CompilationResult OnDeviceRefresh::RunDex2oat(
     const std::vector<std::string>& input_boot_images,
     const OdrArtifacts& artifacts,
     const std::vector<std::string>& extra_args,
+    const std::vector<int>& cpu_set,
     /*inout*/ std::vector<std::unique_ptr<File>>& readonly_files_raii) const {
   std::vector<std::string> args;
   args.push_back(config_.GetDex2Oat());
@@ -1654,7 +1889,8 @@ WARN_UNUSED CompilationResult OnDeviceRefresh::RunDex2oat(
   AddDex2OatCommonOptions(args);
   AddDex2OatDebugInfo(args);
   AddDex2OatInstructionSet(args, isa);
-  Result<void> result = AddDex2OatConcurrencyArguments(args, config_.GetCompilationOsMode());
+  Result<void> result =
+      AddDex2OatConcurrencyArguments(args, config_.GetCompilationOsMode(), cpu_set);
   if (!result.ok()) {
     return CompilationResult::Error(OdrMetrics::Status::kUnknown, result.error().message());
   }
@@ -1753,7 +1989,8 @@ OnDeviceRefresh::RunDex2oatForBootClasspath(const std::string& staging_dir,
                                             const std::vector<std::string>& dex_files,
                                             const std::vector<std::string>& boot_classpath,
                                             const std::vector<std::string>& input_boot_images,
-                                            const std::string& output_path) const {
+                                            const std::string& output_path,
+                                            const std::vector<int>& cpu_set) const {
   std::vector<std::string> args;
   std::vector<std::unique_ptr<File>> readonly_files_raii;
 
@@ -1809,6 +2046,7 @@ OnDeviceRefresh::RunDex2oatForBootClasspath(const std::string& staging_dir,
       input_boot_images,
       OdrArtifacts::ForBootImage(output_path),
       args,
+      cpu_set,
       readonly_files_raii);
 }
 
@@ -1816,7 +2054,8 @@ WARN_UNUSED CompilationResult
 OnDeviceRefresh::CompileBootClasspath(const std::string& staging_dir,
                                       InstructionSet isa,
                                       BootImages boot_images,
-                                      const std::function<void()>& on_dex2oat_success) const {
+                                      const std::function<void()>& on_dex2oat_success,
+                                      const std::vector<int>& cpu_set) const {
   DCHECK_GT(boot_images.Count(), 0);
   DCHECK_IMPLIES(boot_images.primary_boot_image, boot_images.boot_image_mainline_extension);
 
@@ -1839,7 +2078,8 @@ OnDeviceRefresh::CompileBootClasspath(const std::string& staging_dir,
         dex2oat_boot_classpath_jars_,
         dex2oat_boot_classpath_jars_,
         /*input_boot_images=*/{},
-        GetPrimaryBootImagePath(/*on_system=*/false, /*minimal=*/false, isa));
+        GetPrimaryBootImagePath(/*on_system=*/false, /*minimal=*/false, isa),
+        cpu_set);
     result.Merge(primary_result);
 
     if (primary_result.IsOk()) {
@@ -1875,7 +2115,8 @@ OnDeviceRefresh::CompileBootClasspath(const std::string& staging_dir,
         art_bcp_jars,
         art_bcp_jars,
         /*input_boot_images=*/{},
-        GetPrimaryBootImagePath(/*on_system=*/false, /*minimal=*/true, isa));
+        GetPrimaryBootImagePath(/*on_system=*/false, /*minimal=*/true, isa),
+        cpu_set);
     result.Merge(minimal_result);
 
     if (!minimal_result.IsOk()) {
@@ -1893,7 +2134,8 @@ OnDeviceRefresh::CompileBootClasspath(const std::string& staging_dir,
                                    GetMainlineBcpJars(),
                                    boot_classpath_jars_,
                                    GetBestBootImages(isa, /*include_mainline_extension=*/false),
-                                   GetBootImageMainlineExtensionPath(/*on_system=*/false, isa));
+                                   GetBootImageMainlineExtensionPath(/*on_system=*/false, isa),
+                                   cpu_set);
     result.Merge(mainline_result);
 
     if (mainline_result.IsOk()) {
@@ -1911,7 +2153,8 @@ OnDeviceRefresh::CompileBootClasspath(const std::string& staging_dir,
 WARN_UNUSED CompilationResult OnDeviceRefresh::RunDex2oatForSystemServer(
     const std::string& staging_dir,
     const std::string& dex_file,
-    const std::vector<std::string>& classloader_context) const {
+    const std::vector<std::string>& classloader_context,
+    const std::vector<int>& cpu_set) const {
   std::vector<std::string> args;
   std::vector<std::unique_ptr<File>> readonly_files_raii;
   InstructionSet isa = config_.GetSystemServerIsa();
@@ -1962,41 +2205,28 @@ WARN_UNUSED CompilationResult OnDeviceRefresh::RunDex2oatForSystemServer(
                     GetBestBootImages(isa, /*include_mainline_extension=*/true),
                     OdrArtifacts::ForSystemServer(output_path),
                     args,
+                    cpu_set,
                     readonly_files_raii);
 }
 
 WARN_UNUSED CompilationResult
-OnDeviceRefresh::CompileSystemServer(const std::string& staging_dir,
-                                     const std::set<std::string>& system_server_jars_to_compile,
-                                     const std::function<void()>& on_dex2oat_success) const {
-  DCHECK(!system_server_jars_to_compile.empty());
-
-  CompilationResult result = CompilationResult::Ok();
-  std::vector<std::string> classloader_context;
-
+OnDeviceRefresh::CompileSystemServerJar(const std::string& staging_dir,
+                                        const std::string& jar,
+                                        const std::vector<std::string>& classloader_context,
+                                        const std::function<void()>& on_dex2oat_success,
+                                        const std::vector<int>& cpu_set) const {
   if (!check_compilation_space_()) {
-    LOG(ERROR) << "Compilation of system_server failed: Insufficient space";
+    LOG(ERROR) << ART_FORMAT("Compilation of {} failed: Insufficient space", Basename(jar));
     return CompilationResult::Error(OdrMetrics::Status::kNoSpace, "Insufficient space");
   }
 
-  for (const std::string& jar : all_systemserver_jars_) {
-    if (ContainsElement(system_server_jars_to_compile, jar)) {
-      CompilationResult current_result =
-          RunDex2oatForSystemServer(staging_dir, jar, classloader_context);
-      result.Merge(current_result);
-
-      if (current_result.IsOk()) {
-        on_dex2oat_success();
-      } else {
-        LOG(ERROR) << ART_FORMAT("Compilation of {} failed: {}", Basename(jar), result.error_msg);
-      }
-    }
-
-    if (ContainsElement(systemserver_classpath_jars_, jar)) {
-      classloader_context.emplace_back(jar);
-    }
+  CompilationResult result =
+      RunDex2oatForSystemServer(staging_dir, jar, classloader_context, cpu_set);
+  if (result.IsOk()) {
+    on_dex2oat_success();
+  } else {
+    LOG(ERROR) << ART_FORMAT("Compilation of {} failed: {}", Basename(jar), result.error_msg);
   }
-
   return result;
 }
 
@@ -2054,7 +2284,9 @@ WARN_UNUSED ExitCode OnDeviceRefresh::Compile(OdrMetrics& metrics,
   uint32_t dex2oat_invocation_count = 0;
   uint32_t total_dex2oat_invocation_count = compilation_options.CompilationUnitCount();
   ReportNextBootAnimationProgress(dex2oat_invocation_count, total_dex2oat_invocation_count);
+  std::mutex animation_progress_lock;
   auto advance_animation_progress = [&]() {
+    std::lock_guard<std::mutex> guard(animation_progress_lock);
     ReportNextBootAnimationProgress(++dex2oat_invocation_count, total_dex2oat_invocation_count);
   };
 
@@ -2062,31 +2294,77 @@ WARN_UNUSED ExitCode OnDeviceRefresh::Compile(OdrMetrics& metrics,
   DCHECK(!bcp_instruction_sets.empty() && bcp_instruction_sets.size() <= 2);
   InstructionSet system_server_isa = config_.GetSystemServerIsa();
 
-  bool system_server_isa_failed = false;
-  std::optional<std::pair<OdrMetrics::Stage, OdrMetrics::Status>> first_failure;
+  // The boot classpath of each ISA is compiled independently. The system_server jars only depend on
+  // the boot images of their ISA, not on each other, since their class loader context consists of
+  // dex files.
+  size_t max_parallel_invocations =
+      GetMaxParallelDex2OatInvocations(config_.GetCompilationOsMode());
+  std::vector<int> cpu_set;
+  if (max_parallel_invocations > 1) {
+    cpu_set = GetDex2OatCpus(config_.GetCompilationOsMode());
+  }
+  Dex2oatScheduler scheduler(max_parallel_invocations, std::move(cpu_set));
 
+  std::vector<size_t> bcp_tasks;
+  std::vector<size_t> system_server_dependencies;
   for (const auto& [isa, boot_images_to_generate] :
        compilation_options.boot_images_to_generate_for_isas) {
+    size_t task = scheduler.AddTask(
+        [&, isa = isa, boot_images = boot_images_to_generate](const std::vector<int>& cpus) {
+          return CompileBootClasspath(
+              staging_dir, isa, boot_images, advance_animation_progress, cpus);
+        });
+    bcp_tasks.push_back(task);
+    if (isa == system_server_isa) {
+      system_server_dependencies.push_back(task);
+    }
+  }
+
+  // Don't compile system server if the compilation of BCP for its ISA failed.
+  std::vector<size_t> system_server_tasks;
+  std::vector<std::string> classloader_context;
+  for (const std::string& jar : all_systemserver_jars_) {
+    if (ContainsElement(compilation_options.system_server_jars_to_compile, jar)) {
+      system_server_tasks.push_back(scheduler.AddTask(
+          [&, jar, classloader_context](const std::vector<int>& cpus) {
+            return CompileSystemServerJar(
+                staging_dir, jar, classloader_context, advance_animation_progress, cpus);
+          },
+          system_server_dependencies));
+    }
+
+    if (ContainsElement(systemserver_classpath_jars_, jar)) {
+      classloader_context.emplace_back(jar);
+    }
+  }
+
+  std::vector<std::optional<CompilationResult>> results = scheduler.Run();
+
+  std::optional<std::pair<OdrMetrics::Stage, OdrMetrics::Status>> first_failure;
+
+  for (size_t i = 0; i < bcp_tasks.size(); ++i) {
+    const auto& [isa, boot_images_to_generate] =
+        compilation_options.boot_images_to_generate_for_isas[i];
     OdrMetrics::Stage stage = (isa == bcp_instruction_sets.front()) ?
                                   OdrMetrics::Stage::kPrimaryBootClasspath :
                                   OdrMetrics::Stage::kSecondaryBootClasspath;
-    CompilationResult bcp_result =
-        CompileBootClasspath(staging_dir, isa, boot_images_to_generate, advance_animation_progress);
+    DCHECK(results[bcp_tasks[i]].has_value());
+    CompilationResult& bcp_result = results[bcp_tasks[i]].value();
     metrics.SetDex2OatResult(stage, bcp_result.elapsed_time_ms, bcp_result.dex2oat_result);
     metrics.SetBcpCompilationType(stage, boot_images_to_generate.GetTypeForMetrics());
     if (!bcp_result.IsOk()) {
-      if (isa == system_server_isa) {
-        system_server_isa_failed = true;
-      }
       first_failure = first_failure.value_or(std::make_pair(stage, bcp_result.status));
     }
   }
 
-  // Don't compile system server if the compilation of BCP failed.
-  if (!system_server_isa_failed && !compilation_options.system_server_jars_to_compile.empty()) {
+  // The system_server jars share their dependencies, so they have either all run or none has.
+  if (!system_server_tasks.empty() && results[system_server_tasks.front()].has_value()) {
     OdrMetrics::Stage stage = OdrMetrics::Stage::kSystemServerClasspath;
-    CompilationResult ss_result = CompileSystemServer(
-        staging_dir, compilation_options.system_server_jars_to_compile, advance_animation_progress);
+    CompilationResult ss_result = CompilationResult::Ok();
+    for (size_t task : system_server_tasks) {
+      DCHECK(results[task].has_value());
+      ss_result.Merge(results[task].value());
+    }
     metrics.SetDex2OatResult(stage, ss_result.elapsed_time_ms, ss_result.dex2oat_result);
     if (!ss_result.IsOk()) {
       first_failure = first_failure.value_or(std::make_pair(stage, ss_result.status));
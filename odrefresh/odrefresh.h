@@ -24,6 +24,7 @@
 #include <set>
 #include <string>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "android-base/function_ref.h"
@@ -122,11 +123,15 @@ class PreconditionCheckResult {
                                    /*boot_image_mainline_extension_ok=*/false,
                                    /*system_server_ok=*/false);
   }
-  static PreconditionCheckResult SystemServerNotOk(OdrMetrics::Trigger trigger) {
+  // If `stale_system_server_jars` is present, only the artifacts of those jars are invalid.
+  static PreconditionCheckResult SystemServerNotOk(
+      OdrMetrics::Trigger trigger,
+      std::optional<std::set<std::string>> stale_system_server_jars = std::nullopt) {
     return PreconditionCheckResult(trigger,
                                    /*primary_boot_image_ok=*/true,
                                    /*boot_image_mainline_extension_ok=*/true,
-                                   /*system_server_ok=*/false);
+                                   /*system_server_ok=*/false,
+                                   std::move(stale_system_server_jars));
   }
   static PreconditionCheckResult AllOk() {
     return PreconditionCheckResult(/*trigger=*/std::nullopt,
@@ -139,23 +144,62 @@ class PreconditionCheckResult {
   bool IsPrimaryBootImageOk() const { return primary_boot_image_ok_; }
   bool IsBootImageMainlineExtensionOk() const { return boot_image_mainline_extension_ok_; }
   bool IsSystemServerOk() const { return system_server_ok_; }
+  // Returns the system server jars whose artifacts are invalid, or `std::nullopt` if the artifacts
+  // of all of them are. Only meaningful if `IsSystemServerOk()` returns false.
+  const std::optional<std::set<std::string>>& GetStaleSystemServerJars() const {
+    return stale_system_server_jars_;
+  }
 
  private:
   // Use static factory methods instead.
   PreconditionCheckResult(std::optional<OdrMetrics::Trigger> trigger,
                           bool primary_boot_image_ok,
                           bool boot_image_mainline_extension_ok,
-                          bool system_server_ok)
+                          bool system_server_ok,
+                          std::optional<std::set<std::string>> stale_system_server_jars =
+                              std::nullopt)
       : trigger_(trigger),
         primary_boot_image_ok_(primary_boot_image_ok),
         boot_image_mainline_extension_ok_(boot_image_mainline_extension_ok),
-        system_server_ok_(system_server_ok) {}
+        system_server_ok_(system_server_ok),
+        stale_system_server_jars_(std::move(stale_system_server_jars)) {}
 
   // Indicates why the precondition is not okay, or `std::nullopt` if it's okay.
   std::optional<OdrMetrics::Trigger> trigger_;
   bool primary_boot_image_ok_;
   bool boot_image_mainline_extension_ok_;
   bool system_server_ok_;
+  std::optional<std::set<std::string>> stale_system_server_jars_;
+};
+
+// Runs dex2oat invocations in an order that honors their dependencies, up to
+// `max_parallel_invocations` of them at the same time. If `cpu_set` is not empty, each invocation is
+// pinned to a disjoint subset of it: an invocation that starts gets an equal share of the free CPUs
+// between itself and the other invocations that are ready to start.
+class Dex2oatScheduler final {
+ public:
+  // A task takes the CPUs to run dex2oat on, or an empty vector if dex2oat is not pinned.
+  using Task = std::function<CompilationResult(const std::vector<int>& cpu_set)>;
+
+  Dex2oatScheduler(size_t max_parallel_invocations, std::vector<int> cpu_set);
+
+  // Adds a task that runs once all of `dependencies`, which are ids returned by earlier calls, have
+  // succeeded. Returns the id of the task.
+  size_t AddTask(Task task, const std::vector<size_t>& dependencies = {});
+
+  // Runs all tasks and returns their results, indexed by task id. The result of a task is
+  // `std::nullopt` if it hasn't run because one of its dependencies has failed.
+  std::vector<std::optional<CompilationResult>> Run();
+
+ private:
+  struct TaskInfo {
+    Task task;
+    std::vector<size_t> dependencies;
+  };
+
+  size_t max_parallel_invocations_;
+  std::vector<int> cpu_set_;
+  std::vector<TaskInfo> tasks_;
 };
 
 class OnDeviceRefresh final {
@@ -333,6 +377,7 @@ class OnDeviceRefresh final {
              const std::vector<std::string>& input_boot_images,
              const OdrArtifacts& artifacts,
              const std::vector<std::string>& extra_args,
+             const std::vector<int>& cpu_set,
              /*inout*/ std::vector<std::unique_ptr<File>>& readonly_files_raii) const;
 
   WARN_UNUSED CompilationResult
@@ -342,23 +387,28 @@ class OnDeviceRefresh final {
                              const std::vector<std::string>& dex_files,
                              const std::vector<std::string>& boot_classpath,
                              const std::vector<std::string>& input_boot_images,
-                             const std::string& output_path) const;
+                             const std::string& output_path,
+                             const std::vector<int>& cpu_set) const;
 
   WARN_UNUSED CompilationResult
   CompileBootClasspath(const std::string& staging_dir,
                        InstructionSet isa,
                        BootImages boot_images,
-                       const std::function<void()>& on_dex2oat_success) const;
+                       const std::function<void()>& on_dex2oat_success,
+                       const std::vector<int>& cpu_set) const;
 
   WARN_UNUSED CompilationResult
   RunDex2oatForSystemServer(const std::string& staging_dir,
                             const std::string& dex_file,
-                            const std::vector<std::string>& classloader_context) const;
+                            const std::vector<std::string>& classloader_context,
+                            const std::vector<int>& cpu_set) const;
 
   WARN_UNUSED CompilationResult
-  CompileSystemServer(const std::string& staging_dir,
-                      const std::set<std::string>& system_server_jars_to_compile,
-                      const std::function<void()>& on_dex2oat_success) const;
+  CompileSystemServerJar(const std::string& staging_dir,
+                         const std::string& jar,
+                         const std::vector<std::string>& classloader_context,
+                         const std::function<void()>& on_dex2oat_success,
+                         const std::vector<int>& cpu_set) const;
 
   // Configuration to use.
   const OdrConfig& config_;
@@ -18,8 +18,11 @@
 
 #include <unistd.h>
 
+#include <algorithm>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string_view>
 #include <utility>
 #include <vector>
@@ -944,5 +947,69 @@ TEST_F(OdRefreshTest, CompileSystemServerChoosesBootImage_OnSystem) {
       ExitCode::kCompilationSuccess);
 }
 
+
+TEST(Dex2oatSchedulerTest, PartitionsCpusAndHonorsDependencies) {
+  std::mutex lock;
+  std::vector<std::vector<int>> cpu_sets(3);
+  std::vector<size_t> order;
+  auto make_task = [&](size_t index) {
+    return [&, index](const std::vector<int>& cpu_set) {
+      std::lock_guard<std::mutex> guard(lock);
+      cpu_sets[index] = cpu_set;
+      order.push_back(index);
+      return CompilationResult::Ok();
+    };
+  };
+
+  Dex2oatScheduler scheduler(/*max_parallel_invocations=*/2, /*cpu_set=*/{0, 1, 2, 3});
+  size_t first = scheduler.AddTask(make_task(0));
+  size_t second = scheduler.AddTask(make_task(1), {first});
+  size_t third = scheduler.AddTask(make_task(2));
+  std::vector<std::optional<CompilationResult>> results = scheduler.Run();
+
+  ASSERT_EQ(results.size(), 3u);
+  EXPECT_TRUE(results[first].has_value() && results[first]->IsOk());
+  EXPECT_TRUE(results[second].has_value() && results[second]->IsOk());
+  EXPECT_TRUE(results[third].has_value() && results[third]->IsOk());
+
+  // The two independent tasks start together and share the CPUs.
+  EXPECT_EQ(cpu_sets[0].size(), 2u);
+  EXPECT_EQ(cpu_sets[2].size(), 2u);
+  for (int cpu : cpu_sets[0]) {
+    EXPECT_FALSE(ContainsElement(cpu_sets[2], cpu));
+  }
+  EXPECT_FALSE(cpu_sets[1].empty());
+  auto position = [&](size_t index) { return std::find(order.begin(), order.end(), index); };
+  EXPECT_LT(position(0), position(1));
+}
+
+TEST(Dex2oatSchedulerTest, SkipsDependentsOfFailedTasks) {
+  bool dependent_ran = false;
+  Dex2oatScheduler scheduler(/*max_parallel_invocations=*/1, /*cpu_set=*/{});
+  size_t failing = scheduler.AddTask([](const std::vector<int>& cpu_set) {
+    EXPECT_TRUE(cpu_set.empty());
+    return CompilationResult::Error(OdrMetrics::Status::kIoError, "error");
+  });
+  size_t dependent = scheduler.AddTask(
+      [&](const std::vector<int>&) {
+        dependent_ran = true;
+        return CompilationResult::Ok();
+      },
+      {failing});
+  size_t transitive = scheduler.AddTask(
+      [&](const std::vector<int>&) {
+        dependent_ran = true;
+        return CompilationResult::Ok();
+      },
+      {dependent});
+  std::vector<std::optional<CompilationResult>> results = scheduler.Run();
+
+  ASSERT_TRUE(results[failing].has_value());
+  EXPECT_FALSE(results[failing]->IsOk());
+  EXPECT_FALSE(results[dependent].has_value());
+  EXPECT_FALSE(results[transitive].has_value());
+  EXPECT_FALSE(dependent_ran);
+}
+
 }  // namespace odrefresh
 }  // namespace art
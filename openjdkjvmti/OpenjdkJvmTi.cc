@@ -56,6 +56,7 @@
 #include "ti_breakpoint.h"
 #include "ti_class.h"
 #include "ti_dump.h"
+#include "ti_event_filter.h"
 #include "ti_extension.h"
 #include "ti_field.h"
 #include "ti_heap.h"
@@ -1460,6 +1461,7 @@ extern "C" bool ArtPlugin_Initialize() {
   ThreadUtil::Register(gEventHandler);
   ClassUtil::Register(gEventHandler);
   DumpUtil::Register(gEventHandler);
+  EventFilterUtil::Register(gEventHandler);
   MethodUtil::Register(gEventHandler);
   HeapExtensions::Register(gEventHandler);
   SearchUtil::Register();
@@ -108,6 +108,9 @@ struct ArtJvmTiEnv : public jvmtiEnv {
   std::unordered_set<Breakpoint> breakpoints GUARDED_BY(event_info_mutex_);
   std::unordered_set<const art::ShadowFrame*> notify_frames GUARDED_BY(event_info_mutex_);
 
+  // Runtime side filters of the filterable events, see EventFilter.
+  std::unordered_map<ArtJvmtiEvent, EventFilter> event_filters GUARDED_BY(event_info_mutex_);
+
   // RW lock to protect access to all of the event data.
   art::ReaderWriterMutex event_info_mutex_ DEFAULT_MUTEX_ACQUIRED_AFTER;
 
@@ -230,7 +230,6 @@ void DeoptManager::AddMethodBreakpoint(art::ArtMethod* method) {
 
   art::Thread* self = art::Thread::Current();
   method = method->GetCanonicalMethod();
-  bool is_default = method->IsDefault();
 
   art::ScopedThreadSuspension sts(self, art::ThreadState::kSuspended);
   deoptimization_status_lock_.ExclusiveLock(self);
@@ -256,9 +255,8 @@ void DeoptManager::AddMethodBreakpoint(art::ArtMethod* method) {
     // We are already interpreting everything so no need to do anything.
     deoptimization_status_lock_.ExclusiveUnlock(self);
     return;
-  } else if (is_default) {
-    AddDeoptimizeAllMethodsLocked(self);
   } else {
+    // For a default method this also deoptimizes the copies in the implementing classes.
     PerformLimitedDeoptimization(self, method);
   }
 }
@@ -270,7 +268,6 @@ void DeoptManager::RemoveMethodBreakpoint(art::ArtMethod* method) {
 
   art::Thread* self = art::Thread::Current();
   method = method->GetCanonicalMethod();
-  bool is_default = method->IsDefault();
 
   art::ScopedThreadSuspension sts(self, art::ThreadState::kSuspended);
   // Ideally we should do a ScopedSuspendAll right here to get the full mutator_lock_ that we might
@@ -293,11 +290,7 @@ void DeoptManager::RemoveMethodBreakpoint(art::ArtMethod* method) {
     deoptimization_status_lock_.ExclusiveUnlock(self);
     return;
   } else if (is_last_breakpoint) {
-    if (UNLIKELY(is_default)) {
-      RemoveDeoptimizeAllMethodsLocked(self);
-    } else {
-      PerformLimitedUndeoptimization(self, method);
-    }
+    PerformLimitedUndeoptimization(self, method);
   } else {
     // Another thread might be deoptimizing the very methods we just removed breakpoints from. Wait
     // for any deopts to finish before moving on.
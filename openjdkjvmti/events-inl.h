@@ -125,7 +125,8 @@ class ScopedEventDispatchEnvironment final : public art::ValueObject {
   fn(VMObjectAlloc,             ArtJvmtiEvent::kVmObjectAlloc)                         \
   fn(DdmPublishChunk,           ArtJvmtiEvent::kDdmPublishChunk)                       \
   fn(ObsoleteObjectCreated,     ArtJvmtiEvent::kObsoleteObjectCreated)                 \
-  fn(StructuralDexFileLoadHook, ArtJvmtiEvent::kStructuralDexFileLoadHook)
+  fn(StructuralDexFileLoadHook, ArtJvmtiEvent::kStructuralDexFileLoadHook)             \
+  fn(SampledObjectAlloc,        ArtJvmtiEvent::kSampledObjectAlloc)
 
 template <ArtJvmtiEvent kEvent>
 struct EventFnType {
@@ -295,6 +296,31 @@ inline void EventHandler::DispatchEvent(art::Thread* thread, JNIEnv* jnienv, Arg
   }
 }
 
+inline bool EventHandler::PassesEventFilter(ArtJvmTiEnv* env,
+                                            ArtJvmtiEvent event,
+                                            const EventFilterContext& filter) {
+  art::ReaderMutexLock lk(art::Thread::Current(), env->event_info_mutex_);
+  auto it = env->event_filters.find(event);
+  return it == env->event_filters.end() || it->second.Matches(filter);
+}
+
+template <ArtJvmtiEvent kEvent, typename ...Args>
+inline void EventHandler::DispatchFilteredEvent(art::Thread* thread,
+                                                const EventFilterContext& filter,
+                                                JNIEnv* jnienv,
+                                                Args... args) const {
+  art::ScopedThreadStateChange stsc(thread, art::ThreadState::kNative);
+  std::vector<impl::EventHandlerFunc<kEvent>> events = CollectEvents<kEvent>(thread,
+                                                                             jnienv,
+                                                                             args...);
+  const bool has_event_filters = HasEventFilters();
+  for (auto event : events) {
+    if (!has_event_filters || PassesEventFilter(event.env_, kEvent, filter)) {
+      ExecuteCallback<kEvent>(event, jnienv, args...);
+    }
+  }
+}
+
 template <ArtJvmtiEvent kEvent, typename ...Args>
 inline void EventHandler::DispatchEventOnEnv(
     ArtJvmTiEnv* env, art::Thread* thread, JNIEnv* jnienv, Args... args) const {
@@ -479,7 +505,8 @@ template <ArtJvmtiEvent kEvent>
 inline void EventHandler::DispatchClassLoadOrPrepareEvent(art::Thread* thread,
                                                           JNIEnv* jnienv,
                                                           jthread jni_thread,
-                                                          jclass klass) const {
+                                                          jclass klass,
+                                                          const EventFilterContext* filter) const {
   ScopedDisablePopFrame sdpf(thread);
   art::ScopedThreadStateChange stsc(thread, art::ThreadState::kNative);
   std::vector<impl::EventHandlerFunc<kEvent>> events = CollectEvents<kEvent>(thread,
@@ -488,7 +515,9 @@ inline void EventHandler::DispatchClassLoadOrPrepareEvent(art::Thread* thread,
                                                                              klass);
 
   for (auto event : events) {
-    ExecuteCallback<kEvent>(event, jnienv, jni_thread, klass);
+    if (filter == nullptr || PassesEventFilter(event.env_, kEvent, *filter)) {
+      ExecuteCallback<kEvent>(event, jnienv, jni_thread, klass);
+    }
   }
 }
 
@@ -497,14 +526,36 @@ inline void EventHandler::DispatchEvent<ArtJvmtiEvent::kClassLoad>(art::Thread*
                                                                    JNIEnv* jnienv,
                                                                    jthread jni_thread,
                                                                    jclass klass) const {
-  DispatchClassLoadOrPrepareEvent<ArtJvmtiEvent::kClassLoad>(thread, jnienv, jni_thread, klass);
+  DispatchClassLoadOrPrepareEvent<ArtJvmtiEvent::kClassLoad>(
+      thread, jnienv, jni_thread, klass, /*filter=*/ nullptr);
 }
 template <>
 inline void EventHandler::DispatchEvent<ArtJvmtiEvent::kClassPrepare>(art::Thread* thread,
                                                                       JNIEnv* jnienv,
                                                                       jthread jni_thread,
                                                                       jclass klass) const {
-  DispatchClassLoadOrPrepareEvent<ArtJvmtiEvent::kClassPrepare>(thread, jnienv, jni_thread, klass);
+  DispatchClassLoadOrPrepareEvent<ArtJvmtiEvent::kClassPrepare>(
+      thread, jnienv, jni_thread, klass, /*filter=*/ nullptr);
+}
+template <>
+inline void EventHandler::DispatchFilteredEvent<ArtJvmtiEvent::kClassLoad>(
+    art::Thread* thread,
+    const EventFilterContext& filter,
+    JNIEnv* jnienv,
+    jthread jni_thread,
+    jclass klass) const {
+  DispatchClassLoadOrPrepareEvent<ArtJvmtiEvent::kClassLoad>(
+      thread, jnienv, jni_thread, klass, HasEventFilters() ? &filter : nullptr);
+}
+template <>
+inline void EventHandler::DispatchFilteredEvent<ArtJvmtiEvent::kClassPrepare>(
+    art::Thread* thread,
+    const EventFilterContext& filter,
+    JNIEnv* jnienv,
+    jthread jni_thread,
+    jclass klass) const {
+  DispatchClassLoadOrPrepareEvent<ArtJvmtiEvent::kClassPrepare>(
+      thread, jnienv, jni_thread, klass, HasEventFilters() ? &filter : nullptr);
 }
 
 // Need to give a custom specialization for NativeMethodBind since it has to deal with an out
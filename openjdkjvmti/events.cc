@@ -103,6 +103,9 @@ jvmtiError ArtJvmtiEventCallbacks::Set(jint index, jvmtiExtensionEvent cb) {
     case static_cast<jint>(ArtJvmtiEvent::kStructuralDexFileLoadHook):
       StructuralDexFileLoadHook = reinterpret_cast<ArtJvmtiEventStructuralDexFileLoadHook>(cb);
       return OK;
+    case static_cast<jint>(ArtJvmtiEvent::kSampledObjectAlloc):
+      SampledObjectAlloc = reinterpret_cast<ArtJvmtiEventSampledObjectAlloc>(cb);
+      return OK;
     default:
       return ERR(ILLEGAL_ARGUMENT);
   }
@@ -120,6 +123,7 @@ bool IsExtensionEvent(ArtJvmtiEvent e) {
     case ArtJvmtiEvent::kDdmPublishChunk:
     case ArtJvmtiEvent::kObsoleteObjectCreated:
     case ArtJvmtiEvent::kStructuralDexFileLoadHook:
+    case ArtJvmtiEvent::kSampledObjectAlloc:
       return true;
     default:
       return false;
@@ -280,6 +284,30 @@ static void RunEventCallback(EventHandler* handler,
                                  args...);
 }
 
+// Same as RunEventCallback, for the events that can be filtered by the class and the method of
+// their location `method`.
+template<ArtJvmtiEvent kEvent, typename ...Args>
+static void RunFilteredEventCallback(EventHandler* handler,
+                                     art::Thread* self,
+                                     art::JNIEnvExt* jnienv,
+                                     art::ArtMethod* method,
+                                     Args... args)
+    REQUIRES_SHARED(art::Locks::mutator_lock_) {
+  if (LIKELY(!handler->HasEventFilters())) {
+    RunEventCallback<kEvent>(handler, self, jnienv, args...);
+    return;
+  }
+  std::string temp;
+  EventFilterContext filter = {method->GetDeclaringClass()->GetDescriptor(&temp),
+                               method->GetCanonicalMethod()};
+  ScopedLocalRef<jthread> thread_jni(jnienv, AddLocalRef<jthread>(jnienv, self->GetPeer()));
+  handler->DispatchFilteredEvent<kEvent>(self,
+                                         filter,
+                                         static_cast<JNIEnv*>(jnienv),
+                                         thread_jni.get(),
+                                         args...);
+}
+
 static void SetupDdmTracking(art::DdmCallback* listener, bool enable) {
   art::ScopedObjectAccess soa(art::Thread::Current());
   if (enable) {
@@ -348,6 +376,43 @@ class JvmtiEventAllocationListener : public AllocationManager::AllocationCallbac
   EventHandler* handler_;
 };
 
+// Receives the allocations that the heap sampler picked. The sampler cuts the TLABs at the sample
+// points, so, unlike the VMObjectAlloc event, this leaves the allocation fast paths enabled.
+class JvmtiSampledAllocationListener : public art::gc::AllocationListener {
+ public:
+  explicit JvmtiSampledAllocationListener(EventHandler* handler) : handler_(handler) {}
+
+  void ObjectAllocated(art::Thread* self, art::ObjPtr<art::mirror::Object>* obj, size_t byte_count)
+      override REQUIRES_SHARED(art::Locks::mutator_lock_) {
+    DCHECK_EQ(self, art::Thread::Current());
+
+    if (handler_->IsEventEnabledAnywhere(ArtJvmtiEvent::kSampledObjectAlloc)) {
+      art::StackHandleScope<1> hs(self);
+      auto h = hs.NewHandleWrapper(obj);
+      art::JNIEnvExt* jni_env = self->GetJniEnv();
+      ScopedLocalRef<jobject> object(
+          jni_env, jni_env->AddLocalReference<jobject>(*obj));
+      ScopedLocalRef<jclass> klass(
+          jni_env, jni_env->AddLocalReference<jclass>(obj->Ptr()->GetClass()));
+
+      RunEventCallback<ArtJvmtiEvent::kSampledObjectAlloc>(handler_,
+                                                           self,
+                                                           jni_env,
+                                                           object.get(),
+                                                           klass.get(),
+                                                           static_cast<jlong>(byte_count));
+    }
+  }
+
+ private:
+  EventHandler* handler_;
+};
+
+static void SetupSampledAllocationTracking(art::gc::AllocationListener* listener, bool enable) {
+  art::Runtime::Current()->GetHeap()->GetHeapSampler().SetSampleListener(
+      enable ? listener : nullptr);
+}
+
 static void SetupObjectAllocationTracking(bool enable) {
   // We must not hold the mutator lock here, but if we're in FastJNI, for example, we might. For
   // now, do a workaround: (possibly) acquire and release.
@@ -626,10 +691,11 @@ class JvmtiMethodTraceListener final : public art::instrumentation::Instrumentat
     if (!method->IsRuntimeMethod() &&
         event_handler_->IsEventEnabledAnywhere(ArtJvmtiEvent::kMethodEntry)) {
       art::JNIEnvExt* jnienv = self->GetJniEnv();
-      RunEventCallback<ArtJvmtiEvent::kMethodEntry>(event_handler_,
-                                                    self,
-                                                    jnienv,
-                                                    art::jni::EncodeArtMethod(method));
+      RunFilteredEventCallback<ArtJvmtiEvent::kMethodEntry>(event_handler_,
+                                                            self,
+                                                            jnienv,
+                                                            method,
+                                                            art::jni::EncodeArtMethod(method));
     }
   }
 
@@ -677,10 +743,11 @@ class JvmtiMethodTraceListener final : public art::instrumentation::Instrumentat
       art::JNIEnvExt* jnienv = self->GetJniEnv();
       ScopedLocalRef<jobject> return_jobj(jnienv, AddLocalRef<jobject>(jnienv, return_value.Get()));
       val.l = return_jobj.get();
-      RunEventCallback<ArtJvmtiEvent::kMethodExit>(
+      RunFilteredEventCallback<ArtJvmtiEvent::kMethodExit>(
           event_handler_,
           self,
           jnienv,
+          method,
           art::jni::EncodeArtMethod(method),
           /*was_popped_by_exception=*/ static_cast<jboolean>(JNI_FALSE),
           val);
@@ -725,10 +792,11 @@ class JvmtiMethodTraceListener final : public art::instrumentation::Instrumentat
       // 64bit integer is the largest value in the union so we should be fine simply copying it into
       // the union.
       val.j = return_value.GetJ();
-      RunEventCallback<ArtJvmtiEvent::kMethodExit>(
+      RunFilteredEventCallback<ArtJvmtiEvent::kMethodExit>(
           event_handler_,
           self,
           jnienv,
+          method,
           art::jni::EncodeArtMethod(method),
           /*was_popped_by_exception=*/ static_cast<jboolean>(JNI_FALSE),
           val);
@@ -749,10 +817,11 @@ class JvmtiMethodTraceListener final : public art::instrumentation::Instrumentat
       art::Handle<art::mirror::Throwable> old_exception(hs.NewHandle(self->GetException()));
       CHECK(!old_exception.IsNull());
       self->ClearException();
-      RunEventCallback<ArtJvmtiEvent::kMethodExit>(
+      RunFilteredEventCallback<ArtJvmtiEvent::kMethodExit>(
           event_handler_,
           self,
           jnienv,
+          method,
           art::jni::EncodeArtMethod(method),
           /*was_popped_by_exception=*/ static_cast<jboolean>(JNI_TRUE),
           val);
@@ -805,14 +874,15 @@ class JvmtiMethodTraceListener final : public art::instrumentation::Instrumentat
       ScopedLocalRef<jobject> fklass(jnienv,
                                      AddLocalRef<jobject>(jnienv,
                                                           field->GetDeclaringClass().Ptr()));
-      RunEventCallback<ArtJvmtiEvent::kFieldAccess>(event_handler_,
-                                                    self,
-                                                    jnienv,
-                                                    art::jni::EncodeArtMethod(method),
-                                                    static_cast<jlocation>(dex_pc),
-                                                    static_cast<jclass>(fklass.get()),
-                                                    this_ref.get(),
-                                                    art::jni::EncodeArtField(field));
+      RunFilteredEventCallback<ArtJvmtiEvent::kFieldAccess>(event_handler_,
+                                                            self,
+                                                            jnienv,
+                                                            method.Get(),
+                                                            art::jni::EncodeArtMethod(method),
+                                                            static_cast<jlocation>(dex_pc),
+                                                            static_cast<jclass>(fklass.get()),
+                                                            this_ref.get(),
+                                                            art::jni::EncodeArtField(field));
     }
   }
 
@@ -836,10 +906,11 @@ class JvmtiMethodTraceListener final : public art::instrumentation::Instrumentat
       ScopedLocalRef<jobject> fval(jnienv, AddLocalRef<jobject>(jnienv, new_val.Get()));
       jvalue val;
       val.l = fval.get();
-      RunEventCallback<ArtJvmtiEvent::kFieldModification>(
+      RunFilteredEventCallback<ArtJvmtiEvent::kFieldModification>(
           event_handler_,
           self,
           jnienv,
+          method.Get(),
           art::jni::EncodeArtMethod(method),
           static_cast<jlocation>(dex_pc),
           static_cast<jclass>(fklass.get()),
@@ -873,10 +944,11 @@ class JvmtiMethodTraceListener final : public art::instrumentation::Instrumentat
       // 64bit integer is the largest value in the union so we should be fine simply copying it into
       // the union.
       val.j = field_value.GetJ();
-      RunEventCallback<ArtJvmtiEvent::kFieldModification>(
+      RunFilteredEventCallback<ArtJvmtiEvent::kFieldModification>(
           event_handler_,
           self,
           jnienv,
+          method.Get(),
           art::jni::EncodeArtMethod(method),
           static_cast<jlocation>(dex_pc),
           static_cast<jclass>(fklass.get()),
@@ -1163,6 +1235,7 @@ static DeoptRequirement GetDeoptRequirement(ArtJvmtiEvent event, jthread thread)
     case ArtJvmtiEvent::kDdmPublishChunk:
     case ArtJvmtiEvent::kObsoleteObjectCreated:
     case ArtJvmtiEvent::kStructuralDexFileLoadHook:
+    case ArtJvmtiEvent::kSampledObjectAlloc:
       return DeoptRequirement::kNone;
   }
 }
@@ -1312,6 +1385,9 @@ void EventHandler::HandleEventType(ArtJvmtiEvent event, bool enable) {
     case ArtJvmtiEvent::kVmObjectAlloc:
       SetupObjectAllocationTracking(enable);
       return;
+    case ArtJvmtiEvent::kSampledObjectAlloc:
+      SetupSampledAllocationTracking(sampled_alloc_listener_.get(), enable);
+      return;
     case ArtJvmtiEvent::kGarbageCollectionStart:
     case ArtJvmtiEvent::kGarbageCollectionFinish:
       SetupGcPauseTracking(gc_pause_listener_.get(), event, enable);
@@ -1649,6 +1725,7 @@ void EventHandler::Shutdown() {
   // Just remove every possible event.
   art::Runtime::Current()->GetInstrumentation()->RemoveListener(method_trace_listener_.get(), ~0);
   AllocationManager::Get()->RemoveAllocListener();
+  art::Runtime::Current()->GetHeap()->GetHeapSampler().SetSampleListener(nullptr);
 }
 
 EventHandler::EventHandler()
@@ -1662,6 +1739,7 @@ EventHandler::EventHandler()
   method_trace_listener_.reset(new JvmtiMethodTraceListener(this));
   monitor_listener_.reset(new JvmtiMonitorListener(this));
   park_listener_.reset(new JvmtiParkListener(this));
+  sampled_alloc_listener_.reset(new JvmtiSampledAllocationListener(this));
 }
 
 EventHandler::~EventHandler() {
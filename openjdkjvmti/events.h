@@ -17,8 +17,12 @@
 #ifndef ART_OPENJDKJVMTI_EVENTS_H_
 #define ART_OPENJDKJVMTI_EVENTS_H_
 
+#include <atomic>
 #include <bitset>
+#include <string>
+#include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "android-base/logging.h"
@@ -38,6 +42,7 @@ class JvmtiGcPauseListener;
 class JvmtiMethodTraceListener;
 class JvmtiMonitorListener;
 class JvmtiParkListener;
+class JvmtiSampledAllocationListener;
 
 // an enum for ArtEvents. This differs from the JVMTI events only in that we distinguish between
 // retransformation capable and incapable loading
@@ -80,7 +85,8 @@ enum class ArtJvmtiEvent : jint {
     kDdmPublishChunk = JVMTI_MAX_EVENT_TYPE_VAL + 2,
     kObsoleteObjectCreated = JVMTI_MAX_EVENT_TYPE_VAL + 3,
     kStructuralDexFileLoadHook = JVMTI_MAX_EVENT_TYPE_VAL + 4,
-    kMaxNormalEventTypeVal = kStructuralDexFileLoadHook,
+    kSampledObjectAlloc = JVMTI_MAX_EVENT_TYPE_VAL + 5,
+    kMaxNormalEventTypeVal = kSampledObjectAlloc,
 
     // All that follow are events used to implement internal JVMTI functions. They are not settable
     // directly by agents.
@@ -116,6 +122,13 @@ using ArtJvmtiEventStructuralDexFileLoadHook = void (*)(jvmtiEnv *jvmti_env,
                                                         jint* new_dex_data_len,
                                                         unsigned char** new_dex_data);
 
+using ArtJvmtiEventSampledObjectAlloc = void (*)(jvmtiEnv *jvmti_env,
+                                                 JNIEnv* jni_env,
+                                                 jthread thread,
+                                                 jobject object,
+                                                 jclass object_klass,
+                                                 jlong size);
+
 // It is not enough to store a Thread pointer, as these may be reused. Use the pointer and the
 // thread id.
 // Note: We could just use the tid like tracing does.
@@ -131,7 +144,8 @@ struct ArtJvmtiEventCallbacks : jvmtiEventCallbacks {
   ArtJvmtiEventCallbacks()
       : DdmPublishChunk(nullptr),
         ObsoleteObjectCreated(nullptr),
-        StructuralDexFileLoadHook(nullptr) {
+        StructuralDexFileLoadHook(nullptr),
+        SampledObjectAlloc(nullptr) {
     memset(this, 0, sizeof(jvmtiEventCallbacks));
   }
 
@@ -144,6 +158,7 @@ struct ArtJvmtiEventCallbacks : jvmtiEventCallbacks {
   ArtJvmtiEventDdmPublishChunk DdmPublishChunk;
   ArtJvmtiEventObsoleteObjectCreated ObsoleteObjectCreated;
   ArtJvmtiEventStructuralDexFileLoadHook StructuralDexFileLoadHook;
+  ArtJvmtiEventSampledObjectAlloc SampledObjectAlloc;
 };
 
 bool IsExtensionEvent(jint e);
@@ -215,6 +230,30 @@ struct EventMasks {
   void HandleChangedCapabilities(const jvmtiCapabilities& caps, bool caps_added);
 };
 
+// What the event filters look at. It is computed while the thread is runnable, before the event
+// is dispatched, so that the filters can be applied without the mutator lock.
+struct EventFilterContext {
+  // The descriptor of the class of the event, or of the declaring class of its method.
+  std::string_view descriptor;
+  // The canonical method of the event location, null for class events.
+  art::ArtMethod* method;
+};
+
+// A runtime side filter of one event of one env, so that the events the agent would drop never
+// leave the runtime. Set with the com.android.art.events.*_event_filter extension functions.
+struct EventFilter {
+  // Class name patterns in descriptor form, for example "Ljava/lang/*" or "*/Foo;". A leading or
+  // trailing '*' matches any suffix or prefix.
+  std::vector<std::string> included_classes;
+  std::vector<std::string> excluded_classes;
+  // The methods the event is limited to, all methods if empty.
+  std::unordered_set<art::ArtMethod*> methods;
+
+  // Returns whether the event passes the filter: its class matches one of the included patterns
+  // if there are any and none of the excluded ones, and its method is one of the `methods`.
+  bool Matches(const EventFilterContext& context) const;
+};
+
 namespace impl {
 template <ArtJvmtiEvent kEvent> struct EventHandlerFunc { };
 }  // namespace impl
@@ -242,6 +281,16 @@ class EventHandler {
     return global_mask.Test(event);
   }
 
+  // Whether any env has ever set an event filter. Until then, the filterable events do not
+  // compute an EventFilterContext and do not look up the filters of the envs.
+  bool HasEventFilters() const {
+    return has_event_filters_.load(std::memory_order_relaxed);
+  }
+
+  void SetHasEventFilters() {
+    has_event_filters_.store(true, std::memory_order_relaxed);
+  }
+
   // Sets an internal event. Unlike normal JVMTI events internal events are not associated with any
   // particular jvmtiEnv and are refcounted. This refcounting is done to allow us to easily enable
   // events during functions and disable them during the requested event callback. Since these are
@@ -276,6 +325,17 @@ class EventHandler {
   inline void DispatchEvent(art::Thread* thread, JNIEnv* jnienv, Args... args) const
       REQUIRES(!envs_lock_);
 
+  // Dispatch an event that can be filtered by class and method (kClassLoad, kClassPrepare,
+  // kMethodEntry, kMethodExit, kFieldAccess and kFieldModification) to the envs whose event filter
+  // passes `filter`.
+  template <ArtJvmtiEvent kEvent, typename ...Args>
+  ALWAYS_INLINE
+  inline void DispatchFilteredEvent(art::Thread* thread,
+                                    const EventFilterContext& filter,
+                                    JNIEnv* jnienv,
+                                    Args... args) const
+      REQUIRES(!envs_lock_);
+
   // Tell the event handler capabilities were added/lost so it can adjust the sent events.If
   // caps_added is true then caps is all the newly set capabilities of the jvmtiEnv. If it is false
   // then caps is the set of all capabilities that were removed from the jvmtiEnv.
@@ -382,9 +442,16 @@ class EventHandler {
   ALWAYS_INLINE inline void DispatchClassLoadOrPrepareEvent(art::Thread* thread,
                                                             JNIEnv* jnienv,
                                                             jthread jni_thread,
-                                                            jclass klass) const
+                                                            jclass klass,
+                                                            const EventFilterContext* filter) const
       REQUIRES(!envs_lock_);
 
+  // Returns whether the filter of `event` of `env`, if any, passes `filter`.
+  ALWAYS_INLINE
+  static inline bool PassesEventFilter(ArtJvmTiEnv* env,
+                                       ArtJvmtiEvent event,
+                                       const EventFilterContext& filter);
+
   // Sets up the global state needed for the first/last enable of an event across all threads
   void HandleEventType(ArtJvmtiEvent event, bool enable);
   // Perform deopts required for enabling the event on the given thread. Null thread indicates
@@ -428,12 +495,16 @@ class EventHandler {
   std::unique_ptr<JvmtiMethodTraceListener> method_trace_listener_;
   std::unique_ptr<JvmtiMonitorListener> monitor_listener_;
   std::unique_ptr<JvmtiParkListener> park_listener_;
+  std::unique_ptr<JvmtiSampledAllocationListener> sampled_alloc_listener_;
 
   // True if frame pop has ever been enabled. Since we store pointers to stack frames we need to
   // continue to listen to this event even if it has been disabled.
   // TODO We could remove the listeners once all jvmtiEnvs have drained their shadow-frame vectors.
   bool frame_pop_enabled;
 
+  // Set once any env adds an event filter, see HasEventFilters().
+  std::atomic<bool> has_event_filters_{false};
+
   // The overall refcount for each internal event across all threads.
   std::array<int32_t, kInternalEventCount> internal_event_refcount_ GUARDED_BY(envs_lock_);
   // The refcount for each thread for each internal event.
@@ -83,6 +83,19 @@ class ObjectTagTable final : public JvmtiWeakTable<jlong> {
     return tmp;
   }
 
+  // Return the tags of the given object and of its class, or zero for untagged ones. The heap
+  // iteration functions need both for every object, so this only takes the lock once.
+  void GetTagAndClassTagOrZero(art::ObjPtr<art::mirror::Object> obj,
+                               /* out */ jlong* tag,
+                               /* out */ jlong* class_tag)
+      REQUIRES_SHARED(art::Locks::mutator_lock_)
+      REQUIRES(!allow_disallow_lock_) {
+    Lock();
+    *tag = GetTagOrZeroLocked(obj);
+    *class_tag = GetTagOrZeroLocked(obj->GetClass());
+    Unlock();
+  }
+
  protected:
   bool DoesHandleNullOnSweep() override;
   void HandleNullSweep(jlong tag) override;
@@ -283,8 +283,11 @@ struct ClassCallback : public art::ClassLoadCallback {
       ScopedLocalRef<jthread> thread_jni(
           thread->GetJniEnv(),
           peer.IsNull() ? nullptr : thread->GetJniEnv()->AddLocalReference<jthread>(peer));
-      event_handler->DispatchEvent<ArtJvmtiEvent::kClassLoad>(
+      std::string temp;
+      EventFilterContext filter = {klass->GetDescriptor(&temp), /*method=*/ nullptr};
+      event_handler->DispatchFilteredEvent<ArtJvmtiEvent::kClassLoad>(
           thread,
+          filter,
           static_cast<JNIEnv*>(thread->GetJniEnv()),
           thread_jni.get(),
           jklass.get());
@@ -310,8 +313,11 @@ struct ClassCallback : public art::ClassLoadCallback {
       ScopedLocalRef<jthread> thread_jni(
           thread->GetJniEnv(),
           peer.IsNull() ? nullptr : thread->GetJniEnv()->AddLocalReference<jthread>(peer));
-      event_handler->DispatchEvent<ArtJvmtiEvent::kClassPrepare>(
+      std::string temp;
+      EventFilterContext filter = {klass->GetDescriptor(&temp), /*method=*/ nullptr};
+      event_handler->DispatchFilteredEvent<ArtJvmtiEvent::kClassPrepare>(
           thread,
+          filter,
           static_cast<JNIEnv*>(thread->GetJniEnv()),
           thread_jni.get(),
           jklass.get());
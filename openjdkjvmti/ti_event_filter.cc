@@ -0,0 +1,183 @@
+/* Copyright (C) 2023 The Android Open Source Project
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This file implements interfaces from the file jvmti.h. This implementation
+ * is licensed under the same terms as the file jvmti.h.  The
+ * copyright and license information for the file jvmti.h follows.
+ *
+ * Copyright (c) 2003, 2011, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "ti_event_filter.h"
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+
+#include "android-base/strings.h"
+#include "art_jvmti.h"
+#include "art_method-inl.h"
+#include "events-inl.h"
+#include "jni/jni_internal.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace openjdkjvmti {
+
+static EventHandler* gEventHandler = nullptr;
+
+static bool MatchesClassPattern(std::string_view descriptor, std::string_view pattern) {
+  if (!pattern.empty() && pattern.front() == '*') {
+    return android::base::EndsWith(descriptor, pattern.substr(1));
+  } else if (!pattern.empty() && pattern.back() == '*') {
+    return android::base::StartsWith(descriptor, pattern.substr(0, pattern.size() - 1));
+  } else {
+    return descriptor == pattern;
+  }
+}
+
+bool EventFilter::Matches(const EventFilterContext& context) const {
+  if (!methods.empty() && methods.find(context.method) == methods.end()) {
+    return false;
+  }
+  auto matches = [&](const std::string& pattern) {
+    return MatchesClassPattern(context.descriptor, pattern);
+  };
+  if (!included_classes.empty() &&
+      std::none_of(included_classes.begin(), included_classes.end(), matches)) {
+    return false;
+  }
+  return std::none_of(excluded_classes.begin(), excluded_classes.end(), matches);
+}
+
+// Converts a class name pattern like "java.lang.*" or "*.Foo" to the descriptor form that
+// EventFilter matches, "Ljava/lang/*" or "*/Foo;". Returns false for malformed patterns.
+static bool ClassPatternToDescriptor(std::string_view pattern, std::string* descriptor) {
+  if (pattern == "*") {
+    *descriptor = "*";
+    return true;
+  }
+  const bool leading_wildcard = !pattern.empty() && pattern.front() == '*';
+  const bool trailing_wildcard = !leading_wildcard && !pattern.empty() && pattern.back() == '*';
+  std::string_view name = pattern.substr(leading_wildcard ? 1u : 0u,
+                                         pattern.size() - (leading_wildcard || trailing_wildcard));
+  if (name.empty() || name.find('*') != std::string_view::npos) {
+    return false;
+  }
+  std::string slashed(name);
+  std::replace(slashed.begin(), slashed.end(), '.', '/');
+  if (leading_wildcard) {
+    *descriptor = "*" + slashed + ";";
+  } else if (trailing_wildcard) {
+    *descriptor = "L" + slashed + "*";
+  } else {
+    *descriptor = "L" + slashed + ";";
+  }
+  return true;
+}
+
+static jvmtiError GetFilterableEvent(jvmtiEnv* env, jint event, ArtJvmtiEvent* art_event) {
+  *art_event = GetArtJvmtiEvent(ArtJvmTiEnv::AsArtJvmTiEnv(env), static_cast<jvmtiEvent>(event));
+  switch (*art_event) {
+    case ArtJvmtiEvent::kClassLoad:
+    case ArtJvmtiEvent::kClassPrepare:
+    case ArtJvmtiEvent::kMethodEntry:
+    case ArtJvmtiEvent::kMethodExit:
+    case ArtJvmtiEvent::kFieldAccess:
+    case ArtJvmtiEvent::kFieldModification:
+      return OK;
+    default:
+      return ERR(ILLEGAL_ARGUMENT);
+  }
+}
+
+void EventFilterUtil::Register(EventHandler* event_handler) {
+  gEventHandler = event_handler;
+}
+
+jvmtiError EventFilterUtil::AddClassEventFilter(jvmtiEnv* env,
+                                                jint event,
+                                                const char* class_pattern,
+                                                jboolean exclude) {
+  if (class_pattern == nullptr) {
+    return ERR(NULL_POINTER);
+  }
+  ArtJvmtiEvent art_event;
+  jvmtiError error = GetFilterableEvent(env, event, &art_event);
+  if (error != OK) {
+    return error;
+  }
+  std::string descriptor;
+  if (!ClassPatternToDescriptor(class_pattern, &descriptor)) {
+    return ERR(ILLEGAL_ARGUMENT);
+  }
+  ArtJvmTiEnv* tienv = ArtJvmTiEnv::AsArtJvmTiEnv(env);
+  {
+    art::WriterMutexLock lk(art::Thread::Current(), tienv->event_info_mutex_);
+    EventFilter& filter = tienv->event_filters[art_event];
+    (exclude ? filter.excluded_classes : filter.included_classes).push_back(descriptor);
+  }
+  gEventHandler->SetHasEventFilters();
+  return OK;
+}
+
+jvmtiError EventFilterUtil::AddMethodEventFilter(jvmtiEnv* env, jint event, jmethodID method) {
+  if (method == nullptr) {
+    return ERR(INVALID_METHODID);
+  }
+  ArtJvmtiEvent art_event;
+  jvmtiError error = GetFilterableEvent(env, event, &art_event);
+  if (error != OK) {
+    return error;
+  }
+  if (art_event == ArtJvmtiEvent::kClassLoad || art_event == ArtJvmtiEvent::kClassPrepare) {
+    // Class events have no location.
+    return ERR(ILLEGAL_ARGUMENT);
+  }
+  art::ArtMethod* art_method;
+  {
+    art::ScopedObjectAccess soa(art::Thread::Current());
+    art_method = art::jni::DecodeArtMethod(method)->GetCanonicalMethod();
+  }
+  ArtJvmTiEnv* tienv = ArtJvmTiEnv::AsArtJvmTiEnv(env);
+  {
+    art::WriterMutexLock lk(art::Thread::Current(), tienv->event_info_mutex_);
+    tienv->event_filters[art_event].methods.insert(art_method);
+  }
+  gEventHandler->SetHasEventFilters();
+  return OK;
+}
+
+jvmtiError EventFilterUtil::ClearEventFilters(jvmtiEnv* env, jint event) {
+  ArtJvmtiEvent art_event;
+  jvmtiError error = GetFilterableEvent(env, event, &art_event);
+  if (error != OK) {
+    return error;
+  }
+  ArtJvmTiEnv* tienv = ArtJvmTiEnv::AsArtJvmTiEnv(env);
+  art::WriterMutexLock lk(art::Thread::Current(), tienv->event_info_mutex_);
+  tienv->event_filters.erase(art_event);
+  return OK;
+}
+
+}  // namespace openjdkjvmti
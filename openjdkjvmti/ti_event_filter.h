@@ -0,0 +1,65 @@
+/* Copyright (C) 2023 The Android Open Source Project
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This file implements interfaces from the file jvmti.h. This implementation
+ * is licensed under the same terms as the file jvmti.h.  The
+ * copyright and license information for the file jvmti.h follows.
+ *
+ * Copyright (c) 2003, 2011, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#ifndef ART_OPENJDKJVMTI_TI_EVENT_FILTER_H_
+#define ART_OPENJDKJVMTI_TI_EVENT_FILTER_H_
+
+#include "jni.h"
+#include "jvmti.h"
+
+namespace openjdkjvmti {
+
+class EventHandler;
+
+// Extension functions that set the runtime side event filters of an env, see EventFilter.
+class EventFilterUtil {
+ public:
+  static void Register(EventHandler* event_handler);
+
+  // Only send `event` for classes whose name matches `class_pattern`, or with `exclude` for
+  // classes whose name does not match it. The pattern is a class name such as "java.lang.Object",
+  // with an optional '*' wildcard at the start or at the end, like the JDWP ClassMatch and
+  // ClassExclude modifiers.
+  static jvmtiError AddClassEventFilter(jvmtiEnv* env,
+                                        jint event,
+                                        const char* class_pattern,
+                                        jboolean exclude);
+
+  // Only send `event` for locations in `method` or in the other methods added for the event.
+  static jvmtiError AddMethodEventFilter(jvmtiEnv* env, jint event, jmethodID method);
+
+  // Remove all the filters of `event`.
+  static jvmtiError ClearEventFilters(jvmtiEnv* env, jint event);
+};
+
+}  // namespace openjdkjvmti
+
+#endif  // ART_OPENJDKJVMTI_TI_EVENT_FILTER_H_
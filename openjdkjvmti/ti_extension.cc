@@ -41,6 +41,7 @@
 #include "ti_class.h"
 #include "ti_ddms.h"
 #include "ti_dump.h"
+#include "ti_event_filter.h"
 #include "ti_heap.h"
 #include "ti_logging.h"
 #include "ti_monitor.h"
@@ -396,6 +397,85 @@ jvmtiError ExtensionUtil::GetExtensionFunctions(jvmtiEnv* env,
     return error;
   }
 
+  // SetHeapSamplingInterval
+  error = add_extension(
+      reinterpret_cast<jvmtiExtensionFunction>(HeapExtensions::SetHeapSamplingInterval),
+      "com.android.art.heap.set_heap_sampling_interval",
+      "Sets the mean number of bytes allocated between two sampled_object_alloc events. The"
+      " distances between samples follow a geometric distribution with this mean. An interval of 0"
+      " samples every allocation. The interval is shared with the Java heap profiler of"
+      " Perfetto; the last value set applies.",
+      {
+        { "sampling_interval", JVMTI_KIND_IN, JVMTI_TYPE_JINT, false },
+      },
+      {
+         ERR(ILLEGAL_ARGUMENT),
+      });
+  if (error != ERR(NONE)) {
+    return error;
+  }
+
+  // AddClassEventFilter
+  error = add_extension(
+      reinterpret_cast<jvmtiExtensionFunction>(EventFilterUtil::AddClassEventFilter),
+      "com.android.art.events.add_class_event_filter",
+      "Only sends the 'event' to this environment for classes whose name matches 'class_pattern',"
+      " or with 'exclude' set for classes whose name does not match it. The pattern is a class"
+      " name like \"java.lang.Object\" that may start or end with a '*' wildcard, as for the JDWP"
+      " ClassMatch and ClassExclude modifiers. An event passes if it matches any of the included"
+      " patterns, if there are any, and none of the excluded ones. The class of a method or"
+      " field event is the declaring class of the method of its location. Supported events are"
+      " ClassLoad, ClassPrepare, MethodEntry, MethodExit, FieldAccess and FieldModification."
+      " Filtered events never leave the runtime, which is much cheaper than dropping them in"
+      " the agent.",
+      {
+        { "event", JVMTI_KIND_IN, JVMTI_TYPE_JINT, false },
+        { "class_pattern", JVMTI_KIND_IN_BUF, JVMTI_TYPE_CCHAR, false },
+        { "exclude", JVMTI_KIND_IN, JVMTI_TYPE_JBOOLEAN, false },
+      },
+      {
+         ERR(NULL_POINTER),
+         ERR(ILLEGAL_ARGUMENT),
+      });
+  if (error != ERR(NONE)) {
+    return error;
+  }
+
+  // AddMethodEventFilter
+  error = add_extension(
+      reinterpret_cast<jvmtiExtensionFunction>(EventFilterUtil::AddMethodEventFilter),
+      "com.android.art.events.add_method_event_filter",
+      "Only sends the 'event' to this environment for locations in 'method' or in the other"
+      " methods added for the event, like the JDWP LocationOnly modifier. Supported events are"
+      " MethodEntry, MethodExit, FieldAccess and FieldModification. Use SetEventNotificationMode"
+      " with a thread to limit events to a thread.",
+      {
+        { "event", JVMTI_KIND_IN, JVMTI_TYPE_JINT, false },
+        { "method", JVMTI_KIND_IN, JVMTI_TYPE_JMETHODID, false },
+      },
+      {
+         ERR(INVALID_METHODID),
+         ERR(ILLEGAL_ARGUMENT),
+      });
+  if (error != ERR(NONE)) {
+    return error;
+  }
+
+  // ClearEventFilters
+  error = add_extension(
+      reinterpret_cast<jvmtiExtensionFunction>(EventFilterUtil::ClearEventFilters),
+      "com.android.art.events.clear_event_filters",
+      "Removes the class and method filters of the 'event' of this environment.",
+      {
+        { "event", JVMTI_KIND_IN, JVMTI_TYPE_JINT, false },
+      },
+      {
+         ERR(ILLEGAL_ARGUMENT),
+      });
+  if (error != ERR(NONE)) {
+    return error;
+  }
+
   // These require index-ids and debuggable to function
   art::Runtime* runtime = art::Runtime::Current();
   if (runtime->GetJniIdType() == art::JniIdType::kIndices && IsFullJvmtiAvailable()) {
@@ -701,6 +781,25 @@ jvmtiError ExtensionUtil::GetExtensionEvents(jvmtiEnv* env,
   if (error != OK) {
     return error;
   }
+  error = add_extension(
+      ArtJvmtiEvent::kSampledObjectAlloc,
+      "com.android.art.heap.sampled_object_alloc",
+      "Called for a sample of the allocations of java objects, on the allocating thread, once the"
+      " object is initialized. Samples are taken on average every"
+      " 'com.android.art.heap.set_heap_sampling_interval' bytes allocated, 4 KB by default."
+      " This is the SampledObjectAlloc event of JVMTI 11. Unlike VMObjectAlloc, enabling it does"
+      " not disable the allocation fast paths. The arguments are identical to the ones of the"
+      " VMObjectAlloc event and have the same semantics.",
+      {
+        { "jni_env", JVMTI_KIND_IN, JVMTI_TYPE_JNIENV, false },
+        { "thread", JVMTI_KIND_IN, JVMTI_TYPE_JTHREAD, false },
+        { "object", JVMTI_KIND_IN, JVMTI_TYPE_JOBJECT, false },
+        { "klass", JVMTI_KIND_IN, JVMTI_TYPE_JCLASS, false },
+        { "size", JVMTI_KIND_IN, JVMTI_TYPE_JLONG, false },
+      });
+  if (error != OK) {
+    return error;
+  }
   art::Runtime* runtime = art::Runtime::Current();
   if (runtime->GetJniIdType() == art::JniIdType::kIndices && IsFullJvmtiAvailable()) {
     error = add_extension(
@@ -122,8 +122,9 @@ jint ReportString(art::ObjPtr<art::mirror::Object> obj,
       }
     }
 
-    const jlong class_tag = tag_table->GetTagOrZero(obj->GetClass());
-    jlong string_tag = tag_table->GetTagOrZero(obj.Ptr());
+    jlong class_tag;
+    jlong string_tag;
+    tag_table->GetTagAndClassTagOrZero(obj, &string_tag, &class_tag);
     const jlong saved_string_tag = string_tag;
 
     jint result = cb->string_primitive_value_callback(class_tag,
@@ -165,8 +166,9 @@ jint ReportPrimitiveArray(art::ObjPtr<art::mirror::Object> obj,
            prim_type == JVMTI_PRIMITIVE_TYPE_FLOAT ||
            prim_type == JVMTI_PRIMITIVE_TYPE_DOUBLE);
 
-    const jlong class_tag = tag_table->GetTagOrZero(obj->GetClass());
-    jlong array_tag = tag_table->GetTagOrZero(obj.Ptr());
+    jlong class_tag;
+    jlong array_tag;
+    tag_table->GetTagAndClassTagOrZero(obj, &array_tag, &class_tag);
     const jlong saved_array_tag = array_tag;
 
     jint result;
@@ -766,24 +768,23 @@ static jvmtiError DoIterateThroughHeap(T fn,
 
     art::ScopedAssertNoThreadSuspension no_suspension("IterateThroughHeapCallback");
 
-    jlong tag = 0;
-    tag_table->GetTag(obj, &tag);
-
-    jlong class_tag = 0;
+    // Check the class filter first, it does not need the tag table.
     art::ObjPtr<art::mirror::Class> klass = obj->GetClass();
-    tag_table->GetTag(klass.Ptr(), &class_tag);
-    // For simplicity, even if we find a tag = 0, assume 0 = not tagged.
-
-    if (!heap_filter.ShouldReportByHeapFilter(tag, class_tag)) {
-      return;
-    }
-
     if (filter_klass != nullptr) {
       if (filter_klass.Get() != klass) {
         return;
       }
     }
 
+    jlong tag;
+    jlong class_tag;
+    tag_table->GetTagAndClassTagOrZero(obj, &tag, &class_tag);
+    // For simplicity, even if we find a tag = 0, assume 0 = not tagged.
+
+    if (!heap_filter.ShouldReportByHeapFilter(tag, class_tag)) {
+      return;
+    }
+
     jlong size = obj->SizeOf();
 
     jint length = -1;
@@ -1313,15 +1314,15 @@ class FollowReferencesHelper final {
       return JVMTI_VISIT_OBJECTS;
     }
 
-    const jlong class_tag = tag_table_->GetTagOrZero(referree->GetClass());
-    jlong tag = tag_table_->GetTagOrZero(referree);
+    jlong class_tag;
+    jlong tag;
+    tag_table_->GetTagAndClassTagOrZero(referree, &tag, &class_tag);
 
     if (!heap_filter_.ShouldReportByHeapFilter(tag, class_tag)) {
       return JVMTI_VISIT_OBJECTS;
     }
 
-    const jlong referrer_class_tag =
-        referrer == nullptr ? 0 : tag_table_->GetTagOrZero(referrer->GetClass());
+    jlong referrer_class_tag = 0;
     const jlong size = static_cast<jlong>(referree->SizeOf());
     jlong saved_tag = tag;
     jlong referrer_tag = 0;
@@ -1331,9 +1332,11 @@ class FollowReferencesHelper final {
       referrer_tag_ptr = nullptr;
     } else {
       if (referrer == referree) {
+        referrer_class_tag = class_tag;
         referrer_tag_ptr = &tag;
       } else {
-        referrer_tag = saved_referrer_tag = tag_table_->GetTagOrZero(referrer);
+        tag_table_->GetTagAndClassTagOrZero(referrer, &referrer_tag, &referrer_class_tag);
+        saved_referrer_tag = referrer_tag;
         referrer_tag_ptr = &referrer_tag;
       }
     }
@@ -1578,6 +1581,17 @@ jvmtiError HeapExtensions::GetHeapName(jvmtiEnv* env, jint heap_id, char** heap_
   }
 }
 
+jvmtiError HeapExtensions::SetHeapSamplingInterval([[maybe_unused]] jvmtiEnv* env,
+                                                   jint sampling_interval) {
+  if (sampling_interval < 0) {
+    return ERR(ILLEGAL_ARGUMENT);
+  }
+  // The heap sampler samples every allocation with an interval of 1.
+  art::Runtime::Current()->GetHeap()->GetHeapSampler().SetSamplingInterval(
+      std::max(sampling_interval, 1));
+  return ERR(NONE);
+}
+
 jvmtiError HeapExtensions::IterateThroughHeapExt(jvmtiEnv* env,
                                                  jint heap_filter,
                                                  jclass klass,
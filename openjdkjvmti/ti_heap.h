@@ -91,6 +91,8 @@ class HeapExtensions {
 
   static jvmtiError JNICALL ChangeArraySize(jvmtiEnv* env, jobject arr, jsize new_size);
 
+  static jvmtiError JNICALL SetHeapSamplingInterval(jvmtiEnv* env, jint sampling_interval);
+
   static void ReplaceReferences(
       art::Thread* self,
       const std::unordered_map<art::ObjPtr<art::mirror::Object>,
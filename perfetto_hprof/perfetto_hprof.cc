@@ -31,7 +31,10 @@
 #include <thread>
 #include <time.h>
 
+#include <condition_variable>
+#include <deque>
 #include <limits>
+#include <mutex>
 #include <optional>
 #include <type_traits>
 
@@ -52,6 +55,7 @@
 #include "perfetto/trace/profiling/smaps.pbzero.h"
 #include "perfetto/config/profiling/java_hprof_config.pbzero.h"
 #include "perfetto/protozero/packed_repeated_fields.h"
+#include "perfetto/protozero/scattered_heap_buffer.h"
 #include "perfetto/tracing.h"
 #include "runtime-inl.h"
 #include "runtime_callbacks.h"
@@ -639,113 +643,136 @@ uint64_t EncodeBaseObjId(
   return base_obj_id;
 }
 
-// Helper to keep intermediate state while dumping objects and classes from ART into
-// perfetto.protos.HeapGraph.
-class HeapGraphDumper {
+// The objects of the heap walk are serialized in chunks of `kObjectsPerChunk` objects, on
+// several threads. Each chunk is split into parts of at most `kObjectsPerPart` objects, and the
+// parts are appended to the HeapGraph packets one at a time, so that packets stay below
+// `kPacketSizeThreshold` plus one part.
+constexpr size_t kObjectsPerChunk = 4096;
+constexpr size_t kObjectsPerPart = 256;
+constexpr size_t kMaxSerializerThreads = 4;
+
+// Returns the number of threads serializing chunks in the forked child, besides the thread
+// walking the heap. The child cannot attach threads to the runtime, and debug builds check that
+// read barriers run on attached threads, so they serialize everything on the walking thread.
+size_t GetNumberOfSerializerThreads() {
+  if (art::kIsDebugBuild) {
+    return 0u;
+  }
+  size_t num_cpus = std::max(std::thread::hardware_concurrency(), 1u);
+  return std::min(num_cpus - 1u, kMaxSerializerThreads);
+}
+
+// An object of the heap walk, with the ids of the types it needs. The types are interned by the
+// thread walking the heap, so that all chunks agree on their ids.
+struct ObjectToDump {
+  art::mirror::Object* obj;
+  // The id of the type of `obj`, a synthetic type if `obj` is a class.
+  uint64_t type_id;
+  // If `obj` is a class, its id and the id of its superclass (0 if it has none).
+  uint64_t class_id;
+  uint64_t superclass_id;
+};
+
+// Serializes chunks of objects and classes from ART into the fields of
+// perfetto.protos.HeapGraph. Each serializer keeps its own interning tables for field and
+// location names. The ids of serializer `index` out of `num_serializers` are `index + 1` modulo
+// `num_serializers`, so that the tables of different serializers never assign the same id.
+class ChunkSerializer {
  public:
   // Instances of classes whose name is in `ignored_types` will be ignored.
-  explicit HeapGraphDumper(const std::vector<std::string>& ignored_types)
+  ChunkSerializer(const std::vector<std::string>& ignored_types,
+                  size_t index,
+                  size_t num_serializers)
       : ignored_types_(ignored_types),
+        next_string_id_(index + 1u),
+        string_id_stride_(num_serializers),
         reference_field_ids_(std::make_unique<protozero::PackedVarInt>()),
         reference_object_ids_(std::make_unique<protozero::PackedVarInt>()) {}
 
-  // Dumps a heap graph from `*runtime` and writes it to `writer`.
-  void Dump(art::Runtime* runtime, Writer& writer) REQUIRES(art::Locks::mutator_lock_) {
-    DumpRootObjects(runtime, writer);
-
-    DumpObjects(runtime, writer);
-
-    WriteInternedData(writer);
-  }
-
- private:
-  // Dumps the root objects from `*runtime` to `writer`.
-  void DumpRootObjects(art::Runtime* runtime, Writer& writer)
+  // Returns the serialized parts of `objects`.
+  std::vector<std::vector<uint8_t>> Serialize(const std::vector<ObjectToDump>& objects)
       REQUIRES_SHARED(art::Locks::mutator_lock_) {
-    std::map<art::RootType, std::vector<art::mirror::Object*>> root_objects;
-    RootFinder rcf(&root_objects);
-    runtime->VisitRoots(&rcf);
-    std::unique_ptr<protozero::PackedVarInt> object_ids(new protozero::PackedVarInt);
-    for (const auto& p : root_objects) {
-      const art::RootType root_type = p.first;
-      const std::vector<art::mirror::Object*>& children = p.second;
-      perfetto::protos::pbzero::HeapGraphRoot* root_proto = writer.GetHeapGraph()->add_roots();
-      root_proto->set_root_type(ToProtoType(root_type));
-      for (art::mirror::Object* obj : children) {
-        if (writer.will_create_new_packet()) {
-          root_proto->set_object_ids(*object_ids);
-          object_ids->Reset();
-          root_proto = writer.GetHeapGraph()->add_roots();
-          root_proto->set_root_type(ToProtoType(root_type));
-        }
-        object_ids->Append(GetObjectId(obj));
+    std::vector<std::vector<uint8_t>> parts;
+    parts.reserve((objects.size() + kObjectsPerPart - 1u) / kObjectsPerPart);
+    for (size_t begin = 0; begin < objects.size(); begin += kObjectsPerPart) {
+      size_t end = std::min(begin + kObjectsPerPart, objects.size());
+      part_.Reset();
+      // Start the delta encoding of object ids over in each part.
+      prev_object_id_ = 0u;
+      for (size_t i = begin; i != end; ++i) {
+        WriteOneObject(objects[i]);
       }
-      root_proto->set_object_ids(*object_ids);
-      object_ids->Reset();
+      WriteInternedData();
+      parts.push_back(part_.SerializeAsArray());
     }
+    return parts;
   }
 
-  // Dumps all the objects from `*runtime` to `writer`.
-  void DumpObjects(art::Runtime* runtime, Writer& writer) REQUIRES(art::Locks::mutator_lock_) {
-    runtime->GetHeap()->VisitObjectsPaused(
-        [this, &writer](art::mirror::Object* obj)
-            REQUIRES_SHARED(art::Locks::mutator_lock_) { WriteOneObject(obj, writer); });
+ private:
+  // Writes the field and location names interned since the last call to the current part.
+  void WriteInternedData() {
+    for (const auto& [id, str] : new_locations_) {
+      perfetto::protos::pbzero::InternedString* location_proto = part_->add_location_names();
+      location_proto->set_iid(id);
+      location_proto->set_str(reinterpret_cast<const uint8_t*>(str->c_str()), str->size());
+    }
+    new_locations_.clear();
+    for (const auto& [id, str] : new_fields_) {
+      perfetto::protos::pbzero::InternedString* field_proto = part_->add_field_names();
+      field_proto->set_iid(id);
+      field_proto->set_str(reinterpret_cast<const uint8_t*>(str->c_str()), str->size());
+    }
+    new_fields_.clear();
   }
 
-  // Writes all the previously accumulated (while dumping objects and roots) interned data to
-  // `writer`.
-  void WriteInternedData(Writer& writer) {
-    for (const auto& p : interned_locations_) {
-      const std::string& str = p.first;
-      uint64_t id = p.second;
+  uint64_t InternField(const std::string& str) {
+    return InternString(&interned_fields_, &new_fields_, str);
+  }
 
-      perfetto::protos::pbzero::InternedString* location_proto =
-          writer.GetHeapGraph()->add_location_names();
-      location_proto->set_iid(id);
-      location_proto->set_str(reinterpret_cast<const uint8_t*>(str.c_str()), str.size());
-    }
-    for (const auto& p : interned_fields_) {
-      const std::string& str = p.first;
-      uint64_t id = p.second;
+  uint64_t InternLocation(const std::string& str) {
+    return InternString(&interned_locations_, &new_locations_, str);
+  }
 
-      perfetto::protos::pbzero::InternedString* field_proto =
-          writer.GetHeapGraph()->add_field_names();
-      field_proto->set_iid(id);
-      field_proto->set_str(reinterpret_cast<const uint8_t*>(str.c_str()), str.size());
+  uint64_t InternString(std::map<std::string, uint64_t>* interned,
+                        std::vector<std::pair<uint64_t, const std::string*>>* new_strings,
+                        const std::string& str) {
+    auto it = interned->find(str);
+    if (it == interned->end()) {
+      std::tie(it, std::ignore) = interned->emplace(str, next_string_id_);
+      new_strings->emplace_back(next_string_id_, &it->first);
+      next_string_id_ += string_id_stride_;
     }
+    return it->second;
   }
 
-  // Writes `*obj` into `writer`.
-  void WriteOneObject(art::mirror::Object* obj, Writer& writer)
-      REQUIRES_SHARED(art::Locks::mutator_lock_) {
+  // Writes `object` into the current part.
+  void WriteOneObject(const ObjectToDump& object) REQUIRES_SHARED(art::Locks::mutator_lock_) {
+    art::mirror::Object* obj = object.obj;
     if (obj->IsClass()) {
-      WriteClass(obj->AsClass().Ptr(), writer);
+      WriteClass(obj->AsClass().Ptr(), object.class_id, object.superclass_id);
     }
 
     art::mirror::Class* klass = obj->GetClass();
-    uintptr_t class_ptr = reinterpret_cast<uintptr_t>(klass);
     // We need to synethesize a new type for Class<Foo>, which does not exist
     // in the runtime. Otherwise, all the static members of all classes would be
     // attributed to java.lang.Class.
     if (klass->IsClassClass()) {
-      class_ptr = WriteSyntheticClassFromObj(obj, writer);
+      WriteSyntheticClassFromObj(obj, object.type_id);
     }
 
     if (IsIgnored(obj)) {
       return;
     }
 
-    auto class_id = FindOrAppend(&interned_classes_, class_ptr);
-
     uint64_t object_id = GetObjectId(obj);
-    perfetto::protos::pbzero::HeapGraphObject* object_proto = writer.GetHeapGraph()->add_objects();
+    perfetto::protos::pbzero::HeapGraphObject* object_proto = part_->add_objects();
     if (prev_object_id_ && prev_object_id_ < object_id) {
       object_proto->set_id_delta(object_id - prev_object_id_);
     } else {
       object_proto->set_id(object_id);
     }
     prev_object_id_ = object_id;
-    object_proto->set_type_id(class_id);
+    object_proto->set_type_id(object.type_id);
 
     // Arrays / strings are magic and have an instance dependent size.
     if (obj->SizeOf() != klass->GetObjectSize()) {
@@ -757,43 +784,37 @@ class HeapGraphDumper {
     FillFieldValues(obj, klass, object_proto);
   }
 
-  // Writes `*klass` into `writer`.
-  void WriteClass(art::mirror::Class* klass, Writer& writer)
+  // Writes `*klass`, whose id is `class_id`, into the current part.
+  void WriteClass(art::mirror::Class* klass, uint64_t class_id, uint64_t superclass_id)
       REQUIRES_SHARED(art::Locks::mutator_lock_) {
-    perfetto::protos::pbzero::HeapGraphType* type_proto = writer.GetHeapGraph()->add_types();
-    type_proto->set_id(FindOrAppend(&interned_classes_, reinterpret_cast<uintptr_t>(klass)));
+    perfetto::protos::pbzero::HeapGraphType* type_proto = part_->add_types();
+    type_proto->set_id(class_id);
     type_proto->set_class_name(PrettyType(klass));
-    type_proto->set_location_id(FindOrAppend(&interned_locations_, klass->GetLocation()));
+    type_proto->set_location_id(InternLocation(klass->GetLocation()));
     type_proto->set_object_size(klass->GetObjectSize());
     type_proto->set_kind(ProtoClassKind(klass->GetClassFlags()));
     type_proto->set_classloader_id(GetObjectId(klass->GetClassLoader().Ptr()));
-    if (klass->GetSuperClass().Ptr()) {
-      type_proto->set_superclass_id(FindOrAppend(
-          &interned_classes_, reinterpret_cast<uintptr_t>(klass->GetSuperClass().Ptr())));
+    if (superclass_id != 0u) {
+      type_proto->set_superclass_id(superclass_id);
     }
     ForInstanceReferenceField(
         klass, [klass, this](art::MemberOffset offset) NO_THREAD_SAFETY_ANALYSIS {
           auto art_field = art::ArtField::FindInstanceFieldWithOffset(klass, offset.Uint32Value());
-          reference_field_ids_->Append(
-              FindOrAppend(&interned_fields_, art_field->PrettyField(true)));
+          reference_field_ids_->Append(InternField(art_field->PrettyField(true)));
         });
     type_proto->set_reference_field_id(*reference_field_ids_);
     reference_field_ids_->Reset();
   }
 
-  // Creates a fake class that represents a type only used by `*obj` into `writer`.
-  uintptr_t WriteSyntheticClassFromObj(art::mirror::Object* obj, Writer& writer)
+  // Writes a fake class with id `class_id` that represents a type only used by `*obj` into the
+  // current part.
+  void WriteSyntheticClassFromObj(art::mirror::Object* obj, uint64_t class_id)
       REQUIRES_SHARED(art::Locks::mutator_lock_) {
     CHECK(obj->IsClass());
-    perfetto::protos::pbzero::HeapGraphType* type_proto = writer.GetHeapGraph()->add_types();
-    // All pointers are at least multiples of two, so this way we can make sure
-    // we are not colliding with a real class.
-    uintptr_t class_ptr = reinterpret_cast<uintptr_t>(obj) | 1;
-    auto class_id = FindOrAppend(&interned_classes_, class_ptr);
+    perfetto::protos::pbzero::HeapGraphType* type_proto = part_->add_types();
     type_proto->set_id(class_id);
     type_proto->set_class_name(obj->PrettyTypeOf());
-    type_proto->set_location_id(FindOrAppend(&interned_locations_, obj->AsClass()->GetLocation()));
-    return class_ptr;
+    type_proto->set_location_id(InternLocation(obj->AsClass()->GetLocation()));
   }
 
   // Fills `*object_proto` with all the references held by `*obj` (an object of type `*klass`).
@@ -815,7 +836,7 @@ class HeapGraphDumper {
       const std::string& field_name = p.first;
       art::mirror::Object* referred_obj = p.second;
       if (emit_field_ids) {
-        reference_field_ids_->Append(FindOrAppend(&interned_fields_, field_name));
+        reference_field_ids_->Append(InternField(field_name));
       }
       uint64_t referred_obj_id = GetObjectId(referred_obj);
       if (referred_obj_id) {
@@ -894,7 +915,7 @@ class HeapGraphDumper {
   }
 
   // Name of classes whose instances should be ignored.
-  const std::vector<std::string> ignored_types_;
+  const std::vector<std::string>& ignored_types_;
 
   // Make sure that intern ID 0 (default proto value for a uint64_t) always maps to ""
   // (default proto value for a string) or to 0 (default proto value for a uint64).
@@ -903,8 +924,14 @@ class HeapGraphDumper {
   std::map<std::string, uint64_t> interned_fields_{{"", 0}};
   // Map from string (the location name) to its index in perfetto.protos.HeapGraph.location_names
   std::map<std::string, uint64_t> interned_locations_{{"", 0}};
-  // Map from addr (the class pointer) to its id in perfetto.protos.HeapGraph.types
-  std::map<uintptr_t, uint64_t> interned_classes_{{0, 0}};
+  // The strings interned while writing the current part, which it has to define.
+  std::vector<std::pair<uint64_t, const std::string*>> new_fields_;
+  std::vector<std::pair<uint64_t, const std::string*>> new_locations_;
+  uint64_t next_string_id_;
+  const uint64_t string_id_stride_;
+
+  // The part being written.
+  protozero::HeapBuffered<perfetto::protos::pbzero::HeapGraph> part_;
 
   // Temporary buffers: used locally in some methods and then cleared.
   std::unique_ptr<protozero::PackedVarInt> reference_field_ids_;
@@ -914,6 +941,211 @@ class HeapGraphDumper {
   uint64_t prev_object_id_ = 0;
 };
 
+// Serializes the chunks of objects that `Add()` receives on `num_threads` threads, or on the
+// calling thread if there are none, and appends them to `writer` in the order they were added.
+// The threads are plain threads: nothing else runs in the forked child, and the thread walking
+// the heap holds the mutator lock exclusively until the pipeline is finished.
+class ChunkPipeline {
+ public:
+  ChunkPipeline(const std::vector<std::string>& ignored_types, size_t num_threads, Writer& writer)
+      : writer_(writer) {
+    size_t num_serializers = std::max<size_t>(num_threads, 1u);
+    for (size_t i = 0; i != num_serializers; ++i) {
+      serializers_.push_back(std::make_unique<ChunkSerializer>(ignored_types, i, num_serializers));
+    }
+    for (size_t i = 0; i != num_threads; ++i) {
+      threads_.emplace_back([this, i]() { RunSerializer(serializers_[i].get()); });
+    }
+  }
+
+  ~ChunkPipeline() {
+    Finish();
+  }
+
+  void Add(std::vector<ObjectToDump>&& objects) REQUIRES_SHARED(art::Locks::mutator_lock_) {
+    if (threads_.empty()) {
+      WriteChunk(serializers_[0]->Serialize(objects));
+      return;
+    }
+    std::unique_lock<std::mutex> lock(lock_);
+    pending_.emplace_back(next_chunk_++, std::move(objects));
+    pending_cv_.notify_one();
+    // Bound the memory used by the chunks in flight.
+    WriteSerializedChunks(lock, /*max_in_flight=*/ 2u * threads_.size());
+  }
+
+  // Waits for all added chunks to be written.
+  void Finish() {
+    if (threads_.empty()) {
+      return;
+    }
+    {
+      std::unique_lock<std::mutex> lock(lock_);
+      WriteSerializedChunks(lock, /*max_in_flight=*/ 0u);
+      finished_ = true;
+    }
+    pending_cv_.notify_all();
+    for (std::thread& thread : threads_) {
+      thread.join();
+    }
+    threads_.clear();
+  }
+
+ private:
+  // Writes the serialized chunks that are next in order, and waits for chunks until at most
+  // `max_in_flight` chunks are left to write.
+  void WriteSerializedChunks(std::unique_lock<std::mutex>& lock, size_t max_in_flight) {
+    while (true) {
+      auto it = serialized_.find(next_to_write_);
+      if (it == serialized_.end()) {
+        if (next_chunk_ - next_to_write_ <= max_in_flight) {
+          return;
+        }
+        serialized_cv_.wait(lock);
+        continue;
+      }
+      std::vector<std::vector<uint8_t>> chunk = std::move(it->second);
+      serialized_.erase(it);
+      ++next_to_write_;
+      lock.unlock();
+      WriteChunk(chunk);
+      lock.lock();
+    }
+  }
+
+  void WriteChunk(const std::vector<std::vector<uint8_t>>& chunk) {
+    for (const std::vector<uint8_t>& part : chunk) {
+      writer_.GetHeapGraph()->AppendRawProtoBytes(part.data(), part.size());
+    }
+  }
+
+  // The dumping thread holds the mutator lock for the whole dump, see the class comment.
+  void RunSerializer(ChunkSerializer* serializer) NO_THREAD_SAFETY_ANALYSIS {
+    std::unique_lock<std::mutex> lock(lock_);
+    while (true) {
+      pending_cv_.wait(lock, [this]() { return finished_ || !pending_.empty(); });
+      if (pending_.empty()) {
+        return;
+      }
+      size_t index = pending_.front().first;
+      std::vector<ObjectToDump> objects = std::move(pending_.front().second);
+      pending_.pop_front();
+      lock.unlock();
+      std::vector<std::vector<uint8_t>> chunk = serializer->Serialize(objects);
+      lock.lock();
+      serialized_.emplace(index, std::move(chunk));
+      serialized_cv_.notify_one();
+    }
+  }
+
+  Writer& writer_;
+  std::vector<std::unique_ptr<ChunkSerializer>> serializers_;
+  std::vector<std::thread> threads_;
+
+  std::mutex lock_;
+  std::condition_variable pending_cv_;
+  std::condition_variable serialized_cv_;
+  std::deque<std::pair<size_t, std::vector<ObjectToDump>>> pending_;
+  std::map<size_t, std::vector<std::vector<uint8_t>>> serialized_;
+  size_t next_chunk_ = 0u;
+  size_t next_to_write_ = 0u;
+  bool finished_ = false;
+};
+
+// Helper to keep intermediate state while dumping objects and classes from ART into
+// perfetto.protos.HeapGraph.
+class HeapGraphDumper {
+ public:
+  // Instances of classes whose name is in `ignored_types` will be ignored.
+  explicit HeapGraphDumper(const std::vector<std::string>& ignored_types)
+      : ignored_types_(ignored_types) {}
+
+  // Dumps a heap graph from `*runtime` and writes it to `writer`.
+  void Dump(art::Runtime* runtime, Writer& writer) REQUIRES(art::Locks::mutator_lock_) {
+    DumpRootObjects(runtime, writer);
+
+    DumpObjects(runtime, writer);
+  }
+
+ private:
+  // Dumps the root objects from `*runtime` to `writer`.
+  void DumpRootObjects(art::Runtime* runtime, Writer& writer)
+      REQUIRES_SHARED(art::Locks::mutator_lock_) {
+    std::map<art::RootType, std::vector<art::mirror::Object*>> root_objects;
+    RootFinder rcf(&root_objects);
+    runtime->VisitRoots(&rcf);
+    std::unique_ptr<protozero::PackedVarInt> object_ids(new protozero::PackedVarInt);
+    for (const auto& p : root_objects) {
+      const art::RootType root_type = p.first;
+      const std::vector<art::mirror::Object*>& children = p.second;
+      perfetto::protos::pbzero::HeapGraphRoot* root_proto = writer.GetHeapGraph()->add_roots();
+      root_proto->set_root_type(ToProtoType(root_type));
+      for (art::mirror::Object* obj : children) {
+        if (writer.will_create_new_packet()) {
+          root_proto->set_object_ids(*object_ids);
+          object_ids->Reset();
+          root_proto = writer.GetHeapGraph()->add_roots();
+          root_proto->set_root_type(ToProtoType(root_type));
+        }
+        object_ids->Append(GetObjectId(obj));
+      }
+      root_proto->set_object_ids(*object_ids);
+      object_ids->Reset();
+    }
+  }
+
+  // Dumps all the objects from `*runtime` to `writer`. This thread walks the heap and hands
+  // chunks of objects to the serializer threads.
+  void DumpObjects(art::Runtime* runtime, Writer& writer) REQUIRES(art::Locks::mutator_lock_) {
+    ChunkPipeline pipeline(ignored_types_, GetNumberOfSerializerThreads(), writer);
+    std::vector<ObjectToDump> chunk;
+    chunk.reserve(kObjectsPerChunk);
+    runtime->GetHeap()->VisitObjectsPaused(
+        [this, &pipeline, &chunk](art::mirror::Object* obj)
+            REQUIRES_SHARED(art::Locks::mutator_lock_) {
+          chunk.push_back(InternTypes(obj));
+          if (chunk.size() == kObjectsPerChunk) {
+            pipeline.Add(std::move(chunk));
+            chunk.clear();
+            chunk.reserve(kObjectsPerChunk);
+          }
+        });
+    if (!chunk.empty()) {
+      pipeline.Add(std::move(chunk));
+    }
+    pipeline.Finish();
+  }
+
+  // Returns `*obj` with the ids of the types that serializing it needs.
+  ObjectToDump InternTypes(art::mirror::Object* obj) REQUIRES_SHARED(art::Locks::mutator_lock_) {
+    ObjectToDump object = {obj, 0u, 0u, 0u};
+    if (obj->IsClass()) {
+      art::mirror::Class* klass = obj->AsClass().Ptr();
+      object.class_id = FindOrAppend(&interned_classes_, reinterpret_cast<uintptr_t>(klass));
+      if (klass->GetSuperClass().Ptr()) {
+        object.superclass_id = FindOrAppend(
+            &interned_classes_, reinterpret_cast<uintptr_t>(klass->GetSuperClass().Ptr()));
+      }
+    }
+
+    art::mirror::Class* klass = obj->GetClass();
+    uintptr_t class_ptr = reinterpret_cast<uintptr_t>(klass);
+    if (klass->IsClassClass()) {
+      // All pointers are at least multiples of two, so this way we can make sure
+      // the synthetic class of `*obj` is not colliding with a real class.
+      class_ptr = reinterpret_cast<uintptr_t>(obj) | 1;
+    }
+    object.type_id = FindOrAppend(&interned_classes_, class_ptr);
+    return object;
+  }
+
+  // Name of classes whose instances should be ignored.
+  const std::vector<std::string> ignored_types_;
+
+  // Map from addr (the class pointer) to its id in perfetto.protos.HeapGraph.types
+  std::map<uintptr_t, uint64_t> interned_classes_{{0, 0}};
+};
+
 // waitpid with a timeout implemented by ~busy-waiting
 // See b/181031512 for rationale.
 void BusyWaitpid(pid_t pid, uint32_t timeout_ms) {
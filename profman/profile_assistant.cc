@@ -16,6 +16,10 @@
 
 #include "profile_assistant.h"
 
+#include <algorithm>
+#include <memory>
+#include <thread>
+
 #include "base/os.h"
 #include "base/unix_file/fd_file.h"
 #include "profman/profman_result.h"
@@ -27,6 +31,46 @@ namespace art {
 static constexpr const uint32_t kMinNewMethodsForCompilation = 100;
 static constexpr const uint32_t kMinNewClassesForCompilation = 50;
 
+// Current profiles are loaded and merged by up to this many threads, each taking a contiguous
+// range of at least `kMinProfilesPerMergeThread` profiles. Loading a profile is dominated by
+// decompressing and parsing it, which is independent for each profile.
+static constexpr size_t kMaxMergeThreads = 4u;
+static constexpr size_t kMinProfilesPerMergeThread = 2u;
+
+// Loads the current profiles in [begin, end) and merges them in order into `info`.
+static ProfmanResult::ProcessingResult LoadAndMergeProfiles(
+    const std::vector<ScopedFlock>& profile_files,
+    size_t begin,
+    size_t end,
+    const ProfileCompilationInfo::ProfileLoadFilterFn& filter_fn,
+    const ProfileAssistant::Options& options,
+    /*inout*/ ProfileCompilationInfo* info) {
+  for (size_t i = begin; i < end; i++) {
+    ProfileCompilationInfo cur_info(options.IsBootImageMerge());
+    if (!cur_info.Load(profile_files[i]->Fd(), /*merge_classes=*/ true, filter_fn)) {
+      LOG(WARNING) << "Could not load profile file at index " << i;
+      if (options.IsForceMerge()) {
+        // If we have to merge forcefully, ignore load failures.
+        // This is useful for boot image profiles to ignore stale profiles which are
+        // cleared lazily.
+        continue;
+      }
+      // TODO: Do we really need to use a different error code for version mismatch?
+      ProfileCompilationInfo wrong_info(!options.IsBootImageMerge());
+      if (wrong_info.Load(profile_files[i]->Fd(), /*merge_classes=*/ true, filter_fn)) {
+        return ProfmanResult::kErrorDifferentVersions;
+      }
+      return ProfmanResult::kErrorBadProfiles;
+    }
+
+    if (!info->MergeWith(cur_info)) {
+      LOG(WARNING) << "Could not merge profile file at index " << i;
+      return ProfmanResult::kErrorBadProfiles;
+    }
+  }
+  return ProfmanResult::kSuccess;
+}
+
 ProfmanResult::ProcessingResult ProfileAssistant::ProcessProfilesInternal(
     const std::vector<ScopedFlock>& profile_files,
     const ScopedFlock& reference_profile_file,
@@ -50,27 +94,43 @@ ProfmanResult::ProcessingResult ProfileAssistant::ProcessProfilesInternal(
   uint32_t number_of_classes = info.GetNumberOfResolvedClasses();
 
   // Merge all current profiles.
-  for (size_t i = 0; i < profile_files.size(); i++) {
-    ProfileCompilationInfo cur_info(options.IsBootImageMerge());
-    if (!cur_info.Load(profile_files[i]->Fd(), /*merge_classes=*/ true, filter_fn)) {
-      LOG(WARNING) << "Could not load profile file at index " << i;
-      if (options.IsForceMerge()) {
-        // If we have to merge forcefully, ignore load failures.
-        // This is useful for boot image profiles to ignore stale profiles which are
-        // cleared lazily.
-        continue;
+  size_t num_threads = std::min({kMaxMergeThreads,
+                                 std::max<size_t>(std::thread::hardware_concurrency(), 1u),
+                                 profile_files.size() / kMinProfilesPerMergeThread});
+  if (num_threads <= 1u) {
+    ProfmanResult::ProcessingResult result = LoadAndMergeProfiles(
+        profile_files, /*begin=*/ 0u, profile_files.size(), filter_fn, options, &info);
+    if (result != ProfmanResult::kSuccess) {
+      return result;
+    }
+  } else {
+    // Merge contiguous ranges of the current profiles in parallel, then merge the partial results
+    // into the reference profile in order. This keeps the order of the dex files in the result.
+    // The `filter_fn` is called concurrently by the merge threads.
+    size_t profiles_per_thread = (profile_files.size() + num_threads - 1u) / num_threads;
+    std::vector<std::unique_ptr<ProfileCompilationInfo>> partial_infos;
+    std::vector<ProfmanResult::ProcessingResult> partial_results(num_threads);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t != num_threads; ++t) {
+      partial_infos.push_back(std::make_unique<ProfileCompilationInfo>(options.IsBootImageMerge()));
+      size_t begin = std::min(t * profiles_per_thread, profile_files.size());
+      size_t end = std::min(begin + profiles_per_thread, profile_files.size());
+      threads.emplace_back([&, t, begin, end]() {
+        partial_results[t] = LoadAndMergeProfiles(
+            profile_files, begin, end, filter_fn, options, partial_infos[t].get());
+      });
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+    for (size_t t = 0; t != num_threads; ++t) {
+      if (partial_results[t] != ProfmanResult::kSuccess) {
+        return partial_results[t];
       }
-      // TODO: Do we really need to use a different error code for version mismatch?
-      ProfileCompilationInfo wrong_info(!options.IsBootImageMerge());
-      if (wrong_info.Load(profile_files[i]->Fd(), /*merge_classes=*/ true, filter_fn)) {
-        return ProfmanResult::kErrorDifferentVersions;
+      if (!info.MergeWith(*partial_infos[t])) {
+        LOG(WARNING) << "Could not merge profile files of merge thread " << t;
+        return ProfmanResult::kErrorBadProfiles;
       }
-      return ProfmanResult::kErrorBadProfiles;
-    }
-
-    if (!info.MergeWith(cur_info)) {
-      LOG(WARNING) << "Could not merge profile file at index " << i;
-      return ProfmanResult::kErrorBadProfiles;
     }
   }
 
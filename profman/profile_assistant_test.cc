@@ -509,6 +509,45 @@ TEST_F(ProfileAssistantTest, AdviseCompilationEmptyReferences) {
   CheckProfileInfo(profile2, info2);
 }
 
+TEST_F(ProfileAssistantTest, AdviseCompilationManyProfiles) {
+  // Enough profiles for the current profiles to be merged by several threads.
+  constexpr size_t kNumberOfProfiles = 8u;
+  const DexFile* const dex_files[] = {dex1, dex2, dex3, dex4};
+  std::vector<ScratchFile> profiles(kNumberOfProfiles);
+  std::vector<ProfileCompilationInfo> infos(kNumberOfProfiles);
+  ScratchFile reference_profile;
+
+  std::vector<int> profile_fds;
+  for (size_t i = 0; i != kNumberOfProfiles; ++i) {
+    profile_fds.push_back(GetFd(profiles[i]));
+    SetupProfile(dex_files[i % 4u],
+                 dex_files[(i + 1u) % 4u],
+                 /*number_of_methods=*/ 20,
+                 /*number_of_classes=*/ 0,
+                 profiles[i],
+                 &infos[i],
+                 /*start_method_index=*/ static_cast<uint16_t>(i * 10u));
+  }
+  int reference_profile_fd = GetFd(reference_profile);
+
+  // We should advise compilation.
+  ASSERT_EQ(ProfmanResult::kCompile, ProcessProfiles(profile_fds, reference_profile_fd));
+  // The resulting compilation info must be equal to the merge of the inputs in order.
+  ProfileCompilationInfo result;
+  ASSERT_TRUE(result.Load(reference_profile_fd));
+
+  ProfileCompilationInfo expected;
+  for (const ProfileCompilationInfo& info : infos) {
+    ASSERT_TRUE(expected.MergeWith(info));
+  }
+  ASSERT_TRUE(expected.Equals(result));
+
+  // The information from profiles must remain the same.
+  for (size_t i = 0; i != kNumberOfProfiles; ++i) {
+    CheckProfileInfo(profiles[i], infos[i]);
+  }
+}
+
 // TODO(calin): Add more tests for classes.
 TEST_F(ProfileAssistantTest, AdviseCompilationEmptyReferencesBecauseOfClasses) {
   const uint16_t kNumberOfClassesToEnableCompilation = 100;
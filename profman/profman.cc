@@ -150,6 +150,9 @@ NO_RETURN static void Usage(const char *fmt, ...) {
   UsageError("      methods and inline caches.");
   UsageError("  --output-profile-type=(app|boot|bprof): Select output profile format for");
   UsageError("      the --create-profile-from option. Default: app.");
+  UsageError("  --record-startup-order: with --create-profile-from, record the order of the");
+  UsageError("      startup methods in the list as the order in which they are first executed.");
+  UsageError("      dex2oat lays out their compiled code in that order.");
   UsageError("");
   UsageError("  --dex-location=<string>: location string to use with corresponding");
   UsageError("      apk-fd to find dex files");
@@ -321,6 +324,7 @@ class ProfMan final {
       test_profile_seed_(NanoTime()),
       start_ns_(NanoTime()),
       copy_and_update_profile_key_(false),
+      record_startup_order_(false),
       profile_assistant_options_(ProfileAssistant::Options()) {}
 
   ~ProfMan() {
@@ -355,6 +359,8 @@ class ProfMan final {
         dump_classes_and_methods_ = true;
       } else if (StartsWith(option, "--create-profile-from=")) {
         create_profile_from_file_ = std::string(option.substr(strlen("--create-profile-from=")));
+      } else if (option == "--record-startup-order") {
+        record_startup_order_ = true;
       } else if (StartsWith(option, "--output-profile-type=")) {
         ParseOutputProfileType(raw_option, "--output-profile-type=", &output_profile_type_);
       } else if (StartsWith(option, "--dump-output-to-fd=")) {
@@ -1474,6 +1480,11 @@ class ProfMan final {
       // TODO: Check return value?
       profile->AddMethods(
           methods, static_cast<ProfileCompilationInfo::MethodHotness::Flag>(flags), annotation);
+      if (record_startup_order_ && is_startup) {
+        for (const ProfileMethodInfo& method : methods) {
+          profile->AddStartupOrder(method.ref, annotation);
+        }
+      }
       return true;
     }
 
@@ -1619,6 +1630,9 @@ class ProfMan final {
       }
       DCHECK(profile->GetMethodHotness(ref, annotation).IsInProfile()) << method_spec;
     }
+    if (record_startup_order_ && is_startup && !profile->AddStartupOrder(ref, annotation)) {
+      return false;
+    }
     return true;
   }
 
@@ -1743,10 +1757,19 @@ class ProfMan final {
     if (!FdIsValid(fd)) {
         return -1;
     }
-    // Read the user-specified list of classes and methods.
-    std::unique_ptr<std::unordered_set<std::string>>
-        user_lines(ReadCommentedInputFromFile<std::unordered_set<std::string>>(
-            create_profile_from_file_.c_str(), nullptr));  // No post-processing.
+    // Read the user-specified list of classes and methods. Keep the order of the lines if it
+    // is the startup order of the methods.
+    std::unique_ptr<std::vector<std::string>> user_lines;
+    if (record_startup_order_) {
+      user_lines.reset(ReadCommentedInputFromFile<std::vector<std::string>>(
+          create_profile_from_file_.c_str(), nullptr));  // No post-processing.
+    } else {
+      std::unique_ptr<std::unordered_set<std::string>> unique_lines(
+          ReadCommentedInputFromFile<std::unordered_set<std::string>>(
+              create_profile_from_file_.c_str(), nullptr));  // No post-processing.
+      user_lines = std::make_unique<std::vector<std::string>>(unique_lines->begin(),
+                                                              unique_lines->end());
+    }
 
     // Open the dex files to look up classes and methods.
     std::vector<std::unique_ptr<const DexFile>> dex_files;
@@ -1962,6 +1985,7 @@ class ProfMan final {
   uint32_t test_profile_seed_;
   uint64_t start_ns_;
   bool copy_and_update_profile_key_;
+  bool record_startup_order_;
   ProfileAssistant::Options profile_assistant_options_;
   std::string boot_profile_out_path_;
   std::string preloaded_classes_out_path_;
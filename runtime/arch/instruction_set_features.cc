@@ -134,6 +134,9 @@ std::unique_ptr<const InstructionSetFeatures> InstructionSetFeatures::FromRuntim
 #ifdef ART_TARGET_ANDROID
     case InstructionSet::kArm64:
       return Arm64InstructionSetFeatures::FromHwcap();
+    case InstructionSet::kRiscv64:
+      // The AT_HWCAP does not cover the multi-letter extensions, use the ISA string.
+      return Riscv64InstructionSetFeatures::FromCpuInfo();
 #endif
     default:
       return nullptr;
@@ -19,6 +19,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
 // memcmp16 support.
 //
@@ -37,9 +38,19 @@ extern "C" uint32_t __memcmp16(const uint16_t* s0, const uint16_t* s1, size_t co
 
 #else
 
-// This is the generic inlined version.
+// This is the generic inlined version. It skips equal prefixes four chars at a time.
 static inline int32_t MemCmp16(const uint16_t* s0, const uint16_t* s1, size_t count) {
-  for (size_t i = 0; i < count; i++) {
+  size_t i = 0;
+  for (; i + 4u <= count; i += 4u) {
+    uint64_t w0;
+    uint64_t w1;
+    memcpy(&w0, s0 + i, sizeof(w0));
+    memcpy(&w1, s1 + i, sizeof(w1));
+    if (w0 != w1) {
+      break;
+    }
+  }
+  for (; i < count; i++) {
     if (s0[i] != s1[i]) {
       return static_cast<int32_t>(s0[i]) - static_cast<int32_t>(s1[i]);
     }
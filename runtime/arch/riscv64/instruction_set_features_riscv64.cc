@@ -16,21 +16,80 @@
 
 #include "instruction_set_features_riscv64.h"
 
+#if defined(ART_TARGET_ANDROID) && defined(__riscv)
+#include <sys/auxv.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#if __has_include(<asm/hwprobe.h>)
+#include <asm/hwprobe.h>
+#endif
+#endif
+
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 
+#include "android-base/stringprintf.h"
 #include "android-base/strings.h"
 #include "base/logging.h"
+#include "base/utils.h"
 
 namespace art {
 
+using android::base::StringPrintf;
+
 // Basic feature set is rv64gc, aka rv64imafdc.
 constexpr uint32_t BasicFeatures() {
   return Riscv64InstructionSetFeatures::kExtGeneric | Riscv64InstructionSetFeatures::kExtCompressed;
 }
 
+// The vendor extensions implemented by the T-Head C9xx cores, for example the C910 in TH1520.
+constexpr uint32_t XTheadFeatures() {
+  return Riscv64InstructionSetFeatures::kExtXTheadBa |
+         Riscv64InstructionSetFeatures::kExtXTheadBb |
+         Riscv64InstructionSetFeatures::kExtXTheadBs |
+         Riscv64InstructionSetFeatures::kExtXTheadMemIdx |
+         Riscv64InstructionSetFeatures::kExtXTheadMac |
+         Riscv64InstructionSetFeatures::kExtXTheadVector;
+}
+
+// The `mvendorid` of T-Head cores as reported in /proc/cpuinfo.
+static constexpr uint64_t kTHeadVendorId = 0x5b7u;
+
+// Multi-letter extensions, as named in the ISA string and in the feature string.
+static constexpr struct {
+  const char* name;
+  uint32_t bit;
+} kMultiLetterExtensions[] = {
+    {"zba", Riscv64InstructionSetFeatures::kExtZba},
+    {"zbb", Riscv64InstructionSetFeatures::kExtZbb},
+    {"zbs", Riscv64InstructionSetFeatures::kExtZbs},
+    {"xtheadba", Riscv64InstructionSetFeatures::kExtXTheadBa},
+    {"xtheadbb", Riscv64InstructionSetFeatures::kExtXTheadBb},
+    {"xtheadbs", Riscv64InstructionSetFeatures::kExtXTheadBs},
+    {"xtheadmemidx", Riscv64InstructionSetFeatures::kExtXTheadMemIdx},
+    {"xtheadmac", Riscv64InstructionSetFeatures::kExtXTheadMac},
+    {"xtheadvector", Riscv64InstructionSetFeatures::kExtXTheadVector},
+};
+
+static uint32_t FindMultiLetterExtension(const std::string& name) {
+  for (const auto& extension : kMultiLetterExtensions) {
+    if (name == extension.name) {
+      return extension.bit;
+    }
+  }
+  return 0u;
+}
+
 Riscv64FeaturesUniquePtr Riscv64InstructionSetFeatures::FromVariant(
     const std::string& variant, [[maybe_unused]] std::string* error_msg) {
+  if (variant == "thead-c910" || variant == "c910") {
+    // The C910 vector unit implements the 0.7.1 draft which is incompatible with RVV 1.0,
+    // so it is reported as "XTheadVector" instead of "V".
+    return Riscv64FeaturesUniquePtr(
+        new Riscv64InstructionSetFeatures(BasicFeatures() | XTheadFeatures()));
+  }
   if (variant != "generic") {
     LOG(WARNING) << "Unexpected CPU variant for Riscv64 using defaults: " << variant;
   }
@@ -42,17 +101,143 @@ Riscv64FeaturesUniquePtr Riscv64InstructionSetFeatures::FromBitmap(uint32_t bitm
 }
 
 Riscv64FeaturesUniquePtr Riscv64InstructionSetFeatures::FromCppDefines() {
-  return Riscv64FeaturesUniquePtr(new Riscv64InstructionSetFeatures(BasicFeatures()));
+  uint32_t bits = BasicFeatures();
+#if defined(__riscv_v)
+  bits |= kExtVector;
+#endif
+#if defined(__riscv_zba)
+  bits |= kExtZba;
+#endif
+#if defined(__riscv_zbb)
+  bits |= kExtZbb;
+#endif
+#if defined(__riscv_zbs)
+  bits |= kExtZbs;
+#endif
+#if defined(__riscv_xtheadba)
+  bits |= kExtXTheadBa;
+#endif
+#if defined(__riscv_xtheadbb)
+  bits |= kExtXTheadBb;
+#endif
+#if defined(__riscv_xtheadbs)
+  bits |= kExtXTheadBs;
+#endif
+#if defined(__riscv_xtheadmemidx)
+  bits |= kExtXTheadMemIdx;
+#endif
+#if defined(__riscv_xtheadmac)
+  bits |= kExtXTheadMac;
+#endif
+#if defined(__riscv_xtheadvector)
+  bits |= kExtXTheadVector;
+#endif
+  return Riscv64FeaturesUniquePtr(new Riscv64InstructionSetFeatures(bits));
+}
+
+uint32_t Riscv64InstructionSetFeatures::ParseIsaString(const std::string& isa) {
+  static constexpr const char* kIsaPrefix = "rv64";
+  std::vector<std::string> parts;
+  Split(android::base::Trim(isa), '_', &parts);
+  if (parts.empty() || !android::base::StartsWith(parts[0], kIsaPrefix)) {
+    return 0u;
+  }
+  // Single-letter extensions follow the "rv64" prefix without separators.
+  std::string letters = parts[0].substr(strlen(kIsaPrefix));
+  auto has_letter = [&letters](char c) { return letters.find(c) != std::string::npos; };
+  uint32_t bits = 0u;
+  if (has_letter('g') ||
+      (has_letter('i') && has_letter('m') && has_letter('a') && has_letter('f') &&
+       has_letter('d'))) {
+    bits |= kExtGeneric;
+  }
+  if (has_letter('c')) {
+    bits |= kExtCompressed;
+  }
+  if (has_letter('v')) {
+    bits |= kExtVector;
+  }
+  for (size_t i = 1; i != parts.size(); ++i) {
+    bits |= FindMultiLetterExtension(parts[i]);
+  }
+  return bits;
 }
 
 Riscv64FeaturesUniquePtr Riscv64InstructionSetFeatures::FromCpuInfo() {
-  UNIMPLEMENTED(WARNING);
-  return FromCppDefines();
+  // Look in /proc/cpuinfo for the ISA string. The kernel lists the ratified multi-letter
+  // extensions (if it knows them) but older kernels do not list the T-Head vendor extensions.
+  // All T-Head C9xx cores implement these, so we use the vendor id to detect them.
+  uint32_t bits = 0u;
+  bool found_isa = false;
+  bool is_thead = false;
+
+  std::ifstream in("/proc/cpuinfo");
+  if (!in.fail()) {
+    while (!in.eof()) {
+      std::string line;
+      std::getline(in, line);
+      if (!in.eof()) {
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) {
+          continue;
+        }
+        std::string key = android::base::Trim(line.substr(0, colon));
+        std::string value = android::base::Trim(line.substr(colon + 1u));
+        if (key == "isa" && !found_isa) {
+          found_isa = true;
+          bits = ParseIsaString(value);
+        } else if (key == "mvendorid") {
+          is_thead = (strtoull(value.c_str(), nullptr, 0) == kTHeadVendorId);
+        }
+      }
+    }
+    in.close();
+  } else {
+    LOG(ERROR) << "Failed to open /proc/cpuinfo";
+  }
+
+  if (!found_isa || (bits & kExtGeneric) == 0u) {
+    LOG(WARNING) << "Failed to find the rv64gc ISA string in /proc/cpuinfo";
+    return FromCppDefines();
+  }
+  if (is_thead) {
+    // The T-Head vector unit implements the 0.7.1 draft which is incompatible with RVV 1.0,
+    // even if the vendor kernel reports it as "v". Report it as "XTheadVector" instead.
+    bits = (bits & ~kExtVector) | XTheadFeatures();
+  }
+  return Riscv64FeaturesUniquePtr(new Riscv64InstructionSetFeatures(bits));
 }
 
 Riscv64FeaturesUniquePtr Riscv64InstructionSetFeatures::FromHwcap() {
-  UNIMPLEMENTED(WARNING);
-  return FromCppDefines();
+  uint32_t bits = BasicFeatures();
+
+#if defined(ART_TARGET_ANDROID) && defined(__riscv)
+  // The AT_HWCAP bits correspond to the single-letter extensions.
+  uint64_t hwcaps = getauxval(AT_HWCAP);
+  auto has_letter = [hwcaps](char c) { return (hwcaps & (UINT64_C(1) << (c - 'a'))) != 0u; };
+  bits = 0u;
+  if (has_letter('i') && has_letter('m') && has_letter('a') && has_letter('f') &&
+      has_letter('d')) {
+    bits |= kExtGeneric;
+  }
+  if (has_letter('c')) {
+    bits |= kExtCompressed;
+  }
+  if (has_letter('v')) {
+    bits |= kExtVector;
+  }
+#if defined(__NR_riscv_hwprobe) && defined(RISCV_HWPROBE_KEY_IMA_EXT_0)
+  // The multi-letter extensions are reported by the `riscv_hwprobe` syscall (Linux 6.4+).
+  struct riscv_hwprobe probe = {RISCV_HWPROBE_KEY_IMA_EXT_0, 0};
+  if (syscall(__NR_riscv_hwprobe, &probe, 1, 0, nullptr, 0) == 0) {
+    bits |= (probe.value & RISCV_HWPROBE_EXT_ZBA) != 0u ? kExtZba : 0u;
+    bits |= (probe.value & RISCV_HWPROBE_EXT_ZBB) != 0u ? kExtZbb : 0u;
+    bits |= (probe.value & RISCV_HWPROBE_EXT_ZBS) != 0u ? kExtZbs : 0u;
+  }
+#endif
+#endif
+
+  return Riscv64FeaturesUniquePtr(new Riscv64InstructionSetFeatures(bits));
 }
 
 Riscv64FeaturesUniquePtr Riscv64InstructionSetFeatures::FromAssembly() {
@@ -72,6 +257,14 @@ bool Riscv64InstructionSetFeatures::Equals(const InstructionSetFeatures* other)
   return bits_ == other->AsRiscv64InstructionSetFeatures()->bits_;
 }
 
+bool Riscv64InstructionSetFeatures::HasAtLeast(const InstructionSetFeatures* other) const {
+  if (InstructionSet::kRiscv64 != other->GetInstructionSet()) {
+    return false;
+  }
+  uint32_t other_bits = other->AsRiscv64InstructionSetFeatures()->bits_;
+  return (bits_ & other_bits) == other_bits;
+}
+
 uint32_t Riscv64InstructionSetFeatures::AsBitmap() const { return bits_; }
 
 std::string Riscv64InstructionSetFeatures::GetFeatureString() const {
@@ -85,15 +278,53 @@ std::string Riscv64InstructionSetFeatures::GetFeatureString() const {
   if (bits_ & kExtVector) {
     result += "v";
   }
+  for (const auto& extension : kMultiLetterExtensions) {
+    if ((bits_ & extension.bit) != 0u) {
+      result += "_";
+      result += extension.name;
+    }
+  }
   return result;
 }
 
 std::unique_ptr<const InstructionSetFeatures>
 Riscv64InstructionSetFeatures::AddFeaturesFromSplitString(
-    [[maybe_unused]] const std::vector<std::string>& features,
-    [[maybe_unused]] std::string* error_msg) const {
-  UNIMPLEMENTED(WARNING);
-  return std::unique_ptr<const InstructionSetFeatures>(new Riscv64InstructionSetFeatures(bits_));
+    const std::vector<std::string>& features, std::string* error_msg) const {
+  // This 'features' string is from '--instruction-set-features=' option in ART.
+  // Each feature is either a full ISA string as produced by `GetFeatureString()`,
+  // for example "rv64gc_zba_zbb", or the name of an extension ("v", "zba", "xtheadba",
+  // etc.) to add, optionally prefixed with '-' to remove it instead.
+  uint32_t bits = bits_;
+  for (const std::string& feature : features) {
+    DCHECK_EQ(android::base::Trim(feature), feature)
+        << "Feature name is not trimmed: '" << feature << "'";
+    if (android::base::StartsWith(feature, "rv64")) {
+      uint32_t isa_bits = ParseIsaString(feature);
+      if ((isa_bits & kExtGeneric) == 0u) {
+        *error_msg = StringPrintf("Invalid ISA string: '%s'", feature.c_str());
+        return nullptr;
+      }
+      bits = isa_bits;
+      continue;
+    }
+    bool remove = android::base::StartsWith(feature, "-");
+    std::string name = remove ? feature.substr(1u) : feature;
+    uint32_t bit = (name == "v") ? kExtVector : FindMultiLetterExtension(name);
+    if (bit == 0u) {
+      *error_msg = StringPrintf("Unknown instruction set feature: '%s'", feature.c_str());
+      return nullptr;
+    }
+    bits = remove ? (bits & ~bit) : (bits | bit);
+  }
+  return std::unique_ptr<const InstructionSetFeatures>(new Riscv64InstructionSetFeatures(bits));
+}
+
+std::unique_ptr<const InstructionSetFeatures>
+Riscv64InstructionSetFeatures::AddRuntimeDetectedFeatures(
+    const InstructionSetFeatures* features) const {
+  uint32_t detected_bits = features->AsRiscv64InstructionSetFeatures()->bits_;
+  return std::unique_ptr<const InstructionSetFeatures>(
+      new Riscv64InstructionSetFeatures(bits_ | detected_bits));
 }
 
 }  // namespace art
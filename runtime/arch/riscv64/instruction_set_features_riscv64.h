@@ -29,9 +29,18 @@ class Riscv64InstructionSetFeatures final : public InstructionSetFeatures {
  public:
   // Bitmap positions for encoding features as a bitmap.
   enum {
-    kExtGeneric = (1 << 0),     // G extension covers the basic set IMAFD
-    kExtCompressed = (1 << 1),  // C extension adds compressed instructions
-    kExtVector = (1 << 2)       // V extension adds vector instructions
+    kExtGeneric = (1 << 0),        // G extension covers the basic set IMAFD
+    kExtCompressed = (1 << 1),     // C extension adds compressed instructions
+    kExtVector = (1 << 2),         // V extension adds vector instructions
+    kExtZba = (1 << 3),            // Zba extension adds address generation instructions
+    kExtZbb = (1 << 4),            // Zbb extension adds basic bit-manipulation instructions
+    kExtZbs = (1 << 5),            // Zbs extension adds single-bit instructions
+    kExtXTheadBa = (1 << 6),       // T-Head vendor extension for address calculation
+    kExtXTheadBb = (1 << 7),       // T-Head vendor extension for basic bit-manipulation
+    kExtXTheadBs = (1 << 8),       // T-Head vendor extension for single-bit instructions
+    kExtXTheadMemIdx = (1 << 9),   // T-Head vendor extension for indexed memory operations
+    kExtXTheadMac = (1 << 10),     // T-Head vendor extension for multiply-accumulate
+    kExtXTheadVector = (1 << 11),  // T-Head vendor extension for RVV 0.7.1 vector instructions
   };
 
   static Riscv64FeaturesUniquePtr FromVariant(const std::string& variant, std::string* error_msg);
@@ -58,21 +67,41 @@ class Riscv64InstructionSetFeatures final : public InstructionSetFeatures {
 
   bool Equals(const InstructionSetFeatures* other) const override;
 
+  bool HasAtLeast(const InstructionSetFeatures* other) const override;
+
   InstructionSet GetInstructionSet() const override { return InstructionSet::kRiscv64; }
 
   uint32_t AsBitmap() const override;
 
   std::string GetFeatureString() const override;
 
+  bool HasVector() const { return (bits_ & kExtVector) != 0; }
+  bool HasZba() const { return (bits_ & kExtZba) != 0; }
+  bool HasZbb() const { return (bits_ & kExtZbb) != 0; }
+  bool HasZbs() const { return (bits_ & kExtZbs) != 0; }
+  bool HasXTheadBa() const { return (bits_ & kExtXTheadBa) != 0; }
+  bool HasXTheadBb() const { return (bits_ & kExtXTheadBb) != 0; }
+  bool HasXTheadBs() const { return (bits_ & kExtXTheadBs) != 0; }
+  bool HasXTheadMemIdx() const { return (bits_ & kExtXTheadMemIdx) != 0; }
+  bool HasXTheadMac() const { return (bits_ & kExtXTheadMac) != 0; }
+  bool HasXTheadVector() const { return (bits_ & kExtXTheadVector) != 0; }
+
   virtual ~Riscv64InstructionSetFeatures() {}
 
  protected:
   std::unique_ptr<const InstructionSetFeatures> AddFeaturesFromSplitString(
       const std::vector<std::string>& features, std::string* error_msg) const override;
 
+  std::unique_ptr<const InstructionSetFeatures> AddRuntimeDetectedFeatures(
+      const InstructionSetFeatures* features) const override;
+
  private:
   explicit Riscv64InstructionSetFeatures(uint32_t bits) : InstructionSetFeatures(), bits_(bits) {}
 
+  // Parse the ISA string reported by the kernel, for example "rv64imafdc_zba_zbb", and
+  // return the corresponding extension bitmap.
+  static uint32_t ParseIsaString(const std::string& isa);
+
   // Extension bitmap.
   const uint32_t bits_;
 
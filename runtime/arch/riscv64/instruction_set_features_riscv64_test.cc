@@ -35,4 +35,57 @@ TEST(Riscv64InstructionSetFeaturesTest, Riscv64FeaturesFromDefaultVariant) {
   EXPECT_EQ(riscv64_features->AsBitmap(), expected_extensions);  // rv64gc, aka rv64imafdc
 }
 
+TEST(Riscv64InstructionSetFeaturesTest, Riscv64FeaturesFromC910Variant) {
+  std::string error_msg;
+  std::unique_ptr<const InstructionSetFeatures> riscv64_features(
+      InstructionSetFeatures::FromVariant(InstructionSet::kRiscv64, "thead-c910", &error_msg));
+  ASSERT_TRUE(riscv64_features.get() != nullptr) << error_msg;
+
+  const Riscv64InstructionSetFeatures* features =
+      riscv64_features->AsRiscv64InstructionSetFeatures();
+  EXPECT_FALSE(features->HasVector());
+  EXPECT_FALSE(features->HasZba());
+  EXPECT_FALSE(features->HasZbb());
+  EXPECT_TRUE(features->HasXTheadBa());
+  EXPECT_TRUE(features->HasXTheadBb());
+  EXPECT_TRUE(features->HasXTheadBs());
+  EXPECT_TRUE(features->HasXTheadMemIdx());
+  EXPECT_TRUE(features->HasXTheadMac());
+  EXPECT_TRUE(features->HasXTheadVector());
+  EXPECT_STREQ("rv64gc_xtheadba_xtheadbb_xtheadbs_xtheadmemidx_xtheadmac_xtheadvector",
+               riscv64_features->GetFeatureString().c_str());
+}
+
+TEST(Riscv64InstructionSetFeaturesTest, Riscv64AddFeaturesFromString) {
+  std::string error_msg;
+  std::unique_ptr<const InstructionSetFeatures> base_features(
+      InstructionSetFeatures::FromVariant(InstructionSet::kRiscv64, "generic", &error_msg));
+  ASSERT_TRUE(base_features.get() != nullptr) << error_msg;
+
+  std::unique_ptr<const InstructionSetFeatures> zb_features(
+      base_features->AddFeaturesFromString("zba,zbb,zbs", &error_msg));
+  ASSERT_TRUE(zb_features.get() != nullptr) << error_msg;
+  EXPECT_STREQ("rv64gc_zba_zbb_zbs", zb_features->GetFeatureString().c_str());
+  EXPECT_TRUE(zb_features->HasAtLeast(base_features.get()));
+  EXPECT_FALSE(base_features->HasAtLeast(zb_features.get()));
+
+  std::unique_ptr<const InstructionSetFeatures> no_zbs_features(
+      zb_features->AddFeaturesFromString("-zbs", &error_msg));
+  ASSERT_TRUE(no_zbs_features.get() != nullptr) << error_msg;
+  EXPECT_STREQ("rv64gc_zba_zbb", no_zbs_features->GetFeatureString().c_str());
+
+  // The feature string can be parsed back.
+  std::unique_ptr<const InstructionSetFeatures> isa_features(
+      base_features->AddFeaturesFromString("rv64gcv_zba_zbb_xtheadba", &error_msg));
+  ASSERT_TRUE(isa_features.get() != nullptr) << error_msg;
+  EXPECT_STREQ("rv64gcv_zba_zbb_xtheadba", isa_features->GetFeatureString().c_str());
+  std::unique_ptr<const InstructionSetFeatures> parsed_features(
+      base_features->AddFeaturesFromString(isa_features->GetFeatureString(), &error_msg));
+  ASSERT_TRUE(parsed_features.get() != nullptr) << error_msg;
+  EXPECT_TRUE(isa_features->Equals(parsed_features.get()));
+
+  // Unknown features are rejected.
+  EXPECT_TRUE(base_features->AddFeaturesFromString("zbx", &error_msg) == nullptr);
+}
+
 }  // namespace art
@@ -49,5 +49,14 @@ std::ostream& operator<<(std::ostream& os, const FRegister& rhs) {
   return os;
 }
 
+std::ostream& operator<<(std::ostream& os, const VRegister& rhs) {
+  if (rhs >= V0 && rhs < kNumberOfVRegisters) {
+    os << "v" << static_cast<int>(rhs);
+  } else {
+    os << "VRegister[" << static_cast<int>(rhs) << "]";
+  }
+  return os;
+}
+
 }  // namespace riscv64
 }  // namespace art
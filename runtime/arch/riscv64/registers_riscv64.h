@@ -70,6 +70,7 @@ enum XRegister {
   TR = S1,    // ART Thread Register - managed runtime
   TMP = T6,   // Reserved for special uses, such as assembler macro instructions.
   TMP2 = T5,  // Reserved for special uses, such as assembler macro instructions.
+  MR = S11,   // ART Marking Register
 };
 
 std::ostream& operator<<(std::ostream& os, const XRegister& rhs);
@@ -120,6 +121,51 @@ enum FRegister {
 
 std::ostream& operator<<(std::ostream& os, const FRegister& rhs);
 
+enum VRegister {
+  V0 = 0,
+  V1 = 1,
+  V2 = 2,
+  V3 = 3,
+  V4 = 4,
+  V5 = 5,
+  V6 = 6,
+  V7 = 7,
+  V8 = 8,
+  V9 = 9,
+  V10 = 10,
+  V11 = 11,
+  V12 = 12,
+  V13 = 13,
+  V14 = 14,
+  V15 = 15,
+  V16 = 16,
+  V17 = 17,
+  V18 = 18,
+  V19 = 19,
+  V20 = 20,
+  V21 = 21,
+  V22 = 22,
+  V23 = 23,
+  V24 = 24,
+  V25 = 25,
+  V26 = 26,
+  V27 = 27,
+  V28 = 28,
+  V29 = 29,
+  V30 = 30,
+  V31 = 31,
+
+  kNumberOfVRegisters = 32,
+  kNoVRegister = -1,  // Signals an illegal V register.
+
+  // Reserved for special uses, such as vector scratch in the compiler. The compiler keeps
+  // vector values in the V register numbered as the allocated F register, so this is the
+  // V register corresponding to the blocked FTMP.
+  VTMP = V31,
+};
+
+std::ostream& operator<<(std::ostream& os, const VRegister& rhs);
+
 }  // namespace riscv64
 }  // namespace art
 
@@ -72,6 +72,7 @@ enum LockLevel : uint8_t {
   kRosAllocBracketLock,
   kRosAllocBulkFreeLock,
   kAllocSpaceLock,
+  kThinLockHashCodesLock,
   kTaggingLockLevel,
   kJitCodeCacheLock,
   kTransactionLogLock,
@@ -88,9 +88,10 @@ void MemMapArena::Release() {
   }
 }
 
-MemMapArenaPool::MemMapArenaPool(bool low_4gb, const char* name)
+MemMapArenaPool::MemMapArenaPool(bool low_4gb, const char* name, size_t trim_retained_bytes)
     : low_4gb_(low_4gb),
       name_(name),
+      trim_retained_bytes_(trim_retained_bytes),
       free_arenas_(nullptr) {
   MemMap::Init();
 }
@@ -131,8 +132,15 @@ Arena* MemMapArenaPool::AllocArena(size_t size) {
 void MemMapArenaPool::TrimMaps() {
   ScopedTrace trace(__PRETTY_FUNCTION__);
   std::lock_guard<std::mutex> lock(lock_);
+  // Freed arenas are added at the head of the list, keep the first ones.
+  size_t retained_bytes = 0u;
   for (Arena* arena = free_arenas_; arena != nullptr; arena = arena->next_) {
-    arena->Release();
+    if (trim_retained_bytes_ - retained_bytes >= arena->Size()) {
+      retained_bytes += arena->Size();
+    } else {
+      retained_bytes = trim_retained_bytes_;
+      arena->Release();
+    }
   }
 }
 
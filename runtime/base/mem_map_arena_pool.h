@@ -23,19 +23,25 @@ namespace art {
 
 class MemMapArenaPool final : public ArenaPool {
  public:
-  explicit MemMapArenaPool(bool low_4gb = false, const char* name = "LinearAlloc");
+  // `trim_retained_bytes` is the size of the free arenas that `TrimMaps()` keeps resident.
+  explicit MemMapArenaPool(bool low_4gb = false,
+                           const char* name = "LinearAlloc",
+                           size_t trim_retained_bytes = 0u);
   virtual ~MemMapArenaPool();
   Arena* AllocArena(size_t size) override;
   void FreeArenaChain(Arena* first) override;
   size_t GetBytesAllocated() const override;
   void ReclaimMemory() override;
   void LockReclaimMemory() override;
-  // Trim the maps in arenas by madvising, used by JIT to reduce memory usage.
+  // Trim the maps in arenas by madvising, used by JIT to reduce memory usage. The most recently
+  // freed arenas are kept up to `trim_retained_bytes_`, as the next user of the pool is likely to
+  // need them and would otherwise fault in and zero their pages again.
   void TrimMaps() override;
 
  private:
   const bool low_4gb_;
   const char* name_;
+  const size_t trim_retained_bytes_;
   Arena* free_arenas_;
   // Use a std::mutex here as Arenas are second-from-the-bottom when using MemMaps, and MemMap
   // itself uses std::mutex scoped to within an allocate/free only.
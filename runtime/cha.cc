@@ -77,6 +77,16 @@ void ClassHierarchyAnalysis::RemoveDependentsWithMethodHeaders(
       map_it++;
     }
   }
+
+  // Freed code is not on any stack.
+  if (!pending_method_headers_.empty()) {
+    for (OatQuickMethodHeader* method_header : method_headers) {
+      pending_method_headers_.erase(method_header);
+    }
+    if (pending_method_headers_.empty()) {
+      has_pending_invalidations_.store(false, std::memory_order_relaxed);
+    }
+  }
 }
 
 void ClassHierarchyAnalysis::ResetSingleImplementationInHierarchy(ObjPtr<mirror::Class> klass,
@@ -620,8 +630,6 @@ void ClassHierarchyAnalysis::InvalidateSingleImplementationMethods(
   if (!invalidated_single_impl_methods.empty()) {
     Runtime* const runtime = Runtime::Current();
     Thread *self = Thread::Current();
-    // Method headers for compiled code to be invalidated.
-    std::unordered_set<OatQuickMethodHeader*> dependent_method_headers;
     PointerSize image_pointer_size =
         Runtime::Current()->GetClassLinker()->GetImagePointerSize();
 
@@ -662,10 +670,16 @@ void ClassHierarchyAnalysis::InvalidateSingleImplementationMethods(
             // since it would run into problems with lock-ordering. We don't want to re-order the
             // locks since that would make code-commit racy.
             headers.push_back({method, method_header});
-            dependent_method_headers.insert(method_header);
+            // The frames are deoptimized by ProcessPendingInvalidations() before any class,
+            // including the one being loaded, is initialized.
+            pending_method_headers_.insert(method_header);
           }
           RemoveAllDependenciesFor(invalidated);
         }
+        if (!pending_method_headers_.empty()) {
+          // Released before the class is published as resolved.
+          has_pending_invalidations_.store(true, std::memory_order_release);
+        }
       }
       // Since we are still loading the class that invalidated the code it's fine we have this after
       // getting rid of the dependency. Any calls would need to be with the old version (since the
@@ -679,17 +693,38 @@ void ClassHierarchyAnalysis::InvalidateSingleImplementationMethods(
         }
       }
     }
+  }
+}
 
-    if (dependent_method_headers.empty()) {
-      return;
-    }
+void ClassHierarchyAnalysis::ProcessPendingInvalidations(Thread* self) {
+  if (!has_pending_invalidations_.load(std::memory_order_acquire)) {
+    return;
+  }
+  // Keep the method headers pending until their frames are deoptimized, so that a thread
+  // initializing a class concurrently runs its own checkpoint instead of finding none.
+  std::unordered_set<OatQuickMethodHeader*> method_headers;
+  {
+    MutexLock cha_mu(self, *Locks::cha_lock_);
+    method_headers = pending_method_headers_;
+  }
+  if (!method_headers.empty()) {
+    VLOG(class_linker) << "CHA deoptimizing frames of " << method_headers.size()
+                       << " invalidated compiled methods";
     // Deoptimze compiled code on stack that should have been invalidated.
-    CHACheckpoint checkpoint(dependent_method_headers);
-    size_t threads_running_checkpoint = runtime->GetThreadList()->RunCheckpoint(&checkpoint);
+    CHACheckpoint checkpoint(method_headers);
+    size_t threads_running_checkpoint =
+        Runtime::Current()->GetThreadList()->RunCheckpoint(&checkpoint);
     if (threads_running_checkpoint != 0) {
       checkpoint.WaitForThreadsToRunThroughCheckpoint(threads_running_checkpoint);
     }
   }
+  MutexLock cha_mu(self, *Locks::cha_lock_);
+  for (OatQuickMethodHeader* method_header : method_headers) {
+    pending_method_headers_.erase(method_header);
+  }
+  if (pending_method_headers_.empty()) {
+    has_pending_invalidations_.store(false, std::memory_order_relaxed);
+  }
 }
 
 void ClassHierarchyAnalysis::RemoveDependenciesForLinearAlloc(Thread* self,
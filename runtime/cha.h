@@ -17,6 +17,7 @@
 #ifndef ART_RUNTIME_CHA_H_
 #define ART_RUNTIME_CHA_H_
 
+#include <atomic>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -30,6 +31,7 @@ namespace art {
 
 class ArtMethod;
 class LinearAlloc;
+class Thread;
 
 /**
  * Class Hierarchy Analysis (CHA) tries to devirtualize virtual calls into
@@ -65,6 +67,12 @@ class LinearAlloc;
  * checkpoint that walks the stack and for any compiled code on the stack
  * that should be deoptimized, set the hidden local variable value to be true.
  *
+ * The checkpoint is deferred: the invalidated method headers of all classes
+ * loaded since the last checkpoint are collected and the stacks are walked
+ * once, before any class is initialized. A frame can only receive an instance
+ * of a newly loaded class after that class is initialized, so loading a burst
+ * of classes, e.g. for a plugin, runs a single checkpoint.
+ *
  * A cha_lock_ needs to be held for updating single-implementation status,
  * and registering/unregistering CHA dependencies. Registering CHA dependency
  * and making compiled code visible also need to be atomic. Otherwise, we
@@ -124,6 +132,12 @@ class ClassHierarchyAnalysis {
   // Update CHA info for methods that `klass` overrides, after loading `klass`.
   void UpdateAfterLoadingOf(Handle<mirror::Class> klass) REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Deoptimize the frames of the compiled code invalidated by loading classes since the last
+  // call. Must be called before initializing a class, which allows instantiating it.
+  void ProcessPendingInvalidations(Thread* self)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!Locks::cha_lock_);
+
   // Remove all of the dependencies for a linear allocator. This is called when dex cache unloading
   // occurs.
   void RemoveDependenciesForLinearAlloc(Thread* self, const LinearAlloc* linear_alloc)
@@ -171,6 +185,11 @@ class ClassHierarchyAnalysis {
   std::unordered_map<ArtMethod*, ListOfDependentPairs> cha_dependency_map_
     GUARDED_BY(Locks::cha_lock_);
 
+  // Method headers of invalidated compiled code whose frames are not deoptimized yet.
+  std::unordered_set<OatQuickMethodHeader*> pending_method_headers_ GUARDED_BY(Locks::cha_lock_);
+  // Whether `pending_method_headers_` may be non-empty, checked without the lock.
+  std::atomic<bool> has_pending_invalidations_ = false;
+
   DISALLOW_COPY_AND_ASSIGN(ClassHierarchyAnalysis);
 };
 
@@ -62,6 +62,7 @@
 #include "cha.h"
 #include "class_linker-inl.h"
 #include "class_loader_utils.h"
+#include "class_path_index.h"
 #include "class_root-inl.h"
 #include "class_table-inl.h"
 #include "compiler_callbacks.h"
@@ -386,6 +387,9 @@ void ClassLinker::VisiblyInitializedCallbackDone(Thread* self,
 }
 
 void ClassLinker::ForceClassInitialized(Thread* self, Handle<mirror::Class> klass) {
+  if (cha_ != nullptr) {
+    cha_->ProcessPendingInvalidations(self);
+  }
   ClassLinker::VisiblyInitializedCallback* cb = MarkClassInitialized(self, klass);
   if (cb != nullptr) {
     cb->MakeVisible(self);
@@ -396,6 +400,7 @@ void ClassLinker::ForceClassInitialized(Thread* self, Handle<mirror::Class> klas
 
 ClassLinker::VisiblyInitializedCallback* ClassLinker::MarkClassInitialized(
     Thread* self, Handle<mirror::Class> klass) {
+  GetMetrics()->ClassInitializationCount()->AddOne();
   if (kRuntimeISA == InstructionSet::kX86 || kRuntimeISA == InstructionSet::kX86_64) {
     // Thanks to the x86 memory model, we do not need any memory fences and
     // we can immediately mark the class as visibly initialized.
@@ -572,6 +577,7 @@ static void WrapExceptionInInitializer(Handle<mirror::Class> klass)
 ClassLinker::ClassLinker(InternTable* intern_table, bool fast_class_not_found_exceptions)
     : boot_class_table_(new ClassTable()),
       failed_dex_cache_class_lookups_(0),
+      dex_file_close_count_(0u),
       class_roots_(nullptr),
       find_array_class_cache_next_victim_(0),
       init_done_(false),
@@ -1208,7 +1214,11 @@ static uint32_t ComputeMethodHash(ArtMethod* method) REQUIRES_SHARED(Locks::muta
   const DexFile& dex_file = method->GetDeclaringClass<kWithoutReadBarrier>()->GetDexFile();
   const dex::MethodId& method_id = dex_file.GetMethodId(method->GetDexMethodIndex());
   std::string_view name = dex_file.GetMethodNameView(method_id);
-  return ComputeModifiedUtf8Hash(name);
+  // Mix in the shorty, which is the same in all dex files for equal signatures, so that most
+  // overloads, common in generated code such as protobuf builders, get different hashes and
+  // are told apart without comparing their full signatures.
+  std::string_view shorty = dex_file.GetShortyView(dex_file.GetProtoId(method_id.proto_idx_));
+  return ComputeModifiedUtf8Hash(name) * 31u + ComputeModifiedUtf8Hash(shorty);
 }
 
 ALWAYS_INLINE
@@ -3104,17 +3114,42 @@ bool ClassLinker::FindClassInBaseDexClassLoaderClassPath(
 
   const DexFile* dex_file = nullptr;
   const dex::ClassDef* class_def = nullptr;
-  ObjPtr<mirror::Class> ret;
-  auto find_class_def = [&](const DexFile* cp_dex_file) REQUIRES_SHARED(Locks::mutator_lock_) {
-    const dex::ClassDef* cp_class_def = OatDexFile::FindClassDef(*cp_dex_file, descriptor, hash);
-    if (cp_class_def != nullptr) {
-      dex_file = cp_dex_file;
-      class_def = cp_class_def;
-      return false;  // Found a class definition, stop visit.
-    }
-    return true;  // Continue with the next DexFile.
-  };
-  VisitClassLoaderDexFiles(self, class_loader, find_class_def);
+  ClassTable* const class_table = ClassTableForClassLoader(class_loader.Get());
+  if (class_table != nullptr) {
+    // Search the dex files with the class path index of the class loader. Parent class loaders
+    // repeat this search for each class they don't define, so it is worth creating the index
+    // when there is no valid one for the current dex elements.
+    ObjPtr<mirror::Object> dex_elements = GetClassLoaderDexElements(class_loader);
+    uint32_t dex_file_close_count = GetDexFileCloseCount();
+    if (!class_table->FindClassDefInClassPathIndex(
+            dex_elements, dex_file_close_count, descriptor, hash, &dex_file, &class_def)) {
+      std::vector<const DexFile*> dex_files;
+      VisitClassLoaderDexFiles(self,
+                               class_loader,
+                               [&](const DexFile* cp_dex_file) {
+                                 if (cp_dex_file != nullptr) {
+                                   dex_files.push_back(cp_dex_file);
+                                 }
+                                 return true;  // Continue with the next DexFile.
+                               });
+      std::unique_ptr<ClassPathIndex> index = std::make_unique<ClassPathIndex>(
+          dex_elements, std::move(dex_files), dex_file_close_count);
+      class_def = index->FindClassDef(descriptor, hash, &dex_file);
+      class_table->SetClassPathIndex(std::move(index));
+    }
+  } else {
+    auto find_class_def = [&](const DexFile* cp_dex_file) REQUIRES_SHARED(Locks::mutator_lock_) {
+      const dex::ClassDef* cp_class_def =
+          OatDexFile::FindClassDef(*cp_dex_file, descriptor, hash);
+      if (cp_class_def != nullptr) {
+        dex_file = cp_dex_file;
+        class_def = cp_class_def;
+        return false;  // Found a class definition, stop visit.
+      }
+      return true;  // Continue with the next DexFile.
+    };
+    VisitClassLoaderDexFiles(self, class_loader, find_class_def);
+  }
 
   if (class_def != nullptr) {
     *result = DefineClass(self, descriptor, hash, class_loader, *dex_file, *class_def);
@@ -3364,6 +3399,7 @@ ObjPtr<mirror::Class> ClassLinker::DefineClass(Thread* self,
   StackHandleScope<3> hs(self);
   metrics::AutoTimer timer{GetMetrics()->ClassLoadingTotalTime()};
   metrics::AutoTimer timeDelta{GetMetrics()->ClassLoadingTotalTimeDelta()};
+  GetMetrics()->ClassLoadingCount()->AddOne();
   auto klass = hs.NewHandle<mirror::Class>(nullptr);
 
   // Load the class from the dex file.
@@ -4610,6 +4646,11 @@ ObjPtr<mirror::Class> ClassLinker::LookupClass(Thread* self,
                                                const char* descriptor,
                                                size_t hash,
                                                ObjPtr<mirror::ClassLoader> class_loader) {
+  if (class_loader == nullptr) {
+    // The boot class table lives as long as the class linker and `ClassTable::Lookup()` does its
+    // own locking, so boot class path lookups, the most frequent ones, skip the global lock.
+    return ClassTableForClassLoader(nullptr)->Lookup(descriptor, hash);
+  }
   ReaderMutexLock mu(self, *Locks::classlinker_classes_lock_);
   ClassTable* const class_table = ClassTableForClassLoader(class_loader);
   if (class_table != nullptr) {
@@ -4881,6 +4922,12 @@ verifier::FailureKind ClassLinker::VerifyClass(Thread* self,
   std::string error_msg;
   verifier::FailureKind verifier_failure = verifier::FailureKind::kNoFailure;
   if (!preverified) {
+    if (!Runtime::Current()->IsAotCompiler()) {
+      // The other classes of the dex file likely need runtime verification too, try to verify
+      // them in the background before they are used.
+      Runtime::Current()->GetOatFileManager().RunSpeculativeVerification(
+          self, dex_file, klass->GetClassLoader());
+    }
     verifier_failure = PerformClassVerification(self, verifier_deps, klass, log_level, &error_msg);
   } else if (oat_file_class_status == ClassStatus::kVerifiedNeedsAccessChecks) {
     verifier_failure = verifier::FailureKind::kAccessChecksFailure;
@@ -5256,6 +5303,11 @@ ObjPtr<mirror::Class> ClassLinker::CreateProxyClass(ScopedObjectAccessAlreadyRun
     // TODO: Avoid taking subtype_check_lock_ if SubtypeCheck for j.l.r.Proxy is already assigned.
   }
 
+  if (cha_ != nullptr) {
+    // Linking the proxy class may have invalidated compiled code for its interfaces.
+    cha_->ProcessPendingInvalidations(self);
+  }
+
   VisiblyInitializedCallback* callback = nullptr;
   {
     // Lock on klass is released. Lock new class object.
@@ -5437,6 +5489,11 @@ bool ClassLinker::InitializeClass(Thread* self,
   }
 
   self->AllowThreadSuspension();
+  if (cha_ != nullptr) {
+    // Deoptimize the compiled code invalidated by loading `klass` or other classes before any
+    // instance can be created, including by the class initializer.
+    cha_->ProcessPendingInvalidations(self);
+  }
   Runtime* const runtime = Runtime::Current();
   const bool stats_enabled = runtime->HasStatsEnabled();
   uint64_t t0;
@@ -6487,10 +6544,12 @@ ArtMethod* ClassLinker::AddMethodToConflictTable(ObjPtr<mirror::Class> klass,
       ? runtime->CreateImtConflictMethod(linear_alloc)
       : conflict_method;
 
-  // Allocate a new table. Note that we will leak this table at the next conflict,
-  // but that's a tradeoff compared to making the table fixed size.
+  // Allocate a new table. The replaced table is freed below, but only reused once no thread can
+  // be reading it anymore. Tables that grow past ImtConflictTable::kHashedTableMinEntries are
+  // rebuilt with the hashed layout.
+  Thread* const self = Thread::Current();
   void* data = linear_alloc->Alloc(
-      Thread::Current(),
+      self,
       ImtConflictTable::ComputeSizeWithOneMoreEntry(current_table, image_pointer_size_),
       LinearAllocKind::kNoGCRoots);
   if (data == nullptr) {
@@ -6508,7 +6567,14 @@ ArtMethod* ClassLinker::AddMethodToConflictTable(ObjPtr<mirror::Class> klass,
   // memory from the LinearAlloc, but that's a tradeoff compared to using
   // atomic operations.
   std::atomic_thread_fence(std::memory_order_release);
+  ImtConflictTable* replaced_table = new_conflict_method->GetImtConflictTable(image_pointer_size_);
   new_conflict_method->SetImtConflictTable(new_table, image_pointer_size_);
+  // The shared conflict method and the ones in the boot image keep their tables. The computed
+  // size may be less than the allocation, for example for hashed tables, which is fine for
+  // LinearAlloc::Free().
+  if (linear_alloc->Contains(replaced_table)) {
+    linear_alloc->Free(self, replaced_table, replaced_table->ComputeSize(image_pointer_size_));
+  }
   return new_conflict_method;
 }
 
@@ -7907,9 +7973,9 @@ void ClassLinker::LinkMethodsHelper<kPointerSize>::ReallocMethods(ObjPtr<mirror:
                                                                       kMethodSize,
                                                                       kMethodAlignment);
   const size_t old_methods_ptr_size = (old_methods != nullptr) ? old_size : 0;
-  auto* methods = reinterpret_cast<LengthPrefixedArray<ArtMethod>*>(
-      class_linker_->GetAllocatorForClassLoader(klass->GetClassLoader())->Realloc(
-          self_, old_methods, old_methods_ptr_size, new_size, LinearAllocKind::kArtMethodArray));
+  LinearAlloc* allocator = class_linker_->GetAllocatorForClassLoader(klass->GetClassLoader());
+  auto* methods = reinterpret_cast<LengthPrefixedArray<ArtMethod>*>(allocator->Realloc(
+      self_, old_methods, old_methods_ptr_size, new_size, LinearAllocKind::kArtMethodArray));
   CHECK(methods != nullptr);  // Native allocation failure aborts.
 
   if (methods != old_methods) {
@@ -7929,6 +7995,11 @@ void ClassLinker::LinkMethodsHelper<kPointerSize>::ReallocMethods(ObjPtr<mirror:
         m.SetDeclaringClass(nullptr);
       }
     }
+    if (old_methods != nullptr) {
+      // The class is not visible yet, so nothing outside of this function refers to the old
+      // array once the new one is installed below.
+      allocator->Free(self_, old_methods, old_size);
+    }
   }
 
   // Collect and sort copied method records by the vtable index. This places overriding
@@ -8297,8 +8368,8 @@ size_t ClassLinker::LinkMethodsHelper<kPointerSize>::AssignVTableIndexes(
                                 bit_vector_size,
                                 bit_vector_buffer_ptr);
 
-  // Note: our sets hash on the method name, and therefore we pay a high
-  // performance price when a class has many overloads.
+  // Note: our sets hash on the method name and shorty, and therefore we pay a high
+  // performance price when a class has many overloads with the same shorty.
   //
   // We populate a set of declared signatures instead of signatures from the
   // super vtable (which is only lazy populated in case of interface overriding,
@@ -10789,6 +10860,8 @@ void ClassLinker::InsertDexFileInToClassLoader(ObjPtr<mirror::Object> dex_file,
 void ClassLinker::CleanupClassLoaders() {
   Thread* const self = Thread::Current();
   std::list<ClassLoaderData> to_delete;
+  // Make the spans freed before the previous GC reusable. This is called once per GC cycle.
+  Runtime::Current()->GetLinearAlloc()->ReclaimFreedSpans(self);
   // Do the delete outside the lock to avoid lock violation in jit code cache.
   {
     WriterMutexLock mu(self, *Locks::classlinker_classes_lock_);
@@ -10802,6 +10875,8 @@ void ClassLinker::CleanupClassLoaders() {
       if (class_loader == nullptr) {
         VLOG(class_linker) << "Freeing class loader";
         to_delete.splice(to_delete.end(), class_loaders_, this_it);
+      } else {
+        data.allocator->ReclaimFreedSpans(self);
       }
     }
   }
@@ -10980,6 +11055,7 @@ void ClassLinker::SetEnablePublicSdkChecks([[maybe_unused]] bool enabled) {
 }
 
 void ClassLinker::RemoveDexFromCaches(const DexFile& dex_file) {
+  dex_file_close_count_.fetch_add(1u, std::memory_order_release);
   ReaderMutexLock mu(Thread::Current(), *Locks::dex_lock_);
 
   auto it = dex_caches_.find(&dex_file);
@@ -867,6 +867,11 @@ class ClassLinker {
   virtual void SetEnablePublicSdkChecks(bool enabled);
   void RemoveDexFromCaches(const DexFile& dex_file);
 
+  // Returns the number of dex files removed with `RemoveDexFromCaches()` to be closed.
+  uint32_t GetDexFileCloseCount() const {
+    return dex_file_close_count_.load(std::memory_order_acquire);
+  }
+
  protected:
   virtual bool InitializeClass(Thread* self,
                                Handle<mirror::Class> klass,
@@ -1334,6 +1339,10 @@ class ClassLinker {
   // the classes into the class_table_ to avoid dex cache based searches.
   Atomic<uint32_t> failed_dex_cache_class_lookups_;
 
+  // Number of dex files removed with `RemoveDexFromCaches()`. Invalidates `ClassPathIndex`es which
+  // may refer to them.
+  Atomic<uint32_t> dex_file_close_count_;
+
   // Well known mirror::Class roots.
   GcRoot<mirror::ObjectArray<mirror::Class>> class_roots_;
 
@@ -477,9 +477,8 @@ bool ClassLoaderContext::OpenDexFiles(const std::string& classpath_dir,
       std::optional<uint32_t> dex_checksum;
       if (only_read_checksums) {
         bool zip_file_only_contains_uncompress_dex;
-        ArtDexFileLoader dex_file_loader(DupCloexec(fd), location);
-        if (!dex_file_loader.GetMultiDexChecksum(
-                &dex_checksum, &error_msg, &zip_file_only_contains_uncompress_dex)) {
+        if (!OatFileAssistant::GetMultiDexChecksumCached(
+                fd, location, &dex_checksum, &error_msg, &zip_file_only_contains_uncompress_dex)) {
           LOG(WARNING) << "Could not get dex checksums for location " << location << ", fd=" << fd;
           dex_files_state_ = kDexFilesOpenFailed;
         }
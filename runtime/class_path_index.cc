@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "class_path_index.h"
+
+#include <string.h>
+
+#include "base/logging.h"
+#include "dex/dex_file-inl.h"
+#include "dex/utf.h"
+#include "gc_root-inl.h"
+#include "oat_file.h"
+
+namespace art {
+
+const char* ClassPathIndex::EntryEquals::GetDescriptor(const Entry& entry) const {
+  const DexFile* dex_file = (*dex_files_)[entry.dex_file_index];
+  return dex_file->GetClassDescriptor(dex_file->GetClassDef(entry.class_def_index));
+}
+
+bool ClassPathIndex::EntryEquals::operator()(const Entry& a, const Entry& b) const {
+  return a.hash == b.hash && strcmp(GetDescriptor(a), GetDescriptor(b)) == 0;
+}
+
+bool ClassPathIndex::EntryEquals::operator()(const Entry& entry,
+                                             const DescriptorHashPair& key) const {
+  return entry.hash == key.second && strcmp(GetDescriptor(entry), key.first) == 0;
+}
+
+ClassPathIndex::ClassPathIndex(ObjPtr<mirror::Object> dex_elements,
+                               std::vector<const DexFile*>&& dex_files,
+                               uint32_t dex_file_close_count)
+    : dex_elements_(dex_elements),
+      dex_files_(std::move(dex_files)),
+      dex_file_close_count_(dex_file_close_count),
+      entries_(EntryHash(), EntryEquals(&dex_files_)) {
+  if (!HasMergedIndex()) {
+    return;
+  }
+  for (size_t i = 0; i != dex_files_.size(); ++i) {
+    const DexFile* dex_file = dex_files_[i];
+    DCHECK_LE(dex_file->NumClassDefs(), 1u << 16);
+    for (uint32_t class_def_index = 0; class_def_index != dex_file->NumClassDefs();
+         ++class_def_index) {
+      const char* descriptor =
+          dex_file->GetClassDescriptor(dex_file->GetClassDef(class_def_index));
+      uint32_t hash = ComputeModifiedUtf8Hash(descriptor);
+      // Keep the first definition, which is the one a lookup in the dex files finds.
+      if (entries_.FindWithHash(DescriptorHashPair(descriptor, hash), hash) == entries_.end()) {
+        entries_.InsertWithHash(Entry{hash,
+                                      static_cast<uint16_t>(i),
+                                      static_cast<uint16_t>(class_def_index)},
+                                hash);
+      }
+    }
+  }
+  VLOG(class_linker) << "Created class path index with " << entries_.size() << " classes in "
+                     << dex_files_.size() << " dex files";
+}
+
+bool ClassPathIndex::IsValid(ObjPtr<mirror::Object> dex_elements,
+                             uint32_t dex_file_close_count) const {
+  return dex_file_close_count == dex_file_close_count_ && dex_elements_.Read() == dex_elements;
+}
+
+const dex::ClassDef* ClassPathIndex::FindClassDef(const char* descriptor,
+                                                  size_t hash,
+                                                  /*out*/ const DexFile** dex_file) const {
+  if (!HasMergedIndex()) {
+    for (const DexFile* cp_dex_file : dex_files_) {
+      const dex::ClassDef* class_def = OatDexFile::FindClassDef(*cp_dex_file, descriptor, hash);
+      if (class_def != nullptr) {
+        *dex_file = cp_dex_file;
+        return class_def;
+      }
+    }
+    return nullptr;
+  }
+  uint32_t hash32 = static_cast<uint32_t>(hash);
+  auto it = entries_.FindWithHash(DescriptorHashPair(descriptor, hash32), hash32);
+  if (it == entries_.end()) {
+    return nullptr;
+  }
+  *dex_file = dex_files_[it->dex_file_index];
+  return &(*dex_file)->GetClassDef(it->class_def_index);
+}
+
+}  // namespace art
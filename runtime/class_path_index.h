@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_CLASS_PATH_INDEX_H_
+#define ART_RUNTIME_CLASS_PATH_INDEX_H_
+
+#include <utility>
+#include <vector>
+
+#include "base/allocator.h"
+#include "base/hash_set.h"
+#include "base/locks.h"
+#include "base/macros.h"
+#include "gc_root.h"
+#include "obj_ptr.h"
+
+namespace art {
+
+class DexFile;
+
+namespace dex {
+struct ClassDef;
+}  // namespace dex
+
+namespace mirror {
+class Object;
+}  // namespace mirror
+
+// Index of the class definitions in the dex path list of a BaseDexClassLoader. Looking up a class
+// in a long dex path list, as created by plugin frameworks, otherwise probes the type lookup table
+// of each dex file in turn, which all parent class loaders repeat for classes they don't define.
+//
+// The index is only valid for the `dexElements` array of the DexPathList it was created for, the
+// class loader replaces that array when dex files are added to it.
+class ClassPathIndex {
+ public:
+  // Dex path lists with fewer dex files are searched by probing each dex file, the index then
+  // only saves walking the dex elements.
+  static constexpr size_t kMinDexFilesForMergedIndex = 8u;
+
+  // Create an index for `dex_files`, which are the dex files of `dex_elements` in order.
+  // `dex_file_close_count` is `ClassLinker::GetDexFileCloseCount()` before collecting them.
+  ClassPathIndex(ObjPtr<mirror::Object> dex_elements,
+                 std::vector<const DexFile*>&& dex_files,
+                 uint32_t dex_file_close_count)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Returns true if the index is still valid for `dex_elements`, the current dex elements of the
+  // class loader. A dex file that was closed may have been in the index, so an index is also
+  // invalid when any dex file was closed since it was created.
+  bool IsValid(ObjPtr<mirror::Object> dex_elements, uint32_t dex_file_close_count) const
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Returns the first class definition for `descriptor` in the dex path list and sets `dex_file`
+  // to the dex file that contains it, or returns null if there is none.
+  const dex::ClassDef* FindClassDef(const char* descriptor,
+                                    size_t hash,
+                                    /*out*/ const DexFile** dex_file) const;
+
+  size_t NumDexFiles() const {
+    return dex_files_.size();
+  }
+
+  template <typename Visitor>
+  void VisitRoot(Visitor& visitor) NO_THREAD_SAFETY_ANALYSIS {
+    visitor.VisitRootIfNonNull(dex_elements_.AddressWithoutBarrier());
+  }
+
+ private:
+  // A class definition, by the index of its dex file in `dex_files_` and its class def index.
+  struct Entry {
+    uint32_t hash;
+    uint16_t dex_file_index;
+    uint16_t class_def_index;
+  };
+
+  static constexpr uint16_t kEmptyDexFileIndex = 0xffffu;
+
+  struct EntryEmptyFn {
+    void MakeEmpty(Entry& item) const {
+      item.dex_file_index = kEmptyDexFileIndex;
+    }
+    bool IsEmpty(const Entry& item) const {
+      return item.dex_file_index == kEmptyDexFileIndex;
+    }
+  };
+
+  using DescriptorHashPair = std::pair<const char*, uint32_t>;
+
+  struct EntryHash {
+    size_t operator()(const Entry& entry) const {
+      return entry.hash;
+    }
+    size_t operator()(const DescriptorHashPair& key) const {
+      return key.second;
+    }
+  };
+
+  struct EntryEquals {
+    explicit EntryEquals(const std::vector<const DexFile*>* dex_files = nullptr)
+        : dex_files_(dex_files) {}
+    bool operator()(const Entry& a, const Entry& b) const;
+    bool operator()(const Entry& entry, const DescriptorHashPair& key) const;
+
+    const char* GetDescriptor(const Entry& entry) const;
+
+    const std::vector<const DexFile*>* dex_files_;
+  };
+
+  bool HasMergedIndex() const {
+    return dex_files_.size() >= kMinDexFilesForMergedIndex &&
+           dex_files_.size() < kEmptyDexFileIndex;
+  }
+
+  using EntrySet = HashSet<Entry,
+                           EntryEmptyFn,
+                           EntryHash,
+                           EntryEquals,
+                           TrackingAllocator<Entry, kAllocatorTagClassTable>>;
+
+  // Keeps the `dexElements` array the index was created for. The array is also referenced by the
+  // class loader until the class loader replaces it, after which the index is recreated.
+  GcRoot<mirror::Object> dex_elements_;
+  const std::vector<const DexFile*> dex_files_;
+  const uint32_t dex_file_close_count_;
+  // Empty unless `HasMergedIndex()`.
+  EntrySet entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(ClassPathIndex);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_CLASS_PATH_INDEX_H_
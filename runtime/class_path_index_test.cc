@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "class_path_index.h"
+
+#include <memory>
+#include <vector>
+
+#include "common_runtime_test.h"
+#include "dex/dex_file-inl.h"
+#include "dex/utf.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art {
+
+class ClassPathIndexTest : public CommonRuntimeTest {
+ protected:
+  void CheckFindClassDef(const ClassPathIndex& index,
+                         const char* descriptor,
+                         const DexFile* expected_dex_file) {
+    const DexFile* dex_file = nullptr;
+    const dex::ClassDef* class_def =
+        index.FindClassDef(descriptor, ComputeModifiedUtf8Hash(descriptor), &dex_file);
+    if (expected_dex_file == nullptr) {
+      EXPECT_TRUE(class_def == nullptr) << descriptor;
+      return;
+    }
+    ASSERT_TRUE(class_def != nullptr) << descriptor;
+    EXPECT_EQ(dex_file, expected_dex_file) << descriptor;
+    EXPECT_STREQ(dex_file->GetClassDescriptor(*class_def), descriptor);
+  }
+
+  void TestFindClassDef(size_t num_nested_dex_files) {
+    std::vector<std::unique_ptr<const DexFile>> multi_dex_files = OpenTestDexFiles("MultiDex");
+    ASSERT_EQ(multi_dex_files.size(), 2u);
+    std::vector<std::unique_ptr<const DexFile>> nested_dex_files;
+    std::vector<const DexFile*> dex_files = {multi_dex_files[0].get(), multi_dex_files[1].get()};
+    for (size_t i = 0; i != num_nested_dex_files; ++i) {
+      nested_dex_files.push_back(OpenTestDexFile("Nested"));
+      dex_files.push_back(nested_dex_files.back().get());
+    }
+
+    ScopedObjectAccess soa(Thread::Current());
+    ClassPathIndex index(/*dex_elements=*/ nullptr,
+                         std::vector<const DexFile*>(dex_files),
+                         /*dex_file_close_count=*/ 0u);
+    EXPECT_EQ(index.NumDexFiles(), dex_files.size());
+    EXPECT_TRUE(index.IsValid(/*dex_elements=*/ nullptr, /*dex_file_close_count=*/ 0u));
+    EXPECT_FALSE(index.IsValid(/*dex_elements=*/ nullptr, /*dex_file_close_count=*/ 1u));
+
+    CheckFindClassDef(index, "LMain;", dex_files[0]);
+    CheckFindClassDef(index, "LSecond;", dex_files[1]);
+    // Classes defined in several dex files are found in the first one.
+    CheckFindClassDef(index, "LNested;", dex_files[2]);
+    CheckFindClassDef(index, "LNested$Inner;", dex_files[2]);
+    CheckFindClassDef(index, "LNotThere;", nullptr);
+  }
+};
+
+TEST_F(ClassPathIndexTest, FindClassDef) {
+  TestFindClassDef(/*num_nested_dex_files=*/ 2u);
+}
+
+TEST_F(ClassPathIndexTest, FindClassDefMergedIndex) {
+  TestFindClassDef(ClassPathIndex::kMinDexFilesForMergedIndex);
+}
+
+}  // namespace art
@@ -20,6 +20,7 @@
 #include "class_table.h"
 
 #include "base/mutex-inl.h"
+#include "class_path_index.h"
 #include "dex/utf.h"
 #include "gc_root-inl.h"
 #include "mirror/class.h"
@@ -84,6 +85,9 @@ void ClassTable::VisitRoots(Visitor& visitor) {
       visitor.VisitRootIfNonNull(root.AddressWithoutBarrier());
     }
   }
+  if (class_path_index_ != nullptr) {
+    class_path_index_->VisitRoot(visitor);
+  }
 }
 
 template<class Visitor>
@@ -102,6 +106,9 @@ void ClassTable::VisitRoots(const Visitor& visitor) {
       visitor.VisitRootIfNonNull(root.AddressWithoutBarrier());
     }
   }
+  if (class_path_index_ != nullptr) {
+    class_path_index_->VisitRoot(visitor);
+  }
 }
 
 template <typename Visitor>
@@ -139,6 +146,9 @@ void ClassTable::VisitClassesAndRoots(Visitor& visitor) {
       visitor.VisitRootIfNonNull(root.AddressWithoutBarrier());
     }
   }
+  if (class_path_index_ != nullptr) {
+    class_path_index_->VisitRoot(visitor);
+  }
 }
 
 template <ReadBarrierOption kReadBarrierOption, typename Visitor>
@@ -17,6 +17,7 @@
 #include "class_table-inl.h"
 
 #include "base/stl_util.h"
+#include "class_path_index.h"
 #include "mirror/class-inl.h"
 #include "mirror/string-inl.h"
 #include "oat_file.h"
@@ -27,8 +28,23 @@ ClassTable::ClassTable() : lock_("Class loader classes", kClassLoaderClassesLock
   Runtime* const runtime = Runtime::Current();
   classes_.push_back(ClassSet(runtime->GetHashTableMinLoadFactor(),
                               runtime->GetHashTableMaxLoadFactor()));
+  published_frozen_sets_.push_back(std::make_unique<FrozenClassSets>());
+  frozen_sets_.store(published_frozen_sets_.back().get(), std::memory_order_relaxed);
 }
 
+void ClassTable::PublishFrozenSetsLocked() {
+  DCHECK(!classes_.empty());
+  std::unique_ptr<FrozenClassSets> frozen_sets(new FrozenClassSets());
+  frozen_sets->reserve(classes_.size() - 1u);
+  for (auto it = classes_.begin(), end = std::prev(classes_.end()); it != end; ++it) {
+    frozen_sets->push_back(&*it);
+  }
+  frozen_sets_.store(frozen_sets.get(), std::memory_order_release);
+  published_frozen_sets_.push_back(std::move(frozen_sets));
+}
+
+ClassTable::~ClassTable() {}
+
 void ClassTable::FreezeSnapshot() {
   WriterMutexLock mu(Thread::Current(), lock_);
   // Propagate the min/max load factor from the old active set.
@@ -36,6 +52,12 @@ void ClassTable::FreezeSnapshot() {
   const ClassSet& last_set = classes_.back();
   ClassSet new_set(last_set.GetMinLoadFactor(), last_set.GetMaxLoadFactor());
   classes_.push_back(std::move(new_set));
+  PublishFrozenSetsLocked();
+  // The new active set is empty. Clear the filter only after publishing the frozen sets, so that
+  // lookups that see a cleared bit also see the set that became frozen.
+  for (Atomic<uint32_t>& word : active_set_filter_) {
+    word.store(0u, std::memory_order_release);
+  }
 }
 
 ObjPtr<mirror::Class> ClassTable::UpdateClass(const char* descriptor,
@@ -79,8 +101,8 @@ size_t ClassTable::CountDefiningLoaderClasses(ObjPtr<mirror::ClassLoader> defini
 size_t ClassTable::NumZygoteClasses(ObjPtr<mirror::ClassLoader> defining_loader) const {
   ReaderMutexLock mu(Thread::Current(), lock_);
   size_t sum = 0;
-  for (size_t i = 0; i < classes_.size() - 1; ++i) {
-    sum += CountDefiningLoaderClasses(defining_loader, classes_[i]);
+  for (auto it = classes_.begin(), end = std::prev(classes_.end()); it != end; ++it) {
+    sum += CountDefiningLoaderClasses(defining_loader, *it);
   }
   return sum;
 }
@@ -93,8 +115,8 @@ size_t ClassTable::NumNonZygoteClasses(ObjPtr<mirror::ClassLoader> defining_load
 size_t ClassTable::NumReferencedZygoteClasses() const {
   ReaderMutexLock mu(Thread::Current(), lock_);
   size_t sum = 0;
-  for (size_t i = 0; i < classes_.size() - 1; ++i) {
-    sum += classes_[i].size();
+  for (auto it = classes_.begin(), end = std::prev(classes_.end()); it != end; ++it) {
+    sum += it->size();
   }
   return sum;
 }
@@ -106,6 +128,20 @@ size_t ClassTable::NumReferencedNonZygoteClasses() const {
 
 ObjPtr<mirror::Class> ClassTable::Lookup(const char* descriptor, size_t hash) {
   DescriptorHashPair pair(descriptor, hash);
+  if (!MayBeInActiveSet(hash)) {
+    // The class can only be in a frozen set. These are never modified and live as long as the
+    // class table, so search them without the lock, which lookups from many threads would
+    // otherwise contend on. A frozen set may have been added before the frozen sets we load, in
+    // which case the lookup is ordered before that.
+    const FrozenClassSets* frozen_sets = frozen_sets_.load(std::memory_order_acquire);
+    for (const ClassSet* class_set : ReverseRange(*frozen_sets)) {
+      auto it = class_set->FindWithHash(pair, hash);
+      if (it != class_set->end()) {
+        return it->Read();
+      }
+    }
+    return nullptr;
+  }
   ReaderMutexLock mu(Thread::Current(), lock_);
   // Search from the last table, assuming that apps shall search for their own classes
   // more often than for boot image classes. For prebuilt boot images, this also helps
@@ -127,6 +163,8 @@ void ClassTable::Insert(ObjPtr<mirror::Class> klass) {
 
 void ClassTable::InsertWithHash(ObjPtr<mirror::Class> klass, size_t hash) {
   WriterMutexLock mu(Thread::Current(), lock_);
+  uint32_t bit = static_cast<uint32_t>(hash) % kActiveSetFilterBits;
+  active_set_filter_[bit / 32u].fetch_or(1u << (bit % 32u), std::memory_order_relaxed);
   classes_.back().InsertWithHash(TableSlot(klass, hash), hash);
 }
 
@@ -178,7 +216,28 @@ void ClassTable::AddClassSet(ClassSet&& set) {
   // the number of searched frozen tables and not search them again.
   // TODO: Make use of this in `ClassLinker::FindClass()`.
   DCHECK(!classes_.empty());
-  classes_.insert(classes_.end() - 1, std::move(set));
+  classes_.insert(std::prev(classes_.end()), std::move(set));
+  PublishFrozenSetsLocked();
+}
+
+bool ClassTable::FindClassDefInClassPathIndex(ObjPtr<mirror::Object> dex_elements,
+                                              uint32_t dex_file_close_count,
+                                              const char* descriptor,
+                                              size_t hash,
+                                              /*out*/ const DexFile** dex_file,
+                                              /*out*/ const dex::ClassDef** class_def) {
+  ReaderMutexLock mu(Thread::Current(), lock_);
+  if (class_path_index_ == nullptr ||
+      !class_path_index_->IsValid(dex_elements, dex_file_close_count)) {
+    return false;
+  }
+  *class_def = class_path_index_->FindClassDef(descriptor, hash, dex_file);
+  return true;
+}
+
+void ClassTable::SetClassPathIndex(std::unique_ptr<ClassPathIndex> index) {
+  WriterMutexLock mu(Thread::Current(), lock_);
+  class_path_index_ = std::move(index);
 }
 
 void ClassTable::ClearStrongRoots() {
@@ -17,11 +17,15 @@
 #ifndef ART_RUNTIME_CLASS_TABLE_H_
 #define ART_RUNTIME_CLASS_TABLE_H_
 
+#include <array>
+#include <list>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "base/allocator.h"
+#include "base/atomic.h"
 #include "base/hash_set.h"
 #include "base/macros.h"
 #include "base/mutex.h"
@@ -30,8 +34,14 @@
 
 namespace art {
 
+class ClassPathIndex;
+class DexFile;
 class OatFile;
 
+namespace dex {
+struct ClassDef;
+}  // namespace dex
+
 namespace linker {
 class ImageWriter;
 }  // namespace linker
@@ -154,6 +164,7 @@ class ClassTable {
                            TrackingAllocator<TableSlot, kAllocatorTagClassTable>>;
 
   ClassTable();
+  ~ClassTable();
 
   // Freeze the current class tables by allocating a new table and never updating or modifying the
   // existing table. This helps prevents dirty pages after caused by inserting after zygote fork.
@@ -223,6 +234,8 @@ class ClassTable {
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Return the first class that matches the descriptor. Returns null if there are none.
+  // Does not take `lock_` if no class with the same hash was inserted since the last snapshot, in
+  // which case only the frozen class sets, which are never modified, need to be searched.
   ObjPtr<mirror::Class> Lookup(const char* descriptor, size_t hash)
       REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -261,6 +274,22 @@ class ClassTable {
       REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Find the first class definition for `descriptor` in the dex path list of the class loader
+  // using the class path index. Returns false if there is no valid index for `dex_elements`.
+  bool FindClassDefInClassPathIndex(ObjPtr<mirror::Object> dex_elements,
+                                    uint32_t dex_file_close_count,
+                                    const char* descriptor,
+                                    size_t hash,
+                                    /*out*/ const DexFile** dex_file,
+                                    /*out*/ const dex::ClassDef** class_def)
+      REQUIRES(!lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Replace the class path index.
+  void SetClassPathIndex(std::unique_ptr<ClassPathIndex> index)
+      REQUIRES(!lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Clear strong roots (other than classes themselves).
   void ClearStrongRoots()
       REQUIRES(!lock_)
@@ -287,16 +316,46 @@ class ClassTable {
       REQUIRES(lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Publish the current frozen class sets, all but the last one in `classes_`, for lookups that
+  // do not take `lock_`.
+  void PublishFrozenSetsLocked() REQUIRES(lock_);
+
+  // Return false if no class with `hash` was inserted into the active class set since the last
+  // snapshot. May return true for classes that were not inserted.
+  bool MayBeInActiveSet(size_t hash) const {
+    uint32_t bit = static_cast<uint32_t>(hash) % kActiveSetFilterBits;
+    return (active_set_filter_[bit / 32u].load(std::memory_order_acquire) &
+            (1u << (bit % 32u))) != 0u;
+  }
+
+  // Number of bits of `active_set_filter_`.
+  static constexpr size_t kActiveSetFilterBits = 8 * KB;
+
+  // Class sets that are searched without taking `lock_`, in the same order as in `classes_`.
+  using FrozenClassSets = std::vector<const ClassSet*>;
+
   // Lock to guard inserting and removing.
   mutable ReaderWriterMutex lock_;
-  // We have a vector to help prevent dirty pages after the zygote forks by calling FreezeSnapshot.
-  std::vector<ClassSet> classes_ GUARDED_BY(lock_);
+  // We have a list to help prevent dirty pages after the zygote forks by calling FreezeSnapshot.
+  // It is a list so that frozen sets stay at the same address when sets are added.
+  std::list<ClassSet> classes_ GUARDED_BY(lock_);
+  // The frozen class sets as of the last snapshot or added class set. Previously published
+  // vectors are kept in `published_frozen_sets_` since lookups may still be reading them. There
+  // is one per snapshot or added class set, so there are only a few of them.
+  Atomic<const FrozenClassSets*> frozen_sets_;
+  std::vector<std::unique_ptr<FrozenClassSets>> published_frozen_sets_ GUARDED_BY(lock_);
+  // Bloom filter with one bit per descriptor hash of the classes inserted into the active set
+  // since the last snapshot. Bits are set before the class is inserted.
+  std::array<Atomic<uint32_t>, kActiveSetFilterBits / 32u> active_set_filter_;
   // Extra strong roots that can be either dex files or dex caches. Dex files used by the class
   // loader which may not be owned by the class loader must be held strongly live. Also dex caches
   // are held live to prevent them being unloading once they have classes in them.
   std::vector<GcRoot<mirror::Object>> strong_roots_ GUARDED_BY(lock_);
   // Keep track of oat files with GC roots associated with dex caches in `strong_roots_`.
   std::vector<const OatFile*> oat_files_ GUARDED_BY(lock_);
+  // Index of the classes in the dex path list of a BaseDexClassLoader, created on the first lookup
+  // that finds no valid index. Holds the dex elements array it was created for as a root.
+  std::unique_ptr<ClassPathIndex> class_path_index_ GUARDED_BY(lock_);
 
   friend class linker::ImageWriter;  // for InsertWithoutLocks.
 };
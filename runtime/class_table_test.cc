@@ -102,6 +102,8 @@ TEST_F(ClassTableTest, ClassTable) {
   table.FreezeSnapshot();
   EXPECT_EQ(table.NumZygoteClasses(class_loader.Get()), 1u);
   EXPECT_EQ(table.NumNonZygoteClasses(class_loader.Get()), 0u);
+  // h_X is now only in a frozen set, which is searched without the lock.
+  EXPECT_OBJ_PTR_EQ(table.Lookup(descriptor_x, ComputeModifiedUtf8Hash(descriptor_x)), h_X.Get());
 
   // Test inserting and related lookup functions.
   EXPECT_TRUE(table.LookupByDescriptor(h_Y.Get()) == nullptr);
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "code_info_cache.h"
+
+#include "oat_quick_method_header.h"
+
+namespace art {
+
+std::atomic<uint32_t> CodeInfoCache::epoch_(0u);
+
+void CodeInfoCache::CheckEpoch() {
+  uint32_t epoch = epoch_.load(std::memory_order_acquire);
+  if (UNLIKELY(epoch != epoch_seen_)) {
+    headers_.fill(nullptr);
+    stack_map_headers_.fill(nullptr);
+    epoch_seen_ = epoch;
+  }
+}
+
+const CodeInfo& CodeInfoCache::Get(const OatQuickMethodHeader* header) {
+  CheckEpoch();
+  size_t index = IndexOf(header);
+  if (headers_[index] == header) {
+    return code_infos_[index];
+  }
+  // Publish the header last, a stack walk from a signal handler interrupting this thread must
+  // not see a partially decoded entry.
+  headers_[index] = nullptr;
+  code_infos_[index] = CodeInfo(header);
+  headers_[index] = header;
+  return code_infos_[index];
+}
+
+StackMap CodeInfoCache::GetStackMapForNativePcOffset(const OatQuickMethodHeader* header,
+                                                     const CodeInfo& code_info,
+                                                     uint32_t native_pc_offset) {
+  CheckEpoch();
+  size_t index = StackMapIndexOf(header, native_pc_offset);
+  if (stack_map_headers_[index] == header && stack_map_pcs_[index] == native_pc_offset) {
+    StackMap stack_map = code_info.GetStackMapAt(stack_map_rows_[index]);
+    DCHECK_EQ(stack_map.Row(), code_info.GetStackMapForNativePcOffset(native_pc_offset).Row());
+    return stack_map;
+  }
+  StackMap stack_map = code_info.GetStackMapForNativePcOffset(native_pc_offset);
+  if (stack_map.IsValid()) {
+    stack_map_headers_[index] = nullptr;
+    stack_map_pcs_[index] = native_pc_offset;
+    stack_map_rows_[index] = stack_map.Row();
+    stack_map_headers_[index] = header;
+  }
+  return stack_map;
+}
+
+}  // namespace art
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_CODE_INFO_CACHE_H_
+#define ART_RUNTIME_CODE_INFO_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+
+#include "base/bit_utils.h"
+#include "base/macros.h"
+#include "stack_map.h"
+
+namespace art {
+
+class OatQuickMethodHeader;
+
+// Thread-local cache of the decoded code info of recently walked compiled code. Stack walks of the
+// same thread, e.g. for `Thread.getStackTrace()` at every log call, see the same compiled frames
+// over and over, and decoding the code info is most of their cost. GC root visits of deep stacks
+// likewise see the same frames at every GC, the cache also remembers the stack maps they look up.
+//
+// Entries are keyed by method header and refer to the code info data, so the caches of all threads
+// are invalidated whenever compiled code is freed, before the memory can be reused.
+class CodeInfoCache {
+ public:
+  // Direct mapped, big enough for the compiled frames of a typical deep framework stack.
+  static constexpr size_t kSize = 32u;
+  // Direct mapped, a method can have several call sites on a stack.
+  static constexpr size_t kStackMapCacheSize = 64u;
+
+  // Returns the fully decoded code info for `header`. The result is valid until the next call.
+  const CodeInfo& Get(const OatQuickMethodHeader* header);
+
+  // Returns the stack map for `native_pc_offset` of `code_info`, the decoded code info of
+  // `header`. Saves the binary search over the stack maps for call sites seen before.
+  StackMap GetStackMapForNativePcOffset(const OatQuickMethodHeader* header,
+                                        const CodeInfo& code_info,
+                                        uint32_t native_pc_offset);
+
+  // Must be called before compiled code or an oat file is freed.
+  static void InvalidateAll() {
+    epoch_.fetch_add(1u, std::memory_order_release);
+  }
+
+ private:
+  static size_t IndexOf(const OatQuickMethodHeader* header) {
+    static_assert(IsPowerOfTwo(kSize), "Size must be power of two");
+    uintptr_t address = reinterpret_cast<uintptr_t>(header);
+    return ((address >> 4) ^ (address >> 12)) & (kSize - 1u);
+  }
+
+  static size_t StackMapIndexOf(const OatQuickMethodHeader* header, uint32_t native_pc_offset) {
+    static_assert(IsPowerOfTwo(kStackMapCacheSize), "Size must be power of two");
+    uintptr_t address = reinterpret_cast<uintptr_t>(header);
+    return ((address >> 4) ^ (address >> 12) ^ (native_pc_offset >> 2)) &
+           (kStackMapCacheSize - 1u);
+  }
+
+  void CheckEpoch();
+
+  static std::atomic<uint32_t> epoch_;
+
+  uint32_t epoch_seen_ = 0u;
+  std::array<const OatQuickMethodHeader*, kSize> headers_{};
+  std::array<CodeInfo, kSize> code_infos_;
+
+  // Stack map rows by method header and native pc offset.
+  std::array<const OatQuickMethodHeader*, kStackMapCacheSize> stack_map_headers_{};
+  std::array<uint32_t, kStackMapCacheSize> stack_map_pcs_{};
+  std::array<uint32_t, kStackMapCacheSize> stack_map_rows_{};
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_CODE_INFO_CACHE_H_
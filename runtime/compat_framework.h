@@ -17,6 +17,7 @@
 #ifndef ART_RUNTIME_COMPAT_FRAMEWORK_H_
 #define ART_RUNTIME_COMPAT_FRAMEWORK_H_
 
+#include <atomic>
 #include <set>
 
 #include "base/macros.h"
@@ -44,6 +45,12 @@ class CompatFramework {
 
   void SetDisabledCompatChanges(const std::set<uint64_t>& disabled_changes) {
     disabled_compat_changes_ = disabled_changes;
+    disabled_compat_changes_epoch_.fetch_add(1u, std::memory_order_relaxed);
+  }
+
+  // Returns the number of times the disabled compat changes were set.
+  uint32_t GetDisabledCompatChangesEpoch() const {
+    return disabled_compat_changes_epoch_.load(std::memory_order_relaxed);
   }
 
   const std::set<uint64_t>& GetDisabledCompatChanges() const {
@@ -68,6 +75,7 @@ class CompatFramework {
 
   // A set of disabled compat changes for the running app, all other changes are enabled.
   std::set<uint64_t> disabled_compat_changes_;
+  std::atomic<uint32_t> disabled_compat_changes_epoch_ = 0u;
 
   // A set of reported compat changes for the running app.
   std::set<uint64_t> reported_compat_changes_ GUARDED_BY(reported_compat_changes_lock_);
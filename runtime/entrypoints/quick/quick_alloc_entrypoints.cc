@@ -138,6 +138,28 @@ GENERATE_ENTRYPOINTS_FOR_ALLOCATOR(TLAB, gc::kAllocatorTypeTLAB)
 GENERATE_ENTRYPOINTS_FOR_ALLOCATOR(Region, gc::kAllocatorTypeRegion)
 GENERATE_ENTRYPOINTS_FOR_ALLOCATOR(RegionTLAB, gc::kAllocatorTypeRegionTLAB)
 
+// The non-moving entrypoints do not depend on the current allocator and are always
+// instrumented, as they are only used by allocation sites that the JIT found long-lived.
+extern "C" mirror::Object* artAllocObjectFromCodeNonMoving(mirror::Class* klass, Thread* self)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  ScopedQuickEntrypointChecks sqec(self);
+  DCHECK(klass != nullptr);
+  gc::AllocatorType allocator_type = Runtime::Current()->GetHeap()->GetPretenureAllocator();
+  return AllocObjectFromCodeResolved</*kInstrumented=*/ true>(klass, self, allocator_type).Ptr();
+}
+
+extern "C" mirror::Array* artAllocArrayFromCodeNonMoving(
+    mirror::Class* klass, int32_t component_count, Thread* self)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  ScopedQuickEntrypointChecks sqec(self);
+  gc::AllocatorType allocator_type = Runtime::Current()->GetHeap()->GetPretenureAllocator();
+  return AllocArrayFromCodeResolved</*kInstrumented=*/ true>(
+      klass, component_count, self, allocator_type).Ptr();
+}
+
+extern "C" void* art_quick_alloc_object_non_moving(mirror::Class* klass);
+extern "C" void* art_quick_alloc_array_non_moving(mirror::Class* klass, int32_t);
+
 #define GENERATE_ENTRYPOINTS(suffix) \
 extern "C" void* art_quick_alloc_array_resolved##suffix(mirror::Class* klass, int32_t); \
 extern "C" void* art_quick_alloc_array_resolved8##suffix(mirror::Class* klass, int32_t); \
@@ -216,6 +238,8 @@ void SetQuickAllocEntryPointsInstrumented(bool instrumented) {
 
 void ResetQuickAllocEntryPoints(QuickEntryPoints* qpoints) {
 #if !defined(__APPLE__) || !defined(__LP64__)
+  qpoints->SetAllocObjectNonMoving(art_quick_alloc_object_non_moving);
+  qpoints->SetAllocArrayNonMoving(art_quick_alloc_array_non_moving);
   switch (entry_points_allocator) {
     case gc::kAllocatorTypeDlMalloc: {
       SetQuickAllocEntryPoints_dlmalloc(qpoints, entry_points_instrumented);
@@ -16,6 +16,7 @@
 
 #include "base/logging.h"  // For VLOG_IS_ON.
 #include "base/mutex.h"
+#include "base/time_utils.h"
 #include "callee_save_frame.h"
 #include "interpreter/interpreter.h"
 #include "obj_ptr-inl.h"  // TODO: Find the other include that isn't complete, and clean this up.
@@ -42,12 +43,14 @@ NO_RETURN static void artDeoptimizeImpl(Thread* self,
   }
 
   self->AssertHasDeoptimizationContext();
+  uint64_t start_ns = NanoTime();
   QuickExceptionHandler exception_handler(self, true);
   if (single_frame) {
     exception_handler.DeoptimizeSingleFrame(kind);
   } else {
     exception_handler.DeoptimizeStack(skip_method_exit_callbacks);
   }
+  Runtime::Current()->AddDeoptimizationTime(kind, NanoTime() - start_ns);
   if (exception_handler.IsFullFragmentDone()) {
     exception_handler.DoLongJump(true);
   } else {
@@ -34,6 +34,9 @@
   V(AllocStringFromBytes, void*, void*, int32_t, int32_t, int32_t) \
   V(AllocStringFromChars, void*, int32_t, int32_t, void*) \
   V(AllocStringFromString, void*, void*) \
+  /* Allocate in the non-moving space, for allocation sites that the JIT found long-lived. */ \
+  V(AllocObjectNonMoving, void*, mirror::Class*) \
+  V(AllocArrayNonMoving, void*, mirror::Class*, int32_t) \
 \
   V(InstanceofNonTrivial, size_t, mirror::Object*, mirror::Class*) \
   V(CheckInstanceOf, void, mirror::Object*, mirror::Class*) \
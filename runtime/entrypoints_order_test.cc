@@ -61,6 +61,9 @@ namespace art {
 
 class EntrypointsOrderTest : public CommonArtTest {
  protected:
+  static constexpr size_t kHotFieldsCacheLineSize = 64u;
+  static constexpr size_t kNumHotCacheLines = 4u;
+
   void CheckThreadOffsets() {
     CHECKED(OFFSETOF_MEMBER(Thread, tls32_.state_and_flags) == 0, thread_flags_at_zero);
     EXPECT_OFFSET_DIFFP(Thread, tls32_, state_and_flags, suspend_count, 4);
@@ -71,15 +74,16 @@ class EntrypointsOrderTest : public CommonArtTest {
     EXPECT_OFFSET_DIFFP(Thread, tls32_, throwing_OutOfMemoryError, no_thread_suspension, 4);
     EXPECT_OFFSET_DIFFP(Thread, tls32_, no_thread_suspension, thread_exit_check_count, 4);
     EXPECT_OFFSET_DIFFP(Thread, tls32_, thread_exit_check_count, is_transitioning_to_runnable, 4);
+    EXPECT_OFFSET_DIFFP(Thread, tls32_, is_transitioning_to_runnable, is_gc_marking, 4);
+    EXPECT_OFFSET_DIFFP(Thread, tls32_, is_gc_marking, is_deopt_check_required, 4);
+    EXPECT_OFFSET_DIFFP(Thread, tls32_, is_deopt_check_required, shared_method_hotness, 4);
+    CHECKED(OFFSETOF_MEMBER(Thread, tls32_.shared_method_hotness) + 4 <= kHotFieldsCacheLineSize,
+            thread_tls32_hot_fields_in_first_cache_line);
 
-    // TODO: Better connection. Take alignment into account.
-    EXPECT_OFFSET_DIFF_GT3(Thread, tls32_.thread_exit_check_count, tls64_.trace_clock_base, 4,
-                           thread_tls32_to_tls64);
-
-    EXPECT_OFFSET_DIFFP(Thread, tls64_, trace_clock_base, stats, 8);
-
-    // TODO: Better connection. Take alignment into account.
-    EXPECT_OFFSET_DIFF_GT3(Thread, tls64_.stats, tlsPtr_.card_table, 8, thread_tls64_to_tlsptr);
+    // `tlsPtr_` directly follows `tls32_` so that its offset does not depend on the pointer size.
+    CHECKED(OFFSETOF_MEMBER(Thread, tlsPtr_) == sizeof(Thread::tls_32bit_sized_values),
+            thread_tls32_to_tlsptr);
+    CHECKED(sizeof(Thread::tls_32bit_sized_values) % 8 == 0, thread_tls32_size);
 
     EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, card_table, exception, sizeof(void*));
     EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, exception, stack_end, sizeof(void*));
@@ -88,7 +92,25 @@ class EntrypointsOrderTest : public CommonArtTest {
     EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, suspend_trigger, jni_env, sizeof(void*));
     EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, jni_env, tmp_jni_env, sizeof(void*));
     EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, tmp_jni_env, self, sizeof(void*));
-    EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, self, opeer, sizeof(void*));
+    EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, self, thread_local_pos, sizeof(void*));
+    EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, thread_local_pos, thread_local_end, sizeof(void*));
+    EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, thread_local_end, thread_local_start, sizeof(void*));
+    EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, thread_local_start, thread_local_limit, sizeof(void*));
+    EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, thread_local_limit, thread_local_objects, sizeof(void*));
+    EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, thread_local_objects, thread_local_alloc_stack_top,
+                        sizeof(size_t));
+    EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, thread_local_alloc_stack_top, thread_local_alloc_stack_end,
+                        sizeof(void*));
+    EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, thread_local_alloc_stack_end, mutator_lock, sizeof(void*));
+    EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, mutator_lock, thread_local_mark_stack, sizeof(void*));
+    EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, thread_local_mark_stack, opeer, sizeof(void*));
+    // The fields used on the allocation, suspend check and read barrier fast paths must stay
+    // within the first few cache lines of the `Thread`.
+    CHECKED(OFFSETOF_MEMBER(Thread, tlsPtr_.thread_local_mark_stack) + sizeof(void*) <=
+                kNumHotCacheLines * kHotFieldsCacheLineSize,
+            thread_tlsptr_hot_fields_in_first_cache_lines);
+    CHECKED(OFFSETOF_MEMBER(Thread, tlsPtr_.thread_local_pos) % 8 == 0,
+            thread_local_pos_8_byte_aligned);
     EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, opeer, jpeer, sizeof(void*));
     EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, jpeer, stack_begin, sizeof(void*));
     EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, stack_begin, stack_size, sizeof(void*));
@@ -110,39 +132,42 @@ class EntrypointsOrderTest : public CommonArtTest {
                         sizeof(void*));
     EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, last_no_thread_suspension_cause, active_suspend_barriers,
                         sizeof(void*));
-    EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, active_suspend_barriers, thread_local_start,
+    EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, active_suspend_barriers, checkpoint_function,
                         sizeof(Thread::tls_ptr_sized_values::active_suspend_barriers));
-    EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, thread_local_start, thread_local_pos, sizeof(void*));
-    EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, thread_local_pos, thread_local_end, sizeof(void*));
-    EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, thread_local_end, thread_local_limit, sizeof(void*));
-    EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, thread_local_limit, thread_local_objects, sizeof(void*));
-    EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, thread_local_objects, checkpoint_function, sizeof(size_t));
     EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, checkpoint_function, jni_entrypoints,
                         sizeof(void*));
 
     // Skip across the entrypoints structures.
-    EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, rosalloc_runs, thread_local_alloc_stack_top,
+    EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, rosalloc_runs, held_mutexes,
                         sizeof(void*) * kNumRosAllocThreadLocalSizeBracketsInThread);
-    EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, thread_local_alloc_stack_top, thread_local_alloc_stack_end,
-                        sizeof(void*));
-    EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, thread_local_alloc_stack_end, mutator_lock, sizeof(void*));
-    EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, mutator_lock, held_mutexes, sizeof(void*));
     EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, held_mutexes, flip_function,
                         sizeof(void*) * kLockLevelCount);
-    EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, flip_function, thread_local_mark_stack, sizeof(void*));
-    EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, thread_local_mark_stack, async_exception, sizeof(void*));
+    EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, flip_function, async_exception, sizeof(void*));
     EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, async_exception, top_reflective_handle_scope,
                         sizeof(void*));
     EXPECT_OFFSET_DIFFP(
         Thread, tlsPtr_, top_reflective_handle_scope, method_trace_buffer, sizeof(void*));
     EXPECT_OFFSET_DIFFP(
         Thread, tlsPtr_, method_trace_buffer, method_trace_buffer_index, sizeof(void*));
+    EXPECT_OFFSET_DIFFP(
+        Thread, tlsPtr_, method_trace_buffer_index, adaptive_tlab_size, sizeof(size_t));
+    EXPECT_OFFSET_DIFFP(
+        Thread, tlsPtr_, adaptive_tlab_size, tlab_refill_bytes, sizeof(size_t));
+    EXPECT_OFFSET_DIFFP(
+        Thread, tlsPtr_, tlab_refill_bytes, tlab_refill_gc_num, sizeof(size_t));
+    EXPECT_OFFSET_DIFFP(
+        Thread, tlsPtr_, tlab_refill_gc_num, allocation_samples, sizeof(size_t));
     // The first field after tlsPtr_ is forced to a 16 byte alignment so it might have some space.
     auto offset_tlsptr_end = OFFSETOF_MEMBER(Thread, tlsPtr_) +
         sizeof(decltype(reinterpret_cast<Thread*>(16)->tlsPtr_));
-    CHECKED(offset_tlsptr_end - OFFSETOF_MEMBER(Thread, tlsPtr_.method_trace_buffer_index) ==
+    CHECKED(offset_tlsptr_end - OFFSETOF_MEMBER(Thread, tlsPtr_.allocation_samples) ==
                 sizeof(void*),
             "async_exception last field");
+
+    // The cold 64-bit fields follow `tlsPtr_`.
+    EXPECT_OFFSET_DIFF_GT3(Thread, tlsPtr_.allocation_samples, tls64_.trace_clock_base,
+                           sizeof(void*), thread_tlsptr_to_tls64);
+    EXPECT_OFFSET_DIFFP(Thread, tls64_, trace_clock_base, stats, 8);
   }
 
   void CheckJniEntryPoints() {
@@ -181,7 +206,11 @@ class EntrypointsOrderTest : public CommonArtTest {
                          sizeof(void*));
     EXPECT_OFFSET_DIFFNP(QuickEntryPoints, pAllocStringFromChars, pAllocStringFromString,
                          sizeof(void*));
-    EXPECT_OFFSET_DIFFNP(QuickEntryPoints, pAllocStringFromString, pInstanceofNonTrivial,
+    EXPECT_OFFSET_DIFFNP(QuickEntryPoints, pAllocStringFromString, pAllocObjectNonMoving,
+                         sizeof(void*));
+    EXPECT_OFFSET_DIFFNP(QuickEntryPoints, pAllocObjectNonMoving, pAllocArrayNonMoving,
+                         sizeof(void*));
+    EXPECT_OFFSET_DIFFNP(QuickEntryPoints, pAllocArrayNonMoving, pInstanceofNonTrivial,
                          sizeof(void*));
     EXPECT_OFFSET_DIFFNP(QuickEntryPoints, pInstanceofNonTrivial, pCheckInstanceOf, sizeof(void*));
     EXPECT_OFFSET_DIFFNP(QuickEntryPoints, pCheckInstanceOf, pInitializeStaticStorage,
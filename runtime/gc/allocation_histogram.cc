@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "allocation_histogram.h"
+
+#include <algorithm>
+#include <ostream>
+#include <vector>
+
+#include "base/bit_utils.h"
+#include "base/utils.h"
+#include "mirror/class-inl.h"
+#include "obj_ptr-inl.h"
+#include "runtime.h"
+#include "thread.h"
+
+namespace art {
+namespace gc {
+
+AllocationHistogram::AllocationHistogram()
+    : lock_("allocation histogram lock", kGenericBottomLock) {}
+
+size_t AllocationHistogram::SizeClassOf(size_t byte_count) {
+  if (byte_count <= 16u) {
+    return 0u;
+  }
+  return std::min(MinimumBitsToStore(byte_count - 1u) - 4u, kNumSizeClasses - 1u);
+}
+
+void AllocationHistogram::RecordSample(Thread* self,
+                                       ObjPtr<mirror::Class> klass,
+                                       size_t byte_count,
+                                       size_t weight,
+                                       uint32_t gc_num) {
+  ThreadAllocationSamples* thread_samples = self->GetAllocationSamples();
+  if (UNLIKELY(thread_samples == nullptr)) {
+    thread_samples = new ThreadAllocationSamples();
+    thread_samples->gc_num = gc_num;
+    self->SetAllocationSamples(thread_samples);
+  } else if (thread_samples->gc_num != gc_num ||
+             thread_samples->num_samples == kThreadAllocationSamples) {
+    Merge(thread_samples);
+    thread_samples->gc_num = gc_num;
+  }
+  AllocationSample& sample = thread_samples->samples[thread_samples->num_samples++];
+  std::string temp;
+  sample.descriptor = klass->GetDescriptor(&temp);
+  sample.bytes = weight;
+  sample.size_class = SizeClassOf(byte_count);
+}
+
+void AllocationHistogram::FlushThread(Thread* thread) {
+  ThreadAllocationSamples* thread_samples = thread->GetAllocationSamples();
+  if (thread_samples != nullptr) {
+    Merge(thread_samples);
+  }
+}
+
+void AllocationHistogram::Merge(ThreadAllocationSamples* thread_samples) {
+  metrics::ArtMetrics* metrics = GetMetrics();
+  MutexLock mu(Thread::Current(), lock_);
+  for (size_t i = 0; i < thread_samples->num_samples; ++i) {
+    const AllocationSample& sample = thread_samples->samples[i];
+    Stats& size_class = size_classes_[sample.size_class];
+    ++size_class.samples;
+    size_class.bytes += sample.bytes;
+    auto it = classes_.find(sample.descriptor);
+    if (it == classes_.end()) {
+      it = classes_.size() < kMaxClasses
+          ? classes_.emplace(sample.descriptor, Stats()).first
+          : classes_.emplace(kOtherClasses, Stats()).first;
+    }
+    ++it->second.samples;
+    it->second.bytes += sample.bytes;
+    metrics->AllocationSizeClass()->Add(sample.size_class);
+  }
+  thread_samples->num_samples = 0;
+}
+
+void AllocationHistogram::Dump(std::ostream& os, size_t max_classes) {
+  MutexLock mu(Thread::Current(), lock_);
+  os << "Sampled allocations by size class:\n";
+  for (size_t i = 0; i < kNumSizeClasses; ++i) {
+    const Stats& stats = size_classes_[i];
+    if (stats.samples == 0) {
+      continue;
+    }
+    os << "  " << (i + 1 == kNumSizeClasses ? ">" : "<=")
+       << PrettySize(i + 1 == kNumSizeClasses ? 16u << (i - 1) : 16u << i)
+       << ": samples=" << stats.samples << " bytes=" << PrettySize(stats.bytes) << "\n";
+  }
+  std::vector<std::pair<std::string, Stats>> classes(classes_.begin(), classes_.end());
+  std::sort(classes.begin(), classes.end(), [](const auto& a, const auto& b) {
+    return a.second.bytes > b.second.bytes;
+  });
+  os << "Sampled allocations by class:\n";
+  for (size_t i = 0; i < std::min(max_classes, classes.size()); ++i) {
+    os << "  " << classes[i].first << ": samples=" << classes[i].second.samples
+       << " bytes=" << PrettySize(classes[i].second.bytes) << "\n";
+  }
+}
+
+}  // namespace gc
+}  // namespace art
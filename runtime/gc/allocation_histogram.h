@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_GC_ALLOCATION_HISTOGRAM_H_
+#define ART_RUNTIME_GC_ALLOCATION_HISTOGRAM_H_
+
+#include <array>
+#include <iosfwd>
+#include <map>
+#include <string>
+
+#include "base/locks.h"
+#include "base/mutex.h"
+#include "obj_ptr.h"
+
+namespace art {
+
+class Thread;
+
+namespace mirror {
+class Class;
+}  // namespace mirror
+
+namespace gc {
+
+// Number of samples buffered by a thread before they are merged into the AllocationHistogram.
+static constexpr size_t kThreadAllocationSamples = 64;
+
+struct AllocationSample {
+  std::string descriptor;
+  uint64_t bytes;
+  uint8_t size_class;
+};
+
+// The samples buffered by a thread, reachable from Thread::GetAllocationSamples().
+struct ThreadAllocationSamples {
+  uint32_t gc_num = 0;
+  size_t num_samples = 0;
+  std::array<AllocationSample, kThreadAllocationSamples> samples;
+};
+
+// An always-on, sampled histogram of the Java allocations by size class and by class.
+//
+// An allocation is sampled only where it leaves the fast path anyway: when it takes a new TLAB
+// or thread-local run, and when it is allocated outside of thread-local buffers. Each sample is
+// weighted by the bytes handed out with it, so that the per-class bytes estimate the bytes
+// allocated. Samples are buffered per thread and merged into the histogram when the buffer is
+// full, on the thread's first sample after a GC, and when it exits.
+class AllocationHistogram {
+ public:
+  // Size class `i` covers the sizes in (16 << (i - 1), 16 << i], the last one is open-ended.
+  static constexpr size_t kNumSizeClasses = 12;
+  // Beyond this number of classes, samples are accounted to kOtherClasses.
+  static constexpr size_t kMaxClasses = 1024;
+  static constexpr const char* kOtherClasses = "<other>";
+
+  AllocationHistogram();
+
+  static size_t SizeClassOf(size_t byte_count);
+
+  // Record an allocation of `byte_count` bytes of `klass`, which stands for `weight` bytes.
+  void RecordSample(Thread* self,
+                    ObjPtr<mirror::Class> klass,
+                    size_t byte_count,
+                    size_t weight,
+                    uint32_t gc_num)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!lock_);
+
+  // Merge the samples buffered by `thread`, which is the current thread or is suspended.
+  void FlushThread(Thread* thread) REQUIRES(!lock_);
+
+  // Dump the size-class table and the classes with the most sampled bytes.
+  void Dump(std::ostream& os, size_t max_classes = 20) REQUIRES(!lock_);
+
+ private:
+  struct Stats {
+    uint64_t samples = 0;
+    uint64_t bytes = 0;
+  };
+
+  void Merge(ThreadAllocationSamples* thread_samples) REQUIRES(!lock_);
+
+  Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  std::array<Stats, kNumSizeClasses> size_classes_ GUARDED_BY(lock_);
+  std::map<std::string, Stats> classes_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(AllocationHistogram);
+};
+
+}  // namespace gc
+}  // namespace art
+
+#endif  // ART_RUNTIME_GC_ALLOCATION_HISTOGRAM_H_
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "allocation_site_sampler.h"
+
+#include <vector>
+
+#include "art_method-inl.h"
+#include "gc_root-inl.h"
+#include "jit/jit.h"
+#include "jit/jit_code_cache.h"
+#include "object_callbacks.h"
+#include "runtime.h"
+#include "thread.h"
+
+namespace art {
+namespace gc {
+
+AllocationSiteSampler::AllocationSiteSampler()
+    : enabled_(false),
+      candidates_(0u),
+      lock_("allocation site sampler lock", kGenericBottomLock),
+      num_samples_(0u),
+      num_samples_before_gc_(0u) {}
+
+void AllocationSiteSampler::MaybeRecordSample(Thread* self, ObjPtr<mirror::Object> obj) {
+  if (candidates_.fetch_add(1u, std::memory_order_relaxed) % kSampleInterval != 0u) {
+    return;
+  }
+  uint32_t dex_pc;
+  ArtMethod* method =
+      self->GetCurrentMethod(&dex_pc, /*check_suspended=*/ false, /*abort_on_error=*/ false);
+  if (method == nullptr || method->IsNative()) {
+    return;
+  }
+  MutexLock mu(self, lock_);
+  if (num_samples_ == kMaxSamples) {
+    return;
+  }
+  samples_[num_samples_++] = {GcRoot<mirror::Object>(obj), method, dex_pc};
+}
+
+void AllocationSiteSampler::StartGc() {
+  MutexLock mu(Thread::Current(), lock_);
+  num_samples_before_gc_ = num_samples_;
+}
+
+void AllocationSiteSampler::Sweep(IsMarkedVisitor* visitor) {
+  Thread* self = Thread::Current();
+  std::vector<Outcome> outcomes;
+  {
+    MutexLock mu(self, lock_);
+    if (num_samples_ == 0u) {
+      return;
+    }
+    outcomes.reserve(num_samples_before_gc_);
+    size_t kept = 0u;
+    for (size_t i = 0; i != num_samples_; ++i) {
+      Sample& sample = samples_[i];
+      mirror::Object* obj = sample.object.Read<kWithoutReadBarrier>();
+      mirror::Object* new_obj = visitor->IsMarked(obj);
+      if (i < num_samples_before_gc_) {
+        outcomes.push_back({sample.method, sample.dex_pc, new_obj != nullptr});
+      } else if (new_obj != nullptr) {
+        samples_[kept++] = {GcRoot<mirror::Object>(new_obj), sample.method, sample.dex_pc};
+      }
+    }
+    num_samples_ = kept;
+    num_samples_before_gc_ = 0u;
+  }
+
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit == nullptr || outcomes.empty()) {
+    return;
+  }
+  // The methods are only used as keys into the JIT code cache, which has dropped the
+  // ProfilingInfo of the methods that were unloaded since the sample was taken.
+  MutexLock mu(self, *Locks::jit_lock_);
+  for (const Outcome& outcome : outcomes) {
+    jit->GetCodeCache()->AddAllocationSample(outcome.method, outcome.dex_pc, outcome.survived);
+  }
+}
+
+}  // namespace gc
+}  // namespace art
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_GC_ALLOCATION_SITE_SAMPLER_H_
+#define ART_RUNTIME_GC_ALLOCATION_SITE_SAMPLER_H_
+
+#include <array>
+#include <atomic>
+
+#include "base/atomic.h"
+#include "base/locks.h"
+#include "base/mutex.h"
+#include "gc_root.h"
+#include "obj_ptr.h"
+
+namespace art {
+
+class ArtMethod;
+class IsMarkedVisitor;
+class Thread;
+
+namespace mirror {
+class Object;
+}  // namespace mirror
+
+namespace gc {
+
+// Samples the allocation sites of Java objects and tells the JIT whether the sampled objects
+// survived their first GC, see ProfilingInfo::AddAllocationSample(). The JIT allocates the
+// objects of the sites whose samples mostly survive in the non-moving space, so that young
+// collections do not copy them again and again.
+//
+// Like the AllocationHistogram, only the allocations that take a new TLAB or are made outside
+// of one are candidates, and only one in kSampleInterval of them is sampled, as finding the
+// site walks the stack. The sampled objects are weak roots, checked by the GC that follows.
+class AllocationSiteSampler {
+ public:
+  static constexpr uint32_t kSampleInterval = 8u;
+  // Samples taken when the buffer is full are dropped until the next GC.
+  static constexpr size_t kMaxSamples = 256u;
+
+  AllocationSiteSampler();
+
+  void SetEnabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+  }
+
+  bool IsEnabled() const {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  // Called with `obj`, just allocated by `self`, when it took a new thread-local buffer or
+  // was allocated outside of one.
+  void MaybeRecordSample(Thread* self, ObjPtr<mirror::Object> obj)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!lock_);
+
+  // Called before a GC runs. Only the samples taken so far are checked by its Sweep(), the
+  // objects allocated during the GC survive it whatever their lifetime.
+  void StartGc() REQUIRES(!lock_);
+
+  // Update the sampled objects and report the survival of the ones taken before StartGc().
+  void Sweep(IsMarkedVisitor* visitor)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!lock_, !Locks::jit_lock_);
+
+ private:
+  struct Sample {
+    GcRoot<mirror::Object> object;
+    ArtMethod* method;
+    uint32_t dex_pc;
+  };
+
+  struct Outcome {
+    ArtMethod* method;
+    uint32_t dex_pc;
+    bool survived;
+  };
+
+  std::atomic<bool> enabled_;
+  Atomic<uint32_t> candidates_;
+
+  Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  std::array<Sample, kMaxSamples> samples_ GUARDED_BY(lock_);
+  size_t num_samples_ GUARDED_BY(lock_);
+  // The number of samples taken before the GC started, see StartGc().
+  size_t num_samples_before_gc_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(AllocationSiteSampler);
+};
+
+}  // namespace gc
+}  // namespace art
+
+#endif  // ART_RUNTIME_GC_ALLOCATION_SITE_SAMPLER_H_
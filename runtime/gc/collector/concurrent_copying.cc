@@ -45,6 +45,7 @@
 #include "scoped_thread_state_change-inl.h"
 #include "thread-inl.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 #include "well_known_classes.h"
 
 namespace art {
@@ -229,6 +230,14 @@ void ConcurrentCopying::RunPhases() {
   Thread* self = Thread::Current();
   thread_running_gc_ = self;
   Locks::mutator_lock_->AssertNotHeld(self);
+  // The heap thread-pool is used for visiting the roots of the suspended threads in the flip.
+  // Its workers must be created outside of the pause.
+  if (heap_->GetThreadPool() == nullptr &&
+      heap_->GetParallelGCThreadCount() > 0 &&
+      !Runtime::Current()->IsZygote()) {
+    heap_->CreateThreadPool(heap_->GetParallelGCThreadCount());
+    heap_->GetThreadPool()->WaitForWorkersToBeCreated();
+  }
   {
     ReaderMutexLock mu(self, *Locks::mutator_lock_);
     InitializePhase();
@@ -760,6 +769,7 @@ void ConcurrentCopying::VerifyNoMissingCardMarks() {
 // Switch threads that from from-space to to-space refs. Forward/mark the thread roots.
 void ConcurrentCopying::FlipThreadRoots() {
   TimingLogger::ScopedTiming split("FlipThreadRoots", GetTimings());
+  ScopedPhaseTiming phase_timing(GcPhase::kRootVisiting, this);
   if (kVerboseMode || heap_->dump_region_info_before_gc_) {
     LOG(INFO) << "time=" << region_space_->Time();
     region_space_->DumpNonFreeRegions(LOG_STREAM(INFO));
@@ -771,7 +781,8 @@ void ConcurrentCopying::FlipThreadRoots() {
   FlipCallback flip_callback(this);
 
   size_t barrier_count = Runtime::Current()->GetThreadList()->FlipThreadRoots(
-      &thread_flip_visitor, &flip_callback, this, GetHeap()->GetGcPauseListener());
+      &thread_flip_visitor, &flip_callback, this, GetHeap()->GetGcPauseListener(),
+      heap_->GetThreadPool());
 
   {
     ScopedThreadStateChange tsc(self, ThreadState::kWaitingForCheckPointsToRun);
@@ -1380,6 +1391,7 @@ class ConcurrentCopying::ImmuneSpaceCaptureRefsVisitor {
 
 void ConcurrentCopying::MarkingPhase() {
   TimingLogger::ScopedTiming split("MarkingPhase", GetTimings());
+  ScopedPhaseTiming phase_timing(GcPhase::kMarking, this);
   if (kVerboseMode) {
     LOG(INFO) << "GC MarkingPhase";
   }
@@ -1453,6 +1465,7 @@ void ConcurrentCopying::ScanDirtyObject(mirror::Object* obj) {
 // Concurrently mark roots that are guarded by read barriers and process the mark stack.
 void ConcurrentCopying::CopyingPhase() {
   TimingLogger::ScopedTiming split("CopyingPhase", GetTimings());
+  ScopedPhaseTiming phase_timing(GcPhase::kCompaction, this);
   if (kVerboseMode) {
     LOG(INFO) << "GC CopyingPhase";
   }
@@ -2719,6 +2732,7 @@ void ConcurrentCopying::CaptureRssAtPeak() {
 
 void ConcurrentCopying::ReclaimPhase() {
   TimingLogger::ScopedTiming split("ReclaimPhase", GetTimings());
+  ScopedPhaseTiming phase_timing(GcPhase::kReclaim, this);
   if (kVerboseMode) {
     LOG(INFO) << "GC ReclaimPhase";
   }
@@ -2776,6 +2790,7 @@ void ConcurrentCopying::ReclaimPhase() {
     const uint64_t unevac_from_bytes = region_space_->GetBytesAllocatedInUnevacFromSpace();
     uint64_t to_bytes = bytes_moved_.load(std::memory_order_relaxed) + bytes_moved_gc_thread_;
     cumulative_bytes_moved_ += to_bytes;
+    GetCurrentIteration()->SetMovedBytes(to_bytes);
     uint64_t to_objects = objects_moved_.load(std::memory_order_relaxed) + objects_moved_gc_thread_;
     if (kEnableFromSpaceAccountingCheck) {
       CHECK_EQ(from_space_num_bytes_at_first_pause_, from_bytes + unevac_from_bytes);
@@ -3860,6 +3875,7 @@ void ConcurrentCopying::DelayReferenceReferent(ObjPtr<mirror::Class> klass,
 }
 
 void ConcurrentCopying::ProcessReferences(Thread* self) {
+  ScopedPhaseTiming phase_timing(GcPhase::kReferenceProcessing, this);
   // We don't really need to lock the heap bitmap lock as we use CAS to mark in bitmaps.
   WriterMutexLock mu(self, *Locks::heap_bitmap_lock_);
   GetHeap()->GetReferenceProcessor()->ProcessReferences(self, GetTimings());
@@ -51,7 +51,10 @@ void Iteration::Reset(GcCause gc_cause, bool clear_soft_references) {
   timings_.Reset();
   pause_times_.clear();
   duration_ns_ = 0;
+  thread_cpu_time_ns_ = 0;
   bytes_scanned_ = 0;
+  bytes_moved_ = 0;
+  phase_times_ns_.fill(0);
   clear_soft_references_ = clear_soft_references;
   gc_cause_ = gc_cause;
   freed_ = ObjectBytePair();
@@ -189,6 +192,7 @@ void GarbageCollector::Run(GcCause gc_cause, bool clear_soft_references) {
   total_thread_cpu_time_ns_ += thread_cpu_end_time - thread_cpu_start_time;
   uint64_t duration_ns = end_time - start_time;
   current_iteration->SetDurationNs(duration_ns);
+  current_iteration->SetThreadCpuTimeNs(thread_cpu_end_time - thread_cpu_start_time);
   if (Locks::mutator_lock_->IsExclusiveHeld(self)) {
     // The entire GC was paused, clear the fake pauses which might be in the pause times and add
     // the whole GC duration.
@@ -213,6 +217,7 @@ void GarbageCollector::Run(GcCause gc_cause, bool clear_soft_references) {
   // Report total collection time of all GCs put together.
   metrics->TotalGcCollectionTime()->Add(NsToMs(duration_ns));
   metrics->TotalGcCollectionTimeDelta()->Add(NsToMs(duration_ns));
+  ReportPhaseMetrics(current_iteration, metrics);
   if (are_metrics_initialized_) {
     metrics_gc_count_->Add(1);
     metrics_gc_count_delta_->Add(1);
@@ -241,6 +246,47 @@ void GarbageCollector::Run(GcCause gc_cause, bool clear_soft_references) {
   is_transaction_active_ = false;
 }
 
+void GarbageCollector::ReportPhaseMetrics(const Iteration* iteration,
+                                          metrics::ArtMetrics* metrics) {
+  // Report the per-phase times in microseconds.
+  const uint64_t marking_time_us = NsToUs(iteration->GetPhaseTimeNs(GcPhase::kMarking));
+  const uint64_t reclaim_time_us = NsToUs(iteration->GetPhaseTimeNs(GcPhase::kReclaim));
+  const uint64_t compaction_time_us = NsToUs(iteration->GetPhaseTimeNs(GcPhase::kCompaction));
+  const uint64_t reference_processing_time_us =
+      NsToUs(iteration->GetPhaseTimeNs(GcPhase::kReferenceProcessing));
+  const uint64_t root_visiting_time_us =
+      NsToUs(iteration->GetPhaseTimeNs(GcPhase::kRootVisiting));
+  const uint64_t thread_cpu_time_us = NsToUs(iteration->GetThreadCpuTimeNs());
+  metrics->GcMarkingTime()->Add(marking_time_us);
+  metrics->GcReclaimTime()->Add(reclaim_time_us);
+  metrics->GcCompactionTime()->Add(compaction_time_us);
+  metrics->GcReferenceProcessingTime()->Add(reference_processing_time_us);
+  metrics->GcRootVisitingTime()->Add(root_visiting_time_us);
+  metrics->GcThreadCpuTime()->Add(thread_cpu_time_us);
+  metrics->GcMovedBytes()->Add(iteration->GetMovedBytes());
+  // Emit the same breakdown as counter tracks so that it shows up next to the
+  // GC slices in perfetto traces.
+  if (UNLIKELY(ATraceEnabled())) {
+    auto trace_value = [](const char* name, uint64_t value) {
+      ATraceIntegerValue(name, static_cast<int32_t>(std::min<uint64_t>(value, INT32_MAX)));
+    };
+    trace_value("GC marking time (us)", marking_time_us);
+    trace_value("GC reclaim time (us)", reclaim_time_us);
+    trace_value("GC compaction time (us)", compaction_time_us);
+    trace_value("GC reference processing time (us)", reference_processing_time_us);
+    trace_value("GC root visiting time (us)", root_visiting_time_us);
+    trace_value("GC thread CPU time (us)", thread_cpu_time_us);
+    trace_value("GC moved bytes (KB)", iteration->GetMovedBytes() / KB);
+  }
+}
+
+GarbageCollector::ScopedPhaseTiming::ScopedPhaseTiming(GcPhase phase, GarbageCollector* collector)
+    : phase_(phase), iteration_(collector->GetCurrentIteration()), start_time_ns_(NanoTime()) {}
+
+GarbageCollector::ScopedPhaseTiming::~ScopedPhaseTiming() {
+  iteration_->AddPhaseTimeNs(phase_, NanoTime() - start_time_ns_);
+}
+
 void GarbageCollector::SwapBitmaps() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
   // Swap the live and mark bitmaps for each alloc space. This is needed since sweep re-swaps
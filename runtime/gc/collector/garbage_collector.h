@@ -60,6 +60,20 @@ class GarbageCollector : public RootVisitor, public IsMarkedVisitor, public Mark
     bool with_reporting_;
   };
 
+  // Adds the wall time spent in the scope to the given phase of the current iteration.
+  class ScopedPhaseTiming {
+   public:
+    ScopedPhaseTiming(GcPhase phase, GarbageCollector* collector);
+    ~ScopedPhaseTiming();
+
+   private:
+    const GcPhase phase_;
+    Iteration* const iteration_;
+    const uint64_t start_time_ns_;
+
+    DISALLOW_COPY_AND_ASSIGN(ScopedPhaseTiming);
+  };
+
   GarbageCollector(Heap* heap, const std::string& name);
   virtual ~GarbageCollector() { }
   const char* GetName() const {
@@ -150,6 +164,8 @@ class GarbageCollector : public RootVisitor, public IsMarkedVisitor, public Mark
   virtual void RunPhases() = 0;
   // Revoke all the thread-local buffers.
   virtual void RevokeAllThreadLocalBuffers() = 0;
+  // Report the per-phase breakdown of the iteration to ART metrics and systrace.
+  static void ReportPhaseMetrics(const Iteration* iteration, metrics::ArtMetrics* metrics);
 
   static constexpr size_t kPauseBucketSize = 500;
   static constexpr size_t kPauseBucketCount = 32;
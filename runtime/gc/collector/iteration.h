@@ -18,6 +18,7 @@
 #define ART_RUNTIME_GC_COLLECTOR_ITERATION_H_
 
 #include <inttypes.h>
+#include <array>
 #include <vector>
 
 #include "android-base/macros.h"
@@ -29,6 +30,18 @@ namespace art {
 namespace gc {
 namespace collector {
 
+// The phases of a GC iteration whose duration is recorded separately. Reference
+// processing and root visiting are also included in the enclosing phase.
+enum class GcPhase : uint8_t {
+  kMarking,              // Tracing the heap, concurrently and in pauses.
+  kReclaim,              // Sweeping and freeing the unmarked memory.
+  kCompaction,           // Copying or compacting the moving space.
+  kReferenceProcessing,  // Processing soft/weak/finalizer/phantom references.
+  kRootVisiting,         // Visiting the runtime and thread roots.
+  kLast = kRootVisiting,
+};
+static constexpr size_t kGcPhaseCount = static_cast<size_t>(GcPhase::kLast) + 1;
+
 // A information related single garbage collector iteration. Since we only ever have one GC running
 // at any given time, we can have a single iteration info.
 class Iteration {
@@ -60,6 +73,24 @@ class Iteration {
   uint64_t GetFreedRevokeBytes() const {
     return freed_bytes_revoke_;
   }
+  // Returns the wall time spent in `phase` in nanoseconds.
+  uint64_t GetPhaseTimeNs(GcPhase phase) const {
+    return phase_times_ns_[static_cast<size_t>(phase)];
+  }
+  void AddPhaseTimeNs(GcPhase phase, uint64_t time_ns) {
+    phase_times_ns_[static_cast<size_t>(phase)] += time_ns;
+  }
+  // Returns the CPU time consumed by the thread running the GC in nanoseconds.
+  uint64_t GetThreadCpuTimeNs() const {
+    return thread_cpu_time_ns_;
+  }
+  // Returns the number of bytes copied or compacted by moving collectors.
+  uint64_t GetMovedBytes() const {
+    return bytes_moved_;
+  }
+  void SetMovedBytes(uint64_t bytes) {
+    bytes_moved_ = bytes;
+  }
   uint64_t GetScannedBytes() const {
     return bytes_scanned_;
   }
@@ -86,11 +117,17 @@ class Iteration {
   void SetDurationNs(uint64_t duration) {
     duration_ns_ = duration;
   }
+  void SetThreadCpuTimeNs(uint64_t time) {
+    thread_cpu_time_ns_ = time;
+  }
 
   GcCause gc_cause_;
   bool clear_soft_references_;
   uint64_t duration_ns_;
+  uint64_t thread_cpu_time_ns_;
   uint64_t bytes_scanned_;
+  uint64_t bytes_moved_;
+  std::array<uint64_t, kGcPhaseCount> phase_times_ns_;
   TimingLogger timings_;
   ObjectBytePair freed_;
   ObjectBytePair freed_los_;
@@ -65,7 +65,7 @@ inline void MarkCompact::UpdateClassAfterObjectMap(mirror::Object* obj) {
   }
 }
 
-template <size_t kAlignment>
+template <size_t kAlignment> template <bool kParallel>
 inline uintptr_t MarkCompact::LiveWordsBitmap<kAlignment>::SetLiveWords(uintptr_t begin,
                                                                         size_t size) {
   const uintptr_t begin_bit_idx = MemRangeBitmap::BitIndexFromAddr(begin);
@@ -80,7 +80,12 @@ inline uintptr_t MarkCompact::LiveWordsBitmap<kAlignment>::SetLiveWords(uintptr_
   // Bits that needs to be set in the first word, if it's not also the last word
   mask = ~(mask - 1);
   if (diff > 0) {
-    *begin_bm_address |= mask;
+    if (kParallel) {
+      reinterpret_cast<Atomic<uintptr_t>*>(begin_bm_address)->fetch_or(mask,
+                                                                       std::memory_order_relaxed);
+    } else {
+      *begin_bm_address |= mask;
+    }
     mask = ~0;
     // Even though memset can handle the (diff == 1) case but we should avoid the
     // overhead of a function call for this, highly likely (as most of the objects
@@ -91,7 +96,13 @@ inline uintptr_t MarkCompact::LiveWordsBitmap<kAlignment>::SetLiveWords(uintptr_
     }
   }
   uintptr_t end_mask = Bitmap::BitIndexToMask(end_bit_idx);
-  *end_bm_address |= mask & (end_mask | (end_mask - 1));
+  mask &= end_mask | (end_mask - 1);
+  if (kParallel) {
+    reinterpret_cast<Atomic<uintptr_t>*>(end_bm_address)->fetch_or(mask,
+                                                                   std::memory_order_relaxed);
+  } else {
+    *end_bm_address |= mask;
+  }
   return begin_bit_idx;
 }
 
@@ -283,6 +294,7 @@ inline bool MarkCompact::VerifyRootSingleUpdate(void* root,
                          << " stack_high_addr=" << stack_high_addr;
     }
     DCHECK(reinterpret_cast<uint8_t*>(old_ref) >= black_allocations_begin_ ||
+           reinterpret_cast<uint8_t*>(old_ref) < old_gen_end_ ||
            live_words_bitmap_->Test(old_ref))
         << "ref=" << old_ref << " <" << mirror::Object::PrettyTypeOf(old_ref) << "> RootInfo ["
         << info << "]";
@@ -358,6 +370,10 @@ inline mirror::Object* MarkCompact::PostCompactAddressUnchecked(mirror::Object*
   if (reinterpret_cast<uint8_t*>(old_ref) >= black_allocations_begin_) {
     return PostCompactBlackObjAddr(old_ref);
   }
+  // The old generation is not compacted.
+  if (reinterpret_cast<uint8_t*>(old_ref) < old_gen_end_) {
+    return old_ref;
+  }
   if (kIsDebugBuild) {
     mirror::Object* from_ref = GetFromSpaceAddr(old_ref);
     DCHECK(live_words_bitmap_->Test(old_ref))
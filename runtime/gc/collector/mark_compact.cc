@@ -293,6 +293,10 @@ static constexpr size_t kMaxNumUffdWorkers = 2;
 // phase. Using a lower number in debug builds to hopefully catch the issue
 // before it becomes a problem on user builds.
 static constexpr size_t kMutatorCompactionBufferCount = kIsDebugBuild ? 256 : 512;
+// Process the mark-stack with the heap thread-pool workers once it has at least
+// these many objects.
+static constexpr bool kParallelProcessMarkStack = true;
+static constexpr size_t kMinimumParallelMarkStackSize = 128;
 // Minimum from-space chunk to be madvised (during concurrent compaction) in one go.
 static constexpr ssize_t kMinFromSpaceMadviseSize = 1 * MB;
 // Concurrent compaction termination logic is different (and slightly more efficient) if the
@@ -374,18 +378,23 @@ MarkCompact::MarkCompact(Heap* heap)
       lock_("mark compact lock", kGenericBottomLock),
       bump_pointer_space_(heap->GetBumpPointerSpace()),
       moving_space_bitmap_(bump_pointer_space_->GetMarkBitmap()),
+      old_gen_end_(bump_pointer_space_->Begin()),
+      old_gen_objects_count_(0),
       moving_to_space_fd_(kFdUnused),
       moving_from_space_fd_(kFdUnused),
       uffd_(kFdUnused),
       sigbus_in_progress_count_(kSigbusCounterCompactionDoneMask),
       compaction_in_progress_count_(0),
+      compaction_worker_page_idx_(0),
       thread_pool_counter_(0),
       compacting_(false),
       uffd_initialized_(false),
       uffd_minor_fault_supported_(false),
       use_uffd_sigbus_(IsSigbusFeatureAvailable()),
       minor_fault_initialized_(false),
-      map_linear_alloc_shared_(false) {
+      map_linear_alloc_shared_(false),
+      use_generational_(heap->GetUseGenerationalCMC()),
+      young_gen_(false) {
   if (kIsDebugBuild) {
     updated_roots_.reset(new std::unordered_set<void*>());
   }
@@ -600,14 +609,30 @@ void MarkCompact::BindAndResetBitmaps() {
       // be cleared, because we are going to traverse all the reachable objects
       // in these spaces. This card-table will eventually be used to track
       // mutations while concurrent marking is going on.
-      card_table->ClearCardRange(space->Begin(), space->Limit());
+      // In young collections, the cards of the old generation and the
+      // non-moving space still have to be scanned. They are aged later in
+      // ScanOldGenObjects().
+      if (!young_gen_) {
+        card_table->ClearCardRange(space->Begin(), space->Limit());
+      } else if (space == bump_pointer_space_) {
+        card_table->ClearCardRange(old_gen_end_, space->Limit());
+      }
       if (space != bump_pointer_space_) {
         CHECK_EQ(space, heap_->GetNonMovingSpace());
         non_moving_space_ = space;
         non_moving_space_bitmap_ = space->GetMarkBitmap();
+        if (young_gen_) {
+          // Sticky marking: everything that survived the previous GC is
+          // considered marked, so only the newly allocated objects get swept.
+          non_moving_space_bitmap_->CopyFrom(space->GetLiveBitmap());
+        }
       }
     }
   }
+  space::LargeObjectSpace* const los = heap_->GetLargeObjectsSpace();
+  if (young_gen_ && los != nullptr) {
+    los->CopyLiveToMarked();
+  }
 }
 
 void MarkCompact::MarkZygoteLargeObjects() {
@@ -646,6 +671,13 @@ void MarkCompact::InitializePhase() {
   compaction_buffer_counter_.store(1, std::memory_order_relaxed);
   from_space_slide_diff_ = from_space_begin_ - bump_pointer_space_->Begin();
   black_allocations_begin_ = bump_pointer_space_->Limit();
+  if (!young_gen_ && old_gen_end_ != bump_pointer_space_->Begin()) {
+    // Full collections mark and compact the entire moving space. Drop the mark
+    // bits retained for the old generation.
+    moving_space_bitmap_->Clear();
+    old_gen_end_ = bump_pointer_space_->Begin();
+    old_gen_objects_count_ = 0;
+  }
   walk_super_class_cache_ = nullptr;
   // TODO: Would it suffice to read it once in the constructor, which is called
   // in zygote process?
@@ -692,6 +724,13 @@ void MarkCompact::RunPhases() {
   Runtime* runtime = Runtime::Current();
   InitializePhase();
   GetHeap()->PreGcVerification(this);
+  // With SIGBUS feature the heap thread-pool is only used for parallel marking
+  // and compaction. Its workers must be created outside of pauses.
+  if (use_uffd_sigbus_ && heap_->GetThreadPool() == nullptr &&
+      heap_->GetParallelGCThreadCount() > 0 && !runtime->IsZygote()) {
+    heap_->CreateThreadPool(heap_->GetParallelGCThreadCount());
+    heap_->GetThreadPool()->WaitForWorkersToBeCreated();
+  }
   {
     ReaderMutexLock mu(self, *Locks::mutator_lock_);
     MarkingPhase();
@@ -723,7 +762,7 @@ void MarkCompact::RunPhases() {
     ThreadFlipVisitor visitor(this);
     FlipCallback callback(this);
     size_t barrier_count = runtime->GetThreadList()->FlipThreadRoots(
-        &visitor, &callback, this, GetHeap()->GetGcPauseListener());
+        &visitor, &callback, this, GetHeap()->GetGcPauseListener(), heap_->GetThreadPool());
     {
       ScopedThreadStateChange tsc(self, ThreadState::kWaitingForCheckPointsToRun);
       gc_barrier_.Increment(self, barrier_count);
@@ -749,8 +788,11 @@ void MarkCompact::InitMovingSpaceFirstObjects(const size_t vec_len) {
   const uintptr_t heap_begin = moving_space_bitmap_->HeapBegin();
 
   size_t chunk_idx;
-  // Find the first live word in the space
-  for (chunk_idx = 0; chunk_info_vec_[chunk_idx] == 0; chunk_idx++) {
+  // Find the first live word in the space. The old generation, if any, is not
+  // compacted.
+  for (chunk_idx = (old_gen_end_ - bump_pointer_space_->Begin()) / kOffsetChunkSize;
+       chunk_info_vec_[chunk_idx] == 0;
+       chunk_idx++) {
     if (chunk_idx > vec_len) {
       // We don't have any live data on the moving-space.
       return;
@@ -921,6 +963,18 @@ class MarkCompact::ConcurrentCompactionGcTask : public SelfDeletingTask {
   size_t index_;
 };
 
+class MarkCompact::CompactionWorkerTask : public SelfDeletingTask {
+ public:
+  explicit CompactionWorkerTask(MarkCompact* collector) : collector_(collector) {}
+
+  void Run([[maybe_unused]] Thread* self) override REQUIRES_SHARED(Locks::mutator_lock_) {
+    collector_->CompactMovingSpaceWorker();
+  }
+
+ private:
+  MarkCompact* const collector_;
+};
+
 void MarkCompact::PrepareForCompaction() {
   uint8_t* space_begin = bump_pointer_space_->Begin();
   size_t vector_len = (black_allocations_begin_ - space_begin) / kOffsetChunkSize;
@@ -954,6 +1008,11 @@ void MarkCompact::PrepareForCompaction() {
   // of the corresponding chunk. For old-to-new address computation we need
   // every element to reflect total live-bytes till the corresponding chunk.
 
+  // In young collections, the old generation is left in place. Account it as
+  // fully live so that the young objects are compacted starting from
+  // old_gen_end_.
+  std::fill_n(chunk_info_vec_, (old_gen_end_ - space_begin) / kOffsetChunkSize, kOffsetChunkSize);
+
   // Live-bytes count is required to compute post_compact_end_ below.
   uint32_t total;
   // Update the vector one past the heap usage as it is required for black
@@ -973,7 +1032,8 @@ void MarkCompact::PrepareForCompaction() {
     DCHECK_EQ(chunk_info_vec_[i], 0u);
   }
   post_compact_end_ = AlignUp(space_begin + total, kPageSize);
-  CHECK_EQ(post_compact_end_, space_begin + moving_first_objs_count_ * kPageSize);
+  CHECK_EQ(post_compact_end_, old_gen_end_ + moving_first_objs_count_ * kPageSize);
+  GetCurrentIteration()->SetMovedBytes(post_compact_end_ - old_gen_end_);
   black_objs_slide_diff_ = black_allocations_begin_ - post_compact_end_;
   // How do we handle compaction of heap portion used for allocations after the
   // marking-pause?
@@ -1217,6 +1277,7 @@ class MarkCompact::VerifyRootMarkedVisitor : public SingleRootVisitor {
 
 void MarkCompact::ReMarkRoots(Runtime* runtime) {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  ScopedPhaseTiming phase_timing(GcPhase::kRootVisiting, this);
   DCHECK_EQ(thread_running_gc_, Thread::Current());
   Locks::mutator_lock_->AssertExclusiveHeld(thread_running_gc_);
   MarkNonThreadRoots(runtime);
@@ -1234,6 +1295,7 @@ void MarkCompact::ReMarkRoots(Runtime* runtime) {
 
 void MarkCompact::MarkingPause() {
   TimingLogger::ScopedTiming t("(Paused)MarkingPause", GetTimings());
+  ScopedPhaseTiming phase_timing(GcPhase::kMarking, this);
   Runtime* runtime = Runtime::Current();
   Locks::mutator_lock_->AssertExclusiveHeld(thread_running_gc_);
   {
@@ -1256,6 +1318,9 @@ void MarkCompact::MarkingPause() {
     // Fetch only the accumulated objects-allocated count as it is guaranteed to
     // be up-to-date after the TLAB revocation above.
     freed_objects_ += bump_pointer_space_->GetAccumulatedObjectsAllocated();
+    // The old-generation objects are neither marked nor freed in young
+    // collections.
+    freed_objects_ -= old_gen_objects_count_;
     // Capture 'end' of moving-space at this point. Every allocation beyond this
     // point will be considered as black.
     // Align-up to page boundary so that black allocations happen from next page
@@ -1305,6 +1370,7 @@ void MarkCompact::SweepSystemWeaks(Thread* self, Runtime* runtime, const bool pa
 }
 
 void MarkCompact::ProcessReferences(Thread* self) {
+  ScopedPhaseTiming phase_timing(GcPhase::kReferenceProcessing, this);
   WriterMutexLock mu(self, *Locks::heap_bitmap_lock_);
   GetHeap()->GetReferenceProcessor()->ProcessReferences(self, GetTimings());
 }
@@ -1345,6 +1411,7 @@ void MarkCompact::SweepLargeObjects(bool swap_bitmaps) {
 
 void MarkCompact::ReclaimPhase() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  ScopedPhaseTiming phase_timing(GcPhase::kReclaim, this);
   DCHECK(thread_running_gc_ == Thread::Current());
   Runtime* const runtime = Runtime::Current();
   // Process the references concurrently.
@@ -1448,6 +1515,7 @@ void MarkCompact::VerifyObject(mirror::Object* ref, Callback& callback) const {
     mirror::Class* klass_klass = klass->GetClass<kVerifyNone, kWithFromSpaceBarrier>();
     mirror::Class* klass_klass_klass = klass_klass->GetClass<kVerifyNone, kWithFromSpaceBarrier>();
     if (bump_pointer_space_->HasAddress(pre_compact_klass) &&
+        reinterpret_cast<uint8_t*>(pre_compact_klass) >= old_gen_end_ &&
         reinterpret_cast<uint8_t*>(pre_compact_klass) < black_allocations_begin_) {
       CHECK(moving_space_bitmap_->Test(pre_compact_klass))
           << "ref=" << ref
@@ -2174,7 +2242,7 @@ void MarkCompact::CompactMovingSpace(uint8_t* page) {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
   size_t page_status_arr_len = moving_first_objs_count_ + black_page_count_;
   size_t idx = page_status_arr_len;
-  uint8_t* to_space_end = bump_pointer_space_->Begin() + page_status_arr_len * kPageSize;
+  uint8_t* to_space_end = old_gen_end_ + page_status_arr_len * kPageSize;
   uint8_t* shadow_space_end = nullptr;
   if (kMode == kMinorFaultMode) {
     shadow_space_end = shadow_to_space_map_.Begin() + page_status_arr_len * kPageSize;
@@ -2234,7 +2302,53 @@ void MarkCompact::CompactMovingSpace(uint8_t* page) {
         });
     FreeFromSpacePages(idx, kMode);
   }
-  DCHECK_EQ(to_space_end, bump_pointer_space_->Begin());
+  DCHECK_EQ(to_space_end, old_gen_end_);
+}
+
+bool MarkCompact::StartCompactionWorkers() {
+  // Without SIGBUS feature the thread-pool workers are the userfaultfd
+  // handlers, which are busy until the end of compaction.
+  ThreadPool* pool = heap_->GetThreadPool();
+  if (!use_uffd_sigbus_ || pool == nullptr || moving_first_objs_count_ < 2) {
+    return false;
+  }
+  compaction_worker_page_idx_.store(0, std::memory_order_relaxed);
+  size_t num_threads = pool->GetThreadCount();
+  for (size_t i = 0; i < num_threads; i++) {
+    pool->AddTask(thread_running_gc_, new CompactionWorkerTask(this));
+  }
+  pool->StartWorkers(thread_running_gc_);
+  return true;
+}
+
+void MarkCompact::WaitForCompactionWorkers() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  ThreadPool* pool = heap_->GetThreadPool();
+  pool->Wait(thread_running_gc_, /*do_work=*/false, /*may_hold_locks=*/true);
+  pool->StopWorkers(thread_running_gc_);
+}
+
+void MarkCompact::CompactMovingSpaceWorker() {
+  // Claim the pages in the same way as the mutators do in the SIGBUS handler,
+  // so that every page is compacted exactly once and FreeFromSpacePages() on
+  // the GC-thread doesn't release from-space pages that are still in use. The
+  // black-allocated pages at the top are left for the GC-thread, which starts
+  // there.
+  Thread* const self = Thread::Current();
+  const size_t nr_moving_space_used_pages = moving_first_objs_count_ + black_page_count_;
+  while (true) {
+    size_t idx = compaction_worker_page_idx_.fetch_add(1, std::memory_order_relaxed);
+    if (idx >= moving_first_objs_count_) {
+      break;
+    }
+    // Skip the pages already claimed by the GC-thread or by a mutator instead of
+    // waiting for them to be mapped.
+    if (moving_pages_status_[idx].load(std::memory_order_relaxed) != PageState::kUnprocessed) {
+      continue;
+    }
+    ConcurrentlyProcessMovingPage<kCopyMode>(
+        old_gen_end_ + idx * kPageSize, self->GetThreadLocalGcBuffer(), nr_moving_space_used_pages);
+  }
 }
 
 void MarkCompact::UpdateNonMovingPage(mirror::Object* first, uint8_t* page) {
@@ -2416,7 +2530,7 @@ void MarkCompact::UpdateMovingSpaceBlackAllocations() {
         black_allocs = block_end;
       }
     }
-    if (black_page_idx < bump_pointer_space_->Size() / kPageSize) {
+    if (black_page_idx < static_cast<size_t>(bump_pointer_space_->End() - old_gen_end_) / kPageSize) {
       // Store the leftover first-chunk, if any, and update page index.
       if (black_alloc_pages_first_chunk_size_[black_page_idx] > 0) {
         black_page_idx++;
@@ -2649,6 +2763,7 @@ class MarkCompact::LinearAllocPageUpdater {
 
 void MarkCompact::CompactionPause() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  ScopedPhaseTiming phase_timing(GcPhase::kCompaction, this);
   Runtime* runtime = Runtime::Current();
   non_moving_space_bitmap_ = non_moving_space_->GetLiveBitmap();
   if (kIsDebugBuild) {
@@ -2789,6 +2904,13 @@ void MarkCompact::CompactionPause() {
     }
   }
 
+  if (young_gen_) {
+    UpdateOldGenObjects();
+  }
+  if (use_generational_) {
+    CarryOverDirtyCards();
+  }
+
   if (use_uffd_sigbus_) {
     // Release order wrt to mutator threads' SIGBUS handler load.
     sigbus_in_progress_count_.store(0, std::memory_order_release);
@@ -2860,8 +2982,10 @@ void MarkCompact::KernelPrepareRangeForUffd(uint8_t* to_addr,
 
 void MarkCompact::KernelPreparation() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
-  uint8_t* moving_space_begin = bump_pointer_space_->Begin();
-  size_t moving_space_size = bump_pointer_space_->Capacity();
+  // The old generation stays in place during young collections.
+  uint8_t* moving_space_begin = old_gen_end_;
+  size_t moving_space_size =
+      bump_pointer_space_->Capacity() - (old_gen_end_ - bump_pointer_space_->Begin());
   int mode = kCopyMode;
   size_t moving_space_register_sz;
   if (minor_fault_initialized_) {
@@ -2903,12 +3027,12 @@ void MarkCompact::KernelPreparation() {
   if (moving_to_space_fd_ == kFdUnused && map_shared) {
     DCHECK(gHaveMremapDontunmap);
     DCHECK(shadow_to_space_map_.IsValid());
-    DCHECK_EQ(shadow_to_space_map_.Size(), moving_space_size);
-    shadow_addr = shadow_to_space_map_.Begin();
+    DCHECK_EQ(shadow_to_space_map_.Size(), bump_pointer_space_->Capacity());
+    shadow_addr = shadow_to_space_map_.Begin() + (old_gen_end_ - bump_pointer_space_->Begin());
   }
 
   KernelPrepareRangeForUffd(moving_space_begin,
-                            from_space_begin_,
+                            moving_space_begin + from_space_slide_diff_,
                             moving_space_size,
                             moving_to_space_fd_,
                             shadow_addr);
@@ -3113,8 +3237,7 @@ void MarkCompact::ConcurrentlyProcessMovingPage(uint8_t* fault_page,
     MarkCompact* collector_;
   };
 
-  uint8_t* unused_space_begin =
-      bump_pointer_space_->Begin() + nr_moving_space_used_pages * kPageSize;
+  uint8_t* unused_space_begin = old_gen_end_ + nr_moving_space_used_pages * kPageSize;
   DCHECK(IsAligned<kPageSize>(unused_space_begin));
   DCHECK(kMode == kCopyMode || fault_page < unused_space_begin);
   if (kMode == kCopyMode && fault_page >= unused_space_begin) {
@@ -3124,7 +3247,8 @@ void MarkCompact::ConcurrentlyProcessMovingPage(uint8_t* fault_page,
     ZeropageIoctl(fault_page, /*tolerate_eexist=*/true, /*tolerate_enoent=*/true);
     return;
   }
-  size_t page_idx = (fault_page - bump_pointer_space_->Begin()) / kPageSize;
+  DCHECK_GE(fault_page, old_gen_end_);
+  size_t page_idx = (fault_page - old_gen_end_) / kPageSize;
   mirror::Object* first_obj = first_objs_moving_space_[page_idx].AsMirrorPtr();
   if (first_obj == nullptr) {
     // We should never have a case where two workers are trying to install a
@@ -3497,6 +3621,7 @@ void MarkCompact::UnregisterUffd(uint8_t* start, size_t len) {
 
 void MarkCompact::CompactionPhase() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  ScopedPhaseTiming phase_timing(GcPhase::kCompaction, this);
   {
     int32_t freed_bytes = black_objs_slide_diff_;
     bump_pointer_space_->RecordFree(freed_objects_, freed_bytes);
@@ -3506,7 +3631,11 @@ void MarkCompact::CompactionPhase() {
   if (CanCompactMovingSpaceWithMinorFault()) {
     CompactMovingSpace<kMinorFaultMode>(/*page=*/nullptr);
   } else {
+    bool workers_started = StartCompactionWorkers();
     CompactMovingSpace<kCopyMode>(compaction_buffers_map_.Begin());
+    if (workers_started) {
+      WaitForCompactionWorkers();
+    }
   }
 
   // Make sure no mutator is reading from the from-space before unregistering
@@ -3521,10 +3650,10 @@ void MarkCompact::CompactionPhase() {
   }
 
   size_t moving_space_size = bump_pointer_space_->Capacity();
-  UnregisterUffd(bump_pointer_space_->Begin(),
+  UnregisterUffd(old_gen_end_,
                  minor_fault_initialized_ ?
                      (moving_first_objs_count_ + black_page_count_) * kPageSize :
-                     moving_space_size);
+                     moving_space_size - (old_gen_end_ - bump_pointer_space_->Begin()));
 
   // Release all of the memory taken by moving-space's from-map
   if (minor_fault_initialized_) {
@@ -3716,7 +3845,10 @@ void MarkCompact::MarkRootsCheckpoint(Thread* self, Runtime* runtime) {
   gc_barrier_.Init(self, 0);
   // Request the check point is run on all threads returning a count of the threads that must
   // run through the barrier including self.
-  size_t barrier_count = thread_list->RunCheckpoint(&check_point);
+  // The closure marks with CAS and flushes to the mark-stack under lock_, so the
+  // heap thread-pool can run it for the suspended threads in parallel.
+  size_t barrier_count =
+      thread_list->RunCheckpoint(&check_point, /*callback=*/nullptr, heap_->GetThreadPool());
   // Release locks then wait for all mutator threads to pass the barrier.
   // If there are no threads to wait which implys that all the checkpoint functions are finished,
   // then no need to release locks.
@@ -3839,8 +3971,10 @@ void MarkCompact::ScanDirtyObjects(bool paused, uint8_t minimum_age) {
     const bool is_immune_space = space->IsZygoteSpace() || space->IsImageSpace();
     if (paused) {
       DCHECK_EQ(minimum_age, gc::accounting::CardTable::kCardDirty);
-      // We can clear the card-table for any non-immune space.
-      if (is_immune_space) {
+      // We can clear the card-table for any non-immune space. Except when
+      // generational, as the cards dirtied during this cycle are needed to find
+      // the references to the objects that stay in the young generation.
+      if (is_immune_space || use_generational_) {
         card_table->Scan</*kClearCard*/false>(space->GetMarkBitmap(),
                                               space->Begin(),
                                               space->End(),
@@ -3863,6 +3997,14 @@ void MarkCompact::ScanDirtyObjects(bool paused, uint8_t minimum_age) {
                                               space->End(),
                                               visitor,
                                               minimum_age);
+      } else if (use_generational_ && !is_immune_space) {
+        // Leave the cards unchanged so that the pause, and the next young
+        // collection, can tell the cards dirtied during this cycle.
+        card_table->Scan</*kClearCard*/false>(space->GetMarkBitmap(),
+                                              space->Begin(),
+                                              space->End(),
+                                              visitor,
+                                              gc::accounting::CardTable::kCardDirty);
       } else {
         CardModifiedVisitor card_modified_visitor(this, space->GetMarkBitmap(), card_table);
         // For the alloc spaces we should age the dirty cards and clear the rest.
@@ -3890,6 +4032,84 @@ void MarkCompact::ScanDirtyObjects(bool paused, uint8_t minimum_age) {
   }
 }
 
+void MarkCompact::ScanOldGenObjects() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  accounting::CardTable* const card_table = heap_->GetCardTable();
+  // The aged cards of the old generation are later used to update the
+  // references to the young objects in UpdateOldGenObjects().
+  card_table->ModifyCardsAtomic(bump_pointer_space_->Begin(),
+                                old_gen_end_,
+                                AgeCardVisitor(),
+                                CardModifiedVisitor(this, moving_space_bitmap_, card_table));
+  card_table->ModifyCardsAtomic(non_moving_space_->Begin(),
+                                non_moving_space_->End(),
+                                AgeCardVisitor(),
+                                CardModifiedVisitor(this, non_moving_space_bitmap_, card_table));
+}
+
+void MarkCompact::UpdateOldGenObjects() {
+  TimingLogger::ScopedTiming t("(Paused)UpdateOldGenObjects", GetTimings());
+  // Cards are aged at the beginning of the cycle, or dirtied since then.
+  ImmuneSpaceUpdateObjVisitor visitor(this, /*visit_native_roots=*/false);
+  WriterMutexLock wmu(thread_running_gc_, *Locks::heap_bitmap_lock_);
+  heap_->GetCardTable()->Scan</*kClearCard*/false>(moving_space_bitmap_,
+                                                   bump_pointer_space_->Begin(),
+                                                   old_gen_end_,
+                                                   visitor,
+                                                   accounting::CardTable::kCardAged);
+}
+
+void MarkCompact::CarryOverDirtyCards() {
+  TimingLogger::ScopedTiming t("(Paused)CarryOverDirtyCards", GetTimings());
+  accounting::CardTable* const card_table = heap_->GetCardTable();
+  // Compaction only ever moves objects to lower addresses, so the cards are
+  // marked after they are visited here.
+  card_table->ModifyCardsAtomic(
+      old_gen_end_,
+      black_allocations_begin_,
+      []([[maybe_unused]] uint8_t card) { return accounting::CardTable::kCardClean; },
+      [this, card_table](uint8_t* card, uint8_t expected_value, [[maybe_unused]] uint8_t new_value)
+          REQUIRES(Locks::mutator_lock_) {
+        if (expected_value == accounting::CardTable::kCardDirty) {
+          uintptr_t start = reinterpret_cast<uintptr_t>(card_table->AddrFromCard(card));
+          moving_space_bitmap_->VisitMarkedRange(
+              start,
+              start + accounting::CardTable::kCardSize,
+              [this, card_table](mirror::Object* obj) REQUIRES(Locks::mutator_lock_) {
+                card_table->MarkCard(PostCompactOldObjAddr(obj));
+              });
+        }
+      });
+}
+
+void MarkCompact::PromoteCompactedObjects() {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  // The mark-bits beyond old_gen_end_ are stale as the objects have moved. The
+  // compacted objects are contiguous, so walk them to mark their new addresses.
+  moving_space_bitmap_->ClearRange(reinterpret_cast<mirror::Object*>(old_gen_end_),
+                                   reinterpret_cast<mirror::Object*>(bump_pointer_space_->Limit()));
+  int32_t count = 0;
+  uint8_t* addr = old_gen_end_;
+  while (addr < post_compact_end_) {
+    mirror::Object* obj = reinterpret_cast<mirror::Object*>(addr);
+    // The remainder of the last compacted page is zeroed.
+    if (obj->GetClass<kDefaultVerifyFlags, kWithoutReadBarrier>() == nullptr) {
+      break;
+    }
+    moving_space_bitmap_->Set(obj);
+    addr += RoundUp(obj->SizeOf<kDefaultVerifyFlags>(), kAlignment);
+    count++;
+  }
+  old_gen_objects_count_ += count;
+  old_gen_end_ = post_compact_end_;
+}
+
+void MarkCompact::ResetGenerations() {
+  moving_space_bitmap_->Clear();
+  old_gen_end_ = bump_pointer_space_->Begin();
+  old_gen_objects_count_ = 0;
+}
+
 void MarkCompact::RecursiveMarkDirtyObjects(bool paused, uint8_t minimum_age) {
   ScanDirtyObjects(paused, minimum_age);
   ProcessMarkStack();
@@ -3897,6 +4117,7 @@ void MarkCompact::RecursiveMarkDirtyObjects(bool paused, uint8_t minimum_age) {
 
 void MarkCompact::MarkRoots(VisitRootFlags flags) {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  ScopedPhaseTiming phase_timing(GcPhase::kRootVisiting, this);
   Runtime* runtime = Runtime::Current();
   // Make sure that the checkpoint which collects the stack roots is the first
   // one capturning GC-roots. As this one is supposed to find the address
@@ -3928,10 +4149,14 @@ void MarkCompact::PreCleanCards() {
 // scan), it might be better to go with approach 2.
 void MarkCompact::MarkingPhase() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  ScopedPhaseTiming phase_timing(GcPhase::kMarking, this);
   DCHECK_EQ(thread_running_gc_, Thread::Current());
   WriterMutexLock mu(thread_running_gc_, *Locks::heap_bitmap_lock_);
   BindAndResetBitmaps();
   MarkZygoteLargeObjects();
+  if (young_gen_) {
+    ScanOldGenObjects();
+  }
   MarkRoots(
         static_cast<VisitRootFlags>(kVisitRootFlagAllRoots | kVisitRootFlagStartLoggingNewRoots));
   MarkReachableObjects();
@@ -4041,11 +4266,184 @@ void MarkCompact::ScanObject(mirror::Object* obj) {
   obj->VisitReferences(visitor, visitor);
 }
 
+void MarkCompact::UpdateLivenessInfoParallel(mirror::Object* obj,
+                                             size_t obj_size,
+                                             mirror::Class** walk_super_class_cache) {
+  DCHECK(obj != nullptr);
+  DCHECK_EQ(obj_size, obj->SizeOf<kDefaultVerifyFlags>());
+  uintptr_t obj_begin = reinterpret_cast<uintptr_t>(obj);
+  mirror::Class* klass = obj->GetClass<kVerifyNone, kWithoutReadBarrier>();
+  // Avoid taking the lock for every object of a class that needs walking super-classes.
+  if (UNLIKELY(
+          (std::less<mirror::Object*>{}(obj, klass) && bump_pointer_space_->HasAddress(klass)) ||
+          (klass->GetReferenceInstanceOffsets<kVerifyNone>() == mirror::Class::kClassWalkSuper &&
+           *walk_super_class_cache != klass))) {
+    MutexLock mu(Thread::Current(), lock_);
+    UpdateClassAfterObjectMap(obj);
+    if (walk_super_class_cache_ == klass) {
+      *walk_super_class_cache = klass;
+    }
+  }
+  size_t size = RoundUp(obj_size, kAlignment);
+  uintptr_t bit_index = live_words_bitmap_->SetLiveWords</*kParallel*/ true>(obj_begin, size);
+  size_t chunk_idx = (obj_begin - live_words_bitmap_->Begin()) / kOffsetChunkSize;
+  // Compute the bit-index within the chunk-info vector word.
+  bit_index %= kBitsPerVectorWord;
+  size_t first_chunk_portion = std::min(size, (kBitsPerVectorWord - bit_index) * kAlignment);
+  // The first and the last chunks may be shared with objects being updated by
+  // other threads. The ones in between are entirely covered by this object.
+  reinterpret_cast<Atomic<uint32_t>*>(&chunk_info_vec_[chunk_idx++])
+      ->fetch_add(first_chunk_portion, std::memory_order_relaxed);
+  DCHECK_LE(first_chunk_portion, size);
+  for (size -= first_chunk_portion; size > kOffsetChunkSize; size -= kOffsetChunkSize) {
+    DCHECK_EQ(chunk_info_vec_[chunk_idx], 0u);
+    chunk_info_vec_[chunk_idx++] = kOffsetChunkSize;
+  }
+  if (size > 0) {
+    reinterpret_cast<Atomic<uint32_t>*>(&chunk_info_vec_[chunk_idx])
+        ->fetch_add(size, std::memory_order_relaxed);
+  }
+}
+
+// Modelled after MarkSweep::MarkStackTask. Idle workers pick up the tasks that
+// the busy ones hand over when their task-local mark-stack overflows.
+class MarkCompact::MarkStackTask : public Task {
+ public:
+  MarkStackTask(MarkCompact* mark_compact,
+                ThreadPool* thread_pool,
+                size_t mark_stack_size,
+                StackReference<mirror::Object>* mark_stack)
+      : mark_compact_(mark_compact),
+        thread_pool_(thread_pool),
+        mark_stack_pos_(mark_stack_size),
+        bytes_scanned_(0),
+        live_objects_(0),
+        walk_super_class_cache_(nullptr) {
+    DCHECK_LE(mark_stack_size, kMaxSize);
+    std::copy(mark_stack, mark_stack + mark_stack_size, mark_stack_);
+  }
+
+  static constexpr size_t kMaxSize = 1 * KB;
+
+  void Run(Thread* self) override REQUIRES(Locks::heap_bitmap_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    RefFieldsParallelVisitor visitor(this);
+    accounting::ContinuousSpaceBitmap* const moving_space_bitmap =
+        mark_compact_->moving_space_bitmap_;
+    while (mark_stack_pos_ != 0) {
+      mirror::Object* obj = mark_stack_[--mark_stack_pos_].AsMirrorPtr();
+      DCHECK(obj != nullptr);
+      size_t obj_size = obj->SizeOf<kDefaultVerifyFlags>();
+      bytes_scanned_ += obj_size;
+      if (moving_space_bitmap->HasAddress(obj)) {
+        mark_compact_->UpdateLivenessInfoParallel(obj, obj_size, &walk_super_class_cache_);
+        live_objects_++;
+      }
+      obj->VisitReferences(visitor, visitor);
+    }
+    MutexLock mu(self, mark_compact_->lock_);
+    mark_compact_->bytes_scanned_ += bytes_scanned_;
+    mark_compact_->freed_objects_ -= live_objects_;
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  class RefFieldsParallelVisitor {
+   public:
+    explicit RefFieldsParallelVisitor(MarkStackTask* task) : task_(task) {}
+
+    ALWAYS_INLINE void operator()(mirror::Object* obj,
+                                  MemberOffset offset,
+                                  [[maybe_unused]] bool is_static) const
+        REQUIRES(Locks::heap_bitmap_lock_) REQUIRES_SHARED(Locks::mutator_lock_) {
+      Mark(obj->GetFieldObject<mirror::Object>(offset), obj, offset);
+    }
+
+    void operator()(ObjPtr<mirror::Class> klass, ObjPtr<mirror::Reference> ref) const
+        REQUIRES(Locks::heap_bitmap_lock_) REQUIRES_SHARED(Locks::mutator_lock_) {
+      task_->mark_compact_->DelayReferenceReferent(klass, ref);
+    }
+
+    void VisitRootIfNonNull(mirror::CompressedReference<mirror::Object>* root) const
+        REQUIRES(Locks::heap_bitmap_lock_) REQUIRES_SHARED(Locks::mutator_lock_) {
+      if (!root->IsNull()) {
+        VisitRoot(root);
+      }
+    }
+
+    void VisitRoot(mirror::CompressedReference<mirror::Object>* root) const
+        REQUIRES(Locks::heap_bitmap_lock_) REQUIRES_SHARED(Locks::mutator_lock_) {
+      Mark(root->AsMirrorPtr(), nullptr, MemberOffset(0));
+    }
+
+   private:
+    ALWAYS_INLINE void Mark(mirror::Object* ref, mirror::Object* holder, MemberOffset offset) const
+        REQUIRES(Locks::heap_bitmap_lock_) REQUIRES_SHARED(Locks::mutator_lock_) {
+      if (ref != nullptr &&
+          task_->mark_compact_->MarkObjectNonNullNoPush</*kParallel*/ true>(ref, holder, offset)) {
+        task_->MarkStackPush(ref);
+      }
+    }
+
+    MarkStackTask* const task_;
+  };
+
+  ALWAYS_INLINE void MarkStackPush(mirror::Object* obj) {
+    if (UNLIKELY(mark_stack_pos_ == kMaxSize)) {
+      // Mark stack overflow, give 1/2 the stack to the thread pool as a new work task.
+      mark_stack_pos_ /= 2;
+      auto* task = new MarkStackTask(
+          mark_compact_, thread_pool_, kMaxSize - mark_stack_pos_, mark_stack_ + mark_stack_pos_);
+      thread_pool_->AddTask(Thread::Current(), task);
+    }
+    DCHECK_LT(mark_stack_pos_, kMaxSize);
+    mark_stack_[mark_stack_pos_++].Assign(obj);
+  }
+
+  MarkCompact* const mark_compact_;
+  ThreadPool* const thread_pool_;
+  // Thread local mark stack for this task.
+  StackReference<mirror::Object> mark_stack_[kMaxSize];
+  size_t mark_stack_pos_;
+  // Accumulated locally to avoid contention, and added to the collector's
+  // counters at the end of the task.
+  uint64_t bytes_scanned_;
+  int32_t live_objects_;
+  mirror::Class* walk_super_class_cache_;
+};
+
+void MarkCompact::ProcessMarkStackParallel(ThreadPool* thread_pool) {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  Thread* const self = thread_running_gc_;
+  // The GC-thread works on the tasks as well.
+  const size_t thread_count = thread_pool->GetThreadCount() + 1;
+  const size_t chunk_size =
+      std::min(mark_stack_->Size() / thread_count + 1, MarkStackTask::kMaxSize);
+  for (auto* it = mark_stack_->Begin(), *end = mark_stack_->End(); it < end;) {
+    const size_t delta = std::min(static_cast<size_t>(end - it), chunk_size);
+    thread_pool->AddTask(self, new MarkStackTask(this, thread_pool, delta, it));
+    it += delta;
+  }
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, /*do_work=*/true, /*may_hold_locks=*/true);
+  thread_pool->StopWorkers(self);
+  mark_stack_->Reset();
+}
+
 // Scan anything that's on the mark stack.
 void MarkCompact::ProcessMarkStack() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  ThreadPool* const thread_pool = kParallelProcessMarkStack ? heap_->GetThreadPool() : nullptr;
   // TODO: try prefetch like in CMS
   while (!mark_stack_->IsEmpty()) {
+    // Switch to parallel processing once there's enough work to be split.
+    if (thread_pool != nullptr && mark_stack_->Size() >= kMinimumParallelMarkStackSize) {
+      ProcessMarkStackParallel(thread_pool);
+      break;
+    }
     mirror::Object* obj = mark_stack_->PopBack();
     DCHECK(obj != nullptr);
     ScanObject</*kUpdateLiveWords*/ true>(obj);
@@ -4173,6 +4571,8 @@ mirror::Object* MarkCompact::IsMarked(mirror::Object* obj) {
     if (compacting_) {
       if (is_black) {
         return PostCompactBlackObjAddr(obj);
+      } else if (reinterpret_cast<uint8_t*>(obj) < old_gen_end_) {
+        return obj;
       } else if (live_words_bitmap_->Test(obj)) {
         return PostCompactOldObjAddr(obj);
       } else {
@@ -4242,11 +4642,16 @@ void MarkCompact::FinishPhase() {
   }
   info_map_.MadviseDontNeedAndZero();
   live_words_bitmap_->ClearBitmap();
-  // TODO: We can clear this bitmap right before compaction pause. But in that
-  // case we need to ensure that we don't assert on this bitmap afterwards.
-  // Also, we would still need to clear it here again as we may have to use the
-  // bitmap for black-allocations (see UpdateMovingSpaceBlackAllocations()).
-  moving_space_bitmap_->Clear();
+  if (use_generational_) {
+    ReaderMutexLock mu(thread_running_gc_, *Locks::mutator_lock_);
+    PromoteCompactedObjects();
+  } else {
+    // TODO: We can clear this bitmap right before compaction pause. But in that
+    // case we need to ensure that we don't assert on this bitmap afterwards.
+    // Also, we would still need to clear it here again as we may have to use the
+    // bitmap for black-allocations (see UpdateMovingSpaceBlackAllocations()).
+    moving_space_bitmap_->Clear();
+  }
 
   if (UNLIKELY(is_zygote && IsValidFd(uffd_))) {
     heap_->DeleteThreadPool();
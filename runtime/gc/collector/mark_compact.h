@@ -41,6 +41,8 @@ namespace art {
 
 bool KernelSupportsUffd();
 
+class ThreadPool;
+
 namespace mirror {
 class DexCache;
 }  // namespace mirror
@@ -88,9 +90,21 @@ class MarkCompact final : public GarbageCollector {
   bool SigbusHandler(siginfo_t* info) REQUIRES(!lock_) NO_THREAD_SAFETY_ANALYSIS;
 
   GcType GetGcType() const override {
-    return kGcTypeFull;
+    return young_gen_ ? kGcTypeSticky : kGcTypeFull;
+  }
+
+  // Select between a young-generation (sticky) and a full collection for the
+  // next GC cycle. A young collection is only performed if generational
+  // collection is enabled; otherwise the request is ignored.
+  void SetYoungGen(bool young_gen) {
+    young_gen_ = use_generational_ && young_gen;
   }
 
+  // Forget the old generation, e.g. after the moving space has been evacuated
+  // into the zygote space. The next young collection will then compact the
+  // entire moving space.
+  void ResetGenerations();
+
   CollectorType GetCollectorType() const override {
     return kCollectorTypeCMC;
   }
@@ -197,6 +211,9 @@ class MarkCompact final : public GarbageCollector {
     uint32_t FindNthLiveWordOffset(size_t chunk_idx, uint32_t n) const;
     // Sets all bits in the bitmap corresponding to the given range. Also
     // returns the bit-index of the first word.
+    // If kParallel is true, then the bitmap words shared with other objects
+    // are updated atomically.
+    template <bool kParallel = false>
     ALWAYS_INLINE uintptr_t SetLiveWords(uintptr_t begin, size_t size);
     // Count number of live words upto the given bit-index. This is to be used
     // to compute the post-compact address of an old reference.
@@ -236,6 +253,10 @@ class MarkCompact final : public GarbageCollector {
   // pause.
   mirror::Object* GetFromSpaceAddr(mirror::Object* obj) const {
     DCHECK(live_words_bitmap_->HasAddress(obj)) << " obj=" << obj;
+    // The old-generation pages are not moved to the from-space.
+    if (reinterpret_cast<uint8_t*>(obj) < old_gen_end_) {
+      return obj;
+    }
     return reinterpret_cast<mirror::Object*>(reinterpret_cast<uintptr_t>(obj)
                                              + from_space_slide_diff_);
   }
@@ -318,6 +339,14 @@ class MarkCompact final : public GarbageCollector {
   // userfaultfd.
   template <int kMode>
   void CompactMovingSpace(uint8_t* page) REQUIRES_SHARED(Locks::mutator_lock_);
+  // Called by thread-pool workers when using SIGBUS feature to compact the
+  // moving-space pages from the bottom, while the GC-thread compacts them from
+  // the top in CompactMovingSpace().
+  void CompactMovingSpaceWorker() REQUIRES_SHARED(Locks::mutator_lock_);
+  // Start and then wait for the thread-pool workers compacting moving space in parallel with
+  // the GC-thread. Returns false if no workers were started.
+  bool StartCompactionWorkers() REQUIRES_SHARED(Locks::mutator_lock_);
+  void WaitForCompactionWorkers() REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Compact the given page as per func and change its state. Also map/copy the
   // page, if required.
@@ -398,6 +427,26 @@ class MarkCompact final : public GarbageCollector {
   // marking and kCardDirty during the STW pause.
   void ScanDirtyObjects(bool paused, uint8_t minimum_age) REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(Locks::heap_bitmap_lock_);
+  // For young collections, age the cards of the old generation (of moving
+  // space) and the non-moving space, and scan the objects on the cards that
+  // were dirtied since the previous GC cycle. These are the only old objects
+  // which may hold references to the young generation.
+  void ScanOldGenObjects() REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(Locks::heap_bitmap_lock_);
+  // For young collections, update the references in the old-generation
+  // objects of the moving space which are on non-clean cards. Called in the
+  // compaction pause.
+  void UpdateOldGenObjects() REQUIRES(Locks::mutator_lock_);
+  // Re-dirty the post-compact cards of the objects whose pre-compact cards
+  // were dirtied during this cycle, as these objects may hold references to
+  // black allocations, which stay in the young generation. Called in the
+  // compaction pause. Only used for generational collection.
+  void CarryOverDirtyCards() REQUIRES(Locks::mutator_lock_);
+  // After compaction, the compacted objects become part of the old generation:
+  // mark them in the moving-space bitmap and advance old_gen_end_. The bitmap
+  // bits of the old generation are retained across GC cycles so that its
+  // objects are implicitly considered marked by young collections.
+  void PromoteCompactedObjects() REQUIRES_SHARED(Locks::mutator_lock_);
   // Recursively mark dirty objects. Invoked both concurrently as well in a STW
   // pause in PausePhase().
   void RecursiveMarkDirtyObjects(bool paused, uint8_t minimum_age)
@@ -406,6 +455,11 @@ class MarkCompact final : public GarbageCollector {
   // Go through all the objects in the mark-stack until it's empty.
   void ProcessMarkStack() override REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(Locks::heap_bitmap_lock_);
+  // Split the mark-stack into tasks for the heap thread-pool workers, which
+  // hand over half of their stack as a new task whenever it overflows. The
+  // GC-thread also works on the tasks until all of them are done.
+  void ProcessMarkStackParallel(ThreadPool* thread_pool) REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(Locks::heap_bitmap_lock_);
   void ExpandMarkStack() REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(Locks::heap_bitmap_lock_);
 
@@ -424,6 +478,13 @@ class MarkCompact final : public GarbageCollector {
   // Also updates freed_objects_ counter.
   void UpdateLivenessInfo(mirror::Object* obj, size_t obj_size)
       REQUIRES_SHARED(Locks::mutator_lock_);
+  // Same as above, but safe to be called concurrently by the parallel marking
+  // workers. 'walk_super_class_cache' is the caller's counterpart of
+  // walk_super_class_cache_. Doesn't update freed_objects_.
+  void UpdateLivenessInfoParallel(mirror::Object* obj,
+                                  size_t obj_size,
+                                  mirror::Class** walk_super_class_cache)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!lock_);
 
   void ProcessReferences(Thread* self)
       REQUIRES_SHARED(Locks::mutator_lock_)
@@ -703,6 +764,17 @@ class MarkCompact final : public GarbageCollector {
   // Cache (from_space_begin_ - bump_pointer_space_->Begin()) so that we can
   // compute from-space address of a given pre-comapct addr efficiently.
   ptrdiff_t from_space_slide_diff_;
+  // End of the old generation in the moving space, which comprises the objects
+  // that survived the previous GC cycle. Page aligned. A young collection
+  // neither marks nor compacts the pages below it: they are not moved to the
+  // from-space, and the objects on them are updated via the card-table. Set
+  // to the beginning of the moving space for full collections, and to
+  // post_compact_end_ at the end of every GC cycle if generational collection
+  // is enabled.
+  uint8_t* old_gen_end_;
+  // Number of objects in the old generation. Used to compute freed_objects_ in
+  // young collections.
+  int32_t old_gen_objects_count_;
 
   // TODO: Remove once an efficient mechanism to deal with double root updation
   // is incorporated.
@@ -737,6 +809,9 @@ class MarkCompact final : public GarbageCollector {
   // When using SIGBUS feature, this counter is used by mutators to claim a page
   // out of compaction buffers to be used for the entire compaction cycle.
   std::atomic<uint16_t> compaction_buffer_counter_;
+  // Index of the next moving-space page to be claimed by the compaction
+  // workers. See CompactMovingSpaceWorker().
+  std::atomic<size_t> compaction_worker_page_idx_;
   // Used to exit from compaction loop at the end of concurrent compaction
   uint8_t thread_pool_counter_;
   // True while compacting.
@@ -761,6 +836,10 @@ class MarkCompact final : public GarbageCollector {
   // non-zygote processes during first GC, which sets up everyting for using
   // minor-fault from next GC.
   bool map_linear_alloc_shared_;
+  // True if generational collection is enabled (-Xgc:generational_cmc).
+  const bool use_generational_;
+  // True if the current GC cycle is a young-generation collection.
+  bool young_gen_;
 
   class FlipCallback;
   class ThreadFlipVisitor;
@@ -776,6 +855,8 @@ class MarkCompact final : public GarbageCollector {
   class LinearAllocPageUpdater;
   class ImmuneSpaceUpdateObjVisitor;
   class ConcurrentCompactionGcTask;
+  class CompactionWorkerTask;
+  class MarkStackTask;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(MarkCompact);
 };
@@ -176,12 +176,14 @@ void MarkSweep::RunPhases() {
 }
 
 void MarkSweep::ProcessReferences(Thread* self) {
+  ScopedPhaseTiming phase_timing(GcPhase::kReferenceProcessing, this);
   WriterMutexLock mu(self, *Locks::heap_bitmap_lock_);
   GetHeap()->GetReferenceProcessor()->ProcessReferences(self, GetTimings());
 }
 
 void MarkSweep::PausePhase() {
   TimingLogger::ScopedTiming t("(Paused)PausePhase", GetTimings());
+  ScopedPhaseTiming phase_timing(GcPhase::kMarking, this);
   Thread* self = Thread::Current();
   Locks::mutator_lock_->AssertExclusiveHeld(self);
   if (IsConcurrent()) {
@@ -255,6 +257,7 @@ void MarkSweep::RevokeAllThreadLocalAllocationStacks(Thread* self) {
 
 void MarkSweep::MarkingPhase() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  ScopedPhaseTiming phase_timing(GcPhase::kMarking, this);
   Thread* self = Thread::Current();
   BindBitmaps();
   FindDefaultSpaceBitmap();
@@ -337,6 +340,7 @@ void MarkSweep::MarkReachableObjects() {
 
 void MarkSweep::ReclaimPhase() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  ScopedPhaseTiming phase_timing(GcPhase::kReclaim, this);
   Thread* const self = Thread::Current();
   // Process the references concurrently.
   ProcessReferences(self);
@@ -629,6 +633,7 @@ void MarkSweep::VerifySuspendedThreadRoots(std::ostream& os) {
 
 void MarkSweep::MarkRoots(Thread* self) {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  ScopedPhaseTiming phase_timing(GcPhase::kRootVisiting, this);
   if (Locks::mutator_lock_->IsExclusiveHeld(self)) {
     // If we exclusively hold the mutator lock, all threads must be suspended.
     Runtime::Current()->VisitRoots(this);
@@ -1087,6 +1092,7 @@ void MarkSweep::RecursiveMarkDirtyObjects(bool paused, uint8_t minimum_age) {
 
 void MarkSweep::ReMarkRoots() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  ScopedPhaseTiming phase_timing(GcPhase::kRootVisiting, this);
   Locks::mutator_lock_->AssertExclusiveHeld(Thread::Current());
   Runtime::Current()->VisitRoots(this, static_cast<VisitRootFlags>(
       kVisitRootFlagNewRoots | kVisitRootFlagStopLoggingNewRoots | kVisitRootFlagClearRootLog));
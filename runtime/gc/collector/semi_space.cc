@@ -144,6 +144,7 @@ void SemiSpace::InitializePhase() {
 }
 
 void SemiSpace::ProcessReferences(Thread* self) {
+  ScopedPhaseTiming phase_timing(GcPhase::kReferenceProcessing, this);
   WriterMutexLock mu(self, *Locks::heap_bitmap_lock_);
   ReferenceProcessor* rp = GetHeap()->GetReferenceProcessor();
   rp->Setup(self, this, /*concurrent=*/false, GetCurrentIteration()->GetClearSoftReferences());
@@ -152,6 +153,7 @@ void SemiSpace::ProcessReferences(Thread* self) {
 
 void SemiSpace::MarkingPhase() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  ScopedPhaseTiming phase_timing(GcPhase::kMarking, this);
   CHECK(Locks::mutator_lock_->IsExclusiveHeld(self_));
   if (kStoreStackTraces) {
     Locks::mutator_lock_->AssertExclusiveHeld(self_);
@@ -209,6 +211,7 @@ void SemiSpace::MarkingPhase() {
   const int64_t to_bytes = bytes_moved_;
   const uint64_t from_objects = from_space_->GetObjectsAllocated();
   const uint64_t to_objects = objects_moved_;
+  GetCurrentIteration()->SetMovedBytes(to_bytes);
   // Note: Freed bytes can be negative if we copy form a compacted space to a free-list backed
   // space.
   RecordFree(ObjectBytePair(from_objects - to_objects, from_bytes - to_bytes));
@@ -343,6 +346,7 @@ void SemiSpace::MarkReachableObjects() {
 
 void SemiSpace::ReclaimPhase() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  ScopedPhaseTiming phase_timing(GcPhase::kReclaim, this);
   WriterMutexLock mu(self_, *Locks::heap_bitmap_lock_);
   // Reclaim unmarked objects.
   Sweep(false);
@@ -496,6 +500,7 @@ void SemiSpace::VisitRoots(mirror::CompressedReference<mirror::Object>** roots,
 // Marks all objects in the root set.
 void SemiSpace::MarkRoots() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  ScopedPhaseTiming phase_timing(GcPhase::kRootVisiting, this);
   Runtime::Current()->VisitRoots(this);
 }
 
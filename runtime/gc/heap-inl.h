@@ -24,6 +24,8 @@
 #include "base/time_utils.h"
 #include "gc/accounting/atomic_stack.h"
 #include "gc/accounting/card_table-inl.h"
+#include "gc/allocation_histogram.h"
+#include "gc/allocation_site_sampler.h"
 #include "gc/allocation_record.h"
 #include "gc/collector/semi_space.h"
 #include "gc/space/bump_pointer_space-inl.h"
@@ -82,6 +84,7 @@ inline mirror::Object* Heap::AllocObjectWithAllocator(Thread* self,
   size_t usable_size;
   size_t new_num_bytes_allocated = 0;
   bool need_gc = false;
+  bool sampled = false;
   uint32_t starting_gc_num;  // o.w. GC number at which we observed need for GC.
   {
     // Bytes allocated that includes bulk thread-local buffer allocations in addition to direct
@@ -215,6 +218,15 @@ inline mirror::Object* Heap::AllocObjectWithAllocator(Thread* self,
       }
       GetMetrics()->TotalBytesAllocated()->Add(bytes_tl_bulk_allocated);
       GetMetrics()->TotalBytesAllocatedDelta()->Add(bytes_tl_bulk_allocated);
+      // Allocations that took a new thread-local buffer, or were made outside of one, are
+      // samples standing for the bytes handed out.
+      allocation_histogram_->RecordSample(
+          self, klass, byte_count, bytes_tl_bulk_allocated, GetCurrentGcNum());
+      // The heap sampler only samples allocations that took this path.
+      sampled = heap_sampler_.TakePendingSample();
+      if (UNLIKELY(allocation_site_sampler_->IsEnabled())) {
+        allocation_site_sampler_->MaybeRecordSample(self, obj);
+      }
     }
   }
   if (kIsDebugBuild && Runtime::Current()->IsStarted()) {
@@ -252,6 +264,9 @@ inline mirror::Object* Heap::AllocObjectWithAllocator(Thread* self,
   if (AllocatorHasAllocationStack(allocator)) {
     PushOnAllocationStack(self, &obj);
   }
+  if (UNLIKELY(sampled)) {
+    heap_sampler_.DispatchSample(self, &obj, bytes_allocated);
+  }
   if (kInstrumented) {
     if (gc_stress_mode_) {
       CheckGcStressMode(self, &obj);
@@ -293,7 +308,7 @@ inline mirror::Object* Heap::AllocLargeObject(Thread* self,
                         (self, *klass, byte_count, kAllocatorTypeLOS, pre_fence_visitor);
   // Java Heap Profiler check and sample allocation.
   JHPCheckNonTlabSampleAllocation(self, obj, byte_count);
-  return obj;
+  return JHPDispatchPendingSample(self, obj, byte_count);
 }
 
 template <const bool kInstrumented, const bool kGrow>
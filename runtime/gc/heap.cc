@@ -25,6 +25,7 @@
 #include <random>
 #include <unistd.h>
 #include <sys/types.h>
+#include <unordered_map>
 #include <vector>
 
 #include "android-base/stringprintf.h"
@@ -45,6 +46,7 @@
 #include "base/systrace.h"
 #include "base/time_utils.h"
 #include "base/utils.h"
+#include "class_linker.h"
 #include "class_root-inl.h"
 #include "common_throws.h"
 #include "debugger.h"
@@ -56,6 +58,8 @@
 #include "gc/accounting/read_barrier_table.h"
 #include "gc/accounting/remembered_set.h"
 #include "gc/accounting/space_bitmap-inl.h"
+#include "gc/allocation_histogram.h"
+#include "gc/allocation_site_sampler.h"
 #include "gc/collector/concurrent_copying.h"
 #include "gc/collector/mark_compact.h"
 #include "gc/collector/mark_sweep.h"
@@ -93,6 +97,7 @@
 #include "mirror/object-refvisitor-inl.h"
 #include "mirror/object_array-inl.h"
 #include "mirror/reference-inl.h"
+#include "mirror/string-inl.h"
 #include "mirror/var_handle.h"
 #include "nativehelper/scoped_local_ref.h"
 #include "obj_ptr-inl.h"
@@ -256,6 +261,20 @@ static void VerifyBootImagesContiguity(const std::vector<gc::space::ImageSpace*>
   }
 }
 
+// Best effort: back a moving space with transparent huge pages, so that the GC walking it and
+// the mutators allocating into it take fewer TLB misses. The spaces start at 2MB aligned
+// addresses in the default layout, so little of them is left to small pages.
+static void AdviseHugePages(space::ContinuousMemMapAllocSpace* space) {
+#ifdef MADV_HUGEPAGE
+  MemMap* mem_map = space->GetMemMap();
+  if (madvise(mem_map->BaseBegin(), mem_map->BaseSize(), MADV_HUGEPAGE) != 0) {
+    PLOG(WARNING) << "Failed to enable huge pages for " << space->GetName();
+  }
+#else
+  UNUSED(space);
+#endif
+}
+
 Heap::Heap(size_t initial_size,
            size_t growth_limit,
            size_t min_free,
@@ -285,6 +304,8 @@ Heap::Heap(size_t initial_size,
            bool ignore_target_footprint,
            bool always_log_explicit_gcs,
            bool use_tlab,
+           bool use_huge_pages,
+           bool async_native_allocation_checks,
            bool verify_pre_gc_heap,
            bool verify_pre_sweeping_heap,
            bool verify_post_gc_heap,
@@ -295,9 +316,11 @@ Heap::Heap(size_t initial_size,
            bool measure_gc_performance,
            bool use_homogeneous_space_compaction_for_oom,
            bool use_generational_cc,
+           bool use_generational_cmc,
            uint64_t min_interval_homogeneous_space_compaction_by_oom,
            bool dump_region_info_before_gc,
-           bool dump_region_info_after_gc)
+           bool dump_region_info_after_gc,
+           bool dump_duplicate_strings_after_gc)
     : non_moving_space_(nullptr),
       rosalloc_space_(nullptr),
       dlmalloc_space_(nullptr),
@@ -345,6 +368,8 @@ Heap::Heap(size_t initial_size,
       native_bytes_registered_(0),
       old_native_bytes_allocated_(0),
       native_objects_notified_(0),
+      native_allocation_check_pending_(false),
+      native_allocation_throttled_(false),
       num_bytes_freed_revoke_(0),
       num_bytes_alive_after_gc_(0),
       verify_missing_card_marks_(false),
@@ -384,6 +409,7 @@ Heap::Heap(size_t initial_size,
       concurrent_copying_collector_(nullptr),
       is_running_on_memory_tool_(Runtime::Current()->IsRunningOnMemoryTool()),
       use_tlab_(use_tlab),
+      async_native_allocation_checks_(async_native_allocation_checks),
       main_space_backup_(nullptr),
       min_interval_homogeneous_space_compaction_by_oom_(
           min_interval_homogeneous_space_compaction_by_oom),
@@ -394,6 +420,7 @@ Heap::Heap(size_t initial_size,
       pending_heap_trim_(nullptr),
       use_homogeneous_space_compaction_for_oom_(use_homogeneous_space_compaction_for_oom),
       use_generational_cc_(use_generational_cc),
+      use_generational_cmc_(use_generational_cmc),
       running_collection_is_blocking_(false),
       blocking_gc_count_(0U),
       blocking_gc_time_(0U),
@@ -405,6 +432,8 @@ Heap::Heap(size_t initial_size,
       blocking_gc_count_rate_histogram_("blocking gc count rate histogram", 1U,
                                         kGcCountRateMaxBucketCount),
       alloc_tracking_enabled_(false),
+      allocation_histogram_(new AllocationHistogram()),
+      allocation_site_sampler_(new AllocationSiteSampler()),
       alloc_record_depth_(AllocRecordObjectMap::kDefaultAllocStackDepth),
       backtrace_lock_(nullptr),
       seen_backtrace_count_(0u),
@@ -412,6 +441,7 @@ Heap::Heap(size_t initial_size,
       gc_disabled_for_shutdown_(false),
       dump_region_info_before_gc_(dump_region_info_before_gc),
       dump_region_info_after_gc_(dump_region_info_after_gc),
+      dump_duplicate_strings_after_gc_(dump_duplicate_strings_after_gc),
       boot_image_spaces_(),
       boot_images_start_address_(0u),
       boot_images_size_(0u),
@@ -632,6 +662,9 @@ Heap::Heap(size_t initial_size,
     CHECK(region_space_mem_map.IsValid()) << "No region space mem map";
     region_space_ = space::RegionSpace::Create(
         kRegionSpaceName, std::move(region_space_mem_map), use_generational_cc_);
+    if (use_huge_pages) {
+      AdviseHugePages(region_space_);
+    }
     AddSpace(region_space_);
   } else if (IsMovingGc(foreground_collector_type_)) {
     // Create bump pointer spaces.
@@ -640,6 +673,10 @@ Heap::Heap(size_t initial_size,
     bump_pointer_space_ = space::BumpPointerSpace::CreateFromMemMap("Bump pointer space 1",
                                                                     std::move(main_mem_map_1));
     CHECK(bump_pointer_space_ != nullptr) << "Failed to create bump pointer space";
+    // The concurrent mark-compact GC populates its space page by page with userfaultfd.
+    if (use_huge_pages && foreground_collector_type_ != kCollectorTypeCMC) {
+      AdviseHugePages(bump_pointer_space_);
+    }
     AddSpace(bump_pointer_space_);
     // For Concurrent Mark-compact GC we don't need the temp space to be in
     // lower 4GB. So its temp space will be created by the GC itself.
@@ -647,6 +684,9 @@ Heap::Heap(size_t initial_size,
       temp_space_ = space::BumpPointerSpace::CreateFromMemMap("Bump pointer space 2",
                                                               std::move(main_mem_map_2));
       CHECK(temp_space_ != nullptr) << "Failed to create bump pointer space";
+      if (use_huge_pages) {
+        AdviseHugePages(temp_space_);
+      }
       AddSpace(temp_space_);
     }
     CHECK(separate_non_moving_space);
@@ -680,6 +720,10 @@ Heap::Heap(size_t initial_size,
   } else if (large_object_space_type == space::LargeObjectSpaceType::kMap) {
     large_object_space_ = space::LargeObjectMapSpace::Create("mem map large object space");
     CHECK(large_object_space_ != nullptr) << "Failed to create large object space";
+  } else if (large_object_space_type == space::LargeObjectSpaceType::kHugePageMap) {
+    large_object_space_ = space::LargeObjectMapSpace::Create("huge page large object space",
+                                                             /*use_huge_pages=*/ true);
+    CHECK(large_object_space_ != nullptr) << "Failed to create large object space";
   } else {
     // Disable the large object space by making the cutoff excessively large.
     large_object_threshold_ = std::numeric_limits<size_t>::max();
@@ -1116,7 +1160,12 @@ void Heap::CreateThreadPool(size_t num_threads) {
     num_threads = std::max(parallel_gc_threads_, conc_gc_threads_);
   }
   if (num_threads != 0) {
-    thread_pool_.reset(new ThreadPool("Heap thread pool", num_threads));
+    // The parallel marking tasks split off new tasks when their mark stack overflows.
+    thread_pool_.reset(new ThreadPool("Heap thread pool",
+                                      num_threads,
+                                      /*create_peers=*/ false,
+                                      ThreadPoolWorker::kDefaultStackSize,
+                                      /*work_stealing=*/ true));
   }
 }
 
@@ -1546,6 +1595,12 @@ void Heap::DoPendingCollectorTransition() {
                             num_bytes_alive_after_gc_)/4)
         && !kStressCollectorTransition
         && !IsLowMemoryMode()) {
+      // The non-moving space is never compacted, and trims requested while the process was
+      // jank perceptible skipped it. Trim it now that pauses don't matter, so that its free
+      // pages are released for the cached process even without a transition GC.
+      if (!CareAboutPauseTimes()) {
+        RequestTrim(Thread::Current());
+      }
       return;
     }
   }
@@ -1660,6 +1715,12 @@ void Heap::TrimSpaces(Thread* self) {
       }
     }
   }
+  // Live objects of a cached process that weren't evacuated nor written for several GCs are
+  // unlikely to be needed soon. Let the kernel reclaim them before it has to kill the process.
+  uint64_t cold_advised = 0;
+  if (region_space_ != nullptr && !CareAboutPauseTimes()) {
+    cold_advised = region_space_->AdviseColdRegions();
+  }
   total_alloc_space_allocated = GetBytesAllocated();
   if (large_object_space_ != nullptr) {
     total_alloc_space_allocated -= large_object_space_->GetBytesAllocated();
@@ -1677,7 +1738,8 @@ void Heap::TrimSpaces(Thread* self) {
   FinishGC(self, collector::kGcTypeNone);
 
   VLOG(heap) << "Heap trim of managed (duration=" << PrettyDuration(gc_heap_end_ns - start_ns)
-      << ", advised=" << PrettySize(managed_reclaimed) << ") heap. Managed heap utilization of "
+      << ", advised=" << PrettySize(managed_reclaimed)
+      << ", cold=" << PrettySize(cold_advised) << ") heap. Managed heap utilization of "
       << static_cast<int>(100 * managed_utilization) << "%.";
 }
 
@@ -2074,6 +2136,73 @@ size_t Heap::GetObjectsAllocated() const {
   return total;
 }
 
+void Heap::DumpDuplicateStrings(std::ostream& os) {
+  struct ContentHash {
+    size_t operator()(mirror::String* str) const NO_THREAD_SAFETY_ANALYSIS {
+      return static_cast<size_t>(str->ComputeHashCode());
+    }
+  };
+  struct ContentEquals {
+    bool operator()(mirror::String* lhs, mirror::String* rhs) const NO_THREAD_SAFETY_ANALYSIS {
+      return lhs->Equals(rhs);
+    }
+  };
+  struct Copies {
+    size_t count = 0u;
+    size_t bytes = 0u;
+  };
+  static constexpr size_t kMaxDumpedValues = 10u;
+  static constexpr size_t kMaxDumpedLength = 60u;
+
+  Thread* const self = Thread::Current();
+  ScopedThreadStateChange tsc(self, ThreadState::kWaitingForGetObjectsAllocated);
+  gc::ScopedGCCriticalSection gcs(self, gc::kGcCauseDebugger, gc::kCollectorTypeDebugger);
+  ScopedSuspendAll ssa(__FUNCTION__);
+  // The first string seen for each value, with the copies seen after it.
+  std::unordered_map<mirror::String*, Copies, ContentHash, ContentEquals> strings;
+  size_t num_strings = 0u;
+  size_t num_copies = 0u;
+  size_t copy_bytes = 0u;
+  VisitObjectsPaused([&](mirror::Object* obj) NO_THREAD_SAFETY_ANALYSIS {
+    if (!obj->IsString()) {
+      return;
+    }
+    mirror::String* str = obj->AsString().Ptr();
+    ++num_strings;
+    auto [it, inserted] = strings.try_emplace(str);
+    if (!inserted) {
+      size_t bytes = str->SizeOf();
+      ++it->second.count;
+      it->second.bytes += bytes;
+      ++num_copies;
+      copy_bytes += bytes;
+    }
+  });
+  std::vector<std::pair<mirror::String*, Copies>> values;
+  for (const auto& [str, copies] : strings) {
+    if (copies.count != 0u) {
+      values.emplace_back(str, copies);
+    }
+  }
+  size_t num_dumped = std::min(values.size(), kMaxDumpedValues);
+  std::partial_sort(values.begin(),
+                    values.begin() + num_dumped,
+                    values.end(),
+                    [](const auto& lhs, const auto& rhs) {
+                      return lhs.second.bytes > rhs.second.bytes;
+                    });
+  os << "Duplicate strings: " << num_copies << " of " << num_strings << " strings, "
+     << PrettySize(copy_bytes) << " in " << values.size() << " values\n";
+  for (size_t i = 0; i != num_dumped; ++i) {
+    std::string value = values[i].first->ToModifiedUtf8();
+    if (value.length() > kMaxDumpedLength) {
+      value = value.substr(0, kMaxDumpedLength) + "...";
+    }
+    os << "  \"" << value << "\": " << values[i].second.count << " copies, "
+       << PrettySize(values[i].second.bytes) << "\n";
+  }
+}
+
 uint64_t Heap::GetBytesAllocatedEver() const {
   // Force the returned value to be monotonically increasing, in the sense that if this is called
   // at A and B, such that A happens-before B, then the call at B returns a value no smaller than
@@ -2244,6 +2373,9 @@ void Heap::ChangeCollector(CollectorType collector_type) {
         break;
       }
       case kCollectorTypeCMC: {
+        if (use_generational_cmc_) {
+          gc_plan_.push_back(collector::kGcTypeSticky);
+        }
         gc_plan_.push_back(collector::kGcTypeFull);
         if (use_tlab_) {
           ChangeAllocator(kAllocatorTypeTLAB);
@@ -2287,11 +2419,18 @@ void Heap::ChangeCollector(CollectorType collector_type) {
 // Special compacting collector which uses sub-optimal bin packing to reduce zygote space size.
 class ZygoteCompactingCollector final : public collector::SemiSpace {
  public:
-  ZygoteCompactingCollector(gc::Heap* heap, bool is_running_on_memory_tool)
+  // If `dirty_classes` is not empty, only the instances of these classes are moved into the
+  // bins, see MarkNonForwardedObject().
+  ZygoteCompactingCollector(gc::Heap* heap,
+                            bool is_running_on_memory_tool,
+                            const std::unordered_set<const mirror::Class*>& dirty_classes)
       : SemiSpace(heap, "zygote collector"),
         bin_live_bitmap_(nullptr),
         bin_mark_bitmap_(nullptr),
-        is_running_on_memory_tool_(is_running_on_memory_tool) {}
+        is_running_on_memory_tool_(is_running_on_memory_tool),
+        dirty_classes_(dirty_classes),
+        dirty_bytes_in_bins_(0u),
+        dirty_bytes_in_target_space_(0u) {}
 
   void BuildBins(space::ContinuousSpace* space) REQUIRES_SHARED(Locks::mutator_lock_) {
     bin_live_bitmap_ = space->GetLiveBitmap();
@@ -2311,6 +2450,17 @@ class ZygoteCompactingCollector final : public collector::SemiSpace {
     AddBin(reinterpret_cast<uintptr_t>(space->End()) - prev, prev);
   }
 
+  void LogPlacement() const {
+    size_t free_bin_bytes = 0u;
+    for (const auto& bin : bins_) {
+      free_bin_bytes += bin.first;
+    }
+    VLOG(heap) << "Zygote compaction moved " << PrettySize(dirty_bytes_in_bins_)
+               << " of likely dirty objects into bins and "
+               << PrettySize(dirty_bytes_in_target_space_) << " into the zygote bump space, "
+               << PrettySize(free_bin_bytes) << " of bins left free";
+  }
+
  private:
   // Maps from bin sizes to locations.
   std::multimap<size_t, uintptr_t> bins_;
@@ -2319,6 +2469,9 @@ class ZygoteCompactingCollector final : public collector::SemiSpace {
   // Mark bitmap of the space which contains the bins.
   accounting::ContinuousSpaceBitmap* bin_mark_bitmap_;
   const bool is_running_on_memory_tool_;
+  const std::unordered_set<const mirror::Class*>& dirty_classes_;
+  size_t dirty_bytes_in_bins_;
+  size_t dirty_bytes_in_target_space_;
 
   void AddBin(size_t size, uintptr_t position) {
     if (is_running_on_memory_tool_) {
@@ -2340,8 +2493,18 @@ class ZygoteCompactingCollector final : public collector::SemiSpace {
     size_t obj_size = obj->SizeOf<kDefaultVerifyFlags>();
     size_t alloc_size = RoundUp(obj_size, kObjectAlignment);
     mirror::Object* forward_address;
+    // The bins are between the non-moving objects, such as the classes, whose pages the children
+    // of the zygote are likely to write anyway. Without a profile of the dirty classes, fill the
+    // bins with any objects to avoid leaving holes in the zygote space. With a profile, keep the
+    // other objects together in the target space where their pages are more likely to stay clean.
+    bool is_dirty = !dirty_classes_.empty() &&
+        dirty_classes_.find(obj->GetClass<kVerifyNone, kWithoutReadBarrier>().Ptr()) !=
+            dirty_classes_.end();
     // Find the smallest bin which we can move obj in.
-    auto it = bins_.lower_bound(alloc_size);
+    auto it = (dirty_classes_.empty() || is_dirty) ? bins_.lower_bound(alloc_size) : bins_.end();
+    if (is_dirty) {
+      (it == bins_.end() ? dirty_bytes_in_target_space_ : dirty_bytes_in_bins_) += alloc_size;
+    }
     if (it == bins_.end()) {
       // No available space in the bins, place it in the target space instead (grows the zygote
       // space).
@@ -2422,6 +2585,23 @@ void Heap::PreZygoteFork() {
   // We need to close userfaultfd fd for app/webview zygotes to avoid getattr
   // (stat) on the fd during fork.
   Thread* self = Thread::Current();
+  // Look up the dirty classes before taking the zygote creation lock. Classes do not move, so
+  // the zygote compaction can compare the class pointers of the objects with this set.
+  std::unordered_set<const mirror::Class*> dirty_classes;
+  if (kCompactZygote && !HasZygoteSpace() && !zygote_dirty_class_descriptors_.empty()) {
+    ScopedObjectAccess soa(self);
+    ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+    std::vector<ObjPtr<mirror::Class>> classes;
+    for (const std::string& descriptor : zygote_dirty_class_descriptors_) {
+      classes.clear();
+      class_linker->LookupClasses(descriptor.c_str(), classes);
+      for (ObjPtr<mirror::Class> klass : classes) {
+        dirty_classes.insert(klass.Ptr());
+      }
+    }
+    VLOG(heap) << "Found " << dirty_classes.size() << " zygote dirty classes for "
+               << zygote_dirty_class_descriptors_.size() << " descriptors";
+  }
   MutexLock mu(self, zygote_creation_lock_);
   // Try to see if we have any Zygote spaces.
   if (HasZygoteSpace()) {
@@ -2440,7 +2620,7 @@ void Heap::PreZygoteFork() {
     // Temporarily disable rosalloc verification because the zygote
     // compaction will mess up the rosalloc internal metadata.
     ScopedDisableRosAllocVerification disable_rosalloc_verif(this);
-    ZygoteCompactingCollector zygote_collector(this, is_running_on_memory_tool_);
+    ZygoteCompactingCollector zygote_collector(this, is_running_on_memory_tool_, dirty_classes);
     zygote_collector.BuildBins(non_moving_space_);
     // Create a new bump pointer space which we will compact into.
     space::BumpPointerSpace target_space("zygote bump space", non_moving_space_->End(),
@@ -2464,6 +2644,7 @@ void Heap::PreZygoteFork() {
     zygote_collector.SetToSpace(&target_space);
     zygote_collector.SetSwapSemiSpaces(false);
     zygote_collector.Run(kGcCauseCollectorTransition, false);
+    zygote_collector.LogPlacement();
     if (reset_main_space) {
       main_space_->GetMemMap()->Protect(PROT_READ | PROT_WRITE);
       madvise(main_space_->Begin(), main_space_->Capacity(), MADV_DONTNEED);
@@ -2483,6 +2664,10 @@ void Heap::PreZygoteFork() {
         region_space_->GetMarkBitmap()->Clear();
       } else {
         bump_pointer_space_->GetMemMap()->Protect(PROT_READ | PROT_WRITE);
+        if (mark_compact_ != nullptr) {
+          // Evacuated everything out of the moving space, forget the old generation.
+          mark_compact_->ResetGenerations();
+        }
       }
     }
     if (temp_space_ != nullptr) {
@@ -2762,6 +2947,7 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
         collector = semi_space_collector_;
         break;
       case kCollectorTypeCMC:
+        mark_compact_->SetYoungGen(gc_type == collector::kGcTypeSticky);
         collector = mark_compact_;
         break;
       case kCollectorTypeCC:
@@ -2802,8 +2988,13 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
   CHECK(collector != nullptr)
       << "Could not find garbage collector with collector_type="
       << static_cast<size_t>(collector_type_) << " and gc_type=" << gc_type;
+  if (allocation_site_sampler_->IsEnabled()) {
+    allocation_site_sampler_->StartGc();
+  }
   collector->Run(gc_cause, clear_soft_references || runtime->IsZygote());
   IncrementFreedEver();
+  // Other threads merge their samples of this cycle on their next sample.
+  allocation_histogram_->FlushThread(self);
   RequestTrim(self);
   // Collect cleared references.
   SelfDeletingTask* clear = reference_processor_->CollectClearedReferences(self);
@@ -2812,6 +3003,9 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
   old_native_bytes_allocated_.store(GetNativeBytes());
   LogGC(gc_cause, collector);
   FinishGC(self, gc_type);
+  if (UNLIKELY(dump_duplicate_strings_after_gc_)) {
+    DumpDuplicateStrings(LOG_STREAM(INFO));
+  }
   // Actually enqueue all cleared references. Do this after the GC has officially finished since
   // otherwise we can deadlock.
   clear->Run(self);
@@ -3701,13 +3895,19 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
     collector::GcType non_sticky_gc_type = NonStickyGcType();
     // Find what the next non sticky collector will be.
     collector::GarbageCollector* non_sticky_collector = FindCollectorByGcType(non_sticky_gc_type);
-    if (use_generational_cc_) {
+    if (collector_type_ == kCollectorTypeCMC) {
+      // The same collector performs both the young and the full collections,
+      // so its mean throughput is a mix of the two.
+      non_sticky_collector = mark_compact_;
+    } else if (use_generational_cc_) {
       if (non_sticky_collector == nullptr) {
         non_sticky_collector = FindCollectorByGcType(collector::kGcTypePartial);
       }
       CHECK(non_sticky_collector != nullptr);
     }
-    double sticky_gc_throughput_adjustment = GetStickyGcThroughputAdjustment(use_generational_cc_);
+    double sticky_gc_throughput_adjustment =
+        (collector_type_ == kCollectorTypeCMC) ? 1.0
+                                               : GetStickyGcThroughputAdjustment(use_generational_cc_);
 
     // If the throughput of the current sticky GC >= throughput of the non sticky collector, then
     // do another sticky collection next.
@@ -4117,6 +4317,12 @@ inline float Heap::NativeMemoryOverTarget(size_t current_native_bytes, bool is_g
 
 inline void Heap::CheckGCForNative(Thread* self) {
   bool is_gc_concurrent = IsGcConcurrent();
+  if (async_native_allocation_checks_ &&
+      is_gc_concurrent &&
+      !native_allocation_throttled_.load(std::memory_order_relaxed) &&
+      RequestNativeAllocationCheck(self)) {
+    return;
+  }
   uint32_t starting_gc_num = GetCurrentGcNum();
   size_t current_native_bytes = GetNativeBytes();
   float gc_urgency = NativeMemoryOverTarget(current_native_bytes, is_gc_concurrent);
@@ -4152,6 +4358,47 @@ inline void Heap::CheckGCForNative(Thread* self) {
   }
 }
 
+class Heap::NativeAllocationCheckTask : public HeapTask {
+ public:
+  explicit NativeAllocationCheckTask(uint64_t target_time) : HeapTask(target_time) {}
+  void Run(Thread* self) override {
+    Runtime::Current()->GetHeap()->CheckGCForNativeInBackground(self);
+  }
+};
+
+bool Heap::RequestNativeAllocationCheck(Thread* self) {
+  if (native_allocation_check_pending_.load(std::memory_order_relaxed)) {
+    return true;  // The pending task will see this allocation.
+  }
+  if (!CanAddHeapTask(self)) {
+    return false;
+  }
+  bool expected = false;
+  if (native_allocation_check_pending_.CompareAndSetStrongRelaxed(expected, true)) {
+    task_processor_->AddTask(self, new NativeAllocationCheckTask(NanoTime()));
+  }
+  return true;
+}
+
+void Heap::CheckGCForNativeInBackground(Thread* self) {
+  // Clear the flag first, so that allocations made during the check post a new task.
+  native_allocation_check_pending_.store(false, std::memory_order_relaxed);
+  uint32_t starting_gc_num = GetCurrentGcNum();
+  size_t current_native_bytes = GetNativeBytes();
+  float gc_urgency = NativeMemoryOverTarget(current_native_bytes, /*is_gc_concurrent=*/ true);
+  bool throttle = false;
+  if (UNLIKELY(gc_urgency >= 1.0)) {
+    bool requested =
+        RequestConcurrentGC(self, kGcCauseForNativeAlloc, /*force_full=*/true, starting_gc_num);
+    // This thread runs the GC, so it cannot wait for it. CheckGCForNative() makes the
+    // allocating threads wait instead, as in the synchronous mode.
+    throttle = requested &&
+               gc_urgency > kStopForNativeFactor &&
+               current_native_bytes > stop_for_native_allocs_;
+  }
+  native_allocation_throttled_.store(throttle, std::memory_order_relaxed);
+}
+
 // About kNotifyNativeInterval allocations have occurred. Check whether we should garbage collect.
 void Heap::NotifyNativeAllocations(JNIEnv* env) {
   native_objects_notified_.fetch_add(kNotifyNativeInterval, std::memory_order_relaxed);
@@ -4267,6 +4514,20 @@ void Heap::SweepAllocationRecords(IsMarkedVisitor* visitor) const {
   }
 }
 
+void Heap::SweepAllocationSiteSamples(IsMarkedVisitor* visitor) const {
+  if (allocation_site_sampler_->IsEnabled()) {
+    allocation_site_sampler_->Sweep(visitor);
+  }
+}
+
+AllocatorType Heap::GetPretenureAllocator() const {
+  if (non_moving_space_ != nullptr &&
+      non_moving_space_->Size() <= non_moving_space_->Capacity() / 2u) {
+    return GetCurrentNonMovingAllocator();
+  }
+  return GetCurrentAllocator();
+}
+
 void Heap::AllowNewAllocationRecords() const {
   CHECK(!gUseReadBarrier);
   MutexLock mu(Thread::Current(), *Locks::alloc_tracker_lock_);
@@ -4350,6 +4611,17 @@ void Heap::JHPCheckNonTlabSampleAllocation(Thread* self, mirror::Object* obj, si
   }
 }
 
+mirror::Object* Heap::JHPDispatchPendingSample(Thread* self,
+                                               mirror::Object* obj,
+                                               size_t alloc_size) {
+  if (obj != nullptr && UNLIKELY(GetHeapSampler().TakePendingSample())) {
+    ObjPtr<mirror::Object> sampled_obj(obj);
+    GetHeapSampler().DispatchSample(self, &sampled_obj, alloc_size);
+    obj = sampled_obj.Ptr();
+  }
+  return obj;
+}
+
 size_t Heap::JHPCalculateNextTlabSize(Thread* self,
                                       size_t jhp_def_tlab_size,
                                       size_t alloc_size,
@@ -4371,6 +4643,23 @@ void Heap::AdjustSampleOffset(size_t adjustment) {
   GetHeapSampler().AdjustSampleOffset(adjustment);
 }
 
+size_t Heap::GetAdaptiveTlabSize(Thread* self, size_t default_size) {
+  const uint32_t gc_num = GetCurrentGcNum();
+  const uint32_t refill_gc_num = self->GetTlabRefillGcNum();
+  if (refill_gc_num != gc_num) {
+    if (self->GetAdaptiveTlabSize() != 0 || self->GetTlabRefillBytes() != 0) {
+      // Average over all the GCs since the last adaptation, so that threads
+      // which were idle through several GCs shrink their TLABs accordingly.
+      const size_t bytes_per_gc = self->GetTlabRefillBytes() / (gc_num - refill_gc_num);
+      const size_t size = RoundUpToPowerOfTwo(bytes_per_gc / kTargetTlabRefillsPerGc);
+      self->SetAdaptiveTlabSize(std::clamp(size, kMinAdaptiveTlabSize, kMaxAdaptiveTlabSize));
+    }
+    self->ResetTlabRefillStats(gc_num);
+  }
+  const size_t size = self->GetAdaptiveTlabSize();
+  return size != 0 ? size : default_size;
+}
+
 void Heap::CheckGcStressMode(Thread* self, ObjPtr<mirror::Object>* obj) {
   DCHECK(gc_stress_mode_);
   auto* const runtime = Runtime::Current();
@@ -4470,7 +4759,7 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
     // TLAB bytes.
     const size_t min_expand_size = alloc_size - self->TlabSize();
     size_t next_tlab_size = JHPCalculateNextTlabSize(self,
-                                                     kPartialTlabSize,
+                                                     GetAdaptiveTlabSize(self, kPartialTlabSize),
                                                      alloc_size,
                                                      &take_sample,
                                                      &bytes_until_sample);
@@ -4482,6 +4771,7 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
     }
     *bytes_tl_bulk_allocated = expand_bytes;
     self->ExpandTlab(expand_bytes);
+    self->AddTlabRefillBytes(expand_bytes);
     DCHECK_LE(alloc_size, self->TlabSize());
   } else if (allocator_type == kAllocatorTypeTLAB) {
     DCHECK(bump_pointer_space_ != nullptr);
@@ -4489,7 +4779,9 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
     // TODO: for large allocations, which are rare, maybe we should allocate
     // that object and return. There is no need to revoke the current TLAB,
     // particularly if it's mostly unutilized.
-    size_t def_pr_tlab_size = RoundDown(alloc_size + kDefaultTLABSize, kPageSize) - alloc_size;
+    size_t def_pr_tlab_size =
+        RoundDown(alloc_size + GetAdaptiveTlabSize(self, kDefaultTLABSize), kPageSize) -
+        alloc_size;
     size_t next_tlab_size = JHPCalculateNextTlabSize(self,
                                                      def_pr_tlab_size,
                                                      alloc_size,
@@ -4505,6 +4797,7 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
       return nullptr;
     }
     *bytes_tl_bulk_allocated = new_tlab_size;
+    self->AddTlabRefillBytes(new_tlab_size);
     if (CheckPerfettoJHPEnabled()) {
       VLOG(heap) << "JHP:kAllocatorTypeTLAB, New Tlab bytes allocated= " << new_tlab_size;
     }
@@ -4517,7 +4810,7 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
                                             space::RegionSpace::kRegionSize,
                                             grow))) {
         size_t def_pr_tlab_size = kUsePartialTlabs
-                                      ? kPartialTlabSize
+                                      ? GetAdaptiveTlabSize(self, kPartialTlabSize)
                                       : gc::space::RegionSpace::kRegionSize;
         size_t next_pr_tlab_size = JHPCalculateNextTlabSize(self,
                                                             def_pr_tlab_size,
@@ -4537,6 +4830,7 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
           JHPCheckNonTlabSampleAllocation(self, ret, alloc_size);
           return ret;
         }
+        self->AddTlabRefillBytes(*bytes_tl_bulk_allocated);
         // Fall-through to using the TLAB below.
       } else {
         // Check OOME for a non-tlab allocation.
@@ -67,6 +67,8 @@ class Object;
 
 namespace gc {
 
+class AllocationHistogram;
+class AllocationSiteSampler;
 class AllocationListener;
 class AllocRecordObjectMap;
 class GcPauseListener;
@@ -145,6 +147,11 @@ class Heap {
   static constexpr size_t kDefaultLongGCLogThreshold = MsToNs(100);
   static constexpr size_t kDefaultLongGCLogThresholdGcStress = MsToNs(1000);
   static constexpr size_t kDefaultTLABSize = 32 * KB;
+  // Bounds of the TLAB sizes adapted to the allocation rate of each thread.
+  static constexpr size_t kMinAdaptiveTlabSize = 4 * KB;
+  static constexpr size_t kMaxAdaptiveTlabSize = 256 * KB;
+  // Adaptive TLAB sizes are chosen for about this many refills between two GCs.
+  static constexpr size_t kTargetTlabRefillsPerGc = 16;
   static constexpr double kDefaultTargetUtilization = 0.6;
   static constexpr double kDefaultHeapGrowthMultiplier = 2.0;
   // Primitive arrays larger than this size are put in the large object space.
@@ -218,6 +225,8 @@ class Heap {
        bool ignore_target_footprint,
        bool always_log_explicit_gcs,
        bool use_tlab,
+       bool use_huge_pages,
+       bool async_native_allocation_checks,
        bool verify_pre_gc_heap,
        bool verify_pre_sweeping_heap,
        bool verify_post_gc_heap,
@@ -228,9 +237,11 @@ class Heap {
        bool measure_gc_performance,
        bool use_homogeneous_space_compaction,
        bool use_generational_cc,
+       bool use_generational_cmc,
        uint64_t min_interval_homogeneous_space_compaction_by_oom,
        bool dump_region_info_before_gc,
-       bool dump_region_info_after_gc);
+       bool dump_region_info_after_gc,
+       bool dump_duplicate_strings_after_gc);
 
   ~Heap();
 
@@ -271,7 +282,7 @@ class Heap {
                                                                   pre_fence_visitor);
     // Java Heap Profiler check and sample allocation.
     JHPCheckNonTlabSampleAllocation(self, obj, num_bytes);
-    return obj;
+    return JHPDispatchPendingSample(self, obj, num_bytes);
   }
 
   template <bool kInstrumented = true, bool kCheckLargeObject = true, typename PreFenceVisitor>
@@ -554,6 +565,10 @@ class Heap {
     return use_generational_cc_;
   }
 
+  bool GetUseGenerationalCMC() const {
+    return use_generational_cmc_;
+  }
+
   // Returns the number of objects currently allocated.
   size_t GetObjectsAllocated() const
       REQUIRES(!Locks::heap_bitmap_lock_);
@@ -663,6 +678,13 @@ class Heap {
 
   void PreZygoteFork() NO_THREAD_SAFETY_ANALYSIS;
 
+  // Set the descriptors of the classes whose instances are likely to be written by the children
+  // of the zygote. The zygote compaction keeps these instances apart from the other objects, so
+  // that more pages of the zygote space stay clean and shared after fork.
+  void SetZygoteDirtyClasses(std::vector<std::string>&& descriptors) {
+    zygote_dirty_class_descriptors_ = std::move(descriptors);
+  }
+
   // Mark and empty stack.
   void FlushAllocStack()
       REQUIRES_SHARED(Locks::mutator_lock_)
@@ -760,6 +782,13 @@ class Heap {
       REQUIRES(!*gc_complete_lock_);
   void ResetGcPerformanceInfo() REQUIRES(!*gc_complete_lock_);
 
+  // Dump the number and size of the live strings that are equal to another live string, and the
+  // values with the most bytes in copies. ART strings store their characters inline and string
+  // identity is observable, so the copies cannot be merged by the GC; interning the reported
+  // values in the app can. Suspends all threads while walking the heap.
+  void DumpDuplicateStrings(std::ostream& os)
+      REQUIRES(!Locks::mutator_lock_, !*gc_complete_lock_, !Locks::heap_bitmap_lock_);
+
   // Thread pool. Create either the given number of threads, or as per the
   // values of conc_gc_threads_ and parallel_gc_threads_.
   void CreateThreadPool(size_t num_threads = 0);
@@ -896,6 +925,10 @@ class Heap {
   void JHPCheckNonTlabSampleAllocation(Thread* self,
                                        mirror::Object* ret,
                                        size_t alloc_size);
+  // Send the sample that JHPCheckNonTlabSampleAllocation took of the complete allocation `obj`
+  // to the heap sampler's listener, if any. Returns `obj`, which may have moved.
+  mirror::Object* JHPDispatchPendingSample(Thread* self, mirror::Object* obj, size_t alloc_size)
+      REQUIRES_SHARED(Locks::mutator_lock_);
   // In Tlab case: Calculate the next tlab size (location of next sample point) and whether
   // a sample should be taken.
   size_t JHPCalculateNextTlabSize(Thread* self,
@@ -905,6 +938,12 @@ class Heap {
                                   size_t* bytes_until_sample);
   // Reduce the number of bytes to the next sample position by this adjustment.
   void AdjustSampleOffset(size_t adjustment);
+  // Returns the size of the next TLAB (or TLAB expansion) for `self`, based on
+  // how many TLAB bytes it used per GC since its size was last adapted. Threads
+  // that allocate little get smaller TLABs and waste less, while allocation-heavy
+  // threads get bigger ones and refill less often. Returns `default_size` until
+  // the thread has been through a GC.
+  size_t GetAdaptiveTlabSize(Thread* self, size_t default_size);
 
   // Allocation tracking support
   // Callers to this function use double-checked locking to ensure safety on allocation_records_
@@ -930,6 +969,18 @@ class Heap {
     return allocation_records_.get();
   }
 
+  AllocationHistogram* GetAllocationHistogram() const {
+    return allocation_histogram_.get();
+  }
+
+  AllocationSiteSampler* GetAllocationSiteSampler() const {
+    return allocation_site_sampler_.get();
+  }
+
+  // The allocator of the allocation sites that the JIT found long-lived: the non-moving
+  // allocator, unless the non-moving space is more than half full, as it cannot grow.
+  AllocatorType GetPretenureAllocator() const;
+
   void SetAllocationRecords(AllocRecordObjectMap* records)
       REQUIRES(Locks::alloc_tracker_lock_);
 
@@ -941,6 +992,10 @@ class Heap {
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!Locks::alloc_tracker_lock_);
 
+  void SweepAllocationSiteSamples(IsMarkedVisitor* visitor) const
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!Locks::jit_lock_);
+
   void DisallowNewAllocationRecords() const
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!Locks::alloc_tracker_lock_);
@@ -988,6 +1043,7 @@ class Heap {
   class ConcurrentGCTask;
   class CollectorTransitionTask;
   class HeapTrimTask;
+  class NativeAllocationCheckTask;
   class TriggerPostForkCCGcTask;
   class ReduceTargetFootprintTask;
 
@@ -1047,6 +1103,12 @@ class Heap {
   float NativeMemoryOverTarget(size_t current_native_bytes, bool is_gc_concurrent);
   void CheckGCForNative(Thread* self)
       REQUIRES(!*pending_task_lock_, !*gc_complete_lock_, !process_state_update_lock_);
+  // With -XX:AsyncNativeAllocationChecks, post a NativeAllocationCheckTask that does the
+  // check of CheckGCForNative() on the heap task thread. Returns false if the task cannot
+  // be added, in which case the caller checks synchronously.
+  bool RequestNativeAllocationCheck(Thread* self) REQUIRES(!*pending_task_lock_);
+  void CheckGCForNativeInBackground(Thread* self)
+      REQUIRES(!*pending_task_lock_, !*gc_complete_lock_, !process_state_update_lock_);
 
   accounting::ObjectStack* GetMarkStack() {
     return mark_stack_.get();
@@ -1376,6 +1438,9 @@ class Heap {
   // Lock which guards zygote space creation.
   Mutex zygote_creation_lock_;
 
+  // See SetZygoteDirtyClasses().
+  std::vector<std::string> zygote_dirty_class_descriptors_;
+
   // Non-null iff we have a zygote space. Doesn't contain the large objects allocated before
   // zygote space creation.
   space::ZygoteSpace* zygote_space_;
@@ -1474,6 +1539,13 @@ class Heap {
   // Allows us to check for GC only roughly every kNotifyNativeInterval allocations.
   Atomic<uint32_t> native_objects_notified_;
 
+  // Whether a NativeAllocationCheckTask has been posted and has not started yet.
+  Atomic<bool> native_allocation_check_pending_;
+
+  // Set by the NativeAllocationCheckTask when native allocation outpaces the GC badly enough
+  // that allocating threads must wait for it. The threads then check synchronously again.
+  Atomic<bool> native_allocation_throttled_;
+
   // Number of bytes freed by thread local buffer revokes. This will
   // cancel out the ahead-of-time bulk counting of bytes allocated in
   // rosalloc thread-local buffers.  It is temporarily accumulated
@@ -1599,6 +1671,10 @@ class Heap {
   const bool is_running_on_memory_tool_;
   const bool use_tlab_;
 
+  // Whether the native allocation notifications compute the GC urgency, which calls mallinfo(),
+  // on the heap task thread rather than on the allocating thread.
+  const bool async_native_allocation_checks_;
+
   // Pointer to the space which becomes the new main space when we do homogeneous space compaction.
   // Use unique_ptr since the space is only added during the homogeneous compaction phase.
   std::unique_ptr<space::MallocSpace> main_space_backup_;
@@ -1644,6 +1720,12 @@ class Heap {
   // for major collections. Set in Heap constructor.
   const bool use_generational_cc_;
 
+  // If true, enable generational collection when using the Concurrent
+  // Mark-Compact (CMC) collector, i.e. use young collections, which only
+  // compact the objects allocated since the previous GC, for minor collections.
+  // Set in Heap constructor.
+  const bool use_generational_cmc_;
+
   // True if the currently running collection has made some thread wait.
   bool running_collection_is_blocking_ GUARDED_BY(gc_complete_lock_);
   // The number of blocking GC runs.
@@ -1671,6 +1753,10 @@ class Heap {
   // Allocation tracking support
   Atomic<bool> alloc_tracking_enabled_;
   std::unique_ptr<AllocRecordObjectMap> allocation_records_;
+  // Always-on sampled histogram of the allocations by size class and class.
+  std::unique_ptr<AllocationHistogram> allocation_histogram_;
+  // Sampled allocation sites and their survival, for the JIT, see -Xjitpretenure.
+  std::unique_ptr<AllocationSiteSampler> allocation_site_sampler_;
   size_t alloc_record_depth_;
 
   // Perfetto Java Heap Profiler support.
@@ -1693,6 +1779,9 @@ class Heap {
   bool dump_region_info_before_gc_;
   bool dump_region_info_after_gc_;
 
+  // Turned on by -XX:DumpDuplicateStringsAfterGC to log DumpDuplicateStrings() after each GC.
+  bool dump_duplicate_strings_after_gc_;
+
   // Boot image spaces.
   std::vector<space::ImageSpace*> boot_image_spaces_;
 
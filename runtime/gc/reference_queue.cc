@@ -16,6 +16,8 @@
 
 #include "reference_queue.h"
 
+#include <memory>
+
 #include "accounting/card_table-inl.h"
 #include "base/mutex.h"
 #include "collector/concurrent_copying.h"
@@ -28,6 +30,10 @@
 namespace art {
 namespace gc {
 
+// Use the heap thread-pool for clearing white references if there are at least
+// these many references in the queue.
+static constexpr size_t kMinParallelClearWhiteReferences = 1024;
+
 ReferenceQueue::ReferenceQueue(Mutex* lock) : lock_(lock), list_(nullptr) {
 }
 
@@ -56,6 +62,22 @@ void ReferenceQueue::EnqueueReference(ObjPtr<mirror::Reference> ref) {
   list_->SetPendingNext(ref);
 }
 
+void ReferenceQueue::EnqueueQueue(ReferenceQueue* other) {
+  if (other->IsEmpty()) {
+    return;
+  }
+  if (IsEmpty()) {
+    list_ = other->list_;
+  } else {
+    // Splice the two circular lists by swapping the successors of their entry points.
+    ObjPtr<mirror::Reference> head = list_->GetPendingNext<kWithoutReadBarrier>();
+    ObjPtr<mirror::Reference> other_head = other->list_->GetPendingNext<kWithoutReadBarrier>();
+    list_->SetPendingNext(other_head);
+    other->list_->SetPendingNext(head);
+  }
+  other->list_ = nullptr;
+}
+
 ObjPtr<mirror::Reference> ReferenceQueue::DequeuePendingReference() {
   DCHECK(!IsEmpty());
   ObjPtr<mirror::Reference> ref = list_->GetPendingNext<kWithoutReadBarrier>();
@@ -130,36 +152,130 @@ size_t ReferenceQueue::GetLength() const {
   return count;
 }
 
+bool ReferenceQueue::ClearWhiteReferent(ObjPtr<mirror::Reference> ref,
+                                        collector::GarbageCollector* collector) {
+  mirror::HeapReference<mirror::Object>* referent_addr = ref->GetReferentReferenceAddr();
+  // do_atomic_update is false because this happens during the reference processing phase where
+  // Reference.clear() would block.
+  if (collector->IsNullOrMarkedHeapReference(referent_addr, /*do_atomic_update=*/false)) {
+    return false;
+  }
+  // Referent is white, clear it.
+  if (Runtime::Current()->IsActiveTransaction()) {
+    ref->ClearReferent<true>();
+  } else {
+    ref->ClearReferent<false>();
+  }
+  return true;
+}
+
+// Clears the white referents of a slice of a detached reference list, and
+// collects the cleared references in a task-local queue.
+class ReferenceQueue::ClearWhiteReferencesTask : public Task {
+ public:
+  ClearWhiteReferencesTask(ReferenceQueue* queue,
+                           collector::GarbageCollector* collector,
+                           mirror::Reference* const* begin,
+                           mirror::Reference* const* end)
+      : queue_(queue), collector_(collector), begin_(begin), end_(end), cleared_(nullptr) {}
+
+  // The GC-thread, which holds the mutator lock, waits for the workers to finish.
+  void Run([[maybe_unused]] Thread* self) override NO_THREAD_SAFETY_ANALYSIS {
+    for (mirror::Reference* const* it = begin_; it != end_; ++it) {
+      ObjPtr<mirror::Reference> ref = *it;
+      ref->SetPendingNext(nullptr);
+      if (ClearWhiteReferent(ref, collector_)) {
+        cleared_.EnqueueReference(ref);
+        ++num_cleared_;
+      }
+      queue_->DisableReadBarrierForReference(ref);
+    }
+  }
+
+  void Finalize() override {}
+
+  ReferenceQueue* GetCleared() {
+    return &cleared_;
+  }
+
+  size_t GetNumCleared() const {
+    return num_cleared_;
+  }
+
+ private:
+  ReferenceQueue* const queue_;
+  collector::GarbageCollector* const collector_;
+  mirror::Reference* const* const begin_;
+  mirror::Reference* const* const end_;
+  ReferenceQueue cleared_;
+  size_t num_cleared_ = 0;
+};
+
+size_t ReferenceQueue::ClearWhiteReferencesParallel(ThreadPool* thread_pool,
+                                                    const std::vector<mirror::Reference*>& refs,
+                                                    ReferenceQueue* cleared_references,
+                                                    collector::GarbageCollector* collector) {
+  Thread* self = Thread::Current();
+  // The calling thread works on the tasks as well.
+  const size_t num_tasks = thread_pool->GetThreadCount() + 1;
+  const size_t chunk_size = RoundUp(refs.size(), num_tasks) / num_tasks;
+  std::vector<std::unique_ptr<ClearWhiteReferencesTask>> tasks;
+  for (size_t i = 0; i < refs.size(); i += chunk_size) {
+    const size_t end = std::min(i + chunk_size, refs.size());
+    tasks.emplace_back(new ClearWhiteReferencesTask(
+        this, collector, refs.data() + i, refs.data() + end));
+    thread_pool->AddTask(self, tasks.back().get());
+  }
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ true);
+  thread_pool->StopWorkers(self);
+  size_t num_cleared = 0;
+  for (const std::unique_ptr<ClearWhiteReferencesTask>& task : tasks) {
+    cleared_references->EnqueueQueue(task->GetCleared());
+    num_cleared += task->GetNumCleared();
+  }
+  return num_cleared;
+}
+
 void ReferenceQueue::ClearWhiteReferences(ReferenceQueue* cleared_references,
                                           collector::GarbageCollector* collector,
                                           bool report_cleared) {
+  size_t num_cleared = 0;
+  ThreadPool* thread_pool = Runtime::Current()->GetHeap()->GetThreadPool();
+  // In transaction mode reference processing must stay on this thread.
+  if (thread_pool != nullptr && !IsEmpty() && !Runtime::Current()->IsActiveTransaction()) {
+    // Detach the list, keeping its order, so that it can be split in slices.
+    std::vector<mirror::Reference*> refs;
+    ObjPtr<mirror::Reference> head = list_->GetPendingNext<kWithoutReadBarrier>();
+    ObjPtr<mirror::Reference> ref = head;
+    do {
+      refs.push_back(ref.Ptr());
+      ref = ref->GetPendingNext<kWithoutReadBarrier>();
+    } while (ref != head);
+    if (refs.size() >= kMinParallelClearWhiteReferences) {
+      list_ = nullptr;
+      num_cleared = ClearWhiteReferencesParallel(thread_pool, refs, cleared_references, collector);
+    }
+  }
   while (!IsEmpty()) {
     ObjPtr<mirror::Reference> ref = DequeuePendingReference();
-    mirror::HeapReference<mirror::Object>* referent_addr = ref->GetReferentReferenceAddr();
-    // do_atomic_update is false because this happens during the reference processing phase where
-    // Reference.clear() would block.
-    if (!collector->IsNullOrMarkedHeapReference(referent_addr, /*do_atomic_update=*/false)) {
-      // Referent is white, clear it.
-      if (Runtime::Current()->IsActiveTransaction()) {
-        ref->ClearReferent<true>();
-      } else {
-        ref->ClearReferent<false>();
-      }
+    if (ClearWhiteReferent(ref, collector)) {
       cleared_references->EnqueueReference(ref);
-      if (report_cleared) {
-        static bool already_reported = false;
-        if (!already_reported) {
-          // TODO: Maybe do this only if the queue is non-null?
-          LOG(WARNING)
-              << "Cleared Reference was only reachable from finalizer (only reported once)";
-          already_reported = true;
-        }
-      }
+      ++num_cleared;
     }
     // Delay disabling the read barrier until here so that the ClearReferent call above in
     // transaction mode will trigger the read barrier.
     DisableReadBarrierForReference(ref);
   }
+  if (report_cleared && num_cleared > 0) {
+    static bool already_reported = false;
+    if (!already_reported) {
+      // TODO: Maybe do this only if the queue is non-null?
+      LOG(WARNING)
+          << "Cleared Reference was only reachable from finalizer (only reported once)";
+      already_reported = true;
+    }
+  }
 }
 
 FinalizerStats ReferenceQueue::EnqueueFinalizerReferences(ReferenceQueue* cleared_references,
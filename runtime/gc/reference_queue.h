@@ -74,6 +74,9 @@ class ReferenceQueue {
   // Not thread safe, used when mutators are paused to minimize lock overhead.
   void EnqueueReference(ObjPtr<mirror::Reference> ref) REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Move all the references of `other` to this queue, leaving `other` empty.
+  void EnqueueQueue(ReferenceQueue* other) REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Dequeue a reference from the queue and return that dequeued reference.
   // Call DisableReadBarrierForReference for the reference that's returned from this function.
   ObjPtr<mirror::Reference> DequeuePendingReference() REQUIRES_SHARED(Locks::mutator_lock_);
@@ -101,6 +104,7 @@ class ReferenceQueue {
 
   // Unlink the reference list clearing references objects with white referents. Cleared references
   // registered to a reference queue are scheduled for appending by the heap worker thread.
+  // Long lists are split across the heap thread-pool workers, if there are any.
   void ClearWhiteReferences(ReferenceQueue* cleared_references,
                             collector::GarbageCollector* collector,
                             bool report_cleared = false)
@@ -127,6 +131,21 @@ class ReferenceQueue {
       REQUIRES_SHARED(Locks::mutator_lock_);
 
  private:
+  class ClearWhiteReferencesTask;
+
+  // Clear the referent of `ref` if it's white. Returns true if it was cleared.
+  static bool ClearWhiteReferent(ObjPtr<mirror::Reference> ref,
+                                 collector::GarbageCollector* collector)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Process the references of the list, which has been detached into `refs`,
+  // with the workers of `thread_pool`. Returns the number of cleared references.
+  size_t ClearWhiteReferencesParallel(ThreadPool* thread_pool,
+                                      const std::vector<mirror::Reference*>& refs,
+                                      ReferenceQueue* cleared_references,
+                                      collector::GarbageCollector* collector)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Lock, used for parallel GC reference enqueuing. It allows for multiple threads simultaneously
   // calling AtomicEnqueueIfNotEnqueued.
   Mutex* const lock_;
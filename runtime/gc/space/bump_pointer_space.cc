@@ -18,6 +18,7 @@
 #include "bump_pointer_space-inl.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
+#include "runtime.h"
 #include "thread_list.h"
 
 namespace art {
@@ -201,6 +202,9 @@ uint64_t BumpPointerSpace::GetObjectsAllocated() {
 void BumpPointerSpace::RevokeThreadLocalBuffersLocked(Thread* thread) {
   objects_allocated_.fetch_add(thread->GetThreadLocalObjectsAllocated(), std::memory_order_relaxed);
   bytes_allocated_.fetch_add(thread->GetThreadLocalBytesAllocated(), std::memory_order_relaxed);
+  if (thread->HasTlab()) {
+    Runtime::Current()->GetMetrics()->TlabWastedBytes()->Add(thread->TlabSize());
+  }
   thread->ResetTlab();
 }
 
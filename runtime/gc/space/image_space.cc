@@ -20,10 +20,12 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <memory>
 #include <optional>
 #include <random>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "android-base/logging.h"
@@ -34,6 +36,7 @@
 #include "art_field-inl.h"
 #include "art_method-inl.h"
 #include "base/array_ref.h"
+#include "base/atomic.h"
 #include "base/bit_memory_region.h"
 #include "base/callee_save_type.h"
 #include "base/enums.h"
@@ -66,6 +69,7 @@
 #include "oat_file.h"
 #include "profile/profile_compilation_info.h"
 #include "runtime.h"
+#include "runtime_image.h"
 #include "space-inl.h"
 
 namespace art {
@@ -82,6 +86,55 @@ using ::android::base::StringPrintf;
 // supposed to be much smaller and allocating more that this would likely fail anyway.
 static constexpr size_t kMaxTotalImageReservationSize = 1 * GB;
 
+// Relocation visits the object sections in chunks of this size on up to
+// `kMaxRelocationThreads` threads, including the calling thread.
+static constexpr size_t kRelocationChunkSize = 256 * KB;
+static constexpr size_t kMaxRelocationThreads = 4u;
+
+// A range of an object section to relocate, with the bitmap that marks the object starts.
+struct RelocationChunk {
+  const accounting::ContinuousSpaceBitmap* bitmap;
+  uintptr_t begin;
+  uintptr_t end;
+};
+
+void AddRelocationChunks(const accounting::ContinuousSpaceBitmap* bitmap,
+                         uintptr_t begin,
+                         uintptr_t end,
+                         /*inout*/ std::vector<RelocationChunk>* chunks) {
+  for (uintptr_t chunk_begin = begin; chunk_begin < end; chunk_begin += kRelocationChunkSize) {
+    chunks->push_back({bitmap, chunk_begin, std::min(end, chunk_begin + kRelocationChunkSize)});
+  }
+}
+
+// Calls `function(i)` for each `i` in [0, `num_tasks`), on several threads if there is more
+// than one task. The boot image is relocated before the runtime thread pool exists and possibly
+// before the calling thread is attached, so the workers are plain threads that are not attached
+// to the runtime. The tasks must not suspend and must not use ObjPtr<>s created by another
+// thread, as the ObjPtr<> poisoning cookie is per thread.
+template <typename Function>
+void RunRelocationTasks(size_t num_tasks, const Function& function) {
+  size_t num_threads = std::min<size_t>(
+      {num_tasks, kMaxRelocationThreads, std::max(std::thread::hardware_concurrency(), 1u)});
+  Atomic<size_t> next_task(0u);
+  auto run_tasks = [&]() {
+    for (size_t i = next_task.fetch_add(1u, std::memory_order_relaxed);
+         i < num_tasks;
+         i = next_task.fetch_add(1u, std::memory_order_relaxed)) {
+      function(i);
+    }
+  };
+  std::vector<std::thread> workers;
+  workers.reserve(num_threads > 0u ? num_threads - 1u : 0u);
+  for (size_t i = 1u; i < num_threads; ++i) {
+    workers.emplace_back(run_tasks);
+  }
+  run_tasks();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+}
+
 }  // namespace
 
 Atomic<uint32_t> ImageSpace::bitmap_index_(0);
@@ -585,6 +638,21 @@ class ImageSpace::Loader {
                                   image_filename);
         return nullptr;
       }
+      // Images generated by the runtime store a checksum of their uncompressed data. Verify it
+      // before relocating anything, images written before the checksum was stored have none.
+      if (image_oat_checksum == 0u && image_header.GetImageChecksum() != 0u) {
+        TimingLogger::ScopedTiming timing("VerifyRuntimeImageChecksum", &logger);
+        const uint32_t data_checksum = RuntimeImage::ComputeImageDataChecksum(
+            space->GetMemMap()->Begin() + sizeof(ImageHeader),
+            image_header.GetImageSize() - sizeof(ImageHeader));
+        if (data_checksum != image_header.GetImageChecksum()) {
+          *error_msg = StringPrintf("Checksum 0x%x does not match the image one 0x%x in image %s",
+                                    data_checksum,
+                                    image_header.GetImageChecksum(),
+                                    image_filename);
+          return nullptr;
+        }
+      }
       size_t boot_image_space_dependencies;
       if (!ValidateBootImageChecksum(image_filename,
                                      image_header,
@@ -1056,7 +1124,7 @@ class ImageSpace::Loader {
         for (const ImageHeader::Block& block : image_header.GetBlocks(temp_map.Begin())) {
           auto function = [&](Thread*) {
             const uint64_t start2 = NanoTime();
-            ScopedTrace trace("LZ4 decompress block");
+            ScopedTrace trace("Decompress image block");
             bool result = block.Decompress(/*out_ptr=*/map.Begin(),
                                            /*in_ptr=*/temp_map.Begin(),
                                            error_msg);
@@ -1207,7 +1275,9 @@ class ImageSpace::Loader {
 
     void operator()(mirror::Object* obj) const
         NO_THREAD_SAFETY_ANALYSIS {
-      if (!visited_->Set(obj)) {
+      // Use Test() rather than Set(), the objects are visited only once but on several threads
+      // and a non-atomic Set() could lose the bits of neighbouring classes and pointer arrays.
+      if (!visited_->Test(obj)) {
         // Not already visited.
         obj->VisitReferences</*visit native roots*/false, kVerifyNone, kWithoutReadBarrier>(
             *this,
@@ -1356,7 +1426,14 @@ class ImageSpace::Loader {
       uintptr_t objects_begin = reinterpret_cast<uintptr_t>(target_base + objects_section.Offset());
       uintptr_t objects_end = reinterpret_cast<uintptr_t>(target_base + objects_section.End());
       FixupObjectVisitor<ForwardObject> fixup_object_visitor(&visited_bitmap, forward_object);
-      bitmap->VisitMarkedRange(objects_begin, objects_end, fixup_object_visitor);
+      // The objects are fixed up independently of each other, so visit the chunks of the objects
+      // section in parallel. The calling thread keeps holding the mutator lock for the workers.
+      std::vector<RelocationChunk> object_chunks;
+      AddRelocationChunks(bitmap, objects_begin, objects_end, &object_chunks);
+      RunRelocationTasks(object_chunks.size(), [&](size_t index) {
+        const RelocationChunk& chunk = object_chunks[index];
+        chunk.bitmap->VisitMarkedRange(chunk.begin, chunk.end, fixup_object_visitor);
+      });
       // Fixup image roots.
       CHECK(app_image_objects.InSource(reinterpret_cast<uintptr_t>(
           image_header->GetImageRoots<kWithoutReadBarrier>().Ptr())));
@@ -2568,32 +2645,8 @@ class ImageSpace::BootImageLoader {
       reinterpret_cast<ImageHeader*>(space->Begin())->RelocateImageReferences(current_diff64);
       reinterpret_cast<ImageHeader*>(space->Begin())->RelocateBootImageReferences(base_diff64);
 
-      // Patch fields and methods.
-      const ImageHeader& image_header = space->GetImageHeader();
-      image_header.VisitPackedArtFields([&](ArtField& field) REQUIRES_SHARED(Locks::mutator_lock_) {
-        // Fields always reference class in the current image.
-        simple_patch_object_visitor.template PatchGcRoot</*kMayBeNull=*/ false>(
-            &field.DeclaringClassRoot());
-      }, space->Begin());
-      image_header.VisitPackedArtMethods([&](ArtMethod& method)
-          REQUIRES_SHARED(Locks::mutator_lock_) {
-        main_patch_object_visitor.PatchGcRoot(&method.DeclaringClassRoot());
-        if (!method.HasCodeItem()) {
-          void** data_address = PointerAddress(&method, ArtMethod::DataOffset(kPointerSize));
-          main_patch_object_visitor.PatchNativePointer(data_address);
-        }
-        void** entrypoint_address =
-            PointerAddress(&method, ArtMethod::EntryPointFromQuickCompiledCodeOffset(kPointerSize));
-        main_patch_object_visitor.PatchNativePointer(entrypoint_address);
-      }, space->Begin(), kPointerSize);
-      auto method_table_visitor = [&](ArtMethod* method) {
-        DCHECK(method != nullptr);
-        return main_relocate_visitor(method);
-      };
-      image_header.VisitPackedImTables(method_table_visitor, space->Begin(), kPointerSize);
-      image_header.VisitPackedImtConflictTables(method_table_visitor, space->Begin(), kPointerSize);
-
       // Patch the intern table.
+      const ImageHeader& image_header = space->GetImageHeader();
       if (image_header.GetInternedStringsSection().Size() != 0u) {
         const uint8_t* data = space->Begin() + image_header.GetInternedStringsSection().Offset();
         size_t read_count;
@@ -2648,40 +2701,86 @@ class ImageSpace::BootImageLoader {
       }
     }
 
+    // The fields, methods and objects are patched independently of each other once the classes
+    // are patched, so patch the native sections of each space and the chunks of the object
+    // sections in parallel. The live bitmaps give the object starts within the chunks. The
+    // tasks may run on threads other than the one that created the ObjPtr<>s above, so they
+    // compare classes by raw pointers.
+    std::vector<RelocationChunk> object_chunks;
     for (const std::unique_ptr<ImageSpace>& space : spaces) {
-      const ImageHeader& image_header = space->GetImageHeader();
-
       static_assert(IsAligned<kObjectAlignment>(sizeof(ImageHeader)), "Header alignment check");
-      uint32_t objects_end = image_header.GetObjectsSection().Size();
+      uint32_t objects_end = space->GetImageHeader().GetObjectsSection().Size();
       DCHECK_ALIGNED(objects_end, kObjectAlignment);
-      for (uint32_t pos = sizeof(ImageHeader); pos != objects_end; ) {
-        mirror::Object* object = reinterpret_cast<mirror::Object*>(space->Begin() + pos);
-        // Note: use Test() rather than Set() as this is the last time we're checking this object.
-        if (!patched_objects->Test(object)) {
-          // This is the last pass over objects, so we do not need to Set().
-          main_patch_object_visitor.VisitObject(object);
-          ObjPtr<mirror::Class> klass = object->GetClass<kVerifyNone, kWithoutReadBarrier>();
-          if (klass == method_class || klass == constructor_class) {
-            // Patch the ArtMethod* in the mirror::Executable subobject.
-            ObjPtr<mirror::Executable> as_executable =
-                ObjPtr<mirror::Executable>::DownCast(object);
-            ArtMethod* unpatched_method = as_executable->GetArtMethod<kVerifyNone>();
-            ArtMethod* patched_method = main_relocate_visitor(unpatched_method);
-            as_executable->SetArtMethod</*kTransactionActive=*/ false,
-                                        /*kCheckTransaction=*/ true,
-                                        kVerifyNone>(patched_method);
-          } else if (klass == field_var_handle_class || klass == static_field_var_handle_class) {
-            // Patch the ArtField* in the mirror::FieldVarHandle subobject.
-            ObjPtr<mirror::FieldVarHandle> as_field_var_handle =
-                ObjPtr<mirror::FieldVarHandle>::DownCast(object);
-            ArtField* unpatched_field = as_field_var_handle->GetArtField<kVerifyNone>();
-            ArtField* patched_field = main_relocate_visitor(unpatched_field);
-            as_field_var_handle->SetArtField<kVerifyNone>(patched_field);
-          }
+      AddRelocationChunks(space->GetLiveBitmap(),
+                          reinterpret_cast<uintptr_t>(space->Begin() + sizeof(ImageHeader)),
+                          reinterpret_cast<uintptr_t>(space->Begin() + objects_end),
+                          &object_chunks);
+    }
+    const mirror::Class* const raw_method_class = method_class.Ptr();
+    const mirror::Class* const raw_constructor_class = constructor_class.Ptr();
+    const mirror::Class* const raw_field_var_handle_class = field_var_handle_class.Ptr();
+    const mirror::Class* const raw_static_field_var_handle_class =
+        static_field_var_handle_class.Ptr();
+    auto patch_native_sections = [&](ImageSpace* space) REQUIRES_SHARED(Locks::mutator_lock_) {
+      const ImageHeader& image_header = space->GetImageHeader();
+      image_header.VisitPackedArtFields([&](ArtField& field) REQUIRES_SHARED(Locks::mutator_lock_) {
+        // Fields always reference class in the current image.
+        simple_patch_object_visitor.template PatchGcRoot</*kMayBeNull=*/ false>(
+            &field.DeclaringClassRoot());
+      }, space->Begin());
+      image_header.VisitPackedArtMethods([&](ArtMethod& method)
+          REQUIRES_SHARED(Locks::mutator_lock_) {
+        main_patch_object_visitor.PatchGcRoot(&method.DeclaringClassRoot());
+        if (!method.HasCodeItem()) {
+          void** data_address = PointerAddress(&method, ArtMethod::DataOffset(kPointerSize));
+          main_patch_object_visitor.PatchNativePointer(data_address);
+        }
+        void** entrypoint_address =
+            PointerAddress(&method, ArtMethod::EntryPointFromQuickCompiledCodeOffset(kPointerSize));
+        main_patch_object_visitor.PatchNativePointer(entrypoint_address);
+      }, space->Begin(), kPointerSize);
+      auto method_table_visitor = [&](ArtMethod* method) {
+        DCHECK(method != nullptr);
+        return main_relocate_visitor(method);
+      };
+      image_header.VisitPackedImTables(method_table_visitor, space->Begin(), kPointerSize);
+      image_header.VisitPackedImtConflictTables(method_table_visitor, space->Begin(), kPointerSize);
+    };
+    auto patch_object = [&](mirror::Object* object) REQUIRES_SHARED(Locks::mutator_lock_) {
+      // Note: use Test() rather than Set() as this is the last time we're checking this object.
+      if (!patched_objects->Test(object)) {
+        // This is the last pass over objects, so we do not need to Set().
+        main_patch_object_visitor.VisitObject(object);
+        mirror::Class* klass = object->GetClass<kVerifyNone, kWithoutReadBarrier>().Ptr();
+        if (klass == raw_method_class || klass == raw_constructor_class) {
+          // Patch the ArtMethod* in the mirror::Executable subobject.
+          ObjPtr<mirror::Executable> as_executable =
+              ObjPtr<mirror::Executable>::DownCast(object);
+          ArtMethod* unpatched_method = as_executable->GetArtMethod<kVerifyNone>();
+          ArtMethod* patched_method = main_relocate_visitor(unpatched_method);
+          as_executable->SetArtMethod</*kTransactionActive=*/ false,
+                                      /*kCheckTransaction=*/ true,
+                                      kVerifyNone>(patched_method);
+        } else if (klass == raw_field_var_handle_class ||
+                   klass == raw_static_field_var_handle_class) {
+          // Patch the ArtField* in the mirror::FieldVarHandle subobject.
+          ObjPtr<mirror::FieldVarHandle> as_field_var_handle =
+              ObjPtr<mirror::FieldVarHandle>::DownCast(object);
+          ArtField* unpatched_field = as_field_var_handle->GetArtField<kVerifyNone>();
+          ArtField* patched_field = main_relocate_visitor(unpatched_field);
+          as_field_var_handle->SetArtField<kVerifyNone>(patched_field);
         }
-        pos += RoundUp(object->SizeOf<kVerifyNone>(), kObjectAlignment);
       }
-    }
+    };
+    RunRelocationTasks(spaces.size() + object_chunks.size(),
+                       [&](size_t index) NO_THREAD_SAFETY_ANALYSIS {
+      if (index < spaces.size()) {
+        patch_native_sections(spaces[index].get());
+      } else {
+        const RelocationChunk& chunk = object_chunks[index - spaces.size()];
+        chunk.bitmap->VisitMarkedRange(chunk.begin, chunk.end, patch_object);
+      }
+    });
     if (kIsDebugBuild && !kExtension) {
       // We used just Test() instead of Set() above but we need to use Set()
       // for class roots to satisfy a DCHECK() for extensions.
@@ -122,26 +122,63 @@ void LargeObjectSpace::CopyLiveToMarked() {
   mark_bitmap_.CopyFrom(&live_bitmap_);
 }
 
-LargeObjectMapSpace::LargeObjectMapSpace(const std::string& name)
-    : LargeObjectSpace(name, nullptr, nullptr, "large object map space lock") {}
+LargeObjectMapSpace::LargeObjectMapSpace(const std::string& name, bool use_huge_pages)
+    : LargeObjectSpace(name, nullptr, nullptr, "large object map space lock"),
+      use_huge_pages_(use_huge_pages),
+      cached_bytes_(0) {}
 
-LargeObjectMapSpace* LargeObjectMapSpace::Create(const std::string& name) {
+LargeObjectMapSpace* LargeObjectMapSpace::Create(const std::string& name, bool use_huge_pages) {
   if (Runtime::Current()->IsRunningOnMemoryTool()) {
     return new MemoryToolLargeObjectMapSpace(name);
   } else {
-    return new LargeObjectMapSpace(name);
+    return new LargeObjectMapSpace(name, use_huge_pages);
   }
 }
 
+MemMap LargeObjectMapSpace::TakeCachedMemMap(size_t num_bytes) {
+  const size_t size = RoundUp(num_bytes, kPageSize);
+  auto it = cached_mem_maps_.lower_bound(size);
+  if (it == cached_mem_maps_.end() || it->first > size + size / 8) {
+    return MemMap::Invalid();
+  }
+  MemMap mem_map = std::move(it->second);
+  cached_mem_maps_.erase(it);
+  DCHECK_GE(cached_bytes_, mem_map.BaseSize());
+  cached_bytes_ -= mem_map.BaseSize();
+  return mem_map;
+}
+
 mirror::Object* LargeObjectMapSpace::Alloc(Thread* self, size_t num_bytes,
                                            size_t* bytes_allocated, size_t* usable_size,
                                            size_t* bytes_tl_bulk_allocated) {
   std::string error_msg;
-  MemMap mem_map = MemMap::MapAnonymous("large object space allocation",
-                                        num_bytes,
-                                        PROT_READ | PROT_WRITE,
-                                        /*low_4gb=*/ true,
-                                        &error_msg);
+  MemMap mem_map;
+  if (use_huge_pages_ && num_bytes >= kHugePageChunkSize) {
+    {
+      MutexLock mu(self, lock_);
+      mem_map = TakeCachedMemMap(num_bytes);
+    }
+    if (!mem_map.IsValid()) {
+      mem_map = MemMap::MapAnonymousAligned("large object space allocation",
+                                            num_bytes,
+                                            PROT_READ | PROT_WRITE,
+                                            /*low_4gb=*/ true,
+                                            kHugePageChunkSize,
+                                            &error_msg);
+#ifdef MADV_HUGEPAGE
+      if (mem_map.IsValid()) {
+        // Best effort: fewer page faults and TLB misses when the array is first touched.
+        madvise(mem_map.BaseBegin(), mem_map.BaseSize(), MADV_HUGEPAGE);
+      }
+#endif
+    }
+  } else {
+    mem_map = MemMap::MapAnonymous("large object space allocation",
+                                   num_bytes,
+                                   PROT_READ | PROT_WRITE,
+                                   /*low_4gb=*/ true,
+                                   &error_msg);
+  }
   if (UNLIKELY(!mem_map.IsValid())) {
     LOG(WARNING) << "Large object allocation failed: " << error_msg;
     return nullptr;
@@ -201,7 +238,19 @@ size_t LargeObjectMapSpace::Free(Thread* self, mirror::Object* ptr) {
   size_t allocation_size = map_size;
   num_bytes_allocated_ -= allocation_size;
   --num_objects_allocated_;
-  large_objects_.erase(it);
+  if (use_huge_pages_ &&
+      map_size >= kHugePageChunkSize &&
+      cached_bytes_ + map_size <= kMaxCachedBytes) {
+    // Keep the mapping for the next allocation of a similar size, with its pages released so
+    // that it reads as zero.
+    MemMap mem_map = std::move(it->second.mem_map);
+    large_objects_.erase(it);
+    mem_map.MadviseDontNeedAndZero();
+    cached_bytes_ += map_size;
+    cached_mem_maps_.emplace(map_size, std::move(mem_map));
+  } else {
+    large_objects_.erase(it);
+  }
   return allocation_size;
 }
 
@@ -24,6 +24,7 @@
 #include "space.h"
 #include "thread-current-inl.h"
 
+#include <map>
 #include <set>
 #include <vector>
 
@@ -37,6 +38,7 @@ enum class LargeObjectSpaceType {
   kDisabled,
   kMap,
   kFreeList,
+  kHugePageMap,
 };
 
 // Abstraction implemented by all large object spaces.
@@ -150,9 +152,16 @@ class LargeObjectSpace : public DiscontinuousSpace, public AllocSpace {
 // A discontinuous large object space implemented by individual mmap/munmap calls.
 class LargeObjectMapSpace : public LargeObjectSpace {
  public:
+  // Allocations of at least this size are huge-page aligned when huge pages are used.
+  static constexpr size_t kHugePageChunkSize = 2 * MB;
+  // Upper bound of the address space kept in freed mappings for reuse.
+  static constexpr size_t kMaxCachedBytes = 64 * MB;
+
   // Creates a large object space. Allocations into the large object space use memory maps instead
-  // of malloc.
-  static LargeObjectMapSpace* Create(const std::string& name);
+  // of malloc. With `use_huge_pages`, big allocations are placed in mappings aligned to
+  // kHugePageChunkSize and backed by transparent huge pages, and their mappings are released
+  // and cached on free, instead of unmapped, so that allocations of a similar size reuse them.
+  static LargeObjectMapSpace* Create(const std::string& name, bool use_huge_pages = false);
   // Return the storage space required by obj.
   size_t AllocationSize(mirror::Object* obj, size_t* usable_size) override REQUIRES(!lock_);
   mirror::Object* Alloc(Thread* self, size_t num_bytes, size_t* bytes_allocated,
@@ -170,9 +179,19 @@ class LargeObjectMapSpace : public LargeObjectSpace {
     MemMap mem_map;
     bool is_zygote;
   };
-  explicit LargeObjectMapSpace(const std::string& name);
+  using CachedMemMaps = std::multimap<size_t,
+                                      MemMap,
+                                      std::less<size_t>,
+                                      TrackingAllocator<std::pair<const size_t, MemMap>,
+                                                        kAllocatorTagLOSMaps>>;
+
+  explicit LargeObjectMapSpace(const std::string& name, bool use_huge_pages = false);
   virtual ~LargeObjectMapSpace() {}
 
+  // Returns the smallest cached mapping that can hold `num_bytes` without wasting more than an
+  // eighth of it, or an invalid mapping if there is none.
+  MemMap TakeCachedMemMap(size_t num_bytes) REQUIRES(lock_);
+
   bool IsZygoteLargeObject(Thread* self, mirror::Object* obj) const override REQUIRES(!lock_);
   void SetAllLargeObjectsAsZygoteObjects(Thread* self, bool set_mark_bit) override
       REQUIRES(!lock_)
@@ -180,6 +199,11 @@ class LargeObjectMapSpace : public LargeObjectSpace {
 
   AllocationTrackingSafeMap<mirror::Object*, LargeObject, kAllocatorTagLOSMaps> large_objects_
       GUARDED_BY(lock_);
+
+  const bool use_huge_pages_;
+  // Freed huge-page mappings, keyed by size. Their pages have been released.
+  CachedMemMaps cached_mem_maps_ GUARDED_BY(lock_);
+  size_t cached_bytes_ GUARDED_BY(lock_);
 };
 
 // A continuous large object space with a free-list to handle holes.
@@ -182,6 +182,34 @@ TEST_F(LargeObjectSpaceTest, RaceTest) {
   RaceTest();
 }
 
+TEST_F(LargeObjectSpaceTest, HugePageMapReuse) {
+  Thread* const self = Thread::Current();
+  std::unique_ptr<LargeObjectSpace> los(
+      space::LargeObjectMapSpace::Create("large object space", /*use_huge_pages=*/ true));
+  const size_t request_size = 4 * LargeObjectMapSpace::kHugePageChunkSize + 123;
+  size_t allocation_size = 0;
+  size_t bytes_tl_bulk_allocated;
+  mirror::Object* obj =
+      los->Alloc(self, request_size, &allocation_size, nullptr, &bytes_tl_bulk_allocated);
+  ASSERT_TRUE(obj != nullptr);
+  EXPECT_TRUE(IsAlignedParam(obj, LargeObjectMapSpace::kHugePageChunkSize));
+  EXPECT_EQ(RoundUp(request_size, kPageSize), allocation_size);
+  memset(obj, 0xab, request_size);
+  EXPECT_EQ(allocation_size, los->Free(self, obj));
+
+  // A slightly smaller allocation reuses the freed mapping, which reads as zero.
+  mirror::Object* obj2 =
+      los->Alloc(self, request_size - kPageSize, &allocation_size, nullptr,
+                 &bytes_tl_bulk_allocated);
+  ASSERT_EQ(obj, obj2);
+  EXPECT_EQ(RoundUp(request_size, kPageSize), allocation_size);
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(obj2);
+  for (size_t i = 0; i < allocation_size; i += kPageSize / 2) {
+    ASSERT_EQ(0u, bytes[i]);
+  }
+  los->Free(self, obj2);
+}
+
 }  // namespace space
 }  // namespace gc
 }  // namespace art
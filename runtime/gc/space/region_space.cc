@@ -13,15 +13,23 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <sched.h>
+
 #include <deque>
 
+#include "android-base/file.h"
+#include "android-base/stringprintf.h"
+
 #include "bump_pointer_space-inl.h"
 #include "bump_pointer_space.h"
 #include "base/dumpable.h"
 #include "base/logging.h"
+#include "gc/accounting/card_table-inl.h"
 #include "gc/accounting/read_barrier_table.h"
+#include "gc/heap.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
+#include "runtime.h"
 #include "thread_list.h"
 
 namespace art {
@@ -38,6 +46,34 @@ static constexpr bool kProtectClearedRegions = kIsDebugBuild;
 // Wether we poison memory areas occupied by dead objects in unevacuated regions.
 static constexpr bool kPoisonDeadObjectsInUnevacuatedRegions = kIsDebugBuild;
 
+// Number of collections a region must have survived before AdviseColdRegions considers it cold.
+static constexpr uint32_t kColdRegionAge = 4U;
+
+// Read the cluster of every CPU from sysfs. The returned vector is indexed by CPU
+// number and holds dense cluster indices. `num_clusters` is set to the number of
+// distinct clusters, capped to kMaxRegionSpaceClusters.
+static std::vector<uint8_t> ReadCpuClusters(/*out*/ size_t* num_clusters) {
+  std::vector<uint8_t> cpu_clusters;
+  std::vector<std::string> cluster_ids;
+  for (size_t cpu = 0;; ++cpu) {
+    std::string dir = android::base::StringPrintf("/sys/devices/system/cpu/cpu%zu/topology/", cpu);
+    std::string id;
+    // Older kernels don't export cluster_id, in which case use the package as the cluster.
+    if (!android::base::ReadFileToString(dir + "cluster_id", &id) &&
+        !android::base::ReadFileToString(dir + "physical_package_id", &id)) {
+      break;
+    }
+    auto it = std::find(cluster_ids.begin(), cluster_ids.end(), id);
+    size_t cluster = std::distance(cluster_ids.begin(), it);
+    if (it == cluster_ids.end()) {
+      cluster_ids.push_back(id);
+    }
+    cpu_clusters.push_back(static_cast<uint8_t>(cluster % kMaxRegionSpaceClusters));
+  }
+  *num_clusters = std::clamp<size_t>(cluster_ids.size(), 1u, kMaxRegionSpaceClusters);
+  return cpu_clusters;
+}
+
 // Special 32-bit value used to poison memory areas occupied by dead
 // objects in unevacuated regions. Dereferencing this value is expected
 // to trigger a memory protection fault, as it is unlikely that it
@@ -114,10 +150,12 @@ RegionSpace::RegionSpace(const std::string& name, MemMap&& mem_map, bool use_gen
       num_non_free_regions_(0U),
       num_evac_regions_(0U),
       max_peak_num_non_free_regions_(0U),
+      num_partial_tlabs_(0U),
       non_free_region_index_limit_(0U),
       current_region_(&full_region_),
       evac_region_(nullptr),
       cyclic_alloc_region_index_(0U) {
+  cpu_clusters_ = ReadCpuClusters(&num_clusters_);
   CHECK_ALIGNED(mem_map_.Size(), kRegionSize);
   CHECK_ALIGNED(mem_map_.Begin(), kRegionSize);
   DCHECK_GT(num_regions_, 0U);
@@ -321,7 +359,11 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table,
   MutexLock mu(Thread::Current(), region_lock_);
   // We cannot use the partially utilized TLABs across a GC. Therefore, revoke
   // them during the thread-flip.
-  partial_tlabs_.clear();
+  for (auto& partial_tlabs : partial_tlabs_) {
+    partial_tlabs.clear();
+  }
+  num_partial_tlabs_.store(0u, std::memory_order_relaxed);
+  ReleaseReservedRegionsLocked();
 
   // Counter for the number of expected large tail regions following a large region.
   size_t num_expected_large_tails = 0U;
@@ -413,6 +455,57 @@ void RegionSpace::ReleaseFreeRegions() {
   }
 }
 
+// Returns true if swap is backed by zram, in which case paging out memory compresses it in RAM
+// rather than writing it to storage.
+static bool IsZramSwapActive() {
+  std::string swaps;
+  return android::base::ReadFileToString("/proc/swaps", &swaps) &&
+         swaps.find("zram") != std::string::npos;
+}
+
+size_t RegionSpace::AdviseColdRegions() {
+#if defined(MADV_COLD) && defined(MADV_PAGEOUT)
+  static const int advice = IsZramSwapActive() ? MADV_PAGEOUT : MADV_COLD;
+  accounting::CardTable* card_table = Runtime::Current()->GetHeap()->GetCardTable();
+  // Gather the ranges first so that madvise isn't called with region_lock_ held.
+  std::vector<std::pair<uint8_t*, uint8_t*>> cold_ranges;
+  {
+    MutexLock mu(Thread::Current(), region_lock_);
+    for (size_t i = 0u; i < num_regions_; ++i) {
+      Region* r = &regions_[i];
+      if (r->IsFree() || r->IsNewlyAllocated() || r->IsTlab() ||
+          time_ - r->alloc_time_ < kColdRegionAge) {
+        continue;
+      }
+      // A dirty card means that references in the region were written since the cards were
+      // last cleared, so the region is probably still in use.
+      const uint8_t* card_begin = card_table->CardFromAddr(r->Begin());
+      const uint8_t* card_end = card_table->CardFromAddr(r->End() - 1) + 1;
+      if (std::any_of(card_begin, card_end, [](uint8_t card) {
+            return card != accounting::CardTable::kCardClean;
+          })) {
+        continue;
+      }
+      if (!cold_ranges.empty() && cold_ranges.back().second == r->Begin()) {
+        cold_ranges.back().second = r->End();
+      } else {
+        cold_ranges.emplace_back(r->Begin(), r->End());
+      }
+    }
+  }
+  size_t advised_bytes = 0u;
+  for (const auto& range : cold_ranges) {
+    // The advice is only a hint, the pages are still valid if it fails.
+    if (madvise(range.first, range.second - range.first, advice) == 0) {
+      advised_bytes += range.second - range.first;
+    }
+  }
+  return advised_bytes;
+#else
+  return 0u;
+#endif
+}
+
 void RegionSpace::ClearFromSpace(/* out */ uint64_t* cleared_bytes,
                                  /* out */ uint64_t* cleared_objects,
                                  const bool clear_bitmap,
@@ -776,6 +869,7 @@ bool RegionSpace::LogFragmentationAllocFailure(std::ostream& os,
 
 void RegionSpace::Clear() {
   MutexLock mu(Thread::Current(), region_lock_);
+  ReleaseReservedRegionsLocked();
   for (size_t i = 0; i < num_regions_; ++i) {
     Region* r = &regions_[i];
     if (!r->IsFree()) {
@@ -805,6 +899,7 @@ void RegionSpace::ClampGrowthLimit(size_t new_capacity) {
   MutexLock mu(Thread::Current(), region_lock_);
   CHECK_LE(new_capacity, NonGrowthLimitCapacity());
   size_t new_num_regions = new_capacity / kRegionSize;
+  ReleaseReservedRegionsLocked();
   if (non_free_region_index_limit_ > new_num_regions) {
     LOG(WARNING) << "Couldn't clamp region space as there are regions in use beyond growth limit.";
     return;
@@ -855,40 +950,158 @@ void RegionSpace::RecordAlloc(mirror::Object* ref) {
   r->objects_allocated_.fetch_add(1, std::memory_order_relaxed);
 }
 
+RegionSpace::Region* RegionSpace::PopReservedRegion(uint8_t cluster) {
+  ReservedRegions& reserved = reserved_regions_[cluster];
+  uint64_t state = reserved.state.load(std::memory_order_acquire);
+  while (true) {
+    uint32_t count = static_cast<uint32_t>(state);
+    if (count == 0u) {
+      return nullptr;
+    }
+    Region* r = reserved.regions[count - 1].load(std::memory_order_relaxed);
+    // On failure `state` is reloaded with acquire order, which makes the
+    // entries of a concurrent refill visible.
+    if (reserved.state.compare_exchange_weak(state, state - 1u, std::memory_order_acquire)) {
+      return r;
+    }
+  }
+}
+
+void RegionSpace::ReserveRegionsLocked(uint8_t cluster) {
+  ReservedRegions& reserved = reserved_regions_[cluster];
+  // Only this function, with region_lock_ held, increases the count.
+  uint64_t state = reserved.state.load(std::memory_order_relaxed);
+  if (static_cast<uint32_t>(state) != 0u) {
+    return;
+  }
+  uint32_t count = 0;
+  for (; count < kReservedTlabRegions; ++count) {
+    Region* r = AllocateRegion(/*for_evac=*/ false, cluster, /*local_only=*/ true);
+    if (r == nullptr) {
+      break;
+    }
+    reserved.regions[count].store(r, std::memory_order_relaxed);
+  }
+  uint64_t generation = (state >> 32) + 1u;
+  reserved.state.store((generation << 32) | count, std::memory_order_release);
+}
+
+void RegionSpace::ReleaseReservedRegionsLocked() {
+  for (ReservedRegions& reserved : reserved_regions_) {
+    // Mutators may still pop regions concurrently, but only the count changes
+    // without region_lock_. Take the remaining regions with one exchange so that
+    // a region popped in the meantime is not cleared while it is used as a TLAB.
+    uint64_t generation = (reserved.state.load(std::memory_order_relaxed) >> 32) + 1u;
+    uint64_t state = reserved.state.exchange(generation << 32, std::memory_order_relaxed);
+    DCHECK_EQ(state >> 32, generation - 1u);
+    uint32_t count = static_cast<uint32_t>(state);
+    for (uint32_t i = 0; i < count; ++i) {
+      Region* r = reserved.regions[i].load(std::memory_order_relaxed);
+      DCHECK(r->IsAllocated());
+      DCHECK_EQ(r->Top(), r->Begin());
+      r->Clear(/*zero_and_release_pages=*/ false);
+      --num_non_free_regions_;
+    }
+  }
+}
+
+bool RegionSpace::AllocNewTlabLockFree(Thread* self,
+                                       size_t tlab_size,
+                                       size_t* bytes_tl_bulk_allocated) {
+  if (gc::Heap::kUsePartialTlabs) {
+    // Take the slow path if there are partial TLABs to reuse, or if the current
+    // TLAB has enough space left to become one.
+    if (num_partial_tlabs_.load(std::memory_order_relaxed) != 0u) {
+      return false;
+    }
+    uint8_t* tlab_pos = self->GetTlabPos();
+    if (tlab_pos != nullptr &&
+        AlignUp(tlab_pos, kRegionSize) - tlab_pos >= gc::Heap::kPartialTlabSize) {
+      return false;
+    }
+  }
+  const uint8_t cluster = GetCurrentCluster();
+  Region* r = PopReservedRegion(cluster);
+  if (r == nullptr) {
+    return false;
+  }
+  // The region was claimed under region_lock_ and is now exclusively owned by
+  // this thread, like the region of its current TLAB.
+  Region* old_region = RecordTlabAllocations(self);
+  if (old_region != nullptr) {
+    old_region->is_a_tlab_ = false;
+    old_region->thread_ = nullptr;
+    Runtime::Current()->GetMetrics()->TlabWastedBytes()->Add(
+        old_region->End() - self->GetTlabPos());
+  }
+  self->ResetTlab();
+  *bytes_tl_bulk_allocated = tlab_size;
+  SetTlab(self, r, r->Begin(), tlab_size, cluster);
+  return true;
+}
+
+void RegionSpace::SetTlab(Thread* self,
+                          Region* r,
+                          uint8_t* start,
+                          size_t tlab_size,
+                          uint8_t cluster) {
+  DCHECK_ALIGNED(start, kObjectAlignment);
+  r->is_a_tlab_ = true;
+  r->thread_ = self;
+  r->cluster_ = cluster;
+  r->SetTop(r->End());
+  self->SetTlab(start, start + tlab_size, r->End());
+}
+
 bool RegionSpace::AllocNewTlab(Thread* self,
                                const size_t tlab_size,
                                size_t* bytes_tl_bulk_allocated) {
+  if (AllocNewTlabLockFree(self, tlab_size, bytes_tl_bulk_allocated)) {
+    return true;
+  }
   MutexLock mu(self, region_lock_);
   RevokeThreadLocalBuffersLocked(self, /*reuse=*/ gc::Heap::kUsePartialTlabs);
   Region* r = nullptr;
   uint8_t* pos = nullptr;
   *bytes_tl_bulk_allocated = tlab_size;
-  // First attempt to get a partially used TLAB, if available.
-  if (tlab_size < kRegionSize) {
-    // Fetch the largest partial TLAB. The multimap is ordered in decreasing
-    // size.
-    auto largest_partial_tlab = partial_tlabs_.begin();
-    if (largest_partial_tlab != partial_tlabs_.end() && largest_partial_tlab->first >= tlab_size) {
+  const uint8_t cluster = GetCurrentCluster();
+  // Fetch the largest partial TLAB of `partial_tlabs` if it's big enough. The
+  // multimap is ordered in decreasing size.
+  auto take_partial_tlab = [&](std::multimap<size_t, Region*, std::greater<size_t>>& partial_tlabs)
+      REQUIRES(region_lock_) {
+    auto largest_partial_tlab = partial_tlabs.begin();
+    if (largest_partial_tlab != partial_tlabs.end() && largest_partial_tlab->first >= tlab_size) {
       r = largest_partial_tlab->second;
       pos = r->End() - largest_partial_tlab->first;
-      partial_tlabs_.erase(largest_partial_tlab);
+      partial_tlabs.erase(largest_partial_tlab);
+      num_partial_tlabs_.fetch_sub(1u, std::memory_order_relaxed);
       DCHECK_GT(r->End(), pos);
       DCHECK_LE(r->Begin(), pos);
       DCHECK_GE(r->Top(), pos);
       *bytes_tl_bulk_allocated -= r->Top() - pos;
     }
+  };
+  // Prefer memory last used by this cluster, in the order: partially used TLABs,
+  // free regions, partially used TLABs of other clusters and then any free region.
+  if (tlab_size < kRegionSize) {
+    take_partial_tlab(partial_tlabs_[cluster]);
+  }
+  if (r == nullptr && num_clusters_ > 1) {
+    r = AllocateRegion(/*for_evac=*/ false, cluster, /*local_only=*/ true);
+    for (size_t i = 0; r == nullptr && tlab_size < kRegionSize && i < num_clusters_; ++i) {
+      if (i != cluster) {
+        take_partial_tlab(partial_tlabs_[i]);
+      }
+    }
   }
   if (r == nullptr) {
     // Fallback to allocating an entire region as TLAB.
-    r = AllocateRegion(/*for_evac=*/ false);
+    r = AllocateRegion(/*for_evac=*/ false, cluster, /*local_only=*/ false);
   }
   if (r != nullptr) {
-    uint8_t* start = pos != nullptr ? pos : r->Begin();
-    DCHECK_ALIGNED(start, kObjectAlignment);
-    r->is_a_tlab_ = true;
-    r->thread_ = self;
-    r->SetTop(r->End());
-    self->SetTlab(start, start + tlab_size, r->End());
+    SetTlab(self, r, pos != nullptr ? pos : r->Begin(), tlab_size, cluster);
+    // Claim regions for the next refills of this cluster while holding the lock.
+    ReserveRegionsLocked(cluster);
     return true;
   }
   return false;
@@ -906,22 +1119,34 @@ size_t RegionSpace::RevokeThreadLocalBuffers(Thread* thread, const bool reuse) {
   return 0U;
 }
 
-void RegionSpace::RevokeThreadLocalBuffersLocked(Thread* thread, bool reuse) {
+RegionSpace::Region* RegionSpace::RecordTlabAllocations(Thread* thread) {
   uint8_t* tlab_start = thread->GetTlabStart();
   DCHECK_EQ(thread->HasTlab(), tlab_start != nullptr);
-  if (tlab_start != nullptr) {
-    Region* r = RefToRegionLocked(reinterpret_cast<mirror::Object*>(tlab_start));
+  if (tlab_start == nullptr) {
+    return nullptr;
+  }
+  Region* r = RefToRegionLocked(reinterpret_cast<mirror::Object*>(tlab_start));
+  DCHECK(r->IsAllocated());
+  DCHECK_LE(thread->GetThreadLocalBytesAllocated(), kRegionSize);
+  r->RecordThreadLocalAllocations(thread->GetThreadLocalObjectsAllocated(),
+                                  thread->GetTlabEnd() - r->Begin());
+  DCHECK_GE(r->End(), thread->GetTlabPos());
+  DCHECK_LE(r->Begin(), thread->GetTlabPos());
+  return r;
+}
+
+void RegionSpace::RevokeThreadLocalBuffersLocked(Thread* thread, bool reuse) {
+  Region* r = RecordTlabAllocations(thread);
+  if (r != nullptr) {
     r->is_a_tlab_ = false;
     r->thread_ = nullptr;
-    DCHECK(r->IsAllocated());
-    DCHECK_LE(thread->GetThreadLocalBytesAllocated(), kRegionSize);
-    r->RecordThreadLocalAllocations(thread->GetThreadLocalObjectsAllocated(),
-                                    thread->GetTlabEnd() - r->Begin());
-    DCHECK_GE(r->End(), thread->GetTlabPos());
-    DCHECK_LE(r->Begin(), thread->GetTlabPos());
     size_t remaining_bytes = r->End() - thread->GetTlabPos();
     if (reuse && remaining_bytes >= gc::Heap::kPartialTlabSize) {
-      partial_tlabs_.insert(std::make_pair(remaining_bytes, r));
+      // Return the TLAB to the cluster which has been allocating in it.
+      partial_tlabs_[r->cluster_].insert(std::make_pair(remaining_bytes, r));
+      num_partial_tlabs_.fetch_add(1u, std::memory_order_relaxed);
+    } else {
+      Runtime::Current()->GetMetrics()->TlabWastedBytes()->Add(remaining_bytes);
     }
   }
   thread->ResetTlab();
@@ -1038,7 +1263,29 @@ void RegionSpace::TraceHeapSize() {
   heap->TraceHeapSize(heap->GetBytesAllocated() + EvacBytes());
 }
 
+uint8_t RegionSpace::GetCurrentCluster() const {
+  if (num_clusters_ == 1) {
+    return 0;
+  }
+  int cpu = sched_getcpu();
+  if (UNLIKELY(cpu < 0 || static_cast<size_t>(cpu) >= cpu_clusters_.size())) {
+    return 0;
+  }
+  return cpu_clusters_[cpu];
+}
+
 RegionSpace::Region* RegionSpace::AllocateRegion(bool for_evac) {
+  const uint8_t cluster = GetCurrentCluster();
+  if (num_clusters_ > 1) {
+    Region* r = AllocateRegion(for_evac, cluster, /*local_only=*/ true);
+    if (r != nullptr) {
+      return r;
+    }
+  }
+  return AllocateRegion(for_evac, cluster, /*local_only=*/ false);
+}
+
+RegionSpace::Region* RegionSpace::AllocateRegion(bool for_evac, uint8_t cluster, bool local_only) {
   if (!for_evac && (num_non_free_regions_ + 1) * 2 > num_regions_) {
     return nullptr;
   }
@@ -1051,8 +1298,9 @@ RegionSpace::Region* RegionSpace::AllocateRegion(bool for_evac) {
         ? ((cyclic_alloc_region_index_ + i) % num_regions_)
         : i;
     Region* r = &regions_[region_index];
-    if (r->IsFree()) {
+    if (r->IsFree() && (!local_only || r->cluster_ == cluster)) {
       r->Unfree(this, time_);
+      r->cluster_ = cluster;
       if (use_generational_cc_) {
         // TODO: Add an explanation for this assertion.
         DCHECK_IMPLIES(for_evac, !r->is_newly_allocated_);
@@ -22,8 +22,10 @@
 #include "space.h"
 #include "thread.h"
 
+#include <array>
 #include <functional>
 #include <map>
+#include <vector>
 
 namespace art {
 namespace gc {
@@ -43,6 +45,14 @@ namespace space {
 // only enable it in debug mode.
 static constexpr bool kCyclicRegionAllocation = kIsDebugBuild;
 
+// Maximum number of CPU clusters tracked for cluster-local region allocation.
+// CPUs of any further clusters share the tracking of the first ones.
+static constexpr size_t kMaxRegionSpaceClusters = 4;
+
+// Number of free regions claimed in advance per cluster, so that TLAB refills
+// can be served without taking the region lock.
+static constexpr size_t kReservedTlabRegions = 4;
+
 // A space that consists of equal-sized regions.
 class RegionSpace final : public ContinuousMemMapAllocSpace {
  public:
@@ -387,6 +397,11 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
 
   void ReleaseFreeRegions();
 
+  // Advise the kernel that regions whose objects survived several collections, and whose cards
+  // stayed clean, are cold: MADV_PAGEOUT when swap is backed by zram, MADV_COLD otherwise.
+  // Returns the number of bytes advised.
+  size_t AdviseColdRegions() REQUIRES(!region_lock_);
+
  private:
   RegionSpace(const std::string& name, MemMap&& mem_map, bool use_generational_cc);
 
@@ -403,6 +418,7 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
           alloc_time_(0),
           is_newly_allocated_(false),
           is_a_tlab_(false),
+          cluster_(0),
           state_(RegionState::kRegionStateAllocated),
           type_(RegionType::kRegionTypeToSpace) {}
 
@@ -418,6 +434,7 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
       live_bytes_ = static_cast<size_t>(-1);
       is_newly_allocated_ = false;
       is_a_tlab_ = false;
+      cluster_ = 0;
       thread_ = nullptr;
       DCHECK_LT(begin, end);
       DCHECK_EQ(static_cast<size_t>(end - begin), kRegionSize);
@@ -639,6 +656,9 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     // special value for `live_bytes_`.
     bool is_newly_allocated_;           // True if it's allocated after the last collection.
     bool is_a_tlab_;                    // True if it's a tlab.
+    // The CPU cluster that last allocated in the region. Kept after the region is
+    // freed, as its memory is then still likely to be warm in that cluster's caches.
+    uint8_t cluster_;
     RegionState state_;                 // The region state (see RegionState).
     RegionType type_;                   // The region type (see RegionType).
 
@@ -715,8 +735,28 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     }
   }
 
+  // Allocate a free region, preferring the ones last used by the current CPU's cluster.
   Region* AllocateRegion(bool for_evac) REQUIRES(region_lock_);
+  // Allocate a free region for `cluster`. If `local_only` is true, only consider
+  // the free regions last used by `cluster`.
+  Region* AllocateRegion(bool for_evac, uint8_t cluster, bool local_only) REQUIRES(region_lock_);
+  // Returns the cluster of the CPU the calling thread is running on.
+  uint8_t GetCurrentCluster() const;
   void RevokeThreadLocalBuffersLocked(Thread* thread, bool reuse) REQUIRES(region_lock_);
+  // Record the allocations of `thread`'s TLAB in its region and return the
+  // region, or null if the thread has no TLAB. Doesn't reset the TLAB.
+  Region* RecordTlabAllocations(Thread* thread) NO_THREAD_SAFETY_ANALYSIS;
+  void SetTlab(Thread* self, Region* r, uint8_t* start, size_t tlab_size, uint8_t cluster);
+
+  // Try to refill the TLAB from the regions reserved for the current cluster
+  // without taking region_lock_. Returns false if the slow path must be taken.
+  bool AllocNewTlabLockFree(Thread* self, size_t tlab_size, size_t* bytes_tl_bulk_allocated)
+      REQUIRES(!region_lock_);
+  Region* PopReservedRegion(uint8_t cluster);
+  // Reserve up to kReservedTlabRegions free regions of `cluster` if it has none left.
+  void ReserveRegionsLocked(uint8_t cluster) REQUIRES(region_lock_);
+  // Free the reserved regions, which have never been allocated into.
+  void ReleaseReservedRegionsLocked() REQUIRES(region_lock_);
 
   // Scan region range [`begin`, `end`) in increasing order to try to
   // allocate a large region having a size of `num_regs_in_large_region`
@@ -766,9 +806,28 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   // The pointer to the region array.
   std::unique_ptr<Region[]> regions_ GUARDED_BY(region_lock_);
 
+  // Cluster index of each CPU, as found in the sysfs CPU topology.
+  std::vector<uint8_t> cpu_clusters_;
+  // Number of distinct clusters in `cpu_clusters_`, at most kMaxRegionSpaceClusters.
+  size_t num_clusters_;
+
   // To hold partially used TLABs which can be reassigned to threads later for
-  // utilizing the un-used portion.
-  std::multimap<size_t, Region*, std::greater<size_t>> partial_tlabs_ GUARDED_BY(region_lock_);
+  // utilizing the un-used portion. Kept per cluster of the thread that used them.
+  std::array<std::multimap<size_t, Region*, std::greater<size_t>>, kMaxRegionSpaceClusters>
+      partial_tlabs_ GUARDED_BY(region_lock_);
+  // Total number of entries in `partial_tlabs_`. Read without region_lock_ to
+  // decide whether a TLAB refill must go through the slow path to reuse them.
+  Atomic<size_t> num_partial_tlabs_;
+
+  // Free regions claimed under region_lock_ and handed out as TLABs without it.
+  struct ReservedRegions {
+    // The low 32 bits hold the number of available `regions`. The high 32 bits
+    // hold a generation which is incremented on every refill, so that a pop
+    // which read a stale entry fails its CAS.
+    Atomic<uint64_t> state{0u};
+    std::array<Atomic<Region*>, kReservedTlabRegions> regions;
+  };
+  std::array<ReservedRegions, kMaxRegionSpaceClusters> reserved_regions_;
   // The upper-bound index of the non-free regions. Used to avoid scanning all regions in
   // RegionSpace::SetFromSpace and RegionSpace::ClearFromSpace.
   //
@@ -664,6 +664,49 @@ template bool ShouldDenyAccessToMemberImpl<ArtMethod>(ArtMethod* member,
                                                       AccessMethod access_method);
 }  // namespace detail
 
+// Cache of the decisions on accesses from the application domain to hidden members of the boot
+// class path, which is never unloaded. Each entry holds the address of a member, the low bits of
+// the policy epoch the decision was made in, in the top byte, and whether access is denied, in
+// the lowest bit. Entries are replaced on collision.
+static constexpr size_t kAccessDecisionCacheSize = 1024u;
+static constexpr uint64_t kAccessDecisionDenied = 1u;
+static constexpr size_t kAccessDecisionEpochShift = 56u;
+static std::atomic<uint64_t> gAccessDecisionCache[kAccessDecisionCacheSize];
+
+static uint64_t GetAccessDecisionKey(Runtime* runtime, const void* member) {
+  uint64_t address = reinterpret_cast<uintptr_t>(member);
+  DCHECK_EQ(address >> kAccessDecisionEpochShift, 0u);
+  DCHECK_EQ(address & kAccessDecisionDenied, 0u);
+  uint64_t epoch = runtime->GetHiddenApiPolicyEpoch();
+  return address | (epoch << kAccessDecisionEpochShift);
+}
+
+static std::atomic<uint64_t>& GetAccessDecisionEntry(const void* member) {
+  // Members are at least 16 bytes apart.
+  return gAccessDecisionCache[(reinterpret_cast<uintptr_t>(member) >> 4) %
+                              kAccessDecisionCacheSize];
+}
+
+// Returns whether an access to a hidden member with `access_method` may warn, notify the
+// listener or be logged to the event log, which a cached decision would skip.
+static bool MayReportAccess(Runtime* runtime, AccessMethod access_method)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  if (access_method == AccessMethod::kNone) {
+    return false;
+  }
+  if (kLogAllAccesses || runtime->IsJavaDebuggable()) {
+    return true;
+  }
+  if (kIsTargetBuild && !kIsTargetLinux && runtime->GetHiddenApiEventLogSampleRate() != 0) {
+    return true;
+  }
+  if (access_method == AccessMethod::kReflection || access_method == AccessMethod::kJNI) {
+    ArtField* consumer_field = WellKnownClasses::dalvik_system_VMRuntime_nonSdkApiUsageConsumer;
+    return consumer_field->GetObject(consumer_field->GetDeclaringClass()) != nullptr;
+  }
+  return false;
+}
+
 template <typename T>
 bool ShouldDenyAccessToMember(T* member,
                               const std::function<AccessContext()>& fn_get_access_context,
@@ -727,6 +770,21 @@ bool ShouldDenyAccessToMember(T* member,
       // If this is a proxy method, look at the interface method instead.
       member = detail::GetInterfaceMemberIfProxy(member);
 
+      // Reuse an earlier decision for the member, unless the access denied by it must be
+      // reported again.
+      uint64_t decision_key = 0u;
+      if (member->GetDeclaringClass()->IsBootStrapClassLoaded()) {
+        decision_key = GetAccessDecisionKey(runtime, member);
+        uint64_t decision = GetAccessDecisionEntry(member).load(std::memory_order_relaxed);
+        if ((decision & ~kAccessDecisionDenied) == decision_key) {
+          bool deny_access = (decision & kAccessDecisionDenied) != 0u;
+          if (access_method == AccessMethod::kNone ||
+              (!deny_access && !MayReportAccess(runtime, access_method))) {
+            return deny_access;
+          }
+        }
+      }
+
       // Decode hidden API access flags from the dex file.
       // This is an O(N) operation scaling with the number of fields/methods
       // in the class. Only do this on slow path and only do it once.
@@ -734,7 +792,12 @@ bool ShouldDenyAccessToMember(T* member,
       DCHECK(api_list.IsValid());
 
       // Member is hidden and caller is not exempted. Enter slow path.
-      return detail::ShouldDenyAccessToMemberImpl(member, api_list, access_method);
+      bool deny_access = detail::ShouldDenyAccessToMemberImpl(member, api_list, access_method);
+      if (decision_key != 0u) {
+        GetAccessDecisionEntry(member).store(
+            decision_key | (deny_access ? kAccessDecisionDenied : 0u), std::memory_order_relaxed);
+      }
+      return deny_access;
     }
 
     case Domain::kPlatform: {
@@ -30,8 +30,10 @@
 #include <string.h>
 #include <sys/time.h>
 #include <sys/uio.h>
+#include <sys/wait.h>
 #include <time.h>
 #include <unistd.h>
+#include <zlib.h>
 
 #include <set>
 
@@ -385,11 +387,37 @@ class EndianOutputBuffered : public EndianOutput {
 
 class FileEndianOutput final : public EndianOutputBuffered {
  public:
-  FileEndianOutput(File* fp, size_t reserved_size)
-      : EndianOutputBuffered(reserved_size), fp_(fp), errors_(false) {
+  FileEndianOutput(File* fp, size_t reserved_size, HprofCompression compression)
+      : EndianOutputBuffered(reserved_size), fp_(fp), errors_(false), compressing_(false) {
     DCHECK(fp != nullptr);
+    if (compression == HprofCompression::kGzip) {
+      zstream_ = {};
+      // A window of 15 bits, plus 16 for a gzip header. The fastest level keeps the dump short.
+      errors_ = deflateInit2(&zstream_,
+                             Z_BEST_SPEED,
+                             Z_DEFLATED,
+                             /*windowBits=*/ 15 + 16,
+                             /*memLevel=*/ 8,
+                             Z_DEFAULT_STRATEGY) != Z_OK;
+      compressing_ = !errors_;
+      deflate_buffer_.resize(kDeflateBufferSize);
+    }
   }
   ~FileEndianOutput() {
+    if (compressing_) {
+      deflateEnd(&zstream_);
+    }
+  }
+
+  // Writes the end of the compressed stream, if any. Must be called after the last record.
+  void Finish() {
+    if (compressing_) {
+      if (!errors_) {
+        Deflate(nullptr, 0u, Z_FINISH);
+      }
+      deflateEnd(&zstream_);
+      compressing_ = false;
+    }
   }
 
   bool Errors() {
@@ -399,13 +427,40 @@ class FileEndianOutput final : public EndianOutputBuffered {
  protected:
   void HandleFlush(const uint8_t* buffer, size_t length) override {
     if (!errors_) {
-      errors_ = !fp_->WriteFully(buffer, length);
+      if (compressing_) {
+        Deflate(buffer, length, Z_NO_FLUSH);
+      } else {
+        errors_ = !fp_->WriteFully(buffer, length);
+      }
     }
   }
 
  private:
+  static constexpr size_t kDeflateBufferSize = 64 * KB;
+
+  void Deflate(const uint8_t* data, size_t length, int flush) {
+    zstream_.next_in = const_cast<Bytef*>(data);
+    zstream_.avail_in = length;
+    do {
+      zstream_.next_out = deflate_buffer_.data();
+      zstream_.avail_out = deflate_buffer_.size();
+      if (deflate(&zstream_, flush) == Z_STREAM_ERROR) {
+        errors_ = true;
+        return;
+      }
+      size_t deflated = deflate_buffer_.size() - zstream_.avail_out;
+      if (deflated != 0u && !fp_->WriteFully(deflate_buffer_.data(), deflated)) {
+        errors_ = true;
+        return;
+      }
+    } while (zstream_.avail_out == 0u);
+  }
+
   File* fp_;
   bool errors_;
+  bool compressing_;
+  z_stream zstream_;
+  std::vector<uint8_t> deflate_buffer_;
 };
 
 class VectorEndianOuputput final : public EndianOutputBuffered {
@@ -429,14 +484,20 @@ class VectorEndianOuputput final : public EndianOutputBuffered {
 
 class Hprof : public SingleRootVisitor {
  public:
-  Hprof(const char* output_filename, int fd, bool direct_to_ddms)
+  Hprof(const char* output_filename,
+        int fd,
+        bool direct_to_ddms,
+        const DumpHeapOptions& options = DumpHeapOptions())
       : filename_(output_filename),
         fd_(fd),
-        direct_to_ddms_(direct_to_ddms) {
+        direct_to_ddms_(direct_to_ddms),
+        options_(options) {
+    DCHECK(!direct_to_ddms || !options.streaming);
     LOG(INFO) << "hprof: heap dump \"" << filename_ << "\" starting...";
   }
 
-  void Dump()
+  // Returns whether the dump was written.
+  bool Dump()
     REQUIRES(Locks::mutator_lock_)
     REQUIRES(!Locks::heap_bitmap_lock_, !Locks::alloc_tracker_lock_) {
     {
@@ -446,8 +507,17 @@ class Hprof : public SingleRootVisitor {
       }
     }
 
-    // First pass to measure the size of the dump.
     size_t overall_size;
+    if (options_.streaming) {
+      // Records are flushed once complete, so the buffer only needs to hold one segment.
+      bool okay = DumpToFile(/*overall_size=*/ 0u, kMaxBytesPerSegment, &overall_size);
+      if (okay) {
+        LogCompletion(overall_size);
+      }
+      return okay;
+    }
+
+    // First pass to measure the size of the dump.
     size_t max_length;
     {
       EndianOutput count_output;
@@ -467,16 +537,13 @@ class Hprof : public SingleRootVisitor {
         okay = DumpToDdmsBuffered(overall_size, max_length);
       }
     } else {
-      okay = DumpToFile(overall_size, max_length);
+      okay = DumpToFile(overall_size, max_length, /*written_size=*/ nullptr);
     }
 
     if (okay) {
-      const uint64_t duration = NanoTime() - start_ns_;
-      LOG(INFO) << "hprof: heap dump completed (" << PrettySize(RoundUp(overall_size, KB))
-                << ") in " << PrettyDuration(duration)
-                << " objects " << total_objects_
-                << " objects with stack traces " << total_objects_with_stack_trace_;
+      LogCompletion(overall_size);
     }
+    return okay;
   }
 
  private:
@@ -514,6 +581,37 @@ class Hprof : public SingleRootVisitor {
     }
   }
 
+  // Writes the heap dump segments right after the fixed header, and the tables that they fill
+  // after them, so that the heap is only walked once.
+  void ProcessHeapStreaming() REQUIRES(Locks::mutator_lock_) {
+    current_heap_ = HPROF_HEAP_DEFAULT;
+    objects_in_segment_ = 0;
+
+    WriteFixedHeader();
+    ProcessBody();
+    // WriteStackTraces() can add strings, so the string table comes last.
+    WriteClassTable();
+    WriteStackTraces();
+    WriteStringTable();
+    output_->EndRecord();
+  }
+
+  void LogCompletion(size_t overall_size) {
+    const uint64_t duration = NanoTime() - start_ns_;
+    LOG(INFO) << "hprof: heap dump completed (" << PrettySize(RoundUp(overall_size, KB))
+              << ") in " << PrettyDuration(duration)
+              << " objects " << total_objects_
+              << " objects with stack traces " << total_objects_with_stack_trace_;
+  }
+
+  void ReportError(const std::string& msg) REQUIRES(Locks::mutator_lock_) {
+    // A forked child has no one to throw to, its parent reports the failure.
+    if (!options_.fork) {
+      ThrowRuntimeException("%s", msg.c_str());
+    }
+    LOG(ERROR) << msg;
+  }
+
   void ProcessBody() REQUIRES(Locks::mutator_lock_) {
     Runtime* const runtime = Runtime::Current();
     // Walk the roots and the heap.
@@ -751,21 +849,24 @@ class Hprof : public SingleRootVisitor {
     //        Dbg::DdmSendChunkV(CHUNK_TYPE("HPDS"), iov, 2);
   }
 
-  bool DumpToFile(size_t overall_size, size_t max_length)
+  // Writes the dump to the file. In streaming mode, `overall_size` is unknown and the
+  // uncompressed size of the dump is returned in `*written_size`.
+  bool DumpToFile(size_t overall_size, size_t max_length, /*out*/ size_t* written_size)
       REQUIRES(Locks::mutator_lock_) {
     // Where exactly are we writing to?
     int out_fd;
     if (fd_ >= 0) {
       out_fd = DupCloexec(fd_);
       if (out_fd < 0) {
-        ThrowRuntimeException("Couldn't dump heap; dup(%d) failed: %s", fd_, strerror(errno));
+        ReportError(android::base::StringPrintf(
+            "Couldn't dump heap; dup(%d) failed: %s", fd_, strerror(errno)));
         return false;
       }
     } else {
       out_fd = open(filename_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
       if (out_fd < 0) {
-        ThrowRuntimeException("Couldn't dump heap; open(\"%s\") failed: %s", filename_.c_str(),
-                              strerror(errno));
+        ReportError(android::base::StringPrintf(
+            "Couldn't dump heap; open(\"%s\") failed: %s", filename_.c_str(), strerror(errno)));
         return false;
       }
     }
@@ -773,16 +874,24 @@ class Hprof : public SingleRootVisitor {
     std::unique_ptr<File> file(new File(out_fd, filename_, true));
     bool okay;
     {
-      FileEndianOutput file_output(file.get(), max_length);
+      FileEndianOutput file_output(file.get(), max_length, options_.compression);
       output_ = &file_output;
-      ProcessHeap(true);
+      if (options_.streaming) {
+        ProcessHeapStreaming();
+      } else {
+        ProcessHeap(true);
+      }
+      file_output.Finish();
       okay = !file_output.Errors();
 
-      if (okay) {
+      if (okay && !options_.streaming) {
         // Check for expected size. Output is expected to be less-or-equal than first phase, see
         // b/23521263.
         DCHECK_LE(file_output.SumLength(), overall_size);
       }
+      if (written_size != nullptr) {
+        *written_size = file_output.SumLength();
+      }
       output_ = nullptr;
     }
 
@@ -792,11 +901,9 @@ class Hprof : public SingleRootVisitor {
       file->Erase();
     }
     if (!okay) {
-      std::string msg(android::base::StringPrintf("Couldn't dump heap; writing \"%s\" failed: %s",
-                                                  filename_.c_str(),
-                                                  strerror(errno)));
-      ThrowRuntimeException("%s", msg.c_str());
-      LOG(ERROR) << msg;
+      ReportError(android::base::StringPrintf("Couldn't dump heap; writing \"%s\" failed: %s",
+                                              filename_.c_str(),
+                                              strerror(errno)));
     }
 
     return okay;
@@ -871,6 +978,7 @@ class Hprof : public SingleRootVisitor {
   std::string filename_;
   int fd_;
   bool direct_to_ddms_;
+  const DumpHeapOptions options_;
 
   uint64_t start_ns_ = NanoTime();
 
@@ -1606,5 +1714,44 @@ void DumpHeap(const char* filename, int fd, bool direct_to_ddms) {
   hprof.Dump();
 }
 
+void DumpHeap(const char* filename, int fd, const DumpHeapOptions& options) {
+  CHECK(filename != nullptr);
+  Thread* self = Thread::Current();
+  pid_t pid;
+  {
+    gc::ScopedGCCriticalSection gcs(self,
+                                    gc::kGcCauseHprof,
+                                    gc::kCollectorTypeHprof);
+    ScopedSuspendAll ssa(__FUNCTION__, true /* long suspend */);
+    Hprof hprof(filename, fd, /*direct_to_ddms=*/ false, options);
+    if (!options.fork) {
+      hprof.Dump();
+      return;
+    }
+    // Like perfetto_hprof, fork while all threads are suspended: the child gets a consistent
+    // copy of the heap and this thread holds the mutator lock exclusively in it, so the child
+    // can walk the heap while the threads of the parent run.
+    pid = fork();
+    if (pid == 0) {
+      _exit(hprof.Dump() ? 0 : 1);
+    }
+    if (pid == -1) {
+      PLOG(WARNING) << "hprof: fork failed, dumping the heap in the process";
+      hprof.Dump();
+      return;
+    }
+  }
+
+  int status;
+  if (TEMP_FAILURE_RETRY(waitpid(pid, &status, 0)) != pid) {
+    PLOG(ERROR) << "hprof: waitpid failed";
+    status = -1;
+  }
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    ScopedObjectAccess soa(self);
+    ThrowRuntimeException("Couldn't dump heap in child process %d, status %d", pid, status);
+  }
+}
+
 }  // namespace hprof
 }  // namespace art
@@ -21,8 +21,27 @@ namespace art {
 
 namespace hprof {
 
+enum class HprofCompression {
+  kNone,
+  kGzip,
+};
+
+struct DumpHeapOptions {
+  // Walk the heap once and write the records as they are produced. The string, class and stack
+  // trace records then follow the heap dump segments that refer to them, which tools reading
+  // the whole dump before resolving ids accept, but jhat does not.
+  bool streaming = false;
+  // Dump the heap in a forked child, so that the other threads resume as soon as the child is
+  // forked. The calling thread still waits for the child to finish the dump.
+  bool fork = false;
+  HprofCompression compression = HprofCompression::kNone;
+};
+
 void DumpHeap(const char* filename, int fd, bool direct_to_ddms);
 
+// Dumps the heap to `fd`, or to `filename` if `fd` is negative.
+void DumpHeap(const char* filename, int fd, const DumpHeapOptions& options);
+
 }  // namespace hprof
 
 }  // namespace art
@@ -21,6 +21,7 @@
 #include <sstream>
 #include <sys/stat.h>
 #include <zlib.h>
+#include <zstd.h>
 
 #include "android-base/stringprintf.h"
 
@@ -33,9 +34,12 @@
 
 namespace art {
 
-const uint8_t ImageHeader::kImageMagic[] = { 'a', 'r', 't', '\n' };
-// Last change: Add DexCacheSection.
-const uint8_t ImageHeader::kImageVersion[] = { '1', '0', '8', '\0' };
+// Compression level of the zstd storage mode. Higher levels only slow down compression, the
+// decompression speed does not depend on the level.
+static constexpr int kZstdCompressionLevel = 19;
+
+// Last change: Add the hash mask to the IMT conflict tables.
+const uint8_t ImageHeader::kImageVersion[] = { '1', '1', '0', '\0' };
 
 ImageHeader::ImageHeader(uint32_t image_reservation_size,
                          uint32_t component_count,
@@ -196,6 +200,23 @@ bool LZ4_decompress_safe_checked(const char* source,
   }
 }
 
+bool ZSTD_decompress_checked(const uint8_t* source,
+                             uint8_t* dest,
+                             size_t compressed_size,
+                             size_t max_decompressed_size,
+                             /*out*/ size_t* decompressed_size_checked,
+                             /*out*/ std::string* error_msg) {
+  size_t decompressed_size = ZSTD_decompress(dest, max_decompressed_size, source, compressed_size);
+  if (UNLIKELY(ZSTD_isError(decompressed_size))) {
+    *error_msg = android::base::StringPrintf("ZSTD_decompress() failed: %s",
+                                             ZSTD_getErrorName(decompressed_size));
+    return false;
+  } else {
+    *decompressed_size_checked = decompressed_size;
+    return true;
+  }
+}
+
 bool ImageHeader::Block::Decompress(uint8_t* out_ptr,
                                     const uint8_t* in_ptr,
                                     std::string* error_msg) const {
@@ -222,6 +243,20 @@ bool ImageHeader::Block::Decompress(uint8_t* out_ptr,
       CHECK_EQ(decompressed_size, image_size_);
       break;
     }
+    case kStorageModeZstd: {
+      size_t decompressed_size;
+      bool ok = ZSTD_decompress_checked(in_ptr + data_offset_,
+                                        out_ptr + image_offset_,
+                                        data_size_,
+                                        image_size_,
+                                        &decompressed_size,
+                                        error_msg);
+      if (!ok) {
+        return false;
+      }
+      CHECK_EQ(decompressed_size, image_size_);
+      break;
+    }
     default: {
       if (error_msg != nullptr) {
         *error_msg = (std::ostringstream() << "Invalid image format " << storage_mode_).str();
@@ -281,6 +316,17 @@ static ArrayRef<const uint8_t> MaybeCompressData(ArrayRef<const uint8_t> source,
       storage->resize(data_size);
       break;
     }
+    case ImageHeader::kStorageModeZstd: {
+      storage->resize(ZSTD_compressBound(source.size()));
+      size_t data_size = ZSTD_compress(storage->data(),
+                                       storage->size(),
+                                       source.data(),
+                                       source.size(),
+                                       kZstdCompressionLevel);
+      CHECK(!ZSTD_isError(data_size)) << ZSTD_getErrorName(data_size);
+      storage->resize(data_size);
+      break;
+    }
     case ImageHeader::kStorageModeUncompressed: {
       return source;
     }
@@ -291,20 +337,27 @@ static ArrayRef<const uint8_t> MaybeCompressData(ArrayRef<const uint8_t> source,
   }
 
   DCHECK(image_storage_mode == ImageHeader::kStorageModeLZ4 ||
-         image_storage_mode == ImageHeader::kStorageModeLZ4HC);
+         image_storage_mode == ImageHeader::kStorageModeLZ4HC ||
+         image_storage_mode == ImageHeader::kStorageModeZstd);
   VLOG(image) << "Compressed from " << source.size() << " to " << storage->size() << " in "
               << PrettyDuration(NanoTime() - compress_start_time);
   if (kIsDebugBuild) {
     dchecked_vector<uint8_t> decompressed(source.size());
     size_t decompressed_size;
     std::string error_msg;
-    bool ok = LZ4_decompress_safe_checked(
-        reinterpret_cast<char*>(storage->data()),
-        reinterpret_cast<char*>(decompressed.data()),
-        storage->size(),
-        decompressed.size(),
-        &decompressed_size,
-        &error_msg);
+    bool ok = (image_storage_mode == ImageHeader::kStorageModeZstd)
+        ? ZSTD_decompress_checked(storage->data(),
+                                  decompressed.data(),
+                                  storage->size(),
+                                  decompressed.size(),
+                                  &decompressed_size,
+                                  &error_msg)
+        : LZ4_decompress_safe_checked(reinterpret_cast<char*>(storage->data()),
+                                      reinterpret_cast<char*>(decompressed.data()),
+                                      storage->size(),
+                                      decompressed.size(),
+                                      &decompressed_size,
+                                      &error_msg);
     if (!ok) {
       LOG(FATAL) << error_msg;
       UNREACHABLE();
@@ -82,6 +82,7 @@ class PACKED(8) ImageHeader {
     kStorageModeUncompressed,
     kStorageModeLZ4,
     kStorageModeLZ4HC,
+    kStorageModeZstd,
     kStorageModeCount,  // Number of elements in enum.
   };
   static constexpr StorageMode kDefaultStorageMode = kStorageModeUncompressed;
@@ -245,6 +246,9 @@ class PACKED(8) ImageHeader {
     kOomeWhenHandlingStackOverflow,   // Pre-allocated OOME when handling StackOverflowError.
     kNoClassDefFoundError,            // Pre-allocated NoClassDefFoundError.
     kClearedJniWeakSentinel,          // Pre-allocated sentinel for cleared weak JNI references.
+    kWellKnownMemberClasses,          // Declaring classes of the WellKnownClasses members, or
+                                      // null if they are not all in the boot image.
+    kWellKnownMemberIndexes,          // Indexes of the WellKnownClasses members in the classes.
     kIntrinsicObjectsStart
   };
 
@@ -604,6 +608,14 @@ bool LZ4_decompress_safe_checked(const char* source,
                                  /*out*/ size_t* decompressed_size_checked,
                                  /*out*/ std::string* error_msg);
 
+// Wrapper over ZSTD_decompress() that checks for errors.
+bool ZSTD_decompress_checked(const uint8_t* source,
+                             uint8_t* dest,
+                             size_t compressed_size,
+                             size_t max_decompressed_size,
+                             /*out*/ size_t* decompressed_size_checked,
+                             /*out*/ std::string* error_msg);
+
 }  // namespace art
 
 #endif  // ART_RUNTIME_IMAGE_H_
@@ -18,9 +18,11 @@
 #define ART_RUNTIME_IMT_CONFLICT_TABLE_H_
 
 #include <cstddef>
+#include <utility>
 
 #include "base/casts.h"
 #include "base/enums.h"
+#include "base/logging.h"
 #include "base/macros.h"
 
 namespace art {
@@ -29,9 +31,15 @@ class ArtMethod;
 
 // Table to resolve IMT conflicts at runtime. The table is attached to
 // the jni entrypoint of IMT conflict ArtMethods.
-// The table contains a list of pairs of { interface_method, implementation_method }
-// with the last entry being null to make an assembly implementation of a lookup
-// faster.
+// The table starts with a pointer-sized hash mask followed by slots of pairs of
+// { interface_method, implementation_method }. A lookup starts at the slot at byte offset
+// `(interface_method << 1) & hash_mask` and scans forward until it finds the interface method
+// or a null slot, which is what the assembly stubs do.
+// Small tables have a zero hash mask, so they are a plain list of pairs with the last entry
+// being null. Tables that grow past kHashedTableMinEntries are rebuilt with a power-of-two
+// number of home slots at most half full. Probing does not wrap around: entries that do not
+// fit in the home slots spill into a contiguous tail, which is followed by the null marker.
+// Tables in images are always linear, as the hash depends on the method addresses.
 class ImtConflictTable {
   enum MethodIndex {
     kMethodInterface,
@@ -40,31 +48,54 @@ class ImtConflictTable {
   };
 
  public:
+  // Tables with at least this number of entries use the hashed layout.
+  static constexpr size_t kHashedTableMinEntries = 8u;
+
   // Build a new table copying `other` and adding the new entry formed of
-  // the pair { `interface_method`, `implementation_method` }
+  // the pair { `interface_method`, `implementation_method` }. The table needs
+  // ComputeSizeWithOneMoreEntry(`other`) bytes.
   ImtConflictTable(ImtConflictTable* other,
                    ArtMethod* interface_method,
                    ArtMethod* implementation_method,
                    PointerSize pointer_size) {
-    const size_t count = other->NumEntries(pointer_size);
-    for (size_t i = 0; i < count; ++i) {
-      SetInterfaceMethod(i, pointer_size, other->GetInterfaceMethod(i, pointer_size));
-      SetImplementationMethod(i, pointer_size, other->GetImplementationMethod(i, pointer_size));
+    const size_t count = other->NumEntries(pointer_size) + 1u;
+    if (count < kHashedTableMinEntries) {
+      SetHashMask(0u, pointer_size);
+      size_t index = 0u;
+      other->Visit([&](const std::pair<ArtMethod*, ArtMethod*>& methods) {
+        SetInterfaceMethod(index, pointer_size, methods.first);
+        SetImplementationMethod(index, pointer_size, methods.second);
+        ++index;
+        return methods;
+      }, pointer_size);
+      SetInterfaceMethod(index, pointer_size, interface_method);
+      SetImplementationMethod(index, pointer_size, implementation_method);
+      // Add the null marker.
+      SetInterfaceMethod(index + 1u, pointer_size, nullptr);
+      SetImplementationMethod(index + 1u, pointer_size, nullptr);
+      return;
+    }
+    const size_t capacity = ComputeHashedCapacity(count);
+    for (size_t i = 0, num_slots = capacity + count; i != num_slots; ++i) {
+      SetInterfaceMethod(i, pointer_size, nullptr);
+      SetImplementationMethod(i, pointer_size, nullptr);
     }
-    SetInterfaceMethod(count, pointer_size, interface_method);
-    SetImplementationMethod(count, pointer_size, implementation_method);
-    // Add the null marker.
-    SetInterfaceMethod(count + 1, pointer_size, nullptr);
-    SetImplementationMethod(count + 1, pointer_size, nullptr);
+    SetHashMask((capacity - 1u) * EntrySize(pointer_size), pointer_size);
+    other->Visit([&](const std::pair<ArtMethod*, ArtMethod*>& methods) {
+      Insert(methods.first, methods.second, pointer_size);
+      return methods;
+    }, pointer_size);
+    Insert(interface_method, implementation_method, pointer_size);
   }
 
-  // num_entries excludes the header.
+  // Build a linear table. num_entries excludes the null marker.
   ImtConflictTable(size_t num_entries, PointerSize pointer_size) {
+    SetHashMask(0u, pointer_size);
     SetInterfaceMethod(num_entries, pointer_size, nullptr);
     SetImplementationMethod(num_entries, pointer_size, nullptr);
   }
 
-  // Set an entry at an index.
+  // Set an entry at a slot index. Slots of hashed tables may be empty.
   void SetInterfaceMethod(size_t index, PointerSize pointer_size, ArtMethod* method) {
     SetMethod(index * kMethodCount + kMethodInterface, pointer_size, method);
   }
@@ -89,10 +120,18 @@ class ImtConflictTable {
     return AddressOfMethod(index * kMethodCount + kMethodImplementation, pointer_size);
   }
 
+  // Whether the table uses the hashed layout.
+  bool IsHashed(PointerSize pointer_size) const {
+    return GetHashMask(pointer_size) != 0u;
+  }
+
   // Return true if two conflict tables are the same.
   bool Equals(ImtConflictTable* other, PointerSize pointer_size) const {
-    size_t num = NumEntries(pointer_size);
-    if (num != other->NumEntries(pointer_size)) {
+    if (GetHashMask(pointer_size) != other->GetHashMask(pointer_size)) {
+      return false;
+    }
+    size_t num = NumSlots(pointer_size);
+    if (num != other->NumSlots(pointer_size)) {
       return false;
     }
     for (size_t i = 0; i < num; ++i) {
@@ -107,32 +146,33 @@ class ImtConflictTable {
 
   // Visit all of the entries.
   // NO_THREAD_SAFETY_ANALYSIS for calling with held locks. Visitor is passed a pair of ArtMethod*
-  // and also returns one. The order is <interface, implementation>.
+  // and also returns one. The order is <interface, implementation>. The interface methods of
+  // hashed tables cannot be updated, as they determine the slots.
   template<typename Visitor>
   void Visit(const Visitor& visitor, PointerSize pointer_size) NO_THREAD_SAFETY_ANALYSIS {
-    uint32_t table_index = 0;
-    for (;;) {
+    const size_t num_slots = NumSlots(pointer_size);
+    for (size_t table_index = 0; table_index != num_slots; ++table_index) {
       ArtMethod* interface_method = GetInterfaceMethod(table_index, pointer_size);
       if (interface_method == nullptr) {
-        break;
+        continue;
       }
       ArtMethod* implementation_method = GetImplementationMethod(table_index, pointer_size);
       auto input = std::make_pair(interface_method, implementation_method);
       std::pair<ArtMethod*, ArtMethod*> updated = visitor(input);
       if (input.first != updated.first) {
+        DCHECK(!IsHashed(pointer_size));
         SetInterfaceMethod(table_index, pointer_size, updated.first);
       }
       if (input.second != updated.second) {
         SetImplementationMethod(table_index, pointer_size, updated.second);
       }
-      ++table_index;
     }
   }
 
   // Lookup the implementation ArtMethod associated to `interface_method`. Return null
   // if not found.
   ArtMethod* Lookup(ArtMethod* interface_method, PointerSize pointer_size) const {
-    uint32_t table_index = 0;
+    uint32_t table_index = HomeSlot(interface_method, pointer_size);
     for (;;) {
       ArtMethod* current_interface_method = GetInterfaceMethod(table_index, pointer_size);
       if (current_interface_method == nullptr) {
@@ -148,7 +188,24 @@ class ImtConflictTable {
 
   // Compute the number of entries in this table.
   size_t NumEntries(PointerSize pointer_size) const {
-    uint32_t table_index = 0;
+    if (!IsHashed(pointer_size)) {
+      return NumSlots(pointer_size);
+    }
+    size_t count = 0u;
+    for (size_t i = 0, num_slots = NumSlots(pointer_size); i != num_slots; ++i) {
+      if (GetInterfaceMethod(i, pointer_size) != nullptr) {
+        ++count;
+      }
+    }
+    return count;
+  }
+
+  // Compute the number of slots before the null marker, including the empty slots of
+  // hashed tables.
+  size_t NumSlots(PointerSize pointer_size) const {
+    // The tail of a hashed table after the home slots has no empty slots.
+    uint32_t table_index =
+        IsHashed(pointer_size) ? GetHashMask(pointer_size) / EntrySize(pointer_size) + 1u : 0u;
     while (GetInterfaceMethod(table_index, pointer_size) != nullptr) {
       ++table_index;
     }
@@ -157,52 +214,108 @@ class ImtConflictTable {
 
   // Compute the size in bytes taken by this table.
   size_t ComputeSize(PointerSize pointer_size) const {
-    // Add the end marker.
-    return ComputeSize(NumEntries(pointer_size), pointer_size);
+    return HeaderSize(pointer_size) + (NumSlots(pointer_size) + 1u) * EntrySize(pointer_size);
   }
 
   // Compute the size in bytes needed for copying the given `table` and add
   // one more entry.
   static size_t ComputeSizeWithOneMoreEntry(ImtConflictTable* table, PointerSize pointer_size) {
-    return table->ComputeSize(pointer_size) + EntrySize(pointer_size);
+    const size_t count = table->NumEntries(pointer_size) + 1u;
+    if (count < kHashedTableMinEntries) {
+      return ComputeSize(count, pointer_size);
+    }
+    // Reserve enough slots for the tail of the worst case, where all entries have the last
+    // home slot. The null marker follows the tail.
+    const size_t num_slots = ComputeHashedCapacity(count) + count;
+    return HeaderSize(pointer_size) + num_slots * EntrySize(pointer_size);
   }
 
-  // Compute size with a fixed number of entries.
+  // Compute size of a linear table with a fixed number of entries.
   static size_t ComputeSize(size_t num_entries, PointerSize pointer_size) {
-    return (num_entries + 1) * EntrySize(pointer_size);  // Add one for null terminator.
+    // Add one for null terminator.
+    return HeaderSize(pointer_size) + (num_entries + 1) * EntrySize(pointer_size);
   }
 
   static size_t EntrySize(PointerSize pointer_size) {
     return static_cast<size_t>(pointer_size) * static_cast<size_t>(kMethodCount);
   }
 
+  static size_t HeaderSize(PointerSize pointer_size) {
+    return static_cast<size_t>(pointer_size);
+  }
+
  private:
+  // The number of home slots of a hashed table with `count` entries, at most half full.
+  static size_t ComputeHashedCapacity(size_t count) {
+    size_t capacity = 1u;
+    while (capacity < 2u * count) {
+      capacity *= 2u;
+    }
+    return capacity;
+  }
+
+  uint32_t HomeSlot(ArtMethod* interface_method, PointerSize pointer_size) const {
+    // Match the assembly stubs, which compute the byte offset in pointer-sized registers.
+    uint64_t offset = (reinterpret_cast<uintptr_t>(interface_method) << 1) &
+                      GetHashMask(pointer_size);
+    return static_cast<uint32_t>(offset / EntrySize(pointer_size));
+  }
+
+  void Insert(ArtMethod* interface_method,
+              ArtMethod* implementation_method,
+              PointerSize pointer_size) {
+    uint32_t table_index = HomeSlot(interface_method, pointer_size);
+    while (GetInterfaceMethod(table_index, pointer_size) != nullptr) {
+      DCHECK_NE(GetInterfaceMethod(table_index, pointer_size), interface_method);
+      ++table_index;
+    }
+    SetInterfaceMethod(table_index, pointer_size, interface_method);
+    SetImplementationMethod(table_index, pointer_size, implementation_method);
+  }
+
+  uint64_t GetHashMask(PointerSize pointer_size) const {
+    if (pointer_size == PointerSize::k64) {
+      return data64_[0];
+    } else {
+      return data32_[0];
+    }
+  }
+
+  void SetHashMask(uint64_t hash_mask, PointerSize pointer_size) {
+    if (pointer_size == PointerSize::k64) {
+      data64_[0] = hash_mask;
+    } else {
+      data32_[0] = dchecked_integral_cast<uint32_t>(hash_mask);
+    }
+  }
+
   void** AddressOfMethod(size_t index, PointerSize pointer_size) {
+    // Skip the hash mask.
     if (pointer_size == PointerSize::k64) {
-      return reinterpret_cast<void**>(&data64_[index]);
+      return reinterpret_cast<void**>(&data64_[index + 1u]);
     } else {
-      return reinterpret_cast<void**>(&data32_[index]);
+      return reinterpret_cast<void**>(&data32_[index + 1u]);
     }
   }
 
   ArtMethod* GetMethod(size_t index, PointerSize pointer_size) const {
     if (pointer_size == PointerSize::k64) {
-      return reinterpret_cast64<ArtMethod*>(data64_[index]);
+      return reinterpret_cast64<ArtMethod*>(data64_[index + 1u]);
     } else {
-      return reinterpret_cast32<ArtMethod*>(data32_[index]);
+      return reinterpret_cast32<ArtMethod*>(data32_[index + 1u]);
     }
   }
 
   void SetMethod(size_t index, PointerSize pointer_size, ArtMethod* method) {
     if (pointer_size == PointerSize::k64) {
-      data64_[index] = reinterpret_cast64<uint64_t>(method);
+      data64_[index + 1u] = reinterpret_cast64<uint64_t>(method);
     } else {
-      data32_[index] = reinterpret_cast32<uint32_t>(method);
+      data32_[index + 1u] = reinterpret_cast32<uint32_t>(method);
     }
   }
 
-  // Array of entries that the assembly stubs will iterate over. Note that this is
-  // not fixed size, and we allocate data prior to calling the constructor
+  // The hash mask and the array of entries that the assembly stubs will iterate over. Note
+  // that this is not fixed size, and we allocate data prior to calling the constructor
   // of ImtConflictTable.
   union {
     uint32_t data32_[0];
@@ -16,6 +16,7 @@
 
 #include "instrumentation.h"
 
+#include <algorithm>
 #include <functional>
 #include <optional>
 #include <sstream>
@@ -114,6 +115,7 @@ Instrumentation::Instrumentation()
       have_method_entry_listeners_(0),
       have_method_exit_listeners_(0),
       have_method_unwind_listeners_(false),
+      have_selective_method_listeners_(false),
       have_dex_pc_listeners_(false),
       have_field_read_listeners_(false),
       have_field_write_listeners_(false),
@@ -1163,7 +1165,7 @@ std::string Instrumentation::EntryPointString(const void* code) {
 }
 
 void Instrumentation::UpdateMethodsCodeImpl(ArtMethod* method, const void* new_code) {
-  if (!EntryExitStubsInstalled()) {
+  if (!EntryExitStubsInstalled() && !IsSelectivelyTraced(method)) {
     // Fast path: no instrumentation.
     DCHECK(!IsDeoptimized(method));
     UpdateEntryPoints(method, new_code);
@@ -1214,17 +1216,21 @@ void Instrumentation::UpdateMethodsCode(ArtMethod* method, const void* new_code)
 }
 
 bool Instrumentation::AddDeoptimizedMethod(ArtMethod* method) {
-  if (IsDeoptimizedMethod(method)) {
-    // Already in the map. Return.
-    return false;
-  }
-  // Not found. Add it.
-  deoptimized_methods_.insert(method);
-  return true;
+  // Returns false if the method is already in the set.
+  return deoptimized_methods_.insert(method).second;
 }
 
 bool Instrumentation::IsDeoptimizedMethod(ArtMethod* method) {
-  return deoptimized_methods_.find(method) != deoptimized_methods_.end();
+  if (deoptimized_methods_.empty()) {
+    return false;
+  }
+  if (deoptimized_methods_.find(method) != deoptimized_methods_.end()) {
+    return true;
+  }
+  // The copies of a deoptimized default method in the implementing classes are deoptimized too.
+  // This also gives the copies in classes linked later the interpreter bridge.
+  return method->IsCopied() &&
+         deoptimized_methods_.find(method->GetCanonicalMethod()) != deoptimized_methods_.end();
 }
 
 bool Instrumentation::RemoveDeoptimizedMethod(ArtMethod* method) {
@@ -1236,6 +1242,32 @@ bool Instrumentation::RemoveDeoptimizedMethod(ArtMethod* method) {
   return true;
 }
 
+// Calls `fn` for the invokable copies of the default interface method `method` in the classes
+// that implement the interface without overriding the method.
+template <typename Fn>
+static void VisitCopiesOfDefaultMethod(ArtMethod* method, Fn fn)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  if (!method->IsDefault()) {
+    return;
+  }
+  const DexFile* dex_file = method->GetDexFile();
+  uint32_t method_idx = method->GetDexMethodIndex();
+  auto visitor = [&](ObjPtr<mirror::Class> klass) REQUIRES_SHARED(Locks::mutator_lock_) {
+    for (ArtMethod& copy : klass->GetCopiedMethods(kRuntimePointerSize)) {
+      // Compare the dex method index first, GetCanonicalMethod() searches the interface.
+      if (copy.GetDexMethodIndex() == method_idx &&
+          copy.IsInvokable() &&
+          copy.GetDexFile() == dex_file &&
+          copy.GetCanonicalMethod() == method) {
+        fn(&copy);
+      }
+    }
+    return true;
+  };
+  ClassFuncVisitor<decltype(visitor)> class_visitor(visitor);
+  Runtime::Current()->GetClassLinker()->VisitClasses(&class_visitor);
+}
+
 void Instrumentation::Deoptimize(ArtMethod* method) {
   CHECK(!method->IsNative());
   CHECK(!method->IsProxyMethod());
@@ -1249,6 +1281,11 @@ void Instrumentation::Deoptimize(ArtMethod* method) {
   }
   if (!InterpreterStubsInstalled()) {
     UpdateEntryPoints(method, GetQuickToInterpreterBridge());
+    // Deoptimize the copies of a default method instead of all methods, so that a breakpoint
+    // in a default method only slows down that method.
+    VisitCopiesOfDefaultMethod(method, [](ArtMethod* copy) REQUIRES_SHARED(Locks::mutator_lock_) {
+      UpdateEntryPoints(copy, GetQuickToInterpreterBridge());
+    });
 
     // Instrument thread stacks to request a check if the caller needs a deoptimization.
     // This isn't a strong deopt. We deopt this method if it is still in the deopt methods list.
@@ -1283,6 +1320,20 @@ void Instrumentation::Undeoptimize(ArtMethod* method) {
   }
 
   // We are not using interpreter stubs for deoptimization. Restore the code of the method.
+  RestoreMethodEntryPoints(method);
+  VisitCopiesOfDefaultMethod(method, [this](ArtMethod* copy) REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (!copy->IsObsolete()) {
+      RestoreMethodEntryPoints(copy);
+    }
+  });
+
+  // If there is no deoptimized method left, we can restore the stack of each thread.
+  if (!EntryExitStubsInstalled()) {
+    MaybeRestoreInstrumentationStack();
+  }
+}
+
+void Instrumentation::RestoreMethodEntryPoints(ArtMethod* method) {
   // We still retain interpreter bridge if we need it for other reasons.
   if (InterpretOnly(method)) {
     UpdateEntryPoints(method, GetQuickToInterpreterBridge());
@@ -1291,11 +1342,6 @@ void Instrumentation::Undeoptimize(ArtMethod* method) {
   } else {
     UpdateEntryPoints(method, GetMaybeInstrumentedCodeForInvoke(method));
   }
-
-  // If there is no deoptimized method left, we can restore the stack of each thread.
-  if (!EntryExitStubsInstalled()) {
-    MaybeRestoreInstrumentationStack();
-  }
 }
 
 bool Instrumentation::IsDeoptimizedMethodsEmpty() const {
@@ -1304,7 +1350,70 @@ bool Instrumentation::IsDeoptimizedMethodsEmpty() const {
 
 bool Instrumentation::IsDeoptimized(ArtMethod* method) {
   DCHECK(method != nullptr);
-  return IsDeoptimizedMethod(method);
+  return IsDeoptimizedMethod(method) || IsSelectivelyTraced(method);
+}
+
+void Instrumentation::AddSelectiveMethodListener(InstrumentationListener* listener,
+                                                 ArrayRef<ArtMethod* const> methods) {
+  Locks::mutator_lock_->AssertExclusiveHeld(Thread::Current());
+  DCHECK(listener != nullptr);
+  // Reuse the slot of a removed listener if there is one.
+  auto it = std::find_if(selective_method_listeners_.begin(),
+                         selective_method_listeners_.end(),
+                         [](const SelectiveMethodListener& entry) {
+                           return entry.listener == nullptr;
+                         });
+  if (it == selective_method_listeners_.end()) {
+    it = selective_method_listeners_.emplace(selective_method_listeners_.end());
+  }
+  it->listener = listener;
+  for (ArtMethod* method : methods) {
+    if (!method->IsInvokable() ||
+        method->IsNative() ||
+        method->IsProxyMethod() ||
+        method->IsObsolete() ||
+        IsProxyInit(method)) {
+      continue;
+    }
+    if (!it->methods.insert(method).second) {
+      continue;
+    }
+    if (selectively_traced_methods_[method]++ == 0u &&
+        !InterpreterStubsInstalled() &&
+        !IsDeoptimizedMethod(method)) {
+      // Run the method with the interpreter, which reports the method events. Already executing
+      // invocations are left alone, so we don't need to instrument the thread stacks.
+      UpdateEntryPoints(method, GetQuickToInterpreterBridge());
+    }
+  }
+  have_selective_method_listeners_ = !selectively_traced_methods_.empty();
+}
+
+void Instrumentation::RemoveSelectiveMethodListener(InstrumentationListener* listener) {
+  Locks::mutator_lock_->AssertExclusiveHeld(Thread::Current());
+  auto it = std::find_if(selective_method_listeners_.begin(),
+                         selective_method_listeners_.end(),
+                         [listener](const SelectiveMethodListener& entry) {
+                           return entry.listener == listener;
+                         });
+  if (it == selective_method_listeners_.end()) {
+    return;
+  }
+  it->listener = nullptr;
+  std::unordered_set<ArtMethod*> methods;
+  methods.swap(it->methods);
+  for (ArtMethod* method : methods) {
+    auto traced = selectively_traced_methods_.find(method);
+    DCHECK(traced != selectively_traced_methods_.end());
+    if (--traced->second != 0u) {
+      continue;
+    }
+    selectively_traced_methods_.erase(traced);
+    if (!InterpreterStubsInstalled() && !IsDeoptimizedMethod(method) && !method->IsObsolete()) {
+      RestoreMethodEntryPoints(method);
+    }
+  }
+  have_selective_method_listeners_ = !selectively_traced_methods_.empty();
 }
 
 void Instrumentation::DisableDeoptimization(const char* key) {
@@ -1410,6 +1519,13 @@ const void* Instrumentation::GetMaybeInstrumentedCodeForInvoke(ArtMethod* method
 
 void Instrumentation::MethodEnterEventImpl(Thread* thread, ArtMethod* method) const {
   DCHECK(!method->IsRuntimeMethod());
+  if (UNLIKELY(IsSelectivelyTraced(method))) {
+    for (const SelectiveMethodListener& entry : selective_method_listeners_) {
+      if (entry.listener != nullptr && entry.methods.find(method) != entry.methods.end()) {
+        entry.listener->MethodEntered(thread, method);
+      }
+    }
+  }
   if (HasMethodEntryListeners()) {
     for (InstrumentationListener* listener : method_entry_slow_listeners_) {
       if (listener != nullptr) {
@@ -1429,6 +1545,13 @@ void Instrumentation::MethodExitEventImpl(Thread* thread,
                                           ArtMethod* method,
                                           OptionalFrame frame,
                                           MutableHandle<mirror::Object>& return_value) const {
+  if (UNLIKELY(IsSelectivelyTraced(method))) {
+    for (const SelectiveMethodListener& entry : selective_method_listeners_) {
+      if (entry.listener != nullptr && entry.methods.find(method) != entry.methods.end()) {
+        entry.listener->MethodExited(thread, method, frame, return_value);
+      }
+    }
+  }
   if (HasMethodExitListeners()) {
     for (InstrumentationListener* listener : method_exit_slow_listeners_) {
       if (listener != nullptr) {
@@ -1447,11 +1570,18 @@ template<> void Instrumentation::MethodExitEventImpl(Thread* thread,
                                                      ArtMethod* method,
                                                      OptionalFrame frame,
                                                      JValue& return_value) const {
-  if (HasMethodExitListeners()) {
+  if (HasMethodExitListeners() || IsSelectivelyTraced(method)) {
     Thread* self = Thread::Current();
     StackHandleScope<1> hs(self);
     if (method->GetInterfaceMethodIfProxy(kRuntimePointerSize)->GetReturnTypePrimitive() !=
         Primitive::kPrimNot) {
+      if (UNLIKELY(IsSelectivelyTraced(method))) {
+        for (const SelectiveMethodListener& entry : selective_method_listeners_) {
+          if (entry.listener != nullptr && entry.methods.find(method) != entry.methods.end()) {
+            entry.listener->MethodExited(thread, method, frame, return_value);
+          }
+        }
+      }
       for (InstrumentationListener* listener : method_exit_slow_listeners_) {
         if (listener != nullptr) {
           listener->MethodExited(thread, method, frame, return_value);
@@ -1473,6 +1603,13 @@ template<> void Instrumentation::MethodExitEventImpl(Thread* thread,
 void Instrumentation::MethodUnwindEvent(Thread* thread,
                                         ArtMethod* method,
                                         uint32_t dex_pc) const {
+  if (UNLIKELY(IsSelectivelyTraced(method))) {
+    for (const SelectiveMethodListener& entry : selective_method_listeners_) {
+      if (entry.listener != nullptr && entry.methods.find(method) != entry.methods.end()) {
+        entry.listener->MethodUnwind(thread, method, dex_pc);
+      }
+    }
+  }
   if (HasMethodUnwindListeners()) {
     for (InstrumentationListener* listener : method_unwind_listeners_) {
       if (listener != nullptr) {
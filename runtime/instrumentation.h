@@ -24,9 +24,11 @@
 #include <memory>
 #include <optional>
 #include <queue>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "arch/instruction_set.h"
+#include "base/array_ref.h"
 #include "base/enums.h"
 #include "base/locks.h"
 #include "base/macros.h"
@@ -245,6 +247,23 @@ class Instrumentation {
                       bool is_trace_listener = false)
       REQUIRES(Locks::mutator_lock_, !Locks::thread_list_lock_, !Locks::classlinker_classes_lock_);
 
+  // Add a listener to be notified of the method entry, exit and unwind events of `methods` only.
+  // Unlike AddListener this does not install entry / exit hooks for all methods: the selected
+  // methods are executed with the interpreter, which reports their events, and all other methods
+  // keep running with nterp or compiled code. The caller selects the methods, for example all the
+  // methods of a class or the methods matching a name pattern. Native, proxy and non-invokable
+  // methods are ignored. Invocations that are already on the stack when the listener is added, or
+  // that compiled code inlined into its caller, are not reported. The listener must be removed
+  // before the classes of `methods` can be unloaded.
+  void AddSelectiveMethodListener(InstrumentationListener* listener,
+                                  ArrayRef<ArtMethod* const> methods)
+      REQUIRES(Locks::mutator_lock_);
+
+  // Removes a listener added with AddSelectiveMethodListener and restores the entrypoints of the
+  // methods that no other selective listener is interested in.
+  void RemoveSelectiveMethodListener(InstrumentationListener* listener)
+      REQUIRES(Locks::mutator_lock_);
+
   // Calls UndeoptimizeEverything which may visit class linker classes through ConfigureStubs.
   void DisableDeoptimization(const char* key)
       REQUIRES(Locks::mutator_lock_, Roles::uninterruptible_);
@@ -279,17 +298,27 @@ class Instrumentation {
 
   // Deoptimize a method by forcing its execution with the interpreter. Nevertheless, a static
   // method (except a class initializer) set to the resolution trampoline will be deoptimized only
-  // once its declaring class is initialized.
-  void Deoptimize(ArtMethod* method) REQUIRES(Locks::mutator_lock_, !Locks::thread_list_lock_);
+  // once its declaring class is initialized. Deoptimizing a default interface method also
+  // deoptimizes its copies in the implementing classes.
+  void Deoptimize(ArtMethod* method)
+      REQUIRES(Locks::mutator_lock_, !Locks::thread_list_lock_, !Locks::classlinker_classes_lock_);
 
   // Undeoptimze the method by restoring its entrypoints. Nevertheless, a static method
   // (except a class initializer) set to the resolution trampoline will be updated only once its
   // declaring class is initialized.
-  void Undeoptimize(ArtMethod* method) REQUIRES(Locks::mutator_lock_, !Locks::thread_list_lock_);
+  void Undeoptimize(ArtMethod* method)
+      REQUIRES(Locks::mutator_lock_, !Locks::thread_list_lock_, !Locks::classlinker_classes_lock_);
 
-  // Indicates whether the method has been deoptimized so it is executed with the interpreter.
+  // Indicates whether the method has been deoptimized or is selected by a selective method
+  // listener, so it is executed with the interpreter.
   bool IsDeoptimized(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Indicates whether a selective method listener is registered for the method.
+  bool IsSelectivelyTraced(ArtMethod* method) const REQUIRES_SHARED(Locks::mutator_lock_) {
+    return have_selective_method_listeners_ &&
+           selectively_traced_methods_.find(method) != selectively_traced_methods_.end();
+  }
+
   // Indicates if any method needs to be deoptimized. This is used to avoid walking the stack to
   // determine if a deoptimization is required.
   bool IsDeoptimizedMethodsEmpty() const REQUIRES_SHARED(Locks::mutator_lock_);
@@ -382,6 +411,10 @@ class Instrumentation {
     return have_method_unwind_listeners_;
   }
 
+  bool HasSelectiveMethodListeners() const REQUIRES_SHARED(Locks::mutator_lock_) {
+    return have_selective_method_listeners_;
+  }
+
   bool HasDexPcListeners() const REQUIRES_SHARED(Locks::mutator_lock_) {
     return have_dex_pc_listeners_;
   }
@@ -435,7 +468,7 @@ class Instrumentation {
   // listeners into executing code and get method enter events for methods already on the stack.
   void MethodEnterEvent(Thread* thread, ArtMethod* method) const
       REQUIRES_SHARED(Locks::mutator_lock_) {
-    if (UNLIKELY(HasMethodEntryListeners())) {
+    if (UNLIKELY(HasMethodEntryListeners() || HasSelectiveMethodListeners())) {
       MethodEnterEventImpl(thread, method);
     }
   }
@@ -447,7 +480,7 @@ class Instrumentation {
                        OptionalFrame frame,
                        T& return_value) const
       REQUIRES_SHARED(Locks::mutator_lock_) {
-    if (UNLIKELY(HasMethodExitListeners())) {
+    if (UNLIKELY(HasMethodExitListeners() || HasSelectiveMethodListeners())) {
       MethodExitEventImpl(thread, method, frame, return_value);
     }
   }
@@ -654,6 +687,9 @@ class Instrumentation {
   bool RemoveDeoptimizedMethod(ArtMethod* method) REQUIRES(Locks::mutator_lock_);
   void UpdateMethodsCodeImpl(ArtMethod* method, const void* new_code)
       REQUIRES_SHARED(Locks::mutator_lock_);
+  // Restore the entrypoints of a method that no longer needs the interpreter for deoptimization
+  // or selective method listeners.
+  void RestoreMethodEntryPoints(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_);
 
   // We need to run method exit hooks for two reasons:
   // 1. When method exit listeners are installed
@@ -697,6 +733,9 @@ class Instrumentation {
   // Do we have any listeners for method unwind events?
   bool have_method_unwind_listeners_ GUARDED_BY(Locks::mutator_lock_);
 
+  // Do we have any listeners for the events of selected methods only?
+  bool have_selective_method_listeners_ GUARDED_BY(Locks::mutator_lock_);
+
   // Do we have any listeners for dex move events?
   bool have_dex_pc_listeners_ GUARDED_BY(Locks::mutator_lock_);
 
@@ -748,6 +787,19 @@ class Instrumentation {
   std::list<InstrumentationListener*> watched_frame_pop_listeners_ GUARDED_BY(Locks::mutator_lock_);
   std::list<InstrumentationListener*> exception_handled_listeners_ GUARDED_BY(Locks::mutator_lock_);
 
+  // The selective method listeners and the methods they were added for. Like the lists above this
+  // list is never trimmed, removed listeners are cleared instead.
+  struct SelectiveMethodListener {
+    InstrumentationListener* listener;
+    std::unordered_set<ArtMethod*> methods;
+  };
+  std::list<SelectiveMethodListener> selective_method_listeners_ GUARDED_BY(Locks::mutator_lock_);
+
+  // The methods selected by any selective method listener, with the number of listeners that
+  // selected them.
+  std::unordered_map<ArtMethod*, size_t> selectively_traced_methods_
+      GUARDED_BY(Locks::mutator_lock_);
+
   // The set of methods being deoptimized (by the debugger) which must be executed with interpreter
   // only.
   std::unordered_set<ArtMethod*> deoptimized_methods_ GUARDED_BY(Locks::mutator_lock_);
@@ -640,6 +640,59 @@ TEST_F(InstrumentationTest, DeoptimizeDirectMethod) {
   EXPECT_FALSE(instr->IsDeoptimized(method_to_deoptimize));
 }
 
+TEST_F(InstrumentationTest, SelectiveMethodListener) {
+  ScopedObjectAccess soa(Thread::Current());
+  jobject class_loader = LoadDex("Instrumentation");
+  Runtime* const runtime = Runtime::Current();
+  instrumentation::Instrumentation* instr = runtime->GetInstrumentation();
+  ClassLinker* class_linker = runtime->GetClassLinker();
+  StackHandleScope<1> hs(soa.Self());
+  Handle<mirror::ClassLoader> loader(hs.NewHandle(soa.Decode<mirror::ClassLoader>(class_loader)));
+  ObjPtr<mirror::Class> klass = class_linker->FindClass(soa.Self(), "LInstrumentation;", loader);
+  ASSERT_TRUE(klass != nullptr);
+  ArtMethod* traced_method = klass->FindClassMethod("instanceMethod", "()V", kRuntimePointerSize);
+  ASSERT_TRUE(traced_method != nullptr);
+  ArtMethod* other_method =
+      klass->FindClassMethod("returnReference", "()Ljava/lang/Object;", kRuntimePointerSize);
+  ASSERT_TRUE(other_method != nullptr);
+
+  TestInstrumentationListener listener;
+  {
+    ScopedThreadSuspension sts(soa.Self(), ThreadState::kSuspended);
+    ScopedSuspendAll ssa("Add selective method listener");
+    ArtMethod* const methods[] = { traced_method };
+    instr->AddSelectiveMethodListener(&listener, ArrayRef<ArtMethod* const>(methods));
+  }
+
+  // The selected method runs with the interpreter, without entry / exit hooks for all methods.
+  EXPECT_TRUE(instr->HasSelectiveMethodListeners());
+  EXPECT_FALSE(instr->HasMethodEntryListeners());
+  EXPECT_FALSE(instr->EntryExitStubsInstalled());
+  EXPECT_TRUE(instr->IsSelectivelyTraced(traced_method));
+  EXPECT_TRUE(instr->IsDeoptimized(traced_method));
+  EXPECT_TRUE(class_linker->IsQuickToInterpreterBridge(
+      traced_method->GetEntryPointFromQuickCompiledCode()));
+  EXPECT_FALSE(instr->IsSelectivelyTraced(other_method));
+
+  instr->MethodEnterEvent(soa.Self(), other_method);
+  EXPECT_FALSE(listener.received_method_enter_event);
+  instr->MethodEnterEvent(soa.Self(), traced_method);
+  EXPECT_TRUE(listener.received_method_enter_event);
+
+  listener.Reset();
+  {
+    ScopedThreadSuspension sts(soa.Self(), ThreadState::kSuspended);
+    ScopedSuspendAll ssa("Remove selective method listener");
+    instr->RemoveSelectiveMethodListener(&listener);
+  }
+
+  EXPECT_FALSE(instr->HasSelectiveMethodListeners());
+  EXPECT_FALSE(instr->IsSelectivelyTraced(traced_method));
+  EXPECT_FALSE(instr->IsDeoptimized(traced_method));
+  instr->MethodEnterEvent(soa.Self(), traced_method);
+  EXPECT_FALSE(listener.received_method_enter_event);
+}
+
 TEST_F(InstrumentationTest, FullDeoptimization) {
   ScopedObjectAccess soa(Thread::Current());
   Runtime* const runtime = Runtime::Current();
@@ -138,14 +138,30 @@ inline void InternTable::Table::AddInternStrings(UnorderedSet&& intern_strings,
   // Keep the order of previous frozen tables unchanged, so that we can can remember
   // the number of searched frozen tables and not search them again.
   DCHECK(!tables_.empty());
-  tables_.insert(tables_.end() - 1, InternalTable(std::move(intern_strings), is_boot_image));
+  tables_.insert(std::prev(tables_.end()), InternalTable(std::move(intern_strings), is_boot_image));
+  PublishImageTables();
+}
+
+template <typename Key>
+inline ObjPtr<mirror::String> InternTable::Table::FindInImageTables(
+    const Key& key, uint32_t hash, /*out*/ const ImageTables** searched_image_tables) {
+  const ImageTables* image_tables = image_tables_.load(std::memory_order_acquire);
+  *searched_image_tables = image_tables;
+  // Search from the last table, like `Find()`.
+  for (const UnorderedSet* set : ReverseRange(*image_tables)) {
+    auto it = set->FindWithHash(key, hash);
+    if (it != set->end()) {
+      return it->Read();
+    }
+  }
+  return nullptr;
 }
 
 template <typename Visitor>
 inline void InternTable::VisitInterns(const Visitor& visitor,
                                       bool visit_boot_images,
                                       bool visit_non_boot_images) {
-  auto visit_tables = [&](dchecked_vector<Table::InternalTable>& tables)
+  auto visit_tables = [&](std::list<Table::InternalTable>& tables)
       NO_THREAD_SAFETY_ANALYSIS {
     for (Table::InternalTable& table : tables) {
       // Determine if we want to visit the table based on the flags.
@@ -163,7 +179,7 @@ inline void InternTable::VisitInterns(const Visitor& visitor,
 
 inline size_t InternTable::CountInterns(bool visit_boot_images, bool visit_non_boot_images) const {
   size_t ret = 0u;
-  auto visit_tables = [&](const dchecked_vector<Table::InternalTable>& tables)
+  auto visit_tables = [&](const std::list<Table::InternalTable>& tables)
       NO_THREAD_SAFETY_ANALYSIS {
     for (const Table::InternalTable& table : tables) {
       // Determine if we want to visit the table based on the flags.
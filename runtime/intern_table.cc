@@ -114,16 +114,29 @@ ObjPtr<mirror::String> InternTable::LookupStrong(Thread* self, ObjPtr<mirror::St
   DCHECK(s != nullptr);
   // `String::GetHashCode()` ensures that the stored hash is calculated.
   uint32_t hash = static_cast<uint32_t>(s->GetHashCode());
+  const Table::ImageTables* searched_image_tables;
+  ObjPtr<mirror::String> image_string =
+      FindStrongInImageTables(GcRoot<mirror::String>(s), hash, &searched_image_tables);
+  if (image_string != nullptr) {
+    return image_string;
+  }
   MutexLock mu(self, *Locks::intern_table_lock_);
-  return strong_interns_.Find(s, hash);
+  return strong_interns_.Find(s, hash, /*num_searched_frozen_tables=*/ 0u, searched_image_tables);
 }
 
 ObjPtr<mirror::String> InternTable::LookupStrong(Thread* self,
                                                  uint32_t utf16_length,
                                                  const char* utf8_data) {
   uint32_t hash = Utf8String::Hash(utf16_length, utf8_data);
+  Utf8String string(utf16_length, utf8_data);
+  const Table::ImageTables* searched_image_tables;
+  ObjPtr<mirror::String> image_string =
+      FindStrongInImageTables(string, hash, &searched_image_tables);
+  if (image_string != nullptr) {
+    return image_string;
+  }
   MutexLock mu(self, *Locks::intern_table_lock_);
-  return strong_interns_.Find(Utf8String(utf16_length, utf8_data), hash);
+  return strong_interns_.Find(string, hash, searched_image_tables);
 }
 
 ObjPtr<mirror::String> InternTable::LookupWeakLocked(ObjPtr<mirror::String> s) {
@@ -206,6 +219,14 @@ ObjPtr<mirror::String> InternTable::Insert(ObjPtr<mirror::String> s,
   DCHECK_EQ(hash, static_cast<uint32_t>(s->GetStoredHashCode()));
   DCHECK_IMPLIES(hash == 0u, s->ComputeHashCode() == 0);
   Thread* const self = Thread::Current();
+  const Table::ImageTables* searched_image_tables = nullptr;
+  if (num_searched_strong_frozen_tables == 0u) {
+    ObjPtr<mirror::String> image_string =
+        FindStrongInImageTables(GcRoot<mirror::String>(s), hash, &searched_image_tables);
+    if (image_string != nullptr) {
+      return image_string;
+    }
+  }
   MutexLock mu(self, *Locks::intern_table_lock_);
   if (kDebugLocking) {
     Locks::mutator_lock_->AssertSharedHeld(self);
@@ -214,7 +235,7 @@ ObjPtr<mirror::String> InternTable::Insert(ObjPtr<mirror::String> s,
   while (true) {
     // Check the strong table for a match.
     ObjPtr<mirror::String> strong =
-        strong_interns_.Find(s, hash, num_searched_strong_frozen_tables);
+        strong_interns_.Find(s, hash, num_searched_strong_frozen_tables, searched_image_tables);
     if (strong != nullptr) {
       return strong;
     }
@@ -253,14 +274,19 @@ ObjPtr<mirror::String> InternTable::InternStrong(uint32_t utf16_length, const ch
   DCHECK(utf8_data != nullptr);
   uint32_t hash = Utf8String::Hash(utf16_length, utf8_data);
   Thread* self = Thread::Current();
-  ObjPtr<mirror::String> s;
+  Utf8String string(utf16_length, utf8_data);
+  const Table::ImageTables* searched_image_tables;
+  ObjPtr<mirror::String> s = FindStrongInImageTables(string, hash, &searched_image_tables);
+  if (s != nullptr) {
+    return s;
+  }
   size_t num_searched_strong_frozen_tables;
   {
     // Try to avoid allocation. If we need to allocate, release the mutex before the allocation.
     MutexLock mu(self, *Locks::intern_table_lock_);
     DCHECK(!strong_interns_.tables_.empty());
     num_searched_strong_frozen_tables = strong_interns_.tables_.size() - 1u;
-    s = strong_interns_.Find(Utf8String(utf16_length, utf8_data), hash);
+    s = strong_interns_.Find(string, hash, searched_image_tables);
   }
   if (s != nullptr) {
     return s;
@@ -334,15 +360,21 @@ void InternTable::Table::Remove(ObjPtr<mirror::String> s, uint32_t hash) {
 FLATTEN
 ObjPtr<mirror::String> InternTable::Table::Find(ObjPtr<mirror::String> s,
                                                 uint32_t hash,
-                                                size_t num_searched_frozen_tables) {
+                                                size_t num_searched_frozen_tables,
+                                                const ImageTables* searched_image_tables) {
   Locks::intern_table_lock_->AssertHeld(Thread::Current());
-  auto mid = tables_.begin() + num_searched_frozen_tables;
+  auto mid = std::next(tables_.begin(), num_searched_frozen_tables);
   for (Table::InternalTable& table : MakeIterationRange(tables_.begin(), mid)) {
     DCHECK(table.set_.FindWithHash(GcRoot<mirror::String>(s), hash) == table.set_.end());
   }
+  const bool skip_image_tables =
+      searched_image_tables == image_tables_.load(std::memory_order_relaxed);
   // Search from the last table, assuming that apps shall search for their own
   // strings more often than for boot image strings.
   for (Table::InternalTable& table : ReverseRange(MakeIterationRange(mid, tables_.end()))) {
+    if (skip_image_tables && table.IsImage()) {
+      continue;
+    }
     auto it = table.set_.FindWithHash(GcRoot<mirror::String>(s), hash);
     if (it != table.set_.end()) {
       return it->Read();
@@ -352,11 +384,18 @@ ObjPtr<mirror::String> InternTable::Table::Find(ObjPtr<mirror::String> s,
 }
 
 FLATTEN
-ObjPtr<mirror::String> InternTable::Table::Find(const Utf8String& string, uint32_t hash) {
+ObjPtr<mirror::String> InternTable::Table::Find(const Utf8String& string,
+                                                uint32_t hash,
+                                                const ImageTables* searched_image_tables) {
   Locks::intern_table_lock_->AssertHeld(Thread::Current());
+  const bool skip_image_tables =
+      searched_image_tables == image_tables_.load(std::memory_order_relaxed);
   // Search from the last table, assuming that apps shall search for their own
   // strings more often than for boot image strings.
   for (InternalTable& table : ReverseRange(tables_)) {
+    if (skip_image_tables && table.IsImage()) {
+      continue;
+    }
     auto it = table.set_.FindWithHash(string, hash);
     if (it != table.set_.end()) {
       return it->Read();
@@ -374,6 +413,17 @@ void InternTable::Table::AddNewTable() {
   tables_.push_back(std::move(new_table));
 }
 
+void InternTable::Table::PublishImageTables() {
+  std::unique_ptr<ImageTables> image_tables(new ImageTables());
+  for (const InternalTable& table : tables_) {
+    if (table.IsImage()) {
+      image_tables->push_back(&table.set_);
+    }
+  }
+  image_tables_.store(image_tables.get(), std::memory_order_release);
+  published_image_tables_.push_back(std::move(image_tables));
+}
+
 void InternTable::Table::Insert(ObjPtr<mirror::String> s, uint32_t hash) {
   // Always insert the last table, the image tables are before and we avoid inserting into these
   // to prevent dirty pages.
@@ -442,6 +492,8 @@ InternTable::Table::Table() {
   initial_table.set_.SetLoadFactor(runtime->GetHashTableMinLoadFactor(),
                                    runtime->GetHashTableMaxLoadFactor());
   tables_.push_back(std::move(initial_table));
+  published_image_tables_.push_back(std::make_unique<ImageTables>());
+  image_tables_.store(published_image_tables_.back().get(), std::memory_order_relaxed);
 }
 
 }  // namespace art
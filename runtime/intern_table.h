@@ -17,7 +17,12 @@
 #ifndef ART_RUNTIME_INTERN_TABLE_H_
 #define ART_RUNTIME_INTERN_TABLE_H_
 
+#include <list>
+#include <memory>
+#include <vector>
+
 #include "base/allocator.h"
+#include "base/atomic.h"
 #include "base/dchecked_vector.h"
 #include "base/hash_set.h"
 #include "base/mutex.h"
@@ -54,6 +59,9 @@ class Transaction;
  * String.intern. Some code (XML parsers being a prime example) relies on being able to intern
  * arbitrarily many strings for the duration of a parse without permanently increasing the memory
  * footprint.
+ *
+ * Strong interns from images are never modified, so lookups search them without holding
+ * `Locks::intern_table_lock_` and only take the lock for the other tables.
  */
 class InternTable {
  public:
@@ -210,8 +218,9 @@ class InternTable {
     class InternalTable {
      public:
       InternalTable() = default;
+      // A table read from an image.
       InternalTable(UnorderedSet&& set, bool is_boot_image)
-          : set_(std::move(set)), is_boot_image_(is_boot_image) {}
+          : set_(std::move(set)), is_boot_image_(is_boot_image), is_image_(true) {}
 
       bool Empty() const {
         return set_.empty();
@@ -225,9 +234,14 @@ class InternTable {
         return is_boot_image_;
       }
 
+      bool IsImage() const {
+        return is_image_;
+      }
+
      private:
       UnorderedSet set_;
       bool is_boot_image_ = false;
+      bool is_image_ = false;
 
       friend class InternTable;
       friend class linker::ImageWriter;
@@ -235,13 +249,28 @@ class InternTable {
       ART_FRIEND_TEST(InternTableTest, CrossHash);
     };
 
+    // The tables read from images, in the order of `tables_`.
+    using ImageTables = std::vector<const UnorderedSet*>;
+
     Table();
+    // `searched_image_tables` are the image tables already searched by `FindInImageTables()`,
+    // which are then skipped unless more image tables were added since.
     ObjPtr<mirror::String> Find(ObjPtr<mirror::String> s,
                                 uint32_t hash,
-                                size_t num_searched_frozen_tables = 0u)
+                                size_t num_searched_frozen_tables = 0u,
+                                const ImageTables* searched_image_tables = nullptr)
         REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
-    ObjPtr<mirror::String> Find(const Utf8String& string, uint32_t hash)
+    ObjPtr<mirror::String> Find(const Utf8String& string,
+                                uint32_t hash,
+                                const ImageTables* searched_image_tables = nullptr)
         REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
+    // Find a string in the tables read from images without holding the lock. These tables are
+    // never modified. Sets `searched_image_tables` to the tables that were searched.
+    template <typename Key>
+    ObjPtr<mirror::String> FindInImageTables(const Key& key,
+                                             uint32_t hash,
+                                             /*out*/ const ImageTables** searched_image_tables)
+        REQUIRES_SHARED(Locks::mutator_lock_);
     void Insert(ObjPtr<mirror::String> s, uint32_t hash)
         REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
     void Remove(ObjPtr<mirror::String> s, uint32_t hash)
@@ -269,9 +298,18 @@ class InternTable {
     void AddInternStrings(UnorderedSet&& intern_strings, bool is_boot_image)
         REQUIRES(Locks::intern_table_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
 
+    // Publish the current image tables for `FindInImageTables()`.
+    void PublishImageTables() REQUIRES(Locks::intern_table_lock_);
+
     // We call AddNewTable when we create the zygote to reduce private dirty pages caused by
     // modifying the zygote intern table. The back of table is modified when strings are interned.
-    dchecked_vector<InternalTable> tables_;
+    // It is a list so that the image tables stay at the same address when tables are added.
+    std::list<InternalTable> tables_;
+    // The image tables as of the last table read from an image. Previously published vectors are
+    // kept in `published_image_tables_` since lookups may still be reading them. There is one
+    // per image, so there are only a few of them.
+    Atomic<const ImageTables*> image_tables_;
+    std::vector<std::unique_ptr<ImageTables>> published_image_tables_;
 
     friend class InternTable;
     friend class linker::ImageWriter;
@@ -285,6 +323,16 @@ class InternTable {
                                 size_t num_searched_strong_frozen_tables = 0u)
       REQUIRES(!Locks::intern_table_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Find a strong intern in the tables read from images without holding the lock, see
+  // `Table::FindInImageTables()`.
+  // NO_THREAD_SAFETY_ANALYSIS: The image tables are not guarded by `Locks::intern_table_lock_`.
+  template <typename Key>
+  ObjPtr<mirror::String> FindStrongInImageTables(
+      const Key& key, uint32_t hash, /*out*/ const Table::ImageTables** searched_image_tables)
+      REQUIRES_SHARED(Locks::mutator_lock_) NO_THREAD_SAFETY_ANALYSIS {
+    return strong_interns_.FindInImageTables(key, hash, searched_image_tables);
+  }
+
   // Add a table from memory to the strong interns.
   template <typename Visitor>
   size_t AddTableFromMemory(const uint8_t* ptr, const Visitor& visitor, bool is_boot_image)
@@ -19,6 +19,7 @@
 #include "base/hash_set.h"
 #include "common_runtime_test.h"
 #include "dex/utf.h"
+#include "gc/heap.h"
 #include "gc_root-inl.h"
 #include "handle_scope-inl.h"
 #include "mirror/object.h"
@@ -247,6 +248,21 @@ TEST_F(InternTableTest, LookupStrong) {
   EXPECT_TRUE(lookup_foobbS == nullptr);
 }
 
+TEST_F(InternTableTest, LookupStrongInBootImage) {
+  ScopedObjectAccess soa(Thread::Current());
+  InternTable* intern_table = Runtime::Current()->GetInternTable();
+  // Boot image strings are found without taking the intern table lock.
+  ObjPtr<mirror::String> null_string = intern_table->LookupStrong(soa.Self(), 4, "null");
+  ASSERT_TRUE(null_string != nullptr);
+  EXPECT_TRUE(Runtime::Current()->GetHeap()->ObjectIsInBootImageSpace(null_string));
+  EXPECT_OBJ_PTR_EQ(intern_table->InternStrong(4, "null"), null_string);
+  StackHandleScope<1> hs(soa.Self());
+  Handle<mirror::String> null_copy(
+      hs.NewHandle(mirror::String::AllocFromModifiedUtf8(soa.Self(), "null")));
+  EXPECT_OBJ_PTR_EQ(intern_table->LookupStrong(soa.Self(), null_copy.Get()), null_string);
+  EXPECT_OBJ_PTR_EQ(intern_table->InternWeak(null_copy.Get()), null_string);
+}
+
 TEST_F(InternTableTest, InternStrongFrozenWeak) {
   ScopedObjectAccess soa(Thread::Current());
   InternTable intern_table;
@@ -295,7 +295,9 @@ static inline JValue Execute(
     }
 
     instrumentation::Instrumentation* instrumentation = Runtime::Current()->GetInstrumentation();
-    if (UNLIKELY(instrumentation->HasMethodEntryListeners() || shadow_frame.GetForcePopFrame())) {
+    if (UNLIKELY(instrumentation->HasMethodEntryListeners() ||
+                 instrumentation->IsSelectivelyTraced(method) ||
+                 shadow_frame.GetForcePopFrame())) {
       instrumentation->MethodEnterEvent(self, method);
       if (UNLIKELY(shadow_frame.GetForcePopFrame())) {
         // The caller will retry this invoke or ignore the result. Just return immediately without
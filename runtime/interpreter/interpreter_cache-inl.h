@@ -25,10 +25,13 @@ namespace art {
 
 inline bool InterpreterCache::Get(Thread* self, const void* key, /* out */ size_t* value) {
   DCHECK(self->GetInterpreterCache() == this) << "Must be called from owning thread";
-  Entry& entry = data_[IndexOf(key)];
-  if (LIKELY(entry.first == key)) {
-    *value = entry.second;
-    return true;
+  Entry* set = &data_[IndexOf(key)];
+  for (size_t way = 0; way != kNumWays; ++way) {
+    if (LIKELY(set[way].first == key)) {
+      *value = set[way].second;
+      ++num_hits_;
+      return true;
+    }
   }
   return false;
 }
@@ -37,7 +40,27 @@ inline void InterpreterCache::Set(Thread* self, const void* key, size_t value) {
   DCHECK(self->GetInterpreterCache() == this) << "Must be called from owning thread";
   // Simple store works here as the cache is always read/written by the owning
   // thread only (or in a stop-the-world pause).
-  data_[IndexOf(key)] = Entry{key, value};
+  Entry* set = &data_[IndexOf(key)];
+  // Keep the other entry of the set unless it is the stale entry for the key.
+  if (set[0].first != key) {
+    set[1] = set[0];
+  }
+  set[0] = Entry{key, value};
+  ++num_misses_;
+}
+
+inline void InterpreterCache::SetInlineCache(Thread* self,
+                                             const void* key,
+                                             mirror::Class* receiver_class,
+                                             ArtMethod* target) {
+  DCHECK(self->GetInterpreterCache() == this) << "Must be called from owning thread";
+  InlineCacheEntry* entry = &inline_caches_[InlineCacheIndexOf(key)];
+  ++entry->misses;
+  if (target != nullptr) {
+    entry->key = key;
+    entry->receiver_class = receiver_class;
+    entry->target = target;
+  }
 }
 
 }  // namespace art
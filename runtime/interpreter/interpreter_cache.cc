@@ -29,6 +29,32 @@ void InterpreterCache::Clear(Thread* owning_thread) {
         reinterpret_cast<std::atomic<const void*>*>(&entry.first);
     atomic_key_addr->store(nullptr, std::memory_order_relaxed);
   }
+  for (InlineCacheEntry& entry : inline_caches_) {
+    std::atomic<const void*>* atomic_key_addr =
+        reinterpret_cast<std::atomic<const void*>*>(&entry.key);
+    atomic_key_addr->store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+void InterpreterCache::ClearRange(Thread* owning_thread, const void* begin, const void* end) {
+  DCHECK(owning_thread->GetInterpreterCache() == this);
+  DCHECK(owning_thread == Thread::Current() || owning_thread->IsSuspended());
+  for (Entry& entry : data_) {
+    std::atomic<const void*>* atomic_key_addr =
+        reinterpret_cast<std::atomic<const void*>*>(&entry.first);
+    const void* key = atomic_key_addr->load(std::memory_order_relaxed);
+    if (key >= begin && key < end) {
+      atomic_key_addr->store(nullptr, std::memory_order_relaxed);
+    }
+  }
+  for (InlineCacheEntry& entry : inline_caches_) {
+    std::atomic<const void*>* atomic_key_addr =
+        reinterpret_cast<std::atomic<const void*>*>(&entry.key);
+    const void* key = atomic_key_addr->load(std::memory_order_relaxed);
+    if (key >= begin && key < end) {
+      atomic_key_addr->store(nullptr, std::memory_order_relaxed);
+    }
+  }
 }
 
 }  // namespace art
@@ -25,8 +25,13 @@
 
 namespace art {
 
+class ArtMethod;
 class Thread;
 
+namespace mirror {
+class Class;
+}  // namespace mirror
+
 // Small fast thread-local cache for the interpreter.
 // It can hold arbitrary pointer-sized key-value pair.
 // The interpretation of the value depends on the key.
@@ -39,8 +44,17 @@ class Thread;
 //   sget/sput: The ArtField* pointer. The field must be non-volitile.
 //   invoke: The ArtMethod* pointer (before vtable indirection, etc).
 //
-// We ensure consistency of the cache by clearing it
-// whenever any dex file is unloaded.
+// We ensure consistency of the cache by clearing the entries
+// of a dex file's instructions whenever that dex file is unloaded.
+//
+// The cache is two-way set associative: the entries for a key are the
+// two consecutive entries of its set, the most recently set one first.
+// This avoids most of the conflict misses of alternating instructions
+// that map to the same set, and nterp only probes the second way when
+// it misses the first.
+//
+// Next to the cache, the riscv64 nterp keeps a direct-mapped monomorphic
+// inline cache for invoke-virtual and invoke-interface, see InlineCacheEntry.
 //
 // Aligned to 16-bytes to make it easier to get the address of the cache
 // from assembly (it ensures that the offset is valid immediate value).
@@ -52,16 +66,40 @@ class ALIGNED(16) InterpreterCache {
   // 2x size increase/decrease corresponds to ~0.5% interpreter performance change.
   // Value of 256 has around 75% cache hit rate.
   static constexpr size_t kSize = 256;
+  static constexpr size_t kNumWays = 2;
+  static constexpr size_t kNumSets = kSize / kNumWays;
+
+  // The last receiver class seen by an invoke-virtual or invoke-interface and the method it
+  // dispatched to. Nterp calls the target directly when the receiver class matches, and
+  // otherwise asks the runtime to replace the entry, which also adds the class to the inline
+  // cache of the ProfilingInfo of the caller. The runtime stops replacing the entry after
+  // kMaxInlineCacheMisses, which covers both megamorphic sites and sites that share the entry.
+  // The receiver classes are weak roots and the miss counts start over at each GC, see
+  // Thread::SweepInterpreterCache().
+  struct InlineCacheEntry {
+    const void* key;
+    mirror::Class* receiver_class;
+    ArtMethod* target;
+    size_t misses;
+  };
+  // Nterp scales the index by the size.
+  static_assert(sizeof(InlineCacheEntry) == 4 * sizeof(size_t));
+  static constexpr size_t kNumInlineCaches = 64;
+  static constexpr size_t kMaxInlineCacheMisses = 8;
 
   InterpreterCache() {
     // We can not use the Clear() method since the constructor will not
     // be called from the owning thread.
     data_.fill(Entry{});
+    inline_caches_.fill(InlineCacheEntry{});
   }
 
   // Clear the whole cache. It requires the owning thread for DCHECKs.
   void Clear(Thread* owning_thread);
 
+  // Clear the entries with keys in [begin, end). It requires the owning thread for DCHECKs.
+  void ClearRange(Thread* owning_thread, const void* begin, const void* end);
+
   ALWAYS_INLINE bool Get(Thread* self, const void* key, /* out */ size_t* value);
 
   ALWAYS_INLINE void Set(Thread* self, const void* key, size_t value);
@@ -70,15 +108,52 @@ class ALIGNED(16) InterpreterCache {
     return data_;
   }
 
+  // Record a miss of the inline cache of the invoke at `key`, and replace the entry with
+  // `receiver_class` and `target` unless `target` is null.
+  ALWAYS_INLINE void SetInlineCache(Thread* self,
+                                    const void* key,
+                                    mirror::Class* receiver_class,
+                                    ArtMethod* target);
+
+  std::array<InlineCacheEntry, kNumInlineCaches>& GetInlineCaches() {
+    return inline_caches_;
+  }
+
+  static constexpr size_t InlineCachesOffset() {
+    return OFFSETOF_MEMBER(InterpreterCache, inline_caches_);
+  }
+
+  // Hits are counted for lookups from the runtime only, nterp probes the cache
+  // in assembly. Misses are counted when the missing entry is set, which covers
+  // nterp too, but not lookups that are not cached, e.g. of volatile fields.
+  size_t GetNumHits() const {
+    return num_hits_;
+  }
+
+  size_t GetNumMisses() const {
+    return num_misses_;
+  }
+
  private:
+  // Returns the index of the first entry of the key's set.
   static ALWAYS_INLINE size_t IndexOf(const void* key) {
-    static_assert(IsPowerOfTwo(kSize), "Size must be power of two");
-    size_t index = (reinterpret_cast<uintptr_t>(key) >> 2) & (kSize - 1);
+    static_assert(IsPowerOfTwo(kNumSets), "Number of sets must be power of two");
+    static_assert(kNumWays == 2, "Nterp probes exactly two ways");
+    size_t index = ((reinterpret_cast<uintptr_t>(key) >> 2) & (kNumSets - 1)) * kNumWays;
     DCHECK_LT(index, kSize);
     return index;
   }
 
+  // Returns the index of the inline cache entry of the key, nterp uses the same bits.
+  static ALWAYS_INLINE size_t InlineCacheIndexOf(const void* key) {
+    static_assert(IsPowerOfTwo(kNumInlineCaches), "Number of inline caches must be power of two");
+    return (reinterpret_cast<uintptr_t>(key) >> 1) & (kNumInlineCaches - 1);
+  }
+
   std::array<Entry, kSize> data_;
+  std::array<InlineCacheEntry, kNumInlineCaches> inline_caches_;
+  size_t num_hits_ = 0u;
+  size_t num_misses_ = 0u;
 };
 
 }  // namespace art
@@ -106,7 +106,9 @@ bool SendMethodExitEvents(Thread* self,
   // respect these and send additional instrumentation events.
   do {
     frame.SetForcePopFrame(false);
-    if (UNLIKELY(instrumentation->HasMethodExitListeners() && !frame.GetSkipMethodExitEvents())) {
+    if (UNLIKELY((instrumentation->HasMethodExitListeners() ||
+                  instrumentation->IsSelectivelyTraced(method)) &&
+                 !frame.GetSkipMethodExitEvents())) {
       had_event = true;
       instrumentation->MethodExitEvent(self, method, instrumentation::OptionalFrame{frame}, result);
     }
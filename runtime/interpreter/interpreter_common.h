@@ -154,7 +154,9 @@ template <typename T> bool SendMethodExitEvents(
 static inline ALWAYS_INLINE WARN_UNUSED bool
 NeedsMethodExitEvent(const instrumentation::Instrumentation* ins)
     REQUIRES_SHARED(Locks::mutator_lock_) {
-  return ins->HasMethodExitListeners() || ins->HasWatchedFramePopListeners();
+  return ins->HasMethodExitListeners() ||
+         ins->HasSelectiveMethodListeners() ||
+         ins->HasWatchedFramePopListeners();
 }
 
 COLD_ATTR void UnlockHeldMonitors(Thread* self, ShadowFrame* shadow_frame)
@@ -139,6 +139,9 @@ class InstructionHandler {
 
   // Code to run before each dex instruction.
   HANDLER_ATTRIBUTES bool Preamble() {
+    if (LIKELY(!shadow_frame_.NeedsInstructionPreamble())) {
+      return true;
+    }
     /* We need to put this before & after the instrumentation to avoid having to put in a */
     /* post-script macro.                                                                 */
     if (!CheckForceReturn()) {
@@ -1854,53 +1857,74 @@ void ExecuteSwitchImplCpp(SwitchImplContext* ctx) {
   DCHECK(!shadow_frame.GetForceRetryInstruction())
       << "Entered interpreter from invoke without retry instruction being handled!";
 
+  // Labels of the instruction handlers below, indexed by opcode.
+  static const void* const kHandlers[] = {
+#define OPCODE_LABEL(OPCODE, OPCODE_NAME, NAME, FORMAT, i, a, e, v) &&op_##OPCODE_NAME,
+    DEX_INSTRUCTION_LIST(OPCODE_LABEL)
+#undef OPCODE_LABEL
+  };
+  static_assert(arraysize(kHandlers) == kNumPackedOpcodes);
+
   bool const interpret_one_instruction = ctx->interpret_one_instruction;
-  while (true) {
-    const Instruction* const inst = next;
-    dex_pc = inst->GetDexPc(insns);
-    shadow_frame.SetDexPC(dex_pc);
-    TraceExecution(shadow_frame, inst, dex_pc);
-    uint16_t inst_data = inst->Fetch16(0);
-    bool exit = false;
-    bool success;  // Moved outside to keep frames small under asan.
-    if (InstructionHandler<transaction_active, Instruction::kInvalidFormat>(
-            ctx, instrumentation, self, shadow_frame, dex_pc, inst, inst_data, next, exit).
-            Preamble()) {
-      DCHECK_EQ(self->IsExceptionPending(), inst->Opcode(inst_data) == Instruction::MOVE_EXCEPTION);
-      switch (inst->Opcode(inst_data)) {
+  const Instruction* inst;
+  uint16_t inst_data;
+  bool exit = false;
+  bool success;  // Moved outside to keep frames small under asan.
+
+  // Start executing the instruction at `next`. Every handler ends with its own copy of this
+  // dispatch rather than returning to a shared `switch`, so that the indirect branch to the
+  // next handler is predicted from the current opcode.
+#define DISPATCH_NEXT_INSTRUCTION()                                                               \
+  do {                                                                                            \
+    inst = next;                                                                                  \
+    dex_pc = inst->GetDexPc(insns);                                                               \
+    shadow_frame.SetDexPC(dex_pc);                                                                \
+    TraceExecution(shadow_frame, inst, dex_pc);                                                   \
+    inst_data = inst->Fetch16(0);                                                                 \
+    if (!InstructionHandler<transaction_active, Instruction::kInvalidFormat>(                     \
+            ctx, instrumentation, self, shadow_frame, dex_pc, inst, inst_data, next, exit).       \
+            Preamble()) {                                                                         \
+      goto instruction_done;                                                                      \
+    }                                                                                             \
+    DCHECK_EQ(self->IsExceptionPending(), inst->Opcode(inst_data) == Instruction::MOVE_EXCEPTION); \
+    goto *kHandlers[inst->Opcode(inst_data)];                                                     \
+  } while (false)
+
+  DISPATCH_NEXT_INSTRUCTION();
+
 #define OPCODE_CASE(OPCODE, OPCODE_NAME, NAME, FORMAT, i, a, e, v)                                \
-        case OPCODE: {                                                                            \
-          next = inst->RelativeAt(Instruction::SizeInCodeUnits(Instruction::FORMAT));             \
-          success = OP_##OPCODE_NAME<transaction_active>(                                         \
-              ctx, instrumentation, self, shadow_frame, dex_pc, inst, inst_data, next, exit);     \
-          if (success && LIKELY(!interpret_one_instruction)) {                                    \
-            continue;                                                                             \
-          }                                                                                       \
-          break;                                                                                  \
-        }
+  op_##OPCODE_NAME:                                                                               \
+    next = inst->RelativeAt(Instruction::SizeInCodeUnits(Instruction::FORMAT));                   \
+    success = OP_##OPCODE_NAME<transaction_active>(                                               \
+        ctx, instrumentation, self, shadow_frame, dex_pc, inst, inst_data, next, exit);           \
+    if (success && LIKELY(!interpret_one_instruction)) {                                          \
+      DISPATCH_NEXT_INSTRUCTION();                                                                \
+    }                                                                                             \
+    goto instruction_done;
   DEX_INSTRUCTION_LIST(OPCODE_CASE)
 #undef OPCODE_CASE
-      }
-    }
-    if (exit) {
+
+instruction_done:
+  if (exit) {
+    shadow_frame.SetDexPC(dex::kDexNoIndex);
+    return;  // Return statement or debugger forced exit.
+  }
+  if (self->IsExceptionPending()) {
+    if (!InstructionHandler<transaction_active, Instruction::kInvalidFormat>(
+            ctx, instrumentation, self, shadow_frame, dex_pc, inst, inst_data, next, exit).
+            HandlePendingException()) {
       shadow_frame.SetDexPC(dex::kDexNoIndex);
-      return;  // Return statement or debugger forced exit.
-    }
-    if (self->IsExceptionPending()) {
-      if (!InstructionHandler<transaction_active, Instruction::kInvalidFormat>(
-              ctx, instrumentation, self, shadow_frame, dex_pc, inst, inst_data, next, exit).
-              HandlePendingException()) {
-        shadow_frame.SetDexPC(dex::kDexNoIndex);
-        return;  // Locally unhandled exception - return to caller.
-      }
-      // Continue execution in the catch block.
-    }
-    if (interpret_one_instruction) {
-      shadow_frame.SetDexPC(next->GetDexPc(insns));  // Record where we stopped.
-      ctx->result = ctx->result_register;
-      return;
+      return;  // Locally unhandled exception - return to caller.
     }
+    // Continue execution in the catch block.
+  }
+  if (interpret_one_instruction) {
+    shadow_frame.SetDexPC(next->GetDexPc(insns));  // Record where we stopped.
+    ctx->result = ctx->result_register;
+    return;
   }
+  DISPATCH_NEXT_INSTRUCTION();
+#undef DISPATCH_NEXT_INSTRUCTION
 }  // NOLINT(readability/fn_size)
 
 }  // namespace interpreter
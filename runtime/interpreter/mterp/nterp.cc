@@ -28,6 +28,7 @@
 #include "interpreter/interpreter_cache-inl.h"
 #include "interpreter/interpreter_common.h"
 #include "interpreter/shadow_frame-inl.h"
+#include "jit/jit_code_cache.h"
 #include "mirror/string-alloc-inl.h"
 #include "nterp_helpers.h"
 
@@ -39,9 +40,8 @@ bool IsNterpSupported() {
     case InstructionSet::kArm:
     case InstructionSet::kThumb2:
     case InstructionSet::kArm64:
-      return kReserveMarkingRegister && !kUseTableLookupReadBarrier;
     case InstructionSet::kRiscv64:
-      return true;
+      return kReserveMarkingRegister && !kUseTableLookupReadBarrier;
     case InstructionSet::kX86:
     case InstructionSet::kX86_64:
       return !kUseTableLookupReadBarrier;
@@ -370,6 +370,44 @@ extern "C" size_t NterpGetMethod(Thread* self, ArtMethod* caller, const uint16_t
   }
 }
 
+// Called by nterp when the receiver class of an invoke-virtual or invoke-interface misses its
+// inline cache, see InterpreterCache::InlineCacheEntry. `method_or_index` is the value that
+// `NterpGetMethod` returned for the instruction. Returns the method to call, or null to let nterp
+// do the regular interface dispatch, which throws the errors of abstract and conflicting methods.
+extern "C" ArtMethod* NterpUpdateInlineCache(Thread* self,
+                                             ArtMethod* caller,
+                                             const uint16_t* dex_pc_ptr,
+                                             mirror::Class* receiver_class,
+                                             size_t method_or_index)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  ScopedAssertNoThreadSuspension sants("In nterp");
+  const Instruction* inst = Instruction::At(dex_pc_ptr);
+  ArtMethod* target = nullptr;
+  if (inst->Opcode() == Instruction::INVOKE_VIRTUAL ||
+      inst->Opcode() == Instruction::INVOKE_VIRTUAL_RANGE) {
+    target = receiver_class->GetVTableEntry(method_or_index, kRuntimePointerSize);
+  } else if ((method_or_index & 1u) != 0u) {
+    // A method of j.l.Object, called through its vtable index.
+    target = receiver_class->GetVTableEntry(method_or_index >> 16, kRuntimePointerSize);
+  } else {
+    // Clear the default method bit.
+    ArtMethod* interface_method = reinterpret_cast<ArtMethod*>(method_or_index & ~2u);
+    target = receiver_class->FindVirtualMethodForInterface(interface_method, kRuntimePointerSize);
+    if (target != nullptr && (target->IsAbstract() || target->IsDefaultConflicting())) {
+      target = nullptr;
+    }
+  }
+  self->GetInterpreterCache()->SetInlineCache(self, dex_pc_ptr, receiver_class, target);
+
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit != nullptr && target != nullptr) {
+    CodeItemInstructionAccessor accessor(caller->DexInstructions());
+    uint32_t dex_pc = dex_pc_ptr - accessor.Insns();
+    jit->GetCodeCache()->AddInvokeInfo(self, caller, dex_pc, receiver_class);
+  }
+  return target;
+}
+
 extern "C" size_t NterpGetStaticField(Thread* self,
                                       ArtMethod* caller,
                                       const uint16_t* dex_pc_ptr,
@@ -686,12 +724,16 @@ extern "C" jit::OsrData* NterpHotMethod(ArtMethod* method, uint16_t* dex_pc_ptr,
       CodeItemInstructionAccessor accessor(method->DexInstructions());
       uint32_t dex_pc = dex_pc_ptr - accessor.Insns();
       jit::OsrData* osr_data = jit->PrepareForOsr(
-          method->GetInterfaceMethodIfProxy(kRuntimePointerSize), dex_pc, vregs);
+          method->GetInterfaceMethodIfProxy(kRuntimePointerSize),
+          dex_pc,
+          vregs,
+          /* osr_without_jit_code= */ kRuntimeISA == InstructionSet::kRiscv64);
       if (osr_data != nullptr) {
         return osr_data;
       }
     }
-    jit->MaybeEnqueueCompilation(method, Thread::Current());
+    jit->MaybeEnqueueCompilation(
+        method, Thread::Current(), /* from_back_edge= */ dex_pc_ptr != nullptr);
   }
   return nullptr;
 }
@@ -388,6 +388,15 @@ class ShadowFrame {
     UpdateFrameFlag(enable, FrameFlags::kNotifyDexPcMoveEvents);
   }
 
+  // Returns true if the interpreter needs to act on a frame flag before executing the next
+  // dex instruction, i.e. the frame is to be popped or dex pc move events are to be reported.
+  // This tests both flags at once for the interpreter's common path where neither is set.
+  bool NeedsInstructionPreamble() const {
+    constexpr uint32_t kPreambleFlags = static_cast<uint32_t>(FrameFlags::kForcePopFrame) |
+                                        static_cast<uint32_t>(FrameFlags::kNotifyDexPcMoveEvents);
+    return (frame_flags_ & kPreambleFlags) != 0;
+  }
+
   void CheckConsistentVRegs() const {
     if (kIsDebugBuild) {
       // A shadow frame visible to GC requires the following rule: for a given vreg,
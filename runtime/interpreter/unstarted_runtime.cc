@@ -908,6 +908,16 @@ void UnstartedRuntime::UnstartedSystemArraycopy(Thread* self,
     PrimitiveArrayCopy<uint16_t>(self, src_array, src_pos, dst_array, dst_pos, length);
   } else if (src_type->IsPrimitiveInt()) {
     PrimitiveArrayCopy<int32_t>(self, src_array, src_pos, dst_array, dst_pos, length);
+  } else if (src_type->IsPrimitiveShort()) {
+    PrimitiveArrayCopy<int16_t>(self, src_array, src_pos, dst_array, dst_pos, length);
+  } else if (src_type->IsPrimitiveLong()) {
+    PrimitiveArrayCopy<int64_t>(self, src_array, src_pos, dst_array, dst_pos, length);
+  } else if (src_type->IsPrimitiveFloat()) {
+    PrimitiveArrayCopy<float>(self, src_array, src_pos, dst_array, dst_pos, length);
+  } else if (src_type->IsPrimitiveDouble()) {
+    PrimitiveArrayCopy<double>(self, src_array, src_pos, dst_array, dst_pos, length);
+  } else if (src_type->IsPrimitiveBoolean()) {
+    PrimitiveArrayCopy<uint8_t>(self, src_array, src_pos, dst_array, dst_pos, length);
   } else {
     AbortTransactionOrFail(self, "Unimplemented System.arraycopy for type '%s'",
                            src_type->PrettyDescriptor().c_str());
@@ -932,6 +942,36 @@ void UnstartedRuntime::UnstartedSystemArraycopyInt(
   UnstartedRuntime::UnstartedSystemArraycopy(self, shadow_frame, result, arg_offset);
 }
 
+void UnstartedRuntime::UnstartedSystemArraycopyShort(
+    Thread* self, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
+  // Just forward.
+  UnstartedRuntime::UnstartedSystemArraycopy(self, shadow_frame, result, arg_offset);
+}
+
+void UnstartedRuntime::UnstartedSystemArraycopyLong(
+    Thread* self, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
+  // Just forward.
+  UnstartedRuntime::UnstartedSystemArraycopy(self, shadow_frame, result, arg_offset);
+}
+
+void UnstartedRuntime::UnstartedSystemArraycopyFloat(
+    Thread* self, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
+  // Just forward.
+  UnstartedRuntime::UnstartedSystemArraycopy(self, shadow_frame, result, arg_offset);
+}
+
+void UnstartedRuntime::UnstartedSystemArraycopyDouble(
+    Thread* self, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
+  // Just forward.
+  UnstartedRuntime::UnstartedSystemArraycopy(self, shadow_frame, result, arg_offset);
+}
+
+void UnstartedRuntime::UnstartedSystemArraycopyBoolean(
+    Thread* self, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
+  // Just forward.
+  UnstartedRuntime::UnstartedSystemArraycopy(self, shadow_frame, result, arg_offset);
+}
+
 void UnstartedRuntime::UnstartedSystemGetSecurityManager([[maybe_unused]] Thread* self,
                                                          [[maybe_unused]] ShadowFrame* shadow_frame,
                                                          JValue* result,
@@ -1206,6 +1246,49 @@ void UnstartedRuntime::UnstartedMathTan([[maybe_unused]] Thread* self,
   result->SetD(tan(shadow_frame->GetVRegDouble(arg_offset)));
 }
 
+void UnstartedRuntime::UnstartedMathAsin([[maybe_unused]] Thread* self,
+                                         ShadowFrame* shadow_frame,
+                                         JValue* result,
+                                         size_t arg_offset) {
+  result->SetD(asin(shadow_frame->GetVRegDouble(arg_offset)));
+}
+
+void UnstartedRuntime::UnstartedMathAcos([[maybe_unused]] Thread* self,
+                                         ShadowFrame* shadow_frame,
+                                         JValue* result,
+                                         size_t arg_offset) {
+  result->SetD(acos(shadow_frame->GetVRegDouble(arg_offset)));
+}
+
+void UnstartedRuntime::UnstartedMathAtan([[maybe_unused]] Thread* self,
+                                         ShadowFrame* shadow_frame,
+                                         JValue* result,
+                                         size_t arg_offset) {
+  result->SetD(atan(shadow_frame->GetVRegDouble(arg_offset)));
+}
+
+void UnstartedRuntime::UnstartedMathAtan2([[maybe_unused]] Thread* self,
+                                          ShadowFrame* shadow_frame,
+                                          JValue* result,
+                                          size_t arg_offset) {
+  result->SetD(atan2(shadow_frame->GetVRegDouble(arg_offset),
+                     shadow_frame->GetVRegDouble(arg_offset + 2)));
+}
+
+void UnstartedRuntime::UnstartedMathSqrt([[maybe_unused]] Thread* self,
+                                         ShadowFrame* shadow_frame,
+                                         JValue* result,
+                                         size_t arg_offset) {
+  result->SetD(sqrt(shadow_frame->GetVRegDouble(arg_offset)));
+}
+
+void UnstartedRuntime::UnstartedMathLog10([[maybe_unused]] Thread* self,
+                                          ShadowFrame* shadow_frame,
+                                          JValue* result,
+                                          size_t arg_offset) {
+  result->SetD(log10(shadow_frame->GetVRegDouble(arg_offset)));
+}
+
 void UnstartedRuntime::UnstartedObjectHashCode([[maybe_unused]] Thread* self,
                                                ShadowFrame* shadow_frame,
                                                JValue* result,
@@ -2004,6 +2087,29 @@ void UnstartedRuntime::UnstartedJNIStringCompareTo(Thread* self,
   result->SetI(receiver->AsString()->CompareTo(rhs->AsString()));
 }
 
+void UnstartedRuntime::UnstartedJNIStringConcat(Thread* self,
+                                                [[maybe_unused]] ArtMethod* method,
+                                                mirror::Object* receiver,
+                                                uint32_t* args,
+                                                JValue* result) {
+  ObjPtr<mirror::Object> arg = reinterpret_cast32<mirror::Object*>(args[0]);
+  if (arg == nullptr) {
+    AbortTransactionOrFail(self, "String.concat with null object.");
+    return;
+  }
+  StackHandleScope<2> hs(self);
+  Handle<mirror::String> h_this = hs.NewHandle(receiver->AsString());
+  Handle<mirror::String> h_arg = hs.NewHandle(arg->AsString());
+  // Like the native implementation, return one of the strings if the other one is empty.
+  if (h_this->GetLength() == 0) {
+    result->SetL(h_arg.Get());
+  } else if (h_arg->GetLength() == 0) {
+    result->SetL(h_this.Get());
+  } else {
+    result->SetL(mirror::String::DoConcat(self, h_this, h_arg));
+  }
+}
+
 void UnstartedRuntime::UnstartedJNIStringFillBytesLatin1(Thread* self,
                                                          [[maybe_unused]] ArtMethod* method,
                                                          mirror::Object* receiver,
@@ -43,6 +43,11 @@
   V(SystemArraycopyByte, "Ljava/lang/System;", "arraycopy", "([BI[BII)V") \
   V(SystemArraycopyChar, "Ljava/lang/System;", "arraycopy", "([CI[CII)V") \
   V(SystemArraycopyInt, "Ljava/lang/System;", "arraycopy", "([II[III)V") \
+  V(SystemArraycopyShort, "Ljava/lang/System;", "arraycopy", "([SI[SII)V") \
+  V(SystemArraycopyLong, "Ljava/lang/System;", "arraycopy", "([JI[JII)V") \
+  V(SystemArraycopyFloat, "Ljava/lang/System;", "arraycopy", "([FI[FII)V") \
+  V(SystemArraycopyDouble, "Ljava/lang/System;", "arraycopy", "([DI[DII)V") \
+  V(SystemArraycopyBoolean, "Ljava/lang/System;", "arraycopy", "([ZI[ZII)V") \
   V(SystemGetSecurityManager, "Ljava/lang/System;", "getSecurityManager", "()Ljava/lang/SecurityManager;") \
   V(SystemGetProperty, "Ljava/lang/System;", "getProperty", "(Ljava/lang/String;)Ljava/lang/String;") \
   V(SystemGetPropertyWithDefault, "Ljava/lang/System;", "getProperty", "(Ljava/lang/String;Ljava/lang/String;)Ljava/lang/String;") \
@@ -53,6 +58,12 @@
   V(MathCos, "Ljava/lang/Math;", "cos", "(D)D") \
   V(MathPow, "Ljava/lang/Math;", "pow", "(DD)D") \
   V(MathTan, "Ljava/lang/Math;", "tan", "(D)D") \
+  V(MathAsin, "Ljava/lang/Math;", "asin", "(D)D") \
+  V(MathAcos, "Ljava/lang/Math;", "acos", "(D)D") \
+  V(MathAtan, "Ljava/lang/Math;", "atan", "(D)D") \
+  V(MathAtan2, "Ljava/lang/Math;", "atan2", "(DD)D") \
+  V(MathSqrt, "Ljava/lang/Math;", "sqrt", "(D)D") \
+  V(MathLog10, "Ljava/lang/Math;", "log10", "(D)D") \
   V(ObjectHashCode, "Ljava/lang/Object;", "hashCode", "()I") \
   V(DoubleDoubleToRawLongBits, "Ljava/lang/Double;", "doubleToRawLongBits", "(D)J") \
   V(MemoryPeekByte, "Llibcore/io/Memory;", "peekByte", "(J)B") \
@@ -106,6 +117,7 @@
   V(ObjectInternalClone, "Ljava/lang/Object;", "internalClone", "()Ljava/lang/Object;") \
   V(ObjectNotifyAll, "Ljava/lang/Object;", "notifyAll", "()V") \
   V(StringCompareTo, "Ljava/lang/String;", "compareTo", "(Ljava/lang/String;)I") \
+  V(StringConcat, "Ljava/lang/String;", "concat", "(Ljava/lang/String;)Ljava/lang/String;") \
   V(StringFillBytesLatin1, "Ljava/lang/String;", "fillBytesLatin1", "([BI)V") \
   V(StringFillBytesUTF16, "Ljava/lang/String;", "fillBytesUTF16", "([BI)V") \
   V(StringIntern, "Ljava/lang/String;", "intern", "()Ljava/lang/String;") \
@@ -874,6 +874,50 @@ TEST_F(UnstartedRuntimeTest, Pow) {
   EXPECT_EQ(UINT64_C(0x3f8c5c51326aa7ee), lresult);
 }
 
+TEST_F(UnstartedRuntimeTest, Sqrt) {
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+
+  UniqueDeoptShadowFramePtr tmp = CreateShadowFrame(10, nullptr, 0);
+
+  tmp->SetVRegDouble(0, 2.25);
+
+  JValue result;
+  UnstartedMathSqrt(self, tmp.get(), &result, 0);
+
+  EXPECT_EQ(1.5, result.GetD());
+}
+
+TEST_F(UnstartedRuntimeTest, StringConcat) {
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+
+  StackHandleScope<3> hs(self);
+  Handle<mirror::String> h_foo = hs.NewHandle(mirror::String::AllocFromModifiedUtf8(self, "foo"));
+  Handle<mirror::String> h_bar = hs.NewHandle(mirror::String::AllocFromModifiedUtf8(self, "bar"));
+  Handle<mirror::String> h_empty = hs.NewHandle(mirror::String::AllocFromModifiedUtf8(self, ""));
+
+  JValue result;
+  uint32_t args[] = { reinterpret_cast32<uint32_t>(h_bar.Get()) };
+  UnstartedJNIStringConcat(self, nullptr, h_foo.Get(), args, &result);
+  ASSERT_TRUE(result.GetL() != nullptr);
+  EXPECT_EQ("foobar", result.GetL()->AsString()->ToModifiedUtf8());
+
+  // Concatenating an empty string returns the other string.
+  args[0] = reinterpret_cast32<uint32_t>(h_foo.Get());
+  UnstartedJNIStringConcat(self, nullptr, h_empty.Get(), args, &result);
+  EXPECT_OBJ_PTR_EQ(h_foo.Get(), result.GetL());
+
+  // Aborts the transaction for a null argument.
+  EnterTransactionMode();
+  args[0] = 0u;
+  UnstartedJNIStringConcat(self, nullptr, h_foo.Get(), args, &result);
+  ASSERT_TRUE(IsTransactionAborted());
+  ExitTransactionMode();
+  ASSERT_TRUE(self->IsExceptionPending());
+  self->ClearException();
+}
+
 TEST_F(UnstartedRuntimeTest, IsAnonymousClass) {
   Thread* self = Thread::Current();
   ScopedObjectAccess soa(self);
@@ -16,6 +16,7 @@
 
 #include "base/atomic.h"
 #include "base/locks.h"
+#include "gc/allocation_listener.h"
 #include "gc/heap.h"
 #include "javaheapprof/javaheapsampler.h"
 #ifdef ART_TARGET_ANDROID
@@ -66,8 +67,23 @@ void HeapSampler::ReportSample(art::mirror::Object* obj, size_t allocation_size)
   uint64_t perf_alloc_id = reinterpret_cast<uint64_t>(obj);
   VLOG(heap) << "JHP:***Report Perfetto Allocation: obj: " << perf_alloc_id;
 #ifdef ART_TARGET_ANDROID
-  AHeapProfile_reportSample(perfetto_heap_id_, perf_alloc_id, allocation_size);
+  if (enabled_.load(std::memory_order_acquire)) {
+    AHeapProfile_reportSample(perfetto_heap_id_, perf_alloc_id, allocation_size);
+  }
 #endif
+  // The listener needs a complete object, the allocation sends the sample once it has one.
+  if (obj != nullptr && sample_listener_.load(std::memory_order_acquire) != nullptr) {
+    *GetSamplePending() = true;
+  }
+}
+
+void HeapSampler::DispatchSample(Thread* self,
+                                 ObjPtr<mirror::Object>* obj,
+                                 size_t allocation_size) {
+  gc::AllocationListener* listener = sample_listener_.load(std::memory_order_acquire);
+  if (listener != nullptr) {
+    listener->ObjectAllocated(self, obj, allocation_size);
+  }
 }
 
 // Check whether we should take a sample or not at this allocation and calculate the sample
@@ -132,7 +148,8 @@ void HeapSampler::AdjustSampleOffset(size_t adjustment) {
 }
 
 bool HeapSampler::IsEnabled() {
-  return enabled_.load(std::memory_order_acquire);
+  return enabled_.load(std::memory_order_acquire) ||
+         sample_listener_.load(std::memory_order_acquire) != nullptr;
 }
 
 int HeapSampler::GetSamplingInterval() {
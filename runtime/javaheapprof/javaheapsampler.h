@@ -21,9 +21,14 @@
 #include "base/locks.h"
 #include "base/mutex.h"
 #include "mirror/object.h"
+#include "obj_ptr.h"
 
 namespace art {
 
+namespace gc {
+class AllocationListener;
+}  // namespace gc
+
 class HeapSampler {
  public:
   HeapSampler() : rng_(/*seed=*/std::minstd_rand::default_seed),
@@ -51,7 +56,25 @@ class HeapSampler {
   void DisableHeapSampler() {
     enabled_.store(false, std::memory_order_release);
   }
-  // Report a sample to Perfetto.
+  // Set the listener that receives the sampled allocations once they are complete, or nullptr.
+  // The sampler runs while a listener is set, even if Perfetto did not enable it. A listener that
+  // was once set must never be deleted.
+  void SetSampleListener(gc::AllocationListener* listener) {
+    sample_listener_.store(listener, std::memory_order_release);
+  }
+  // Whether ReportSample() sampled the allocation in progress on this thread for the sample
+  // listener. Clears the sample.
+  bool TakePendingSample() {
+    bool* sample_pending = GetSamplePending();
+    bool result = *sample_pending;
+    *sample_pending = false;
+    return result;
+  }
+  // Send a sample returned by TakePendingSample() to the sample listener. May suspend.
+  void DispatchSample(Thread* self, ObjPtr<mirror::Object>* obj, size_t allocation_size)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+  // Report a sample to Perfetto, and record it for the sample listener. The object may not be
+  // initialized yet.
   void ReportSample(art::mirror::Object* obj, size_t allocation_size);
   // Check whether we should take a sample or not at this allocation, and return the
   // number of bytes from current pos to the next sample to use in the expand Tlab
@@ -75,12 +98,17 @@ class HeapSampler {
   int GetSamplingInterval();
 
  private:
+  bool* GetSamplePending() {
+    thread_local bool sample_pending = false;
+    return &sample_pending;
+  }
   size_t NextGeoDistRandSample() REQUIRES(!geo_dist_rng_lock_);
   // Choose, save, and return the number of bytes until the next sample,
   // possibly decreasing sample intervals by sample_adj_bytes.
   size_t PickAndAdjustNextSample(size_t sample_adj_bytes = 0) REQUIRES(!geo_dist_rng_lock_);
 
   std::atomic<bool> enabled_;
+  std::atomic<gc::AllocationListener*> sample_listener_{nullptr};
   // Default sampling interval is 4kb.
   // Writes guarded by geo_dist_rng_lock_.
   std::atomic<int> p_sampling_interval_{4 * 1024};
@@ -30,15 +30,18 @@
 #include "class_root-inl.h"
 #include "compilation_kind.h"
 #include "debugger.h"
+#include "dex/dex_file_loader.h"
 #include "dex/type_lookup_table.h"
 #include "gc/space/image_space.h"
 #include "entrypoints/entrypoint_utils-inl.h"
 #include "entrypoints/runtime_asm_entrypoints.h"
+#include "handle_scope-inl.h"
 #include "image-inl.h"
 #include "interpreter/interpreter.h"
 #include "jit-inl.h"
 #include "jit_code_cache.h"
 #include "jni/java_vm_ext.h"
+#include "mirror/dex_cache-inl.h"
 #include "mirror/method_handle_impl.h"
 #include "mirror/var_handle.h"
 #include "oat_file.h"
@@ -90,6 +93,8 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
   jit_options->use_jit_compilation_ = options.GetOrDefault(RuntimeArgumentMap::UseJitCompilation);
   jit_options->use_profiled_jit_compilation_ =
       options.GetOrDefault(RuntimeArgumentMap::UseProfiledJitCompilation);
+  jit_options->precompile_from_profile_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITPrecompileFromProfile);
 
   jit_options->code_cache_initial_capacity_ =
       options.GetOrDefault(RuntimeArgumentMap::JITCodeCacheInitialCapacity);
@@ -103,6 +108,11 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
       options.GetOrDefault(RuntimeArgumentMap::JITPoolThreadPthreadPriority);
   jit_options->zygote_thread_pool_pthread_priority_ =
       options.GetOrDefault(RuntimeArgumentMap::JITZygotePoolThreadPthreadPriority);
+  jit_options->cpu_budget_ = options.GetOrDefault(RuntimeArgumentMap::JITCpuBudget);
+  jit_options->zygote_shared_profile_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITZygoteSharedProfile);
+  jit_options->pretenure_allocation_sites_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITPretenureAllocationSites);
 
   // Set default optimize threshold to aid with checking defaults.
   jit_options->optimize_threshold_ =
@@ -384,6 +394,16 @@ void Jit::DeleteThreadPool() {
 void Jit::StartProfileSaver(const std::string& profile_filename,
                             const std::vector<std::string>& code_paths,
                             const std::string& ref_profile_filename) {
+  if (options_->PrecompileFromProfile() &&
+      UseJitCompilation() &&
+      thread_pool_ != nullptr &&
+      !profile_filename.empty() &&
+      !Runtime::Current()->IsJavaDebuggable()) {
+    // Read the profile before the saver of this run can update it. The methods are only
+    // compiled after boot, see `CompileMethodsFromProfile`.
+    thread_pool_->AddTask(Thread::Current(),
+                          new JitSavedProfileTask(profile_filename, code_paths));
+  }
   if (options_->GetSaveProfilingInfo()) {
     ProfileSaver::Start(options_->GetProfileSaverOptions(),
                         profile_filename,
@@ -460,14 +480,18 @@ extern "C" void art_quick_osr_stub(void** stack,
                                    const char* shorty,
                                    Thread* self);
 
-OsrData* Jit::PrepareForOsr(ArtMethod* method, uint32_t dex_pc, uint32_t* vregs) {
+OsrData* Jit::PrepareForOsr(ArtMethod* method,
+                            uint32_t dex_pc,
+                            uint32_t* vregs,
+                            bool osr_without_jit_code) {
   if (!kEnableOnStackReplacement) {
     return nullptr;
   }
 
   // Cheap check if the method has been compiled already. That's an indicator that we should
   // osr into it.
-  if (!GetCodeCache()->ContainsPc(method->GetEntryPointFromQuickCompiledCode())) {
+  if (!osr_without_jit_code &&
+      !GetCodeCache()->ContainsPc(method->GetEntryPointFromQuickCompiledCode())) {
     return nullptr;
   }
 
@@ -803,6 +827,27 @@ class ScopedCompilation {
   bool owns_compilation_;
 };
 
+// Priorities of the compilation tasks in the JIT thread pool. Methods stuck in a loop, and
+// methods whose baseline code got hot, are compiled before the first baseline compilations,
+// which are compiled before the profile and other tasks at the default priority.
+static constexpr int32_t kBaselineCompilePriority = ThreadPool::kDefaultTaskPriority + 1;
+static constexpr int32_t kOptimizedCompilePriority = ThreadPool::kDefaultTaskPriority + 2;
+static constexpr int32_t kOsrCompilePriority = ThreadPool::kDefaultTaskPriority + 3;
+
+static int32_t GetCompileTaskPriority(CompilationKind compilation_kind, bool precompile) {
+  if (precompile) {
+    return ThreadPool::kDefaultTaskPriority;
+  }
+  switch (compilation_kind) {
+    case CompilationKind::kOsr:
+      return kOsrCompilePriority;
+    case CompilationKind::kOptimized:
+      return kOptimizedCompilePriority;
+    case CompilationKind::kBaseline:
+      return kBaselineCompilePriority;
+  }
+}
+
 class JitCompileTask final : public Task {
  public:
   enum class TaskKind {
@@ -829,11 +874,14 @@ class JitCompileTask final : public Task {
       switch (kind_) {
         case TaskKind::kCompile:
         case TaskKind::kPreCompile: {
-          Runtime::Current()->GetJit()->CompileMethodInternal(
+          Jit* jit = Runtime::Current()->GetJit();
+          uint64_t start_ns = ThreadCpuNanoTime();
+          jit->CompileMethodInternal(
               method_,
               self,
               compilation_kind_,
               /* prejit= */ (kind_ == TaskKind::kPreCompile));
+          jit->AddCompilationCpuTime(self, ThreadCpuNanoTime() - start_ns);
           break;
         }
       }
@@ -845,6 +893,10 @@ class JitCompileTask final : public Task {
     delete this;
   }
 
+  ArtMethod* GetMethod() const {
+    return method_;
+  }
+
  private:
   ArtMethod* const method_;
   const TaskKind kind_;
@@ -996,6 +1048,18 @@ class ZygoteTask final : public Task {
             self, boot_class_path, profile_file, null_handle, /* add_to_queue= */ true);
       }
     }
+    const std::string& shared_profile = runtime->GetJit()->GetZygoteSharedProfile();
+    if (!shared_profile.empty()) {
+      // The boot classpath methods that many apps compile on their own. Compiling them here
+      // puts them in the zygote region, which the children map instead of compiling them.
+      LOG(INFO) << "JIT Zygote looking at shared profile " << shared_profile;
+      added_to_queue += runtime->GetJit()->CompileMethodsFromProfile(
+          self,
+          runtime->GetClassLinker()->GetBootClassPath(),
+          shared_profile,
+          ScopedNullHandle<mirror::ClassLoader>(),
+          /* add_to_queue= */ true);
+    }
     DCHECK(runtime->GetJit()->InZygoteUsingJit());
     runtime->GetJit()->AddPostBootTask(self, new JitZygoteDoneCompilingTask());
 
@@ -1072,6 +1136,76 @@ class JitProfileTask final : public Task {
   DISALLOW_COPY_AND_ASSIGN(JitProfileTask);
 };
 
+/**
+ * A JIT task to compile the methods that the profile saver recorded for the app in its
+ * previous runs. The profile data of a dex file is only used if its checksum matches.
+ */
+class JitSavedProfileTask final : public SelfDeletingTask {
+ public:
+  JitSavedProfileTask(const std::string& profile_filename,
+                      const std::vector<std::string>& code_paths)
+      : profile_filename_(profile_filename), code_paths_(code_paths.begin(), code_paths.end()) {}
+
+  void Run(Thread* self) override {
+    ScopedObjectAccess soa(self);
+    VariableSizedHandleScope hs(self);
+    // The dex files of the code paths, grouped by the class loader they are registered with.
+    std::vector<std::pair<Handle<mirror::ClassLoader>, std::vector<const DexFile*>>> dex_files;
+    {
+      ReaderMutexLock mu(self, *Locks::dex_lock_);
+      CodePathsVisitor visitor(code_paths_, &hs, &dex_files);
+      Runtime::Current()->GetClassLinker()->VisitDexCaches(&visitor);
+    }
+    Jit* jit = Runtime::Current()->GetJit();
+    uint32_t added_to_queue = 0u;
+    for (const auto& [class_loader, loader_dex_files] : dex_files) {
+      added_to_queue += jit->CompileMethodsFromProfile(
+          self, loader_dex_files, profile_filename_, class_loader, /* add_to_queue= */ true);
+    }
+    VLOG(jit) << "Queued " << added_to_queue << " methods from saved profile "
+              << profile_filename_;
+  }
+
+ private:
+  class CodePathsVisitor final : public DexCacheVisitor {
+   public:
+    CodePathsVisitor(
+        const std::set<std::string>& code_paths,
+        VariableSizedHandleScope* hs,
+        std::vector<std::pair<Handle<mirror::ClassLoader>, std::vector<const DexFile*>>>* out)
+        : code_paths_(code_paths), hs_(hs), out_(out) {}
+
+    void Visit(ObjPtr<mirror::DexCache> dex_cache)
+        REQUIRES_SHARED(Locks::dex_lock_, Locks::mutator_lock_) override {
+      const DexFile* dex_file = dex_cache->GetDexFile();
+      ObjPtr<mirror::ClassLoader> class_loader = dex_cache->GetClassLoader();
+      if (dex_file == nullptr ||
+          class_loader == nullptr ||
+          code_paths_.count(DexFileLoader::GetBaseLocation(dex_file->GetLocation())) == 0u) {
+        return;
+      }
+      auto it = std::find_if(out_->begin(), out_->end(), [&](const auto& entry) {
+        return entry.first.Get() == class_loader;
+      });
+      if (it == out_->end()) {
+        out_->emplace_back(hs_->NewHandle(class_loader), std::vector<const DexFile*>());
+        it = out_->end() - 1;
+      }
+      it->second.push_back(dex_file);
+    }
+
+   private:
+    const std::set<std::string>& code_paths_;
+    VariableSizedHandleScope* const hs_;
+    std::vector<std::pair<Handle<mirror::ClassLoader>, std::vector<const DexFile*>>>* const out_;
+  };
+
+  const std::string profile_filename_;
+  const std::set<std::string> code_paths_;
+
+  DISALLOW_COPY_AND_ASSIGN(JitSavedProfileTask);
+};
+
 static void CopyIfDifferent(void* s1, const void* s2, size_t n) {
   if (memcmp(s1, s2, n) != 0) {
     memcpy(s1, s2, n);
@@ -1351,8 +1485,19 @@ void Jit::AddCompileTask(Thread* self,
   JitCompileTask::TaskKind task_kind = precompile
       ? JitCompileTask::TaskKind::kPreCompile
       : JitCompileTask::TaskKind::kCompile;
+  const int32_t priority = GetCompileTaskPriority(compilation_kind, precompile);
+  if (priority == kOptimizedCompilePriority) {
+    // A baseline compilation of the method that is still queued is stale: it would either be
+    // replaced by the optimized code, or be compiled optimized as well if we cannot allocate
+    // profiling infos anymore.
+    thread_pool_->RemoveTasks(self, [method](Task* task, int32_t task_priority) {
+      // Only JitCompileTasks are queued with the compilation priorities.
+      return task_priority == kBaselineCompilePriority &&
+             down_cast<JitCompileTask*>(task)->GetMethod() == method;
+    });
+  }
   thread_pool_->AddTask(
-      self, new JitCompileTask(method, task_kind, compilation_kind, std::move(sc)));
+      self, new JitCompileTask(method, task_kind, compilation_kind, std::move(sc)), priority);
 }
 
 bool Jit::CompileMethodFromProfile(Thread* self,
@@ -1545,9 +1690,42 @@ void Jit::EnqueueOptimizedCompilation(ArtMethod* method, Thread* self) {
   // We arrive here after a baseline compiled code has reached its baseline
   // hotness threshold. If we're not only using the baseline compiler, enqueue a compilation
   // task that will compile optimize the method.
-  if (!options_->UseBaselineCompiler()) {
-    AddCompileTask(self, method, CompilationKind::kOptimized);
+  if (options_->UseBaselineCompiler()) {
+    return;
+  }
+  // The baseline code keeps running and asks again once it reaches the threshold again.
+  if (ShouldDeferOptimizedCompilation(self)) {
+    VLOG(jit) << "Deferring optimized compilation of " << ArtMethod::PrettyMethod(method);
+    return;
   }
+  AddCompileTask(self, method, CompilationKind::kOptimized);
+}
+
+void Jit::AddCompilationCpuTime(Thread* self, uint64_t cpu_time_ns) {
+  if (options_->GetCpuBudget() == 0u) {
+    return;
+  }
+  uint64_t now_ns = NanoTime();
+  MutexLock mu(self, lock_);
+  if (now_ns - cpu_budget_window_start_ns_ >= MsToNs(kJitCpuBudgetWindowMs)) {
+    cpu_budget_window_start_ns_ = now_ns;
+    cpu_budget_window_used_ns_ = 0u;
+  }
+  cpu_budget_window_used_ns_ += cpu_time_ns;
+}
+
+bool Jit::ShouldDeferOptimizedCompilation(Thread* self) {
+  if (thermal_status_.load(std::memory_order_relaxed) >= kJitThrottleThermalStatus) {
+    return true;
+  }
+  uint32_t budget = options_->GetCpuBudget();
+  if (budget == 0u) {
+    return false;
+  }
+  uint64_t now_ns = NanoTime();
+  MutexLock mu(self, lock_);
+  return now_ns - cpu_budget_window_start_ns_ < MsToNs(kJitCpuBudgetWindowMs) &&
+         cpu_budget_window_used_ns_ * 100u > MsToNs(kJitCpuBudgetWindowMs) * budget;
 }
 
 class ScopedSetRuntimeThread {
@@ -1783,7 +1961,7 @@ bool Jit::CanAssumeInitialized(ObjPtr<mirror::Class> cls, bool is_for_shared_reg
   }
 }
 
-void Jit::MaybeEnqueueCompilation(ArtMethod* method, Thread* self) {
+void Jit::MaybeEnqueueCompilation(ArtMethod* method, Thread* self, bool from_back_edge) {
   if (thread_pool_ == nullptr) {
     return;
   }
@@ -1837,9 +2015,25 @@ void Jit::MaybeEnqueueCompilation(ArtMethod* method, Thread* self) {
     }
   }
 
+  if (kRuntimeISA == InstructionSet::kRiscv64 &&
+      from_back_edge &&
+      !method->IsNative() &&
+      !code_cache_->IsOsrCompiled(method)) {
+    // On riscv64, the method got hot in a loop of nterp, which may keep running for a long
+    // time. Compile the OSR version now rather than once the method has other JIT code, so
+    // that the loop can leave the interpreter the next time it reaches the threshold. The OSR
+    // code has an entry at every loop header, so the hottest loop is covered whichever one
+    // crossed the threshold.
+    AddCompileTask(self, method, CompilationKind::kOsr);
+  }
+
   if (!method->IsNative() && GetCodeCache()->CanAllocateProfilingInfo()) {
     AddCompileTask(self, method, CompilationKind::kBaseline);
   } else {
+    if (!method->IsNative() && options_->GetSaveProfilingInfo()) {
+      // The profile saver finds hot methods through their profiling info.
+      GetCodeCache()->AddHotMethodWithoutProfilingInfo(method);
+    }
     AddCompileTask(self, method, CompilationKind::kOptimized);
   }
 }
@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_JIT_JIT_H_
 #define ART_RUNTIME_JIT_JIT_H_
 
+#include <atomic>
+
 #include <android-base/unique_fd.h>
 
 #include "base/histogram-inl.h"
@@ -66,6 +68,11 @@ static constexpr int kJitPoolThreadPthreadDefaultPriority = 9;
 // 19 is the lowest background priority on device.
 // See android/os/Process.java.
 static constexpr int kJitZygotePoolThreadPthreadDefaultPriority = 19;
+// The window over which the CPU time spent compiling is compared to the JIT CPU budget.
+static constexpr uint64_t kJitCpuBudgetWindowMs = 1000;
+// From this thermal status on, optimized compilations are deferred. This is
+// THERMAL_STATUS_MODERATE, see android/os/PowerManager.java.
+static constexpr int32_t kJitThrottleThermalStatus = 2;
 
 class JitOptions {
  public:
@@ -115,6 +122,27 @@ class JitOptions {
     return zygote_thread_pool_pthread_priority_;
   }
 
+  // The percentage of a `kJitCpuBudgetWindowMs` window that compilations may take before
+  // optimized compilations get deferred. Zero means no budget.
+  uint32_t GetCpuBudget() const {
+    return cpu_budget_;
+  }
+
+  // A boot profile of the boot classpath methods that the zygote compiles into the region
+  // it shares with its children, in addition to the profiles of the boot image. It is meant
+  // for the methods that apps would otherwise compile independently, aggregated from their
+  // profiles outside of the runtime. Empty for none.
+  const std::string& GetZygoteSharedProfile() const {
+    return zygote_shared_profile_;
+  }
+
+  // Whether the GC samples the survival of the objects allocated by the methods with a
+  // ProfilingInfo, and optimized code allocates the objects of the long-lived sites in the
+  // non-moving space.
+  bool PretenureAllocationSites() const {
+    return pretenure_allocation_sites_;
+  }
+
   bool UseJitCompilation() const {
     return use_jit_compilation_;
   }
@@ -123,6 +151,12 @@ class JitOptions {
     return use_profiled_jit_compilation_;
   }
 
+  // Whether to compile, after boot, the methods that the profile saver recorded for the
+  // app's code paths in its previous runs.
+  bool PrecompileFromProfile() const {
+    return precompile_from_profile_;
+  }
+
   void SetUseJitCompilation(bool b) {
     use_jit_compilation_ = b;
   }
@@ -155,6 +189,7 @@ class JitOptions {
 
   bool use_jit_compilation_;
   bool use_profiled_jit_compilation_;
+  bool precompile_from_profile_;
   bool use_baseline_compiler_;
   size_t code_cache_initial_capacity_;
   size_t code_cache_max_capacity_;
@@ -165,11 +200,15 @@ class JitOptions {
   bool dump_info_on_shutdown_;
   int thread_pool_pthread_priority_;
   int zygote_thread_pool_pthread_priority_;
+  uint32_t cpu_budget_;
+  std::string zygote_shared_profile_;
+  bool pretenure_allocation_sites_;
   ProfileSaverOptions profile_saver_options_;
 
   JitOptions()
       : use_jit_compilation_(false),
         use_profiled_jit_compilation_(false),
+        precompile_from_profile_(false),
         use_baseline_compiler_(false),
         code_cache_initial_capacity_(0),
         code_cache_max_capacity_(0),
@@ -179,7 +218,9 @@ class JitOptions {
         invoke_transition_weight_(0),
         dump_info_on_shutdown_(false),
         thread_pool_pthread_priority_(kJitPoolThreadPthreadDefaultPriority),
-        zygote_thread_pool_pthread_priority_(kJitZygotePoolThreadPthreadDefaultPriority) {}
+        zygote_thread_pool_pthread_priority_(kJitZygotePoolThreadPthreadDefaultPriority),
+        cpu_budget_(0),
+        pretenure_allocation_sites_(false) {}
 
   DISALLOW_COPY_AND_ASSIGN(JitOptions);
 };
@@ -279,6 +320,10 @@ class Jit {
     return options_->GetZygoteThreadPoolPthreadPriority();
   }
 
+  const std::string& GetZygoteSharedProfile() const {
+    return options_->GetZygoteSharedProfile();
+  }
+
   uint16_t HotMethodThreshold() const {
     return options_->GetOptimizeThreshold();
   }
@@ -349,8 +394,13 @@ class Jit {
   bool CanInvokeCompiledCode(ArtMethod* method);
 
   // Return the information required to do an OSR jump. Return null if the OSR
-  // cannot be done.
-  OsrData* PrepareForOsr(ArtMethod* method, uint32_t dex_pc, uint32_t* vregs)
+  // cannot be done. Unless `osr_without_jit_code` is true, we only look for OSR
+  // code if the method already has JIT code, which avoids taking the JIT lock on
+  // every interpreted branch.
+  OsrData* PrepareForOsr(ArtMethod* method,
+                         uint32_t dex_pc,
+                         uint32_t* vregs,
+                         bool osr_without_jit_code = false)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // If an OSR compiled version is available for `method`,
@@ -440,7 +490,21 @@ class Jit {
 
   void EnqueueOptimizedCompilation(ArtMethod* method, Thread* self);
 
-  void MaybeEnqueueCompilation(ArtMethod* method, Thread* self)
+  // Account `cpu_time_ns` of compilation to the current JIT CPU budget window.
+  void AddCompilationCpuTime(Thread* self, uint64_t cpu_time_ns) REQUIRES(!lock_);
+
+  // Set from the framework, see android/os/PowerManager.java for the values.
+  void SetThermalStatus(int32_t status) {
+    thermal_status_.store(status, std::memory_order_relaxed);
+  }
+
+  // Whether optimized compilations should be deferred, because the device is
+  // thermally throttled or because the JIT exceeded its CPU budget.
+  bool ShouldDeferOptimizedCompilation(Thread* self) REQUIRES(!lock_);
+
+  // Called when `method` reached its hotness threshold. `from_back_edge` tells
+  // whether the threshold was reached in a loop.
+  void MaybeEnqueueCompilation(ArtMethod* method, Thread* self, bool from_back_edge = false)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
  private:
@@ -496,6 +560,11 @@ class Jit {
   Histogram<uint64_t> memory_use_ GUARDED_BY(lock_);
   Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
 
+  // CPU budget accounting, see `JitOptions::GetCpuBudget()`.
+  uint64_t cpu_budget_window_start_ns_ GUARDED_BY(lock_) = 0u;
+  uint64_t cpu_budget_window_used_ns_ GUARDED_BY(lock_) = 0u;
+  std::atomic<int32_t> thermal_status_ = 0;
+
   // In the JIT zygote configuration, after all compilation is done, the zygote
   // will copy its contents of the boot image to the zygote_mapping_methods_,
   // which will be picked up by processes that will map the memory
@@ -34,6 +34,7 @@
 #include "base/time_utils.h"
 #include "base/utils.h"
 #include "cha.h"
+#include "code_info_cache.h"
 #include "debugger_interface.h"
 #include "dex/dex_file_loader.h"
 #include "dex/method_reference.h"
@@ -573,6 +574,14 @@ void JitCodeCache::RemoveMethodsIn(Thread* self, const LinearAlloc& alloc) {
         ++it;
       }
     }
+    for (auto it = hot_methods_without_profiling_info_.begin();
+         it != hot_methods_without_profiling_info_.end();) {
+      if (alloc.ContainsUnsafe(*it)) {
+        it = hot_methods_without_profiling_info_.erase(it);
+      } else {
+        ++it;
+      }
+    }
     FreeAllMethodHeaders(method_headers);
   }
 }
@@ -1033,6 +1042,7 @@ void JitCodeCache::Free(Thread* self,
 
 void JitCodeCache::FreeLocked(JitMemoryRegion* region, const uint8_t* code, const uint8_t* data) {
   if (code != nullptr) {
+    CodeInfoCache::InvalidateAll();
     RemoveNativeDebugInfoForJit(reinterpret_cast<const void*>(FromAllocationToCode(code)));
     region->FreeCode(code);
   }
@@ -1162,6 +1172,11 @@ void JitCodeCache::GarbageCollectCache(Thread* self) {
     {
       MutexLock mu(self, *Locks::jit_lock_);
 
+      // Live code isn't moved, so that return addresses on the stacks stay valid. Instead,
+      // don't keep the holes left by the collected code and data resident.
+      size_t released = private_region_.ReleaseUnusedPages();
+      VLOG(jit) << "Released " << PrettySize(released) << " of unused code cache pages";
+
       // Increase the code cache only when we do partial collections.
       // TODO: base this strategy on how full the code cache is?
       if (do_full_collection) {
@@ -1487,25 +1502,47 @@ OatQuickMethodHeader* JitCodeCache::LookupOsrMethodHeader(ArtMethod* method) {
 
 ProfilingInfo* JitCodeCache::AddProfilingInfo(Thread* self,
                                               ArtMethod* method,
-                                              const std::vector<uint32_t>& entries) {
+                                              const std::vector<uint32_t>& entries,
+                                              const std::vector<uint32_t>& allocation_sites) {
   DCHECK(CanAllocateProfilingInfo());
   ProfilingInfo* info = nullptr;
   {
     MutexLock mu(self, *Locks::jit_lock_);
-    info = AddProfilingInfoInternal(self, method, entries);
+    info = AddProfilingInfoInternal(self, method, entries, allocation_sites);
   }
 
   if (info == nullptr) {
     GarbageCollectCache(self);
     MutexLock mu(self, *Locks::jit_lock_);
-    info = AddProfilingInfoInternal(self, method, entries);
+    info = AddProfilingInfoInternal(self, method, entries, allocation_sites);
   }
   return info;
 }
 
-ProfilingInfo* JitCodeCache::AddProfilingInfoInternal(Thread* self,
-                                                      ArtMethod* method,
-                                                      const std::vector<uint32_t>& entries) {
+void JitCodeCache::AddAllocationSample(ArtMethod* method, uint32_t dex_pc, bool survived) {
+  auto it = profiling_infos_.find(method);
+  if (it != profiling_infos_.end()) {
+    it->second->AddAllocationSample(dex_pc, survived);
+  }
+}
+
+void JitCodeCache::AddInvokeInfo(Thread* self,
+                                 ArtMethod* method,
+                                 uint32_t dex_pc,
+                                 mirror::Class* cls) {
+  MutexLock mu(self, *Locks::jit_lock_);
+  auto it = profiling_infos_.find(method);
+  if (it != profiling_infos_.end()) {
+    ScopedAssertNoThreadSuspension sants("Adding invoke info");
+    it->second->AddInvokeInfo(dex_pc, cls);
+  }
+}
+
+ProfilingInfo* JitCodeCache::AddProfilingInfoInternal(
+    Thread* self,
+    ArtMethod* method,
+    const std::vector<uint32_t>& entries,
+    const std::vector<uint32_t>& allocation_sites) {
   ScopedDebugDisallowReadBarriers sddrb(self);
   // Check whether some other thread has concurrently created it.
   auto it = profiling_infos_.find(method);
@@ -1514,7 +1551,8 @@ ProfilingInfo* JitCodeCache::AddProfilingInfoInternal(Thread* self,
   }
 
   size_t profile_info_size = RoundUp(
-      sizeof(ProfilingInfo) + sizeof(InlineCache) * entries.size(),
+      sizeof(ProfilingInfo) + sizeof(InlineCache) * entries.size() +
+          sizeof(AllocationSite) * allocation_sites.size(),
       sizeof(void*));
 
   const uint8_t* data = private_region_.AllocateData(profile_info_size);
@@ -1522,7 +1560,7 @@ ProfilingInfo* JitCodeCache::AddProfilingInfoInternal(Thread* self,
     return nullptr;
   }
   uint8_t* writable_data = private_region_.GetWritableDataAddress(data);
-  ProfilingInfo* info = new (writable_data) ProfilingInfo(method, entries);
+  ProfilingInfo* info = new (writable_data) ProfilingInfo(method, entries, allocation_sites);
 
   profiling_infos_.Put(method, info);
   histogram_profiling_info_memory_use_.AddValue(profile_info_size);
@@ -1535,6 +1573,12 @@ void* JitCodeCache::MoreCore(const void* mspace, intptr_t increment) {
       : private_region_.MoreCore(mspace, increment);
 }
 
+void JitCodeCache::AddHotMethodWithoutProfilingInfo(ArtMethod* method) {
+  DCHECK(!method->IsNative());
+  MutexLock mu(Thread::Current(), *Locks::jit_lock_);
+  hot_methods_without_profiling_info_.insert(method);
+}
+
 void JitCodeCache::GetProfiledMethods(const std::set<std::string>& dex_base_locations,
                                       std::vector<ProfileMethodInfo>& methods) {
   Thread* self = Thread::Current();
@@ -1623,6 +1667,18 @@ void JitCodeCache::GetProfiledMethods(const std::set<std::string>& dex_base_loca
     methods.emplace_back(/*ProfileMethodInfo*/
         MethodReference(dex_file, method->GetDexMethodIndex()), inline_caches);
   }
+  for (ArtMethod* method : hot_methods_without_profiling_info_) {
+    if (profiling_infos_.find(method) != profiling_infos_.end()) {
+      continue;  // Already added above.
+    }
+    const DexFile* dex_file = method->GetDexFile();
+    if (ContainsElement(dex_base_locations,
+                        DexFileLoader::GetBaseLocation(dex_file->GetLocation()))) {
+      methods.emplace_back(/*ProfileMethodInfo*/
+          MethodReference(dex_file, method->GetDexMethodIndex()),
+          std::vector<ProfileMethodInfo::ProfileInlineCache>());
+    }
+  }
 }
 
 bool JitCodeCache::IsOsrCompiled(ArtMethod* method) {
@@ -317,7 +317,19 @@ class JitCodeCache {
   // Create a 'ProfileInfo' for 'method'.
   ProfilingInfo* AddProfilingInfo(Thread* self,
                                   ArtMethod* method,
-                                  const std::vector<uint32_t>& entries)
+                                  const std::vector<uint32_t>& entries,
+                                  const std::vector<uint32_t>& allocation_sites)
+      REQUIRES(!Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Add to the ProfilingInfo of `method`, if it has one, whether an object allocated at
+  // `dex_pc` survived its first GC.
+  void AddAllocationSample(ArtMethod* method, uint32_t dex_pc, bool survived)
+      REQUIRES(Locks::jit_lock_);
+
+  // Add `cls` to the inline cache of the invoke at `dex_pc` in the ProfilingInfo of `method`,
+  // if it has one. Used by the interpreter, compiled code updates the inline caches directly.
+  void AddInvokeInfo(Thread* self, ArtMethod* method, uint32_t dex_pc, mirror::Class* cls)
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -327,6 +339,12 @@ class JitCodeCache {
 
   void* MoreCore(const void* mspace, intptr_t increment);
 
+  // Remember a method that got hot but does not get a profiling info, so that
+  // `GetProfiledMethods()` still reports it.
+  void AddHotMethodWithoutProfilingInfo(ArtMethod* method)
+      REQUIRES(!Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Adds to `methods` all profiled methods which are part of any of the given dex locations.
   void GetProfiledMethods(const std::set<std::string>& dex_base_locations,
                           std::vector<ProfileMethodInfo>& methods)
@@ -424,7 +442,8 @@ class JitCodeCache {
 
   ProfilingInfo* AddProfilingInfoInternal(Thread* self,
                                           ArtMethod* method,
-                                          const std::vector<uint32_t>& entries)
+                                          const std::vector<uint32_t>& entries,
+                                          const std::vector<uint32_t>& allocation_sites)
       REQUIRES(Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -556,6 +575,9 @@ class JitCodeCache {
   // ProfilingInfo objects we have allocated.
   SafeMap<ArtMethod*, ProfilingInfo*> profiling_infos_ GUARDED_BY(Locks::jit_lock_);
 
+  // Methods that got hot without a ProfilingInfo, see `AddHotMethodWithoutProfilingInfo()`.
+  std::set<ArtMethod*> hot_methods_without_profiling_info_ GUARDED_BY(Locks::jit_lock_);
+
   // Methods we are currently compiling, one set for each kind of compilation.
   std::set<ArtMethod*> current_optimized_compilations_ GUARDED_BY(Locks::jit_lock_);
   std::set<ArtMethod*> current_osr_compilations_ GUARDED_BY(Locks::jit_lock_);
@@ -17,6 +17,7 @@
 #include "jit_memory_region.h"
 
 #include <fcntl.h>
+#include <sys/mman.h>
 #include <unistd.h>
 
 #include <android-base/unique_fd.h>
@@ -335,6 +336,36 @@ bool JitMemoryRegion::IncreaseCodeCacheCapacity() {
   return true;
 }
 
+// Callback for mspace_inspect_all releasing the whole pages of free chunks. The views of a dual
+// mapping share the pages of a memfd, which only MADV_REMOVE frees: MADV_DONTNEED would just
+// unmap them from the view. Private mappings don't support MADV_REMOVE, so fall back to it.
+static void ReleaseFreePagesCallback(void* start, void* end, size_t used_bytes, void* arg) {
+  if (used_bytes != 0) {
+    return;
+  }
+  uint8_t* begin = AlignUp(reinterpret_cast<uint8_t*>(start), kPageSize);
+  uint8_t* limit = AlignDown(reinterpret_cast<uint8_t*>(end), kPageSize);
+  if (limit <= begin) {
+    return;
+  }
+  const size_t length = limit - begin;
+  if (madvise(begin, length, MADV_REMOVE) == 0 || madvise(begin, length, MADV_DONTNEED) == 0) {
+    *reinterpret_cast<size_t*>(arg) += length;
+  }
+}
+
+size_t JitMemoryRegion::ReleaseUnusedPages() {
+  ScopedTrace trace(__PRETTY_FUNCTION__);
+  size_t released = 0;
+  if (data_mspace_ != nullptr) {
+    mspace_inspect_all(data_mspace_, ReleaseFreePagesCallback, &released);
+  }
+  if (exec_mspace_ != nullptr) {
+    mspace_inspect_all(exec_mspace_, ReleaseFreePagesCallback, &released);
+  }
+  return released;
+}
+
 // NO_THREAD_SAFETY_ANALYSIS as this is called from mspace code, at which point the lock
 // is already held.
 void* JitMemoryRegion::MoreCore(const void* mspace, intptr_t increment) NO_THREAD_SAFETY_ANALYSIS {
@@ -79,6 +79,10 @@ class JitMemoryRegion {
   // Set the footprint limit of the code cache.
   void SetFootprintLimit(size_t new_footprint) REQUIRES(Locks::jit_lock_);
 
+  // Give the whole pages of free code and data chunks back to the kernel. Returns the number of
+  // bytes released.
+  size_t ReleaseUnusedPages() REQUIRES(Locks::jit_lock_);
+
   const uint8_t* AllocateCode(size_t code_size) REQUIRES(Locks::jit_lock_);
   void FreeCode(const uint8_t* code) REQUIRES(Locks::jit_lock_);
   const uint8_t* AllocateData(size_t data_size) REQUIRES(Locks::jit_lock_);
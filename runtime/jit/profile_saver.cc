@@ -57,6 +57,10 @@ static_assert(ProfileCompilationInfo::kIndividualInlineCacheSize ==
 // At what priority to schedule the saver threads. 9 is the lowest foreground priority on device.
 static constexpr int kProfileSaverPthreadPriority = 9;
 
+// Number of periodic saves that take the hot methods from the JIT code cache only, before walking
+// all loaded methods again for the warm and sampled ones.
+static constexpr uint32_t kIncrementalSavesPerFullCollection = 4u;
+
 static void SetProfileSaverThreadPriority(pthread_t thread, int priority) {
 #if defined(ART_TARGET_ANDROID)
   int result = setpriority(PRIO_PROCESS, pthread_gettid_np(thread), priority);
@@ -97,6 +101,8 @@ ProfileSaver::ProfileSaver(const ProfileSaverOptions& options, jit::JitCodeCache
       total_ns_of_work_(0),
       total_number_of_hot_spikes_(0),
       total_number_of_wake_ups_(0),
+      total_number_of_full_collections_(0),
+      incremental_saves_since_full_collection_(0),
       options_(options) {
   DCHECK(options_.IsEnabled());
 }
@@ -842,9 +848,18 @@ bool ProfileSaver::ProcessProfilingInfo(
   }
 
   if (!skip_class_and_method_fetching) {
-    // We only need to do this once, not once per dex location.
-    // TODO: Figure out a way to only do it when stuff has changed? It takes 30-50ms.
-    FetchAndCacheResolvedClassesAndMethods(/*startup=*/ false);
+    // We only need to do this once, not once per dex location. Methods are recorded in the JIT
+    // code cache when they get hot, see `JitCodeCache::GetProfiledMethods()`, so periodic saves
+    // only walk all loaded methods every few saves to find the warm and sampled ones. The walk
+    // holds the mutator lock for tens of milliseconds in apps with many methods.
+    if (force_save ||
+        incremental_saves_since_full_collection_ >= kIncrementalSavesPerFullCollection) {
+      FetchAndCacheResolvedClassesAndMethods(/*startup=*/ false);
+      incremental_saves_since_full_collection_ = 0u;
+      total_number_of_full_collections_++;
+    } else {
+      incremental_saves_since_full_collection_++;
+    }
   }
 
   for (const auto& it : tracked_locations) {
@@ -1232,7 +1247,9 @@ void ProfileSaver::DumpInfo(std::ostream& os) {
      << "ProfileSaver total_ms_of_sleep=" << total_ms_of_sleep_ << '\n'
      << "ProfileSaver total_ms_of_work=" << NsToMs(total_ns_of_work_) << '\n'
      << "ProfileSaver total_number_of_hot_spikes=" << total_number_of_hot_spikes_ << '\n'
-     << "ProfileSaver total_number_of_wake_ups=" << total_number_of_wake_ups_ << '\n';
+     << "ProfileSaver total_number_of_wake_ups=" << total_number_of_wake_ups_ << '\n'
+     << "ProfileSaver total_number_of_full_collections="
+     << total_number_of_full_collections_ << '\n';
 }
 
 
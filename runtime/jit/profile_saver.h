@@ -174,6 +174,10 @@ class ProfileSaver {
   // TODO(calin): replace with an actual size.
   uint64_t total_number_of_hot_spikes_;
   uint64_t total_number_of_wake_ups_;
+  uint64_t total_number_of_full_collections_;
+
+  // Number of periodic saves since the last walk of all loaded methods.
+  uint32_t incremental_saves_since_full_collection_;
 
   const ProfileSaverOptions options_;
 
@@ -16,6 +16,8 @@
 
 #include "profiling_info.h"
 
+#include <algorithm>
+
 #include "art_method-inl.h"
 #include "dex/dex_instruction.h"
 #include "jit/jit.h"
@@ -25,15 +27,23 @@
 
 namespace art {
 
-ProfilingInfo::ProfilingInfo(ArtMethod* method, const std::vector<uint32_t>& entries)
+ProfilingInfo::ProfilingInfo(ArtMethod* method,
+                             const std::vector<uint32_t>& entries,
+                             const std::vector<uint32_t>& allocation_sites)
       : baseline_hotness_count_(GetOptimizeThreshold()),
         method_(method),
         number_of_inline_caches_(entries.size()),
+        number_of_allocation_sites_(allocation_sites.size()),
         current_inline_uses_(0) {
   memset(&cache_, 0, number_of_inline_caches_ * sizeof(InlineCache));
   for (size_t i = 0; i < number_of_inline_caches_; ++i) {
     cache_[i].dex_pc_ = entries[i];
   }
+  AllocationSite* sites = GetAllocationSites();
+  memset(sites, 0, number_of_allocation_sites_ * sizeof(AllocationSite));
+  for (size_t i = 0; i < number_of_allocation_sites_; ++i) {
+    sites[i].dex_pc_ = allocation_sites[i];
+  }
 }
 
 uint16_t ProfilingInfo::GetOptimizeThreshold() {
@@ -45,7 +55,9 @@ ProfilingInfo* ProfilingInfo::Create(Thread* self, ArtMethod* method) {
   // instructions we are interested in profiling.
   DCHECK(!method->IsNative());
 
+  bool profile_allocations = Runtime::Current()->GetJITOptions()->PretenureAllocationSites();
   std::vector<uint32_t> entries;
+  std::vector<uint32_t> allocation_sites;
   for (const DexInstructionPcPair& inst : method->DexInstructions()) {
     switch (inst->Opcode()) {
       case Instruction::INVOKE_VIRTUAL:
@@ -55,6 +67,13 @@ ProfilingInfo* ProfilingInfo::Create(Thread* self, ArtMethod* method) {
         entries.push_back(inst.DexPc());
         break;
 
+      case Instruction::NEW_INSTANCE:
+      case Instruction::NEW_ARRAY:
+        if (profile_allocations) {
+          allocation_sites.push_back(inst.DexPc());
+        }
+        break;
+
       default:
         break;
     }
@@ -65,7 +84,7 @@ ProfilingInfo* ProfilingInfo::Create(Thread* self, ArtMethod* method) {
 
   // Allocate the `ProfilingInfo` object int the JIT's data space.
   jit::JitCodeCache* code_cache = Runtime::Current()->GetJit()->GetCodeCache();
-  return code_cache->AddProfilingInfo(self, method, entries);
+  return code_cache->AddProfilingInfo(self, method, entries, allocation_sites);
 }
 
 InlineCache* ProfilingInfo::GetInlineCache(uint32_t dex_pc) {
@@ -80,6 +99,24 @@ InlineCache* ProfilingInfo::GetInlineCache(uint32_t dex_pc) {
   UNREACHABLE();
 }
 
+AllocationSite* ProfilingInfo::GetAllocationSite(uint32_t dex_pc) {
+  // The sites are in increasing dex pc order.
+  AllocationSite* sites = GetAllocationSites();
+  AllocationSite* end = sites + number_of_allocation_sites_;
+  AllocationSite* it = std::lower_bound(
+      sites, end, dex_pc, [](const AllocationSite& site, uint32_t pc) {
+        return site.dex_pc_ < pc;
+      });
+  return (it != end && it->dex_pc_ == dex_pc) ? it : nullptr;
+}
+
+void ProfilingInfo::AddAllocationSample(uint32_t dex_pc, bool survived) {
+  AllocationSite* site = GetAllocationSite(dex_pc);
+  if (site != nullptr) {
+    site->AddSample(survived);
+  }
+}
+
 void ProfilingInfo::AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls) {
   InlineCache* cache = GetInlineCache(dex_pc);
   for (size_t i = 0; i < InlineCache::kIndividualCacheSize; ++i) {
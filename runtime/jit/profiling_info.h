@@ -60,6 +60,50 @@ class InlineCache {
   DISALLOW_COPY_AND_ASSIGN(InlineCache);
 };
 
+// Structure to store the survival of the objects allocated by a NEW_INSTANCE or NEW_ARRAY
+// instruction, sampled by the gc::AllocationSiteSampler. The optimizing compiler allocates
+// the objects of the sites whose samples mostly survive their first GC in the non-moving space.
+class AllocationSite {
+ public:
+  // The number of samples needed before deciding that a site is long-lived.
+  static constexpr uint16_t kMinSamples = 8;
+  // The percentage of the samples that must have survived their first GC.
+  static constexpr uint16_t kLongLivedSurvivalPercent = 90;
+  // The counts are halved when reaching this number of samples, so that the site can change
+  // its mind when the program changes phase.
+  static constexpr uint16_t kMaxSamples = 256;
+
+  uint32_t GetDexPc() const {
+    return dex_pc_;
+  }
+
+  bool IsLongLived() const {
+    return samples_ >= kMinSamples &&
+           static_cast<uint32_t>(survivors_) * 100u >=
+               static_cast<uint32_t>(samples_) * kLongLivedSurvivalPercent;
+  }
+
+ private:
+  void AddSample(bool survived) {
+    if (samples_ == kMaxSamples) {
+      samples_ /= 2u;
+      survivors_ /= 2u;
+    }
+    ++samples_;
+    if (survived) {
+      ++survivors_;
+    }
+  }
+
+  uint32_t dex_pc_;
+  uint16_t samples_;
+  uint16_t survivors_;
+
+  friend class ProfilingInfo;
+
+  DISALLOW_COPY_AND_ASSIGN(AllocationSite);
+};
+
 /**
  * Profiling info for a method, created and filled by the interpreter once the
  * method is warm, and used by the compiler to drive optimizations.
@@ -83,6 +127,13 @@ class ProfilingInfo {
 
   InlineCache* GetInlineCache(uint32_t dex_pc);
 
+  // Returns null if the instruction at `dex_pc` is not a profiled allocation, which is the
+  // case of all of them unless -Xjitpretenure is set.
+  AllocationSite* GetAllocationSite(uint32_t dex_pc);
+
+  // Add whether an object allocated at `dex_pc` survived its first GC.
+  void AddAllocationSample(uint32_t dex_pc, bool survived) REQUIRES(Locks::jit_lock_);
+
   // Increments the number of times this method is currently being inlined.
   // Returns whether it was successful, that is it could increment without
   // overflowing.
@@ -120,7 +171,14 @@ class ProfilingInfo {
   }
 
  private:
-  ProfilingInfo(ArtMethod* method, const std::vector<uint32_t>& entries);
+  ProfilingInfo(ArtMethod* method,
+                const std::vector<uint32_t>& entries,
+                const std::vector<uint32_t>& allocation_sites);
+
+  // The allocation sites follow the inline caches.
+  AllocationSite* GetAllocationSites() {
+    return reinterpret_cast<AllocationSite*>(&cache_[number_of_inline_caches_]);
+  }
 
   static uint16_t GetOptimizeThreshold();
 
@@ -137,11 +195,15 @@ class ProfilingInfo {
   // Number of instructions we are profiling in the ArtMethod.
   const uint32_t number_of_inline_caches_;
 
+  // Number of allocations we are profiling in the ArtMethod, after the inline caches.
+  const uint32_t number_of_allocation_sites_;
+
   // When the compiler inlines the method associated to this ProfilingInfo,
   // it updates this counter so that the GC does not try to clear the inline caches.
   uint16_t current_inline_uses_;
 
-  // Dynamically allocated array of size `number_of_inline_caches_`.
+  // Dynamically allocated array of size `number_of_inline_caches_`, followed by the
+  // `number_of_allocation_sites_` allocation sites.
   InlineCache cache_[0];
 
   friend class jit::JitCodeCache;
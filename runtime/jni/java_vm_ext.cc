@@ -18,6 +18,7 @@
 
 #include <dlfcn.h>
 #include <string_view>
+#include <unordered_map>
 
 #include "android-base/stringprintf.h"
 
@@ -70,6 +71,18 @@ bool JavaVMExt::IsBadJniVersion(int version) {
   return version != JNI_VERSION_1_2 && version != JNI_VERSION_1_4 && version != JNI_VERSION_1_6;
 }
 
+// A native library can export a table of all its `Java_*` functions, generated when the
+// library is built, as a null-terminated array of this struct named `ART_JNI_BINDING_TABLE`.
+// The native methods are then looked up in a hash map built from the table when the library
+// is loaded, instead of trying dlsym() with the short and the long JNI name of each method.
+// Functions registered with RegisterNatives() in JNI_OnLoad do not need to be in the table.
+struct JniBindingTableEntry {
+  const char* name;
+  void* fn;
+};
+
+static constexpr const char* kJniBindingTableSymbol = "ART_JNI_BINDING_TABLE";
+
 class SharedLibrary {
  public:
   SharedLibrary(JNIEnv* env, Thread* self, const std::string& path, void* handle,
@@ -84,6 +97,9 @@ class SharedLibrary {
         jni_on_load_thread_id_(self->GetThreadId()),
         jni_on_load_result_(kPending) {
     CHECK(class_loader_allocator_ != nullptr);
+    if (!needs_native_bridge) {
+      LoadBindingTable();
+    }
   }
 
   ~SharedLibrary() {
@@ -173,6 +189,11 @@ class SharedLibrary {
       REQUIRES(!Locks::mutator_lock_) {
     CHECK(!NeedsNativeBridge());
 
+    if (has_binding_table_ && StartsWith(symbol_name, "Java_")) {
+      // The table lists all the JNI functions of the library, so a miss needs no dlsym().
+      auto it = binding_table_.find(symbol_name);
+      return (it != binding_table_.end()) ? it->second : nullptr;
+    }
     return dlsym(handle_, symbol_name.c_str());
   }
 
@@ -185,6 +206,20 @@ class SharedLibrary {
   }
 
  private:
+  void LoadBindingTable() {
+    const JniBindingTableEntry* entries = reinterpret_cast<const JniBindingTableEntry*>(
+        dlsym(handle_, kJniBindingTableSymbol));
+    if (entries == nullptr) {
+      return;
+    }
+    ScopedTrace trace("LoadJniBindingTable");
+    for (const JniBindingTableEntry* entry = entries; entry->name != nullptr; ++entry) {
+      binding_table_.emplace(entry->name, entry->fn);
+    }
+    has_binding_table_ = true;
+    VLOG(jni) << "[Loaded " << binding_table_.size() << " JNI bindings from "" << path_ << ""]";
+  }
+
   enum JNI_OnLoadState {
     kPending,
     kFailed,
@@ -200,6 +235,11 @@ class SharedLibrary {
   // True if a native bridge is required.
   bool needs_native_bridge_;
 
+  // The JNI functions of the library by name, if it exports `kJniBindingTableSymbol`. The names
+  // are owned by the library.
+  bool has_binding_table_ = false;
+  std::unordered_map<std::string_view, void*> binding_table_;
+
   // The ClassLoader this library is associated with, a weak global JNI reference that is
   // created/deleted with the scope of the library.
   const jweak class_loader_;
@@ -51,9 +51,6 @@ namespace jni {
 
 constexpr bool kTraceIds = false;
 
-// TODO This whole thing could be done lock & wait free (since we never remove anything from the
-// ids list). It's not clear this would be worthwile though.
-
 namespace {
 
 static constexpr size_t IdToIndex(uintptr_t id) {
@@ -262,6 +259,17 @@ template <>
 std::vector<ArtMethod*>& JniIdManager::GetGenericMap<ArtMethod>() {
   return method_id_map_;
 }
+
+template <>
+JniIdDecodeTable<ArtField>& JniIdManager::GetDecodeTable<ArtField>() {
+  return field_id_decode_table_;
+}
+
+template <>
+JniIdDecodeTable<ArtMethod>& JniIdManager::GetDecodeTable<ArtMethod>() {
+  return method_id_decode_table_;
+}
+
 template <>
 size_t JniIdManager::GetLinearSearchStartId<ArtField>(
     [[maybe_unused]] ReflectiveHandle<ArtField> t) {
@@ -381,6 +389,7 @@ uintptr_t JniIdManager::EncodeGenericId(ReflectiveHandle<ArtType> t) {
   vec.reserve(cur_index + 1);
   vec.resize(std::max(vec.size(), cur_index + 1), nullptr);
   vec[cur_index] = t.Get();
+  GetDecodeTable<ArtType>().Set(cur_index, t.Get());
   if (ids.IsNull()) {
     if (kIsDebugBuild && CanUseIdArrays(t)) {
       CHECK_NE(deferred_allocation_refcount_, 0u)
@@ -451,6 +460,7 @@ void JniIdManager::VisitReflectiveTargets(ReflectiveValueVisitor* rvv) {
         rvv->VisitField(old_field, JniIdReflectiveSourceInfo(reinterpret_cast<jfieldID>(id)));
     if (old_field != new_field) {
       *it = new_field;
+      field_id_decode_table_.Set(IdToIndex(id), new_field);
       ObjPtr<mirror::Class> old_class(old_field->GetDeclaringClass());
       ObjPtr<mirror::Class> new_class(new_field->GetDeclaringClass());
       ObjPtr<mirror::ClassExt> old_ext_data(old_class->GetExtData());
@@ -504,6 +514,7 @@ void JniIdManager::VisitReflectiveTargets(ReflectiveValueVisitor* rvv) {
         rvv->VisitMethod(old_method, JniIdReflectiveSourceInfo(reinterpret_cast<jmethodID>(id)));
     if (old_method != new_method) {
       *it = new_method;
+      method_id_decode_table_.Set(IdToIndex(id), new_method);
       ObjPtr<mirror::Class> old_class(old_method->GetDeclaringClass());
       ObjPtr<mirror::Class> new_class(new_method->GetDeclaringClass());
       ObjPtr<mirror::ClassExt> old_ext_data(old_class->GetExtData());
@@ -532,8 +543,14 @@ void JniIdManager::VisitReflectiveTargets(ReflectiveValueVisitor* rvv) {
 
 template <typename ArtType> ArtType* JniIdManager::DecodeGenericId(uintptr_t t) {
   if (Runtime::Current()->GetJniIdType() == JniIdType::kIndices && (t % 2) == 1) {
-    ReaderMutexLock mu(Thread::Current(), *Locks::jni_id_lock_);
     size_t index = IdToIndex(t);
+    ArtType* result = GetDecodeTable<ArtType>().Get(index);
+    if (LIKELY(result != nullptr)) {
+      return result;
+    }
+    // The id is not in the decode table if it is too large for it or if this thread has not yet
+    // seen the store that published it. Look at the id map.
+    ReaderMutexLock mu(Thread::Current(), *Locks::jni_id_lock_);
     DCHECK_GT(GetGenericMap<ArtType>().size(), index);
     return GetGenericMap<ArtType>().at(index);
   } else {
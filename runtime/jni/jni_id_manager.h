@@ -24,6 +24,7 @@
 
 #include "art_field.h"
 #include "art_method.h"
+#include "base/bit_utils.h"
 #include "base/mutex.h"
 #include "gc_root.h"
 #include "jni_id_type.h"
@@ -39,6 +40,70 @@ template<typename RT> class ReflectiveHandle;
 namespace jni {
 
 class ScopedEnableSuspendAllJniIdQueries;
+
+// Index -> ArtField/ArtMethod map that can be read without holding the `jni_id_lock_`. Entries
+// are stored in chunks that are never moved or freed while the runtime is alive, the first chunk
+// has `kFirstChunkSize` entries and each further chunk doubles the total capacity.
+template <typename ArtType>
+class JniIdDecodeTable {
+ public:
+  JniIdDecodeTable() {}
+
+  ~JniIdDecodeTable() {
+    for (std::atomic<std::atomic<ArtType*>*>& chunk : chunks_) {
+      delete[] chunk.load(std::memory_order_relaxed);
+    }
+  }
+
+  // Returns null if there is no entry for `index`.
+  ArtType* Get(size_t index) const {
+    size_t chunk_index = ChunkIndex(index);
+    if (UNLIKELY(chunk_index >= kNumChunks)) {
+      return nullptr;
+    }
+    std::atomic<ArtType*>* chunk = chunks_[chunk_index].load(std::memory_order_acquire);
+    if (UNLIKELY(chunk == nullptr)) {
+      return nullptr;
+    }
+    return chunk[index - ChunkStart(chunk_index)].load(std::memory_order_acquire);
+  }
+
+  void Set(size_t index, ArtType* t) REQUIRES(Locks::jni_id_lock_) {
+    size_t chunk_index = ChunkIndex(index);
+    if (UNLIKELY(chunk_index >= kNumChunks)) {
+      return;  // Reads of such ids go to the id map.
+    }
+    std::atomic<ArtType*>* chunk = chunks_[chunk_index].load(std::memory_order_relaxed);
+    if (chunk == nullptr) {
+      chunk = new std::atomic<ArtType*>[ChunkSize(chunk_index)]();
+      chunks_[chunk_index].store(chunk, std::memory_order_release);
+    }
+    chunk[index - ChunkStart(chunk_index)].store(t, std::memory_order_release);
+  }
+
+ private:
+  static constexpr size_t kFirstChunkSize = 256u;
+  static constexpr size_t kNumChunks = BitSizeOf<uint32_t>() - WhichPowerOf2(kFirstChunkSize) + 1u;
+
+  static size_t ChunkIndex(size_t index) {
+    return (index < kFirstChunkSize)
+        ? 0u
+        : static_cast<size_t>(MostSignificantBit(index)) - WhichPowerOf2(kFirstChunkSize) + 1u;
+  }
+
+  static size_t ChunkStart(size_t chunk_index) {
+    return (chunk_index == 0u) ? 0u : kFirstChunkSize << (chunk_index - 1u);
+  }
+
+  static size_t ChunkSize(size_t chunk_index) {
+    return (chunk_index == 0u) ? kFirstChunkSize : ChunkStart(chunk_index);
+  }
+
+  std::atomic<std::atomic<ArtType*>*> chunks_[kNumChunks] = {};
+
+  DISALLOW_COPY_AND_ASSIGN(JniIdDecodeTable);
+};
+
 class JniIdManager {
  public:
   template <typename T,
@@ -76,6 +141,7 @@ class JniIdManager {
   ArtType* DecodeGenericId(uintptr_t input) REQUIRES(!Locks::jni_id_lock_);
   template <typename ArtType> std::vector<ArtType*>& GetGenericMap()
       REQUIRES(Locks::jni_id_lock_);
+  template <typename ArtType> JniIdDecodeTable<ArtType>& GetDecodeTable();
   template <typename ArtType> uintptr_t GetNextId(JniIdType id)
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(Locks::jni_id_lock_);
@@ -91,6 +157,9 @@ class JniIdManager {
   std::vector<ArtMethod*> method_id_map_ GUARDED_BY(Locks::jni_id_lock_);
   uintptr_t next_field_id_ GUARDED_BY(Locks::jni_id_lock_) = 1u;
   std::vector<ArtField*> field_id_map_ GUARDED_BY(Locks::jni_id_lock_);
+  // Copies of `method_id_map_` and `field_id_map_` for decoding ids without taking the lock.
+  JniIdDecodeTable<ArtMethod> method_id_decode_table_;
+  JniIdDecodeTable<ArtField> field_id_decode_table_;
 
   // If non-zero indicates that some thread is trying to allocate ids without being able to update
   // the method->id mapping (due to not being able to allocate or something). In this case decode
@@ -143,6 +143,25 @@ inline ObjPtr<mirror::Object> LocalReferenceTable::Get(IndirectRef iref) const {
   return ToLrtEntry(iref)->GetReference();
 }
 
+inline IndirectRef LocalReferenceTable::Add(LRTSegmentState previous_state,
+                                            ObjPtr<mirror::Object> obj,
+                                            std::string* error_msg) {
+  // Fast-path for pushing onto a table without holes and with CheckJNI disabled, which is how
+  // most native code uses local references. Everything else is handled out of line.
+  uint32_t top_index = segment_state_.top_index;
+  if (LIKELY(free_entries_list_ == kEmptyFreeListAndCheckJniDisabled) &&
+      LIKELY(top_index != max_entries_)) {
+    DCHECK(obj != nullptr);
+    VerifyObject(obj);
+    DCHECK_LE(previous_state.top_index, top_index);
+    LrtEntry* free_entry = GetEntry(top_index);
+    segment_state_.top_index = top_index + 1u;
+    free_entry->SetReference(obj);
+    return ToIndirectRef(free_entry);
+  }
+  return AddSlowPath(previous_state, obj, error_msg);
+}
+
 inline void LocalReferenceTable::Update(IndirectRef iref, ObjPtr<mirror::Object> obj) {
   DCheckValidReference(iref);
   ToLrtEntry(iref)->SetReference(obj);
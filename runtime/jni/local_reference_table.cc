@@ -262,9 +262,9 @@ inline uint32_t LocalReferenceTable::IncrementSerialNumber(LrtEntry* serial_numb
   return new_serial_number;
 }
 
-IndirectRef LocalReferenceTable::Add(LRTSegmentState previous_state,
-                                     ObjPtr<mirror::Object> obj,
-                                     std::string* error_msg) {
+IndirectRef LocalReferenceTable::AddSlowPath(LRTSegmentState previous_state,
+                                             ObjPtr<mirror::Object> obj,
+                                             std::string* error_msg) {
   if (kDebugLRT) {
     LOG(INFO) << "+++ Add: previous_state=" << previous_state.top_index
               << " top_index=" << segment_state_.top_index;
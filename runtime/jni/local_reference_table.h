@@ -269,7 +269,7 @@ class LocalReferenceTable {
   IndirectRef Add(LRTSegmentState previous_state,
                   ObjPtr<mirror::Object> obj,
                   std::string* error_msg)
-      REQUIRES_SHARED(Locks::mutator_lock_);
+      REQUIRES_SHARED(Locks::mutator_lock_) ALWAYS_INLINE;
 
   // Given an `IndirectRef` in the table, return the `Object` it refers to.
   //
@@ -438,6 +438,12 @@ class LocalReferenceTable {
   // Debug mode check that the reference is valid.
   void DCheckValidReference(IndirectRef iref) const REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Out-of-line part of `Add()` for tables with holes or CheckJNI enabled and for full tables.
+  IndirectRef AddSlowPath(LRTSegmentState previous_state,
+                          ObjPtr<mirror::Object> obj,
+                          std::string* error_msg)
+      REQUIRES_SHARED(Locks::mutator_lock_) NO_INLINE;
+
   // Resize the backing table to be at least `new_size` elements long. The `new_size`
   // must be larger than the current size. After return max_entries_ >= new_size.
   bool Resize(size_t new_size, std::string* error_msg);
@@ -19,6 +19,10 @@
 
 #include "linear_alloc.h"
 
+#include <string.h>
+
+#include <algorithm>
+
 #include "base/gc_visited_arena_pool.h"
 #include "thread-current-inl.h"
 
@@ -74,16 +78,68 @@ inline void* LinearAlloc::Realloc(Thread* self,
   }
 }
 
+inline void* LinearAlloc::AllocFromFreeSpans(size_t size) {
+  if (LIKELY(free_spans_.empty())) {
+    return nullptr;
+  }
+  auto it = free_spans_.find(size);
+  if (it == free_spans_.end()) {
+    return nullptr;
+  }
+  void* span = it->second;
+  free_spans_.erase(it);
+  // Keep the zero-initialization of the arena memory.
+  memset(span, 0, size);
+  return span;
+}
+
 inline void* LinearAlloc::Alloc(Thread* self, size_t size, LinearAllocKind kind) {
   MutexLock mu(self, lock_);
   if (track_allocations_) {
     size += sizeof(TrackingHeader);
+    void* span = AllocFromFreeSpans(size);
+    if (span != nullptr) {
+      // The first objects of the pages were set when the span was first allocated.
+      return new (span) TrackingHeader(size, kind) + 1;
+    }
     TrackingHeader* storage = new (allocator_.Alloc(size)) TrackingHeader(size, kind);
     SetFirstObject(storage, size);
     return storage + 1;
   } else {
-    return allocator_.Alloc(size);
+    void* span = AllocFromFreeSpans(size);
+    return span != nullptr ? span : allocator_.Alloc(size);
+  }
+}
+
+inline void LinearAlloc::Free(Thread* self, void* ptr, size_t size) {
+  MutexLock mu(self, lock_);
+  DCHECK(allocator_.Contains(ptr));
+  if (track_allocations_) {
+    TrackingHeader* header = reinterpret_cast<TrackingHeader*>(ptr) - 1;
+    DCHECK(!header->Is16Aligned());
+    DCHECK_LE(size + sizeof(TrackingHeader), header->GetSize());
+    // Visits of the GC walk from allocation to allocation, so the whole of it is freed.
+    size = header->GetSize();
+    // The GC skips the contents from now on. A concurrent visit that already read the old kind
+    // still sees the old contents, which are only overwritten once the span is reused.
+    new (header) TrackingHeader(size, LinearAllocKind::kNoGCRoots);
+    ptr = header;
+  }
+  // Threads that race to replace the same IMT conflict table free it twice.
+  auto is_span = [ptr](const std::pair<size_t, void*>& span) { return span.second == ptr; };
+  if (std::none_of(freed_spans_.begin(), freed_spans_.end(), is_span) &&
+      std::none_of(retired_spans_.begin(), retired_spans_.end(), is_span)) {
+    freed_spans_.emplace_back(size, ptr);
+  }
+}
+
+inline void LinearAlloc::ReclaimFreedSpans(Thread* self) {
+  MutexLock mu(self, lock_);
+  for (const auto& [size, span] : retired_spans_) {
+    free_spans_.emplace(size, span);
   }
+  retired_spans_.swap(freed_spans_);
+  freed_spans_.clear();
 }
 
 inline void* LinearAlloc::AllocAlign16(Thread* self, size_t size, LinearAllocKind kind) {
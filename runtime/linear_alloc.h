@@ -17,6 +17,10 @@
 #ifndef ART_RUNTIME_LINEAR_ALLOC_H_
 #define ART_RUNTIME_LINEAR_ALLOC_H_
 
+#include <map>
+#include <utility>
+#include <vector>
+
 #include "base/arena_allocator.h"
 #include "base/casts.h"
 #include "base/mutex.h"
@@ -80,6 +84,18 @@ class LinearAlloc {
   void* Realloc(Thread* self, void* ptr, size_t old_size, size_t new_size, LinearAllocKind kind)
       REQUIRES(!lock_);
 
+  // Give back `size` bytes at `ptr`, returned by Alloc() or Realloc(), for reuse by a later
+  // Alloc() of the same size. Other threads may still read the span, for example a superseded
+  // IMT conflict table, so it becomes reusable only at the second ReclaimFreedSpans() after
+  // this call. 16-byte aligned allocations cannot be freed. `size` may be less than the size of
+  // the allocation, the rest of it is not reused then.
+  void Free(Thread* self, void* ptr, size_t size) REQUIRES(!lock_);
+
+  // Called by the GC once per cycle, outside of the pauses. Spans freed before the previous call
+  // become reusable: all threads passed a suspend point since they were freed, so none holds
+  // a pointer into them anymore.
+  void ReclaimFreedSpans(Thread* self) REQUIRES(!lock_);
+
   // Allocate an array of structs of type T.
   template<class T>
   T* AllocArray(Thread* self, size_t elements, LinearAllocKind kind) REQUIRES(!lock_) {
@@ -108,10 +124,20 @@ class LinearAlloc {
   void SetFirstObject(void* begin, size_t bytes) const REQUIRES(lock_);
 
  private:
+  // Allocate `size` bytes, including the tracking header, from a reusable span.
+  void* AllocFromFreeSpans(size_t size) REQUIRES(lock_);
+
   mutable Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
   ArenaAllocator allocator_ GUARDED_BY(lock_);
   const bool track_allocations_;
 
+  // The spans freed since the last ReclaimFreedSpans(), and the ones freed before it, as pairs of
+  // the size, including the tracking header, and the address.
+  std::vector<std::pair<size_t, void*>> freed_spans_ GUARDED_BY(lock_);
+  std::vector<std::pair<size_t, void*>> retired_spans_ GUARDED_BY(lock_);
+  // The reusable spans by size.
+  std::multimap<size_t, void*> free_spans_ GUARDED_BY(lock_);
+
   DISALLOW_IMPLICIT_CONSTRUCTORS(LinearAlloc);
 };
 
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "startup_timeline.h"
+
+#include <ostream>
+
+#include "base/time_utils.h"
+
+#pragma clang diagnostic push
+#pragma clang diagnostic error "-Wconversion"
+
+namespace art {
+namespace metrics {
+
+const char* StartupPhaseName(StartupPhase phase) {
+  switch (phase) {
+#define PHASE(name) \
+    case StartupPhase::k##name: \
+      return #name;
+    ART_STARTUP_PHASES(PHASE)
+#undef PHASE
+  }
+}
+
+void StartupTimeline::Start(uint64_t start_ns) {
+  start_ns_ = start_ns;
+  for (std::atomic<State>& state : states_) {
+    state.store(kNotReached, std::memory_order_relaxed);
+  }
+}
+
+void StartupTimeline::MarkPhaseSlow(StartupPhase phase, ArtMetrics* metrics) {
+  size_t index = static_cast<size_t>(phase);
+  State expected = kNotReached;
+  if (!states_[index].compare_exchange_strong(expected, kRecording, std::memory_order_relaxed)) {
+    // Another thread reached the phase first.
+    return;
+  }
+  uint64_t now_ns = NanoTime();
+  phases_[index] = {
+      .time_ns = now_ns > start_ns_ ? now_ns - start_ns_ : 0u,
+      .classes_loaded = metrics->ClassLoadingCount()->Value(),
+      .classes_verified = metrics->ClassVerificationCount()->Value(),
+      .classes_initialized = metrics->ClassInitializationCount()->Value(),
+      .bytes_allocated = metrics->TotalBytesAllocated()->Value(),
+      .jit_compilations = metrics->JitMethodCompileCount()->Value(),
+  };
+  states_[index].store(kReached, std::memory_order_release);
+}
+
+bool StartupTimeline::GetPhase(StartupPhase phase, PhaseData* data) const {
+  size_t index = static_cast<size_t>(phase);
+  if (states_[index].load(std::memory_order_acquire) != kReached) {
+    return false;
+  }
+  *data = phases_[index];
+  return true;
+}
+
+void StartupTimeline::Report(ArtMetrics* metrics) const {
+  PhaseData data;
+  PhaseData last_data;
+  bool reached_any = false;
+#define PHASE(name)                                                 \
+  if (GetPhase(StartupPhase::k##name, &data)) {                     \
+    metrics->Startup##name##Time()->Add(NsToUs(data.time_ns));      \
+    last_data = data;                                               \
+    reached_any = true;                                             \
+  }
+  ART_STARTUP_PHASES(PHASE)
+#undef PHASE
+  if (reached_any) {
+    metrics->StartupClassesLoadedCount()->Add(last_data.classes_loaded);
+    metrics->StartupClassesVerifiedCount()->Add(last_data.classes_verified);
+    metrics->StartupClassesInitializedCount()->Add(last_data.classes_initialized);
+    metrics->StartupBytesAllocated()->Add(last_data.bytes_allocated);
+    metrics->StartupJitCompilationCount()->Add(last_data.jit_compilations);
+  }
+}
+
+void StartupTimeline::Dump(std::ostream& os) const {
+  os << "Startup timeline:\n";
+  for (size_t i = 0; i != kNumStartupPhases; ++i) {
+    StartupPhase phase = static_cast<StartupPhase>(i);
+    PhaseData data;
+    if (!GetPhase(phase, &data)) {
+      continue;
+    }
+    os << "  " << StartupPhaseName(phase) << ": " << PrettyDuration(data.time_ns)
+       << " classes loaded=" << data.classes_loaded
+       << " verified=" << data.classes_verified
+       << " initialized=" << data.classes_initialized
+       << " bytes allocated=" << data.bytes_allocated
+       << " jit compilations=" << data.jit_compilations << "\n";
+  }
+}
+
+}  // namespace metrics
+}  // namespace art
+
+#pragma clang diagnostic pop  // -Wconversion
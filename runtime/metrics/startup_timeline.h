@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_METRICS_STARTUP_TIMELINE_H_
+#define ART_RUNTIME_METRICS_STARTUP_TIMELINE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+
+#include "base/macros.h"
+#include "base/metrics/metrics.h"
+
+#pragma clang diagnostic push
+#pragma clang diagnostic error "-Wconversion"
+
+namespace art {
+namespace metrics {
+
+// The phases of the startup of a process, in the order in which they are usually reached. Each
+// phase has a Startup<name>Time metric in ART_EVENT_METRICS.
+#define ART_STARTUP_PHASES(PHASE) \
+  PHASE(RuntimeInitialized)       \
+  PHASE(RuntimeStarted)           \
+  PHASE(AppInfoRegistered)        \
+  PHASE(DexFilesLoaded)           \
+  PHASE(FirstJitCompilation)      \
+  PHASE(Completed)
+
+enum class StartupPhase : uint8_t {
+#define PHASE(name) k##name,
+  ART_STARTUP_PHASES(PHASE)
+#undef PHASE
+};
+
+#define PHASE(name) +1
+static constexpr size_t kNumStartupPhases = 0 ART_STARTUP_PHASES(PHASE);
+#undef PHASE
+
+const char* StartupPhaseName(StartupPhase phase);
+
+/**
+ * Records when the startup of the process reaches each phase, relative to the start of the runtime
+ * or to the zygote fork, together with a snapshot of the class, allocation and JIT counters of
+ * ArtMetrics at that time. These count from the last metrics reset, which also happens at fork.
+ *
+ * Only the first time a phase is reached is recorded, after which marking it again is a single
+ * atomic load, so the marks can be on paths that run repeatedly.
+ */
+class StartupTimeline {
+ public:
+  struct PhaseData {
+    uint64_t time_ns;
+    uint64_t classes_loaded;
+    uint64_t classes_verified;
+    uint64_t classes_initialized;
+    uint64_t bytes_allocated;
+    uint64_t jit_compilations;
+  };
+
+  StartupTimeline() {}
+
+  // Start a new timeline at `start_ns`, forgetting the phases of the previous one. Must not run
+  // concurrently with the other methods.
+  void Start(uint64_t start_ns);
+
+  // Record `phase` with the counters of `metrics`, unless it was already reached.
+  void MarkPhase(StartupPhase phase, ArtMetrics* metrics) {
+    if (states_[static_cast<size_t>(phase)].load(std::memory_order_relaxed) == kNotReached) {
+      MarkPhaseSlow(phase, metrics);
+    }
+  }
+
+  // Returns whether `phase` was reached, and if so sets `data`.
+  bool GetPhase(StartupPhase phase, PhaseData* data) const;
+
+  // Add the time of each phase that was reached to its Startup<name>Time metric, and the counters
+  // of the last one to the Startup*Count metrics.
+  void Report(ArtMetrics* metrics) const;
+
+  void Dump(std::ostream& os) const;
+
+ private:
+  enum State : uint8_t {
+    kNotReached,
+    kRecording,
+    kReached,
+  };
+
+  void MarkPhaseSlow(StartupPhase phase, ArtMetrics* metrics);
+
+  uint64_t start_ns_ = 0u;
+  std::atomic<State> states_[kNumStartupPhases] = {};
+  PhaseData phases_[kNumStartupPhases] = {};
+
+  DISALLOW_COPY_AND_ASSIGN(StartupTimeline);
+};
+
+}  // namespace metrics
+}  // namespace art
+
+#pragma clang diagnostic pop  // -Wconversion
+
+#endif  // ART_RUNTIME_METRICS_STARTUP_TIMELINE_H_
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "startup_timeline.h"
+
+#include <sstream>
+
+#include "base/metrics/metrics_test.h"
+#include "base/time_utils.h"
+#include "gtest/gtest.h"
+
+#pragma clang diagnostic push
+#pragma clang diagnostic error "-Wconversion"
+
+namespace art {
+namespace metrics {
+
+using test::CounterValue;
+
+class StartupTimelineTest : public testing::Test {
+ protected:
+  ArtMetrics metrics_;
+  StartupTimeline timeline_;
+};
+
+TEST_F(StartupTimelineTest, MarkPhaseOnce) {
+  timeline_.Start(NanoTime());
+  metrics_.ClassLoadingCount()->Add(3u);
+  metrics_.JitMethodCompileCount()->Add(1u);
+  timeline_.MarkPhase(StartupPhase::kAppInfoRegistered, &metrics_);
+
+  // Reaching the phase again does not change it.
+  metrics_.ClassLoadingCount()->Add(2u);
+  timeline_.MarkPhase(StartupPhase::kAppInfoRegistered, &metrics_);
+
+  StartupTimeline::PhaseData data;
+  ASSERT_TRUE(timeline_.GetPhase(StartupPhase::kAppInfoRegistered, &data));
+  EXPECT_EQ(data.classes_loaded, 3u);
+  EXPECT_EQ(data.jit_compilations, 1u);
+  EXPECT_FALSE(timeline_.GetPhase(StartupPhase::kRuntimeInitialized, &data));
+  EXPECT_FALSE(timeline_.GetPhase(StartupPhase::kCompleted, &data));
+
+  // A new timeline forgets the phases.
+  timeline_.Start(NanoTime());
+  EXPECT_FALSE(timeline_.GetPhase(StartupPhase::kAppInfoRegistered, &data));
+}
+
+TEST_F(StartupTimelineTest, Report) {
+  timeline_.Start(NanoTime());
+  timeline_.MarkPhase(StartupPhase::kDexFilesLoaded, &metrics_);
+  metrics_.ClassLoadingCount()->Add(10u);
+  metrics_.ClassVerificationCount()->Add(4u);
+  metrics_.ClassInitializationCount()->Add(5u);
+  metrics_.TotalBytesAllocated()->Add(4096u);
+  metrics_.JitMethodCompileCount()->Add(2u);
+  timeline_.MarkPhase(StartupPhase::kCompleted, &metrics_);
+
+  StartupTimeline::PhaseData dex_files_loaded;
+  StartupTimeline::PhaseData completed;
+  ASSERT_TRUE(timeline_.GetPhase(StartupPhase::kDexFilesLoaded, &dex_files_loaded));
+  ASSERT_TRUE(timeline_.GetPhase(StartupPhase::kCompleted, &completed));
+  EXPECT_LE(dex_files_loaded.time_ns, completed.time_ns);
+  EXPECT_EQ(dex_files_loaded.classes_loaded, 0u);
+
+  timeline_.Report(&metrics_);
+  EXPECT_EQ(CounterValue(*metrics_.StartupDexFilesLoadedTime()),
+            NsToUs(dex_files_loaded.time_ns));
+  EXPECT_EQ(CounterValue(*metrics_.StartupCompletedTime()), NsToUs(completed.time_ns));
+  EXPECT_EQ(CounterValue(*metrics_.StartupRuntimeStartedTime()), 0u);
+  EXPECT_EQ(CounterValue(*metrics_.StartupClassesLoadedCount()), 10u);
+  EXPECT_EQ(CounterValue(*metrics_.StartupClassesVerifiedCount()), 4u);
+  EXPECT_EQ(CounterValue(*metrics_.StartupClassesInitializedCount()), 5u);
+  EXPECT_EQ(CounterValue(*metrics_.StartupBytesAllocated()), 4096u);
+  EXPECT_EQ(CounterValue(*metrics_.StartupJitCompilationCount()), 2u);
+
+  std::ostringstream os;
+  timeline_.Dump(os);
+  EXPECT_NE(os.str().find("DexFilesLoaded"), std::string::npos);
+  EXPECT_NE(os.str().find("Completed"), std::string::npos);
+  EXPECT_EQ(os.str().find("RuntimeStarted"), std::string::npos);
+}
+
+}  // namespace metrics
+}  // namespace art
+
+#pragma clang diagnostic pop  // -Wconversion
@@ -192,6 +192,37 @@ constexpr std::optional<int32_t> EncodeDatumId(DatumId datum_id) {
       return std::make_optional(
           statsd::
               ART_DATUM_DELTA_REPORTED__KIND__ART_DATUM_DELTA_GC_FULL_HEAP_COLLECTION_DURATION_MS);
+    // The per-phase GC, Runtime::Init and startup timeline breakdowns don't have atoms.proto
+    // entries yet. They are reported through the other metrics backends and perfetto counter
+    // tracks.
+    case DatumId::kGcMarkingTime:
+    case DatumId::kGcReclaimTime:
+    case DatumId::kGcCompactionTime:
+    case DatumId::kGcReferenceProcessingTime:
+    case DatumId::kGcRootVisitingTime:
+    case DatumId::kGcThreadCpuTime:
+    case DatumId::kGcMovedBytes:
+    case DatumId::kTlabWastedBytes:
+    case DatumId::kTimeToSafepoint:
+    case DatumId::kRuntimeInitTime:
+    case DatumId::kRuntimeInitHeapTime:
+    case DatumId::kRuntimeInitClassLinkerTime:
+    case DatumId::kMonitorHashCodeInflationCount:
+    case DatumId::kClassLoadingCount:
+    case DatumId::kClassInitializationCount:
+    case DatumId::kStartupRuntimeInitializedTime:
+    case DatumId::kStartupRuntimeStartedTime:
+    case DatumId::kStartupAppInfoRegisteredTime:
+    case DatumId::kStartupDexFilesLoadedTime:
+    case DatumId::kStartupFirstJitCompilationTime:
+    case DatumId::kStartupCompletedTime:
+    case DatumId::kStartupClassesLoadedCount:
+    case DatumId::kStartupClassesVerifiedCount:
+    case DatumId::kStartupClassesInitializedCount:
+    case DatumId::kStartupBytesAllocated:
+    case DatumId::kStartupJitCompilationCount:
+    case DatumId::kAllocationSizeClass:
+      return std::nullopt;
   }
 }
 
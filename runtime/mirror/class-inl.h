@@ -856,9 +856,20 @@ inline uint32_t Class::DescriptorHash() {
     hash = UpdateModifiedUtf8Hash(hash, Primitive::Descriptor(klass->GetPrimitiveType())[0]);
   } else {
     const DexFile& dex_file = klass->GetDexFile();
-    const dex::TypeId& type_id = dex_file.GetTypeId(klass->GetDexTypeIndex());
-    std::string_view descriptor = dex_file.GetTypeDescriptorView(type_id);
-    hash = UpdateModifiedUtf8Hash(hash, descriptor);
+    const OatDexFile* oat_dex_file = dex_file.GetOatDexFile();
+    if (klass == this &&
+        oat_dex_file != nullptr &&
+        oat_dex_file->GetClassDescriptorHashes() != nullptr) {
+      // Use the hash that the vdex stores for the class def. It cannot be combined with the
+      // '[' of array classes above, so those are hashed character by character.
+      uint16_t class_def_index = klass->GetDexClassDefIndex();
+      DCHECK_LT(class_def_index, dex_file.NumClassDefs());
+      hash = oat_dex_file->GetClassDescriptorHashes()[class_def_index];
+    } else {
+      const dex::TypeId& type_id = dex_file.GetTypeId(klass->GetDexTypeIndex());
+      std::string_view descriptor = dex_file.GetTypeDescriptorView(type_id);
+      hash = UpdateModifiedUtf8Hash(hash, descriptor);
+    }
   }
 
   if (kIsDebugBuild) {
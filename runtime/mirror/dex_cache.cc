@@ -40,6 +40,12 @@ namespace mirror {
 // while debugging b/283632504.
 static constexpr bool kEnableFullArraysAtStartup = false;
 
+// Number of evictions per pair after which a dex cache is upgraded to a full array.
+static constexpr size_t kEvictionsPerPairForFullArray = 4u;
+
+// Maximum number of elements of a full array that replaces a dex cache.
+static constexpr size_t kMaxElementsForFullArray = 64 * KB;
+
 void DexCache::Initialize(const DexFile* dex_file, ObjPtr<ClassLoader> class_loader) {
   DCHECK(GetDexFile() == nullptr);
   DCHECK(GetStrings() == nullptr);
@@ -202,6 +208,23 @@ bool DexCache::ShouldAllocateFullArrayAtStartup() {
   return true;
 }
 
+bool DexCache::ShouldUpgradeToFullArray(const char* cache_name,
+                                        size_t number_of_elements,
+                                        uint32_t number_of_evictions,
+                                        size_t dex_cache_size) {
+  if (number_of_evictions < kEvictionsPerPairForFullArray * dex_cache_size ||
+      number_of_elements > kMaxElementsForFullArray) {
+    return false;
+  }
+  if (Runtime::Current()->IsAotCompiler()) {
+    // To save on memory in dex2oat, we don't allocate full arrays.
+    return false;
+  }
+  VLOG(class_linker) << "Upgrading " << cache_name << " cache with " << number_of_elements
+                     << " elements to a full array after " << number_of_evictions << " evictions";
+  return true;
+}
+
 void DexCache::UnlinkStartupCaches() {
   if (GetDexFile() == nullptr) {
     // Unused dex cache.
@@ -21,6 +21,7 @@
 #include "base/array_ref.h"
 #include "base/atomic_pair.h"
 #include "base/bit_utils.h"
+#include "base/casts.h"
 #include "base/locks.h"
 #include "dex/dex_file.h"
 #include "dex/dex_file_types.h"
@@ -140,6 +141,40 @@ template <typename T, size_t size> class NativeDexCachePairArray {
     SetNativePair(entries_, SlotIndex(index), value);
   }
 
+  // Sets the entry for `index` and returns whether this replaced the entry of another index.
+  bool SetAndCheckEviction(uint32_t index, T* value) REQUIRES_SHARED(Locks::mutator_lock_) {
+    uint32_t slot = SlotIndex(index);
+    NativeDexCachePair<T> old_pair = GetNativePair(entries_, slot);
+    SetNativePair(entries_, slot, NativeDexCachePair<T>(value, index));
+    return old_pair.object != nullptr && old_pair.index != index;
+  }
+
+  // Counts an eviction and returns the number of evictions so far. The count is kept in the
+  // slot after the last entry, whose object is always null. Concurrent updates may be lost,
+  // the count is only used as a heuristic.
+  uint32_t RecordEviction() REQUIRES_SHARED(Locks::mutator_lock_) {
+    NativeDexCachePair<T> counter = GetNativePair(entries_, size);
+    uint32_t num_evictions = dchecked_integral_cast<uint32_t>(counter.index) + 1u;
+    counter.index = num_evictions;
+    SetNativePair(entries_, size, counter);
+    return num_evictions;
+  }
+
+  uint32_t GetNumEvictions() REQUIRES_SHARED(Locks::mutator_lock_) {
+    return dchecked_integral_cast<uint32_t>(GetNativePair(entries_, size).index);
+  }
+
+  // Calls `visitor(index, object)` for each entry in the cache.
+  template <typename Visitor>
+  void VisitEntries(const Visitor& visitor) REQUIRES_SHARED(Locks::mutator_lock_) {
+    for (size_t slot = 0; slot != size; ++slot) {
+      NativeDexCachePair<T> pair = GetNativePair(entries_, slot);
+      if (pair.object != nullptr) {
+        visitor(dchecked_integral_cast<uint32_t>(pair.index), pair.object);
+      }
+    }
+  }
+
  private:
   NativeDexCachePair<T> GetNativePair(std::atomic<NativeDexCachePair<T>>* pair_array, size_t idx) {
     auto* array = reinterpret_cast<AtomicPair<uintptr_t>*>(pair_array);
@@ -185,6 +220,40 @@ template <typename T, size_t size> class DexCachePairArray {
     entries_[SlotIndex(index)].store(value, std::memory_order_relaxed);
   }
 
+  // Sets the entry for `index` and returns whether this replaced the entry of another index.
+  bool SetAndCheckEviction(uint32_t index, T* value) REQUIRES_SHARED(Locks::mutator_lock_) {
+    uint32_t slot = SlotIndex(index);
+    DexCachePair<T> old_pair = entries_[slot].load(std::memory_order_relaxed);
+    entries_[slot].store(DexCachePair<T>(value, index), std::memory_order_relaxed);
+    return !old_pair.object.IsNull() && old_pair.index != index;
+  }
+
+  // Counts an eviction and returns the number of evictions so far. The count is kept in the
+  // slot after the last entry, whose object is always null so that visiting the roots of the
+  // whole allocation skips it. Concurrent updates may be lost, the count is only used as a
+  // heuristic.
+  uint32_t RecordEviction() {
+    DexCachePair<T> counter = entries_[size].load(std::memory_order_relaxed);
+    ++counter.index;
+    entries_[size].store(counter, std::memory_order_relaxed);
+    return counter.index;
+  }
+
+  uint32_t GetNumEvictions() {
+    return entries_[size].load(std::memory_order_relaxed).index;
+  }
+
+  // Calls `visitor(index, object)` for each entry in the cache.
+  template <typename Visitor>
+  void VisitEntries(const Visitor& visitor) REQUIRES_SHARED(Locks::mutator_lock_) {
+    for (size_t slot = 0; slot != size; ++slot) {
+      DexCachePair<T> pair = entries_[slot].load(std::memory_order_relaxed);
+      if (!pair.object.IsNull()) {
+        visitor(pair.index, pair.object.Read());
+      }
+    }
+  }
+
   void Clear(uint32_t index) {
     uint32_t slot = SlotIndex(index);
     // This is racy but should only be called from the transactional interpreter.
@@ -392,6 +461,14 @@ class MANAGED DexCache final : public Object {
     return number_of_elements <= dex_cache_size;
   }
 
+  // Returns whether a cache of `dex_cache_size` pairs, which had `number_of_evictions`
+  // evictions, should be replaced by a full array of `number_of_elements`. Hot dex files with
+  // many more ids than pairs otherwise keep evicting entries and resolving them again.
+  static bool ShouldUpgradeToFullArray(const char* cache_name,
+                                       size_t number_of_elements,
+                                       uint32_t number_of_evictions,
+                                       size_t dex_cache_size);
+
 
 // NOLINTBEGIN(bugprone-macro-parentheses)
 #define DEFINE_ARRAY(name, array_kind, getter_setter, type, ids, alloc_kind) \
@@ -432,16 +509,21 @@ class MANAGED DexCache final : public Object {
   static constexpr MemberOffset getter_setter ##Offset() { \
     return OFFSET_OF_OBJECT_MEMBER(DexCache, name); \
   } \
+  /* The slot after the last entry holds the eviction count. */ \
   pair_kind ##Array<type, size>* Allocate ##getter_setter() \
       REQUIRES_SHARED(Locks::mutator_lock_) { \
     return reinterpret_cast<pair_kind ##Array<type, size>*>( \
         AllocArray<std::atomic<pair_kind<type>>>( \
-            getter_setter ##Offset(), size, alloc_kind)); \
+            getter_setter ##Offset(), size + 1u, alloc_kind)); \
   } \
   template<VerifyObjectFlags kVerifyFlags = kDefaultVerifyFlags> \
   size_t Num ##getter_setter() REQUIRES_SHARED(Locks::mutator_lock_) { \
     return Get ##getter_setter() == nullptr ? 0u : size; \
   } \
+  uint32_t Num ##getter_setter ##Evictions() REQUIRES_SHARED(Locks::mutator_lock_) { \
+    auto* pairs = Get ##getter_setter(); \
+    return pairs == nullptr ? 0u : pairs->GetNumEvictions(); \
+  } \
 
 #define DEFINE_DUAL_CACHE( \
     name, pair_kind, getter_setter, type, pair_size, alloc_pair_kind, \
@@ -479,14 +561,24 @@ class MANAGED DexCache final : public Object {
           pairs = Allocate ##getter_setter(); \
           pairs->Set(index, resolved); \
         } \
-      } else { \
-        pairs->Set(index, resolved); \
+      } else if (pairs->SetAndCheckEviction(index, resolved) && \
+                 ShouldUpgradeToFullArray(#getter_setter, \
+                                          GetDexFile()->ids(), \
+                                          pairs->RecordEviction(), \
+                                          pair_size)) { \
+        array = Allocate ##getter_setter ##Array(); \
+        auto set_entry = [array](uint32_t i, type* value) REQUIRES_SHARED(Locks::mutator_lock_) { \
+          array->Set(i, value); \
+        }; \
+        pairs->VisitEntries(set_entry); \
       } \
     } \
   } \
   void Unlink ##getter_setter ##ArrayIfStartup() \
       REQUIRES_SHARED(Locks::mutator_lock_) { \
-    if (!ShouldAllocateFullArray(GetDexFile()->ids(), pair_size)) { \
+    /* A full array next to the pairs replaced them after too many evictions. */ \
+    if (!ShouldAllocateFullArray(GetDexFile()->ids(), pair_size) && \
+        Get ##getter_setter() == nullptr) { \
       Set ##getter_setter ##Array(nullptr) ; \
     } \
   }
@@ -72,6 +72,44 @@ TEST_F(DexCacheMethodHandlesTest, Open) {
   EXPECT_EQ(0u, dex_cache->NumResolvedMethodTypes());
 }
 
+TEST_F(DexCacheTest, UpgradeToFullArray) {
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<1> hs(soa.Self());
+  ASSERT_TRUE(java_lang_dex_file_ != nullptr);
+  Handle<DexCache> dex_cache(
+      hs.NewHandle(class_linker_->AllocAndInitializeDexCache(
+          soa.Self(), *java_lang_dex_file_, /*class_loader=*/nullptr)));
+  ASSERT_TRUE(dex_cache != nullptr);
+  constexpr uint32_t kCacheSize = DexCache::kDexCacheMethodCacheSize;
+  ASSERT_GT(java_lang_dex_file_->NumMethodIds(), 2u * kCacheSize);
+
+  // Any method will do, the dex cache does not look at it.
+  ArtMethod* method = runtime_->GetResolutionMethod();
+  dex_cache->SetResolvedMethod(0u, method);
+  ASSERT_EQ(kCacheSize, dex_cache->NumResolvedMethods());
+  EXPECT_EQ(0u, dex_cache->NumResolvedMethodsArray());
+  EXPECT_EQ(0u, dex_cache->NumResolvedMethodsEvictions());
+  dex_cache->SetResolvedMethod(kCacheSize, method);
+  EXPECT_EQ(1u, dex_cache->NumResolvedMethodsEvictions());
+  EXPECT_EQ(nullptr, dex_cache->GetResolvedMethod(0u));
+  EXPECT_EQ(method, dex_cache->GetResolvedMethod(kCacheSize));
+
+  // Keep evicting entries until the pairs are replaced by a full array.
+  uint32_t method_idx = 0u;
+  for (size_t i = 0; i != 16u * kCacheSize && dex_cache->NumResolvedMethodsArray() == 0u; ++i) {
+    method_idx = i % (2u * kCacheSize);
+    dex_cache->SetResolvedMethod(method_idx, method);
+  }
+  ASSERT_EQ(java_lang_dex_file_->NumMethodIds(), dex_cache->NumResolvedMethodsArray());
+  // The entries of the pairs, which are the last `kCacheSize` ones set, are kept in the full array.
+  auto previous_idx = [&](uint32_t distance) {
+    return (method_idx + 2u * kCacheSize - distance) % (2u * kCacheSize);
+  };
+  EXPECT_EQ(method, dex_cache->GetResolvedMethod(method_idx));
+  EXPECT_EQ(method, dex_cache->GetResolvedMethod(previous_idx(kCacheSize - 1u)));
+  EXPECT_EQ(nullptr, dex_cache->GetResolvedMethod(previous_idx(kCacheSize)));
+}
+
 TEST_F(DexCacheTest, TestResolvedFieldAccess) {
   ScopedObjectAccess soa(Thread::Current());
   jobject jclass_loader(LoadDex("Packages"));
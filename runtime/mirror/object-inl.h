@@ -75,6 +75,15 @@ inline void Object::SetLockWord(LockWord new_val, bool as_volatile) {
   }
 }
 
+template<VerifyObjectFlags kVerifyFlags>
+inline void Object::SetLockWordRelease(LockWord new_val) {
+  // Force use of non-transactional mode and do not check.
+  Verify<kVerifyFlags>();
+  uint8_t* raw_addr = reinterpret_cast<uint8_t*>(this) + MonitorOffset().Int32Value();
+  reinterpret_cast<Atomic<uint32_t>*>(raw_addr)->store(new_val.GetValue(),
+                                                       std::memory_order_release);
+}
+
 inline uint32_t Object::GetLockOwnerThreadId() {
   return Monitor::GetLockOwnerThreadId(this);
 }
@@ -35,6 +35,7 @@
 #include "object-refvisitor-inl.h"
 #include "object_array-inl.h"
 #include "runtime.h"
+#include "thin_lock_hash_codes.h"
 #include "throwable.h"
 #include "well_known_classes.h"
 
@@ -191,6 +192,14 @@ int32_t Object::IdentityHashCode() {
     LockWord lw = current_this->GetLockWord(false);
     switch (lw.GetState()) {
       case LockWord::kUnlocked: {
+        // The object may have been thin-locked after it was hashed and unlocked again.
+        ThinLockHashCodes* thin_lock_hash_codes = Runtime::Current()->GetThinLockHashCodes();
+        if (UNLIKELY(thin_lock_hash_codes->MayHaveEntries())) {
+          uint32_t hash_code = thin_lock_hash_codes->GetHashCode(Thread::Current(), current_this);
+          if (hash_code != 0u) {
+            return hash_code;
+          }
+        }
         // Try to compare and swap in a new hash, if we succeed we will return the hash on the next
         // loop iteration.
         LockWord hash_word = LockWord::FromHashCode(GenerateIdentityHashCode(), lw.GCState());
@@ -203,6 +212,13 @@ int32_t Object::IdentityHashCode() {
         break;
       }
       case LockWord::kThinLocked: {
+        ThinLockHashCodes* thin_lock_hash_codes = Runtime::Current()->GetThinLockHashCodes();
+        if (UNLIKELY(thin_lock_hash_codes->MayHaveEntries())) {
+          uint32_t hash_code = thin_lock_hash_codes->GetHashCode(Thread::Current(), current_this);
+          if (hash_code != 0u) {
+            return hash_code;
+          }
+        }
         // Inflate the thin lock to a monitor and stick the hash code inside of the monitor. May
         // fail spuriously.
         Thread* self = Thread::Current();
@@ -217,6 +233,19 @@ int32_t Object::IdentityHashCode() {
         // Already inflated, return the hash stored in the monitor.
         Monitor* monitor = lw.FatLockMonitor();
         DCHECK(monitor != nullptr);
+        if (!monitor->HasHashCode()) {
+          // A thin lock with its hash code in the side table may have been inflated since.
+          ThinLockHashCodes* thin_lock_hash_codes = Runtime::Current()->GetThinLockHashCodes();
+          if (UNLIKELY(thin_lock_hash_codes->MayHaveEntries())) {
+            Thread* self = Thread::Current();
+            uint32_t hash_code = thin_lock_hash_codes->GetHashCode(self, current_this);
+            if (hash_code != 0u) {
+              int32_t monitor_hash_code = monitor->SetHashCodeIfMissing(hash_code);
+              thin_lock_hash_codes->Remove(self, current_this);
+              return monitor_hash_code;
+            }
+          }
+        }
         return monitor->GetHashCode();
       }
       case LockWord::kHashCode: {
@@ -152,6 +152,9 @@ class MANAGED LOCKABLE Object {
   LockWord GetLockWord(bool as_volatile) REQUIRES_SHARED(Locks::mutator_lock_);
   template<VerifyObjectFlags kVerifyFlags = kDefaultVerifyFlags>
   void SetLockWord(LockWord new_val, bool as_volatile) REQUIRES_SHARED(Locks::mutator_lock_);
+  // Store the lock word with release ordering, which is all that unlocking a thin lock needs.
+  template<VerifyObjectFlags kVerifyFlags = kDefaultVerifyFlags>
+  void SetLockWordRelease(LockWord new_val) REQUIRES_SHARED(Locks::mutator_lock_);
   bool CasLockWord(LockWord old_val, LockWord new_val, CASMode mode, std::memory_order memory_order)
       REQUIRES_SHARED(Locks::mutator_lock_);
   uint32_t GetLockOwnerThreadId() REQUIRES_SHARED(Locks::mutator_lock_);
@@ -18,6 +18,10 @@
 
 #include "string.h"
 
+#include <string.h>
+
+#include <limits>
+
 #include "android-base/stringprintf.h"
 
 #include "class-inl.h"
@@ -59,6 +63,27 @@ template <typename MemoryType>
 int32_t String::FastIndexOf(MemoryType* chars, int32_t ch, int32_t start) {
   const MemoryType* p = chars + start;
   const MemoryType* end = chars + GetLength();
+  if (ch < 0 || ch > std::numeric_limits<MemoryType>::max()) {
+    return -1;
+  }
+  if constexpr (sizeof(MemoryType) == 1u) {
+    const void* found = memchr(p, ch, end - p);
+    return (found != nullptr) ? static_cast<const MemoryType*>(found) - chars : -1;
+  } else {
+    // Skip four chars at a time while none of them is `ch`, i.e. while no 16-bit lane of the
+    // word XORed with `ch` is zero. The lane that matched is then found by the loop below.
+    static constexpr uint64_t kLaneOnes = UINT64_C(0x0001000100010001);
+    static constexpr uint64_t kLaneHighBits = UINT64_C(0x8000800080008000);
+    const uint64_t pattern = kLaneOnes * static_cast<uint16_t>(ch);
+    for (; end - p >= 4; p += 4) {
+      uint64_t word;
+      memcpy(&word, p, sizeof(word));
+      word ^= pattern;
+      if (((word - kLaneOnes) & ~word & kLaneHighBits) != 0u) {
+        break;
+      }
+    }
+  }
   while (p < end) {
     if (*p++ == ch) {
       return (p - 1) - chars;
@@ -320,6 +320,52 @@ std::string String::ToModifiedUtf8() {
   }
 }
 
+// Returns the length of the common prefix of two compressed strings, comparing eight chars at a
+// time.
+static inline int32_t CompressedCommonPrefixLength(const uint8_t* lhs_chars,
+                                                   const uint8_t* rhs_chars,
+                                                   int32_t count) {
+  int32_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    uint64_t lhs_word;
+    uint64_t rhs_word;
+    memcpy(&lhs_word, lhs_chars + i, sizeof(lhs_word));
+    memcpy(&rhs_word, rhs_chars + i, sizeof(rhs_word));
+    if (lhs_word != rhs_word) {
+      break;
+    }
+  }
+  while (i < count && lhs_chars[i] == rhs_chars[i]) {
+    ++i;
+  }
+  return i;
+}
+
+// Returns the length of the common prefix of a compressed and an uncompressed string, comparing
+// four chars at a time. The compressed chars are widened to the in-memory layout of four
+// consecutive 16-bit chars on a little-endian target, which all supported ISAs are.
+static inline int32_t MixedCommonPrefixLength(const uint8_t* compressed_chars,
+                                              const uint16_t* uncompressed_chars,
+                                              int32_t count) {
+  int32_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    uint32_t narrow;
+    memcpy(&narrow, compressed_chars + i, sizeof(narrow));
+    uint64_t widened = narrow;
+    widened = (widened | (widened << 16)) & UINT64_C(0x0000ffff0000ffff);
+    widened = (widened | (widened << 8)) & UINT64_C(0x00ff00ff00ff00ff);
+    uint64_t word;
+    memcpy(&word, uncompressed_chars + i, sizeof(word));
+    if (widened != word) {
+      break;
+    }
+  }
+  while (i < count && compressed_chars[i] == uncompressed_chars[i]) {
+    ++i;
+  }
+  return i;
+}
+
 int32_t String::CompareTo(ObjPtr<String> rhs) {
   // Quick test for comparison of a string with itself.
   ObjPtr<String> lhs = this;
@@ -333,22 +379,19 @@ int32_t String::CompareTo(ObjPtr<String> rhs) {
   if (lhs->IsCompressed() && rhs->IsCompressed()) {
     const uint8_t* lhs_chars = lhs->GetValueCompressed();
     const uint8_t* rhs_chars = rhs->GetValueCompressed();
-    for (int32_t i = 0; i < min_count; ++i) {
-      int32_t char_diff = static_cast<int32_t>(lhs_chars[i]) - static_cast<int32_t>(rhs_chars[i]);
-      if (char_diff != 0) {
-        return char_diff;
-      }
+    int32_t i = CompressedCommonPrefixLength(lhs_chars, rhs_chars, min_count);
+    if (i != min_count) {
+      return static_cast<int32_t>(lhs_chars[i]) - static_cast<int32_t>(rhs_chars[i]);
     }
   } else if (lhs->IsCompressed() || rhs->IsCompressed()) {
     const uint8_t* compressed_chars =
         lhs->IsCompressed() ? lhs->GetValueCompressed() : rhs->GetValueCompressed();
     const uint16_t* uncompressed_chars = lhs->IsCompressed() ? rhs->GetValue() : lhs->GetValue();
-    for (int32_t i = 0; i < min_count; ++i) {
+    int32_t i = MixedCommonPrefixLength(compressed_chars, uncompressed_chars, min_count);
+    if (i != min_count) {
       int32_t char_diff =
           static_cast<int32_t>(compressed_chars[i]) - static_cast<int32_t>(uncompressed_chars[i]);
-      if (char_diff != 0) {
-        return lhs->IsCompressed() ? char_diff : -char_diff;
-      }
+      return lhs->IsCompressed() ? char_diff : -char_diff;
     }
   } else {
     const uint16_t* lhs_chars = lhs->GetValue();
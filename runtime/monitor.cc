@@ -28,16 +28,20 @@
 #include "base/systrace.h"
 #include "base/time_utils.h"
 #include "class_linker.h"
+#include "dex/descriptors_names.h"
 #include "dex/dex_file-inl.h"
 #include "dex/dex_file_types.h"
 #include "dex/dex_instruction-inl.h"
+#include "dex/utf.h"
 #include "entrypoints/entrypoint_utils-inl.h"
 #include "lock_word-inl.h"
+#include "monitor_contention_profile.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
 #include "object_callbacks.h"
 #include "scoped_thread_state_change-inl.h"
 #include "stack.h"
+#include "thin_lock_hash_codes.h"
 #include "thread.h"
 #include "thread_list.h"
 #include "verifier/method_verifier.h"
@@ -169,6 +173,12 @@ int32_t Monitor::GetHashCode() {
   return hc;
 }
 
+int32_t Monitor::SetHashCodeIfMissing(int32_t hash_code) {
+  DCHECK_NE(hash_code, 0);
+  hash_code_.CompareAndSetStrongRelaxed(0, hash_code);
+  return hash_code_.load(std::memory_order_relaxed);
+}
+
 void Monitor::SetLockingMethod(Thread* owner) {
   DCHECK(owner == Thread::Current() || owner->IsSuspended());
   // Do not abort on dex pc errors. This can easily happen when we want to dump a stack trace on
@@ -234,7 +244,12 @@ bool Monitor::Install(Thread* self) NO_THREAD_SAFETY_ANALYSIS {
   LockWord lw(GetObject()->GetLockWord(false));
   switch (lw.GetState()) {
     case LockWord::kThinLocked: {
-      DCHECK(owner != nullptr);
+      if (owner == nullptr) {
+        // Another thread thin-locked the hashed object with its hash code in the
+        // ThinLockHashCodes. The caller tries again.
+        DCHECK_NE(hash_code_.load(std::memory_order_relaxed), 0);
+        return false;
+      }
       CHECK_EQ(owner->GetThreadId(), lw.ThinLockOwner());
       DCHECK_EQ(monitor_lock_.GetExclusiveOwnerTid(), 0) << " my tid = " << SafeGetTid(self);
       lock_count_ = lw.ThinLockCount();
@@ -265,8 +280,9 @@ bool Monitor::Install(Thread* self) NO_THREAD_SAFETY_ANALYSIS {
       return false;
     }
     case LockWord::kUnlocked: {
-      LOG(FATAL) << "Inflating unlocked lock word";
-      UNREACHABLE();
+      // The hashed object may also have been thin-locked and unlocked again.
+      CHECK(owner == nullptr) << "Inflating unlocked lock word";
+      return false;
     }
     default: {
       LOG(FATAL) << "Invalid monitor state " << lw.GetState();
@@ -426,8 +442,11 @@ bool Monitor::TryLock(Thread* self, bool spin) {
     lock_count_++;
     CHECK_NE(lock_count_, 0u);  // Abort on overflow.
   } else {
-    bool success = spin ? monitor_lock_.ExclusiveTryLockWithSpinning(self)
-        : monitor_lock_.ExclusiveTryLock(self);
+    bool success = monitor_lock_.ExclusiveTryLock(self);
+    if (!success && spin && ShouldSpin(self)) {
+      success = monitor_lock_.ExclusiveTryLockWithSpinning(self);
+      RecordSpinOutcome(success);
+    }
     if (!success) {
       return false;
     }
@@ -443,6 +462,68 @@ bool Monitor::TryLock(Thread* self, bool spin) {
   return true;
 }
 
+void Monitor::RecordContention(Thread* self, uint64_t wait_ns, ArtMethod* owner_method) {
+  MonitorContentionProfile* profile = Runtime::Current()->GetMonitorContentionProfile();
+  if (profile == nullptr) {
+    return;
+  }
+  uint32_t dex_pc;
+  ArtMethod* waiter_method =
+      self->GetCurrentMethod(&dex_pc, /*check_suspended=*/ false, /*abort_on_error=*/ false);
+  std::string temp;
+  const char* descriptor = GetObject()->GetClass()->GetDescriptor(&temp);
+  uint64_t key = ComputeModifiedUtf8Hash(descriptor);
+  key = key * 31u + reinterpret_cast<uintptr_t>(waiter_method);
+  key = key * 31u + reinterpret_cast<uintptr_t>(owner_method);
+  profile->Record(key != 0u ? key : 1u, wait_ns, [&]() REQUIRES_SHARED(Locks::mutator_lock_) {
+    std::ostringstream oss;
+    oss << "on " << PrettyDescriptor(descriptor)
+        << " waiting in " << ArtMethod::PrettyMethod(waiter_method)
+        << " held in "
+        << (owner_method != nullptr ? ArtMethod::PrettyMethod(owner_method) : "<unknown>");
+    return oss.str();
+  });
+}
+
+// Returns true if the thread with `thread_id` is runnable, or gone. A thread that is suspended,
+// waiting or in native code does not release a lock it holds before it runs Java code again, so
+// spinning for it only wastes the CPU it may need to get there.
+static bool IsThreadRunnable(Thread* self, uint32_t thread_id)
+    REQUIRES(!Locks::thread_list_lock_) {
+  MutexLock mu(self, *Locks::thread_list_lock_);
+  Thread* thread = Runtime::Current()->GetThreadList()->FindThreadByThreadId(thread_id);
+  return thread == nullptr || thread->GetState() == ThreadState::kRunnable;
+}
+
+bool Monitor::ShouldSpin(Thread* self) {
+  if (failed_spins_.load(std::memory_order_relaxed) >= kMaxFailedSpins) {
+    // Spinning kept failing. Go straight to sleeping, but check again from time to time whether
+    // the monitor is now held for shorter periods.
+    uint8_t skipped_spins = skipped_spins_.load(std::memory_order_relaxed) + 1u;
+    if (skipped_spins < kSkippedSpinsBeforeRetry) {
+      skipped_spins_.store(skipped_spins, std::memory_order_relaxed);
+      return false;
+    }
+    skipped_spins_.store(0u, std::memory_order_relaxed);
+  }
+  // Acquiring thread_list_lock_ ensures that the owner doesn't disappear while we're looking at
+  // it. The owner may change meanwhile, which only makes us spin less or more than we should.
+  MutexLock mu(self, *Locks::thread_list_lock_);
+  Thread* owner = owner_.load(std::memory_order_relaxed);
+  return owner == nullptr || owner->GetState() == ThreadState::kRunnable;
+}
+
+void Monitor::RecordSpinOutcome(bool success) {
+  if (success) {
+    failed_spins_.store(0u, std::memory_order_relaxed);
+  } else {
+    uint8_t failed_spins = failed_spins_.load(std::memory_order_relaxed);
+    if (failed_spins < kMaxFailedSpins) {
+      failed_spins_.store(failed_spins + 1u, std::memory_order_relaxed);
+    }
+  }
+}
+
 template <LockReason reason>
 void Monitor::Lock(Thread* self) {
   bool called_monitors_callback = false;
@@ -457,9 +538,10 @@ void Monitor::Lock(Thread* self) {
   // Contended; not reentrant. We hold no locks, so tread carefully.
   const bool log_contention = (lock_profiling_threshold_ != 0);
   uint64_t wait_start_ms = log_contention ? MilliTime() : 0;
+  uint64_t wait_start_ns = NanoTime();
 
   Thread *orig_owner = nullptr;
-  ArtMethod* owners_method;
+  ArtMethod* owners_method = nullptr;
   uint32_t owners_dex_pc;
 
   // Do this before releasing the mutator lock so that we don't get deflated.
@@ -637,6 +719,7 @@ void Monitor::Lock(Thread* self) {
   self->SetMonitorEnterObject(nullptr);
   num_waiters_.fetch_sub(1, std::memory_order_relaxed);
   DCHECK(monitor_lock_.IsExclusiveHeld(self));
+  RecordContention(self, NanoTime() - wait_start_ns, owners_method);
   // We need to pair this with a single contended locking call. NB we match the RI behavior and call
   // this even if MonitorEnter failed.
   if (called_monitors_callback) {
@@ -1048,6 +1131,20 @@ void Monitor::Inflate(Thread* self, Thread* owner, ObjPtr<mirror::Object> obj, i
           << " created monitor " << m << " for object " << obj;
     }
     Runtime::Current()->GetMonitorList()->Add(m);
+    if (hash_code != 0) {
+      Runtime::Current()->GetMetrics()->MonitorHashCodeInflationCount()->AddOne();
+    } else {
+      // Move the hash code of a thin lock from the side table to the monitor. The side table
+      // keeps it until the monitor has it, for the threads that hash the object meanwhile.
+      ThinLockHashCodes* thin_lock_hash_codes = Runtime::Current()->GetThinLockHashCodes();
+      if (thin_lock_hash_codes->MayHaveEntries()) {
+        uint32_t table_hash_code = thin_lock_hash_codes->GetHashCode(self, obj);
+        if (table_hash_code != 0u) {
+          m->SetHashCodeIfMissing(table_hash_code);
+          thin_lock_hash_codes->Remove(self, obj);
+        }
+      }
+    }
     CHECK_EQ(obj->GetLockWord(true).GetState(), LockWord::kFatLocked);
   } else {
     MonitorPool::ReleaseMonitor(self, m);
@@ -1110,6 +1207,8 @@ ObjPtr<mirror::Object> Monitor::MonitorEnter(Thread* self,
   uint32_t thread_id = self->GetThreadId();
   size_t contention_count = 0;
   constexpr size_t kExtraSpinIters = 100;
+  // Spinning iterations after which we check that the owner of a thin lock is running.
+  constexpr size_t kSpinItersBeforeOwnerCheck = 10;
   StackHandleScope<1> hs(self);
   Handle<mirror::Object> h_obj(hs.NewHandle(obj));
   while (true) {
@@ -1165,7 +1264,12 @@ ObjPtr<mirror::Object> Monitor::MonitorEnter(Thread* self,
           // Contention.
           contention_count++;
           Runtime* runtime = Runtime::Current();
-          if (contention_count
+          if (contention_count == kSpinItersBeforeOwnerCheck &&
+              !IsThreadRunnable(self, owner_thread_id)) {
+            // The owner won't release the lock soon, inflate and wait on the monitor.
+            contention_count = 0;
+            InflateThinLocked(self, h_obj, lock_word, 0);
+          } else if (contention_count
               <= kExtraSpinIters + runtime->GetMaxSpinsBeforeThinLockInflation()) {
             // TODO: Consider switching the thread state to kWaitingForLockInflation when we are
             // yielding.  Use sched_yield instead of NanoSleep since NanoSleep can wait much longer
@@ -1196,6 +1300,19 @@ ObjPtr<mirror::Object> Monitor::MonitorEnter(Thread* self,
         }
       }
       case LockWord::kHashCode:
+        if (!Runtime::Current()->IsAotCompiler()) {
+          // Keep a thin lock and move the hash code to the side table. The image writer keeps
+          // only the hash codes of lock words, so dex2oat inflates instead.
+          if (Runtime::Current()->GetThinLockHashCodes()->ThinLockHashed(
+                  self, h_obj.Get(), lock_word)) {
+            AtraceMonitorLock(self, h_obj.Get(), /* is_wait= */ false);
+            return h_obj.Get();  // Success!
+          }
+          if (!LockWord::Equal<true>(h_obj->GetLockWord(false), lock_word)) {
+            continue;  // Go again.
+          }
+          // The side table has no slot for the hash code.
+        }
         // Inflate with the existing hashcode.
         // Again no ordering required for initial lockword read, since we don't rely
         // on the visibility of any prior computation.
@@ -1241,10 +1358,9 @@ bool Monitor::MonitorExit(Thread* self, ObjPtr<mirror::Object> obj) {
           }
           if (!gUseReadBarrier) {
             DCHECK_EQ(new_lw.ReadBarrierState(), 0U);
-            // TODO: This really only needs memory_order_release, but we currently have
-            // no way to specify that. In fact there seem to be no legitimate uses of SetLockWord
-            // with a final argument of true. This slows down x86 and ARMv7, but probably not v8.
-            h_obj->SetLockWord(new_lw, true);
+            // Only the owner writes the lock word of a thin lock, so a release store is enough to
+            // publish the critical section to the next owner.
+            h_obj->SetLockWordRelease(new_lw);
             AtraceMonitorUnlock();
             // Success!
             return true;
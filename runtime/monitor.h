@@ -143,6 +143,9 @@ class Monitor {
 
   int32_t GetHashCode();
 
+  // Use `hash_code` unless the monitor already has a hash code. Returns the hash code.
+  int32_t SetHashCodeIfMissing(int32_t hash_code);
+
   // Is the monitor currently locked? Debug only, provides no memory ordering guarantees.
   bool IsLocked() REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!monitor_lock_);
 
@@ -218,6 +221,11 @@ class Monitor {
                           uint32_t owner_dex_pc)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Record a contended acquisition of the monitor in the runtime's contention profile.
+  // `owner_method` is the method the owner acquired the monitor in, if known.
+  void RecordContention(Thread* self, uint64_t wait_ns, ArtMethod* owner_method)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   static void FailedUnlock(ObjPtr<mirror::Object> obj,
                            uint32_t expected_owner_thread_id,
                            uint32_t found_owner_thread_id,
@@ -226,11 +234,22 @@ class Monitor {
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Try to lock without blocking, returns true if we acquired the lock.
-  // If spin is true, then we spin for a short period before failing.
+  // If spin is true, then we spin for a short period before failing, unless `ShouldSpin()` says
+  // that spinning is unlikely to get the lock.
   bool TryLock(Thread* self, bool spin = false)
       TRY_ACQUIRE(true, monitor_lock_)
+      REQUIRES(!Locks::thread_list_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Returns true if spinning for the contended monitor is worth it: the owner is running Java
+  // code, and spinning did not keep failing for this monitor recently.
+  bool ShouldSpin(Thread* self)
+      REQUIRES(!Locks::thread_list_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Adjust the spin policy of the monitor after spinning for it.
+  void RecordSpinOutcome(bool success);
+
   template<LockReason reason = LockReason::kForLock>
   void Lock(Thread* self)
       ACQUIRE(monitor_lock_)
@@ -332,6 +351,14 @@ class Monitor {
   // Owner's recursive lock depth. Owner_ non-null, and lock_count_ == 0 ==> held once.
   unsigned int lock_count_ GUARDED_BY(monitor_lock_);
 
+  // Number of consecutive times spinning failed to get the contended monitor, up to
+  // kMaxFailedSpins, and the number of times spinning was skipped since. Updated racily, as they
+  // only steer how much we spin.
+  static constexpr uint8_t kMaxFailedSpins = 4u;
+  static constexpr uint8_t kSkippedSpinsBeforeRetry = 16u;
+  std::atomic<uint8_t> failed_spins_ = 0u;
+  std::atomic<uint8_t> skipped_spins_ = 0u;
+
   // Owner's recursive lock depth is given by monitor_lock_.GetDepth().
 
   // What object are we part of. This is a weak root. Do not access
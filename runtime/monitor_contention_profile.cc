@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "monitor_contention_profile.h"
+
+#include <algorithm>
+#include <ostream>
+#include <vector>
+
+#include "base/time_utils.h"
+
+namespace art {
+
+// Number of entries to look at for a key before giving up on recording it.
+static constexpr size_t kMaxProbes = 16u;
+
+MonitorContentionProfile::~MonitorContentionProfile() {
+  for (Entry& entry : entries_) {
+    delete entry.description.load(std::memory_order_relaxed);
+  }
+}
+
+MonitorContentionProfile::Entry* MonitorContentionProfile::FindOrClaimEntry(uint64_t key,
+                                                                            bool* claimed) {
+  size_t index = static_cast<size_t>(key ^ (key >> 32)) % kNumEntries;
+  for (size_t probe = 0; probe != kMaxProbes; ++probe) {
+    Entry* entry = &entries_[(index + probe) % kNumEntries];
+    uint64_t entry_key = entry->key.load(std::memory_order_relaxed);
+    if (entry_key == 0u &&
+        entry->key.compare_exchange_strong(entry_key, key, std::memory_order_relaxed)) {
+      *claimed = true;
+      return entry;
+    }
+    if (entry_key == key) {
+      return entry;
+    }
+  }
+  return nullptr;
+}
+
+uint64_t MonitorContentionProfile::GetTotalCount() const {
+  uint64_t count = dropped_count_.load(std::memory_order_relaxed);
+  for (const Entry& entry : entries_) {
+    count += entry.count.load(std::memory_order_relaxed);
+  }
+  return count;
+}
+
+uint64_t MonitorContentionProfile::GetTotalWaitNs() const {
+  uint64_t wait_ns = dropped_wait_ns_.load(std::memory_order_relaxed);
+  for (const Entry& entry : entries_) {
+    wait_ns += entry.total_wait_ns.load(std::memory_order_relaxed);
+  }
+  return wait_ns;
+}
+
+void MonitorContentionProfile::Reset() {
+  for (Entry& entry : entries_) {
+    delete entry.description.exchange(nullptr, std::memory_order_relaxed);
+    entry.count.store(0u, std::memory_order_relaxed);
+    entry.total_wait_ns.store(0u, std::memory_order_relaxed);
+    entry.max_wait_ns.store(0u, std::memory_order_relaxed);
+    entry.key.store(0u, std::memory_order_relaxed);
+  }
+  dropped_count_.store(0u, std::memory_order_relaxed);
+  dropped_wait_ns_.store(0u, std::memory_order_relaxed);
+}
+
+void MonitorContentionProfile::Dump(std::ostream& os, size_t max_entries) const {
+  struct Site {
+    const std::string* description;
+    uint64_t count;
+    uint64_t total_wait_ns;
+    uint64_t max_wait_ns;
+  };
+  std::vector<Site> sites;
+  for (const Entry& entry : entries_) {
+    // Skip entries that are claimed but not described yet.
+    const std::string* description = entry.description.load(std::memory_order_acquire);
+    uint64_t count = entry.count.load(std::memory_order_relaxed);
+    if (description != nullptr && count != 0u) {
+      sites.push_back({description,
+                       count,
+                       entry.total_wait_ns.load(std::memory_order_relaxed),
+                       entry.max_wait_ns.load(std::memory_order_relaxed)});
+    }
+  }
+  if (sites.empty()) {
+    return;
+  }
+  std::sort(sites.begin(), sites.end(), [](const Site& lhs, const Site& rhs) {
+    return lhs.total_wait_ns > rhs.total_wait_ns;
+  });
+  os << "Monitor contention: " << GetTotalCount() << " contended acquisitions, waited "
+     << PrettyDuration(GetTotalWaitNs()) << "\n";
+  for (size_t i = 0, size = std::min(sites.size(), max_entries); i != size; ++i) {
+    const Site& site = sites[i];
+    os << "  " << PrettyDuration(site.total_wait_ns) << " in " << site.count
+       << " waits (max " << PrettyDuration(site.max_wait_ns) << ") " << *site.description << "\n";
+  }
+  uint64_t dropped_count = dropped_count_.load(std::memory_order_relaxed);
+  if (dropped_count != 0u) {
+    os << "  " << PrettyDuration(dropped_wait_ns_.load(std::memory_order_relaxed)) << " in "
+       << dropped_count << " waits at sites that did not fit the profile\n";
+  }
+  os << "\n";
+}
+
+}  // namespace art
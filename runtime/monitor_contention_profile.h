@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_MONITOR_CONTENTION_PROFILE_H_
+#define ART_RUNTIME_MONITOR_CONTENTION_PROFILE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <iosfwd>
+#include <string>
+
+#include "android-base/logging.h"
+#include "base/macros.h"
+
+namespace art {
+
+// Aggregated wait times of contended monitor acquisitions, by lock class, waiting method and,
+// when lock profiling asks the owner for it, owning method. Recording does not take any lock, so
+// that profiling does not add to the contention it measures. The profile has room for a fixed
+// number of distinct contention sites; further sites are only counted as dropped.
+class MonitorContentionProfile {
+ public:
+  static constexpr size_t kNumEntries = 512u;
+
+  // Record a contended acquisition that waited `wait_ns`. `key` identifies the contention site
+  // and must not be zero. `describe` returns the description of the site, it is called only for
+  // the first acquisition recorded for the key, with the locks the caller holds.
+  template <typename DescribeFn>
+  void Record(uint64_t key, uint64_t wait_ns, DescribeFn&& describe) NO_THREAD_SAFETY_ANALYSIS;
+
+  // Print the contention sites with the most wait time, up to `max_entries`.
+  void Dump(std::ostream& os, size_t max_entries = 20u) const;
+
+  uint64_t GetTotalCount() const;
+  uint64_t GetTotalWaitNs() const;
+
+  // Forget all recorded contention. Must not be called concurrently with `Record()`.
+  void Reset();
+
+  ~MonitorContentionProfile();
+
+ private:
+  struct Entry {
+    std::atomic<uint64_t> key{0u};
+    // Set once by the thread that claimed the entry.
+    std::atomic<std::string*> description{nullptr};
+    std::atomic<uint64_t> count{0u};
+    std::atomic<uint64_t> total_wait_ns{0u};
+    std::atomic<uint64_t> max_wait_ns{0u};
+  };
+
+  Entry* FindOrClaimEntry(uint64_t key, /*out*/ bool* claimed);
+
+  Entry entries_[kNumEntries];
+  std::atomic<uint64_t> dropped_count_{0u};
+  std::atomic<uint64_t> dropped_wait_ns_{0u};
+};
+
+template <typename DescribeFn>
+inline void MonitorContentionProfile::Record(uint64_t key,
+                                             uint64_t wait_ns,
+                                             DescribeFn&& describe) {
+  DCHECK_NE(key, 0u);
+  bool claimed = false;
+  Entry* entry = FindOrClaimEntry(key, &claimed);
+  if (entry == nullptr) {
+    dropped_count_.fetch_add(1u, std::memory_order_relaxed);
+    dropped_wait_ns_.fetch_add(wait_ns, std::memory_order_relaxed);
+    return;
+  }
+  if (claimed) {
+    entry->description.store(new std::string(describe()), std::memory_order_release);
+  }
+  entry->count.fetch_add(1u, std::memory_order_relaxed);
+  entry->total_wait_ns.fetch_add(wait_ns, std::memory_order_relaxed);
+  uint64_t max_wait_ns = entry->max_wait_ns.load(std::memory_order_relaxed);
+  while (wait_ns > max_wait_ns &&
+         !entry->max_wait_ns.compare_exchange_weak(max_wait_ns, wait_ns,
+                                                   std::memory_order_relaxed)) {
+  }
+}
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_MONITOR_CONTENTION_PROFILE_H_
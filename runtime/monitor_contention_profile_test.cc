@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "monitor_contention_profile.h"
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace art {
+
+TEST(MonitorContentionProfileTest, Record) {
+  auto profile = std::make_unique<MonitorContentionProfile>();
+  size_t num_describe_calls = 0u;
+  auto describe = [&](const char* description) {
+    return [&num_describe_calls, description]() {
+      ++num_describe_calls;
+      return std::string(description);
+    };
+  };
+  profile->Record(/*key=*/ 1u, /*wait_ns=*/ 1000u, describe("site one"));
+  profile->Record(/*key=*/ 1u, /*wait_ns=*/ 3000u, describe("site one again"));
+  profile->Record(/*key=*/ 2u, /*wait_ns=*/ 5000u, describe("site two"));
+  EXPECT_EQ(num_describe_calls, 2u);
+  EXPECT_EQ(profile->GetTotalCount(), 3u);
+  EXPECT_EQ(profile->GetTotalWaitNs(), 9000u);
+
+  std::ostringstream oss;
+  profile->Dump(oss);
+  std::string dump = oss.str();
+  // Sites are sorted by total wait time.
+  size_t site_two = dump.find("in 1 waits (max 5us) site two");
+  size_t site_one = dump.find("in 2 waits (max 3us) site one\n");
+  ASSERT_NE(site_two, std::string::npos) << dump;
+  ASSERT_NE(site_one, std::string::npos) << dump;
+  EXPECT_LT(site_two, site_one);
+  EXPECT_EQ(dump.find("site one again"), std::string::npos);
+
+  profile->Reset();
+  EXPECT_EQ(profile->GetTotalCount(), 0u);
+  std::ostringstream empty_oss;
+  profile->Dump(empty_oss);
+  EXPECT_TRUE(empty_oss.str().empty());
+}
+
+TEST(MonitorContentionProfileTest, Dropped) {
+  auto profile = std::make_unique<MonitorContentionProfile>();
+  // Keys that map to the same entry fill the probe sequence of that entry.
+  for (uint64_t i = 1u; i <= 2u * MonitorContentionProfile::kNumEntries; ++i) {
+    profile->Record(i * MonitorContentionProfile::kNumEntries, /*wait_ns=*/ 10u, []() {
+      return std::string("site");
+    });
+  }
+  EXPECT_EQ(profile->GetTotalCount(), 2u * MonitorContentionProfile::kNumEntries);
+  std::ostringstream oss;
+  profile->Dump(oss);
+  EXPECT_NE(oss.str().find("at sites that did not fit the profile"), std::string::npos);
+}
+
+}  // namespace art
@@ -30,6 +30,7 @@
 #include "mirror/string-inl.h"  // Strings are easiest to allocate
 #include "object_lock.h"
 #include "scoped_thread_state_change-inl.h"
+#include "thin_lock_hash_codes.h"
 #include "thread_pool.h"
 
 namespace art {
@@ -391,5 +392,52 @@ TEST_F(MonitorTest, TestTryLock) {
   thread_pool.StopWorkers(self);
 }
 
+class ThinLockHashCodesTest : public CommonRuntimeTest {
+ protected:
+  ThinLockHashCodesTest() {
+    use_boot_image_ = true;  // Make the Runtime creation cheaper.
+  }
+
+  void SetUpRuntimeOptions([[maybe_unused]] RuntimeOptions* options) override {
+    // Without compiler callbacks, this is not an AOT compiler, which inflates hashed objects.
+    callbacks_.reset();
+  }
+};
+
+TEST_F(ThinLockHashCodesTest, LockHashedObjectWithoutInflation) {
+  Thread* const self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  StackHandleScope<1> hs(self);
+  Handle<mirror::Object> obj(
+      hs.NewHandle<mirror::Object>(mirror::String::AllocFromModifiedUtf8(self, "hello, world!")));
+  ASSERT_TRUE(obj != nullptr);
+  int32_t hash_code = obj->IdentityHashCode();
+  ASSERT_EQ(obj->GetLockWord(false).GetState(), LockWord::kHashCode);
+  ThinLockHashCodes* thin_lock_hash_codes = Runtime::Current()->GetThinLockHashCodes();
+  size_t num_entries = thin_lock_hash_codes->Size();
+  {
+    ObjectLock<mirror::Object> lock(self, obj);
+    EXPECT_EQ(obj->GetLockWord(false).GetState(), LockWord::kThinLocked);
+    EXPECT_EQ(thin_lock_hash_codes->Size(), num_entries + 1u);
+    EXPECT_EQ(obj->IdentityHashCode(), hash_code);
+    EXPECT_EQ(obj->GetLockWord(false).GetState(), LockWord::kThinLocked);
+  }
+  EXPECT_EQ(obj->GetLockWord(false).GetState(), LockWord::kUnlocked);
+  EXPECT_EQ(thin_lock_hash_codes->Size(), num_entries + 1u);
+  EXPECT_EQ(obj->IdentityHashCode(), hash_code);
+  // The hash code is back in the lock word and the entry is removed.
+  EXPECT_EQ(obj->GetLockWord(false).GetState(), LockWord::kHashCode);
+  EXPECT_EQ(thin_lock_hash_codes->Size(), num_entries);
+  {
+    // Inflating moves the hash code to the monitor.
+    ObjectLock<mirror::Object> lock(self, obj);
+    EXPECT_EQ(thin_lock_hash_codes->Size(), num_entries + 1u);
+    Monitor::InflateThinLocked(self, obj, obj->GetLockWord(false), 0u);
+    EXPECT_EQ(obj->GetLockWord(false).GetState(), LockWord::kFatLocked);
+    EXPECT_TRUE(obj->GetLockWord(false).FatLockMonitor()->HasHashCode());
+    EXPECT_EQ(thin_lock_hash_codes->Size(), num_entries);
+    EXPECT_EQ(obj->IdentityHashCode(), hash_code);
+  }
+}
 
 }  // namespace art
@@ -30,6 +30,7 @@
 #include "class_root-inl.h"
 #include "common_throws.h"
 #include "debugger.h"
+#include "gc/allocation_histogram.h"
 #include "gc/space/bump_pointer_space.h"
 #include "gc/space/dlmalloc_space.h"
 #include "gc/space/large_object_space.h"
@@ -234,7 +235,13 @@ static void VMDebug_dumpHprofData(JNIEnv* env, jclass, jstring javaFilename, jin
 
   int fd = javaFd;
 
-  hprof::DumpHeap(filename.c_str(), fd, false);
+  hprof::DumpHeapOptions options;
+  options.fork = gFlags.HprofFork();
+  options.streaming = gFlags.HprofStreaming();
+  if (javaFilename != nullptr && android::base::EndsWith(filename, ".gz")) {
+    options.compression = hprof::HprofCompression::kGzip;
+  }
+  hprof::DumpHeap(filename.c_str(), fd, options);
 }
 
 static void VMDebug_dumpHprofDataDdms(JNIEnv*, jclass) {
@@ -313,6 +320,7 @@ enum class VMDebugRuntimeStatId {
   kArtGcObjectsAllocated,
   kArtGcTotalTimeWaitingForGc,
   kArtGcPreOomeGcCount,
+  kArtGcAllocationHistogram,
   kNumRuntimeStats,
 };
 
@@ -365,6 +373,11 @@ static jstring VMDebug_getRuntimeStatInternal(JNIEnv* env, jclass, jint statId)
       std::string output = std::to_string(heap->GetPreOomeGcCount());
       return env->NewStringUTF(output.c_str());
     }
+    case VMDebugRuntimeStatId::kArtGcAllocationHistogram: {
+      std::ostringstream output;
+      heap->GetAllocationHistogram()->Dump(output);
+      return env->NewStringUTF(output.str().c_str());
+    }
     default:
       return nullptr;
   }
@@ -459,6 +459,15 @@ static void VMRuntime_bootCompleted([[maybe_unused]] JNIEnv* env, [[maybe_unused
   }
 }
 
+static void VMRuntime_setThermalStatus([[maybe_unused]] JNIEnv* env,
+                                       [[maybe_unused]] jclass klass,
+                                       jint status) {
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit != nullptr) {
+    jit->SetThermalStatus(status);
+  }
+}
+
 class ClearJitCountersVisitor : public ClassVisitor {
  public:
   bool operator()(ObjPtr<mirror::Class> klass) override REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -580,6 +589,7 @@ static JNINativeMethod gMethods[] = {
   NATIVE_METHOD(VMRuntime, setProcessPackageName, "(Ljava/lang/String;)V"),
   NATIVE_METHOD(VMRuntime, setProcessDataDirectory, "(Ljava/lang/String;)V"),
   NATIVE_METHOD(VMRuntime, bootCompleted, "()V"),
+  NATIVE_METHOD(VMRuntime, setThermalStatus, "(I)V"),
   NATIVE_METHOD(VMRuntime, resetJitCounters, "()V"),
   NATIVE_METHOD(VMRuntime, isValidClassLoaderContext, "(Ljava/lang/String;)Z"),
   NATIVE_METHOD(VMRuntime, getBaseApkOptimizationInfo,
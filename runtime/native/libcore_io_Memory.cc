@@ -19,10 +19,11 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "common_throws.h"
 #include "jni/jni_internal.h"
+#include "mirror/array-inl.h"
 #include "native_util.h"
 #include "nativehelper/jni_macros.h"
-#include "nativehelper/scoped_primitive_array.h"
 #include "scoped_fast_native_object_access-inl.h"
 
 namespace art {
@@ -93,33 +94,45 @@ static inline void swapLongs(jlong* dstLongs, const jlong* srcLongs, size_t coun
   }
 }
 
+// Implements the peekXArray methods. The elements are copied, and for swapped access byte-swapped
+// in the same pass, directly into the array data. Unlike the JNI GetXArrayElements functions, this
+// does not copy the whole array out and back in when the array is movable.
+template <typename ArrayT, typename SwapT>
+static void PeekArray(JNIEnv* env,
+                      jlong srcAddress,
+                      jobject dst,
+                      jint dstOffset,
+                      jint count,
+                      jboolean swap,
+                      void (*swap_fn)(SwapT*, const SwapT*, size_t)) {
+  ScopedFastNativeObjectAccess soa(env);
+  ObjPtr<ArrayT> array = soa.Decode<ArrayT>(dst);
+  if (UNLIKELY(array == nullptr)) {
+    ThrowNullPointerException("dst == null");
+    return;
+  }
+  if (UNLIKELY(dstOffset < 0 || count < 0 || count > array->GetLength() - dstOffset)) {
+    std::string type(array->PrettyTypeOf());
+    soa.Self()->ThrowNewExceptionF("Ljava/lang/ArrayIndexOutOfBoundsException;",
+                                   "%s offset=%d length=%d dst.length=%d",
+                                   type.c_str(), dstOffset, count, array->GetLength());
+    return;
+  }
+  auto* data = array->GetData() + dstOffset;
+  static_assert(sizeof(*data) == sizeof(SwapT));
+  if (swap_fn != nullptr && swap) {
+    swap_fn(reinterpret_cast<SwapT*>(data), cast<const SwapT*>(srcAddress), count);
+  } else {
+    memcpy(data, cast<const void*>(srcAddress), count * sizeof(*data));
+  }
+}
+
 static void Memory_peekByteArray(
     JNIEnv* env, jclass, jlong srcAddress, jbyteArray dst, jint dstOffset, jint byteCount) {
-  env->SetByteArrayRegion(dst, dstOffset, byteCount, cast<const jbyte*>(srcAddress));
+  PeekArray<mirror::ByteArray, jbyte>(
+      env, srcAddress, dst, dstOffset, byteCount, /*swap=*/ false, /*swap_fn=*/ nullptr);
 }
 
-// Implements the peekXArray methods:
-// - For unswapped access, we just use the JNI SetXArrayRegion functions.
-// - For swapped access, we use GetXArrayElements and our own copy-and-swap routines.
-//   GetXArrayElements is disproportionately cheap on Dalvik because it doesn't copy (as opposed
-//   to Hotspot, which always copies). The SWAP_FN copies and swaps in one pass, which is cheaper
-//   than copying and then swapping in a second pass. Depending on future VM/GC changes, the
-//   swapped case might need to be revisited.
-#define PEEKER(SCALAR_TYPE, JNI_NAME, SWAP_TYPE, SWAP_FN)                                       \
-  {                                                                                             \
-    if (swap) {                                                                                 \
-      Scoped##JNI_NAME##ArrayRW elements(env, dst);                                             \
-      if (elements.get() == NULL) {                                                             \
-        return;                                                                                 \
-      }                                                                                         \
-      const SWAP_TYPE* src = cast<const SWAP_TYPE*>(srcAddress);                                \
-      SWAP_FN(reinterpret_cast<SWAP_TYPE*>(elements.get()) + dstOffset, src, count); /*NOLINT*/ \
-    } else {                                                                                    \
-      const SCALAR_TYPE* src = cast<const SCALAR_TYPE*>(srcAddress);                            \
-      env->Set##JNI_NAME##ArrayRegion(dst, dstOffset, count, src);                              \
-    }                                                                                           \
-  }
-
 static void Memory_peekCharArray(JNIEnv* env,
                                  jclass,
                                  jlong srcAddress,
@@ -127,7 +140,7 @@ static void Memory_peekCharArray(JNIEnv* env,
                                  jint dstOffset,
                                  jint count,
                                  jboolean swap) {
-  PEEKER(jchar, Char, jshort, swapShorts);
+  PeekArray<mirror::CharArray, jshort>(env, srcAddress, dst, dstOffset, count, swap, swapShorts);
 }
 
 static void Memory_peekDoubleArray(JNIEnv* env,
@@ -137,7 +150,7 @@ static void Memory_peekDoubleArray(JNIEnv* env,
                                    jint dstOffset,
                                    jint count,
                                    jboolean swap) {
-  PEEKER(jdouble, Double, jlong, swapLongs);
+  PeekArray<mirror::DoubleArray, jlong>(env, srcAddress, dst, dstOffset, count, swap, swapLongs);
 }
 
 static void Memory_peekFloatArray(JNIEnv* env,
@@ -147,7 +160,7 @@ static void Memory_peekFloatArray(JNIEnv* env,
                                   jint dstOffset,
                                   jint count,
                                   jboolean swap) {
-  PEEKER(jfloat, Float, jint, swapInts);
+  PeekArray<mirror::FloatArray, jint>(env, srcAddress, dst, dstOffset, count, swap, swapInts);
 }
 
 static void Memory_peekIntArray(JNIEnv* env,
@@ -157,7 +170,7 @@ static void Memory_peekIntArray(JNIEnv* env,
                                 jint dstOffset,
                                 jint count,
                                 jboolean swap) {
-  PEEKER(jint, Int, jint, swapInts);
+  PeekArray<mirror::IntArray, jint>(env, srcAddress, dst, dstOffset, count, swap, swapInts);
 }
 
 static void Memory_peekLongArray(JNIEnv* env,
@@ -167,7 +180,7 @@ static void Memory_peekLongArray(JNIEnv* env,
                                  jint dstOffset,
                                  jint count,
                                  jboolean swap) {
-  PEEKER(jlong, Long, jlong, swapLongs);
+  PeekArray<mirror::LongArray, jlong>(env, srcAddress, dst, dstOffset, count, swap, swapLongs);
 }
 
 static void Memory_peekShortArray(JNIEnv* env,
@@ -177,7 +190,7 @@ static void Memory_peekShortArray(JNIEnv* env,
                                   jint dstOffset,
                                   jint count,
                                   jboolean swap) {
-  PEEKER(jshort, Short, jshort, swapShorts);
+  PeekArray<mirror::ShortArray, jshort>(env, srcAddress, dst, dstOffset, count, swap, swapShorts);
 }
 
 // The remaining Memory methods are contained in libcore/luni/src/main/native/libcore_io_Memory.cpp
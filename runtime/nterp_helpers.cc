@@ -234,27 +234,6 @@ bool CanMethodUseNterp(ArtMethod* method, InstructionSet isa) {
       method->IsProxyMethod()) {
     return false;
   }
-  if (isa == InstructionSet::kRiscv64) {
-    if (method->GetDexFile()->IsCompactDexFile()) {
-      return false;  // Riscv64 nterp does not support compact dex yet.
-    }
-    if (method->DexInstructionData().TriesSize() != 0u) {
-      return false;  // Riscv64 nterp does not support exception handling yet.
-    }
-    if (method->DexInstructionData().InsSize() != 0u) {
-      return false;  // Riscv64 nterp does not support argument processing yet.
-    }
-    for (DexInstructionPcPair pair : method->DexInstructions()) {
-      // TODO(riscv64): Add support for more instructions.
-      // Remove the check when all instructions are supported.
-      switch (pair->Opcode()) {
-        case Instruction::RETURN_VOID:
-          break;
-        default:
-          return false;
-      }
-    }
-  }
   // There is no need to add the alignment padding size for comparison with aligned limit.
   size_t frame_size_without_padding = NterpGetFrameSizeWithoutPadding(method, isa);
   DCHECK_EQ(NterpGetFrameSize(method, isa), RoundUp(frame_size_without_padding, kStackAlignment));
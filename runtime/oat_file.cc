@@ -483,7 +483,7 @@ static bool ComputeAndCheckTypeLookupTableData(const DexFile::Header& header,
   }
 
   size_t found_size = reinterpret_cast<const uint32_t*>(type_lookup_table_start)[0];
-  size_t expected_table_size = TypeLookupTable::RawDataLength(header.class_defs_size_);
+  size_t expected_table_size = VdexFile::TypeLookupTableDataSize(header.class_defs_size_);
   if (UNLIKELY(found_size != expected_table_size)) {
     *error_msg =
         StringPrintf("In vdex file '%s' unexpected type lookup table size: found %zu, expected %zu",
@@ -959,7 +959,7 @@ bool OatFileBase::Setup(int zip_fd,
     if (lookup_table_offset != 0u &&
         (UNLIKELY(lookup_table_offset > DexSize()) ||
             UNLIKELY(DexSize() - lookup_table_offset <
-                     TypeLookupTable::RawDataLength(header->class_defs_size_)))) {
+                     VdexFile::TypeLookupTableDataSize(header->class_defs_size_)))) {
       *error_msg = StringPrintf("In oat file '%s' found OatDexFile #%zu for '%s' with truncated "
                                     "type lookup table, offset %u of %zu, class defs %u",
                                 GetLocation().c_str(),
@@ -2190,7 +2190,7 @@ void OatDexFile::InitializeTypeLookupTable() {
     // Peek the number of classes from the DexFile.
     const DexFile::Header* dex_header = reinterpret_cast<const DexFile::Header*>(dex_file_pointer_);
     const uint32_t num_class_defs = dex_header->class_defs_size_;
-    if (lookup_table_data_ + TypeLookupTable::RawDataLength(num_class_defs) >
+    if (lookup_table_data_ + VdexFile::TypeLookupTableDataSize(num_class_defs) >
             GetOatFile()->DexEnd()) {
       LOG(WARNING) << "found truncated lookup table in " << dex_file_location_;
     } else {
@@ -2200,6 +2200,8 @@ void OatDexFile::InitializeTypeLookupTable() {
         dex_data += dex_header->data_off_;
       }
       lookup_table_ = TypeLookupTable::Open(dex_data, lookup_table_data_, num_class_defs);
+      class_descriptor_hashes_ = reinterpret_cast<const uint32_t*>(
+          lookup_table_data_ + TypeLookupTable::RawDataLength(num_class_defs));
     }
   }
 }
@@ -574,6 +574,12 @@ class OatDexFile final {
     return lookup_table_;
   }
 
+  // Returns the ComputeModifiedUtf8Hash() of the descriptor of each class def, which the vdex
+  // stores after the type lookup table, or null if there is no type lookup table in the vdex.
+  const uint32_t* GetClassDescriptorHashes() const {
+    return class_descriptor_hashes_;
+  }
+
   ~OatDexFile();
 
   // Create only with a type lookup table, used by the compiler to speed up compilation.
@@ -626,6 +632,7 @@ class OatDexFile final {
   const IndexBssMapping* const string_bss_mapping_ = nullptr;
   const uint32_t* const oat_class_offsets_pointer_ = nullptr;
   TypeLookupTable lookup_table_;
+  const uint32_t* class_descriptor_hashes_ = nullptr;
   const DexLayoutSections* const dex_layout_sections_ = nullptr;
 
   friend class OatFile;
@@ -18,9 +18,12 @@
 
 #include <sys/stat.h>
 
+#include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <sstream>
+#include <tuple>
 #include <vector>
 
 #include "android-base/file.h"
@@ -721,11 +724,13 @@ bool OatFileAssistant::GetRequiredDexChecksum(std::optional<uint32_t>* checksum,
   if (!required_dex_checksums_attempted_) {
     required_dex_checksums_attempted_ = true;
 
-    ArtDexFileLoader dex_loader(DupCloexec(zip_fd_), dex_location_);
     std::optional<uint32_t> checksum2;
     std::string error2;
-    if (dex_loader.GetMultiDexChecksum(
-            &checksum2, &error2, &zip_file_only_contains_uncompressed_dex_)) {
+    if (GetMultiDexChecksumCached(zip_fd_,
+                                  dex_location_,
+                                  &checksum2,
+                                  &error2,
+                                  &zip_file_only_contains_uncompressed_dex_)) {
       cached_required_dex_checksums_ = checksum2;
       cached_required_dex_checksums_error_ = std::nullopt;
     } else {
@@ -748,6 +753,77 @@ bool OatFileAssistant::GetRequiredDexChecksum(std::optional<uint32_t>* checksum,
   return true;
 }
 
+namespace {
+
+// The file identity that GetMultiDexChecksumCached() checks. The change time cannot be set from
+// user space, so a rewritten file does not match its old entry even if it keeps the inode, the
+// size and the modification time.
+struct DexChecksumCacheKey {
+  dev_t dev;
+  ino_t ino;
+  off_t size;
+  int64_t mtime_ns;
+  int64_t ctime_ns;
+
+  bool operator<(const DexChecksumCacheKey& other) const {
+    return std::tie(dev, ino, size, mtime_ns, ctime_ns) <
+           std::tie(other.dev, other.ino, other.size, other.mtime_ns, other.ctime_ns);
+  }
+};
+
+struct DexChecksumCacheEntry {
+  std::optional<uint32_t> checksum;
+  bool only_contains_uncompressed_dex;
+};
+
+// Bounds the memory use of the cache, the cache is cleared when it is full.
+constexpr size_t kMaxDexChecksumCacheEntries = 1024u;
+
+// Not an art::Mutex, the oat file assistant is also used without a runtime.
+std::mutex dex_checksum_cache_lock;
+std::map<DexChecksumCacheKey, DexChecksumCacheEntry> dex_checksum_cache;
+
+int64_t TimespecToNs(const struct timespec& ts) {
+  return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+}  // namespace
+
+bool OatFileAssistant::GetMultiDexChecksumCached(int zip_fd,
+                                                 const std::string& location,
+                                                 /*out*/ std::optional<uint32_t>* checksum,
+                                                 /*out*/ std::string* error_msg,
+                                                 /*out*/ bool* only_contains_uncompressed_dex) {
+  struct stat st;
+  int stat_result = (zip_fd >= 0) ? fstat(zip_fd, &st) : stat(location.c_str(), &st);
+  std::optional<DexChecksumCacheKey> key;
+  if (stat_result == 0 && S_ISREG(st.st_mode)) {
+    key = DexChecksumCacheKey{
+        st.st_dev, st.st_ino, st.st_size, TimespecToNs(st.st_mtim), TimespecToNs(st.st_ctim)};
+    std::lock_guard<std::mutex> lock(dex_checksum_cache_lock);
+    auto it = dex_checksum_cache.find(*key);
+    if (it != dex_checksum_cache.end()) {
+      *checksum = it->second.checksum;
+      *only_contains_uncompressed_dex = it->second.only_contains_uncompressed_dex;
+      return true;
+    }
+  }
+
+  ArtDexFileLoader dex_loader(DupCloexec(zip_fd), location);
+  if (!dex_loader.GetMultiDexChecksum(checksum, error_msg, only_contains_uncompressed_dex)) {
+    return false;
+  }
+  if (key.has_value()) {
+    std::lock_guard<std::mutex> lock(dex_checksum_cache_lock);
+    if (dex_checksum_cache.size() == kMaxDexChecksumCacheEntries) {
+      dex_checksum_cache.clear();
+    }
+    dex_checksum_cache.insert_or_assign(
+        *key, DexChecksumCacheEntry{*checksum, *only_contains_uncompressed_dex});
+  }
+  return true;
+}
+
 bool OatFileAssistant::ValidateBootClassPathChecksums(OatFileAssistantContext* ofa_context,
                                                       InstructionSet isa,
                                                       std::string_view oat_checksums,
@@ -370,6 +370,16 @@ class OatFileAssistant {
                                              std::string_view oat_boot_class_path,
                                              /*out*/ std::string* error_msg);
 
+  // Like ArtDexFileLoader::GetMultiDexChecksum(), but remembers the results for files that did
+  // not change since they were read, as identified by their inode, size and change times. The
+  // dexopt status queries of long-lived processes read the checksums of the same apks, splits
+  // and shared libraries again and again. `zip_fd` is used if it is not -1.
+  static bool GetMultiDexChecksumCached(int zip_fd,
+                                        const std::string& location,
+                                        /*out*/ std::optional<uint32_t>* checksum,
+                                        /*out*/ std::string* error_msg,
+                                        /*out*/ bool* only_contains_uncompressed_dex);
+
  private:
   class OatFileInfo {
    public:
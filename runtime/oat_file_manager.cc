@@ -19,24 +19,29 @@
 #include <memory>
 #include <queue>
 #include <vector>
+#include <fcntl.h>
 #include <sys/stat.h>
 
 #include "android-base/file.h"
 #include "android-base/stringprintf.h"
 #include "android-base/strings.h"
 
+#include "app_info.h"
 #include "art_field-inl.h"
 #include "base/bit_vector-inl.h"
 #include "base/file_utils.h"
 #include "base/logging.h"  // For VLOG.
 #include "base/mutex-inl.h"
+#include "base/scoped_flock.h"
 #include "base/sdk_version.h"
 #include "base/stl_util.h"
 #include "base/systrace.h"
 #include "class_linker.h"
 #include "class_loader_context.h"
+#include "code_info_cache.h"
 #include "dex/art_dex_file_loader.h"
 #include "dex/dex_file-inl.h"
+#include "dex/dex_file_layout.h"
 #include "dex/dex_file_loader.h"
 #include "dex/dex_file_tracking_registrar.h"
 #include "gc/scoped_gc_critical_section.h"
@@ -50,6 +55,7 @@
 #include "oat_file.h"
 #include "oat_file_assistant.h"
 #include "obj_ptr-inl.h"
+#include "profile/profile_compilation_info.h"
 #include "runtime_image.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread-current-inl.h"
@@ -69,6 +75,10 @@ static constexpr bool kEnableAppImage = true;
 // If true, we attempt to load an app image generated by the runtime.
 static const bool kEnableRuntimeAppImage = true;
 
+// If true, we verify the classes of app dex files that were not verified at dexopt time on a
+// background thread once the first of their classes needs runtime verification.
+static constexpr bool kEnableSpeculativeVerification = true;
+
 const OatFile* OatFileManager::RegisterOatFile(std::unique_ptr<const OatFile> oat_file,
                                                bool in_memory) {
   // Use class_linker vlog to match the log for dex file registration.
@@ -103,6 +113,7 @@ void OatFileManager::UnRegisterAndDeleteOatFile(const OatFile* oat_file) {
   std::unique_ptr<const OatFile> compare(oat_file);
   auto it = oat_files_.find(compare);
   CHECK(it != oat_files_.end());
+  CodeInfoCache::InvalidateAll();
   oat_files_.erase(it);
   compare.release();  // NOLINT b/117926937
 }
@@ -174,6 +185,70 @@ bool OatFileManager::ShouldLoadAppImage() const {
   return kEnableAppImage && !runtime->IsJavaDebuggableAtInit();
 }
 
+// The state of opening the dex files of one dex location. Finding, opening and validating the
+// best oat file of the location does not need the mutator lock and is done by OpenOatFile(),
+// possibly for several locations in parallel. LoadDexFilesFromOat() does the rest.
+struct OatFileManager::OatFileLoad {
+  std::string dex_location;
+  jobject class_loader = nullptr;
+  std::unique_ptr<ClassLoaderContext> context;
+  // Set by OpenOatFile(), null if the oat file should not be looked for.
+  std::unique_ptr<OatFileAssistant> oat_file_assistant;
+  std::string odex_location;
+  std::string compilation_filter;
+  std::string compilation_reason;
+  std::string odex_status;
+  std::unique_ptr<const OatFile> oat_file;
+};
+
+bool OatFileManager::StartOatFileLoad(const char* dex_location,
+                                      jobject class_loader,
+                                      jobjectArray dex_elements,
+                                      /*out*/ OatFileLoad* load) {
+  load->dex_location = dex_location;
+  load->class_loader = class_loader;
+  load->context = ClassLoaderContext::CreateContextForClassLoader(class_loader, dex_elements);
+
+  // If the class_loader is null there's not much we can do. This happens if a dex files is loaded
+  // directly with DexFile APIs instead of using class loaders.
+  if (class_loader == nullptr) {
+    LOG(WARNING) << "Opening an oat file without a class loader. "
+                 << "Are you using the deprecated DexFile APIs?";
+    return false;
+  }
+  return load->context != nullptr;
+}
+
+void OatFileManager::OpenOatFile(OatFileLoad* load) const {
+  ScopedTrace trace(StringPrintf("%s(%s)", __FUNCTION__, load->dex_location.c_str()));
+  load->oat_file_assistant =
+      std::make_unique<OatFileAssistant>(load->dex_location.c_str(),
+                                         kRuntimeISA,
+                                         load->context.get(),
+                                         Runtime::Current()->GetOatFilesExecutable(),
+                                         only_use_system_oat_files_);
+
+  // Get the current optimization status for trace debugging.
+  // Implementation detail note: GetOptimizationStatus will select the same
+  // oat file as GetBestOatFile used below, and in doing so it already pre-populates
+  // some OatFileAssistant internal fields.
+  load->oat_file_assistant->GetOptimizationStatus(&load->odex_location,
+                                                  &load->compilation_filter,
+                                                  &load->compilation_reason,
+                                                  &load->odex_status);
+
+  load->oat_file.reset(load->oat_file_assistant->GetBestOatFile().release());
+  const OatFile* oat_file = load->oat_file.get();
+  VLOG(oat) << "OatFileAssistant(" << load->dex_location << ").GetBestOatFile()="
+            << (oat_file != nullptr ? oat_file->GetLocation() : "")
+            << " (executable=" << (oat_file != nullptr ? oat_file->IsExecutable() : false) << ")";
+
+  CHECK(oat_file == nullptr || load->odex_location == oat_file->GetLocation())
+      << "OatFileAssistant non-determinism in choosing best oat files. "
+      << "optimization-status-location=" << load->odex_location
+      << " best_oat_file-location=" << oat_file->GetLocation();
+}
+
 std::vector<std::unique_ptr<const DexFile>> OatFileManager::OpenDexFilesFromOat(
     const char* dex_location,
     jobject class_loader,
@@ -186,36 +261,86 @@ std::vector<std::unique_ptr<const DexFile>> OatFileManager::OpenDexFilesFromOat(
 
   // Verify we aren't holding the mutator lock, which could starve GC when
   // hitting the disk.
+  Locks::mutator_lock_->AssertNotHeld(Thread::Current());
+
+  OatFileLoad load;
+  if (StartOatFileLoad(dex_location, class_loader, dex_elements, &load)) {
+    OpenOatFile(&load);
+  }
+  return LoadDexFilesFromOat(&load, out_oat_file, error_msgs);
+}
+
+std::vector<std::vector<std::unique_ptr<const DexFile>>> OatFileManager::OpenDexFilesFromOat(
+    const std::vector<DexLocationToOpen>& locations,
+    /*out*/ std::vector<const OatFile*>* out_oat_files,
+    /*out*/ std::vector<std::vector<std::string>>* error_msgs) {
+  ScopedTrace trace(StringPrintf("%s(%zu locations)", __FUNCTION__, locations.size()));
+  CHECK(out_oat_files != nullptr);
+  CHECK(error_msgs != nullptr);
+
   Thread* const self = Thread::Current();
   Locks::mutator_lock_->AssertNotHeld(self);
+
+  // The class loader contexts need the mutator lock, so they are created on this thread.
+  std::vector<OatFileLoad> loads(locations.size());
+  std::vector<OatFileLoad*> loads_to_open;
+  for (size_t i = 0; i != locations.size(); ++i) {
+    CHECK(locations[i].dex_location != nullptr);
+    if (StartOatFileLoad(locations[i].dex_location,
+                         locations[i].class_loader,
+                         locations[i].dex_elements,
+                         &loads[i])) {
+      loads_to_open.push_back(&loads[i]);
+    }
+  }
+
+  // Open and validate the oat and vdex files on the runtime thread pool, which is alive while the
+  // app starts, so that the batches share its workers. Without the pool, open them here.
+  {
+    Runtime::ScopedThreadPoolUsage stpu;
+    ThreadPool* const pool = stpu.GetThreadPool();
+    const bool use_parallel = pool != nullptr && loads_to_open.size() >= 2u;
+    for (OatFileLoad* load : loads_to_open) {
+      if (use_parallel) {
+        pool->AddTask(self, new FunctionTask([this, load](Thread*) { OpenOatFile(load); }));
+      } else {
+        OpenOatFile(load);
+      }
+    }
+    if (use_parallel) {
+      ScopedTrace wait_trace("Waiting for oat file workers");
+      pool->Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ false);
+    }
+  }
+
+  // Load the dex files and register the oat files in the order of `locations`, as opening
+  // them one by one would.
+  std::vector<std::vector<std::unique_ptr<const DexFile>>> dex_files(locations.size());
+  out_oat_files->assign(locations.size(), nullptr);
+  error_msgs->assign(locations.size(), {});
+  for (size_t i = 0; i != locations.size(); ++i) {
+    dex_files[i] = LoadDexFilesFromOat(&loads[i], &(*out_oat_files)[i], &(*error_msgs)[i]);
+  }
+  return dex_files;
+}
+
+std::vector<std::unique_ptr<const DexFile>> OatFileManager::LoadDexFilesFromOat(
+    OatFileLoad* load,
+    const OatFile** out_oat_file,
+    std::vector<std::string>* error_msgs) {
+  Thread* const self = Thread::Current();
   Runtime* const runtime = Runtime::Current();
+  const char* dex_location = load->dex_location.c_str();
+  const jobject class_loader = load->class_loader;
+  const std::unique_ptr<ClassLoaderContext>& context = load->context;
+  const std::unique_ptr<OatFileAssistant>& oat_file_assistant = load->oat_file_assistant;
 
   std::vector<std::unique_ptr<const DexFile>> dex_files;
-  std::unique_ptr<ClassLoaderContext> context(
-      ClassLoaderContext::CreateContextForClassLoader(class_loader, dex_elements));
-
-  // If the class_loader is null there's not much we can do. This happens if a dex files is loaded
-  // directly with DexFile APIs instead of using class loaders.
-  if (class_loader == nullptr) {
-    LOG(WARNING) << "Opening an oat file without a class loader. "
-                 << "Are you using the deprecated DexFile APIs?";
-  } else if (context != nullptr) {
-    auto oat_file_assistant = std::make_unique<OatFileAssistant>(dex_location,
-                                                                 kRuntimeISA,
-                                                                 context.get(),
-                                                                 runtime->GetOatFilesExecutable(),
-                                                                 only_use_system_oat_files_);
-
-    // Get the current optimization status for trace debugging.
-    // Implementation detail note: GetOptimizationStatus will select the same
-    // oat file as GetBestOatFile used below, and in doing so it already pre-populates
-    // some OatFileAssistant internal fields.
-    std::string odex_location;
-    std::string compilation_filter;
-    std::string compilation_reason;
-    std::string odex_status;
-    oat_file_assistant->GetOptimizationStatus(
-        &odex_location, &compilation_filter, &compilation_reason, &odex_status);
+  if (oat_file_assistant != nullptr) {
+    const std::string& odex_location = load->odex_location;
+    std::string& compilation_filter = load->compilation_filter;
+    const std::string& compilation_reason = load->compilation_reason;
+    const std::string& odex_status = load->odex_status;
 
     ScopedTrace odex_loading(StringPrintf(
         "location=%s status=%s filter=%s reason=%s",
@@ -235,16 +360,7 @@ std::vector<std::unique_ptr<const DexFile>> OatFileManager::OpenDexFilesFromOat(
                                 code_type == AppInfo::CodeType::kSplitApk;
 
     // Proceed with oat file loading.
-    std::unique_ptr<const OatFile> oat_file(oat_file_assistant->GetBestOatFile().release());
-    VLOG(oat) << "OatFileAssistant(" << dex_location << ").GetBestOatFile()="
-              << (oat_file != nullptr ? oat_file->GetLocation() : "")
-              << " (executable=" << (oat_file != nullptr ? oat_file->IsExecutable() : false) << ")";
-
-    CHECK(oat_file == nullptr || odex_location == oat_file->GetLocation())
-        << "OatFileAssistant non-determinism in choosing best oat files. "
-        << "optimization-status-location=" << odex_location
-        << " best_oat_file-location=" << oat_file->GetLocation();
-
+    std::unique_ptr<const OatFile> oat_file = std::move(load->oat_file);
     if (oat_file != nullptr) {
       bool compilation_enabled =
           CompilerFilter::IsAotCompilationEnabled(oat_file->GetCompilerFilter());
@@ -380,6 +496,15 @@ std::vector<std::unique_ptr<const DexFile>> OatFileManager::OpenDexFilesFromOat(
       } else if (should_madvise) {
         size_t madvise_size_limit = Runtime::Current()->GetMadviseWillNeedTotalDexSize();
         for (const std::unique_ptr<const DexFile>& dex_file : dex_files) {
+          // Prefetch the parts that dexlayout placed together for the hot and startup methods
+          // and strings of the profile, wherever they are in the dex file.
+          const DexLayoutSections* layout_sections =
+              dex_file->GetOatDexFile()->GetDexLayoutSections();
+          if (layout_sections != nullptr && runtime->InJankPerceptibleProcessState()) {
+            size_t advised_bytes = layout_sections->MadviseAtLoad(*dex_file);
+            VLOG(oat) << "Madvised " << advised_bytes << " bytes of hot and startup sections of "
+                      << dex_file->GetLocation();
+          }
           // Prefetch the dex file based on vdex size limit (name should
           // have been dex size limit).
           VLOG(oat) << "Madvising dex file: " << dex_file->GetLocation();
@@ -672,19 +797,58 @@ static bool UnlinkLeastRecentlyUsedVdexIfNeeded(const std::string& vdex_path_to_
   return true;
 }
 
+// Verifies the class defined by `class_def` in `class_loader`, a global reference, unless the
+// class loader resolves its descriptor to another class. Returns whether the class is verified.
+static bool VerifyClassInBackground(Thread* self,
+                                    jobject class_loader,
+                                    const DexFile* dex_file,
+                                    const dex::ClassDef& class_def,
+                                    verifier::VerifierDeps* verifier_deps) {
+  ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
+
+  // Take handles for each class. The background verification is low priority
+  // and we want to minimize the risk of blocking anyone else.
+  ScopedObjectAccess soa(self);
+  StackHandleScope<2> hs(self);
+  Handle<mirror::ClassLoader> h_loader(hs.NewHandle(
+      soa.Decode<mirror::ClassLoader>(class_loader)));
+  Handle<mirror::Class> h_class(hs.NewHandle<mirror::Class>(class_linker->FindClass(
+      self,
+      dex_file->GetClassDescriptor(class_def),
+      h_loader)));
+
+  if (h_class == nullptr) {
+    DCHECK(self->IsExceptionPending());
+    self->ClearException();
+    return false;
+  }
+
+  if (&h_class->GetDexFile() != dex_file) {
+    // There is a different class in the class path or a parent class loader
+    // with the same descriptor. This `h_class` is not resolvable, skip it.
+    return false;
+  }
+
+  DCHECK(h_class->IsResolved()) << h_class->PrettyDescriptor();
+  class_linker->VerifyClass(self, verifier_deps, h_class);
+  if (self->IsExceptionPending()) {
+    // ClassLinker::VerifyClass can throw, but the exception isn't useful here.
+    self->ClearException();
+  }
+
+  DCHECK(h_class->IsVerified() || h_class->IsErroneous())
+      << h_class->PrettyDescriptor() << ": state=" << h_class->GetStatus();
+  return h_class->IsVerified();
+}
+
 class BackgroundVerificationTask final : public Task {
  public:
   BackgroundVerificationTask(const std::vector<const DexFile*>& dex_files,
                              jobject class_loader,
                              const std::string& vdex_path)
       : dex_files_(dex_files),
-        vdex_path_(vdex_path) {
-    Thread* const self = Thread::Current();
-    ScopedObjectAccess soa(self);
-    // Create a global ref for `class_loader` because it will be accessed from a different thread.
-    class_loader_ = soa.Vm()->AddGlobalRef(self, soa.Decode<mirror::ClassLoader>(class_loader));
-    CHECK(class_loader_ != nullptr);
-  }
+        class_loader_(class_loader),
+        vdex_path_(vdex_path) {}
 
   ~BackgroundVerificationTask() {
     Thread* const self = Thread::Current();
@@ -694,48 +858,13 @@ class BackgroundVerificationTask final : public Task {
 
   void Run(Thread* self) override {
     std::string error_msg;
-    ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
     verifier::VerifierDeps verifier_deps(dex_files_);
 
     // Iterate over all classes and verify them.
     for (const DexFile* dex_file : dex_files_) {
       for (uint32_t cdef_idx = 0; cdef_idx < dex_file->NumClassDefs(); cdef_idx++) {
         const dex::ClassDef& class_def = dex_file->GetClassDef(cdef_idx);
-
-        // Take handles inside the loop. The background verification is low priority
-        // and we want to minimize the risk of blocking anyone else.
-        ScopedObjectAccess soa(self);
-        StackHandleScope<2> hs(self);
-        Handle<mirror::ClassLoader> h_loader(hs.NewHandle(
-            soa.Decode<mirror::ClassLoader>(class_loader_)));
-        Handle<mirror::Class> h_class(hs.NewHandle<mirror::Class>(class_linker->FindClass(
-            self,
-            dex_file->GetClassDescriptor(class_def),
-            h_loader)));
-
-        if (h_class == nullptr) {
-          DCHECK(self->IsExceptionPending());
-          self->ClearException();
-          continue;
-        }
-
-        if (&h_class->GetDexFile() != dex_file) {
-          // There is a different class in the class path or a parent class loader
-          // with the same descriptor. This `h_class` is not resolvable, skip it.
-          continue;
-        }
-
-        DCHECK(h_class->IsResolved()) << h_class->PrettyDescriptor();
-        class_linker->VerifyClass(self, &verifier_deps, h_class);
-        if (self->IsExceptionPending()) {
-          // ClassLinker::VerifyClass can throw, but the exception isn't useful here.
-          self->ClearException();
-        }
-
-        DCHECK(h_class->IsVerified() || h_class->IsErroneous())
-            << h_class->PrettyDescriptor() << ": state=" << h_class->GetStatus();
-
-        if (h_class->IsVerified()) {
+        if (VerifyClassInBackground(self, class_loader_, dex_file, class_def, &verifier_deps)) {
           verifier_deps.RecordClassVerified(*dex_file, class_def);
         }
       }
@@ -763,22 +892,113 @@ class BackgroundVerificationTask final : public Task {
 
  private:
   const std::vector<const DexFile*> dex_files_;
-  jobject class_loader_;
+  // Global reference, owned by the task.
+  const jobject class_loader_;
   const std::string vdex_path_;
 
   DISALLOW_COPY_AND_ASSIGN(BackgroundVerificationTask);
 };
 
-void OatFileManager::RunBackgroundVerification(const std::vector<const DexFile*>& dex_files,
-                                               jobject class_loader) {
+// Verifies classes of a dex file that was not verified at dexopt time before they are used, so
+// that the threads using them don't need to. The classes listed in the reference profile of the
+// app are verified, or all classes in class def order if the profile doesn't list any.
+class SpeculativeVerificationTask final : public Task {
+ public:
+  SpeculativeVerificationTask(const DexFile* dex_file, jobject class_loader)
+      : dex_file_(dex_file),
+        class_loader_(class_loader) {}
+
+  ~SpeculativeVerificationTask() {
+    Thread* const self = Thread::Current();
+    ScopedObjectAccess soa(self);
+    soa.Vm()->DeleteGlobalRef(self, class_loader_);
+  }
+
+  void Run(Thread* self) override {
+    ScopedTrace trace("Speculative verification of " + dex_file_->GetLocation());
+    std::vector<const dex::ClassDef*> class_defs = GetProfileClassDefs();
+    if (class_defs.empty()) {
+      for (uint32_t cdef_idx = 0; cdef_idx < dex_file_->NumClassDefs(); cdef_idx++) {
+        class_defs.push_back(&dex_file_->GetClassDef(cdef_idx));
+      }
+    }
+
+    size_t num_verified = 0;
+    for (const dex::ClassDef* class_def : class_defs) {
+      if (Runtime::Current()->IsShuttingDown(self)) {
+        return;
+      }
+      if (VerifyClassInBackground(
+              self, class_loader_, dex_file_, *class_def, /*verifier_deps=*/ nullptr)) {
+        ++num_verified;
+      }
+    }
+    VLOG(verifier) << "Speculatively verified " << num_verified << " of " << class_defs.size()
+                   << " classes of " << dex_file_->GetLocation();
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  std::vector<const dex::ClassDef*> GetProfileClassDefs() {
+    std::vector<const dex::ClassDef*> class_defs;
+    std::string profile_file = Runtime::Current()->GetAppInfo()->GetPrimaryApkReferenceProfile();
+    if (profile_file.empty()) {
+      return class_defs;
+    }
+
+    // Lock the file, it could be concurrently updated by the system. Don't block,
+    // verifying all classes is fine.
+    std::string error;
+    ScopedFlock profile =
+        LockedFile::Open(profile_file.c_str(), O_RDONLY, /*block=*/false, &error);
+    if (profile == nullptr) {
+      VLOG(verifier) << "Couldn't lock the profile file " << profile_file << ": " << error;
+      return class_defs;
+    }
+
+    ProfileCompilationInfo profile_info(/* for_boot_image= */ false);
+    if (!profile_info.Load(profile->Fd())) {
+      VLOG(verifier) << "Could not load profile file " << profile_file;
+      return class_defs;
+    }
+
+    // The profile does not reference the dex file if it has no classes or methods of it,
+    // which is the case for dex files of other APKs.
+    const ArenaSet<dex::TypeIndex>* class_types = profile_info.GetClasses(*dex_file_);
+    if (class_types == nullptr) {
+      return class_defs;
+    }
+    for (dex::TypeIndex idx : *class_types) {
+      // The index is greater or equal to NumTypeIds if the type is an extra
+      // descriptor, not referenced by the dex file.
+      if (idx.index_ < dex_file_->NumTypeIds()) {
+        const dex::ClassDef* class_def = dex_file_->FindClassDef(idx);
+        if (class_def != nullptr) {
+          class_defs.push_back(class_def);
+        }
+      }
+    }
+    return class_defs;
+  }
+
+  const DexFile* const dex_file_;
+  // Global reference, owned by the task.
+  const jobject class_loader_;
+
+  DISALLOW_COPY_AND_ASSIGN(SpeculativeVerificationTask);
+};
+
+bool OatFileManager::CanVerifyInBackground(Thread* self, jobject class_loader) {
   Runtime* const runtime = Runtime::Current();
-  Thread* const self = Thread::Current();
 
   if (runtime->IsJavaDebuggable()) {
     // Threads created by ThreadPool ("runtime threads") are not allowed to load
     // classes when debuggable to match class-initialization semantics
     // expectations. Do not verify in the background.
-    return;
+    return false;
   }
 
   {
@@ -791,17 +1011,38 @@ void OatFileManager::RunBackgroundVerification(const std::vector<const DexFile*>
       // chain. Because the background verification runs on runtime threads,
       // which do not call Java, we won't be able to load classes when
       // verifying, which is something the current verifier relies on.
-      return;
+      return false;
     }
   }
 
   if (!IsSdkVersionSetAndAtLeast(runtime->GetTargetSdkVersion(), SdkVersion::kQ)) {
     // Do not run for legacy apps as they may depend on the previous class loader behaviour.
-    return;
+    return false;
   }
 
   if (runtime->IsShuttingDown(self)) {
     // Not allowed to create new threads during runtime shutdown.
+    return false;
+  }
+
+  return true;
+}
+
+ThreadPool* OatFileManager::GetOrCreateVerificationThreadPool(Thread* self) {
+  WriterMutexLock mu(self, *Locks::oat_file_manager_lock_);
+  if (verification_thread_pool_ == nullptr) {
+    verification_thread_pool_.reset(
+        new ThreadPool("Verification thread pool", /* num_threads= */ 1));
+    verification_thread_pool_->StartWorkers(self);
+  }
+  return verification_thread_pool_.get();
+}
+
+void OatFileManager::RunBackgroundVerification(const std::vector<const DexFile*>& dex_files,
+                                               jobject class_loader) {
+  Thread* const self = Thread::Current();
+
+  if (!CanVerifyInBackground(self, class_loader)) {
     return;
   }
 
@@ -836,18 +1077,57 @@ void OatFileManager::RunBackgroundVerification(const std::vector<const DexFile*>
 
   {
     WriterMutexLock mu(self, *Locks::oat_file_manager_lock_);
-    if (verification_thread_pool_ == nullptr) {
-      verification_thread_pool_.reset(
-          new ThreadPool("Verification thread pool", /* num_threads= */ 1));
-      verification_thread_pool_->StartWorkers(self);
-    }
+    // There is no need to verify these dex files speculatively.
+    background_verified_dex_files_.insert(dex_files.begin(), dex_files.end());
   }
-  verification_thread_pool_->AddTask(self, new BackgroundVerificationTask(
+  jobject global_class_loader;
+  {
+    // Create a global ref for `class_loader` because it will be accessed from a different thread.
+    ScopedObjectAccess soa(self);
+    global_class_loader =
+        soa.Vm()->AddGlobalRef(self, soa.Decode<mirror::ClassLoader>(class_loader));
+    CHECK(global_class_loader != nullptr);
+  }
+  GetOrCreateVerificationThreadPool(self)->AddTask(self, new BackgroundVerificationTask(
       dex_files,
-      class_loader,
+      global_class_loader,
       GetVdexFilename(odex_filename)));
 }
 
+void OatFileManager::RunSpeculativeVerification(Thread* self,
+                                                const DexFile& dex_file,
+                                                ObjPtr<mirror::ClassLoader> class_loader) {
+  if (!kEnableSpeculativeVerification || class_loader == nullptr) {
+    // Boot class path dex files are verified when the boot image is compiled.
+    return;
+  }
+  const OatDexFile* oat_dex_file = dex_file.GetOatDexFile();
+  if (oat_dex_file != nullptr &&
+      oat_dex_file->GetOatFile() != nullptr &&
+      CompilerFilter::IsVerificationEnabled(oat_dex_file->GetOatFile()->GetCompilerFilter())) {
+    // The classes that failed verification at dexopt time are verified as they are used, most
+    // classes should not need runtime verification.
+    return;
+  }
+  {
+    WriterMutexLock mu(self, *Locks::oat_file_manager_lock_);
+    if (!background_verified_dex_files_.insert(&dex_file).second) {
+      return;
+    }
+  }
+
+  // Create a global ref for `class_loader` because it will be accessed from a different thread.
+  jobject global_class_loader = self->GetJniEnv()->GetVm()->AddGlobalRef(self, class_loader);
+  CHECK(global_class_loader != nullptr);
+  if (!CanVerifyInBackground(self, global_class_loader)) {
+    self->GetJniEnv()->GetVm()->DeleteGlobalRef(self, global_class_loader);
+    return;
+  }
+  VLOG(verifier) << "Starting speculative verification of " << dex_file.GetLocation();
+  GetOrCreateVerificationThreadPool(self)->AddTask(
+      self, new SpeculativeVerificationTask(&dex_file, global_class_loader));
+}
+
 void OatFileManager::WaitForWorkersToBeCreated() {
   DCHECK(!Runtime::Current()->IsShuttingDown(Thread::Current()))
       << "Cannot create new threads during runtime shutdown";
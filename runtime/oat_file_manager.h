@@ -27,6 +27,7 @@
 #include "base/locks.h"
 #include "base/macros.h"
 #include "jni.h"
+#include "obj_ptr.h"
 
 namespace art {
 
@@ -36,10 +37,15 @@ class ImageSpace;
 }  // namespace space
 }  // namespace gc
 
+namespace mirror {
+class ClassLoader;
+}  // namespace mirror
+
 class ClassLoaderContext;
 class DexFile;
 class MemMap;
 class OatFile;
+class Thread;
 class ThreadPool;
 
 // Class for dealing with oat file management.
@@ -101,6 +107,26 @@ class OatFileManager {
       /*out*/ std::vector<std::string>* error_msgs)
       REQUIRES(!Locks::oat_file_manager_lock_, !Locks::mutator_lock_);
 
+  // A dex location to open with the batch version of OpenDexFilesFromOat(), with the class
+  // loader and dex elements that the single location version takes.
+  struct DexLocationToOpen {
+    const char* dex_location;
+    jobject class_loader;
+    jobjectArray dex_elements;
+  };
+
+  // Like calling the version above for each of `locations` in order, except that the oat and
+  // vdex files of the locations are opened and validated in parallel on the runtime thread pool,
+  // when it exists. The dex files and oat files are still loaded and registered in the order of
+  // `locations`. As each location gets the class loader context of its own `dex_elements`,
+  // locations whose contexts contain each other, like the splits of one PathClassLoader, must
+  // not be in the same batch. The results and `error_msgs` are indexed like `locations`.
+  std::vector<std::vector<std::unique_ptr<const DexFile>>> OpenDexFilesFromOat(
+      const std::vector<DexLocationToOpen>& locations,
+      /*out*/ std::vector<const OatFile*>* out_oat_files,
+      /*out*/ std::vector<std::vector<std::string>>* error_msgs)
+      REQUIRES(!Locks::oat_file_manager_lock_, !Locks::mutator_lock_);
+
   // Opens dex files provided in `dex_mem_maps` and attempts to find an anonymous
   // vdex file created during a previous load attempt. If found, will initialize
   // an instance of OatFile to back the DexFiles and preverify them using the
@@ -127,6 +153,15 @@ class OatFileManager {
   void RunBackgroundVerification(const std::vector<const DexFile*>& dex_files,
                                  jobject class_loader);
 
+  // Called when a class of `dex_file` in `class_loader` was not verified at dexopt time and is
+  // being verified. If `dex_file` was not verified at dexopt time, spawns a background thread
+  // which verifies the classes of `dex_file` that the reference profile lists, or all of its
+  // classes if there's no profile for it, before they are used. Does so at most once per dex file.
+  void RunSpeculativeVerification(Thread* self,
+                                  const DexFile& dex_file,
+                                  ObjPtr<mirror::ClassLoader> class_loader)
+      REQUIRES(!Locks::oat_file_manager_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Wait for thread pool workers to be created. This is used during shutdown as
   // threads are not allowed to attach while runtime is in shutdown lock.
   void WaitForWorkersToBeCreated();
@@ -154,12 +189,42 @@ class OatFileManager {
       /*out*/ std::vector<std::string>* error_msgs)
       REQUIRES(!Locks::oat_file_manager_lock_, !Locks::mutator_lock_);
 
+  struct OatFileLoad;
+
+  // Creates the class loader context of `load`. Returns whether the oat file of `dex_location`
+  // should be opened with OpenOatFile().
+  static bool StartOatFileLoad(const char* dex_location,
+                               jobject class_loader,
+                               jobjectArray dex_elements,
+                               /*out*/ OatFileLoad* load)
+      REQUIRES(!Locks::mutator_lock_);
+
+  // Finds, opens and validates the best oat file of `load`, without registering it. Can run on
+  // any thread, concurrently with other loads.
+  void OpenOatFile(OatFileLoad* load) const REQUIRES(!Locks::mutator_lock_);
+
+  // Loads the dex files of `load` from the oat file that OpenOatFile() found, or from the dex
+  // location itself, and registers the oat file.
+  std::vector<std::unique_ptr<const DexFile>> LoadDexFilesFromOat(
+      OatFileLoad* load,
+      /*out*/ const OatFile** out_oat_file,
+      /*out*/ std::vector<std::string>* error_msgs)
+      REQUIRES(!Locks::oat_file_manager_lock_, !Locks::mutator_lock_);
+
   const OatFile* FindOpenedOatFileFromOatLocationLocked(const std::string& oat_location) const
       REQUIRES(Locks::oat_file_manager_lock_);
 
   // Return true if we should attempt to load the app image.
   bool ShouldLoadAppImage() const;
 
+  // Returns whether classes of dex files in `class_loader`, a global reference, can be verified
+  // on a background thread.
+  static bool CanVerifyInBackground(Thread* self, jobject class_loader);
+
+  // Returns the thread pool for background verification, creating it if needed.
+  ThreadPool* GetOrCreateVerificationThreadPool(Thread* self)
+      REQUIRES(!Locks::oat_file_manager_lock_);
+
   std::set<std::unique_ptr<const OatFile>> oat_files_ GUARDED_BY(Locks::oat_file_manager_lock_);
 
   // Only use the compiled code in an OAT file when the file is on /system. If the OAT file
@@ -169,6 +234,10 @@ class OatFileManager {
   // Single-thread pool used to run the verifier in the background.
   std::unique_ptr<ThreadPool> verification_thread_pool_;
 
+  // Dex files whose classes were or are being verified in the background.
+  std::set<const DexFile*> background_verified_dex_files_
+      GUARDED_BY(Locks::oat_file_manager_lock_);
+
   DISALLOW_COPY_AND_ASSIGN(OatFileManager);
 };
 
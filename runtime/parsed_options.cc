@@ -230,6 +230,8 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
           .IntoKey(M::DumpRegionInfoBeforeGC)
       .Define("-XX:DumpRegionInfoAfterGC")
           .IntoKey(M::DumpRegionInfoAfterGC)
+      .Define("-XX:DumpDuplicateStringsAfterGC")
+          .IntoKey(M::DumpDuplicateStringsAfterGC)
       .Define("-XX:DumpJITInfoOnShutdown")
           .IntoKey(M::DumpJITInfoOnShutdown)
       .Define("-XX:IgnoreMaxFootprint")
@@ -242,6 +244,17 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-XX:UseTLAB")
           .WithValue(true)
           .IntoKey(M::UseTLAB)
+      .Define("-XX:HeapHugePages:_")
+          .WithHelp("Back the moving heap spaces with transparent huge pages. Defaults to 'false'")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::HeapHugePages)
+      .Define("-XX:AsyncNativeAllocationChecks:_")
+          .WithHelp("Check whether native allocations need a GC on the heap task thread, so that"
+                    " registering native allocations does not call mallinfo(). Defaults to 'false'")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::AsyncNativeAllocationChecks)
       .Define({"-XX:EnableHSpaceCompactForOOM", "-XX:DisableHSpaceCompactForOOM"})
           .WithValues({true, false})
           .IntoKey(M::EnableHSpaceCompactForOOM)
@@ -271,6 +284,10 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
           .WithType<bool>()
           .WithValueMap({{"false", false}, {"true", true}})
           .IntoKey(M::UseProfiledJitCompilation)
+      .Define("-Xjitprecompilefromprofile:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::JITPrecompileFromProfile)
       .Define("-Xjitinitialsize:_")
           .WithType<MemoryKiB>()
           .IntoKey(M::JITCodeCacheInitialCapacity)
@@ -292,6 +309,17 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xjitzygotepthreadpriority:_")
           .WithType<int>()
           .IntoKey(M::JITZygotePoolThreadPthreadPriority)
+      .Define("-Xjitcpubudget:_")
+          .WithType<unsigned int>()
+          .WithRange(0, 100)
+          .IntoKey(M::JITCpuBudget)
+      .Define("-Xjitzygotesharedprofile:_")
+          .WithType<std::string>()
+          .IntoKey(M::JITZygoteSharedProfile)
+      .Define("-Xjitpretenure:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::JITPretenureAllocationSites)
       .Define("-Xjitsaveprofilinginfo")
           .WithType<ProfileSaverOptions>()
           .AppendValues()
@@ -331,7 +359,8 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
           .WithType<gc::space::LargeObjectSpaceType>()
           .WithValueMap({{"disabled", gc::space::LargeObjectSpaceType::kDisabled},
                          {"freelist", gc::space::LargeObjectSpaceType::kFreeList},
-                         {"map",      gc::space::LargeObjectSpaceType::kMap}})
+                         {"map",      gc::space::LargeObjectSpaceType::kMap},
+                         {"hugepagemap", gc::space::LargeObjectSpaceType::kHugePageMap}})
           .IntoKey(M::LargeObjectSpace)
       .Define("-XX:LargeObjectThreshold=_")
           .WithType<Memory<1>>()
@@ -387,6 +416,9 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xzygote-max-boot-retry=_")
           .WithType<unsigned int>()
           .IntoKey(M::ZygoteMaxFailedBoots)
+      .Define("-Xzygote-dirty-objects:_")
+          .WithType<std::string>()
+          .IntoKey(M::ZygoteDirtyObjects)
       .Define("-Xno-sig-chain")
           .IntoKey(M::NoSigChain)
       .Define("--cpu-abilist=_")
@@ -395,6 +427,15 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xfingerprint:_")
           .WithType<std::string>()
           .IntoKey(M::Fingerprint)
+      .Define("-Xpost-fork-warmup-profile:_")
+          .WithType<std::string>()
+          .IntoKey(M::PostForkWarmupProfile)
+      .Define("-XX:BackgroundStartupClassInit:_")
+          .WithHelp("Load the startup classes of the app profile on a background thread and"
+                    " initialize the ones without class initializers. Defaults to 'false'")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::BackgroundStartupClassInit)
       .Define("-Xexperimental:_")
           .WithType<ExperimentalFlags>()
           .AppendValues()
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "post_fork_warmup_task.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <optional>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "base/bit_utils.h"
+#include "base/logging.h"  // For VLOG.
+#include "base/systrace.h"
+#include "base/time_utils.h"
+#include "base/unix_file/fd_file.h"
+#include "base/utils.h"
+#include "class_linker.h"
+#include "dex/class_accessor-inl.h"
+#include "dex/dex_file.h"
+#include "oat_file-inl.h"
+#include "profile/profile_boot_info.h"
+#include "runtime.h"
+
+namespace art {
+
+// Adds the page range of the dex code item and of the compiled code of each method of
+// `dex_file` in `method_indexes` to `ranges`.
+static void AddMethodRanges(const DexFile& dex_file,
+                            const std::unordered_set<uint32_t>& method_indexes,
+                            /*inout*/ std::vector<std::pair<uintptr_t, uintptr_t>>* ranges) {
+  const OatDexFile* oat_dex_file = dex_file.GetOatDexFile();
+  for (ClassAccessor accessor : dex_file.GetClasses()) {
+    std::optional<OatFile::OatClass> oat_class;
+    // The index of the method in the class, in the order of the OatMethodOffsets.
+    uint32_t class_method_index = 0u;
+    for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+      uint32_t index = class_method_index++;
+      if (method_indexes.find(method.GetIndex()) == method_indexes.end()) {
+        continue;
+      }
+      const dex::CodeItem* code_item = dex_file.GetCodeItem(method.GetCodeItemOffset());
+      if (code_item != nullptr) {
+        uintptr_t begin = reinterpret_cast<uintptr_t>(code_item);
+        ranges->emplace_back(begin, begin + dex_file.GetCodeItemSize(*code_item));
+      }
+      if (oat_dex_file == nullptr) {
+        continue;
+      }
+      if (!oat_class.has_value()) {
+        oat_class.emplace(oat_dex_file->GetOatClass(accessor.GetClassDefIndex()));
+      }
+      const OatFile::OatMethod oat_method = oat_class->GetOatMethod(index);
+      const void* code = oat_method.GetQuickCode();
+      if (code != nullptr) {
+        // Include the OatQuickMethodHeader before the code.
+        ranges->emplace_back(reinterpret_cast<uintptr_t>(oat_method.GetOatQuickMethodHeader()),
+                             reinterpret_cast<uintptr_t>(code) + oat_method.GetQuickCodeSize());
+      }
+    }
+  }
+}
+
+void PostForkWarmupTask::Run([[maybe_unused]] Thread* self) {
+  ScopedTrace trace("Post-fork warmup");
+  const uint64_t start_ns = NanoTime();
+  unix_file::FdFile profile(profile_file_, O_RDONLY, /*check_usage=*/ false);
+  if (profile.Fd() == -1) {
+    PLOG(WARNING) << "No post-fork warmup profile: " << profile_file_;
+    return;
+  }
+  ProfileBootInfo profile_info;
+  if (!profile_info.Load(profile.Fd(), Runtime::Current()->GetClassLinker()->GetBootClassPath())) {
+    LOG(WARNING) << "Could not load the post-fork warmup profile " << profile_file_;
+    return;
+  }
+
+  const std::vector<const DexFile*>& dex_files = profile_info.GetDexFiles();
+  std::vector<std::unordered_set<uint32_t>> method_indexes(dex_files.size());
+  for (const std::pair<uint32_t, uint32_t>& method : profile_info.GetMethods()) {
+    if (method.first < dex_files.size()) {
+      method_indexes[method.first].insert(method.second);
+    }
+  }
+  std::vector<std::pair<uintptr_t, uintptr_t>> ranges;
+  for (size_t i = 0; i != dex_files.size(); ++i) {
+    if (!method_indexes[i].empty()) {
+      AddMethodRanges(*dex_files[i], method_indexes[i], &ranges);
+    }
+  }
+
+  // Round the ranges to pages and merge them, so that each page is advised once and neighbouring
+  // methods result in one larger read.
+  for (std::pair<uintptr_t, uintptr_t>& range : ranges) {
+    range.first = RoundDown(range.first, kPageSize);
+    range.second = RoundUp(range.second, kPageSize);
+  }
+  std::sort(ranges.begin(), ranges.end());
+  size_t advised_ranges = 0u;
+  size_t advised_bytes = 0u;
+  for (size_t i = 0; i != ranges.size(); ) {
+    uintptr_t begin = ranges[i].first;
+    uintptr_t end = ranges[i].second;
+    for (++i; i != ranges.size() && ranges[i].first <= end; ++i) {
+      end = std::max(end, ranges[i].second);
+    }
+    // Failures are expected for ranges that are not file mappings and do not matter.
+    if (madvise(reinterpret_cast<void*>(begin), end - begin, MADV_WILLNEED) == 0) {
+      ++advised_ranges;
+      advised_bytes += end - begin;
+    }
+  }
+  VLOG(startup) << "Post-fork warmup advised " << PrettySize(advised_bytes) << " in "
+                << advised_ranges << " ranges for " << profile_info.GetMethods().size()
+                << " methods in " << PrettyDuration(NanoTime() - start_ns);
+}
+
+}  // namespace art
@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_POST_FORK_WARMUP_TASK_H_
+#define ART_RUNTIME_POST_FORK_WARMUP_TASK_H_
+
+#include <string>
+
+#include "thread_pool.h"
+
+namespace art {
+
+class Thread;
+
+// Runs once in the runtime thread pool of a forked app. It reads a boot profile of the boot
+// class path, as created by `profman --output-profile-type=bprof`, and issues
+// madvise(MADV_WILLNEED) for the dex code items and the compiled code of the profiled methods.
+// The page faults of the first frames of the app then hit the page cache.
+// See -Xpost-fork-warmup-profile:.
+class PostForkWarmupTask : public SelfDeletingTask {
+ public:
+  explicit PostForkWarmupTask(const std::string& profile_file) : profile_file_(profile_file) {}
+
+  void Run(Thread* self) override;
+
+ private:
+  const std::string profile_file_;
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_POST_FORK_WARMUP_TASK_H_
@@ -17,8 +17,10 @@
 #include "quick_exception_handler.h"
 
 #include <ios>
+#include <map>
 #include <queue>
 #include <sstream>
+#include <tuple>
 
 #include "arch/context.h"
 #include "art_method-inl.h"
@@ -27,6 +29,7 @@
 #include "base/globals.h"
 #include "base/logging.h"  // For VLOG_IS_ON.
 #include "base/systrace.h"
+#include "dex/code_item_accessors-inl.h"
 #include "dex/dex_file_types.h"
 #include "dex/dex_instruction.h"
 #include "entrypoints/entrypoint_utils.h"
@@ -122,8 +125,13 @@ class CatchBlockStackVisitor final : public StackVisitor {
  private:
   bool HandleTryItems(ArtMethod* method)
       REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (method->IsNative()) {
+      return true;  // Continue stack walk.
+    }
+    // Decoding the dex pc of a compiled frame needs a stack map lookup, only do it for
+    // methods that have try items. The others cannot catch the exception.
     uint32_t dex_pc = dex::kDexNoIndex;
-    if (!method->IsNative()) {
+    if (CodeItemDataAccessor(method->DexInstructionData()).TriesSize() != 0) {
       dex_pc = GetDexPc();
     }
     if (dex_pc != dex::kDexNoIndex) {
@@ -142,15 +150,16 @@ class CatchBlockStackVisitor final : public StackVisitor {
         exception_handler_->SetHandlerQuickFrame(GetCurrentQuickFrame());
         exception_handler_->SetHandlerMethodHeader(GetCurrentOatQuickMethodHeader());
         return false;  // End stack walk.
-      } else if (UNLIKELY(GetThread()->HasDebuggerShadowFrames())) {
-        // We are going to unwind this frame. Did we prepare a shadow frame for debugging?
-        size_t frame_id = GetFrameId();
-        ShadowFrame* frame = GetThread()->FindDebuggerShadowFrame(frame_id);
-        if (frame != nullptr) {
-          // We will not execute this shadow frame so we can safely deallocate it.
-          GetThread()->RemoveDebuggerShadowFrameMapping(frame_id);
-          ShadowFrame::DeleteDeoptimizedFrame(frame);
-        }
+      }
+    }
+    if (UNLIKELY(GetThread()->HasDebuggerShadowFrames())) {
+      // We are going to unwind this frame. Did we prepare a shadow frame for debugging?
+      size_t frame_id = GetFrameId();
+      ShadowFrame* frame = GetThread()->FindDebuggerShadowFrame(frame_id);
+      if (frame != nullptr) {
+        // We will not execute this shadow frame so we can safely deallocate it.
+        GetThread()->RemoveDebuggerShadowFrameMapping(frame_id);
+        ShadowFrame::DeleteDeoptimizedFrame(frame);
       }
     }
     return true;  // Continue stack walk.
@@ -554,16 +563,14 @@ class DeoptimizeStackVisitor final : public StackVisitor {
                                       const bool* updated_vregs)
       REQUIRES_SHARED(Locks::mutator_lock_) {
     const OatQuickMethodHeader* method_header = GetCurrentOatQuickMethodHeader();
-    CodeInfo code_info(method_header);
+    const CodeInfo& code_info = GetCodeInfo(method_header);
     uintptr_t native_pc_offset = method_header->NativeQuickPcOffset(GetCurrentQuickFramePc());
     StackMap stack_map = code_info.GetStackMapForNativePcOffset(native_pc_offset);
     CodeItemDataAccessor accessor(m->DexInstructionData());
     const size_t number_of_vregs = accessor.RegistersSize();
     uint32_t register_mask = code_info.GetRegisterMaskOf(stack_map);
     BitMemoryRegion stack_mask = code_info.GetStackMaskOf(stack_map);
-    DexRegisterMap vreg_map = IsInInlinedFrame()
-        ? code_info.GetInlineDexRegisterMapOf(stack_map, GetCurrentInlinedFrame())
-        : code_info.GetDexRegisterMapOf(stack_map);
+    const DexRegisterMap& vreg_map = GetDexRegisterMap(method_header, code_info, stack_map);
 
     if (kIsDebugBuild || UNLIKELY(Runtime::Current()->IsJavaDebuggable())) {
       CHECK_EQ(vreg_map.size(), number_of_vregs) << *Thread::Current()
@@ -635,6 +642,35 @@ class DeoptimizeStackVisitor final : public StackVisitor {
     }
   }
 
+  // Deoptimizing a stack often meets the same compiled code several times, for the inlined frames
+  // of a physical frame and for recursive calls. Decode its code info and the dex register maps of
+  // its deoptimization points only once per stack walk.
+  const CodeInfo& GetCodeInfo(const OatQuickMethodHeader* method_header) {
+    auto it = code_infos_.find(method_header);
+    if (it == code_infos_.end()) {
+      it = code_infos_.emplace(method_header, CodeInfo(method_header)).first;
+    }
+    return it->second;
+  }
+
+  const DexRegisterMap& GetDexRegisterMap(const OatQuickMethodHeader* method_header,
+                                          const CodeInfo& code_info,
+                                          StackMap stack_map)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    uint32_t inline_info_row = IsInInlinedFrame() ? GetCurrentInlinedFrame().Row()
+                                                  : StackMap::kNoValue;
+    auto key = std::make_tuple(method_header, stack_map.Row(), inline_info_row);
+    auto it = vreg_maps_.find(key);
+    if (it == vreg_maps_.end()) {
+      it = vreg_maps_.emplace(key,
+                              IsInInlinedFrame()
+                                  ? code_info.GetInlineDexRegisterMapOf(stack_map,
+                                                                        GetCurrentInlinedFrame())
+                                  : code_info.GetDexRegisterMapOf(stack_map)).first;
+    }
+    return it->second;
+  }
+
   static VRegKind GetVRegKind(uint16_t reg, const std::vector<int32_t>& kinds) {
     return static_cast<VRegKind>(kinds[reg * 2]);
   }
@@ -651,6 +687,10 @@ class DeoptimizeStackVisitor final : public StackVisitor {
   // a deopt after running method exit callbacks if the callback throws or requests events that
   // need a deopt.
   bool skip_method_exit_callbacks_;
+  // Decoded code info and dex register maps of the compiled frames deoptimized so far, see
+  // `GetCodeInfo()`. Dex register maps are keyed by stack map row and inline info row.
+  std::map<const OatQuickMethodHeader*, CodeInfo> code_infos_;
+  std::map<std::tuple<const OatQuickMethodHeader*, uint32_t, uint32_t>, DexRegisterMap> vreg_maps_;
 
   DISALLOW_COPY_AND_ASSIGN(DeoptimizeStackVisitor);
 };
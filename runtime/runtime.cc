@@ -40,6 +40,7 @@
 #include <unordered_set>
 #include <vector>
 
+#include "android-base/file.h"
 #include "android-base/strings.h"
 
 #include "aot_class_linker.h"
@@ -68,6 +69,7 @@
 #include "base/sdk_version.h"
 #include "base/stl_util.h"
 #include "base/systrace.h"
+#include "base/timing_logger.h"
 #include "base/unix_file/fd_file.h"
 #include "base/utils.h"
 #include "class_linker-inl.h"
@@ -82,6 +84,7 @@
 #include "experimental_flags.h"
 #include "fault_handler.h"
 #include "gc/accounting/card_table-inl.h"
+#include "gc/allocation_site_sampler.h"
 #include "gc/heap.h"
 #include "gc/scoped_gc_critical_section.h"
 #include "gc/space/image_space.h"
@@ -119,6 +122,7 @@
 #include "mirror/throwable.h"
 #include "mirror/var_handle.h"
 #include "monitor.h"
+#include "monitor_contention_profile.h"
 #include "native/dalvik_system_DexFile.h"
 #include "native/dalvik_system_BaseDexClassLoader.h"
 #include "native/dalvik_system_VMDebug.h"
@@ -162,6 +166,7 @@
 #include "object_callbacks.h"
 #include "odr_statslog/odr_statslog.h"
 #include "parsed_options.h"
+#include "post_fork_warmup_task.h"
 #include "quick/quick_method_frame_info.h"
 #include "reflection.h"
 #include "runtime_callbacks.h"
@@ -173,6 +178,8 @@
 #include "sigchain.h"
 #include "signal_catcher.h"
 #include "signal_set.h"
+#include "startup_class_init_task.h"
+#include "thin_lock_hash_codes.h"
 #include "thread.h"
 #include "thread_list.h"
 #include "ti/agent.h"
@@ -205,6 +212,9 @@ static constexpr double kLowMemoryMinLoadFactor = 0.5;
 static constexpr double kLowMemoryMaxLoadFactor = 0.8;
 static constexpr double kNormalMinLoadFactor = 0.4;
 static constexpr double kNormalMaxLoadFactor = 0.7;
+// Free JIT arenas kept resident when trimming after a compilation, enough for compiling most
+// methods without faulting in and zeroing fresh pages.
+static constexpr size_t kJitArenaPoolRetainedBytes = 1 * MB;
 
 Runtime* Runtime::instance_ = nullptr;
 
@@ -261,6 +271,7 @@ Runtime::Runtime()
       class_linker_(nullptr),
       signal_catcher_(nullptr),
       java_vm_(nullptr),
+      jit_compiler_library_loaded_(false),
       thread_pool_ref_count_(0u),
       fault_message_(nullptr),
       threads_being_born_(0),
@@ -297,6 +308,7 @@ Runtime::Runtime()
       monitor_timeout_ns_(0),
       zygote_max_failed_boots_(0),
       experimental_flags_(ExperimentalFlags::kNone),
+      background_startup_class_init_(false),
       oat_file_manager_(nullptr),
       is_low_memory_mode_(false),
       madvise_willneed_total_dex_size_(0),
@@ -326,11 +338,16 @@ Runtime::Runtime()
   callbacks_.reset(new RuntimeCallbacks());
   for (size_t i = 0; i <= static_cast<size_t>(DeoptimizationKind::kLast); ++i) {
     deoptimization_counts_[i] = 0u;
+    deoptimization_times_ns_[i] = 0u;
   }
 }
 
 Runtime::~Runtime() {
   ScopedTrace trace("Runtime shutdown");
+  if (jit_compiler_library_loader_.joinable()) {
+    // The runtime was not started.
+    jit_compiler_library_loader_.join();
+  }
   if (is_native_bridge_loaded_) {
     UnloadNativeBridge();
   }
@@ -515,6 +532,8 @@ Runtime::~Runtime() {
   monitor_list_ = nullptr;
   delete monitor_pool_;
   monitor_pool_ = nullptr;
+  thin_lock_hash_codes_.reset();
+  monitor_contention_profile_.reset();
   delete class_linker_;
   class_linker_ = nullptr;
   delete small_lrt_allocator_;
@@ -792,8 +811,10 @@ void Runtime::CallExitHook(jint status) {
 void Runtime::SweepSystemWeaks(IsMarkedVisitor* visitor) {
   GetInternTable()->SweepInternTableWeaks(visitor);
   GetMonitorList()->SweepMonitorList(visitor);
+  GetThinLockHashCodes()->Sweep(visitor);
   GetJavaVM()->SweepJniWeakGlobals(visitor);
   GetHeap()->SweepAllocationRecords(visitor);
+  GetHeap()->SweepAllocationSiteSamples(visitor);
   // Sweep JIT tables only if the GC is moving as in other cases the entries are
   // not updated.
   if (GetJit() != nullptr && GetHeap()->IsMovingGc()) {
@@ -988,7 +1009,7 @@ bool Runtime::Start() {
   if (jit_options_->UseJitCompilation() || jit_options_->GetSaveProfilingInfo()) {
     // Try to load compiler pre zygote to reduce PSS. b/27744947
     std::string error_msg;
-    if (!jit::Jit::LoadCompilerLibrary(&error_msg)) {
+    if (!LoadJitCompilerLibrary(&error_msg)) {
       LOG(WARNING) << "Failed to load JIT compiler with error " << error_msg;
     }
     CreateJit();
@@ -1008,6 +1029,10 @@ bool Runtime::Start() {
       jit_->GetThreadPool()->WaitForWorkersToBeCreated();
     }
 #endif
+  } else if (jit_compiler_library_loader_.joinable()) {
+    // The JIT was disabled after Init(), for example by an agent. Do not fork the zygote with
+    // the loader thread still running.
+    jit_compiler_library_loader_.join();
   }
 
   // Send the start phase event. We have to wait till here as this is when the main thread peer
@@ -1044,6 +1069,7 @@ bool Runtime::Start() {
     self->GetJniEnv()->AssertLocalsEmpty();
   }
 
+  startup_timeline_.MarkPhase(metrics::StartupPhase::kRuntimeStarted, GetMetrics());
   VLOG(startup) << "Runtime::Start exiting";
   finished_starting_ = true;
 
@@ -1175,12 +1201,21 @@ void Runtime::InitNonZygoteOrPostFork(
     CHECK(thread_pool_ == nullptr);
     thread_pool_.reset(new ThreadPool("Runtime", num_workers, /*create_peers=*/false, kStackSize));
     thread_pool_->StartWorkers(Thread::Current());
+    if (!post_fork_warmup_profile_.empty()) {
+      // Read ahead the boot class path code of the startup methods while the main thread
+      // initializes the app.
+      thread_pool_->AddTask(Thread::Current(), new PostForkWarmupTask(post_fork_warmup_profile_));
+    }
   }
 
   // Reset the gc performance data and metrics at zygote fork so that the events from
   // before fork aren't attributed to an app.
   heap_->ResetGcPerformanceInfo();
   GetMetrics()->Reset();
+  if (finished_starting_) {
+    // The startup of an app forked from the zygote starts at the fork.
+    startup_timeline_.Start(NanoTime());
+  }
 
   if (metrics_reporter_ != nullptr) {
     // Now that we know if we are an app or system server, reload the metrics reporter config
@@ -1273,6 +1308,25 @@ void Runtime::StartDaemonThreads() {
   VLOG(startup) << "Runtime::StartDaemonThreads exiting";
 }
 
+// Reads the class descriptors of -Xzygote-dirty-objects:, in the format of the dex2oat
+// --dirty-image-objects file. Empty lines, comment lines starting with '#' and anything after
+// the descriptor on a line are ignored.
+static std::vector<std::string> ReadZygoteDirtyClasses(const std::string& filename) {
+  std::string content;
+  if (!android::base::ReadFileToString(filename, &content)) {
+    PLOG(WARNING) << "Failed to read the zygote dirty objects " << filename;
+    return {};
+  }
+  std::vector<std::string> descriptors;
+  for (const std::string& line : android::base::Split(content, "\n")) {
+    std::string descriptor = android::base::Trim(line.substr(0, line.find_first_of(" \t")));
+    if (!descriptor.empty() && descriptor[0] != '#') {
+      descriptors.push_back(std::move(descriptor));
+    }
+  }
+  return descriptors;
+}
+
 static size_t OpenBootDexFiles(ArrayRef<const std::string> dex_filenames,
                                ArrayRef<const std::string> dex_locations,
                                ArrayRef<const int> dex_fds,
@@ -1408,6 +1462,10 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   Opt runtime_options(std::move(runtime_options_in));
   ScopedTrace trace(__FUNCTION__);
   CHECK_EQ(static_cast<size_t>(sysconf(_SC_PAGE_SIZE)), kPageSize);
+  const uint64_t init_start_ns = NanoTime();
+  startup_timeline_.Start(init_start_ns);
+  // The phases that take most of the time, for -verbose:startup and the metrics.
+  TimingLogger init_timings(__FUNCTION__, /*precise=*/ true, /*verbose=*/ false);
 
   // Reload all the flags value (from system properties and device configs).
   ReloadAllFlags(__FUNCTION__);
@@ -1534,6 +1592,8 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
 
   monitor_list_ = new MonitorList;
   monitor_pool_ = MonitorPool::Create();
+  thin_lock_hash_codes_ = std::make_unique<ThinLockHashCodes>();
+  monitor_contention_profile_ = std::make_unique<MonitorContentionProfile>();
   thread_list_ = new ThreadList(runtime_options.GetOrDefault(Opt::ThreadSuspendTimeout));
   intern_table_ = new InternTable;
 
@@ -1577,6 +1637,8 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   Split(runtime_options.GetOrDefault(Opt::CpuAbiList), ',', &cpu_abilist_);
 
   fingerprint_ = runtime_options.ReleaseOrDefault(Opt::Fingerprint);
+  post_fork_warmup_profile_ = runtime_options.ReleaseOrDefault(Opt::PostForkWarmupProfile);
+  background_startup_class_init_ = runtime_options.GetOrDefault(Opt::BackgroundStartupClassInit);
 
   if (runtime_options.GetOrDefault(Opt::Interpret)) {
     GetInstrumentation()->ForceInterpretOnly();
@@ -1624,6 +1686,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
                       : (gUseUserfaultfd ? BackgroundGcOption(xgc_option.collector_type_)
                                          : runtime_options.GetOrDefault(Opt::BackgroundGc));
 
+  init_timings.StartTiming("CreateHeap");
   heap_ = new gc::Heap(runtime_options.GetOrDefault(Opt::MemoryInitialSize),
                        runtime_options.GetOrDefault(Opt::HeapGrowthLimit),
                        runtime_options.GetOrDefault(Opt::HeapMinFree),
@@ -1654,6 +1717,8 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
                        runtime_options.Exists(Opt::IgnoreMaxFootprint),
                        runtime_options.GetOrDefault(Opt::AlwaysLogExplicitGcs),
                        runtime_options.GetOrDefault(Opt::UseTLAB),
+                       runtime_options.GetOrDefault(Opt::HeapHugePages),
+                       runtime_options.GetOrDefault(Opt::AsyncNativeAllocationChecks),
                        xgc_option.verify_pre_gc_heap_,
                        xgc_option.verify_pre_sweeping_heap_,
                        xgc_option.verify_post_gc_heap_,
@@ -1664,9 +1729,16 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
                        xgc_option.measure_,
                        runtime_options.GetOrDefault(Opt::EnableHSpaceCompactForOOM),
                        use_generational_cc,
+                       xgc_option.generational_cmc,
                        runtime_options.GetOrDefault(Opt::HSpaceCompactForOOMMinIntervalsMs),
                        runtime_options.Exists(Opt::DumpRegionInfoBeforeGC),
-                       runtime_options.Exists(Opt::DumpRegionInfoAfterGC));
+                       runtime_options.Exists(Opt::DumpRegionInfoAfterGC),
+                       runtime_options.Exists(Opt::DumpDuplicateStringsAfterGC));
+  init_timings.EndTiming();
+  if (is_zygote_ && runtime_options.Exists(Opt::ZygoteDirtyObjects)) {
+    heap_->SetZygoteDirtyClasses(
+        ReadZygoteDirtyClasses(runtime_options.GetOrDefault(Opt::ZygoteDirtyObjects)));
+  }
 
   dump_gc_performance_on_shutdown_ = runtime_options.Exists(Opt::DumpGCPerformanceOnShutdown);
 
@@ -1712,6 +1784,15 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
     jit_options_->SetUseJitCompilation(false);
     jit_options_->SetSaveProfilingInfo(false);
   }
+  // Start() loads the JIT compiler library before creating the JIT. The dlopen() does not
+  // depend on anything below, so the zygote starts it now and it runs concurrently with the
+  // class linker initialization. Memory tool builds keep the sequential order to avoid the
+  // pthread_create() and dlopen() race described in Start().
+  if (is_zygote_ &&
+      !kRunningOnMemoryTool &&
+      (jit_options_->UseJitCompilation() || jit_options_->GetSaveProfilingInfo())) {
+    StartLoadingJitCompilerLibrary();
+  }
 
   // Use MemMap arena pool for jit, malloc otherwise. Malloc arenas are faster to allocate but
   // can't be trimmed as easily.
@@ -1721,7 +1802,8 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
     jit_arena_pool_.reset(new MallocArenaPool());
   } else {
     arena_pool_.reset(new MemMapArenaPool(/* low_4gb= */ false));
-    jit_arena_pool_.reset(new MemMapArenaPool(/* low_4gb= */ false, "CompilerMetadata"));
+    jit_arena_pool_.reset(new MemMapArenaPool(
+        /* low_4gb= */ false, "CompilerMetadata", kJitArenaPoolRetainedBytes));
   }
 
   // For 64 bit compilers, it needs to be in low 4GB in the case where we are cross compiling for a
@@ -1823,6 +1905,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
 
   CHECK_GE(GetHeap()->GetContinuousSpaces().size(), 1U);
 
+  init_timings.StartTiming("InitClassLinker");
   if (UNLIKELY(IsAotCompiler())) {
     class_linker_ = new AotClassLinker(intern_table_);
   } else {
@@ -1907,6 +1990,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   ArrayRef<const DexFile* const> bcp_dex_files(GetClassLinker()->GetBootClassPath());
   boot_class_path_checksums_ = gc::space::ImageSpace::GetBootClassPathChecksums(image_spaces,
                                                                                 bcp_dex_files);
+  init_timings.EndTiming();
 
   CHECK(class_linker_ != nullptr);
 
@@ -1989,6 +2073,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   // We load plugins first since that can modify the runtime state slightly.
   // Load all plugins
   {
+    TimingLogger::ScopedTiming timing("LoadPlugins", &init_timings);
     // The init method of plugins expect the state of the thread to be non runnable.
     ScopedThreadSuspension sts(self, ThreadState::kNative);
     for (auto& plugin : plugins_) {
@@ -2027,6 +2112,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   //   DidForkFromZygote(kInitialize) -> try to initialize any native bridge given.
   //   No-op wrt native bridge.
   {
+    TimingLogger::ScopedTiming timing("LoadNativeBridge", &init_timings);
     std::string native_bridge_file_name = runtime_options.ReleaseOrDefault(Opt::NativeBridge);
     is_native_bridge_loaded_ = LoadNativeBridge(native_bridge_file_name);
   }
@@ -2073,6 +2159,14 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
     dlopen(plugin_name, RTLD_NOW | RTLD_LOCAL);
   }
 
+  TimingLogger::TimingData timing_data = init_timings.CalculateTimingData();
+  GetMetrics()->RuntimeInitTime()->Add(NsToUs(NanoTime() - init_start_ns));
+  GetMetrics()->RuntimeInitHeapTime()->Add(
+      NsToUs(timing_data.GetTotalTime(init_timings.FindTimingIndex("CreateHeap", 0u))));
+  GetMetrics()->RuntimeInitClassLinkerTime()->Add(
+      NsToUs(timing_data.GetTotalTime(init_timings.FindTimingIndex("InitClassLinker", 0u))));
+  startup_timeline_.MarkPhase(metrics::StartupPhase::kRuntimeInitialized, GetMetrics());
+  VLOG(startup) << Dumpable<TimingLogger>(init_timings);
   VLOG(startup) << "Runtime::Init exiting";
 
   return true;
@@ -2310,6 +2404,8 @@ void Runtime::DumpDeoptimizations(std::ostream& os) {
          << GetDeoptimizationKindName(static_cast<DeoptimizationKind>(i))
          << " deoptimizations: "
          << deoptimization_counts_[i]
+         << ", total time "
+         << PrettyDuration(deoptimization_times_ns_[i].load(std::memory_order_relaxed))
          << "\n";
     }
   }
@@ -2335,6 +2431,7 @@ void Runtime::DumpForSigQuit(std::ostream& os) {
   os << "\n";
 
   BaseMutex::DumpAll(os);
+  monitor_contention_profile_->Dump(os);
 
   // Inform anyone else who is interested in SigQuit.
   {
@@ -2644,6 +2741,7 @@ ArtMethod* Runtime::CreateCalleeSaveMethod() {
 void Runtime::DisallowNewSystemWeaks() {
   CHECK(!gUseReadBarrier);
   monitor_list_->DisallowNewMonitors();
+  thin_lock_hash_codes_->Disallow();
   intern_table_->ChangeWeakRootState(gc::kWeakRootStateNoReadsOrWrites);
   java_vm_->DisallowNewWeakGlobals();
   heap_->DisallowNewAllocationRecords();
@@ -2660,6 +2758,7 @@ void Runtime::DisallowNewSystemWeaks() {
 void Runtime::AllowNewSystemWeaks() {
   CHECK(!gUseReadBarrier);
   monitor_list_->AllowNewMonitors();
+  thin_lock_hash_codes_->Allow();
   intern_table_->ChangeWeakRootState(gc::kWeakRootStateNormal);  // TODO: Do this in the sweeping.
   java_vm_->AllowNewWeakGlobals();
   heap_->AllowNewAllocationRecords();
@@ -2678,6 +2777,7 @@ void Runtime::BroadcastForNewSystemWeaks(bool broadcast_for_checkpoint) {
   // Thread::GetWeakRefAccessEnabled() flag and the checkpoint while weak ref access is disabled
   // (see ThreadList::RunCheckpoint).
   monitor_list_->BroadcastForNewMonitors();
+  thin_lock_hash_codes_->Broadcast(broadcast_for_checkpoint);
   intern_table_->BroadcastForNewInterns();
   java_vm_->BroadcastForNewWeakGlobals();
   heap_->BroadcastForNewAllocationRecords();
@@ -2737,11 +2837,28 @@ void Runtime::RegisterAppInfo(const std::string& package_name,
       profile_output_filename,
       ref_profile_filename,
       AppInfo::FromVMRuntimeConstants(code_type));
+  startup_timeline_.MarkPhase(metrics::StartupPhase::kAppInfoRegistered, GetMetrics());
 
   if (metrics_reporter_ != nullptr) {
     metrics_reporter_->NotifyAppInfoUpdated(&app_info_);
   }
 
+  if (background_startup_class_init_ &&
+      AppInfo::FromVMRuntimeConstants(code_type) == AppInfo::CodeType::kPrimaryApk &&
+      !IsJavaDebuggable()) {
+    // The reference profile is the one the app was compiled with, the current profile may only
+    // have the data of the last runs.
+    const std::string& profile_filename =
+        (!ref_profile_filename.empty() && OS::FileExists(ref_profile_filename.c_str()))
+            ? ref_profile_filename
+            : profile_output_filename;
+    ScopedThreadPoolUsage stpu;
+    if (!profile_filename.empty() && stpu.GetThreadPool() != nullptr) {
+      stpu.GetThreadPool()->AddTask(Thread::Current(),
+                                    new StartupClassInitTask(code_paths, profile_filename));
+    }
+  }
+
   if (jit_.get() == nullptr) {
     // We are not JITing. Nothing to do.
     return;
@@ -3070,7 +3187,28 @@ void Runtime::CreateJit() {
     jit_code_cache_.reset();
   } else {
     jit->CreateThreadPool();
+    if (jit_options_->UseJitCompilation() && jit_options_->PretenureAllocationSites()) {
+      GetHeap()->GetAllocationSiteSampler()->SetEnabled(true);
+    }
+  }
+}
+
+void Runtime::StartLoadingJitCompilerLibrary() {
+  DCHECK(!jit_compiler_library_loader_.joinable());
+  jit_compiler_library_loader_ = std::thread([this]() {
+    ScopedTrace trace("LoadJitCompilerLibrary");
+    jit_compiler_library_loaded_ = jit::Jit::LoadCompilerLibrary(&jit_compiler_library_error_);
+  });
+}
+
+bool Runtime::LoadJitCompilerLibrary(/*out*/ std::string* error_msg) {
+  if (!jit_compiler_library_loader_.joinable()) {
+    return jit::Jit::LoadCompilerLibrary(error_msg);
   }
+  ScopedTrace trace("Wait for LoadJitCompilerLibrary");
+  jit_compiler_library_loader_.join();
+  *error_msg = std::move(jit_compiler_library_error_);
+  return jit_compiler_library_loaded_;
 }
 
 bool Runtime::CanRelocate() const {
@@ -3376,6 +3514,11 @@ bool Runtime::NotifyStartupCompleted() {
 
   ProfileSaver::NotifyStartupCompleted();
 
+  // Record the timeline before the metrics reporter takes its startup snapshot.
+  startup_timeline_.MarkPhase(metrics::StartupPhase::kCompleted, GetMetrics());
+  startup_timeline_.Report(GetMetrics());
+  VLOG(startup) << Dumpable<metrics::StartupTimeline>(startup_timeline_);
+
   if (metrics_reporter_ != nullptr) {
     metrics_reporter_->NotifyStartupCompleted();
   }
@@ -3383,6 +3526,7 @@ bool Runtime::NotifyStartupCompleted() {
 }
 
 void Runtime::NotifyDexFileLoaded() {
+  startup_timeline_.MarkPhase(metrics::StartupPhase::kDexFilesLoaded, GetMetrics());
   if (metrics_reporter_ != nullptr) {
     metrics_reporter_->NotifyAppInfoUpdated(&app_info_);
   }
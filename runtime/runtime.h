@@ -25,6 +25,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -44,6 +45,7 @@
 #include "jni/jni_id_manager.h"
 #include "jni_id_type.h"
 #include "metrics/reporter.h"
+#include "metrics/startup_timeline.h"
 #include "obj_ptr.h"
 #include "offsets.h"
 #include "process_state.h"
@@ -102,6 +104,7 @@ class InternTable;
 class IsMarkedVisitor;
 class JavaVMExt;
 class LinearAlloc;
+class MonitorContentionProfile;
 class MonitorList;
 class MonitorPool;
 class NullPointerHandler;
@@ -113,6 +116,7 @@ class RuntimeCallbacks;
 class SignalCatcher;
 class StackOverflowHandler;
 class SuspensionHandler;
+class ThinLockHashCodes;
 class ThreadList;
 class ThreadPool;
 class Trace;
@@ -414,6 +418,14 @@ class Runtime {
     return monitor_pool_;
   }
 
+  ThinLockHashCodes* GetThinLockHashCodes() const {
+    return thin_lock_hash_codes_.get();
+  }
+
+  MonitorContentionProfile* GetMonitorContentionProfile() const {
+    return monitor_contention_profile_.get();
+  }
+
   // Is the given object the special object used to mark a cleared JNI weak global?
   bool IsClearedJniWeakGlobal(ObjPtr<mirror::Object> obj) REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -701,6 +713,7 @@ class Runtime {
 
   void SetHiddenApiEnforcementPolicy(hiddenapi::EnforcementPolicy policy) {
     hidden_api_policy_ = policy;
+    InvalidateHiddenApiAccessDecisions();
   }
 
   hiddenapi::EnforcementPolicy GetHiddenApiEnforcementPolicy() const {
@@ -717,6 +730,7 @@ class Runtime {
 
   void SetTestApiEnforcementPolicy(hiddenapi::EnforcementPolicy policy) {
     test_api_policy_ = policy;
+    InvalidateHiddenApiAccessDecisions();
   }
 
   hiddenapi::EnforcementPolicy GetTestApiEnforcementPolicy() const {
@@ -725,6 +739,7 @@ class Runtime {
 
   void SetHiddenApiExemptions(const std::vector<std::string>& exemptions) {
     hidden_api_exemptions_ = exemptions;
+    InvalidateHiddenApiAccessDecisions();
   }
 
   const std::vector<std::string>& GetHiddenApiExemptions() {
@@ -747,6 +762,14 @@ class Runtime {
     return hidden_api_access_event_log_rate_;
   }
 
+  // Returns a number that changes whenever the hidden API policy, the test API policy, the
+  // exemptions, the target SDK version or the disabled compat changes change. Cached hidden API
+  // access decisions are only valid for the epoch they were made in.
+  uint32_t GetHiddenApiPolicyEpoch() const {
+    return hidden_api_policy_epoch_.load(std::memory_order_relaxed) +
+           compat_framework_.GetDisabledCompatChangesEpoch();
+  }
+
   const std::string& GetProcessPackageName() const {
     return process_package_name_;
   }
@@ -781,6 +804,7 @@ class Runtime {
 
   void SetTargetSdkVersion(uint32_t version) {
     target_sdk_version_ = version;
+    InvalidateHiddenApiAccessDecisions();
   }
 
   uint32_t GetTargetSdkVersion() const {
@@ -804,6 +828,14 @@ class Runtime {
   // Create the JIT and instrumentation and code cache.
   void CreateJit();
 
+  // Start loading the JIT compiler library on a background thread, so that the dlopen()
+  // overlaps with the class linker initialization.
+  void StartLoadingJitCompilerLibrary();
+
+  // Wait for the library load started by StartLoadingJitCompilerLibrary(), or load the library
+  // now if it was not started.
+  bool LoadJitCompilerLibrary(/*out*/ std::string* error_msg);
+
   ArenaPool* GetLinearAllocArenaPool() {
     return linear_alloc_arena_pool_.get();
   }
@@ -992,6 +1024,13 @@ class Runtime {
     deoptimization_counts_[static_cast<size_t>(kind)]++;
   }
 
+  // Add the time spent walking the stack and creating the shadow frames for a deoptimization.
+  void AddDeoptimizationTime(DeoptimizationKind kind, uint64_t time_ns) {
+    DCHECK_LE(kind, DeoptimizationKind::kLast);
+    deoptimization_times_ns_[static_cast<size_t>(kind)].fetch_add(time_ns,
+                                                                  std::memory_order_relaxed);
+  }
+
   uint32_t GetNumberOfDeoptimizations() const {
     uint32_t result = 0;
     for (size_t i = 0; i <= static_cast<size_t>(DeoptimizationKind::kLast); ++i) {
@@ -1121,6 +1160,8 @@ class Runtime {
 
   metrics::ArtMetrics* GetMetrics() { return &metrics_; }
 
+  metrics::StartupTimeline* GetStartupTimeline() { return &startup_timeline_; }
+
   AppInfo* GetAppInfo() { return &app_info_; }
 
   void RequestMetricsReport(bool synchronous = true);
@@ -1187,6 +1228,10 @@ class Runtime {
 
   void BlockSignals();
 
+  void InvalidateHiddenApiAccessDecisions() {
+    hidden_api_policy_epoch_.fetch_add(1u, std::memory_order_relaxed);
+  }
+
   bool Init(RuntimeArgumentMap&& runtime_options)
       SHARED_TRYLOCK_FUNCTION(true, Locks::mutator_lock_);
   void InitNativeMethods() REQUIRES(!Locks::mutator_lock_);
@@ -1310,6 +1355,8 @@ class Runtime {
   size_t max_spins_before_thin_lock_inflation_;
   MonitorList* monitor_list_;
   MonitorPool* monitor_pool_;
+  std::unique_ptr<ThinLockHashCodes> thin_lock_hash_codes_;
+  std::unique_ptr<MonitorContentionProfile> monitor_contention_profile_;
 
   ThreadList* thread_list_;
 
@@ -1329,6 +1376,11 @@ class Runtime {
   std::unique_ptr<jit::JitCodeCache> jit_code_cache_;
   std::unique_ptr<jit::JitOptions> jit_options_;
 
+  // The thread loading the JIT compiler library during Init(), joined in Start().
+  std::thread jit_compiler_library_loader_;
+  bool jit_compiler_library_loaded_;
+  std::string jit_compiler_library_error_;
+
   // Runtime thread pool. The pool is only for startup and gets deleted after.
   std::unique_ptr<ThreadPool> thread_pool_ GUARDED_BY(Locks::runtime_thread_pool_lock_);
   size_t thread_pool_ref_count_ GUARDED_BY(Locks::runtime_thread_pool_lock_);
@@ -1463,6 +1515,12 @@ class Runtime {
   // Contains the build fingerprint, if given as a parameter.
   std::string fingerprint_;
 
+  // The boot profile of the PostForkWarmupTask, if given as a parameter.
+  std::string post_fork_warmup_profile_;
+
+  // Whether to run a StartupClassInitTask when the primary APK of the app is registered.
+  bool background_startup_class_init_;
+
   // Oat file manager, keeps track of what oat files are open.
   OatFileManager* oat_file_manager_;
 
@@ -1502,6 +1560,9 @@ class Runtime {
   // This is only used for testing.
   bool dedupe_hidden_api_warnings_;
 
+  // Incremented when a setting that hidden API access decisions depend on changes.
+  std::atomic<uint32_t> hidden_api_policy_epoch_ = 0u;
+
   // How often to log hidden API access to the event log. An integer between 0
   // (never) and 0x10000 (always).
   uint32_t hidden_api_access_event_log_rate_;
@@ -1562,6 +1623,8 @@ class Runtime {
 
   std::atomic<uint32_t> deoptimization_counts_[
       static_cast<uint32_t>(DeoptimizationKind::kLast) + 1];
+  std::atomic<uint64_t> deoptimization_times_ns_[
+      static_cast<uint32_t>(DeoptimizationKind::kLast) + 1];
 
   MemMap protected_fault_page_;
 
@@ -1582,6 +1645,7 @@ class Runtime {
 
   metrics::ArtMetrics metrics_;
   std::unique_ptr<metrics::MetricsReporter> metrics_reporter_;
+  metrics::StartupTimeline startup_timeline_;
 
   // Apex versions of boot classpath jars concatenated in a string. The format
   // is of the type:
@@ -60,6 +60,12 @@ static constexpr bool kEnableGenerationalCCByDefault = true;
 static constexpr bool kEnableGenerationalCCByDefault = false;
 #endif
 
+// When using the Concurrent Mark-Compact (CMC) collector, enable generational
+// collection, i.e. use young collections which only compact the objects
+// allocated since the previous GC. Can be overridden with the runtime option
+// `-Xgc:[no]generational_cmc`.
+static constexpr bool kEnableGenerationalCMCByDefault = false;
+
 // If true, enable the tlab allocator by default.
 #ifdef ART_USE_TLAB
 static constexpr bool kUseTlab = true;
@@ -19,11 +19,13 @@
 #include <lz4.h>
 #include <sstream>
 #include <unistd.h>
+#include <zlib.h>
 
 #include "android-base/file.h"
 #include "android-base/stringprintf.h"
 #include "android-base/strings.h"
 
+#include "app_info.h"
 #include "base/arena_allocator.h"
 #include "base/arena_containers.h"
 #include "base/bit_utils.h"
@@ -1839,12 +1841,46 @@ static bool EnsureDirectoryExists(const std::string& directory, std::string* err
   return true;
 }
 
+uint32_t RuntimeImage::ComputeImageDataChecksum(const uint8_t* data, size_t size) {
+  uint32_t checksum = adler32(0L, Z_NULL, 0);
+  return adler32(checksum, data, size);
+}
+
+// Returns whether the primary APK runs with a runtime app image loaded from disk. That image has
+// been validated against the dex files and boot image, so writing a new one would only redo the
+// I/O that the image saves.
+static bool HasLoadedRuntimeImageForPrimaryApk() {
+  Runtime* runtime = Runtime::Current();
+  AppInfo* app_info = runtime->GetAppInfo();
+  ScopedObjectAccess soa(Thread::Current());
+  for (gc::space::ContinuousSpace* space : runtime->GetHeap()->GetContinuousSpaces()) {
+    if (!space->IsImageSpace()) {
+      continue;
+    }
+    gc::space::ImageSpace* image_space = space->AsImageSpace();
+    const OatFile* oat_file = image_space->GetOatFile();
+    if (oat_file == nullptr || oat_file->GetOatDexFiles().empty()) {
+      continue;
+    }
+    const std::string& dex_location = oat_file->GetOatDexFiles()[0]->GetDexFileLocation();
+    if (app_info->GetRegisteredCodeType(dex_location) == AppInfo::CodeType::kPrimaryApk &&
+        image_space->GetImageFilename() == RuntimeImage::GetRuntimeImagePath(dex_location)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 bool RuntimeImage::WriteImageToDisk(std::string* error_msg) {
   gc::Heap* heap = Runtime::Current()->GetHeap();
   if (!heap->HasBootImageSpace()) {
     *error_msg = "Cannot generate an app image without a boot image";
     return false;
   }
+  if (HasLoadedRuntimeImageForPrimaryApk()) {
+    *error_msg = "The runtime app image of the primary APK is already in use";
+    return false;
+  }
   std::string oat_path = GetOatPath();
   if (!oat_path.empty() && !EnsureDirectoryExists(oat_path, error_msg)) {
     return false;
@@ -1855,6 +1891,12 @@ bool RuntimeImage::WriteImageToDisk(std::string* error_msg) {
   if (!image->Generate(error_msg)) {
     return false;
   }
+  if (image->GetHeader()->GetImageSize() > kMaxImageSize) {
+    *error_msg = StringPrintf("Runtime app image of %zu bytes exceeds the maximum of %zu bytes",
+                              image->GetHeader()->GetImageSize(),
+                              kMaxImageSize);
+    return false;
+  }
 
   ScopedTrace write_image_trace("Writing runtime image to disk");
 
@@ -1877,13 +1919,19 @@ bool RuntimeImage::WriteImageToDisk(std::string* error_msg) {
   std::vector<uint8_t> full_data(image->GetHeader()->GetImageSize());
   image->FillData(full_data);
 
+  // Store a checksum of the uncompressed data, which the loader verifies before using the image.
+  // The data is only written once and loaded on every start of the app, so it is worth catching
+  // a corrupted image instead of crashing while relocating or running with it.
+  image->GetHeader()->SetImageChecksum(ComputeImageDataChecksum(
+      full_data.data() + sizeof(ImageHeader), full_data.size() - sizeof(ImageHeader)));
+
   // Specify default block size of 512K to enable parallel image decompression.
   static constexpr size_t kMaxImageBlockSize = 524288;
   // Use LZ4 as good compromise between CPU time and compression. LZ4HC
   // empirically takes 10x more time compressing.
   static constexpr ImageHeader::StorageMode kImageStorageMode = ImageHeader::kStorageModeLZ4;
-  // Note: no need to update the checksum of the runtime app image: we have no
-  // use for it, and computing it takes CPU time.
+  // Note: the checksum of the runtime app image has been computed over the
+  // uncompressed data above, don't let `WriteData` compute another one.
   if (!image->GetHeader()->WriteData(
           image_file,
           full_data.data(),
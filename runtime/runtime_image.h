@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_RUNTIME_IMAGE_H_
 #define ART_RUNTIME_RUNTIME_IMAGE_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 namespace art {
@@ -28,6 +30,14 @@ class RuntimeImage {
 
   // Gets the path where a runtime-generated app image is stored.
   static std::string GetRuntimeImagePath(const std::string& dex_location);
+
+  // Computes the checksum stored in the header of a runtime-generated app image, over the
+  // uncompressed image data that follows the header.
+  static uint32_t ComputeImageDataChecksum(const uint8_t* data, size_t size);
+
+  // The maximum size of a runtime-generated app image. Larger images are not written, as writing
+  // and loading them would cost more than they save.
+  static constexpr size_t kMaxImageSize = 64 * 1024 * 1024;
 };
 
 }  // namespace art
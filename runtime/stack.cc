@@ -24,6 +24,7 @@
 #include "base/callee_save_type.h"
 #include "base/enums.h"
 #include "base/hex_dump.h"
+#include "code_info_cache.h"
 #include "dex/dex_file_types.h"
 #include "entrypoints/entrypoint_utils-inl.h"
 #include "entrypoints/quick/callee_save_frame.h"
@@ -85,7 +86,13 @@ CodeInfo* StackVisitor::GetCurrentInlineInfo() const {
   DCHECK(!(*cur_quick_frame_)->IsNative());
   const OatQuickMethodHeader* header = GetCurrentOatQuickMethodHeader();
   if (cur_inline_info_.first != header) {
-    cur_inline_info_ = std::make_pair(header, CodeInfo::DecodeInlineInfoOnly(header));
+    // Walks from the same thread usually see the same compiled frames, reuse their decoded
+    // code info. Threads that are not attached, e.g. while dumping, decode it every time.
+    Thread* self = Thread::Current();
+    cur_inline_info_ = std::make_pair(
+        header,
+        self != nullptr ? self->GetCodeInfoCache()->Get(header)
+                        : CodeInfo::DecodeInlineInfoOnly(header));
   }
   return &cur_inline_info_.second;
 }
@@ -86,8 +86,10 @@ StackMap CodeInfo::GetStackMapForNativePcOffset(uintptr_t pc, InstructionSet isa
   auto it = std::partition_point(
       stack_maps_.begin(),
       stack_maps_.end(),
-      [packed_pc](const StackMap& sm) {
-        return sm.GetPackedNativePc() < packed_pc && sm.GetKind() != StackMap::Kind::Catch;
+      [this, packed_pc](const StackMap& sm) {
+        static_assert(StackMap::kPackedNativePc == StackMap::kKind + 1u);
+        auto [kind, pc] = stack_maps_.GetColumns<2u>(sm.Row(), StackMap::kKind);
+        return pc < packed_pc && kind != static_cast<uint32_t>(StackMap::Kind::Catch);
       });
   // Start at the lower bound and iterate over all stack maps with the given native pc.
   for (; it != stack_maps_.end() && (*it).GetNativePcOffset(isa) == pc; ++it) {
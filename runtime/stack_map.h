@@ -230,8 +230,9 @@ class DexRegisterInfo : public BitTableAccessor<2> {
   BIT_TABLE_COLUMN(1, PackedValue)
 
   ALWAYS_INLINE DexRegisterLocation GetLocation() const {
-    DexRegisterLocation::Kind kind = static_cast<DexRegisterLocation::Kind>(GetKind());
-    return DexRegisterLocation(kind, UnpackValue(kind, GetPackedValue()));
+    auto [kind_value, packed_value] = table_->template GetColumns<2u>(row_);
+    DexRegisterLocation::Kind kind = static_cast<DexRegisterLocation::Kind>(kind_value);
+    return DexRegisterLocation(kind, UnpackValue(kind, packed_value));
   }
 
   static uint32_t PackValue(DexRegisterLocation::Kind kind, uint32_t value) {
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "startup_class_init_task.h"
+
+#include <algorithm>
+
+#include "base/logging.h"  // For VLOG.
+#include "base/systrace.h"
+#include "base/time_utils.h"
+#include "class_linker-inl.h"
+#include "dex/dex_file_loader.h"
+#include "handle_scope-inl.h"
+#include "mirror/class-inl.h"
+#include "mirror/class_loader.h"
+#include "mirror/dex_cache-inl.h"
+#include "mirror/iftable-inl.h"
+#include "profile/profile_compilation_info.h"
+#include "runtime.h"
+#include "scoped_thread_state_change-inl.h"
+#include "thread-current-inl.h"
+
+namespace art {
+
+bool StartupClassInitTask::CanInitializeWithoutCode(Handle<mirror::Class> klass) {
+  const PointerSize pointer_size = Runtime::Current()->GetClassLinker()->GetImagePointerSize();
+  for (ObjPtr<mirror::Class> c = klass.Get();
+       c != nullptr && !c->IsInitialized();
+       c = c->GetSuperClass()) {
+    if (!c->IsVerified() || c->FindClassInitializer(pointer_size) != nullptr) {
+      return false;
+    }
+  }
+  ObjPtr<mirror::IfTable> iftable = klass->GetIfTable();
+  for (int32_t i = 0, count = klass->GetIfTableCount(); i != count; ++i) {
+    ObjPtr<mirror::Class> iface = iftable->GetInterface(i);
+    if (!iface->IsInitialized() && iface->FindClassInitializer(pointer_size) != nullptr) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void StartupClassInitTask::Run(Thread* self) {
+  ScopedTrace trace("Startup class init");
+  const uint64_t start_ns = NanoTime();
+  Runtime* const runtime = Runtime::Current();
+  ProfileCompilationInfo profile;
+  if (!profile.Load(profile_file_, /*clear_if_invalid=*/ false) || profile.IsEmpty()) {
+    VLOG(startup) << "No startup classes in " << profile_file_;
+    return;
+  }
+
+  ScopedObjectAccess soa(self);
+  ClassLinker* const class_linker = runtime->GetClassLinker();
+  // Find the dex caches of the code paths, they reference the class loader of the app.
+  VariableSizedHandleScope hs(self);
+  std::vector<Handle<mirror::DexCache>> dex_caches;
+  {
+    ReaderMutexLock mu(self, *Locks::dex_lock_);
+    class DexCacheCollector : public DexCacheVisitor {
+     public:
+      DexCacheCollector(const std::vector<std::string>& code_paths,
+                        VariableSizedHandleScope* hs,
+                        std::vector<Handle<mirror::DexCache>>* dex_caches)
+          : code_paths_(code_paths), hs_(hs), dex_caches_(dex_caches) {}
+
+      void Visit(ObjPtr<mirror::DexCache> dex_cache)
+          REQUIRES_SHARED(Locks::dex_lock_, Locks::mutator_lock_) override {
+        std::string base_location =
+            DexFileLoader::GetBaseLocation(dex_cache->GetDexFile()->GetLocation());
+        if (std::find(code_paths_.begin(), code_paths_.end(), base_location) !=
+                code_paths_.end()) {
+          dex_caches_->push_back(hs_->NewHandle(dex_cache));
+        }
+      }
+
+     private:
+      const std::vector<std::string>& code_paths_;
+      VariableSizedHandleScope* const hs_;
+      std::vector<Handle<mirror::DexCache>>* const dex_caches_;
+    };
+    DexCacheCollector collector(code_paths_, &hs, &dex_caches);
+    class_linker->VisitDexCaches(&collector);
+  }
+
+  size_t loaded = 0u;
+  size_t initialized = 0u;
+  MutableHandle<mirror::ClassLoader> class_loader = hs.NewHandle<mirror::ClassLoader>(nullptr);
+  MutableHandle<mirror::Class> klass = hs.NewHandle<mirror::Class>(nullptr);
+  for (Handle<mirror::DexCache> dex_cache : dex_caches) {
+    const ArenaSet<dex::TypeIndex>* classes = profile.GetClasses(*dex_cache->GetDexFile());
+    if (classes == nullptr) {
+      continue;
+    }
+    class_loader.Assign(dex_cache->GetClassLoader());
+    // The profile does not record the order of the first uses, so follow the type index order.
+    for (dex::TypeIndex type_index : *classes) {
+      // The classes that the main thread does not use before startup completes were probably
+      // recorded by another run of the app, stop there.
+      if (runtime->GetStartupCompleted()) {
+        break;
+      }
+      // This thread cannot run the code of class loaders, so an unsupported class loader or a
+      // missing class results in the pre-allocated NoClassDefFoundError. The main thread then
+      // reports its own error when it uses the class.
+      klass.Assign(class_linker->ResolveType(type_index, dex_cache, class_loader));
+      if (klass == nullptr) {
+        self->ClearException();
+        continue;
+      }
+      ++loaded;
+      if (!klass->IsInitialized() && CanInitializeWithoutCode(klass)) {
+        if (class_linker->EnsureInitialized(self,
+                                            klass,
+                                            /*can_init_fields=*/ true,
+                                            /*can_init_parents=*/ true)) {
+          ++initialized;
+        } else {
+          self->ClearException();
+        }
+      }
+    }
+  }
+  VLOG(startup) << "Startup class init loaded " << loaded << " classes and initialized "
+                << initialized << " in " << PrettyDuration(NanoTime() - start_ns);
+}
+
+}  // namespace art
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_STARTUP_CLASS_INIT_TASK_H_
+#define ART_RUNTIME_STARTUP_CLASS_INIT_TASK_H_
+
+#include <string>
+#include <vector>
+
+#include "base/locks.h"
+#include "handle.h"
+#include "thread_pool.h"
+
+namespace art {
+
+namespace mirror {
+class Class;
+}  // namespace mirror
+
+class Thread;
+
+// Runs once in the runtime thread pool of an app, after the primary APK is registered by bind
+// application. It loads the classes of the app profile that the framework recorded during
+// startup, before the main thread uses them, and initializes the ones whose initialization
+// runs no code. Initialization goes through ClassLinker::EnsureInitialized(), so the main
+// thread waits on the normal class initialization lock if it needs a class at the same time.
+// The task stops when startup completes. See -XX:BackgroundStartupClassInit.
+class StartupClassInitTask : public SelfDeletingTask {
+ public:
+  StartupClassInitTask(const std::vector<std::string>& code_paths,
+                       const std::string& profile_file)
+      : code_paths_(code_paths), profile_file_(profile_file) {}
+
+  void Run(Thread* self) override;
+
+ private:
+  // Returns whether initializing `klass` does not run any class initializer: neither the
+  // superclasses nor the interfaces that would be initialized with it have a <clinit>.
+  static bool CanInitializeWithoutCode(Handle<mirror::Class> klass)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  const std::vector<std::string> code_paths_;
+  const std::string profile_file_;
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_STARTUP_CLASS_INIT_TASK_H_
@@ -16,15 +16,19 @@
 
 #include "string_builder_append.h"
 
+#include <cmath>
+
+#include "art_field-inl.h"
 #include "base/casts.h"
 #include "base/logging.h"
 #include "common_throws.h"
+#include "dex/primitive.h"
 #include "gc/heap.h"
 #include "mirror/array-inl.h"
 #include "mirror/string-alloc-inl.h"
 #include "obj_ptr-inl.h"
 #include "runtime.h"
-#include "well_known_classes.h"
+#include "well_known_classes-inl.h"
 
 namespace art {
 
@@ -48,6 +52,11 @@ class StringBuilderAppend::Builder {
     return (value >= 0) ? Uint64Length(v) : 1u + Uint64Length(-v);
   }
 
+  // Returns the primitive type of a boxed primitive passed as `Argument::kObject` and stores
+  // its value widened to `int64_t` in `value`.
+  static Primitive::Type GetBoxedValue(ObjPtr<mirror::Object> obj, /*out*/ int64_t* value)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   static size_t RemainingSpace(ObjPtr<mirror::String> new_string, const uint8_t* data)
       REQUIRES_SHARED(Locks::mutator_lock_) {
     DCHECK(new_string->IsCompressed());
@@ -82,6 +91,14 @@ class StringBuilderAppend::Builder {
                                CharType* data,
                                int64_t value) REQUIRES_SHARED(Locks::mutator_lock_);
 
+  template <typename CharType>
+  static CharType* AppendBoxedPrimitive(ObjPtr<mirror::String> new_string,
+                                        CharType* data,
+                                        ObjPtr<mirror::Object> obj)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  static size_t ConvertIntegralFpArg(double value, uint8_t* out);
+
   int32_t ConvertFpArgs() REQUIRES_SHARED(Locks::mutator_lock_);
 
   template <typename CharType>
@@ -160,6 +177,33 @@ inline size_t StringBuilderAppend::Builder::Uint64Length(uint64_t value)  {
   return log10_value_estimate + adjustment;
 }
 
+inline Primitive::Type StringBuilderAppend::Builder::GetBoxedValue(ObjPtr<mirror::Object> obj,
+                                                                  /*out*/ int64_t* value) {
+  ObjPtr<mirror::Class> klass = obj->GetClass();
+  ArtField* primitive_field = &klass->GetIFieldsPtr()->At(0);
+  if (klass == WellKnownClasses::java_lang_Boolean) {
+    *value = primitive_field->GetBoolean(obj);
+    return Primitive::kPrimBoolean;
+  } else if (klass == WellKnownClasses::java_lang_Byte) {
+    *value = primitive_field->GetByte(obj);
+    return Primitive::kPrimByte;
+  } else if (klass == WellKnownClasses::java_lang_Character) {
+    *value = primitive_field->GetChar(obj);
+    return Primitive::kPrimChar;
+  } else if (klass == WellKnownClasses::java_lang_Short) {
+    *value = primitive_field->GetShort(obj);
+    return Primitive::kPrimShort;
+  } else if (klass == WellKnownClasses::java_lang_Integer) {
+    *value = primitive_field->GetInt(obj);
+    return Primitive::kPrimInt;
+  } else {
+    CHECK(klass == WellKnownClasses::java_lang_Long) << "Unexpected object argument of type "
+        << klass->PrettyDescriptor();
+    *value = primitive_field->GetLong(obj);
+    return Primitive::kPrimLong;
+  }
+}
+
 template <typename CharType>
 inline CharType* StringBuilderAppend::Builder::AppendFpArg(ObjPtr<mirror::String> new_string,
                                                            CharType* data,
@@ -234,6 +278,51 @@ inline CharType* StringBuilderAppend::Builder::AppendInt64(ObjPtr<mirror::String
   return data + length;
 }
 
+template <typename CharType>
+inline CharType* StringBuilderAppend::Builder::AppendBoxedPrimitive(
+    ObjPtr<mirror::String> new_string, CharType* data, ObjPtr<mirror::Object> obj) {
+  int64_t value;
+  switch (GetBoxedValue(obj, &value)) {
+    case Primitive::kPrimBoolean:
+      return (value != 0) ? AppendLiteral(new_string, data, kTrue)
+                          : AppendLiteral(new_string, data, kFalse);
+    case Primitive::kPrimChar:
+      DCHECK_GE(RemainingSpace(new_string, data), 1u);
+      *data = dchecked_integral_cast<CharType>(value);
+      return data + 1u;
+    default:
+      return AppendInt64(new_string, data, value);
+  }
+}
+
+// Formats a float or double with an integral value of magnitude below 10^7 the way
+// `Double.toString()` and `Float.toString()` do, as the integer followed by ".0", and returns
+// the length. Returns 0 for other values, these are converted with `FloatingDecimal`.
+inline size_t StringBuilderAppend::Builder::ConvertIntegralFpArg(double value, uint8_t* out) {
+  // Note: NaN fails the first comparison.
+  if (!(std::fabs(value) < 1e7) || value != std::trunc(value)) {
+    return 0u;
+  }
+  uint8_t* data = out;
+  if (std::signbit(value)) {
+    *data = '-';
+    ++data;
+  }
+  uint32_t v = static_cast<uint32_t>(std::fabs(value));
+  size_t length = Uint64Length(v);
+  for (size_t i = length; i != 0u; ) {
+    --i;
+    data[i] = '0' + static_cast<char>(v % 10u);
+    v /= 10u;
+  }
+  data += length;
+  data[0] = '.';
+  data[1] = '0';
+  data += 2u;
+  DCHECK_LE(static_cast<size_t>(data - out), kBinaryToASCIIBufferSize);
+  return data - out;
+}
+
 int32_t StringBuilderAppend::Builder::ConvertFpArgs() {
   int32_t fp_args_length = 0u;
   const uint32_t* current_arg = args_;
@@ -241,8 +330,10 @@ int32_t StringBuilderAppend::Builder::ConvertFpArgs() {
   for (uint32_t f = format_; f != 0u; f >>= kBitsPerArg) {
     DCHECK_LE(f & kArgMask, static_cast<uint32_t>(Argument::kLast));
     bool fp_arg = false;
+    size_t integral_fp_arg_length = 0u;
     ObjPtr<mirror::Object> converter;
     switch (static_cast<Argument>(f & kArgMask)) {
+      case Argument::kObject:
       case Argument::kString:
       case Argument::kBoolean:
       case Argument::kChar:
@@ -256,8 +347,12 @@ int32_t StringBuilderAppend::Builder::ConvertFpArgs() {
       case Argument::kFloat: {
         fp_arg = true;
         float arg = bit_cast<float>(*current_arg);
-        converter = WellKnownClasses::jdk_internal_math_FloatingDecimal_getBinaryToASCIIConverter_F
-            ->InvokeStatic<'L', 'F'>(hs_.Self(), arg);
+        integral_fp_arg_length = ConvertIntegralFpArg(arg, converted_fp_args_[fp_arg_index]);
+        if (integral_fp_arg_length == 0u) {
+          converter =
+              WellKnownClasses::jdk_internal_math_FloatingDecimal_getBinaryToASCIIConverter_F
+                  ->InvokeStatic<'L', 'F'>(hs_.Self(), arg);
+        }
         break;
       }
       case Argument::kDouble: {
@@ -265,14 +360,17 @@ int32_t StringBuilderAppend::Builder::ConvertFpArgs() {
         current_arg = AlignUp(current_arg, sizeof(int64_t));
         double arg = bit_cast<double>(
             static_cast<uint64_t>(current_arg[0]) + (static_cast<uint64_t>(current_arg[1]) << 32));
-        converter = WellKnownClasses::jdk_internal_math_FloatingDecimal_getBinaryToASCIIConverter_D
-            ->InvokeStatic<'L', 'D'>(hs_.Self(), arg);
+        integral_fp_arg_length = ConvertIntegralFpArg(arg, converted_fp_args_[fp_arg_index]);
+        if (integral_fp_arg_length == 0u) {
+          converter =
+              WellKnownClasses::jdk_internal_math_FloatingDecimal_getBinaryToASCIIConverter_D
+                  ->InvokeStatic<'L', 'D'>(hs_.Self(), arg);
+        }
         ++current_arg;  // Skip the low word, let the common code skip the high word.
         break;
       }
       case Argument::kStringBuilder:
       case Argument::kCharArray:
-      case Argument::kObject:
         LOG(FATAL) << "Unimplemented arg format: 0x" << std::hex
             << (f & kArgMask) << " full format: 0x" << std::hex << format_;
         UNREACHABLE();
@@ -281,7 +379,12 @@ int32_t StringBuilderAppend::Builder::ConvertFpArgs() {
             << (f & kArgMask) << " full format: 0x" << std::hex << format_;
         UNREACHABLE();
     }
-    if (fp_arg) {
+    if (integral_fp_arg_length != 0u) {
+      DCHECK(fp_arg);
+      converted_fp_arg_lengths_[fp_arg_index] = integral_fp_arg_length;
+      fp_args_length += integral_fp_arg_length;
+      ++fp_arg_index;
+    } else if (fp_arg) {
       // If we see an exception (presumably OOME or SOE), keep it as is, even
       // though it may be confusing to see the stack trace for FP argument
       // conversion continue at the StringBuilder.toString() invoke location.
@@ -343,6 +446,29 @@ inline int32_t StringBuilderAppend::Builder::CalculateLengthWithFlag() {
   for (uint32_t f = format_; f != 0u; f >>= kBitsPerArg) {
     DCHECK_LE(f & kArgMask, static_cast<uint32_t>(Argument::kLast));
     switch (static_cast<Argument>(f & kArgMask)) {
+      case Argument::kObject: {
+        Handle<mirror::Object> obj =
+            hs_.NewHandle(reinterpret_cast32<mirror::Object*>(*current_arg));
+        if (obj != nullptr) {
+          int64_t value;
+          switch (GetBoxedValue(obj.Get(), &value)) {
+            case Primitive::kPrimBoolean:
+              length += (value != 0) ? kTrueLength : kFalseLength;
+              break;
+            case Primitive::kPrimChar:
+              length += 1u;
+              compressible =
+                  compressible && mirror::String::IsASCII(dchecked_integral_cast<uint16_t>(value));
+              break;
+            default:
+              length += Int64Length(value);
+              break;
+          }
+        } else {
+          length += kNullLength;
+        }
+        break;
+      }
       case Argument::kString: {
         Handle<mirror::String> str =
             hs_.NewHandle(reinterpret_cast32<mirror::String*>(*current_arg));
@@ -386,7 +512,6 @@ inline int32_t StringBuilderAppend::Builder::CalculateLengthWithFlag() {
 
       case Argument::kStringBuilder:
       case Argument::kCharArray:
-      case Argument::kObject:
         LOG(FATAL) << "Unimplemented arg format: 0x" << std::hex
             << (f & kArgMask) << " full format: 0x" << std::hex << format_;
         UNREACHABLE();
@@ -429,6 +554,16 @@ inline void StringBuilderAppend::Builder::StoreData(ObjPtr<mirror::String> new_s
   for (uint32_t f = format_; f != 0u; f >>= kBitsPerArg) {
     DCHECK_LE(f & kArgMask, static_cast<uint32_t>(Argument::kLast));
     switch (static_cast<Argument>(f & kArgMask)) {
+      case Argument::kObject: {
+        ObjPtr<mirror::Object> obj = hs_.GetReference(handle_index);
+        ++handle_index;
+        if (obj != nullptr) {
+          data = AppendBoxedPrimitive(new_string, data, obj);
+        } else {
+          data = AppendLiteral(new_string, data, kNull);
+        }
+        break;
+      }
       case Argument::kString: {
         ObjPtr<mirror::String> str =
             ObjPtr<mirror::String>::DownCast(hs_.GetReference(handle_index));
@@ -36,7 +36,7 @@ class StringBuilderAppend {
  public:
   enum class Argument : uint8_t {
     kEnd = 0u,
-    kObject,
+    kObject,  // Only null or a boxed boolean, byte, char, short, int or long.
     kStringBuilder,
     kString,
     kCharArray,
@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "thin_lock_hash_codes.h"
+
+#include <vector>
+
+#include "gc/heap.h"
+#include "gc_root-inl.h"
+#include "mirror/object-inl.h"
+#include "object_callbacks.h"
+#include "runtime.h"
+#include "thread-current-inl.h"
+
+namespace art {
+
+bool ThinLockHashCodes::ThinLockHashed(Thread* self,
+                                       ObjPtr<mirror::Object> obj,
+                                       LockWord lock_word) {
+  DCHECK_EQ(lock_word.GetState(), LockWord::kHashCode);
+  uint64_t entry = MakeEntry(obj.Ptr(), lock_word.GetHashCode());
+  std::atomic<uint64_t>* slot = InsertInSlot(entry);
+  if (slot == nullptr) {
+    return false;
+  }
+  num_entries_.fetch_add(1u, std::memory_order_relaxed);
+  // The release orders the entry before the lock word for threads that inflate the lock.
+  LockWord thin_locked(LockWord::FromThinLockId(self->GetThreadId(), 0, lock_word.GCState()));
+  if (obj->CasLockWord(lock_word, thin_locked, CASMode::kStrong, std::memory_order_acq_rel)) {
+    return true;
+  }
+  // Free the slot again, unless the entry was claimed, removed or moved by the GC in the
+  // meantime. An entry left behind has the hash code of the object and is harmless.
+  if (slot->compare_exchange_strong(entry, 0u, std::memory_order_relaxed)) {
+    num_entries_.fetch_sub(1u, std::memory_order_relaxed);
+  }
+  return false;
+}
+
+uint32_t ThinLockHashCodes::GetHashCode(Thread* self, ObjPtr<mirror::Object> obj) {
+  std::atomic<uint64_t>* slot;
+  uint64_t entry;
+  uint32_t hash_code = Find(self, obj, &slot, &entry);
+  if (hash_code == 0u) {
+    return 0u;
+  }
+  LockWord lock_word = obj->GetLockWord(false);
+  if (lock_word.GetState() == LockWord::kUnlocked) {
+    // Put the hash code back into the lock word for the fast path. This may fail if the
+    // object was locked in the meantime, the entry stays then.
+    bool claimed = slot != nullptr &&
+                   (entry & kClaimedBit) == 0u &&
+                   slot->compare_exchange_strong(entry, entry | kClaimedBit,
+                                                 std::memory_order_relaxed);
+    LockWord hash_word = LockWord::FromHashCode(hash_code, lock_word.GCState());
+    bool success =
+        obj->CasLockWord(lock_word, hash_word, CASMode::kStrong, std::memory_order_relaxed);
+    if (claimed) {
+      // Threads that lock the object from now on add entries of their own. The CAS fails if the
+      // entry was removed or moved by the GC in the meantime.
+      uint64_t claimed_entry = entry | kClaimedBit;
+      if (success) {
+        if (slot->compare_exchange_strong(claimed_entry, 0u, std::memory_order_relaxed)) {
+          num_entries_.fetch_sub(1u, std::memory_order_relaxed);
+        }
+      } else {
+        slot->compare_exchange_strong(claimed_entry, entry, std::memory_order_relaxed);
+      }
+    }
+  }
+  return hash_code;
+}
+
+void ThinLockHashCodes::Remove(Thread* self, ObjPtr<mirror::Object> obj) {
+  uint32_t sequence = update_sequence_.load(std::memory_order_acquire);
+  for (size_t i = 0, index = FirstSlot(obj.Ptr()); i != kMaxProbes; ++i) {
+    std::atomic<uint64_t>& slot = slots_[(index + i) & (kNumSlots - 1u)];
+    uint64_t entry = slot.load(std::memory_order_relaxed);
+    if (entry != 0u && EntryObject(entry) == obj.Ptr() &&
+        slot.compare_exchange_strong(entry, 0u, std::memory_order_relaxed)) {
+      num_entries_.fetch_sub(1u, std::memory_order_relaxed);
+    }
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if ((sequence & 1u) == 0u &&
+      update_sequence_.load(std::memory_order_relaxed) == sequence &&
+      !MissNeedsLock(self)) {
+    return;
+  }
+  MutexLock mu(self, allow_disallow_lock_);
+  Wait(self);
+  MaybeUpdateKeysLocked(self);
+  uint64_t entry;
+  while (std::atomic<uint64_t>* slot = FindSlot(obj.Ptr(), &entry)) {
+    if (slot->compare_exchange_strong(entry, 0u, std::memory_order_relaxed)) {
+      num_entries_.fetch_sub(1u, std::memory_order_relaxed);
+    }
+  }
+  if (locked_entries_.erase(GcRoot<mirror::Object>(obj)) != 0u) {
+    num_entries_.fetch_sub(1u, std::memory_order_relaxed);
+    num_locked_entries_.store(locked_entries_.size(), std::memory_order_relaxed);
+  }
+}
+
+std::atomic<uint64_t>* ThinLockHashCodes::FindSlot(mirror::Object* obj, /*out*/ uint64_t* entry) {
+  for (size_t i = 0, index = FirstSlot(obj); i != kMaxProbes; ++i) {
+    std::atomic<uint64_t>& slot = slots_[(index + i) & (kNumSlots - 1u)];
+    // Pairs with the release of the lock word by the thread that inserted the entry.
+    uint64_t value = slot.load(std::memory_order_acquire);
+    if (value != 0u && EntryObject(value) == obj) {
+      *entry = value;
+      return &slot;
+    }
+  }
+  return nullptr;
+}
+
+std::atomic<uint64_t>* ThinLockHashCodes::InsertInSlot(uint64_t entry) {
+  for (size_t i = 0, index = FirstSlot(EntryObject(entry)); i != kMaxProbes; ++i) {
+    std::atomic<uint64_t>& slot = slots_[(index + i) & (kNumSlots - 1u)];
+    uint64_t expected = 0u;
+    if (slot.load(std::memory_order_relaxed) == 0u &&
+        slot.compare_exchange_strong(expected, entry, std::memory_order_release)) {
+      return &slot;
+    }
+  }
+  return nullptr;
+}
+
+uint32_t ThinLockHashCodes::Find(Thread* self,
+                                 ObjPtr<mirror::Object> obj,
+                                 /*out*/ std::atomic<uint64_t>** slot,
+                                 /*out*/ uint64_t* entry) {
+  // Like a sequence lock, a miss is only trusted if no entries were moved during the lookup.
+  uint32_t sequence = update_sequence_.load(std::memory_order_acquire);
+  *slot = FindSlot(obj.Ptr(), entry);
+  if (*slot != nullptr) {
+    return EntryHashCode(*entry);
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if ((sequence & 1u) == 0u &&
+      update_sequence_.load(std::memory_order_relaxed) == sequence &&
+      !MissNeedsLock(self)) {
+    return 0u;
+  }
+  MutexLock mu(self, allow_disallow_lock_);
+  Wait(self);
+  return FindLocked(self, obj);
+}
+
+bool ThinLockHashCodes::MissNeedsLock(Thread* self) {
+  if (num_locked_entries_.load(std::memory_order_relaxed) != 0u) {
+    return true;
+  }
+  // `obj` may be a to-space reference while the table still has the from-space reference.
+  return gUseReadBarrier &&
+         self->GetIsGcMarking() &&
+         keys_updated_gc_num_.load(std::memory_order_acquire) !=
+             Runtime::Current()->GetHeap()->GetCurrentGcNum();
+}
+
+void ThinLockHashCodes::MaybeUpdateKeysLocked(Thread* self) {
+  if (gUseReadBarrier && self->GetIsGcMarking()) {
+    uint32_t gc_num = Runtime::Current()->GetHeap()->GetCurrentGcNum();
+    if (keys_updated_gc_num_.load(std::memory_order_relaxed) != gc_num) {
+      // This keeps all objects of the table live for this cycle, like the JVMTI tag table.
+      UpdateKeys([](mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
+        return GcRoot<mirror::Object>(obj).Read<kWithReadBarrier>();
+      });
+      keys_updated_gc_num_.store(gc_num, std::memory_order_release);
+    }
+  }
+}
+
+uint32_t ThinLockHashCodes::FindLocked(Thread* self, ObjPtr<mirror::Object> obj) {
+  MaybeUpdateKeysLocked(self);
+  uint64_t entry;
+  if (FindSlot(obj.Ptr(), &entry) != nullptr) {
+    return EntryHashCode(entry);
+  }
+  auto it = locked_entries_.find(GcRoot<mirror::Object>(obj));
+  return (it != locked_entries_.end()) ? it->second : 0u;
+}
+
+template <typename Updater>
+void ThinLockHashCodes::UpdateKeys(Updater&& update) {
+  update_sequence_.fetch_add(1u, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  // An updated key may be equal to a key that is not updated yet, so the moved entries are
+  // inserted after the loop. The entries that did not fit into the slots are inserted again.
+  std::vector<std::pair<mirror::Object*, uint32_t>> moved;
+  for (std::atomic<uint64_t>& slot : slots_) {
+    // Mutators add and remove entries concurrently.
+    uint64_t entry = slot.load(std::memory_order_relaxed);
+    while (entry != 0u) {
+      mirror::Object* obj = EntryObject(entry);
+      mirror::Object* new_obj = update(obj);
+      if (new_obj == obj) {
+        break;
+      }
+      if (slot.compare_exchange_weak(entry, 0u, std::memory_order_relaxed)) {
+        if (new_obj != nullptr) {
+          moved.emplace_back(new_obj, EntryHashCode(entry));
+        } else {
+          num_entries_.fetch_sub(1u, std::memory_order_relaxed);
+        }
+        break;
+      }
+    }
+  }
+  for (const auto& entry : locked_entries_) {
+    mirror::Object* new_obj = update(entry.first.Read<kWithoutReadBarrier>());
+    if (new_obj != nullptr) {
+      moved.emplace_back(new_obj, entry.second);
+    } else {
+      num_entries_.fetch_sub(1u, std::memory_order_relaxed);
+    }
+  }
+  locked_entries_.clear();
+  for (const auto& [obj, hash_code] : moved) {
+    if (InsertInSlot(MakeEntry(obj, hash_code)) == nullptr &&
+        !locked_entries_.emplace(GcRoot<mirror::Object>(obj), hash_code).second) {
+      // Another entry of the object, which has the same hash code.
+      num_entries_.fetch_sub(1u, std::memory_order_relaxed);
+    }
+  }
+  num_locked_entries_.store(locked_entries_.size(), std::memory_order_relaxed);
+  update_sequence_.fetch_add(1u, std::memory_order_release);
+}
+
+void ThinLockHashCodes::Sweep(IsMarkedVisitor* visitor) {
+  MutexLock mu(Thread::Current(), allow_disallow_lock_);
+  UpdateKeys([visitor](mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
+    return visitor->IsMarked(obj);
+  });
+  if (gUseReadBarrier) {
+    // All keys are to-space references until the next GC cycle.
+    keys_updated_gc_num_.store(Runtime::Current()->GetHeap()->GetCurrentGcNum(),
+                               std::memory_order_release);
+  }
+}
+
+}  // namespace art
@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_THIN_LOCK_HASH_CODES_H_
+#define ART_RUNTIME_THIN_LOCK_HASH_CODES_H_
+
+#include <array>
+#include <atomic>
+#include <limits>
+#include <unordered_map>
+
+#include "base/bit_utils.h"
+#include "base/casts.h"
+#include "base/locks.h"
+#include "gc/system_weak.h"
+#include "gc_root.h"
+#include "lock_word.h"
+#include "obj_ptr.h"
+
+namespace art {
+
+class IsMarkedVisitor;
+class Thread;
+
+namespace mirror {
+class Object;
+}  // namespace mirror
+
+// Identity hash codes of objects that were thin-locked after being hashed. The lock word holds
+// either a thin lock or a hash code, so locking a hashed object used to inflate its lock into a
+// Monitor. Instead, the hash code moves to this table and the object is thin-locked.
+//
+// The unlock fast paths of the compiled code do not know about the table, so an entry stays
+// after the object is unlocked and a lock word that is unlocked without a hash code is only
+// trusted if the table has no entry for the object. Entries are removed when the hash code moves
+// back into the lock word, which happens when an unlocked object is hashed, when the hash code
+// moves into the monitor of an inflated lock, and when the object dies.
+//
+// The entries live in a fixed array of slots, each holding the compressed reference and the hash
+// code of an object in one word, so that lookups, insertions and removals do not take a lock. An
+// object is looked up in kMaxProbes slots from the index of its reference. Locking a hashed
+// object inflates it when these slots are full. Entries that the GC moves to slots that are
+// full go to a map guarded by the lock of the system weak holder, like the entries that are
+// being moved while the table is swept. Lookups that miss take the lock when there are such
+// entries, or when the keys may still be from-space references of the concurrent copying GC.
+//
+// Hashing an object that is already thin-locked still inflates it: the table cannot be kept
+// consistent with the Object::IdentityHashCode() fast path when the lock is released by the
+// unlock fast paths of the compiled code and a racing thread hashes the unlocked object.
+class ThinLockHashCodes : public gc::SystemWeakHolder {
+ public:
+  ThinLockHashCodes() : gc::SystemWeakHolder(kThinLockHashCodesLock) {}
+
+  // Whether the table may have entries, for the fast paths that found the lock word without a
+  // hash code. Orders the preceding read of the lock word before the read of the size, so that
+  // an unlocked or inflated lock word implies that its entry, if any, is visible.
+  bool MayHaveEntries() const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return num_entries_.load(std::memory_order_relaxed) != 0u;
+  }
+
+  // Thin-lock `obj` for `self`, moving the hash code of `lock_word` to the table. Returns false
+  // if the lock word of `obj` is no longer `lock_word`, or if the table has no slot for `obj`.
+  bool ThinLockHashed(Thread* self, ObjPtr<mirror::Object> obj, LockWord lock_word)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!allow_disallow_lock_);
+
+  // Returns the hash code of `obj` in the table, or 0 if it has none. The hash code of an
+  // unlocked object is put back into its lock word and its entry is removed.
+  uint32_t GetHashCode(Thread* self, ObjPtr<mirror::Object> obj)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!allow_disallow_lock_);
+
+  // Remove the entries of `obj`, whose hash code was moved to its monitor.
+  void Remove(Thread* self, ObjPtr<mirror::Object> obj)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!allow_disallow_lock_);
+
+  size_t Size() const {
+    return num_entries_.load(std::memory_order_relaxed);
+  }
+
+  void Sweep(IsMarkedVisitor* visitor) override
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!allow_disallow_lock_);
+
+ private:
+  static constexpr size_t kNumSlots = 1024u;
+  static constexpr size_t kMaxProbes = 8u;
+  static_assert(IsPowerOfTwo(kNumSlots));
+
+  struct HashGcRoot {
+    size_t operator()(const GcRoot<mirror::Object>& root) const
+        REQUIRES_SHARED(Locks::mutator_lock_) {
+      return reinterpret_cast<uintptr_t>(root.Read<kWithoutReadBarrier>());
+    }
+  };
+
+  struct EqGcRoot {
+    bool operator()(const GcRoot<mirror::Object>& lhs, const GcRoot<mirror::Object>& rhs) const
+        REQUIRES_SHARED(Locks::mutator_lock_) {
+      return lhs.Read<kWithoutReadBarrier>() == rhs.Read<kWithoutReadBarrier>();
+    }
+  };
+
+  using HashCodeMap = std::unordered_map<GcRoot<mirror::Object>, uint32_t, HashGcRoot, EqGcRoot>;
+
+  // A slot holds the compressed reference in the high half and the hash code in the low half,
+  // or 0 if it is free. The thread that puts the hash code back into the lock word claims the
+  // entry first, so that the slot cannot be freed and reused by another thread before it frees
+  // it.
+  static constexpr uint64_t kClaimedBit = UINT64_C(1) << 31;
+  static_assert(LockWord::kHashMask < kClaimedBit);
+
+  static uint64_t MakeEntry(mirror::Object* obj, uint32_t hash_code) {
+    DCHECK_LE(hash_code, static_cast<uint32_t>(LockWord::kHashMask));
+    return (static_cast<uint64_t>(reinterpret_cast32<uint32_t>(obj)) << 32) | hash_code;
+  }
+
+  static mirror::Object* EntryObject(uint64_t entry) {
+    return reinterpret_cast32<mirror::Object*>(static_cast<uint32_t>(entry >> 32));
+  }
+
+  static uint32_t EntryHashCode(uint64_t entry) {
+    return static_cast<uint32_t>(entry) & LockWord::kHashMask;
+  }
+
+  static size_t FirstSlot(mirror::Object* obj) {
+    // Fibonacci hashing, the low bits of the reference are zero.
+    constexpr size_t kShift = 32u - WhichPowerOf2(kNumSlots);
+    return (reinterpret_cast32<uint32_t>(obj) * 0x9e3779b9u) >> kShift;
+  }
+
+  // Returns the first slot that holds an entry of `obj` and stores the entry in `entry`, or
+  // returns null.
+  std::atomic<uint64_t>* FindSlot(mirror::Object* obj, /*out*/ uint64_t* entry);
+
+  // Stores `entry` in a free slot for its object and returns the slot, or returns null.
+  std::atomic<uint64_t>* InsertInSlot(uint64_t entry);
+
+  // Returns the hash code of `obj`, or 0 if it has none. The slot and the entry are stored in
+  // `slot` and `entry` if the entry was found without the lock, otherwise `slot` is null.
+  uint32_t Find(Thread* self,
+                ObjPtr<mirror::Object> obj,
+                /*out*/ std::atomic<uint64_t>** slot,
+                /*out*/ uint64_t* entry)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!allow_disallow_lock_);
+
+  // Whether a lookup that found no slot for an object must check the entries under the lock.
+  bool MissNeedsLock(Thread* self) REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Update the from-space keys of the concurrent copying GC, once per GC cycle.
+  void MaybeUpdateKeysLocked(Thread* self)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(allow_disallow_lock_);
+
+  uint32_t FindLocked(Thread* self, ObjPtr<mirror::Object> obj)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(allow_disallow_lock_);
+
+  // Replace the keys by the results of `update(object)`, removing the entries for which it
+  // returns null.
+  template <typename Updater>
+  void UpdateKeys(Updater&& update)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(allow_disallow_lock_);
+
+  std::array<std::atomic<uint64_t>, kNumSlots> slots_{};
+  HashCodeMap locked_entries_ GUARDED_BY(allow_disallow_lock_);
+  std::atomic<size_t> num_entries_{0u};
+  // The size of `locked_entries_`, for the lookups without the lock.
+  std::atomic<size_t> num_locked_entries_{0u};
+  // Odd while UpdateKeys() moves entries, so that lookups that miss take the lock.
+  std::atomic<uint32_t> update_sequence_{0u};
+  // Under concurrent copying, mutators may look up to-space references while the table still
+  // holds from-space references until it is swept. The keys are then updated with read barriers
+  // once per GC cycle, which is recorded with the number of the last completed GC.
+  std::atomic<uint32_t> keys_updated_gc_num_{std::numeric_limits<uint32_t>::max()};
+
+  DISALLOW_COPY_AND_ASSIGN(ThinLockHashCodes);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_THIN_LOCK_HASH_CODES_H_
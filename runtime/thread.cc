@@ -41,6 +41,7 @@
 #include "arch/context.h"
 #include "art_field-inl.h"
 #include "art_method-inl.h"
+#include "barrier.h"
 #include "base/atomic.h"
 #include "base/bit_utils.h"
 #include "base/casts.h"
@@ -55,6 +56,7 @@
 #include "base/utils.h"
 #include "class_linker-inl.h"
 #include "class_root-inl.h"
+#include "code_info_cache.h"
 #include "debugger.h"
 #include "dex/descriptors_names.h"
 #include "dex/dex_file-inl.h"
@@ -64,6 +66,7 @@
 #include "entrypoints/quick/quick_alloc_entrypoints.h"
 #include "gc/accounting/card_table-inl.h"
 #include "gc/accounting/heap_bitmap-inl.h"
+#include "gc/allocation_histogram.h"
 #include "gc/allocator/rosalloc.h"
 #include "gc/heap.h"
 #include "gc/space/space-inl.h"
@@ -108,6 +111,7 @@
 #include "stack_map.h"
 #include "thread-inl.h"
 #include "thread_list.h"
+#include "thread_stack_cache.h"
 #include "trace.h"
 #include "verify_object.h"
 #include "well_known_classes-inl.h"
@@ -617,6 +621,9 @@ void* Thread::CreateCallback(void* arg) {
   Runtime* runtime = Runtime::Current();
   if (runtime == nullptr) {
     LOG(ERROR) << "Thread attaching to non-existent runtime: " << *self;
+    if (self->cached_stack_.IsValid()) {
+      ThreadStackCache::GetInstance()->ThreadExiting(self->cached_stack_);
+    }
     return nullptr;
   }
   {
@@ -670,7 +677,11 @@ void* Thread::CreateCallback(void* arg) {
     WellKnownClasses::java_lang_Thread_run->InvokeVirtual<'V'>(self, receiver);
   }
   // Detach and delete self.
+  ThreadStackCache::Stack cached_stack = self->cached_stack_;
   Runtime::Current()->GetThreadList()->Unregister(self, /* should_run_callbacks= */ true);
+  if (cached_stack.IsValid()) {
+    ThreadStackCache::GetInstance()->ThreadExiting(cached_stack);
+  }
 
   return nullptr;
 }
@@ -912,9 +923,23 @@ void Thread::CreateNativeThread(JNIEnv* env, jobject java_peer, size_t stack_siz
     pthread_attr_t attr;
     child_thread->tlsPtr_.tmp_jni_env = child_jni_env_ext.get();
     CHECK_PTHREAD_CALL(pthread_attr_init, (&attr), "new thread");
-    CHECK_PTHREAD_CALL(pthread_attr_setdetachstate, (&attr, PTHREAD_CREATE_DETACHED),
-                       "PTHREAD_CREATE_DETACHED");
-    CHECK_PTHREAD_CALL(pthread_attr_setstacksize, (&attr, stack_size), stack_size);
+    if (ThreadStackCache::IsSupported()) {
+      // Match the protected region that InitStackHwm() would install.
+      bool implicit_stack_check =
+          runtime->GetImplicitStackOverflowChecks() && !runtime->IsAotCompiler();
+      child_thread->cached_stack_ = ThreadStackCache::GetInstance()->Acquire(
+          stack_size, implicit_stack_check ? kStackOverflowProtectedSize : 0u);
+    }
+    if (child_thread->cached_stack_.IsValid()) {
+      // The thread is joined by the next exiting thread, see ThreadStackCache.
+      const ThreadStackCache::Stack& stack = child_thread->cached_stack_;
+      CHECK_PTHREAD_CALL(pthread_attr_setstack, (&attr, stack.begin, stack.size), stack.size);
+      CHECK_PTHREAD_CALL(pthread_attr_setguardsize, (&attr, 0u), "guard size");
+    } else {
+      CHECK_PTHREAD_CALL(pthread_attr_setdetachstate, (&attr, PTHREAD_CREATE_DETACHED),
+                         "PTHREAD_CREATE_DETACHED");
+      CHECK_PTHREAD_CALL(pthread_attr_setstacksize, (&attr, stack_size), stack_size);
+    }
     pthread_create_result = pthread_create(&new_pthread,
                                            &attr,
                                            gUseUserfaultfd ? Thread::CreateCallbackWithUffdGc
@@ -940,6 +965,9 @@ void Thread::CreateNativeThread(JNIEnv* env, jobject java_peer, size_t stack_siz
   // Manually delete the global reference since Thread::Init will not have been run. Make sure
   // nothing can observe both opeer and jpeer set at the same time.
   child_thread->DeleteJPeer(env);
+  if (child_thread->cached_stack_.IsValid()) {
+    ThreadStackCache::GetInstance()->Release(child_thread->cached_stack_);
+  }
   delete child_thread;
   child_thread = nullptr;
   // TODO: remove from thread group?
@@ -1380,7 +1408,15 @@ bool Thread::InitStackHwm() {
     tlsPtr_.stack_end += read_guard_size + kStackOverflowProtectedSize;
     tlsPtr_.stack_size -= read_guard_size + kStackOverflowProtectedSize;
 
-    InstallImplicitProtection();
+    // A stack from the ThreadStackCache already has the protected region.
+    bool has_protected_region =
+        cached_stack_.IsValid() &&
+        cached_stack_.begin == read_stack_base &&
+        read_guard_size == 0u &&
+        cached_stack_.protected_size == kStackOverflowProtectedSize;
+    if (!has_protected_region) {
+      InstallImplicitProtection();
+    }
   }
 
   // Consistency check.
@@ -1580,6 +1616,9 @@ bool Thread::PassActiveSuspendBarriers(Thread* self) {
           futex(pending_threads->Address(), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
         }
 #endif
+        if (done && (cur_val - 1) == 0) {
+          Runtime::Current()->GetThreadList()->SetLastThreadToSuspend(GetThreadId());
+        }
       } while (!done);
       ++barrier_count;
     }
@@ -2600,6 +2639,7 @@ void Thread::Destroy(bool should_run_callbacks) {
   {
     ScopedObjectAccess soa(self);
     Runtime::Current()->GetHeap()->RevokeThreadLocalBuffers(this);
+    Runtime::Current()->GetHeap()->GetAllocationHistogram()->FlushThread(this);
   }
   // Mark-stack revocation must be performed at the very end. No
   // checkpoint/flip-function or read-barrier should be called after this.
@@ -2651,6 +2691,8 @@ Thread::~Thread() {
     delete[] tlsPtr_.method_trace_buffer;
   }
 
+  delete tlsPtr_.allocation_samples;
+
   Runtime::Current()->GetHeap()->AssertThreadLocalBuffersAreRevoked(this);
 
   TearDownAlternateSignalStack();
@@ -3725,6 +3767,8 @@ void Thread::DumpThreadOffset(std::ostream& os, uint32_t offset) {
   QUICK_ENTRY_POINT_INFO(pAllocStringFromBytes)
   QUICK_ENTRY_POINT_INFO(pAllocStringFromChars)
   QUICK_ENTRY_POINT_INFO(pAllocStringFromString)
+  QUICK_ENTRY_POINT_INFO(pAllocObjectNonMoving)
+  QUICK_ENTRY_POINT_INFO(pAllocArrayNonMoving)
   QUICK_ENTRY_POINT_INFO(pInstanceofNonTrivial)
   QUICK_ENTRY_POINT_INFO(pCheckInstanceOf)
   QUICK_ENTRY_POINT_INFO(pInitializeStaticStorage)
@@ -4016,7 +4060,9 @@ class ReferenceMapVisitor : public StackVisitor {
       // to know the inlined frames.
       : StackVisitor(thread, context, StackVisitor::StackWalkKind::kSkipInlinedFrames),
         visitor_(visitor),
-        visit_declaring_class_(!Runtime::Current()->GetHeap()->IsPerformingUffdCompaction()) {}
+        visit_declaring_class_(!Runtime::Current()->GetHeap()->IsPerformingUffdCompaction()),
+        code_info_cache_(Thread::Current() != nullptr ? Thread::Current()->GetCodeInfoCache()
+                                                      : nullptr) {}
 
   bool VisitFrame() override REQUIRES_SHARED(Locks::mutator_lock_) {
     if (false) {
@@ -4195,10 +4241,16 @@ class ReferenceMapVisitor : public StackVisitor {
       StackReference<mirror::Object>* vreg_base =
           reinterpret_cast<StackReference<mirror::Object>*>(cur_quick_frame);
       uintptr_t native_pc_offset = method_header->NativeQuickPcOffset(GetCurrentQuickFramePc());
-      CodeInfo code_info = kPrecise
-          ? CodeInfo(method_header)  // We will need dex register maps.
-          : CodeInfo::DecodeGcMasksOnly(method_header);
-      StackMap map = code_info.GetStackMapForNativePcOffset(native_pc_offset);
+      // The cache of the visiting thread keeps the decoded code info and the stack maps of the
+      // frames seen at previous root visits.
+      CodeInfo code_info = (code_info_cache_ != nullptr)
+          ? code_info_cache_->Get(method_header)
+          : (kPrecise ? CodeInfo(method_header)  // We will need dex register maps.
+                      : CodeInfo::DecodeGcMasksOnly(method_header));
+      StackMap map = (code_info_cache_ != nullptr)
+          ? code_info_cache_->GetStackMapForNativePcOffset(
+                method_header, code_info, dchecked_integral_cast<uint32_t>(native_pc_offset))
+          : code_info.GetStackMapForNativePcOffset(native_pc_offset);
       DCHECK(map.IsValid());
 
       T vreg_info(m, code_info, map, visitor_);
@@ -4355,6 +4407,8 @@ class ReferenceMapVisitor : public StackVisitor {
   // Visitor for when we visit a root.
   RootVisitor& visitor_;
   bool visit_declaring_class_;
+  // Null if the visiting thread is not attached.
+  CodeInfoCache* const code_info_cache_;
 };
 
 class RootCallbackVisitor {
@@ -4512,6 +4566,19 @@ void Thread::SweepInterpreterCache(IsMarkedVisitor* visitor) {
   for (InterpreterCache::Entry& entry : GetInterpreterCache()->GetArray()) {
     SweepCacheEntry(visitor, reinterpret_cast<const Instruction*>(entry.first), &entry.second);
   }
+  for (InterpreterCache::InlineCacheEntry& entry : GetInterpreterCache()->GetInlineCaches()) {
+    // Give the sites that missed too often another chance.
+    entry.misses = 0u;
+    if (entry.key == nullptr) {
+      continue;
+    }
+    mirror::Object* new_class = visitor->IsMarked(entry.receiver_class);
+    if (new_class == nullptr) {
+      entry.key = nullptr;
+    } else if (new_class != entry.receiver_class) {
+      entry.receiver_class = down_cast<mirror::Class*>(new_class);
+    }
+  }
 }
 
 // FIXME: clang-r433403 reports the below function exceeds frame size limit.
@@ -4728,6 +4795,18 @@ void Thread::SetReadBarrierEntrypoints() {
   UpdateReadBarrierEntrypoints(&tlsPtr_.quick_entrypoints, /* is_active=*/ true);
 }
 
+void Thread::SetTraceMethodIdCache(std::unique_ptr<TraceMethodIdCache> cache) {
+  trace_method_id_cache_ = std::move(cache);
+}
+
+CodeInfoCache* Thread::GetCodeInfoCache() {
+  DCHECK(this == Thread::Current());
+  if (code_info_cache_ == nullptr) {
+    code_info_cache_ = std::make_unique<CodeInfoCache>();
+  }
+  return code_info_cache_.get();
+}
+
 void Thread::ClearAllInterpreterCaches() {
   static struct ClearInterpreterCacheClosure : Closure {
     void Run(Thread* thread) override {
@@ -4737,6 +4816,40 @@ void Thread::ClearAllInterpreterCaches() {
   Runtime::Current()->GetThreadList()->RunCheckpoint(&closure);
 }
 
+void Thread::ClearInterpreterCaches(const std::vector<const DexFile*>& dex_files) {
+  class ClearInterpreterCacheRangesClosure : public Closure {
+   public:
+    ClearInterpreterCacheRangesClosure(const std::vector<const DexFile*>& dex_files,
+                                       Barrier* barrier)
+        : dex_files_(dex_files), barrier_(barrier) {}
+
+    void Run(Thread* thread) override {
+      InterpreterCache* cache = thread->GetInterpreterCache();
+      for (const DexFile* dex_file : dex_files_) {
+        if (dex_file != nullptr) {
+          // Code items are in the data section, which is separate for compact dex.
+          cache->ClearRange(thread, dex_file->Begin(), dex_file->Begin() + dex_file->Size());
+          cache->ClearRange(
+              thread, dex_file->DataBegin(), dex_file->DataBegin() + dex_file->DataSize());
+        }
+      }
+      barrier_->Pass(Thread::Current());
+    }
+
+   private:
+    const std::vector<const DexFile*>& dex_files_;
+    Barrier* const barrier_;
+  };
+
+  Thread* self = Thread::Current();
+  Barrier barrier(0);
+  ClearInterpreterCacheRangesClosure closure(dex_files, &barrier);
+  size_t threads_running_checkpoint = Runtime::Current()->GetThreadList()->RunCheckpoint(&closure);
+  if (threads_running_checkpoint != 0) {
+    barrier.Increment(self, threads_running_checkpoint);
+  }
+}
+
 
 void Thread::ReleaseLongJumpContextInternal() {
   // Each QuickExceptionHandler gets a long jump context and uses
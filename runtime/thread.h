@@ -47,6 +47,7 @@
 #include "reflective_handle_scope.h"
 #include "runtime_globals.h"
 #include "runtime_stats.h"
+#include "thread_stack_cache.h"
 #include "thread_state.h"
 
 namespace unwindstack {
@@ -56,6 +57,7 @@ class AndroidLocalUnwinder;
 namespace art {
 
 namespace gc {
+struct ThreadAllocationSamples;
 namespace accounting {
 template<class T> class AtomicStack;
 }  // namespace accounting
@@ -89,6 +91,7 @@ class ArtMethod;
 class BaseMutex;
 class ClassLinker;
 class Closure;
+class CodeInfoCache;
 class Context;
 class DeoptimizationContextRecord;
 class DexFile;
@@ -104,6 +107,7 @@ class StackedShadowFrameRecord;
 enum class SuspendReason : char;
 class Thread;
 class ThreadList;
+class TraceMethodIdCache;
 enum VisitRootFlags : uint8_t;
 
 // A piece of data that can be held in the CustomTls. The destructor will be called during thread
@@ -1230,6 +1234,12 @@ class Thread {
     tlsPtr_.method_trace_buffer_index = 0;
   }
 
+  TraceMethodIdCache* GetTraceMethodIdCache() {
+    return trace_method_id_cache_.get();
+  }
+
+  void SetTraceMethodIdCache(std::unique_ptr<TraceMethodIdCache> cache);
+
   uint64_t GetTraceClockBase() const {
     return tls64_.trace_clock_base;
   }
@@ -1291,6 +1301,32 @@ class Thread {
   // Doesn't check that there is room.
   mirror::Object* AllocTlab(size_t bytes);
   void SetTlab(uint8_t* start, uint8_t* end, uint8_t* limit);
+  size_t GetAdaptiveTlabSize() const {
+    return tlsPtr_.adaptive_tlab_size;
+  }
+  void SetAdaptiveTlabSize(size_t size) {
+    tlsPtr_.adaptive_tlab_size = size;
+  }
+  // Statistics of the TLAB refills since GC number `GetTlabRefillGcNum()`.
+  size_t GetTlabRefillBytes() const {
+    return tlsPtr_.tlab_refill_bytes;
+  }
+  uint32_t GetTlabRefillGcNum() const {
+    return static_cast<uint32_t>(tlsPtr_.tlab_refill_gc_num);
+  }
+  void AddTlabRefillBytes(size_t bytes) {
+    tlsPtr_.tlab_refill_bytes += bytes;
+  }
+  void ResetTlabRefillStats(uint32_t gc_num) {
+    tlsPtr_.tlab_refill_bytes = 0;
+    tlsPtr_.tlab_refill_gc_num = gc_num;
+  }
+  gc::ThreadAllocationSamples* GetAllocationSamples() const {
+    return tlsPtr_.allocation_samples;
+  }
+  void SetAllocationSamples(gc::ThreadAllocationSamples* samples) {
+    tlsPtr_.allocation_samples = samples;
+  }
   bool HasTlab() const;
   void ResetTlab();
   uint8_t* GetTlabStart() {
@@ -1436,6 +1472,9 @@ class Thread {
     return &interpreter_cache_;
   }
 
+  // Must only be called from the owning thread.
+  CodeInfoCache* GetCodeInfoCache();
+
   // Clear all thread-local interpreter caches.
   //
   // Since the caches are keyed by memory pointer to dex instructions, this must be
@@ -1446,13 +1485,20 @@ class Thread {
   // called if the pre-conditions might no longer hold true.
   static void ClearAllInterpreterCaches();
 
+  // Clear the entries for instructions of `dex_files` from all thread-local interpreter
+  // caches and wait for all threads to do so. This is enough when unloading the dex files,
+  // the entries of other dex files do not depend on them.
+  static void ClearInterpreterCaches(const std::vector<const DexFile*>& dex_files)
+      REQUIRES(!Locks::mutator_lock_);
+
   template<PointerSize pointer_size>
   static constexpr ThreadOffset<pointer_size> InterpreterCacheOffset() {
     return ThreadOffset<pointer_size>(OFFSETOF_MEMBER(Thread, interpreter_cache_));
   }
 
+  // Log2 of the number of sets, nterp indexes the sets with that many bits of the dex pc.
   static constexpr int InterpreterCacheSizeLog2() {
-    return WhichPowerOf2(InterpreterCache::kSize);
+    return WhichPowerOf2(InterpreterCache::kNumSets);
   }
 
   static constexpr uint32_t AllThreadFlags() {
@@ -1774,10 +1820,13 @@ class Thread {
   /***********************************************************************************************/
   // Thread local storage. Fields are grouped by size to enable 32 <-> 64 searching to account for
   // pointer size differences. To encourage shorter encoding, more frequently used values appear
-  // first if possible.
+  // first if possible. The fields used by compiled code, nterp and the allocation and read
+  // barrier fast paths are kept at the start of `tls32_` and `tlsPtr_` so that they share a few
+  // cache lines; `tls64_` only holds debugging and statistics data and is placed after `tlsPtr_`.
   /***********************************************************************************************/
 
-  struct PACKED(4) tls_32bit_sized_values {
+  // Aligned to 8 bytes so that `tlsPtr_` starts at the same offset for all pointer sizes.
+  struct PACKED(8) tls_32bit_sized_values {
     // We have no control over the size of 'bool', but want our boolean fields
     // to be 4-byte quantities.
     using bool32_t = uint32_t;
@@ -1794,14 +1843,14 @@ class Thread {
           is_transitioning_to_runnable(false),
           is_gc_marking(false),
           is_deopt_check_required(false),
+          shared_method_hotness(kSharedMethodHotnessThreshold),
           weak_ref_access_enabled(WeakRefAccessState::kVisiblyEnabled),
           disable_thread_flip_count(0),
           user_code_suspend_count(0),
           force_interpreter_count(0),
           make_visibly_initialized_counter(0),
           define_class_counter(0),
-          num_name_readers(0),
-          shared_method_hotness(kSharedMethodHotnessThreshold)
+          num_name_readers(0)
         {}
 
     // The state and flags field must be changed atomically so that flag values aren't lost.
@@ -1854,6 +1903,14 @@ class Thread {
     // set to false.
     bool32_t is_deopt_check_required;
 
+    // Thread-local hotness counter for shared memory methods. Initialized with
+    // `kSharedMethodHotnessThreshold`. The interpreter decrements it and goes
+    // into the runtime when hitting zero. Note that all previous decrements
+    // could have been executed by another method than the one seeing zero.
+    // There is a second level counter in `Jit::shared_method_counters_` to make
+    // sure we at least have a few samples before compiling a method.
+    uint32_t shared_method_hotness;
+
     // Thread "interrupted" status; stays raised until queried or thrown.
     Atomic<bool32_t> interrupted;
 
@@ -1902,26 +1959,8 @@ class Thread {
     // retrieved.
     mutable std::atomic<uint32_t> num_name_readers;
     static_assert(std::atomic<uint32_t>::is_always_lock_free);
-
-    // Thread-local hotness counter for shared memory methods. Initialized with
-    // `kSharedMethodHotnessThreshold`. The interpreter decrements it and goes
-    // into the runtime when hitting zero. Note that all previous decrements
-    // could have been executed by another method than the one seeing zero.
-    // There is a second level counter in `Jit::shared_method_counters_` to make
-    // sure we at least have a few samples before compiling a method.
-    uint32_t shared_method_hotness;
   } tls32_;
 
-  struct PACKED(8) tls_64bit_sized_values {
-    tls_64bit_sized_values() : trace_clock_base(0) {
-    }
-
-    // The clock base used for tracing.
-    uint64_t trace_clock_base;
-
-    RuntimeStats stats;
-  } tls64_;
-
   struct PACKED(sizeof(void*)) tls_ptr_sized_values {
       tls_ptr_sized_values() : card_table(nullptr),
                                exception(nullptr),
@@ -1931,6 +1970,15 @@ class Thread {
                                jni_env(nullptr),
                                tmp_jni_env(nullptr),
                                self(nullptr),
+                               thread_local_pos(nullptr),
+                               thread_local_end(nullptr),
+                               thread_local_start(nullptr),
+                               thread_local_limit(nullptr),
+                               thread_local_objects(0),
+                               thread_local_alloc_stack_top(nullptr),
+                               thread_local_alloc_stack_end(nullptr),
+                               mutator_lock(nullptr),
+                               thread_local_mark_stack(nullptr),
                                opeer(nullptr),
                                jpeer(nullptr),
                                stack_begin(nullptr),
@@ -1947,21 +1995,16 @@ class Thread {
                                name(nullptr),
                                pthread_self(0),
                                last_no_thread_suspension_cause(nullptr),
-                               thread_local_start(nullptr),
-                               thread_local_pos(nullptr),
-                               thread_local_end(nullptr),
-                               thread_local_limit(nullptr),
-                               thread_local_objects(0),
                                checkpoint_function(nullptr),
-                               thread_local_alloc_stack_top(nullptr),
-                               thread_local_alloc_stack_end(nullptr),
-                               mutator_lock(nullptr),
                                flip_function(nullptr),
-                               thread_local_mark_stack(nullptr),
                                async_exception(nullptr),
                                top_reflective_handle_scope(nullptr),
                                method_trace_buffer(nullptr),
-                               method_trace_buffer_index(0) {
+                               method_trace_buffer_index(0),
+                               adaptive_tlab_size(0),
+                               tlab_refill_bytes(0),
+                               tlab_refill_gc_num(0),
+                               allocation_samples(nullptr) {
       std::fill(held_mutexes, held_mutexes + kLockLevelCount, nullptr);
     }
 
@@ -1994,6 +2037,38 @@ class Thread {
     // Thread::Current to give the address.
     Thread* self;
 
+    // thread_local_pos and thread_local_end must be consecutive for ldrd and are 8 byte aligned for
+    // potentially better performance. They directly follow `self` to keep them 8 byte aligned on
+    // ARM and close to the other fields used by compiled code.
+    uint8_t* thread_local_pos;
+    uint8_t* thread_local_end;
+
+    // Thread-local allocation pointer.
+    uint8_t* thread_local_start;
+
+    // Thread local limit is how much we can expand the thread local buffer to, it is greater or
+    // equal to thread_local_end.
+    uint8_t* thread_local_limit;
+
+    size_t thread_local_objects;
+
+    // Thread-local allocation stack data/routines.
+    StackReference<mirror::Object>* thread_local_alloc_stack_top;
+    StackReference<mirror::Object>* thread_local_alloc_stack_end;
+
+    // Pointer to the mutator lock.
+    // This is the same as `Locks::mutator_lock_` but cached for faster state transitions.
+    MutatorMutex* mutator_lock;
+
+    union {
+      // Thread-local mark stack for the concurrent copying collector.
+      gc::accounting::AtomicStack<mirror::Object>* thread_local_mark_stack;
+      // Thread-local page-sized buffer for userfaultfd GC.
+      uint8_t* thread_local_gc_buffer;
+    };
+
+    // Fields below are not used on the allocation, suspend check and read barrier fast paths.
+
     // Our managed peer (an instance of java.lang.Thread). The jobject version is used during thread
     // start up, until the thread is registered and the local opeer_ is used.
     mirror::Object* opeer;
@@ -2065,20 +2140,6 @@ class Thread {
     // to avoid additional cost of a mutex and a condition variable, as used in art::Barrier.
     AtomicInteger* active_suspend_barriers[kMaxSuspendBarriers];
 
-    // Thread-local allocation pointer. Moved here to force alignment for thread_local_pos on ARM.
-    uint8_t* thread_local_start;
-
-    // thread_local_pos and thread_local_end must be consecutive for ldrd and are 8 byte aligned for
-    // potentially better performance.
-    uint8_t* thread_local_pos;
-    uint8_t* thread_local_end;
-
-    // Thread local limit is how much we can expand the thread local buffer to, it is greater or
-    // equal to thread_local_end.
-    uint8_t* thread_local_limit;
-
-    size_t thread_local_objects;
-
     // Pending checkpoint function or null if non-pending. If this checkpoint is set and someone\
     // requests another checkpoint, it goes to the checkpoint overflow list.
     Closure* checkpoint_function GUARDED_BY(Locks::thread_suspend_count_lock_);
@@ -2091,27 +2152,12 @@ class Thread {
     // There are RosAlloc::kNumThreadLocalSizeBrackets thread-local size brackets per thread.
     void* rosalloc_runs[kNumRosAllocThreadLocalSizeBracketsInThread];
 
-    // Thread-local allocation stack data/routines.
-    StackReference<mirror::Object>* thread_local_alloc_stack_top;
-    StackReference<mirror::Object>* thread_local_alloc_stack_end;
-
-    // Pointer to the mutator lock.
-    // This is the same as `Locks::mutator_lock_` but cached for faster state transitions.
-    MutatorMutex* mutator_lock;
-
     // Support for Mutex lock hierarchy bug detection.
     BaseMutex* held_mutexes[kLockLevelCount];
 
     // The function used for thread flip.
     Closure* flip_function;
 
-    union {
-      // Thread-local mark stack for the concurrent copying collector.
-      gc::accounting::AtomicStack<mirror::Object>* thread_local_mark_stack;
-      // Thread-local page-sized buffer for userfaultfd GC.
-      uint8_t* thread_local_gc_buffer;
-    };
-
     // The pending async-exception or null.
     mirror::Throwable* async_exception;
 
@@ -2123,8 +2169,29 @@ class Thread {
 
     // The index of the next free entry in method_trace_buffer.
     size_t method_trace_buffer_index;
+
+    // The TLAB size adapted to this thread's allocation rate, or 0 until it
+    // has been computed. See Heap::GetAdaptiveTlabSize().
+    size_t adaptive_tlab_size;
+
+    // Bytes of TLABs handed to this thread since GC number `tlab_refill_gc_num`.
+    size_t tlab_refill_bytes;
+    size_t tlab_refill_gc_num;
+
+    // Allocation samples not yet merged into the heap's allocation histogram.
+    gc::ThreadAllocationSamples* allocation_samples;
   } tlsPtr_;
 
+  struct PACKED(8) tls_64bit_sized_values {
+    tls_64bit_sized_values() : trace_clock_base(0) {
+    }
+
+    // The clock base used for tracing.
+    uint64_t trace_clock_base;
+
+    RuntimeStats stats;
+  } tls64_;
+
   // Small thread-local cache to be used from the interpreter.
   // It is keyed by dex instruction pointer.
   // The value is opcode-depended (e.g. field offset).
@@ -2169,6 +2236,16 @@ class Thread {
   // the caller is allowed to access all fields and methods in the Core Platform API.
   uint32_t core_platform_api_cookie_ = 0;
 
+  // Recently decoded code info of compiled frames, allocated on first use by a stack walk.
+  std::unique_ptr<CodeInfoCache> code_info_cache_;
+
+  // Method ids of the trace buffer, see Trace::RecordMethodEvent().
+  std::unique_ptr<TraceMethodIdCache> trace_method_id_cache_;
+
+  // The stack of a thread created by CreateNativeThread() if it comes from the ThreadStackCache,
+  // with its protected region already installed.
+  ThreadStackCache::Stack cached_stack_;
+
   friend class gc::collector::SemiSpace;  // For getting stack traces.
   friend class Runtime;  // For CreatePeer.
   friend class QuickExceptionHandler;  // For dumping the stack.
@@ -20,6 +20,8 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
 #include <map>
 #include <sstream>
 #include <tuple>
@@ -51,6 +53,7 @@
 #include "obj_ptr-inl.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread.h"
+#include "thread_pool.h"
 #include "trace.h"
 #include "well_known_classes.h"
 
@@ -81,6 +84,7 @@ ThreadList::ThreadList(uint64_t thread_suspend_timeout_ns)
       unregistering_count_(0),
       suspend_all_historam_("suspend all histogram", 16, 64),
       long_suspend_(false),
+      last_thread_to_suspend_(0u),
       shut_down_(false),
       thread_suspend_timeout_ns_(thread_suspend_timeout_ns),
       empty_checkpoint_barrier_(new Barrier(0)) {
@@ -323,7 +327,60 @@ static void ThreadSuspendSleep(useconds_t delay_us) {
   }
 }
 
-size_t ThreadList::RunCheckpoint(Closure* checkpoint_function, Closure* callback) {
+// Below this number of suspended threads, waking up the workers of the thread pool takes longer
+// than visiting the threads on the calling thread.
+static constexpr size_t kMinThreadsForParallelVisit = 8u;
+
+void ThreadList::VisitSuspendedThreads(Thread* self,
+                                       const std::vector<Thread*>& threads,
+                                       ThreadPool* thread_pool,
+                                       const std::function<void(Thread*, Thread*)>& visit) {
+  if (thread_pool == nullptr ||
+      thread_pool->GetThreadCount() == 0u ||
+      threads.size() < kMinThreadsForParallelVisit) {
+    for (Thread* thread : threads) {
+      visit(self, thread);
+    }
+    return;
+  }
+  // The workers are suspended threads as well. Visit them after they stopped, so that no
+  // worker is visited while it is visiting another thread.
+  std::vector<Thread*> worker_threads;
+  std::vector<Thread*> other_threads;
+  other_threads.reserve(threads.size());
+  const std::vector<ThreadPoolWorker*>& workers = thread_pool->GetWorkers();
+  for (Thread* thread : threads) {
+    auto is_worker = [thread](ThreadPoolWorker* worker) { return worker->GetThread() == thread; };
+    if (std::any_of(workers.begin(), workers.end(), is_worker)) {
+      worker_threads.push_back(thread);
+    } else {
+      other_threads.push_back(thread);
+    }
+  }
+  // The stack depths differ too much for static partitioning, claim one thread at a time.
+  std::atomic<size_t> next_thread(0u);
+  auto visit_threads = [&](Thread* worker) NO_THREAD_SAFETY_ANALYSIS {
+    for (size_t i = next_thread.fetch_add(1u, std::memory_order_relaxed);
+         i < other_threads.size();
+         i = next_thread.fetch_add(1u, std::memory_order_relaxed)) {
+      visit(worker, other_threads[i]);
+    }
+  };
+  for (size_t i = 0, num_tasks = thread_pool->GetThreadCount(); i != num_tasks; ++i) {
+    thread_pool->AddTask(self, new FunctionTask(visit_threads));
+  }
+  thread_pool->StartWorkers(self);
+  visit_threads(self);
+  thread_pool->Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ true);
+  thread_pool->StopWorkers(self);
+  for (Thread* thread : worker_threads) {
+    visit(self, thread);
+  }
+}
+
+size_t ThreadList::RunCheckpoint(Closure* checkpoint_function,
+                                 Closure* callback,
+                                 ThreadPool* thread_pool) {
   Thread* self = Thread::Current();
   Locks::mutator_lock_->AssertNotExclusiveHeld(self);
   Locks::thread_list_lock_->AssertNotHeld(self);
@@ -389,23 +446,22 @@ size_t ThreadList::RunCheckpoint(Closure* checkpoint_function, Closure* callback
   checkpoint_function->Run(self);
 
   // Run the checkpoint on the suspended threads.
-  for (const auto& thread : suspended_count_modified_threads) {
-    // We know for sure that the thread is suspended at this point.
-    DCHECK(thread->IsSuspended());
-    checkpoint_function->Run(thread);
-    {
-      MutexLock mu2(self, *Locks::thread_suspend_count_lock_);
-      bool updated = thread->ModifySuspendCount(self, -1, nullptr, SuspendReason::kInternal);
-      DCHECK(updated);
-    }
-  }
-
-  {
-    // Imitate ResumeAll, threads may be waiting on Thread::resume_cond_ since we raised their
-    // suspend count. Now the suspend_count_ is lowered so we must do the broadcast.
-    MutexLock mu2(self, *Locks::thread_suspend_count_lock_);
-    Thread::resume_cond_->Broadcast(self);
-  }
+  VisitSuspendedThreads(self,
+                        suspended_count_modified_threads,
+                        thread_pool,
+                        [checkpoint_function](Thread* worker, Thread* thread) {
+                          // We know for sure that the thread is suspended at this point.
+                          DCHECK(thread->IsSuspended());
+                          checkpoint_function->Run(thread);
+                          // Resume the thread right away, a later closure may wait for it.
+                          MutexLock mu2(worker, *Locks::thread_suspend_count_lock_);
+                          bool updated = thread->ModifySuspendCount(
+                              worker, -1, nullptr, SuspendReason::kInternal);
+                          DCHECK(updated);
+                          // Imitate ResumeAll, the thread may be waiting on
+                          // Thread::resume_cond_ since we raised its suspend count.
+                          Thread::resume_cond_->Broadcast(worker);
+                        });
 
   return count;
 }
@@ -522,7 +578,8 @@ void ThreadList::RunEmptyCheckpoint() {
 size_t ThreadList::FlipThreadRoots(Closure* thread_flip_visitor,
                                    Closure* flip_callback,
                                    gc::collector::GarbageCollector* collector,
-                                   gc::GcPauseListener* pause_listener) {
+                                   gc::GcPauseListener* pause_listener,
+                                   ThreadPool* thread_pool) {
   TimingLogger::ScopedTiming split("ThreadListFlip", collector->GetTimings());
   Thread* self = Thread::Current();
   Locks::mutator_lock_->AssertNotHeld(self);
@@ -544,7 +601,7 @@ size_t ThreadList::FlipThreadRoots(Closure* thread_flip_visitor,
 
   // Run the flip callback for the collector.
   Locks::mutator_lock_->ExclusiveLock(self);
-  suspend_all_historam_.AdjustAndAddValue(NanoTime() - suspend_start_time);
+  RecordTimeToSafepoint(self, NanoTime() - suspend_start_time);
   flip_callback->Run(self);
   // Releasing mutator-lock *before* setting up flip function in the threads
   // leaves a gap for another thread trying to suspend all threads. That thread
@@ -599,10 +656,13 @@ size_t ThreadList::FlipThreadRoots(Closure* thread_flip_visitor,
   // Try to run the closure on the other threads.
   {
     TimingLogger::ScopedTiming split3("FlipOtherThreads", collector->GetTimings());
-    for (Thread* thread : other_threads) {
-      thread->EnsureFlipFunctionStarted(self);
-      DCHECK(!thread->ReadFlag(ThreadFlag::kPendingFlipFunction));
-    }
+    VisitSuspendedThreads(self,
+                          other_threads,
+                          thread_pool,
+                          [](Thread* worker, Thread* thread) {
+                            thread->EnsureFlipFunctionStarted(worker);
+                            DCHECK(!thread->ReadFlag(ThreadFlag::kPendingFlipFunction));
+                          });
     // Try to run the flip function for self.
     self->EnsureFlipFunctionStarted(self);
     DCHECK(!self->ReadFlag(ThreadFlag::kPendingFlipFunction));
@@ -659,11 +719,7 @@ void ThreadList::SuspendAll(const char* cause, bool long_suspend) {
     long_suspend_ = long_suspend;
 
     const uint64_t end_time = NanoTime();
-    const uint64_t suspend_time = end_time - start_time;
-    suspend_all_historam_.AdjustAndAddValue(suspend_time);
-    if (suspend_time > kLongThreadSuspendThreshold) {
-      LOG(WARNING) << "Suspending all threads took: " << PrettyDuration(suspend_time);
-    }
+    RecordTimeToSafepoint(self, end_time - start_time);
 
     if (kDebugLocking) {
       // Debug check that all threads are suspended.
@@ -679,6 +735,39 @@ void ThreadList::SuspendAll(const char* cause, bool long_suspend) {
   }
 }
 
+void ThreadList::RecordTimeToSafepoint(Thread* self, uint64_t suspend_time) {
+  suspend_all_historam_.AdjustAndAddValue(suspend_time);
+  Runtime::Current()->GetMetrics()->TimeToSafepoint()->Add(NsToUs(suspend_time));
+  const bool is_long = suspend_time > kLongThreadSuspendThreshold;
+  if (!is_long && !VLOG_IS_ON(threads)) {
+    return;
+  }
+  // All threads are suspended, so the top frame of the last thread to suspend is the method
+  // that reached a suspend point last, usually right after the code that delayed it.
+  std::ostringstream last_thread;
+  uint32_t last_thread_id = last_thread_to_suspend_.load(std::memory_order_relaxed);
+  if (last_thread_id != 0u) {
+    MutexLock mu(self, *Locks::thread_list_lock_);
+    Thread* thread = FindThreadByThreadId(last_thread_id);
+    if (thread != nullptr) {
+      std::string name;
+      thread->GetThreadName(name);
+      uint32_t dex_pc = 0u;
+      ArtMethod* method =
+          thread->GetCurrentMethod(&dex_pc, /*check_suspended=*/ true, /*abort_on_error=*/ false);
+      last_thread << ", last to suspend: \"" << name << "\" in "
+                  << ArtMethod::PrettyMethod(method) << " at dex pc 0x" << std::hex << dex_pc;
+    }
+  }
+  if (is_long) {
+    LOG(WARNING) << "Suspending all threads took: " << PrettyDuration(suspend_time)
+                 << last_thread.str();
+  } else {
+    VLOG(threads) << "Suspending all threads took: " << PrettyDuration(suspend_time)
+                  << last_thread.str();
+  }
+}
+
 // Ensures all threads running Java suspend and that those not running Java don't start.
 void ThreadList::SuspendAllInternal(Thread* self,
                                     Thread* ignore1,
@@ -709,10 +798,14 @@ void ThreadList::SuspendAllInternal(Thread* self,
     ++num_ignored;
   }
   {
+    // Number of threads that were already suspended. They are subtracted from the counter
+    // together, to not contend with the runnable threads passing the barrier.
+    int32_t num_suspended = 0;
     MutexLock mu(self, *Locks::thread_list_lock_);
     MutexLock mu2(self, *Locks::thread_suspend_count_lock_);
     // Update global suspend all state for attaching threads.
     ++suspend_all_count_;
+    last_thread_to_suspend_.store(0u, std::memory_order_relaxed);
     pending_threads.store(list_.size() - num_ignored, std::memory_order_relaxed);
     // Increment everybody's suspend count (except those that should be ignored).
     for (const auto& thread : list_) {
@@ -729,9 +822,11 @@ void ThreadList::SuspendAllInternal(Thread* self,
       if (thread->IsSuspended()) {
         // Only clear the counter for the current thread.
         thread->ClearSuspendBarrier(&pending_threads);
-        pending_threads.fetch_sub(1, std::memory_order_seq_cst);
+        ++num_suspended;
       }
     }
+    // The counter cannot reach zero before this, so the runnable threads never wake us early.
+    pending_threads.fetch_sub(num_suspended, std::memory_order_seq_cst);
   }
 
   // Wait for the barrier to be passed by all runnable threads. This wait
@@ -26,6 +26,7 @@
 #include "suspend_reason.h"
 
 #include <bitset>
+#include <functional>
 #include <list>
 #include <vector>
 
@@ -40,6 +41,7 @@ class Closure;
 class IsMarkedVisitor;
 class RootVisitor;
 class Thread;
+class ThreadPool;
 class TimingLogger;
 enum VisitRootFlags : uint8_t;
 
@@ -101,6 +103,11 @@ class ThreadList {
   // Find an existing thread (or self) by its thread id (not tid).
   Thread* FindThreadByThreadId(uint32_t thread_id) REQUIRES(Locks::thread_list_lock_);
 
+  // Called by the thread that passes the suspend barrier of a suspend-all request last.
+  void SetLastThreadToSuspend(uint32_t thread_id) {
+    last_thread_to_suspend_.store(thread_id, std::memory_order_relaxed);
+  }
+
   // Find an existing thread (or self) by its tid (not thread id).
   Thread* FindThreadByTid(int tid) REQUIRES(Locks::thread_list_lock_);
 
@@ -114,8 +121,12 @@ class ThreadList {
   // return value includes already suspended threads for b/24191051. Runs or requests the
   // callback, if non-null, inside the thread_list_lock critical section after determining the
   // runnable/suspended states of the threads. Does not wait for completion of the callbacks in
-  // running threads.
-  size_t RunCheckpoint(Closure* checkpoint_function, Closure* callback = nullptr)
+  // running threads. If `thread_pool` is non-null, the checkpoint function of the suspended
+  // threads may be run by its workers in parallel with the calling thread, so it must be safe to
+  // run on any thread. The workers must have been created and be idle.
+  size_t RunCheckpoint(Closure* checkpoint_function,
+                       Closure* callback = nullptr,
+                       ThreadPool* thread_pool = nullptr)
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
 
   // Run an empty checkpoint on threads. Wait until threads pass the next suspend point or are
@@ -127,11 +138,13 @@ class ThreadList {
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
 
   // Flip thread roots from from-space refs to to-space refs. Used by
-  // the concurrent moving collectors.
+  // the concurrent moving collectors. If `thread_pool` is non-null, the flip functions of the
+  // suspended threads may be run by its workers, as for RunCheckpoint().
   size_t FlipThreadRoots(Closure* thread_flip_visitor,
                          Closure* flip_callback,
                          gc::collector::GarbageCollector* collector,
-                         gc::GcPauseListener* pause_listener)
+                         gc::GcPauseListener* pause_listener,
+                         ThreadPool* thread_pool = nullptr)
       REQUIRES(!Locks::mutator_lock_,
                !Locks::thread_list_lock_,
                !Locks::thread_suspend_count_lock_);
@@ -193,6 +206,14 @@ class ThreadList {
   size_t RunCheckpoint(Closure* checkpoint_function, bool includeSuspended)
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
 
+  // Calls `visit(self, thread)` for each of the suspended `threads`. With a `thread_pool` and
+  // enough threads, the workers of the pool and `self` claim the threads one at a time and pass
+  // themselves as `self`.
+  static void VisitSuspendedThreads(Thread* self,
+                                    const std::vector<Thread*>& threads,
+                                    ThreadPool* thread_pool,
+                                    const std::function<void(Thread*, Thread*)>& visit);
+
   void DumpUnattachedThreads(std::ostream& os, bool dump_native_stack)
       REQUIRES(!Locks::thread_list_lock_);
 
@@ -208,6 +229,11 @@ class ThreadList {
   void AssertThreadsAreSuspended(Thread* self, Thread* ignore1, Thread* ignore2 = nullptr)
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
 
+  // Record the time it took all threads to reach a suspend point for a suspend-all request, and
+  // report the thread that got there last if that took long.
+  void RecordTimeToSafepoint(Thread* self, uint64_t suspend_time)
+      REQUIRES(Locks::mutator_lock_, !Locks::thread_list_lock_);
+
   std::bitset<kMaxThreadId> allocated_ids_ GUARDED_BY(Locks::allocated_thread_ids_lock_);
 
   // The actual list of all threads.
@@ -226,6 +252,10 @@ class ThreadList {
   // Whether or not the current thread suspension is long.
   bool long_suspend_;
 
+  // Thread id of the thread that passed the barrier of the current suspend-all request last, or 0
+  // if no thread had to be waited for.
+  std::atomic<uint32_t> last_thread_to_suspend_;
+
   // Whether the shutdown function has been called. This is checked in the destructor. It is an
   // error to destroy a ThreadList instance without first calling ShutDown().
   bool shut_down_;
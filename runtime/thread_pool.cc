@@ -49,7 +49,8 @@ static constexpr bool kUseCustomThreadPoolStack = true;
 ThreadPoolWorker::ThreadPoolWorker(ThreadPool* thread_pool, const std::string& name,
                                    size_t stack_size)
     : thread_pool_(thread_pool),
-      name_(name) {
+      name_(name),
+      thread_(nullptr) {
   std::string error_msg;
   // On Bionic, we know pthreads will give us a big-enough stack with
   // a guard page, so don't do anything special on Bionic libc.
@@ -146,9 +147,30 @@ void* ThreadPoolWorker::Callback(void* arg) {
   return nullptr;
 }
 
-void ThreadPool::AddTask(Thread* self, Task* task) {
+void ThreadPool::AddTask(Thread* self, Task* task, int32_t priority) {
+  if (work_stealing_ && priority == kDefaultTaskPriority) {
+    const size_t worker_index = GetWorkerIndex(self);
+    if (worker_index < local_queues_.size()) {
+      LocalTaskQueue* queue = local_queues_[worker_index].get();
+      {
+        MutexLock mu(self, queue->lock);
+        queue->tasks.push_back(task);
+        num_local_tasks_.fetch_add(1u, std::memory_order_relaxed);
+      }
+      // Wake up an idle worker to steal the task. If we miss a worker that is about to wait, this
+      // worker runs the task itself.
+      if (MayHaveWaitingWorkers()) {
+        MutexLock mu(self, task_queue_lock_);
+        if (started_ && waiting_count_ != 0) {
+          task_queue_condition_.Signal(self);
+        }
+      }
+      return;
+    }
+  }
   MutexLock mu(self, task_queue_lock_);
-  tasks_.push_back(task);
+  // Equal keys are inserted after the existing ones, which keeps the FIFO order per priority.
+  tasks_.emplace(priority, task);
   // If we have any waiters, signal one.
   if (started_ && waiting_count_ != 0) {
     task_queue_condition_.Signal(self);
@@ -162,14 +184,53 @@ void ThreadPool::RemoveAllTasks(Thread* self) {
   while ((task = TryGetTask(self)) != nullptr) {
     task->Finalize();
   }
+  for (std::unique_ptr<LocalTaskQueue>& queue : local_queues_) {
+    MutexLock mu(self, queue->lock);
+    num_local_tasks_.fetch_sub(queue->tasks.size(), std::memory_order_relaxed);
+    queue->tasks.clear();
+  }
   MutexLock mu(self, task_queue_lock_);
   tasks_.clear();
 }
 
+size_t ThreadPool::RemoveTasks(Thread* self,
+                               const std::function<bool(Task*, int32_t)>& predicate) {
+  std::vector<Task*> removed;
+  {
+    MutexLock mu(self, task_queue_lock_);
+    for (auto it = tasks_.begin(); it != tasks_.end();) {
+      if (predicate(it->second, it->first)) {
+        removed.push_back(it->second);
+        it = tasks_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+  for (std::unique_ptr<LocalTaskQueue>& queue : local_queues_) {
+    MutexLock mu(self, queue->lock);
+    for (auto it = queue->tasks.begin(); it != queue->tasks.end();) {
+      if (predicate(*it, kDefaultTaskPriority)) {
+        removed.push_back(*it);
+        it = queue->tasks.erase(it);
+        num_local_tasks_.fetch_sub(1u, std::memory_order_relaxed);
+      } else {
+        ++it;
+      }
+    }
+  }
+  // Finalize without holding the lock, as it may delete the task and release its resources.
+  for (Task* task : removed) {
+    task->Finalize();
+  }
+  return removed.size();
+}
+
 ThreadPool::ThreadPool(const char* name,
                        size_t num_threads,
                        bool create_peers,
-                       size_t worker_stack_size)
+                       size_t worker_stack_size,
+                       bool work_stealing)
   : name_(name),
     task_queue_lock_("task queue lock", kGenericBottomLock),
     task_queue_condition_("task queue condition", task_queue_lock_),
@@ -182,7 +243,9 @@ ThreadPool::ThreadPool(const char* name,
     creation_barier_(0),
     max_active_workers_(num_threads),
     create_peers_(create_peers),
-    worker_stack_size_(worker_stack_size) {
+    worker_stack_size_(worker_stack_size),
+    work_stealing_(work_stealing),
+    num_local_tasks_(0u) {
   CreateThreads();
 }
 
@@ -200,6 +263,9 @@ void ThreadPool::CreateThreads() {
       threads_.push_back(
           new ThreadPoolWorker(this, worker_name, worker_stack_size_));
     }
+    while (work_stealing_ && local_queues_.size() < GetThreadCount()) {
+      local_queues_.push_back(std::make_unique<LocalTaskQueue>());
+    }
   }
 }
 
@@ -259,47 +325,115 @@ bool ThreadPool::HasStarted(Thread* self) {
 }
 
 Task* ThreadPool::GetTask(Thread* self) {
-  MutexLock mu(self, task_queue_lock_);
-  while (!IsShuttingDown()) {
-    const size_t thread_count = GetThreadCount();
-    // Ensure that we don't use more threads than the maximum active workers.
-    const size_t active_threads = thread_count - waiting_count_;
-    // <= since self is considered an active worker.
-    if (active_threads <= max_active_workers_) {
-      Task* task = TryGetTaskLocked();
+  const size_t worker_index = work_stealing_ ? GetWorkerIndex(self) : GetThreadCount();
+  while (true) {
+    // The tasks that this worker split off from its own tasks come first. They do not need
+    // `task_queue_lock_`, and their data is most likely still in the cache.
+    Task* task = PopLocalTask(self, worker_index);
+    if (task != nullptr) {
+      return task;
+    }
+    bool steal = false;
+    {
+      MutexLock mu(self, task_queue_lock_);
+      if (IsShuttingDown()) {
+        // We are shutting down, return null to tell the worker thread to stop looping.
+        return nullptr;
+      }
+      const size_t thread_count = GetThreadCount();
+      // Ensure that we don't use more threads than the maximum active workers.
+      const size_t active_threads = thread_count - waiting_count_;
+      // <= since self is considered an active worker.
+      if (active_threads <= max_active_workers_) {
+        task = TryGetTaskLocked();
+        if (task != nullptr) {
+          return task;
+        }
+        // The shared queue is empty, so any outstanding tasks are in the local queues of the
+        // other workers.
+        steal = HasOutstandingTasks();
+      }
+      if (!steal) {
+        ++waiting_count_;
+        if (waiting_count_ == GetThreadCount() && !HasOutstandingTasks()) {
+          // We may be done, lets broadcast to the completion condition.
+          completion_condition_.Broadcast(self);
+        }
+        const uint64_t wait_start = kMeasureWaitTime ? NanoTime() : 0;
+        task_queue_condition_.Wait(self);
+        if (kMeasureWaitTime) {
+          const uint64_t wait_end = NanoTime();
+          total_wait_time_ += wait_end - std::max(wait_start, start_time_);
+        }
+        --waiting_count_;
+      }
+    }
+    if (steal) {
+      task = StealLocalTask(self, worker_index);
       if (task != nullptr) {
         return task;
       }
     }
+  }
+}
 
-    ++waiting_count_;
-    if (waiting_count_ == GetThreadCount() && !HasOutstandingTasks()) {
-      // We may be done, lets broadcast to the completion condition.
-      completion_condition_.Broadcast(self);
-    }
-    const uint64_t wait_start = kMeasureWaitTime ? NanoTime() : 0;
-    task_queue_condition_.Wait(self);
-    if (kMeasureWaitTime) {
-      const uint64_t wait_end = NanoTime();
-      total_wait_time_ += wait_end - std::max(wait_start, start_time_);
+Task* ThreadPool::TryGetTask(Thread* self) {
+  {
+    MutexLock mu(self, task_queue_lock_);
+    Task* task = TryGetTaskLocked();
+    if (task != nullptr || !HasOutstandingTasks()) {
+      return task;
     }
-    --waiting_count_;
   }
+  return StealLocalTask(self, GetWorkerIndex(self));
+}
 
-  // We are shutting down, return null to tell the worker thread to stop looping.
+Task* ThreadPool::TryGetTaskLocked() {
+  if (started_ && !tasks_.empty()) {
+    Task* task = tasks_.begin()->second;
+    tasks_.erase(tasks_.begin());
+    return task;
+  }
   return nullptr;
 }
 
-Task* ThreadPool::TryGetTask(Thread* self) {
-  MutexLock mu(self, task_queue_lock_);
-  return TryGetTaskLocked();
+size_t ThreadPool::GetWorkerIndex(Thread* self) const {
+  // The workers are not added or removed while tasks run, see DeleteThreads().
+  for (size_t i = 0; i != threads_.size(); ++i) {
+    if (threads_[i]->thread_ == self) {
+      return i;
+    }
+  }
+  return threads_.size();
 }
 
-Task* ThreadPool::TryGetTaskLocked() {
-  if (HasOutstandingTasks()) {
-    Task* task = tasks_.front();
-    tasks_.pop_front();
-    return task;
+Task* ThreadPool::PopLocalTask(Thread* self, size_t worker_index) {
+  if (worker_index >= local_queues_.size() ||
+      num_local_tasks_.load(std::memory_order_relaxed) == 0u) {
+    return nullptr;
+  }
+  LocalTaskQueue* queue = local_queues_[worker_index].get();
+  MutexLock mu(self, queue->lock);
+  if (queue->tasks.empty()) {
+    return nullptr;
+  }
+  Task* task = queue->tasks.back();
+  queue->tasks.pop_back();
+  num_local_tasks_.fetch_sub(1u, std::memory_order_relaxed);
+  return task;
+}
+
+Task* ThreadPool::StealLocalTask(Thread* self, size_t worker_index) {
+  const size_t num_queues = local_queues_.size();
+  for (size_t i = 1; i <= num_queues; ++i) {
+    LocalTaskQueue* queue = local_queues_[(worker_index + i) % num_queues].get();
+    MutexLock mu(self, queue->lock);
+    if (!queue->tasks.empty()) {
+      Task* task = queue->tasks.front();
+      queue->tasks.pop_front();
+      num_local_tasks_.fetch_sub(1u, std::memory_order_relaxed);
+      return task;
+    }
   }
   return nullptr;
 }
@@ -326,7 +460,7 @@ void ThreadPool::Wait(Thread* self, bool do_work, bool may_hold_locks) {
 
 size_t ThreadPool::GetTaskCount(Thread* self) {
   MutexLock mu(self, task_queue_lock_);
-  return tasks_.size();
+  return tasks_.size() + num_local_tasks_.load(std::memory_order_relaxed);
 }
 
 void ThreadPool::SetPthreadPriority(int priority) {
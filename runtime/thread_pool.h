@@ -17,8 +17,11 @@
 #ifndef ART_RUNTIME_THREAD_POOL_H_
 #define ART_RUNTIME_THREAD_POOL_H_
 
+#include <atomic>
 #include <deque>
 #include <functional>
+#include <map>
+#include <memory>
 #include <vector>
 
 #include "barrier.h"
@@ -110,6 +113,10 @@ class ThreadPoolWorker {
 // Note that thread pool workers will set Thread#setCanCallIntoJava to false.
 class ThreadPool {
  public:
+  // Priority of the tasks added without one. Tasks run in decreasing priority order, and in the
+  // order they were added for equal priorities.
+  static constexpr int32_t kDefaultTaskPriority = 0;
+
   // Returns the number of threads in the thread pool.
   size_t GetThreadCount() const {
     return threads_.size();
@@ -127,21 +134,36 @@ class ThreadPool {
   bool HasStarted(Thread* self) REQUIRES(!task_queue_lock_);
 
   // Add a new task, the first available started worker will process it. Does not delete the task
-  // after running it, it is the caller's responsibility.
-  void AddTask(Thread* self, Task* task) REQUIRES(!task_queue_lock_);
+  // after running it, it is the caller's responsibility. In a work-stealing pool, tasks of the
+  // default priority added by a worker go to its local queue, see ThreadPool().
+  void AddTask(Thread* self, Task* task, int32_t priority = kDefaultTaskPriority)
+      REQUIRES(!task_queue_lock_);
 
   // Remove all tasks in the queue.
   void RemoveAllTasks(Thread* self) REQUIRES(!task_queue_lock_);
 
+  // Remove the queued tasks for which `predicate(task, priority)` returns true, and finalize them
+  // without running them. Returns the number of removed tasks. The predicate is called with
+  // `task_queue_lock_` held.
+  size_t RemoveTasks(Thread* self, const std::function<bool(Task*, int32_t)>& predicate)
+      REQUIRES(!task_queue_lock_);
+
   // Create a named thread pool with the given number of threads.
   //
   // If create_peers is true, all worker threads will have a Java peer object. Note that if the
   // pool is asked to do work on the current thread (see Wait), a peer may not be available. Wait
   // will conservatively abort if create_peers and do_work are true.
+  //
+  // If work_stealing is true, each worker has a local queue for the tasks of the default priority
+  // that it adds itself, for tasks that split their work into new tasks. A worker runs the last
+  // task of its local queue first, then the tasks of the shared queue, and then steals the oldest
+  // tasks of the other local queues, which takes `task_queue_lock_` only to find out that the
+  // shared queue is empty.
   ThreadPool(const char* name,
              size_t num_threads,
              bool create_peers = false,
-             size_t worker_stack_size = ThreadPoolWorker::kDefaultStackSize);
+             size_t worker_stack_size = ThreadPoolWorker::kDefaultStackSize,
+             bool work_stealing = false);
   virtual ~ThreadPool();
 
   // Create the threads of this pool.
@@ -184,13 +206,39 @@ class ThreadPool {
   Task* TryGetTask(Thread* self) REQUIRES(!task_queue_lock_);
   Task* TryGetTaskLocked() REQUIRES(task_queue_lock_);
 
+  // The tasks that a worker of a work-stealing pool added to its own queue.
+  struct LocalTaskQueue {
+    LocalTaskQueue() : lock("thread pool local task queue lock", kGenericBottomLock) {}
+
+    Mutex lock;
+    std::deque<Task*> tasks GUARDED_BY(lock);
+  };
+
+  // Returns the index of the worker running on `self`, or the thread count if `self` is not a
+  // worker of this pool.
+  size_t GetWorkerIndex(Thread* self) const;
+
+  // Pop the last task of the local queue of the worker `worker_index`. Must not be called with
+  // `task_queue_lock_` held, as the local queue locks have the same level.
+  Task* PopLocalTask(Thread* self, size_t worker_index) REQUIRES(!task_queue_lock_);
+
+  // Steal the oldest task of the first non-empty local queue after the one of `worker_index`.
+  Task* StealLocalTask(Thread* self, size_t worker_index) REQUIRES(!task_queue_lock_);
+
+  // Racy check for workers waiting on `task_queue_condition_`, to avoid taking `task_queue_lock_`
+  // when a worker adds a task to its local queue.
+  bool MayHaveWaitingWorkers() const NO_THREAD_SAFETY_ANALYSIS {
+    return waiting_count_ != 0;
+  }
+
   // Are we shutting down?
   bool IsShuttingDown() const REQUIRES(task_queue_lock_) {
     return shutting_down_;
   }
 
   bool HasOutstandingTasks() const REQUIRES(task_queue_lock_) {
-    return started_ && !tasks_.empty();
+    return started_ &&
+        (!tasks_.empty() || num_local_tasks_.load(std::memory_order_relaxed) != 0u);
   }
 
   const std::string name_;
@@ -201,7 +249,8 @@ class ThreadPool {
   volatile bool shutting_down_ GUARDED_BY(task_queue_lock_);
   // How many worker threads are waiting on the condition.
   volatile size_t waiting_count_ GUARDED_BY(task_queue_lock_);
-  std::deque<Task*> tasks_ GUARDED_BY(task_queue_lock_);
+  // Queued tasks, highest priority first.
+  std::multimap<int32_t, Task*, std::greater<int32_t>> tasks_ GUARDED_BY(task_queue_lock_);
   std::vector<ThreadPoolWorker*> threads_;
   // Work balance detection.
   uint64_t start_time_ GUARDED_BY(task_queue_lock_);
@@ -210,10 +259,15 @@ class ThreadPool {
   size_t max_active_workers_ GUARDED_BY(task_queue_lock_);
   const bool create_peers_;
   const size_t worker_stack_size_;
+  const bool work_stealing_;
+  // One queue per worker if `work_stealing_`. They outlive the workers so that the tasks left in
+  // them can be removed after DeleteThreads().
+  std::vector<std::unique_ptr<LocalTaskQueue>> local_queues_;
+  // The number of tasks in all the local queues, updated with the lock of the queue held.
+  std::atomic<size_t> num_local_tasks_;
 
  private:
   friend class ThreadPoolWorker;
-  friend class WorkStealingWorker;
   DISALLOW_COPY_AND_ASSIGN(ThreadPool);
 };
 
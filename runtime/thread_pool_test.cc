@@ -160,6 +160,29 @@ TEST_F(ThreadPoolTest, RecursiveTest) {
   EXPECT_EQ((1 << depth) - 1, count.load(std::memory_order_seq_cst));
 }
 
+// Test that the tasks added to the local queues of the workers all run, with and without the
+// calling thread helping.
+TEST_F(ThreadPoolTest, WorkStealingRecursiveTest) {
+  Thread* self = Thread::Current();
+  ThreadPool thread_pool("Thread pool test thread pool",
+                         num_threads,
+                         /*create_peers=*/ false,
+                         ThreadPoolWorker::kDefaultStackSize,
+                         /*work_stealing=*/ true);
+  AtomicInteger count(0);
+  static const int depth = 12;
+  thread_pool.AddTask(self, new TreeTask(&thread_pool, &count, depth));
+  thread_pool.StartWorkers(self);
+  thread_pool.Wait(self, /* do_work= */ true, false);
+  EXPECT_EQ((1 << depth) - 1, count.load(std::memory_order_seq_cst));
+  EXPECT_EQ(0u, thread_pool.GetTaskCount(self));
+
+  count.store(0, std::memory_order_seq_cst);
+  thread_pool.AddTask(self, new TreeTask(&thread_pool, &count, depth));
+  thread_pool.Wait(self, /* do_work= */ false, false);
+  EXPECT_EQ((1 << depth) - 1, count.load(std::memory_order_seq_cst));
+}
+
 class PeerTask : public Task {
  public:
   PeerTask() {}
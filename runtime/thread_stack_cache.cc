@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "thread_stack_cache.h"
+
+#include <sys/mman.h>
+#include <sys/prctl.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "base/bit_utils.h"
+#include "base/globals.h"
+#include "base/logging.h"
+#include "base/memory_tool.h"
+
+namespace art {
+
+// The guard page below each stack, which catches overflows past the protected region.
+static constexpr size_t kGuardSize = kPageSize;
+
+ThreadStackCache* ThreadStackCache::GetInstance() {
+  static ThreadStackCache* cache = new ThreadStackCache();
+  return cache;
+}
+
+bool ThreadStackCache::IsSupported() {
+#if defined(__linux__)
+  // The memory tools track the stacks that libc allocates.
+  return !kMemoryToolIsAvailable;
+#else
+  return false;
+#endif
+}
+
+ThreadStackCache::ThreadStackCache() {
+  stacks_.reserve(kMaxCachedStacks);
+  pthread_atfork(PrepareFork, ParentAfterFork, ChildAfterFork);
+}
+
+ThreadStackCache::Stack ThreadStackCache::Acquire(size_t size, size_t protected_size) {
+  DCHECK_ALIGNED(size, kPageSize);
+  DCHECK_ALIGNED(protected_size, kPageSize);
+  DCHECK_LT(protected_size, size);
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    for (auto it = stacks_.begin(); it != stacks_.end(); ++it) {
+      if (it->size == size && it->protected_size == protected_size) {
+        Stack stack = *it;
+        stacks_.erase(it);
+        return stack;
+      }
+    }
+  }
+  return Map(size, protected_size);
+}
+
+void ThreadStackCache::Release(const Stack& stack) {
+  DCHECK(stack.IsValid());
+  // Thread::SetStackEndForStackOverflow() unprotects the region while handling a stack overflow.
+  if (stack.protected_size != 0u &&
+      mprotect(stack.begin, stack.protected_size, PROT_NONE) != 0) {
+    PLOG(WARNING) << "Failed to protect the stack at " << static_cast<void*>(stack.begin);
+    Unmap(stack);
+    return;
+  }
+  uint8_t* used_begin = stack.begin + stack.protected_size;
+  if (madvise(used_begin, stack.size - stack.protected_size, MADV_DONTNEED) != 0) {
+    PLOG(WARNING) << "Failed to release the stack at " << static_cast<void*>(stack.begin);
+  }
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    if (stacks_.size() < kMaxCachedStacks) {
+      stacks_.push_back(stack);
+      return;
+    }
+  }
+  Unmap(stack);
+}
+
+void ThreadStackCache::ThreadExiting(const Stack& stack) {
+  DCHECK(stack.IsValid());
+  bool has_previous_thread;
+  pthread_t previous_thread;
+  Stack previous_stack;
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    has_previous_thread = has_exiting_thread_;
+    previous_thread = exiting_thread_;
+    previous_stack = exiting_stack_;
+    has_exiting_thread_ = true;
+    exiting_thread_ = pthread_self();
+    exiting_stack_ = stack;
+  }
+  if (!has_previous_thread) {
+    return;
+  }
+  int rc = pthread_join(previous_thread, nullptr);
+  if (rc != 0) {
+    // Without the join, the stack may still be in use, so it is leaked.
+    errno = rc;
+    PLOG(WARNING) << "Failed to join an exited thread";
+    return;
+  }
+  Release(previous_stack);
+}
+
+size_t ThreadStackCache::Size() {
+  std::lock_guard<std::mutex> lock(lock_);
+  return stacks_.size();
+}
+
+ThreadStackCache::Stack ThreadStackCache::Map(size_t size, size_t protected_size) {
+  void* map = mmap(nullptr,
+                   kGuardSize + size,
+                   PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                   /*fd=*/ -1,
+                   /*offset=*/ 0);
+  if (map == MAP_FAILED) {
+    PLOG(WARNING) << "Failed to map a thread stack of " << size << " bytes";
+    return Stack();
+  }
+  // The guard page and the protected region are contiguous.
+  if (mprotect(map, kGuardSize + protected_size, PROT_NONE) != 0) {
+    PLOG(WARNING) << "Failed to protect a thread stack";
+    munmap(map, kGuardSize + size);
+    return Stack();
+  }
+#if defined(PR_SET_VMA)
+  prctl(PR_SET_VMA, PR_SET_VMA_ANON_NAME, map, kGuardSize + size, "thread stack");
+#endif
+  Stack stack;
+  stack.begin = reinterpret_cast<uint8_t*>(map) + kGuardSize;
+  stack.size = size;
+  stack.protected_size = protected_size;
+  return stack;
+}
+
+void ThreadStackCache::Unmap(const Stack& stack) {
+  if (munmap(stack.begin - kGuardSize, kGuardSize + stack.size) != 0) {
+    PLOG(WARNING) << "Failed to unmap the stack at " << static_cast<void*>(stack.begin);
+  }
+}
+
+void ThreadStackCache::PrepareFork() {
+  GetInstance()->lock_.lock();
+}
+
+void ThreadStackCache::ParentAfterFork() {
+  GetInstance()->lock_.unlock();
+}
+
+void ThreadStackCache::ChildAfterFork() {
+  ThreadStackCache* cache = GetInstance();
+  // The exiting thread does not exist in the child and cannot be joined, but no thread of the
+  // child runs on its stack, so the stack can be unmapped.
+  if (cache->has_exiting_thread_) {
+    cache->has_exiting_thread_ = false;
+    cache->Unmap(cache->exiting_stack_);
+    cache->exiting_stack_ = Stack();
+  }
+  cache->lock_.unlock();
+}
+
+}  // namespace art
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_THREAD_STACK_CACHE_H_
+#define ART_RUNTIME_THREAD_STACK_CACHE_H_
+
+#include <pthread.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "base/macros.h"
+
+namespace art {
+
+// The stacks of the threads created by Thread::CreateNativeThread(). Creating a thread with a
+// stack from libc maps the stack and its guard page, then Thread::InitStackHwm() protects the
+// region for implicit stack overflow checks, and libc unmaps all of it when the thread exits.
+// With many short-lived threads, these system calls are a large part of the thread creation.
+//
+// The stacks of the cache keep their guard page and protected region when a thread exits, and
+// their other pages are released to the kernel, so a new thread using one needs no system call
+// for its stack.
+//
+// A stack can only be reused once the kernel no longer runs the thread on it, so the threads that
+// use these stacks are joinable. Each such thread joins the one that exited before it, which has
+// then already exited or is about to, and takes its place as the thread to join. At most one
+// exited thread is not joined.
+class ThreadStackCache {
+ public:
+  struct Stack {
+    // The lowest address of the stack, above its guard page.
+    uint8_t* begin = nullptr;
+    size_t size = 0u;
+    // The size of the PROT_NONE region at `begin`.
+    size_t protected_size = 0u;
+
+    bool IsValid() const { return begin != nullptr; }
+  };
+
+  // The maximum number of unused stacks that are kept.
+  static constexpr size_t kMaxCachedStacks = 8u;
+
+  // The process-wide cache. It is never deleted, as exiting threads may still use it while the
+  // runtime shuts down.
+  static ThreadStackCache* GetInstance();
+
+  // Whether threads can use stacks of the cache in this build.
+  static bool IsSupported();
+
+  // Returns a stack of `size` bytes whose lowest `protected_size` bytes are protected, from the
+  // cache if it has such a stack. Returns an invalid stack if the stack cannot be mapped.
+  Stack Acquire(size_t size, size_t protected_size);
+
+  // Give back a stack that no thread runs on anymore.
+  void Release(const Stack& stack);
+
+  // Called by a thread running on `stack` right before it exits, see the class comment.
+  void ThreadExiting(const Stack& stack);
+
+  // The number of unused stacks in the cache.
+  size_t Size();
+
+ private:
+  ThreadStackCache();
+
+  Stack Map(size_t size, size_t protected_size);
+  void Unmap(const Stack& stack);
+
+  static void PrepareFork();
+  static void ParentAfterFork();
+  static void ChildAfterFork();
+
+  std::mutex lock_;
+  std::vector<Stack> stacks_;
+  // The last thread that called ThreadExiting() and its stack, not joined yet.
+  bool has_exiting_thread_ = false;
+  pthread_t exiting_thread_;
+  Stack exiting_stack_;
+
+  DISALLOW_COPY_AND_ASSIGN(ThreadStackCache);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_THREAD_STACK_CACHE_H_
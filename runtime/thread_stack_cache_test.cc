@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "thread_stack_cache.h"
+
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+
+#include "base/globals.h"
+#include "gtest/gtest.h"
+
+namespace art {
+
+// Sizes that no other test uses, as the cache is shared by the process.
+static constexpr size_t kTestStackSize = 300 * kPageSize;
+static constexpr size_t kTestThreadStackSize = 400 * kPageSize;
+static constexpr size_t kTestForkStackSize = 500 * kPageSize;
+static constexpr size_t kTestProtectedSize = 2 * kPageSize;
+
+class ThreadStackCacheTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    if (!ThreadStackCache::IsSupported()) {
+      GTEST_SKIP() << "The thread stack cache is not supported";
+    }
+    cache_ = ThreadStackCache::GetInstance();
+  }
+
+  ThreadStackCache* cache_ = nullptr;
+};
+
+TEST_F(ThreadStackCacheTest, AcquireRelease) {
+  ThreadStackCache::Stack stack = cache_->Acquire(kTestStackSize, kTestProtectedSize);
+  ASSERT_TRUE(stack.IsValid());
+  EXPECT_EQ(stack.size, kTestStackSize);
+  EXPECT_EQ(stack.protected_size, kTestProtectedSize);
+  // The pages above the protected region are writable.
+  stack.begin[kTestProtectedSize] = 1u;
+  stack.begin[kTestStackSize - 1u] = 1u;
+
+  size_t size = cache_->Size();
+  cache_->Release(stack);
+  EXPECT_EQ(cache_->Size(), size + 1u);
+
+  // A stack of another size is not reused.
+  ThreadStackCache::Stack other = cache_->Acquire(kTestStackSize + kPageSize, kTestProtectedSize);
+  ASSERT_TRUE(other.IsValid());
+  EXPECT_NE(other.begin, stack.begin);
+
+  ThreadStackCache::Stack reused = cache_->Acquire(kTestStackSize, kTestProtectedSize);
+  EXPECT_EQ(reused.begin, stack.begin);
+  // The released pages are zero again.
+  EXPECT_EQ(reused.begin[kTestStackSize - 1u], 0u);
+
+  cache_->Release(other);
+  cache_->Release(reused);
+}
+
+struct ThreadArgs {
+  ThreadStackCache::Stack stack;
+  std::atomic<bool> exiting{false};
+};
+
+static void* ExitingThread(void* arg) {
+  ThreadArgs* args = reinterpret_cast<ThreadArgs*>(arg);
+  ThreadStackCache::GetInstance()->ThreadExiting(args->stack);
+  args->exiting.store(true);
+  return nullptr;
+}
+
+static void StartThread(ThreadArgs* args) {
+  pthread_attr_t attr;
+  ASSERT_EQ(pthread_attr_init(&attr), 0);
+  ASSERT_EQ(pthread_attr_setstack(&attr, args->stack.begin, args->stack.size), 0);
+  ASSERT_EQ(pthread_attr_setguardsize(&attr, 0u), 0);
+  pthread_t thread;
+  ASSERT_EQ(pthread_create(&thread, &attr, ExitingThread, args), 0);
+  ASSERT_EQ(pthread_attr_destroy(&attr), 0);
+  while (!args->exiting.load()) {
+    sched_yield();
+  }
+}
+
+TEST_F(ThreadStackCacheTest, ThreadExiting) {
+  ThreadArgs first;
+  first.stack = cache_->Acquire(kTestThreadStackSize, kTestProtectedSize);
+  ASSERT_TRUE(first.stack.IsValid());
+  StartThread(&first);
+
+  // The second thread joins the first one and releases its stack.
+  ThreadArgs second;
+  second.stack = cache_->Acquire(kTestThreadStackSize, kTestProtectedSize);
+  ASSERT_TRUE(second.stack.IsValid());
+  EXPECT_NE(second.stack.begin, first.stack.begin);
+  StartThread(&second);
+
+  ThreadStackCache::Stack reused = cache_->Acquire(kTestThreadStackSize, kTestProtectedSize);
+  EXPECT_EQ(reused.begin, first.stack.begin);
+  cache_->Release(reused);
+}
+
+// Whether the page at `addr` is mapped, whatever its protection.
+static bool IsMapped(uint8_t* addr) {
+  unsigned char vec;
+  return mincore(addr, kPageSize, &vec) == 0;
+}
+
+TEST_F(ThreadStackCacheTest, ForkWithExitingThread) {
+  ThreadArgs args;
+  args.stack = cache_->Acquire(kTestForkStackSize, kTestProtectedSize);
+  ASSERT_TRUE(args.stack.IsValid());
+  StartThread(&args);
+  // The thread is the one to join, and its stack is still in use.
+  uint8_t* page = args.stack.begin + kTestProtectedSize;
+  ASSERT_TRUE(IsMapped(page));
+
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+  if (pid == 0) {
+    // The thread does not exist in the child, so its stack is unmapped.
+    _exit(IsMapped(page) ? 1 : 0);
+  }
+  int status;
+  ASSERT_EQ(waitpid(pid, &status, 0), pid);
+  ASSERT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(WEXITSTATUS(status), 0);
+  EXPECT_TRUE(IsMapped(page));
+}
+
+}  // namespace art
@@ -23,6 +23,7 @@
 #include "android-base/stringprintf.h"
 
 #include "art_method-inl.h"
+#include "barrier.h"
 #include "base/casts.h"
 #include "base/enums.h"
 #include "base/os.h"
@@ -73,7 +74,6 @@ TraceClockSource Trace::default_clock_source_ = kDefaultTraceClockSource;
 
 Trace* volatile Trace::the_trace_ = nullptr;
 pthread_t Trace::sampling_pthread_ = 0U;
-std::unique_ptr<std::vector<ArtMethod*>> Trace::temp_stack_trace_;
 
 // The key identifying the tracer to update instrumentation.
 static constexpr const char* kTracerInstrumentationKey = "Tracer";
@@ -236,16 +236,6 @@ uint16_t Trace::GetThreadEncoding(pid_t thread_id) {
   return idx;
 }
 
-std::vector<ArtMethod*>* Trace::AllocStackTrace() {
-  return (temp_stack_trace_.get() != nullptr)  ? temp_stack_trace_.release() :
-      new std::vector<ArtMethod*>();
-}
-
-void Trace::FreeStackTrace(std::vector<ArtMethod*>* stack_trace) {
-  stack_trace->clear();
-  temp_stack_trace_.reset(stack_trace);
-}
-
 void Trace::SetDefaultClockSource(TraceClockSource clock_source) {
 #if defined(__linux__)
   default_clock_source_ = clock_source;
@@ -331,8 +321,13 @@ static void Append8LE(uint8_t* buf, uint64_t val) {
   *buf++ = static_cast<uint8_t>(val >> 56);
 }
 
-static void GetSample(Thread* thread, void* arg) REQUIRES_SHARED(Locks::mutator_lock_) {
-  std::vector<ArtMethod*>* const stack_trace = Trace::AllocStackTrace();
+static void GetSample(Thread* thread, Trace* the_trace) REQUIRES_SHARED(Locks::mutator_lock_) {
+  // Reuse the capacity of the previous sample, which is usually about as deep.
+  std::vector<ArtMethod*>* old_stack_trace = thread->GetStackTraceSample();
+  std::vector<ArtMethod*>* const stack_trace = new std::vector<ArtMethod*>();
+  if (old_stack_trace != nullptr) {
+    stack_trace->reserve(old_stack_trace->size());
+  }
   StackVisitor::WalkStack(
       [&](const art::StackVisitor* stack_visitor) REQUIRES_SHARED(Locks::mutator_lock_) {
         ArtMethod* m = stack_visitor->GetMethod();
@@ -345,10 +340,27 @@ static void GetSample(Thread* thread, void* arg) REQUIRES_SHARED(Locks::mutator_
       thread,
       /* context= */ nullptr,
       art::StackVisitor::StackWalkKind::kIncludeInlinedFrames);
-  Trace* the_trace = reinterpret_cast<Trace*>(arg);
   the_trace->CompareAndUpdateStackTrace(thread, stack_trace);
 }
 
+// Samples the stack of each thread in a checkpoint, so that threads are only stopped for their
+// own sample rather than for the samples of all threads.
+class SampleStackClosure final : public Closure {
+ public:
+  SampleStackClosure(Trace* the_trace, Barrier* barrier)
+      : the_trace_(the_trace), barrier_(barrier) {}
+
+  void Run(Thread* thread) override REQUIRES_SHARED(Locks::mutator_lock_) {
+    DCHECK(thread == Thread::Current() || thread->IsSuspended());
+    GetSample(thread, the_trace_);
+    barrier_->Pass(Thread::Current());
+  }
+
+ private:
+  Trace* const the_trace_;
+  Barrier* const barrier_;
+};
+
 static void ClearThreadStackTraceAndClockBase(Thread* thread, [[maybe_unused]] void* arg) {
   thread->SetTraceClockBase(0);
   std::vector<ArtMethod*>* stack_trace = thread->GetStackTraceSample();
@@ -358,7 +370,9 @@ static void ClearThreadStackTraceAndClockBase(Thread* thread, [[maybe_unused]] v
 
 void Trace::CompareAndUpdateStackTrace(Thread* thread,
                                        std::vector<ArtMethod*>* stack_trace) {
-  CHECK_EQ(pthread_self(), sampling_pthread_);
+  // Samples are taken by the thread itself in a checkpoint, or by the sampling thread while the
+  // thread is suspended.
+  DCHECK(thread == Thread::Current() || thread->IsSuspended());
   std::vector<ArtMethod*>* old_stack_trace = thread->GetStackTraceSample();
   // Update the thread's stack trace sample.
   thread->SetStackTraceSample(stack_trace);
@@ -390,7 +404,7 @@ void Trace::CompareAndUpdateStackTrace(Thread* thread,
     for (; rit != stack_trace->rend(); ++rit) {
       LogMethodTraceEvent(thread, *rit, kTraceMethodEnter, thread_clock_diff, timestamp_counter);
     }
-    FreeStackTrace(old_stack_trace);
+    delete old_stack_trace;
   }
 }
 
@@ -414,15 +428,20 @@ void* Trace::RunSamplingThread(void* arg) {
       }
     }
     {
-      // Avoid a deadlock between a thread doing garbage collection
-      // and the profile sampling thread, by blocking GC when sampling
-      // thread stacks (see b/73624630).
-      gc::ScopedGCCriticalSection gcs(self,
-                                      art::gc::kGcCauseInstrumentation,
-                                      art::gc::kCollectorTypeInstrumentation);
-      ScopedSuspendAll ssa(__FUNCTION__);
-      MutexLock mu(self, *Locks::thread_list_lock_);
-      runtime->GetThreadList()->ForEach(GetSample, the_trace);
+      // Request a sample from each thread and wait for all of them, so that no sample is in
+      // flight when tracing stops. Unlike suspending all threads, the checkpoint does not need
+      // to block GC to avoid deadlocking with it (see b/73624630).
+      Barrier barrier(0);
+      SampleStackClosure closure(the_trace, &barrier);
+      size_t threads_running_checkpoint = 0;
+      {
+        ScopedObjectAccess soa(self);
+        threads_running_checkpoint = runtime->GetThreadList()->RunCheckpoint(&closure);
+      }
+      if (threads_running_checkpoint != 0) {
+        ScopedThreadStateChange tsc(self, ThreadState::kWaitingForCheckPointsToRun);
+        barrier.Increment(self, threads_running_checkpoint);
+      }
     }
   }
 
@@ -660,6 +679,8 @@ void Trace::StopTracing(bool finish_tracing, bool flush_file) {
           the_trace->FlushStreamingBuffer(thread);
           thread->ResetMethodTraceBuffer();
         }
+        // The method ids and thread encodings are only valid for this trace.
+        thread->SetTraceMethodIdCache(nullptr);
         // Record threads here before resetting the_trace_ to prevent any races between
         // unregistering the thread and resetting the_trace_.
         the_trace->UpdateThreadsList(thread);
@@ -1225,10 +1246,23 @@ void Trace::RecordMethodEvent(Thread* thread,
   uint8_t* ptr;
   ptr = buf_.get() + old_offset;
   uint32_t wall_clock_diff = GetMicroTime(timestamp_counter) - start_time_;
-  MutexLock mu(Thread::Current(), tracing_lock_);
+  // Only the thread's own events, or samples taken while it is suspended, use its cache.
+  TraceMethodIdCache* cache = thread->GetTraceMethodIdCache();
+  uint32_t method_index =
+      (cache != nullptr) ? cache->Get(method) : TraceMethodIdCache::kNoMethodId;
+  if (method_index == TraceMethodIdCache::kNoMethodId) {
+    MutexLock mu(Thread::Current(), tracing_lock_);
+    if (cache == nullptr) {
+      thread->SetTraceMethodIdCache(
+          std::make_unique<TraceMethodIdCache>(GetThreadEncoding(thread->GetTid())));
+      cache = thread->GetTraceMethodIdCache();
+    }
+    method_index = EncodeTraceMethod(method);
+    cache->Set(method, method_index);
+  }
   EncodeEventEntry(ptr,
-                   GetThreadEncoding(thread->GetTid()),
-                   EncodeTraceMethod(method),
+                   cache->GetThreadEncoding(),
+                   method_index,
                    action,
                    thread_clock_diff,
                    wall_clock_diff);
@@ -17,7 +17,9 @@
 #ifndef ART_RUNTIME_TRACE_H_
 #define ART_RUNTIME_TRACE_H_
 
+#include <array>
 #include <bitset>
+#include <limits>
 #include <map>
 #include <memory>
 #include <ostream>
@@ -113,6 +115,44 @@ static constexpr int32_t kLowTimestampOffsetInBytes =
 
 static constexpr uintptr_t kMaskTraceAction = ~0b11;
 
+// Per-thread cache of the trace's method ids and of the thread's encoding. Recording an event in
+// the shared trace buffer does not need the tracing lock for methods the thread has seen recently.
+// Owned by the thread and cleared when tracing stops.
+class TraceMethodIdCache {
+ public:
+  static constexpr size_t kSize = 64u;
+  static constexpr uint32_t kNoMethodId = std::numeric_limits<uint32_t>::max();
+
+  explicit TraceMethodIdCache(uint16_t thread_encoding) : thread_encoding_(thread_encoding) {
+    methods_.fill(nullptr);
+  }
+
+  uint16_t GetThreadEncoding() const {
+    return thread_encoding_;
+  }
+
+  // Returns the method id of `method` or `kNoMethodId` if it is not cached.
+  uint32_t Get(ArtMethod* method) const {
+    size_t index = IndexOf(method);
+    return methods_[index] == method ? ids_[index] : kNoMethodId;
+  }
+
+  void Set(ArtMethod* method, uint32_t id) {
+    size_t index = IndexOf(method);
+    methods_[index] = method;
+    ids_[index] = id;
+  }
+
+ private:
+  static size_t IndexOf(ArtMethod* method) {
+    return (reinterpret_cast<uintptr_t>(method) >> 5) & (kSize - 1u);
+  }
+
+  const uint16_t thread_encoding_;
+  std::array<ArtMethod*, kSize> methods_;
+  std::array<uint32_t, kSize> ids_;
+};
+
 // Class for recording event traces. Trace data is either collected
 // synchronously during execution (TracingMode::kMethodTracingActive),
 // or by a separate sampling thread (TracingMode::kSampleProfilingActive).
@@ -235,10 +275,6 @@ class Trace final : public instrumentation::InstrumentationListener {
       REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!tracing_lock_) override;
   void WatchedFramePop(Thread* thread, const ShadowFrame& frame)
       REQUIRES_SHARED(Locks::mutator_lock_) override;
-  // Reuse an old stack trace if it exists, otherwise allocate a new one.
-  static std::vector<ArtMethod*>* AllocStackTrace();
-  // Clear and store an old stack trace for later use.
-  static void FreeStackTrace(std::vector<ArtMethod*>* stack_trace);
   // Save id and name of a thread before it exits.
   static void StoreExitingThreadInfo(Thread* thread);
 
@@ -357,9 +393,6 @@ class Trace final : public instrumentation::InstrumentationListener {
   // Sampling thread, non-zero when sampling.
   static pthread_t sampling_pthread_;
 
-  // Used to remember an unused stack trace to avoid re-allocation during sampling.
-  static std::unique_ptr<std::vector<ArtMethod*>> temp_stack_trace_;
-
   // File to write trace data out to, null if direct to ddms.
   std::unique_ptr<File> trace_file_;
 
@@ -33,6 +33,7 @@
 #include "obj_ptr-inl.h"
 #include "runtime.h"
 
+#include <algorithm>
 #include <list>
 
 namespace art {
@@ -48,6 +49,10 @@ Transaction::Transaction(bool strict,
       allocator_(arena_stack != nullptr ? arena_stack : &arena_stack_.emplace(arena_pool)),
       object_logs_(std::less<mirror::Object*>(), allocator_.Adapter(kArenaAllocTransaction)),
       array_logs_(std::less<mirror::Array*>(), allocator_.Adapter(kArenaAllocTransaction)),
+      last_object_(nullptr),
+      last_object_log_(nullptr),
+      last_array_(nullptr),
+      last_array_log_(nullptr),
       intern_string_logs_(allocator_.Adapter(kArenaAllocTransaction)),
       resolve_string_logs_(allocator_.Adapter(kArenaAllocTransaction)),
       resolve_method_type_logs_(allocator_.Adapter(kArenaAllocTransaction)),
@@ -167,7 +172,19 @@ bool Transaction::ReadConstraint(ObjPtr<mirror::Object> obj) const {
 }
 
 inline Transaction::ObjectLog& Transaction::GetOrCreateObjectLog(mirror::Object* obj) {
-  return object_logs_.GetOrCreate(obj, [&]() { return ObjectLog(&allocator_); });
+  if (obj != last_object_) {
+    last_object_log_ = &object_logs_.GetOrCreate(obj, [&]() { return ObjectLog(&allocator_); });
+    last_object_ = obj;
+  }
+  return *last_object_log_;
+}
+
+inline Transaction::ArrayLog& Transaction::GetOrCreateArrayLog(mirror::Array* array) {
+  if (array != last_array_) {
+    last_array_log_ = &array_logs_.GetOrCreate(array, [&]() { return ArrayLog(&allocator_); });
+    last_array_ = array;
+  }
+  return *last_array_log_;
 }
 
 void Transaction::RecordWriteFieldBoolean(mirror::Object* obj,
@@ -247,7 +264,7 @@ void Transaction::RecordWriteArray(mirror::Array* array, size_t index, uint64_t
   DCHECK(array->IsArrayInstance());
   DCHECK(!array->IsObjectArray());
   DCHECK(assert_no_new_records_reason_ == nullptr) << assert_no_new_records_reason_;
-  ArrayLog& array_log = array_logs_.GetOrCreate(array, [&]() { return ArrayLog(&allocator_); });
+  ArrayLog& array_log = GetOrCreateArrayLog(array);
   array_log.LogValue(index, value);
 }
 
@@ -314,6 +331,8 @@ void Transaction::UndoObjectModifications() {
     it.second.Undo(it.first);
   }
   object_logs_.clear();
+  last_object_ = nullptr;
+  last_object_log_ = nullptr;
 }
 
 void Transaction::UndoArrayModifications() {
@@ -323,6 +342,8 @@ void Transaction::UndoArrayModifications() {
     it.second.Undo(it.first);
   }
   array_logs_.clear();
+  last_array_ = nullptr;
+  last_array_log_ = nullptr;
 }
 
 void Transaction::UndoInternStringTableModifications() {
@@ -400,6 +421,8 @@ void Transaction::VisitObjectLogs(RootVisitor* visitor, ArenaStack* arena_stack)
 
   // Update object logs with moving roots.
   UpdateKeys(moving_roots, object_logs_);
+  last_object_ = nullptr;
+  last_object_log_ = nullptr;
 }
 
 void Transaction::VisitArrayLogs(RootVisitor* visitor, ArenaStack* arena_stack) {
@@ -419,6 +442,8 @@ void Transaction::VisitArrayLogs(RootVisitor* visitor, ArenaStack* arena_stack)
 
   // Update array logs with moving roots.
   UpdateKeys(moving_roots, array_logs_);
+  last_array_ = nullptr;
+  last_array_log_ = nullptr;
 }
 
 void Transaction::VisitInternStringLogs(RootVisitor* visitor) {
@@ -473,21 +498,26 @@ void Transaction::ObjectLog::LogValue(ObjectLog::FieldValueKind kind,
                                       MemberOffset offset,
                                       uint64_t value,
                                       bool is_volatile) {
-  auto it = field_values_.find(offset.Uint32Value());
-  if (it == field_values_.end()) {
-    ObjectLog::FieldValue field_value;
-    field_value.value = value;
-    field_value.is_volatile = is_volatile;
-    field_value.kind = kind;
-    field_values_.emplace(offset.Uint32Value(), std::move(field_value));
+  uint32_t field_offset = offset.Uint32Value();
+  auto it = field_values_.end();
+  if (!field_values_.empty() && field_values_.back().offset >= field_offset) {
+    it = std::lower_bound(field_values_.begin(),
+                          field_values_.end(),
+                          field_offset,
+                          [](const FieldValue& lhs, uint32_t rhs) { return lhs.offset < rhs; });
+    if (it->offset == field_offset) {
+      // Only the value before the first write needs to be restored.
+      return;
+    }
   }
+  field_values_.insert(it, FieldValue{value, field_offset, kind, is_volatile});
 }
 
 void Transaction::ObjectLog::Undo(mirror::Object* obj) const {
-  for (auto& it : field_values_) {
+  for (const FieldValue& field_value : field_values_) {
     // Garbage collector needs to access object's class and array's length. So we don't rollback
     // these values.
-    MemberOffset field_offset(it.first);
+    MemberOffset field_offset(field_value.offset);
     if (field_offset.Uint32Value() == mirror::Class::ClassOffset().Uint32Value()) {
       // Skip Object::class field.
       continue;
@@ -497,7 +527,6 @@ void Transaction::ObjectLog::Undo(mirror::Object* obj) const {
       // Skip Array::length field.
       continue;
     }
-    const FieldValue& field_value = it.second;
     UndoFieldWrite(obj, field_offset, field_value);
   }
 }
@@ -589,8 +618,7 @@ void Transaction::ObjectLog::UndoFieldWrite(mirror::Object* obj,
 }
 
 void Transaction::ObjectLog::VisitRoots(RootVisitor* visitor) {
-  for (auto& it : field_values_) {
-    FieldValue& field_value = it.second;
+  for (FieldValue& field_value : field_values_) {
     if (field_value.kind == ObjectLog::kReference) {
       visitor->VisitRootIfNonNull(reinterpret_cast<mirror::Object**>(&field_value.value),
                                   RootInfo(kRootUnknown));
@@ -684,16 +712,26 @@ Transaction::InternStringLog::InternStringLog(ObjPtr<mirror::String> s,
 }
 
 void Transaction::ArrayLog::LogValue(size_t index, uint64_t value) {
-  // Add a mapping if there is none yet.
-  array_values_.FindOrAdd(index, value);
+  auto it = array_values_.end();
+  if (!array_values_.empty() && array_values_.back().index >= index) {
+    it = std::lower_bound(array_values_.begin(),
+                          array_values_.end(),
+                          index,
+                          [](const ArrayValue& lhs, size_t rhs) { return lhs.index < rhs; });
+    if (it->index == index) {
+      // Only the value before the first write needs to be restored.
+      return;
+    }
+  }
+  array_values_.insert(it, ArrayValue{value, index});
 }
 
 void Transaction::ArrayLog::Undo(mirror::Array* array) const {
   DCHECK(array != nullptr);
   DCHECK(array->IsArrayInstance());
   Primitive::Type type = array->GetClass()->GetComponentType()->GetPrimitiveType();
-  for (auto it : array_values_) {
-    UndoArrayWrite(array, type, it.first, it.second);
+  for (const ArrayValue& array_value : array_values_) {
+    UndoArrayWrite(array, type, array_value.index, array_value.value);
   }
 }
 
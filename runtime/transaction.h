@@ -163,11 +163,11 @@ class Transaction final {
     }
 
     explicit ObjectLog(ScopedArenaAllocator* allocator)
-        : field_values_(std::less<uint32_t>(), allocator->Adapter(kArenaAllocTransaction)) {}
+        : field_values_(allocator->Adapter(kArenaAllocTransaction)) {}
     ObjectLog(ObjectLog&& log) = default;
 
    private:
-    enum FieldValueKind {
+    enum FieldValueKind : uint8_t {
       kBoolean,
       kByte,
       kChar,
@@ -176,17 +176,12 @@ class Transaction final {
       k64Bits,
       kReference
     };
-    struct FieldValue : public ValueObject {
+    struct FieldValue {
       // TODO use JValue instead ?
       uint64_t value;
+      uint32_t offset;
       FieldValueKind kind;
       bool is_volatile;
-
-      FieldValue() : value(0), kind(FieldValueKind::kBoolean), is_volatile(false) {}
-      FieldValue(FieldValue&& log) = default;
-
-     private:
-      DISALLOW_COPY_AND_ASSIGN(FieldValue);
     };
 
     void LogValue(FieldValueKind kind, MemberOffset offset, uint64_t value, bool is_volatile);
@@ -194,8 +189,9 @@ class Transaction final {
                         MemberOffset field_offset,
                         const FieldValue& field_value) const REQUIRES_SHARED(Locks::mutator_lock_);
 
-    // Maps field's offset to its value.
-    ScopedArenaSafeMap<uint32_t, FieldValue> field_values_;
+    // The value of each field before its first write, sorted by offset. Fields are mostly
+    // written in increasing offset order, so this is usually an append.
+    ScopedArenaVector<FieldValue> field_values_;
 
     DISALLOW_COPY_AND_ASSIGN(ObjectLog);
   };
@@ -211,19 +207,25 @@ class Transaction final {
     }
 
     explicit ArrayLog(ScopedArenaAllocator* allocator)
-        : array_values_(std::less<size_t>(), allocator->Adapter(kArenaAllocTransaction)) {}
+        : array_values_(allocator->Adapter(kArenaAllocTransaction)) {}
 
     ArrayLog(ArrayLog&& log) = default;
 
    private:
+    struct ArrayValue {
+      // TODO use JValue instead ?
+      uint64_t value;
+      size_t index;
+    };
+
     void UndoArrayWrite(mirror::Array* array,
                         Primitive::Type array_type,
                         size_t index,
                         uint64_t value) const REQUIRES_SHARED(Locks::mutator_lock_);
 
-    // Maps index to value.
-    // TODO use JValue instead ?
-    ScopedArenaSafeMap<size_t, uint64_t> array_values_;
+    // The value of each element before its first write, sorted by index, like
+    // `ObjectLog::field_values_`.
+    ScopedArenaVector<ArrayValue> array_values_;
 
     DISALLOW_COPY_AND_ASSIGN(ArrayLog);
   };
@@ -317,6 +319,7 @@ class Transaction final {
   const std::string& GetAbortMessage() const;
 
   ObjectLog& GetOrCreateObjectLog(mirror::Object* obj);
+  ArrayLog& GetOrCreateArrayLog(mirror::Array* array);
 
   // The top-level transaction creates an `ArenaStack` which is then
   // passed down to nested transactions.
@@ -326,6 +329,13 @@ class Transaction final {
 
   ScopedArenaSafeMap<mirror::Object*, ObjectLog> object_logs_;
   ScopedArenaSafeMap<mirror::Array*, ArrayLog> array_logs_;
+  // The logs of the last written object and array. Class initializers tend to write
+  // consecutively to the same object, so this avoids most of the map lookups. The map nodes
+  // do not move, but the keys do, so these are reset when visiting the roots.
+  mirror::Object* last_object_;
+  ObjectLog* last_object_log_;
+  mirror::Array* last_array_;
+  ArrayLog* last_array_log_;
   ScopedArenaForwardList<InternStringLog> intern_string_logs_;
   ScopedArenaForwardList<ResolveStringLog> resolve_string_logs_;
   ScopedArenaForwardList<ResolveMethodTypeLog> resolve_method_type_logs_;
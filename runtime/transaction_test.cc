@@ -163,6 +163,35 @@ TEST_F(TransactionTest, Array_length) {
   EXPECT_EQ(h_obj->GetLength(), kArraySize);
 }
 
+// Tests that only the value before the first write is restored, whatever the order of writes.
+TEST_F(TransactionTest, ArrayRewritesTest) {
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<1> hs(soa.Self());
+
+  constexpr int32_t kArraySize = 8;
+  Handle<mirror::IntArray> h_array = hs.NewHandle(mirror::IntArray::Alloc(soa.Self(), kArraySize));
+  ASSERT_TRUE(h_array != nullptr);
+  for (int32_t i = 0; i != kArraySize; ++i) {
+    h_array->Set(i, i);
+  }
+
+  EnterTransactionMode();
+  // Write every other element backwards, then all the elements twice.
+  for (int32_t i = kArraySize - 1; i >= 0; i -= 2) {
+    h_array->Set(i, -1);
+  }
+  for (int32_t value = -2; value != -4; --value) {
+    for (int32_t i = 0; i != kArraySize; ++i) {
+      h_array->Set(i, value);
+    }
+  }
+  RollbackAndExitTransactionMode();
+
+  for (int32_t i = 0; i != kArraySize; ++i) {
+    EXPECT_EQ(h_array->Get(i), i);
+  }
+}
+
 // Tests static fields are reset to their default value after transaction rollback.
 TEST_F(TransactionTest, StaticFieldsTest) {
   ScopedObjectAccess soa(Thread::Current());
@@ -37,6 +37,7 @@
 #include "dex/art_dex_file_loader.h"
 #include "dex/class_accessor-inl.h"
 #include "dex/dex_file_loader.h"
+#include "dex/utf.h"
 #include "gc/heap.h"
 #include "gc/space/image_space.h"
 #include "mirror/class-inl.h"
@@ -212,6 +213,20 @@ const uint8_t* VdexFile::GetNextTypeLookupTableData(const uint8_t* cursor,
   }
 }
 
+uint32_t VdexFile::TypeLookupTableDataSize(uint32_t num_class_defs) {
+  uint32_t table_size = TypeLookupTable::RawDataLength(num_class_defs);
+  return table_size != 0u ? table_size + num_class_defs * sizeof(uint32_t) : 0u;
+}
+
+std::vector<uint32_t> VdexFile::ComputeClassDescriptorHashes(const DexFile& dex_file) {
+  std::vector<uint32_t> hashes;
+  hashes.reserve(dex_file.NumClassDefs());
+  for (uint32_t i = 0; i != dex_file.NumClassDefs(); ++i) {
+    hashes.push_back(ComputeModifiedUtf8Hash(dex_file.GetClassDescriptor(dex_file.GetClassDef(i))));
+  }
+  return hashes;
+}
+
 bool VdexFile::OpenAllDexFiles(std::vector<std::unique_ptr<const DexFile>>* dex_files,
                                std::string* error_msg) const {
   size_t i = 0;
@@ -267,8 +282,7 @@ bool VdexFile::WriteToDisk(const std::string& path,
 
   size_t type_lookup_table_size = 0u;
   for (const DexFile* dex_file : dex_files) {
-    type_lookup_table_size +=
-        sizeof(uint32_t) + TypeLookupTable::RawDataLength(dex_file->NumClassDefs());
+    type_lookup_table_size += sizeof(uint32_t) + TypeLookupTableDataSize(dex_file->NumClassDefs());
   }
 
   VdexFile::VdexFileHeader vdex_header(/* has_dex_section= */ false);
@@ -345,14 +359,24 @@ bool VdexFile::WriteToDisk(const std::string& path,
   size_t written_type_lookup_table_size = 0;
   for (const DexFile* dex_file : dex_files) {
     TypeLookupTable type_lookup_table = TypeLookupTable::Create(*dex_file);
-    uint32_t size = type_lookup_table.RawDataLength();
+    uint32_t size = TypeLookupTableDataSize(dex_file->NumClassDefs());
     DCHECK_ALIGNED(size, 4);
-    if (!out->WriteFully(reinterpret_cast<const char*>(&size), sizeof(uint32_t)) ||
-        !out->WriteFully(reinterpret_cast<const char*>(type_lookup_table.RawData()), size)) {
+    if (!out->WriteFully(reinterpret_cast<const char*>(&size), sizeof(uint32_t))) {
       *error_msg = "Could not write type lookup table " + path;
       out->Unlink();
       return false;
     }
+    if (type_lookup_table.Valid()) {
+      std::vector<uint32_t> hashes = ComputeClassDescriptorHashes(*dex_file);
+      if (!out->WriteFully(reinterpret_cast<const char*>(type_lookup_table.RawData()),
+                           type_lookup_table.RawDataLength()) ||
+          !out->WriteFully(reinterpret_cast<const char*>(hashes.data()),
+                           hashes.size() * sizeof(uint32_t))) {
+        *error_msg = "Could not write type lookup table " + path;
+        out->Unlink();
+        return false;
+      }
+    }
     written_type_lookup_table_size += sizeof(uint32_t) + size;
   }
   DCHECK_EQ(written_type_lookup_table_size, type_lookup_table_size);
@@ -459,20 +483,15 @@ ClassStatus VdexFile::ComputeClassStatus(Thread* self, Handle<mirror::Class> cls
 
   // Fetch type checks offsets.
   uint32_t class_def_offset = dex_file_class_defs[class_def_index];
-  if (class_def_offset == verifier::VerifierDeps::kNotVerifiedMarker) {
+  if (!verifier::VerifierDeps::IsVerifiedOffsetEntry(class_def_offset)) {
     // Return a status that needs re-verification.
     return ClassStatus::kResolved;
   }
-  // End offset for this class's type checks. We know there is one and the loop
-  // will terminate.
-  uint32_t end_offset = verifier::VerifierDeps::kNotVerifiedMarker;
-  for (uint32_t i = class_def_index + 1; i < dex_file.NumClassDefs() + 1; ++i) {
-    end_offset = dex_file_class_defs[i];
-    if (end_offset != verifier::VerifierDeps::kNotVerifiedMarker) {
-      break;
-    }
-  }
-  DCHECK_NE(end_offset, verifier::VerifierDeps::kNotVerifiedMarker);
+  // End offset for this class's type checks, which is where the data for the next class
+  // starts. The last entry is the end of the type checks of all classes.
+  uint32_t end_offset =
+      verifier::VerifierDeps::GetOffsetFromEntry(dex_file_class_defs[class_def_index + 1]);
+  DCHECK_LE(class_def_offset, end_offset);
 
   uint32_t number_of_extra_strings = 0;
   // Offset where extra strings are stored.
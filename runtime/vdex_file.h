@@ -19,6 +19,7 @@
 
 #include <stdint.h>
 #include <string>
+#include <vector>
 
 #include "base/array_ref.h"
 #include "base/macros.h"
@@ -66,14 +67,21 @@ class VerifierDeps;
 //      uint32[D]                  DexFileDeps offsets for each dex file
 //      DexFileDeps[D][]           verification dependencies
 //        4-byte alignment
-//        uint32[class_def_size]     TypeAssignability offsets (kNotVerifiedMarker for a class
-//                                        that isn't verified)
+//        uint32[class_def_size]     TypeAssignability offsets (with kNotVerifiedFlag set for a
+//                                        class that isn't verified)
 //        uint32                     Offset of end of AssignabilityType sets
 //        uint8[]                    AssignabilityType sets
 //        4-byte alignment
 //        uint32                     Number of strings
 //        uint32[]                   String data offsets for each string
 //        uint8[]                    String data
+//
+//   TypeLookupTables
+//      4-byte alignment
+//      For each dex file:
+//        uint32                     Size of the two arrays below, 0 if there is no table
+//        uint8[]                    TypeLookupTable data
+//        uint32[class_def_size]     ComputeModifiedUtf8Hash() of each class def descriptor
 
 
 enum VdexSection : uint32_t {
@@ -122,8 +130,8 @@ class VdexFile {
     static constexpr uint8_t kVdexMagic[] = { 'v', 'd', 'e', 'x' };
 
     // The format version of the verifier deps header and the verifier deps.
-    // Last update: Introduce vdex sections.
-    static constexpr uint8_t kVdexVersion[] = { '0', '2', '7', '\0' };
+    // Last update: Store class descriptor hashes after the type lookup tables.
+    static constexpr uint8_t kVdexVersion[] = { '0', '2', '9', '\0' };
 
     uint8_t magic_[4];
     uint8_t vdex_version_[4];
@@ -271,6 +279,13 @@ class VdexFile {
 
   const uint8_t* GetNextTypeLookupTableData(const uint8_t* cursor, uint32_t dex_file_index) const;
 
+  // Returns the size of the type lookup table data of a dex file with `num_class_defs` class
+  // defs, which is its TypeLookupTable followed by the descriptor hashes of its class defs.
+  static uint32_t TypeLookupTableDataSize(uint32_t num_class_defs);
+
+  // Returns the descriptor hashes stored after the TypeLookupTable of `dex_file`.
+  static std::vector<uint32_t> ComputeClassDescriptorHashes(const DexFile& dex_file);
+
   // Get the location checksum of the dex file number `dex_file_index`.
   uint32_t GetLocationChecksum(uint32_t dex_file_index) const {
     DCHECK_LT(dex_file_index, GetNumberOfDexFiles());
@@ -668,71 +668,87 @@ const RegType& RegType::Merge(const RegType& incoming_type,
       return SelectNonConstant2(*this, incoming_type);  // 0 MERGE ref => ref
     } else if (IsJavaLangObject() || incoming_type.IsJavaLangObject()) {
       return reg_types->JavaLangObject(false);  // Object MERGE ref => Object
-    } else if (IsUnresolvedTypes() || incoming_type.IsUnresolvedTypes()) {
-      // We know how to merge an unresolved type with itself, 0 or Object. In this case we
-      // have two sub-classes and don't know how to merge. Create a new string-based unresolved
-      // type that reflects our lack of knowledge and that allows the rest of the unresolved
-      // mechanics to continue.
-      return reg_types->FromUnresolvedMerge(*this, incoming_type, verifier);
-    } else {  // Two reference types, compute Join
-      // Do not cache the classes as ClassJoin() can suspend and invalidate ObjPtr<>s.
-      DCHECK(GetClass() != nullptr && !GetClass()->IsPrimitive());
-      DCHECK(incoming_type.GetClass() != nullptr && !incoming_type.GetClass()->IsPrimitive());
-      ObjPtr<mirror::Class> join_class = ClassJoin(GetClass(),
-                                                   incoming_type.GetClass(),
-                                                   reg_types->GetClassLinker());
-      if (UNLIKELY(join_class == nullptr)) {
-        // Internal error joining the classes (e.g., OOME). Report an unresolved reference type.
-        // We cannot report an unresolved merge type, as that will attempt to merge the resolved
-        // components, leaving us in an infinite loop.
-        // We do not want to report the originating exception, as that would require a fast path
-        // out all the way to VerifyClass. Instead attempt to continue on without a detailed type.
-        Thread* self = Thread::Current();
-        self->AssertPendingException();
-        self->ClearException();
-
-        // When compiling on the host, we rather want to abort to ensure determinism for preopting.
-        // (In that case, it is likely a misconfiguration of dex2oat.)
-        if (!kIsTargetBuild && (verifier != nullptr && verifier->IsAotMode())) {
-          LOG(FATAL) << "Could not create class join of "
-                     << GetClass()->PrettyClass()
-                     << " & "
-                     << incoming_type.GetClass()->PrettyClass();
-          UNREACHABLE();
-        }
-
-        return reg_types->MakeUnresolvedReference();
-      }
-
-      // Record the dependency that both `GetClass()` and `incoming_type.GetClass()`
-      // are assignable to `join_class`. The `verifier` is null during unit tests.
-      if (verifier != nullptr) {
-        VerifierDeps::MaybeRecordAssignability(verifier->GetVerifierDeps(),
-                                               verifier->GetDexFile(),
-                                               verifier->GetClassDef(),
-                                               join_class,
-                                               GetClass());
-        VerifierDeps::MaybeRecordAssignability(verifier->GetVerifierDeps(),
-                                               verifier->GetDexFile(),
-                                               verifier->GetClassDef(),
-                                               join_class,
-                                               incoming_type.GetClass());
-      }
-      if (GetClass() == join_class && !IsPreciseReference()) {
-        return *this;
-      } else if (incoming_type.GetClass() == join_class && !incoming_type.IsPreciseReference()) {
-        return incoming_type;
-      } else {
-        std::string temp;
-        const char* descriptor = join_class->GetDescriptor(&temp);
-        return reg_types->FromClass(descriptor, join_class, /* precise= */ false);
+    } else {
+      // Merging the other references needs a class join or a search for an unresolved merged
+      // type. Loops merge the same types again on each iteration, so remember the result.
+      const RegType* merged = reg_types->FindMerge(*this, incoming_type);
+      if (merged == nullptr) {
+        merged = &MergeReferences(incoming_type, reg_types, verifier);
+        reg_types->AddMerge(*this, incoming_type, *merged);
       }
+      return *merged;
     }
   } else {
     return conflict;  // Unexpected types => Conflict
   }
 }
 
+const RegType& RegType::MergeReferences(const RegType& incoming_type,
+                                        RegTypeCache* reg_types,
+                                        MethodVerifier* verifier) const {
+  DCHECK(IsNonZeroReferenceTypes() && incoming_type.IsNonZeroReferenceTypes());
+  if (IsUnresolvedTypes() || incoming_type.IsUnresolvedTypes()) {
+    // We know how to merge an unresolved type with itself, 0 or Object. In this case we
+    // have two sub-classes and don't know how to merge. Create a new string-based unresolved
+    // type that reflects our lack of knowledge and that allows the rest of the unresolved
+    // mechanics to continue.
+    return reg_types->FromUnresolvedMerge(*this, incoming_type, verifier);
+  } else {  // Two reference types, compute Join
+    // Do not cache the classes as ClassJoin() can suspend and invalidate ObjPtr<>s.
+    DCHECK(GetClass() != nullptr && !GetClass()->IsPrimitive());
+    DCHECK(incoming_type.GetClass() != nullptr && !incoming_type.GetClass()->IsPrimitive());
+    ObjPtr<mirror::Class> join_class = ClassJoin(GetClass(),
+                                                 incoming_type.GetClass(),
+                                                 reg_types->GetClassLinker());
+    if (UNLIKELY(join_class == nullptr)) {
+      // Internal error joining the classes (e.g., OOME). Report an unresolved reference type.
+      // We cannot report an unresolved merge type, as that will attempt to merge the resolved
+      // components, leaving us in an infinite loop.
+      // We do not want to report the originating exception, as that would require a fast path
+      // out all the way to VerifyClass. Instead attempt to continue on without a detailed type.
+      Thread* self = Thread::Current();
+      self->AssertPendingException();
+      self->ClearException();
+
+      // When compiling on the host, we rather want to abort to ensure determinism for preopting.
+      // (In that case, it is likely a misconfiguration of dex2oat.)
+      if (!kIsTargetBuild && (verifier != nullptr && verifier->IsAotMode())) {
+        LOG(FATAL) << "Could not create class join of "
+                   << GetClass()->PrettyClass()
+                   << " & "
+                   << incoming_type.GetClass()->PrettyClass();
+        UNREACHABLE();
+      }
+
+      return reg_types->MakeUnresolvedReference();
+    }
+
+    // Record the dependency that both `GetClass()` and `incoming_type.GetClass()`
+    // are assignable to `join_class`. The `verifier` is null during unit tests.
+    if (verifier != nullptr) {
+      VerifierDeps::MaybeRecordAssignability(verifier->GetVerifierDeps(),
+                                             verifier->GetDexFile(),
+                                             verifier->GetClassDef(),
+                                             join_class,
+                                             GetClass());
+      VerifierDeps::MaybeRecordAssignability(verifier->GetVerifierDeps(),
+                                             verifier->GetDexFile(),
+                                             verifier->GetClassDef(),
+                                             join_class,
+                                             incoming_type.GetClass());
+    }
+    if (GetClass() == join_class && !IsPreciseReference()) {
+      return *this;
+    } else if (incoming_type.GetClass() == join_class && !incoming_type.IsPreciseReference()) {
+      return incoming_type;
+    } else {
+      std::string temp;
+      const char* descriptor = join_class->GetDescriptor(&temp);
+      return reg_types->FromClass(descriptor, join_class, /* precise= */ false);
+    }
+  }
+}
+
 void RegType::CheckInvariants() const {
   if (IsConstant() || IsConstantLo() || IsConstantHi()) {
     CHECK(descriptor_.empty()) << *this;
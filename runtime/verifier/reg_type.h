@@ -335,6 +335,11 @@ class RegType {
  private:
   virtual void CheckInvariants() const REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Merge of two reference types that are not uninitialized, null or java.lang.Object.
+  const RegType& MergeReferences(const RegType& incoming_type,
+                                 RegTypeCache* reg_types,
+                                 MethodVerifier* verifier) const
+      REQUIRES_SHARED(Locks::mutator_lock_);
 
   static bool AssignableFrom(const RegType& lhs,
                              const RegType& rhs,
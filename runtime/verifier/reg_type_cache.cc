@@ -296,6 +296,7 @@ RegTypeCache::RegTypeCache(ClassLinker* class_linker,
                            bool can_suspend)
     : entries_(allocator.Adapter(kArenaAllocVerifier)),
       klass_entries_(allocator.Adapter(kArenaAllocVerifier)),
+      merges_(allocator.Adapter(kArenaAllocVerifier)),
       allocator_(allocator),
       handles_(handles),
       class_linker_(class_linker),
@@ -313,6 +314,21 @@ RegTypeCache::RegTypeCache(ClassLinker* class_linker,
   FillPrimitiveAndSmallConstantTypes();
 }
 
+static uint32_t MergeKey(const RegType& left, const RegType& right) {
+  return (static_cast<uint32_t>(left.GetId()) << 16) | right.GetId();
+}
+
+const RegType* RegTypeCache::FindMerge(const RegType& left, const RegType& right) const {
+  auto it = merges_.find(MergeKey(left, right));
+  return (it != merges_.end()) ? it->second : nullptr;
+}
+
+void RegTypeCache::AddMerge(const RegType& left, const RegType& right, const RegType& merged) {
+  DCHECK_GE(left.GetId(), kNumPrimitivesAndSmallConstants);
+  DCHECK_GE(right.GetId(), kNumPrimitivesAndSmallConstants);
+  merges_.insert(std::make_pair(MergeKey(left, right), &merged));
+}
+
 const RegType& RegTypeCache::FromUnresolvedMerge(const RegType& left,
                                                  const RegType& right,
                                                  MethodVerifier* verifier) {
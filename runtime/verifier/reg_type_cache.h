@@ -102,6 +102,12 @@ class RegTypeCache {
   const RegType& FromUnresolvedSuperClass(const RegType& child)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Returns the result of an earlier merge of the reference types `left` and `right`, or null if
+  // they were not merged yet.
+  const RegType* FindMerge(const RegType& left, const RegType& right) const;
+  // Remember that merging the reference types `left` and `right` results in `merged`.
+  void AddMerge(const RegType& left, const RegType& right, const RegType& merged);
+
   // Note: this should not be used outside of RegType::ClassJoin!
   const RegType& MakeUnresolvedReference() REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -202,6 +208,10 @@ class RegTypeCache {
   // Fast lookup for quickly finding entries that have a matching class.
   ScopedArenaVector<std::pair<Handle<mirror::Class>, const RegType*>> klass_entries_;
 
+  // Results of merging reference types, keyed by the ids of the merged types. The key is never 0
+  // as reference types are not among the primitives and small constants.
+  ScopedArenaHashMap<uint32_t, const RegType*> merges_;
+
   // Arena allocator.
   ScopedArenaAllocator& allocator_;
 
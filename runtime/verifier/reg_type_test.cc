@@ -530,6 +530,12 @@ TEST_F(RegTypeReferenceTest, Merging) {
       down_cast<UnresolvedMergedType*>(&merged_nonconst)->GetUnresolvedTypes();
   EXPECT_TRUE(unresolved_parts.IsBitSet(ref_type_0.GetId()));
   EXPECT_TRUE(unresolved_parts.IsBitSet(ref_type_1.GetId()));
+
+  // Merging the same types again returns the remembered merge.
+  EXPECT_EQ(&merged, cache_new.FindMerge(ref_type_1, ref_type_0));
+  size_t cache_size = cache_new.GetCacheSize();
+  EXPECT_EQ(&merged, &ref_type_1.Merge(ref_type_0, &cache_new, /* verifier= */ nullptr));
+  EXPECT_EQ(cache_size, cache_new.GetCacheSize());
 }
 
 TEST_F(RegTypeTest, MergingFloat) {
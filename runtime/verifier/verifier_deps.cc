@@ -401,6 +401,7 @@ static void EncodeSetVector(std::vector<uint8_t>* out,
   out->resize(out->size() + (vector.size() + 1) * sizeof(uint32_t));
   uint32_t class_def_index = 0;
   for (const std::set<T>& set : vector) {
+    DCHECK_EQ(out->size() & VerifierDeps::kNotVerifiedFlag, 0u);
     if (verified_classes[class_def_index]) {
       // Store the offset of the set for this class.
       SetUint32InUint8Array(out, offsets_index, class_def_index, out->size());
@@ -408,7 +409,9 @@ static void EncodeSetVector(std::vector<uint8_t>* out,
         EncodeTuple(out, entry);
       }
     } else {
-      SetUint32InUint8Array(out, offsets_index, class_def_index, VerifierDeps::kNotVerifiedMarker);
+      // Store the offset with the flag, so that the set of the previous class ends here.
+      SetUint32InUint8Array(
+          out, offsets_index, class_def_index, out->size() | VerifierDeps::kNotVerifiedFlag);
     }
     class_def_index++;
   }
@@ -423,13 +426,12 @@ static bool DecodeSetVector(const uint8_t** cursor,
                             std::vector<bool>* verified_classes,
                             size_t num_class_defs) {
   const uint32_t* offsets = reinterpret_cast<const uint32_t*>(*cursor);
-  uint32_t next_valid_offset_index = 1;
   // Put the cursor after the offsets of each class, +1 for the offset of the
   // end of the assignable types data.
   *cursor += (num_class_defs + 1) * sizeof(uint32_t);
   for (uint32_t i = 0; i < num_class_defs; ++i) {
     uint32_t offset = offsets[i];
-    if (offset == VerifierDeps::kNotVerifiedMarker) {
+    if (!VerifierDeps::IsVerifiedOffsetEntry(offset)) {
       (*verified_classes)[i] = false;
       continue;
     }
@@ -437,14 +439,13 @@ static bool DecodeSetVector(const uint8_t** cursor,
     *cursor = start + offset;
     // Fetch the assignability checks.
     std::set<T>& set = (*vector)[i];
-    // Find the offset of the next entry. This will tell us where to stop when
-    // reading the checks. Note that the last entry in the `offsets` array points
-    // to the end of the assignability types data, so the loop will terminate correctly.
-    while (next_valid_offset_index <= i ||
-           offsets[next_valid_offset_index] == VerifierDeps::kNotVerifiedMarker) {
-      next_valid_offset_index++;
+    // The offset in the next entry tells us where to stop when reading the checks.
+    // Note that the last entry in the `offsets` array points to the end of the
+    // assignability types data.
+    const uint8_t* set_end = start + VerifierDeps::GetOffsetFromEntry(offsets[i + 1]);
+    if (UNLIKELY(set_end < *cursor || set_end > end)) {
+      return false;
     }
-    const uint8_t* set_end = start + offsets[next_valid_offset_index];
     // Decode each check.
     while (*cursor < set_end) {
       T tuple;
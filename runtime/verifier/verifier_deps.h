@@ -62,9 +62,20 @@ class VerifierDeps {
  public:
   explicit VerifierDeps(const std::vector<const DexFile*>& dex_files, bool output_only = true);
 
-  // Marker to know whether a class is verified. A non-verified class will have
-  // this marker as its offset entry in the encoded data.
-  static uint32_t constexpr kNotVerifiedMarker = std::numeric_limits<uint32_t>::max();
+  // Flag to know whether a class is verified. A non-verified class has this flag set in its
+  // offset entry in the encoded data. The rest of the entry is still the offset where the
+  // class's (empty) set would start, so that the end of any class's set is the next entry.
+  static uint32_t constexpr kNotVerifiedFlag = 1u << 31;
+
+  // Returns whether the offset entry of a class in the encoded data is for a verified class.
+  static bool IsVerifiedOffsetEntry(uint32_t entry) {
+    return (entry & kNotVerifiedFlag) == 0u;
+  }
+
+  // Returns the offset stored in the offset entry of a class in the encoded data.
+  static uint32_t GetOffsetFromEntry(uint32_t entry) {
+    return entry & ~kNotVerifiedFlag;
+  }
 
   // Fill dependencies from stored data. Returns true on success, false on failure.
   bool ParseStoredData(const std::vector<const DexFile*>& dex_files, ArrayRef<const uint8_t> data);
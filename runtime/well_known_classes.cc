@@ -19,22 +19,29 @@
 #include <stdlib.h>
 
 #include <sstream>
+#include <vector>
 
 #include <android-base/logging.h>
 #include <android-base/stringprintf.h>
 
+#include "art_field-inl.h"
 #include "art_method-inl.h"
 #include "base/casts.h"
 #include "base/enums.h"
+#include "base/length_prefixed_array.h"
 #include "class_linker.h"
 #include "class_root-inl.h"
 #include "entrypoints/quick/quick_entrypoints_enum.h"
+#include "gc/heap.h"
+#include "gc/space/image_space.h"
 #include "handle_scope-inl.h"
 #include "hidden_api.h"
 #include "jni/java_vm_ext.h"
 #include "jni/jni_internal.h"
 #include "jni_id_type.h"
-#include "mirror/class.h"
+#include "mirror/array-inl.h"
+#include "mirror/class-inl.h"
+#include "mirror/object_array-inl.h"
 #include "mirror/throwable.h"
 #include "nativehelper/scoped_local_ref.h"
 #include "obj_ptr-inl.h"
@@ -161,6 +168,114 @@ ArtField* WellKnownClasses::org_apache_harmony_dalvik_ddmc_Chunk_length;
 ArtField* WellKnownClasses::org_apache_harmony_dalvik_ddmc_Chunk_offset;
 ArtField* WellKnownClasses::org_apache_harmony_dalvik_ddmc_Chunk_type;
 
+// The members found by name in `InitFieldsAndMethodsByName()`. The boot image records them in
+// this order, so changing these lists requires a new `ImageHeader::kImageVersion`.
+static ArtMethod** const kBootImageMethods[] = {
+    &WellKnownClasses::dalvik_system_BaseDexClassLoader_getLdLibraryPath,
+    &WellKnownClasses::dalvik_system_DelegateLastClassLoader_init,
+    &WellKnownClasses::dalvik_system_DexClassLoader_init,
+    &WellKnownClasses::dalvik_system_InMemoryDexClassLoader_init,
+    &WellKnownClasses::dalvik_system_PathClassLoader_init,
+    &WellKnownClasses::dalvik_system_VMRuntime_hiddenApiUsed,
+    &WellKnownClasses::java_lang_Boolean_valueOf,
+    &WellKnownClasses::java_lang_BootClassLoader_init,
+    &WellKnownClasses::java_lang_Byte_valueOf,
+    &WellKnownClasses::java_lang_Character_valueOf,
+    &WellKnownClasses::java_lang_ClassLoader_loadClass,
+    &WellKnownClasses::java_lang_ClassNotFoundException_init,
+    &WellKnownClasses::java_lang_Daemons_start,
+    &WellKnownClasses::java_lang_Daemons_stop,
+    &WellKnownClasses::java_lang_Daemons_waitForDaemonStart,
+    &WellKnownClasses::java_lang_Double_doubleToRawLongBits,
+    &WellKnownClasses::java_lang_Double_valueOf,
+    &WellKnownClasses::java_lang_Error_init,
+    &WellKnownClasses::java_lang_Float_floatToRawIntBits,
+    &WellKnownClasses::java_lang_Float_valueOf,
+    &WellKnownClasses::java_lang_IllegalAccessError_init,
+    &WellKnownClasses::java_lang_Integer_valueOf,
+    &WellKnownClasses::java_lang_Long_valueOf,
+    &WellKnownClasses::java_lang_NoClassDefFoundError_init,
+    &WellKnownClasses::java_lang_OutOfMemoryError_init,
+    &WellKnownClasses::java_lang_RuntimeException_init,
+    &WellKnownClasses::java_lang_Short_valueOf,
+    &WellKnownClasses::java_lang_StackOverflowError_init,
+    &WellKnownClasses::java_lang_String_charAt,
+    &WellKnownClasses::java_lang_Thread_dispatchUncaughtException,
+    &WellKnownClasses::java_lang_Thread_init,
+    &WellKnownClasses::java_lang_Thread_run,
+    &WellKnownClasses::java_lang_ThreadGroup_add,
+    &WellKnownClasses::java_lang_ThreadGroup_threadTerminated,
+    &WellKnownClasses::java_lang_invoke_MethodHandle_asType,
+    &WellKnownClasses::java_lang_invoke_MethodHandle_invokeExact,
+    &WellKnownClasses::java_lang_invoke_MethodHandles_lookup,
+    &WellKnownClasses::java_lang_invoke_MethodHandles_Lookup_findConstructor,
+    &WellKnownClasses::java_lang_ref_FinalizerReference_add,
+    &WellKnownClasses::java_lang_ref_ReferenceQueue_add,
+    &WellKnownClasses::java_lang_reflect_InvocationTargetException_init,
+    &WellKnownClasses::java_lang_reflect_Parameter_init,
+    &WellKnownClasses::java_lang_reflect_Proxy_init,
+    &WellKnownClasses::java_lang_reflect_Proxy_invoke,
+    &WellKnownClasses::java_nio_Buffer_isDirect,
+    &WellKnownClasses::java_nio_DirectByteBuffer_init,
+    &WellKnownClasses::java_util_function_Consumer_accept,
+    &WellKnownClasses::jdk_internal_math_FloatingDecimal_getBinaryToASCIIConverter_D,
+    &WellKnownClasses::jdk_internal_math_FloatingDecimal_getBinaryToASCIIConverter_F,
+    &WellKnownClasses::jdk_internal_math_FloatingDecimal_BinaryToASCIIBuffer_getChars,
+    &WellKnownClasses::libcore_reflect_AnnotationFactory_createAnnotation,
+    &WellKnownClasses::libcore_reflect_AnnotationMember_init,
+    &WellKnownClasses::org_apache_harmony_dalvik_ddmc_DdmServer_broadcast,
+    &WellKnownClasses::org_apache_harmony_dalvik_ddmc_DdmServer_dispatch,
+};
+
+static ArtField** const kBootImageFields[] = {
+    &WellKnownClasses::dalvik_system_BaseDexClassLoader_pathList,
+    &WellKnownClasses::dalvik_system_BaseDexClassLoader_sharedLibraryLoaders,
+    &WellKnownClasses::dalvik_system_BaseDexClassLoader_sharedLibraryLoadersAfter,
+    &WellKnownClasses::dalvik_system_DexFile_cookie,
+    &WellKnownClasses::dalvik_system_DexFile_fileName,
+    &WellKnownClasses::dalvik_system_DexPathList_dexElements,
+    &WellKnownClasses::dalvik_system_DexPathList__Element_dexFile,
+    &WellKnownClasses::dalvik_system_VMRuntime_nonSdkApiUsageConsumer,
+    &WellKnownClasses::java_io_FileDescriptor_descriptor,
+    &WellKnownClasses::java_lang_ClassLoader_parent,
+    &WellKnownClasses::java_lang_Thread_parkBlocker,
+    &WellKnownClasses::java_lang_Thread_daemon,
+    &WellKnownClasses::java_lang_Thread_group,
+    &WellKnownClasses::java_lang_Thread_lock,
+    &WellKnownClasses::java_lang_Thread_name,
+    &WellKnownClasses::java_lang_Thread_priority,
+    &WellKnownClasses::java_lang_Thread_nativePeer,
+    &WellKnownClasses::java_lang_Thread_systemDaemon,
+    &WellKnownClasses::java_lang_Thread_unparkedBeforeStart,
+    &WellKnownClasses::java_lang_ThreadGroup_groups,
+    &WellKnownClasses::java_lang_ThreadGroup_ngroups,
+    &WellKnownClasses::java_lang_ThreadGroup_mainThreadGroup,
+    &WellKnownClasses::java_lang_ThreadGroup_name,
+    &WellKnownClasses::java_lang_ThreadGroup_parent,
+    &WellKnownClasses::java_lang_ThreadGroup_systemThreadGroup,
+    &WellKnownClasses::java_lang_Throwable_cause,
+    &WellKnownClasses::java_lang_Throwable_detailMessage,
+    &WellKnownClasses::java_lang_Throwable_stackTrace,
+    &WellKnownClasses::java_lang_Throwable_stackState,
+    &WellKnownClasses::java_lang_Throwable_suppressedExceptions,
+    &WellKnownClasses::java_nio_Buffer_address,
+    &WellKnownClasses::java_nio_Buffer_capacity,
+    &WellKnownClasses::java_nio_Buffer_elementSizeShift,
+    &WellKnownClasses::java_nio_Buffer_limit,
+    &WellKnownClasses::java_nio_Buffer_position,
+    &WellKnownClasses::java_nio_ByteBuffer_hb,
+    &WellKnownClasses::java_nio_ByteBuffer_isReadOnly,
+    &WellKnownClasses::java_nio_ByteBuffer_offset,
+    &WellKnownClasses::java_util_Collections_EMPTY_LIST,
+    &WellKnownClasses::jdk_internal_math_FloatingDecimal_BinaryToASCIIBuffer_buffer,
+    &WellKnownClasses::jdk_internal_math_FloatingDecimal_ExceptionalBinaryToASCIIBuffer_image,
+    &WellKnownClasses::libcore_util_EmptyArray_STACK_TRACE_ELEMENT,
+    &WellKnownClasses::org_apache_harmony_dalvik_ddmc_Chunk_data,
+    &WellKnownClasses::org_apache_harmony_dalvik_ddmc_Chunk_length,
+    &WellKnownClasses::org_apache_harmony_dalvik_ddmc_Chunk_offset,
+    &WellKnownClasses::org_apache_harmony_dalvik_ddmc_Chunk_type,
+};
+
 static ObjPtr<mirror::Class> FindSystemClass(ClassLinker* class_linker,
                                              Thread* self,
                                              const char* descriptor)
@@ -336,6 +451,84 @@ void WellKnownClasses::Init(JNIEnv* env) {
   InitFieldsAndMethodsOnly(env);
 }
 
+size_t WellKnownClasses::GetNumberOfBootImageMembers() {
+  return arraysize(kBootImageMethods) + arraysize(kBootImageFields);
+}
+
+// Each index is the position of the member in `GetMethodsSlice()`, `GetSFieldsPtr()` or
+// `GetIFieldsPtr()` of its class. Field indexes have the low bit set for static fields.
+void WellKnownClasses::FillBootImageMembers(ObjPtr<mirror::ObjectArray<mirror::Class>> classes,
+                                            ObjPtr<mirror::IntArray> indexes) {
+  DCHECK_EQ(static_cast<size_t>(classes->GetLength()), GetNumberOfBootImageMembers());
+  DCHECK_EQ(static_cast<size_t>(indexes->GetLength()), GetNumberOfBootImageMembers());
+  PointerSize pointer_size = Runtime::Current()->GetClassLinker()->GetImagePointerSize();
+  int32_t pos = 0;
+  for (ArtMethod** member : kBootImageMethods) {
+    ArtMethod* method = *member;
+    ObjPtr<mirror::Class> klass = method->GetDeclaringClass();
+    ArraySlice<ArtMethod> methods = klass->GetMethodsSlice(pointer_size);
+    int32_t index = 0;
+    while (&methods[index] != method) {
+      ++index;
+      DCHECK_LT(static_cast<size_t>(index), methods.size());
+    }
+    classes->Set</*kTransactionActive=*/ false>(pos, klass);
+    indexes->Set</*kTransactionActive=*/ false>(pos, index);
+    ++pos;
+  }
+  for (ArtField** member : kBootImageFields) {
+    ArtField* field = *member;
+    ObjPtr<mirror::Class> klass = field->GetDeclaringClass();
+    LengthPrefixedArray<ArtField>* fields =
+        field->IsStatic() ? klass->GetSFieldsPtr() : klass->GetIFieldsPtr();
+    int32_t index = dchecked_integral_cast<int32_t>(field - &fields->At(0));
+    DCHECK_LT(static_cast<size_t>(index), fields->size());
+    classes->Set</*kTransactionActive=*/ false>(pos, klass);
+    indexes->Set</*kTransactionActive=*/ false>(pos, (index << 1) | (field->IsStatic() ? 1 : 0));
+    ++pos;
+  }
+}
+
+bool WellKnownClasses::InitFieldsAndMethodsFromBootImage(ClassLinker* class_linker) {
+  gc::Heap* heap = Runtime::Current()->GetHeap();
+  if (!heap->HasBootImageSpace()) {
+    return false;
+  }
+  const ImageHeader& image_header = heap->GetBootImageSpaces()[0]->GetImageHeader();
+  ObjPtr<mirror::ObjectArray<mirror::Object>> boot_image_live_objects =
+      ObjPtr<mirror::ObjectArray<mirror::Object>>::DownCast(
+          image_header.GetImageRoot(ImageHeader::kBootImageLiveObjects));
+  ObjPtr<mirror::ObjectArray<mirror::Class>> classes =
+      ObjPtr<mirror::ObjectArray<mirror::Class>>::DownCast(
+          boot_image_live_objects->Get(ImageHeader::kWellKnownMemberClasses));
+  ObjPtr<mirror::IntArray> indexes = ObjPtr<mirror::IntArray>::DownCast(
+      boot_image_live_objects->Get(ImageHeader::kWellKnownMemberIndexes));
+  if (classes == nullptr) {
+    // The boot image does not contain all the declaring classes.
+    DCHECK(indexes == nullptr);
+    return false;
+  }
+  CHECK_EQ(static_cast<size_t>(classes->GetLength()), GetNumberOfBootImageMembers());
+  CHECK_EQ(static_cast<size_t>(indexes->GetLength()), GetNumberOfBootImageMembers());
+
+  PointerSize pointer_size = class_linker->GetImagePointerSize();
+  int32_t pos = 0;
+  for (ArtMethod** member : kBootImageMethods) {
+    ObjPtr<mirror::Class> klass = classes->GetWithoutChecks(pos);
+    *member = &klass->GetMethodsSlice(pointer_size)[indexes->GetWithoutChecks(pos)];
+    ++pos;
+  }
+  for (ArtField** member : kBootImageFields) {
+    ObjPtr<mirror::Class> klass = classes->GetWithoutChecks(pos);
+    int32_t index = indexes->GetWithoutChecks(pos);
+    LengthPrefixedArray<ArtField>* fields =
+        ((index & 1) != 0) ? klass->GetSFieldsPtr() : klass->GetIFieldsPtr();
+    *member = &fields->At(static_cast<uint32_t>(index) >> 1);
+    ++pos;
+  }
+  return true;
+}
+
 void WellKnownClasses::InitFieldsAndMethodsOnly(JNIEnv* env) {
   hiddenapi::ScopedHiddenApiEnforcementPolicySetting hiddenapi_exemption(
       hiddenapi::EnforcementPolicy::kDisabled);
@@ -344,6 +537,30 @@ void WellKnownClasses::InitFieldsAndMethodsOnly(JNIEnv* env) {
   ScopedObjectAccess soa(self);
   ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
 
+  // With a boot image, skip the lookups by name, apart from debug builds which check that both
+  // find the same members.
+  if (!InitFieldsAndMethodsFromBootImage(class_linker)) {
+    InitFieldsAndMethodsByName(self, class_linker);
+  } else if (kIsDebugBuild) {
+    std::vector<ArtMethod*> image_methods;
+    for (ArtMethod** member : kBootImageMethods) {
+      image_methods.push_back(*member);
+    }
+    std::vector<ArtField*> image_fields;
+    for (ArtField** member : kBootImageFields) {
+      image_fields.push_back(*member);
+    }
+    InitFieldsAndMethodsByName(self, class_linker);
+    for (size_t i = 0; i != arraysize(kBootImageMethods); ++i) {
+      CHECK_EQ(image_methods[i], *kBootImageMethods[i]) << (*kBootImageMethods[i])->PrettyMethod();
+    }
+    for (size_t i = 0; i != arraysize(kBootImageFields); ++i) {
+      CHECK_EQ(image_fields[i], *kBootImageFields[i]) << (*kBootImageFields[i])->PrettyField();
+    }
+  }
+}
+
+void WellKnownClasses::InitFieldsAndMethodsByName(Thread* self, ClassLinker* class_linker) {
   java_lang_Boolean_valueOf =
       CachePrimitiveBoxingMethod(class_linker, self, 'Z', "Ljava/lang/Boolean;");
   java_lang_Byte_valueOf =
@@ -26,9 +26,14 @@ namespace art {
 
 class ArtField;
 class ArtMethod;
+class ClassLinker;
+class Thread;
 
 namespace mirror {
 class Class;
+template<class T> class ObjectArray;
+template<class T> class PrimitiveArray;
+using IntArray = PrimitiveArray<int32_t>;
 }  // namespace mirror
 
 namespace detail {
@@ -80,8 +85,20 @@ struct WellKnownClasses {
 
   static ObjPtr<mirror::Class> ToClass(jclass global_jclass) REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // The boot image records the declaring classes of the methods and fields that are otherwise
+  // looked up by name, together with the indexes of the members in these classes. See
+  // `ImageHeader::kWellKnownMemberClasses`.
+  static size_t GetNumberOfBootImageMembers();
+  static void FillBootImageMembers(ObjPtr<mirror::ObjectArray<mirror::Class>> classes,
+                                   ObjPtr<mirror::IntArray> indexes)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
  private:
   static void InitFieldsAndMethodsOnly(JNIEnv* env);
+  static bool InitFieldsAndMethodsFromBootImage(ClassLinker* class_linker)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+  static void InitFieldsAndMethodsByName(Thread* self, ClassLinker* class_linker)
+      REQUIRES_SHARED(Locks::mutator_lock_);
 
   template <ArtMethod** kMethod>
   using ClassFromMethod = detail::ClassFromMember<ArtMethod, kMethod>;
@@ -220,16 +237,24 @@ struct WellKnownClasses {
       dalvik_system_InMemoryDexClassLoader;
   static constexpr ClassFromMethod<&dalvik_system_PathClassLoader_init>
       dalvik_system_PathClassLoader;
+  static constexpr ClassFromMethod<&java_lang_Boolean_valueOf> java_lang_Boolean;
   static constexpr ClassFromMethod<&java_lang_BootClassLoader_init> java_lang_BootClassLoader;
+  static constexpr ClassFromMethod<&java_lang_Byte_valueOf> java_lang_Byte;
+  static constexpr ClassFromMethod<&java_lang_Character_valueOf> java_lang_Character;
   static constexpr ClassFromField<&java_lang_ClassLoader_parent> java_lang_ClassLoader;
   static constexpr ClassFromMethod<&java_lang_Daemons_start> java_lang_Daemons;
+  static constexpr ClassFromMethod<&java_lang_Double_valueOf> java_lang_Double;
   static constexpr ClassFromMethod<&java_lang_Error_init> java_lang_Error;
+  static constexpr ClassFromMethod<&java_lang_Float_valueOf> java_lang_Float;
   static constexpr ClassFromMethod<&java_lang_IllegalAccessError_init>
       java_lang_IllegalAccessError;
+  static constexpr ClassFromMethod<&java_lang_Integer_valueOf> java_lang_Integer;
+  static constexpr ClassFromMethod<&java_lang_Long_valueOf> java_lang_Long;
   static constexpr ClassFromMethod<&java_lang_NoClassDefFoundError_init>
       java_lang_NoClassDefFoundError;
   static constexpr ClassFromMethod<&java_lang_OutOfMemoryError_init> java_lang_OutOfMemoryError;
   static constexpr ClassFromMethod<&java_lang_RuntimeException_init> java_lang_RuntimeException;
+  static constexpr ClassFromMethod<&java_lang_Short_valueOf> java_lang_Short;
   static constexpr ClassFromMethod<&java_lang_StackOverflowError_init>
       java_lang_StackOverflowError;
   static constexpr ClassFromField<&java_lang_Thread_daemon> java_lang_Thread;
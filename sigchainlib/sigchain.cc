@@ -56,7 +56,9 @@
 // forwards signals appropriately.
 //
 // In our handler, we start off with all signals blocked, fetch the original signal mask from the
-// passed in ucontext, and then adjust our signal mask appropriately for the user handler.
+// passed in ucontext, and then adjust our signal mask appropriately for the user handler. If there
+// are special handlers, the kernel blocks the signals of the first one instead, so that handling a
+// fault in the first special handler doesn't need any sigprocmask call.
 //
 // It's somewhat tricky for us to properly handle some flag cases:
 //   SA_NOCLDSTOP and SA_NOCLDWAIT: shouldn't matter, we don't have special handlers for SIGCHLD.
@@ -259,23 +261,12 @@ class SignalChain {
 
   // Register the signal chain with the kernel if needed.
   void Register(int signo) {
+    SetKernelAction(signo, &action_);
 #if defined(__BIONIC__)
     struct sigaction64 handler_action = {};
-    sigfillset64(&handler_action.sa_mask);
-#else
-    struct sigaction handler_action = {};
-    sigfillset(&handler_action.sa_mask);
-#endif
-
-    handler_action.sa_sigaction = SignalChain::Handler;
-    handler_action.sa_flags = SA_RESTART | SA_SIGINFO | SA_ONSTACK |
-                              SA_UNSUPPORTED | SA_EXPOSE_TAGBITS;
-
-#if defined(__BIONIC__)
-    linked_sigaction64(signo, &handler_action, &action_);
     linked_sigaction64(signo, nullptr, &handler_action);
 #else
-    linked_sigaction(signo, &handler_action, &action_);
+    struct sigaction handler_action = {};
     linked_sigaction(signo, nullptr, &handler_action);
 #endif
 
@@ -316,6 +307,25 @@ class SignalChain {
     }
   }
 
+  // Update the mask of the signal chain in the kernel after the special handlers changed. Leaves
+  // the kernel alone if the signal chain is not registered or was circumvented.
+  void UpdateKernelAction(int signo) {
+    if (!claimed_) {
+      return;
+    }
+#if defined(__BIONIC__)
+    struct sigaction64 handler_action = {};
+    linked_sigaction64(signo, nullptr, &handler_action);
+#else
+    struct sigaction handler_action = {};
+    linked_sigaction(signo, nullptr, &handler_action);
+#endif
+    if (handler_action.sa_sigaction != SignalChain::Handler) {
+      return;
+    }
+    SetKernelAction(signo, nullptr);
+  }
+
   template <typename SigactionType>
   SigactionType GetAction() {
     if constexpr (std::is_same_v<decltype(action_), SigactionType>) {
@@ -353,7 +363,10 @@ class SignalChain {
   void AddSpecialHandler(SigchainAction* sa) {
     for (SigchainAction& slot : special_handlers_) {
       if (slot.sc_sigaction == nullptr) {
-        slot = *sa;
+        // Publish the handler last, the signal handler may run concurrently.
+        slot.sc_mask = sa->sc_mask;
+        slot.sc_flags = sa->sc_flags;
+        __atomic_store_n(&slot.sc_sigaction, sa->sc_sigaction, __ATOMIC_RELEASE);
         return;
       }
     }
@@ -381,6 +394,105 @@ class SignalChain {
   static void Handler(int signo, siginfo_t* siginfo, void*);
 
  private:
+#if defined(__BIONIC__)
+  using KernelSigaction = struct sigaction64;
+#else
+  using KernelSigaction = struct sigaction;
+#endif
+
+  // Make the kernel use the action of the signal chain, and return the previous action in
+  // `old_action` if not null. The signal may be handled on any thread meanwhile, so the handler
+  // mask is not used while the sequence number is odd, see KernelSetHandlerMask().
+  void SetKernelAction(int signo, KernelSigaction* old_action) {
+    KernelSigaction handler_action = {};
+    int unblocked_signals[_NSIG];
+    size_t num_unblocked_signals = 0u;
+    bool uses_handler_mask =
+        InitHandlerAction(signo, &handler_action, unblocked_signals, &num_unblocked_signals);
+
+    uint32_t sequence = handler_mask_sequence_.load(std::memory_order_relaxed);
+    handler_mask_sequence_.store(sequence + 1u, std::memory_order_relaxed);
+    // Keep the writes below after the store of the odd sequence number.
+    std::atomic_thread_fence(std::memory_order_release);
+    __atomic_store_n(&kernel_uses_handler_mask_, false, __ATOMIC_RELAXED);
+    for (size_t i = 0; i != num_unblocked_signals; ++i) {
+      __atomic_store_n(&unblocked_signals_[i], unblocked_signals[i], __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&num_unblocked_signals_, num_unblocked_signals, __ATOMIC_RELAXED);
+#if defined(__BIONIC__)
+    linked_sigaction64(signo, &handler_action, old_action);
+#else
+    linked_sigaction(signo, &handler_action, old_action);
+#endif
+    __atomic_store_n(&kernel_uses_handler_mask_, uses_handler_mask, __ATOMIC_RELAXED);
+    handler_mask_sequence_.store(sequence + 2u, std::memory_order_release);
+  }
+
+  // Fill in the action of the signal chain for the kernel. The kernel blocks the mask of the first
+  // special handler rather than all signals when there is one, so that the common case of a fault
+  // handled by the first special handler does not need to change the mask. Returns whether the
+  // mask of the first special handler is used, and then the signals it leaves unblocked.
+  template <typename SigactionType>
+  bool InitHandlerAction(int signo,
+                         SigactionType* action,
+                         /*out*/ int* unblocked_signals,
+                         /*out*/ size_t* num_unblocked_signals) {
+    action->sa_sigaction = SignalChain::Handler;
+    action->sa_flags = SA_RESTART | SA_SIGINFO | SA_ONSTACK | SA_UNSUPPORTED | SA_EXPOSE_TAGBITS;
+    const SigchainAction& first_handler = special_handlers_[0];
+    if (first_handler.sc_sigaction == nullptr) {
+#if defined(__BIONIC__)
+      sigfillset64(&action->sa_mask);
+#else
+      sigfillset(&action->sa_mask);
+#endif
+      return false;
+    }
+
+    sigemptyset(&action->sa_mask);
+    for (int i = 1; i < _NSIG; ++i) {
+      if (sigismember(&first_handler.sc_mask, i) == 1) {
+        sigaddset(&action->sa_mask, i);
+      } else {
+        unblocked_signals[(*num_unblocked_signals)++] = i;
+      }
+    }
+    if (sigismember(&first_handler.sc_mask, signo) != 1) {
+      action->sa_flags |= SA_NODEFER;
+    }
+    return true;
+  }
+
+  // Whether the kernel already set the mask of the first special handler when delivering the
+  // signal. It adds the mask to the one of the interrupted code, so this is only the case if the
+  // interrupted code did not block any signal that the handler wants unblocked. Synchronous faults
+  // always satisfy this for the signal itself, as the kernel does not deliver them when blocked.
+  // `sequence` is the value of `handler_mask_sequence_` read when entering the handler. Returns
+  // false, so that the mask is set explicitly, if the kernel action was updated meanwhile.
+  bool KernelSetHandlerMask(const ucontext_t* ucontext, uint32_t sequence) const {
+    if ((sequence & 1u) != 0u || !__atomic_load_n(&kernel_uses_handler_mask_, __ATOMIC_RELAXED)) {
+      return false;
+    }
+#if defined(__BIONIC__)
+    const sigset64_t* interrupted_mask = &ucontext->uc_sigmask64;
+#else
+    const sigset_t* interrupted_mask = &ucontext->uc_sigmask;
+#endif
+    bool interrupted_mask_compatible = true;
+    size_t num_unblocked_signals = __atomic_load_n(&num_unblocked_signals_, __ATOMIC_RELAXED);
+    for (size_t i = 0; i != num_unblocked_signals && i != _NSIG; ++i) {
+      int unblocked_signal = __atomic_load_n(&unblocked_signals_[i], __ATOMIC_RELAXED);
+      if (sigismember(interrupted_mask, unblocked_signal) == 1) {
+        interrupted_mask_compatible = false;
+        break;
+      }
+    }
+    // Keep the reads above before the re-check of the sequence number.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return interrupted_mask_compatible &&
+           handler_mask_sequence_.load(std::memory_order_relaxed) == sequence;
+  }
+
   bool claimed_;
   int kernel_supported_flags_;
 #if defined(__BIONIC__)
@@ -389,6 +501,15 @@ class SignalChain {
   struct sigaction action_;
 #endif
   SigchainAction special_handlers_[2];
+
+  // Odd while the kernel action and the fields below are updated, and incremented again once
+  // they are, so that the handler can detect an update that raced with reading them.
+  std::atomic<uint32_t> handler_mask_sequence_{0u};
+  // Whether the kernel blocks the mask of the first special handler, see InitHandlerAction().
+  bool kernel_uses_handler_mask_ = false;
+  // The signals that are not in the mask of the first special handler.
+  int unblocked_signals_[_NSIG];
+  size_t num_unblocked_signals_ = 0;
 };
 
 // _NSIG is 1 greater than the highest valued signal, but signals start from 1.
@@ -404,11 +525,21 @@ __attribute__((weak)) extern "C" bool android_handle_signal(int signal_number,
                                                             void* context);
 
 void SignalChain::Handler(int signo, siginfo_t* siginfo, void* ucontext_raw) {
+  SignalChain& chain = chains[signo];
+  ucontext_t* ucontext = static_cast<ucontext_t*>(ucontext_raw);
+
   // Try the special handlers first.
   // If one of them crashes, we'll reenter this handler and pass that crash onto the user handler.
+  // The mask does not need to be restored when a special handler handles the signal, returning
+  // from this handler restores the mask of the interrupted code.
+  uint32_t sequence = chain.handler_mask_sequence_.load(std::memory_order_acquire);
+  // The kernel may have used the mask of the first special handler if an update was in progress.
+  bool mask_changed = (sequence & 1u) != 0u ||
+                      __atomic_load_n(&chain.kernel_uses_handler_mask_, __ATOMIC_RELAXED);
   if (!GetHandlingSignal(signo)) {
-    for (const auto& handler : chains[signo].special_handlers_) {
-      if (handler.sc_sigaction == nullptr) {
+    for (const auto& handler : chain.special_handlers_) {
+      auto sc_sigaction = __atomic_load_n(&handler.sc_sigaction, __ATOMIC_ACQUIRE);
+      if (sc_sigaction == nullptr) {
         break;
       }
 
@@ -416,19 +547,33 @@ void SignalChain::Handler(int signo, siginfo_t* siginfo, void* ucontext_raw) {
       // Avoid setting the thread local flag in this case, since we'll never
       // get a chance to restore it.
       bool handler_noreturn = (handler.sc_flags & SIGCHAIN_ALLOW_NORETURN);
-      sigset_t previous_mask;
-      linked_sigprocmask(SIG_SETMASK, &handler.sc_mask, &previous_mask);
+      if (&handler != &chain.special_handlers_[0] ||
+          !chain.KernelSetHandlerMask(ucontext, sequence)) {
+        linked_sigprocmask(SIG_SETMASK, &handler.sc_mask, nullptr);
+        mask_changed = true;
+      }
 
       ScopedHandlingSignal restorer(signo, !handler_noreturn);
 
-      if (handler.sc_sigaction(signo, siginfo, ucontext_raw)) {
+      if (sc_sigaction(signo, siginfo, ucontext_raw)) {
         return;
       }
-
-      linked_sigprocmask(SIG_SETMASK, &previous_mask, nullptr);
     }
   }
 
+  // Block all signals again for the rest of the chain, like when the kernel blocks them.
+  if (mask_changed) {
+#if defined(__BIONIC__)
+    sigset64_t full_mask;
+    sigfillset64(&full_mask);
+    linked_sigprocmask64(SIG_SETMASK, &full_mask, nullptr);
+#else
+    sigset_t full_mask;
+    sigfillset(&full_mask);
+    linked_sigprocmask(SIG_SETMASK, &full_mask, nullptr);
+#endif
+  }
+
   // In Android 14, there's a special feature called "recoverable" GWP-ASan. GWP-ASan is a tool that
   // finds heap-buffer-overflow and heap-use-after-free on native heap allocations (e.g. malloc()
   // inside of JNI, not the ART heap). The way it catches buffer overflow (roughly) is by rounding
@@ -450,7 +595,6 @@ void SignalChain::Handler(int signo, siginfo_t* siginfo, void* ucontext_raw) {
 
   // Forward to the user's signal handler.
   int handler_flags = chains[signo].action_.sa_flags;
-  ucontext_t* ucontext = static_cast<ucontext_t*>(ucontext_raw);
 #if defined(__BIONIC__)
   sigset64_t mask;
   sigorset(&mask, &ucontext->uc_sigmask64, &chains[signo].action_.sa_mask);
@@ -640,6 +784,7 @@ extern "C" void AddSpecialSignalHandlerFn(int signal, SigchainAction* sa) {
 
   // Set the managed_handler.
   chains[signal].AddSpecialHandler(sa);
+  chains[signal].UpdateKernelAction(signal);
   chains[signal].Claim(signal);
 }
 
@@ -651,6 +796,7 @@ extern "C" void RemoveSpecialSignalHandlerFn(int signal, bool (*fn)(int, siginfo
   }
 
   chains[signal].RemoveSpecialHandler(fn);
+  chains[signal].UpdateKernelAction(signal);
 }
 
 extern "C" void EnsureFrontOfChain(int signal) {
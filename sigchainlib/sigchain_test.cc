@@ -53,6 +53,10 @@ static int sigemptyset64(sigset64_t* set) {
 static int sigismember64(sigset64_t* set, int member) {
   return sigismember(set, member);
 }
+
+static int sigaddset64(sigset64_t* set, int member) {
+  return sigaddset(set, member);
+}
 #endif
 
 static int RealSigprocmask(int how, const sigset64_t* new_sigset, sigset64_t* old_sigset) {
@@ -255,6 +259,48 @@ TEST_F(SigchainTest, EnsureFrontOfChain) {
   called = 0;
 }
 
+// Make sure that special handlers run with their mask, whether the kernel or sigchain sets it.
+TEST_F(SigchainTest, SpecialHandlerMask) {
+  static sigset64_t handler_mask;
+  art::SigchainAction action = {
+      .sc_sigaction = [](int, siginfo_t*, void*) -> bool {
+        RealSigprocmask(SIG_SETMASK, nullptr, &handler_mask);
+        return true;
+      },
+      .sc_mask = {},
+      .sc_flags = 0,
+  };
+  sigfillset(&action.sc_mask);
+  sigdelset(&action.sc_mask, SIGSEGV);
+  sigdelset(&action.sc_mask, SIGUSR2);
+  art::AddSpecialSignalHandlerFn(SIGUSR2, &action);
+
+  for (bool block_sigsegv : {false, true}) {
+    sigset64_t mask;
+    sigemptyset64(&mask);
+    if (block_sigsegv) {
+      sigaddset64(&mask, SIGSEGV);
+    }
+    ASSERT_EQ(0, RealSigprocmask(SIG_SETMASK, &mask, nullptr));
+    sigemptyset64(&handler_mask);
+    sigval value;
+    value.sival_ptr = nullptr;
+    sigqueue(getpid(), SIGUSR2, value);
+
+    EXPECT_FALSE(sigismember64(&handler_mask, SIGSEGV));
+    EXPECT_FALSE(sigismember64(&handler_mask, SIGUSR2));
+    EXPECT_TRUE(sigismember64(&handler_mask, SIGUSR1));
+    ASSERT_EQ(0, RealSigprocmask(SIG_SETMASK, nullptr, &mask));
+    EXPECT_EQ(block_sigsegv, sigismember64(&mask, SIGSEGV) == 1);
+    EXPECT_FALSE(sigismember64(&mask, SIGUSR1));
+  }
+
+  art::RemoveSpecialSignalHandlerFn(SIGUSR2, action.sc_sigaction);
+  sigset64_t mask;
+  sigemptyset64(&mask);
+  ASSERT_EQ(0, RealSigprocmask(SIG_SETMASK, &mask, nullptr));
+}
+
 #if defined(__aarch64__)
 // The test intentionally dereferences (tagged) null to trigger SIGSEGV.
 // We need to disable HWASAN since it would catch the dereference first.
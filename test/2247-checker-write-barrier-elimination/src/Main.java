@@ -46,6 +46,13 @@ public class Main {
         $noinline$testStaticFieldSetsMultipleReceivers(new Object(), new Object(), new Object());
         $noinline$testArraySetsMultipleReceiversSameRTI();
 
+        // A write barrier covers the sets to the same receiver in the blocks it dominates, if
+        // they have a single predecessor.
+        $noinline$testInstanceFieldSetsAcrossBlocks(
+                new Main(), new Object(), new Object(), new Object(), true);
+        $noinline$testInstanceFieldSetsAcrossBlocks(
+                new Main(), new Object(), new Object(), new Object(), false);
+
         // The write barrier elimination optimization is blocked by invokes, suspend checks, and
         // instructions that can throw.
         $noinline$testInstanceFieldSetsBlocked(
@@ -248,6 +255,25 @@ public class Main {
         return array_of_arrays;
     }
 
+    /// CHECK-START: Main Main.$noinline$testInstanceFieldSetsAcrossBlocks(Main, java.lang.Object, java.lang.Object, java.lang.Object, boolean) disassembly (after)
+    /// CHECK: InstanceFieldSet field_name:Main.inner field_type:Reference write_barrier_kind:EmitNoNullCheck
+    /// CHECK: InstanceFieldSet field_name:Main.inner{{[23]}} field_type:Reference write_barrier_kind:DontEmit
+    /// CHECK: InstanceFieldSet field_name:Main.inner{{[23]}} field_type:Reference write_barrier_kind:DontEmit
+
+    /// CHECK-START: Main Main.$noinline$testInstanceFieldSetsAcrossBlocks(Main, java.lang.Object, java.lang.Object, java.lang.Object, boolean) disassembly (after)
+    /// CHECK: ; card_table
+    /// CHECK-NOT: ; card_table
+    private static Main $noinline$testInstanceFieldSetsAcrossBlocks(
+            Main m, Object o, Object o2, Object o3, boolean b) {
+        m.inner = o;
+        if (b) {
+            m.inner2 = o2;
+        } else {
+            m.inner3 = o3;
+        }
+        return m;
+    }
+
     private static void $noinline$emptyMethod() {}
 
     /// CHECK-START: Main Main.$noinline$testInstanceFieldSetsBlocked(Main, java.lang.Object, java.lang.Object, java.lang.Object) disassembly (after)
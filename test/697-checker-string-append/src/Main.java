@@ -23,6 +23,8 @@ public class Main {
         testAppendDoubleAndFloat();
         testAppendStringAndString();
         testMiscelaneous();
+        testAppendBoxed();
+        testLongChain();
         testNoArgs();
         testInline();
         testEquals();
@@ -224,6 +226,8 @@ public class Main {
         "Float/-9999999.0",
         "Float/-1.0E7",
         "Float/-1.0E10",
+        "Float/0.0",
+        "Float/-0.0",
         "Float/0.25",
         "Float/1.625",
         "Float/9.3125",
@@ -290,6 +294,8 @@ public class Main {
         "Double/-9999999.0",
         "Double/-1.0E7",
         "Double/-1.0E24",
+        "Double/0.0",
+        "Double/-0.0",
         "Double/0.25",
         "Double/1.625",
         "Double/9.3125",
@@ -391,6 +397,65 @@ public class Main {
                      $noinline$appendSLILC("x", 1L, 7, -1L, '\u0131'));
     }
 
+    /// CHECK-START: java.lang.String Main.$noinline$appendBoxed(java.lang.Integer, java.lang.Long, java.lang.Boolean, java.lang.Character, java.lang.Short, java.lang.Byte) instruction_simplifier (before)
+    /// CHECK-NOT:              StringBuilderAppend
+
+    /// CHECK-START: java.lang.String Main.$noinline$appendBoxed(java.lang.Integer, java.lang.Long, java.lang.Boolean, java.lang.Character, java.lang.Short, java.lang.Byte) instruction_simplifier (after)
+    /// CHECK:                  StringBuilderAppend
+    public static String $noinline$appendBoxed(Integer i,
+                                               Long l,
+                                               Boolean z,
+                                               Character c,
+                                               Short s,
+                                               Byte b) {
+        return new StringBuilder().append(i)
+                                  .append('/')
+                                  .append(l)
+                                  .append('/')
+                                  .append(z)
+                                  .append(c)
+                                  .append(s)
+                                  .append(b).toString();
+    }
+
+    /// CHECK-START: java.lang.String Main.$noinline$appendObject(java.lang.Object) instruction_simplifier (after)
+    /// CHECK-NOT:              StringBuilderAppend
+    public static String $noinline$appendObject(Object o) {
+        return new StringBuilder().append("o=").append(o).toString();
+    }
+
+    public static void testAppendBoxed() {
+        assertEquals("42/-1/truex7-8",
+                     $noinline$appendBoxed(42, -1L, true, 'x', (short) 7, (byte) -8));
+        assertEquals("null/null/nullnullnullnull",
+                     $noinline$appendBoxed(null, null, null, null, null, null));
+        assertEquals("-2147483648/9223372036854775807/false\u01310-128",
+                     $noinline$appendBoxed(Integer.MIN_VALUE, Long.MAX_VALUE, false, '\u0131',
+                                           (short) 0, Byte.MIN_VALUE));
+        assertEquals("o=42", $noinline$appendObject(42));
+    }
+
+    /// CHECK-START: java.lang.String Main.$noinline$appendLongChain(java.lang.String, int, long, char) instruction_simplifier (before)
+    /// CHECK-NOT:              StringBuilderAppend
+
+    /// CHECK-START: java.lang.String Main.$noinline$appendLongChain(java.lang.String, int, long, char) instruction_simplifier (after)
+    /// CHECK:                  <<First:l\d+>> StringBuilderAppend
+    /// CHECK:                  StringBuilderAppend [<<First>>,{{.*}}]
+
+    /// CHECK-START: java.lang.String Main.$noinline$appendLongChain(java.lang.String, int, long, char) instruction_simplifier (after)
+    /// CHECK-NOT:              InvokeVirtual method_name:java.lang.StringBuilder.toString
+    public static String $noinline$appendLongChain(String s, int i, long l, char c) {
+        return new StringBuilder().append(s).append(i).append(l).append(c)
+                                  .append(s).append(i).append(l).append(c)
+                                  .append(s).append(i).append(l).append(c).toString();
+    }
+
+    public static void testLongChain() {
+        assertEquals("a1-2ba1-2ba1-2b", $noinline$appendLongChain("a", 1, -2L, 'b'));
+        assertEquals("null0-1\u0131null0-1\u0131null0-1\u0131",
+                     $noinline$appendLongChain(null, 0, -1L, '\u0131'));
+    }
+
     public static String $inline$testInlineInner(StringBuilder sb, String s, int i) {
         return sb.append(s).append(i).toString();
     }